@@ -0,0 +1,162 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <fusion.h>
+#include <ops/all_ops.h>
+#include <runtime/fusion_executor_cache.h>
+
+#include <benchmark/benchmark.h>
+
+#include <ATen/ATen.h>
+#include <c10/util/irange.h>
+
+#include <tests/cpp/utils.h>
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Scalability of runFusionWithInputs when threads share FusionExecutorCaches,
+// as in multi-threaded serving. Kernel launches are disabled so that the
+// host path, and in particular the locks of the caches, dominates. The
+// argument is the percentage of runs whose inputs hit the InputsIdLookup of
+// their cache. The other runs use shapes that were evicted from it, so they
+// map their inputs to a runtime through the heuristics again.
+//
+// Besides the throughput, each benchmark reports the median and tail latency
+// of a run, and the fraction of the wall time the threads were not on a CPU,
+// mostly blocked on locks. The counters are averaged over the threads.
+
+using namespace nvfuser;
+
+namespace {
+
+constexpr int64_t kNumCaches = 2;
+constexpr int64_t kNumHotShapes = 8;
+// More shapes than the 100 input sets an InputsIdLookup keeps
+constexpr int64_t kNumColdShapes = 256;
+
+std::vector<c10::IValue> makeInputs(int64_t rows) {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  return {at::randn({rows, 128}, options)};
+}
+
+std::unique_ptr<FusionExecutorCache> makeCache(int64_t cache_id) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* tv = makeContigTensor(2);
+  fusion->addInput(tv);
+  tv = cache_id % 2 == 0 ? sin(tv) : relu(tv);
+  tv = mul(tv, IrBuilder::create<Val>(2.0));
+  fusion->addOutput(tv);
+  return std::make_unique<FusionExecutorCache>(std::move(fusion));
+}
+
+struct SharedCaches {
+  std::vector<std::unique_ptr<FusionExecutorCache>> caches;
+  std::vector<std::vector<c10::IValue>> hot_inputs;
+  std::vector<std::vector<c10::IValue>> cold_inputs;
+};
+
+// Compiles the caches for all shapes once for all benchmarks. The hot shapes
+// run last, so they are the ones left in the lookups.
+SharedCaches& sharedCaches() {
+  static SharedCaches shared = []() {
+    SharedCaches shared;
+    for (auto i : c10::irange(kNumColdShapes)) {
+      shared.cold_inputs.push_back(makeInputs(64 + i));
+    }
+    for (auto i : c10::irange(kNumHotShapes)) {
+      shared.hot_inputs.push_back(makeInputs(8 + i));
+    }
+    for (auto cache_id : c10::irange(kNumCaches)) {
+      auto& cache = shared.caches.emplace_back(makeCache(cache_id));
+      for (const auto& inputs : shared.cold_inputs) {
+        cache->runFusionWithInputs(inputs);
+      }
+      for (const auto& inputs : shared.hot_inputs) {
+        cache->runFusionWithInputs(inputs);
+      }
+      cache->disableKernelLaunch();
+    }
+    return shared;
+  }();
+  return shared;
+}
+
+double threadCpuSeconds() {
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1.0e-9;
+}
+
+} // namespace
+
+static void CacheScalability_RunFusionWithInputs(
+    benchmark::State& benchmark_state) {
+  using Clock = std::chrono::steady_clock;
+  const int64_t hit_percentage = benchmark_state.range(0);
+  SharedCaches& shared = sharedCaches();
+
+  const int64_t thread_index = benchmark_state.thread_index();
+  std::mt19937 generator(thread_index);
+  std::uniform_int_distribution<int64_t> percentage(0, 99);
+  int64_t next_hot = thread_index;
+  int64_t next_cold = thread_index * (kNumColdShapes / 16);
+  std::vector<double> latencies_us;
+
+  const auto wall_start = Clock::now();
+  const double cpu_start = threadCpuSeconds();
+  for (auto _ : benchmark_state) {
+    const auto& inputs = percentage(generator) < hit_percentage
+        ? shared.hot_inputs[next_hot++ % kNumHotShapes]
+        : shared.cold_inputs[next_cold++ % kNumColdShapes];
+    FusionExecutorCache& cache =
+        *shared.caches[(next_hot + next_cold) % kNumCaches];
+
+    const auto start = Clock::now();
+    benchmark::DoNotOptimize(cache.runFusionWithInputs(inputs));
+    latencies_us.push_back(
+        std::chrono::duration<double, std::micro>(Clock::now() - start)
+            .count());
+  }
+  const double cpu_seconds = threadCpuSeconds() - cpu_start;
+  const double wall_seconds =
+      std::chrono::duration<double>(Clock::now() - wall_start).count();
+
+  benchmark_state.SetItemsProcessed(benchmark_state.iterations());
+  if (latencies_us.empty()) {
+    return;
+  }
+  auto percentile = [&](double p) {
+    auto nth = latencies_us.begin() +
+        (int64_t)((double)(latencies_us.size() - 1) * p);
+    std::nth_element(latencies_us.begin(), nth, latencies_us.end());
+    return *nth;
+  };
+  benchmark_state.counters["p50_us"] =
+      benchmark::Counter(percentile(0.5), benchmark::Counter::kAvgThreads);
+  benchmark_state.counters["p99_us"] =
+      benchmark::Counter(percentile(0.99), benchmark::Counter::kAvgThreads);
+  benchmark_state.counters["blocked"] = benchmark::Counter(
+      std::max(0.0, 1.0 - cpu_seconds / wall_seconds),
+      benchmark::Counter::kAvgThreads);
+}
+
+BENCHMARK(CacheScalability_RunFusionWithInputs)
+    ->Arg(100)
+    ->Arg(90)
+    ->Arg(50)
+    ->Arg(0)
+    ->ThreadRange(1, 16)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
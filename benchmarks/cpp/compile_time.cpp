@@ -0,0 +1,353 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <fusion.h>
+#include <fusion_profiler.h>
+#include <instrumentation.h>
+#include <ir/builder.h>
+#include <ops/all_ops.h>
+#include <options.h>
+#include <runtime/fusion_executor_cache.h>
+
+#include <benchmark/benchmark.h>
+
+#include <ATen/ATen.h>
+#include <c10/util/irange.h>
+
+#include <tests/cpp/utils.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Host time of going from a Fusion to compiled kernels, broken down into the
+// phases recorded by CompilePhaseProfiler. Each benchmark reports one phase
+// of one fusion as its manual time, so tools/compare_benchmark.py diffs the
+// phases separately. Phases recorded by parallel compilation threads are
+// summed, so they may exceed the wall time of the compilation.
+
+using namespace nvfuser;
+
+namespace {
+
+enum class CompilePhaseGroup {
+  Preseg,
+  Segmentation,
+  Scheduling,
+  Lowering,
+  Codegen,
+  Nvrtc
+};
+
+bool startsWith(const std::string& name, const std::string& prefix) {
+  return name.compare(0, prefix.size(), prefix) == 0;
+}
+
+bool endsWith(const std::string& name, const std::string& suffix) {
+  return name.size() >= suffix.size() &&
+      name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// The segmenter includes the canSchedule checks and heuristics it runs, so
+// scheduling only counts the scheduling of the segments
+bool isInGroup(const std::string& name, CompilePhaseGroup group) {
+  switch (group) {
+    case CompilePhaseGroup::Preseg:
+      return startsWith(name, "Preseg ");
+    case CompilePhaseGroup::Segmentation:
+      return name == "Segmenter";
+    case CompilePhaseGroup::Scheduling:
+      return endsWith(name, " schedule");
+    case CompilePhaseGroup::Lowering:
+      return startsWith(name, "GpuLower::");
+    case CompilePhaseGroup::Codegen:
+      return name == "Codegen";
+    case CompilePhaseGroup::Nvrtc:
+      return name == "NVRTC";
+  }
+  return false;
+}
+
+struct FusionAndInputs {
+  std::unique_ptr<Fusion> fusion;
+  std::vector<c10::IValue> inputs;
+};
+
+// Compiles a new FusionExecutorCache of the fusion in each iteration and
+// reports the time of the phases in `group`
+void runCompileTime(
+    benchmark::State& benchmark_state,
+    const std::function<FusionAndInputs()>& make_fusion,
+    CompilePhaseGroup group) {
+  ProfilerOptionsGuard profiler_guard;
+  ProfilerOptionsGuard::getCurOptions().set(ProfilerOption::EnableNocupti);
+
+  for (auto _ : benchmark_state) {
+    FusionAndInputs fusion_and_inputs = make_fusion();
+    FusionExecutorCache executor_cache(std::move(fusion_and_inputs.fusion));
+    executor_cache.runFusionWithInputs(fusion_and_inputs.inputs);
+
+    double time_ms = 0.0;
+    for (const inst::CompilePhase& phase :
+         FusionProfiler::profile().compile_phases) {
+      if (isInGroup(phase.name, group)) {
+        time_ms += phase.time_ms;
+      }
+    }
+    benchmark_state.SetIterationTime(time_ms / 1000.0);
+  }
+}
+
+// Bias, dropout, residual and layer norm that end a BERT layer
+FusionAndInputs makeBertLayer() {
+  constexpr int64_t kBatch = 8;
+  constexpr int64_t kSequence = 512;
+  constexpr int64_t kHidden = 1024;
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto x = makeContigTensor(3, DataType::Half);
+  auto bias = makeContigTensor(1, DataType::Half);
+  auto residual = makeContigTensor(3, DataType::Half);
+  auto weight = makeContigTensor(1, DataType::Half);
+  auto beta = makeContigTensor(1, DataType::Half);
+  fusion->addInput(x);
+  fusion->addInput(bias);
+  fusion->addInput(residual);
+  fusion->addInput(weight);
+  fusion->addInput(beta);
+
+  auto y = add(castOp(DataType::Float, x), castOp(DataType::Float, bias));
+  auto dropout_result = dropout(y, IrBuilder::create<Val>(0.1));
+  y = add(dropout_result.output, castOp(DataType::Float, residual));
+  auto norm = layer_norm(
+      y,
+      {kHidden},
+      castOp(DataType::Float, weight),
+      castOp(DataType::Float, beta),
+      IrBuilder::create<Val>(1e-5));
+  fusion->addOutput(castOp(DataType::Half, norm.output));
+  fusion->addOutput(dropout_result.mask);
+  fusion->addOutput(norm.mean);
+  fusion->addOutput(norm.invstd);
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  return {
+      std::move(fusion),
+      {at::randn({kBatch, kSequence, kHidden}, options),
+       at::randn({kHidden}, options),
+       at::randn({kBatch, kSequence, kHidden}, options),
+       at::randn({kHidden}, options),
+       at::randn({kHidden}, options)}};
+}
+
+FusionAndInputs makeLayerNormBackward() {
+  constexpr int64_t kOuter = 8192;
+  constexpr int64_t kHidden = 1024;
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto grad_out = makeContigTensor(2);
+  auto input = makeContigTensor(2);
+  auto mean = makeConcreteTensor({-1, 1});
+  auto rstd = makeConcreteTensor({-1, 1});
+  auto weight = makeContigTensor(1);
+  auto bias = makeContigTensor(1);
+  fusion->addInput(grad_out);
+  fusion->addInput(input);
+  fusion->addInput(mean);
+  fusion->addInput(rstd);
+  fusion->addInput(weight);
+  fusion->addInput(bias);
+
+  auto grads = layer_norm_backward(
+      grad_out, input, {kHidden}, mean, rstd, weight, bias, {true, true, true});
+  fusion->addOutput(grads.grad_input);
+  fusion->addOutput(grads.grad_weight);
+  fusion->addOutput(grads.grad_bias);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  return {
+      std::move(fusion),
+      {at::randn({kOuter, kHidden}, options),
+       at::randn({kOuter, kHidden}, options),
+       at::randn({kOuter, 1}, options),
+       at::randn({kOuter, 1}, options),
+       at::randn({kHidden}, options),
+       at::randn({kHidden}, options)}};
+}
+
+// Fused with EnableOption::FuseMatmul, so that the matmul scheduler and its
+// lowering are compiled rather than evaluated by ATen
+FusionAndInputs makeMatmulEpilogue() {
+  constexpr int64_t kM = 2048;
+  constexpr int64_t kN = 4096;
+  constexpr int64_t kK = 1024;
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto x = makeContigTensor(2, DataType::Half);
+  auto weight = makeContigTensor(2, DataType::Half);
+  auto bias = makeContigTensor(1, DataType::Half);
+  fusion->addInput(x);
+  fusion->addInput(weight);
+  fusion->addInput(bias);
+
+  auto y = gelu(linear(x, weight, bias));
+  fusion->addOutput(castOp(DataType::Half, y));
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  return {
+      std::move(fusion),
+      {at::randn({kM, kK}, options),
+       at::randn({kN, kK}, options),
+       at::randn({kN}, options)}};
+}
+
+// Rotary embedding of the queries, which rotates the halves of the head
+// dimension with slices and a concatenation
+FusionAndInputs makeRope() {
+  constexpr int64_t kBatch = 2;
+  constexpr int64_t kHeads = 32;
+  constexpr int64_t kSequence = 4096;
+  constexpr int64_t kHeadDim = 128;
+  constexpr int64_t kRotaryDim = 64;
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto q = makeContigConcreteTensor(
+      {kBatch, kHeads, kSequence, kHeadDim}, DataType::BFloat16);
+  auto cos_tv =
+      makeContigConcreteTensor({kSequence, kRotaryDim}, DataType::BFloat16);
+  auto sin_tv =
+      makeContigConcreteTensor({kSequence, kRotaryDim}, DataType::BFloat16);
+  fusion->addInput(q);
+  fusion->addInput(cos_tv);
+  fusion->addInput(sin_tv);
+
+  auto q_rot = slice(q, {0, 0, 0, 0}, {kBatch, kHeads, kSequence, kRotaryDim});
+  auto q_pass = slice(
+      q, {0, 0, 0, kRotaryDim}, {kBatch, kHeads, kSequence, kHeadDim});
+  auto x1 = slice(
+      q_rot, {0, 0, 0, 0}, {kBatch, kHeads, kSequence, kRotaryDim / 2});
+  auto x2 = slice(
+      q_rot,
+      {0, 0, 0, kRotaryDim / 2},
+      {kBatch, kHeads, kSequence, kRotaryDim});
+  auto rotated = cat({neg(x2), x1}, -1);
+  auto cos_b = broadcast(cos_tv, {true, true, false, false});
+  auto sin_b = broadcast(sin_tv, {true, true, false, false});
+  auto q_embed = add(mul(q_rot, cos_b), mul(rotated, sin_b));
+  auto out = cat({castOp(DataType::BFloat16, q_embed), q_pass}, -1);
+  fusion->addOutput(out);
+
+  auto options = at::TensorOptions().dtype(at::kBFloat16).device(at::kCUDA, 0);
+  return {
+      std::move(fusion),
+      {at::randn({kBatch, kHeads, kSequence, kHeadDim}, options),
+       at::randn({kSequence, kRotaryDim}, options),
+       at::randn({kSequence, kRotaryDim}, options)}};
+}
+
+// A long chain of pointwise ops over a few inputs
+FusionAndInputs makeManyPointwiseOps() {
+  constexpr int64_t kNumInputs = 4;
+  constexpr int64_t kNumOps = 200;
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  std::vector<TensorView*> tvs;
+  for (auto i : c10::irange(kNumInputs)) {
+    (void)i; // Suppress unused variable warning
+    auto tv = makeContigTensor(2);
+    fusion->addInput(tv);
+    tvs.push_back(tv);
+  }
+  TensorView* tv = tvs.front();
+  for (auto i : c10::irange(kNumOps)) {
+    TensorView* other = tvs.at(i % kNumInputs);
+    tv = i % 3 == 0 ? add(tv, other)
+        : i % 3 == 1 ? mul(tv, other)
+                     : sin(tv);
+  }
+  fusion->addOutput(tv);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<c10::IValue> inputs;
+  for (auto i : c10::irange(kNumInputs)) {
+    (void)i; // Suppress unused variable warning
+    inputs.emplace_back(at::randn({1024, 1024}, options));
+  }
+  return {std::move(fusion), std::move(inputs)};
+}
+
+} // namespace
+
+static void CompileTime_BertLayer(
+    benchmark::State& benchmark_state,
+    CompilePhaseGroup group) {
+  runCompileTime(benchmark_state, makeBertLayer, group);
+}
+
+static void CompileTime_LayerNormBackward(
+    benchmark::State& benchmark_state,
+    CompilePhaseGroup group) {
+  runCompileTime(benchmark_state, makeLayerNormBackward, group);
+}
+
+static void CompileTime_MatmulEpilogue(
+    benchmark::State& benchmark_state,
+    CompilePhaseGroup group) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::FuseMatmul);
+  runCompileTime(benchmark_state, makeMatmulEpilogue, group);
+}
+
+static void CompileTime_Rope(
+    benchmark::State& benchmark_state,
+    CompilePhaseGroup group) {
+  runCompileTime(benchmark_state, makeRope, group);
+}
+
+static void CompileTime_ManyPointwiseOps(
+    benchmark::State& benchmark_state,
+    CompilePhaseGroup group) {
+  runCompileTime(benchmark_state, makeManyPointwiseOps, group);
+}
+
+#define NVFUSER_COMPILE_TIME_BENCHMARK(fn)                                 \
+  BENCHMARK_CAPTURE(fn, Preseg, CompilePhaseGroup::Preseg)                 \
+      ->UseManualTime()                                                    \
+      ->Unit(benchmark::kMillisecond);                                     \
+  BENCHMARK_CAPTURE(fn, Segmentation, CompilePhaseGroup::Segmentation)     \
+      ->UseManualTime()                                                    \
+      ->Unit(benchmark::kMillisecond);                                     \
+  BENCHMARK_CAPTURE(fn, Scheduling, CompilePhaseGroup::Scheduling)         \
+      ->UseManualTime()                                                    \
+      ->Unit(benchmark::kMillisecond);                                     \
+  BENCHMARK_CAPTURE(fn, Lowering, CompilePhaseGroup::Lowering)             \
+      ->UseManualTime()                                                    \
+      ->Unit(benchmark::kMillisecond);                                     \
+  BENCHMARK_CAPTURE(fn, Codegen, CompilePhaseGroup::Codegen)               \
+      ->UseManualTime()                                                    \
+      ->Unit(benchmark::kMillisecond);                                     \
+  BENCHMARK_CAPTURE(fn, Nvrtc, CompilePhaseGroup::Nvrtc)                   \
+      ->UseManualTime()                                                    \
+      ->Unit(benchmark::kMillisecond)
+
+NVFUSER_COMPILE_TIME_BENCHMARK(CompileTime_BertLayer);
+NVFUSER_COMPILE_TIME_BENCHMARK(CompileTime_LayerNormBackward);
+NVFUSER_COMPILE_TIME_BENCHMARK(CompileTime_MatmulEpilogue);
+NVFUSER_COMPILE_TIME_BENCHMARK(CompileTime_Rope);
+NVFUSER_COMPILE_TIME_BENCHMARK(CompileTime_ManyPointwiseOps);
@@ -0,0 +1,212 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <fusion.h>
+#include <ops/all_ops.h>
+#include <runtime/allocations.h>
+#include <runtime/executor.h>
+#include <runtime/executor_utils.h>
+#include <runtime/fusion_cache_utils.h>
+#include <runtime/fusion_executor_cache.h>
+#include <runtime/fusion_kernel_runtime.h>
+
+#include <benchmark/benchmark.h>
+
+#include <ATen/ATen.h>
+#include <c10/util/irange.h>
+#include <cuda_runtime.h>
+
+#include <tests/cpp/utils.h>
+
+#include <memory>
+#include <vector>
+
+// Host latency of the steady state of runFusionWithInputs, i.e., when the
+// inputs hit the caches, and of its stages. The tensors are tiny so that the
+// GPU keeps up with the launches and the host path dominates. The argument
+// of each benchmark is the number of segments.
+
+using namespace nvfuser;
+
+namespace {
+
+// A chain of pointwise segments of the same shape, so any tensor of that
+// shape is a valid input of every segment
+std::unique_ptr<FusionExecutorCache> makeSegmentChain(int64_t num_segments) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* tv = makeContigTensor(2);
+  fusion->addInput(tv);
+  for (auto i : c10::irange(num_segments)) {
+    tv = sin(tv);
+    if (i + 1 < num_segments) {
+      tv = segment_set(tv);
+    }
+  }
+  fusion->addOutput(tv);
+  return std::make_unique<FusionExecutorCache>(std::move(fusion));
+}
+
+std::vector<c10::IValue> makeInputs() {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  return {at::randn({16, 16}, options)};
+}
+
+// Runs the fusion once to compile it and returns the kernels of its segments
+std::vector<KernelExecutor*> warmUp(
+    FusionExecutorCache& executor_cache,
+    const std::vector<c10::IValue>& inputs,
+    int64_t num_segments) {
+  executor_cache.runFusionWithInputs(inputs);
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  std::vector<KernelExecutor*> kernel_executors;
+  for (const auto& executor : runtime->executors()) {
+    if (auto ke = dynamic_cast<KernelExecutor*>(executor.get())) {
+      kernel_executors.push_back(ke);
+    }
+  }
+  NVF_ERROR((int64_t)kernel_executors.size() == num_segments);
+  return kernel_executors;
+}
+
+} // namespace
+
+// From the entry of runFusionWithInputs to the return of the last launch
+static void HostLatency_EndToEnd(benchmark::State& benchmark_state) {
+  const int64_t num_segments = benchmark_state.range(0);
+  auto executor_cache = makeSegmentChain(num_segments);
+  auto inputs = makeInputs();
+  warmUp(*executor_cache, inputs, num_segments);
+
+  for (auto _ : benchmark_state) {
+    benchmark::DoNotOptimize(executor_cache->runFusionWithInputs(inputs));
+  }
+  cudaDeviceSynchronize();
+}
+
+// Same as HostLatency_EndToEnd without the kernel launches
+static void HostLatency_NoLaunch(benchmark::State& benchmark_state) {
+  const int64_t num_segments = benchmark_state.range(0);
+  auto executor_cache = makeSegmentChain(num_segments);
+  auto inputs = makeInputs();
+  warmUp(*executor_cache, inputs, num_segments);
+  executor_cache->disableKernelLaunch();
+
+  for (auto _ : benchmark_state) {
+    benchmark::DoNotOptimize(executor_cache->runFusionWithInputs(inputs));
+  }
+}
+
+// Mapping the inputs to the id of a known input set
+static void HostLatency_InputsIdLookup(benchmark::State& benchmark_state) {
+  auto inputs = makeInputs();
+  InputsIdLookup inputs_id_lookup;
+  inputs_id_lookup.lookupId(inputs);
+
+  for (auto _ : benchmark_state) {
+    benchmark::DoNotOptimize(inputs_id_lookup.lookupId(inputs));
+  }
+}
+
+// Converting the inputs to the arguments of the fusion
+static void HostLatency_ArgumentBinding(benchmark::State& benchmark_state) {
+  auto inputs = makeInputs();
+
+  for (auto _ : benchmark_state) {
+    benchmark::DoNotOptimize(
+        KernelArgumentHolder::createKernelArgumentHolder(inputs));
+  }
+}
+
+// Binding the arguments of each segment to an evaluator of its kernel
+static void HostLatency_Evaluator(benchmark::State& benchmark_state) {
+  const int64_t num_segments = benchmark_state.range(0);
+  auto executor_cache = makeSegmentChain(num_segments);
+  auto inputs = makeInputs();
+  auto kernel_executors = warmUp(*executor_cache, inputs, num_segments);
+  auto args = KernelArgumentHolder::createKernelArgumentHolder(inputs);
+
+  for (auto _ : benchmark_state) {
+    for (KernelExecutor* ke : kernel_executors) {
+      benchmark::DoNotOptimize(executor_utils::bindInputs(args, ke->kernel()));
+    }
+  }
+}
+
+// Inferring and allocating the outputs of each segment
+static void HostLatency_Allocation(benchmark::State& benchmark_state) {
+  const int64_t num_segments = benchmark_state.range(0);
+  auto executor_cache = makeSegmentChain(num_segments);
+  auto inputs = makeInputs();
+  auto kernel_executors = warmUp(*executor_cache, inputs, num_segments);
+  auto args = KernelArgumentHolder::createKernelArgumentHolder(inputs);
+  const c10::Device device(c10::DeviceType::CUDA, 0);
+
+  std::vector<ExpressionEvaluator> expr_evals;
+  for (KernelExecutor* ke : kernel_executors) {
+    expr_evals.push_back(executor_utils::bindInputs(args, ke->kernel()));
+  }
+
+  for (auto _ : benchmark_state) {
+    for (auto i : c10::irange(num_segments)) {
+      kir::Kernel* kernel = kernel_executors[i]->kernel();
+      auto output_info = getBufferInfos(
+          expr_evals[i], kernel->indexType(), kernel->outputs());
+      benchmark::DoNotOptimize(
+          allocateOutputs(kernel, output_info, device, expr_evals[i]));
+    }
+  }
+}
+
+// Running each segment with preallocated outputs, i.e., building its launch
+// arguments and launching it
+static void HostLatency_Launch(benchmark::State& benchmark_state) {
+  const int64_t num_segments = benchmark_state.range(0);
+  auto executor_cache = makeSegmentChain(num_segments);
+  auto inputs = makeInputs();
+  auto kernel_executors = warmUp(*executor_cache, inputs, num_segments);
+  std::vector<at::Tensor> outputs = {at::empty_like(inputs[0].toTensor())};
+
+  for (auto _ : benchmark_state) {
+    for (KernelExecutor* ke : kernel_executors) {
+      // run appends the outputs to the arguments
+      auto args = KernelArgumentHolder::createKernelArgumentHolder(inputs);
+      benchmark::DoNotOptimize(ke->run(args, {}, {}, outputs));
+    }
+  }
+  cudaDeviceSynchronize();
+}
+
+BENCHMARK(HostLatency_EndToEnd)
+    ->Arg(1)
+    ->Arg(5)
+    ->Arg(20)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(HostLatency_NoLaunch)
+    ->Arg(1)
+    ->Arg(5)
+    ->Arg(20)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(HostLatency_InputsIdLookup)->Unit(benchmark::kNanosecond);
+BENCHMARK(HostLatency_ArgumentBinding)->Unit(benchmark::kNanosecond);
+BENCHMARK(HostLatency_Evaluator)
+    ->Arg(1)
+    ->Arg(5)
+    ->Arg(20)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(HostLatency_Allocation)
+    ->Arg(1)
+    ->Arg(5)
+    ->Arg(20)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(HostLatency_Launch)
+    ->Arg(1)
+    ->Arg(5)
+    ->Arg(20)
+    ->Unit(benchmark::kMicrosecond);
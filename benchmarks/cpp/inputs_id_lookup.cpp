@@ -0,0 +1,136 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <runtime/fusion_cache_utils.h>
+#include <scheduler/runtime_info.h>
+
+#include <benchmark/benchmark.h>
+
+#include <ATen/ATen.h>
+#include <c10/util/irange.h>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace nvfuser;
+
+namespace {
+
+std::vector<c10::IValue> makeInputs(int64_t num_inputs) {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<c10::IValue> inputs;
+  for (auto i : c10::irange(num_inputs)) {
+    inputs.emplace_back(at::empty({8, 128 + i, 1024}, options));
+  }
+  return inputs;
+}
+
+// Reference string encoding that InputsIdLookup used before hashing, kept to
+// measure the gain of the allocation-free lookup
+template <typename T>
+void encodeBuffer(T value, std::string& buffer) {
+  const char* v = reinterpret_cast<char*>(&value);
+  buffer.append(v, sizeof(T));
+}
+
+class StringInputsIdLookup {
+ public:
+  size_t lookupId(const at::ArrayRef<c10::IValue>& inputs, int8_t device) {
+    encoding_.clear();
+    encodeBuffer(device, encoding_);
+    for (const auto& input : inputs) {
+      const auto& input_tensor = input.toTensor();
+      for (auto size : input_tensor.sizes()) {
+        encodeBuffer(size, encoding_);
+        encoding_.push_back(' ');
+      }
+      encoding_.push_back('X');
+      encoding_.push_back(' ');
+      for (auto stride : input_tensor.strides()) {
+        encodeBuffer(stride, encoding_);
+        encoding_.push_back(' ');
+      }
+      encoding_.push_back('a');
+      encodeBuffer(
+          SchedulerRuntimeInfo::computeAlignmentSize(
+              (size_t)input_tensor.data_ptr()),
+          encoding_);
+      encoding_.push_back(';');
+    }
+    auto& id = encoding_lookup_[encoding_];
+    if (id == 0) {
+      id = encoding_lookup_.size();
+    }
+    return id;
+  }
+
+ private:
+  std::string encoding_;
+  std::unordered_map<std::string, size_t> encoding_lookup_;
+};
+
+} // namespace
+
+static void InputsIdLookup_Hit(benchmark::State& benchmark_state) {
+  auto inputs = makeInputs(benchmark_state.range(0));
+
+  InputsIdLookup inputs_id_lookup;
+  const size_t id = inputs_id_lookup.lookupId(inputs).id;
+
+  for (auto _ : benchmark_state) {
+    NVF_ERROR(inputs_id_lookup.lookupId(inputs).id == id);
+  }
+}
+
+static void InputsIdLookup_StringEncodingHit(
+    benchmark::State& benchmark_state) {
+  auto inputs = makeInputs(benchmark_state.range(0));
+
+  StringInputsIdLookup inputs_id_lookup;
+  const size_t id = inputs_id_lookup.lookupId(inputs, 0);
+
+  for (auto _ : benchmark_state) {
+    NVF_ERROR(inputs_id_lookup.lookupId(inputs, 0) == id);
+  }
+}
+
+// Alternate between more input sets than fit in the cache so every lookup
+// misses and evicts an entry
+static void InputsIdLookup_Miss(benchmark::State& benchmark_state) {
+  constexpr int64_t num_input_sets = 8;
+  std::vector<std::vector<c10::IValue>> input_sets;
+  for (auto i : c10::irange(num_input_sets)) {
+    (void)i; // Suppress unused variable warning
+    input_sets.push_back(makeInputs(benchmark_state.range(0)));
+  }
+  for (auto i : c10::irange(num_input_sets)) {
+    auto options = input_sets[i][0].toTensor().options();
+    input_sets[i][0] = at::empty({i + 1}, options);
+  }
+
+  InputsIdLookup inputs_id_lookup(/*max_cache_size=*/num_input_sets - 1);
+  int64_t i = 0;
+  for (auto _ : benchmark_state) {
+    benchmark::DoNotOptimize(
+        inputs_id_lookup.lookupId(input_sets[i++ % num_input_sets]));
+  }
+}
+
+BENCHMARK(InputsIdLookup_Hit)
+    ->RangeMultiplier(4)
+    ->Range(1, 16)
+    ->Unit(benchmark::kNanosecond);
+BENCHMARK(InputsIdLookup_StringEncodingHit)
+    ->RangeMultiplier(4)
+    ->Range(1, 16)
+    ->Unit(benchmark::kNanosecond);
+BENCHMARK(InputsIdLookup_Miss)
+    ->RangeMultiplier(4)
+    ->Range(1, 16)
+    ->Unit(benchmark::kNanosecond);
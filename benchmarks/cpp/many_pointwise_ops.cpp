@@ -5,10 +5,12 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
+#include <device_lower/lower2device.h>
 #include <fusion.h>
 #include <ir/all_nodes.h>
 #include <ops/all_ops.h>
 #include <ops/arith.h>
+#include <scheduler/tools/inlining.h>
 
 #include <benchmark/benchmark.h>
 #include <benchmarks/cpp/utils.h>
@@ -62,3 +64,28 @@ BENCHMARK_REGISTER_F(
     ->RangeMultiplier(2)
     ->Range(1 << 3, 1 << 12)
     ->Complexity();
+
+// Lowering a deep, fully inlined chain is dominated by expression sorting,
+// which should scale near-linearly with the number of expressions
+BENCHMARK_DEFINE_F(
+    NvFuserScheduler_ManyPointwiseOpsFixture,
+    ManyPointwiseOpsLowerTest)
+(benchmark::State& state) {
+  Fusion fcopy = *fusion_;
+  {
+    FusionGuard fg(&fcopy);
+    inlineMost();
+  }
+  for (auto _ : state) {
+    GpuLower(&fcopy).run();
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK_REGISTER_F(
+    NvFuserScheduler_ManyPointwiseOpsFixture,
+    ManyPointwiseOpsLowerTest)
+    ->RangeMultiplier(2)
+    ->Range(1 << 3, 1 << 11)
+    ->Complexity()
+    ->Unit(benchmark::kMillisecond);
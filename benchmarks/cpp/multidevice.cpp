@@ -0,0 +1,594 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <cuda_utils.h>
+#include <fusion.h>
+#include <host_ir/container.h>
+#include <ir/builder.h>
+#include <multidevice/communication.h>
+#include <multidevice/communicator.h>
+#include <multidevice/executor.h>
+#include <multidevice/utils.h>
+#include <ops/all_ops.h>
+#include <ops/utils.h>
+#include <runtime/fusion_executor_cache.h>
+
+#include <benchmark/benchmark.h>
+
+#include <ATen/ATen.h>
+#include <c10/cuda/CUDAFunctions.h>
+#include <c10/util/irange.h>
+#include <cuda_runtime.h>
+
+#include <tests/cpp/multidevice_transformer.h>
+#include <tests/cpp/utils.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Benchmarks of multidevice/, launched with one process per GPU, e.g.,
+//   mpirun -np 8 bin/nvfuser_multidevice_bench
+// Every rank runs every benchmark in lockstep, so the number of iterations is
+// fixed and each one starts with a barrier. Only rank 0 reports. Times are
+// wall times between device synchronizations, so they include host overhead
+// and the work of all streams.
+//
+// - Communication_* post one Communication of each CommunicationType on the
+//   NCCL (0) or UCC (1) backend for a range of message sizes, and report the
+//   bus bandwidth with the conventions of nccl-tests.
+// - AllgatherMatmul and MatmulReduceScatter are the two halves of a
+//   sequence-parallel linear layer, lowered by HostIrLower with (1) or
+//   without (0) stream pipelining, i.e.,
+//   lowerToCollectiveBasedPipelinedGemmComm and its reduce-scatter
+//   counterpart. They report the overlap efficiency, the fraction of the
+//   shorter of the communication and the matmul hidden by the other one.
+// - TensorParallelMlp and TensorParallelAttention run the blocks of
+//   DistributedTransformer end to end, without (0) or with (1) sequence
+//   parallelism.
+
+using namespace nvfuser;
+
+namespace {
+
+constexpr int64_t kIterations = 20;
+
+Communicator& communicator() {
+  return Communicator::getInstance();
+}
+
+at::TensorOptions tensorOptions(at::ScalarType dtype = at::kFloat) {
+  return at::TensorOptions().dtype(dtype).device(communicator().device());
+}
+
+// Mean wall time of fn in seconds, after a warm-up run
+double timeSeconds(const std::function<void()>& fn, int64_t iterations) {
+  fn();
+  communicator().barrier();
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceSynchronize());
+  const auto start = std::chrono::steady_clock::now();
+  for (auto i : c10::irange(iterations)) {
+    (void)i; // Suppress unused variable warning
+    fn();
+  }
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceSynchronize());
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+             .count() /
+      (double)iterations;
+}
+
+// Runs fn once per iteration of benchmark_state, after a warm-up run
+void runIterations(
+    benchmark::State& benchmark_state,
+    const std::function<void()>& fn) {
+  fn();
+  for (auto _ : benchmark_state) {
+    communicator().barrier();
+    NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceSynchronize());
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceSynchronize());
+    benchmark_state.SetIterationTime(
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+            .count());
+  }
+}
+
+// Ratio of the bus bandwidth to the algorithm bandwidth, see
+// https://github.com/NVIDIA/nccl-tests/blob/master/doc/PERFORMANCE.md
+double busBandwidthFactor(CommunicationType type, int64_t num_ranks) {
+  const auto n = (double)num_ranks;
+  switch (type) {
+    case CommunicationType::Allgather:
+    case CommunicationType::ReduceScatter:
+    case CommunicationType::Gather:
+    case CommunicationType::Scatter:
+      return (n - 1) / n;
+    case CommunicationType::Allreduce:
+      return 2 * (n - 1) / n;
+    case CommunicationType::Reduce:
+    case CommunicationType::Broadcast:
+    case CommunicationType::SendRecv:
+      return 1;
+  }
+  NVF_THROW("Unexpected communication type: ", type);
+}
+
+} // namespace
+
+// The first argument is the backend, the second the size in bytes of the
+// unsharded buffer, e.g., the output of an allgather or the input of a
+// reduce-scatter
+static void Communication_Benchmark(
+    benchmark::State& benchmark_state,
+    CommunicationType type) {
+  Communicator& comm = communicator();
+  const auto backend_type = benchmark_state.range(0) == 0
+      ? CommunicatorBackend::kNccl
+      : CommunicatorBackend::kUcc;
+  if (!comm.isBackendAvailable(backend_type)) {
+    benchmark_state.SkipWithError("Backend not available");
+    return;
+  }
+  const int64_t num_ranks = comm.size();
+  const DeviceIdxType my_device = comm.deviceId();
+  if (type == CommunicationType::SendRecv && num_ranks < 2) {
+    benchmark_state.SkipWithError("Requires 2 ranks");
+    return;
+  }
+  constexpr DeviceIdxType kRoot = 0;
+  const int64_t numel = benchmark_state.range(1) / (int64_t)sizeof(float);
+  const int64_t shard_numel = numel / num_ranks;
+
+  hir::HostIrContainer container;
+  FusionGuard fg(&container);
+  const auto mesh = DeviceMesh::createForNumDevices(num_ranks);
+  Team team = mesh.vector();
+  DeviceIdxType root = kRoot;
+  TensorView* in = nullptr;
+  TensorView* out = nullptr;
+  at::Tensor input;
+  at::Tensor output;
+  const bool is_root = my_device == kRoot;
+  switch (type) {
+    case CommunicationType::Gather:
+    case CommunicationType::Allgather:
+      in = makeContigTensor(2);
+      out = ops::newValLike(in, in->dtype())->as<TensorView>();
+      input = at::randn({1, shard_numel}, tensorOptions());
+      output = at::empty({num_ranks, shard_numel}, tensorOptions());
+      break;
+    case CommunicationType::Scatter:
+      in = makeContigTensor(2);
+      out = ops::newValLike(in, in->dtype())->as<TensorView>();
+      if (is_root) {
+        input = at::randn({num_ranks, shard_numel}, tensorOptions());
+      }
+      output = at::empty({1, shard_numel}, tensorOptions());
+      break;
+    case CommunicationType::Reduce:
+    case CommunicationType::Allreduce:
+      in = makeContigTensor(2);
+      out = newForReduction(in, {0});
+      input = at::randn({1, numel}, tensorOptions());
+      output = at::empty({numel}, tensorOptions());
+      break;
+    case CommunicationType::ReduceScatter:
+      in = makeContigTensor(3);
+      out = newForReduction(in, {0});
+      input = at::randn({1, num_ranks, shard_numel}, tensorOptions());
+      output = at::empty({1, shard_numel}, tensorOptions());
+      break;
+    case CommunicationType::Broadcast:
+      in = makeContigTensor(1);
+      out = ops::newValLike(in, in->dtype())->as<TensorView>();
+      if (is_root) {
+        input = at::randn({numel}, tensorOptions());
+      }
+      output = at::empty({numel}, tensorOptions());
+      break;
+    case CommunicationType::SendRecv:
+      // From the last rank to the first one
+      in = makeContigTensor(1);
+      out = ops::newValLike(in, in->dtype())->as<TensorView>();
+      root = num_ranks - 1;
+      team = {root, kRoot};
+      if (my_device == root) {
+        input = at::randn({numel}, tensorOptions());
+      } else if (is_root) {
+        output = at::empty({numel}, tensorOptions());
+      }
+      break;
+  }
+  in->setDeviceMesh(mesh);
+  const bool is_rooted = type == CommunicationType::Gather ||
+      type == CommunicationType::Scatter ||
+      type == CommunicationType::Reduce ||
+      type == CommunicationType::Broadcast ||
+      type == CommunicationType::SendRecv;
+  const bool is_reduction = type == CommunicationType::Reduce ||
+      type == CommunicationType::Allreduce ||
+      type == CommunicationType::ReduceScatter;
+  auto* communication = IrBuilder::create<Communication>(
+      type,
+      out,
+      in,
+      team,
+      is_rooted ? root : -1,
+      is_reduction ? c10d::ReduceOp::RedOpType::SUM
+                   : c10d::ReduceOp::RedOpType::UNUSED,
+      /*scattered_axis=*/type == CommunicationType::ReduceScatter ? 1 : -1);
+
+  const bool in_team =
+      std::find(team.begin(), team.end(), my_device) != team.end();
+  c10d::Backend* backend =
+      in_team ? comm.getBackendForTeam(team, backend_type) : nullptr;
+  runIterations(benchmark_state, [&]() {
+    if (!in_team) {
+      return;
+    }
+    auto work = postSingleCommunication(
+        communication, my_device, backend, input, output);
+    if (work != nullptr) {
+      work->wait();
+    }
+  });
+
+  const double bytes = (double)benchmark_state.range(1);
+  benchmark_state.SetBytesProcessed(
+      (int64_t)(bytes * (double)benchmark_state.iterations()));
+  benchmark_state.counters["busbw_GBps"] = benchmark::Counter(
+      bytes * busBandwidthFactor(type, num_ranks) * 1.0e-9 *
+          (double)benchmark_state.iterations(),
+      benchmark::Counter::kIsRate);
+}
+
+namespace {
+
+// c = a @ b, a being sharded on its second axis: [S, DIDx(D), M/(S*D), K]
+std::unique_ptr<Fusion> makeAllgatherMatmul(
+    int64_t num_devices,
+    bool pipelined) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* a = makeContigTensor(4);
+  TensorView* b = makeContigTensor(2);
+  TensorView* c = matmul(a, b);
+  fusion->addInput(a);
+  fusion->addInput(b);
+  fusion->addOutput(c);
+
+  auto mesh = DeviceMesh::createForNumDevices(num_devices);
+  for (auto tv : {a, b, c}) {
+    tv->setDeviceMesh(mesh);
+  }
+  a->axis(1)->parallelize(ParallelType::DIDx);
+  if (pipelined) {
+    c->axis(0)->parallelize(ParallelType::Stream);
+  }
+  return fusion;
+}
+
+// c = sum(a @ b, {1}), reduce-scattered on its third axis:
+// a [S, DIDx(D), D, M/(S*D), K/D], b [DIDx(D), 1, K/D, N]
+std::unique_ptr<Fusion> makeMatmulReduceScatter(
+    int64_t num_devices,
+    bool pipelined) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* a = makeContigTensor(5);
+  TensorView* b = makeContigTensor(4);
+  TensorView* c_unreduced = matmul(a, b);
+  TensorView* c = sum(c_unreduced, {1});
+  fusion->addInput(a);
+  fusion->addInput(b);
+  fusion->addOutput(c);
+
+  auto mesh = DeviceMesh::createForNumDevices(num_devices);
+  for (auto tv : {a, b, c_unreduced, c}) {
+    tv->setDeviceMesh(mesh);
+  }
+  a->axis(1)->parallelize(ParallelType::DIDx);
+  b->axis(0)->parallelize(ParallelType::DIDx);
+  c_unreduced->axis(1)->parallelize(ParallelType::DIDx);
+  c->axis(2)->parallelize(ParallelType::DIDx);
+  if (pipelined) {
+    c->axis(0)->parallelize(ParallelType::Stream);
+  }
+  return fusion;
+}
+
+// Reports the overlap efficiency of a run taking seconds per iteration given
+// the times of its communication and its compute alone
+void reportOverlap(
+    benchmark::State& benchmark_state,
+    double comm_seconds,
+    double compute_seconds,
+    double seconds) {
+  benchmark_state.counters["comm_ms"] = comm_seconds * 1.0e3;
+  benchmark_state.counters["compute_ms"] = compute_seconds * 1.0e3;
+  benchmark_state.counters["overlap_eff"] =
+      (comm_seconds + compute_seconds - seconds) /
+      std::min(comm_seconds, compute_seconds);
+}
+
+constexpr int64_t kStreams = 8;
+constexpr int64_t kOverlapK = 4096;
+constexpr int64_t kOverlapN = 4096;
+
+} // namespace
+
+// The first argument is whether the matmul is pipelined, the second is M
+static void AllgatherMatmul(benchmark::State& benchmark_state) {
+  Communicator& comm = communicator();
+  const bool pipelined = benchmark_state.range(0) != 0;
+  const int64_t M = benchmark_state.range(1);
+  const int64_t D = comm.size();
+  if (M % (D * kStreams) != 0) {
+    benchmark_state.SkipWithError("M must be a multiple of D * S");
+    return;
+  }
+
+  MultiDeviceExecutor executor(makeAllgatherMatmul(D, pipelined), comm);
+  at::Tensor a =
+      at::randn({kStreams, 1, M / (kStreams * D), kOverlapK}, tensorOptions());
+  at::Tensor b = at::randn({kOverlapK, kOverlapN}, tensorOptions());
+  std::vector<c10::IValue> inputs = {a, b};
+
+  at::Tensor a_gathered = at::empty({D * a.numel()}, tensorOptions());
+  at::Tensor a_unsharded =
+      at::randn({kStreams, D, M / (kStreams * D), kOverlapK}, tensorOptions());
+  c10d::Backend* world = comm.getWorld();
+  const double comm_seconds = timeSeconds(
+      [&]() { world->_allgather_base(a_gathered, a.flatten())->wait(); },
+      kIterations);
+  const double compute_seconds = timeSeconds(
+      [&]() { benchmark::DoNotOptimize(at::matmul(a_unsharded, b)); },
+      kIterations);
+
+  runIterations(benchmark_state, [&]() { executor.runWithInput(inputs); });
+  const double seconds =
+      timeSeconds([&]() { executor.runWithInput(inputs); }, kIterations);
+  reportOverlap(benchmark_state, comm_seconds, compute_seconds, seconds);
+}
+
+// The first argument is whether the matmul is pipelined, the second is M
+static void MatmulReduceScatter(benchmark::State& benchmark_state) {
+  Communicator& comm = communicator();
+  const bool pipelined = benchmark_state.range(0) != 0;
+  const int64_t M = benchmark_state.range(1);
+  const int64_t D = comm.size();
+  if (M % (D * kStreams) != 0 || kOverlapK % D != 0) {
+    benchmark_state.SkipWithError(
+        "M must be a multiple of D * S and K a multiple of D");
+    return;
+  }
+
+  MultiDeviceExecutor executor(makeMatmulReduceScatter(D, pipelined), comm);
+  at::Tensor a = at::randn(
+      {kStreams, 1, D, M / (kStreams * D), kOverlapK / D}, tensorOptions());
+  at::Tensor b = at::randn({1, 1, kOverlapK / D, kOverlapN}, tensorOptions());
+  std::vector<c10::IValue> inputs = {a, b};
+
+  at::Tensor c_unreduced = at::matmul(a, b);
+  at::Tensor c = at::empty({c_unreduced.numel() / D}, tensorOptions());
+  c10d::Backend* world = comm.getWorld();
+  const double comm_seconds = timeSeconds(
+      [&]() {
+        world->_reduce_scatter_base(c, c_unreduced.flatten())->wait();
+      },
+      kIterations);
+  const double compute_seconds = timeSeconds(
+      [&]() { benchmark::DoNotOptimize(at::matmul(a, b)); }, kIterations);
+
+  runIterations(benchmark_state, [&]() { executor.runWithInput(inputs); });
+  const double seconds =
+      timeSeconds([&]() { executor.runWithInput(inputs); }, kIterations);
+  reportOverlap(benchmark_state, comm_seconds, compute_seconds, seconds);
+}
+
+namespace {
+
+constexpr int64_t kBatch = 1;
+constexpr int64_t kSequence = 2048;
+constexpr int64_t kEmbedding = 4096;
+constexpr int64_t kHeads = 32;
+
+// Runs a block of DistributedTransformer. make adds the block to the fusion
+// and returns its outputs, given its inputs and whether it is sequence
+// parallel. Linear layers have 4 * E hidden features in the MLP and 3 * E in
+// attention.
+void runTransformerBlock(
+    benchmark::State& benchmark_state,
+    int64_t hidden_multiple,
+    int64_t out_features_divisor,
+    const std::function<std::vector<TensorView*>(
+        DistributedTransformer&,
+        const std::vector<TensorView*>&,
+        const DeviceMesh&,
+        bool)>& make) {
+  Communicator& comm = communicator();
+  const bool sequence_parallel = benchmark_state.range(0) != 0;
+  const int64_t D = comm.size();
+  const int64_t hidden = hidden_multiple * kEmbedding;
+  const int64_t out_features = kEmbedding / out_features_divisor;
+  if (hidden % D != 0 || kHeads % D != 0 ||
+      (sequence_parallel && (D == 1 || (kBatch * kSequence) % D != 0))) {
+    benchmark_state.SkipWithError("Unsupported number of devices");
+    return;
+  }
+
+  DistributedTransformer model(D, kBatch, kEmbedding, kHeads, kSequence);
+  const DataType dtype = DataType::BFloat16;
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  const auto mesh = DeviceMesh::createForNumDevices(D);
+
+  const int64_t tokens = kBatch * kSequence;
+  std::vector<int64_t> x_sizes = sequence_parallel
+      ? std::vector<int64_t>{D, tokens / D, kEmbedding}
+      : std::vector<int64_t>{tokens, kEmbedding};
+  std::vector<TensorView*> inputs = {
+      makeContigConcreteTensor(x_sizes, dtype),
+      makeContigConcreteTensor({D, hidden / D, kEmbedding}, dtype),
+      makeContigConcreteTensor({D, hidden / D}, dtype),
+      makeContigConcreteTensor({D, kEmbedding, out_features / D}, dtype),
+      makeContigConcreteTensor({kEmbedding}, dtype)};
+  for (TensorView* tv : inputs) {
+    fusion->addInput(tv);
+  }
+  for (TensorView* tv : make(model, inputs, mesh, sequence_parallel)) {
+    fusion->addOutput(tv);
+  }
+
+  // Local shards of the inputs
+  const auto options = tensorOptions(at::kBFloat16);
+  x_sizes[0] = sequence_parallel ? 1 : tokens;
+  std::vector<c10::IValue> aten_inputs = {
+      at::randn(x_sizes, options),
+      at::randn({1, hidden / D, kEmbedding}, options),
+      at::randn({1, hidden / D}, options),
+      at::randn({1, kEmbedding, out_features / D}, options),
+      at::randn({kEmbedding}, options)};
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  runIterations(benchmark_state, [&]() {
+    executor_cache.runFusionWithInputs(aten_inputs);
+  });
+}
+
+} // namespace
+
+// The argument is whether the block is sequence parallel
+static void TensorParallelMlp(benchmark::State& benchmark_state) {
+  runTransformerBlock(
+      benchmark_state,
+      /*hidden_multiple=*/4,
+      /*out_features_divisor=*/1,
+      [](DistributedTransformer& model,
+         const std::vector<TensorView*>& in,
+         const DeviceMesh& mesh,
+         bool sequence_parallel) -> std::vector<TensorView*> {
+        auto out = model.mlp(
+            in[0], in[1], in[2], in[3], in[4], mesh, sequence_parallel);
+        TensorView* sharded_until =
+            sequence_parallel ? out.matmul1 : out.output;
+        shardBetween({in[1]}, {sharded_until}, in[1]);
+        shardBetween({in[3]}, {sharded_until}, in[3]);
+        if (sequence_parallel) {
+          shardBetween({out.matmul1}, {out.output}, out.matmul1);
+        }
+        return {out.output};
+      });
+}
+
+// The argument is whether the block is sequence parallel
+static void TensorParallelAttention(benchmark::State& benchmark_state) {
+  runTransformerBlock(
+      benchmark_state,
+      /*hidden_multiple=*/3,
+      /*out_features_divisor=*/4,
+      [](DistributedTransformer& model,
+         const std::vector<TensorView*>& in,
+         const DeviceMesh& mesh,
+         bool sequence_parallel) -> std::vector<TensorView*> {
+        auto out = model.mha(
+            in[0], in[1], in[2], in[3], in[4], mesh, sequence_parallel);
+        TensorView* sharded_until =
+            sequence_parallel ? out.matmul1 : out.output;
+        shardBetween({in[1]}, {sharded_until}, in[1]);
+        shardBetween({in[3]}, {sharded_until}, in[3]);
+        if (sequence_parallel) {
+          shardBetween({out.matmul1}, {out.output}, out.matmul1);
+        }
+        return {out.output};
+      });
+}
+
+#define COMMUNICATION_BENCHMARK(type)                                 \
+  BENCHMARK_CAPTURE(                                                  \
+      Communication_Benchmark, type, CommunicationType::type)         \
+      ->ArgsProduct(                                                  \
+          {{0, 1}, benchmark::CreateRange(1 << 12, 1 << 28, 16)})     \
+      ->Iterations(kIterations)                                       \
+      ->UseManualTime()                                               \
+      ->Unit(benchmark::kMicrosecond)
+
+COMMUNICATION_BENCHMARK(Gather);
+COMMUNICATION_BENCHMARK(Allgather);
+COMMUNICATION_BENCHMARK(Scatter);
+COMMUNICATION_BENCHMARK(Reduce);
+COMMUNICATION_BENCHMARK(Allreduce);
+COMMUNICATION_BENCHMARK(ReduceScatter);
+COMMUNICATION_BENCHMARK(Broadcast);
+COMMUNICATION_BENCHMARK(SendRecv);
+
+BENCHMARK(AllgatherMatmul)
+    ->ArgsProduct({{0, 1}, {4096, 16384}})
+    ->Iterations(kIterations)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(MatmulReduceScatter)
+    ->ArgsProduct({{0, 1}, {4096, 16384}})
+    ->Iterations(kIterations)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(TensorParallelMlp)
+    ->Arg(0)
+    ->Arg(1)
+    ->Iterations(kIterations)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(TensorParallelAttention)
+    ->Arg(0)
+    ->Arg(1)
+    ->Iterations(kIterations)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
+namespace {
+
+// Drops the results of the ranks other than 0
+class NullReporter : public benchmark::BenchmarkReporter {
+ public:
+  bool ReportContext(const Context&) override {
+    return true;
+  }
+  void ReportRuns(const std::vector<Run>&) override {}
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+
+  Communicator& comm = communicator();
+  NVF_CHECK(
+      comm.is_available(),
+      "The communicator is not available. Launch with mpirun.");
+  c10::cuda::set_device((c10::DeviceIndex)comm.local_rank());
+  ::benchmark::AddCustomContext("num_ranks", std::to_string(comm.size()));
+
+  if (comm.deviceId() == 0) {
+    ::benchmark::RunSpecifiedBenchmarks();
+  } else {
+    NullReporter reporter;
+    ::benchmark::RunSpecifiedBenchmarks(&reporter);
+  }
+
+  comm.cleanup();
+  ::benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,91 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <evaluator_common.h>
+#include <fusion.h>
+#include <ir/builder.h>
+#include <ops/all_ops.h>
+#include <runtime/executor_kernel_arg.h>
+
+#include <benchmark/benchmark.h>
+
+#include <ATen/ATen.h>
+
+#include <tests/cpp/utils.h>
+
+#include <vector>
+
+using namespace nvfuser;
+
+namespace {
+
+std::unique_ptr<Fusion> makeLayerNormFusion() {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  constexpr int64_t kNormSize = 1024;
+  auto input = makeSymbolicTensor(3);
+  auto weight = makeSymbolicTensor(1);
+  auto bias = makeSymbolicTensor(1);
+  fusion->addInput(input);
+  fusion->addInput(weight);
+  fusion->addInput(bias);
+
+  auto result = layer_norm(
+      input, {kNormSize}, weight, bias, IrBuilder::create<Val>(1e-5));
+  fusion->addOutput(result.output);
+  fusion->addOutput(result.mean);
+  fusion->addOutput(result.invstd);
+  return fusion;
+}
+
+KernelArgumentHolder makeArgs(int64_t batch_size, int64_t sequence_length) {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  return KernelArgumentHolder::createKernelArgumentHolder(
+      {at::empty({batch_size, sequence_length, 1024}, options),
+       at::empty({1024}, options),
+       at::empty({1024}, options)});
+}
+
+// Alternates between two argument sets and measures binding them and
+// evaluating the whole workspace, i.e., the host work done per launch
+void runPrecomputedValues(
+    benchmark::State& benchmark_state,
+    const std::vector<KernelArgumentHolder>& arg_sets) {
+  auto fusion = makeLayerNormFusion();
+  PrecomputedValues pv(fusion.get());
+
+  int64_t i = 0;
+  for (auto _ : benchmark_state) {
+    pv.bindInputs(arg_sets[i++ % arg_sets.size()]);
+    pv.evaluate();
+  }
+}
+
+} // namespace
+
+// Only the tensors change between launches, so no value is recomputed
+static void PrecomputedValues_SameShapes(benchmark::State& benchmark_state) {
+  runPrecomputedValues(benchmark_state, {makeArgs(8, 512), makeArgs(8, 512)});
+}
+
+// Only the batch size changes, so only the values depending on it are
+// recomputed
+static void PrecomputedValues_NewBatchSize(benchmark::State& benchmark_state) {
+  runPrecomputedValues(benchmark_state, {makeArgs(8, 512), makeArgs(16, 512)});
+}
+
+// Every dynamic size changes, so all the values are recomputed. This is the
+// baseline of a full evaluation.
+static void PrecomputedValues_NewShapes(benchmark::State& benchmark_state) {
+  runPrecomputedValues(benchmark_state, {makeArgs(8, 512), makeArgs(16, 256)});
+}
+
+BENCHMARK(PrecomputedValues_SameShapes)->Unit(benchmark::kNanosecond);
+BENCHMARK(PrecomputedValues_NewBatchSize)->Unit(benchmark::kNanosecond);
+BENCHMARK(PrecomputedValues_NewShapes)->Unit(benchmark::kNanosecond);
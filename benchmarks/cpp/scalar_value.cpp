@@ -0,0 +1,129 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <expr_evaluator.h>
+#include <fusion.h>
+#include <ops/all_ops.h>
+#include <polymorphic_value.h>
+#include <scalar_value.h>
+
+#include <benchmark/benchmark.h>
+
+#include <c10/util/irange.h>
+
+#include <tests/cpp/utils.h>
+
+#include <vector>
+
+using namespace nvfuser;
+
+namespace {
+
+constexpr int64_t kNumValues = 64;
+
+template <typename T>
+std::vector<T> makeValues() {
+  std::vector<T> values;
+  values.reserve(kNumValues);
+  for (auto i : c10::irange(kNumValues)) {
+    values.emplace_back(i);
+  }
+  return values;
+}
+
+} // namespace
+
+static void PolymorphicValue_CopyInt(benchmark::State& benchmark_state) {
+  const auto values = makeValues<PolymorphicValue>();
+  std::vector<PolymorphicValue> copies(kNumValues);
+  for (auto _ : benchmark_state) {
+    for (auto i : c10::irange(kNumValues)) {
+      copies[i] = values[i];
+    }
+    benchmark::DoNotOptimize(copies.data());
+  }
+}
+
+static void ScalarValue_CopyInt(benchmark::State& benchmark_state) {
+  const auto values = makeValues<ScalarValue>();
+  std::vector<ScalarValue> copies(kNumValues);
+  for (auto _ : benchmark_state) {
+    for (auto i : c10::irange(kNumValues)) {
+      copies[i] = values[i];
+    }
+    benchmark::DoNotOptimize(copies.data());
+  }
+}
+
+static void PolymorphicValue_CompareInt(benchmark::State& benchmark_state) {
+  const auto lhs = makeValues<PolymorphicValue>();
+  const auto rhs = makeValues<PolymorphicValue>();
+  for (auto _ : benchmark_state) {
+    for (auto i : c10::irange(kNumValues)) {
+      benchmark::DoNotOptimize(
+          PolymorphicValue_functions::isSame(lhs[i], rhs[i]));
+    }
+  }
+}
+
+static void ScalarValue_CompareInt(benchmark::State& benchmark_state) {
+  const auto lhs = makeValues<ScalarValue>();
+  const auto rhs = makeValues<ScalarValue>();
+  for (auto _ : benchmark_state) {
+    for (auto i : c10::irange(kNumValues)) {
+      benchmark::DoNotOptimize(lhs[i] == rhs[i]);
+    }
+  }
+}
+
+// Evaluates the extents of a tensor the way allocation inference does
+static void ExpressionEvaluator_EvaluateExtents(
+    benchmark::State& benchmark_state,
+    bool evaluate_scalar) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+  TensorView* tv = makeSymbolicTensor(4);
+  fusion.addInput(tv);
+
+  ExpressionEvaluator ee;
+  for (auto i : c10::irange(tv->nDims())) {
+    ee.bind(tv->axis(i)->extent(), (i + 1) * 128);
+  }
+
+  for (auto _ : benchmark_state) {
+    for (auto i : c10::irange(tv->nDims())) {
+      Val* extent = tv->axis(i)->extent();
+      if (evaluate_scalar) {
+        const ScalarValue size = ee.evaluateScalar(extent);
+        benchmark::DoNotOptimize(size.as<int64_t>());
+      } else {
+        const PolymorphicValue size = ee.evaluate(extent);
+        benchmark::DoNotOptimize(size.as<int64_t>());
+      }
+    }
+  }
+}
+
+static void ExpressionEvaluator_EvaluatePolymorphicValue(
+    benchmark::State& benchmark_state) {
+  ExpressionEvaluator_EvaluateExtents(benchmark_state, false);
+}
+
+static void ExpressionEvaluator_EvaluateScalarValue(
+    benchmark::State& benchmark_state) {
+  ExpressionEvaluator_EvaluateExtents(benchmark_state, true);
+}
+
+BENCHMARK(PolymorphicValue_CopyInt)->Unit(benchmark::kNanosecond);
+BENCHMARK(ScalarValue_CopyInt)->Unit(benchmark::kNanosecond);
+BENCHMARK(PolymorphicValue_CompareInt)->Unit(benchmark::kNanosecond);
+BENCHMARK(ScalarValue_CompareInt)->Unit(benchmark::kNanosecond);
+BENCHMARK(ExpressionEvaluator_EvaluatePolymorphicValue)
+    ->Unit(benchmark::kNanosecond);
+BENCHMARK(ExpressionEvaluator_EvaluateScalarValue)
+    ->Unit(benchmark::kNanosecond);
@@ -0,0 +1,93 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <fusion.h>
+#include <fusion_segmenter.h>
+#include <ir/all_nodes.h>
+#include <ir/builder.h>
+#include <ops/all_ops.h>
+#include <runtime/executor_kernel_arg.h>
+
+#include <benchmark/benchmark.h>
+
+#include <ATen/ATen.h>
+#include <c10/util/irange.h>
+
+#include <vector>
+
+#include <tests/cpp/utils.h>
+
+using namespace nvfuser;
+
+namespace {
+
+// Stack of bias-dropout-add-layer_norm blocks, each followed by a reduction
+// across the batch dimension. Mixing inner and outer reductions keeps any
+// single scheduler from taking more than one block, so the segmenter has to
+// try many merges.
+void setupStackedNorms(Fusion* fusion, int64_t num_layers) {
+  FusionGuard fg(fusion);
+
+  auto x = makeContigTensor(2);
+  fusion->addInput(x);
+
+  for (auto i : c10::irange(num_layers)) {
+    (void)i; // Suppress unused variable warning
+    auto bias = makeContigTensor(1);
+    auto weight = makeContigTensor(1);
+    auto ln_bias = makeContigTensor(1);
+    fusion->addInput(bias);
+    fusion->addInput(weight);
+    fusion->addInput(ln_bias);
+
+    auto tv = add(x, broadcast(bias, {true, false}));
+    tv = dropout(tv, IrBuilder::create<Val>(0.9)).output;
+    tv = add(tv, x);
+    tv = layer_norm(tv, 1, weight, ln_bias, IrBuilder::create<Val>(1e-5))
+             .output;
+    fusion->addOutput(tv);
+
+    auto col_sum = sum(tv, {0}, /*keep_dim=*/true);
+    x = sub(tv, col_sum);
+  }
+  fusion->addOutput(x);
+}
+
+std::vector<c10::IValue> makeStackedNormsInputs(int64_t num_layers) {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<c10::IValue> inputs;
+  inputs.emplace_back(at::randn({1024, 1024}, options));
+  for (auto i : c10::irange(3 * num_layers)) {
+    (void)i; // Suppress unused variable warning
+    inputs.emplace_back(at::randn({1024}, options));
+  }
+  return inputs;
+}
+
+} // namespace
+
+static void Segmenter_StackedNorms(benchmark::State& benchmark_state) {
+  const int64_t num_layers = benchmark_state.range(0);
+  Fusion fusion;
+  setupStackedNorms(&fusion, num_layers);
+
+  auto args = KernelArgumentHolder::createKernelArgumentHolder(
+      makeStackedNormsInputs(num_layers));
+
+  int64_t num_groups = 0;
+  for (auto _ : benchmark_state) {
+    auto segmented_fusion = SegmentCandidateFinder::segment(&fusion, &args);
+    num_groups = (int64_t)segmented_fusion->groups().size();
+  }
+  benchmark_state.counters["groups"] = (double)num_groups;
+}
+
+BENCHMARK(Segmenter_StackedNorms)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->Unit(benchmark::kMillisecond);
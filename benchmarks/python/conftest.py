@@ -61,6 +61,13 @@ def pytest_addoption(parser):
         help="Number of inputs to randomly sample for each benchmark.",
     )
 
+    parser.addoption(
+        "--serving-trace",
+        action="store",
+        default=None,
+        help="CSV file of the batch and seqlen of each request replayed by the serving benchmarks. A synthetic trace is used by default.",
+    )
+
 
 @pytest.fixture
 def disable_validation(request):
@@ -72,6 +79,11 @@ def disable_benchmarking(request):
     return request.config.getoption("--disable-benchmarking")
 
 
+@pytest.fixture
+def serving_trace_file(request):
+    return request.config.getoption("--serving-trace")
+
+
 def pytest_make_parametrize_id(val, argname):
     if isinstance(val, tuple):
         return f'{argname}=[{"_".join(str(v) for v in val)}]'
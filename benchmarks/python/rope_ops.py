@@ -987,6 +987,63 @@ def hf_mistral_nemo_rope():
     return MistralNemoRope(cfg).cuda().bfloat16(), inputs, grads, iobytes
 
 
+# Only the rotate-half part of RoPE on an already laid out query, without the
+# reshapes and permutes of the models, so the kernel should run at pointwise
+# bandwidth. The resize scheduler splits the rotated dimension into its halves
+# with NVFUSER_ENABLE=resize_scheduler.
+def apply_rope_only():
+    batches, n_head, seq_length, head_size = 2, 32, 4096, 128
+
+    class ApplyRope(torch.nn.Module):
+        def forward(self, q, cos, sin):
+            return (apply_rope(q, cos, sin),)
+
+    def inputs():
+        q = torch.randn(
+            batches,
+            n_head,
+            seq_length,
+            head_size,
+            device="cuda",
+            dtype=torch.bfloat16,
+            requires_grad=True,
+        )
+        cos = torch.randn(
+            seq_length,
+            head_size,
+            device="cuda",
+            dtype=torch.bfloat16,
+            requires_grad=False,
+        )
+        sin = torch.randn(
+            seq_length,
+            head_size,
+            device="cuda",
+            dtype=torch.bfloat16,
+            requires_grad=False,
+        )
+        return q, cos, sin
+
+    def grads():
+        return torch.randn(
+            batches,
+            n_head,
+            seq_length,
+            head_size,
+            device="cuda",
+            dtype=torch.bfloat16,
+            requires_grad=False,
+        )
+
+    def iobytes():
+        # q.grad, the output grad, cos and sin
+        n_elements = 2 * batches * n_head * seq_length * head_size
+        n_elements += 2 * seq_length * head_size
+        return n_elements * torch.bfloat16.itemsize
+
+    return ApplyRope().cuda(), inputs, grads, iobytes
+
+
 # The setup returns a function that would setup benchmark by returning:
 #    fwd_model, inputs_fn, grads_fn, iobytes_fn
 rope_setup = {
@@ -995,4 +1052,5 @@ rope_setup = {
     "hf_qwen2_rope": hf_qwen2_rope,
     "hf_phi3_rope": hf_phi3_rope,
     "hf_mistral_nemo_rope": hf_mistral_nemo_rope,
+    "apply_rope_only": apply_rope_only,
 }
@@ -15,6 +15,7 @@ from .rope_ops import rope_setup
         "hf_qwen2_rope",
         "hf_phi3_rope",
         "hf_mistral_nemo_rope",
+        "apply_rope_only",
     ],
 )
 @pytest.mark.parametrize(
@@ -49,6 +50,7 @@ def test_rope_fwd_benchmark(
         "hf_qwen2_rope",
         "hf_phi3_rope",
         "hf_mistral_nemo_rope",
+        "apply_rope_only",
     ],
 )
 @pytest.mark.parametrize(
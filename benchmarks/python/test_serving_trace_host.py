@@ -0,0 +1,197 @@
+# SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+# All rights reserved.
+# SPDX-License-Identifier: BSD-3-Clause
+import csv
+import time
+
+import numpy as np
+import pytest
+import torch
+from nvfuser import FusionCache, FusionDefinition, DataType
+
+HIDDEN_SIZE = 1024
+TRACE_LENGTH = 512
+PERCENTILES = [50, 99]
+
+# Features that reduce the latency of dynamic shapes, enabled one at a time
+# and then all together
+SERVING_CONFIGS = {
+    "baseline": {},
+    "shape_buckets": {"shape_buckets": True},
+    "async_compile": {"async_compile": True},
+    "fast_execute": {"execute_by_id": True},
+    "all": {"shape_buckets": True, "async_compile": True, "execute_by_id": True},
+}
+
+
+def serving_fusion(fd: FusionDefinition, eps: float = 1e-5) -> None:
+    # RMSNorm followed by SiLU of the [batch, seqlen, hidden] activations of a
+    # request, whose batch and seqlen vary from a request to another
+    T0 = fd.define_tensor(
+        shape=[-1, -1, -1],
+        contiguity=[True, True, True],
+        dtype=DataType.BFloat16,
+        is_cpu=False,
+    )
+    T1 = fd.define_tensor(
+        shape=[-1], contiguity=[True], dtype=DataType.BFloat16, is_cpu=False
+    )
+    T2 = fd.ops.cast(T0, dtype=DataType.Float)
+    T3 = fd.ops.cast(T1, dtype=DataType.Float)
+    T4 = fd.ops.mul(T2, T2)
+    T5 = fd.ops.sum(T4, dims=[2], keepdim=False, dtype=DataType.Null)
+    V6 = fd.define_vector([T0.size(0), T0.size(1), 1], dtype=DataType.Int)
+    T7 = fd.ops.broadcast_in_dim(T5, shape=V6, broadcast_dims=[0, 1])
+    S8 = fd.ops.reciprocal(T0.size(2))
+    T9 = fd.ops.mul(T7, S8)
+    S10 = fd.define_scalar(eps, dtype=DataType.Double)
+    T11 = fd.ops.add(T9, S10)
+    T12 = fd.ops.rsqrt(T11)
+    T13 = fd.ops.broadcast_in_dim(T12, shape=T0.shape(), broadcast_dims=[0, 1, 2])
+    T14 = fd.ops.mul(T2, T13)
+    T15 = fd.ops.broadcast_in_dim(T3, shape=T0.shape(), broadcast_dims=[2])
+    T16 = fd.ops.mul(T14, T15)
+    T17 = fd.ops.sigmoid(T16)
+    T18 = fd.ops.mul(T16, T17)
+    T19 = fd.ops.cast(T18, dtype=DataType.BFloat16)
+    fd.add_output(T19)
+
+
+def serving_reference(x: torch.Tensor, weight: torch.Tensor, eps: float = 1e-5):
+    x = x.float()
+    y = x * torch.rsqrt(x.pow(2).mean(-1, keepdim=True) + eps) * weight.float()
+    return torch.nn.functional.silu(y).bfloat16()
+
+
+def synthetic_trace(length: int = TRACE_LENGTH, seed: int = 0) -> list:
+    # Small batches dominate, and sequence lengths follow a log-normal
+    # distribution, so that most requests have a shape not seen before
+    rng = np.random.default_rng(seed)
+    batches = rng.choice([1, 2, 4, 8, 16], size=length, p=[0.4, 0.25, 0.15, 0.12, 0.08])
+    seqlens = np.clip(rng.lognormal(np.log(256), 1.0, size=length), 16, 4096)
+    return list(zip(batches.tolist(), seqlens.astype(int).tolist()))
+
+
+def read_trace(path: str) -> list:
+    # A CSV file with a header naming the batch and seqlen columns
+    with open(path, newline="") as f:
+        return [(int(row["batch"]), int(row["seqlen"])) for row in csv.DictReader(f)]
+
+
+def replay_trace(fd: FusionDefinition, trace: list, execute_by_id: bool) -> list:
+    """
+    Executes fd once per request of the trace and times each request from the
+    call until its outputs are ready. The time in the call is a compile stall
+    when the request created a kernel runtime and host overhead otherwise. The
+    rest is spent waiting for the GPU.
+    """
+    weight = torch.randn(HIDDEN_SIZE, device="cuda", dtype=torch.bfloat16)
+    latencies = []
+    for batch, seqlen in trace:
+        inputs = [
+            torch.randn(
+                batch, seqlen, HIDDEN_SIZE, device="cuda", dtype=torch.bfloat16
+            ),
+            weight,
+        ]
+        torch.cuda.synchronize()
+        created_runtimes = fd.runtime_cache_stats()["created_runtimes"]
+
+        start = time.perf_counter()
+        if execute_by_id:
+            FusionDefinition.execute_by_id(fd.id(), inputs)
+        else:
+            fd.execute(inputs)
+        returned = time.perf_counter()
+        torch.cuda.synchronize()
+        end = time.perf_counter()
+
+        call_ms = (returned - start) * 1e3
+        compiled = fd.runtime_cache_stats()["created_runtimes"] > created_runtimes
+        latencies.append(
+            {
+                "e2e": (end - start) * 1e3,
+                "host": 0.0 if compiled else call_ms,
+                "compile_stall": call_ms if compiled else 0.0,
+                "gpu": (end - returned) * 1e3,
+            }
+        )
+    return latencies
+
+
+def report_latencies(benchmark, latencies: list, start_stats: dict, stats: dict):
+    for key in ["e2e", "host", "compile_stall", "gpu"]:
+        values = np.array([latency[key] for latency in latencies])
+        for percentile in PERCENTILES:
+            benchmark.extra_info[f"{key}_p{percentile}_ms"] = float(
+                np.percentile(values, percentile)
+            )
+        benchmark.extra_info[f"{key}_total_ms"] = float(values.sum())
+
+    hits, misses, created = (
+        stats[key] - start_stats[key]
+        for key in ["runtime_hits", "runtime_misses", "created_runtimes"]
+    )
+    benchmark.extra_info["requests"] = len(latencies)
+    # Lookups whose inputs were seen before
+    benchmark.extra_info["runtime_hit_rate"] = hits / max(hits + misses, 1)
+    # Missed lookups served by an existing runtime instead of a new one
+    benchmark.extra_info["runtime_reuse_rate"] = (misses - created) / max(misses, 1)
+    benchmark.extra_info["compiled_runtimes"] = created
+    benchmark.extra_info["compile_stalls"] = sum(
+        latency["compile_stall"] > 0 for latency in latencies
+    )
+
+
+@pytest.mark.parametrize("config", SERVING_CONFIGS.keys())
+def test_serving_trace_benchmark(
+    benchmark,
+    config: str,
+    serving_trace_file: str,
+    disable_validation: bool,
+    disable_benchmarking: bool,
+):
+    trace = (
+        synthetic_trace()
+        if serving_trace_file is None
+        else read_trace(serving_trace_file)
+    )
+    features = SERVING_CONFIGS[config]
+
+    def define_fusion():
+        with FusionDefinition() as fd:
+            serving_fusion(fd)
+        if features.get("shape_buckets", False):
+            # Bucket the batch and seqlen of the activations
+            fd.set_shape_bucket_policy([(0, 0), (0, 1)])
+        fd.set_async_compilation(features.get("async_compile", False))
+        return fd
+
+    # Also initializes the process, e.g., loads NVRTC, so that the first
+    # request isn't charged with it
+    FusionCache.reset()
+    fd = define_fusion()
+    weight = torch.randn(HIDDEN_SIZE, device="cuda", dtype=torch.bfloat16)
+    for batch, seqlen in [trace[0], max(trace)]:
+        x = torch.randn(batch, seqlen, HIDDEN_SIZE, device="cuda", dtype=torch.bfloat16)
+        if disable_validation:
+            fd.execute([x, weight])
+        else:
+            fd.validate([x, weight], [serving_reference(x, weight)])
+
+    if not disable_benchmarking:
+
+        def serve():
+            # A server starts cold, so the compile stalls of the trace are part
+            # of its latency
+            FusionCache.reset()
+            fd = define_fusion()
+            start_stats = fd.runtime_cache_stats()
+            latencies = replay_trace(
+                fd, trace, execute_by_id=features.get("execute_by_id", False)
+            )
+            report_latencies(
+                benchmark, latencies, start_stats, fd.runtime_cache_stats()
+            )
+
+        benchmark.pedantic(serve, rounds=1, iterations=1, warmup_rounds=0)
@@ -5,6 +5,8 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
+#include <algorithm>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -171,6 +173,10 @@ void AliasFinder::handle(const ViewOp* view) {
   std::optional<Layout> out_root_layout =
       mapInLayoutToOutRoot(analysis_.preferredLayout(in), in, out);
   if (!out_root_layout.has_value()) {
+    analysis_.addCopyReason(
+        out,
+        "the allocation domain of the input is not a permutation of its "
+        "logical domain");
     return;
   }
 
@@ -182,6 +188,10 @@ void AliasFinder::handle(const ViewOp* view) {
       // broadcast IterDomain from `in_logical` when `view` splits or merges
       // that IterDomain. We return no alias when this happen; otherwise
       // AliasTest.MergeBroadcastsBetweenConcretes would fail.
+      analysis_.addCopyReason(
+          out,
+          "the root domain materializes the expanded broadcast " +
+              out_root_layout->allocation_domain[i]->toString());
       return;
     }
     allocation_to_contiguity.pushBack(
@@ -208,9 +218,22 @@ void AliasFinder::handle(const ViewOp* view) {
     } else if (Merge* merge = dynamic_cast<Merge*>(transform)) {
       const auto [outer_contiguity, inner_i] =
           allocation_to_contiguity.erase(merge->outer());
-      if (inner_i == allocation_to_contiguity.end() ||
-          inner_i->first != merge->inner()) {
+      // Size-1 broadcasts between outer and inner don't have a stride to
+      // keep, so they are left in front of the merged IterDomain.
+      auto broadcast_i = inner_i;
+      while (broadcast_i != allocation_to_contiguity.end() &&
+             broadcast_i->first != merge->inner() &&
+             broadcast_i->first->isBroadcast() &&
+             !broadcast_i->first->hasExpandedExtent()) {
+        ++broadcast_i;
+      }
+      if (broadcast_i == allocation_to_contiguity.end() ||
+          broadcast_i->first != merge->inner()) {
         // Outer and inner are not adjacent in allocation order.
+        analysis_.addCopyReason(
+            out,
+            merge->outer()->toString() + " and " + merge->inner()->toString() +
+                " are merged but not adjacent in allocation order");
         return;
       }
       const auto [inner_contiguity, merge_i] =
@@ -221,6 +244,10 @@ void AliasFinder::handle(const ViewOp* view) {
           merge->inner()->hasExpandedExtent(),
           inner_contiguity);
       if (!mergeable) {
+        analysis_.addCopyReason(
+            out,
+            merge->outer()->toString() + " and " + merge->inner()->toString() +
+                " are merged but their strides can't be one stride");
         return;
       }
       allocation_to_contiguity.insert(merge_i, merge->out(), contiguity);
@@ -419,6 +446,20 @@ TensorView* AliasAnalysisResult::getRoot(const TensorView* alias) const {
   return getOrDefault(alias_to_root_, alias);
 }
 
+void AliasAnalysisResult::addCopyReason(
+    const TensorView* tv,
+    std::string reason) {
+  copy_reasons_.emplace_back(tv, std::move(reason));
+}
+
+std::string AliasAnalysisResult::copyReason(const TensorView* tv) const {
+  auto i = std::find_if(
+      copy_reasons_.begin(), copy_reasons_.end(), [&](const auto& entry) {
+        return entry.first == tv;
+      });
+  return i == copy_reasons_.end() ? "" : i->second;
+}
+
 namespace {
 bool okToRelayout(
     const TensorView* tv,
@@ -438,6 +479,13 @@ void AliasAnalysisResult::finalize(
 
     if (!okToRelayout(
             alias, preferred_layout, can_override_empty_allocation_domain)) {
+      if (alias->definition() != nullptr &&
+          alias->definition()->isA<ViewOp>()) {
+        addCopyReason(
+            alias,
+            "the layout " + preferred_layout.toString() +
+                " of the alias is incompliant with its allocation domain");
+      }
       continue;
     }
 
@@ -492,6 +540,13 @@ std::string AliasAnalysisResult::toString(const int indent_size) const {
         << "] is a transitive alias of " << ir_utils::varName(root)
         << std::endl;
   }
+  if (!copy_reasons_.empty()) {
+    indent(ss, indent_size) << "Reshapes that need a copy:" << std::endl;
+    for (const auto& [tv, reason] : copy_reasons_) {
+      indent(ss, indent_size + 1)
+          << ir_utils::varName(tv) << " because " << reason << std::endl;
+    }
+  }
   return ss.str();
 }
 
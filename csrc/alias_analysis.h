@@ -70,6 +70,14 @@ class AliasAnalysisResult {
   // Returns the mapped value in `alias_to_root_` or null.
   TensorView* getRoot(const TensorView* alias) const;
 
+  // Records why the output of a reshape can't be an alias of its input, so
+  // the reshape needs a copy.
+  void addCopyReason(const TensorView* tv, std::string reason);
+
+  // Returns why `tv`, the output of a reshape, needs a copy, or an empty
+  // string if no reason was recorded.
+  std::string copyReason(const TensorView* tv) const;
+
  private:
   // Maps an alias (e.g. the output of a `ViewOp`) to its direct source (e.g.
   // the input of the same `ViewOp`). Also stores the preferred output layout
@@ -82,6 +90,9 @@ class AliasAnalysisResult {
   // Maps an alias to its "highest ancestor" according to `alias_to_source_`,
   // if its preferred layout is compliant with its actual layout.
   std::unordered_map<const TensorView*, TensorView*> alias_to_root_;
+
+  // Reasons recorded by `addCopyReason` in the order they were found.
+  std::vector<std::pair<const TensorView*, std::string>> copy_reasons_;
 };
 
 // Finds aliases of the fusion inputs. The analysis should be conservative --
@@ -8,6 +8,7 @@
 #include <codegen.h>
 #include <device_lower/utils.h>
 #include <instrumentation.h>
+#include <iter_visitor.h>
 #include <ir/utils.h>
 #include <kernel_ir.h>
 #include <kernel_ir_dispatch.h>
@@ -18,6 +19,7 @@
 
 #include <array>
 #include <cmath>
+#include <optional>
 #include <sstream>
 #include <typeindex>
 #include <vector>
@@ -159,8 +161,9 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
   static std::string generateKernelDefinition(
       const kir::Kernel* kernel,
       const std::string& kernel_name,
-      std::optional<int64_t> num_threads_per_cta) {
-    CudaKernelGenerator codegen(kernel);
+      std::optional<int64_t> num_threads_per_cta,
+      std::optional<BlockDimSpecialization> block_dim) {
+    CudaKernelGenerator codegen(kernel, block_dim);
     codegen.genDeclaration(kernel_name, num_threads_per_cta);
     codegen.startBlock();
     codegen.genPrologue();
@@ -170,8 +173,29 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     return codegen.code_.str();
   }
 
+  static KernelStage generateKernelStage(
+      const kir::Kernel* kernel,
+      const std::string& stage_name) {
+    CudaKernelGenerator codegen(kernel, /*block_dim=*/std::nullopt);
+    codegen.as_stage_ = true;
+    codegen.genDeclaration(stage_name, /*num_threads_per_cta=*/std::nullopt);
+    codegen.startBlock();
+    codegen.genPrologue();
+    codegen.genBody();
+    codegen.endBlock();
+    NVF_CHECK(codegen.block_nest_level_ == 0);
+    return {codegen.code_.str(), std::move(codegen.param_types_)};
+  }
+
  private:
-  explicit CudaKernelGenerator(const kir::Kernel* kernel) : kernel_(kernel) {
+  CudaKernelGenerator(
+      const kir::Kernel* kernel,
+      std::optional<BlockDimSpecialization> block_dim)
+      : kernel_(kernel), block_dim_(block_dim) {
+    NVF_ERROR(
+        !block_dim_.has_value() ||
+            !kernel_->summary().parallel_dimension_map.hasWarpSpecialization(),
+        "Warp specialized kernels can't be specialized for a block size");
     initStringStreamFormat(code_);
   }
 
@@ -218,8 +242,31 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     }
   }
 
+  // Returns the fixed extent of a thread dimension of a kernel specialized
+  // for a block size
+  int64_t staticBlockDim(ParallelType pt) const {
+    NVF_ERROR(block_dim_.has_value());
+    switch (pt) {
+      case ParallelType::TIDx:
+        return block_dim_->dims[0];
+      case ParallelType::TIDy:
+        return block_dim_->dims[1];
+      case ParallelType::TIDz:
+        return block_dim_->dims[2];
+      default:
+        NVF_THROW("Not a thread dimension: ", pt);
+    }
+  }
+
   std::string genVariableName(const Val* v) {
     if (auto ns = dynamic_cast<const NamedScalar*>(v)) {
+      // The block dimensions of a specialized kernel are constants
+      if (block_dim_.has_value() && ns->getParallelDim().has_value() &&
+          isParallelTypeThreadDim(ns->getParallelDim().value())) {
+        return "((nvfuser_index_t)" +
+            std::to_string(staticBlockDim(ns->getParallelDim().value())) +
+            ")";
+      }
       // dim3 components are unsigned int. Cast to signed integer to
       // support negative indexing
       if (ns->getParallelIndex().has_value() ||
@@ -276,7 +323,15 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
   void genDeclaration(
       const std::string& kernel_name,
       std::optional<int64_t> num_threads_per_cta) {
-    code_ << "__global__ void ";
+    if (as_stage_) {
+      NVF_ERROR(
+          !kernel_->hasManaged("enable_register_sharing") &&
+              !kernel_->hasManaged("cluster_dims"),
+          "The launch attributes of a kernel can't apply to a stage");
+      code_ << "__device__ __forceinline__ void ";
+    } else {
+      code_ << "__global__ void ";
+    }
     if (kernel_->hasManaged("enable_register_sharing") &&
         kernel_->getManaged<bool>("enable_register_sharing")) {
       NVF_ERROR(
@@ -284,6 +339,10 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
           "__launch_bounds__ must be set for register sharing warp specialization");
       code_ << "__launch_bounds__(/*MAX_THREADS_PER_BLOCK=*/"
             << num_threads_per_cta.value() << ") ";
+    } else if (block_dim_.has_value()) {
+      code_ << "__launch_bounds__(/*MAX_THREADS_PER_BLOCK=*/"
+            << block_dim_->numThreads() << ", /*MIN_BLOCKS_PER_SM=*/"
+            << block_dim_->min_blocks_per_sm << ") ";
     }
     if (kernel_->hasManaged("cluster_dims")) {
       auto cluster_dims =
@@ -319,27 +378,37 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
         var_name_ss << "_duplicate_" << duplicate_counter++;
       }
 
+      std::stringstream type_ss;
       if (const auto tv = dynamic_cast<TensorView*>(param)) {
         if (tv->isCpuScalar()) {
-          code_ << " CpuScalarTensor<" << param->dtype() << "> "
-                << var_name_ss.str();
+          type_ss << "CpuScalarTensor<" << param->dtype() << ">";
         } else {
-          code_ << "Tensor<" << param->dtype() << ", "
-                << TensorDomain::noReductions(tv->getLogicalDomain()).size()
-                << ", "
-                << TensorDomain::noReductions(tv->getMaybeAllocationDomain())
-                       .size()
-                << "> " << var_name_ss.str();
+          // Sizes and strides the kernel never reads are not passed
+          const auto& summary = kernel_->summary();
+          const size_t dim =
+              summary.params_without_logical_size.count(tv)
+              ? 0
+              : TensorDomain::noReductions(tv->getLogicalDomain()).size();
+          const size_t alloc_dim =
+              summary.params_without_alloc_stride.count(tv)
+              ? 0
+              : TensorDomain::noReductions(tv->getMaybeAllocationDomain())
+                    .size();
+          type_ss << "Tensor<" << param->dtype() << ", " << dim << ", "
+                  << alloc_dim << ">";
         }
       } else {
         NVF_ERROR(param->isScalar()); // NOLINT (LLVM bug 48525)
         if (isTmaType(param->dtype())) {
-          code_ << "const __grid_constant__ " << param->dtype() << " "
-                << var_name_ss.str();
+          NVF_ERROR(
+              !as_stage_, "TMA descriptors can only be kernel parameters");
+          type_ss << "const __grid_constant__ " << param->dtype();
         } else {
-          code_ << param->dtype() << " " << var_name_ss.str();
+          type_ss << param->dtype();
         }
       }
+      code_ << type_ss.str() << " " << var_name_ss.str();
+      param_types_.push_back(type_ss.str());
 
       if (i + 1 != kernel_->parameters().size()) {
         code_ << ", ";
@@ -357,10 +426,14 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
   void genPrologue() {
     const auto& kernel_summary = kernel_->summary();
 
-    if (kernel_summary.has_philox_op) {
-      indent() << "uint4 rng_result;\n";
-      indent() << "nvfuser_index_t rng_subseq = -1;\n";
-      indent() << "nvfuser_index_t rng_offset = -1;\n";
+    // Each RNG op keeps the Philox result of its current 4-element group, so
+    // that RNG ops interleaved in a loop don't recompute each other's results
+    for (const RNGOp* rop : kernel_summary.rng_ops) {
+      indent() << "uint4 rng_result" << rop->name() << ";\n";
+      indent() << "nvfuser_index_t rng_cached_subseq" << rop->name()
+               << " = -1;\n";
+      indent() << "nvfuser_index_t rng_cached_offset" << rop->name()
+               << " = -1;\n";
     }
 
     // Do we have any dynamic shared memory buffers?
@@ -393,8 +466,11 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
           smem_buf_size_ss << bdimx << " * " << bdimy << " * " << bdimz
                            << " * sizeof("
                            << kernel_summary.largest_smem_data_type << ")";
-          if (has_parallel_welford) {
+          if (kernel_summary.has_block_welford_with_smem_n ||
+              kernel_summary.has_grid_welford) {
             smem_buf_size_ss << " * 3";
+          } else if (kernel_summary.has_block_welford) {
+            smem_buf_size_ss << " * 2";
           }
           std::string smem_buf_size = smem_buf_size_ss.str();
           if (kernel_summary.has_outer_grouped_grid_welford) {
@@ -413,8 +489,13 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
         if (has_parallel_welford) {
           // Unpack shared mem pointer
           auto space_type = kernel_summary.largest_smem_data_type;
-          indent()
-              << "nvfuser_index_t block_size = blockDim.x*blockDim.y*blockDim.z;\n";
+          if (block_dim_.has_value()) {
+            indent() << "nvfuser_index_t block_size = "
+                     << block_dim_->numThreads() << ";\n";
+          } else {
+            indent() << "nvfuser_index_t block_size = "
+                     << "blockDim.x*blockDim.y*blockDim.z;\n";
+          }
           indent() << space_type << " *shared_mem_var = "
                    << "static_cast<" << space_type << "*>("
                    << "shared_mem);\n";
@@ -861,13 +942,17 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
              << " = linear_index" << rop->name() << " % " << multiple << ";\n";
     indent() << "nvfuser_index_t rng_offset" << rop->name() << " = "
              << genInline(rop->getRNGOffsetVal()) << ";\n";
-    indent() << "if (rng_subseq != rng_subseq" << rop->name()
-             << " || rng_offset != rng_offset" << rop->name() << ") {\n";
-    indent() << "  rng_result = philox(" << genInline(rop->getRNGSeedVal())
-             << ", rng_subseq" << rop->name() << ", "
+    indent() << "if (rng_cached_subseq" << rop->name() << " != rng_subseq"
+             << rop->name() << " || rng_cached_offset" << rop->name()
+             << " != rng_offset" << rop->name() << ") {\n";
+    indent() << "  rng_result" << rop->name() << " = philox("
+             << genInline(rop->getRNGSeedVal()) << ", rng_subseq"
+             << rop->name() << ", "
              << "rng_offset" << rop->name() << ");\n";
-    indent() << "  rng_subseq = rng_subseq" << rop->name() << ";\n";
-    indent() << "  rng_offset = rng_offset" << rop->name() << ";\n";
+    indent() << "  rng_cached_subseq" << rop->name() << " = rng_subseq"
+             << rop->name() << ";\n";
+    indent() << "  rng_cached_offset" << rop->name() << " = rng_offset"
+             << rop->name() << ";\n";
     indent() << "}\n";
     auto op_type = rop->getRNGOpType();
     indent() << gen(rop->output(0)) << " = " << op_type;
@@ -881,7 +966,7 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
       }
       // Generate other datatypes in double
     }
-    code_ << "(rng_result, rng_component" << rop->name();
+    code_ << "(rng_result" << rop->name() << ", rng_component" << rop->name();
     switch (op_type) {
       case RNGOpType::UniformRange:
       case RNGOpType::NormalGeneral: {
@@ -1209,20 +1294,6 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     }
   }
 
-  void handle(const IndexSelectOp* sop) final {
-    // generate code
-    if (!print_inline_) {
-      indent() << gen(sop->output(0));
-      if (!sop->output(0)->isScalar()) {
-        code_ << "\n";
-        indent() << kTab;
-      }
-      code_ << " = ";
-    }
-
-    code_ << gen(sop->input(0)) << ";\n";
-  }
-
   void handle(const ScatterOp* sop) final {
     // generate code like T_output[... T_index[...]] = op(T_src[...]);
     if (sop->getScatterOpType() == ScatterOpType::Set) {
@@ -1237,7 +1308,10 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
   std::string genComputeBlockDim() {
     std::stringstream ss;
     const auto& pdim_map = kernel_->summary().parallel_dimension_map;
-    if (!pdim_map.hasWarpSpecialization()) {
+    if (block_dim_.has_value()) {
+      ss << "StaticBlockDim<" << block_dim_->dims[0] << ", "
+         << block_dim_->dims[1] << ", " << block_dim_->dims[2] << ">()";
+    } else if (!pdim_map.hasWarpSpecialization()) {
       ss << "DefaultBlockDim()";
     } else {
       ss << "dim3("
@@ -1538,6 +1612,44 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     }
   }
 
+  // Block welford whose input N is uniform across the block. N is
+  // computed from the reduction tree rather than loaded from shared
+  // memory, and the op is never predicated, so there is no read
+  // predicate or init value to pass.
+  void genBlockWelfordUniformN(
+      const WelfordOp* wop,
+      const ArgumentBuilder& template_args,
+      const std::string& out_avg,
+      const std::string& out_var,
+      const std::string& out_n) {
+    const auto data_type = wop->outAvg()->dtype();
+    const auto index_type = wop->outN()->dtype();
+
+    ArgumentBuilder func_args;
+    func_args.arg(out_avg);
+    func_args.arg(out_var);
+    func_args.arg(out_n);
+    func_args.arg(gen(wop->inAvg()));
+    if (wop->inVar()->isZeroInt()) {
+      func_args.arg(genStaticCast(data_type, gen(wop->inVar())));
+    } else {
+      func_args.arg(gen(wop->inVar()));
+    }
+    func_args.arg(genStaticCast(index_type, gen(wop->inN())));
+    func_args.arg(genReinterpretCast(genPtrType(data_type), "shared_mem_avg"));
+    func_args.arg(genReinterpretCast(genPtrType(data_type), "shared_mem_var"));
+    if (wop->writePredicate() != nullptr) {
+      NVF_ERROR(wop->writePredicate()->hasValue());
+      func_args.arg(genInline(wop->writePredicate()));
+    } else {
+      func_args.arg("true");
+    }
+    func_args.arg(genComputeBlockDim());
+
+    indent() << genCall("blockWelfordUniformN", template_args, func_args)
+             << ";\n";
+  }
+
   void genBlockWelford(const WelfordOp* wop) {
     NVF_ERROR(
         ir_utils::getTvOutput(wop)->domain()->hasBlockReduction(),
@@ -1591,6 +1703,11 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     template_args.arg(tidx).arg(tidy).arg(tidz);
     template_args.arg(isAligned());
 
+    if (lower_utils::hasUniformWelfordInputN(wop)) {
+      genBlockWelfordUniformN(wop, template_args, out_avg, out_var, out_n);
+      return;
+    }
+
     ArgumentBuilder func_args;
     func_args.arg(out_avg);
     func_args.arg(out_var);
@@ -1792,11 +1909,34 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     const bool persistent_sync =
         kernel_->summary().has_cooperative_grid_reduction;
 
+    if (kernel_->hasManaged("cluster_reduction") &&
+        kernel_->getManaged<bool>("cluster_reduction")) {
+      NVF_ERROR(
+          !persistent_sync,
+          "Cluster reductions can't be used in persistent kernels: ",
+          grop->toString());
+      generateClusterReduction(grop, flags_str);
+      return;
+    }
+
+    // Nothing needs the result in the last block along the reduced
+    // dimensions when nothing in the kernel reads the output, so the last
+    // block to arrive can finish the reduction instead
+    const bool is_last_arrival = !persistent_sync &&
+        out->view()->getMemoryType() == MemoryType::Global &&
+        out->view()->uses().empty() &&
+        !(isOptionEnabled(EnableOption::KernelProfile) &&
+          kernel_->profile().isProfiled(grop));
+
     // Since block-level reduction is already done, those dimensions
     // with tidx/y/z being true do not participate in the grid
     // reduction.
     ArgumentBuilder template_args;
-    template_args.arg(flags_str).arg(persistent_sync).arg(isAligned());
+    template_args.arg(flags_str);
+    if (!is_last_arrival) {
+      template_args.arg(persistent_sync);
+    }
+    template_args.arg(isAligned());
 
     ArgumentBuilder func_args(block_nest_level_ + 1, kTab);
     func_args.arg(gen(grop->out()));
@@ -1823,7 +1963,44 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
 
     addProfileArguments(func_args, grop);
 
-    indent() << "reduction::gridReduce<" << template_args << ">(\n";
+    indent() << "reduction::"
+             << (is_last_arrival ? "gridReduceLastArrival" : "gridReduce")
+             << "<" << template_args << ">(\n";
+    indent() << kTab << func_args << ");\n";
+  }
+
+  //! The scheduler guarantees that each reduction segment is exactly one
+  //! thread block cluster, so the work and sync buffers are not used.
+  void generateClusterReduction(
+      const kir::GridReduction* grop,
+      const std::string& flags_str) {
+    NVF_ERROR(
+        kernel_->hasManaged("cluster_dims"),
+        "Cluster reduction requires a cluster launch");
+    const auto out = grop->out()->as<kir::TensorIndex>();
+    const auto data_type = grop->out()->dtype();
+
+    ArgumentBuilder template_args;
+    template_args.arg(flags_str).arg(isAligned());
+
+    ArgumentBuilder func_args(block_nest_level_ + 1, kTab);
+    func_args.arg(gen(grop->out()));
+    func_args.arg(gen(grop->in()));
+    func_args.arg(genReductionOp(grop->getReductionOpType(), out->dtype()));
+    func_args.arg(genCall("static_cast", ptrType(data_type), "shared_mem"));
+    NVF_ERROR(grop->predicate() != nullptr && grop->predicate()->hasValue());
+    const auto read_pred = genInline(grop->predicate());
+    func_args.arg(read_pred);
+    if (grop->writePredicate() != nullptr) {
+      NVF_ERROR(grop->writePredicate()->hasValue());
+      func_args.arg(genInline(grop->writePredicate()));
+    } else {
+      func_args.arg(read_pred);
+    }
+    func_args.arg(genCall(data_type, genInline(grop->init())));
+    func_args.arg(genComputeBlockDim());
+
+    indent() << "reduction::clusterReduce<" << template_args << ">(\n";
     indent() << kTab << func_args << ");\n";
   }
 
@@ -2873,6 +3050,92 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
              << reduction_name << ";\n";
   }
 
+  // Returns the offset of the first element a loop accesses in a local
+  // array, if the loop accesses contiguous elements starting from it
+  std::optional<std::string> getLocalArrayOffsetInLoop(
+      const kir::TensorIndex* ti,
+      const ForLoop* loop) {
+    if (ti->view()->getMemoryType() != MemoryType::Local) {
+      return std::nullopt;
+    }
+    Val* index = ti->index();
+    if (index == loop->index()) {
+      return "0";
+    }
+    auto* add = dynamic_cast<BinaryOp*>(index->definition());
+    if (add == nullptr || add->getBinaryOpType() != BinaryOpType::Add) {
+      return std::nullopt;
+    }
+    for (auto [operand, offset] :
+         {std::make_pair(add->lhs(), add->rhs()),
+          std::make_pair(add->rhs(), add->lhs())}) {
+      if (operand == loop->index() &&
+          !DependencyCheck::isDependencyOf(loop->index(), offset)) {
+        return genInline(offset);
+      }
+    }
+    return std::nullopt;
+  }
+
+  // Generates an unrolled loop whose body is only a cast between local
+  // arrays of FP8 and float or half values as packed conversions, e.g.,
+  //   fp8PackedCast<4>(&T2[0], &T3[0]);
+  // Returns false if the loop is not such a loop.
+  bool genPackedFp8Cast(const ForLoop* loop) {
+    if (!loop->isUnrolled() ||
+        loop->circularBufferLoopStage() !=
+            CircularBufferLoopStage::NotApplicable ||
+        !loop->start()->isZeroInt() || !loop->step()->isOneInt() ||
+        !loop->simplifiedStop()->isConstInt()) {
+      return false;
+    }
+    const int64_t extent = loop->simplifiedStop()->evaluate().as<int64_t>();
+    if (extent % 2 != 0 || loop->body().exprs().size() != 1) {
+      return false;
+    }
+    auto* uop = dynamic_cast<UnaryOp*>(loop->body().exprs().front());
+    if (uop == nullptr || uop->getUnaryOpType() != UnaryOpType::Cast) {
+      return false;
+    }
+    auto* in = dynamic_cast<kir::TensorIndex*>(uop->in());
+    auto* out = dynamic_cast<kir::TensorIndex*>(uop->out());
+    if (in == nullptr || out == nullptr) {
+      return false;
+    }
+    auto is_fp8 = [](const DataType& dtype) {
+      return dtype == DataType::Float8_e4m3fn ||
+          dtype == DataType::Float8_e5m2;
+    };
+    auto is_packable = [](const DataType& dtype) {
+      return dtype == DataType::Float || dtype == DataType::Half;
+    };
+    if (!(is_fp8(in->dtype()) && is_packable(out->dtype())) &&
+        !(is_packable(in->dtype()) && is_fp8(out->dtype()))) {
+      return false;
+    }
+    std::optional<std::string> in_offset = getLocalArrayOffsetInLoop(in, loop);
+    std::optional<std::string> out_offset =
+        getLocalArrayOffsetInLoop(out, loop);
+    if (!in_offset.has_value() || !out_offset.has_value()) {
+      return false;
+    }
+
+    ArgumentBuilder func_args;
+    func_args.arg("&")
+        .append(genVariableName(in->view()))
+        .append("[")
+        .append(*in_offset)
+        .append("]");
+    func_args.arg("&")
+        .append(genVariableName(out->view()))
+        .append("[")
+        .append(*out_offset)
+        .append("]");
+    indent() << genCall("fp8PackedCast", std::to_string(extent), func_args)
+             << ";\n";
+    return true;
+  }
+
   void handleTrivialLoop(const ForLoop* loop) {
     if (loop->vectorize()) {
       vectorize_scope_ = true;
@@ -3026,6 +3289,10 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
       return;
     }
 
+    if (genPackedFp8Cast(loop)) {
+      return;
+    }
+
     const auto gen_index = gen(loop->index());
     const auto gen_start = genInline(loop->start());
     const auto gen_stop = genInline(loop->simplifiedStop());
@@ -3338,6 +3605,10 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
   }
 
   void handle(const kir::BlockSync* sync) final {
+    if (sync->isWarpSync()) {
+      indent() << "__syncwarp();\n";
+      return;
+    }
     // Use a custom synchronization method if enabled
     if (getNvFuserEnv("USE_BLOCK_SYNC_ATOMIC")) {
       indent() << "block_sync::sync();\n";
@@ -3354,9 +3625,23 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     bool bidy = sync->syncDims().get(ParallelType::BIDy);
     bool bidz = sync->syncDims().get(ParallelType::BIDz);
 
+    // Sync buffers that reset to zero are placed in reused zeroed memory by
+    // the executor, so they need the sync that clears its semaphore
+    const auto& global_allocations = kernel_->summary().global_allocations;
+    const bool resets_to_zero = std::any_of(
+        global_allocations.begin(),
+        global_allocations.end(),
+        [sync](const kir::Allocate* alloc) {
+          return alloc->buffer() == sync->syncBuffer() &&
+              alloc->resetsToZero();
+        });
+
     ArgumentBuilder sync_call_template_parms;
-    sync_call_template_parms.arg(bidx).arg(bidy).arg(bidz).arg(true).arg(
-        isAligned());
+    sync_call_template_parms.arg(bidx).arg(bidy).arg(bidz);
+    if (!resets_to_zero) {
+      sync_call_template_parms.arg(true);
+    }
+    sync_call_template_parms.arg(isAligned());
 
     auto sync_idx = genCall(
         "index_utils::maskedOffset",
@@ -3376,8 +3661,10 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     sync_call_args.arg(sync_segment_size);
     sync_call_args.arg(genComputeBlockDim());
 
-    auto sync_call =
-        genCall("grid_sync::sync", sync_call_template_parms, sync_call_args);
+    auto sync_call = genCall(
+        resets_to_zero ? "grid_sync::resettingSync" : "grid_sync::sync",
+        sync_call_template_parms,
+        sync_call_args);
 
     indent() << sync_call << ";\n";
   }
@@ -3521,6 +3808,21 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     indent() << "NVFUSER_UPDATE_MAGIC_ZERO;\n";
   }
 
+  void handle(const kir::IncrementScalar* inc) final {
+    indent() << gen(inc->scalar()) << " += " << genInline(inc->increment())
+             << ";\n";
+  }
+
+  void handle(const kir::RecordTimelineEvent* record) final {
+    const auto& profile = kernel_->profile();
+    ArgumentBuilder func_args;
+    func_args.arg(genVariableName(record->buffer())).append(".data");
+    func_args.arg(record->event());
+    func_args.arg(profile.timelineSampledBlocks());
+    func_args.arg(profile.timelineMaxRecords());
+    indent() << genCall("recordTimelineEvent", func_args) << ";\n";
+  }
+
   void handle(const kir::Return* ret) final {
     indent() << "return;\n";
   }
@@ -3528,6 +3830,8 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
  private:
   std::stringstream code_;
   const kir::Kernel* kernel_;
+  //! The block size the kernel is specialized for, if any
+  std::optional<BlockDimSpecialization> block_dim_;
   int block_nest_level_ = 0;
   int block_reduce_name_ = 0;
   bool print_inline_ = false;
@@ -3547,6 +3851,10 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
   std::unordered_map<const Val*, std::string> val_to_name_;
   //! basically kernel_->parameters(), but as a set so it's faster to lookup
   std::unordered_set<const Val*> kernel_params_;
+  //! The type of each of kernel_->parameters(), see KernelStage
+  std::vector<std::string> param_types_;
+  //! Whether the kernel is generated as a device function, see KernelStage
+  bool as_stage_ = false;
 };
 
 } // namespace
@@ -3554,10 +3862,18 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
 std::string generateCudaKernel(
     const kir::Kernel* kernel,
     const std::string& kernel_name,
-    std::optional<int64_t> num_threads_per_cta) {
+    std::optional<int64_t> num_threads_per_cta,
+    std::optional<BlockDimSpecialization> block_dim) {
   FUSER_PERF_SCOPE("generateCudaKernel");
   return CudaKernelGenerator::generateKernelDefinition(
-      kernel, kernel_name, num_threads_per_cta);
+      kernel, kernel_name, num_threads_per_cta, block_dim);
+}
+
+KernelStage generateCudaKernelStage(
+    const kir::Kernel* kernel,
+    const std::string& stage_name) {
+  FUSER_PERF_SCOPE("generateCudaKernelStage");
+  return CudaKernelGenerator::generateKernelStage(kernel, stage_name);
 }
 
 } // namespace codegen
@@ -11,16 +11,51 @@
 #include <kernel.h>
 #include <visibility.h>
 
+#include <array>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace nvfuser {
 namespace codegen {
 
+//! The block size a kernel is specialized for. Its dimensions are emitted as
+//! constants in place of blockDim, and the kernel is annotated with
+//! __launch_bounds__, so it can only be launched with exactly this block
+//! size.
+struct BlockDimSpecialization {
+  std::array<int64_t, 3> dims = {1, 1, 1};
+  //! The number of blocks that should be resident on an SM, passed as the
+  //! second argument of __launch_bounds__
+  int64_t min_blocks_per_sm = 1;
+
+  int64_t numThreads() const {
+    return dims[0] * dims[1] * dims[2];
+  }
+};
+
 //! Generates a CUDA kernel definition for the given kernel
 NVF_API std::string generateCudaKernel(
     const kir::Kernel* kernel,
     const std::string& kernel_name = "CUDAGeneratedKernel",
-    std::optional<int64_t> num_threads_per_cta = std::nullopt);
+    std::optional<int64_t> num_threads_per_cta = std::nullopt,
+    std::optional<BlockDimSpecialization> block_dim = std::nullopt);
+
+//! A kernel generated as a device function, so that a single kernel can
+//! call several of them in order, see Megakernel. The function has the
+//! parameters of the kernel and reads its launch configuration, e.g.,
+//! blockDim, from the calling kernel.
+struct KernelStage {
+  std::string definition;
+  //! The type of each of kir::Kernel::parameters
+  std::vector<std::string> param_types;
+};
+
+//! Generates the definition of the given kernel as a stage. Kernels with
+//! TMA descriptors, clusters or register sharing can't be stages.
+NVF_API KernelStage generateCudaKernelStage(
+    const kir::Kernel* kernel,
+    const std::string& stage_name);
 
 } // namespace codegen
 } // namespace nvfuser
@@ -7,6 +7,7 @@
 // clang-format on
 #include <device_lower/analysis/bank_conflict.h>
 
+#include <device_lower/utils.h>
 #include <expr_evaluator.h>
 #include <ir/utils.h>
 #include <kernel_ir.h>
@@ -254,8 +255,156 @@ class BankConflictInfo : public kir::IrVisitor {
   ExpressionEvaluator expr_eval_;
 };
 
+bool isPowOf2(int64_t x) {
+  return x > 1 && (x & (x - 1)) == 0;
+}
+
+// The layout of a shared memory tensor is chosen by its scheduler if it is
+// accessed by TMA, ldmatrix or mma
+bool hasFixedLayout(TensorView* tv) {
+  if (tv->hasAllocation() || tv->hasSwizzleOp() || tv->isCircularBuffered()) {
+    return true;
+  }
+  std::vector<Expr*> exprs = tv->uses();
+  if (tv->definition() != nullptr) {
+    exprs.push_back(tv->definition());
+  }
+  return std::any_of(exprs.begin(), exprs.end(), [](Expr* expr) {
+    return ir_utils::isCpAsyncBulk(expr) || ir_utils::isLdMatrixOp(expr) ||
+        expr->isA<MmaOp>();
+  });
+}
+
+// The IDs of the tile a tensor allocates, in the order they are laid out. The
+// loop IDs to the right of the compute-at position are replayed back through
+// the splits and merges that only involve them, so that the dimensions of the
+// tile show up, e.g., [tile0 * tile1 / 128, 128] becomes [tile0, tile1].
+std::vector<IterDomain*> getAllocatedTile(TensorView* tv) {
+  const auto& loop_domain = tv->getLoopDomain();
+  std::vector<IterDomain*> tile(
+      loop_domain.begin() + tv->getComputeAtPosition(), loop_domain.end());
+  bool replayed = true;
+  while (replayed) {
+    replayed = false;
+    for (auto i : c10::irange(tile.size())) {
+      Expr* def = tile[i]->definition();
+      if (auto split = dynamic_cast<Split*>(def)) {
+        if (i + 1 < tile.size() && tile[i] == split->outer() &&
+            tile[i + 1] == split->inner()) {
+          tile[i] = split->in();
+          tile.erase(tile.begin() + (int64_t)i + 1);
+          replayed = true;
+          break;
+        }
+      } else if (auto merge = dynamic_cast<Merge*>(def)) {
+        tile[i] = merge->outer();
+        tile.insert(tile.begin() + (int64_t)i + 1, merge->inner());
+        replayed = true;
+        break;
+      }
+    }
+  }
+  return tile;
+}
+
 } // namespace
 
+bool swizzleAllocation(TensorView* tv) {
+  std::vector<IterDomain*> tile = getAllocatedTile(tv);
+  if (tile.size() < 2 ||
+      std::any_of(tile.begin(), tile.end(), [](IterDomain* id) {
+        return id->isBroadcast() || id->isReduction() ||
+            !id->extent()->isConstInt();
+      })) {
+    return false;
+  }
+
+  int64_t vector_size = ir_utils::getVectorizeSize(tv);
+  for (auto consumer : ir_utils::consumerTvsOf(tv)) {
+    vector_size =
+        std::max(vector_size, ir_utils::getVectorizeSize(consumer));
+  }
+
+  IterDomain* x = tile.at(tile.size() - 2);
+  IterDomain* y = tile.at(tile.size() - 1);
+  int64_t x_size = x->extent()->evaluate().as<int64_t>();
+  int64_t y_size = y->extent()->evaluate().as<int64_t>();
+  if (y_size % vector_size != 0 || !isPowOf2(x_size) ||
+      !isPowOf2(y_size / vector_size)) {
+    return false;
+  }
+  int64_t swizzle_size = std::min(x_size, y_size / vector_size);
+
+  // [..., X, Y] -> [..., X/s, s, Y/v/s, s, v], swizzling the two s's
+  std::vector<IterDomain*> allocation(
+      tv->getLoopDomain().begin(),
+      tv->getLoopDomain().begin() + tv->getComputeAtPosition());
+  allocation.insert(allocation.end(), tile.begin(), tile.end() - 2);
+  auto split = [](IterDomain* id, int64_t factor) {
+    return IterDomain::split(
+        id, IrBuilder::create<Val>(factor, DataType::Index), true);
+  };
+  IterDomain* vector_id = nullptr;
+  if (vector_size > 1) {
+    std::tie(y, vector_id) = split(y, vector_size);
+  }
+  if (x_size > swizzle_size) {
+    auto [x_outer, x_inner] = split(x, swizzle_size);
+    allocation.push_back(x_outer);
+    x = x_inner;
+  }
+  IterDomain* y_outer = nullptr;
+  if (y_size / vector_size > swizzle_size) {
+    std::tie(y_outer, y) = split(y, swizzle_size);
+  }
+  std::tie(x, y) = IterDomain::swizzle(SwizzleType::XOR, x, y);
+  allocation.push_back(x);
+  if (y_outer != nullptr) {
+    allocation.push_back(y_outer);
+  }
+  allocation.push_back(y);
+  if (vector_id != nullptr) {
+    allocation.push_back(vector_id);
+  }
+
+  try {
+    tv->setAllocationDomain(allocation, true);
+  } catch (const nvfError&) {
+    return false;
+  }
+  return true;
+}
+
+std::vector<TensorView*> swizzleBankConflicts(
+    Fusion* fusion,
+    const std::unordered_map<const Expr*, std::pair<int64_t, int64_t>>&
+        bank_conflict_info) {
+  // The kernel is a copy of the fusion, so its tensors are looked up by name
+  std::unordered_set<StmtNameType> conflicted;
+  for (const auto& [expr, ways] : bank_conflict_info) {
+    if (ways.first > 1 && isSmemTensorIndex(expr->input(0))) {
+      conflicted.insert(expr->input(0)->as<kir::TensorIndex>()->view()->name());
+    }
+    if (ways.second > 1 && isSmemTensorIndex(expr->output(0))) {
+      conflicted.insert(
+          expr->output(0)->as<kir::TensorIndex>()->view()->name());
+    }
+  }
+
+  FusionGuard fg(fusion);
+  std::vector<TensorView*> swizzled;
+  for (auto tv : fusion->allTvs()) {
+    if (tv->getMemoryType() != MemoryType::Shared ||
+        conflicted.count(tv->name()) == 0 || hasFixedLayout(tv)) {
+      continue;
+    }
+    if (swizzleAllocation(tv)) {
+      swizzled.push_back(tv);
+    }
+  }
+  return swizzled;
+}
+
 std::unordered_map<const Expr*, std::pair<int64_t, int64_t>> getBankConflictInfo(
     const kir::Kernel* kernel,
     LaunchParams launch_params,
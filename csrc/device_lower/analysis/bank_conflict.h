@@ -16,6 +16,7 @@
 
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace nvfuser {
 
@@ -50,4 +51,25 @@ getBankConflictInfo(
     LaunchParams launch_params = {},
     const std::unordered_map<Val*, PolymorphicValue>& known_values = {});
 
+// Swizzles the innermost two dimensions [X, Y] of the tile tv allocates, such
+// that row x of the tile is stored with its vectors rotated by XOR with x. The
+// tile is found from the loop domain to the right of the compute-at position,
+// so tv has to be inlined first. Returns false if the tile has no such pair of
+// constant, power of 2 dimensions.
+NVF_API bool swizzleAllocation(TensorView* tv);
+
+// Applies an XOR swizzle to the allocation domain of the shared memory tensors
+// of fusion that have bank conflicts in bank_conflict_info, which is computed
+// on a lowering of fusion. The innermost two dimensions of the tile each
+// tensor allocates are swizzled, at the granularity of its widest vectorized
+// access. Tensors accessed by TMA, ldmatrix or mma, tensors that are circular
+// buffered, and tensors that already have an allocation domain or a swizzle
+// are left alone, as their layouts are chosen by their schedulers. Returns the
+// swizzled tensors. The fusion needs to be lowered again for the swizzles to
+// take effect.
+NVF_API std::vector<TensorView*> swizzleBankConflicts(
+    Fusion* fusion,
+    const std::unordered_map<const Expr*, std::pair<int64_t, int64_t>>&
+        bank_conflict_info);
+
 } // namespace nvfuser
@@ -48,13 +48,15 @@ void MinimumDeviceVersion::handle(MmaOp* mma_op) {
     ensureVersion({8, 0}, "Fusion contains an Ampere MMA macro");
   } else if (isHopper(mma_op->macro())) {
     ensureVersion({9, 0}, "Fusion contains a Hopper MMA macro");
+  } else if (isBlackwell(mma_op->macro())) {
+    ensureVersion({10, 0}, "Fusion contains a Blackwell MMA macro");
   } else {
     NVF_ERROR(
         "MmaOp ",
         mma_op->toString(),
         " has macro ",
         toString(mma_op->macro()),
-        " which does not appear to be Turing, Ampere, or Hopper");
+        " which does not appear to be Turing, Ampere, Hopper, or Blackwell");
   }
 }
 
@@ -102,6 +102,26 @@ bool isExactParallelSharedMemAccess(TensorView* tv) {
   return true;
 }
 
+// Utility to check if the given global TensorView is allocated by
+//   its loop domain, as done by EnableOption::PadGlobalIntermediates,
+//   so that, like a local tensor, it can't be accessed out of bound
+//   through its loop domain. All the parallel dimensions need to be
+//   exact as they are allocated too.
+bool isAllocatedAsLoopDomain(TensorView* tv) {
+  if (tv->getMemoryType() != MemoryType::Global || tv->isFusionInput() ||
+      tv->isFusionOutput() || !tv->hasAllocation() ||
+      tv->getAllocationDomain() != tv->getLoopDomain()) {
+    return false;
+  }
+  return std::all_of(
+      tv->getLoopDomain().begin(),
+      tv->getLoopDomain().end(),
+      [](IterDomain* id) {
+        return !id->isThread() ||
+            lower_utils::isExtentEqualToMaxParallelTypeExtent(id);
+      });
+}
+
 // Check for conditions where the predicate cannot be removed
 //  when either producer or consumer is in shared memory.
 bool needSharedMemPredicate(TensorView* producer, TensorView* consumer) {
@@ -221,8 +241,14 @@ class ProducerConsumerPairAnalyzer : public OptOutDispatch {
     // of the parallelized axis is the actual size of the axis, not
     // the number of threads. This is currently actively checked to avoid
     // out of bound shared mem access by out of bound threads.
-    if (producer->getMemoryType() == MemoryType::Global ||
-        consumer->getMemoryType() == MemoryType::Global) {
+    // Global intermediates allocated based on loop domains are
+    // treated like local tensors.
+    auto is_allocated_by_logical = [](TensorView* tv) {
+      return tv->getMemoryType() == MemoryType::Global &&
+          !isAllocatedAsLoopDomain(tv);
+    };
+    if (is_allocated_by_logical(producer) ||
+        is_allocated_by_logical(consumer)) {
       return true;
     }
 
@@ -447,7 +473,7 @@ class PredicateChcker : public IterVisitor {
         predicateProducerConsumerPair(expr) ||
         predicateNonDivisibleRootDomains(expr) ||
         predicateNonDivisibleSplit(expr) || predicateExpandReduce(expr) ||
-        predicateRNGOp(expr);
+        predicateRNGOp(expr) || predicatePaddedGlobalProducer(expr);
 
     if (needs_predicate_) {
       return;
@@ -466,6 +492,21 @@ class PredicateChcker : public IterVisitor {
     RECORD_AND_RETURN(expr->isA<RNGOp>());
   }
 
+  // The out-of-bound region of a global intermediate allocated by
+  // its loop domain can't be initialized like a local tensor, so its
+  // consumers can omit their predicates only if it's fully written
+  // without a predicate.
+  bool predicatePaddedGlobalProducer(Expr* expr) const {
+    DEBUG_PRINT_SCOPE(expr);
+    for (auto input : ir_utils::filterByType<TensorView>(expr->inputs())) {
+      if (isAllocatedAsLoopDomain(input) &&
+          non_predicated_exprs_.count(input->definition()) == 0) {
+        RECORD_AND_RETURN(true);
+      }
+    }
+    RECORD_AND_RETURN(false);
+  }
+
   // Always predicate integer division and related ops as we don't
   // know what values are in the out-of-bound region and they may
   // cause exceptions
@@ -655,6 +696,11 @@ class PredicateChcker : public IterVisitor {
       if (split_root.empty()) {
         continue;
       }
+      // Every loop index of a global tensor allocated by its loop
+      // domain has its own element, so no index is aliased.
+      if (isAllocatedAsLoopDomain(output)) {
+        continue;
+      }
       const auto zero_loop_ids = getZeroLeafIds(output);
       if (zero_loop_ids.empty()) {
         RECORD_AND_RETURN(true);
@@ -0,0 +1,86 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <device_lower/analysis/register_pressure.h>
+
+#include <kernel_ir.h>
+#include <kernel_ir_dispatch.h>
+#include <type.h>
+#include <utils.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace nvfuser {
+
+namespace {
+
+// Registers for thread and block indices, kernel parameters and addresses
+constexpr int64_t kBaseRegisters = 16;
+
+class RegisterPressureEstimator : private kir::ConstIrVisitor {
+ public:
+  static int64_t estimate(const kir::Kernel* kernel) {
+    RegisterPressureEstimator estimator;
+    const std::vector<Expr*>& exprs = kernel->topLevelExprs();
+    estimator.handle(std::vector<const Expr*>(exprs.begin(), exprs.end()));
+    return kBaseRegisters + estimator.peak_;
+  }
+
+ private:
+  RegisterPressureEstimator() : scope_registers_(1, 0) {}
+
+  using kir::ConstIrVisitor::handle;
+
+  void handle(const kir::Allocate* alloc) final {
+    if (alloc->memoryType() != MemoryType::Local || alloc->alias() != nullptr ||
+        !alloc->size()->isConstInt()) {
+      return;
+    }
+    const int64_t bytes = alloc->size()->evaluate().as<int64_t>() *
+        (int64_t)dataTypeSize(alloc->buffer()->dtype());
+    const int64_t registers = ceilDiv(bytes, 4);
+    scope_registers_.back() += registers;
+    live_registers_ += registers;
+    updatePeak();
+  }
+
+  void handle(const ForLoop* fl) final {
+    const int64_t index_registers = fl->isTrivial() || fl->isUnrolled() ? 0 : 1;
+    live_registers_ += index_registers;
+    scope_registers_.push_back(0);
+    updatePeak();
+    kir::ConstIrVisitor::handle(fl);
+    live_registers_ -= scope_registers_.back() + index_registers;
+    scope_registers_.pop_back();
+  }
+
+  void handle(const kir::IfThenElse* ite) final {
+    scope_registers_.push_back(0);
+    kir::ConstIrVisitor::handle(ite);
+    live_registers_ -= scope_registers_.back();
+    scope_registers_.pop_back();
+  }
+
+  void updatePeak() {
+    peak_ = std::max(peak_, live_registers_);
+  }
+
+ private:
+  // Registers allocated in each enclosing scope, innermost last
+  std::vector<int64_t> scope_registers_;
+  int64_t live_registers_ = 0;
+  int64_t peak_ = 0;
+};
+
+} // namespace
+
+int64_t estimateRegistersPerThread(const kir::Kernel* kernel) {
+  return RegisterPressureEstimator::estimate(kernel);
+}
+
+} // namespace nvfuser
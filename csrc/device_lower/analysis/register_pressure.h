@@ -0,0 +1,36 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <kernel.h>
+#include <visibility.h>
+
+#include <cstdint>
+
+namespace nvfuser {
+
+// Estimates the peak number of 32-bit registers per thread used by kernel,
+// without compiling it. This lets heuristics reject schedules that would spill
+// before paying for NVRTC and ptxas.
+//
+// The estimate is the largest sum, over all points of the kernel, of:
+//
+//   1. The local memory allocations live at that point. This covers
+//      persistent buffers and the buffers of unrolled and vectorized loads.
+//      An allocation is live from its kir::Allocate to the end of the scope
+//      it is allocated in, and aliases of other allocations are not counted.
+//   2. One index register for each enclosing loop that is neither trivial nor
+//      unrolled.
+//   3. A fixed number of registers for thread and block indices, kernel
+//      parameters and addresses.
+//
+// ptxas may reuse dead registers within a scope or keep values of unrolled
+// loops in registers that are not allocated, so this is only an estimate.
+NVF_API int64_t estimateRegistersPerThread(const kir::Kernel* kernel);
+
+} // namespace nvfuser
@@ -38,8 +38,18 @@
 #include <instrumentation.h>
 #include <ir/iostream.h>
 #include <ir/utils.h>
+#include <runtime/compile_thread_pool.h>
 
+#include <utils.h>
+
+#include <c10/util/irange.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
 #include <list>
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -209,6 +219,42 @@ void segmenterHintCleanup(Fusion* fusion) {
   }
 }
 
+// Allocates the global intermediates of the kernel by their loop domains
+// instead of their logical domains, which rounds the allocated extents up to
+// the multiples of the split factors. Writes past the logical extents then
+// land in the padding, so predicate elimination can treat these tensors like
+// local ones and omit the boundary predicates of the exprs writing them.
+// Fusion inputs and outputs are not owned by the kernel and keep their
+// layouts.
+void padGlobalIntermediates(Fusion* fusion) {
+  if (!isOptionEnabled(EnableOption::PadGlobalIntermediates)) {
+    return;
+  }
+  for (auto tv : fusion->allTvs()) {
+    if (tv->getMemoryType() != MemoryType::Global || tv->isFusionInput() ||
+        tv->isFusionOutput() || tv->hasAllocation()) {
+      continue;
+    }
+    // Broadcast domains are allocated as size 1, so a loop domain
+    // derived from one may be indexed past its allocation
+    const auto& logical = tv->getLogicalDomain();
+    if (std::any_of(logical.begin(), logical.end(), [](IterDomain* id) {
+          return id->isBroadcast();
+        })) {
+      continue;
+    }
+    const auto exprs = DependencyCheck::getAllExprsBetween(
+        {logical.begin(), logical.end()},
+        {tv->getLoopDomain().begin(), tv->getLoopDomain().end()});
+    if (exprs.empty() || std::any_of(exprs.begin(), exprs.end(), [](Expr* e) {
+          return !e->isA<Split>() && !e->isA<Merge>();
+        })) {
+      continue;
+    }
+    tv->setAllocationDomain(tv->getLoopDomain(), true);
+  }
+}
+
 std::tuple<Val*, Val*, kir::GetRNGSeedAndOffsetFromHost*>
 getRNGSeedAndOffsetFromHost();
 
@@ -276,6 +322,7 @@ GpuLower::GpuLower(Fusion* fusion, const CompileParams& cparams)
            {"rotateLoops", rotateLoops},
            {"UnrollPass", UnrollPass::runPass},
            {"processMisalignedVectorization", processMisalignedVectorization},
+           {"findMagicZeroLoops", findMagicZeroLoops},
            {"IndexLowering", IndexLowering::getIndexedExprs},
            {"fuseWarpReduce", fuseWarpReduce},
            {"generateConditionalFromPredicate",
@@ -292,14 +339,117 @@ GpuLower::GpuLower(Fusion* fusion, const CompileParams& cparams)
 
 namespace {
 struct LowerGuard {
-  LowerGuard(GpuLower* gpu_lower) {
+  LowerGuard(GpuLower* gpu_lower)
+      : simplify_expr_cache_guard(
+            isOptionEnabled(EnableOption::MemoizeExprSimplify)
+                ? &gpu_lower->simplifyExprCache()
+                : nullptr) {
     active_gpu_lower = gpu_lower;
   }
   ~LowerGuard() {
     active_gpu_lower = nullptr;
   }
+
+  // Memoizes simplifyExpr within the lowering session
+  SimplifyExprCacheGuard simplify_expr_cache_guard;
+};
+
+// Makes a GpuLower active on a thread of the pool while it runs analysis
+// steps, restoring whatever that thread had before. Neither pointer is
+// dereferenced, as the lowering may be over by the time a pool task starts.
+struct AnalysisStepGuard {
+  AnalysisStepGuard(GpuLower* gpu_lower, Fusion* fusion)
+      : fusion_guard(fusion), previous(active_gpu_lower) {
+    active_gpu_lower = gpu_lower;
+  }
+  ~AnalysisStepGuard() {
+    active_gpu_lower = previous;
+  }
+
+  FusionGuard fusion_guard;
+  GpuLower* previous;
 };
 
+// Runs independent analysis steps concurrently on the thread pool with
+// EnableOption::ParallelLowering, and in order otherwise. The steps must
+// only read the IR and the analyses built before them, as IrContainer is not
+// thread-safe. The calling thread runs steps as well, so this can't deadlock
+// when the lowering itself runs in the pool, e.g., with parallel compilation.
+// Exceptions are rethrown in the order of the steps, like a serial run would.
+void runAnalysisSteps(
+    GpuLower* gpu_lower,
+    const std::vector<std::function<void()>>& steps) {
+  if (steps.size() < 2 || !isOptionEnabled(EnableOption::ParallelLowering)) {
+    for (const auto& step : steps) {
+      step();
+    }
+    return;
+  }
+
+  // Lazily built state of the fusion is built up front, so that steps don't
+  // race to build it
+  Fusion* fusion = gpu_lower->kernel();
+  const auto all_tvs = fusion->allTvs();
+  if (!all_tvs.empty()) {
+    all_tvs.front()->uses();
+  }
+
+  // Pool tasks may only start after the calling thread has run every step,
+  // so they share the ownership of the bookkeeping
+  struct State {
+    explicit State(size_t num_steps)
+        : claimed(num_steps), errors(num_steps) {}
+    std::vector<std::atomic<bool>> claimed;
+    std::vector<std::exception_ptr> errors;
+    std::mutex mutex;
+    std::condition_variable done_cv;
+    size_t num_done = 0;
+  };
+  auto state = std::make_shared<State>(steps.size());
+
+  // Runs unclaimed steps until there are none left. Steps are only
+  // dereferenced once claimed, and the calling thread waits for every claimed
+  // step, so they outlive their use.
+  auto run_unclaimed = [state, &steps]() {
+    for (auto i : c10::irange(state->claimed.size())) {
+      if (state->claimed.at(i).exchange(true)) {
+        continue;
+      }
+      try {
+        steps.at(i)();
+      } catch (...) {
+        state->errors.at(i) = std::current_exception();
+      }
+      std::lock_guard<std::mutex> lock(state->mutex);
+      ++state->num_done;
+      state->done_cv.notify_all();
+    }
+  };
+
+  CompileTaskGroup helpers;
+  for ([[maybe_unused]] auto i : c10::irange(steps.size() - 1)) {
+    helpers.run([gpu_lower, fusion, run_unclaimed]() {
+      AnalysisStepGuard guard(gpu_lower, fusion);
+      run_unclaimed();
+    });
+  }
+  run_unclaimed();
+  // Every step is claimed by now, so the helpers that haven't started would
+  // have nothing left to do
+  helpers.cancel();
+
+  {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done_cv.wait(
+        lock, [&]() { return state->num_done == state->claimed.size(); });
+  }
+  for (const auto& error : state->errors) {
+    if (error != nullptr) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
 } // namespace
 
 kir::Kernel* GpuLower::run() {
@@ -307,7 +457,9 @@ kir::Kernel* GpuLower::run() {
   LowerGuard lower_guard(this);
   // Reorder expressions for loop-nest generation respecting computeAt
   // relationships
+  inst::CompilePhaseLaps lowering_phases("GpuLower::run ");
   auto exprs_lowered = reorderExprsForComputeAt();
+  lowering_phases.lap("reorderExprsForComputeAt");
   dumpExprsIfEnabled(exprs_lowered, "reorderExprsForComputeAt");
 
   commonScalarMap().initialize(exprs_lowered);
@@ -321,6 +473,7 @@ kir::Kernel* GpuLower::run() {
 
   for (auto [name, pass] : passes()) {
     exprs_lowered = pass(exprs_lowered);
+    lowering_phases.lap(name);
     dumpExprsIfEnabled(exprs_lowered, name);
   }
 
@@ -436,6 +589,14 @@ void GpuLower::analysis(Fusion* fusion) {
 
   LowerGuard lower_guard(this);
 
+  // Times each step of the analysis, and dumps the fusion after it if
+  // enabled
+  inst::CompilePhaseLaps analysis_phases("GpuLower::analysis ");
+  auto finish_step = [&](const std::string& name) {
+    analysis_phases.lap(name);
+    dumpExprsIfEnabled(fusion_->exprs(), name);
+  };
+
   // Use int64 by default as the kernel index type
   if (!cparams_.index_type.has_value()) {
     cparams_.index_type = PrimDataType::Int;
@@ -446,13 +607,25 @@ void GpuLower::analysis(Fusion* fusion) {
   // Alias the fusion kernel caries around as a view of itself.
   fusion_ = kernel_.get();
 
-  dumpExprsIfEnabled(fusion_->exprs(), "initialize lowering");
+  finish_step("initialize lowering");
 
   segmenterHintCleanup(fusion_);
   FusionGuard fg(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "segmenterHintCleanup");
+  finish_step("segmenterHintCleanup");
+
+  padGlobalIntermediates(fusion_);
+  finish_step("padGlobalIntermediates");
 
   id_model_options_ = getIdModelOptions(fusion_);
+  // Only TensorIndexer knows how to widen the linearization of global
+  // tensors, so it must produce all tensor indices
+  if (subTensorIndexing()) {
+    NVF_ERROR(
+        indexType() == PrimDataType::Int32,
+        "Sub-tensor indexing requires the 32-bit index type");
+    id_model_options_.setProducerIndex(true);
+    id_model_options_.setConsumerIndex(true);
+  }
 
   // Temporarily set allKnownVals to inputs. In the future, we will have a real
   // pass to determine how to set allKnownVals.
@@ -460,25 +633,25 @@ void GpuLower::analysis(Fusion* fusion) {
   // change their use of fusion_->exprs() to only include exprs that are not
   // between inputs and allKnownVals()?
   allKnownVals() = kernel_->inputs();
-  dumpExprsIfEnabled(fusion_->exprs(), "set allKnownVals");
+  finish_step("set allKnownVals");
 
   // prepare for lowering
   validateIr(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateIr");
+  finish_step("validateIr");
 
   // Determines minimum device version necessary to compile and run this fusion.
   std::tie(min_device_version_, min_device_version_reason_) =
       MinimumDeviceVersion::compute(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "MinimumDeviceVersion");
+  finish_step("MinimumDeviceVersion");
 
   // Checks if any TIDx dim is marked as padded to a warp. Also checks if we can
   // determine the padding is explicitly a single warp.
   collectPaddedParallelDims();
-  dumpExprsIfEnabled(fusion_->exprs(), "collectPaddedParallelDims");
+  finish_step("collectPaddedParallelDims");
 
   // Replaces integers that are tensor sizes by named scalars as "T0.size[0]"
   replaceSymbolicSizes(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "replaceSymbolicSizes");
+  finish_step("replaceSymbolicSizes");
 
   // Build what's refered to as the compute at map. This map contains the
   // mappings of all iteration domains across the fusion. There are three types
@@ -501,92 +674,104 @@ void GpuLower::analysis(Fusion* fusion) {
   }
 
   resolveComputeWith(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "resolveComputeWith");
+  finish_step("resolveComputeWith");
 
   if (isDebugDumpEnabled(DebugDumpOption::ComputeAtMap)) {
     debug() << compute_at_map_->toString() << std::endl;
   }
   compute_at_map_->validateAndPropagatePType();
-  dumpExprsIfEnabled(fusion_->exprs(), "validateAndPropagatePType");
-
-  // Uses compute_at_map, find all splits that are enforced to be divisible
-  divisible_splits_ = getAllDivisibleSplits(fusion_, compute_at_map_.get());
-  dumpExprsIfEnabled(fusion_->exprs(), "getAllDivisibleSplits");
-
-  // Used in parallel dimension map
-  concretized_broadcast_domains_ =
-      std::make_shared<const ConcretizedBroadcastDomains>(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build ConcretizedBroadcastDomains");
+  finish_step("validateAndPropagatePType");
+
+  runAnalysisSteps(
+      this,
+      {// Uses compute_at_map, find all splits that are enforced to be
+       // divisible
+       [&]() {
+         divisible_splits_ =
+             getAllDivisibleSplits(fusion_, compute_at_map_.get());
+       },
+       // Used in parallel dimension map
+       [&]() {
+         concretized_broadcast_domains_ =
+             std::make_shared<const ConcretizedBroadcastDomains>(fusion_);
+       }});
+  finish_step("getAllDivisibleSplits");
+  finish_step("build ConcretizedBroadcastDomains");
 
   parallelDimensionMap().build(fusion_);
   if (isDebugDumpEnabled(DebugDumpOption::ParallelDimensions)) {
     debug() << "Parallel dimension map:" << std::endl;
     debug() << parallel_dimension_map_.toString() << std::endl;
   }
-  dumpExprsIfEnabled(fusion_->exprs(), "build parallelDimensionMap");
-
-  // Validate mma data format and compatibility if any on the fusion.
-  validateMma(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateMma");
-
-  // Validate swizzle usage on the fusion schedule.
-  validateSwizzle(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateSwizzle");
-
-  validateReductions(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateReductions");
+  finish_step("build parallelDimensionMap");
+
+  runAnalysisSteps(
+      this,
+      {// Validate mma data format and compatibility if any on the fusion.
+       [&]() { validateMma(fusion_); },
+       // Validate swizzle usage on the fusion schedule.
+       [&]() { validateSwizzle(fusion_); },
+       [&]() { validateReductions(fusion_); }});
+  finish_step("validateMma");
+  finish_step("validateSwizzle");
+  finish_step("validateReductions");
 
   // Compute thread predicates. Depends on parallel_dimension_map_
   thread_pred_map_.build(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build thread_pred_map_");
+  finish_step("build thread_pred_map_");
 
   // Fuse cetain patterns of reductions, such as a grid reduction
   // followed by a grid broadcast. Only depends on parallelization and
   // thread predicate map.
   fuseReductionsAndBroadcasts(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "fuseReductionsAndBroadcasts");
+  finish_step("fuseReductionsAndBroadcasts");
 
   // Depends on ComputeAtMap
   validateAndConvertIterDomainGrouping(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateAndConvertIterDomainGrouping");
+  finish_step("validateAndConvertIterDomainGrouping");
 
   // Assumes all grouped reductions are convered to
   // GroupedReductionOp, which is done by
   // validateAndConvertIterDomainGrouping
   validateGroupedReductions(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateGroupedReductions");
+  finish_step("validateGroupedReductions");
 
   // Want to run this after parallel map is created.
   // Needs info about grouped reductions.
   // vectorized_accesses_ and vectorized_set_info_ are filled.
   validateAndCollectVectorizeInfo(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateAndCollectVectorizeInfo");
+  finish_step("validateAndCollectVectorizeInfo");
 
   // all of the lookup TVs are fusion inputs
   validateLookupTV(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateLookupTV");
-
-  // Depends on thread_pred_map_, validates parallelization collects which
-  // tensor views need WAR or RAW syncs
-  sync_map_ = std::make_shared<const SyncMap>(fusion_);
+  finish_step("validateLookupTV");
+
+  runAnalysisSteps(
+      this,
+      {// Depends on thread_pred_map_, validates parallelization collects
+       // which tensor views need WAR or RAW syncs
+       [&]() { sync_map_ = std::make_shared<const SyncMap>(fusion_); },
+       // Doesn't depend on the analyses below, so it is built alongside
+       // SyncMap
+       [&]() { circularBufferInfo().build(fusion_); }});
   if (isDebugDumpEnabled(DebugDumpOption::SyncMap)) {
     debug() << sync_map_->toString() << std::endl;
   }
-  dumpExprsIfEnabled(fusion_->exprs(), "SyncMap");
+  finish_step("SyncMap");
+  finish_step("build circularBufferInfo");
 
+  // Creates the divisibility predicates, so it can't run concurrently with
+  // other analyses
   nonDivisibleSplitInfo().build(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build nonDivisibleSplitInfo");
+  finish_step("build nonDivisibleSplitInfo");
 
   // Detects all exprssions that don't need predicates. Depends on
   // nonDivisibleSplitInfo.
   pred_elimination_ = std::make_unique<PredicateElimination>(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build predicateElimination");
-
-  circularBufferInfo().build(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build circularBufferInfo");
+  finish_step("build predicateElimination");
 
   compute_at_map_->allocateIndexVariables();
-  dumpExprsIfEnabled(fusion_->exprs(), "allocateIndexVariables");
+  finish_step("allocateIndexVariables");
 
   if (idModelOptions().loop()) {
     id_model_->allocateLoopIndexVariables();
@@ -597,7 +782,7 @@ void GpuLower::analysis(Fusion* fusion) {
   }
 
   consumerToTMAInfo() = getConsumerToTMAInfoMap(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "getConsumerToTMAInfoMap");
+  finish_step("getConsumerToTMAInfoMap");
 }
 
 kir::Kernel* GpuLower::kernel() const {
@@ -223,6 +223,25 @@ class GpuLower : public NonCopyable {
     return ldst_mbarrier_map_;
   }
 
+  //! Indices of the unrolled loops whose indices and predicates need magic
+  //! zero protection. Only used with EnableOption::PruneMagicZero. See
+  //! findMagicZeroLoops.
+  std::unordered_set<Val*>& magicZeroLoopIndices() {
+    return magic_zero_loop_indices_;
+  }
+
+  //! Memoized simplifyExpr results of this lowering session. Only used with
+  //! EnableOption::MemoizeExprSimplify.
+  SimplifyExprCache& simplifyExprCache() {
+    return simplify_expr_cache_;
+  }
+
+  //! True if global memory tensors are linearized in 64-bit on top of
+  //! 32-bit loop indices. See canUseSubTensorIndexing.
+  bool subTensorIndexing() const {
+    return cparams_.sub_tensor_indexing;
+  }
+
   bool isNvFuserZeroEnabled() {
     if (isOptionDisabled(DisableOption::MagicZero)) {
       return false;
@@ -365,6 +384,10 @@ class GpuLower : public NonCopyable {
   // Keep track of the mbarrier used for each load/store operation
   std::unordered_map<const Expr*, TensorView*> ldst_mbarrier_map_;
 
+  std::unordered_set<Val*> magic_zero_loop_indices_;
+
+  SimplifyExprCache simplify_expr_cache_;
+
   // Keep track of validations needed at runtime. For example, a pair of
   //! "extent mod split_factor == 0" and an error message for divisibility check
   //! for vectorization.
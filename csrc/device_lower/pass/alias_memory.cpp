@@ -36,6 +36,17 @@
 namespace nvfuser {
 
 namespace {
+//! Returns true if expr synchronizes all the threads of the block. Warp syncs
+//! only order the accesses within each warp, so buffers shared by the whole
+//! block can't be reused across them.
+bool synchronizesAllThreads(const Expr* expr) {
+  if (auto sync = dynamic_cast<const kir::BlockSync*>(expr);
+      sync != nullptr && sync->isWarpSync()) {
+    return false;
+  }
+  return lower_utils::hasBlockSync(expr, GpuLower::current()->threadPredMap());
+}
+
 // Alias used for std::transform
 IterDomain* exactConcreteId(IterDomain* id) {
   return GpuLower::current()->caMap()->getConcreteMappedID(
@@ -1693,7 +1704,7 @@ class StackBasedSharedMemAllocator : kir::IrVisitor {
 
     // Reclaim memory whenever we pass an Expr that is known to synchronize the
     // block
-    if (lower_utils::hasBlockSync(expr, GpuLower::current()->threadPredMap())) {
+    if (synchronizesAllThreads(expr)) {
       if (isDebugDumpEnabled(DebugDumpOption::BufferReuseInfo)) {
         debug() << "Block syncing expr found at position " << position_
                 << ". Reclaiming memory." << std::endl;
@@ -1868,6 +1879,200 @@ class StackBasedSharedMemAllocator : kir::IrVisitor {
   std::vector<AllocationInfo*> waiting_to_push_;
 };
 
+//! Packs shared memory allocations by offset assignment on their live
+//! intervals, i.e. first-fit coloring of the interval graph in decreasing
+//! order of size. It is only used when all allocation sizes are known at
+//! compile time, and it runs after StackBasedSharedMemAllocator so that its
+//! result is only kept when it is smaller than the stack-based one.
+//!
+//! Two allocations X and Y interfere unless there is a block sync at a
+//! position p with lastRead(X) <= p < firstWrite(Y), or the other way
+//! around. This is the same condition under which the stack-based allocator
+//! reclaims the memory of X for Y, so no new syncs are needed. Unlike the
+//! stack, a freed buffer can be re-used even when a longer-lived buffer was
+//! placed above it. For example,
+//!
+//!   a: Write A and B
+//!   b: Last read of A
+//!   *: Sync. The stack pushes B, then A, and pops A
+//!   c: Write C, which is placed on top of B
+//!   d: Last read of B
+//!   *: Sync. B cannot be popped since C is above it
+//!   e: Write E, which is placed on top of C
+//!   f: Last read of C and E
+//!
+//! Interval packing places E at the address of B instead.
+class IntervalSharedMemAllocator : kir::IrVisitor {
+ public:
+  IntervalSharedMemAllocator(const AllocationInfoMap& allocation_info_map)
+      : allocation_info_map_(allocation_info_map) {}
+
+  //! Re-assigns the addresses of all unaliased shared memory allocations if
+  //! that reduces the total. Returns whether the addresses were changed.
+  bool allocate(const std::vector<Expr*>& exprs) {
+    if (!collectBuffers()) {
+      return false;
+    }
+    handle(exprs);
+
+    // Place large allocations first. Ties are broken by name so that the
+    // result is deterministic.
+    std::vector<Buffer*> order;
+    order.reserve(buffers_.size());
+    for (Buffer& buffer : buffers_) {
+      order.push_back(&buffer);
+    }
+    std::sort(order.begin(), order.end(), [](Buffer* a, Buffer* b) {
+      if (a->size != b->size) {
+        return a->size > b->size;
+      }
+      return a->info->alloc_expr->name() < b->info->alloc_expr->name();
+    });
+
+    int64_t packed_bytes = 0;
+    std::vector<Buffer*> placed;
+    for (Buffer* buffer : order) {
+      buffer->offset = firstFit(buffer, placed);
+      packed_bytes = std::max(packed_bytes, buffer->offset + buffer->size);
+      placed.push_back(buffer);
+    }
+
+    int64_t stack_bytes = 0;
+    for (const Buffer& buffer : buffers_) {
+      stack_bytes = std::max(stack_bytes, buffer.stack_offset + buffer.size);
+    }
+
+    if (isDebugDumpEnabled(DebugDumpOption::BufferReuseInfo)) {
+      debug() << "Interval packing of " << buffers_.size()
+              << " shared memory allocations uses " << packed_bytes
+              << " bytes, stack-based allocation uses " << stack_bytes
+              << " bytes";
+      if (packed_bytes < stack_bytes) {
+        debug() << ". Saved " << stack_bytes - packed_bytes << " bytes";
+      }
+      debug() << std::endl;
+    }
+
+    if (packed_bytes >= stack_bytes) {
+      return false;
+    }
+    for (const Buffer& buffer : buffers_) {
+      kir::Allocate* alloc = buffer.info->alloc_expr;
+      alloc->setAddress(
+          IrBuilder::create<Val>(buffer.offset, DataType::Index));
+      if (isDebugDumpEnabled(DebugDumpOption::BufferReuseInfo)) {
+        debug() << "Assigned address " << buffer.offset << " for T"
+                << alloc->buffer()->name() << " with size " << buffer.size
+                << " bytes" << std::endl;
+      }
+    }
+    return true;
+  }
+
+ private:
+  struct Buffer {
+    AllocationInfo* info = nullptr;
+    int64_t size = 0;
+    int64_t alignment = 16;
+    int64_t first_write = -1;
+    // Last read of this allocation or any allocation aliasing it
+    int64_t last_read = -1;
+    // Address assigned by StackBasedSharedMemAllocator
+    int64_t stack_offset = 0;
+    int64_t offset = -1;
+  };
+
+  void dispatch(Expr* expr) final {
+    if (synchronizesAllThreads(expr)) {
+      sync_positions_.push_back(
+          allocation_info_map_.getScopeMap().getExprPos(expr));
+    }
+    kir::IrVisitor::dispatch(expr);
+  }
+
+  //! Returns false if any size or stack-based address is not a compile-time
+  //! constant
+  bool collectBuffers() {
+    std::unordered_map<AllocationInfo*, int64_t> last_aliased_read;
+    for (auto& alloc_info : allocation_info_map_.allAllocationInfos()) {
+      if (alloc_info->mem_type != MemoryType::Shared) {
+        continue;
+      }
+      AllocationInfo* base = alloc_info.get();
+      if (alloc_info->alias_to) {
+        base = allocation_info_map_.getAllocationInfo(alloc_info->alias_to);
+        NVF_ERROR(base != nullptr);
+      }
+      int64_t& last_read = last_aliased_read[base];
+      last_read =
+          std::max(last_read, alloc_info->outer_live_interval->lastRead());
+    }
+
+    for (auto [info, last_read] : last_aliased_read) {
+      kir::Allocate* alloc = info->alloc_expr;
+      Val* size = allocSizeBytes(alloc);
+      if (!size->isConstInt() || alloc->address() == nullptr ||
+          !alloc->address()->isConstInt()) {
+        return false;
+      }
+      Buffer buffer;
+      buffer.info = info;
+      buffer.size = size->evaluate().as<int64_t>();
+      buffer.alignment = info->is_cp_async_bulk ? 128 : 16;
+      buffer.first_write = info->outer_live_interval->firstWrite();
+      buffer.last_read = last_read;
+      buffer.stack_offset = alloc->address()->evaluate().as<int64_t>();
+      buffers_.push_back(buffer);
+    }
+    return !buffers_.empty();
+  }
+
+  //! Whether a block sync separates the last read of x from the first write
+  //! of y
+  bool syncedBefore(const Buffer* x, const Buffer* y) const {
+    auto it = std::lower_bound(
+        sync_positions_.begin(), sync_positions_.end(), x->last_read);
+    return it != sync_positions_.end() && *it < y->first_write;
+  }
+
+  bool interferes(const Buffer* a, const Buffer* b) const {
+    return !syncedBefore(a, b) && !syncedBefore(b, a);
+  }
+
+  //! Lowest aligned offset at which buffer does not overlap any interfering
+  //! placed buffer
+  int64_t firstFit(const Buffer* buffer, const std::vector<Buffer*>& placed)
+      const {
+    std::vector<std::pair<int64_t, int64_t>> taken;
+    for (const Buffer* other : placed) {
+      if (interferes(buffer, other)) {
+        taken.emplace_back(other->offset, other->offset + other->size);
+      }
+    }
+    std::sort(taken.begin(), taken.end());
+
+    auto align = [&](int64_t offset) {
+      return (offset + buffer->alignment - 1) & -buffer->alignment;
+    };
+    int64_t offset = 0;
+    for (auto [start, end] : taken) {
+      if (align(offset) + buffer->size <= start) {
+        break;
+      }
+      offset = std::max(offset, end);
+    }
+    return align(offset);
+  }
+
+  const AllocationInfoMap& allocation_info_map_;
+
+  std::vector<Buffer> buffers_;
+
+  // Positions of exprs that synchronize the thread block, in increasing
+  // order since exprs are visited in program order
+  std::vector<int64_t> sync_positions_;
+};
+
 } // namespace
 
 // Use allocation info map to find aliases, i.e. allocations that are properly
@@ -2014,7 +2219,7 @@ class PromoteReuseSyncModifier : private kir::ExprMutator {
     // there is no need to perform the hasBlockSync check as we know that
     // upcoming_first_writes_ was just cleared.
     if (!inserted_sync &&
-        lower_utils::hasBlockSync(expr, GpuLower::current()->threadPredMap())) {
+        synchronizesAllThreads(expr)) {
       if (isDebugDumpEnabled(DebugDumpOption::BufferReuseInfo)) {
         debug() << "Found blocking expression at position " << position
                 << std::endl;
@@ -2069,11 +2274,15 @@ std::pair<std::vector<Expr*>, bool> promoteReuseSyncs(
 
 // Assign addresses for dynamic shared memory allocations. This re-uses memory
 // by reclaiming memory that is unused when encountering a block
-// synchronization.
+// synchronization. With EnableOption::SmemIntervalPacking, the addresses are
+// re-assigned by interval packing when that needs less memory.
 void assignSharedMemoryAllocations(
     const std::vector<Expr*>& exprs,
     AllocationInfoMap& allocation_info_map) {
   StackBasedSharedMemAllocator(allocation_info_map).allocate(exprs);
+  if (isOptionEnabled(EnableOption::SmemIntervalPacking)) {
+    IntervalSharedMemAllocator(allocation_info_map).allocate(exprs);
+  }
 
   // Verify that all smem allocations have a non-null address now
   for (auto& alloc_info : allocation_info_map.allAllocationInfos()) {
@@ -317,6 +317,9 @@ class ExprSegmentationSorter {
 
   bool hasCADomains(const std::unordered_set<IterDomain*>& domains) const;
 
+  // Add delta to the number of groups holding each of the CA domains of group
+  void updateCADomainCounts(const ExprGroup* group, int64_t delta);
+
   // Checks if the for loop associated with the concrete ID is ready to be
   // resolved in sorting.
   bool loopReady(IterDomain* concrete_id) const;
@@ -388,6 +391,11 @@ class ExprSegmentationSorter {
   std::unordered_map<IterDomain*, std::unordered_set<IterDomain*>>
       concrete_id_dependencies_;
 
+  // Number of groups that have each ID in their CA domains. loopReady is
+  // queried for every merge candidate, so it's kept up to date as groups are
+  // created and merged instead of scanning all groups on each query.
+  std::unordered_map<IterDomain*, int64_t> ca_domain_counts_;
+
   // ID representing the outermost scope of the kernel being
   // generated. We may want to have this defined in the Kernel
   // container itself, but for now just define here as it's only used
@@ -606,47 +614,37 @@ void ExprSegmentationSorter::resetTraversal() {
 // Level is maximum distance from inputs. It's the metric used to select what
 // nodes can be merged while maintaining a DAG
 void ExprSegmentationSorter::resetLevels() {
-  std::vector<ExprGroup*> next_to_visit;
+  // Number of producer edges of each group whose producer hasn't been visited.
+  // A group is only queued once all of them are visited, so each group and
+  // edge is processed exactly once.
+  std::unordered_map<ExprGroup*, size_t> n_pending_producers;
+  size_t n_visited = 0;
 
   while (!to_visit_.empty()) {
     auto visit = to_visit_.front();
     to_visit_.pop_front();
 
-    // All inputs processed?
-    bool ready = true;
-    if (!visit->producerEdges().empty()) {
-      ready = std::all_of(
-          visit->producerEdges().begin(),
-          visit->producerEdges().end(),
-          [&](ExprGroupConnections* dep) {
-            return dep->from->payload()->visited;
-          });
-    }
-
-    if (!ready) {
-      // In case traversal doesn't complete because there's an error in the
-      // DAG topology.
-      next_to_visit.push_back(visit);
-      continue;
-    }
-
     visit->payload()->visited = true;
-
-    to_visit_.insert(
-        to_visit_.end(), next_to_visit.begin(), next_to_visit.end());
-    next_to_visit.clear();
-
-    for (auto out : visit->consumerEdges()) {
-      to_visit_.push_back(out->to);
-    }
+    ++n_visited;
 
     visit->payload()->level = 0;
     for (auto inp : visit->producerEdges()) {
       visit->payload()->level =
           std::max(visit->payload()->level, inp->from->payload()->level + 1);
     }
+
+    for (auto out : visit->consumerEdges()) {
+      auto consumer = out->to;
+      auto it =
+          n_pending_producers
+              .try_emplace(consumer, consumer->producerEdges().size())
+              .first;
+      if (--it->second == 0) {
+        to_visit_.push_back(consumer);
+      }
+    }
   }
-  NVF_ERROR(next_to_visit.empty(), "Error in graph, is not a DAG.");
+  NVF_ERROR(n_visited == groups_.size(), "Error in graph, is not a DAG.");
 }
 
 ExprGroup* ExprSegmentationSorter::makeEmptyGroup(bool is_scalar_only) {
@@ -675,6 +673,7 @@ ExprGroup* ExprSegmentationSorter::makeEmptyGroup(
         auto concrete_id = getConcreteID(out_tv->axis(tv_i));
         group->payload()->ca_domains.push_back(concrete_id);
       }
+      updateCADomainCounts(group, 1);
     }
     // Similarly for PA, unless all the inputs are either fusion
     // inputs or just scalar Vals, we need to have the global scope domain
@@ -980,6 +979,7 @@ ExprGroup* ExprSegmentationSorter::makeMergedNode(
       joined_groups->payload()->pa_domains.emplace_back(id);
     }
   }
+  updateCADomainCounts(joined_groups, 1);
 
   if (isDebugDumpEnabled(DebugDumpOption::ExprSort) ||
       isDebugDumpEnabled(DebugDumpOption::ExprSortVerbose)) {
@@ -1117,6 +1117,7 @@ void ExprSegmentationSorter::mergeNodes() {
   }
 
   for (auto group : clean_up_groups) {
+    updateCADomainCounts(group, -1);
     auto disconnected_edges = disconnectGroup(group);
     clean_up_edges.insert(disconnected_edges.begin(), disconnected_edges.end());
   }
@@ -1255,21 +1256,25 @@ void ExprSegmentationSorter::initializeForLoopDependencies() {
 
 bool ExprSegmentationSorter::hasCADomains(
     const std::unordered_set<IterDomain*>& domains) const {
-  for (auto& group : groups_) {
-    if (std::any_of(
-            group->payload()->ca_domains.begin(),
-            group->payload()->ca_domains.end(),
-            [&](auto ca_domain) { return domains.count(ca_domain); })) {
-      return true;
-    }
+  return std::any_of(domains.begin(), domains.end(), [&](IterDomain* id) {
+    auto it = ca_domain_counts_.find(id);
+    return it != ca_domain_counts_.end() && it->second > 0;
+  });
+}
+
+void ExprSegmentationSorter::updateCADomainCounts(
+    const ExprGroup* group,
+    int64_t delta) {
+  for (auto ca_domain : group->payload()->ca_domains) {
+    auto& count = ca_domain_counts_[ca_domain];
+    count += delta;
+    NVF_ERROR(count >= 0, "Negative CA domain count: ", ca_domain->toString());
   }
-  return false;
 }
 
 // Checks if the for loop associated with the concrete ID is ready to be
-// resolved in sorting. This could be done more efficiently with some
-// additional tracking, however we recreate ca_domain_ when we merge groups,
-// so it's hard to track what is no longer needed.
+// resolved in sorting, i.e., no group still has any of its dependencies as a
+// CA domain.
 bool ExprSegmentationSorter::loopReady(IterDomain* concrete_id) const {
   NVF_ERROR(
       concrete_id == getConcreteID(concrete_id),
@@ -1437,6 +1442,12 @@ bool ExprSegmentationSorter::supportedMerge(ExprGroup* sg1, ExprGroup* sg2) {
 }
 
 bool ExprSegmentationSorter::testStillDag(ExprGroup* sg1, ExprGroup* sg2) {
+  // Levels are up to date here as this is only used by the fallback, which
+  // merges at most once after resetLevels. Consumers always have a larger
+  // level than their producers, so nothing at or beyond this level other than
+  // sg1 and sg2 themselves can reach back to them.
+  const auto max_level =
+      std::max(sg1->payload()->level, sg2->payload()->level);
   std::deque<ExprGroup*> to_visit;
   std::unordered_set<ExprGroup*> visited;
   // Add consumers of sg1 if not sg2
@@ -1471,6 +1482,9 @@ bool ExprSegmentationSorter::testStillDag(ExprGroup* sg1, ExprGroup* sg2) {
       continue;
     }
     visited.emplace(group);
+    if (group->payload()->level >= max_level) {
+      continue;
+    }
     for (auto consumer_edge : group->consumerEdges()) {
       to_visit.emplace_back(consumer_edge->to);
     }
@@ -1524,15 +1538,16 @@ void ExprSegmentationSorter::sort() {
     expr2group.insert(std::make_pair(expr, group));
   }
 
+  const std::unordered_set<Val*> known_vals(
+      GpuLower::current()->allKnownVals().begin(),
+      GpuLower::current()->allKnownVals().end());
+
   // Create edges between the Exprs. Mark inputs and outputs of the fusion.
   for (auto expr : all_exprs) {
     auto expr_group = expr2group.at(expr);
     auto out = expr->outputs()[0];
     for (auto inp : expr->inputs()) {
-      if (std::any_of(
-              GpuLower::current()->allKnownVals().begin(),
-              GpuLower::current()->allKnownVals().end(),
-              [&inp](Val* input) { return input == inp; })) {
+      if (known_vals.count(inp)) {
         continue;
       }
 
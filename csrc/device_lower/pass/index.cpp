@@ -331,9 +331,10 @@ void IndexLowering::handle(const IndexSelectOp* sop) {
   const auto lookup =
       lowerSrcIndex(sop->input(0), sop->output(0), override_index);
 
+  // Like TorchGatherOp, the gather is a plain load from the overridden
+  // index, so it can be vectorized along the rows of the lookup
   const auto out = lowerDstIndex(sop->output(0));
-  pushBack(
-      IrBuilder::create<IndexSelectOp>(out, lookup, sop->dim(), lowered_index));
+  pushBack(IrBuilder::create<LoadStoreOp>(LoadStoreOpType::Set, out, lookup));
   GpuLower::current()->propagateExprInfo(sop, back());
 }
 
@@ -13,6 +13,7 @@
 #include <ir/utils.h>
 #include <kernel_ir.h>
 #include <kernel_ir_dispatch.h>
+#include <options.h>
 
 #include <unordered_set>
 
@@ -20,6 +21,28 @@ namespace nvfuser {
 
 namespace {
 
+//! Returns true if the threads communicating along sync_bits are always in
+//! the same warp, so that a warp sync can replace the block sync. This is the
+//! case with NVFUSER_ENABLE=warp_sync when they only differ in threadIdx.x and
+//! blockDim.x is a constant divisor of the warp size.
+bool isWarpLocalSync(const ParallelTypeBitmap& sync_bits) {
+  if (!isOptionEnabled(EnableOption::WarpSync)) {
+    return false;
+  }
+  ParallelTypeBitmap tidx_bits;
+  tidx_bits.set(ParallelType::TIDx);
+  if (sync_bits != tidx_bits) {
+    return false;
+  }
+  Val* bdimx =
+      GpuLower::current()->parallelDimensionMap().getRaw(ParallelType::TIDx);
+  if (bdimx == nullptr || !bdimx->isConstInt()) {
+    return false;
+  }
+  const int64_t bdimx_val = bdimx->evaluate().as<int64_t>();
+  return bdimx_val > 0 && 32 % bdimx_val == 0;
+}
+
 //! Scan through Kernel IR for-loops to insert Sync nodes to avoid
 //! Write-After-Read (WAR) race condition.
 //!
@@ -159,8 +182,11 @@ class WarSyncInserter : private kir::ExprMutator {
     }
   }
 
-  void handle(kir::BlockSync*) final {
-    handleSync();
+  void handle(kir::BlockSync* sync) final {
+    // A warp sync doesn't order the accesses of other warps
+    if (!sync->isWarpSync()) {
+      handleSync();
+    }
   }
 
   void handle(kir::GridSync*) final {
@@ -494,12 +520,18 @@ class ReadAfterWriteSyncs : public kir::ExprMutator {
       Expr* sync_expr = nullptr;
       kir::Allocate* maybe_alloc = nullptr;
       if (sync_bitmap.hasBID()) {
+        // See grid_sync::resettingSync
         maybe_alloc = lower_utils::allocGlobalBufferForGridComm(
             lower_utils::getGridSyncBufferSize(sync_bitmap),
             DataType::Int,
-            true);
+            /*zero_init=*/true,
+            /*resets_to_zero=*/
+            isOptionEnabled(EnableOption::ResettingGridSync));
         sync_expr = IrBuilder::create<kir::GridSync>(
             sync_bitmap, maybe_alloc->buffer());
+      } else if (isWarpLocalSync(sync_bitmap)) {
+        sync_expr = IrBuilder::create<kir::BlockSync>(
+            /*war_sync=*/false, /*warp_sync=*/true);
       } else {
         sync_expr = IrBuilder::create<kir::BlockSync>(false); // is not war sync
       }
@@ -698,9 +730,16 @@ class ReadAfterWriteSyncs : public kir::ExprMutator {
             prev_tv_expr != nullptr,
             "Can't require sync on inputs, however, detected it's needed.");
         ParallelTypeBitmap bitmap;
-        bitmap.set(ParallelType::TIDx);
-        bitmap.set(ParallelType::TIDy);
-        bitmap.set(ParallelType::TIDz);
+        for (auto entry : smem) {
+          bitmap |= GpuLower::current()->syncMap()->needsRawSync(
+              entry.first->as<TensorView>());
+        }
+        if (!isWarpLocalSync(bitmap)) {
+          bitmap = ParallelTypeBitmap();
+          bitmap.set(ParallelType::TIDx);
+          bitmap.set(ParallelType::TIDy);
+          bitmap.set(ParallelType::TIDz);
+        }
         sync_before_.emplace_back(expr, bitmap);
 
         // Before clearing `smem`, put all the currently pending smem writes
@@ -7,8 +7,12 @@
 // clang-format on
 #include <device_lower/lower2device.h>
 #include <device_lower/pass/magic_zero.h>
+#include <device_lower/utils.h>
 #include <iter_visitor.h>
 #include <kernel_ir_dispatch.h>
+#include <options.h>
+
+#include <string>
 
 #include <device_lower/pass/instrument.h>
 
@@ -99,18 +103,136 @@ class Instrumentor : private kir::IrVisitor {
   kir::Allocate* buffer_alloc_ = nullptr;
 };
 
+//! Record the phases of each warp of the first blocks with the global
+//! timer: the issue of TMA loads and MMAs, the waits on mbarriers, and the
+//! stores of the epilogue.
+class TimelineInstrumentor : private kir::ExprMutator {
+ public:
+  using TimelineEvent = kir::KernelPerformanceProfile::TimelineEvent;
+
+  TimelineInstrumentor(
+      const std::vector<Expr*>& exprs,
+      kir::KernelPerformanceProfile& profile)
+      : profile_(profile) {
+    int64_t sampled_blocks = 2;
+    int64_t max_records = 512;
+    const auto& args = getEnableOptionArguments(EnableOption::KernelTimeline);
+    if (!args.empty()) {
+      sampled_blocks = std::stol(args.at(0));
+    }
+    if (args.size() > 1) {
+      max_records = std::stol(args.at(1));
+    }
+    NVF_CHECK(
+        sampled_blocks > 0 && max_records > 0,
+        "Invalid kernel_timeline arguments: ",
+        sampled_blocks,
+        " sampled blocks, ",
+        max_records,
+        " records per warp");
+
+    allocateBuffer(sampled_blocks, max_records);
+    profile_.setTimelineBuffer(buffer_, sampled_blocks, max_records);
+
+    const std::vector<Expr*> mutated_exprs = traverseAndInsert(exprs);
+
+    exprs_.push_back(buffer_alloc_);
+    exprs_.push_back(createEvent(TimelineEvent::KernelStart));
+    exprs_.insert(exprs_.end(), mutated_exprs.begin(), mutated_exprs.end());
+    exprs_.push_back(createEvent(TimelineEvent::KernelEnd));
+  }
+
+  const std::vector<Expr*>& exprs() const {
+    return exprs_;
+  }
+
+ private:
+  using kir::ExprMutator::handle;
+
+  void handle(LoadStoreOp* ldst) final {
+    if (ir_utils::isCpAsyncBulkLoad(ldst)) {
+      registerInsertBefore(ldst, createEvent(TimelineEvent::TmaIssue));
+      return;
+    }
+    auto out = dynamic_cast<kir::TensorIndex*>(ldst->out());
+    if (out != nullptr && out->view()->getMemoryType() == MemoryType::Global) {
+      registerInsertBefore(ldst, createEvent(TimelineEvent::EpilogueStore));
+    }
+  }
+
+  void handle(MmaOp* mma) final {
+    registerInsertBefore(mma, createEvent(TimelineEvent::MmaIssue));
+  }
+
+  void handle(kir::MBarrierWait* wait) final {
+    instrumentWait(wait);
+  }
+
+  void handle(kir::MBarrierWaitParity* wait) final {
+    instrumentWait(wait);
+  }
+
+  void instrumentWait(Expr* wait) {
+    registerInsertBefore(wait, createEvent(TimelineEvent::MBarrierWaitBegin));
+    registerInsertAfter(wait, createEvent(TimelineEvent::MBarrierWaitEnd));
+  }
+
+  Expr* createEvent(TimelineEvent event) {
+    return IrBuilder::create<kir::RecordTimelineEvent>(buffer_, (int64_t)event);
+  }
+
+  //! A row for each warp of the sampled blocks, each with the number of
+  //! records followed by the timestamp and the event of each record
+  void allocateBuffer(int64_t sampled_blocks, int64_t max_records) {
+    const std::vector<IterDomain*> new_buffer_ids = {
+        IterDomainBuilder(
+            GpuLower::current()->kernel()->zeroVal(),
+            IrBuilder::create<Val>(
+                sampled_blocks *
+                    kir::KernelPerformanceProfile::timeline_warps_per_block,
+                DataType::Index))
+            .build(),
+        IterDomainBuilder(
+            GpuLower::current()->kernel()->zeroVal(),
+            IrBuilder::create<Val>(1 + 2 * max_records, DataType::Index))
+            .build()};
+
+    const auto buffer_domain = IrBuilder::create<TensorDomain>(new_buffer_ids);
+
+    buffer_ = IrBuilder::create<TensorView>(
+        buffer_domain, DataType::Int, MemoryType::Global);
+
+    buffer_alloc_ = IrBuilder::create<kir::Allocate>(
+        buffer_, buffer_->getMemoryType(), nullptr, true);
+  }
+
+ private:
+  std::vector<Expr*> exprs_;
+  kir::KernelPerformanceProfile& profile_;
+  TensorView* buffer_ = nullptr;
+  kir::Allocate* buffer_alloc_ = nullptr;
+};
+
 } // namespace
 
 std::vector<Expr*> instrumentKernel(const std::vector<Expr*>& exprs) {
-  if (!isOptionEnabled(EnableOption::KernelProfile)) {
-    return exprs;
+  std::vector<Expr*> instrumented_exprs = exprs;
+  kir::KernelPerformanceProfile profile;
+
+  if (isOptionEnabled(EnableOption::KernelProfile)) {
+    Instrumentor inst(instrumented_exprs);
+    profile = inst.profile();
+    instrumented_exprs = inst.exprs();
   }
 
-  Instrumentor inst(exprs);
+  if (isOptionEnabled(EnableOption::KernelTimeline)) {
+    TimelineInstrumentor inst(instrumented_exprs, profile);
+    instrumented_exprs = inst.exprs();
+  }
 
-  GpuLower::current()->profile() = inst.profile();
+  GpuLower::current()->profile() = profile;
 
-  return inst.exprs();
+  return instrumented_exprs;
 }
 
 } // namespace nvfuser
@@ -19,6 +19,10 @@ namespace nvfuser {
 //! profiled, so this pass should be called after all expressions are
 //! lowered. KernelPerformanceProfile is copied to Kernel after
 //! lowering.
+//!
+//! When EnableOption::KernelTimeline is enabled, the pass also records a
+//! timeline of the warps of the first blocks, see
+//! KernelPerformanceProfile::TimelineEvent.
 std::vector<Expr*> instrumentKernel(const std::vector<Expr*>& exprs);
 
 } // namespace nvfuser
@@ -13,6 +13,7 @@
 #include <instrumentation.h>
 #include <ir/utils.h>
 #include <kernel_ir_dispatch.h>
+#include <options.h>
 
 namespace nvfuser {
 
@@ -57,8 +58,60 @@ class MagicZeroInserter : public kir::ExprMutator {
   std::vector<InsertionInfo> insertion_list_;
 };
 
+class MagicZeroLoopFinder : public kir::IrVisitor {
+ public:
+  static void find(const std::vector<Expr*>& exprs) {
+    MagicZeroLoopFinder finder;
+    finder.handle(exprs);
+  }
+
+ private:
+  using kir::IrVisitor::handle;
+
+  void dispatch(Expr* expr) final {
+    if (dependsOnLoopIndices(expr->predicate()) ||
+        dependsOnLoopIndices(expr->writePredicate())) {
+      for (auto fl : for_loops_) {
+        if (fl->isUnrolled()) {
+          GpuLower::current()->magicZeroLoopIndices().insert(fl->index());
+        }
+      }
+    }
+    kir::IrVisitor::dispatch(expr);
+  }
+
+  // Thread predicates and manual predicates do not depend on loop indices.
+  // Neither do inline predicates that predicate elimination will omit.
+  static bool dependsOnLoopIndices(kir::Predicate* pred) {
+    if (pred == nullptr) {
+      return false;
+    }
+    switch (pred->predicate_type()) {
+      case PredicateType::Manual:
+      case PredicateType::ElectSync:
+        return false;
+      case PredicateType::Inline:
+        return pred->expr() == nullptr ||
+            !GpuLower::current()->predicateElimination().canOmitPredicate(
+                pred->expr());
+      default:
+        return true;
+    }
+  }
+};
+
 } // namespace
 
+std::vector<Expr*> findMagicZeroLoops(const std::vector<Expr*>& exprs) {
+  FUSER_PERF_SCOPE("GpuLower::Lower::findMagicZeroLoops");
+  if (!GpuLower::current()->isNvFuserZeroEnabled() ||
+      !isOptionEnabled(EnableOption::PruneMagicZero)) {
+    return exprs;
+  }
+  MagicZeroLoopFinder::find(exprs);
+  return exprs;
+}
+
 std::vector<Expr*> insertMagicZero(const std::vector<Expr*>& exprs) {
   FUSER_PERF_SCOPE("GpuLower::Lower::insertMagicZero");
   if (!GpuLower::current()->isNvFuserZeroEnabled()) {
@@ -114,6 +167,11 @@ bool needsMagicZero(ForLoop* loop, IterDomain* reference_domain, Val* ind) {
     return false;
   }
 
+  if (isOptionEnabled(EnableOption::PruneMagicZero) &&
+      GpuLower::current()->magicZeroLoopIndices().count(loop->index()) == 0) {
+    return false;
+  }
+
   bool ref_dom_simple =
       reference_domain == nullptr || reference_domain->definition() != nullptr;
   bool ind_simple =
@@ -24,6 +24,15 @@ struct IndexFromIdGraph;
 //! This will make sure nvrtc does not aggressively save predicate and indices.
 std::vector<Expr*> insertMagicZero(const std::vector<Expr*>& exprs);
 
+//! Find the unrolled loops that need magic zero protection, i.e., the ones
+//! that contain an expression whose predicate depends on the loop
+//! indices. nvrtc may compute such predicates, and the indices they use, for
+//! all the unrolled iterations at once, which is what magic zero prevents.
+//! Hoisting the indices of the other unrolled loops is harmless, so with
+//! EnableOption::PruneMagicZero, needsMagicZero skips them. Returns exprs
+//! unchanged. Must run before indexing.
+std::vector<Expr*> findMagicZeroLoops(const std::vector<Expr*>& exprs);
+
 //! Check if val is a reference to the magic zero variable
 NVF_API bool isMagicZero(const Val* val);
 
@@ -41,6 +50,9 @@ Val* maybeUnwrapMagicZero(Val* val);
 // compiler. If the loop can be unrolled and the index and domain are not
 // "simple" we likely want the loop protected.
 //
+// With EnableOption::PruneMagicZero, only the unrolled loops found by
+// findMagicZeroLoops are protected.
+//
 // Magic zero protection should only be done for global memory and predicates.
 // We should avoid use on registers. Shared memory does not require it, but
 // likely wouldn't hurt.
@@ -19,12 +19,30 @@ namespace nvfuser {
 
 namespace {
 
+// With EnableOption::HostScalarHoisting, integer arithmetic on the inputs
+// of the kernel, e.g., ceilDivs and products of extents, is evaluated by the
+// host once per launch instead of by every thread. Reading the extents and
+// strides of tensors is free, so those are not hoisted by themselves.
+bool isComputableOnHost(Val* value) {
+  if (!isOptionEnabled(EnableOption::HostScalarHoisting) ||
+      !value->isIntegralScalar() || !value->definition()->isA<BinaryOp>()) {
+    return false;
+  }
+  const auto& kernel_inputs = GpuLower::current()->kernel()->inputs();
+  const auto inputs = InputsOf::output(value);
+  return std::all_of(inputs.begin(), inputs.end(), [&](Val* input) {
+    return input->isConstScalar() ||
+        std::find(kernel_inputs.begin(), kernel_inputs.end(), input) !=
+        kernel_inputs.end();
+  });
+}
+
 bool shouldHoistToHost(Val* value) {
   if (value->definition() == nullptr) {
     return false;
   }
   auto def = value->definition();
-  return def->isA<kir::EncodeTensorMapTiled>();
+  return def->isA<kir::EncodeTensorMapTiled>() || isComputableOnHost(value);
 }
 
 // Get the position of the innermost non-trivial loop
@@ -571,14 +589,209 @@ class CommonScalarInserter : private kir::ExprMutator {
   const CommonScalarMap& common_scalar_map_;
 };
 
+// Strength-reduce the hoisted scalars of serial loops that are affine in the
+// loop index. For a loop
+//   FOR i in [start, stop) step s
+//     v = a + i * b
+// where a and b are computed outside of the loop, v is replaced by a running
+// scalar that is advanced by s * b at the end of every iteration:
+//   p = a + start * b
+//   FOR i in [start, stop) step s
+//     v = p
+//     ...
+//     p += s * b
+// Unrolled loops are left alone. Their indices are protected with magic zero,
+// and become constants after unrolling, so there is no multiplication left to
+// reduce. The definition of p stays its initial value, so this must run after
+// all passes that reason about the definitions of hoisted scalars.
+class IndexStrengthReducer : private kir::ExprMutator {
+ public:
+  static std::vector<Expr*> run(const std::vector<Expr*>& exprs) {
+    IndexStrengthReducer reducer(exprs);
+    return std::move(reducer.exprs_);
+  }
+
+ private:
+  IndexStrengthReducer(const std::vector<Expr*>& exprs) {
+    IrVisitor::handle(exprs);
+    mutate();
+  }
+
+  using kir::ExprMutator::handle;
+
+  void handle(ForLoop* loop) final {
+    if (isReducible(loop)) {
+      reduce(loop);
+    }
+    kir::ExprMutator::handle(loop);
+  }
+
+  static bool isReducible(ForLoop* loop) {
+    return !loop->isTrivial() && !loop->isUnrolled() && !loop->vectorize() &&
+        loop->iter_domain()->getParallelType() == ParallelType::Serial &&
+        !loop->body().empty();
+  }
+
+  void reduce(ForLoop* loop) {
+    loop_ = loop;
+    loop_vals_.clear();
+    invariant_.clear();
+    collectLoopVals(loop->body());
+    if (!isInvariant(loop->start()) || !isInvariant(loop->step())) {
+      return;
+    }
+
+    Scope* parent_scope = scope_.empty() ? nullptr : scope_.back();
+    Expr* last_expr = loop->body().exprs().back();
+    std::unordered_set<Val*> allocated;
+    for (auto expr : loop->body().exprs()) {
+      if (auto alloc = dynamic_cast<kir::Allocate*>(expr)) {
+        if (alloc->buffer()->isScalar()) {
+          allocated.insert(alloc->buffer());
+        }
+        continue;
+      }
+      // Hoisted scalars are placed at the beginning of the loop body
+      if (expr->outputs().size() != 1 ||
+          allocated.count(expr->output(0)) == 0) {
+        break;
+      }
+      Val* value = expr->output(0);
+      auto [base, stride] = matchAffine(expr);
+      if (stride == nullptr) {
+        continue;
+      }
+
+      // p = a + start * b, before the loop
+      auto running = IrBuilder::create<Val>(value->dtype());
+      auto init = SimplifyingIrBuilder::addExpr(
+          base, SimplifyingIrBuilder::mulExpr(loop->start(), stride));
+      auto alloc = IrBuilder::create<kir::Allocate>(
+          running,
+          MemoryType::Local,
+          GpuLower::current()->kernel()->oneVal());
+      registerInsertBefore(loop, alloc, parent_scope);
+      registerInsertBefore(
+          loop,
+          IrBuilder::create<LoadStoreOp>(
+              LoadStoreOpType::Set, running, init),
+          parent_scope);
+
+      // v = p, and p += s * b at the end of the loop body
+      registerReplace(
+          expr,
+          IrBuilder::create<LoadStoreOp>(
+              LoadStoreOpType::Set, value, running),
+          &loop->body());
+      registerInsertAfter(
+          last_expr,
+          IrBuilder::create<kir::IncrementScalar>(
+              running, SimplifyingIrBuilder::mulExpr(loop->step(), stride)),
+          &loop->body());
+    }
+  }
+
+  void collectLoopVals(const Scope& scope) {
+    for (auto expr : scope.exprs()) {
+      if (auto inner_loop = dynamic_cast<ForLoop*>(expr)) {
+        loop_vals_.insert(inner_loop->index());
+        collectLoopVals(inner_loop->body());
+      } else if (auto ite = dynamic_cast<kir::IfThenElse*>(expr)) {
+        collectLoopVals(ite->thenBody());
+        collectLoopVals(ite->elseBody());
+      } else {
+        loop_vals_.insert(expr->outputs().begin(), expr->outputs().end());
+      }
+    }
+  }
+
+  // Returns {a, b} if expr computes a + i * b or i * b, where i is the index
+  // of loop_ and a and b are loop invariant. Returns {nullptr, nullptr}
+  // otherwise.
+  std::pair<Val*, Val*> matchAffine(Expr* expr) {
+    auto bop = dynamic_cast<BinaryOp*>(expr);
+    if (bop == nullptr) {
+      return {nullptr, nullptr};
+    }
+    if (bop->getBinaryOpType() == BinaryOpType::Mul) {
+      if (Val* stride = matchStride(bop)) {
+        return {GpuLower::current()->kernel()->zeroVal(), stride};
+      }
+      return {nullptr, nullptr};
+    }
+    if (bop->getBinaryOpType() != BinaryOpType::Add) {
+      return {nullptr, nullptr};
+    }
+    for (auto [base, term] :
+         {std::make_pair(bop->lhs(), bop->rhs()),
+          std::make_pair(bop->rhs(), bop->lhs())}) {
+      if (!isInvariant(base)) {
+        continue;
+      }
+      if (Val* stride = matchStride(term->definition())) {
+        return {base, stride};
+      }
+    }
+    return {nullptr, nullptr};
+  }
+
+  // Returns b if expr computes i * b or b * i
+  Val* matchStride(Expr* expr) {
+    auto bop = dynamic_cast<BinaryOp*>(expr);
+    if (bop == nullptr || bop->getBinaryOpType() != BinaryOpType::Mul) {
+      return nullptr;
+    }
+    if (bop->lhs() == loop_->index() && isInvariant(bop->rhs())) {
+      return bop->rhs();
+    }
+    if (bop->rhs() == loop_->index() && isInvariant(bop->lhs())) {
+      return bop->lhs();
+    }
+    return nullptr;
+  }
+
+  // A scalar is invariant in loop_ if it can be computed before the loop. The
+  // magic zero is excluded so that the protection it gives is not lost.
+  bool isInvariant(Val* value) {
+    if (auto it = invariant_.find(value); it != invariant_.end()) {
+      return it->second;
+    }
+    bool invariant = true;
+    if (value == loop_->index() || loop_vals_.count(value) ||
+        isMagicZero(value) || value->isA<kir::TensorIndex>()) {
+      invariant = false;
+    } else if (auto tv = dynamic_cast<TensorView*>(value)) {
+      // Only the metadata of global tensors, e.g., strides, is read here
+      invariant = tv->getMemoryType() == MemoryType::Global;
+    } else if (auto def = value->definition()) {
+      invariant = std::all_of(
+          def->inputs().begin(), def->inputs().end(), [this](Val* input) {
+            return isInvariant(input);
+          });
+    }
+    invariant_[value] = invariant;
+    return invariant;
+  }
+
+ private:
+  ForLoop* loop_ = nullptr;
+  // Vals defined in the body of loop_, including the indices of inner loops
+  std::unordered_set<Val*> loop_vals_;
+  std::unordered_map<Val*, bool> invariant_;
+};
+
 } // namespace
 
 std::vector<Expr*> allocateCommonScalars(const std::vector<Expr*>& exprs) {
   if (isOptionDisabled(DisableOption::IndexHoist)) {
     return exprs;
   }
-  return CommonScalarInserter::run(
+  auto inserted = CommonScalarInserter::run(
       exprs, GpuLower::current()->commonScalarMap());
+  if (!isOptionEnabled(EnableOption::IndexStrengthReduction)) {
+    return inserted;
+  }
+  return IndexStrengthReducer::run(inserted);
 }
 
 } // namespace nvfuser
@@ -109,7 +109,10 @@ class CommonScalarMap {
 };
 
 //! Insert allocations of hoisted indices. Must be called after
-//! collecting all common indices.
+//! collecting all common indices. With EnableOption::IndexStrengthReduction,
+//! hoisted indices of serial loops of the form base + index * stride are then
+//! computed by a running scalar that is advanced by step * stride at the end
+//! of each iteration instead of a multiplication.
 std::vector<Expr*> allocateCommonScalars(const std::vector<Expr*>& exprs);
 
 } // namespace nvfuser
@@ -157,6 +157,12 @@ bool isTvOp(const Expr* expr) {
           MatmulOp,
           MmaOp,
           LinearOp,
+          GroupedMatmulOp,
+          SegmentedReductionOp,
+          EmbeddingBwdOp,
+          ScanOp,
+          SortOp,
+          TopKOp,
           SdpaFwdOp,
           SdpaBwdOp,
           BroadcastOp,
@@ -976,6 +982,15 @@ bool isReductionInitExpr(const Expr* expr) {
   return true;
 }
 
+bool hasUniformWelfordInputN(const WelfordOp* wop) {
+  if (!wop->inN()->isConstScalar()) {
+    return false;
+  }
+  // Threads with a false read predicate would contribute N = 0
+  const kir::Predicate* pred = wop->predicate();
+  return pred != nullptr && pred->hasValue() && pred->value()->isTrue();
+}
+
 bool predicateAtEnd(ForLoop* loop) {
   auto loop_id = loop->iter_domain();
   auto split = dynamic_cast<Split*>(loop_id->definition());
@@ -266,6 +266,13 @@ std::array<UnitDim, 2> getMmaLayout(const MmaOp* expr);
 // buffer.
 bool isReductionInitExpr(const Expr* expr);
 
+// Returns true if the input N of a block-parallel WelfordOp is the same
+// on every thread of the block, i.e., it is a constant and the op is not
+// predicated. The count of each partial result then follows from the
+// shape of the reduction tree, so N does not need to be kept in shared
+// memory.
+bool hasUniformWelfordInputN(const WelfordOp* wop);
+
 // Return true if it is sufficient to predicate the end of the loop
 // iteration. An aligned vectorized loop is one example where it is
 // guaranteed to be valid by the validation checks. More generally,
@@ -674,9 +674,14 @@ class VectorizeValidator : public OptInDispatch {
         "Tv has no definition, cannot validate vectorization:",
         tv);
     // TernaryOp(where) is a could have multiple inputs. But we only support
-    // single TensorView input for vectorization.
+    // single TensorView input for vectorization. The index of IndexSelectOp is
+    // read once per vector, so only its lookup is a vectorized producer.
+    std::vector<Val*> tv_inputs = tv_def->inputs();
+    if (auto* index_select = dynamic_cast<IndexSelectOp*>(tv_def)) {
+      tv_inputs = {index_select->lookupTv()};
+    }
     TensorView* producer_tv = nullptr;
-    for (auto input : tv_def->inputs()) {
+    for (auto input : tv_inputs) {
       if (!input->isA<TensorView>()) {
         continue;
       }
@@ -817,7 +822,7 @@ void validateAndCollectVectorizeInfo(Fusion* fusion) {
       Expr* def = tv->definition();
       NVF_ERROR(
           def == nullptr || def->isA<LoadStoreOp>() || def->isA<SliceOp>() ||
-              def->isA<PadOp>() ||
+              def->isA<PadOp>() || def->isA<IndexSelectOp>() ||
               (def->isA<TernaryOp>() &&
                def->as<TernaryOp>()->getTernaryOpType() ==
                    TernaryOpType::Where) ||
@@ -940,6 +945,13 @@ namespace {
 //!  of mma ops are swizzled and also validates
 //!  specialization of tidx as lane id.
 void validateMmaTensors(MmaOp* mma) {
+  // tcgen05.mma accumulates in tensor memory, which is not allocated by
+  // lowering yet
+  NVF_CHECK(
+      !mma->isBlackwell(),
+      "Blackwell MMA macros are not supported by codegen yet: ",
+      toString(mma->macro()));
+
   bool tidx_validated = false;
   std::vector<TensorView*> to_validate = {mma->out()->as<TensorView>()};
 
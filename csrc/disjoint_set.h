@@ -9,8 +9,11 @@
 
 #include <exceptions.h>
 
+#include <c10/util/irange.h>
+
 #include <algorithm>
 #include <initializer_list>
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -37,6 +40,10 @@ std::string abstractToString(T ref) {
 // Vector like class that will prevent adding duplicate entries by also
 // maintaing a set
 //
+// Most sets of IterDomains are small, so the set is only maintained once there
+// are more than kMaxLinearSize entries. Smaller containers are searched
+// linearly, which is faster than hashing.
+//
 // TODO: Can we support std::back_inserter with this class?
 template <typename T, typename Hash = std::hash<T>>
 class VectorOfUniqueEntries {
@@ -74,6 +81,20 @@ class VectorOfUniqueEntries {
 
   // Returns if a node was actually added
   bool pushBack(T entry) {
+    if (isLinear()) {
+      if (has(entry)) {
+        return false;
+      }
+      vector_.push_back(entry);
+      if (isLinear()) {
+        set_is_current_ = false;
+      } else {
+        set_.clear();
+        set_.insert(vector_.begin(), vector_.end());
+        set_is_current_ = true;
+      }
+      return true;
+    }
     if (set_.emplace(entry).second) {
       vector_.push_back(entry);
       return true;
@@ -81,6 +102,13 @@ class VectorOfUniqueEntries {
     return false;
   }
 
+  void reserve(int64_t size) {
+    vector_.reserve(size);
+    if (size > kMaxLinearSize) {
+      set_.reserve(size);
+    }
+  }
+
   // Returns true if any node was added
   bool pushBack(const VectorOfUniqueEntries<T, Hash>& other) {
     return pushBack(other.vector());
@@ -140,6 +168,11 @@ class VectorOfUniqueEntries {
   }
 
   const std::unordered_set<T>& set() const {
+    if (!set_is_current_) {
+      set_.clear();
+      set_.insert(vector_.begin(), vector_.end());
+      set_is_current_ = true;
+    }
     return set_;
   }
 
@@ -173,8 +206,8 @@ class VectorOfUniqueEntries {
     NVF_ERROR(!empty());
 #endif // defined(NDEBUG) && !defined(NVFUSER_EXPLICIT_CHECK)
     T v = vector_.back();
-    set_.erase(v);
     vector_.pop_back();
+    eraseFromSet(v);
     return v;
   }
 
@@ -186,6 +219,7 @@ class VectorOfUniqueEntries {
   void clear() {
     vector_.clear();
     set_.clear();
+    set_is_current_ = true;
   }
 
   // Returns the number of elements in this container
@@ -195,20 +229,27 @@ class VectorOfUniqueEntries {
 
   // Returns if entry is in this vector
   bool has(T entry) const {
+    if (isLinear()) {
+      return std::find(vector_.begin(), vector_.end(), entry) != vector_.end();
+    }
     return set_.find(entry) != set_.end();
   }
 
   // Erase given entry from the containers if
   //  there is a match.
   int64_t erase(T entry) {
+    const auto size = vector_.size();
     vector_.erase(
         std::remove_if(
             vector_.begin(),
             vector_.end(),
             [entry](T val) { return val == entry; }),
         vector_.end());
-
-    return static_cast<int64_t>(set_.erase(entry));
+    if (vector_.size() == size) {
+      return 0;
+    }
+    eraseFromSet(entry);
+    return 1;
   }
 
   // Insert elements at the end of the container.
@@ -276,9 +317,28 @@ class VectorOfUniqueEntries {
     return ss.str();
   }
 
+  static constexpr int64_t kMaxLinearSize = 8;
+
  private:
+  bool isLinear() const {
+    return (int64_t)vector_.size() <= kMaxLinearSize;
+  }
+
+  // Updates set_ after entry was erased from vector_
+  void eraseFromSet(T entry) {
+    if (isLinear()) {
+      set_is_current_ = false;
+    } else {
+      set_.erase(entry);
+    }
+  }
+
   std::vector<T> vector_;
-  std::unordered_set<T, Hash> set_;
+  // Holds the entries of vector_ if there are more than kMaxLinearSize of
+  // them, or if set_is_current_. Otherwise it is only built when set() is
+  // called.
+  mutable std::unordered_set<T, Hash> set_;
+  mutable bool set_is_current_ = true;
 };
 
 //! Container class DisjointSet models equivalence relationships
@@ -307,6 +367,8 @@ class DisjointSets {
     using std::swap;
     swap(sets1.disjoint_sets_, sets2.disjoint_sets_);
     swap(sets1.disjoint_set_maps_, sets2.disjoint_set_maps_);
+    swap(sets1.set_indices_, sets2.set_indices_);
+    swap(sets1.num_erased_sets_, sets2.num_erased_sets_);
   }
 
   // Warning: returned values should never be modified. This accessor isn't
@@ -318,6 +380,7 @@ class DisjointSets {
   // Warning: returned values should never be modified. This accessor isn't
   // strictly safe as VectorOfUniqueEntries is not returned as a const.
   const std::vector<DisjointSet>& disjointSets() const {
+    compact();
     return disjoint_sets_;
   }
 
@@ -354,11 +417,10 @@ class DisjointSets {
       return std::make_pair(disjoint_set_maps_it, false);
     }
 
-    disjoint_sets_.push_back(
-        std::make_shared<VectorOfUniqueEntries<T, Hash>>());
-    disjoint_sets_.back()->pushBack(entry);
-    return disjoint_set_maps_.emplace(
-        std::make_pair(entry, disjoint_sets_.back()));
+    auto new_set = std::make_shared<VectorOfUniqueEntries<T, Hash>>();
+    new_set->pushBack(entry);
+    addSet(new_set);
+    return disjoint_set_maps_.emplace(std::make_pair(entry, new_set));
   }
 
   // Adds all of the disjoint set belonging to entry1 to the disjoint set
@@ -377,9 +439,11 @@ class DisjointSets {
     }
 
     // Make and map new set
-    disjoint_sets_.push_back(
-        std::make_shared<VectorOfUniqueEntries<T, Hash>>());
-    auto new_set = disjoint_sets_.back();
+    auto new_set = std::make_shared<VectorOfUniqueEntries<T, Hash>>();
+    new_set->reserve(
+        (set_0_found ? set_it_0->second->size() : 1) +
+        (set_1_found ? set_it_1->second->size() : 1));
+    addSet(new_set);
 
     // Add an entry to new_set along with the other entries previously
     // grouped together with the entry. The existing set is erased.
@@ -391,8 +455,7 @@ class DisjointSets {
           new_set->pushBack(existing_entry);
           disjoint_set_maps_[existing_entry] = new_set;
         }
-        disjoint_sets_.erase(std::find(
-            disjoint_sets_.begin(), disjoint_sets_.end(), existing_set));
+        eraseSet(existing_set);
       } else {
         new_set->pushBack(entry);
         disjoint_set_maps_[entry] = new_set;
@@ -461,8 +524,7 @@ class DisjointSets {
           set->front() == entry,
           "Disjoint set container found to be in inconsistent state.");
       disjoint_set_maps_.erase(entry);
-      disjoint_sets_.erase(
-          std::find(disjoint_sets_.begin(), disjoint_sets_.end(), set));
+      eraseSet(set);
     } else {
       disjoint_set_maps_.erase(entry);
       set->erase(entry);
@@ -477,7 +539,7 @@ class DisjointSets {
   // Warning: constructed on every call, consider caching result.
   VectorOfUniqueEntries<T, Hash> getAllElements() const {
     VectorOfUniqueEntries<T, Hash> all_elements;
-    for (auto set : disjoint_sets_) {
+    for (const auto& set : disjointSets()) {
       for (auto entry : set->vector()) {
         all_elements.pushBack(entry);
       }
@@ -489,13 +551,15 @@ class DisjointSets {
   void clear() {
     disjoint_set_maps_.clear();
     disjoint_sets_.clear();
+    set_indices_.clear();
+    num_erased_sets_ = 0;
   }
 
   std::string toString() const {
     std::stringstream ss;
     ss << "disjoint sets{\n";
     const std::string sep("  ");
-    for (auto s_ptr : disjoint_sets_) {
+    for (const auto& s_ptr : disjointSets()) {
       auto& set = *s_ptr;
       ss << sep << abstractToString(set) << "\n";
     }
@@ -504,18 +568,61 @@ class DisjointSets {
   }
 
   int64_t size() const {
-    return disjoint_sets_.size();
+    return (int64_t)disjoint_sets_.size() - num_erased_sets_;
   }
 
  private:
+  void addSet(const DisjointSet& set) {
+    set_indices_.emplace(set.get(), disjoint_sets_.size());
+    disjoint_sets_.push_back(set);
+  }
+
+  // Erasing a set leaves a null entry in disjoint_sets_, so that merging sets
+  // doesn't search and shift disjoint_sets_. Null entries are dropped when
+  // they are the majority or when disjoint_sets_ is accessed.
+  void eraseSet(const DisjointSet& set) {
+    auto index_it = set_indices_.find(set.get());
+    NVF_ERROR(
+        index_it != set_indices_.end(),
+        "Disjoint set container found to be in inconsistent state.");
+    disjoint_sets_.at(index_it->second).reset();
+    set_indices_.erase(index_it);
+    ++num_erased_sets_;
+    if (num_erased_sets_ * 2 > (int64_t)disjoint_sets_.size()) {
+      compact();
+    }
+  }
+
+  // Drops the null entries of disjoint_sets_, keeping the order of the sets
+  void compact() const {
+    if (num_erased_sets_ == 0) {
+      return;
+    }
+    disjoint_sets_.erase(
+        std::remove(disjoint_sets_.begin(), disjoint_sets_.end(), nullptr),
+        disjoint_sets_.end());
+    for (const auto i : c10::irange(disjoint_sets_.size())) {
+      set_indices_[disjoint_sets_[i].get()] = i;
+    }
+    num_erased_sets_ = 0;
+  }
+
   // Disjoint sets
   DisjointSetMap disjoint_set_maps_;
 
-  // Keep a list of disjoint_sets that's deterministic to iterate over
+  // Keep a list of disjoint_sets that's deterministic to iterate over. It is
+  // compacted lazily, see eraseSet.
   //
   // TODO: Should this just be a
   // VectorOfUniqueEntries<std::shared_ptr<VectorOfUniqueEntries ?
-  std::vector<DisjointSet> disjoint_sets_;
+  mutable std::vector<DisjointSet> disjoint_sets_;
+
+  // Index of each set in disjoint_sets_
+  mutable std::unordered_map<const VectorOfUniqueEntries<T, Hash>*, size_t>
+      set_indices_;
+
+  // Number of null entries in disjoint_sets_
+  mutable int64_t num_erased_sets_ = 0;
 };
 
 template <typename T, typename Hash>
@@ -524,10 +631,10 @@ DisjointSets<T, Hash>::DisjointSets(const DisjointSets<T, Hash>& other) {
 
   // Deep copy the vector of the disjoint sets, keeping the same
   // ordering of the sets.
-  for (const auto& other_set : other.disjoint_sets_) {
+  for (const auto& other_set : other.disjointSets()) {
     auto new_set = std::make_shared<VectorOfUniqueEntries<T, Hash>>(*other_set);
     int new_set_index = disjoint_sets_.size();
-    disjoint_sets_.emplace_back(new_set);
+    addSet(new_set);
     NVF_ERROR(
         ptr_map.emplace(other_set, new_set_index).second,
         "Duplicated set found: ",
@@ -545,8 +652,7 @@ DisjointSets<T, Hash>::DisjointSets(const DisjointSets<T, Hash>& other) {
 template <typename T, typename Hash>
 DisjointSets<T, Hash>& DisjointSets<T, Hash>::operator=(
     const DisjointSets<T, Hash>& other) {
-  disjoint_set_maps_.clear();
-  disjoint_sets_.clear();
+  clear();
 
   DisjointSets<T, Hash> copy(other);
   swap(*this, copy);
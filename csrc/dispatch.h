@@ -88,6 +88,9 @@ class Val;
   f(ScatterOp);                   \
   f(RNGOp);                       \
   f(ReductionOp);                 \
+  f(ScanOp);                      \
+  f(SortOp);                      \
+  f(TopKOp);                      \
   f(GroupedReductionOp);          \
   f(WelfordOp);                   \
   f(GroupedWelfordOp);            \
@@ -109,6 +112,9 @@ class Val;
   f(Resize);                      \
   f(MatmulOp);                    \
   f(LinearOp);                    \
+  f(GroupedMatmulOp);             \
+  f(SegmentedReductionOp);        \
+  f(EmbeddingBwdOp);              \
   f(SdpaFwdOp);                   \
   f(SdpaBwdOp);                   \
   f(Communication);               \
@@ -143,6 +149,8 @@ class Val;
   f(AllocateFusedReduction);          \
   f(InitMagicZero);                   \
   f(UpdateMagicZero);                 \
+  f(IncrementScalar);                 \
+  f(RecordTimelineEvent);             \
   f(GetRNGSeedAndOffsetFromHost);     \
   f(EncodeTensorMapTiled);
 #define DISPATCH_FOR_ALL_HIR_EXPRS(f) \
@@ -153,6 +161,13 @@ class Val;
   f(GetCurrentStream);                \
   f(Wait);                            \
   f(Synchronize);                     \
+  f(RecordEvent);                     \
+  f(WaitEvent);                       \
+  f(Deallocate);                      \
+  f(SymmetricAllocate);               \
+  f(GetRemoteTensor);                 \
+  f(PutSignal);                       \
+  f(WaitSignal);                      \
   f(StartCoalescing);                 \
   f(EndCoalescing);
 
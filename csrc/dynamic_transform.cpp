@@ -21,6 +21,7 @@
 #include <transform_view.h>
 #include <utils.h>
 
+#include <algorithm>
 #include <optional>
 
 namespace nvfuser {
@@ -57,9 +58,39 @@ DynamicTransformInitialInfo DynamicTransformInitialInfo::clone(
   for (const auto v : root_dynamic_vals_) {
     cloned_info.root_dynamic_vals_.insert(ir_cloner.clone(v));
   }
+  cloned_info.root_dynamic_val_positions_ = root_dynamic_val_positions_;
+  cloned_info.has_fingerprint_ = has_fingerprint_;
   return cloned_info;
 }
 
+std::optional<std::vector<int64_t>> DynamicTransformInitialInfo::fingerprint(
+    const KernelArgumentHolder& args) const {
+  if (!has_fingerprint_) {
+    return std::nullopt;
+  }
+  std::vector<int64_t> values;
+  values.reserve(root_dynamic_val_positions_.size());
+  for (const auto& [input_pos, axis] : root_dynamic_val_positions_) {
+    NVF_ERROR(
+        input_pos < (int64_t)args.size(),
+        "Expected at least ",
+        input_pos + 1,
+        " arguments but received ",
+        args.size());
+    const PolymorphicValue& arg = *args[input_pos];
+    if (axis >= 0) {
+      values.push_back(arg.as<at::Tensor>().size(axis));
+    } else if (arg.is<int64_t>()) {
+      values.push_back(arg.as<int64_t>());
+    } else if (arg.is<bool>()) {
+      values.push_back((int64_t)arg.as<bool>());
+    } else {
+      return std::nullopt;
+    }
+  }
+  return values;
+}
+
 std::string DynamicTransformInitialInfo::toString() const {
   std::stringstream ss;
   ss << "DynamicTransformInitialInfo\n";
@@ -227,6 +258,50 @@ class DynamicTransformInitialInfoBuilder : public IterVisitor {
         info_.scalar_inputs_affecting_concretization_.insert(i);
       }
     }
+
+    finalizeRootDynamicValPositions();
+  }
+
+  //! Locate each root dynamic Val in the fusion inputs so that a fingerprint
+  //! of the concretization can be read from the arguments
+  void finalizeRootDynamicValPositions() {
+    std::unordered_map<Val*, std::pair<int64_t, int64_t>> input_positions;
+    const auto& inputs = info_.fusion()->inputs();
+    for (const auto i : c10::irange((int64_t)inputs.size())) {
+      auto tv = dynamic_cast<TensorView*>(inputs.at(i));
+      if (tv == nullptr) {
+        if (inputs.at(i)->isIntegralScalar() ||
+            inputs.at(i)->dtype() == DataType::Bool) {
+          input_positions.emplace(inputs.at(i), std::make_pair(i, -1));
+        }
+        continue;
+      }
+      const auto logical_dom =
+          TensorDomain::noReductions(tv->getLogicalDomain());
+      for (const auto axis : c10::irange((int64_t)logical_dom.size())) {
+        input_positions.emplace(
+            logical_dom.at(axis)->getMaybeExpandedExtent(),
+            std::make_pair(i, axis));
+      }
+    }
+
+    for (auto v : info_.root_dynamic_vals_) {
+      if (v->isConstScalar()) {
+        continue;
+      }
+      auto it = input_positions.find(v);
+      if (it == input_positions.end()) {
+        info_.root_dynamic_val_positions_.clear();
+        return;
+      }
+      info_.root_dynamic_val_positions_.push_back(it->second);
+    }
+    // root_dynamic_vals_ is unordered, so sort to make fingerprints
+    // comparable
+    std::sort(
+        info_.root_dynamic_val_positions_.begin(),
+        info_.root_dynamic_val_positions_.end());
+    info_.has_fingerprint_ = true;
   }
 
   //! Convert maybe_zero_extents_set_ to a vector so we can index it reliably
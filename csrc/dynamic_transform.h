@@ -21,12 +21,15 @@
 
 #include <functional>
 #include <memory>
+#include <optional>
+#include <utility>
 #include <vector>
 
 namespace nvfuser {
 
 class Fusion;
 class DynamicTransformInitialInfoBuilder;
+class KernelArgumentHolder;
 
 //! Initial information derived only from the symbolic Fusion without input
 //! sizes
@@ -100,6 +103,15 @@ class DynamicTransformInitialInfo {
     return scalar_inputs_affecting_concretization_;
   }
 
+  //! Return the values of getRootDynamicVals() given the fusion inputs in
+  //! args. Concretization only depends on these values, so args with equal
+  //! fingerprints have equal concretization info. This reads args directly
+  //! instead of binding them to an ExpressionEvaluator. Returns std::nullopt
+  //! if a root dynamic Val is neither an integer scalar input nor an extent
+  //! of an input TensorView.
+  std::optional<std::vector<int64_t>> fingerprint(
+      const KernelArgumentHolder& args) const;
+
  protected:
   //! Holds the set of scalar fusion inputs that affect concretization.
   std::unordered_set<size_t> scalar_inputs_affecting_concretization_;
@@ -133,6 +145,14 @@ class DynamicTransformInitialInfo {
   // Root Vals that determine concretization
   std::unordered_set<Val*> root_dynamic_vals_;
 
+  // Where each non-constant root dynamic Val is found in the fusion inputs,
+  // as (input position, axis) pairs. The axis is -1 for scalar inputs.
+  std::vector<std::pair<int64_t, int64_t>> root_dynamic_val_positions_;
+
+  // Whether all root dynamic Vals are found in the fusion inputs, i.e.
+  // whether root_dynamic_val_positions_ can be used as a fingerprint
+  bool has_fingerprint_ = false;
+
   friend class DynamicTransformInitialInfoBuilder;
 };
 
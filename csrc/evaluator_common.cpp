@@ -15,6 +15,8 @@
 #include <runtime/executor_kernel_arg.h>
 #include <tensor_metadata.h>
 
+#include <algorithm>
+#include <numeric>
 #include <optional>
 
 namespace nvfuser {
@@ -80,13 +82,17 @@ std::vector<Val*> makeSortedEvaluationList(std::vector<Val*> input) {
 }
 
 //! Kernel IR utility, collects all the symbolic values
-//!  used in allocation nodes.
+//!  used in allocation nodes, including the addresses of
+//!  shared memory buffers, which size the dynamic shared memory.
 void collectBufferSizes(
     std::vector<Val*>& into,
     const std::vector<Expr*>& exprs) {
   for (auto expr : exprs) {
     if (auto allocate = dynamic_cast<kir::Allocate*>(expr)) {
       into.push_back(allocate->size());
+      if (allocate->address() != nullptr) {
+        into.push_back(allocate->address());
+      }
     } else if (auto for_loop = dynamic_cast<ForLoop*>(expr)) {
       collectBufferSizes(into, for_loop->body().exprs());
     } else if (auto ite = dynamic_cast<kir::IfThenElse*>(expr)) {
@@ -122,7 +128,14 @@ std::vector<Val*> collectRuntimeUsedValues(Fusion* fusion) {
   }
   // Collect allocation sizes:
   if (fusion->isA<kir::Kernel>()) {
-    collectBufferSizes(ret, fusion->as<kir::Kernel>()->topLevelExprs());
+    auto kernel = fusion->as<kir::Kernel>();
+    collectBufferSizes(ret, kernel->topLevelExprs());
+    // Collect the simplified extents of the parallel types, which are
+    // evaluated for the launch parameters of every new shape
+    for (const auto& [p_type, extent] :
+         kernel->summary().parallel_dimension_map.getMap()) {
+      ret.push_back(extent);
+    }
   }
   return makeSortedEvaluationList(ret);
 }
@@ -206,6 +219,10 @@ void PrecomputedValues::initializeValueList(
   num_of_values_ = (int)sorted_value_list.size();
   defined_ = std::vector<bool>(num_of_values_, false);
   is_constant_ = std::vector<bool>(num_of_values_, false);
+  is_bound_ = std::vector<bool>(num_of_values_, false);
+  was_defined_ = std::vector<bool>(num_of_values_, false);
+  was_bound_ = std::vector<bool>(num_of_values_, false);
+  is_dirty_ = std::vector<bool>(num_of_values_, false);
   values_ = std::vector<PolymorphicValue>(num_of_values_, PolymorphicValue());
 
   // Fill in constants and assign evaluator indices
@@ -245,6 +262,15 @@ void PrecomputedValues::print() const {
 
 void PrecomputedValues::evaluate() {
   FUSER_PERF_SCOPE("PrecomputedValues::Evaluate");
+  if (has_previous_values_) {
+    // A value bound in the previous cycle but not yet in this one must not
+    // be reused by the instructions consuming it
+    for (const auto i : c10::irange(num_of_values_)) {
+      if (was_bound_[i] && !is_bound_[i]) {
+        is_dirty_[i] = true;
+      }
+    }
+  }
   value_machine_->run();
   validate();
 }
@@ -253,8 +279,15 @@ void PrecomputedValues::invalidate() {
   // clear binding values
   binding_log_.clear();
 
+  // keep the state of this cycle to be reused by the next one
+  has_previous_values_ = has_valid_values_;
+  was_defined_.swap(defined_);
+  was_bound_.swap(is_bound_);
+  std::fill(is_dirty_.begin(), is_dirty_.end(), false);
+
   // invalidate value entries
   std::fill(defined_.begin(), defined_.end(), false);
+  std::fill(is_bound_.begin(), is_bound_.end(), false);
 
   // invalidate flag
   has_valid_values_ = false;
@@ -279,13 +312,18 @@ PrecomputedValues PrecomputedValues::clone(IrCloner& ir_cloner) const {
   pv.values_.insert(pv.values_.end(), values_.begin(), values_.end());
   pv.binding_log_.insert(
       pv.binding_log_.end(), binding_log_.begin(), binding_log_.end());
+  pv.is_bound_ = is_bound_;
+  pv.has_previous_values_ = has_previous_values_;
+  pv.was_defined_ = was_defined_;
+  pv.was_bound_ = was_bound_;
+  pv.is_dirty_ = is_dirty_;
 
   pv.symbols_.resize(symbols_.size());
   for (const auto i : c10::irange(symbols_.size())) {
     pv.symbols_[i] = ir_cloner.clone(symbols_[i]);
   }
 
-  pv.value_machine_->copyFrom(*value_machine_.get());
+  pv.value_machine_->copyFrom(*value_machine_.get(), ir_cloner);
 
   return pv;
 }
@@ -407,6 +445,16 @@ NaiveValueMachine::NaiveValueMachine(PrecomputedValues& precomputed_values)
         makeBinaryOp(bop);
       } else if (auto top = dynamic_cast<TernaryOp*>(def)) {
         makeTernaryOp(top);
+      } else if (auto ldst = dynamic_cast<LoadStoreOp*>(def)) {
+        makeSetOp(ldst);
+      } else if (auto get_attr = dynamic_cast<GetAttr*>(def)) {
+        makeGetAttr(get_attr);
+      } else if (auto get_item = dynamic_cast<GetItem*>(def)) {
+        makeGetItem(get_item);
+      } else if (def->isOneOf<ArrayConstruct, ReverseArray>()) {
+        // StructConstruct is not handled because the producers of structs
+        // are not in the workspace. See makeSortedEvaluationList.
+        makeEvaluateOp(def);
       } else {
         // There could be some ops not supported yet. For these ops, we will
         // bind their outputs. So ignoring them here.
@@ -415,44 +463,49 @@ NaiveValueMachine::NaiveValueMachine(PrecomputedValues& precomputed_values)
   }
 }
 
-void NaiveValueMachine::copyFrom(const NaiveValueMachine& other) {
+void NaiveValueMachine::copyFrom(
+    const NaiveValueMachine& other,
+    IrCloner& ir_cloner) {
   num_of_instructions_ = other.num_of_instructions_;
-
-  inst_type_.clear();
-  inst_type_.insert(
-      inst_type_.end(), other.inst_type_.begin(), other.inst_type_.end());
-
-  uop_type_.clear();
-  uop_type_.insert(
-      uop_type_.end(), other.uop_type_.begin(), other.uop_type_.end());
-
-  data_type_.clear();
-  data_type_.insert(
-      data_type_.end(), other.data_type_.begin(), other.data_type_.end());
-
-  bop_type_.clear();
-  bop_type_.insert(
-      bop_type_.end(), other.bop_type_.begin(), other.bop_type_.end());
-
-  src0_.clear();
-  src0_.insert(src0_.end(), other.src0_.begin(), other.src0_.end());
-
-  src1_.clear();
-  src1_.insert(src1_.end(), other.src1_.begin(), other.src1_.end());
-
-  dest_.clear();
-  dest_.insert(dest_.end(), other.dest_.begin(), other.dest_.end());
+  inst_type_ = other.inst_type_;
+  uop_type_ = other.uop_type_;
+  data_type_ = other.data_type_;
+  bop_type_ = other.bop_type_;
+  top_type_ = other.top_type_;
+  src0_ = other.src0_;
+  src1_ = other.src1_;
+  src2_ = other.src2_;
+  dest_ = other.dest_;
+  attr_name_ = other.attr_name_;
+  srcs_ = other.srcs_;
+
+  expr_.clear();
+  expr_.reserve(other.expr_.size());
+  for (Expr* expr : other.expr_) {
+    expr_.push_back(expr == nullptr ? nullptr : ir_cloner.clone(expr));
+  }
 }
 
 void NaiveValueMachine::run() {
   for (const auto i : c10::irange(num_of_instructions_)) {
+    int dest_index = dest_[i];
     // Skip this instruction if the dest location
     //  has already been computed or is constant.
-    if (precomputed_values_.defined_[dest_[i]] ||
-        precomputed_values_.is_constant_[dest_[i]]) {
+    if (precomputed_values_.defined_[dest_index] ||
+        precomputed_values_.is_constant_[dest_index]) {
+      continue;
+    }
+    // Reuse the result of the previous cycle if none of the
+    //  operands changed. The instructions are topologically
+    //  sorted, so the operands are already final here.
+    if (precomputed_values_.has_previous_values_ &&
+        precomputed_values_.was_defined_[dest_index] &&
+        !precomputed_values_.is_dirty_[dest_index] && !hasDirtyOperand(i)) {
+      precomputed_values_.defined_[dest_index] = true;
       continue;
     }
     runInstruction(i);
+    precomputed_values_.is_dirty_[dest_index] = true;
   }
 }
 
@@ -509,6 +562,69 @@ void NaiveValueMachine::makeTernaryOp(TernaryOp* top) {
   dest_[index] = out;
 }
 
+void NaiveValueMachine::makeSetOp(LoadStoreOp* ldst) {
+  int in = ldst->in()->evaluatorIndex();
+  int out = ldst->out()->evaluatorIndex();
+  NVF_ERROR(in >= 0, "Integer Machine: unknown input: ", ldst);
+  NVF_ERROR(out >= 0, "Integer Machine: unknown out: ", ldst);
+
+  int index = makeInstructionEntry();
+  inst_type_[index] = InstructionType::SET_OP;
+  src0_[index] = in;
+  dest_[index] = out;
+}
+
+void NaiveValueMachine::makeGetAttr(GetAttr* get_attr) {
+  int in = get_attr->struct_()->evaluatorIndex();
+  int out = get_attr->out()->evaluatorIndex();
+  NVF_ERROR(in >= 0, "Integer Machine: unknown struct: ", get_attr);
+  NVF_ERROR(out >= 0, "Integer Machine: unknown out: ", get_attr);
+
+  int index = makeInstructionEntry();
+  inst_type_[index] = InstructionType::GET_ATTR;
+  attr_name_[index] = get_attr->attr();
+  src0_[index] = in;
+  dest_[index] = out;
+}
+
+void NaiveValueMachine::makeGetItem(GetItem* get_item) {
+  int in0 = get_item->array()->evaluatorIndex();
+  int in1 = get_item->index()->evaluatorIndex();
+  int out = get_item->out()->evaluatorIndex();
+  NVF_ERROR(in0 >= 0, "Integer Machine: unknown array: ", get_item);
+  NVF_ERROR(in1 >= 0, "Integer Machine: unknown index: ", get_item);
+  NVF_ERROR(out >= 0, "Integer Machine: unknown out: ", get_item);
+
+  int index = makeInstructionEntry();
+  inst_type_[index] = InstructionType::GET_ITEM;
+  src0_[index] = in0;
+  src1_[index] = in1;
+  dest_[index] = out;
+}
+
+void NaiveValueMachine::makeEvaluateOp(Expr* expr) {
+  NVF_ERROR(
+      expr->outputs().size() == 1,
+      "Integer Machine: expected a single output: ",
+      expr);
+  int out = expr->output(0)->evaluatorIndex();
+  NVF_ERROR(out >= 0, "Integer Machine: unknown out: ", expr);
+
+  std::vector<int> ins;
+  ins.reserve(expr->inputs().size());
+  for (Val* in : expr->inputs()) {
+    NVF_ERROR(
+        in->evaluatorIndex() >= 0, "Integer Machine: unknown input: ", expr);
+    ins.push_back(in->evaluatorIndex());
+  }
+
+  int index = makeInstructionEntry();
+  inst_type_[index] = InstructionType::EVALUATE_OP;
+  expr_[index] = expr;
+  srcs_[index] = std::move(ins);
+  dest_[index] = out;
+}
+
 int NaiveValueMachine::makeInstructionEntry() {
   int index = num_of_instructions_++;
   inst_type_.emplace_back(InstructionType::UNARY_OP);
@@ -520,14 +636,56 @@ int NaiveValueMachine::makeInstructionEntry() {
   src1_.emplace_back(-1);
   src2_.emplace_back(-1);
   dest_.emplace_back(-1);
+  attr_name_.emplace_back();
+  expr_.emplace_back(nullptr);
+  srcs_.emplace_back();
   return index;
 }
 
+bool NaiveValueMachine::hasDirtyOperand(int index) const {
+  const auto& is_dirty = precomputed_values_.is_dirty_;
+  for (int src_index : {src0_[index], src1_[index], src2_[index]}) {
+    if (src_index >= 0 && is_dirty[src_index]) {
+      return true;
+    }
+  }
+  return std::any_of(
+      srcs_[index].begin(), srcs_[index].end(), [&is_dirty](int src_index) {
+        return is_dirty[src_index];
+      });
+}
+
+bool NaiveValueMachine::isOperandReady(int operand_index) const {
+  return precomputed_values_.defined_[operand_index] ||
+      precomputed_values_.is_constant_[operand_index];
+}
+
 void NaiveValueMachine::runInstruction(int index) {
   switch (inst_type_[index]) {
     case InstructionType::SET_OP:
-      precomputed_values_.values_[dest_[index]] =
-          precomputed_values_.values_[src0_[index]];
+      if (isOperandReady(src0_[index])) {
+        precomputed_values_.values_[dest_[index]] =
+            precomputed_values_.values_[src0_[index]];
+        precomputed_values_.defined_[dest_[index]] = true;
+      }
+      break;
+    case InstructionType::GET_ATTR:
+      if (isOperandReady(src0_[index])) {
+        precomputed_values_.values_[dest_[index]] =
+            precomputed_values_.values_[src0_[index]]->*attr_name_[index];
+        precomputed_values_.defined_[dest_[index]] = true;
+      }
+      break;
+    case InstructionType::GET_ITEM:
+      if (isOperandReady(src0_[index]) && isOperandReady(src1_[index])) {
+        const auto& array = precomputed_values_.values_[src0_[index]];
+        const auto& item = precomputed_values_.values_[src1_[index]];
+        precomputed_values_.values_[dest_[index]] = array[item];
+        precomputed_values_.defined_[dest_[index]] = true;
+      }
+      break;
+    case InstructionType::EVALUATE_OP:
+      runEvaluateOp(index);
       break;
     case InstructionType::UNARY_OP:
       runUnaryOp(index);
@@ -541,6 +699,123 @@ void NaiveValueMachine::runInstruction(int index) {
   }
 }
 
+namespace {
+
+// The fast paths below compute the most common scalar ops, i.e., index and
+// extent arithmetic, without dispatching on the types held by
+// PolymorphicValue. They return false when there is no fast path for the op,
+// in which case dest is untouched. The results must match the generic path.
+
+bool runInt64UnaryOp(UnaryOpType op, int64_t a, PolymorphicValue& dest) {
+  switch (op) {
+    case UnaryOpType::Neg:
+      dest = -a;
+      return true;
+    case UnaryOpType::Abs:
+      dest = std::abs(a);
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool runInt64BinaryOp(
+    BinaryOpType op,
+    int64_t a,
+    int64_t b,
+    PolymorphicValue& dest) {
+  switch (op) {
+    case BinaryOpType::Add:
+      dest = a + b;
+      return true;
+    case BinaryOpType::Sub:
+      dest = a - b;
+      return true;
+    case BinaryOpType::Mul:
+      dest = a * b;
+      return true;
+    case BinaryOpType::Div:
+      NVF_CHECK(b != 0);
+      dest = a / b;
+      return true;
+    case BinaryOpType::Mod:
+      NVF_CHECK(b != 0);
+      dest = a % b;
+      return true;
+    case BinaryOpType::CeilDiv:
+      NVF_CHECK(b != 0);
+      dest = b > 0 ? (a + b - 1) / b : (a + b + 1) / b;
+      return true;
+    case BinaryOpType::Max:
+      dest = std::max(a, b);
+      return true;
+    case BinaryOpType::Min:
+      dest = std::min(a, b);
+      return true;
+    case BinaryOpType::Gcd:
+      dest = std::gcd(a, b);
+      return true;
+    case BinaryOpType::LT:
+      dest = a < b;
+      return true;
+    case BinaryOpType::LE:
+      dest = a <= b;
+      return true;
+    case BinaryOpType::Eq:
+      dest = a == b;
+      return true;
+    case BinaryOpType::NE:
+      dest = a != b;
+      return true;
+    case BinaryOpType::GE:
+      dest = a >= b;
+      return true;
+    case BinaryOpType::GT:
+      dest = a > b;
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool runDoubleBinaryOp(
+    BinaryOpType op,
+    double a,
+    double b,
+    PolymorphicValue& dest) {
+  switch (op) {
+    case BinaryOpType::Add:
+      dest = a + b;
+      return true;
+    case BinaryOpType::Sub:
+      dest = a - b;
+      return true;
+    case BinaryOpType::Mul:
+      dest = a * b;
+      return true;
+    case BinaryOpType::Div:
+      NVF_CHECK(b != 0);
+      dest = a / b;
+      return true;
+    case BinaryOpType::LT:
+      dest = a < b;
+      return true;
+    case BinaryOpType::LE:
+      dest = a <= b;
+      return true;
+    case BinaryOpType::GE:
+      dest = a >= b;
+      return true;
+    case BinaryOpType::GT:
+      dest = a > b;
+      return true;
+    default:
+      return false;
+  }
+}
+
+} // namespace
+
 void NaiveValueMachine::runUnaryOp(int index) {
   using namespace PolymorphicValue_functions;
   int src_index = src0_[index];
@@ -555,6 +830,12 @@ void NaiveValueMachine::runUnaryOp(int index) {
   auto& src = precomputed_values_.values_[src_index];
   auto& dest = precomputed_values_.values_[dest_index];
 
+  if (src.is<int64_t>() &&
+      runInt64UnaryOp(uop_type_[index], src.as<int64_t>(), dest)) {
+    precomputed_values_.defined_[dest_index] = true;
+    return;
+  }
+
   switch (uop_type_[index]) {
     case UnaryOpType::Neg:
       dest = -src;
@@ -612,6 +893,19 @@ void NaiveValueMachine::runBinaryOp(int index) {
   auto& rhs = precomputed_values_.values_[src1_index];
   auto& dest = precomputed_values_.values_[dest_index];
 
+  if (lhs.is<int64_t>() && rhs.is<int64_t>() &&
+      runInt64BinaryOp(
+          bop_type_[index], lhs.as<int64_t>(), rhs.as<int64_t>(), dest)) {
+    precomputed_values_.defined_[dest_index] = true;
+    return;
+  }
+  if (lhs.is<double>() && rhs.is<double>() &&
+      runDoubleBinaryOp(
+          bop_type_[index], lhs.as<double>(), rhs.as<double>(), dest)) {
+    precomputed_values_.defined_[dest_index] = true;
+    return;
+  }
+
   switch (bop_type_[index]) {
     case BinaryOpType::Add:
       dest = lhs + rhs;
@@ -735,4 +1029,27 @@ void NaiveValueMachine::runTernaryOp(int index) {
   precomputed_values_.defined_[dest_index] = true;
 }
 
+void NaiveValueMachine::runEvaluateOp(int index) {
+  const std::vector<int>& srcs = srcs_[index];
+  if (!std::all_of(srcs.begin(), srcs.end(), [this](int src_index) {
+        return isOperandReady(src_index);
+      })) {
+    return;
+  }
+
+  operand_buffer_.clear();
+  for (int src_index : srcs) {
+    operand_buffer_.push_back(precomputed_values_.values_[src_index]);
+  }
+
+  // The exprs handled here don't look up other values, so an empty
+  // evaluator suffices
+  ExpressionEvaluator ee;
+  std::vector<PolymorphicValue> outputs =
+      expr_[index]->evaluate(ee, operand_buffer_);
+  NVF_ERROR(outputs.size() == 1);
+  precomputed_values_.values_[dest_[index]] = std::move(outputs[0]);
+  precomputed_values_.defined_[dest_[index]] = true;
+}
+
 } // namespace nvfuser
@@ -30,9 +30,22 @@ struct TensorArgAbstract;
 //!   and it currently must be associated with an instance of
 //!   PrecomputedValues that will provide the workspace
 //!   containing the concrete values for the values.
+//!  Registers are the workspace slots. Integer and double
+//!   operands take a fast path that skips the dispatch of
+//!   PolymorphicValue operators.
 class NaiveValueMachine {
   //! The generic types of instructions supported for this machine.
-  enum class InstructionType { UNARY_OP, BINARY_OP, TERNARY_OP, SET_OP };
+  //!  EVALUATE_OP falls back to Expr::evaluate for the few scalar
+  //!  exprs without a dedicated instruction.
+  enum class InstructionType {
+    UNARY_OP,
+    BINARY_OP,
+    TERNARY_OP,
+    SET_OP,
+    GET_ATTR,
+    GET_ITEM,
+    EVALUATE_OP
+  };
 
  public:
   //! Constructor lowers all the expr IR nodes stored in precomputed_values
@@ -42,11 +55,13 @@ class NaiveValueMachine {
   //! Copy all values other than `precomputed_values_` from other
   //! This would be better implemented as a copy constructor, except that would
   //! also presumably bind precomputed_values_ which we could not then rebind,
-  //! as we need to during cloning.
-  void copyFrom(const NaiveValueMachine& other);
+  //! as we need to during cloning. The exprs of EVALUATE_OP instructions are
+  //! cloned with ir_cloner.
+  void copyFrom(const NaiveValueMachine& other, IrCloner& ir_cloner);
 
   //! Runs all the instructions and write results to the associated
-  //!  precomputed_values.
+  //!  precomputed_values. Instructions whose operands did not change
+  //!  since the previous evaluation cycle keep their previous results.
   void run();
 
  private:
@@ -59,6 +74,27 @@ class NaiveValueMachine {
   //! Convert an ternary IR expr to an instruction
   void makeTernaryOp(TernaryOp* bop);
 
+  //! Convert a scalar LoadStoreOp to an instruction
+  void makeSetOp(LoadStoreOp* ldst);
+
+  //! Convert a GetAttr to an instruction
+  void makeGetAttr(GetAttr* get_attr);
+
+  //! Convert a GetItem to an instruction
+  void makeGetItem(GetItem* get_item);
+
+  //! Convert any other single-output expr to an instruction evaluated with
+  //!  Expr::evaluate
+  void makeEvaluateOp(Expr* expr);
+
+  //! Returns true if the operand at the given workspace index
+  //!  has been bound, computed, or is a constant.
+  bool isOperandReady(int operand_index) const;
+
+  //! Returns true if any operand of the instruction at the given
+  //!  index may differ from the previous evaluation cycle.
+  bool hasDirtyOperand(int index) const;
+
   //! Create an empty instruction with all default values
   //!  and place it at the end of the instruction buffer.
   int makeInstructionEntry();
@@ -77,6 +113,9 @@ class NaiveValueMachine {
   //! Runs a ternary operation at given index of instruction buffer
   void runTernaryOp(int index);
 
+  //! Runs a generic evaluation at given index of instruction buffer
+  void runEvaluateOp(int index);
+
  private:
   friend PrecomputedValues;
 
@@ -129,6 +168,21 @@ class NaiveValueMachine {
 
   //! Destination of each instruction.
   std::vector<int> dest_;
+
+  //! Attribute name of each GET_ATTR instruction, empty for other
+  //!  instructions.
+  std::vector<std::string> attr_name_;
+
+  //! Expr of each EVALUATE_OP instruction, nullptr for other
+  //!  instructions.
+  std::vector<Expr*> expr_;
+
+  //! Operands of each EVALUATE_OP instruction, empty for other
+  //!  instructions.
+  std::vector<std::vector<int>> srcs_;
+
+  //! Reused to gather the operands of EVALUATE_OP instructions
+  std::vector<PolymorphicValue> operand_buffer_;
 };
 
 //! PrecomputedValues:
@@ -209,7 +263,12 @@ class PrecomputedValues {
     if (index < 0 || is_constant_[index]) {
       return;
     }
+    if (has_previous_values_ && !is_dirty_[index] &&
+        (!was_bound_[index] || !isSame(values_[index], value))) {
+      is_dirty_[index] = true;
+    }
     defined_[index] = true;
+    is_bound_[index] = true;
     values_[index] = value;
     binding_log_.emplace_back(index, value);
   }
@@ -218,7 +277,8 @@ class PrecomputedValues {
     bindValue_(index, PolymorphicValue(value));
   }
 
-  //! Invalidate all computed values in the workspace.
+  //! Invalidate all computed values in the workspace. The values are kept
+  //!  as the previous cycle so the next evaluation can reuse them.
   void invalidate();
 
   //! Interface for subclasses to access symbols_
@@ -276,6 +336,32 @@ class PrecomputedValues {
   //! Stores the concrete values at each index.
   std::vector<PolymorphicValue> values_;
 
+  //! Marks if a value has been bound, as opposed to computed,
+  //!  at each index in the current evaluation cycle.
+  std::vector<bool> is_bound_;
+
+  //! Incremental evaluation:
+  //!  Usually only a few inputs, e.g., the batch size, change
+  //!  between launches. The values of the previous evaluation
+  //!  cycle are then reused for the instructions whose operands
+  //!  did not change, instead of evaluating all of them again.
+
+  //! True if the values of the previous evaluation cycle are
+  //!  still in the workspace and can be reused.
+  bool has_previous_values_ = false;
+
+  //! Marks if a value was defined at each index at the end of
+  //!  the previous evaluation cycle.
+  std::vector<bool> was_defined_;
+
+  //! Marks if a value was bound at each index in the previous
+  //!  evaluation cycle.
+  std::vector<bool> was_bound_;
+
+  //! Marks if the value at each index may differ from the
+  //!  previous evaluation cycle.
+  std::vector<bool> is_dirty_;
+
   //! Use a single monostate to represent null, instead of creating a new
   //! PolymorphicValue for each null.
   PolymorphicValue null_ = std::monostate{};
@@ -249,6 +249,10 @@ const PolymorphicValue& ExpressionEvaluator::evaluate(const Val* value) {
   return evaluate(value, known_values_);
 }
 
+ScalarValue ExpressionEvaluator::evaluateScalar(const Val* value) {
+  return ScalarValue::fromPolymorphicValue(evaluate(value, known_values_));
+}
+
 PolymorphicValue ExpressionEvaluator::evaluate(const Val* value) const {
   std::unordered_map<const Val*, PolymorphicValue> known_values;
   return evaluate(value, known_values);
@@ -258,8 +262,10 @@ const PolymorphicValue& ExpressionEvaluator::evaluate(
     const Val* value,
     std::unordered_map<const Val*, PolymorphicValue>& known_values) const {
   if (precomputed_values_ && precomputed_values_->hasValidValues()) {
-    if (precomputed_values_->getMaybeValueFor(value).hasValue()) {
-      return precomputed_values_->getMaybeValueFor(value);
+    const PolymorphicValue& precomputed_value =
+        precomputed_values_->getMaybeValueFor(value);
+    if (precomputed_value.hasValue()) {
+      return precomputed_value;
     }
   }
 
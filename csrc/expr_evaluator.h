@@ -14,6 +14,7 @@
 #include <iter_visitor.h>
 #include <logical_domain_map.h>
 #include <polymorphic_value.h>
+#include <scalar_value.h>
 #include <visibility.h>
 
 #include <string>
@@ -45,9 +46,21 @@ class ExpressionEvaluator {
   //! Set a concrete value for a parallel dimension
   void bind(ParallelType pt, PolymorphicValue concrete_value);
 
+  //! Record the value of an IR variable computed outside of this evaluator,
+  //!  e.g., by evaluating its definition directly. Unlike bind, the value is
+  //!  not validated and the extents of a TensorView are not bound.
+  void setEvaluatedValue(const Val* value, PolymorphicValue concrete_value) {
+    known_values_[value] = std::move(concrete_value);
+  }
+
   //! Try to evaluate a Fusion IR value
   NVF_API const PolymorphicValue& evaluate(const Val* value);
 
+  //! Try to evaluate a Fusion IR value to an int64_t, double, or bool.
+  //!  Returns an empty ScalarValue if the value can't be evaluated or is not
+  //!  of these types. The result is cheap to copy, unlike PolymorphicValue.
+  NVF_API ScalarValue evaluateScalar(const Val* value);
+
   //! Try to evaluate a parallel dimension
   const PolymorphicValue& evaluate(ParallelType pt);
 
@@ -25,6 +25,7 @@
 #include <regex>
 #include <sstream>
 #include <string>
+#include <typeinfo>
 #include <unordered_set>
 #include <vector>
 
@@ -2760,6 +2761,150 @@ Val* cancelTermsInPredicate(Val* value, const Context& context) {
 
 } // namespace rules
 
+namespace {
+
+thread_local SimplifyExprCache* active_simplify_expr_cache = nullptr; // NOLINT
+
+} // namespace
+
+SimplifyExprCacheGuard::SimplifyExprCacheGuard(SimplifyExprCache* cache)
+    : prev_cache_(active_simplify_expr_cache) {
+  active_simplify_expr_cache = cache;
+}
+
+SimplifyExprCacheGuard::~SimplifyExprCacheGuard() {
+  active_simplify_expr_cache = prev_cache_;
+}
+
+SimplifyExprCache* SimplifyExprCacheGuard::getCurCache() {
+  return active_simplify_expr_cache;
+}
+
+size_t SimplifyExprCache::hash(Val* value) {
+  auto it = val_hashes_.find(value);
+  if (it != val_hashes_.end()) {
+    return it->second;
+  }
+
+  // Values without definitions are only the same as themselves unless they
+  // are constants or named scalars of the same name, see Val::sameAs and
+  // NamedScalar::sameAs. Tensors are variables to the simplifier, so they are
+  // not hashed through their definitions either.
+  size_t h = typeid(*value).hash_code();
+  auto def = value->definition();
+  if (auto ns = dynamic_cast<NamedScalar*>(value)) {
+    hashCombine(h, std::hash<std::string>{}(ns->name()));
+  } else if (def == nullptr || value->isA<TensorView>()) {
+    if (!value->value().hasValue()) {
+      hashCombine(h, std::hash<Val*>{}(value));
+    } else if (value->value().is<int64_t>()) {
+      hashCombine(h, std::hash<int64_t>{}(value->value().as<int64_t>()));
+    } else if (value->value().is<bool>()) {
+      hashCombine(h, std::hash<bool>{}(value->value().as<bool>()));
+    } else if (value->value().is<double>()) {
+      hashCombine(h, std::hash<double>{}(value->value().as<double>()));
+    }
+  } else {
+    hashCombine(h, typeid(*def).hash_code());
+    if (auto uop = dynamic_cast<UnaryOp*>(def)) {
+      hashCombine(h, static_cast<size_t>(uop->getUnaryOpType()));
+    } else if (auto bop = dynamic_cast<BinaryOp*>(def)) {
+      hashCombine(h, static_cast<size_t>(bop->getBinaryOpType()));
+    } else if (auto top = dynamic_cast<TernaryOp*>(def)) {
+      hashCombine(h, static_cast<size_t>(top->getTernaryOpType()));
+    }
+    for (auto inp : def->inputs()) {
+      hashCombine(h, hash(inp));
+    }
+  }
+  val_hashes_.emplace(value, h);
+  return h;
+}
+
+size_t SimplifyExprCache::hash(
+    Val* value,
+    const std::list<VarInfo>& variables,
+    const std::vector<Val*>& assumptions,
+    bool preserve_error) {
+  size_t h = hash(value);
+  for (const auto& info : variables) {
+    hashCombine(h, std::hash<Val*>{}(info.variable));
+    hashCombine(h, info.is_unrolled_loop_index);
+  }
+  for (auto assumption : assumptions) {
+    hashCombine(h, hash(assumption));
+  }
+  hashCombine(h, preserve_error);
+  return h;
+}
+
+bool SimplifyExprCache::matches(
+    const Entry& entry,
+    Val* value,
+    const std::list<VarInfo>& variables,
+    const std::vector<Val*>& assumptions,
+    bool preserve_error) const {
+  if (entry.value->container() != value->container() ||
+      entry.num_axioms != value->fusion()->axioms().size() ||
+      entry.preserve_error != preserve_error ||
+      entry.variables.size() != variables.size() ||
+      entry.assumptions.size() != assumptions.size()) {
+    return false;
+  }
+  auto var_it = variables.begin();
+  for (const auto& [var, is_unrolled_loop_index] : entry.variables) {
+    if (var != var_it->variable ||
+        is_unrolled_loop_index != var_it->is_unrolled_loop_index) {
+      return false;
+    }
+    ++var_it;
+  }
+  for (auto i : c10::irange(assumptions.size())) {
+    if (!entry.assumptions.at(i)->sameAs(assumptions.at(i))) {
+      return false;
+    }
+  }
+  return entry.value->sameAs(value);
+}
+
+Val* SimplifyExprCache::find(
+    Val* value,
+    const std::list<VarInfo>& variables,
+    const std::vector<Val*>& assumptions,
+    bool preserve_error) {
+  auto it = entries_.find(hash(value, variables, assumptions, preserve_error));
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+  for (const auto& entry : it->second) {
+    if (matches(entry, value, variables, assumptions, preserve_error)) {
+      ++num_hits_;
+      return entry.simplified;
+    }
+  }
+  return nullptr;
+}
+
+void SimplifyExprCache::insert(
+    Val* value,
+    const std::list<VarInfo>& variables,
+    const std::vector<Val*>& assumptions,
+    bool preserve_error,
+    Val* simplified) {
+  Entry entry;
+  entry.value = value;
+  entry.variables.reserve(variables.size());
+  for (const auto& info : variables) {
+    entry.variables.emplace_back(info.variable, info.is_unrolled_loop_index);
+  }
+  entry.assumptions = assumptions;
+  entry.preserve_error = preserve_error;
+  entry.num_axioms = value->fusion()->axioms().size();
+  entry.simplified = simplified;
+  entries_[hash(value, variables, assumptions, preserve_error)].emplace_back(
+      std::move(entry));
+}
+
 #define RUN_PASS(pass_name)                                     \
   if (disabled_passes == nullptr ||                             \
       (!disabled_passes->empty() &&                             \
@@ -2782,8 +2927,6 @@ Val* simplifyExpr(
     std::vector<Val*> assumptions,
     bool preserve_error) {
   FusionGuard fg(value->fusion());
-  const Context context(variables, assumptions, preserve_error);
-  auto logger = debug_print::createLogger(value);
 
   // nullptr -> disable nothing
   // empty set -> disable everything
@@ -2798,6 +2941,20 @@ Val* simplifyExpr(
         std::make_unique<std::unordered_set<std::string>>(v.begin(), v.end());
   }
 
+  // Partially disabled simplification is not memoized
+  auto cache = disabled_passes == nullptr
+      ? SimplifyExprCacheGuard::getCurCache()
+      : nullptr;
+  if (cache != nullptr) {
+    if (auto cached =
+            cache->find(value, variables, assumptions, preserve_error)) {
+      return cached;
+    }
+  }
+
+  const Context context(variables, assumptions, preserve_error);
+  auto logger = debug_print::createLogger(value);
+
   Val* simplified = value;
   Val* old_simplified = nullptr;
   while (old_simplified != simplified) {
@@ -2835,6 +2992,9 @@ Val* simplifyExpr(
 
   auto unflattened = assoc_comm::unflatten(simplified, context);
   logger->record(debug_print::kUnflattenName, unflattened);
+  if (cache != nullptr) {
+    cache->insert(value, variables, assumptions, preserve_error, unflattened);
+  }
   return unflattened;
 }
 
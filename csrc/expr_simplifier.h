@@ -11,6 +11,10 @@
 #include <ir/all_nodes.h>
 #include <visibility.h>
 
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 // Note: [The Mathematics of Integer Arithmetic]
@@ -154,6 +158,86 @@ NVF_API Val* simplifyExpr(
     std::vector<Val*> assumptions = {},
     bool preserve_error = false);
 
+// Memoized results of simplifyExpr. While a cache is active on the current
+// thread (see SimplifyExprCacheGuard), simplifying a value that is the same
+// (in the sense of sameAs) as one simplified before, with the same variables,
+// assumptions and axioms, returns the earlier result instead of running all the
+// passes again. Values are hash-consed by a structural hash of their
+// definitions, which is memoized per Val so shared subexpressions are only
+// hashed once.
+//
+// Cached Vals are not owned. A cache must not outlive the containers of the
+// values simplified with it, e.g., GpuLower keeps one per lowering session.
+class SimplifyExprCache {
+ public:
+  // Returns the memoized simplification of value, or nullptr if there is none
+  Val* find(
+      Val* value,
+      const std::list<VarInfo>& variables,
+      const std::vector<Val*>& assumptions,
+      bool preserve_error);
+
+  void insert(
+      Val* value,
+      const std::list<VarInfo>& variables,
+      const std::vector<Val*>& assumptions,
+      bool preserve_error,
+      Val* simplified);
+
+  int64_t numHits() const {
+    return num_hits_;
+  }
+
+ private:
+  struct Entry {
+    Val* value = nullptr;
+    std::vector<std::pair<Val*, bool>> variables;
+    std::vector<Val*> assumptions;
+    bool preserve_error = false;
+    size_t num_axioms = 0;
+    Val* simplified = nullptr;
+  };
+
+  size_t hash(Val* value);
+
+  size_t hash(
+      Val* value,
+      const std::list<VarInfo>& variables,
+      const std::vector<Val*>& assumptions,
+      bool preserve_error);
+
+  bool matches(
+      const Entry& entry,
+      Val* value,
+      const std::list<VarInfo>& variables,
+      const std::vector<Val*>& assumptions,
+      bool preserve_error) const;
+
+  // Structural hash of each Val seen so far
+  std::unordered_map<Val*, size_t> val_hashes_;
+
+  // Entries bucketed by the hash of their whole key
+  std::unordered_map<size_t, std::vector<Entry>> entries_;
+
+  int64_t num_hits_ = 0;
+};
+
+// Makes cache the active SimplifyExprCache of the current thread for the
+// lifetime of the guard. A nullptr cache disables memoization.
+class SimplifyExprCacheGuard {
+ public:
+  explicit SimplifyExprCacheGuard(SimplifyExprCache* cache);
+  ~SimplifyExprCacheGuard();
+
+  SimplifyExprCacheGuard(const SimplifyExprCacheGuard&) = delete;
+  SimplifyExprCacheGuard& operator=(const SimplifyExprCacheGuard&) = delete;
+
+  static SimplifyExprCache* getCurCache();
+
+ private:
+  SimplifyExprCache* prev_cache_ = nullptr;
+};
+
 class Context;
 namespace assoc_comm {
 // The expression type that represents the flattened ops. For example, if I have
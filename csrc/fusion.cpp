@@ -39,6 +39,7 @@ void swap(Fusion& a, Fusion& b) noexcept {
   swap(a.outputs_, b.outputs_);
 
   swap(a.io_alias_, b.io_alias_);
+  swap(a.donatable_inputs_, b.donatable_inputs_);
 }
 
 std::unique_ptr<SegmentedFusion> Fusion::segment(
@@ -72,7 +73,12 @@ IrCloner Fusion::copy(const Fusion* from, Fusion* to) {
     to->io_alias_[copied_output] = {
         .type = alias_info.type,
         .aliased_io = copied_input,
-        .hide_output = alias_info.hide_output};
+        .hide_output = alias_info.hide_output,
+        .slice_offset = ir_cloner.clone(alias_info.slice_offset),
+        .slice_axis = alias_info.slice_axis};
+  }
+  for (const Val* input : from->donatable_inputs_) {
+    to->donatable_inputs_.insert(ir_cloner.clone(input));
   }
 
   to->all_tv_uses_valid_ = from->all_tv_uses_valid_;
@@ -108,6 +114,124 @@ IrCloner Fusion::copy(const Fusion* from, Fusion* to) {
   return ir_cloner;
 }
 
+namespace {
+
+//! Records the originals of the Statements it clones, including the ones
+//! cloned transitively, e.g., the IterDomains of a TensorView
+class SubgraphCloner : public IrCloner {
+ public:
+  using IrCloner::IrCloner;
+
+  //! Originals of the clones, in the order they were cloned
+  const std::vector<const Statement*>& originals() const {
+    return originals_;
+  }
+
+  bool isCloned(const Statement* stmt) const {
+    return clones_map_.count(stmt) > 0;
+  }
+
+ protected:
+  Statement* handle(const Statement* s) override {
+    Statement* clone = IrCloner::handle(s);
+    originals_.push_back(s);
+    return clone;
+  }
+
+ private:
+  std::vector<const Statement*> originals_;
+};
+
+} // namespace
+
+IrCloner Fusion::copySubgraph(
+    const Fusion* from,
+    Fusion* to,
+    const std::vector<Expr*>& exprs,
+    const std::vector<Val*>& inputs,
+    const std::vector<Val*>& outputs) {
+  FUSER_PERF_SCOPE("Fusion::copySubgraph");
+  to->clear();
+  SubgraphCloner ir_cloner(to);
+  const std::unordered_set<const Val*> boundary(inputs.begin(), inputs.end());
+
+  for (Val* input : inputs) {
+    ir_cloner.clone(input);
+  }
+  for (Expr* expr : exprs) {
+    ir_cloner.clone(expr);
+  }
+  for (Val* output : outputs) {
+    ir_cloner.clone(output);
+  }
+  for (const auto& [output, alias_info] : from->io_alias_) {
+    if (!ir_cloner.isCloned(output)) {
+      continue;
+    }
+    to->io_alias_[ir_cloner.clone(output)] = {
+        .type = alias_info.type,
+        .aliased_io = ir_cloner.clone(alias_info.aliased_io),
+        .hide_output = alias_info.hide_output,
+        .slice_offset = ir_cloner.clone(alias_info.slice_offset),
+        .slice_axis = alias_info.slice_axis};
+  }
+  for (const auto& i : from->managed_data_) {
+    if (i.first.has_value()) {
+      to->managed_data_.emplace_back(i.second(ir_cloner, i.first), i.second);
+    } else {
+      to->managed_data_.emplace_back(i.first, i.second);
+    }
+  }
+  for (auto [k, v] : from->managed_named_data_) {
+    if (v.first.has_value()) {
+      to->managed_named_data_.insert(std::make_pair(
+          k, std::make_pair(v.second(ir_cloner, v.first), v.second)));
+    }
+  }
+
+  // Tensors are only defined by exprs, but the definitions of the other vals,
+  // e.g., the splits of an IterDomain or the ops computing an extent, are
+  // part of the subgraph. originals() grows while cloning them.
+  for (size_t i = 0; i < ir_cloner.originals().size(); ++i) {
+    const Statement* stmt = ir_cloner.originals().at(i);
+    if (!stmt->isVal()) {
+      continue;
+    }
+    const Val* val = stmt->asVal();
+    if (val->definition() != nullptr && !val->isA<TensorView>() &&
+        boundary.count(val) == 0) {
+      ir_cloner.clone(val->definition());
+    }
+  }
+
+  for (const Statement* stmt : ir_cloner.originals()) {
+    if (!stmt->isVal()) {
+      continue;
+    }
+    const Val* val = stmt->asVal();
+    Val* clone = ir_cloner.clone(val);
+    if (boundary.count(val) == 0 && ir_cloner.isCloned(val->definition_)) {
+      clone->setDefinition(ir_cloner.clone(val->definition_));
+    }
+    std::vector<Expr*> uses;
+    for (Expr* use : val->uses_) {
+      if (ir_cloner.isCloned(use)) {
+        uses.push_back(ir_cloner.clone(use));
+      }
+    }
+    clone->setUses(uses);
+  }
+
+  for (const Val* input : from->donatable_inputs_) {
+    if (ir_cloner.isCloned(input)) {
+      to->donatable_inputs_.insert(ir_cloner.clone(input));
+    }
+  }
+  to->expected_dynamic_smem_bytes_ = from->expected_dynamic_smem_bytes_;
+
+  return ir_cloner;
+}
+
 // Clang tidy complains when using default constructor for IrContainer instead
 // of copy constructor. Fusion::copy has a call to IrContainer::copy, so it's
 // redundant to use the IrContainer copy constructor, but it is harmless since
@@ -153,6 +277,7 @@ void Fusion::clear() noexcept {
   outputs_.clear();
 
   io_alias_.clear();
+  donatable_inputs_.clear();
 
   managed_data_.clear();
   managed_named_data_.clear();
@@ -811,6 +936,69 @@ void Fusion::aliasOutputToInput(
   }
 }
 
+void Fusion::aliasOutputToInputSlice(
+    Val* output,
+    Val* input,
+    int64_t axis,
+    Val* offset) {
+  auto* out_tv = dynamic_cast<TensorView*>(output);
+  auto* in_tv = dynamic_cast<TensorView*>(input);
+  NVF_CHECK(
+      out_tv != nullptr && in_tv != nullptr,
+      "Only tensors can be aliased to a slice");
+  NVF_CHECK(
+      offset->isIntegralScalar() &&
+          (offset->isFusionInput() || offset->isConstScalar()),
+      "The slice offset must be an integral fusion input or constant, but got ",
+      offset->toString());
+  NVF_CHECK(
+      out_tv->dtype() == in_tv->dtype(),
+      "The output must have the dtype of the aliased input");
+  NVF_CHECK(
+      !in_tv->hasAllocation() && !out_tv->hasAllocation(),
+      "Slice aliases don't support allocation domains");
+  NVF_CHECK(
+      !in_tv->hasBroadcast(),
+      "The input aliased to a slice can't have broadcast dimensions");
+  NVF_CHECK(
+      !output->isFusionInput(),
+      "A fusion input can't be aliased to a slice of another");
+  const std::vector<IterDomain*> in_logical =
+      TensorDomain::noReductions(in_tv->getLogicalDomain());
+  const std::vector<IterDomain*> out_logical =
+      TensorDomain::noReductions(out_tv->getLogicalDomain());
+  NVF_CHECK(
+      out_logical.size() == in_logical.size(),
+      "The output must have the rank of the aliased input");
+  axis = wrapDim(axis, (int64_t)in_logical.size());
+
+  aliasOutputToInput(output, input, AllocationType::ReuseBuffer);
+  AliasInfo& alias_info = io_alias_.at(output);
+  alias_info.slice_offset = offset;
+  alias_info.slice_axis = axis;
+
+  // The output is written as a strided view of the input, whose dimensions
+  // outer to the slice axis are no longer contiguous
+  const std::vector<std::optional<bool>>& in_contiguity =
+      in_tv->getContiguity();
+  std::vector<std::optional<bool>> contiguity;
+  int64_t in_index = 0;
+  for (IterDomain* id : out_tv->getLogicalDomain()) {
+    if (id->isReduction()) {
+      contiguity.push_back(std::nullopt);
+      continue;
+    }
+    if (id->isBroadcast()) {
+      contiguity.push_back(std::nullopt);
+    } else {
+      contiguity.push_back(
+          in_index >= axis && in_contiguity.at(in_index).value_or(false));
+    }
+    in_index++;
+  }
+  out_tv->setContiguity(contiguity);
+}
+
 const AliasInfo& Fusion::getOutputAlias(const Val* output) const {
   static AliasInfo no_alias_info{
       .type = AllocationType::New, .aliased_io = nullptr, .hide_output = false};
@@ -820,6 +1008,14 @@ const AliasInfo& Fusion::getOutputAlias(const Val* output) const {
   return no_alias_info;
 }
 
+void Fusion::markDonatable(Val* input) {
+  NVF_CHECK(
+      input->isFusionInput(),
+      "Only fusion inputs can be donated, but got ",
+      input->toString());
+  donatable_inputs_.insert(input);
+}
+
 bool Fusion::hasDynamicTransform() {
   return !ir_utils::getTVsWithDynamicTransform(this).empty();
 }
@@ -90,6 +90,12 @@ struct AliasInfo {
   // Whether integration should hide the output from users. This is currently
   // only used for ReuseBuffer.
   bool hide_output;
+  // Only used for ReuseBuffer. If set, the output is written to the slice of
+  // `aliased_io` starting at `slice_offset` along `slice_axis`, e.g., the keys
+  // and values of a decoding step appended to a KV cache. See
+  // Fusion::aliasOutputToInputSlice.
+  Val* slice_offset = nullptr;
+  int64_t slice_axis = -1;
 };
 
 //! Fusion is mutable but unique. Nodes cannot be copied in any way from one
@@ -242,11 +248,32 @@ class NVF_API Fusion : public IrContainer {
   // those of type `ReuseBuffer` are marked in fusion definitions.
   NVF_API void aliasOutputToInput(Val* output, Val* input, AllocationType type);
 
+  //! Like aliasOutputToInput with AllocationType::ReuseBuffer, but the output
+  //! is written in place of the slice of `input` starting at `offset` along
+  //! `axis`, whose size is the output's. `offset` is a fusion input or a
+  //! constant, so it may change from run to run without recompiling, e.g.,
+  //! the position of a decoding step in a KV cache. The rest of the input is
+  //! left untouched.
+  NVF_API void aliasOutputToInputSlice(
+      Val* output,
+      Val* input,
+      int64_t axis,
+      Val* offset);
+
   //! Returns the aliased input of a given output along with an `AliasInfo`
   //! describing how they alias. Returns <nullptr,nullptr> when `output` is not
   //! aliased.
   const AliasInfo& getOutputAlias(const Val* output) const;
 
+  //! Declares that the caller won't read `input` after running the fusion, so
+  //! its buffer may be reused for an output. InputDonationPass aliases such
+  //! inputs with outputs that are safe to write in place.
+  NVF_API void markDonatable(Val* input);
+
+  bool isDonatable(const Val* input) const {
+    return donatable_inputs_.count(input) > 0;
+  }
+
   bool isTVUseInfoValid() {
     return all_tv_uses_valid_;
   }
@@ -402,6 +429,18 @@ class NVF_API Fusion : public IrContainer {
 
   static IrCloner copy(const Fusion* from, Fusion* to);
 
+  //! Copies exprs into `to` together with inputs, outputs, and every Statement
+  //! they depend on, e.g., the IterDomain transforms and the scalar extents
+  //! of their tensors. The definitions of inputs and of tensors that exprs
+  //! don't define are not copied, so the copy costs the size of the subgraph
+  //! rather than of `from`. Inputs and outputs are not registered with `to`.
+  static IrCloner copySubgraph(
+      const Fusion* from,
+      Fusion* to,
+      const std::vector<Expr*>& exprs,
+      const std::vector<Val*>& inputs,
+      const std::vector<Val*>& outputs);
+
   //! During scheduling, this can be set to a non-negative value. If done, then
   //! during execution by KernelExecutor, we will check that this value matches
   //! the corresponding value in LaunchParams.
@@ -472,6 +511,9 @@ class NVF_API Fusion : public IrContainer {
   // io alias pointing from output to input
   std::unordered_map<const Val*, AliasInfo> io_alias_;
 
+  // inputs whose buffers may be reused for outputs
+  std::unordered_set<const Val*> donatable_inputs_;
+
   // Records if the current use data in the IR nodes are valid
   //  the states are either all valid or all invalid
   bool all_tv_uses_valid_ = false;
@@ -8,7 +8,17 @@
 
 #include <cupti.h>
 #include <fusion_profiler.h>
+#include <algorithm>
 #include <iomanip>
+#include <mutex>
+
+// The range profiler and its host API are available since CUDA 12.6
+#if __has_include(<cupti_range_profiler.h>)
+#include <cupti_profiler_host.h>
+#include <cupti_range_profiler.h>
+#include <cupti_target.h>
+#define NVFUSER_HAS_CUPTI_RANGE_PROFILER
+#endif
 
 namespace nvfuser {
 
@@ -56,6 +66,8 @@ void record_cupti_activity(CUpti_Activity* pRecord, FILE* pFileHandle) {
       constexpr double ms_convert = 1.0 / 1000000.0;
       prof.time_ms =
           static_cast<double>(pKARecord->end - pKARecord->start) * ms_convert;
+      prof.start_ns = pKARecord->start;
+      prof.end_ns = pKARecord->end;
       prof.grid = {pKARecord->gridX, pKARecord->gridY, pKARecord->gridZ};
       prof.block = {pKARecord->blockX, pKARecord->blockY, pKARecord->blockZ};
       prof.cluster = {
@@ -179,8 +191,232 @@ const char* profiler_state2string(const ProfilerState& pstate) {
   }
 }
 
+#ifdef NVFUSER_HAS_CUPTI_RANGE_PROFILER
+//! Metrics collected by NVFUSER_PROF=metrics without arguments
+const std::vector<std::string>& defaultMetrics() {
+  static const std::vector<std::string> metrics{
+      // DRAM bytes read and written
+      "dram__bytes.sum",
+      // L2 hit rate
+      "lts__t_sector_hit_rate.pct",
+      // Achieved occupancy
+      "sm__warps_active.avg.pct_of_peak_sustained_active",
+      // SM throughput
+      "sm__throughput.avg.pct_of_peak_sustained_elapsed",
+      // Shared memory bank conflicts
+      "l1tex__data_bank_conflicts_pipe_lsu_mem_shared.sum",
+      // Local memory stores, i.e., register spills
+      "l1tex__t_bytes_pipe_lsu_mem_local_op_st.sum"};
+  return metrics;
+}
+#endif // NVFUSER_HAS_CUPTI_RANGE_PROFILER
+
 } // namespace
 
+#ifdef NVFUSER_HAS_CUPTI_RANGE_PROFILER
+
+//! Collects the metrics of single kernel launches with the CUPTI range
+//! profiler. Each launch is a range of its own, which CUPTI replays as many
+//! times as the metrics need passes.
+class CuptiMetricSession {
+ public:
+  CuptiMetricSession(std::vector<std::string> metric_names);
+  ~CuptiMetricSession();
+
+  void start();
+  std::vector<std::pair<std::string, double>> stop();
+
+ private:
+  // A launch is a single range, this leaves room for the launches of
+  // libraries, e.g., by an ATen fallback
+  static constexpr size_t max_ranges{64};
+
+  std::vector<std::string> metric_names_;
+  std::vector<const char*> metric_name_ptrs_;
+  CUpti_RangeProfiler_Object* range_profiler_ = nullptr;
+  CUpti_Profiler_Host_Object* host_ = nullptr;
+  std::vector<uint8_t> config_image_;
+  std::vector<uint8_t> counter_data_image_;
+};
+
+CuptiMetricSession::CuptiMetricSession(std::vector<std::string> metric_names)
+    : metric_names_(std::move(metric_names)) {
+  for (const auto& name : metric_names_) {
+    metric_name_ptrs_.push_back(name.c_str());
+  }
+
+  static std::once_flag profiler_initialized;
+  std::call_once(profiler_initialized, []() {
+    CUpti_Profiler_Initialize_Params params = {
+        CUpti_Profiler_Initialize_Params_STRUCT_SIZE};
+    NVFUSER_CUPTI_SAFE_CALL(cuptiProfilerInitialize(&params));
+  });
+
+  CUcontext ctx = nullptr;
+  NVFUSER_CUDA_SAFE_CALL(cuCtxGetCurrent(&ctx));
+  CUdevice device = 0;
+  NVFUSER_CUDA_SAFE_CALL(cuCtxGetDevice(&device));
+
+  CUpti_RangeProfiler_Enable_Params enable_params = {
+      CUpti_RangeProfiler_Enable_Params_STRUCT_SIZE};
+  enable_params.ctx = ctx;
+  NVFUSER_CUPTI_SAFE_CALL(cuptiRangeProfilerEnable(&enable_params));
+  range_profiler_ = enable_params.pRangeProfilerObject;
+
+  CUpti_Device_GetChipName_Params chip_params = {
+      CUpti_Device_GetChipName_Params_STRUCT_SIZE};
+  chip_params.deviceIndex = (size_t)device;
+  NVFUSER_CUPTI_SAFE_CALL(cuptiDeviceGetChipName(&chip_params));
+
+  // The first call queries the size of the image
+  CUpti_RangeProfiler_GetCounterAvailability_Params availability_params = {
+      CUpti_RangeProfiler_GetCounterAvailability_Params_STRUCT_SIZE};
+  availability_params.ctx = ctx;
+  NVFUSER_CUPTI_SAFE_CALL(
+      cuptiRangeProfilerGetCounterAvailability(&availability_params));
+  std::vector<uint8_t> availability_image(
+      availability_params.counterAvailabilityImageSize);
+  availability_params.pCounterAvailabilityImage = availability_image.data();
+  NVFUSER_CUPTI_SAFE_CALL(
+      cuptiRangeProfilerGetCounterAvailability(&availability_params));
+
+  CUpti_Profiler_Host_Initialize_Params host_params = {
+      CUpti_Profiler_Host_Initialize_Params_STRUCT_SIZE};
+  host_params.profilerType = CUPTI_PROFILER_TYPE_RANGE_PROFILER;
+  host_params.pChipName = chip_params.pChipName;
+  host_params.pCounterAvailabilityImage = availability_image.data();
+  NVFUSER_CUPTI_SAFE_CALL(cuptiProfilerHostInitialize(&host_params));
+  host_ = host_params.pHostObject;
+
+  CUpti_Profiler_Host_ConfigAddMetrics_Params add_params = {
+      CUpti_Profiler_Host_ConfigAddMetrics_Params_STRUCT_SIZE};
+  add_params.pHostObject = host_;
+  add_params.ppMetricNames = metric_name_ptrs_.data();
+  add_params.numMetrics = metric_name_ptrs_.size();
+  NVFUSER_CUPTI_SAFE_CALL(cuptiProfilerHostConfigAddMetrics(&add_params));
+
+  CUpti_Profiler_Host_GetConfigImageSize_Params config_size_params = {
+      CUpti_Profiler_Host_GetConfigImageSize_Params_STRUCT_SIZE};
+  config_size_params.pHostObject = host_;
+  NVFUSER_CUPTI_SAFE_CALL(
+      cuptiProfilerHostGetConfigImageSize(&config_size_params));
+  config_image_.resize(config_size_params.configImageSize);
+
+  CUpti_Profiler_Host_GetConfigImage_Params config_params = {
+      CUpti_Profiler_Host_GetConfigImage_Params_STRUCT_SIZE};
+  config_params.pHostObject = host_;
+  config_params.configImageSize = config_image_.size();
+  config_params.pConfigImage = config_image_.data();
+  NVFUSER_CUPTI_SAFE_CALL(cuptiProfilerHostGetConfigImage(&config_params));
+
+  CUpti_RangeProfiler_GetCounterDataSize_Params counter_size_params = {
+      CUpti_RangeProfiler_GetCounterDataSize_Params_STRUCT_SIZE};
+  counter_size_params.pRangeProfilerObject = range_profiler_;
+  counter_size_params.pMetricNames = metric_name_ptrs_.data();
+  counter_size_params.numMetrics = metric_name_ptrs_.size();
+  counter_size_params.maxNumOfRanges = max_ranges;
+  counter_size_params.maxNumRangeTreeNodes = max_ranges;
+  NVFUSER_CUPTI_SAFE_CALL(
+      cuptiRangeProfilerGetCounterDataSize(&counter_size_params));
+  counter_data_image_.resize(counter_size_params.counterDataSize);
+}
+
+CuptiMetricSession::~CuptiMetricSession() {
+  CUpti_Profiler_Host_Deinitialize_Params host_params = {
+      CUpti_Profiler_Host_Deinitialize_Params_STRUCT_SIZE};
+  host_params.pHostObject = host_;
+  NVFUSER_CUPTI_SAFE_CALL(cuptiProfilerHostDeinitialize(&host_params));
+
+  CUpti_RangeProfiler_Disable_Params disable_params = {
+      CUpti_RangeProfiler_Disable_Params_STRUCT_SIZE};
+  disable_params.pRangeProfilerObject = range_profiler_;
+  NVFUSER_CUPTI_SAFE_CALL(cuptiRangeProfilerDisable(&disable_params));
+}
+
+void CuptiMetricSession::start() {
+  // Clear the ranges of the previous launch
+  CUpti_RangeProfiler_CounterDataImage_Initialize_Params init_params = {
+      CUpti_RangeProfiler_CounterDataImage_Initialize_Params_STRUCT_SIZE};
+  init_params.pRangeProfilerObject = range_profiler_;
+  init_params.counterDataSize = counter_data_image_.size();
+  init_params.pCounterData = counter_data_image_.data();
+  NVFUSER_CUPTI_SAFE_CALL(
+      cuptiRangeProfilerCounterDataImageInitialize(&init_params));
+
+  CUpti_RangeProfiler_SetConfig_Params config_params = {
+      CUpti_RangeProfiler_SetConfig_Params_STRUCT_SIZE};
+  config_params.pRangeProfilerObject = range_profiler_;
+  config_params.configSize = config_image_.size();
+  config_params.pConfig = config_image_.data();
+  config_params.counterDataImageSize = counter_data_image_.size();
+  config_params.pCounterDataImage = counter_data_image_.data();
+  config_params.range = CUPTI_AutoRange;
+  config_params.replayMode = CUPTI_KernelReplay;
+  config_params.maxRangesPerPass = max_ranges;
+  config_params.numNestingLevels = 1;
+  config_params.minNestingLevel = 1;
+  config_params.passIndex = 0;
+  config_params.targetNestingLevel = 0;
+  NVFUSER_CUPTI_SAFE_CALL(cuptiRangeProfilerSetConfig(&config_params));
+
+  CUpti_RangeProfiler_Start_Params start_params = {
+      CUpti_RangeProfiler_Start_Params_STRUCT_SIZE};
+  start_params.pRangeProfilerObject = range_profiler_;
+  NVFUSER_CUPTI_SAFE_CALL(cuptiRangeProfilerStart(&start_params));
+}
+
+std::vector<std::pair<std::string, double>> CuptiMetricSession::stop() {
+  CUpti_RangeProfiler_Stop_Params stop_params = {
+      CUpti_RangeProfiler_Stop_Params_STRUCT_SIZE};
+  stop_params.pRangeProfilerObject = range_profiler_;
+  NVFUSER_CUPTI_SAFE_CALL(cuptiRangeProfilerStop(&stop_params));
+  NVF_ERROR(
+      stop_params.isAllPassSubmitted,
+      "Kernel replay did not submit all the passes of the metrics!");
+
+  CUpti_RangeProfiler_DecodeData_Params decode_params = {
+      CUpti_RangeProfiler_DecodeData_Params_STRUCT_SIZE};
+  decode_params.pRangeProfilerObject = range_profiler_;
+  NVFUSER_CUPTI_SAFE_CALL(cuptiRangeProfilerDecodeData(&decode_params));
+
+  CUpti_RangeProfiler_GetCounterDataInfo_Params info_params = {
+      CUpti_RangeProfiler_GetCounterDataInfo_Params_STRUCT_SIZE};
+  info_params.pCounterDataImage = counter_data_image_.data();
+  info_params.counterDataImageSize = counter_data_image_.size();
+  NVFUSER_CUPTI_SAFE_CALL(cuptiRangeProfilerGetCounterDataInfo(&info_params));
+  if (info_params.numTotalRanges == 0) {
+    return {};
+  }
+
+  // The kernel of the segment is the last launch of the range
+  std::vector<double> values(metric_names_.size(), 0.0);
+  CUpti_Profiler_Host_EvaluateToGpuValues_Params eval_params = {
+      CUpti_Profiler_Host_EvaluateToGpuValues_Params_STRUCT_SIZE};
+  eval_params.pHostObject = host_;
+  eval_params.pCounterDataImage = counter_data_image_.data();
+  eval_params.counterDataImageSize = counter_data_image_.size();
+  eval_params.rangeIndex = info_params.numTotalRanges - 1;
+  eval_params.ppMetricNames = metric_name_ptrs_.data();
+  eval_params.numMetrics = metric_name_ptrs_.size();
+  eval_params.pMetricValues = values.data();
+  NVFUSER_CUPTI_SAFE_CALL(cuptiProfilerHostEvaluateToGpuValues(&eval_params));
+
+  std::vector<std::pair<std::string, double>> metrics;
+  metrics.reserve(metric_names_.size());
+  for (size_t i = 0; i < metric_names_.size(); ++i) {
+    metrics.emplace_back(metric_names_[i], values[i]);
+  }
+  return metrics;
+}
+
+#else
+
+//! Placeholder without the CUPTI range profiler, FusionProfiler::start
+//! rejects NVFUSER_PROF=metrics
+class CuptiMetricSession {};
+
+#endif // NVFUSER_HAS_CUPTI_RANGE_PROFILER
+
 std::ostream& operator<<(std::ostream& out, const ProfilerState& pstate) {
   return out << profiler_state2string(pstate);
 }
@@ -213,11 +449,15 @@ void CudaEventTimer::start() {
 }
 
 void CudaEventTimer::stop() {
+  stop(stream_);
+}
+
+void CudaEventTimer::stop(cudaStream_t s) {
   NVF_CHECK(
       state_ == ProfilerState::Running,
       "ProfilerState is not Running! ",
       state_);
-  NVFUSER_CUDA_RT_SAFE_CALL(cudaEventRecord(stop_event_, stream_));
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaEventRecord(stop_event_, s));
   state_ = ProfilerState::Finished;
 }
 
@@ -240,6 +480,23 @@ double CudaEventTimer::time() {
   return time_ms_;
 }
 
+double CudaEventTimer::startTimeSince(const CudaEventTimer& origin) {
+  NVF_CHECK(
+      state_ != ProfilerState::Ready && state_ != ProfilerState::Running &&
+          origin.state_ != ProfilerState::Ready &&
+          origin.state_ != ProfilerState::Running,
+      "Both timers must have stopped! ",
+      origin.state_,
+      " ",
+      state_);
+  float tmp{0.0};
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaEventSynchronize(origin.start_event_));
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaEventSynchronize(start_event_));
+  NVFUSER_CUDA_RT_SAFE_CALL(
+      cudaEventElapsedTime(&tmp, origin.start_event_, start_event_));
+  return static_cast<double>(tmp);
+}
+
 ProfilerState CudaEventTimer::state() const {
   return state_;
 }
@@ -293,6 +550,36 @@ ProfilerState HostTimer::state() const {
   return state_;
 }
 
+namespace {
+
+// FLOPs per clock per SM of the FP32 FMA units, i.e., 2x the FMA lanes
+int64_t fp32FlopsPerClockPerSm(int major, int minor) {
+  if (major >= 9 || (major == 8 && minor > 0)) {
+    return 256;
+  }
+  return 128;
+}
+
+// Dense FLOPs per clock per SM of the tensor cores for FP16 operands with FP32
+// accumulation
+int64_t fp16TensorFlopsPerClockPerSm(int major, int minor) {
+  if (major >= 10 && major < 12) {
+    return 8192;
+  }
+  if (major == 9) {
+    return 4096;
+  }
+  if (major == 8 && minor == 0) {
+    return 2048;
+  }
+  if (major >= 7) {
+    return 1024;
+  }
+  return 0;
+}
+
+} // namespace
+
 void DeviceDescriptor::generate(DeviceDescriptor& desc, int device) {
   desc.device = device;
   desc.name.reserve(100);
@@ -315,6 +602,43 @@ void DeviceDescriptor::generate(DeviceDescriptor& desc, int device) {
   desc.peak_bandwidth_gbs = static_comp *
       static_cast<double>(desc.memory_clock) *
       static_cast<double>(desc.bus_width);
+
+  NVFUSER_CUDA_SAFE_CALL(cuDeviceGetAttribute(
+      &desc.sm_count, CU_DEVICE_ATTRIBUTE_MULTIPROCESSOR_COUNT, device));
+  NVFUSER_CUDA_SAFE_CALL(cuDeviceGetAttribute(
+      &desc.sm_clock, CU_DEVICE_ATTRIBUTE_CLOCK_RATE, device));
+  NVFUSER_CUDA_SAFE_CALL(cuDeviceGetAttribute(
+      &desc.major, CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MAJOR, device));
+  NVFUSER_CUDA_SAFE_CALL(cuDeviceGetAttribute(
+      &desc.minor, CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MINOR, device));
+
+  // Peak FLOP/s calculation:
+  // The clock is the max boost clock in kHz, so the peaks are an upper bound
+  // (SMs * FLOPs per clock per SM * clock in kHz) * (1 GFLOP / 1e6 kFLOP)
+  const double sm_gigacycles = static_cast<double>(desc.sm_count) *
+      static_cast<double>(desc.sm_clock) * 1.0e-6;
+  desc.peak_fp32_gflops = sm_gigacycles *
+      static_cast<double>(fp32FlopsPerClockPerSm(desc.major, desc.minor));
+  desc.peak_fp16_tensor_gflops = sm_gigacycles *
+      static_cast<double>(fp16TensorFlopsPerClockPerSm(desc.major, desc.minor));
+}
+
+double DeviceDescriptor::peakTensorCoreGflops(DataType dtype) const {
+  if (peak_fp16_tensor_gflops == 0.0) {
+    return peak_fp32_gflops;
+  }
+  if (dtype == DataType::Half || dtype == DataType::BFloat16) {
+    return peak_fp16_tensor_gflops;
+  }
+  // TF32 runs at half the rate of FP16 and FP8 at twice the rate
+  if (dtype == DataType::Float && major >= 8) {
+    return peak_fp16_tensor_gflops / 2.0;
+  }
+  if ((dtype == DataType::Float8_e4m3fn || dtype == DataType::Float8_e5m2) &&
+      (major > 8 || (major == 8 && minor == 9))) {
+    return peak_fp16_tensor_gflops * 2.0;
+  }
+  return peak_fp32_gflops;
 }
 
 SegmentProfiler::SegmentProfiler(uint32_t id, bool cupti_disabled)
@@ -374,6 +698,18 @@ void SegmentProfiler::outputBytesAccessed(int64_t bytes) {
   output_bytes_ = bytes;
 }
 
+void SegmentProfiler::flopsExecuted(
+    int64_t flops,
+    std::optional<DataType> mma_dtype) {
+  flops_ = flops;
+  mma_dtype_ = mma_dtype;
+}
+
+void SegmentProfiler::metrics(
+    std::vector<std::pair<std::string, double>> values) {
+  metrics_ = std::move(values);
+}
+
 void SegmentProfiler::scheduler(const std::string& name) {
   scheduler_ = name;
 }
@@ -408,11 +744,16 @@ auto FusionProfile::toTuple(const FusionProfile& prof, size_t seg_id) {
       prof.percentage_peak_bandwidth,
       prof.input_bytes,
       prof.output_bytes,
+      prof.peak_memory_bytes,
       kp.segment_id,
       kp.time_ms,
       kp.compile_time_ms,
       kp.effective_bandwidth_gbs,
       kp.percentage_peak_bandwidth,
+      kp.gflops,
+      kp.percentage_peak_flops,
+      kp.bound,
+      kp.flops,
       kp.input_bytes,
       kp.output_bytes,
       kp.shared_mem_str,
@@ -424,6 +765,7 @@ auto FusionProfile::toTuple(const FusionProfile& prof, size_t seg_id) {
       kp.device,
       kp.stream,
       kp.peak_bandwidth_gbs,
+      kp.peak_gflops,
       kp.device_name,
       kp.name);
 }
@@ -455,8 +797,13 @@ void FusionProfile::reset() {
 
   input_bytes = 0;
   output_bytes = 0;
+  peak_memory_bytes = 0;
 
   kernel_profiles.clear();
+  compile_phases.clear();
+
+  communication_profiles.clear();
+  communication_time_ms = 0.0;
 }
 
 const std::vector<ProfileAttrDescriptor> FusionProfile::profile_attr_descs{
@@ -472,11 +819,16 @@ const std::vector<ProfileAttrDescriptor> FusionProfile::profile_attr_descs{
     {"%PkBw", false, false, false, 7, true, 2, std::nullopt},
     {"In(MB)", true, false, false, 8, true, 3, 1.0e-6},
     {"Out(MB)", true, false, false, 9, true, 3, 1.0e-6},
+    {"PeakMem(MB)", false, false, false, 11, true, 3, 1.0e-6},
     {"S-Seg#", false, true, false, 6, true, 0, std::nullopt},
     {"S-KerTm(ms)", false, true, false, 11, true, 3, std::nullopt},
     {"S-CmpTm(ms)", true, true, false, 11, true, 3},
     {"S-EffBw(GB/s)", false, true, false, 13, true, 3, std::nullopt},
     {"S-%PkBw", false, true, false, 7, true, 2, std::nullopt},
+    {"S-GFLOP/s", false, true, false, 11, true, 3, std::nullopt},
+    {"S-%PkFlop", false, true, false, 9, true, 2, std::nullopt},
+    {"S-Bound", false, true, false, 7, false, 0, std::nullopt},
+    {"S-GFlop", true, true, false, 9, true, 3, 1.0e-9},
     {"S-In(MB)", false, true, false, 8, true, 3, 1.0e-6},
     {"S-Out(MB)", false, true, false, 9, true, 3, 1.0e-6},
     {"S-Smem[Dyn,Stat]", false, true, true, 16, false, 0, std::nullopt},
@@ -488,6 +840,7 @@ const std::vector<ProfileAttrDescriptor> FusionProfile::profile_attr_descs{
     {"S-Dev", true, true, false, 5, true, 0, std::nullopt},
     {"S-Stm", true, true, false, 5, true, 0, std::nullopt},
     {"S-PkBw(GB/s)", true, true, false, 12, true, 3, std::nullopt},
+    {"S-PkFlop(GF/s)", true, true, false, 14, true, 3, std::nullopt},
     {"S-DeviceName", true, true, false, 20, false, 0, std::nullopt},
     {"S-KerName", false, true, false, 20, false, 0, std::nullopt}};
 
@@ -602,6 +955,47 @@ std::ostream& operator<<(std::ostream& os, const FusionProfile& fp) {
     }
   }
 
+  // Print the communication timeline of host programs
+  if (!fp.communication_profiles.empty()) {
+    os << std::setfill(' ') << std::left << std::setw(6) << "C-Com#" << " "
+       << std::setw(14) << "C-Name" << " " << std::setw(5) << "C-Dev"
+       << " " << std::setw(6) << "C-Team" << " " << std::setw(9) << "C-MB"
+       << " " << std::setw(11) << "C-Start(ms)" << " " << std::setw(10)
+       << "C-Time(ms)" << " " << std::setw(13) << "C-AlgBw(GB/s)" << " "
+       << std::setw(13) << "C-BusBw(GB/s)" << std::endl;
+    for (size_t i = 0; i < fp.communication_profiles.size(); ++i) {
+      const CommunicationProfile& cprof = fp.communication_profiles.at(i);
+      os << std::right << std::fixed << std::setw(6) << i << " "
+         << std::setw(14) << cprof.name << " " << std::setw(5) << cprof.device
+         << " " << std::setw(6) << cprof.team_size << " " << std::setw(9)
+         << std::setprecision(3) << static_cast<double>(cprof.bytes) * 1.0e-6
+         << " " << std::setw(11) << cprof.start_ms << " " << std::setw(10)
+         << cprof.time_ms << " " << std::setw(13)
+         << cprof.algorithm_bandwidth_gbs << " " << std::setw(13)
+         << cprof.bus_bandwidth_gbs << std::endl;
+    }
+  }
+
+  // Print the hardware counters of each segment
+  for (const KernelProfile& kprof : fp.kernel_profiles) {
+    if (kprof.metrics.empty()) {
+      continue;
+    }
+    size_t name_width = 8;
+    for (const auto& [name, value] : kprof.metrics) {
+      name_width = std::max(name_width, name.size());
+    }
+    os << std::setfill(' ') << std::left << std::setw(6) << "M-Seg#" << " "
+       << std::setw((int)name_width) << "M-Metric" << " " << std::right
+       << std::setw(16) << "M-Value" << std::endl;
+    for (const auto& [name, value] : kprof.metrics) {
+      os << std::right << std::setw(6) << kprof.segment_id << " " << std::left
+         << std::setw((int)name_width) << name << " " << std::right
+         << std::fixed << std::setprecision(3) << std::setw(16) << value
+         << std::endl;
+    }
+  }
+
   return os;
 }
 
@@ -645,10 +1039,42 @@ void FusionProfiler::reset() {
   fp->host_timer_.reset();
   fp->compile_timer_.reset();
   fp->segments_.clear();
+  fp->communications_.clear();
+  fp->communication_timers_.clear();
   fp->kernel_profiles_.clear();
   fp->corrid_2_segid_.clear();
 }
 
+void FusionProfiler::startKernelMetrics() {
+#ifdef NVFUSER_HAS_CUPTI_RANGE_PROFILER
+  FusionProfiler* fp = get();
+  NVF_CHECK(
+      state() == ProfilerState::Running,
+      "FusionProfiler state is not Running!",
+      state());
+  if (fp->metric_session_ == nullptr) {
+    std::vector<std::string> metric_names =
+        getProfilerOptionArguments(ProfilerOption::Metrics);
+    if (metric_names.empty()) {
+      metric_names = defaultMetrics();
+    }
+    fp->metric_session_ =
+        std::make_unique<CuptiMetricSession>(std::move(metric_names));
+  }
+  fp->metric_session_->start();
+#endif
+}
+
+void FusionProfiler::stopKernelMetrics(size_t seg_id) {
+#ifdef NVFUSER_HAS_CUPTI_RANGE_PROFILER
+  FusionProfiler* fp = get();
+  NVF_CHECK(
+      fp->metric_session_ != nullptr,
+      "FusionProfiler::startKernelMetrics was not called!");
+  segment(seg_id).metrics(fp->metric_session_->stop());
+#endif
+}
+
 ProfilerState FusionProfiler::state() {
   return get()->state_;
 }
@@ -674,10 +1100,45 @@ SegmentProfiler& FusionProfiler::segment(size_t idx) {
   return get()->segments_.at(idx);
 }
 
+int64_t FusionProfiler::startCommunication(CommunicationProfile prof) {
+  FusionProfiler* fp = get();
+  NVF_CHECK(
+      state() == ProfilerState::Running,
+      "FusionProfiler state is not Running!",
+      state());
+  auto timer =
+      std::make_unique<CudaEventTimer>(at::cuda::getCurrentCUDAStream());
+  timer->start();
+  fp->communications_.push_back(std::move(prof));
+  fp->communication_timers_.push_back(std::move(timer));
+  return static_cast<int64_t>(fp->communications_.size()) - 1;
+}
+
+void FusionProfiler::stopCommunication(int64_t idx) {
+  NVF_CHECK(
+      state() == ProfilerState::Running,
+      "FusionProfiler state is not Running!",
+      state());
+  get()->communication_timers_.at(idx)->stop(
+      at::cuda::getCurrentCUDAStream());
+}
+
+CommunicationProfile& FusionProfiler::communication(int64_t idx) {
+  NVF_CHECK(
+      idx >= 0 && (size_t)idx < get()->communications_.size(),
+      "FusionProfiler: You are attempting to access a non-existent "
+      "communication! Communications: ",
+      get()->communications_.size(),
+      " Idx: ",
+      idx);
+  return get()->communications_.at(idx);
+}
+
 /*static*/ void FusionProfiler::start(bool cupti_disable) {
   FusionProfiler* fp = get();
   fp->cupti_disabled_ = cupti_disable;
   reset();
+  inst::CompilePhaseProfiler::instance()->reset();
   if (!fp->cupti_disabled_) {
     NVFUSER_CUPTI_SAFE_CALL(
         cuptiActivityEnable(CUPTI_ACTIVITY_KIND_CONCURRENT_KERNEL));
@@ -685,7 +1146,18 @@ SegmentProfiler& FusionProfiler::segment(size_t idx) {
     NVFUSER_CUPTI_SAFE_CALL(cuptiActivityEnable(CUPTI_ACTIVITY_KIND_RUNTIME));
     NVFUSER_CUPTI_SAFE_CALL(
         cuptiActivityEnable(CUPTI_ACTIVITY_KIND_EXTERNAL_CORRELATION));
+    NVFUSER_CUPTI_SAFE_CALL(cuptiGetTimestamp(&fp->cupti_timestamp_ns_));
+    fp->host_timestamp_ = inst::Trace::Clock::now();
   }
+  NVF_CHECK(
+      !isProfilerCollectingMetrics() || !fp->cupti_disabled_,
+      "NVFUSER_PROF=metrics needs CUPTI");
+#ifndef NVFUSER_HAS_CUPTI_RANGE_PROFILER
+  NVF_CHECK(
+      !isProfilerCollectingMetrics(),
+      "NVFUSER_PROF=metrics needs the CUPTI range profiler of CUDA 12.6 or "
+      "newer");
+#endif
   cudaDeviceSynchronize();
   fp->fusion_timer_.start();
   fp->host_timer_.start();
@@ -767,6 +1239,26 @@ const DeviceDescriptor& FusionProfiler::deviceDescriptor(const int device_id) {
           mb_divider;
       kprof.percentage_peak_bandwidth =
           kprof.effective_bandwidth_gbs / kprof.peak_bandwidth_gbs * 100.0;
+      kprof.flops = segment(kp_idx).flops();
+      kprof.peak_gflops = segment(kp_idx).mmaDataType().has_value()
+          ? device_desc.peakTensorCoreGflops(
+                segment(kp_idx).mmaDataType().value())
+          : device_desc.peak_fp32_gflops;
+      // time_ms is in ms, so FLOPs / ms * 1e-6 is GFLOP/s
+      kprof.gflops = (double)kprof.flops / kprof.time_ms * 1.0e-6;
+      if (kprof.peak_gflops > 0.0) {
+        kprof.percentage_peak_flops =
+            kprof.gflops / kprof.peak_gflops * 100.0;
+      }
+      // Compare the arithmetic intensity with the ridge point of the roofline
+      if (kprof.input_bytes + kprof.output_bytes > 0 &&
+          kprof.peak_bandwidth_gbs > 0.0) {
+        const double intensity = (double)kprof.flops /
+            (double)(kprof.input_bytes + kprof.output_bytes);
+        kprof.bound =
+            intensity < kprof.peak_gflops / kprof.peak_bandwidth_gbs ? "Mem"
+                                                                     : "Comp";
+      }
       kprof.compile_time_ms = segment(kp_idx).compileTime();
 
       kprof.grid_str = toString(kprof.grid);
@@ -775,6 +1267,25 @@ const DeviceDescriptor& FusionProfiler::deviceDescriptor(const int device_id) {
       kprof.shared_mem_str = toString(kprof.shared_mem);
 
       kprof.scheduler = segment(kp_idx).scheduler();
+      kprof.metrics = segment(kp_idx).metrics();
+
+      if (inst::Trace::instance()->enabled()) {
+        auto toHostTime = [fp](uint64_t timestamp_ns) {
+          return fp->host_timestamp_ +
+              std::chrono::duration_cast<inst::Trace::Clock::duration>(
+                     std::chrono::nanoseconds(
+                         (int64_t)timestamp_ns -
+                         (int64_t)fp->cupti_timestamp_ns_));
+        };
+        inst::Trace::instance()->logDeviceEvent(
+            kprof.name,
+            toHostTime(kprof.start_ns),
+            toHostTime(kprof.end_ns),
+            kprof.device,
+            kprof.stream,
+            fprof.fusion_id,
+            (int64_t)kprof.segment_id);
+      }
 
       kernel_time_ms += kprof.time_ms;
       fprof.kernel_profiles[kp_idx] = std::move(kprof);
@@ -797,7 +1308,31 @@ const DeviceDescriptor& FusionProfiler::deviceDescriptor(const int device_id) {
     }
   }
   fprof.compile_time_ms = fp->compile_timer_.time();
+  fprof.compile_phases = inst::CompilePhaseProfiler::instance()->phases();
+
+  for (size_t i = 0; i < fp->communications_.size(); ++i) {
+    CommunicationProfile& cprof = fp->communications_.at(i);
+    CudaEventTimer& timer = *fp->communication_timers_.at(i);
+    NVF_CHECK(
+        timer.state() == ProfilerState::Finished,
+        "Communication ",
+        i,
+        " (",
+        cprof.name,
+        ") was not waited for before the profiler stopped!");
+    cprof.time_ms = timer.time();
+    cprof.start_ms = timer.startTimeSince(fp->fusion_timer_);
+    if (cprof.time_ms > 0.0) {
+      cprof.algorithm_bandwidth_gbs =
+          (double)cprof.bytes / cprof.time_ms * mb_divider;
+      cprof.bus_bandwidth_gbs =
+          cprof.algorithm_bandwidth_gbs * cprof.bus_bandwidth_factor;
+    }
+    fprof.communication_time_ms += cprof.time_ms;
+    fprof.communication_profiles.push_back(cprof);
+  }
 
+  fp->metric_session_.reset();
   fp->state_ = ProfilerState::Processed;
 }
 
@@ -833,6 +1368,14 @@ void FusionProfiler::outputBytesAccessed(int64_t bytes) {
   get()->profile_.output_bytes = bytes;
 }
 
+void FusionProfiler::peakMemoryBytes(int64_t bytes) {
+  NVF_CHECK(
+      state() == ProfilerState::Running,
+      "FusionProfiler state is not Running!",
+      state());
+  get()->profile_.peak_memory_bytes = bytes;
+}
+
 const FusionProfile& FusionProfiler::profile() {
   NVF_CHECK(
       state() == ProfilerState::Processed,
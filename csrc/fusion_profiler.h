@@ -7,13 +7,16 @@
 // clang-format on
 #pragma once
 #include <chrono>
+#include <memory>
 #include <unordered_map>
 
 #include <c10/cuda/CUDAStream.h>
 #include <cuda_runtime.h>
 #include <cuda_utils.h>
 #include <debug.h>
+#include <instrumentation.h>
 #include <options.h>
+#include <type.h>
 #include <utils.h>
 #include <visibility.h>
 
@@ -41,7 +44,13 @@ class CudaEventTimer {
   void reset();
   void start();
   void stop();
+  //! Records the stop event on the given stream instead of the stream of the
+  //! timer, e.g., when the timed work is waited for on another stream
+  void stop(cudaStream_t s);
   double time();
+  //! Time between the start of origin and the start of this timer. Both
+  //! timers must have stopped.
+  double startTimeSince(const CudaEventTimer& origin);
   ProfilerState state() const;
 
  private:
@@ -75,20 +84,31 @@ class HostTimer {
 
 //! \struct DeviceDescriptor
 //! \brief This struct captures the GPU information necessary to calculate the
-//! the Peak Bandwidth of the specific GPU queried.
+//! the Peak Bandwidth and the Peak FLOP/s of the specific GPU queried.
 struct DeviceDescriptor {
   //! Queries the GPU to populate the struct's data members and calculates the
-  //! peak bandwidth
+  //! peaks
   static void generate(DeviceDescriptor& desc, int device);
 
+  //! Peak dense tensor core GFLOP/s for matmul operands of the given type, or
+  //! the CUDA core FP32 peak if the GPU has no tensor cores for it
+  double peakTensorCoreGflops(DataType dtype) const;
+
   //! Queried data members
   int device{-1};
   std::string name{"NVIDIA Unknown GPU"};
   int bus_width{0};
   int memory_clock{0};
+  int sm_count{0};
+  int sm_clock{0};
+  int major{0};
+  int minor{0};
 
-  //! Calculated data member
+  //! Calculated data members
   double peak_bandwidth_gbs{0.0};
+  double peak_fp32_gflops{0.0};
+  //! Dense FP16 and BF16 tensor core peak with FP32 accumulation
+  double peak_fp16_tensor_gflops{0.0};
 };
 
 //! \struct KernelProfile
@@ -100,12 +120,26 @@ struct KernelProfile {
   int device{-1};
   uint32_t stream{0};
   uint32_t correlation_id{0};
+  //! CUPTI timestamps of the kernel in ns
+  uint64_t start_ns{0};
+  uint64_t end_ns{0};
 
   double compile_time_ms{0.0};
   double time_ms{0.0};
   double effective_bandwidth_gbs{0.0};
   double percentage_peak_bandwidth{0.0};
 
+  //! Roofline of the segment: FLOPs are estimated from its fusion, the peak
+  //! is the tensor core peak for its matmul operands if it has matmuls and
+  //! the FP32 peak otherwise. A segment is compute bound if its arithmetic
+  //! intensity is above the ridge point, i.e., peak_gflops over
+  //! peak_bandwidth_gbs.
+  int64_t flops{0};
+  double gflops{0.0};
+  double percentage_peak_flops{0.0};
+  double peak_gflops{0.0};
+  std::string bound{};
+
   std::array<int32_t, 3> grid{0, 0, 0};
   std::array<int32_t, 3> block{0, 0, 0};
   std::array<uint32_t, 3> cluster{0, 0, 0};
@@ -127,6 +161,32 @@ struct KernelProfile {
   std::string shared_mem_str{};
 
   std::string scheduler{};
+
+  //! Hardware counters collected with NVFUSER_PROF=metrics, in the order they
+  //! were requested
+  std::vector<std::pair<std::string, double>> metrics{};
+};
+
+//! \struct CommunicationProfile
+//! \brief This struct captures the profiled information from a Communication
+//! or a P2PCommunication posted by a host program. It is timed with CUDA
+//! events recorded on the current stream when the communication is posted and
+//! once it is waited for, so its time is an upper bound of the time of the
+//! communication on the stream of the backend.
+struct CommunicationProfile {
+  std::string name{};
+  int device{-1};
+  int64_t team_size{0};
+  int64_t bytes{0};
+  //! Ratio between the bus bandwidth and the algorithm bandwidth, e.g.,
+  //! 2*(n-1)/n for an allreduce on n devices, like in nccl-tests
+  double bus_bandwidth_factor{1.0};
+
+  //! Start time relative to the start of the profiled fusion
+  double start_ms{0.0};
+  double time_ms{0.0};
+  double algorithm_bandwidth_gbs{0.0};
+  double bus_bandwidth_gbs{0.0};
 };
 
 struct ProfileAttrDescriptor {
@@ -173,9 +233,18 @@ struct FusionProfile {
 
   int64_t input_bytes{0};
   int64_t output_bytes{0};
+  //! See PeakMemoryStats::peak_bytes
+  int64_t peak_memory_bytes{0};
 
   //! Vector of of the KernelProfiles for each segment of a Fusion
   std::vector<KernelProfile> kernel_profiles{};
+
+  //! Communications posted by host programs, in posting order
+  std::vector<CommunicationProfile> communication_profiles{};
+  double communication_time_ms{0.0};
+
+  //! Host time spent in each phase of compilation while profiling
+  std::vector<inst::CompilePhase> compile_phases{};
 };
 
 std::ostream& operator<<(std::ostream&, const FusionProfile&);
@@ -197,6 +266,8 @@ class SegmentProfiler {
   }
   void inputBytesAccessed(int64_t bytes);
   void outputBytesAccessed(int64_t bytes);
+  void flopsExecuted(int64_t flops, std::optional<DataType> mma_dtype);
+  void metrics(std::vector<std::pair<std::string, double>> values);
 
   void scheduler(const std::string& name);
   const std::string& scheduler() const;
@@ -212,6 +283,15 @@ class SegmentProfiler {
   int64_t outputBytes() const {
     return output_bytes_;
   }
+  int64_t flops() const {
+    return flops_;
+  }
+  const std::optional<DataType>& mmaDataType() const {
+    return mma_dtype_;
+  }
+  const std::vector<std::pair<std::string, double>>& metrics() const {
+    return metrics_;
+  }
   double compileTime() {
     return compile_timer_.time();
   }
@@ -228,10 +308,15 @@ class SegmentProfiler {
   HostTimer compile_timer_;
   int64_t input_bytes_ = -1;
   int64_t output_bytes_ = -1;
+  int64_t flops_ = 0;
+  std::optional<DataType> mma_dtype_ = std::nullopt;
+  std::vector<std::pair<std::string, double>> metrics_;
   std::string scheduler_ = "None";
   ProfilerState kernel_profile_state_;
 };
 
+class CuptiMetricSession;
+
 //! \struct FusionProfiler
 //! \brief A singleton class to profile Fusions that can include multiple
 //! segments.
@@ -253,6 +338,7 @@ class FusionProfiler {
   static void stopCompile();
   static void inputBytesAccessed(int64_t bytes);
   static void outputBytesAccessed(int64_t bytes);
+  static void peakMemoryBytes(int64_t bytes);
   NVF_API static const FusionProfile& profile();
   // An API to query the last kernel time measured that is convenient
   // for profile a single kernel from the Fusion Executor.  Note, there
@@ -261,6 +347,20 @@ class FusionProfiler {
   NVF_API static double lastKernelTime();
   static SegmentProfiler& segment(size_t idx);
 
+  //! Starts timing a communication on the current stream right before it is
+  //! posted and returns its index
+  static int64_t startCommunication(CommunicationProfile prof);
+  //! Stops timing a communication on the current stream, right after it is
+  //! waited for
+  static void stopCommunication(int64_t idx);
+  static CommunicationProfile& communication(int64_t idx);
+
+  //! Brackets the launch of the kernel of a segment to collect its hardware
+  //! counters when NVFUSER_PROF=metrics is set. The kernel must be the only
+  //! one launched in between.
+  static void startKernelMetrics();
+  static void stopKernelMetrics(size_t seg_id);
+
   //! Methods to capture Asynchronous CUPTI activity that get called from
   //! functions registered with CUPTI.
   //! Correlation ID -> Segment ID
@@ -298,6 +398,9 @@ class FusionProfiler {
   //! Total compilation time if there is more than one segment
   HostTimer compile_timer_;
   std::vector<SegmentProfiler> segments_;
+  //! Communications being profiled and their timers
+  std::vector<CommunicationProfile> communications_;
+  std::vector<std::unique_ptr<CudaEventTimer>> communication_timers_;
   //! The FusionProfiler collects a cache of device descriptors so each segment
   //! does not need to spend time re-generating the information.
   std::vector<DeviceDescriptor> device_descriptors_;
@@ -306,6 +409,15 @@ class FusionProfiler {
   //! generated by CUPTI, to the segments responsible for the activity
   std::vector<KernelProfile> kernel_profiles_;
   std::unordered_map<uint32_t, uint32_t> corrid_2_segid_;
+
+  //! A CUPTI timestamp and the host time it was taken at, to convert the
+  //! timestamps of kernels to host time for the trace
+  uint64_t cupti_timestamp_ns_{0};
+  inst::Trace::Clock::time_point host_timestamp_;
+
+  //! Range profiler session of NVFUSER_PROF=metrics, created at the first
+  //! kernel of a profiled fusion
+  std::unique_ptr<CuptiMetricSession> metric_session_;
 };
 
 } // namespace nvfuser
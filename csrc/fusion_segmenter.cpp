@@ -10,6 +10,7 @@
 
 #include <debug.h>
 #include <fusion.h>
+#include <fusion_profiler.h>
 #include <fusion_segmenter.h>
 #include <instrumentation.h>
 #include <ir/all_nodes.h>
@@ -25,12 +26,18 @@
 #include <scheduler/normalization_utils.h>
 #include <transform_iter.h>
 
+#include <ATen/cuda/CUDAContext.h>
+
 namespace nvfuser {
 
 namespace {
 
 using GroupSet = VectorOfUniqueEntries<SegmentedGroup*>;
 
+// Key of the fusion-managed dtype set by setLowerPrecisionSegmentEdges
+constexpr const char* kLowerPrecisionSegmentEdgesKey =
+    "lower_precision_segment_edges";
+
 // This helper function converts selected keys to their corresponding values.
 // During serialization, we map pointers to an integer. For deserialization, we
 // reverse the mapping from integers to pointers.
@@ -356,9 +363,9 @@ void SegmentedGroup::finalize() {
   // alias aware segmentation. we add inputs that are aliased by output
   // generated in this SegmentedGroup
   for (Val* output : output_vals) {
-    if (Val* aliased_input = segmented_fusion_->completeFusion()
-                                 ->getOutputAlias(output)
-                                 .aliased_io) {
+    const AliasInfo& alias_info =
+        segmented_fusion_->completeFusion()->getOutputAlias(output);
+    if (Val* aliased_input = alias_info.aliased_io) {
       // aliasing currently only supported as output to input
       NVF_ERROR(
           aliased_input->isFusionInput(),
@@ -370,6 +377,13 @@ void SegmentedGroup::finalize() {
         input_vals.push_back(aliased_input);
       }
     }
+    // The offset of a slice alias is needed to allocate the output
+    if (Val* offset = alias_info.slice_offset;
+        offset != nullptr && offset->isFusionInput() &&
+        !input_set.count(offset)) {
+      input_set.insert(offset);
+      input_vals.push_back(offset);
+    }
   }
 }
 
@@ -1223,7 +1237,8 @@ void SegmentedFusion::finalize() {
 std::vector<SegmentedEdge*> SegmentedFusion::castInputOutputToLowerPrecision(
     const std::vector<SegmentedEdge*>& edges,
     const std::vector<SegmentedGroup*>& groups_to_merge) {
-  if (!isOptionEnabled(EnableOption::IoToLowerPrecision)) {
+  if (!isOptionEnabled(EnableOption::IoToLowerPrecision) &&
+      !complete_fusion_->hasManaged(kLowerPrecisionSegmentEdgesKey)) {
     return {};
   }
 
@@ -1955,12 +1970,19 @@ void eraseInputDistinctRootDomains(Fusion* fusion) {
 
 std::pair<IrCloner, std::unique_ptr<Fusion>> SegmentedFusion::makeFusion(
     SegmentedGroup* sg) {
-  // TODO Optimize cloning step by only copying values and expressions between
-  // the fusion segment's inputs and outputs.
   auto fusion_segment = std::make_unique<Fusion>();
 
+  // Copying the complete fusion for every segment is quadratic in the number
+  // of segments, so the subgraph of the segment can be copied instead
   IrCloner complete_to_segment_map =
-      Fusion::copy(completeFusion(), fusion_segment.get());
+      isOptionEnabled(EnableOption::PartialSegmentCopy)
+      ? Fusion::copySubgraph(
+            completeFusion(),
+            fusion_segment.get(),
+            sg->exprs(),
+            getAllInputs(sg),
+            sg->output_vals)
+      : Fusion::copy(completeFusion(), fusion_segment.get());
 
   std::vector<Val*> input_list(
       fusion_segment->inputs().begin(), fusion_segment->inputs().end());
@@ -2023,6 +2045,7 @@ std::unique_ptr<SegmentedFusion> SegmentCandidateFinder::segment(
     std::unique_ptr<Fusion> fusion,
     const KernelArgumentHolder* inputs,
     SchedulerRuntimeInfo& runtime_info) {
+  FUSER_COMPILE_PHASE_SCOPE("Segmenter");
   if (!hasSegmentHints(fusion.get())) {
     scheduler_debug_utils::canScheduleMessage(
         "***Runtime***: Try to schedule fusion un-segmented:\n");
@@ -2582,49 +2605,84 @@ class FusionSegmentGuard : public NonCopyable {
 #endif
 };
 
-SchedulerType tryMerge(
+// Identifies the fusion set up by a FusionSegmentGuard by the names of its
+// exprs, inputs and outputs. Names are never reused within a Fusion, so a
+// key can't match a fusion made of exprs that replaced the original ones.
+std::string segmentKey(Fusion* fusion) {
+  std::vector<StmtNameType> expr_names;
+  for (auto expr : fusion->exprs()) {
+    expr_names.push_back(expr->name());
+  }
+  std::sort(expr_names.begin(), expr_names.end());
+
+  std::stringstream ss;
+  ss << toDelimitedString(expr_names, ",") << ";";
+  for (auto inp : fusion->inputs()) {
+    ss << ir_utils::varName(inp) << ",";
+  }
+  ss << ";";
+  for (auto out : fusion->outputs()) {
+    ss << ir_utils::varName(out) << ",";
+  }
+  return ss.str();
+}
+
+// Propose a scheduler for the fusion set up by a FusionSegmentGuard. The
+// result only depends on the exprs, inputs and outputs of the segment, so it
+// is memoized. A merge that was rejected is then not evaluated again until
+// one of its groups changes.
+SchedulerType proposeHeuristicsForSegment(
     SegmentedFusion* segmented_fusion,
     SchedulerRuntimeInfo& runtime_info,
-    SegmentedGroup* a,
-    SegmentedGroup* b = nullptr) {
-  FusionSegmentGuard fsg(segmented_fusion, a, b);
-
+    std::unordered_map<std::string, SchedulerType>& scheduler_type_memo) {
+  Fusion* fusion = segmented_fusion->completeFusion();
   NVF_ERROR(
-      !segmented_fusion->completeFusion()->unordered_exprs().empty(),
+      !fusion->unordered_exprs().empty(),
       "We shouldn't attempt to merge empty fusions. "
       "This might not indicate a bug, "
       "but it's definitely a change of world view that we should be aware of.");
 
-  scheduler_debug_utils::canScheduleMessage(
-      "\n**Segmenter** Considering fusion:\n",
-      segmented_fusion->completeFusion());
-  if (tryingToMergeSegmenterSet(segmented_fusion->completeFusion())) {
+  if (tryingToMergeSegmenterSet(fusion)) {
     return SchedulerType::None;
   }
-  return Schedule::proposeHeuristics(
-      segmented_fusion->completeFusion(), runtime_info);
+
+  auto key = segmentKey(fusion);
+  auto memo_it = scheduler_type_memo.find(key);
+  if (memo_it != scheduler_type_memo.end()) {
+    scheduler_debug_utils::canScheduleMessage(
+        "\n**Segmenter** Reusing the proposed scheduler ",
+        memo_it->second,
+        " for fusion:\n",
+        fusion);
+    return memo_it->second;
+  }
+
+  scheduler_debug_utils::canScheduleMessage(
+      "\n**Segmenter** Considering fusion:\n", fusion);
+  auto scheduler_type = Schedule::proposeHeuristics(fusion, runtime_info);
+  scheduler_type_memo.emplace(std::move(key), scheduler_type);
+  return scheduler_type;
 }
 
 SchedulerType tryMerge(
     SegmentedFusion* segmented_fusion,
     SchedulerRuntimeInfo& runtime_info,
+    std::unordered_map<std::string, SchedulerType>& scheduler_type_memo,
+    SegmentedGroup* a,
+    SegmentedGroup* b = nullptr) {
+  FusionSegmentGuard fsg(segmented_fusion, a, b);
+  return proposeHeuristicsForSegment(
+      segmented_fusion, runtime_info, scheduler_type_memo);
+}
+
+SchedulerType tryMerge(
+    SegmentedFusion* segmented_fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    std::unordered_map<std::string, SchedulerType>& scheduler_type_memo,
     const std::vector<SegmentedGroup*>& segmented_groups) {
   FusionSegmentGuard fsg(segmented_fusion, segmented_groups);
-
-  NVF_ERROR(
-      !segmented_fusion->completeFusion()->unordered_exprs().empty(),
-      "We shouldn't attempt to merge empty fusions. "
-      "This might not indicate a bug, "
-      "but it's definitely a change of world view that we should be aware of.");
-
-  scheduler_debug_utils::canScheduleMessage(
-      "\n**Segmenter** Considering fusion:\n",
-      segmented_fusion->completeFusion());
-  if (tryingToMergeSegmenterSet(segmented_fusion->completeFusion())) {
-    return SchedulerType::None;
-  }
-  return Schedule::proposeHeuristics(
-      segmented_fusion->completeFusion(), runtime_info);
+  return proposeHeuristicsForSegment(
+      segmented_fusion, runtime_info, scheduler_type_memo);
 }
 
 // This function is for cleanup and
@@ -2662,6 +2720,7 @@ void deDuplicateScalarExprs(std::vector<Expr*>& exprs) {
 std::optional<std::unique_ptr<HeuristicParams>> SegmentedGroup::
     getMaybeHeuristicParams(SchedulerRuntimeInfo& runtime_info) {
   FUSER_PERF_SCOPE("SegmentedFusion::getMaybeHeuristicParams");
+  FUSER_COMPILE_PHASE_SCOPE(toString(schedulerType()) + " heuristics");
   auto heuristic_data_cache =
       segmented_fusion_->getCachedHeuristicDataFor(this);
   if (!Schedule::canSchedule(
@@ -3225,6 +3284,7 @@ class CombineReductions {
     if (tryMerge(
             segment_candidate_finder_->segmented_fusion_.get(),
             segment_candidate_finder_->runtimeInfo(),
+            segment_candidate_finder_->scheduler_type_memo_,
             all_groups_to_merge_vec) == SchedulerType::None) {
       return nullptr;
     }
@@ -3362,6 +3422,7 @@ class CombineReductions {
           if (tryMerge(
                   segment_candidate_finder_->segmented_fusion_.get(),
                   segment_candidate_finder_->runtimeInfo(),
+                  segment_candidate_finder_->scheduler_type_memo_,
                   groups_to_merge_vec) != SchedulerType::None) {
             // Found a valid horizontal merge, want to proceed with merging here
             auto joined_group = segment_candidate_finder_->mergeAllGivenGroups(
@@ -3727,6 +3788,7 @@ class MergeUpAndDownCast {
     auto sched_type = tryMerge(
         segment_candidate_finder_->segmented_fusion_.get(),
         segment_candidate_finder_->runtimeInfo(),
+        segment_candidate_finder_->scheduler_type_memo_,
         groups);
 
     if (sched_type == SchedulerType::None) {
@@ -3917,12 +3979,22 @@ bool SegmentCandidateFinder::codeGenSupportedMerge(
     }
     return true;
   }
-  return tryMerge(segmented_fusion_.get(), runtimeInfo(), group1, group2) !=
-      SchedulerType::None;
+  if (tryMerge(
+          segmented_fusion_.get(),
+          runtimeInfo(),
+          scheduler_type_memo_,
+          group1,
+          group2) == SchedulerType::None) {
+    return false;
+  }
+  // Merging input groups only resolves forwarded inputs
+  if (isOptionEnabled(EnableOption::SegmenterCostModel) &&
+      !group1->isFusionInputGroup() && !group2->isFusionInputGroup()) {
+    return isMergeProfitable(group1, group2);
+  }
+  return true;
 }
 
-// TODO: consider caching the heuristics value so tryMerge doesn't have to be
-//       called twice
 SchedulerType SegmentCandidateFinder::deriveSchedulerType(
     SegmentedGroup* group) {
   if (options_.only_segment_resharding_exprs) {
@@ -3930,7 +4002,8 @@ SchedulerType SegmentCandidateFinder::deriveSchedulerType(
     // this moment
     return SchedulerType::None;
   }
-  auto scheduler_type = tryMerge(segmented_fusion_.get(), runtimeInfo(), group);
+  auto scheduler_type = tryMerge(
+      segmented_fusion_.get(), runtimeInfo(), scheduler_type_memo_, group);
   NVF_ERROR(
       scheduler_type != SchedulerType::None,
       "Can not find a scheduler to schedule fusion segment");
@@ -4185,6 +4258,21 @@ void SegmentCandidateFinder::findSegments() {
 
   segmented_fusion_->validateIfDebug();
 
+  if (options_.run_rematerialization &&
+      !options_.only_segment_resharding_exprs && runtime_info_.has_value() &&
+      !isOptionDisabled(DisableOption::Rematerialization)) {
+    rematerializeCheapProducers();
+    // Rematerialized exprs are shared by the producer and consumer groups
+    segmented_fusion_->validateIfDebug(/*require_disjoint=*/false);
+  }
+
+  if (options_.run_horizontal_merge &&
+      !options_.only_segment_resharding_exprs && runtime_info_.has_value() &&
+      !isOptionDisabled(DisableOption::HorizontalFusion)) {
+    horizontalMerge();
+    segmented_fusion_->validateIfDebug(/*require_disjoint=*/false);
+  }
+
   // Resolve all the input expressions needed in each group
   resolveForwardedInputs();
 
@@ -4581,6 +4669,412 @@ void SegmentCandidateFinder::resolveNonscalarForwardedInput(
   }
 }
 
+namespace {
+
+// Upper bound of the tensor exprs recomputed in a consumer group to avoid
+// materializing their output
+constexpr int64_t kMaxRematerializedExprs = 8;
+
+// Elementwise ops added per byte of global memory traffic saved. Kernels with
+// that little arithmetic per byte are still memory bound.
+constexpr int64_t kRematerializationOpsPerByte = 8;
+
+bool isRematerializable(Expr* expr) {
+  if (auto* ldst = dynamic_cast<LoadStoreOp*>(expr)) {
+    return ldst->opType() == LoadStoreOpType::Set;
+  }
+  return expr->isOneOf<
+      UnaryOp,
+      BinaryOp,
+      TernaryOp,
+      BroadcastOp,
+      SqueezeOp,
+      ExpandOp,
+      FullOp,
+      IotaOp>();
+}
+
+// Returns the number of elements stored for tv, i.e., not counting broadcast
+// dimensions, or std::nullopt if an extent can't be evaluated
+std::optional<int64_t> numStoredElements(
+    TensorView* tv,
+    ExpressionEvaluator& expr_eval) {
+  int64_t num_elements = 1;
+  for (IterDomain* id : TensorDomain::noReductions(tv->getLogicalDomain())) {
+    if (id->isBroadcast()) {
+      continue;
+    }
+    PolymorphicValue extent = expr_eval.evaluate(id->extent());
+    if (!extent.hasValue()) {
+      return std::nullopt;
+    }
+    num_elements *= extent.as<int64_t>();
+  }
+  return num_elements;
+}
+
+// Constants of the analytical cost model of the segmenter. A kernel is
+// assumed to be bound by global memory, whose bandwidth it only saturates
+// with enough resident warps per SM.
+constexpr double kKernelLaunchOverheadUs = 3.0;
+constexpr int64_t kSaturatingWarpsPerSM = 28;
+
+double peakBandwidthGbs() {
+  static const double peak_bandwidth_gbs = []() {
+    DeviceDescriptor desc;
+    DeviceDescriptor::generate(desc, at::cuda::current_device());
+    return desc.peak_bandwidth_gbs;
+  }();
+  return peak_bandwidth_gbs;
+}
+
+// Returns the warps per SM that can be resident when each reduction row or
+// column keeps persistent_buffer_size bytes on chip. The buffer is spread
+// over the threads of up to a full block, first in registers and then in
+// shared memory.
+int64_t residentWarpsPerSM(int64_t persistent_buffer_size) {
+  const auto dev_prop = at::cuda::getCurrentDeviceProperties();
+  const int64_t threads_per_block = dev_prop->maxThreadsPerBlock;
+  const int64_t max_threads_per_sm = dev_prop->maxThreadsPerMultiProcessor;
+  const int64_t registers_per_thread =
+      ceilDiv(
+          persistent_buffer_size,
+          threads_per_block * scheduler_utils::bytes_per_register) +
+      scheduler_utils::register_overhead;
+  int64_t threads_per_sm = 0;
+  if (registers_per_thread <= scheduler_utils::max_registers_per_thread) {
+    threads_per_sm = getThreadsPerSMGivenRegPerThread(registers_per_thread);
+  } else {
+    threads_per_sm = (int64_t)dev_prop->sharedMemPerMultiprocessor /
+        persistent_buffer_size * threads_per_block;
+  }
+  return std::max<int64_t>(
+      1, std::min(threads_per_sm, max_threads_per_sm) / dev_prop->warpSize);
+}
+
+// Estimates the time in microseconds a kernel takes for the segment set up by
+// a FusionSegmentGuard with the given scheduler, from the bytes it moves from
+// and to global memory and, for persistent schedulers, the occupancy its
+// buffers allow. Returns std::nullopt if a size can't be evaluated.
+std::optional<double> estimateSegmentTime(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    SchedulerType scheduler_type) {
+  int64_t bytes = 0;
+  for (const auto& vals : {fusion->inputs(), fusion->outputs()}) {
+    for (auto tv : ir_utils::filterByType<TensorView>(vals)) {
+      std::optional<int64_t> num_elements =
+          numStoredElements(tv, runtime_info.expressionEvaluator());
+      if (!num_elements.has_value()) {
+        return std::nullopt;
+      }
+      bytes += num_elements.value() * (int64_t)dataTypeSize(tv->dtype());
+    }
+  }
+
+  double efficiency = 1.0;
+  if (scheduler_type == SchedulerType::InnerPersistent ||
+      scheduler_type == SchedulerType::OuterPersistent ||
+      scheduler_type == SchedulerType::InnerOuterPersistent) {
+    auto persistent_buffer_info = scheduler_utils::persistentBufferInfo(fusion);
+    auto persistent_buffer_size = scheduler_utils::persistentBufferSize(
+        fusion, runtime_info, persistent_buffer_info);
+    int64_t buffer_size = persistent_buffer_size.persistent_buffer_size;
+    if (persistent_buffer_size.projected_persistent_buffer_size > 0) {
+      buffer_size = std::min(
+          buffer_size, persistent_buffer_size.projected_persistent_buffer_size);
+    }
+    if (buffer_size > 0) {
+      efficiency = std::min(
+          1.0,
+          (double)residentWarpsPerSM(buffer_size) /
+              (double)kSaturatingWarpsPerSM);
+    }
+  }
+
+  // GB/s is 1e3 bytes per microsecond
+  return kKernelLaunchOverheadUs +
+      (double)bytes / (peakBandwidthGbs() * 1e3 * efficiency);
+}
+
+} // namespace
+
+std::optional<double> SegmentCandidateFinder::segmentTime(
+    const std::vector<SegmentedGroup*>& groups) {
+  FusionSegmentGuard fsg(segmented_fusion_.get(), groups);
+  Fusion* fusion = segmented_fusion_->completeFusion();
+  auto key = segmentKey(fusion);
+  auto memo_it = segment_time_memo_.find(key);
+  if (memo_it != segment_time_memo_.end()) {
+    return memo_it->second;
+  }
+  SchedulerType scheduler_type = proposeHeuristicsForSegment(
+      segmented_fusion_.get(), runtimeInfo(), scheduler_type_memo_);
+  std::optional<double> time = scheduler_type == SchedulerType::None
+      ? std::nullopt
+      : estimateSegmentTime(fusion, runtimeInfo(), scheduler_type);
+  segment_time_memo_.emplace(std::move(key), time);
+  return time;
+}
+
+bool SegmentCandidateFinder::isMergeProfitable(
+    SegmentedGroup* group1,
+    SegmentedGroup* group2) {
+  std::optional<double> time1 = segmentTime({group1});
+  std::optional<double> time2 = segmentTime({group2});
+  std::optional<double> merged_time = segmentTime({group1, group2});
+  // Without an estimate, keep merging whatever a scheduler accepts
+  if (!time1.has_value() || !time2.has_value() || !merged_time.has_value()) {
+    return true;
+  }
+  const bool profitable =
+      merged_time.value() <= time1.value() + time2.value();
+  scheduler_debug_utils::canScheduleMessage(
+      "\n**Segmenter** Cost model ",
+      profitable ? "accepts" : "rejects",
+      " merging group ",
+      group1->groupId(),
+      " (",
+      time1.value(),
+      " us) with group ",
+      group2->groupId(),
+      " (",
+      time2.value(),
+      " us) into ",
+      merged_time.value(),
+      " us");
+  return profitable;
+}
+
+bool SegmentCandidateFinder::tryRematerialize(SegmentedEdge* edge) {
+  SegmentedGroup* producer = edge->from;
+  SegmentedGroup* consumer = edge->to;
+  auto* tv = dynamic_cast<TensorView*>(edge->val);
+  if (tv == nullptr || tv->isFusionOutput() ||
+      producer->isFusionInputGroup() || consumer->isFusionInputGroup()) {
+    return false;
+  }
+
+  auto is_moved = [&](SegmentedEdge* e) {
+    return e->from == producer && e->to == consumer && e->val == tv;
+  };
+  // Keep at least one output in the producer, otherwise it would compute
+  // nothing
+  if (producer->output_vals.empty() &&
+      std::all_of(
+          producer->consumer_edges.begin(),
+          producer->consumer_edges.end(),
+          is_moved)) {
+    return false;
+  }
+
+  std::vector<Expr*> exprs = StmtSort::getExprsTo({tv});
+  int64_t num_tensor_exprs = 0;
+  for (Expr* expr : exprs) {
+    if (ir_utils::isScalarOp(expr)) {
+      continue;
+    }
+    if (!isRematerializable(expr)) {
+      return false;
+    }
+    num_tensor_exprs++;
+  }
+  if (num_tensor_exprs > kMaxRematerializedExprs) {
+    return false;
+  }
+
+  // Vals the consumer reads anyway, including the fusion inputs of its
+  // forwarded inputs
+  std::unordered_set<Val*> consumer_inputs(
+      consumer->input_vals.begin(), consumer->input_vals.end());
+  for (SegmentedEdge* e : consumer->producer_edges) {
+    consumer_inputs.insert(e->val);
+    if (isFusionInput(e->val)) {
+      for (Val* inp : IterVisitor::getInputsTo({e->val})) {
+        consumer_inputs.insert(inp);
+      }
+    }
+  }
+
+  // The consumer can't both compute and read an intermediate of the chain
+  std::unordered_set<Expr*> consumer_exprs(
+      consumer->exprs().begin(), consumer->exprs().end());
+  for (Expr* expr : exprs) {
+    if (consumer_exprs.count(expr)) {
+      return false;
+    }
+    for (Val* out : expr->outputs()) {
+      if (out != tv && consumer_inputs.count(out)) {
+        return false;
+      }
+    }
+  }
+
+  // Recomputing saves writing and reading tv but adds reading the fusion
+  // inputs of the chain that the consumer doesn't read yet
+  ExpressionEvaluator& expr_eval = expressionEvaluator();
+  const PrimDataType index_type = runtimeInfo().getIndexType();
+  std::optional<int64_t> num_elements = numStoredElements(tv, expr_eval);
+  if (!num_elements.has_value()) {
+    return false;
+  }
+  int64_t saved_bytes = *num_elements * dataTypeSize(tv->dtype(), index_type);
+  const std::vector<Val*> chain_inputs = IterVisitor::getInputsTo({tv});
+  for (auto* inp : ir_utils::filterByType<TensorView>(chain_inputs)) {
+    if (consumer_inputs.count(inp)) {
+      continue;
+    }
+    std::optional<int64_t> num_input_elements =
+        numStoredElements(inp, expr_eval);
+    if (!num_input_elements.has_value()) {
+      return false;
+    }
+    saved_bytes -= *num_input_elements * dataTypeSize(inp->dtype(), index_type);
+  }
+  if (saved_bytes <= 0 ||
+      *num_elements * num_tensor_exprs >
+          kRematerializationOpsPerByte * saved_bytes) {
+    return false;
+  }
+
+  // Same as resolveNonscalarForwardedInput, but the edges are moved back if
+  // the consumer can't be scheduled with the recomputed exprs
+  SegmentedGroup* input_group = createInputGroup(tv);
+  std::vector<SegmentedEdge*> moved_edges;
+  for (SegmentedEdge* e : consumer->producer_edges) {
+    if (is_moved(e)) {
+      moved_edges.push_back(e);
+    }
+  }
+  producer->consumer_edges.erase(
+      std::remove_if(
+          producer->consumer_edges.begin(),
+          producer->consumer_edges.end(),
+          is_moved),
+      producer->consumer_edges.end());
+  for (SegmentedEdge* e : moved_edges) {
+    e->from = input_group;
+    input_group->consumer_edges.push_back(e);
+  }
+
+  if (codeGenSupportedMerge(input_group, consumer)) {
+    NVF_ERROR(to_merge_.empty());
+    to_merge_.push_back(input_group);
+    to_merge_.push_back(consumer);
+    mergeNodes();
+    return true;
+  }
+
+  for (SegmentedEdge* e : moved_edges) {
+    e->from = producer;
+    producer->consumer_edges.push_back(e);
+  }
+  groups().erase(
+      std::remove(groups().begin(), groups().end(), input_group),
+      groups().end());
+  return false;
+}
+
+void SegmentCandidateFinder::rematerializeCheapProducers() {
+  // Edges that were considered and kept. Edges are not freed until
+  // finalization, so their addresses are not reused by merging.
+  std::unordered_set<SegmentedEdge*> kept_edges;
+  bool rematerialized = true;
+  while (rematerialized) {
+    rematerialized = false;
+    // Merging replaces the edges of the consumer, so restart the search after
+    // each rematerialization
+    for (SegmentedEdge* edge : edges()) {
+      if (kept_edges.count(edge)) {
+        continue;
+      }
+      if (tryRematerialize(edge)) {
+        rematerialized = true;
+        break;
+      }
+      kept_edges.insert(edge);
+    }
+  }
+}
+
+namespace {
+
+// Segments whose tensors all have fewer elements than this don't fill a GPU
+// on their own, so launching them together is worth a horizontal merge
+constexpr int64_t kMaxHorizontalMergeElements = (int64_t)1 << 20;
+
+// Returns true if all the tensors read or written by group are known to have
+// fewer than kMaxHorizontalMergeElements elements
+bool isSmallGroup(SegmentedGroup* group, ExpressionEvaluator& expr_eval) {
+  std::vector<Val*> vals = group->input_vals;
+  vals.insert(vals.end(), group->output_vals.begin(), group->output_vals.end());
+  for (SegmentedEdge* edge : group->producer_edges) {
+    vals.push_back(edge->val);
+  }
+  for (SegmentedEdge* edge : group->consumer_edges) {
+    vals.push_back(edge->val);
+  }
+  for (auto* tv : ir_utils::filterByType<TensorView>(vals)) {
+    std::optional<int64_t> num_elements = numStoredElements(tv, expr_eval);
+    if (!num_elements.has_value() ||
+        *num_elements >= kMaxHorizontalMergeElements) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+void SegmentCandidateFinder::horizontalMerge() {
+  // Rematerialization creates groups that the dependency analysis hasn't
+  // seen, so recompute it
+  group_dependency_.reset();
+  GroupDependencyAnalysis* dependency = getGroupDependency();
+
+  bool merged_nodes = true;
+  while (merged_nodes) {
+    merged_nodes = false;
+    std::vector<SegmentedGroup*> candidates;
+    for (SegmentedGroup* group : groups()) {
+      if (group->isFusionInputGroup() ||
+          group->schedulerType() == SchedulerType::ExprEval ||
+          group->schedulerType() == SchedulerType::NoOp ||
+          !isSmallGroup(group, expressionEvaluator())) {
+        continue;
+      }
+      candidates.push_back(group);
+    }
+
+    for (auto a_it = candidates.begin();
+         a_it != candidates.end() && !merged_nodes;
+         a_it++) {
+      for (auto b_it = std::next(a_it); b_it != candidates.end(); b_it++) {
+        SegmentedGroup* a = *a_it;
+        SegmentedGroup* b = *b_it;
+        // Merging dependent groups may create a cycle. Producer-consumer
+        // pairs that can be merged are left to finalMerge.
+        if (dependency->isProducerOf(a, b) || dependency->isConsumerOf(a, b)) {
+          continue;
+        }
+        if (tryMerge(
+                segmented_fusion_.get(),
+                runtimeInfo(),
+                scheduler_type_memo_,
+                std::vector<SegmentedGroup*>{a, b}) == SchedulerType::None) {
+          continue;
+        }
+        NVF_ERROR(to_merge_.empty());
+        to_merge_.push_back(a);
+        to_merge_.push_back(b);
+        mergeNodes();
+        merged_nodes = true;
+        break;
+      }
+    }
+  }
+}
+
 void SegmentCandidateFinder::removeScalarEdges() {
   // Remove all scalar edges between groups
   //  They may have been created by welford
@@ -4650,6 +5144,7 @@ GroupDependencyAnalysis* SegmentCandidateFinder::getGroupDependency() {
 std::unique_ptr<HeuristicParams> SegmentedFusion::makeInitialHeuristicParams(
     SegmentedGroup* sg,
     SchedulerRuntimeInfo& runtime_info) {
+  FUSER_COMPILE_PHASE_SCOPE(toString(sg->schedulerType()) + " heuristics");
   // This will be the first time each group is scheduled. So we'd want to
   //  construct the cache data here.
   auto heuristic_data_cache_ptr = std::make_unique<HeuristicDataCache>();
@@ -4837,6 +5332,21 @@ class ForceHalfAnnotation : public IterVisitor {
 } // namespace
 
 void SegmentedFusion::annotateFP16IntermediateTensors() {
+  // A fusion opted in with setLowerPrecisionSegmentEdges stores all its Float
+  // intermediates in lower precision, whatever the dtypes of its outputs.
+  if (std::optional<const DataType> dtype =
+          complete_fusion_->getManagedSafe<DataType>(
+              kLowerPrecisionSegmentEdgesKey)) {
+    force_half_precision_type_ = *dtype;
+    for (TensorView* tv : complete_fusion_->allTvs()) {
+      if (tv->getDataType() == DataType::Float && !tv->isFusionInput() &&
+          !tv->isFusionOutput()) {
+        force_fp16_tv_set_.insert(tv);
+      }
+    }
+    return;
+  }
+
   force_fp16_tv_set_ =
       ForceHalfAnnotation::getFP16AnnotatedSet(complete_fusion_.get());
   for (auto out_tv :
@@ -4850,6 +5360,14 @@ void SegmentedFusion::annotateFP16IntermediateTensors() {
   }
 }
 
+void setLowerPrecisionSegmentEdges(Fusion* fusion, DataType dtype) {
+  NVF_CHECK(
+      dtype == DataType::Half || dtype == DataType::BFloat16,
+      "Segment edges can only be stored as Half or BFloat16, but got ",
+      dtype);
+  fusion->manage(kLowerPrecisionSegmentEdgesKey, dtype);
+}
+
 std::string toString(const SegmentCandidateFinderOptions& segment_options) {
   std::stringstream ss;
   ss << "segmentation phases {\n";
@@ -4862,6 +5380,12 @@ std::string toString(const SegmentCandidateFinderOptions& segment_options) {
   if (segment_options.run_final_merge) {
     ss << "final merging\n";
   }
+  if (segment_options.run_rematerialization) {
+    ss << "rematerialization\n";
+  }
+  if (segment_options.run_horizontal_merge) {
+    ss << "horizontal merging\n";
+  }
   ss << "\n}\n";
   return ss.str();
 }
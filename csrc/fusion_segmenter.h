@@ -496,6 +496,8 @@ struct SegmentCandidateFinderOptions {
   bool run_combine_reductions = true;
   bool run_herrmann_merge = true;
   bool run_final_merge = true;
+  bool run_rematerialization = true;
+  bool run_horizontal_merge = true;
   bool only_segment_resharding_exprs = false;
 };
 
@@ -562,6 +564,16 @@ class SegmentCandidateFinder {
 
   bool codeGenSupportedMerge(SegmentedGroup* group1, SegmentedGroup* group2);
 
+  //! Predicted time of a kernel of the given groups merged, with the
+  //!  scheduler proposed for them, or std::nullopt if none is proposed or
+  //!  the sizes can't be evaluated
+  std::optional<double> segmentTime(const std::vector<SegmentedGroup*>& groups);
+
+  //! With EnableOption::SegmenterCostModel, a merge accepted by a scheduler
+  //!  is only done if the cost model predicts the merged kernel to be no
+  //!  slower than the kernels of the two groups
+  bool isMergeProfitable(SegmentedGroup* group1, SegmentedGroup* group2);
+
   void buildInitialSegments();
 
   void findSegments();
@@ -639,6 +651,29 @@ class SegmentCandidateFinder {
 
   void resolveForwardedInputs();
 
+  //! Recompute cheap producer chains in consumer segments instead of
+  //!  materializing them. For example, in
+  //!
+  //!   tv2 = broadcast(castOp(DataType::Float, tv1));
+  //!
+  //!  materializing tv2 writes and re-reads four bytes per element while the
+  //!  consumer could read the one-byte tv1 and recompute tv2 with two cheap
+  //!  ops. An edge whose val is only made of elementwise, broadcast and
+  //!  factory ops from fusion inputs is replaced by recomputing the val in
+  //!  the consumer when that reduces the global memory traffic and the
+  //!  added arithmetic stays below what a memory bound kernel hides.
+  void rematerializeCheapProducers();
+
+  //! Returns true if the val of edge has been recomputed in its consumer
+  bool tryRematerialize(SegmentedEdge* edge);
+
+  //! Merge pairs of small segments that don't depend on each other so
+  //!  they are launched as one kernel. Segments with different shapes,
+  //!  e.g., the independent output branches of a fusion, are each too
+  //!  small to fill the GPU and pay their own launch latency. A pair is
+  //!  merged when a scheduler, typically the horizontal one, accepts it.
+  void horizontalMerge();
+
   // Creates the input group that ends at `forwarded_input`, i.e., the region
   // between fusion inputs and `forwarded_input`.
   SegmentedGroup* createInputGroup(Val* forwarded_input);
@@ -723,6 +758,16 @@ class SegmentCandidateFinder {
   // used for breaking the fusion into compute and communication segments
   std::optional<SchedulerRuntimeInfo> runtime_info_;
 
+  //! Schedulers proposed for the segments tried so far, keyed by the names of
+  //!  the exprs, inputs and outputs of each segment. Merge passes revisit the
+  //!  same neighbor pairs many times, so this avoids repeating the
+  //!  canSchedule checks of all schedulers for segments that didn't change.
+  std::unordered_map<std::string, SchedulerType> scheduler_type_memo_;
+
+  //! Predicted times of the segments tried by the cost model, with the same
+  //!  keys as scheduler_type_memo_
+  std::unordered_map<std::string, std::optional<double>> segment_time_memo_;
+
   //! Note:
   //!  Segmenter should eventually rely only on runtime_info_ for
   //!  safe caching. runtime_inputs_ is only used in translateWelford
@@ -742,6 +787,14 @@ class SegmentCandidateFinder {
   const KernelArgumentHolder* runtime_inputs_;
 };
 
+//! Opts fusion in to storing the Float tensors passed between its segments as
+//!  dtype, i.e., Half or BFloat16, like EnableOption::IoToLowerPrecision does
+//!  for the producers of half-precision outputs. Consumers cast the stored
+//!  tensors back and compute in Float, so only the rounding of the stored
+//!  values is lost. Meant for fusions that tolerate that error, e.g.,
+//!  normalization backwards whose gradients are already rounded to dtype.
+NVF_API void setLowerPrecisionSegmentEdges(Fusion* fusion, DataType dtype);
+
 // TODO: Make as member functions on classes instead of global scope
 std::string toString(const SegmentedGroup* group);
 std::string toString(const SegmentedEdge* edge);
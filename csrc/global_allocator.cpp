@@ -12,96 +12,127 @@
 #include <type.h>
 
 #include <ATen/ATen.h>
+#include <c10/cuda/CUDAGraphsC10Utils.h>
+#include <c10/cuda/CUDAStream.h>
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
 
 namespace nvfuser {
 
 namespace {
 
-// For each device, we maintain an arena tensor which we will slice to provide
-// individual tensors. These tensors will grow in size and remain at the
-// high-water mark for their particular device until the thread terminates.
-class Arena {
+// Smallest block handed out by a pool
+constexpr int64_t min_block_bytes = 128;
+
+// For each stream, we maintain a pool of zeroed blocks whose sizes are powers
+// of two. Kernels reset their zeroed buffers before they finish, so a block
+// can be handed out again to the next kernel on the same stream without a
+// memset. Blocks are only allocated, never freed, until the thread
+// terminates.
+class ZeroedMemoryPool {
  public:
-  // Mark allocated_bytes_ as 0, allowing all available zeroed memory to be
-  // reused on subsequent calls to getTensor().
+  // Mark all blocks as available for reuse on subsequent calls to
+  // getTensor().
   void reset() {
-    if (isDebugDumpEnabled(DebugDumpOption::GlobalZeroedMemory)) {
-      debug() << "[global zeroed memory] Resetting allocated bytes to 0"
-              << std::endl;
+    for (auto& [block_bytes, blocks] : blocks_) {
+      for (Block& block : blocks) {
+        block.in_use = false;
+      }
     }
-    allocated_bytes_ = 0LL;
+    in_use_bytes_ = 0;
   }
 
   at::Tensor getTensor(
       const std::vector<int64_t>& sizes,
       const c10::ScalarType& aten_dtype,
-      const c10::Device& device) {
+      const c10::Device& device,
+      c10::StreamId stream_id) {
     // determine number of bytes needed for this tensor
     int64_t new_bytes = dataTypeSize(aten_to_data_type(aten_dtype));
     for (auto sz : sizes) {
       new_bytes *= sz;
     }
 
-    // align at 16 bytes regardless of requested dtype
-    int64_t aligned_allocated_bytes = (allocated_bytes_ + 15) & (~15);
-
-    // after this function returns this will be the allocated size
-    int64_t new_allocated_bytes = aligned_allocated_bytes + new_bytes;
-
-    // resize tensor_ if needed. Minimum size is 128B.
-    int64_t new_used_bytes = std::max((int64_t)128LL, tensor_.numel());
-    while (new_used_bytes < new_allocated_bytes) {
-      new_used_bytes *= 2;
+    int64_t block_bytes = min_block_bytes;
+    while (block_bytes < new_bytes) {
+      block_bytes *= 2;
     }
-    if (new_used_bytes > tensor_.numel()) {
-      if (isDebugDumpEnabled(DebugDumpOption::GlobalZeroedMemory)) {
-        debug() << "[global zeroed memory] Resizing arena to " << new_used_bytes
-                << " bytes" << std::endl;
-      }
-      tensor_ = at::zeros(
-          {new_used_bytes},
-          at::TensorOptions().dtype(at::kByte).device(device));
+
+    auto& blocks = blocks_[block_bytes];
+    auto it = std::find_if(blocks.begin(), blocks.end(), [](const Block& b) {
+      return !b.in_use;
+    });
+    if (it == blocks.end()) {
+      blocks.push_back(
+          {at::zeros(
+               {block_bytes},
+               at::TensorOptions().dtype(at::kByte).device(device)),
+           false});
+      it = std::prev(blocks.end());
+      reserved_bytes_ += block_bytes;
     }
+    it->in_use = true;
+    in_use_bytes_ += block_bytes;
 
     if (isDebugDumpEnabled(DebugDumpOption::GlobalZeroedMemory)) {
-      debug() << "[global zeroed memory] Allocating byte range: "
-              << aligned_allocated_bytes << " to " << new_used_bytes << " bytes"
-              << std::endl;
+      debug() << "[global zeroed memory] Allocating " << new_bytes
+              << " bytes in a " << block_bytes << "-byte block on device "
+              << (int)device.index() << " stream " << stream_id << ". "
+              << in_use_bytes_ << " of " << reserved_bytes_
+              << " reserved bytes in use" << std::endl;
     }
 
     // Check that memory is zeroed before allocating. Note that this launches
     // another kernel, so it is disabled for release builds.
 #ifndef NDEBUG
-    checkZeroed();
+    checkZeroed(it->tensor);
 #endif
 
-    allocated_bytes_ = new_allocated_bytes;
-
     // slice and view tensor
-    return tensor_
-        .index({at::indexing::Slice(
-            aligned_allocated_bytes, new_allocated_bytes, 1)})
+    return it->tensor.index({at::indexing::Slice(0, new_bytes, 1)})
         .view(aten_dtype)
         .view(sizes);
   }
 
+  ZeroedMemoryStats stats() const {
+    ZeroedMemoryStats stats;
+    for (const auto& [block_bytes, blocks] : blocks_) {
+      stats.num_blocks += (int64_t)blocks.size();
+    }
+    stats.reserved_bytes = reserved_bytes_;
+    stats.in_use_bytes = in_use_bytes_;
+    return stats;
+  }
+
  private:
-  void checkZeroed() const {
-    c10::Scalar nnz = at::count_nonzero(tensor_).item();
+  static void checkZeroed(const at::Tensor& tensor) {
+    c10::Scalar nnz = at::count_nonzero(tensor).item();
     NVF_ERROR(
         nnz.equal(0),
-        "Global memory arena was not properly zeroed. Found ",
+        "Global memory block was not properly zeroed. Found ",
         nnz,
         " bytes that are not zero");
   }
 
  private:
-  at::Tensor tensor_;
-  int64_t allocated_bytes_ = 0LL;
+  struct Block {
+    at::Tensor tensor;
+    bool in_use = false;
+  };
+
+  // Blocks indexed by their size in bytes
+  std::map<int64_t, std::vector<Block>> blocks_;
+  int64_t reserved_bytes_ = 0;
+  int64_t in_use_bytes_ = 0;
 };
 
-// We hold one Arena for each device
-thread_local std::vector<Arena> arenas;
+// We hold one pool for each stream of each device. Work on one stream is
+// ordered, so its blocks can be reused right after a launch. Work on
+// different streams is not, so they never share blocks.
+thread_local std::vector<std::unordered_map<c10::StreamId, ZeroedMemoryPool>>
+    pools;
 
 } // namespace
 
@@ -110,25 +141,60 @@ at::Tensor contigZeroedTensor(
     const c10::ScalarType& aten_dtype,
     const c10::Device& device) {
   NVF_ERROR(device.is_cuda(), "contigZeroTensor requires CUDA device");
+
+  // A graph would bake in a block that later launches on the capture stream
+  // reuse. Zeroing the buffer as part of the graph keeps replays
+  // independent.
+  if (c10::cuda::currentStreamCaptureStatusMayInitCtx() !=
+      c10::cuda::CaptureStatus::None) {
+    if (isDebugDumpEnabled(DebugDumpOption::GlobalZeroedMemory)) {
+      debug() << "[global zeroed memory] Allocating a zeroed tensor during "
+              << "CUDA graph capture" << std::endl;
+    }
+    return at::zeros(
+        sizes, at::TensorOptions().dtype(aten_dtype).device(device));
+  }
+
   // Intermediate cast from int8_t to uint8_t for clarity:
   // https://clang.llvm.org/extra/clang-tidy/checks/bugprone/signed-char-misuse.html
   size_t device_num = (uint8_t)device.index();
 
-  // get arena from device number, resizing arenas if needed
-  if (device_num >= arenas.size()) {
-    arenas.resize(device_num + 1);
+  // get pools from device number, resizing pools if needed
+  if (device_num >= pools.size()) {
+    pools.resize(device_num + 1);
   }
 
-  // request tensor from arena
-  return arenas[device_num].getTensor(sizes, aten_dtype, device);
+  // request tensor from the pool of the current stream
+  const c10::StreamId stream_id =
+      c10::cuda::getCurrentCUDAStream(device.index()).id();
+  return pools[device_num][stream_id].getTensor(
+      sizes, aten_dtype, device, stream_id);
 }
 
 // Note that this does not free allocated zeroed memory, but rather it marks all
 // zeroed memory as available for re-use.
 void releaseZeroedMemory() {
-  for (Arena& a : arenas) {
-    a.reset();
+  for (auto& device_pools : pools) {
+    for (auto& [stream_id, pool] : device_pools) {
+      pool.reset();
+    }
+  }
+}
+
+ZeroedMemoryStats zeroedMemoryStats(const c10::Device& device) {
+  ZeroedMemoryStats stats;
+  size_t device_num = (uint8_t)device.index();
+  if (device_num >= pools.size()) {
+    return stats;
+  }
+  for (const auto& [stream_id, pool] : pools[device_num]) {
+    ZeroedMemoryStats pool_stats = pool.stats();
+    stats.num_streams++;
+    stats.num_blocks += pool_stats.num_blocks;
+    stats.reserved_bytes += pool_stats.reserved_bytes;
+    stats.in_use_bytes += pool_stats.in_use_bytes;
   }
+  return stats;
 }
 
 } // namespace nvfuser
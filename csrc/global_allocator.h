@@ -7,6 +7,8 @@
 // clang-format on
 #pragma once
 
+#include <visibility.h>
+
 #include <ATen/ATen.h>
 
 namespace nvfuser {
@@ -14,6 +16,10 @@ namespace nvfuser {
 //! This returns a slice of a thread local at::Tensor that contains all zeroes.
 //! Uses of this memory should always "clean up" by resetting the memory to zero
 //! at the end of the kernel.
+//!
+//! Tensors come from a pool of power-of-two sized blocks for the current
+//! stream, so concurrent launches on different streams never share memory.
+//! During CUDA graph capture, a new zeroed tensor is allocated instead.
 at::Tensor contigZeroedTensor(
     const std::vector<int64_t>& sizes,
     const c10::ScalarType& aten_dtype,
@@ -24,4 +30,16 @@ at::Tensor contigZeroedTensor(
 //! memory, but rather it marks all zeroed memory as available for re-use.
 void releaseZeroedMemory();
 
+//! Usage of the zeroed memory pools of the calling thread
+struct ZeroedMemoryStats {
+  int64_t num_streams = 0;
+  int64_t num_blocks = 0;
+  int64_t reserved_bytes = 0;
+  int64_t in_use_bytes = 0;
+};
+
+//! Returns the usage of the zeroed memory pools of a device, summed over
+//! streams
+NVF_API ZeroedMemoryStats zeroedMemoryStats(const c10::Device& device);
+
 } // namespace nvfuser
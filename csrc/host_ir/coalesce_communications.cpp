@@ -0,0 +1,135 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <host_ir/coalesce_communications.h>
+
+#include <algorithm>
+#include <unordered_set>
+#include <vector>
+
+#include <ir/builder.h>
+#include <kernel_ir.h>
+#include <multidevice/communication.h>
+
+namespace nvfuser::hir {
+
+namespace {
+
+// Collectives that ProcessGroupNCCL can post in a coalesced group
+bool isCoalescable(Communication* communication) {
+  switch (communication->type()) {
+    case CommunicationType::Allgather:
+    case CommunicationType::Allreduce:
+    case CommunicationType::Broadcast:
+    case CommunicationType::ReduceScatter:
+      return true;
+    case CommunicationType::AllToAll:
+      // Variable split sizes are exchanged and waited for before posting
+      return communication->inputSplits() == nullptr;
+    default:
+      return false;
+  }
+}
+
+// Adjacent collectives that can be coalesced, and the Allocates interleaved
+// with them
+struct CoalescedRun {
+  std::vector<Expr*> allocates;
+  std::vector<Communication*> communications;
+  std::unordered_set<Val*> buffers;
+  // Number of top-level exprs spanned by the run
+  size_t size = 0;
+
+  bool canAppend(Communication* communication) const {
+    if (!isCoalescable(communication)) {
+      return false;
+    }
+    if (communications.empty()) {
+      return true;
+    }
+    return communication->team() == communications.front()->team() &&
+        buffers.count(communication->in()) == 0 &&
+        buffers.count(communication->out()) == 0;
+  }
+
+  bool isWaitOfRun(Expr* expr) const {
+    auto* wait = dynamic_cast<Wait*>(expr);
+    return wait != nullptr &&
+        std::find(
+            communications.begin(),
+            communications.end(),
+            wait->communication()) != communications.end();
+  }
+};
+
+CoalescedRun findRun(const std::vector<Expr*>& exprs, size_t begin) {
+  CoalescedRun run;
+  // Allocates are only part of the run if a collective of the run follows
+  std::vector<Expr*> pending_allocates;
+  for (size_t i = begin; i < exprs.size(); i++) {
+    Expr* expr = exprs.at(i);
+    if (expr->isA<kir::Allocate>()) {
+      pending_allocates.push_back(expr);
+      continue;
+    }
+    if (run.isWaitOfRun(expr)) {
+      run.size = i + 1 - begin;
+      continue;
+    }
+    auto* communication = dynamic_cast<Communication*>(expr);
+    if (communication == nullptr || !run.canAppend(communication)) {
+      break;
+    }
+    run.allocates.insert(
+        run.allocates.end(),
+        pending_allocates.begin(),
+        pending_allocates.end());
+    pending_allocates.clear();
+    run.communications.push_back(communication);
+    run.buffers.insert(communication->in());
+    run.buffers.insert(communication->out());
+    run.size = i + 1 - begin;
+  }
+  return run;
+}
+
+} // namespace
+
+void coalesceCommunications(HostIrContainer* hic) {
+  FusionGuard fg(hic);
+  const std::vector<Expr*>& exprs = hic->topLevelExprs();
+  std::vector<Expr*> new_exprs;
+  new_exprs.reserve(exprs.size());
+
+  size_t i = 0;
+  while (i < exprs.size()) {
+    CoalescedRun run = findRun(exprs, i);
+    if (run.communications.size() < 2) {
+      // Nothing to coalesce: keep the expr as is
+      new_exprs.push_back(exprs.at(i));
+      i++;
+      continue;
+    }
+
+    new_exprs.insert(
+        new_exprs.end(), run.allocates.begin(), run.allocates.end());
+    new_exprs.push_back(IrBuilder::create<StartCoalescing>(
+        run.communications.front()->team()));
+    new_exprs.insert(
+        new_exprs.end(),
+        run.communications.begin(),
+        run.communications.end());
+    auto* end_coalescing = IrBuilder::create<EndCoalescing>();
+    new_exprs.push_back(end_coalescing);
+    new_exprs.push_back(IrBuilder::create<Wait>(end_coalescing));
+    i += run.size;
+  }
+
+  hic->resetTopLevelExprs(std::move(new_exprs));
+}
+
+} // namespace nvfuser::hir
@@ -0,0 +1,32 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <host_ir/container.h>
+
+namespace nvfuser::hir {
+
+// Groups runs of adjacent top-level collectives of a host program into
+// coalesced regions, so that their launch latency is paid once, e.g., in one
+// NCCL group, instead of once per collective. For example,
+//
+//   Allocate(out0), Communication0(in0, out0), Wait(Communication0),
+//   Allocate(out1), Communication1(in1, out1), Wait(Communication1)
+//
+// becomes
+//
+//   Allocate(out0), Allocate(out1),
+//   StartCoalescing, Communication0, Communication1, EndCoalescing,
+//   Wait(EndCoalescing)
+//
+// A run only contains collectives on the same team, hence on the same
+// backend, and none of them may read or write the buffers of another one. Only
+// Allocates and the Waits of the run can be interleaved with its collectives.
+void coalesceCommunications(HostIrContainer* hic);
+
+} // namespace nvfuser::hir
@@ -42,6 +42,14 @@ class HostIrContainer final : public Fusion {
     return top_level_exprs_.push_back(expr);
   }
 
+  // Replaces the host program, e.g., after a pass rewrote it
+  void resetTopLevelExprs(std::vector<Expr*> exprs) {
+    for (Expr* expr : exprs) {
+      assertInContainer(expr, "Cannot add expr, ");
+    }
+    top_level_exprs_ = std::move(exprs);
+  }
+
   void pushBackKernelExecutor(std::unique_ptr<KernelExecutor> ke) {
     return kernel_executors_.push_back(std::move(ke));
   }
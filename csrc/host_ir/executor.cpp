@@ -7,6 +7,8 @@
 // clang-format on
 
 #include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAEvent.h>
+#include <c10/cuda/CUDAGuard.h>
 
 #include <dynamic_transform.h>
 #include <fusion_profiler.h>
@@ -204,8 +206,179 @@ HostIrEvaluator::HostIrEvaluator(
   expr_evaluator_.bind("numberOfStreams", params_.number_of_streams);
 }
 
+HostIrEvaluator::~HostIrEvaluator() {
+  // Errors can't be thrown from a destructor
+  for (const auto& [expr, event] : events_) {
+    cudaEventDestroy(event);
+  }
+}
+
 std::vector<at::Tensor> HostIrEvaluator::runWithInput(
     std::unordered_map<Val*, c10::IValue> val_to_IValue) {
+  if (!canUseCudaGraph(val_to_IValue)) {
+    return runEagerly(val_to_IValue);
+  }
+
+  if (!matchesGraphInputs(val_to_IValue)) {
+    // Kernels are compiled and communicators are created the first time the
+    // program runs with given inputs, neither of which can be captured, so
+    // this run stays eager
+    cuda_graph_.reset();
+    graph_outputs_.clear();
+    graph_inputs_ = val_to_IValue;
+    return runEagerly(val_to_IValue);
+  }
+
+  if (cuda_graph_ == nullptr) {
+    captureCudaGraph(val_to_IValue);
+  } else {
+    for (const auto& [val, ivalue] : val_to_IValue) {
+      if (!ivalue.isTensor()) {
+        continue;
+      }
+      at::Tensor graph_tensor = graph_inputs_.at(val).toTensor();
+      if (ivalue.toTensor().data_ptr() != graph_tensor.data_ptr()) {
+        graph_tensor.copy_(ivalue.toTensor(), /*non_blocking=*/true);
+      }
+    }
+  }
+
+  cuda_graph_->replay();
+
+  // Copy the outputs so that they stay valid across replays
+  std::vector<at::Tensor> outputs;
+  outputs.reserve(graph_outputs_.size());
+  for (const auto& output : graph_outputs_) {
+    outputs.push_back(output.defined() ? output.clone() : output);
+  }
+  return outputs;
+}
+
+bool HostIrEvaluator::canUseCudaGraph(
+    const std::unordered_map<Val*, c10::IValue>& val_to_IValue) const {
+  if (!params_.use_cuda_graph || isProfilerEnabled()) {
+    return false;
+  }
+  // CPU scalar tensors are passed by value, and overlapping tensors cannot be
+  // copied into
+  return std::all_of(
+      val_to_IValue.begin(), val_to_IValue.end(), [](const auto& entry) {
+        const c10::IValue& ivalue = entry.second;
+        return !ivalue.isTensor() ||
+            (ivalue.toTensor().is_cuda() &&
+             ivalue.toTensor().is_non_overlapping_and_dense());
+      });
+}
+
+bool HostIrEvaluator::matchesGraphInputs(
+    const std::unordered_map<Val*, c10::IValue>& val_to_IValue) const {
+  if (val_to_IValue.size() != graph_inputs_.size()) {
+    return false;
+  }
+  for (const auto& [val, ivalue] : val_to_IValue) {
+    auto it = graph_inputs_.find(val);
+    if (it == graph_inputs_.end() ||
+        ivalue.isTensor() != it->second.isTensor()) {
+      return false;
+    }
+    if (!ivalue.isTensor()) {
+      // Scalars are baked into the graph
+      if (!(ivalue == it->second)) {
+        return false;
+      }
+      continue;
+    }
+    const at::Tensor& tensor = ivalue.toTensor();
+    const at::Tensor& graph_tensor = it->second.toTensor();
+    if (tensor.sizes() != graph_tensor.sizes() ||
+        tensor.strides() != graph_tensor.strides() ||
+        tensor.scalar_type() != graph_tensor.scalar_type() ||
+        tensor.device() != graph_tensor.device()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void HostIrEvaluator::captureCudaGraph(
+    const std::unordered_map<Val*, c10::IValue>& val_to_IValue) {
+  FUSER_PERF_SCOPE("HostIrEvaluator::captureCudaGraph");
+  // The graph reads its own copy of the inputs, so that later inputs can be
+  // copied in without overwriting the tensors of the caller
+  graph_inputs_.clear();
+  for (const auto& [val, ivalue] : val_to_IValue) {
+    if (ivalue.isTensor()) {
+      const at::Tensor& tensor = ivalue.toTensor();
+      at::Tensor graph_tensor =
+          at::empty_strided(tensor.sizes(), tensor.strides(), tensor.options());
+      graph_tensor.copy_(tensor, /*non_blocking=*/true);
+      graph_inputs_.emplace(val, graph_tensor);
+    } else {
+      graph_inputs_.emplace(val, ivalue);
+    }
+  }
+
+  // Capture must not happen on the legacy default stream, which is what the
+  // default stream of the host program and GetCurrentStream usually map to.
+  // Those are replaced by the capture stream while capturing.
+  const auto device_index = static_cast<c10::DeviceIndex>(my_device_index_);
+  auto current_stream = c10::cuda::getCurrentCUDAStream(device_index);
+  auto capture_stream = c10::cuda::getStreamFromPool(
+      /*isHighPriority=*/false, device_index);
+  const auto legacy_stream = c10::cuda::getDefaultCUDAStream(device_index);
+  auto eager_streams = streams_;
+  for (auto& [key, stream] : streams_) {
+    if (stream == legacy_stream || stream == current_stream) {
+      stream = capture_stream;
+    }
+  }
+  capture_stream_ = capture_stream;
+  forked_streams_.clear();
+
+  // Values bound by the eager runs must be recomputed while capturing
+  expr_evaluator_ = ExpressionEvaluator();
+  expr_evaluator_.bind("numberOfStreams", params_.number_of_streams);
+
+  at::cuda::CUDAEvent inputs_ready;
+  inputs_ready.record(current_stream);
+  inputs_ready.block(capture_stream);
+  {
+    c10::cuda::CUDAStreamGuard stream_guard(capture_stream);
+    cuda_graph_ = std::make_unique<at::cuda::CUDAGraph>();
+    cuda_graph_->capture_begin();
+    graph_outputs_ = runEagerly(graph_inputs_);
+    // All work must be joined back to the capture stream before the capture
+    // ends
+    for (const auto& stream : forked_streams_) {
+      at::cuda::CUDAEvent stream_done;
+      stream_done.record(stream);
+      stream_done.block(capture_stream);
+    }
+    cuda_graph_->capture_end();
+  }
+  capture_stream_.reset();
+  forked_streams_.clear();
+  streams_ = std::move(eager_streams);
+
+  at::cuda::CUDAEvent captured;
+  captured.record(capture_stream);
+  captured.block(current_stream);
+}
+
+void HostIrEvaluator::forkFromCaptureStream(c10::cuda::CUDAStream stream) {
+  if (!capture_stream_.has_value() || stream == capture_stream_.value() ||
+      std::find(forked_streams_.begin(), forked_streams_.end(), stream) !=
+          forked_streams_.end()) {
+    return;
+  }
+  at::cuda::CUDAEvent fork;
+  fork.record(capture_stream_.value());
+  fork.block(stream);
+  forked_streams_.push_back(stream);
+}
+
+std::vector<at::Tensor> HostIrEvaluator::runEagerly(
+    const std::unordered_map<Val*, c10::IValue>& val_to_IValue) {
   // process input values
   for (const auto& [val, ivalue] : val_to_IValue) {
     expr_evaluator_.bind(val, IValueToPolymorphicValue(ivalue));
@@ -216,9 +389,15 @@ std::vector<at::Tensor> HostIrEvaluator::runWithInput(
   for (auto expr : container_->topLevelExprs()) {
     dispatch(expr);
   }
+  waitForDeferredWorks(/*expr=*/nullptr);
 
   // Collect global outputs
-  return getKnownTensorOrUndefined(container_->outputs(), expr_evaluator_);
+  std::vector<at::Tensor> outputs =
+      getKnownTensorOrUndefined(container_->outputs(), expr_evaluator_);
+  if (params_.use_allocation_pool) {
+    releasePooledOutputs(outputs);
+  }
+  return outputs;
 }
 
 std::string HostIrEvaluator::canRun() const {
@@ -268,7 +447,9 @@ c10::cuda::CUDAStream HostIrEvaluator::getCUDAStream(Stream* stream) {
          c10::cuda::getStreamFromPool(
              /*isHighPriority=*/false, static_cast<c10::DeviceIndex>(i))});
   }
-  return streams_.at(stream_key);
+  c10::cuda::CUDAStream cuda_stream = streams_.at(stream_key);
+  forkFromCaptureStream(cuda_stream);
+  return cuda_stream;
 }
 
 void HostIrEvaluator::handle(SetCurrentStream* set_current_stream) {
@@ -282,6 +463,18 @@ void HostIrEvaluator::handle(GetCurrentStream* get_current_stream) {
            static_cast<c10::DeviceIndex>(my_device_index_))});
 }
 
+cudaEvent_t HostIrEvaluator::getCUDAEvent(Expr* expr) {
+  auto it = events_.find(expr);
+  if (it != events_.end()) {
+    return it->second;
+  }
+  cudaEvent_t event = {};
+  NVFUSER_CUDA_RT_SAFE_CALL(
+      cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+  events_[expr] = event;
+  return event;
+}
+
 void HostIrEvaluator::handle(Synchronize* synchronize) {
   cudaStream_t current_stream =
       c10::cuda::getCurrentCUDAStream(
@@ -289,13 +482,103 @@ void HostIrEvaluator::handle(Synchronize* synchronize) {
           .stream();
   cudaStream_t stream_to_sync = getCUDAStream(synchronize->stream()).stream();
 
-  cudaEvent_t event = {};
-  NVFUSER_CUDA_RT_SAFE_CALL(
-      cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+  // Re-recording the event is safe because cudaStreamWaitEvent waits for the
+  // state of the event at the time of the call
+  cudaEvent_t event = getCUDAEvent(synchronize);
   NVFUSER_CUDA_RT_SAFE_CALL(cudaEventRecord(event, stream_to_sync));
   NVFUSER_CUDA_RT_SAFE_CALL(
       cudaStreamWaitEvent(current_stream, event, cudaEventWaitDefault));
-  NVFUSER_CUDA_RT_SAFE_CALL(cudaEventDestroy(event));
+}
+
+void HostIrEvaluator::handle(RecordEvent* record_event) {
+  cudaStream_t current_stream =
+      c10::cuda::getCurrentCUDAStream(
+          static_cast<c10::DeviceIndex>(my_device_index_))
+          .stream();
+  NVFUSER_CUDA_RT_SAFE_CALL(
+      cudaEventRecord(getCUDAEvent(record_event), current_stream));
+}
+
+void HostIrEvaluator::handle(WaitEvent* wait_event) {
+  NVF_ERROR(
+      events_.count(wait_event->recordEvent()),
+      "The event of ",
+      wait_event->recordEvent()->toString(),
+      " must be recorded before being waited for");
+  cudaStream_t current_stream =
+      c10::cuda::getCurrentCUDAStream(
+          static_cast<c10::DeviceIndex>(my_device_index_))
+          .stream();
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaStreamWaitEvent(
+      current_stream,
+      events_.at(wait_event->recordEvent()),
+      cudaEventWaitDefault));
+}
+
+void HostIrEvaluator::handle(Deallocate* deallocate) {
+  // The allocation pool keeps its own reference to pooled buffers
+  expr_evaluator_.invalidate(deallocate->buffer());
+}
+
+void HostIrEvaluator::handle(SymmetricAllocate* symmetric_allocate) {
+  NVF_ERROR(
+      communicator_ != nullptr && communicator_->is_available(),
+      "A valid communicator must be provided");
+  NVF_ERROR(
+      !capture_stream_.has_value(),
+      "Symmetric tensors can't be allocated while capturing a CUDA graph");
+  TensorView* tv = symmetric_allocate->buffer();
+  GlobalBufferInfo info =
+      getBufferInfos(expr_evaluator_, PrimDataType::Int, {tv}).at(0);
+  std::unique_ptr<SymmetricTensor>& symmetric_tensor = symmetric_tensors_[tv];
+  // All the processes run the same program, so they all reallocate together
+  if (symmetric_tensor == nullptr ||
+      !symmetric_tensor->hasSameLayout(info.sizes, info.strides, info.type)) {
+    symmetric_tensor.reset();
+    symmetric_tensor = std::make_unique<SymmetricTensor>(
+        communicator_, info.sizes, info.strides, info.type);
+  }
+  if (info.zero_init) {
+    symmetric_tensor->localTensor().zero_();
+  }
+  expr_evaluator_.bind(tv, symmetric_tensor->localTensor());
+}
+
+SymmetricTensor& HostIrEvaluator::getSymmetricTensor(TensorView* buffer) {
+  auto it = symmetric_tensors_.find(buffer);
+  NVF_ERROR(
+      it != symmetric_tensors_.end(),
+      buffer->toString(),
+      " must be allocated by a SymmetricAllocate");
+  return *it->second;
+}
+
+void HostIrEvaluator::handle(GetRemoteTensor* get_remote_tensor) {
+  const auto peer =
+      expr_evaluator_.evaluate(get_remote_tensor->peer()).as<int64_t>();
+  expr_evaluator_.bind(
+      get_remote_tensor->out(),
+      getSymmetricTensor(get_remote_tensor->buffer()).remoteTensor(peer));
+}
+
+void HostIrEvaluator::handle(PutSignal* put_signal) {
+  const auto peer = expr_evaluator_.evaluate(put_signal->peer()).as<int64_t>();
+  getSymmetricTensor(put_signal->buffer())
+      .signal(
+          peer,
+          c10::cuda::getCurrentCUDAStream(
+              static_cast<c10::DeviceIndex>(my_device_index_))
+              .stream());
+}
+
+void HostIrEvaluator::handle(WaitSignal* wait_signal) {
+  const auto peer = expr_evaluator_.evaluate(wait_signal->peer()).as<int64_t>();
+  getSymmetricTensor(wait_signal->buffer())
+      .waitSignal(
+          peer,
+          c10::cuda::getCurrentCUDAStream(
+              static_cast<c10::DeviceIndex>(my_device_index_))
+              .stream());
 }
 
 void HostIrEvaluator::handle(LaunchKernel* launch_kernel) {
@@ -313,9 +596,32 @@ void HostIrEvaluator::handle(LaunchKernel* launch_kernel) {
     args.push(input_evaluation);
   }
 
+  // Host IR isn't SSA, so the outputs may be defined by other exprs, e.g.,
+  // as the symmetric tensor of a peer, in which case the kernel writes them
+  // in place
+  std::vector<at::Tensor> preallocated_outputs;
+  for (Val* output : launch_kernel->outputs()) {
+    if (output->definition() != nullptr &&
+        output->definition() != launch_kernel) {
+      preallocated_outputs.push_back(
+          expr_evaluator_.evaluate(output).as<at::Tensor>());
+    }
+  }
+  NVF_ERROR(
+      preallocated_outputs.empty() ||
+          preallocated_outputs.size() == launch_kernel->outputs().size(),
+      "Either all or none of the outputs of ",
+      launch_kernel->toString(),
+      " must be defined by other exprs");
+
   // run the compiled kernel
   std::vector<at::Tensor> outputs =
-      container_->getKernelExecutor(launch_kernel->getIndex())->run(args);
+      container_->getKernelExecutor(launch_kernel->getIndex())
+          ->run(
+              args,
+              LaunchParams(),
+              CompileParams(),
+              std::move(preallocated_outputs));
 
   // Store the outputs in the context
   for (auto output_idx : c10::irange(outputs.size())) {
@@ -401,13 +707,74 @@ void HostIrEvaluator::handle(PostOnStream* post_ir) {
     }
   }
 
-  // Store the outputs in the context
+  // Store the outputs in the context. Host IR isn't SSA, so an output may be
+  // defined by another expr, e.g., as a slice of a buffer allocated before a
+  // loop, in which case it is written in place.
   for (auto output_idx : c10::irange(outputs.size())) {
-    expr_evaluator_.bind(
-        post_ir->outputs().at(output_idx), outputs.at(output_idx));
+    Val* output = post_ir->outputs().at(output_idx);
+    if (output->definition() != nullptr && output->definition() != post_ir) {
+      expr_evaluator_.evaluate(output).as<at::Tensor>().copy_(
+          outputs.at(output_idx));
+    } else {
+      expr_evaluator_.bind(output, outputs.at(output_idx));
+    }
   }
 }
 
+namespace {
+
+// Ratio of the bus bandwidth to the algorithm bandwidth, so that the bus
+// bandwidth of a collective is comparable to the peak link bandwidth
+// regardless of the team size, as in nccl-tests
+double busBandwidthFactor(CommunicationType type, int64_t team_size) {
+  if (team_size <= 1) {
+    return 1.0;
+  }
+  const auto n = static_cast<double>(team_size);
+  switch (type) {
+    case CommunicationType::Allreduce:
+      return 2.0 * (n - 1.0) / n;
+    case CommunicationType::Allgather:
+    case CommunicationType::ReduceScatter:
+    case CommunicationType::AllToAll:
+      return (n - 1.0) / n;
+    default:
+      return 1.0;
+  }
+}
+
+int64_t nbytesOrZero(const at::Tensor& tensor) {
+  return tensor.defined() ? static_cast<int64_t>(tensor.nbytes()) : 0;
+}
+
+} // namespace
+
+bool HostIrEvaluator::isProfilingCommunications() const {
+  // Events recorded while capturing would only be timed at replay
+  return !capture_stream_.has_value() && isProfilerEnabled() &&
+      FusionProfiler::state() == ProfilerState::Running;
+}
+
+void HostIrEvaluator::startCommunicationProfile(
+    Expr* communication,
+    const std::string& name,
+    int64_t team_size,
+    int64_t bytes,
+    double bus_bandwidth_factor) {
+  if (coalescing_profile_ >= 0) {
+    FusionProfiler::communication(coalescing_profile_).bytes += bytes;
+    return;
+  }
+  CommunicationProfile prof;
+  prof.name = name;
+  prof.device = my_device_index_;
+  prof.team_size = team_size;
+  prof.bytes = bytes;
+  prof.bus_bandwidth_factor = bus_bandwidth_factor;
+  profiled_communications_[communication] =
+      FusionProfiler::startCommunication(std::move(prof));
+}
+
 void HostIrEvaluator::handle(Communication* communication) {
   NVF_ERROR(
       communicator_ != nullptr && communicator_->is_available(),
@@ -417,15 +784,82 @@ void HostIrEvaluator::handle(Communication* communication) {
       getKnownTensorOrUndefined(communication->input(0), expr_evaluator_);
   at::Tensor output_tensor =
       getKnownTensorOrUndefined(communication->output(0), expr_evaluator_);
+  at::Tensor input_splits;
+  at::Tensor output_splits;
+  if (communication->inputSplits() != nullptr) {
+    NVF_ERROR(
+        !capture_stream_.has_value(),
+        "Variable split sizes are read on the host, so they can't be captured "
+        "into a CUDA graph");
+    input_splits = getKnownTensorOrUndefined(
+        communication->inputSplits(), expr_evaluator_);
+    output_splits = getKnownTensorOrUndefined(
+        communication->outputSplits(), expr_evaluator_);
+  }
 
+  // Coalesced groups and CUDA graphs are bound to the default backend. The
+  // input size is the same on every rank of the collectives selected by
+  // message size, so that they all select the same backend.
+  std::optional<CommunicatorBackend> backend_type;
+  if (coalescing_backend_ == nullptr && !capture_stream_.has_value()) {
+    backend_type = communicator_->selectBackend(
+        communication->type(),
+        communication->team_size(),
+        nbytesOrZero(input_tensor));
+  }
   c10d::Backend* backend =
-      communicator_->getBackendForTeam(communication->team(), std::nullopt);
-  works_[communication] = postSingleCommunication(
+      communicator_->getBackendForTeam(communication->team(), backend_type);
+  NVF_ERROR(
+      !capture_stream_.has_value() || backend->getBackendName() == "nccl",
+      "Only NCCL communications can be captured into a CUDA graph");
+  const bool is_profiled = isProfilingCommunications();
+  if (is_profiled) {
+    const auto team_size = static_cast<int64_t>(communication->team().size());
+    std::stringstream name;
+    name << communication->type();
+    startCommunicationProfile(
+        communication,
+        name.str(),
+        team_size,
+        std::max(nbytesOrZero(input_tensor), nbytesOrZero(output_tensor)),
+        busBandwidthFactor(communication->type(), team_size));
+  }
+  if (coalescing_backend_ != nullptr) {
+    // A hierarchical communication would be posted on other backends than the
+    // one of the coalesced group
+    NVF_ERROR(
+        backend == coalescing_backend_,
+        "The communication ",
+        communication->toString(),
+        " is not on the backend of the coalesced group");
+    works_[communication] = postSingleCommunication(
+        communication,
+        communicator_->deviceId(),
+        backend,
+        input_tensor,
+        output_tensor,
+        input_splits,
+        output_splits);
+    return;
+  }
+  // Deferring the wait would make the profile include the independent work
+  // enqueued in between
+  if (backend->getBackendName() != "nccl" && !is_profiled) {
+    host_blocking_works_.insert(communication);
+  }
+  auto post_communication =
+      isOptionEnabled(EnableOption::CompressedCollectives)
+      ? postCompressedCommunication
+      : postHierarchicalCommunication;
+  works_[communication] = post_communication(
       communication,
       communicator_->deviceId(),
-      backend,
+      communicator_,
+      backend_type,
       input_tensor,
-      output_tensor);
+      output_tensor,
+      input_splits,
+      output_splits);
 }
 
 void HostIrEvaluator::handle(P2PCommunication* communication) {
@@ -436,6 +870,53 @@ void HostIrEvaluator::handle(P2PCommunication* communication) {
   at::Tensor buffer =
       getKnownTensorOrUndefined(communication->buffer(), expr_evaluator_);
 
+  const bool is_profiled = isProfilingCommunications();
+  if (is_profiled) {
+    std::stringstream name;
+    name << communication->type();
+    startCommunicationProfile(
+        communication,
+        name.str(),
+        /*team_size=*/2,
+        nbytesOrZero(buffer),
+        /*bus_bandwidth_factor=*/1.0);
+  }
+
+  if (communication->backend() == CommunicatorBackend::kCuda) {
+    NVF_ERROR(
+        !capture_stream_.has_value(),
+        "CUDA IPC communications can't be captured into a CUDA graph");
+    const auto peer =
+        expr_evaluator_.evaluate(communication->peer()).as<int64_t>();
+    const bool is_send = communication->type() == P2PCommunicationType::SEND;
+    if (ipc_channels_ == nullptr) {
+      ipc_channels_ = std::make_unique<IpcP2pChannelCache>(communicator_);
+    }
+    IpcP2pChannel& channel = ipc_channels_->get(
+        /*sender=*/is_send ? my_device_index_ : peer,
+        /*receiver=*/is_send ? peer : my_device_index_,
+        static_cast<int64_t>(buffer.nbytes()));
+    cudaStream_t stream = c10::cuda::getCurrentCUDAStream(
+                              static_cast<c10::DeviceIndex>(my_device_index_))
+                              .stream();
+    if (is_send) {
+      channel.send(buffer, stream);
+    } else {
+      channel.recv(buffer, stream);
+    }
+    // The transfer is ordered on the current stream, so there is nothing to
+    // wait for
+    works_[communication] = nullptr;
+    return;
+  }
+
+  NVF_ERROR(
+      !capture_stream_.has_value() ||
+          communicator_->getWorld()->getBackendName() == "nccl",
+      "Only NCCL communications can be captured into a CUDA graph");
+  if (communicator_->getWorld()->getBackendName() != "nccl" && !is_profiled) {
+    host_blocking_works_.insert(communication);
+  }
   works_[communication] = postSingleCommunication(
       communication,
       communicator_->deviceId(),
@@ -444,16 +925,6 @@ void HostIrEvaluator::handle(P2PCommunication* communication) {
       buffer);
 }
 
-void HostIrEvaluator::handle(Wait* wait) {
-  Expr* communication = wait->communication();
-  NVF_ERROR(works_.find(communication) != works_.end(), "no wait req");
-  auto& work = works_.at(communication);
-  if (work != nullptr) {
-    work->wait();
-  }
-  works_.erase(communication);
-}
-
 namespace {
 
 void allConsumerValsOfHelper(Val* val, std::unordered_set<Val*>& visited_vals) {
@@ -482,6 +953,105 @@ std::unordered_set<Val*> allConsumerValsOf(Val* val) {
 
 } // namespace
 
+void HostIrEvaluator::handle(Wait* wait) {
+  Expr* communication = wait->communication();
+  NVF_ERROR(works_.find(communication) != works_.end(), "no wait req");
+  c10::intrusive_ptr<c10d::Work> work = works_.at(communication);
+  works_.erase(communication);
+  const bool is_host_blocking = host_blocking_works_.erase(communication);
+  if (is_host_blocking && work != nullptr) {
+    deferred_works_.push_back(
+        {work,
+         c10::cuda::getCurrentCUDAStream(
+             static_cast<c10::DeviceIndex>(my_device_index_)),
+         &getCommunicationBuffers(communication)});
+    return;
+  }
+  if (work != nullptr) {
+    // For NCCL, this only makes the current stream wait for the communication
+    work->wait();
+  }
+  // The stop event is recorded on the current stream once it has waited, so
+  // the profile is an upper bound of the communication time
+  auto profile_it = profiled_communications_.find(communication);
+  if (profile_it != profiled_communications_.end()) {
+    FusionProfiler::stopCommunication(profile_it->second);
+    profiled_communications_.erase(profile_it);
+  }
+}
+
+const std::unordered_set<Val*>& HostIrEvaluator::getCommunicationBuffers(
+    Expr* communication) {
+  auto [it, inserted] = communication_buffers_.try_emplace(communication);
+  if (!inserted) {
+    return it->second;
+  }
+  std::unordered_set<Val*>& buffers = it->second;
+  // A buffer may be a view, e.g., a select, of a tensor that other exprs
+  // access, so the whole producer chain of the buffers and all their
+  // consumers are considered touched by the communication.
+  std::vector<Val*> to_visit;
+  auto add_with_producers = [&](Val* val) {
+    to_visit.push_back(val);
+    while (!to_visit.empty()) {
+      Val* producer = to_visit.back();
+      to_visit.pop_back();
+      if (!buffers.insert(producer).second) {
+        continue;
+      }
+      Expr* definition = producer->definition();
+      if (definition != nullptr && definition != communication) {
+        to_visit.insert(
+            to_visit.end(),
+            definition->inputs().begin(),
+            definition->inputs().end());
+      }
+    }
+  };
+  for (Val* val : communication->inputs()) {
+    add_with_producers(val);
+  }
+  for (Val* val : communication->outputs()) {
+    add_with_producers(val);
+  }
+  std::vector<Val*> producers(buffers.begin(), buffers.end());
+  for (Val* producer : producers) {
+    if (producer->isA<TensorView>()) {
+      std::unordered_set<Val*> consumers = allConsumerValsOf(producer);
+      buffers.insert(consumers.begin(), consumers.end());
+    }
+  }
+  return buffers;
+}
+
+void HostIrEvaluator::waitForDeferredWorks(Expr* expr) {
+  auto touches_buffers = [expr](const DeferredWork& deferred_work) {
+    if (expr == nullptr) {
+      return true;
+    }
+    auto is_buffer = [&deferred_work](Val* val) {
+      return deferred_work.buffers->count(val) > 0;
+    };
+    return std::any_of(
+               expr->inputs().begin(), expr->inputs().end(), is_buffer) ||
+        std::any_of(expr->outputs().begin(), expr->outputs().end(), is_buffer);
+  };
+  for (auto it = deferred_works_.begin(); it != deferred_works_.end();) {
+    if (!touches_buffers(*it)) {
+      it++;
+      continue;
+    }
+    c10::cuda::CUDAStreamGuard stream_guard(it->stream);
+    it->work->wait();
+    it = deferred_works_.erase(it);
+  }
+}
+
+void HostIrEvaluator::dispatch(Expr* expr) {
+  waitForDeferredWorks(expr);
+  OptOutDispatch::dispatch(expr);
+}
+
 void HostIrEvaluator::handle(ForLoop* for_loop) {
   auto start = expr_evaluator_.evaluate(for_loop->start()).as<int64_t>();
   auto step = expr_evaluator_.evaluate(for_loop->step()).as<int64_t>();
@@ -501,19 +1071,36 @@ void HostIrEvaluator::handle(ForLoop* for_loop) {
 }
 
 void HostIrEvaluator::handle(StartCoalescing* start_coalescing) {
-  auto backend = communicator_->getWorld();
+  NVF_ERROR(
+      coalescing_backend_ == nullptr, "Coalesced groups can't be nested");
+  auto backend = start_coalescing->team().empty()
+      ? communicator_->getWorld()
+      : communicator_->getBackendForTeam(
+            start_coalescing->team(), std::nullopt);
   NVF_ERROR(
       backend->getBackendName() == "nccl",
       "ProcessGroupUCC does not implement coalescence");
   backend->startCoalescing();
+  coalescing_backend_ = backend;
+  if (isProfilingCommunications()) {
+    CommunicationProfile prof;
+    prof.name = "Coalesced";
+    prof.device = my_device_index_;
+    prof.team_size = backend->getSize();
+    coalescing_profile_ = FusionProfiler::startCommunication(std::move(prof));
+  }
 }
 
 void HostIrEvaluator::handle(EndCoalescing* end_coalescing) {
-  auto backend = communicator_->getWorld();
   NVF_ERROR(
-      backend->getBackendName() == "nccl",
-      "ProcessGroupUCC does not implement coalescence");
-  works_[end_coalescing] = backend->endCoalescing();
+      coalescing_backend_ != nullptr,
+      "EndCoalescing without a matching StartCoalescing");
+  works_[end_coalescing] = coalescing_backend_->endCoalescing();
+  coalescing_backend_ = nullptr;
+  if (coalescing_profile_ >= 0) {
+    profiled_communications_[end_coalescing] = coalescing_profile_;
+    coalescing_profile_ = -1;
+  }
 }
 
 void HostIrEvaluator::handle(kir::IfThenElse* if_then_else) {
@@ -545,6 +1132,51 @@ void HostIrEvaluator::handle(MatmulOp* matmul) {
   }
 }
 
+void HostIrEvaluator::handle(SdpaFwdOp* sdpa) {
+  std::vector<PolymorphicValue> inputs;
+  for (Val* input : sdpa->inputs()) {
+    NVF_ERROR(
+        expr_evaluator_.isKnown(input),
+        "Inputs of the attention ",
+        sdpa->toString(),
+        " must be precomputed before being retrieved");
+    inputs.push_back(expr_evaluator_.evaluate(input));
+  }
+  std::vector<PolymorphicValue> outputs =
+      sdpa->evaluate(expr_evaluator_, inputs);
+  // Outputs that are already known, e.g., slices of a preallocated buffer, are
+  // written in place. The philox scalars are rebound.
+  for (auto i : c10::irange(sdpa->outputs().size())) {
+    auto* output = sdpa->output(i)->as<TensorView>();
+    if (expr_evaluator_.isKnown(output) && !output->isCpuScalar()) {
+      expr_evaluator_.evaluate(output).as<at::Tensor>().copy_(
+          outputs.at(i).as<at::Tensor>());
+    } else {
+      expr_evaluator_.bind(output, outputs.at(i));
+    }
+  }
+}
+
+void HostIrEvaluator::handle(CatOp* cat) {
+  // The inputs of a CatOp are pads of the concatenated tensors, which the
+  // ExpressionEvaluator skips, so only the concatenated tensors must be known
+  for (Val* input : cat->inputs()) {
+    NVF_ERROR(
+        input->definition() != nullptr && input->definition()->isA<PadOp>(),
+        "Expected CatOp to be preceded by a PadOp.");
+    Val* unpadded_input = input->definition()->input(0);
+    NVF_ERROR(
+        expr_evaluator_.isKnown(unpadded_input),
+        "input ",
+        unpadded_input->toString(),
+        " of the expression ",
+        cat->toString(),
+        " must be precomputed before being retrieved");
+  }
+  expr_evaluator_.bind(
+      cat->output(0), expr_evaluator_.evaluate(cat->output(0)));
+}
+
 void HostIrEvaluator::handle(kir::Allocate* allocate) {
   NVF_ERROR(
       allocate->buffer()->isA<TensorView>(),
@@ -557,8 +1189,53 @@ void HostIrEvaluator::handle(kir::Allocate* allocate) {
       .type = AllocationType::New, .aliased_io = nullptr, .hide_output = false};
   c10::Device device =
       communicator_ ? communicator_->device() : at::Device("cuda:0");
-  at::Tensor tensor = allocateTensor(info, alias_info, device, expr_evaluator_);
-  expr_evaluator_.bind(tv, tensor);
+
+  if (!params_.use_allocation_pool) {
+    at::Tensor tensor =
+        allocateTensor(info, alias_info, device, expr_evaluator_);
+    expr_evaluator_.bind(tv, tensor);
+    return;
+  }
+
+  // Buffers are reused in stream order, like in the caching allocator
+  cudaStream_t stream = c10::cuda::getCurrentCUDAStream(
+                            static_cast<c10::DeviceIndex>(my_device_index_))
+                            .stream();
+  AllocationPool& pool = allocation_pools_[{allocate, stream}];
+  PooledBuffer& buffer = pool.buffers.at(pool.next);
+  pool.next = (pool.next + 1) % static_cast<int64_t>(pool.buffers.size());
+  if (buffer.tensor.defined() && buffer.sizes == info.sizes &&
+      buffer.strides == info.strides && buffer.type == info.type) {
+    if (info.zero_init) {
+      buffer.tensor.zero_();
+    }
+  } else {
+    buffer = {
+        allocateTensor(info, alias_info, device, expr_evaluator_),
+        info.sizes,
+        info.strides,
+        info.type};
+  }
+  expr_evaluator_.bind(tv, buffer.tensor);
+}
+
+void HostIrEvaluator::releasePooledOutputs(
+    const std::vector<at::Tensor>& outputs) {
+  for (auto& [key, pool] : allocation_pools_) {
+    for (PooledBuffer& buffer : pool.buffers) {
+      if (!buffer.tensor.defined()) {
+        continue;
+      }
+      const bool is_aliased = std::any_of(
+          outputs.begin(), outputs.end(), [&](const at::Tensor& output) {
+            return output.defined() &&
+                output.storage().is_alias_of(buffer.tensor.storage());
+          });
+      if (is_aliased) {
+        buffer = PooledBuffer();
+      }
+    }
+  }
 }
 
 void HostIrEvaluator::unhandled(Statement* stmt) {
@@ -12,13 +12,22 @@
 #include <host_ir/container.h>
 #include <host_ir/host_ir.h>
 #include <multidevice/communicator.h>
+#include <multidevice/ipc_handle.h>
+#include <multidevice/symmetric_tensor.h>
 #include <runtime/executor.h>
 #include <runtime/executor_abstract.h>
 #include <runtime/executor_params.h>
 #include <runtime/fusion_executor_cache.h>
 
+#include <ATen/cuda/CUDAGraph.h>
 #include <c10/cuda/CUDAStream.h>
 
+#include <array>
+#include <map>
+#include <optional>
+#include <unordered_set>
+#include <vector>
+
 namespace nvfuser {
 
 class HostIrExecutor : public ExecutorAbstract {
@@ -77,6 +86,18 @@ struct HostIrEvaluatorParams {
   // number of additional cuda streams to use at runtime for comm+compute
   // pipelining
   int64_t number_of_streams = 4;
+  // Experimental: capture the host program into a CUDA graph the second time
+  // it runs with given inputs, and replay the graph afterwards. Replays
+  // require the same scalar inputs and the same sizes and strides of tensor
+  // inputs as the captured run. Otherwise, the program runs eagerly and is
+  // captured again on its next run.
+  bool use_cuda_graph = false;
+  // Experimental: keep the buffers of kir::Allocate alive across loop
+  // iterations and runs, so that the steady state does no allocation. Each
+  // Allocate alternates between two buffers per stream, so that an iteration
+  // can fill a buffer while the previous one is still being read. Buffers
+  // returned as, or aliased by, outputs leave the pool.
+  bool use_allocation_pool = false;
 };
 
 class HostIrEvaluator final : public OptOutDispatch {
@@ -85,6 +106,7 @@ class HostIrEvaluator final : public OptOutDispatch {
       std::unique_ptr<HostIrContainer> container,
       Communicator* communicator = nullptr,
       HostIrEvaluatorParams = HostIrEvaluatorParams());
+  ~HostIrEvaluator() override;
   std::vector<at::Tensor> runWithInput(
       std::unordered_map<Val*, c10::IValue> val_to_IValue);
 
@@ -113,10 +135,20 @@ class HostIrEvaluator final : public OptOutDispatch {
   std::string canRun() const;
 
  private:
+  using OptOutDispatch::dispatch;
   using OptOutDispatch::handle;
+  // Waits for the deferred works the expr depends on before dispatching it
+  void dispatch(Expr* expr) override;
   void handle(SetCurrentStream* set_current_stream) override;
   void handle(GetCurrentStream* get_current_stream) override;
   void handle(Synchronize* synchronize) override;
+  void handle(RecordEvent* record_event) override;
+  void handle(WaitEvent* wait_event) override;
+  void handle(Deallocate* deallocate) override;
+  void handle(SymmetricAllocate* symmetric_allocate) override;
+  void handle(GetRemoteTensor* get_remote_tensor) override;
+  void handle(PutSignal* put_signal) override;
+  void handle(WaitSignal* wait_signal) override;
   void handle(PostOnStream* post_ir) override;
   void handle(LaunchKernel* post_ir) override;
   void handle(Communication* communication) override;
@@ -127,11 +159,65 @@ class HostIrEvaluator final : public OptOutDispatch {
   void handle(EndCoalescing* end_coalescing) override;
   void handle(kir::IfThenElse* if_then_else) override;
   void handle(MatmulOp* matmul) override;
+  void handle(SdpaFwdOp* sdpa) override;
+  void handle(CatOp* cat) override;
   void handle(kir::Allocate* allocate) override;
   void unhandled(Statement* stmt) override;
 
   c10::cuda::CUDAStream getCUDAStream(Stream* stream);
 
+  // Returns the symmetric tensor of a SymmetricAllocate
+  SymmetricTensor& getSymmetricTensor(TensorView* buffer);
+
+  // Returns the event of a RecordEvent or a Synchronize, created on first use
+  cudaEvent_t getCUDAEvent(Expr* expr);
+
+  // Returns the buffers a communication reads or writes, including the
+  // tensors they alias through the host program
+  const std::unordered_set<Val*>& getCommunicationBuffers(Expr* communication);
+
+  // Removes from the pool the buffers that outputs alias, so that the next
+  // runs don't overwrite tensors returned to the caller
+  void releasePooledOutputs(const std::vector<at::Tensor>& outputs);
+
+  // Returns true if the communications are timed by the FusionProfiler
+  bool isProfilingCommunications() const;
+
+  // Starts the profile of a communication, or adds its bytes to the profile of
+  // the coalesced group being posted
+  void startCommunicationProfile(
+      Expr* communication,
+      const std::string& name,
+      int64_t team_size,
+      int64_t bytes,
+      double bus_bandwidth_factor);
+
+  // Waits for the deferred works that touch the inputs or the outputs of
+  // expr, or for all of them if expr is nullptr
+  void waitForDeferredWorks(Expr* expr);
+
+  // Interprets the host program node by node
+  std::vector<at::Tensor> runEagerly(
+      const std::unordered_map<Val*, c10::IValue>& val_to_IValue);
+
+  // Returns true if the inputs can be run with params_.use_cuda_graph
+  bool canUseCudaGraph(
+      const std::unordered_map<Val*, c10::IValue>& val_to_IValue) const;
+
+  // Returns true if the graph captured with graph_inputs_ is valid for the
+  // given inputs
+  bool matchesGraphInputs(
+      const std::unordered_map<Val*, c10::IValue>& val_to_IValue) const;
+
+  // Runs the host program on a side stream while capturing it into
+  // cuda_graph_
+  void captureCudaGraph(
+      const std::unordered_map<Val*, c10::IValue>& val_to_IValue);
+
+  // While capturing, makes a stream used by the host program wait for the
+  // capture stream, so that its work is captured too
+  void forkFromCaptureStream(c10::cuda::CUDAStream stream);
+
   std::unique_ptr<HostIrContainer> container_;
   Communicator* communicator_;
   HostIrEvaluatorParams params_;
@@ -143,7 +229,61 @@ class HostIrEvaluator final : public OptOutDispatch {
   using StreamKey = std::variant<int64_t, Stream*>;
   std::unordered_map<StreamKey, c10::cuda::CUDAStream> streams_;
   std::unordered_map<Expr*, c10::intrusive_ptr<c10d::Work>> works_;
+  // Backend of the coalesced group being posted, if any
+  c10d::Backend* coalescing_backend_ = nullptr;
+  // Communications posted on a backend whose Work::wait blocks the host, e.g.,
+  // UCC, unlike NCCL whose wait only makes the current stream wait
+  std::unordered_set<Expr*> host_blocking_works_;
+  // A host-blocking work whose Wait has been reached. It is only waited for
+  // once an expr touches its buffers, or when the program ends, so that the
+  // host can enqueue the independent work in between.
+  struct DeferredWork {
+    c10::intrusive_ptr<c10d::Work> work;
+    // Current stream at the Wait
+    c10::cuda::CUDAStream stream;
+    const std::unordered_set<Val*>* buffers;
+  };
+  std::vector<DeferredWork> deferred_works_;
+  std::unordered_map<Expr*, std::unordered_set<Val*>> communication_buffers_;
+  std::unordered_map<Expr*, cudaEvent_t> events_;
+  // Indices in the FusionProfiler of the communications being timed, which
+  // are stopped at their Wait
+  std::unordered_map<Expr*, int64_t> profiled_communications_;
+  // Index of the profile of the coalesced group being posted, if any
+  int64_t coalescing_profile_ = -1;
+  // See HostIrEvaluatorParams::use_allocation_pool
+  struct PooledBuffer {
+    at::Tensor tensor;
+    std::vector<int64_t> sizes;
+    std::vector<int64_t> strides;
+    at::ScalarType type = at::ScalarType::Undefined;
+  };
+  struct AllocationPool {
+    std::array<PooledBuffer, 2> buffers;
+    int64_t next = 0;
+  };
+  std::map<std::pair<kir::Allocate*, cudaStream_t>, AllocationPool>
+      allocation_pools_;
+  // Channels of the P2PCommunications through CUDA IPC, created on first use
+  std::unique_ptr<IpcP2pChannelCache> ipc_channels_;
+  // Tensors of the SymmetricAllocates, kept across runs since allocating them
+  // exchanges IPC handles between all the processes of the node
+  std::unordered_map<TensorView*, std::unique_ptr<SymmetricTensor>>
+      symmetric_tensors_;
   const int64_t my_device_index_;
+
+  // Captured host program, see HostIrEvaluatorParams::use_cuda_graph
+  std::unique_ptr<at::cuda::CUDAGraph> cuda_graph_;
+  // Inputs of the last eager run, or of the graph once captured. Tensors read
+  // by the graph are owned by the graph.
+  std::unordered_map<Val*, c10::IValue> graph_inputs_;
+  // Outputs written by the graph, in the memory pool of the graph
+  std::vector<at::Tensor> graph_outputs_;
+  // Set while capturing
+  std::optional<c10::cuda::CUDAStream> capture_stream_;
+  // Streams forked from capture_stream_, which are joined back to it before
+  // the capture ends
+  std::vector<c10::cuda::CUDAStream> forked_streams_;
 };
 
 } // namespace hir
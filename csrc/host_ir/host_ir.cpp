@@ -283,7 +283,7 @@ bool Synchronize::sameAs(const Statement* other) const {
   return false;
 }
 
-StartCoalescing::StartCoalescing(IrBuilderPasskey passkey) : Expr(passkey) {
+RecordEvent::RecordEvent(IrBuilderPasskey passkey) : Expr(passkey) {
   NVF_ERROR(passkey.ir_container_ != nullptr);
   NVF_ERROR(
       passkey.ir_container_->isA<HostIrContainer>(),
@@ -291,11 +291,207 @@ StartCoalescing::StartCoalescing(IrBuilderPasskey passkey) : Expr(passkey) {
       "must be registered in a HostIrContainer");
 }
 
+NVFUSER_DEFINE_CLONE_AND_CREATE(RecordEvent)
+
+std::string RecordEvent::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << "RecordEvent " << name() << std::endl;
+  return ss.str();
+}
+
+std::string RecordEvent::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "Cannot be printed inline");
+}
+
+bool RecordEvent::sameAs(const Statement* other) const {
+  return false;
+}
+
+WaitEvent::WaitEvent(IrBuilderPasskey passkey, RecordEvent* record_event)
+    : Expr(passkey, {}, {}, {record_event}) {
+  NVF_ERROR(passkey.ir_container_ != nullptr);
+  NVF_ERROR(
+      passkey.ir_container_->isA<HostIrContainer>(),
+      this,
+      "must be registered in a HostIrContainer");
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(WaitEvent)
+
+std::string WaitEvent::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << "WaitEvent " << recordEvent()->name()
+                          << std::endl;
+  return ss.str();
+}
+
+std::string WaitEvent::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "Cannot be printed inline");
+}
+
+bool WaitEvent::sameAs(const Statement* other) const {
+  return false;
+}
+
+Deallocate::Deallocate(IrBuilderPasskey passkey, TensorView* buffer)
+    : Expr(passkey, {buffer}, {}, {}) {
+  NVF_ERROR(passkey.ir_container_ != nullptr);
+  NVF_ERROR(
+      passkey.ir_container_->isA<HostIrContainer>(),
+      this,
+      "must be registered in a HostIrContainer");
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(Deallocate)
+
+std::string Deallocate::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << "Deallocate " << buffer()->toString()
+                          << std::endl;
+  return ss.str();
+}
+
+std::string Deallocate::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "Cannot be printed inline");
+}
+
+bool Deallocate::sameAs(const Statement* other) const {
+  return false;
+}
+
+SymmetricAllocate::SymmetricAllocate(
+    IrBuilderPasskey passkey,
+    TensorView* buffer)
+    : Expr(passkey, {buffer}, {}, {}) {
+  NVF_ERROR(passkey.ir_container_ != nullptr);
+  NVF_ERROR(
+      passkey.ir_container_->isA<HostIrContainer>(),
+      this,
+      "must be registered in a HostIrContainer");
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(SymmetricAllocate)
+
+std::string SymmetricAllocate::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << "SymmetricAllocate " << buffer()->toString()
+                          << std::endl;
+  return ss.str();
+}
+
+std::string SymmetricAllocate::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "Cannot be printed inline");
+}
+
+bool SymmetricAllocate::sameAs(const Statement* other) const {
+  return false;
+}
+
+GetRemoteTensor::GetRemoteTensor(
+    IrBuilderPasskey passkey,
+    TensorView* out,
+    TensorView* buffer,
+    Val* peer)
+    : Expr(passkey, {buffer, peer}, {out}, {}) {
+  NVF_ERROR(passkey.ir_container_ != nullptr);
+  NVF_ERROR(
+      passkey.ir_container_->isA<HostIrContainer>(),
+      this,
+      "must be registered in a HostIrContainer");
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(GetRemoteTensor)
+
+std::string GetRemoteTensor::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << out()->toString() << " = GetRemoteTensor("
+                          << buffer()->toString()
+                          << ", peer=" << peer()->toInlineString() << ")"
+                          << std::endl;
+  return ss.str();
+}
+
+std::string GetRemoteTensor::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "Cannot be printed inline");
+}
+
+bool GetRemoteTensor::sameAs(const Statement* other) const {
+  return false;
+}
+
+PutSignal::PutSignal(IrBuilderPasskey passkey, TensorView* buffer, Val* peer)
+    : Expr(passkey, {buffer, peer}, {}, {}) {
+  NVF_ERROR(passkey.ir_container_ != nullptr);
+  NVF_ERROR(
+      passkey.ir_container_->isA<HostIrContainer>(),
+      this,
+      "must be registered in a HostIrContainer");
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(PutSignal)
+
+std::string PutSignal::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << "PutSignal(" << buffer()->toString()
+                          << ", peer=" << peer()->toInlineString() << ")"
+                          << std::endl;
+  return ss.str();
+}
+
+std::string PutSignal::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "Cannot be printed inline");
+}
+
+bool PutSignal::sameAs(const Statement* other) const {
+  return false;
+}
+
+WaitSignal::WaitSignal(IrBuilderPasskey passkey, TensorView* buffer, Val* peer)
+    : Expr(passkey, {buffer, peer}, {}, {}) {
+  NVF_ERROR(passkey.ir_container_ != nullptr);
+  NVF_ERROR(
+      passkey.ir_container_->isA<HostIrContainer>(),
+      this,
+      "must be registered in a HostIrContainer");
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(WaitSignal)
+
+std::string WaitSignal::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << "WaitSignal(" << buffer()->toString()
+                          << ", peer=" << peer()->toInlineString() << ")"
+                          << std::endl;
+  return ss.str();
+}
+
+std::string WaitSignal::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "Cannot be printed inline");
+}
+
+bool WaitSignal::sameAs(const Statement* other) const {
+  return false;
+}
+
+StartCoalescing::StartCoalescing(IrBuilderPasskey passkey, Team team)
+    : Expr(passkey) {
+  NVF_ERROR(passkey.ir_container_ != nullptr);
+  NVF_ERROR(
+      passkey.ir_container_->isA<HostIrContainer>(),
+      this,
+      "must be registered in a HostIrContainer");
+  addDataAttribute(std::move(team));
+}
+
 NVFUSER_DEFINE_CLONE_AND_CREATE(StartCoalescing)
 
 std::string StartCoalescing::toString(int indent_size) const {
   std::stringstream ss;
-  indent(ss, indent_size) << "StartCoalescing" << std::endl;
+  indent(ss, indent_size) << "StartCoalescing";
+  if (!team().empty()) {
+    ss << " team=(" << team() << ")";
+  }
+  ss << std::endl;
   return ss.str();
 }
 
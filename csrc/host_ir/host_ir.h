@@ -264,6 +264,232 @@ class Synchronize : public Expr {
   }
 };
 
+// Records an event on the current stream. Together with WaitEvent, it
+// expresses a dependency between two points of two streams that is resolved
+// on the device, without blocking the host.
+class RecordEvent : public Expr {
+ public:
+  using Expr::Expr;
+  RecordEvent(IrBuilderPasskey passkey);
+
+  RecordEvent(const RecordEvent& other) = delete;
+  RecordEvent& operator=(const RecordEvent& other) = delete;
+  RecordEvent(RecordEvent&& other) = delete;
+  RecordEvent& operator=(RecordEvent&& other) = delete;
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+  const char* getOpString() const override {
+    return "hir::RecordEvent";
+  }
+
+  bool sameAs(const Statement* other) const override;
+};
+
+// Makes the current stream wait for the last event recorded by the given
+// RecordEvent. Non-blocking from the host point of view.
+class WaitEvent : public Expr {
+ public:
+  using Expr::Expr;
+  WaitEvent(IrBuilderPasskey passkey, RecordEvent* record_event);
+
+  WaitEvent(const WaitEvent& other) = delete;
+  WaitEvent& operator=(const WaitEvent& other) = delete;
+  WaitEvent(WaitEvent&& other) = delete;
+  WaitEvent& operator=(WaitEvent&& other) = delete;
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+  const char* getOpString() const override {
+    return "hir::WaitEvent";
+  }
+
+  bool sameAs(const Statement* other) const override;
+
+  RecordEvent* recordEvent() const {
+    return attributes_.at(0)->as<RecordEvent>();
+  }
+};
+
+// Releases the buffer of a tensor, e.g., a gathered parameter after its last
+// use. The memory is freed once the work enqueued so far on the stream it was
+// allocated on is done.
+class Deallocate : public Expr {
+ public:
+  using Expr::Expr;
+  Deallocate(IrBuilderPasskey passkey, TensorView* buffer);
+
+  Deallocate(const Deallocate& other) = delete;
+  Deallocate& operator=(const Deallocate& other) = delete;
+  Deallocate(Deallocate&& other) = delete;
+  Deallocate& operator=(Deallocate&& other) = delete;
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+  const char* getOpString() const override {
+    return "hir::Deallocate";
+  }
+
+  bool sameAs(const Statement* other) const override;
+
+  TensorView* buffer() const {
+    return input(0)->as<TensorView>();
+  }
+};
+
+// Allocates a tensor with the same sizes on all the processes of the node and
+// maps it in the address space of all of them, see
+// multidevice/symmetric_tensor.h. It must be reached by all the processes, in
+// the same order. The allocation is kept across runs of the host program.
+//
+// Together with GetRemoteTensor, PutSignal and WaitSignal, this lets a kernel
+// write its output straight to the memory of a peer, e.g.,
+//
+//   SymmetricAllocate(buffer),
+//   GetRemoteTensor(peer_buffer, buffer, peer),
+//   LaunchKernel(Inputs: {in}, Outputs: {peer_buffer}),
+//   PutSignal(buffer, peer)
+//
+// on the producer, and
+//
+//   SymmetricAllocate(buffer),
+//   WaitSignal(buffer, peer),
+//   LaunchKernel(Inputs: {buffer}, Outputs: {out})
+//
+// on the consumer. Signals are enqueued on the current stream, so neither
+// side synchronizes with the host.
+class SymmetricAllocate : public Expr {
+ public:
+  using Expr::Expr;
+  SymmetricAllocate(IrBuilderPasskey passkey, TensorView* buffer);
+
+  SymmetricAllocate(const SymmetricAllocate& other) = delete;
+  SymmetricAllocate& operator=(const SymmetricAllocate& other) = delete;
+  SymmetricAllocate(SymmetricAllocate&& other) = delete;
+  SymmetricAllocate& operator=(SymmetricAllocate&& other) = delete;
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+  const char* getOpString() const override {
+    return "hir::SymmetricAllocate";
+  }
+
+  bool sameAs(const Statement* other) const override;
+
+  TensorView* buffer() const {
+    return input(0)->as<TensorView>();
+  }
+};
+
+// Binds out to the symmetric tensor of a peer on the same node. Exprs writing
+// out, e.g., a LaunchKernel, write to the memory of the peer in place.
+class GetRemoteTensor : public Expr {
+ public:
+  using Expr::Expr;
+  GetRemoteTensor(
+      IrBuilderPasskey passkey,
+      TensorView* out,
+      TensorView* buffer,
+      Val* peer);
+
+  GetRemoteTensor(const GetRemoteTensor& other) = delete;
+  GetRemoteTensor& operator=(const GetRemoteTensor& other) = delete;
+  GetRemoteTensor(GetRemoteTensor&& other) = delete;
+  GetRemoteTensor& operator=(GetRemoteTensor&& other) = delete;
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+  const char* getOpString() const override {
+    return "hir::GetRemoteTensor";
+  }
+
+  bool sameAs(const Statement* other) const override;
+
+  TensorView* out() const {
+    return output(0)->as<TensorView>();
+  }
+
+  TensorView* buffer() const {
+    return input(0)->as<TensorView>();
+  }
+
+  Val* peer() const {
+    return input(1);
+  }
+};
+
+// Signals a peer that the work enqueued so far on the current stream, e.g.,
+// writes to its symmetric tensor, is done
+class PutSignal : public Expr {
+ public:
+  using Expr::Expr;
+  PutSignal(IrBuilderPasskey passkey, TensorView* buffer, Val* peer);
+
+  PutSignal(const PutSignal& other) = delete;
+  PutSignal& operator=(const PutSignal& other) = delete;
+  PutSignal(PutSignal&& other) = delete;
+  PutSignal& operator=(PutSignal&& other) = delete;
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+  const char* getOpString() const override {
+    return "hir::PutSignal";
+  }
+
+  bool sameAs(const Statement* other) const override;
+
+  TensorView* buffer() const {
+    return input(0)->as<TensorView>();
+  }
+
+  Val* peer() const {
+    return input(1);
+  }
+};
+
+// Makes the current stream wait for the next PutSignal of a peer on a
+// symmetric tensor
+class WaitSignal : public Expr {
+ public:
+  using Expr::Expr;
+  WaitSignal(IrBuilderPasskey passkey, TensorView* buffer, Val* peer);
+
+  WaitSignal(const WaitSignal& other) = delete;
+  WaitSignal& operator=(const WaitSignal& other) = delete;
+  WaitSignal(WaitSignal&& other) = delete;
+  WaitSignal& operator=(WaitSignal&& other) = delete;
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+  const char* getOpString() const override {
+    return "hir::WaitSignal";
+  }
+
+  bool sameAs(const Statement* other) const override;
+
+  TensorView* buffer() const {
+    return input(0)->as<TensorView>();
+  }
+
+  Val* peer() const {
+    return input(1);
+  }
+};
+
 // For ProcessGroupNCCL, startCoalescing and endCoalescing correspond to
 // ncclGroupStart and ncclGroupEnd respectively. Those calls group p2p calls
 // that need to be progressed together -- one global work handle returned by
@@ -277,10 +503,13 @@ class Synchronize : public Expr {
 // that we don't have a fine-grain control on synchronicity, in other words, we
 // can only synchronize with the grouped communication at once.
 // Remark: ProcessGroupUCC does not implement coalesced groups for now
+//
+// The group is posted on the backend of `team`, or of the world if `team` is
+// empty. All the communications of the group must use this backend.
 class StartCoalescing : public Expr {
  public:
   using Expr::Expr;
-  StartCoalescing(IrBuilderPasskey passkey);
+  StartCoalescing(IrBuilderPasskey passkey, Team team = {});
 
   StartCoalescing(const StartCoalescing& other) = delete;
   StartCoalescing& operator=(const StartCoalescing& other) = delete;
@@ -294,6 +523,10 @@ class StartCoalescing : public Expr {
   const char* getOpString() const override {
     return "hir::StartCoalescing";
   }
+
+  const Team& team() const {
+    return attribute<Team>(0);
+  }
 };
 
 class EndCoalescing : public Expr {
@@ -7,7 +7,9 @@
 // clang-format on
 #include <device_lower/utils.h>
 #include <fusion_segmenter.h>
+#include <host_ir/coalesce_communications.h>
 #include <host_ir/lower.h>
+#include <host_ir/prefetch_allgathers.h>
 #include <ir/builder.h>
 #include <ir/interface_nodes.h>
 #include <ir/iostream.h>
@@ -15,12 +17,15 @@
 #include <multidevice/utils.h>
 #include <ops/all_ops.h>
 #include <ops/utils.h>
+#include <options.h>
 #include <preseg_passes/insert_reshardings.h>
 #include <preseg_passes/make_resharding_contiguous.h>
 #include <preseg_passes/propagate_shardings.h>
 #include <preseg_passes/reorder_sharded_axis.h>
 #include <runtime/fusion_kernel_runtime.h>
+#include <algorithm>
 #include <limits>
+#include <unordered_set>
 
 namespace nvfuser {
 
@@ -98,6 +103,16 @@ void lowerToAllgather(
       CommunicationType::Allgather, output_tv, input_tv, mesh.vector()));
 }
 
+// Adds one AllToAll communication to the vector 'comms'
+void lowerToAllToAll(
+    TensorView* input_tv,
+    TensorView* output_tv,
+    std::vector<Expr*>& comms) {
+  const DeviceMesh& mesh = input_tv->getDeviceMesh();
+  comms.push_back(IrBuilder::create<Communication>(
+      CommunicationType::AllToAll, output_tv, input_tv, mesh.vector()));
+}
+
 // Adds one or zero Broadcast communication to the vector 'comms'
 void lowerToBroadcast(
     TensorView* input_tv,
@@ -222,6 +237,411 @@ void lowerToReduceScatter(
       scattered_axis));
 }
 
+// Returns true for a reduce-scatter of the form
+//   [S, DIDx(D), D, ...] -> [Stream(S), r(D), DIDx(D), ...]
+// Each slice along S is then lowered to a reduce-scatter whose scattered
+// axis is the outermost one of the local slice.
+bool isStreamPipelinedReduceScatter(Expr* expr) {
+  auto* reduction = dynamic_cast<ReductionOp*>(expr);
+  if (reduction == nullptr) {
+    return false;
+  }
+  auto* in = reduction->in()->as<TensorView>();
+  auto* out = reduction->out()->as<TensorView>();
+  if (out->nDims() == 0 ||
+      out->axis(0)->getParallelType() != ParallelType::Stream) {
+    return false;
+  }
+  std::optional<int64_t> reduction_axis = out->getReductionAxis();
+  return reduction_axis.has_value() && reduction_axis.value() == 1 &&
+      getShardedLogicalAxis(in, ParallelType::DIDx) == 1 &&
+      getShardedLogicalAxis(out, ParallelType::DIDx) == 1;
+}
+
+// Returns true for a set within a mesh that reshards the axis right after a
+// stream-parallel outermost axis, e.g.,
+//   [Stream(S), DIDx(D), ...] -> [Stream(S), D, ...]
+// Such a set is lowered slice by slice along S, see lowerToStreamParallelLoop,
+// and the resharded axis is outermost in each slice.
+bool isStreamParallelResharding(Expr* expr) {
+  auto* ldst = dynamic_cast<LoadStoreOp*>(expr);
+  if (ldst == nullptr || ldst->opType() != LoadStoreOpType::Set) {
+    return false;
+  }
+  auto* in = ldst->in()->as<TensorView>();
+  auto* out = ldst->out()->as<TensorView>();
+  if (in->getDeviceMesh() != out->getDeviceMesh()) {
+    return false;
+  }
+  for (TensorView* tv : {in, out}) {
+    if (tv->nDims() == 0 ||
+        tv->axis(0)->getParallelType() != ParallelType::Stream ||
+        (isSharded(tv) &&
+         getShardedLogicalAxis(tv, ParallelType::DIDx) != 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the MatmulOp producing the input of a stream-pipelined
+// reduce-scatter if each slice of the matmul can be computed right before it
+// is reduce-scattered, i.e.,
+//   c_unreduced = matmul(a, b) // [S, DIDx(D), D, M/(S*D), N]
+//   c = sum(c_unreduced, {1})  // [Stream(S), r(D), DIDx(D), M/(S*D), N]
+// Returns nullptr otherwise.
+MatmulOp* getPipelinedMatmul(Expr* reduce_scatter) {
+  if (!isStreamPipelinedReduceScatter(reduce_scatter)) {
+    return nullptr;
+  }
+  auto* c_unreduced = reduce_scatter->input(0)->as<TensorView>();
+  auto* matmul = dynamic_cast<MatmulOp*>(c_unreduced->definition());
+  if (matmul == nullptr || c_unreduced->isFusionOutput() ||
+      c_unreduced->uses().size() != 1) {
+    return nullptr;
+  }
+  TensorView* a = matmul->inA();
+  if (a->nDims() < 2 ||
+      a->axis(0)->getParallelType() != ParallelType::Serial ||
+      getShardedLogicalAxis(a, ParallelType::DIDx) != 1) {
+    return nullptr;
+  }
+  return matmul;
+}
+
+// A ring decomposition of the allgather only pays off when the devices are
+// densely connected, e.g., by NVLink within a node, and when each step moves
+// enough bytes for its latency to be hidden behind the matmul of the
+// previous chunk.
+constexpr int64_t kMaxP2pRingTeamSize = 8;
+constexpr int64_t kMinP2pRingMessageBytes = 1 << 20;
+
+bool canUseP2pRing(const DeviceMesh& mesh, int64_t my_device_index) {
+  return mesh.size() >= 2 && mesh.size() <= kMaxP2pRingTeamSize &&
+      mesh.has(my_device_index);
+}
+
+// Returns a boolean Val evaluating to true if the bytes that each step of the
+// ring sends, i.e., the local chunk tva_j_local, are enough for the ring to be
+// worthwhile.
+Val* isP2pRingProfitable(TensorView* tva_j_local) {
+  Val* message_bytes = IrBuilder::create<Val>(
+      dataTypeSize(tva_j_local->dtype()), DataType::Index);
+  for (IterDomain* id :
+       TensorDomain::noReductions(tva_j_local->getLogicalDomain())) {
+    message_bytes = mul(message_bytes, id->extent());
+  }
+  return ge(
+      message_bytes,
+      IrBuilder::create<Val>(kMinP2pRingMessageBytes, DataType::Index));
+}
+
+// Computes tvc_j = matmul(allgather(tva_j), tvb) with a ring of send/recv
+// between neighboring devices of the mesh. At step k, each device multiplies
+// the chunk it received at step k-1, starting with its local chunk, while
+// forwarding it to the next device. tva_allgathered_j holds the received
+// chunks, the slot of the local chunk being left unused.
+std::vector<Expr*> lowerToP2pRingGemm(
+    TensorView* tva_j_local,
+    TensorView* tva_allgathered_j,
+    TensorView* tvb,
+    TensorView* tvc_j,
+    const DeviceMesh& mesh,
+    int64_t my_device_index) {
+  auto hic = FusionGuard::getCurFusion()->as<hir::HostIrContainer>();
+  const int64_t team_size = mesh.size();
+  const int64_t my_index_in_mesh = mesh.idxOf(my_device_index);
+  auto* send_peer = IrBuilder::create<Val>(
+      mesh.vector().at((my_index_in_mesh + 1) % team_size));
+  auto* recv_peer = IrBuilder::create<Val>(
+      mesh.vector().at((my_index_in_mesh + team_size - 1) % team_size));
+
+  // The chunk that a device holds at step k is the local chunk of the device
+  // k positions before it in the ring
+  auto* my_index_val =
+      IrBuilder::create<Val>(my_index_in_mesh, DataType::Index);
+  auto* team_size_val = IrBuilder::create<Val>(team_size, DataType::Index);
+  auto chunk_index = [&](Val* k) -> Val* {
+    return mod(add(sub(my_index_val, k), team_size_val), team_size_val);
+  };
+  auto select_chunk = [&mesh](TensorView* tv, Val* index) {
+    TensorView* chunk = select(tv, 0, index);
+    chunk->setDeviceMesh(mesh);
+    return chunk;
+  };
+
+  // Multiplies the chunk held at step k. Unless it is the last step, the chunk
+  // is forwarded to the next device and the chunk of step k+1 is received
+  // while the matmul runs.
+  auto lower_step = [&](TensorView* chunk, Val* k, bool is_last_step) {
+    TensorView* tvc_chunk = select_chunk(tvc_j, chunk_index(k));
+    auto* mm = IrBuilder::create<MatmulOp>(tvc_chunk, chunk, tvb);
+    if (is_last_step) {
+      return std::vector<Expr*>({tvc_chunk->definition(), mm});
+    }
+    TensorView* recv_buffer =
+        select_chunk(tva_allgathered_j, chunk_index(add(k, hic->oneVal())));
+    auto* end_coalescing = IrBuilder::create<hir::EndCoalescing>();
+    return std::vector<Expr*>(
+        {tvc_chunk->definition(),
+         recv_buffer->definition(),
+         IrBuilder::create<hir::StartCoalescing>(),
+         IrBuilder::create<P2PCommunication>(
+             P2PCommunicationType::SEND, chunk, send_peer),
+         IrBuilder::create<P2PCommunication>(
+             P2PCommunicationType::RECV, recv_buffer, recv_peer),
+         end_coalescing,
+         mm,
+         IrBuilder::create<hir::Wait>(end_coalescing)});
+  };
+
+  // Step 0 works on the local chunk
+  std::vector<Expr*> exprs =
+      lower_step(tva_j_local, hic->zeroVal(), /*is_last_step=*/false);
+
+  // Steps 1 to team_size-2 forward the chunk received at the previous step
+  auto* k = IrBuilder::create<Val>(DataType::Index);
+  auto* ring_loop = IrBuilder::create<ForLoop>(
+      /*IterDomain=*/tva_allgathered_j->axis(0), // unused
+      /*index=*/k,
+      /*start=*/hic->oneVal(),
+      /*stop=*/sub(team_size_val, hic->oneVal()),
+      /*step=*/hic->oneVal(),
+      /*vectorize=*/false,
+      /*vectorize_shift=*/nullptr,
+      /*unroll_required=*/false,
+      CircularBufferLoopStage::NotApplicable,
+      /*circular_buffer_loop_stage_depth=*/0);
+  TensorView* chunk = select_chunk(tva_allgathered_j, chunk_index(k));
+  ring_loop->body().push_back(chunk->definition());
+  for (Expr* expr : lower_step(chunk, k, /*is_last_step=*/false)) {
+    ring_loop->body().push_back(expr);
+  }
+  exprs.push_back(ring_loop);
+
+  // The last step has nothing left to forward
+  Val* last_k = sub(team_size_val, hic->oneVal());
+  TensorView* last_chunk =
+      select_chunk(tva_allgathered_j, chunk_index(last_k));
+  exprs.push_back(last_chunk->definition());
+  for (Expr* expr : lower_step(last_chunk, last_k, /*is_last_step=*/true)) {
+    exprs.push_back(expr);
+  }
+  return exprs;
+}
+
+// Returns a buffer of `outer_extent` copies of the local shard of tv, i.e.,
+// [outer_extent, <loop domain of tv without device dims>]
+TensorView* makeShardBuffer(TensorView* tv, Val* outer_extent) {
+  std::vector<Val*> shape = {outer_extent};
+  for (IterDomain* id : tv->getLoopDomain()) {
+    if (!id->isDeviceDim() && !id->isReduction()) {
+      shape.push_back(id->extent());
+    }
+  }
+  TensorView* buffer = TensorViewBuilder()
+                           .shape(shape)
+                           .dtype(tv->dtype())
+                           .contiguity(true)
+                           .build();
+  buffer->setDeviceMesh(tv->getDeviceMesh());
+  buffer->setMemoryType(MemoryType::Global);
+  return buffer;
+}
+
+// Merges the partial attentions of the query against each shard of the keys,
+// given as [D, N, H, L/D, Ev] and their log-sum-exps as [D, N, H, L/D]:
+//   lse = log(sum_i exp(lse_i))
+//   out = sum_i exp(lse_i - lse) * out_i
+std::unique_ptr<Fusion> makeRingAttentionCombineFusion(
+    DataType out_dtype,
+    DataType lse_dtype) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* partial_out =
+      TensorViewBuilder().ndims(5).dtype(out_dtype).contiguity(true).build();
+  TensorView* partial_lse =
+      TensorViewBuilder().ndims(4).dtype(lse_dtype).contiguity(true).build();
+  fusion->addInput(partial_out);
+  fusion->addInput(partial_lse);
+
+  // Subtracting the max keeps the exponentials in range
+  TensorView* lse_max = max(partial_lse, {0});
+  TensorView* weight =
+      exp(sub(partial_lse, broadcast(lse_max, {true, false, false, false})));
+  TensorView* weight_sum = sum(weight, {0});
+  TensorView* lse = add(log(weight_sum), lse_max);
+  TensorView* scale =
+      div(weight, broadcast(weight_sum, {true, false, false, false}));
+  TensorView* out = sum(
+      mul(castOp(DataType::Float, partial_out),
+          broadcast(scale, {false, false, false, false, true})),
+      {0});
+  fusion->addOutput(castOp(out_dtype, out));
+  fusion->addOutput(castOp(lse_dtype, lse));
+  return fusion;
+}
+
+// Computes a context-parallel attention, see isContextParallelSdpa, with a
+// ring of send/recv between neighboring devices of the mesh. At step k, each
+// device attends its query shard to the key/value shard it received at step
+// k-1, starting with its local shard, while forwarding that shard to the next
+// device. The shards are received into two alternating slots, so no rank
+// holds more than three shards of the keys and values at once. The partial
+// attentions are merged by their log-sum-exps in a final fusion.
+std::vector<Expr*> lowerToRingAttention(
+    SdpaFwdOp* sdpa,
+    int64_t my_device_index) {
+  NVF_ERROR(
+      my_device_index >= 0,
+      "Lowering a context-parallel attention requires the device index: ",
+      sdpa);
+  auto hic = FusionGuard::getCurFusion()->as<hir::HostIrContainer>();
+  TensorView* query = sdpa->query();
+  TensorView* key = sdpa->key();
+  TensorView* value = sdpa->value();
+  TensorView* attn_out = sdpa->attn_out();
+  TensorView* logsumexp = sdpa->logsumexp();
+  for (auto* tv : {query, key, value, attn_out, logsumexp}) {
+    tv->setMemoryType(MemoryType::Global);
+  }
+
+  const DeviceMesh& mesh = query->getDeviceMesh();
+  const int64_t team_size = mesh.size();
+  const int64_t my_index_in_mesh = mesh.idxOf(my_device_index);
+  auto* send_peer = IrBuilder::create<Val>(
+      mesh.vector().at((my_index_in_mesh + 1) % team_size));
+  auto* recv_peer = IrBuilder::create<Val>(
+      mesh.vector().at((my_index_in_mesh + team_size - 1) % team_size));
+  auto* team_size_val = IrBuilder::create<Val>(team_size, DataType::Index);
+  auto* num_slots = IrBuilder::create<Val>(2, DataType::Index);
+
+  TensorView* key_slots = makeShardBuffer(key, num_slots);
+  TensorView* value_slots = makeShardBuffer(value, num_slots);
+  TensorView* partial_outs = makeShardBuffer(attn_out, team_size_val);
+  TensorView* partial_lses = makeShardBuffer(logsumexp, team_size_val);
+  std::vector<Expr*> exprs;
+  for (auto* tv : {key_slots, value_slots, partial_outs, partial_lses}) {
+    exprs.push_back(IrBuilder::create<kir::Allocate>(tv, MemoryType::Global));
+  }
+
+  auto select_chunk = [&mesh](TensorView* tv, Val* index) {
+    TensorView* chunk = select(tv, 0, index);
+    chunk->setDeviceMesh(mesh);
+    return chunk;
+  };
+
+  // Attends to the shard held at step k. Unless it is the last step, the shard
+  // is forwarded to the next device and the shard of step k+1 is received
+  // while the attention runs.
+  auto lower_step = [&](TensorView* key_chunk,
+                        TensorView* value_chunk,
+                        Val* k,
+                        bool is_last_step) {
+    TensorView* partial_out = select_chunk(partial_outs, k);
+    TensorView* partial_lse = select_chunk(partial_lses, k);
+    // The philox outputs of the first step stand for those of the op. They
+    // are meaningless without dropout anyway.
+    const bool is_first_step = k->isZeroInt();
+    TensorView* philox_seed = is_first_step
+        ? sdpa->philox_seed()
+        : TensorViewBuilder().dtype(DataType::Int).build();
+    TensorView* philox_offset = is_first_step
+        ? sdpa->philox_offset()
+        : TensorViewBuilder().dtype(DataType::Int).build();
+    philox_seed->setCpuScalar(true);
+    philox_offset->setCpuScalar(true);
+    auto* attention = IrBuilder::create<SdpaFwdOp>(
+        partial_out,
+        partial_lse,
+        philox_seed,
+        philox_offset,
+        query,
+        key_chunk,
+        value_chunk,
+        sdpa->dropout_p(),
+        sdpa->is_causal(),
+        sdpa->scale());
+    std::vector<Expr*> step_exprs = {
+        partial_out->definition(), partial_lse->definition()};
+    if (is_last_step) {
+      step_exprs.push_back(attention);
+      return step_exprs;
+    }
+    Val* next_slot = mod(add(k, hic->oneVal()), num_slots);
+    TensorView* next_key_chunk = select_chunk(key_slots, next_slot);
+    TensorView* next_value_chunk = select_chunk(value_slots, next_slot);
+    auto* end_coalescing = IrBuilder::create<hir::EndCoalescing>();
+    step_exprs.insert(
+        step_exprs.end(),
+        {next_key_chunk->definition(),
+         next_value_chunk->definition(),
+         IrBuilder::create<hir::StartCoalescing>(),
+         IrBuilder::create<P2PCommunication>(
+             P2PCommunicationType::SEND, key_chunk, send_peer),
+         IrBuilder::create<P2PCommunication>(
+             P2PCommunicationType::SEND, value_chunk, send_peer),
+         IrBuilder::create<P2PCommunication>(
+             P2PCommunicationType::RECV, next_key_chunk, recv_peer),
+         IrBuilder::create<P2PCommunication>(
+             P2PCommunicationType::RECV, next_value_chunk, recv_peer),
+         end_coalescing,
+         attention,
+         IrBuilder::create<hir::Wait>(end_coalescing)});
+    return step_exprs;
+  };
+
+  // Step 0 works on the local shard
+  for (Expr* expr :
+       lower_step(key, value, hic->zeroVal(), /*is_last_step=*/false)) {
+    exprs.push_back(expr);
+  }
+
+  // Steps 1 to team_size-2 forward the shard received at the previous step
+  auto* k = IrBuilder::create<Val>(DataType::Index);
+  auto* ring_loop = IrBuilder::create<ForLoop>(
+      /*IterDomain=*/partial_outs->axis(0), // unused
+      /*index=*/k,
+      /*start=*/hic->oneVal(),
+      /*stop=*/sub(team_size_val, hic->oneVal()),
+      /*step=*/hic->oneVal(),
+      /*vectorize=*/false,
+      /*vectorize_shift=*/nullptr,
+      /*unroll_required=*/false,
+      CircularBufferLoopStage::NotApplicable,
+      /*circular_buffer_loop_stage_depth=*/0);
+  Val* slot = mod(k, num_slots);
+  TensorView* key_chunk = select_chunk(key_slots, slot);
+  TensorView* value_chunk = select_chunk(value_slots, slot);
+  ring_loop->body().push_back(key_chunk->definition());
+  ring_loop->body().push_back(value_chunk->definition());
+  for (Expr* expr :
+       lower_step(key_chunk, value_chunk, k, /*is_last_step=*/false)) {
+    ring_loop->body().push_back(expr);
+  }
+  exprs.push_back(ring_loop);
+
+  // The last step has nothing left to forward
+  Val* last_k = sub(team_size_val, hic->oneVal());
+  Val* last_slot = mod(last_k, num_slots);
+  TensorView* last_key_chunk = select_chunk(key_slots, last_slot);
+  TensorView* last_value_chunk = select_chunk(value_slots, last_slot);
+  exprs.push_back(last_key_chunk->definition());
+  exprs.push_back(last_value_chunk->definition());
+  for (Expr* expr : lower_step(
+           last_key_chunk, last_value_chunk, last_k, /*is_last_step=*/true)) {
+    exprs.push_back(expr);
+  }
+
+  auto* combine = IrBuilder::create<hir::HostUnit>(
+      makeRingAttentionCombineFusion(attn_out->dtype(), logsumexp->dtype()));
+  exprs.push_back(IrBuilder::create<hir::PostOnStream>(
+      combine,
+      std::vector<Val*>{partial_outs, partial_lses},
+      std::vector<Val*>{attn_out, logsumexp}));
+  return exprs;
+}
+
 } // namespace
 
 /*
@@ -233,11 +653,18 @@ TODO:
    sources
 *) Leverage the topology to ensure that the senders and recerivers are close
 */
-std::vector<Expr*> HostIrLower::lower(Expr* c) {
+std::vector<Expr*> HostIrLower::lower(Expr* c, int64_t my_device_index) {
   FusionGuard fg(c->fusion());
 
+  if (isContextParallelSdpa(c)) {
+    return lowerToRingAttention(c->as<SdpaFwdOp>(), my_device_index);
+  }
   if (c->isA<MatmulOp>()) {
-    return lowerToCollectiveBasedPipelinedGemmComm(c);
+    return lowerToCollectiveBasedPipelinedGemmComm(c, my_device_index);
+  }
+  if (isStreamPipelinedReduceScatter(c)) {
+    return lowerToCollectiveBasedPipelinedGemmReduceScatter(
+        c->as<ReductionOp>(), /*matmul=*/nullptr);
   }
 
   std::vector<Expr*> comms;
@@ -267,7 +694,7 @@ std::vector<Expr*> HostIrLower::lower(Expr* c) {
       c->toString(),
       " to communication is not supported");
   NVF_ERROR(
-      !isInnerResharding(c),
+      !isInnerResharding(c) || isStreamParallelResharding(c),
       "Resharding on an inner axis is not lowerable ",
       c->toString());
   bool is_reduction = c->isA<ReductionOp>();
@@ -292,7 +719,9 @@ std::vector<Expr*> HostIrLower::lower(Expr* c) {
       }
     }
   } else {
-    if (!is_input_sharded && is_output_sharded) {
+    if (isAllToAll(c)) {
+      lowerToAllToAll(input_tv, output_tv, comms);
+    } else if (!is_input_sharded && is_output_sharded) {
       lowerToScatter(input_tv, output_tv, comms);
     } else if (is_input_sharded && !is_output_sharded) {
       if (same_mesh) {
@@ -315,7 +744,10 @@ bool HostIrLower::canLower(Expr* expr, bool ignore_inner_resharding) {
     return false;
   }
   if (auto* reduction = dynamic_cast<ReductionOp*>(expr)) {
-    if (!ignore_inner_resharding && isInnerResharding(expr)) {
+    // A stream-pipelined reduce-scatter is lowered slice by slice, and the
+    // scattered axis is outermost in each slice
+    if (!ignore_inner_resharding && isInnerResharding(expr) &&
+        !isStreamPipelinedReduceScatter(expr)) {
       return false;
     }
     auto in = reduction->in()->as<TensorView>();
@@ -337,7 +769,8 @@ bool HostIrLower::canLower(Expr* expr, bool ignore_inner_resharding) {
     auto c2p_map_it = c2p_map.find(reduction_axis.at(0));
     return c2p_map_it != c2p_map.end() && c2p_map_it->second->isDeviceDim();
   } else if (auto* ldst = dynamic_cast<LoadStoreOp*>(expr)) {
-    if (!ignore_inner_resharding && isInnerResharding(expr)) {
+    if (!ignore_inner_resharding && isInnerResharding(expr) &&
+        !isStreamParallelResharding(expr)) {
       return false;
     }
     return ldst->as<LoadStoreOp>()->opType() == LoadStoreOpType::Set;
@@ -348,12 +781,15 @@ bool HostIrLower::canLower(Expr* expr, bool ignore_inner_resharding) {
         matmul->inA()->axis(0)->getParallelType() == ParallelType::Serial &&
         getShardedLogicalAxis(matmul->inA(), ParallelType::DIDx) == 1 &&
         matmul->out()->axis(0)->getParallelType() == ParallelType::Stream;
+  } else if (isContextParallelSdpa(expr)) {
+    return true;
   }
   return false;
 }
 
 std::vector<Expr*> HostIrLower::lowerToCollectiveBasedPipelinedGemmComm(
-    Expr* expr) {
+    Expr* expr,
+    int64_t my_device_index) {
   auto matmul = expr->as<MatmulOp>();
   NVF_ERROR(matmul != nullptr, "Expect a MatmulOp, got", expr);
   TensorView* tva = matmul->inA();
@@ -445,12 +881,34 @@ std::vector<Expr*> HostIrLower::lowerToCollectiveBasedPipelinedGemmComm(
       set_stream,
       tva_j->definition(),
       tva_allgathered_j->definition(),
-      communication,
-      wait,
-      tvc_j->definition(),
-      mm,
-      set_back_original_stream,
-      sync_stream};
+      tvc_j->definition()};
+  std::vector<Expr*> collective_exprs = {communication, wait, mm};
+  if (canUseP2pRing(tva->getDeviceMesh(), my_device_index)) {
+    // Whether the ring pays off depends on the message size, which is only
+    // known at runtime
+    TensorView* tva_j_local = select(tva_j, 0, hic->zeroVal());
+    tva_j_local->setDeviceMesh(tva->getDeviceMesh());
+    loop_body.push_back(tva_j_local->definition());
+    auto* if_then_else = IrBuilder::create<kir::IfThenElse>(
+        IrBuilder::create<kir::Predicate>(isP2pRingProfitable(tva_j_local)));
+    for (Expr* e : lowerToP2pRingGemm(
+             tva_j_local,
+             tva_allgathered_j,
+             tvb,
+             tvc_j,
+             tva->getDeviceMesh(),
+             my_device_index)) {
+      if_then_else->thenBody().push_back(e);
+    }
+    for (Expr* e : collective_exprs) {
+      if_then_else->elseBody().push_back(e);
+    }
+    loop_body.push_back(if_then_else);
+  } else {
+    loop_body.insert(
+        loop_body.end(), collective_exprs.begin(), collective_exprs.end());
+  }
+  loop_body.insert(loop_body.end(), {set_back_original_stream, sync_stream});
   for (Expr* expr : loop_body) {
     for_loop->body().push_back(expr);
   }
@@ -458,9 +916,725 @@ std::vector<Expr*> HostIrLower::lowerToCollectiveBasedPipelinedGemmComm(
   return {get_current_stream, allocate_tva_allgathered, allocate_tvc, for_loop};
 }
 
+std::vector<Expr*> HostIrLower::
+    lowerToCollectiveBasedPipelinedGemmReduceScatter(
+        ReductionOp* reduction,
+        MatmulOp* matmul) {
+  NVF_ERROR(
+      isStreamPipelinedReduceScatter(reduction),
+      "Expect a stream-pipelined reduce-scatter, got ",
+      reduction);
+  auto* tvc_unreduced = reduction->in()->as<TensorView>();
+  auto* tvc = reduction->out()->as<TensorView>();
+  NVF_ERROR(
+      matmul == nullptr || matmul->out() == tvc_unreduced,
+      "The matmul ",
+      matmul,
+      " is expected to produce the input of ",
+      reduction);
+  IterDomain* stream_axis = tvc->axis(0);
+
+  auto hic = FusionGuard::getCurFusion()->as<hir::HostIrContainer>();
+
+  auto* get_current_stream = IrBuilder::create<hir::GetCurrentStream>();
+  hir::Stream* original_stream = get_current_stream->stream();
+
+  std::vector<Expr*> top_level_exprs = {get_current_stream};
+  if (matmul != nullptr) {
+    tvc_unreduced->setMemoryType(MemoryType::Global);
+    top_level_exprs.push_back(
+        IrBuilder::create<kir::Allocate>(tvc_unreduced, MemoryType::Global));
+  }
+  tvc->setMemoryType(MemoryType::Global);
+  top_level_exprs.push_back(
+      IrBuilder::create<kir::Allocate>(tvc, MemoryType::Global));
+
+  auto* j =
+      IrBuilder::create<Val>(DataType::Index); // running index of the for-loop
+  auto* start = hic->zeroVal();
+  auto* stop = stream_axis->extent();
+  auto* step = hic->oneVal();
+  auto* for_loop = IrBuilder::create<ForLoop>(
+      stream_axis,
+      /*index=*/j,
+      start,
+      stop,
+      step,
+      /*vectorize=*/false,
+      /*vectorize_shift=*/nullptr,
+      /*unroll_required=*/false,
+      CircularBufferLoopStage::NotApplicable,
+      /*circular_buffer_loop_stage_depth=*/0);
+
+  auto* number_of_streams =
+      IrBuilder::create<NamedScalar>("numberOfStreams", DataType::Int);
+  auto* stream_index = mod(j, number_of_streams);
+  auto* stream = IrBuilder::create<hir::Stream>(stream_index);
+  auto* set_stream = IrBuilder::create<hir::SetCurrentStream>(stream);
+
+  // The local slice of the unreduced output has a size-1 outermost axis,
+  // the one sharded on the reduced devices. Selecting it makes the scattered
+  // axis outermost, which lets the reduce-scatter avoid copies.
+  TensorView* tvc_unreduced_j = select(tvc_unreduced, 0, j);
+  TensorView* tvc_unreduced_j_local =
+      select(tvc_unreduced_j, 0, hic->zeroVal());
+  TensorView* tvc_j = select(tvc, 0, j);
+
+  NVF_ERROR(
+      tvc_unreduced->hasDeviceMesh(),
+      "The reduction's input ",
+      tvc_unreduced,
+      "is expected to have a DeviceMesh");
+  const DeviceMesh& mesh = tvc_unreduced->getDeviceMesh();
+  for (auto tv : {tvc_unreduced_j, tvc_unreduced_j_local, tvc_j}) {
+    tv->setDeviceMesh(mesh);
+  }
+
+  std::vector<Expr*> loop_body = {set_stream};
+  if (matmul != nullptr) {
+    TensorView* tva_j = select(matmul->inA(), 0, j);
+    tva_j->setDeviceMesh(mesh);
+    auto* mm = IrBuilder::create<MatmulOp>(
+        tvc_unreduced_j, tva_j, matmul->inB());
+    loop_body.insert(
+        loop_body.end(),
+        {tva_j->definition(), tvc_unreduced_j->definition(), mm});
+  } else {
+    loop_body.push_back(tvc_unreduced_j->definition());
+  }
+
+  auto* communication = IrBuilder::create<Communication>(
+      CommunicationType::ReduceScatter,
+      /*out=*/tvc_j,
+      /*in=*/tvc_unreduced_j_local,
+      /*team=*/mesh.vector(),
+      /*root=*/-1,
+      getC10dReduceOpType(reduction->getReductionOpType()),
+      /*scattered_axis=*/0);
+  auto* wait = IrBuilder::create<hir::Wait>(communication);
+
+  auto* set_back_original_stream =
+      IrBuilder::create<hir::SetCurrentStream>(original_stream);
+  auto* sync_stream = IrBuilder::create<hir::Synchronize>(stream);
+
+  loop_body.insert(
+      loop_body.end(),
+      {tvc_unreduced_j_local->definition(),
+       tvc_j->definition(),
+       communication,
+       wait,
+       set_back_original_stream,
+       sync_stream});
+  for (Expr* expr : loop_body) {
+    for_loop->body().push_back(expr);
+  }
+
+  top_level_exprs.push_back(for_loop);
+  return top_level_exprs;
+}
+
+namespace {
+
+// Whether tv is split into micro-batches, see PipelineParams
+bool isMicroBatched(const TensorView* tv) {
+  return tv->nDims() > 0 &&
+      tv->axis(0)->getParallelType() == ParallelType::Stream;
+}
+
+// Returns a buffer of the shape of one micro-batch of tv, or of the whole of
+// tv if it isn't micro-batched
+TensorView* makeMicroBatchBuffer(TensorView* tv, int64_t num_micro_batches) {
+  std::vector<Val*> shape;
+  for (IterDomain* id : TensorDomain::noReductions(tv->getLogicalDomain())) {
+    shape.push_back(id->extent());
+  }
+  if (isMicroBatched(tv)) {
+    NVF_CHECK(
+        tv->axis(0) == tv->getLogicalDomain().front(),
+        "The micro-batched axis must be the outermost logical axis of ",
+        tv->toString());
+    shape.front() = div(
+        shape.front(),
+        IrBuilder::create<Val>(num_micro_batches, DataType::Index));
+  }
+  TensorView* buffer = TensorViewBuilder()
+                           .shape(shape)
+                           .dtype(tv->dtype())
+                           .contiguity(true)
+                           .build();
+  buffer->setDeviceMesh(tv->getDeviceMesh());
+  buffer->setMemoryType(MemoryType::Global);
+  return buffer;
+}
+
+// Returns a HostUnit computing a segment on slices of its stream-parallel
+// tensors, within which the stream-parallel axes are serial
+hir::HostUnit* makeSliceHostUnit(
+    SegmentedFusion* segmented_fusion,
+    SegmentedGroup* group) {
+  std::unique_ptr<Fusion> fusion = segmented_fusion->makeFusion(group).second;
+  for (TensorView* tv : fusion->allTvs()) {
+    for (IterDomain* id : tv->getLoopDomain()) {
+      if (id->getParallelType() == ParallelType::Stream) {
+        id->parallelize(ParallelType::Serial);
+      }
+    }
+  }
+  return IrBuilder::create<hir::HostUnit>(std::move(fusion));
+}
+
+// The compute segments of a stage of a pipeline, and the transfers, i.e.,
+// the resharding sets, of the tensors it receives from the previous stage and
+// sends to the next one
+struct PipelineStage {
+  DeviceMesh mesh;
+  std::vector<SegmentedGroup*> groups;
+  std::vector<Expr*> recvs;
+  std::vector<Expr*> sends;
+};
+
+// Lowers a pipeline-parallel fusion, see PipelineParams. Each device unrolls
+// the steps that the schedule assigns to its rank. A step posts the compute
+// segments of its stage on its micro-batch, and then coalesces the sends of
+// their results to the next stage with the recvs of the next step. The
+// coalesced group is posted on a separate stream, so that the sends overlap
+// the compute of the next step, which only waits for what it receives. Pairing
+// the sends of a step with the recvs of the next one keeps the groups of
+// neighboring ranks matched, e.g., in the steady state of 1F1B, where a rank
+// sends activations forward while receiving gradients back.
+void lowerToPipeline(
+    hir::HostIrContainer* hic,
+    SegmentedFusion* staged_fusion,
+    const std::vector<SegmentedGroup*>& group_run_order,
+    IrCloner& ir_cloner,
+    int64_t my_device_index,
+    const PipelineParams& pipeline_params) {
+  const int64_t num_micro_batches = pipeline_params.num_micro_batches;
+
+  // A compute segment belongs to the stage after the ones it receives tensors
+  // from, or else to the latest stage it reads tensors of, or else to the
+  // latest stage of its mesh.
+  std::vector<PipelineStage> stages;
+  std::unordered_map<Val*, int64_t> producing_stages;
+  std::vector<Expr*> transfers;
+  std::unordered_map<Val*, Expr*> received_tvs;
+  for (SegmentedGroup* group : group_run_order) {
+    NVF_ERROR(!group->exprs().empty(), "invalid segmentation");
+    Expr* first_expr = group->exprs().at(0);
+    if (group->exprs().size() == 1 && isResharding(first_expr)) {
+      NVF_CHECK(
+          first_expr->isA<LoadStoreOp>() &&
+              first_expr->as<LoadStoreOp>()->opType() == LoadStoreOpType::Set,
+          "Pipelines only support communications between stages, but got ",
+          first_expr->toString());
+      auto* in = first_expr->input(0)->as<TensorView>();
+      auto* out = first_expr->output(0)->as<TensorView>();
+      NVF_CHECK(
+          in->getDeviceMesh().size() == out->getDeviceMesh().size() &&
+              !isSharded(in) && !isSharded(out),
+          "Tensors sent between stages must be neither sharded nor sent to a "
+          "mesh of a different size: ",
+          first_expr->toString());
+      NVF_CHECK(
+          isMicroBatched(in) && isMicroBatched(out),
+          "Tensors sent between stages must be micro-batched: ",
+          first_expr->toString());
+      NVF_CHECK(
+          producing_stages.count(in),
+          "Tensors sent between stages must be computed by a stage: ",
+          first_expr->toString());
+      transfers.push_back(first_expr);
+      received_tvs[out] = first_expr;
+      continue;
+    }
+
+    auto output_tvs = ir_utils::filterByType<TensorView>(group->outputs());
+    NVF_ERROR(
+        output_tvs.begin() != output_tvs.end(),
+        "Compute segments must output tensors");
+    const DeviceMesh& mesh = (*output_tvs.begin())->getDeviceMesh();
+    int64_t stage = -1;
+    for (Val* in : group->inputs()) {
+      if (auto it = received_tvs.find(in); it != received_tvs.end()) {
+        stage = std::max(
+            stage, producing_stages.at(it->second->input(0)) + 1);
+      } else if (auto it = producing_stages.find(in);
+                 it != producing_stages.end()) {
+        stage = std::max(stage, it->second);
+      }
+    }
+    if (stage < 0) {
+      auto it = std::find_if(
+          stages.rbegin(), stages.rend(), [&mesh](const PipelineStage& s) {
+            return s.mesh == mesh;
+          });
+      stage = it == stages.rend()
+          ? static_cast<int64_t>(stages.size())
+          : static_cast<int64_t>(std::distance(it, stages.rend())) - 1;
+    }
+    if (stage == static_cast<int64_t>(stages.size())) {
+      stages.push_back({mesh, {}, {}, {}});
+    }
+    NVF_CHECK(
+        stages.at(stage).mesh == mesh,
+        "Stage ",
+        stage,
+        " of the pipeline runs on ",
+        stages.at(stage).mesh,
+        " but the segment computing ",
+        *output_tvs.begin(),
+        " runs on ",
+        mesh);
+    stages.at(stage).groups.push_back(group);
+    for (Val* out : group->outputs()) {
+      producing_stages[out] = stage;
+    }
+  }
+  NVF_CHECK(!stages.empty(), "A pipeline must have at least one stage");
+
+  for (Expr* transfer : transfers) {
+    const int64_t sender = producing_stages.at(transfer->input(0));
+    bool is_read = false;
+    for (auto receiver : c10::irange(stages.size())) {
+      const auto& groups = stages.at(receiver).groups;
+      if (std::none_of(groups.begin(), groups.end(), [&](SegmentedGroup* g) {
+            return std::find(
+                       g->inputs().begin(),
+                       g->inputs().end(),
+                       transfer->output(0)) != g->inputs().end();
+          })) {
+        continue;
+      }
+      NVF_CHECK(
+          static_cast<int64_t>(receiver) == sender + 1,
+          "Tensors can only be sent to the next stage of the pipeline, but ",
+          transfer->toString(),
+          " goes from stage ",
+          sender,
+          " to stage ",
+          receiver);
+      is_read = true;
+    }
+    NVF_CHECK(
+        is_read,
+        "Tensors sent between stages must be read by the next stage: ",
+        transfer->toString());
+    stages.at(sender).sends.push_back(transfer);
+    stages.at(sender + 1).recvs.push_back(transfer);
+  }
+
+  // The meshes of the stages are the ranks of the pipeline
+  std::vector<DeviceMesh> rank_meshes;
+  std::vector<int64_t> stage_ranks;
+  int64_t my_rank = -1;
+  for (const PipelineStage& stage : stages) {
+    auto it = std::find(rank_meshes.begin(), rank_meshes.end(), stage.mesh);
+    if (it == rank_meshes.end()) {
+      for (const DeviceMesh& rank_mesh : rank_meshes) {
+        for (DeviceIdxType device : stage.mesh.vector()) {
+          NVF_CHECK(
+              !rank_mesh.has(device),
+              "The stages of a pipeline must run on the same or disjoint "
+              "meshes, but ",
+              stage.mesh,
+              " and ",
+              rank_mesh,
+              " overlap");
+        }
+      }
+      if (stage.mesh.has(my_device_index)) {
+        my_rank = static_cast<int64_t>(rank_meshes.size());
+      }
+      it = rank_meshes.insert(rank_meshes.end(), stage.mesh);
+    }
+    stage_ranks.push_back(std::distance(rank_meshes.begin(), it));
+  }
+
+  for (Val* input : staged_fusion->inputs()) {
+    hic->addInput(ir_cloner.clone(input));
+  }
+
+  auto* num_micro_batches_val =
+      IrBuilder::create<Val>(num_micro_batches, DataType::Index);
+  // The values of the tensors of the fusion for each micro-batch
+  std::vector<std::unordered_map<Val*, Val*>> micro_batch_vals(
+      num_micro_batches);
+  auto get_val = [&](Val* val, int64_t micro_batch) -> Val* {
+    auto& vals = micro_batch_vals.at(micro_batch);
+    if (auto it = vals.find(val); it != vals.end()) {
+      return it->second;
+    }
+    Val* cloned = ir_cloner.clone(val);
+    auto* tv = dynamic_cast<TensorView*>(cloned);
+    NVF_ERROR(
+        tv == nullptr || val->isFusionInput(),
+        "Micro-batch ",
+        micro_batch,
+        " of ",
+        val->toString(),
+        " is read before being computed");
+    if (tv != nullptr && isMicroBatched(tv)) {
+      // The micro-batches of an input are views of equal slices of its
+      // outermost axis
+      Val* extent = div(tv->axis(0)->extent(), num_micro_batches_val);
+      std::vector<Slice> ranges(
+          TensorDomain::noReductions(tv->getLogicalDomain()).size());
+      ranges.front().start = mul(
+          extent, IrBuilder::create<Val>(micro_batch, DataType::Index));
+      ranges.front().stop = mul(
+          extent, IrBuilder::create<Val>(micro_batch + 1, DataType::Index));
+      TensorView* micro_batch_tv =
+          slice(tv, ranges, /*manual_normalization=*/true);
+      micro_batch_tv->setDeviceMesh(tv->getDeviceMesh());
+      hic->pushBackTopLevelExprs(micro_batch_tv->definition());
+      cloned = micro_batch_tv;
+    }
+    vals[val] = cloned;
+    return cloned;
+  };
+
+  // The segment fusions are shared by the micro-batches, each of them being
+  // computed by a kernel of its own
+  std::unordered_map<SegmentedGroup*, hir::HostUnit*> host_units;
+  auto get_host_unit = [&](SegmentedGroup* group) {
+    auto [it, inserted] = host_units.try_emplace(group, nullptr);
+    if (inserted) {
+      it->second = makeSliceHostUnit(staged_fusion, group);
+    }
+    return it->second;
+  };
+
+  auto* get_current_stream = IrBuilder::create<hir::GetCurrentStream>();
+  hic->pushBackTopLevelExprs(get_current_stream);
+  hir::Stream* compute_stream = get_current_stream->stream();
+  auto* communication_stream = IrBuilder::create<hir::Stream>();
+  hir::EndCoalescing* recvs_to_wait_for = nullptr;
+  std::vector<hir::EndCoalescing*> sends_to_wait_for;
+
+  // The i-th device of the mesh of a stage exchanges tensors with the i-th
+  // device of the meshes of its neighboring stages
+  auto peer_of = [my_device_index](
+                     const DeviceMesh& my_mesh, const DeviceMesh& peer_mesh) {
+    return IrBuilder::create<Val>(
+        peer_mesh.at(my_mesh.idxOf(my_device_index)));
+  };
+  auto post_transfers = [&](const PipelineStep* computed_step,
+                            const PipelineStep* next_step) {
+    std::vector<Expr*> allocations;
+    std::vector<Expr*> communications;
+    if (computed_step != nullptr) {
+      for (Expr* transfer : stages.at(computed_step->stage).sends) {
+        auto* in = transfer->input(0)->as<TensorView>();
+        auto* out = transfer->output(0)->as<TensorView>();
+        communications.push_back(IrBuilder::create<P2PCommunication>(
+            P2PCommunicationType::SEND,
+            get_val(in, computed_step->micro_batch)->as<TensorView>(),
+            peer_of(in->getDeviceMesh(), out->getDeviceMesh())));
+      }
+    }
+    if (next_step != nullptr) {
+      for (Expr* transfer : stages.at(next_step->stage).recvs) {
+        auto* in = transfer->input(0)->as<TensorView>();
+        auto* out = transfer->output(0)->as<TensorView>();
+        TensorView* buffer = makeMicroBatchBuffer(
+            ir_cloner.clone(out)->as<TensorView>(), num_micro_batches);
+        micro_batch_vals.at(next_step->micro_batch)[out] = buffer;
+        allocations.push_back(
+            IrBuilder::create<kir::Allocate>(buffer, MemoryType::Global));
+        communications.push_back(IrBuilder::create<P2PCommunication>(
+            P2PCommunicationType::RECV,
+            buffer,
+            peer_of(out->getDeviceMesh(), in->getDeviceMesh())));
+      }
+    }
+    if (communications.empty()) {
+      return;
+    }
+
+    for (Expr* allocation : allocations) {
+      hic->pushBackTopLevelExprs(allocation);
+    }
+    hic->pushBackTopLevelExprs(
+        IrBuilder::create<hir::SetCurrentStream>(communication_stream));
+    hic->pushBackTopLevelExprs(
+        IrBuilder::create<hir::Synchronize>(compute_stream));
+    hic->pushBackTopLevelExprs(IrBuilder::create<hir::StartCoalescing>());
+    for (Expr* communication : communications) {
+      hic->pushBackTopLevelExprs(communication);
+    }
+    auto* end_coalescing = IrBuilder::create<hir::EndCoalescing>();
+    hic->pushBackTopLevelExprs(end_coalescing);
+    hic->pushBackTopLevelExprs(
+        IrBuilder::create<hir::SetCurrentStream>(compute_stream));
+    if (allocations.empty()) {
+      sends_to_wait_for.push_back(end_coalescing);
+    } else {
+      recvs_to_wait_for = end_coalescing;
+    }
+  };
+
+  std::vector<PipelineStep> steps;
+  if (my_rank >= 0) {
+    steps = pipelineSteps(
+        pipeline_params.schedule, stage_ranks, num_micro_batches, my_rank);
+    post_transfers(nullptr, &steps.front());
+  }
+  for (auto i : c10::irange(steps.size())) {
+    const PipelineStep& step = steps.at(i);
+    if (recvs_to_wait_for != nullptr) {
+      hic->pushBackTopLevelExprs(
+          IrBuilder::create<hir::Wait>(recvs_to_wait_for));
+      recvs_to_wait_for = nullptr;
+    }
+    for (SegmentedGroup* group : stages.at(step.stage).groups) {
+      std::vector<Val*> inputs;
+      for (Val* in : group->inputs()) {
+        inputs.push_back(get_val(in, step.micro_batch));
+      }
+      std::vector<Val*> outputs;
+      for (Val* out : group->outputs()) {
+        NVF_CHECK(
+            out->isA<TensorView>(),
+            "Pipeline stages must output tensors, but got ",
+            out->toString());
+        TensorView* buffer = makeMicroBatchBuffer(
+            ir_cloner.clone(out)->as<TensorView>(), num_micro_batches);
+        micro_batch_vals.at(step.micro_batch)[out] = buffer;
+        outputs.push_back(buffer);
+      }
+      hic->pushBackTopLevelExprs(IrBuilder::create<hir::PostOnStream>(
+          get_host_unit(group), inputs, outputs));
+    }
+    post_transfers(&step, i + 1 < steps.size() ? &steps.at(i + 1) : nullptr);
+  }
+  for (hir::EndCoalescing* end_coalescing : sends_to_wait_for) {
+    hic->pushBackTopLevelExprs(IrBuilder::create<hir::Wait>(end_coalescing));
+  }
+
+  // Micro-batched outputs are concatenated, and the others summed
+  for (Val* output : staged_fusion->outputs()) {
+    auto it = producing_stages.find(output);
+    if (it == producing_stages.end() ||
+        stage_ranks.at(it->second) != my_rank) {
+      hic->addOutput(ir_cloner.clone(output));
+      continue;
+    }
+    std::vector<TensorView*> micro_batches;
+    for (auto micro_batch : c10::irange(num_micro_batches)) {
+      micro_batches.push_back(
+          micro_batch_vals.at(micro_batch).at(output)->as<TensorView>());
+    }
+    TensorView* result = micro_batches.front();
+    if (isMicroBatched(output->as<TensorView>())) {
+      result = cat(micro_batches, 0);
+      hic->pushBackTopLevelExprs(result->definition());
+    } else {
+      for (TensorView* micro_batch : std::vector<TensorView*>(
+               micro_batches.begin() + 1, micro_batches.end())) {
+        result = add(result, micro_batch);
+        hic->pushBackTopLevelExprs(result->definition());
+      }
+    }
+    result->setDeviceMesh(output->as<TensorView>()->getDeviceMesh());
+    hic->addOutput(result);
+  }
+}
+
+// Whether a segment computes each slice of its outputs along their
+// stream-parallel outermost axis independently of the others
+bool isStreamParallel(SegmentedGroup* group) {
+  if (group->exprs().size() == 1 && isResharding(group->exprs().at(0))) {
+    return isStreamParallelResharding(group->exprs().at(0));
+  }
+  auto output_tvs = ir_utils::filterByType<TensorView>(group->outputs());
+  return !output_tvs.empty() &&
+      std::all_of(output_tvs.begin(), output_tvs.end(), [](TensorView* tv) {
+           return isMicroBatched(tv);
+         });
+}
+
+// Returns a buffer of the shape of one slice of tv along its stream-parallel
+// axis, sharded like tv
+TensorView* makeSliceBuffer(TensorView* tv) {
+  const std::vector<IterDomain*> logical_domain =
+      TensorDomain::noReductions(tv->getLogicalDomain());
+  std::vector<Val*> shape;
+  for (IterDomain* id : logical_domain) {
+    shape.push_back(id->extent());
+  }
+  shape.front() = FusionGuard::getCurFusion()->oneVal();
+  TensorView* buffer = TensorViewBuilder()
+                           .shape(shape)
+                           .dtype(tv->dtype())
+                           .contiguity(true)
+                           .build();
+  for (auto i : c10::irange(1, logical_domain.size())) {
+    buffer->axis((int64_t)i)->parallelize(
+        logical_domain.at(i)->getParallelType());
+  }
+  buffer->setDeviceMesh(tv->getDeviceMesh());
+  buffer->setMemoryType(MemoryType::Global);
+  return buffer;
+}
+
+// Lowers consecutive stream-parallel segments, see isStreamParallel, into a
+// host loop over their stream-parallel axis. Iteration j computes the j-th
+// slice of their outputs on the stream j % numberOfStreams, so that the
+// computations and communications of different slices overlap. The
+// stream-parallel inputs of the segments are sliced, and the others are read
+// whole. The stream-parallel axes of a loop must therefore have the same
+// extent, and inputs indexed by them must be stream-parallel too.
+//
+// The outputs of communications, and the tensors read after the loop, are
+// allocated before the loop and written slice by slice. The other tensors
+// computed in the loop only exist one slice at a time.
+void lowerToStreamParallelLoop(
+    hir::HostIrContainer* hic,
+    SegmentedFusion* segmented_fusion,
+    const std::vector<SegmentedGroup*>& loop_groups,
+    const std::vector<SegmentedGroup*>& group_run_order,
+    IrCloner& ir_cloner) {
+  const std::unordered_set<SegmentedGroup*> loop_group_set(
+      loop_groups.begin(), loop_groups.end());
+  std::unordered_set<Val*> read_after_loop(
+      segmented_fusion->outputs().begin(), segmented_fusion->outputs().end());
+  for (SegmentedGroup* group : group_run_order) {
+    if (loop_group_set.count(group) == 0) {
+      read_after_loop.insert(group->inputs().begin(), group->inputs().end());
+    }
+  }
+
+  // The slices wait for the exprs before the loop, but not for each other
+  auto* get_current_stream = IrBuilder::create<hir::GetCurrentStream>();
+  hir::Stream* original_stream = get_current_stream->stream();
+  auto* record_event = IrBuilder::create<hir::RecordEvent>();
+  hic->pushBackTopLevelExprs(get_current_stream);
+  hic->pushBackTopLevelExprs(record_event);
+
+  auto* reference = ir_cloner.clone(
+      *ir_utils::filterByType<TensorView>(loop_groups.front()->outputs())
+           .begin());
+  IterDomain* stream_axis = reference->axis(0);
+  auto* j =
+      IrBuilder::create<Val>(DataType::Index); // running index of the for-loop
+  auto* for_loop = IrBuilder::create<ForLoop>(
+      stream_axis,
+      /*index=*/j,
+      /*start=*/hic->zeroVal(),
+      /*stop=*/stream_axis->extent(),
+      /*step=*/hic->oneVal(),
+      /*vectorize=*/false,
+      /*vectorize_shift=*/nullptr,
+      /*unroll_required=*/false,
+      CircularBufferLoopStage::NotApplicable,
+      /*circular_buffer_loop_stage_depth=*/0);
+
+  auto* number_of_streams =
+      IrBuilder::create<NamedScalar>("numberOfStreams", DataType::Int);
+  auto* stream = IrBuilder::create<hir::Stream>(mod(j, number_of_streams));
+  for_loop->body().push_back(IrBuilder::create<hir::SetCurrentStream>(stream));
+  for_loop->body().push_back(IrBuilder::create<hir::WaitEvent>(record_event));
+
+  auto slice_of = [&](TensorView* tv) {
+    NVF_CHECK(
+        tv->axis(0) == tv->getLogicalDomain().front(),
+        "The stream-parallel axis must be the outermost logical axis of ",
+        tv->toString());
+    std::vector<Slice> ranges(
+        TensorDomain::noReductions(tv->getLogicalDomain()).size());
+    ranges.front().start = j;
+    ranges.front().stop = add(j, hic->oneVal());
+    TensorView* tv_j = slice(tv, ranges, /*manual_normalization=*/true);
+    tv_j->setDeviceMesh(tv->getDeviceMesh());
+    for_loop->body().push_back(tv_j->definition());
+    return tv_j;
+  };
+
+  // The slices of the current iteration, by the vals of the segmented fusion
+  std::unordered_map<Val*, Val*> slices;
+  auto get_input = [&](Val* in) -> Val* {
+    if (auto it = slices.find(in); it != slices.end()) {
+      return it->second;
+    }
+    Val* cloned = ir_cloner.clone(in);
+    auto* tv = dynamic_cast<TensorView*>(cloned);
+    if (tv == nullptr || !isMicroBatched(tv)) {
+      return cloned;
+    }
+    TensorView* tv_j = slice_of(tv);
+    slices[in] = tv_j;
+    return tv_j;
+  };
+  auto get_output = [&](Val* out, bool is_communicated) {
+    NVF_CHECK(
+        out->isA<TensorView>(),
+        "Stream-parallel segments must output tensors, but got ",
+        out->toString());
+    auto* tv = ir_cloner.clone(out)->as<TensorView>();
+    TensorView* tv_j = nullptr;
+    if (is_communicated || read_after_loop.count(out)) {
+      tv->setMemoryType(MemoryType::Global);
+      hic->pushBackTopLevelExprs(
+          IrBuilder::create<kir::Allocate>(tv, MemoryType::Global));
+      tv_j = slice_of(tv);
+    } else {
+      tv_j = makeSliceBuffer(tv);
+    }
+    slices[out] = tv_j;
+    return tv_j;
+  };
+
+  for (SegmentedGroup* group : loop_groups) {
+    Expr* expr = group->exprs().at(0);
+    if (group->exprs().size() == 1 && isResharding(expr)) {
+      auto* in_j = get_input(expr->input(0))->as<TensorView>();
+      TensorView* out_j =
+          get_output(expr->output(0), /*is_communicated=*/true);
+      for (Expr* e : HostIrLower::lower(ir_cloner.clone(expr))) {
+        auto* communication = dynamic_cast<Communication*>(e);
+        NVF_ERROR(
+            communication != nullptr,
+            "Expected a Communication, got ",
+            e->toString());
+        auto* communication_j = IrBuilder::create<Communication>(
+            communication->type(),
+            out_j,
+            in_j,
+            communication->team(),
+            communication->root(),
+            communication->reduceOp(),
+            communication->scatteredAxis());
+        for_loop->body().push_back(communication_j);
+        for_loop->body().push_back(
+            IrBuilder::create<hir::Wait>(communication_j));
+      }
+      continue;
+    }
+
+    std::vector<Val*> inputs;
+    for (Val* in : group->inputs()) {
+      inputs.push_back(get_input(in));
+    }
+    std::vector<Val*> outputs;
+    for (Val* out : group->outputs()) {
+      outputs.push_back(get_output(out, /*is_communicated=*/false));
+    }
+    for_loop->body().push_back(IrBuilder::create<hir::PostOnStream>(
+        makeSliceHostUnit(segmented_fusion, group), inputs, outputs));
+  }
+
+  for_loop->body().push_back(
+      IrBuilder::create<hir::SetCurrentStream>(original_stream));
+  for_loop->body().push_back(IrBuilder::create<hir::Synchronize>(stream));
+  hic->pushBackTopLevelExprs(for_loop);
+}
+
+} // namespace
+
 std::unique_ptr<hir::HostIrContainer> HostIrLower::lower(
     std::unique_ptr<Fusion> fusion,
-    int64_t my_device_index) {
+    int64_t my_device_index,
+    const PipelineParams& pipeline_params) {
   // Sharding PreSegmenter passes.
   // Note: passes run before PreSegmenter optimization passes.
   preseg_passes::OptimizationPass<
@@ -504,12 +1678,84 @@ std::unique_ptr<hir::HostIrContainer> HostIrLower::lower(
     return cloned_vals;
   };
 
+  if (pipeline_params.num_micro_batches > 1) {
+    lowerToPipeline(
+        hic.get(),
+        staged_fusion.get(),
+        workspace.group_run_order,
+        ir_cloner,
+        my_device_index,
+        pipeline_params);
+    return hic;
+  }
+
+  // Matmuls that are computed slice by slice together with the
+  // reduce-scatter consuming them, instead of in their own segment
+  std::unordered_map<Expr*, MatmulOp*> pipelined_matmuls;
+  std::unordered_set<SegmentedGroup*> pipelined_matmul_groups;
+  for (auto group : workspace.group_run_order) {
+    if (group->exprs().size() != 1 || !isResharding(group->exprs().at(0))) {
+      continue;
+    }
+    Expr* reduce_scatter = group->exprs().at(0);
+    MatmulOp* matmul = getPipelinedMatmul(reduce_scatter);
+    if (matmul == nullptr) {
+      continue;
+    }
+    auto producer_it = std::find_if(
+        workspace.group_run_order.begin(),
+        workspace.group_run_order.end(),
+        [matmul](SegmentedGroup* producer) {
+          return producer->exprs().size() == 1 &&
+              producer->exprs().at(0) == matmul;
+        });
+    if (producer_it != workspace.group_run_order.end()) {
+      pipelined_matmuls[reduce_scatter] = matmul;
+      pipelined_matmul_groups.insert(*producer_it);
+    }
+  }
+
+  // Consecutive stream-parallel segments are lowered into one loop
+  std::vector<SegmentedGroup*> stream_parallel_groups;
+  auto lower_stream_parallel_groups = [&]() {
+    if (stream_parallel_groups.empty()) {
+      return;
+    }
+    lowerToStreamParallelLoop(
+        hic.get(),
+        staged_fusion.get(),
+        stream_parallel_groups,
+        workspace.group_run_order,
+        ir_cloner);
+    stream_parallel_groups.clear();
+  };
+
   for (auto group : workspace.group_run_order) {
     std::vector<Expr*> host_exprs;
     NVF_ERROR(!group->exprs().empty(), "invalid segmentation");
     if (involvedDevices(group->exprs().at(0)).count(my_device_index) == 0) {
       continue;
     }
+    if (pipelined_matmul_groups.count(group)) {
+      continue;
+    }
+    if (!pipelined_matmuls.count(group->exprs().at(0)) &&
+        isStreamParallel(group)) {
+      stream_parallel_groups.push_back(group);
+      continue;
+    }
+    lower_stream_parallel_groups();
+    if (auto it = pipelined_matmuls.find(group->exprs().at(0));
+        it != pipelined_matmuls.end()) {
+      // The matmul is cloned first so that the reduction reads its output
+      auto* matmul = ir_cloner.clone(it->second)->as<MatmulOp>();
+      auto* reduction = ir_cloner.clone(it->first)->as<ReductionOp>();
+      for (auto* expr : lowerToCollectiveBasedPipelinedGemmReduceScatter(
+               reduction, matmul)) {
+        hic->pushBackTopLevelExprs(expr);
+      }
+      continue;
+    }
     const bool is_resharding = std::any_of(
         group->exprs().begin(), group->exprs().end(), [](auto expr) {
           return isResharding(expr);
@@ -519,7 +1765,8 @@ std::unique_ptr<hir::HostIrContainer> HostIrLower::lower(
           group->exprs().size() == 1,
           "Communication segments must contain only one Expr");
       for (auto* expr :
-           HostIrLower::lower(ir_cloner.clone(group->exprs().at(0)))) {
+           HostIrLower::lower(
+               ir_cloner.clone(group->exprs().at(0)), my_device_index)) {
         // Allocate the recv buffers of communications
         if (expr->isA<Communication>()) {
           auto* communication = expr->as<Communication>();
@@ -544,6 +1791,7 @@ std::unique_ptr<hir::HostIrContainer> HostIrLower::lower(
       hic->pushBackTopLevelExprs(post_on_stream);
     }
   }
+  lower_stream_parallel_groups();
   for (auto input : staged_fusion->inputs()) {
     hic->addInput(ir_cloner.clone(input));
   }
@@ -551,6 +1799,34 @@ std::unique_ptr<hir::HostIrContainer> HostIrLower::lower(
     hic->addOutput(ir_cloner.clone(output));
   }
 
+  // Parameter allgathers are hoisted before the adjacent collectives are
+  // grouped
+  if (isOptionEnabled(EnableOption::PrefetchAllgathers)) {
+    int64_t max_distance = 2;
+    int64_t memory_budget_mib = 1024;
+    const auto& args =
+        getEnableOptionArguments(EnableOption::PrefetchAllgathers);
+    if (!args.empty()) {
+      max_distance = std::stol(args.at(0));
+    }
+    if (args.size() > 1) {
+      memory_budget_mib = std::stol(args.at(1));
+    }
+    NVF_CHECK(
+        max_distance >= 0 && memory_budget_mib >= 0,
+        "Invalid prefetch_allgathers arguments: ",
+        max_distance,
+        " compute segments, ",
+        memory_budget_mib,
+        " MiB");
+    hir::prefetchAllgathers(
+        hic.get(), max_distance, memory_budget_mib << 20);
+  }
+
+  if (isOptionEnabled(EnableOption::CoalesceCommunications)) {
+    hir::coalesceCommunications(hic.get());
+  }
+
   return hic;
 }
 
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <host_ir/container.h>
+#include <host_ir/pipeline.h>
 #include <ir/base_nodes.h>
 #include <multidevice/communication.h>
 #include <multidevice/multidevice.h>
@@ -21,15 +22,38 @@ class HostIrLower {
   // behaviors
   static bool canLower(Expr* expr, bool ignore_inner_resharding = false);
 
-  // Lower a sharded Expr into a series of Communication.
-  static std::vector<Expr*> lower(Expr* c);
+  // Lower a sharded Expr into a series of Communication. Lowerings that
+  // depend on the position of the device in the mesh, e.g., rings of
+  // send/recv, are only considered if my_device_index is given.
+  static std::vector<Expr*> lower(Expr* c, int64_t my_device_index = -1);
 
+  // Lowers a segmented fusion into a host program. If
+  // pipeline_params.num_micro_batches is larger than 1, the stages of the
+  // fusion are run on micro-batches in the order of pipeline_params.schedule,
+  // see PipelineParams. Otherwise, consecutive segments whose outputs are
+  // parallelized with ParallelType::Stream on their outermost axis are lowered
+  // into a host loop computing them slice by slice on a pool of streams.
   static std::unique_ptr<hir::HostIrContainer> lower(
       std::unique_ptr<Fusion> fusion,
-      int64_t my_device_index);
+      int64_t my_device_index,
+      const PipelineParams& pipeline_params = PipelineParams());
 
  private:
-  static std::vector<Expr*> lowerToCollectiveBasedPipelinedGemmComm(Expr* expr);
+  // Lowers c = matmul(a, b), a being sharded, into a stream-pipelined loop
+  // allgathering each slice of a before multiplying it. When the mesh is small
+  // enough and the slices large enough, each allgather is decomposed into a
+  // ring of send/recv overlapped with the matmuls of the received chunks.
+  static std::vector<Expr*> lowerToCollectiveBasedPipelinedGemmComm(
+      Expr* expr,
+      int64_t my_device_index);
+
+  // Lowers a reduce-scatter whose output is stream-parallelized on axis 0
+  // into a loop posting one ReduceScatter per slice. If matmul is given, it
+  // must produce the input of the reduction, and each slice of it is computed
+  // in the loop right before being reduce-scattered.
+  static std::vector<Expr*> lowerToCollectiveBasedPipelinedGemmReduceScatter(
+      ReductionOp* reduction,
+      MatmulOp* matmul);
 };
 
 } // namespace nvfuser
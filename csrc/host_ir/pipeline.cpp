@@ -0,0 +1,162 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <host_ir/pipeline.h>
+
+#include <exceptions.h>
+
+#include <c10/util/irange.h>
+
+#include <algorithm>
+
+namespace nvfuser {
+
+std::ostream& operator<<(std::ostream& os, PipelineSchedule schedule) {
+  switch (schedule) {
+    case PipelineSchedule::OneFOneB:
+      return os << "OneFOneB";
+    case PipelineSchedule::Interleaved:
+      return os << "Interleaved";
+  }
+  NVF_THROW("unrecognized PipelineSchedule");
+}
+
+std::ostream& operator<<(std::ostream& os, const PipelineStep& step) {
+  return os << "PipelineStep{stage: " << step.stage
+            << ", micro_batch: " << step.micro_batch << "}";
+}
+
+namespace {
+
+std::vector<PipelineStep> oneFOneBSteps(
+    const std::vector<int64_t>& stage_ranks,
+    int64_t num_ranks,
+    int64_t num_micro_batches,
+    int64_t rank) {
+  const auto num_stages = static_cast<int64_t>(stage_ranks.size());
+  const bool has_backward = num_ranks > 1 && num_stages == 2 * num_ranks - 1;
+  NVF_CHECK(
+      num_stages == num_ranks || has_backward,
+      "A 1F1B pipeline of ",
+      num_ranks,
+      " ranks must have as many stages, or twice as many minus one with the "
+      "backward stages, but has ",
+      num_stages);
+  for (auto stage : c10::irange(num_stages)) {
+    const int64_t expected_rank =
+        stage < num_ranks ? stage : num_stages - 1 - stage;
+    NVF_CHECK(
+        stage_ranks.at(stage) == expected_rank,
+        "Stage ",
+        stage,
+        " of a 1F1B pipeline must run on rank ",
+        expected_rank,
+        ", but runs on rank ",
+        stage_ranks.at(stage));
+  }
+
+  std::vector<PipelineStep> steps;
+  const int64_t forward = rank;
+  const int64_t backward = num_stages - 1 - rank;
+  if (!has_backward || forward == backward) {
+    for (auto micro_batch : c10::irange(num_micro_batches)) {
+      steps.push_back({forward, micro_batch});
+    }
+    return steps;
+  }
+
+  const int64_t num_warmup_steps =
+      std::min(num_ranks - 1 - rank, num_micro_batches);
+  for (auto micro_batch : c10::irange(num_warmup_steps)) {
+    steps.push_back({forward, micro_batch});
+  }
+  for (auto micro_batch :
+       c10::irange(num_micro_batches - num_warmup_steps)) {
+    steps.push_back({forward, micro_batch + num_warmup_steps});
+    steps.push_back({backward, micro_batch});
+  }
+  for (auto micro_batch : c10::irange(
+           num_micro_batches - num_warmup_steps, num_micro_batches)) {
+    steps.push_back({backward, micro_batch});
+  }
+  return steps;
+}
+
+std::vector<PipelineStep> interleavedSteps(
+    const std::vector<int64_t>& stage_ranks,
+    int64_t num_ranks,
+    int64_t num_micro_batches,
+    int64_t rank) {
+  const auto num_stages = static_cast<int64_t>(stage_ranks.size());
+  NVF_CHECK(
+      num_stages % num_ranks == 0,
+      "An interleaved pipeline of ",
+      num_ranks,
+      " ranks must have a multiple of that many stages, but has ",
+      num_stages);
+  for (auto stage : c10::irange(num_stages)) {
+    NVF_CHECK(
+        stage_ranks.at(stage) == stage % num_ranks,
+        "Stage ",
+        stage,
+        " of an interleaved pipeline must run on rank ",
+        stage % num_ranks,
+        ", but runs on rank ",
+        stage_ranks.at(stage));
+  }
+  NVF_CHECK(
+      num_micro_batches % num_ranks == 0,
+      "The number of micro-batches of an interleaved pipeline must be a "
+      "multiple of its number of ranks, ",
+      num_ranks,
+      ", but is ",
+      num_micro_batches);
+
+  std::vector<PipelineStep> steps;
+  const int64_t num_chunks = num_stages / num_ranks;
+  for (int64_t group = 0; group < num_micro_batches; group += num_ranks) {
+    for (auto chunk : c10::irange(num_chunks)) {
+      for (auto micro_batch : c10::irange(group, group + num_ranks)) {
+        steps.push_back({chunk * num_ranks + rank, micro_batch});
+      }
+    }
+  }
+  return steps;
+}
+
+} // namespace
+
+std::vector<PipelineStep> pipelineSteps(
+    PipelineSchedule schedule,
+    const std::vector<int64_t>& stage_ranks,
+    int64_t num_micro_batches,
+    int64_t rank) {
+  NVF_CHECK(!stage_ranks.empty(), "A pipeline must have at least one stage");
+  NVF_CHECK(
+      num_micro_batches > 0,
+      "The number of micro-batches must be positive, but is ",
+      num_micro_batches);
+  const int64_t num_ranks =
+      *std::max_element(stage_ranks.begin(), stage_ranks.end()) + 1;
+  NVF_CHECK(
+      rank >= 0 && rank < num_ranks,
+      "Rank ",
+      rank,
+      " is out of a pipeline of ",
+      num_ranks,
+      " ranks");
+
+  switch (schedule) {
+    case PipelineSchedule::OneFOneB:
+      return oneFOneBSteps(stage_ranks, num_ranks, num_micro_batches, rank);
+    case PipelineSchedule::Interleaved:
+      return interleavedSteps(stage_ranks, num_ranks, num_micro_batches, rank);
+  }
+  NVF_THROW("unrecognized PipelineSchedule");
+}
+
+} // namespace nvfuser
@@ -0,0 +1,70 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <visibility.h>
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace nvfuser {
+
+// Order in which the devices of a pipeline run the stages of the micro-batches.
+// Stages are the maximal parts of a fusion computed on one device mesh, in
+// topological order. The meshes of the stages are the ranks of the pipeline,
+// numbered by their first stage.
+enum class PipelineSchedule {
+  // One forward stage per rank, optionally followed by the backward stages
+  // running through the ranks in reverse order, the last rank running its
+  // forward and backward as a single stage, e.g., meshes {0}, {1}, {2}, {1},
+  // {0}. Each rank runs the forward stage of as many micro-batches as there
+  // are ranks after it, and then alternates one forward and one backward
+  // stage, so that it only keeps the activations of a few micro-batches.
+  OneFOneB,
+  // Several forward stages, i.e., model chunks, per rank, assigned to the
+  // ranks in a round-robin fashion, e.g., meshes {0}, {1}, {0}, {1}. Each rank
+  // runs all its chunks of one group of as many micro-batches as there are
+  // ranks before moving on to the next group, which shrinks the bubble by the
+  // number of chunks. The number of micro-batches must be a multiple of the
+  // number of ranks.
+  Interleaved
+};
+
+std::ostream& operator<<(std::ostream& os, PipelineSchedule schedule);
+
+// Micro-batched tensors of a pipeline-parallel fusion have their outermost
+// axis parallelized with ParallelType::Stream. Each stage is computed on
+// micro-batches of num_micro_batches equal slices of that axis. Micro-batched
+// outputs are concatenated and other outputs, e.g., weight gradients, are
+// summed over the micro-batches.
+struct PipelineParams {
+  // 1 disables pipelining
+  int64_t num_micro_batches = 1;
+  PipelineSchedule schedule = PipelineSchedule::OneFOneB;
+};
+
+// A stage of the pipeline computed on a micro-batch
+struct PipelineStep {
+  int64_t stage = 0;
+  int64_t micro_batch = 0;
+
+  bool operator==(const PipelineStep& other) const = default;
+};
+
+std::ostream& operator<<(std::ostream& os, const PipelineStep& step);
+
+// Returns the steps that the device of the given rank runs, in order.
+// stage_ranks holds the rank that runs each stage.
+NVF_API std::vector<PipelineStep> pipelineSteps(
+    PipelineSchedule schedule,
+    const std::vector<int64_t>& stage_ranks,
+    int64_t num_micro_batches,
+    int64_t rank);
+
+} // namespace nvfuser
@@ -0,0 +1,209 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <host_ir/prefetch_allgathers.h>
+
+#include <algorithm>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <device_lower/utils.h>
+#include <ir/builder.h>
+#include <kernel_ir.h>
+#include <multidevice/communication.h>
+
+namespace nvfuser::hir {
+
+namespace {
+
+bool isCompute(Expr* expr) {
+  return expr->isA<PostOnStream>() || expr->isA<LaunchKernel>();
+}
+
+// Collectives must be posted in the same order on all the ranks of a team,
+// whose host programs may differ by their compute exprs. Allgathers are
+// therefore never hoisted over other communications, or scopes that may hold
+// some.
+bool isCommunicationBarrier(Expr* expr) {
+  return expr->isA<Communication>() || expr->isA<P2PCommunication>() ||
+      expr->isA<StartCoalescing>() || expr->isA<EndCoalescing>() ||
+      expr->isA<ForLoop>() || expr->isA<kir::IfThenElse>();
+}
+
+// Returns the number of bytes of a tensor, if known at compile time
+std::optional<int64_t> knownBytes(TensorView* tv) {
+  int64_t numel = 1;
+  for (IterDomain* id : TensorDomain::noReductions(tv->getLogicalDomain())) {
+    if (!id->extent()->isConstInt()) {
+      return std::nullopt;
+    }
+    numel *= id->extent()->evaluate().as<int64_t>();
+  }
+  return numel * (int64_t)dataTypeSize(tv->dtype());
+}
+
+bool uses(Expr* expr, TensorView* buffer) {
+  auto is_buffer = [buffer](Val* val) { return val == buffer; };
+  return std::any_of(expr->inputs().begin(), expr->inputs().end(), is_buffer) ||
+      std::any_of(expr->outputs().begin(), expr->outputs().end(), is_buffer);
+}
+
+// Inserts a Deallocate after the last top-level use of each buffer, unless an
+// expr of a nested scope, e.g., of a ForLoop, uses it
+std::vector<Expr*> deallocateAfterLastUse(
+    const std::vector<Expr*>& exprs,
+    const std::vector<TensorView*>& buffers) {
+  const std::unordered_set<Expr*> top_level_exprs(exprs.begin(), exprs.end());
+  std::vector<Expr*> nested_exprs;
+  for (Expr* expr : lower_utils::flattenScopedExprs(exprs)) {
+    if (top_level_exprs.count(expr) == 0) {
+      nested_exprs.push_back(expr);
+    }
+  }
+
+  std::unordered_map<Expr*, std::vector<TensorView*>> deallocations;
+  for (TensorView* buffer : buffers) {
+    if (std::any_of(nested_exprs.begin(), nested_exprs.end(), [&](Expr* e) {
+          return uses(e, buffer);
+        })) {
+      continue;
+    }
+    auto last_use = std::find_if(exprs.rbegin(), exprs.rend(), [&](Expr* e) {
+      return uses(e, buffer);
+    });
+    if (last_use != exprs.rend()) {
+      deallocations[*last_use].push_back(buffer);
+    }
+  }
+
+  std::vector<Expr*> new_exprs;
+  new_exprs.reserve(exprs.size() + buffers.size());
+  for (Expr* expr : exprs) {
+    new_exprs.push_back(expr);
+    auto it = deallocations.find(expr);
+    if (it == deallocations.end()) {
+      continue;
+    }
+    for (TensorView* buffer : it->second) {
+      new_exprs.push_back(IrBuilder::create<Deallocate>(buffer));
+    }
+  }
+  return new_exprs;
+}
+
+} // namespace
+
+void prefetchAllgathers(
+    HostIrContainer* hic,
+    int64_t max_distance,
+    int64_t memory_budget_bytes) {
+  FusionGuard fg(hic);
+  const std::vector<Expr*>& exprs = hic->topLevelExprs();
+  const std::unordered_set<Val*> inputs(
+      hic->inputs().begin(), hic->inputs().end());
+  const std::unordered_set<Val*> outputs(
+      hic->outputs().begin(), hic->outputs().end());
+
+  // Top-level indices of the compute exprs, the number of them before each
+  // top-level expr and the index of the last communication barrier before
+  // each top-level expr
+  std::vector<int64_t> compute_indices;
+  std::vector<int64_t> num_computes_before(exprs.size());
+  std::vector<int64_t> last_barrier_before(exprs.size());
+  int64_t last_barrier = -1;
+  for (size_t i = 0; i < exprs.size(); i++) {
+    num_computes_before.at(i) = (int64_t)compute_indices.size();
+    last_barrier_before.at(i) = last_barrier;
+    if (isCompute(exprs.at(i))) {
+      compute_indices.push_back((int64_t)i);
+    }
+    if (isCommunicationBarrier(exprs.at(i))) {
+      last_barrier = (int64_t)i;
+    }
+  }
+
+  // Bytes of the parameters prefetched over each compute expr, in order
+  std::vector<int64_t> prefetched_bytes(compute_indices.size(), 0);
+  // Exprs hoisted before each compute expr, in order
+  std::unordered_map<int64_t, std::vector<Expr*>> hoisted_exprs;
+  std::unordered_set<Expr*> hoisted;
+  std::vector<TensorView*> gathered;
+  auto* communication_stream = IrBuilder::create<Stream>();
+
+  for (size_t i = 1; i < exprs.size(); i++) {
+    auto* communication = dynamic_cast<Communication*>(exprs.at(i));
+    if (communication == nullptr ||
+        communication->type() != CommunicationType::Allgather ||
+        inputs.count(communication->in()) == 0) {
+      continue;
+    }
+    TensorView* out = communication->out();
+    if (outputs.count(out) == 0) {
+      gathered.push_back(out);
+    }
+    auto* allocate = dynamic_cast<kir::Allocate*>(exprs.at(i - 1));
+    std::optional<int64_t> bytes = knownBytes(out);
+    if (allocate == nullptr || allocate->buffer() != out ||
+        !bytes.has_value()) {
+      continue;
+    }
+
+    // Hoist over as many of the preceding compute exprs as the budget allows
+    const int64_t next_compute = num_computes_before.at(i);
+    int64_t distance = 0;
+    while (distance < std::min(max_distance, next_compute)) {
+      const int64_t compute = next_compute - distance - 1;
+      if (compute_indices.at(compute) < last_barrier_before.at(i) ||
+          prefetched_bytes.at(compute) + bytes.value() > memory_budget_bytes) {
+        break;
+      }
+      distance++;
+    }
+    if (distance == 0) {
+      continue;
+    }
+    for (int64_t compute = next_compute - distance; compute < next_compute;
+         compute++) {
+      prefetched_bytes.at(compute) += bytes.value();
+    }
+
+    // The buffer is allocated on the compute stream, so the communication
+    // stream waits for the kernels that may still use its memory
+    auto* get_current_stream = IrBuilder::create<GetCurrentStream>();
+    Stream* compute_stream = get_current_stream->stream();
+    auto& group = hoisted_exprs[next_compute - distance];
+    group.push_back(get_current_stream);
+    group.push_back(allocate);
+    group.push_back(IrBuilder::create<SetCurrentStream>(communication_stream));
+    group.push_back(IrBuilder::create<Synchronize>(compute_stream));
+    group.push_back(communication);
+    group.push_back(IrBuilder::create<SetCurrentStream>(compute_stream));
+    hoisted.insert(allocate);
+    hoisted.insert(communication);
+  }
+
+  std::vector<Expr*> new_exprs;
+  new_exprs.reserve(exprs.size());
+  for (size_t i = 0; i < exprs.size(); i++) {
+    Expr* expr = exprs.at(i);
+    if (isCompute(expr)) {
+      auto it = hoisted_exprs.find(num_computes_before.at(i));
+      if (it != hoisted_exprs.end()) {
+        new_exprs.insert(new_exprs.end(), it->second.begin(), it->second.end());
+      }
+    }
+    if (hoisted.count(expr) == 0) {
+      new_exprs.push_back(expr);
+    }
+  }
+
+  hic->resetTopLevelExprs(deallocateAfterLastUse(new_exprs, gathered));
+}
+
+} // namespace nvfuser::hir
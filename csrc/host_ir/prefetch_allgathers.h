@@ -0,0 +1,45 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <host_ir/container.h>
+
+#include <cstdint>
+
+namespace nvfuser::hir {
+
+// Posts the allgathers of parameters, i.e., of sharded global inputs, on a
+// communication stream up to max_distance compute exprs ahead of the exprs
+// consuming them, as in ZeRO-3. Compute exprs are PostOnStreams and
+// LaunchKernels. For example, with max_distance = 1,
+//
+//   PostOnStream(layer0),
+//   Allocate(w1), Communication(w1_shard, w1), Wait(Communication),
+//   PostOnStream(layer1, w1)
+//
+// becomes
+//
+//   GetCurrentStream(compute), Allocate(w1),
+//   SetCurrentStream(communication), Synchronize(compute),
+//   Communication(w1_shard, w1), SetCurrentStream(compute),
+//   PostOnStream(layer0), Wait(Communication),
+//   PostOnStream(layer1, w1), Deallocate(w1)
+//
+// so that the allgather of w1 overlaps layer0. At any point of the program,
+// the prefetched parameters take at most memory_budget_bytes more memory than
+// without prefetching. This needs the size of a gathered parameter to be
+// known at compile time, so the others aren't prefetched.
+//
+// Gathered parameters are deallocated after their last top-level use, unless
+// they are outputs of the program or used in nested scopes.
+void prefetchAllgathers(
+    HostIrContainer* hic,
+    int64_t max_distance,
+    int64_t memory_budget_bytes);
+
+} // namespace nvfuser::hir
@@ -878,9 +878,7 @@ ValGraph IdModel::buildIntersection(
 }
 
 // Replay Expr but with the inputs provided.
-Expr* IdModel::addReplayAs(std::vector<IterDomain*> new_inputs, Expr* expr) {
-  // Figure out which graphs are already initialized to make sure we add the new
-  // expression to them.
+std::vector<IdMappingMode> IdModel::initializedModes() const {
   std::vector<IdMappingMode> initialized_modes;
   for (auto mode : kIdMappingModes) {
     auto graph_it = id_graphs_.find(mode);
@@ -895,6 +893,13 @@ Expr* IdModel::addReplayAs(std::vector<IterDomain*> new_inputs, Expr* expr) {
 
     initialized_modes.push_back(mode);
   }
+  return initialized_modes;
+}
+
+Expr* IdModel::addReplayAs(std::vector<IterDomain*> new_inputs, Expr* expr) {
+  // Figure out which graphs are already initialized to make sure we add the new
+  // expression to them.
+  const std::vector<IdMappingMode> initialized_modes = initializedModes();
 
   // Replace the provided inputs with IterType::Iteration domains as
   // reduction domains cannot be merged with non-reduction domains.
@@ -948,38 +953,44 @@ Expr* IdModel::addReplayAs(std::vector<IterDomain*> new_inputs, Expr* expr) {
   auto replay = ReplayTransform::replayAs(new_inputs, expr);
   NVF_ERROR(replay != nullptr, "no replay found");
 
-  for (auto out_id : ir_utils::filterByType<IterDomain>(replay->outputs())) {
-    id_definitions_[out_id].pushBack(replay);
+  addExpr(replay);
+
+  return replay;
+}
+
+void IdModel::addExpr(Expr* expr) {
+  for (auto out_id : ir_utils::filterByType<IterDomain>(expr->outputs())) {
+    id_definitions_[out_id].pushBack(expr);
     // out_id is a new IterDomain with no use expr yet. Initialize its
     // use mapping with an empty set
     NVF_ERROR(id_uses_.emplace(out_id, VectorOfUniqueEntries<Expr*>{}).second);
   }
 
   // Add the expression to the uses of the inputs
-  for (auto inp_id : ir_utils::filterByType<IterDomain>(replay->inputs())) {
+  for (auto inp_id : ir_utils::filterByType<IterDomain>(expr->inputs())) {
     // inp_id should not be a new domain, so just make sure it has a
     // def mapping.
     NVF_ERROR(id_definitions_.find(inp_id) != id_definitions_.end());
-    id_uses_[inp_id].pushBack(replay);
+    id_uses_[inp_id].pushBack(expr);
   }
 
   // Initialize output iter domains in the graphs
-  for (auto mode : initialized_modes) {
+  for (auto mode : initializedModes()) {
     auto& graph = idGraph(mode);
 
-    // Initialize output ids in map. The replay expr will be
-    // registered as a definition by registerExpr
-    for (auto out_id : ir_utils::filterByType<IterDomain>(replay->outputs())) {
+    // Initialize output ids in map. The expr will be registered as a
+    // definition by registerExpr
+    for (auto out_id : ir_utils::filterByType<IterDomain>(expr->outputs())) {
       graph.initializeVal(out_id, {}, {});
     }
 
-    graph.registerExpr(replay);
+    graph.registerExpr(expr);
 
     // Propagate through all the uses of the iter domain groups of the inputs
     // with the new expression.
     // Gather all use expressions from inputs
     VectorOfUniqueEntries<Expr*> representative_uses;
-    for (IterDomain* inp : new_inputs) {
+    for (auto inp : ir_utils::filterByType<IterDomain>(expr->inputs())) {
       for (const ExprGroup& use_group : graph.getUses(graph.toGroup(inp))) {
         NVF_ERROR(!use_group->empty());
         representative_uses.pushBack(use_group->front());
@@ -987,11 +998,66 @@ Expr* IdModel::addReplayAs(std::vector<IterDomain*> new_inputs, Expr* expr) {
     }
 
     for (auto rep_use : representative_uses) {
-      graph.maybeMapThroughExprs(rep_use, replay, true);
+      graph.maybeMapThroughExprs(rep_use, expr, true);
+    }
+
+    // The almost exact graph additionally maps through trivial
+    // expressions, see buildAlmostExactGraph
+    if (mode == IdMappingMode::ALMOSTEXACT) {
+      for (const auto& mapped_id_group : getTriviallyMappedIds(expr)) {
+        for (auto id : mapped_id_group) {
+          graph.mapVals(mapped_id_group.front(), id);
+        }
+      }
     }
   }
+}
 
-  return replay;
+void IdModel::addTransformsOf(TensorView* tv) {
+  NVF_ERROR(
+      std::find(tvs_.begin(), tvs_.end(), tv) != tvs_.end(),
+      "Not a tensor of this IdModel: ",
+      tv->toString());
+
+  // Transforms the model doesn't know yet. An expression can only be
+  // added once all of its inputs are known.
+  std::vector<Expr*> new_exprs;
+  for (auto expr : tv->domain()->allExprs()) {
+    auto outputs = ir_utils::filterByType<IterDomain>(expr->outputs());
+    if (std::any_of(outputs.begin(), outputs.end(), [&](IterDomain* id) {
+          return id_definitions_.find(id) == id_definitions_.end();
+        })) {
+      new_exprs.push_back(expr);
+    }
+  }
+
+  if (new_exprs.empty()) {
+    return;
+  }
+
+  while (!new_exprs.empty()) {
+    auto ready_it =
+        std::find_if(new_exprs.begin(), new_exprs.end(), [&](Expr* expr) {
+          auto inputs = ir_utils::filterByType<IterDomain>(expr->inputs());
+          return std::all_of(inputs.begin(), inputs.end(), [&](IterDomain* id) {
+            return id_definitions_.find(id) != id_definitions_.end();
+          });
+        });
+    NVF_ERROR(
+        ready_it != new_exprs.end(),
+        "Transforms of ",
+        tv->toString(),
+        " are not connected to its known domains");
+    addExpr(*ready_it);
+    new_exprs.erase(ready_it);
+  }
+
+  // Broadcast forwarding and inlining are not incrementally
+  // maintained. Drop the graphs depending on them so that they are
+  // rebuilt by maybeBuildGraph when needed.
+  id_graphs_.erase(IdMappingMode::PERMISSIVE);
+  id_graphs_.erase(IdMappingMode::LOOP);
+  loop_promotion_map_.clear();
 }
 
 void IdModel::validateLoopGraphHasNoSelfMappedLeafDomains() const {
@@ -230,6 +230,20 @@ class IdModel : public PolymorphicBase {
   // replayed expression and adding potential mappings through the expression.
   Expr* addReplayAs(std::vector<IterDomain*> new_inputs, Expr* expr);
 
+  // Add an existing IterDomain expression whose inputs are already in
+  // this model, e.g., a split applied after the model was built. The
+  // initialized graphs are updated the same way as with addReplayAs.
+  void addExpr(Expr* expr);
+
+  // Incrementally update the model after tv was transformed by a
+  // scheduler, i.e., add the new expressions between its known domains
+  // and its current loop and allocation domains. EXACT, ALMOSTEXACT and
+  // BROADCAST graphs are updated in place. PERMISSIVE and LOOP graphs
+  // also depend on broadcast forwarding and inlining, so they are
+  // dropped and need to be rebuilt with maybeBuildGraph. New tensors
+  // still require building a new model.
+  void addTransformsOf(TensorView* tv);
+
   //! Run through disjoint sets in the LOOP graph, make sure there's only one
   //! non-serial parallel type in each disjoint set, set the parallel type of
   //! all IterDomains in the disjoint set to that PType.
@@ -281,6 +295,9 @@ class IdModel : public PolymorphicBase {
   std::unordered_map<ValGroup, IterDomain*> buildLoopPromotionMap(
       const StatefulInliningInfo& info);
 
+  // Graphs that are built and not empty
+  std::vector<IdMappingMode> initializedModes() const;
+
   // Errors if self mapping occurs
   void assertNoSelfMapping();
 
@@ -29,6 +29,7 @@
 
 #include <algorithm>
 #include <fstream>
+#include <limits>
 
 namespace nvfuser {
 
@@ -898,13 +899,25 @@ Val* TensorIndexer::getLinearIndex(
   const auto [contig_indices, contig_strides] =
       getContigIndexFor(expr, as_consumer, alloc_info, for_loops);
 
+  // With sub-tensor indexing, each index and stride of a global
+  // tensor fits in 32 bits, but their linearization may not, so it
+  // is done in 64 bits. See canUseSubTensorIndexing.
+  const bool widen = tv->getMemoryType() == MemoryType::Global &&
+      GpuLower::hasCurrent() && GpuLower::current()->subTensorIndexing();
+  auto maybe_widen = [&](Val* val) {
+    return widen ? SimplifyingIrBuilder::maybeCastExpr(DataType::Int, val)
+                 : val;
+  };
+
   // Linearize the indices with strides.
-  Val* linear_index = tv->fusion()->zeroVal();
+  Val* linear_index =
+      widen ? tv->fusion()->zeroVal(DataType::Int) : tv->fusion()->zeroVal();
   for (const auto i : c10::irange(contig_indices.size())) {
     Val* stride = contig_strides.at(i);
     linear_index = SimplifyingIrBuilder::addExpr(
         linear_index,
-        SimplifyingIrBuilder::mulExpr(contig_indices.at(i), stride));
+        SimplifyingIrBuilder::mulExpr(
+            maybe_widen(contig_indices.at(i)), maybe_widen(stride)));
   }
 
   // If a tensor is circular buffered, it also requires indexing of
@@ -912,8 +925,8 @@ Val* TensorIndexer::getLinearIndex(
   if (tv->isCircularBuffered()) {
     auto circular_buffer_offset =
         getOffsetForCircularBufferTensor(tv, as_consumer, for_loops);
-    linear_index =
-        SimplifyingIrBuilder::addExpr(linear_index, circular_buffer_offset);
+    linear_index = SimplifyingIrBuilder::addExpr(
+        linear_index, maybe_widen(circular_buffer_offset));
   }
 
   return linear_index;
@@ -1262,11 +1275,33 @@ ExprPath<ExprGroup> TensorIndexer::getIndexingPath(
     }
   }
 
-  return IndexingTraversal::getExprsBetween(
-      expr,
-      traversalGraph(),
-      getLoopIds(expr, id_model_),
-      non_broadcast_index_ids);
+  const std::vector<IterDomain*> loop_ids = getLoopIds(expr, id_model_);
+  if (IndexingTraversal::isPathSpecificToExpr(expr)) {
+    return IndexingTraversal::getExprsBetween(
+        expr, traversalGraph(), loop_ids, non_broadcast_index_ids);
+  }
+
+  // The graph isn't expected to change once indexing starts, but the
+  // cached paths would be stale if it did
+  const ValGraph& graph = traversalGraph();
+  if (graph.disjointValSets().size() != cached_num_val_groups_ ||
+      graph.disjointExprSets().size() != cached_num_expr_groups_) {
+    indexing_path_cache_.clear();
+    cached_num_val_groups_ = graph.disjointValSets().size();
+    cached_num_expr_groups_ = graph.disjointExprSets().size();
+  }
+
+  IndexingPathKey key{
+      graph.toGroups(loop_ids).vector(),
+      graph.toGroups(non_broadcast_index_ids).vector()};
+  if (auto it = indexing_path_cache_.find(key);
+      it != indexing_path_cache_.end()) {
+    return it->second;
+  }
+  auto path = IndexingTraversal::getExprsBetween(
+      expr, traversalGraph(), loop_ids, non_broadcast_index_ids);
+  indexing_path_cache_.emplace(std::move(key), path);
+  return path;
 }
 
 std::pair<std::vector<ValGroup>, std::vector<Val*>> TensorIndexer::
@@ -1360,4 +1395,57 @@ std::pair<std::vector<Val*>, std::vector<Val*>> TensorIndexer::
   return {result, contig_strides};
 }
 
+bool canUseSubTensorIndexing(Fusion* fusion, ExpressionEvaluator& expr_eval) {
+  constexpr int64_t max_int32 = std::numeric_limits<int32_t>::max();
+
+  auto fits_int32 = [&](Val* extent) {
+    PolymorphicValue value = expr_eval.evaluate(extent);
+    return value.hasValue() && value.is<int64_t>() &&
+        value.as<int64_t>() <= max_int32;
+  };
+
+  for (Expr* expr : fusion->exprs()) {
+    if (expr->isA<RNGOp>() || ir_utils::isCpAsyncBulk(expr)) {
+      return false;
+    }
+  }
+
+  for (TensorView* tv : fusion->allTvs()) {
+    if (tv->dtype() == DataType::Index) {
+      return false;
+    }
+
+    for (IterDomain* id : tv->domain()->allIDs()) {
+      if (!fits_int32(id->extent()) ||
+          (id->hasExpandedExtent() && !fits_int32(id->expandedExtent()))) {
+        return false;
+      }
+    }
+
+    if (tv->getMemoryType() != MemoryType::Global || tv->isFusionInput()) {
+      continue;
+    }
+
+    // The executor allocates the tensor contiguously, so the stride
+    // of the outermost allocated domain is the largest one
+    std::vector<IterDomain*> allocated_ids;
+    for (IterDomain* id : tv->getMaybeAllocationDomain()) {
+      if (!id->isReduction() && !id->isBroadcast()) {
+        allocated_ids.push_back(id);
+      }
+    }
+    int64_t max_stride = 1;
+    for (const auto i : c10::irange(1, allocated_ids.size())) {
+      // Each extent is at most max_int32, so this can't overflow
+      max_stride *= expr_eval.evaluate(allocated_ids.at(i)->extent())
+                        .as<int64_t>();
+      if (max_stride > max_int32) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
 } // namespace nvfuser
@@ -8,11 +8,13 @@
 #pragma once
 
 #include <device_lower/analysis/trivial_broadcast.h>
+#include <expr_evaluator.h>
 #include <id_model/id_model.h>
 #include <ir/base_nodes.h>
 #include <ir/interface_nodes.h>
 #include <options.h>
 #include <type.h>
+#include <utils.h>
 
 // Just for PredicateInfo. Should be moved to its own header file
 #include <index_compute.h>
@@ -31,6 +33,30 @@ struct IndexingInfo {
   std::unordered_map<ValGroup, ValGroups> loop_group_dependencies;
 };
 
+// Groups of the loop and the index domains of an indexing path
+struct IndexingPathKey {
+  std::vector<ValGroup> loop_groups;
+  std::vector<ValGroup> index_groups;
+
+  bool operator==(const IndexingPathKey& other) const {
+    return loop_groups == other.loop_groups &&
+        index_groups == other.index_groups;
+  }
+};
+
+struct IndexingPathKeyHash {
+  size_t operator()(const IndexingPathKey& key) const {
+    size_t hash = key.loop_groups.size();
+    for (const auto& group : key.loop_groups) {
+      hashCombine(hash, std::hash<ValGroup>()(group));
+    }
+    for (const auto& group : key.index_groups) {
+      hashCombine(hash, std::hash<ValGroup>()(group));
+    }
+    return hash;
+  }
+};
+
 struct IndexingAllocationInfo {
   std::vector<IterDomain*> domains;
   std::vector<Val*> strides;
@@ -203,6 +229,37 @@ class TensorIndexer {
   // Allocation info for each tensor. Must be filled before computing
   // the index of each tensor
   std::unordered_map<TensorView*, IndexingAllocationInfo> alloc_info_;
+
+  // Indexing paths that don't depend on the expr they were computed
+  // for. Many tensors of a kernel, and both the index and the
+  // predicates of a tensor, share the same path. See getIndexingPath.
+  mutable std::
+      unordered_map<IndexingPathKey, ExprPath<ExprGroup>, IndexingPathKeyHash>
+          indexing_path_cache_;
+  // Sizes of the traversal graph when indexing_path_cache_ was filled
+  mutable int64_t cached_num_val_groups_ = -1;
+  mutable int64_t cached_num_expr_groups_ = -1;
 };
 
+// Check if a fusion whose tensors require 64-bit indexing as a whole
+// can still be indexed with the 32-bit index type, widening only the
+// linearization of global memory tensors to 64 bits. That is the case
+// when, with the extents bound in expr_eval:
+//
+// - The extent of every domain fits in int32. The index of a domain is
+//   always smaller than its extent, so all loop indices and all the
+//   indices propagated from them fit as well. In other words, each
+//   tile a loop nest visits is addressed in 32 bits, only its base
+//   offset in the linearized tensor needs 64 bits.
+// - The strides of global memory tensors fit in int32. For the
+//   tensors allocated by the executor, the largest stride is the
+//   product of all but the outermost allocation extents. The
+//   strides of the fusion inputs need to be checked by the caller as
+//   they depend on the given tensors.
+// - No expression uses a flattened index other than the tensor
+//   offsets. RNG ops need the flattened index of a tensor and TMA has
+//   its own 32-bit indexing requirement, so they are rejected, as are
+//   tensors of DataType::Index.
+bool canUseSubTensorIndexing(Fusion* fusion, ExpressionEvaluator& expr_eval);
+
 } // namespace nvfuser
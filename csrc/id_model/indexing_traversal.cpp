@@ -66,6 +66,25 @@ IndexingTraversal::IndexingTraversal(
   }
 }
 
+bool IndexingTraversal::isPathSpecificToExpr(const Expr* expr) {
+  // Without any resize, the constructor only keeps the resize exprs of unique
+  // paths, which only depend on the graph, and getExprsBetweenForResize
+  // returns std::nullopt
+  auto is_resized = [](Val* val) {
+    auto tv = ir_utils::getTv(val);
+    if (tv == nullptr) {
+      return false;
+    }
+    const auto all_exprs = tv->domain()->allExprs();
+    return std::any_of(all_exprs.begin(), all_exprs.end(), [](Expr* expr) {
+      return expr->isA<Resize>();
+    });
+  };
+  return std::any_of(
+             expr->inputs().begin(), expr->inputs().end(), is_resized) ||
+      std::any_of(expr->outputs().begin(), expr->outputs().end(), is_resized);
+}
+
 std::optional<IndexingTraversal::ExprPath> IndexingTraversal::
     getExprsBetweenForResize(
         const Expr* expr,
@@ -42,6 +42,11 @@ class IndexingTraversal : public ValGraphBFS {
       const std::vector<IterDomain*>& from_domains,
       const std::vector<IterDomain*>& to_domains);
 
+  //! Whether the path found by getExprsBetween depends on expr and not only
+  //! on the groups it is given. That is only the case when the tensors of
+  //! expr are resized, so the paths of other exprs can be reused.
+  static bool isPathSpecificToExpr(const Expr* expr);
+
   using ValGraphBFS::isVisited;
 
   bool excludeFromTraversal(const NodeType& group) const override {
@@ -9,6 +9,9 @@
 #include <options.h>
 #include <utils.h>
 
+#include <algorithm>
+#include <iomanip>
+
 #ifdef _WIN32
 #include <c10/util/win32-headers.h>
 #else
@@ -19,6 +22,32 @@
 namespace nvfuser {
 namespace inst {
 
+namespace {
+
+unsigned int currentPid() {
+#ifdef _WIN32
+  return GetCurrentProcessId();
+#else
+  return getpid();
+#endif // _WIN32
+}
+
+unsigned int currentTid() {
+#ifdef _WIN32
+  return GetCurrentThreadId();
+#else
+  return std::hash<pthread_t>{}(pthread_self());
+#endif // _WIN32
+}
+
+// Device tracks use thread ids with the top bit set, which are unlikely to
+// collide with the hashes of the host threads
+unsigned int deviceTrackTid(int device, uint32_t stream) {
+  return 0x80000000u | ((unsigned int)device << 24) | (stream & 0xffffffu);
+}
+
+} // namespace
+
 Trace::Trace() {
   const char* trace_filename = getNvFuserEnv("TRACE");
   if (trace_filename != nullptr) {
@@ -52,18 +81,24 @@ Trace::~Trace() {
   }
 }
 
-void Trace::logEvent(char ph, const char* name, char sep) {
-  const std::chrono::duration<double> d = Clock::now() - start_timestamp_;
-  const double elapsed = d.count() * 1e6;
-
-#ifdef _WIN32
-  const unsigned int pid = GetCurrentProcessId();
-  const unsigned int tid = GetCurrentThreadId();
-#else
-  const unsigned int pid = getpid();
-  const unsigned int tid = std::hash<pthread_t>{}(pthread_self());
-#endif // _WIN32
+void Trace::logEvent(char ph, const char* name, char sep, int64_t segment_id) {
+  const double elapsed = elapsedUs(Clock::now());
+  const unsigned int pid = currentPid();
+  const unsigned int tid = currentTid();
 
+  if (segment_id >= 0) {
+    fprintf(
+        log_file_,
+        "{ \"name\": \"%s\", \"ph\": \"%c\", \"pid\": %u, \"tid\": %u, \"ts\": %.0f, \"args\": { \"segment\": %ld } }%c\n",
+        name,
+        ph,
+        pid,
+        tid,
+        elapsed,
+        (long)segment_id,
+        sep);
+    return;
+  }
   fprintf(
       log_file_,
       "{ \"name\": \"%s\", \"ph\": \"%c\", \"pid\": %u, \"tid\": %u, \"ts\": %.0f }%c\n",
@@ -75,5 +110,117 @@ void Trace::logEvent(char ph, const char* name, char sep) {
       sep);
 }
 
+void Trace::logCompleteEvent(
+    const std::string& name,
+    Clock::time_point start,
+    Clock::time_point end) {
+  if (log_file_ == nullptr) {
+    return;
+  }
+  const double ts = elapsedUs(start);
+  fprintf(
+      log_file_,
+      "{ \"name\": \"%s\", \"ph\": \"X\", \"pid\": %u, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f },\n",
+      name.c_str(),
+      currentPid(),
+      currentTid(),
+      ts,
+      elapsedUs(end) - ts);
+}
+
+void Trace::logDeviceEvent(
+    const std::string& name,
+    Clock::time_point start,
+    Clock::time_point end,
+    int device,
+    uint32_t stream,
+    int64_t fusion_id,
+    int64_t segment_id) {
+  if (log_file_ == nullptr) {
+    return;
+  }
+  const unsigned int pid = currentPid();
+  const unsigned int tid = deviceTrackTid(device, stream);
+  {
+    // Name the track of the stream the first time a kernel runs on it
+    std::lock_guard<std::mutex> lock(device_tracks_mutex_);
+    if (device_tracks_.insert(tid).second) {
+      fprintf(
+          log_file_,
+          "{ \"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %u, \"tid\": %u, \"args\": { \"name\": \"GPU %d stream %u\" } },\n",
+          pid,
+          tid,
+          device,
+          stream);
+    }
+  }
+  const double ts = elapsedUs(start);
+  fprintf(
+      log_file_,
+      "{ \"name\": \"%s\", \"ph\": \"X\", \"pid\": %u, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f, \"args\": { \"fusion\": %ld, \"segment\": %ld } },\n",
+      name.c_str(),
+      pid,
+      tid,
+      ts,
+      elapsedUs(end) - ts,
+      (long)fusion_id,
+      (long)segment_id);
+}
+
+void recordCompilePhase(
+    const std::string& name,
+    std::chrono::steady_clock::time_point start,
+    std::chrono::steady_clock::time_point end) {
+  if (CompilePhaseProfiler::enabled()) {
+    const std::chrono::duration<double, std::milli> d = end - start;
+    CompilePhaseProfiler::instance()->record(name, d.count());
+  }
+  Trace::instance()->logCompleteEvent(name, start, end);
+}
+
+bool CompilePhaseProfiler::enabled() {
+  return isProfilerEnabled() ||
+      isDebugDumpEnabled(DebugDumpOption::CompileTimes);
+}
+
+void CompilePhaseProfiler::record(const std::string& name, double time_ms) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto [it, inserted] = phase_index_.emplace(name, phases_.size());
+  if (inserted) {
+    phases_.push_back(CompilePhase{name});
+  }
+  CompilePhase& phase = phases_.at(it->second);
+  ++phase.count;
+  phase.time_ms += time_ms;
+}
+
+std::vector<CompilePhase> CompilePhaseProfiler::phases() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return phases_;
+}
+
+void CompilePhaseProfiler::reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  phases_.clear();
+  phase_index_.clear();
+}
+
+void CompilePhaseProfiler::print(std::ostream& os) const {
+  const auto recorded_phases = phases();
+  size_t name_width = 5;
+  for (const auto& phase : recorded_phases) {
+    name_width = std::max(name_width, phase.name.size());
+  }
+  os << std::left << std::setw((int)name_width) << "Phase" << " "
+     << std::right << std::setw(7) << "Count" << " " << std::setw(12)
+     << "Time(ms)" << std::endl;
+  for (const auto& phase : recorded_phases) {
+    os << std::left << std::setw((int)name_width) << phase.name << " "
+       << std::right << std::setw(7) << phase.count << " " << std::setw(12)
+       << std::fixed << std::setprecision(3) << phase.time_ms << std::endl;
+  }
+  os << std::defaultfloat;
+}
+
 } // namespace inst
 } // namespace nvfuser
@@ -16,6 +16,12 @@
 #include <stdio.h>
 #include <chrono>
 #include <cstdio>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace nvfuser {
 namespace inst {
@@ -34,7 +40,13 @@ namespace inst {
 //! https://chromium.googlesource.com/catapult/+/HEAD/tracing/README.md
 //!
 //! An easy way to view traces is to type `about://tracing` in Chrome or
-//! Chromium.
+//! Chromium, or to open them in https://ui.perfetto.dev.
+//!
+//! Besides the perf scopes, the trace has a span for each compilation phase
+//! recorded by CompilePhaseProfiler on the thread that compiled it. When the
+//! FusionProfiler runs with CUPTI, the kernels of the profiled fusions are
+//! added as device spans on a track per device and stream. Host and device
+//! spans of the same segment both have its id in their "segment" argument.
 //!
 class Trace : public NonCopyable {
  public:
@@ -55,6 +67,17 @@ class Trace : public NonCopyable {
     }
   }
 
+  //! Same as beginEvent(name), with the id of the segment the event
+  //! belongs to
+  void beginEvent(const char* name, int64_t segment_id) {
+    if (log_file_ != nullptr) {
+      logEvent('B', name, ',', segment_id);
+    }
+    if (record_nvtx_range_) {
+      nvtxRangePushA(name);
+    }
+  }
+
   void endEvent(const char* name) {
     if (record_nvtx_range_) {
       nvtxRangePop();
@@ -64,16 +87,50 @@ class Trace : public NonCopyable {
     }
   }
 
+  bool enabled() const {
+    return log_file_ != nullptr;
+  }
+
+  //! Logs a host span that has already ended on the calling thread
+  NVF_API void logCompleteEvent(
+      const std::string& name,
+      Clock::time_point start,
+      Clock::time_point end);
+
+  //! Logs a kernel span that ran on a device. start and end are device
+  //! timestamps converted to the host clock.
+  NVF_API void logDeviceEvent(
+      const std::string& name,
+      Clock::time_point start,
+      Clock::time_point end,
+      int device,
+      uint32_t stream,
+      int64_t fusion_id,
+      int64_t segment_id);
+
  private:
   NVF_API Trace();
   NVF_API ~Trace();
 
-  NVF_API void logEvent(char ph, const char* name, char sep = ',');
+  NVF_API void logEvent(
+      char ph,
+      const char* name,
+      char sep = ',',
+      int64_t segment_id = -1);
+
+  double elapsedUs(Clock::time_point t) const {
+    const std::chrono::duration<double> d = t - start_timestamp_;
+    return d.count() * 1e6;
+  }
 
  private:
   FILE* log_file_ = nullptr;
   Clock::time_point start_timestamp_;
   bool record_nvtx_range_ = true;
+
+  //! Device tracks that have been named in the trace
+  std::mutex device_tracks_mutex_;
+  std::unordered_set<uint64_t> device_tracks_;
 };
 
 //! \internal Automatic scope for a perf marker
@@ -84,6 +141,11 @@ class TraceScope : public NonCopyable {
     Trace::instance()->beginEvent(event_name_);
   }
 
+  TraceScope(const char* event_name, int64_t segment_id)
+      : event_name_(event_name) {
+    Trace::instance()->beginEvent(event_name_, segment_id);
+  }
+
   ~TraceScope() {
     Trace::instance()->endEvent(event_name_);
   }
@@ -103,5 +165,129 @@ class TraceScope : public NonCopyable {
 #define FUSER_PERF_SCOPE(name) \
   nvfuser::inst::TraceScope FUSER_ANONYMOUS(_perf_scope_)(name)
 
+//! Same as FUSER_PERF_SCOPE for the work of one segment of a fusion
+//!
+//! \param name The name of the scope, normally a simple string literal
+//! \param segment_id The id of the segment, recorded in the trace
+//!
+#define FUSER_PERF_SEGMENT_SCOPE(name, segment_id) \
+  nvfuser::inst::TraceScope FUSER_ANONYMOUS(_perf_scope_)(name, segment_id)
+
+//! Accumulated host time of one phase of compilation
+struct CompilePhase {
+  std::string name;
+  int64_t count = 0;
+  double time_ms = 0.0;
+};
+
+//! Breakdown of the host time spent compiling fusions into phases: each
+//! pre-segmentation pass, the segmenter, the heuristics and scheduling of
+//! each scheduler, each lowering pass, codegen, NVRTC and module loading.
+//! Phases are marked with FUSER_COMPILE_PHASE_SCOPE or CompilePhaseLaps and
+//! may be recorded from parallel compilation threads. An enclosing phase
+//! includes the time of the phases nested in it.
+//!
+//! Recording is enabled while the FusionProfiler is enabled or when
+//! `NVFUSER_DUMP=compile_times` is set.
+class CompilePhaseProfiler : public NonCopyable {
+ public:
+  NVF_API static CompilePhaseProfiler* instance() {
+    static CompilePhaseProfiler profiler;
+    return &profiler;
+  }
+
+  NVF_API static bool enabled();
+
+  NVF_API void record(const std::string& name, double time_ms);
+
+  //! Phases recorded since the last reset, in the order they were first
+  //! recorded
+  NVF_API std::vector<CompilePhase> phases() const;
+
+  NVF_API void reset();
+
+  //! Print the phases recorded since the last reset as a table
+  NVF_API void print(std::ostream& os) const;
+
+ private:
+  CompilePhaseProfiler() = default;
+
+ private:
+  mutable std::mutex mutex_;
+  std::vector<CompilePhase> phases_;
+  std::unordered_map<std::string, size_t> phase_index_;
+};
+
+//! \internal Records a compilation phase with CompilePhaseProfiler and in
+//!   the trace, whichever is enabled
+NVF_API void recordCompilePhase(
+    const std::string& name,
+    std::chrono::steady_clock::time_point start,
+    std::chrono::steady_clock::time_point end);
+
+//! \internal Automatic scope for a compilation phase
+//!   (normally used through the FUSER_COMPILE_PHASE_SCOPE macro). The name
+//!   is only built when recording is enabled.
+class CompilePhaseScope : public NonCopyable {
+ public:
+  template <typename NameFn>
+  explicit CompilePhaseScope(NameFn name_fn) {
+    if (CompilePhaseProfiler::enabled() || Trace::instance()->enabled()) {
+      enabled_ = true;
+      name_ = name_fn();
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~CompilePhaseScope() {
+    if (enabled_) {
+      recordCompilePhase(name_, start_, std::chrono::steady_clock::now());
+    }
+  }
+
+ private:
+  bool enabled_ = false;
+  std::string name_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+//! Times a sequence of phases that run back to back, such as the passes of
+//! GpuLower, without a scope for each of them. Each call to lap records the
+//! time since the previous call, or since construction.
+class CompilePhaseLaps : public NonCopyable {
+ public:
+  explicit CompilePhaseLaps(std::string prefix)
+      : enabled_(
+            CompilePhaseProfiler::enabled() || Trace::instance()->enabled()),
+        prefix_(std::move(prefix)) {
+    if (enabled_) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  void lap(const std::string& name) {
+    if (!enabled_) {
+      return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    recordCompilePhase(prefix_ + name, start_, now);
+    start_ = now;
+  }
+
+ private:
+  bool enabled_ = false;
+  std::string prefix_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+//! Defines a compilation phase recorded by CompilePhaseProfiler
+//!
+//! \param name An expression evaluating to the name of the phase. It is only
+//!   evaluated when recording is enabled.
+//!
+#define FUSER_COMPILE_PHASE_SCOPE(name)                                  \
+  nvfuser::inst::CompilePhaseScope FUSER_ANONYMOUS(_compile_phase_scope_)( \
+      [&]() { return std::string(name); })
+
 } // namespace inst
 } // namespace nvfuser
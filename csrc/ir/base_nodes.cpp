@@ -13,6 +13,7 @@
 #include <ir/builder.h>
 #include <ir/cloner.h>
 #include <ir/printer.h>
+#include <ir/statement_arena.h>
 #include <ir/utils.h>
 #include <kernel.h>
 #include <kernel_ir.h>
@@ -36,6 +37,18 @@ Statement::Statement(const Statement* src, IrCloner* ir_cloner)
 
 NVFUSER_DEFINE_CLONE(Statement)
 
+void* Statement::operator new(size_t size, StatementArena& arena) {
+  return arena.allocate(size);
+}
+
+void Statement::operator delete(void* ptr, StatementArena&) noexcept {
+  StatementArena::deallocate(ptr);
+}
+
+void Statement::operator delete(void* ptr) noexcept {
+  StatementArena::deallocate(ptr);
+}
+
 void Statement::setName(IrContainerPasskey, StmtNameType name) {
   name_ = name;
 }
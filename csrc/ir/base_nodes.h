@@ -62,6 +62,7 @@ class IrContainer;
 class IrBuilderPasskey;
 class IrContainerPasskey;
 class ExpressionEvaluator;
+class StatementArena;
 
 namespace kir {
 class Kernel;
@@ -103,6 +104,12 @@ class NVF_API Statement : public NonCopyable, public PolymorphicBase {
   // Cloning constructor
   Statement(const Statement* src, IrCloner* ir_cloner);
 
+  // Statements are allocated in the StatementArena of their container by
+  // IrBuilder, so there is no operator new without an arena
+  static void* operator new(size_t size, StatementArena& arena);
+  static void operator delete(void* ptr, StatementArena& arena) noexcept;
+  static void operator delete(void* ptr) noexcept;
+
   // Dispatch functions, definitions in dispatch.cpp
   template <typename T>
   static void dispatch(T handler, Statement*);
@@ -43,7 +43,8 @@ class IrBuilder {
   template <class T, class... Args>
   static T* createInContainer(IrContainer* container, Args&&... args) {
     NVF_ERROR(container != nullptr, "Need an active container to build IR.");
-    T* node = new T(IrBuilderPasskey(container), std::forward<Args>(args)...);
+    T* node = new (container->arena())
+        T(IrBuilderPasskey(container), std::forward<Args>(args)...);
 
     container->registerStmt(IrBuilderPasskey(container), node);
 
@@ -120,6 +120,11 @@ class IrCloner {
     return ir_container_;
   }
 
+  //! Reserves space for the clones of num_stmts Statements
+  void reserve(size_t num_stmts) {
+    clones_map_.reserve(num_stmts);
+  }
+
  protected:
   NVF_API void registerClone(const Statement* src, Statement* clone);
   virtual Statement* handle(const Statement* s);
@@ -164,7 +169,7 @@ T* IrBuilder::clone(const T* src, IrCloner* ir_cloner) {
       ir_cloner->container() != nullptr,
       "Cloner doesn't have a valid container to store cloned object.");
 
-  T* dest = new T(src, ir_cloner);
+  T* dest = new (ir_cloner->container()->arena()) T(src, ir_cloner);
   const Statement* src_stmt = dynamic_cast<const Statement*>(src);
   Statement* dest_stmt = dynamic_cast<Statement*>(dest);
 
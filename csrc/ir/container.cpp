@@ -12,22 +12,65 @@
 #include <ir/container.h>
 #include <ir/internal_nodes.h>
 
+#include <c10/util/irange.h>
+
+#include <algorithm>
+
 namespace nvfuser {
 
+namespace {
+
+// Removed Statements leave null entries behind. They are dropped once they
+// are the majority of a large vector, which keeps removal amortized constant
+// time and iteration linear in the number of live Statements.
+template <typename T>
+void maybeCompact(
+    std::vector<std::unique_ptr<T>>& stmts,
+    int64_t& num_removed) {
+  constexpr int64_t kMinRemovedToCompact = 1024;
+  if (num_removed < kMinRemovedToCompact ||
+      num_removed * 2 < (int64_t)stmts.size()) {
+    return;
+  }
+  stmts.erase(std::remove(stmts.begin(), stmts.end(), nullptr), stmts.end());
+  for (auto i : c10::irange(stmts.size())) {
+    StatementArena::setIndex(stmts[i].get(), (int64_t)i);
+  }
+  num_removed = 0;
+}
+
+void retainArena(
+    std::vector<std::shared_ptr<StatementArena>>& retained_arenas,
+    const std::shared_ptr<StatementArena>& arena) {
+  if (std::find(retained_arenas.begin(), retained_arenas.end(), arena) ==
+      retained_arenas.end()) {
+    retained_arenas.push_back(arena);
+  }
+}
+
+} // namespace
+
 void swap(IrContainer& a, IrContainer& b) noexcept {
   FUSER_PERF_SCOPE("Fusion swap");
 
   using std::swap;
 
   // Swap the content
+  swap(a.arena_, b.arena_);
+  swap(a.retained_arenas_, b.retained_arenas_);
+  // The shortcut vals are not swapped, so each container keeps the arena they
+  // were allocated from
+  retainArena(a.retained_arenas_, b.arena_);
+  retainArena(b.retained_arenas_, a.arena_);
+
   swap(a.vals_up_, b.vals_up_);
+  swap(a.num_removed_vals_, b.num_removed_vals_);
   swap(a.vals_, b.vals_);
 
   swap(a.exprs_up_, b.exprs_up_);
+  swap(a.num_removed_exprs_, b.num_removed_exprs_);
   swap(a.exprs_, b.exprs_);
 
-  swap(a.raw_ptrs_, b.raw_ptrs_);
-
   swap(a.val_type_name_map_, b.val_type_name_map_);
   swap(a.expr_name_counter_, b.expr_name_counter_);
 
@@ -43,10 +86,10 @@ void swap(IrContainer& a, IrContainer& b) noexcept {
 
   // Fixup the Statement::fusion_ links for b
   for (auto val : b.vals_) {
-    val->ir_container_ = &a;
+    val->ir_container_ = &b;
   }
   for (auto expr : b.exprs_) {
-    expr->ir_container_ = &a;
+    expr->ir_container_ = &b;
   }
 }
 
@@ -54,19 +97,24 @@ IrCloner IrContainer::copy(const IrContainer* from, IrContainer* to) {
   to->clear();
   IrCloner ir_cloner(to);
 
-  // Copy values in deterministic order
-  // deterministic_vals can contain special values like one_val_, zero_val_, etc
-  // that are not registered in the container.
-  for (auto val : from->deterministic_vals()) {
-    if (from->vals().count(val) > 0) {
-      to->vals_.insert(ir_cloner.clone(val));
+  // Clones are registered with `to` in a single pass over the dense vectors,
+  // in deterministic order. Every live entry of vals_up_ and exprs_up_ is
+  // registered, unlike the shortcut vals, which are cloned on use.
+  const size_t num_vals = from->vals_up_.size() - from->num_removed_vals_;
+  const size_t num_exprs = from->exprs_up_.size() - from->num_removed_exprs_;
+  ir_cloner.reserve(num_vals + num_exprs);
+  to->vals_up_.reserve(num_vals);
+  to->vals_.reserve(num_vals);
+  to->exprs_up_.reserve(num_exprs);
+  to->exprs_.reserve(num_exprs);
+  for (const auto& val_up : from->vals_up_) {
+    if (val_up != nullptr) {
+      ir_cloner.clone(val_up.get());
     }
   }
-
-  // Copy expressions in deterministic order
-  for (auto expr : from->deterministic_exprs()) {
-    if (from->unordered_exprs().count(expr) > 0) {
-      to->exprs_.insert(ir_cloner.clone(expr));
+  for (const auto& expr_up : from->exprs_up_) {
+    if (expr_up != nullptr) {
+      ir_cloner.clone(expr_up.get());
     }
   }
 
@@ -139,18 +187,16 @@ void IrContainer::removeExpr(Expr* expr) {
   NVF_ERROR(
       exprs_.find(expr) != exprs_.end(),
       "Wanted to remove an expression but it doesn't exist in this container.");
-  auto expr_in_deque = std::find_if(
-      exprs_up_.begin(),
-      exprs_up_.end(),
-      [expr](std::unique_ptr<Expr>& expr_up) { return expr_up.get() == expr; });
-
+  const int64_t index = StatementArena::index(expr);
   NVF_ERROR(
-      expr_in_deque != exprs_up_.end(),
+      index >= 0 && index < (int64_t)exprs_up_.size() &&
+          exprs_up_[index].get() == expr,
       "Wanted to remove an expression but its unique ptr is missing.");
 
   exprs_.erase(expr);
-  exprs_up_.erase(expr_in_deque);
-  raw_ptrs_.erase((void*)expr);
+  exprs_up_[index].reset();
+  ++num_removed_exprs_;
+  maybeCompact(exprs_up_, num_removed_exprs_);
 }
 
 //! Completely remove val from the fusion, break all dependencies associated
@@ -166,18 +212,16 @@ void IrContainer::removeVal(Val* val) {
   NVF_ERROR(
       vals_.find(val) != vals_.end(),
       "Wanted to remove a value but it doesn't exist in this container.");
-  auto val_in_deque = std::find_if(
-      vals_up_.begin(), vals_up_.end(), [val](std::unique_ptr<Val>& val_up) {
-        return val_up.get() == val;
-      });
-
+  const int64_t index = StatementArena::index(val);
   NVF_ERROR(
-      val_in_deque != vals_up_.end(),
+      index >= 0 && index < (int64_t)vals_up_.size() &&
+          vals_up_[index].get() == val,
       "Wanted to remove a value but its unique ptr is missing.");
 
   vals_.erase(val);
-  vals_up_.erase(val_in_deque);
-  raw_ptrs_.erase((void*)val);
+  vals_up_[index].reset();
+  ++num_removed_vals_;
+  maybeCompact(vals_up_, num_removed_vals_);
 }
 
 //! Register the Val with this container
@@ -186,10 +230,14 @@ void IrContainer::registerVal(Val* val) {
     return;
   }
 
+  NVF_ERROR(
+      ownsMemory(val),
+      "Vals must be allocated in the arena of the container they are "
+      "registered with.");
+  StatementArena::setRegistered(val, (int64_t)vals_up_.size());
   vals_up_.emplace_back(std::unique_ptr<Val>(val));
-  vals_.emplace(vals_up_.back().get());
-  val->setName(IrContainerPasskey(), getValName(vals_up_.back()->vtype()));
-  raw_ptrs_.emplace((void*)vals_up_.back().get());
+  vals_.emplace(val);
+  val->setName(IrContainerPasskey(), getValName(val->vtype()));
 }
 
 //! Register expr with this container.
@@ -197,49 +245,56 @@ void IrContainer::registerExpr(Expr* expr) {
   if (inContainer(expr)) {
     return;
   }
+  NVF_ERROR(
+      ownsMemory(expr),
+      "Exprs must be allocated in the arena of the container they are "
+      "registered with.");
+  StatementArena::setRegistered(expr, (int64_t)exprs_up_.size());
   exprs_up_.emplace_back(std::unique_ptr<Expr>(expr));
-  exprs_.emplace(exprs_up_.back().get());
+  exprs_.emplace(expr);
   expr->setName(IrContainerPasskey(), getExprName());
-  raw_ptrs_.emplace((void*)exprs_up_.back().get());
 }
 
 void IrContainer::clear() noexcept {
   FUSER_PERF_SCOPE("IrContainer clear");
   vals_.clear();
   vals_up_.clear();
+  num_removed_vals_ = 0;
   exprs_.clear();
   exprs_up_.clear();
-  raw_ptrs_.clear();
+  num_removed_exprs_ = 0;
   axioms_.reset();
   val_type_name_map_.clear();
   metadata_.clear();
   expr_name_counter_ = 0;
 }
 
-bool IrContainer::inContainer(const Statement* stmt) const {
-  const void* const_void = (const void*)(stmt);
-  void* nonconst_void = const_cast<void*>(const_void); // NOLINT
-  if (raw_ptrs_.find(nonconst_void) == raw_ptrs_.end()) {
-    return false;
+bool IrContainer::ownsMemory(const Statement* stmt) const {
+  if (arena_->contains(stmt)) {
+    return true;
   }
+  return std::any_of(
+      retained_arenas_.begin(),
+      retained_arenas_.end(),
+      [stmt](const auto& arena) { return arena->contains(stmt); });
+}
 
-  NVF_ERROR(
-      stmt->container() == this,
-      "Container claims to own stmt, but stmt disagrees.");
-
-  Statement* nonconst_stmt = const_cast<Statement*>(stmt); // NOLINT
-  if (stmt->isExpr()) {
-    NVF_ERROR(
-        exprs_.find(nonconst_stmt->as<Expr>()) != exprs_.end(),
-        "Somehow container claims to and not to own an Expr.");
-  }
-  if (stmt->isVal()) {
-    NVF_ERROR(
-        vals_.find(nonconst_stmt->as<Val>()) != vals_.end(),
-        "Somehow container claims to and not to own an Val.");
+// stmt may be a dangling pointer to a Statement of another container, so it
+// is only dereferenced once it is known to point into the memory of this
+// container, which stays allocated until the container is destroyed.
+bool IrContainer::inContainer(const Statement* stmt) const {
+  if (!ownsMemory(stmt) || !StatementArena::isRegistered(stmt)) {
+    return false;
   }
+  return stmt->container() == this;
+}
 
-  return true;
+Val* IrContainer::releaseLastVal() {
+  Val* val = vals_up_.back().release();
+  vals_up_.pop_back();
+  // The val stays registered, but it is no longer in vals_up_
+  StatementArena::setIndex(val, -1);
+  return val;
 }
 
 // Shortcuts for frequently used vals
@@ -248,8 +303,7 @@ Val* IrContainer::zeroVal() {
     auto zero_val =
         IrBuilder::createInContainer<Val>(this, 0L, DataType::Index);
     NVF_ERROR(vals_up_.back().get() == zero_val);
-    zero_val_ = std::unique_ptr<Val>(vals_up_.back().release());
-    vals_up_.pop_back();
+    zero_val_ = std::unique_ptr<Val>(releaseLastVal());
   }
   return zero_val_.get();
 }
@@ -269,8 +323,7 @@ Val* IrContainer::oneVal() {
   if (!one_val_) {
     auto one_val = IrBuilder::createInContainer<Val>(this, 1L, DataType::Index);
     NVF_ERROR(vals_up_.back().get() == one_val);
-    one_val_ = std::unique_ptr<Val>(vals_up_.back().release());
-    vals_up_.pop_back();
+    one_val_ = std::unique_ptr<Val>(releaseLastVal());
   }
   return one_val_.get();
 }
@@ -291,8 +344,7 @@ Val* IrContainer::falseVal() {
     auto false_val =
         IrBuilder::createInContainer<Val>(this, false, DataType::Bool);
     NVF_ERROR(vals_up_.back().get() == false_val);
-    false_val_ = std::unique_ptr<Val>(vals_up_.back().release());
-    vals_up_.pop_back();
+    false_val_ = std::unique_ptr<Val>(releaseLastVal());
   }
   return false_val_.get();
 }
@@ -302,8 +354,7 @@ Val* IrContainer::trueVal() {
     auto true_val =
         IrBuilder::createInContainer<Val>(this, true, DataType::Bool);
     NVF_ERROR(vals_up_.back().get() == true_val);
-    true_val_ = std::unique_ptr<Val>(vals_up_.back().release());
-    vals_up_.pop_back();
+    true_val_ = std::unique_ptr<Val>(releaseLastVal());
   }
   return true_val_.get();
 }
@@ -313,9 +364,8 @@ NamedScalar* IrContainer::magicZeroVal() {
     auto magic_zero =
         IrBuilder::create<NamedScalar>(kMagicZeroName, DataType::Index);
     NVF_ERROR(vals_up_.back().get() == magic_zero);
-    magic_zero_val_ = std::unique_ptr<NamedScalar>(
-        vals_up_.back().release()->as<NamedScalar>());
-    vals_up_.pop_back();
+    magic_zero_val_ =
+        std::unique_ptr<NamedScalar>(releaseLastVal()->as<NamedScalar>());
   }
   return magic_zero_val_.get();
 }
@@ -11,11 +11,14 @@
 #include <visibility.h>
 
 #include <ir/base_nodes.h>
+#include <ir/statement_arena.h>
 #include <utils.h>
 
 #include <deque>
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace nvfuser {
 
@@ -55,22 +58,22 @@ class IrContainer : public PolymorphicBase {
   //! Return values in insertion order
   const std::deque<Val*> deterministic_vals() const noexcept {
     std::deque<Val*> vals_deque;
-    std::transform(
-        vals_up_.begin(),
-        vals_up_.end(),
-        std::back_inserter(vals_deque),
-        [](const std::unique_ptr<Val>& val_up) { return val_up.get(); });
+    for (const auto& val_up : vals_up_) {
+      if (val_up != nullptr) {
+        vals_deque.push_back(val_up.get());
+      }
+    }
     return vals_deque;
   }
 
   //! Return expression in insertion order
   const std::deque<Expr*> deterministic_exprs() const noexcept {
     std::deque<Expr*> exprs_deque;
-    std::transform(
-        exprs_up_.begin(),
-        exprs_up_.end(),
-        std::back_inserter(exprs_deque),
-        [](const std::unique_ptr<Expr>& expr_up) { return expr_up.get(); });
+    for (const auto& expr_up : exprs_up_) {
+      if (expr_up != nullptr) {
+        exprs_deque.push_back(expr_up.get());
+      }
+    }
     return exprs_deque;
   }
 
@@ -78,14 +81,13 @@ class IrContainer : public PolymorphicBase {
   const std::unordered_map<Val*, int64_t> deterministic_vals_map()
       const noexcept {
     std::unordered_map<Val*, int64_t> vals_map;
+    vals_map.reserve(vals_.size());
     int64_t count = 0;
-    std::transform(
-        vals_up_.begin(),
-        vals_up_.end(),
-        std::inserter(vals_map, vals_map.end()),
-        [&count](const std::unique_ptr<Val>& val_up) {
-          return std::make_pair(val_up.get(), count++);
-        });
+    for (const auto& val_up : vals_up_) {
+      if (val_up != nullptr) {
+        vals_map.emplace(val_up.get(), count++);
+      }
+    }
     return vals_map;
   }
 
@@ -93,14 +95,13 @@ class IrContainer : public PolymorphicBase {
   const std::unordered_map<Expr*, int64_t> deterministic_exprs_map()
       const noexcept {
     std::unordered_map<Expr*, int64_t> exprs_map;
+    exprs_map.reserve(exprs_.size());
     int64_t count = 0;
-    std::transform(
-        exprs_up_.begin(),
-        exprs_up_.end(),
-        std::inserter(exprs_map, exprs_map.end()),
-        [&count](const std::unique_ptr<Expr>& expr_up) {
-          return std::make_pair(expr_up.get(), count++);
-        });
+    for (const auto& expr_up : exprs_up_) {
+      if (expr_up != nullptr) {
+        exprs_map.emplace(expr_up.get(), count++);
+      }
+    }
     return exprs_map;
   }
 
@@ -144,6 +145,11 @@ class IrContainer : public PolymorphicBase {
   void assumePositive(Val* val);
   void assumeNonNegative(Val* val);
 
+  //! Memory of the Statements of this container, see IrBuilder
+  StatementArena& arena() {
+    return *arena_;
+  }
+
  protected:
   static IrCloner copy(const IrContainer* from, IrContainer* to);
 
@@ -179,27 +185,42 @@ class IrContainer : public PolymorphicBase {
 
   void lazyInitAxioms();
 
-  // Deque of unique pointer is the memory owning data structure
-  std::deque<std::unique_ptr<Val>> vals_up_;
+  //! Whether stmt points into the memory of this container. stmt is not
+  //! dereferenced.
+  bool ownsMemory(const Statement* stmt) const;
+
+  //! Releases the last registered Val from vals_up_, keeping it registered,
+  //! to make it a shortcut val
+  Val* releaseLastVal();
+
+  // Arena holding the memory of the Statements. It is declared before every
+  // owner of Statements so that it is destroyed after them.
+  std::shared_ptr<StatementArena> arena_ = std::make_shared<StatementArena>();
+
+  // Arenas of other containers holding Statements of this one. Swapping
+  // containers only swaps the registered Statements, so the shortcut vals
+  // stay in the arena they were allocated from.
+  std::vector<std::shared_ptr<StatementArena>> retained_arenas_;
+
+  // Dense vector of unique pointers is the memory owning data structure. The
+  // index of a Val is stored in its arena header, so it is removed in
+  // constant time, leaving a null entry until the vector is compacted.
+  std::vector<std::unique_ptr<Val>> vals_up_;
+  int64_t num_removed_vals_ = 0;
 
   // A convenient set to return when we just need an unordered set to do
   // something like check if a Val is in this container
   std::unordered_set<Val*> vals_;
 
-  // Deque of unique pointer is the memory owning data structure
-  std::deque<std::unique_ptr<Expr>> exprs_up_;
+  // Dense vector of unique pointers is the memory owning data structure, see
+  // vals_up_
+  std::vector<std::unique_ptr<Expr>> exprs_up_;
+  int64_t num_removed_exprs_ = 0;
 
   // A convenient set to return when we just need an unordered set to do
   // something like check if an Expr is in this container
   std::unordered_set<Expr*> exprs_;
 
-  // Used to implement a generic "inContainer" that can be passed an invalid
-  // pointer. Specifically a pointer to a Statement owned by another container
-  // that has been freed. We can't check normally with the unordered_sets we
-  // already have because it would require a const_cast from a constant
-  // expr/val, or a dynamic cast from a Statement.
-  std::unordered_set<void*> raw_ptrs_;
-
   // Values names counters
   std::unordered_map<ValType, StmtNameType> val_type_name_map_;
 
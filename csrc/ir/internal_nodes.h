@@ -940,6 +940,160 @@ class NVF_API ReductionOp : public Expr {
   }
 };
 
+//! Inclusive scan along dim, e.g. a cumulative sum. out[..., i, ...] is
+//! reductionOp(out[..., i-1, ...], in[..., i, ...]) and out[..., 0, ...] is
+//! reductionOp(init, in[..., 0, ...]). Unlike ReductionOp, the output keeps the
+//! scanned axis as an iteration domain. There is no codegen support yet, so
+//! the op is expression evaluated.
+class NVF_API ScanOp : public Expr {
+ public:
+  using Expr::Expr;
+
+  ScanOp(
+      IrBuilderPasskey,
+      BinaryOpType scan_op_type,
+      Val* init,
+      Val* out,
+      Val* in,
+      int64_t dim);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  const char* getOpString() const override {
+    return "ScanOp";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+  std::vector<PolymorphicValue> evaluate(
+      const ExpressionEvaluator& ee,
+      const std::vector<PolymorphicValue>& inputs) const override;
+
+  TensorView* out() const {
+    return output(0)->as<TensorView>();
+  }
+  TensorView* in() const {
+    return input(0)->as<TensorView>();
+  }
+  Val* init() const {
+    return attributeVal(0);
+  }
+
+  BinaryOpType getScanOpType() const {
+    return attribute<BinaryOpType>(1);
+  }
+
+  //! Position of the scanned axis in the logical domain of out
+  int64_t dim() const {
+    return attribute<int64_t>(2);
+  }
+};
+
+//! Sorts in along dim, like torch.sort. The outputs are the sorted values and
+//! the positions of those values along dim in the input. There is no codegen
+//! support yet, so the op is expression evaluated.
+class NVF_API SortOp : public Expr {
+ public:
+  using Expr::Expr;
+
+  SortOp(
+      IrBuilderPasskey,
+      TensorView* values,
+      TensorView* indices,
+      TensorView* in,
+      int64_t dim,
+      bool descending,
+      bool stable);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  const char* getOpString() const override {
+    return "SortOp";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+  std::vector<PolymorphicValue> evaluate(
+      const ExpressionEvaluator& ee,
+      const std::vector<PolymorphicValue>& inputs) const override;
+
+  TensorView* values() const {
+    return output(0)->as<TensorView>();
+  }
+  TensorView* indices() const {
+    return output(1)->as<TensorView>();
+  }
+  TensorView* in() const {
+    return input(0)->as<TensorView>();
+  }
+
+  //! Position of the sorted axis in the logical domain of in
+  int64_t dim() const {
+    return attribute<int64_t>(0);
+  }
+  bool isDescending() const {
+    return attribute<bool>(1);
+  }
+  bool isStable() const {
+    return attribute<bool>(2);
+  }
+};
+
+//! Selects the k largest or smallest elements of in along dim, like
+//! torch.topk. The outputs have extent k along dim and hold the selected
+//! values and their positions along dim in the input. There is no codegen
+//! support yet, so the op is expression evaluated.
+class NVF_API TopKOp : public Expr {
+ public:
+  using Expr::Expr;
+
+  TopKOp(
+      IrBuilderPasskey,
+      TensorView* values,
+      TensorView* indices,
+      TensorView* in,
+      Val* k,
+      int64_t dim,
+      bool largest,
+      bool sorted);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  const char* getOpString() const override {
+    return "TopKOp";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+  std::vector<PolymorphicValue> evaluate(
+      const ExpressionEvaluator& ee,
+      const std::vector<PolymorphicValue>& inputs) const override;
+
+  TensorView* values() const {
+    return output(0)->as<TensorView>();
+  }
+  TensorView* indices() const {
+    return output(1)->as<TensorView>();
+  }
+  TensorView* in() const {
+    return input(0)->as<TensorView>();
+  }
+  Val* k() const {
+    return input(1);
+  }
+
+  //! Position of the selected axis in the logical domain of in
+  int64_t dim() const {
+    return attribute<int64_t>(0);
+  }
+  bool isLargest() const {
+    return attribute<bool>(1);
+  }
+  bool isSorted() const {
+    return attribute<bool>(2);
+  }
+};
+
 //! Grouped reduction operation for horizontal fusions. It works like
 //! batched GEMMs in the sense that multiple independent reductions are
 //! performed together. The main benefit is when reducing tensors across thread
@@ -1475,6 +1629,10 @@ class NVF_API MmaOp : public Expr {
     return nvfuser::isHopper(macro());
   }
 
+  bool isBlackwell() const {
+    return nvfuser::isBlackwell(macro());
+  }
+
   void setMacro(MmaMacro options);
 
   const AxisMapping& axisMapping() const {
@@ -2275,6 +2433,156 @@ class LinearOp : public Expr {
   }
 };
 
+//! Grouped matmul of differently sized row blocks of mat1[M, K] with the
+//! matrices of mat2[G, K, N], as used by Mixture-of-Experts layers. offsets[G]
+//! holds the cumulative end row of each group, so group g computes
+//! out[offsets[g-1]:offsets[g]] = mat1[offsets[g-1]:offsets[g]] @ mat2[g].
+//! Rows past offsets[G-1] are zero. Like MatmulOp, it is expression evaluated
+//! without decomposition.
+class GroupedMatmulOp : public Expr {
+ public:
+  using Expr::Expr;
+
+  GroupedMatmulOp(
+      IrBuilderPasskey,
+      Val* out,
+      Val* mat1,
+      Val* mat2,
+      Val* offsets);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  const char* getOpString() const override {
+    return "GroupedMatmulOp";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+
+  TensorView* out() const {
+    return output(0)->as<TensorView>();
+  }
+
+  TensorView* mat1() const {
+    return input(0)->as<TensorView>();
+  }
+
+  TensorView* mat2() const {
+    return input(1)->as<TensorView>();
+  }
+
+  TensorView* offsets() const {
+    return input(2)->as<TensorView>();
+  }
+
+  std::vector<PolymorphicValue> evaluate(
+      const ExpressionEvaluator& ee,
+      const std::vector<PolymorphicValue>& inputs) const override;
+};
+
+//! Reduction of the variable-length segments of a packed in[T, ...], as used
+//! for batches of sequences stored without padding. offsets[B] holds the
+//! cumulative end row of each segment like in GroupedMatmulOp, so
+//! out[b] = reductionOp(init, in[offsets[b-1]:offsets[b]]). Empty segments are
+//! init and rows past offsets[B-1] are ignored. It is expression evaluated.
+class SegmentedReductionOp : public Expr {
+ public:
+  using Expr::Expr;
+
+  SegmentedReductionOp(
+      IrBuilderPasskey,
+      BinaryOpType reduction_op_type,
+      Val* init,
+      Val* out,
+      Val* in,
+      Val* offsets);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  const char* getOpString() const override {
+    return "SegmentedReductionOp";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+  std::vector<PolymorphicValue> evaluate(
+      const ExpressionEvaluator& ee,
+      const std::vector<PolymorphicValue>& inputs) const override;
+
+  TensorView* out() const {
+    return output(0)->as<TensorView>();
+  }
+  TensorView* in() const {
+    return input(0)->as<TensorView>();
+  }
+  TensorView* offsets() const {
+    return input(1)->as<TensorView>();
+  }
+  Val* init() const {
+    return attributeVal(0);
+  }
+
+  BinaryOpType getReductionOpType() const {
+    return attribute<BinaryOpType>(1);
+  }
+};
+
+//! Gradient of an embedding lookup with respect to the weight table:
+//!   grad_weight[indices[i], :] += grad_output[i, :]
+//! grad_output is [..., D] and indices holds the leading dims. The output is
+//! [num_weights, D]. Rows equal to padding_idx receive no gradient, and with
+//! scale_grad_by_freq each row is divided by the number of times it occurs.
+//!
+//! Indices are sorted first so that every duplicate of a row is reduced in a
+//! single segment before the row is written once. This avoids contended
+//! atomics on skewed token distributions and makes the result deterministic.
+class EmbeddingBwdOp : public Expr {
+ public:
+  using Expr::Expr;
+
+  EmbeddingBwdOp(
+      IrBuilderPasskey,
+      TensorView* grad_weight,
+      TensorView* grad_output,
+      TensorView* indices,
+      Val* num_weights,
+      int64_t padding_idx,
+      bool scale_grad_by_freq);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  const char* getOpString() const override {
+    return "EmbeddingBwdOp";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+  std::vector<PolymorphicValue> evaluate(
+      const ExpressionEvaluator& ee,
+      const std::vector<PolymorphicValue>& inputs) const override;
+
+  TensorView* gradWeight() const {
+    return output(0)->as<TensorView>();
+  }
+  TensorView* gradOutput() const {
+    return input(0)->as<TensorView>();
+  }
+  TensorView* indices() const {
+    return input(1)->as<TensorView>();
+  }
+  Val* numWeights() const {
+    return input(2);
+  }
+
+  int64_t paddingIdx() const {
+    return attribute<int64_t>(0);
+  }
+
+  bool scaleGradByFreq() const {
+    return attribute<bool>(1);
+  }
+};
+
 /*
 SDPA node with same functionality at::_scaled_dot_product_flash_attention
 output = [N, H, L, Ev]
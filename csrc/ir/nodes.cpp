@@ -18,6 +18,7 @@
 #include <kernel_ir.h>
 #include <logical_domain_map.h>
 #include <ops/arith.h>
+#include <options.h>
 #include <transform_iter.h>
 #include <transform_rfactor.h>
 #include <transform_view.h>
@@ -268,6 +269,52 @@ IterDomain* ScatterOp::getIndexedID() const {
   return ir_utils::getTvOutput(this)->getLogicalDomain().at(dim());
 }
 
+namespace {
+
+// Scatters src into a copy of input, keeping the last source in the order of
+// index for duplicate indices. The winner of each position is picked by an
+// integer max, which is the same whatever the order of its atomics.
+at::Tensor deterministicScatter(
+    const at::Tensor& input,
+    int64_t dim,
+    const at::Tensor& index,
+    const at::Tensor& src) {
+  const auto long_options = index.options().dtype(at::kLong);
+  std::vector<int64_t> out_strides(input.dim(), 1);
+  for (int64_t d = input.dim() - 2; d >= 0; d--) {
+    out_strides.at(d) = out_strides.at(d + 1) * input.size(d + 1);
+  }
+
+  // Position of each element of index in the flattened output
+  at::Tensor linear_index = index.to(at::kLong) * out_strides.at(dim);
+  at::Tensor narrowed_src = src;
+  for (const auto d : c10::irange(index.dim())) {
+    narrowed_src = narrowed_src.narrow(d, 0, index.size(d));
+    if (d == dim) {
+      continue;
+    }
+    std::vector<int64_t> shape(index.dim(), 1);
+    shape.at(d) = index.size(d);
+    linear_index = linear_index +
+        at::arange(index.size(d), long_options).view(shape) * out_strides.at(d);
+  }
+
+  at::Tensor winner =
+      at::full({input.numel()}, -1, long_options)
+          .scatter_reduce_(
+              0,
+              linear_index.reshape(-1),
+              at::arange(index.numel(), long_options),
+              "amax");
+  at::Tensor hit = winner.ge(0);
+  at::Tensor out = input.clone(at::MemoryFormat::Contiguous);
+  out.view(-1).index_put_(
+      {hit}, narrowed_src.reshape(-1).index({winner.index({hit})}));
+  return out;
+}
+
+} // namespace
+
 std::vector<PolymorphicValue> ScatterOp::evaluate(
     const ExpressionEvaluator& ee,
     const std::vector<PolymorphicValue>& inputs) const {
@@ -275,7 +322,13 @@ std::vector<PolymorphicValue> ScatterOp::evaluate(
   const auto& index = inputs.at(1).as<at::Tensor>();
   const auto& src = inputs.at(2).as<at::Tensor>();
   auto dimension = dim();
-  return {at::scatter(input, dimension, index, src)};
+  if (!isOptionEnabled(EnableOption::DeterministicReductions) ||
+      at::globalContext().deterministicAlgorithms()) {
+    return {at::scatter(input, dimension, index, src)};
+  }
+  // ATen's deterministic scatter is only used when its mode is turned on for
+  // the whole process
+  return {deterministicScatter(input, dimension, index, src)};
 }
 
 NVFUSER_DEFINE_CLONE_AND_CREATE(ScatterOp)
@@ -1544,6 +1597,180 @@ std::vector<PolymorphicValue> ReductionOp::evaluate(
 
 NVFUSER_DEFINE_CLONE_AND_CREATE(ReductionOp)
 
+ScanOp::ScanOp(
+    IrBuilderPasskey passkey,
+    BinaryOpType scan_op_type,
+    Val* init,
+    Val* out,
+    Val* in,
+    int64_t dim)
+    : Expr(passkey) {
+  NVF_ERROR(
+      in->isA<TensorView>() && out->isA<TensorView>(),
+      "Scan operation was created that does not have tensor inputs and "
+      "outputs.");
+  NVF_ERROR(
+      init->isConstScalar(),
+      "Tried to create a scan operation whith an initial value that isn't a "
+      "constant.");
+  addOutput(out);
+  addInput(in);
+  addAttribute(init);
+  addDataAttribute(scan_op_type);
+  addDataAttribute(dim);
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(ScanOp)
+
+std::string ScanOp::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << out() << "\n";
+  indent(ss, indent_size) << "   = scan( " << in()->toString()
+                          << ", op = " << getScanOpType() << ", dim = " << dim()
+                          << ", initial value = " << init()->toString()
+                          << " )\n";
+  return ss.str();
+}
+
+std::string ScanOp::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "Tensor op can not be printed inline");
+}
+
+std::vector<PolymorphicValue> ScanOp::evaluate(
+    const ExpressionEvaluator& ee,
+    const std::vector<PolymorphicValue>& inputs) const {
+  const auto& input = inputs.at(0).as<at::Tensor>();
+  const auto out_dtype = data_type_to_aten(out()->dtype());
+  // The initial value is combined with every element of the scan. cumsum and
+  // cumprod start from the identity, so skip the extra pass in that case.
+  const c10::Scalar init_val = toScalar(init()->evaluate());
+  switch (getScanOpType()) {
+    case BinaryOpType::Add: {
+      at::Tensor output = at::cumsum(input, dim(), out_dtype);
+      return {init()->isZero() ? output : output.add_(init_val)};
+    }
+    case BinaryOpType::Mul: {
+      at::Tensor output = at::cumprod(input, dim(), out_dtype);
+      return {init()->isOne() ? output : output.mul_(init_val)};
+    }
+    case BinaryOpType::Max:
+      return {std::get<0>(at::cummax(input, dim()))
+                  .to(out_dtype)
+                  .clamp_min_(init_val)};
+    case BinaryOpType::Min:
+      return {std::get<0>(at::cummin(input, dim()))
+                  .to(out_dtype)
+                  .clamp_max_(init_val)};
+    default:
+      NVF_CHECK(
+          false,
+          "Unexpected operator type: ",
+          getScanOpType(),
+          " in ",
+          toString());
+  }
+}
+
+SortOp::SortOp(
+    IrBuilderPasskey passkey,
+    TensorView* values,
+    TensorView* indices,
+    TensorView* in,
+    int64_t dim,
+    bool descending,
+    bool stable)
+    : Expr(passkey) {
+  NVF_ERROR(
+      isIntegralType(indices->dtype()),
+      "Sort indices must be integral, but got ",
+      indices->dtype());
+  addOutput(values);
+  addOutput(indices);
+  addInput(in);
+  addDataAttribute(dim);
+  addDataAttribute(descending);
+  addDataAttribute(stable);
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(SortOp)
+
+std::string SortOp::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << "( " << values()->toString() << ", "
+                          << indices()->toString() << " )\n";
+  indent(ss, indent_size) << "   = sort( " << in()->toString()
+                          << ", dim = " << dim()
+                          << ", descending = " << isDescending()
+                          << ", stable = " << isStable() << " )\n";
+  return ss.str();
+}
+
+std::string SortOp::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "Tensor op can not be printed inline");
+}
+
+std::vector<PolymorphicValue> SortOp::evaluate(
+    const ExpressionEvaluator& ee,
+    const std::vector<PolymorphicValue>& inputs) const {
+  const auto& input = inputs.at(0).as<at::Tensor>();
+  auto [values, indices] = at::sort(input, isStable(), dim(), isDescending());
+  return {values, indices.to(data_type_to_aten(this->indices()->dtype()))};
+}
+
+TopKOp::TopKOp(
+    IrBuilderPasskey passkey,
+    TensorView* values,
+    TensorView* indices,
+    TensorView* in,
+    Val* k,
+    int64_t dim,
+    bool largest,
+    bool sorted)
+    : Expr(passkey) {
+  NVF_ERROR(
+      isIntegralType(k->dtype()),
+      "TopK expects an integral k, but got ",
+      k->dtype());
+  NVF_ERROR(
+      isIntegralType(indices->dtype()),
+      "TopK indices must be integral, but got ",
+      indices->dtype());
+  addOutput(values);
+  addOutput(indices);
+  addInput(in);
+  addInput(k);
+  addDataAttribute(dim);
+  addDataAttribute(largest);
+  addDataAttribute(sorted);
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(TopKOp)
+
+std::string TopKOp::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << "( " << values()->toString() << ", "
+                          << indices()->toString() << " )\n";
+  indent(ss, indent_size) << "   = topk( " << in()->toString()
+                          << ", k = " << k()->toInlineString()
+                          << ", dim = " << dim()
+                          << ", largest = " << isLargest()
+                          << ", sorted = " << isSorted() << " )\n";
+  return ss.str();
+}
+
+std::string TopKOp::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "Tensor op can not be printed inline");
+}
+
+std::vector<PolymorphicValue> TopKOp::evaluate(
+    const ExpressionEvaluator& ee,
+    const std::vector<PolymorphicValue>& inputs) const {
+  const auto& input = inputs.at(0).as<at::Tensor>();
+  const auto k = inputs.at(1).as<int64_t>();
+  auto [values, indices] = at::topk(input, k, dim(), isLargest(), isSorted());
+  return {values, indices.to(data_type_to_aten(this->indices()->dtype()))};
+}
+
 GroupedReductionOp::GroupedReductionOp(
     IrBuilderPasskey passkey,
     std::vector<BinaryOpType> reduction_op_types,
@@ -4655,6 +4882,255 @@ std::vector<PolymorphicValue> LinearOp::evaluate(
   return {out};
 }
 
+GroupedMatmulOp::GroupedMatmulOp(
+    IrBuilderPasskey passkey,
+    Val* out,
+    Val* mat1,
+    Val* mat2,
+    Val* offsets)
+    : Expr(passkey) {
+  addOutput(out);
+  addInput(mat1);
+  addInput(mat2);
+  addInput(offsets);
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(GroupedMatmulOp)
+
+std::string GroupedMatmulOp::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << out()->toString() << "\n";
+  indent(ss, indent_size + 1)
+      << " = grouped_matmul(" << mat1()->toString() << ",\n";
+  indent(ss, indent_size + 1)
+      << "                  " << mat2()->toString() << ",\n";
+  indent(ss, indent_size + 1)
+      << "                  " << offsets()->toString() << ")\n";
+  return ss.str();
+}
+
+std::string GroupedMatmulOp::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "Tensor op can not be printed inline");
+}
+
+std::vector<PolymorphicValue> GroupedMatmulOp::evaluate(
+    const ExpressionEvaluator& ee,
+    const std::vector<PolymorphicValue>& inputs) const {
+  const auto mat1 = inputs.at(0).as<at::Tensor>();
+  const auto mat2 = inputs.at(1).as<at::Tensor>();
+  const auto offsets = inputs.at(2).as<at::Tensor>();
+  NVF_CHECK(
+      offsets.dim() == 1 && offsets.size(0) == mat2.size(0),
+      "Expected one offset per group, got offsets of shape ",
+      offsets.sizes(),
+      " for mat2 of shape ",
+      mat2.sizes());
+
+  const int64_t m = mat1.size(0);
+  const std::vector<int64_t> out_sizes = {m, mat2.size(2)};
+  at::Tensor out = ir_utils::hasTrivialAllocationDomain(this->out())
+      ? at::empty(out_sizes, mat1.options())
+      : at::empty_strided(
+            out_sizes, computeStrides(this->out(), out_sizes), mat1.options());
+
+  // The group boundaries decide the shapes of the per-group GEMMs, so they
+  // are needed on the host
+  const at::Tensor ends = offsets.to(at::kCPU, at::kLong);
+  int64_t start = 0;
+  for (auto g : c10::irange(ends.size(0))) {
+    const int64_t end = ends[g].item<int64_t>();
+    NVF_CHECK(
+        start <= end && end <= m,
+        "Offsets must be non-decreasing and at most ",
+        m,
+        ", got ",
+        ends);
+    if (end > start) {
+      at::Tensor out_g = out.narrow(0, start, end - start);
+      at::mm_out(out_g, mat1.narrow(0, start, end - start), mat2.select(0, g));
+    }
+    start = end;
+  }
+  if (start < m) {
+    out.narrow(0, start, m - start).zero_();
+  }
+  return {out};
+}
+
+SegmentedReductionOp::SegmentedReductionOp(
+    IrBuilderPasskey passkey,
+    BinaryOpType reduction_op_type,
+    Val* init,
+    Val* out,
+    Val* in,
+    Val* offsets)
+    : Expr(passkey) {
+  NVF_ERROR(
+      init->isConstScalar(),
+      "Tried to create a segmented reduction operation whith an initial value "
+      "that isn't a constant.");
+  addOutput(out);
+  addInput(in);
+  addInput(offsets);
+  addAttribute(init);
+  addDataAttribute(reduction_op_type);
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(SegmentedReductionOp)
+
+std::string SegmentedReductionOp::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << out() << "\n";
+  indent(ss, indent_size) << "   = segmented_reduction( " << in()->toString()
+                          << ", offsets = " << offsets()->toString()
+                          << ", op = " << getReductionOpType()
+                          << ", initial value = " << init()->toString()
+                          << " )\n";
+  return ss.str();
+}
+
+std::string SegmentedReductionOp::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "Tensor op can not be printed inline");
+}
+
+std::vector<PolymorphicValue> SegmentedReductionOp::evaluate(
+    const ExpressionEvaluator& ee,
+    const std::vector<PolymorphicValue>& inputs) const {
+  const auto& input = inputs.at(0).as<at::Tensor>();
+  const auto& offsets = inputs.at(1).as<at::Tensor>();
+  NVF_CHECK(offsets.dim() == 1, "Expected 1D offsets, got ", offsets.sizes());
+
+  const char* reduce = nullptr;
+  switch (getReductionOpType()) {
+    case BinaryOpType::Add:
+      reduce = "sum";
+      break;
+    case BinaryOpType::Mul:
+      reduce = "prod";
+      break;
+    case BinaryOpType::Max:
+      reduce = "amax";
+      break;
+    case BinaryOpType::Min:
+      reduce = "amin";
+      break;
+    default:
+      NVF_CHECK(
+          false,
+          "Unexpected operator type: ",
+          getReductionOpType(),
+          " in ",
+          toString());
+  }
+
+  const int64_t num_rows = input.size(0);
+  const int64_t num_segments = offsets.size(0);
+  const auto out_dtype = data_type_to_aten(this->out()->dtype());
+
+  if (isOptionEnabled(EnableOption::DeterministicReductions)) {
+    // scatter_reduce_ accumulates with atomics. Segment reductions instead
+    // reduce each segment in a fixed order. The segments start at 0 and at
+    // each offset, and an extra segment holds the rows past the last offset.
+    // The offsets are not validated, which would synchronize with the host.
+    at::Tensor bounds = at::cat(
+        {at::zeros({1}, offsets.options()),
+         offsets,
+         at::full({1}, num_rows, offsets.options())});
+    at::Tensor out = at::segment_reduce(
+        input.to(out_dtype),
+        reduce,
+        /*lengths=*/std::nullopt,
+        /*indices=*/std::nullopt,
+        /*offsets=*/bounds,
+        /*axis=*/0,
+        /*unsafe=*/true,
+        /*initial=*/toScalar(init()->evaluate()));
+    return {out.narrow(0, 0, num_segments)};
+  }
+
+  // Row t belongs to the segment of the first offset greater than t. Rows
+  // past the last offset get segment B, which is dropped from the output.
+  // This keeps the segment boundaries on the device.
+  at::Tensor segment_ids = at::searchsorted(
+      offsets.to(at::kLong),
+      at::arange(num_rows, offsets.options().dtype(at::kLong)),
+      /*out_int32=*/false,
+      /*right=*/true);
+  std::vector<int64_t> index_shape(input.dim(), 1);
+  index_shape[0] = num_rows;
+  at::Tensor index = segment_ids.view(index_shape).expand_as(input);
+
+  std::vector<int64_t> out_sizes = input.sizes().vec();
+  out_sizes[0] = num_segments + 1;
+  at::Tensor out = at::full(
+      out_sizes,
+      toScalar(init()->evaluate()),
+      input.options().dtype(out_dtype));
+  out.scatter_reduce_(
+      0, index, input.to(out.scalar_type()), reduce, /*include_self=*/true);
+  return {out.narrow(0, 0, num_segments)};
+}
+
+EmbeddingBwdOp::EmbeddingBwdOp(
+    IrBuilderPasskey passkey,
+    TensorView* grad_weight,
+    TensorView* grad_output,
+    TensorView* indices,
+    Val* num_weights,
+    int64_t padding_idx,
+    bool scale_grad_by_freq)
+    : Expr(passkey) {
+  addOutput(grad_weight);
+  addInput(grad_output);
+  addInput(indices);
+  addInput(num_weights);
+  addDataAttribute(padding_idx);
+  addDataAttribute(scale_grad_by_freq);
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(EmbeddingBwdOp)
+
+std::string EmbeddingBwdOp::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << gradWeight() << "\n";
+  indent(ss, indent_size) << "   = embedding_bwd( " << gradOutput()->toString()
+                          << ", indices = " << indices()->toString()
+                          << ", num_weights = "
+                          << numWeights()->toInlineString()
+                          << ", padding_idx = " << paddingIdx()
+                          << ", scale_grad_by_freq = "
+                          << (scaleGradByFreq() ? "true" : "false") << " )\n";
+  return ss.str();
+}
+
+std::string EmbeddingBwdOp::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "Tensor op can not be printed inline");
+}
+
+std::vector<PolymorphicValue> EmbeddingBwdOp::evaluate(
+    const ExpressionEvaluator& ee,
+    const std::vector<PolymorphicValue>& inputs) const {
+  const auto& grad_output = inputs.at(0).as<at::Tensor>();
+  const auto& indices = inputs.at(1).as<at::Tensor>();
+  const int64_t num_weights = inputs.at(2).as<int64_t>();
+  NVF_CHECK(
+      grad_output.dim() == indices.dim() + 1,
+      "Expected grad_output to have one more dimension than indices, got ",
+      grad_output.sizes(),
+      " and ",
+      indices.sizes());
+
+  // The CUDA implementation sorts the indices and reduces each run of equal
+  // indices before a single write per row, so duplicates never race.
+  at::Tensor grad_weight = at::embedding_dense_backward(
+      grad_output,
+      indices.to(at::kLong),
+      num_weights,
+      paddingIdx(),
+      scaleGradByFreq());
+  return {grad_weight.to(data_type_to_aten(gradWeight()->dtype()))};
+}
+
 SdpaFwdOp::SdpaFwdOp(
     IrBuilderPasskey passkey,
     TensorView* output,
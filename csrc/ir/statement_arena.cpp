@@ -0,0 +1,108 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <exceptions.h>
+#include <ir/statement_arena.h>
+
+#include <limits>
+
+namespace nvfuser {
+
+StatementArena::~StatementArena() = default;
+
+StatementArena::Header* StatementArena::header(const void* ptr) {
+  return reinterpret_cast<Header*>(
+      const_cast<char*>(static_cast<const char*>(ptr)) - kHeaderSize);
+}
+
+char* StatementArena::newBlock(size_t size) {
+  blocks_.emplace_back(new char[size]);
+  char* block = blocks_.back().get();
+  block_sizes_.emplace(block, size);
+  reserved_bytes_ += size;
+  return block;
+}
+
+void* StatementArena::allocate(size_t size) {
+  const size_t size_class = (size + kAlignment - 1) / kAlignment;
+  const size_t bytes = kHeaderSize + size_class * kAlignment;
+
+  char* memory = nullptr;
+  if (size_class > kMaxSizeClass) {
+    memory = newBlock(bytes);
+  } else if (void* freed = free_lists_[size_class]; freed != nullptr) {
+    free_lists_[size_class] = *static_cast<void**>(freed);
+    memory = static_cast<char*>(freed) - kHeaderSize;
+  } else {
+    if (cursor_ == nullptr || (size_t)(end_ - cursor_) < bytes) {
+      cursor_ = newBlock(kBlockSize);
+      end_ = cursor_ + kBlockSize;
+    }
+    memory = cursor_;
+    cursor_ += bytes;
+  }
+
+  auto* stmt_header = reinterpret_cast<Header*>(memory);
+  stmt_header->arena = this;
+  stmt_header->index = -1;
+  stmt_header->size_class =
+      size_class > kMaxSizeClass ? 0 : (uint16_t)size_class;
+  stmt_header->registered = 0;
+  return memory + kHeaderSize;
+}
+
+void StatementArena::deallocate(void* ptr) noexcept {
+  if (ptr == nullptr) {
+    return;
+  }
+  Header* stmt_header = header(ptr);
+  stmt_header->registered = 0;
+  stmt_header->index = -1;
+  // Dedicated blocks are released with the arena
+  const size_t size_class = stmt_header->size_class;
+  if (size_class == 0) {
+    return;
+  }
+  auto& free_list = stmt_header->arena->free_lists_[size_class];
+  *static_cast<void**>(ptr) = free_list;
+  free_list = ptr;
+}
+
+bool StatementArena::contains(const void* ptr) const {
+  const char* address = static_cast<const char*>(ptr);
+  auto block = block_sizes_.upper_bound(address);
+  if (block == block_sizes_.begin()) {
+    return false;
+  }
+  --block;
+  return address >= block->first + kHeaderSize &&
+      address < block->first + block->second;
+}
+
+bool StatementArena::isRegistered(const void* ptr) {
+  return header(ptr)->registered != 0;
+}
+
+int64_t StatementArena::index(const void* ptr) {
+  return header(ptr)->index;
+}
+
+void StatementArena::setRegistered(const void* ptr, int64_t index) {
+  Header* stmt_header = header(ptr);
+  stmt_header->registered = 1;
+  setIndex(ptr, index);
+}
+
+void StatementArena::setIndex(const void* ptr, int64_t index) {
+  NVF_ERROR(
+      index >= -1 && index <= std::numeric_limits<int32_t>::max(),
+      "Statement index out of range: ",
+      index);
+  header(ptr)->index = (int32_t)index;
+}
+
+} // namespace nvfuser
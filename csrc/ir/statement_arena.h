@@ -0,0 +1,106 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <utils.h>
+#include <visibility.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace nvfuser {
+
+//! StatementArena is the memory of the Statements of an IrContainer. Large
+//! fusions are built and cloned many times, e.g., by concretization,
+//! segmentation, scheduler trials, and lowering, so Statements are bump
+//! allocated from blocks instead of individually allocated from the heap.
+//! The memory of a destroyed Statement is kept in a free list of its size
+//! class and reused by the next Statement of that size. Blocks are only
+//! returned to the heap when the arena is destroyed.
+//!
+//! Each Statement is preceded by a header holding its arena and its index in
+//! the dense vectors of its container, so that a container can remove a
+//! Statement and check its ownership of a pointer without hashing.
+//!
+//! The arena is not thread-safe, like the container it belongs to.
+class StatementArena : public NonCopyable {
+ public:
+  StatementArena() = default;
+  ~StatementArena();
+
+  //! Memory for a Statement of size bytes. Throws std::bad_alloc like
+  //! operator new.
+  NVF_API void* allocate(size_t size);
+
+  //! Returns the memory of a destroyed Statement to the arena it came from
+  NVF_API static void deallocate(void* ptr) noexcept;
+
+  //! Whether ptr points into a block of this arena. ptr is not dereferenced,
+  //! so it may be a dangling pointer to a Statement of any container.
+  bool contains(const void* ptr) const;
+
+  //! Whether the Statement at ptr, which must be in a block of this arena, is
+  //! alive and registered with a container
+  static bool isRegistered(const void* ptr);
+
+  //! Index of the Statement in the dense vector of its container, or -1 if the
+  //! container doesn't keep it in one, e.g., for the shortcut vals
+  static int64_t index(const void* ptr);
+
+  //! Marks the Statement as registered with a container at the given index
+  static void setRegistered(const void* ptr, int64_t index);
+
+  //! Updates the index of a registered Statement, e.g., when its container
+  //! compacts its vectors
+  static void setIndex(const void* ptr, int64_t index);
+
+  //! Number of bytes of all blocks
+  size_t reservedBytes() const {
+    return reserved_bytes_;
+  }
+
+ private:
+  struct Header {
+    StatementArena* arena;
+    int32_t index;
+    //! Size of the Statement rounded up to kAlignment, in units of kAlignment
+    uint16_t size_class;
+    uint8_t registered;
+    uint8_t unused;
+  };
+
+  static constexpr size_t kAlignment = alignof(std::max_align_t);
+  static constexpr size_t kHeaderSize =
+      (sizeof(Header) + kAlignment - 1) / kAlignment * kAlignment;
+  static constexpr size_t kBlockSize = 64 * 1024;
+  //! Statements of more than kMaxSizeClass * kAlignment bytes get a
+  //! dedicated block, which is not reused
+  static constexpr size_t kMaxSizeClass = 256;
+
+  static Header* header(const void* ptr);
+
+  //! Allocates a block of at least size bytes and records its range
+  char* newBlock(size_t size);
+
+  //! Blocks indexed by their first byte, mapped to their size
+  std::map<const char*, size_t> block_sizes_;
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  //! Free bytes of the last block
+  char* cursor_ = nullptr;
+  char* end_ = nullptr;
+  //! Heads of the free lists indexed by size class. The memory of a freed
+  //! Statement holds the next element of its list.
+  std::array<void*, kMaxSizeClass + 1> free_lists_{};
+  size_t reserved_bytes_ = 0;
+};
+
+} // namespace nvfuser
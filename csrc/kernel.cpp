@@ -7,14 +7,18 @@
 // clang-format on
 #include <debug.h>
 #include <device_lower/lower2device.h>
+#include <device_lower/utils.h>
 #include <instrumentation.h>
 #include <ir/iostream.h>
 #include <ir/utils.h>
 #include <kernel.h>
 #include <kernel_ir_dispatch.h>
+#include <options.h>
 
 #include <ATen/cuda/CUDAContext.h>
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <unordered_set>
 
@@ -98,6 +102,12 @@ class KernelIrScanner : private IrVisitor {
 
   void handle(RNGOp* rng_op) final {
     summary_.has_philox_op = true;
+    // Unswitched and unrolled copies of a loop nest share their exprs
+    if (std::find(
+            summary_.rng_ops.begin(), summary_.rng_ops.end(), rng_op) ==
+        summary_.rng_ops.end()) {
+      summary_.rng_ops.push_back(rng_op);
+    }
   }
 
   void handle(TensorIndex* tensor_index) final {
@@ -125,6 +135,10 @@ class KernelIrScanner : private IrVisitor {
     auto out_dom = welford_op->outAvg()->as<TensorIndex>()->view()->domain();
     summary_.has_block_welford =
         summary_.has_block_welford || out_dom->hasBlockReduction();
+    summary_.has_block_welford_with_smem_n =
+        summary_.has_block_welford_with_smem_n ||
+        (out_dom->hasBlockReduction() &&
+         !lower_utils::hasUniformWelfordInputN(welford_op));
   }
 
   // TODO: need to split into IterGroupedReductionOp and ExprGroupedReductionOp?
@@ -371,6 +385,9 @@ void Kernel::finalize(std::vector<Expr*> top_level_exprs) {
   for (auto alloc : summary_.global_allocations) {
     parameters_.push_back(alloc->buffer());
   }
+  if (isOptionEnabled(EnableOption::CompactTensorArgs)) {
+    findUnreadTensorMetaData();
+  }
 }
 
 void Kernel::analyze() {
@@ -380,6 +397,58 @@ void Kernel::analyze() {
   summary_ = ir_scanner.summary();
 }
 
+void Kernel::findUnreadTensorMetaData() {
+  FUSER_PERF_SCOPE("Kernel::findUnreadTensorMetaData");
+
+  // Fields of each tensor read by the kernel. Indices and extents are inlined
+  // into the generated code, so every GetAttr of a metadata struct in the
+  // container is considered read. This can only overestimate what is read.
+  std::unordered_map<const TensorView*, std::unordered_set<std::string>>
+      read_fields;
+  // Tensors whose metadata struct is used as a whole, e.g., assigned to a
+  // local variable, need all their fields
+  std::unordered_set<const TensorView*> fully_read;
+
+  for (Expr* expr : ir_utils::flattenScopedExprs(top_level_exprs_)) {
+    if (auto* metadata = dynamic_cast<GetMetaData*>(expr)) {
+      if (auto* tv = dynamic_cast<TensorView*>(metadata->in())) {
+        fully_read.insert(tv);
+      }
+    }
+  }
+  for (Expr* expr : unordered_exprs()) {
+    for (Val* input : expr->inputs()) {
+      auto* metadata = dynamic_cast<GetMetaData*>(input->definition());
+      if (metadata == nullptr) {
+        continue;
+      }
+      auto* tv = dynamic_cast<TensorView*>(metadata->in());
+      if (tv == nullptr) {
+        continue;
+      }
+      if (auto* get_attr = dynamic_cast<GetAttr*>(expr)) {
+        read_fields[tv].insert(get_attr->attr());
+      } else {
+        fully_read.insert(tv);
+      }
+    }
+  }
+
+  for (Val* param : parameters_) {
+    auto* tv = dynamic_cast<TensorView*>(param);
+    if (tv == nullptr || tv->isCpuScalar() || fully_read.count(tv)) {
+      continue;
+    }
+    const std::unordered_set<std::string>& fields = read_fields[tv];
+    if (!fields.count("logical_size")) {
+      summary_.params_without_logical_size.insert(tv);
+    }
+    if (!fields.count("alloc_stride")) {
+      summary_.params_without_alloc_stride.insert(tv);
+    }
+  }
+}
+
 void Kernel::print() const {
   IrPrinter ir_printer(debug());
   ir_printer.handle(this);
@@ -508,5 +577,98 @@ std::string KernelPerformanceProfile::toString(const at::Tensor& buffer) const {
   return ss.str();
 }
 
+namespace {
+
+const char* timelineEventName(KernelPerformanceProfile::TimelineEvent event) {
+  using TimelineEvent = KernelPerformanceProfile::TimelineEvent;
+  switch (event) {
+    case TimelineEvent::KernelStart:
+    case TimelineEvent::KernelEnd:
+      return "kernel";
+    case TimelineEvent::TmaIssue:
+      return "tma issue";
+    case TimelineEvent::MBarrierWaitBegin:
+    case TimelineEvent::MBarrierWaitEnd:
+      return "mbarrier wait";
+    case TimelineEvent::MmaIssue:
+      return "mma issue";
+    case TimelineEvent::EpilogueStore:
+      return "epilogue store";
+  }
+  NVF_THROW("Unexpected timeline event: ", (int64_t)event);
+}
+
+} // namespace
+
+std::string KernelPerformanceProfile::writeTimeline(
+    const at::Tensor& buffer,
+    const std::string& path) const {
+  const at::Tensor records = buffer.cpu();
+  const auto rows = records.accessor<int64_t, 2>();
+
+  // Timestamps are relative to the first record of any warp. The global
+  // timer is shared by the SMs of a device.
+  int64_t origin = std::numeric_limits<int64_t>::max();
+  for (auto row : c10::irange(rows.size(0))) {
+    if (rows[row][0] > 0) {
+      origin = std::min(origin, rows[row][1]);
+    }
+  }
+
+  std::ofstream trace(path);
+  NVF_CHECK(trace.good(), "Can't open kernel timeline file: ", path);
+  trace << "{\n\"traceEvents\": [\n";
+  std::stringstream summary;
+  summary << "Kernel timeline written to " << path << "\n";
+  summary << std::setprecision(3) << std::fixed;
+  bool first_event = true;
+  for (auto row : c10::irange(rows.size(0))) {
+    const int64_t count = std::min(rows[row][0], timeline_max_records_);
+    if (count == 0) {
+      continue;
+    }
+    const int64_t block = row / timeline_warps_per_block;
+    const int64_t warp = row % timeline_warps_per_block;
+    int64_t wait_ns = 0;
+    int64_t wait_begin = -1;
+    for (auto i : c10::irange(count)) {
+      const int64_t timestamp = rows[row][1 + 2 * i];
+      const auto event = (TimelineEvent)rows[row][2 + 2 * i];
+      // Waits and the kernel are spans, the other events are instants
+      char ph = 'i';
+      if (event == TimelineEvent::KernelStart ||
+          event == TimelineEvent::MBarrierWaitBegin) {
+        ph = 'B';
+      } else if (
+          event == TimelineEvent::KernelEnd ||
+          event == TimelineEvent::MBarrierWaitEnd) {
+        ph = 'E';
+      }
+      if (event == TimelineEvent::MBarrierWaitBegin) {
+        wait_begin = timestamp;
+      } else if (event == TimelineEvent::MBarrierWaitEnd && wait_begin >= 0) {
+        wait_ns += timestamp - wait_begin;
+        wait_begin = -1;
+      }
+      trace << (first_event ? "" : ",\n") << "{ \"name\": \""
+            << timelineEventName(event) << "\", \"ph\": \"" << ph
+            << "\", \"pid\": " << block << ", \"tid\": " << warp
+            << ", \"ts\": " << (double)(timestamp - origin) * 1.0e-3
+            << (ph == 'i' ? ", \"s\": \"t\"" : "") << " }";
+      first_event = false;
+    }
+    const int64_t span_ns = rows[row][1 + 2 * (count - 1)] - rows[row][1];
+    summary << "block " << block << " warp " << warp << ": " << count
+            << " records";
+    if (rows[row][0] > timeline_max_records_) {
+      summary << " (" << rows[row][0] - timeline_max_records_ << " dropped)";
+    }
+    summary << ", span " << (double)span_ns * 1.0e-3 << " us, mbarrier wait "
+            << (double)wait_ns * 1.0e-3 << " us\n";
+  }
+  trace << "\n],\n\"displayTimeUnit\": \"ns\"\n}\n";
+  return summary.str();
+}
+
 } // namespace kir
 } // namespace nvfuser
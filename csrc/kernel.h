@@ -22,6 +22,7 @@
 
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -46,6 +47,9 @@ struct KernelSummary {
   //! Indicate the need to generate random numbers
   bool has_philox_op = false;
 
+  //! List of RNG ops, each of which caches its own Philox result
+  std::vector<const RNGOp*> rng_ops;
+
   //! Do we have any block reductions?
   bool has_block_reductions = false;
 
@@ -68,6 +72,11 @@ struct KernelSummary {
   //! Do we have any welford op?
   bool has_block_welford = false;
 
+  //! Do we have any block welford op whose N is kept in shared memory? It
+  //! isn't if the input N is uniform across the block. See
+  //! lower_utils::hasUniformWelfordInputN.
+  bool has_block_welford_with_smem_n = false;
+
   //! Do we have any welford op?
   bool has_grid_welford = false;
 
@@ -126,6 +135,14 @@ struct KernelSummary {
   //! Track Circular Buffer TensorViews
   CircularBufferInfo circular_buffer_info;
 
+  //! Tensor parameters whose logical sizes are never read by the kernel. With
+  //! EnableOption::CompactTensorArgs, they are neither declared in the kernel
+  //! signature nor passed at launch.
+  std::unordered_set<const TensorView*> params_without_logical_size;
+
+  //! Same as params_without_logical_size for allocation strides
+  std::unordered_set<const TensorView*> params_without_alloc_stride;
+
   //! Track if there are ElectSync predicates in this Kernel.
   //! Reason: At runtime, we check that at least a single warp along TIDx axis
   //! exists.
@@ -160,6 +177,50 @@ class KernelPerformanceProfile {
 
   std::string toString(const at::Tensor& buffer) const;
 
+  //! Events of the timeline of EnableOption::KernelTimeline
+  enum class TimelineEvent : int64_t {
+    KernelStart,
+    TmaIssue,
+    MBarrierWaitBegin,
+    MBarrierWaitEnd,
+    MmaIssue,
+    EpilogueStore,
+    KernelEnd
+  };
+
+  //! Rows of the timeline buffer per sampled block, i.e., the max number of
+  //! warps of a block
+  static constexpr int64_t timeline_warps_per_block = 32;
+
+  //! Set the backing buffer of the timeline. It has a row for each warp of
+  //! the sampled blocks with the number of records of the warp, followed by
+  //! the global timer in ns and the event of each record.
+  void setTimelineBuffer(
+      TensorView* buffer,
+      int64_t sampled_blocks,
+      int64_t max_records) {
+    timeline_buffer_ = buffer;
+    timeline_sampled_blocks_ = sampled_blocks;
+    timeline_max_records_ = max_records;
+  }
+
+  TensorView* getTimelineBuffer() const {
+    return timeline_buffer_;
+  }
+
+  int64_t timelineSampledBlocks() const {
+    return timeline_sampled_blocks_;
+  }
+
+  int64_t timelineMaxRecords() const {
+    return timeline_max_records_;
+  }
+
+  //! Write the timeline as a Chrome trace to path, with a process per block
+  //! and a thread per warp, and return a summary of each warp
+  std::string writeTimeline(const at::Tensor& buffer, const std::string& path)
+      const;
+
  private:
   //! Get the new profile index
   int64_t getNewIndex();
@@ -178,6 +239,11 @@ class KernelPerformanceProfile {
   //! Map profiled expressions to profile entry offsets
   std::unordered_map<const Expr*, int64_t> expr_entry_map_;
 
+  //! Backing buffer of the timeline and its dimensions
+  TensorView* timeline_buffer_ = nullptr;
+  int64_t timeline_sampled_blocks_ = 0;
+  int64_t timeline_max_records_ = 0;
+
   // TODO: Allow profiling of ForLoops
   //! Map profiled ForLoop to profile entry offsets
   // std::unordered_map<const ForLoop*, int64_t> loop_entry_map_;
@@ -260,6 +326,10 @@ class NVF_API Kernel final : public Fusion {
   // Analyze the kernel IR and caches the summary of interesting data
   void analyze();
 
+  // Find the tensor parameters whose logical sizes or allocation strides the
+  // kernel never reads
+  void findUnreadTensorMetaData();
+
   // Top level statements
   std::vector<Expr*> top_level_exprs_;
 
@@ -0,0 +1,87 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <sstream>
+
+#include <exceptions.h>
+#include <instrumentation.h>
+#include <kernel_db/artifact_store.h>
+#include <kernel_db/utils.h>
+
+namespace nvfuser {
+
+DirectoryArtifactStore::DirectoryArtifactStore(const std::string& directory)
+    : directory_(directory) {
+  if (!fs::is_directory(directory_)) {
+    try {
+      // Another process may create the directory concurrently
+      fs::create_directories(directory_);
+    } catch (const std::exception& e) {
+      NVF_CHECK(
+          fs::is_directory(directory_),
+          "Unable to create kernel artifact store directory! ",
+          directory_.string(),
+          e.what());
+    }
+  }
+}
+
+bool DirectoryArtifactStore::fetch(
+    const KernelDbKey& key,
+    KernelArtifact& artifact) {
+  FUSER_PERF_SCOPE("DirectoryArtifactStore::fetch");
+  const std::string base_name = key.toString();
+  fs::path meta_file_path = directory_ / (base_name + ".txt");
+  if (!fs::is_regular_file(meta_file_path)) {
+    return false;
+  }
+
+  std::string meta;
+  if (!copy_from_text_file(meta_file_path.string(), meta)) {
+    return false;
+  }
+  std::stringstream meta_ss(meta);
+  if (!std::getline(meta_ss, artifact.kernel_signature) ||
+      !std::getline(meta_ss, artifact.compile_args)) {
+    TORCH_WARN(
+        "Kernel artifact store: Badly formed entry: ",
+        meta_file_path.string());
+    return false;
+  }
+  return copy_from_text_file(
+             (directory_ / (base_name + ".cu")).string(),
+             artifact.kernel_code) &&
+      copy_from_binary_file(
+             (directory_ / (base_name + ".cubin")).string(), artifact.cubin);
+}
+
+bool DirectoryArtifactStore::publish(
+    const KernelDbKey& key,
+    const KernelArtifact& artifact) {
+  FUSER_PERF_SCOPE("DirectoryArtifactStore::publish");
+  const std::string base_name = key.toString();
+  fs::path meta_file_path = directory_ / (base_name + ".txt");
+  // Every rank that compiled the kernel publishes identical contents, so the
+  // first one wins
+  if (fs::is_regular_file(meta_file_path)) {
+    return true;
+  }
+
+  const std::string meta =
+      artifact.kernel_signature + "\n" + artifact.compile_args + "\n";
+  return atomic_copy_to_file(
+             (directory_ / (base_name + ".cu")).string(),
+             artifact.kernel_code.data(),
+             artifact.kernel_code.size()) &&
+      atomic_copy_to_file(
+             (directory_ / (base_name + ".cubin")).string(),
+             artifact.cubin.data(),
+             artifact.cubin.size()) &&
+      atomic_copy_to_file(meta_file_path.string(), meta.data(), meta.size());
+}
+
+} // namespace nvfuser
@@ -0,0 +1,72 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <kernel_db/kernel_db.h>
+#include <visibility.h>
+
+namespace nvfuser {
+
+//! KernelArtifact holds everything needed to reuse a compiled kernel on
+//! another process or node.
+struct KernelArtifact {
+  //! Cuda kernel code, compared on fetch to rule out hash collisions
+  std::string kernel_code;
+  //! Compilation args supplied to NVRTC
+  std::string compile_args;
+  //! Cuda kernel function signature that is required to load the Cubin
+  std::string kernel_signature;
+  //! Compiled binary
+  std::vector<char> cubin;
+};
+
+//! KernelArtifactStore is the backend that a KernelDb falls back to when a
+//! kernel is missing from its local db, and that it publishes newly compiled
+//! kernels to. A store shared by every node of a job, or kept from a previous
+//! job, lets a kernel be compiled once for the whole cluster.
+//!
+//! Implementations must be safe to use from several processes at once. A
+//! fetch that races with a publish of the same key either fails or returns
+//! the complete artifact.
+class KernelArtifactStore {
+ public:
+  virtual ~KernelArtifactStore() = default;
+
+  //! Returns false if the store doesn't hold an artifact for the key
+  virtual bool fetch(const KernelDbKey& key, KernelArtifact& artifact) = 0;
+  //! Returns false if the artifact couldn't be stored
+  virtual bool publish(
+      const KernelDbKey& key,
+      const KernelArtifact& artifact) = 0;
+};
+
+//! Stores artifacts as content-addressed files in a directory, e.g., on a
+//! file system shared by all nodes. It uses the same file layout as the
+//! KernelDb entries, but has no index. The .txt file is written last, so an
+//! artifact is visible only once all of its files are in place.
+class DirectoryArtifactStore : public KernelArtifactStore {
+ public:
+  NVF_API explicit DirectoryArtifactStore(const std::string& directory);
+
+  const fs::path& directory() const {
+    return directory_;
+  }
+
+  NVF_API bool fetch(const KernelDbKey& key, KernelArtifact& artifact)
+      override;
+  NVF_API bool publish(const KernelDbKey& key, const KernelArtifact& artifact)
+      override;
+
+ private:
+  fs::path directory_;
+};
+
+} // namespace nvfuser
@@ -0,0 +1,232 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <iomanip>
+#include <memory>
+#include <sstream>
+
+#include <c10/util/irange.h>
+
+#include <exceptions.h>
+#include <instrumentation.h>
+#include <kernel_db/heuristic_snapshot.h>
+#include <kernel_db/utils.h>
+#include <options.h>
+
+namespace nvfuser {
+
+namespace {
+
+constexpr char kFieldSeparator = '\t';
+
+std::string header() {
+  return "nvfuser_heuristic_snapshot" + std::string(1, kFieldSeparator) +
+      std::to_string(HeuristicSnapshot::kFormatVersion) + "\n";
+}
+
+std::optional<SchedulerType> schedulerTypeFromString(const std::string& str) {
+  for (SchedulerType scheduler_type : all_heuristics_in_priority_order) {
+    if (toString(scheduler_type) == str) {
+      return scheduler_type;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<AutotuneKnob> knobFromString(const std::string& str) {
+  for (auto knob : c10::irange(kNumAutotuneKnobs)) {
+    if (str == toString((AutotuneKnob)knob)) {
+      return (AutotuneKnob)knob;
+    }
+  }
+  return std::nullopt;
+}
+
+} // namespace
+
+// Segments are separated by spaces, and the knobs scaled in a segment follow
+// its scheduler, e.g., "matmul_expr_eval=1 reduction:inner_unroll=1 pointwise"
+std::string TunedHeuristics::toString() const {
+  NVF_ERROR(scheduler_types.size() == autotune_variants.size());
+  std::stringstream ss;
+  ss << "matmul_expr_eval=" << (matmul_expr_eval ? 1 : 0);
+  for (auto group_id : c10::irange(scheduler_types.size())) {
+    ss << " " << nvfuser::toString(scheduler_types.at(group_id));
+    const AutotuneVariant& variant = autotune_variants.at(group_id);
+    bool first = true;
+    for (auto knob : c10::irange(kNumAutotuneKnobs)) {
+      if (variant.log2_scales.at(knob) == 0) {
+        continue;
+      }
+      ss << (first ? ":" : ",") << nvfuser::toString((AutotuneKnob)knob) << "="
+         << variant.log2_scales.at(knob);
+      first = false;
+    }
+  }
+  return ss.str();
+}
+
+std::optional<TunedHeuristics> TunedHeuristics::fromString(
+    const std::string& str) {
+  std::stringstream ss(str);
+  std::string token;
+  if (!(ss >> token) || (token != "matmul_expr_eval=0" &&
+                         token != "matmul_expr_eval=1")) {
+    return std::nullopt;
+  }
+  TunedHeuristics tuned;
+  tuned.matmul_expr_eval = token.back() == '1';
+  while (ss >> token) {
+    const size_t colon = token.find(':');
+    auto scheduler_type = schedulerTypeFromString(token.substr(0, colon));
+    if (!scheduler_type.has_value()) {
+      return std::nullopt;
+    }
+    AutotuneVariant variant;
+    if (colon != std::string::npos) {
+      std::stringstream knobs_ss(token.substr(colon + 1));
+      std::string knob_scale;
+      while (std::getline(knobs_ss, knob_scale, ',')) {
+        const size_t equal = knob_scale.find('=');
+        if (equal == std::string::npos) {
+          return std::nullopt;
+        }
+        auto knob = knobFromString(knob_scale.substr(0, equal));
+        if (!knob.has_value()) {
+          return std::nullopt;
+        }
+        try {
+          variant.log2_scales.at((size_t)knob.value()) =
+              std::stoll(knob_scale.substr(equal + 1));
+        } catch (const std::exception&) {
+          return std::nullopt;
+        }
+      }
+    }
+    tuned.scheduler_types.push_back(scheduler_type.value());
+    tuned.autotune_variants.push_back(variant);
+  }
+  return tuned;
+}
+
+HeuristicSnapshot::HeuristicSnapshot(const std::string& path) : path_(path) {
+  FUSER_PERF_SCOPE("HeuristicSnapshot::HeuristicSnapshot");
+  std::string contents;
+  if (!copy_from_text_file(path_.string(), contents) || contents.empty()) {
+    return;
+  }
+  if (contents.rfind(header(), 0) != 0) {
+    compatible_ = false;
+    TORCH_WARN(
+        "Heuristic snapshot: ",
+        path_.string(),
+        " is not a snapshot of format version ",
+        kFormatVersion,
+        ", so it is ignored");
+    return;
+  }
+  std::stringstream contents_ss(contents);
+  std::string line;
+  while (std::getline(contents_ss, line)) {
+    // Processes creating the file concurrently may each write the header,
+    // and a line may be truncated if a process died while appending it
+    std::stringstream line_ss(line);
+    std::string hash_field;
+    std::string inputs;
+    std::string tuned_field;
+    if (!std::getline(line_ss, hash_field, kFieldSeparator) ||
+        !std::getline(line_ss, inputs, kFieldSeparator) ||
+        !std::getline(line_ss, tuned_field)) {
+      continue;
+    }
+    uint64_t fusion_hash = 0;
+    try {
+      fusion_hash = std::stoull(hash_field, nullptr, 16);
+    } catch (const std::exception&) {
+      continue;
+    }
+    // Records of schedulers or knobs that were removed are dropped
+    auto tuned = TunedHeuristics::fromString(tuned_field);
+    if (tuned.has_value()) {
+      records_[key(fusion_hash, inputs)] = std::move(tuned.value());
+    }
+  }
+}
+
+HeuristicSnapshot& HeuristicSnapshot::get() {
+  static std::mutex mutex;
+  // Snapshots are never destroyed, so a reference stays valid if the options
+  // change, e.g., between tests
+  static std::unordered_map<std::string, std::unique_ptr<HeuristicSnapshot>>
+      snapshots;
+
+  std::string path =
+      (fs::temp_directory_path() / "nvfuser_heuristic_snapshot.tsv").string();
+  const auto& args = getEnableOptionArguments(EnableOption::HeuristicSnapshot);
+  if (!args.empty()) {
+    path = args.at(0);
+  }
+
+  std::lock_guard<std::mutex> guard(mutex);
+  auto& snapshot = snapshots[path];
+  if (snapshot == nullptr) {
+    snapshot = std::make_unique<HeuristicSnapshot>(path);
+  }
+  return *snapshot;
+}
+
+std::string HeuristicSnapshot::key(
+    uint64_t fusion_hash,
+    const std::string& inputs) {
+  std::stringstream ss;
+  ss << std::hex << std::setfill('0') << std::setw(16) << fusion_hash
+     << kFieldSeparator << inputs;
+  return ss.str();
+}
+
+std::optional<TunedHeuristics> HeuristicSnapshot::lookup(
+    uint64_t fusion_hash,
+    const std::string& inputs) const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = records_.find(key(fusion_hash, inputs));
+  if (it == records_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+bool HeuristicSnapshot::record(
+    uint64_t fusion_hash,
+    const std::string& inputs,
+    const TunedHeuristics& tuned) {
+  FUSER_PERF_SCOPE("HeuristicSnapshot::record");
+  NVF_ERROR(
+      inputs.find_first_of("\t\n") == std::string::npos,
+      "The input signature of a heuristic snapshot record can't hold tabs or "
+      "new lines: ",
+      inputs);
+  const std::string record_key = key(fusion_hash, inputs);
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (!compatible_) {
+    return false;
+  }
+  auto it = records_.find(record_key);
+  if (it != records_.end() && it->second == tuned) {
+    return true;
+  }
+  std::string line = record_key + kFieldSeparator + tuned.toString() + "\n";
+  if (!fs::exists(path_)) {
+    line = header() + line;
+  }
+  if (!append_to_text_file(path_.string(), line)) {
+    return false;
+  }
+  records_[record_key] = tuned;
+  return true;
+}
+
+} // namespace nvfuser
@@ -0,0 +1,102 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <kernel_db/kernel_db.h>
+#include <scheduler/autotune.h>
+#include <scheduler/scheduler_types.h>
+#include <visibility.h>
+
+namespace nvfuser {
+
+//! The choices of a FusionKernelRuntime that were tuned by timing rather than
+//! computed by the analytical heuristics
+struct TunedHeuristics {
+  //! False if matmuls were segmented for the Matmul scheduler instead of being
+  //! evaluated with ATen, see EnableOption::MatmulAutoSelect
+  bool matmul_expr_eval = true;
+  //! Scheduler of each segment, indexed by group id. The variants only apply
+  //! to a runtime segmented the same way.
+  std::vector<SchedulerType> scheduler_types;
+  //! Autotuned variant of each segment, indexed by group id
+  std::vector<AutotuneVariant> autotune_variants;
+
+  bool operator==(const TunedHeuristics& other) const {
+    return matmul_expr_eval == other.matmul_expr_eval &&
+        scheduler_types == other.scheduler_types &&
+        autotune_variants == other.autotune_variants;
+  }
+
+  //! Serializes the choices as a single line without tabs
+  std::string toString() const;
+  //! Returns std::nullopt if the string is badly formed or names a scheduler
+  //! or knob this version doesn't know
+  static std::optional<TunedHeuristics> fromString(const std::string& str);
+};
+
+//! HeuristicSnapshot is a sibling of KernelDb that keeps the tuned heuristics
+//! of fusions, keyed on the stable hash of the unscheduled fusion and the
+//! signature of its inputs. Unlike a serialized FusionCache, which holds
+//! cubins and is dropped by every new version of nvFuser, the snapshot only
+//! stores choices relative to the analytical heuristics, so a new version
+//! reuses them instead of timing the candidates again.
+//!
+//! The snapshot is a text file that starts with a header naming
+//! kFormatVersion, followed by one record per line. Records are appended in
+//! a single write, so several processes can share a snapshot, and the last
+//! record of a key wins.
+class HeuristicSnapshot {
+ public:
+  //! Only bumped when the format of the records changes, not with the version
+  //! of nvFuser
+  static constexpr int64_t kFormatVersion = 1;
+
+  //! Reads the records of the file at path, if it exists
+  NVF_API explicit HeuristicSnapshot(const std::string& path);
+
+  //! Thread-Safe method to get the snapshot of the process. It is used with
+  //! NVFUSER_ENABLE=heuristic_snapshot, optionally with the path of the file,
+  //! e.g., heuristic_snapshot(/shared/heuristics.tsv). The default is
+  //! nvfuser_heuristic_snapshot.tsv in the temp directory.
+  NVF_API static HeuristicSnapshot& get();
+
+  const fs::path& path() const {
+    return path_;
+  }
+
+  NVF_API std::optional<TunedHeuristics> lookup(
+      uint64_t fusion_hash,
+      const std::string& inputs) const;
+
+  //! Appends a record, unless the snapshot already holds the same choices for
+  //! the key. Returns false if the file can't be written or is in another
+  //! format.
+  NVF_API bool record(
+      uint64_t fusion_hash,
+      const std::string& inputs,
+      const TunedHeuristics& tuned);
+
+ private:
+  static std::string key(uint64_t fusion_hash, const std::string& inputs);
+
+  const fs::path path_;
+  //! False if the file exists but starts with another header, in which case
+  //! it is neither read nor written
+  bool compatible_ = true;
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, TunedHeuristics> records_;
+};
+
+} // namespace nvfuser
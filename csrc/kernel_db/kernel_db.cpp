@@ -5,11 +5,19 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
-#include <fstream>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <iomanip>
 #include <mutex>
-#include <regex>
+#include <sstream>
 
 #include <instrumentation.h>
+#include <kernel_db/artifact_store.h>
 #include <kernel_db/kernel_db.h>
 #include <kernel_db/utils.h>
 #include <options.h>
@@ -19,19 +27,112 @@ namespace nvfuser {
 
 static std::mutex kernel_db_lock;
 
+namespace {
+
+//! The index file starts with this magic string. It is bumped whenever the
+//! layout of the db changes so that stale dbs are reset instead of misread.
+constexpr char kIndexMagic[] = "NVFKDB01";
+constexpr size_t kIndexHeaderSize = sizeof(kIndexMagic) - 1;
+constexpr size_t kIndexRecordSize = sizeof(KernelDbKey);
+static_assert(kIndexRecordSize == 2 * sizeof(uint64_t));
+
+//! Retries write(2) until all bytes are written or an error occurs
+bool writeAll(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    auto written = ::write(fd, data, size);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += written;
+    size -= (size_t)written;
+  }
+  return true;
+}
+
+//! Holds an exclusive advisory lock on a file for the lifetime of the guard.
+//! flock is emulated with fcntl byte-range locks on NFS, so this also works
+//! for a db shared by several nodes.
+class FileLockGuard {
+ public:
+  explicit FileLockGuard(int fd) : fd_(fd) {
+    locked_ = ::flock(fd_, LOCK_EX) == 0;
+  }
+  ~FileLockGuard() {
+    if (locked_) {
+      ::flock(fd_, LOCK_UN);
+    }
+  }
+  bool locked() const {
+    return locked_;
+  }
+
+ private:
+  int fd_;
+  bool locked_ = false;
+};
+
+bool decompressCubin(
+    std::vector<char>& cubin,
+    const std::string& kernel_signature) {
+  if (decompress_blob(cubin)) {
+    return true;
+  }
+  TORCH_WARN(
+      "Kernel DB: Unable to decompress the cubin of ",
+      kernel_signature,
+      ". Reading compressed entries requires nvFuser built with "
+      "NVFUSER_BUILD_WITH_ZSTD.");
+  return false;
+}
+
+} // namespace
+
+std::string KernelDbKey::toString() const {
+  std::stringstream ss;
+  ss << std::hex << std::setfill('0') << std::setw(16) << code_hash << "_"
+     << std::setw(16) << args_hash;
+  return ss.str();
+}
+
 KernelDb::KernelDb(bool _disabled)
     : disabled_(_disabled),
       initialized_(false),
       kernel_map_(),
       kernel_db_path_(),
-      kernel_db_txt_file_() {}
+      kernel_db_index_file_() {}
+
+KernelDb::~KernelDb() {
+  close();
+}
 
 KernelDb& KernelDb::get() {
-  const std::string kernel_db_dir = "nvfuser_kernel_db";
-  const std::string kernel_db_file = "db.csv";
+  const std::string kernel_db_file = "index.bin";
+
+  // A user supplied directory is used as is, e.g. a directory on a shared
+  // file system. Otherwise, the db is placed in the temp directory.
+  if (isOptionEnabled(EnableOption::KernelDb) &&
+      !getEnableOptionArguments(EnableOption::KernelDb).empty()) {
+    const auto& args = getEnableOptionArguments(EnableOption::KernelDb);
+    auto& kernel_db = get(args.at(0), kernel_db_file, false, false, false);
+    if (args.size() > 1 && kernel_db.enabled() &&
+        !kernel_db.hasArtifactStore()) {
+      try {
+        kernel_db.setArtifactStore(
+            std::make_shared<DirectoryArtifactStore>(args.at(1)));
+      } catch (const std::exception& e) {
+        TORCH_WARN(
+            "nvFuser's kernel_db is unable to use the artifact store. Exception: ",
+            e.what());
+      }
+    }
+    return kernel_db;
+  }
 
   return get(
-      kernel_db_dir,
+      "nvfuser_kernel_db",
       kernel_db_file,
       true,
       !isOptionEnabled(EnableOption::KernelDb),
@@ -53,9 +154,10 @@ KernelDb& KernelDb::get(
   if (reset) {
     singleton.disabled_ = true;
     singleton.initialized_ = false;
-    singleton.kernel_map_.clear();
+    singleton.close();
     singleton.kernel_db_path_.clear();
-    singleton.kernel_db_txt_file_.clear();
+    singleton.kernel_db_index_file_.clear();
+    singleton.artifact_store_.reset();
   }
 
   singleton.disabled_ = disabled;
@@ -72,6 +174,7 @@ KernelDb& KernelDb::get(
           e.what());
     }
     if (!success) {
+      singleton.close();
       singleton.disabled_ = true;
     } else {
       singleton.initialized_ = true;
@@ -80,13 +183,25 @@ KernelDb& KernelDb::get(
   return singleton;
 }
 
+void KernelDb::close() {
+  if (index_map_ != nullptr) {
+    ::munmap(const_cast<char*>(index_map_), index_map_size_);
+  }
+  if (index_fd_ >= 0) {
+    ::close(index_fd_);
+  }
+  index_fd_ = -1;
+  index_map_ = nullptr;
+  index_map_size_ = 0;
+  index_consumed_size_ = 0;
+  kernel_map_.clear();
+}
+
 bool KernelDb::open(
     const std::string& kernel_db_dir,
     const std::string& kernel_db_file,
     bool use_temp_dir) {
   FUSER_PERF_SCOPE("KernelDb::open");
-  const std::string header(
-      "kernel_signature,compile_args,kernel_code_file,cubin_file");
 
   // The KernelDb directory is queried and created if it doesn't exist
   {
@@ -98,133 +213,237 @@ bool KernelDb::open(
     }
     if (!fs::is_directory(kernel_db_path_)) {
       try {
-        fs::create_directory(kernel_db_path_);
+        // Another process may create the directory concurrently
+        fs::create_directories(kernel_db_path_);
       } catch (const std::exception& e) {
-        TORCH_WARN(
-            "Unable to create nvFuser Kernel DB directory! ",
-            kernel_db_path_.string(),
-            e.what());
-        return false;
+        if (!fs::is_directory(kernel_db_path_)) {
+          TORCH_WARN(
+              "Unable to create nvFuser Kernel DB directory! ",
+              kernel_db_path_.string(),
+              e.what());
+          return false;
+        }
       }
     }
   }
 
-  // The CSV file that captures the db is read if it exists
+  // The index file is created if it doesn't exist. Its header is validated
+  // under the file lock so that only one process initializes or resets it.
   {
-    FUSER_PERF_SCOPE("KernelDb::open::read_db_txt_file");
-
-    kernel_db_txt_file_ = kernel_db_path_ / kernel_db_file;
-    if (fs::is_regular_file(kernel_db_txt_file_)) {
-      std::ifstream in_file(kernel_db_txt_file_.c_str(), std::ios::in);
-      if (in_file) {
-        bool matched_header = false;
-        bool read_db_file = true;
-        // kernel_signature
-        //  --- Group 1: any word character and dash
-        // compile_args
-        //  --- Group 2: any word character, space, plus, dash and equals
-        // kernel_code_file
-        //  --- Group 3: [any word character, dash and slash].cu
-        // cubin_file
-        //  --- Group 4: [any word character, dash and slash].cubin
-        std::regex db_line_regex(
-            R"(^([\w-]+),([\w \+\-\=]+),([\w\-\/]+\.cu),([\w\-\/]+\.cubin)$)");
-        for (std::string line; std::getline(in_file, line);) {
-          if (!matched_header) {
-            if (line.compare(header) == 0) {
-              matched_header = true;
-            } else {
-              // Header is corrupted or badly formed
-              TORCH_WARN(
-                  "Kernel DB: CSV file header is corrupted or badly formed - Resetting!: ",
-                  line);
-              read_db_file = false;
-              break;
-            }
-          } else {
-            std::smatch db_line_match;
-            if (std::regex_match(line, db_line_match, db_line_regex)) {
-              if (db_line_match.size() == 5) {
-                KernelDbEntry temp{
-                    db_line_match[1],
-                    db_line_match[2],
-                    db_line_match[3],
-                    db_line_match[4]};
-
-                fs::path code_path = kernel_db_path_ / temp.kernel_code_file;
-                std::string code;
-                if (copy_from_text_file(code_path.string(), code)) {
-                  kernel_map_[code] = temp;
-                } else {
-                  TORCH_WARN(
-                      "Kernel DB: Unable to copy cuda file: ",
-                      code_path.string());
-                }
-              }
-            } else {
-              TORCH_WARN("Kernel DB: CSV line Doesn't match: ", line);
-            }
+    FUSER_PERF_SCOPE("KernelDb::open::open_index_file");
+
+    kernel_db_index_file_ = kernel_db_path_ / kernel_db_file;
+    index_fd_ = ::open(kernel_db_index_file_.c_str(), O_RDWR | O_CREAT, 0644);
+    if (index_fd_ < 0) {
+      TORCH_WARN(
+          "Kernel DB: Unable to open index file: ",
+          kernel_db_index_file_.string());
+      return false;
+    }
+
+    FileLockGuard file_lock(index_fd_);
+    if (!file_lock.locked()) {
+      TORCH_WARN(
+          "Kernel DB: Unable to lock index file: ",
+          kernel_db_index_file_.string());
+      return false;
+    }
+
+    struct stat index_stat {};
+    if (::fstat(index_fd_, &index_stat) != 0) {
+      return false;
+    }
+    const auto index_size = (size_t)index_stat.st_size;
+
+    bool valid_header = false;
+    if (index_size >= kIndexHeaderSize) {
+      char header[kIndexHeaderSize];
+      valid_header = ::pread(index_fd_, header, kIndexHeaderSize, 0) ==
+              (ssize_t)kIndexHeaderSize &&
+          std::memcmp(header, kIndexMagic, kIndexHeaderSize) == 0;
+    }
+
+    if (!valid_header) {
+      if (index_size > 0) {
+        // Header is corrupted or belongs to an older layout
+        TORCH_WARN(
+            "Kernel DB: Index file header is corrupted or badly formed - Resetting!: ",
+            kernel_db_index_file_.string());
+      }
+
+      // Remove all entry files from the directory since they can no longer
+      // be reached through the index
+      for (const auto& dir_entry : fs::directory_iterator(kernel_db_path_)) {
+        const fs::path& path = dir_entry.path();
+        if (fs::is_regular_file(path) && path != kernel_db_index_file_) {
+          if (path.extension() == ".cubin" || path.extension() == ".cu" ||
+              path.extension() == ".txt" || path.extension() == ".csv") {
+            fs::remove(path);
           }
         }
-        if (read_db_file) {
-          return true;
-        }
+      }
+
+      if (::ftruncate(index_fd_, 0) != 0 ||
+          ::pwrite(index_fd_, kIndexMagic, kIndexHeaderSize, 0) !=
+              (ssize_t)kIndexHeaderSize) {
+        TORCH_WARN(
+            "Kernel DB: Unable to initialize index file: ",
+            kernel_db_index_file_.string());
+        return false;
       }
     }
   }
 
-  // If reading of the CSV file was successful, the rest of this method
-  // is skipped
+  index_consumed_size_ = kIndexHeaderSize;
+  return refreshIndex();
+}
 
-  // Remove all files from directory if valid db txt file was not found
-  for (const auto& dir_entry : fs::directory_iterator(kernel_db_path_)) {
-    const fs::path& path = dir_entry.path();
-    if (fs::is_regular_file(path)) {
-      if (path.extension() == ".cubin" || path.extension() == ".cu" ||
-          path.extension() == ".csv") {
-        fs::remove(path);
-      }
-    }
+bool KernelDb::refreshIndex() const {
+  FUSER_PERF_SCOPE("KernelDb::refreshIndex");
+  struct stat index_stat {};
+  if (::fstat(index_fd_, &index_stat) != 0) {
+    return false;
+  }
+  // Only complete records are consumed. A record that is being appended by
+  // another process is picked up by a later refresh.
+  const auto index_size = (size_t)index_stat.st_size;
+  const auto usable_size = kIndexHeaderSize +
+      (index_size - std::min(index_size, kIndexHeaderSize)) /
+          kIndexRecordSize * kIndexRecordSize;
+  if (usable_size <= index_consumed_size_) {
+    return true;
   }
 
-  // Create an empty db csv file
-  {
-    FUSER_PERF_SCOPE("KernelDb::open::create_db_txt_file");
+  if (index_map_ != nullptr) {
+    ::munmap(const_cast<char*>(index_map_), index_map_size_);
+    index_map_ = nullptr;
+    index_map_size_ = 0;
+  }
+  void* map = ::mmap(nullptr, usable_size, PROT_READ, MAP_SHARED, index_fd_, 0);
+  if (map == MAP_FAILED) {
+    return false;
+  }
+  index_map_ = static_cast<const char*>(map);
+  index_map_size_ = usable_size;
+
+  for (; index_consumed_size_ < usable_size;
+       index_consumed_size_ += kIndexRecordSize) {
+    KernelDbKey key;
+    std::memcpy(&key, index_map_ + index_consumed_size_, kIndexRecordSize);
+    const auto base_name = key.toString();
+    kernel_map_[key] =
+        KernelDbEntry{"", "", base_name + ".cu", base_name + ".cubin"};
+  }
+  return true;
+}
 
-    if (copy_to_text_file(kernel_db_txt_file_, header + "\n")) {
-      return true;
-    }
+bool KernelDb::appendToIndex(const KernelDbKey& key) {
+  FileLockGuard file_lock(index_fd_);
+  if (!file_lock.locked()) {
+    return false;
   }
-  return false;
+  // Another process may have added the same entry while we were compiling
+  if (!refreshIndex()) {
+    return false;
+  }
+  if (kernel_map_.count(key) > 0) {
+    return true;
+  }
+  // Records are only ever appended at a record boundary, which drops a
+  // truncated record left behind by a process that died mid-append.
+  if (::lseek(index_fd_, (off_t)index_consumed_size_, SEEK_SET) < 0 ||
+      ::ftruncate(index_fd_, (off_t)index_consumed_size_) != 0 ||
+      !writeAll(
+          index_fd_, reinterpret_cast<const char*>(&key), kIndexRecordSize)) {
+    return false;
+  }
+  return refreshIndex();
 }
 
 bool KernelDb::query(
     const std::string& kernel_code,
     const std::string& compile_args,
     std::string& kernel_signature,
-    std::vector<char>& cubin) const {
+    std::vector<char>& cubin) {
   FUSER_PERF_SCOPE("KernelDb::query");
-  bool status = false;
-  auto db_entry = kernel_map_.find(kernel_code);
-
-  // Kernel Match is found
-  if (db_entry != kernel_map_.end()) {
-    // Make sure the compilation args also match
-    if (db_entry->second.compile_args == compile_args) {
-      // Copy the cubin to a data buffer and record the kernel name for module
-      // loading
-      fs::path cubin_file_path = kernel_db_path_ / db_entry->second.cubin_file;
-      if (copy_from_binary_file(cubin_file_path.string(), cubin)) {
-        kernel_signature = db_entry->second.kernel_signature;
-        status = true;
-      }
+  std::lock_guard<std::mutex> guard(kernel_db_lock);
+
+  const KernelDbKey key{stable_hash(kernel_code), stable_hash(compile_args)};
+  auto db_entry = kernel_map_.find(key);
+
+  // Pick up entries written by other processes since the last lookup
+  if (db_entry == kernel_map_.end() && refreshIndex()) {
+    db_entry = kernel_map_.find(key);
+  }
+  if (db_entry == kernel_map_.end()) {
+    if (artifact_store_ == nullptr) {
+      return false;
     }
+    // Another node may have compiled the kernel already
+    KernelArtifact artifact;
+    if (!artifact_store_->fetch(key, artifact) ||
+        artifact.compile_args != compile_args ||
+        artifact.kernel_code != kernel_code) {
+      return false;
+    }
+    if (!writeEntry(
+            key,
+            kernel_code,
+            compile_args,
+            artifact.kernel_signature,
+            artifact.cubin)) {
+      TORCH_WARN(
+          "Kernel DB: Unable to add a fetched kernel to the local db: ",
+          artifact.kernel_signature);
+    }
+    kernel_signature = std::move(artifact.kernel_signature);
+    cubin = std::move(artifact.cubin);
+    return decompressCubin(cubin, kernel_signature);
   }
-  return status;
+
+  // The signature and compile args are loaded lazily on the first hit
+  auto& entry = db_entry->second;
+  if (entry.kernel_signature.empty()) {
+    std::string meta;
+    fs::path meta_file_path = kernel_db_path_ / (key.toString() + ".txt");
+    if (!copy_from_text_file(meta_file_path.string(), meta)) {
+      return false;
+    }
+    std::stringstream meta_ss(meta);
+    std::string signature;
+    std::string args;
+    if (!std::getline(meta_ss, signature) || !std::getline(meta_ss, args)) {
+      TORCH_WARN("Kernel DB: Badly formed entry: ", meta_file_path.string());
+      return false;
+    }
+    entry.kernel_signature = signature;
+    entry.compile_args = args;
+  }
+
+  // Make sure the compilation args and the kernel also match. A mismatch can
+  // only happen on a hash collision.
+  if (entry.compile_args != compile_args) {
+    return false;
+  }
+  std::string code;
+  fs::path code_file_path = kernel_db_path_ / entry.kernel_code_file;
+  if (!copy_from_text_file(code_file_path.string(), code) ||
+      code != kernel_code) {
+    return false;
+  }
+
+  // Copy the cubin to a data buffer and record the kernel name for module
+  // loading
+  fs::path cubin_file_path = kernel_db_path_ / entry.cubin_file;
+  if (!copy_from_binary_file(cubin_file_path.string(), cubin)) {
+    return false;
+  }
+  kernel_signature = entry.kernel_signature;
+  return decompressCubin(cubin, kernel_signature);
 }
 
-// This method will write a cubin and the kernel code to files as well as add
-// an entry to the db csv file.
+// This method will write a cubin, the kernel code and the entry metadata to
+// content-addressed files and then publish the entry through the index file.
 bool KernelDb::write(
     const std::string& kernel_code,
     const std::string& compile_args,
@@ -233,51 +452,77 @@ bool KernelDb::write(
   FUSER_PERF_SCOPE("KernelDb::write");
   std::lock_guard<std::mutex> guard(kernel_db_lock);
 
+  const KernelDbKey key{stable_hash(kernel_code), stable_hash(compile_args)};
+
   // Short-circuit path if kernel already exist in database.
   // Only return false if it does not already exist in the database and we fail
   // to add kernel to database.
-  if (kernel_map_.count(kernel_code) > 0) {
+  if (kernel_map_.count(key) > 0) {
     return true;
   }
 
-  // If the kernel doesn't already exist in the hash map, add it.
-  // The cubin and kernel code files are given a unique number based on the
-  // size of the hash map.
-  std::string kernel_num =
-      std::to_string(static_cast<unsigned long>(kernel_map_.size()));
-
-  // Kernel Code File path
-  std::string code_file_name("kernel_" + kernel_num + ".cu");
-  fs::path code_file_path = kernel_db_path_ / code_file_name;
-
-  // Cubin File path
-  std::string cubin_file_name("kernel_" + kernel_num + ".cubin");
-  fs::path cubin_file_path = kernel_db_path_ / cubin_file_name;
-
-  // Copy kernel code to file
-  bool status = copy_to_text_file(code_file_path.string(), kernel_code);
+  // Entries are stored as written, so that compressed and uncompressed
+  // entries coexist in the same db and artifact store
+  const std::vector<char> stored_cubin =
+      isOptionEnabled(EnableOption::CompressKernelBinaries)
+      ? compress_blob(cubin)
+      : cubin;
+  if (!writeEntry(
+          key, kernel_code, compile_args, kernel_signature, stored_cubin)) {
+    return false;
+  }
+  if (artifact_store_ != nullptr &&
+      !artifact_store_->publish(
+          key,
+          KernelArtifact{
+              kernel_code, compile_args, kernel_signature, stored_cubin})) {
+    TORCH_WARN(
+        "Kernel DB: Unable to publish kernel to the artifact store: ",
+        kernel_signature);
+  }
+  return true;
+}
 
-  // If the kernel code copy was successful, copy the cubin to file
+bool KernelDb::writeEntry(
+    const KernelDbKey& key,
+    const std::string& kernel_code,
+    const std::string& compile_args,
+    const std::string& kernel_signature,
+    const std::vector<char>& cubin) {
+  const std::string base_name = key.toString();
+  fs::path code_file_path = kernel_db_path_ / (base_name + ".cu");
+  fs::path cubin_file_path = kernel_db_path_ / (base_name + ".cubin");
+  fs::path meta_file_path = kernel_db_path_ / (base_name + ".txt");
+  const std::string meta = kernel_signature + "\n" + compile_args + "\n";
+
+  // Every file is fully written before it appears under its final name, and
+  // the index record is only appended after all files are in place, so a
+  // concurrent reader never observes a partial entry. If another process
+  // writes the same entry concurrently, both write identical contents.
+  bool status = atomic_copy_to_file(
+      code_file_path.string(), kernel_code.data(), kernel_code.size());
   if (status) {
-    status = copy_to_binary_file(cubin_file_path.string(), cubin);
+    status = atomic_copy_to_file(
+        cubin_file_path.string(), cubin.data(), cubin.size());
   }
-
-  // If both files were created successfully, add an entry to the CSV file
   if (status) {
-    std::string entry(kernel_signature);
-    entry += "," + compile_args + "," + code_file_name + "," + cubin_file_name +
-        "\n";
-    status = append_to_text_file(kernel_db_txt_file_.string(), entry);
+    status =
+        atomic_copy_to_file(meta_file_path.string(), meta.data(), meta.size());
   }
-
-  // If writing both files and adding an entry the CSV file was successful,
-  // finally add an entry to the Kernel DB
   if (status) {
-    KernelDbEntry tmp{
-        kernel_signature, compile_args, code_file_name, cubin_file_name};
-    kernel_map_[kernel_code] = tmp;
+    status = appendToIndex(key);
   }
   return status;
 }
 
+void KernelDb::setArtifactStore(std::shared_ptr<KernelArtifactStore> store) {
+  std::lock_guard<std::mutex> guard(kernel_db_lock);
+  artifact_store_ = std::move(store);
+}
+
+bool KernelDb::hasArtifactStore() const {
+  std::lock_guard<std::mutex> guard(kernel_db_lock);
+  return artifact_store_ != nullptr;
+}
+
 } // namespace nvfuser
@@ -17,6 +17,9 @@ namespace fs = std::experimental::filesystem;
 #error "C++14 or Higher is required for filesystem library!"
 #endif
 
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -24,23 +27,65 @@ namespace fs = std::experimental::filesystem;
 
 namespace nvfuser {
 
-//! KernelDbEntry captures information to be printed per fusion in a csv file
-//! that is used to restore a hash map
+class KernelArtifactStore;
+
+//! KernelDbKey is the content address of an entry.  Compile args carry the
+//! target architecture and every CompileParams derived NVRTC option (e.g.,
+//! maxrregcount), so hashing them together with the kernel code uniquely
+//! identifies a compiled binary.
+struct KernelDbKey {
+  uint64_t code_hash = 0;
+  uint64_t args_hash = 0;
+
+  bool operator==(const KernelDbKey& other) const {
+    return code_hash == other.code_hash && args_hash == other.args_hash;
+  }
+
+  //! Hex string used as the base name of the entry's files
+  std::string toString() const;
+};
+
+struct KernelDbKeyHash {
+  size_t operator()(const KernelDbKey& key) const {
+    return static_cast<size_t>(key.code_hash ^ (key.args_hash << 1));
+  }
+};
+
+//! KernelDbEntry captures the files that make up a single entry of the db.
+//! All files are named after the KernelDbKey of the entry.
 struct KernelDbEntry {
   //! Cuda kernel function signature that is required to load the Cubin
   std::string kernel_signature;
   //! Compilation args supplied to NVRTC -- register usage and compute
   //! capability can be specific to a kernel instance
   std::string compile_args;
-  //! Full file path to Cuda Kernel
+  //! File name of the Cuda Kernel, kept to guard against hash collisions
   std::string kernel_code_file;
-  //! Full file path to cubin
+  //! File name of the cubin
   std::string cubin_file;
 };
 
 //! KernelDb class is a singleton structure that is used to open, query, and
-//! write to the the database that is held in a hash map.  The kernel code is
-//! used as string key to the hash map.
+//! write to a content-addressed, on-disk database of compiled kernels.
+//!
+//! Every entry is stored as a set of files named after its KernelDbKey:
+//!   <key>.cu    -- kernel code, compared on query to rule out collisions
+//!   <key>.cubin -- compiled binary
+//!   <key>.txt   -- kernel signature and compile args
+//! Each file is written to a temporary file and atomically renamed into place,
+//! so the store can be shared by every process on a node, or by several nodes
+//! through a shared directory.
+//!
+//! An index file holds a magic header followed by fixed-width KernelDbKey
+//! records. It is memory-mapped by every process and appended to, under an
+//! exclusive file lock, only after all files of an entry are in place. When a
+//! query misses, the mapping is refreshed to pick up entries that other
+//! processes have written since the last lookup.
+//!
+//! A KernelArtifactStore can back the db, e.g., a directory shared by every
+//! node of a job. A query that misses the local db fetches the kernel from the
+//! store and adds it to the local db, and new kernels are published to the
+//! store, so a kernel is only compiled once for the whole cluster.
 class KernelDb {
   KernelDb(bool _disabled);
 
@@ -51,12 +96,37 @@ class KernelDb {
       const std::string& kernel_db_file,
       bool use_temp_dir);
 
+  //! Unmaps and closes the index file and clears the in-memory map
+  void close();
+
+  //! Maps any records appended to the index file since the last refresh.
+  //! Returns false if the index file can no longer be read.
+  bool refreshIndex() const;
+
+  //! Appends a record to the index file unless another process already did
+  bool appendToIndex(const KernelDbKey& key);
+
+  //! Writes the files of a new entry and publishes it through the index file.
+  //! kernel_db_lock must be held.
+  bool writeEntry(
+      const KernelDbKey& key,
+      const std::string& kernel_code,
+      const std::string& compile_args,
+      const std::string& kernel_signature,
+      const std::vector<char>& cubin);
+
  public:
   // clang-tidy - deleted member function should be public
   KernelDb(const KernelDb&) = delete;
   KernelDb& operator=(const KernelDb&) = delete;
+  ~KernelDb();
 
   //! Thread-Safe method to get the Meyer's singleton -- Interface
+  //!
+  //! The db lives in a temporary directory unless a directory is given as an
+  //! argument, e.g., NVFUSER_ENABLE=kernel_db(/shared/nvfuser_kernel_db). A
+  //! second argument is the directory of a DirectoryArtifactStore backing the
+  //! db, e.g., NVFUSER_ENABLE=kernel_db(/tmp/kernel_db,/shared/artifacts)
   static KernelDb& get();
   //! Thread-Safe method to get the Meyer's singleton -- For testing
   NVF_API static KernelDb& get(
@@ -70,40 +140,58 @@ class KernelDb {
   bool enabled() const {
     return !disabled_ && initialized_;
   }
-  //! Returns the number entries in the db
+  //! Returns the number entries in the db known to this process
   size_t size() const {
     return kernel_map_.size();
   }
 
-  //! Query uses the string of the kernel code to lookup whether a cubin already
-  //! exists for the given kernel.  Additionally, the compile args are also
-  //! matched.
+  //! Query uses the hash of the kernel code and compile args to lookup whether
+  //! a cubin already exists for the given kernel.  The stored kernel code and
+  //! compile args are also compared to rule out hash collisions. On a miss,
+  //! the kernel is fetched from the artifact store if there is one.
   NVF_API bool query(
       const std::string& kernel_code,
       const std::string& compile_args,
       std::string& kernel_signature,
-      std::vector<char>& cubin) const;
+      std::vector<char>& cubin);
   //! Write is used to write a new entry to the db upon compilation of a
-  //! new fusion
+  //! new fusion. The entry is also published to the artifact store.
   NVF_API bool write(
       const std::string& kernel_code,
       const std::string& compile_args,
       const std::string& kernel_signature,
       const std::vector<char>& cubin);
 
+  //! Thread-Safe: Backs the db with a store, or detaches the store if null
+  NVF_API void setArtifactStore(std::shared_ptr<KernelArtifactStore> store);
+  NVF_API bool hasArtifactStore() const;
+
  private:
   //! Disablement is specified by the user and can also be set by a
   //! failure to open the db
   bool disabled_ = true;
   //! Db is only initialized after it is successfully open
   bool initialized_ = false;
-  //! Hash Map of kernel_string -> db_entry
-  std::unordered_map<std::string, KernelDbEntry> kernel_map_;
+  //! Hash Map of key -> db_entry for every record mapped from the index
+  mutable std::unordered_map<KernelDbKey, KernelDbEntry, KernelDbKeyHash>
+      kernel_map_;
 
   //! Full path to the db directory
   fs::path kernel_db_path_;
-  //! Full path to csv file used to record and restore the db
-  fs::path kernel_db_txt_file_;
+  //! Full path to the index file shared by all processes
+  fs::path kernel_db_index_file_;
+
+  //! File descriptor of the index file
+  int index_fd_ = -1;
+  //! Read-only mapping of the index file
+  mutable const char* index_map_ = nullptr;
+  //! Number of bytes currently mapped
+  mutable size_t index_map_size_ = 0;
+  //! Number of bytes of the mapping that have been added to kernel_map_
+  mutable size_t index_consumed_size_ = 0;
+
+  //! Optional store shared with other processes and nodes
+  std::shared_ptr<KernelArtifactStore> artifact_store_;
 };
 
 } // namespace nvfuser
@@ -0,0 +1,255 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <algorithm>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+#include <c10/util/irange.h>
+
+#include <exceptions.h>
+#include <instrumentation.h>
+#include <kernel_db/perf_db.h>
+#include <kernel_db/utils.h>
+#include <options.h>
+
+namespace nvfuser {
+
+namespace {
+
+constexpr char kFieldSeparator = '\t';
+constexpr size_t kNumFields = 9;
+
+//! Fields can't hold the field or line separators, so both are replaced by
+//! spaces, and runs of spaces are collapsed.
+std::string sanitize(const std::string& field) {
+  std::string result;
+  result.reserve(field.size());
+  for (char c : field) {
+    if (c == kFieldSeparator || c == '\n' || c == '\r') {
+      c = ' ';
+    }
+    if (c == ' ' && (result.empty() || result.back() == ' ')) {
+      continue;
+    }
+    result.push_back(c);
+  }
+  while (!result.empty() && result.back() == ' ') {
+    result.pop_back();
+  }
+  return result;
+}
+
+double median(std::vector<double> values) {
+  NVF_ERROR(!values.empty());
+  auto mid = values.begin() + (int64_t)(values.size() / 2);
+  std::nth_element(values.begin(), mid, values.end());
+  return *mid;
+}
+
+//! Summarizes the records of a run by kernel: the median time, the largest
+//! register count, and the heuristic params of the last record
+std::vector<KernelPerfRecord> summarize(
+    const std::vector<KernelPerfRecord>& records) {
+  std::vector<KernelPerfRecord> summaries;
+  std::vector<std::vector<double>> times;
+  for (const auto& record : records) {
+    auto it = std::find_if(
+        summaries.begin(), summaries.end(), [&](const auto& summary) {
+          return summary.sameKey(record);
+        });
+    if (it == summaries.end()) {
+      summaries.push_back(record);
+      times.emplace_back();
+      it = summaries.end() - 1;
+    }
+    it->kernel_name = record.kernel_name;
+    it->scheduler = record.scheduler;
+    it->heuristic_params = record.heuristic_params;
+    it->registers = std::max(it->registers, record.registers);
+    times.at(std::distance(summaries.begin(), it)).push_back(record.time_ms);
+  }
+  for (auto i : c10::irange(summaries.size())) {
+    summaries[i].time_ms = median(times[i]);
+  }
+  return summaries;
+}
+
+} // namespace
+
+std::string KernelPerfRecord::toLine() const {
+  std::stringstream ss;
+  ss << std::hex << std::setfill('0') << std::setw(16) << fusion_hash
+     << std::dec << kFieldSeparator << segment << kFieldSeparator
+     << sanitize(gpu) << kFieldSeparator << sanitize(inputs) << kFieldSeparator
+     << sanitize(kernel_name) << kFieldSeparator << sanitize(scheduler)
+     << kFieldSeparator << sanitize(heuristic_params) << kFieldSeparator
+     << registers << kFieldSeparator << std::setprecision(9) << time_ms
+     << "\n";
+  return ss.str();
+}
+
+bool KernelPerfRecord::fromLine(
+    const std::string& line,
+    KernelPerfRecord& record) {
+  std::vector<std::string> fields;
+  std::stringstream line_ss(line);
+  std::string field;
+  while (std::getline(line_ss, field, kFieldSeparator)) {
+    fields.push_back(field);
+  }
+  if (fields.size() != kNumFields) {
+    return false;
+  }
+  try {
+    record.fusion_hash = std::stoull(fields[0], nullptr, 16);
+    record.segment = std::stoll(fields[1]);
+    record.gpu = fields[2];
+    record.inputs = fields[3];
+    record.kernel_name = fields[4];
+    record.scheduler = fields[5];
+    record.heuristic_params = fields[6];
+    record.registers = std::stoll(fields[7]);
+    record.time_ms = std::stod(fields[8]);
+  } catch (const std::exception&) {
+    return false;
+  }
+  return true;
+}
+
+std::string KernelPerfRegression::toString() const {
+  std::stringstream ss;
+  ss << candidate.kernel_name << " (" << candidate.scheduler << ", fusion "
+     << std::hex << std::setfill('0') << std::setw(16) << candidate.fusion_hash
+     << std::dec << " segment " << candidate.segment << ", "
+     << candidate.inputs << ")";
+  if (time_regressed) {
+    ss << std::fixed << std::setprecision(4) << " time " << baseline.time_ms
+       << " ms -> " << candidate.time_ms << " ms (" << std::setprecision(2)
+       << timeRatio() << "x)";
+  }
+  if (registers_regressed) {
+    ss << " registers " << baseline.registers << " -> " << candidate.registers;
+  }
+  if (baseline.heuristic_params != candidate.heuristic_params) {
+    ss << "\n  baseline params: " << baseline.heuristic_params
+       << "\n  candidate params: " << candidate.heuristic_params;
+  }
+  return ss.str();
+}
+
+KernelPerfDb::KernelPerfDb(const std::string& directory, const std::string& run)
+    : directory_(directory), run_(sanitize(run)) {
+  NVF_CHECK(!run_.empty(), "The run of a kernel perf db needs a label");
+  if (!fs::is_directory(directory_)) {
+    try {
+      // Another process may create the directory concurrently
+      fs::create_directories(directory_);
+    } catch (const std::exception& e) {
+      NVF_CHECK(
+          fs::is_directory(directory_),
+          "Unable to create nvFuser kernel perf db directory! ",
+          directory_.string(),
+          e.what());
+    }
+  }
+}
+
+KernelPerfDb& KernelPerfDb::get() {
+  static std::mutex mutex;
+  // Dbs are never destroyed, so a reference stays valid if the options
+  // change, e.g., between tests
+  static std::unordered_map<std::string, std::unique_ptr<KernelPerfDb>> dbs;
+
+  std::string directory =
+      (fs::temp_directory_path() / "nvfuser_kernel_perf_db").string();
+  std::string run = "default";
+  const auto& args = getEnableOptionArguments(EnableOption::KernelPerfDb);
+  if (!args.empty()) {
+    directory = args.at(0);
+  }
+  if (args.size() > 1) {
+    run = args.at(1);
+  }
+
+  std::lock_guard<std::mutex> guard(mutex);
+  auto& db = dbs[directory + kFieldSeparator + run];
+  if (db == nullptr) {
+    db = std::make_unique<KernelPerfDb>(directory, run);
+  }
+  return *db;
+}
+
+fs::path KernelPerfDb::runFile(const std::string& run) const {
+  return directory_ / (sanitize(run) + ".tsv");
+}
+
+bool KernelPerfDb::record(const KernelPerfRecord& record) const {
+  FUSER_PERF_SCOPE("KernelPerfDb::record");
+  return append_to_text_file(runFile(run_).string(), record.toLine());
+}
+
+std::vector<KernelPerfRecord> KernelPerfDb::load(const std::string& run) const {
+  FUSER_PERF_SCOPE("KernelPerfDb::load");
+  std::vector<KernelPerfRecord> records;
+  std::string contents;
+  if (!copy_from_text_file(runFile(run).string(), contents)) {
+    return records;
+  }
+  std::stringstream contents_ss(contents);
+  std::string line;
+  while (std::getline(contents_ss, line)) {
+    // A line may be truncated if a process died while appending it
+    KernelPerfRecord record;
+    if (KernelPerfRecord::fromLine(line, record)) {
+      records.push_back(std::move(record));
+    }
+  }
+  return records;
+}
+
+std::vector<KernelPerfRegression> KernelPerfDb::findRegressions(
+    const std::string& baseline_run,
+    const std::string& candidate_run,
+    double time_tolerance,
+    int64_t register_tolerance) const {
+  FUSER_PERF_SCOPE("KernelPerfDb::findRegressions");
+  const auto baselines = summarize(load(baseline_run));
+  const auto candidates = summarize(load(candidate_run));
+
+  std::vector<KernelPerfRegression> regressions;
+  for (const auto& candidate : candidates) {
+    auto baseline = std::find_if(
+        baselines.begin(), baselines.end(), [&](const auto& summary) {
+          return summary.sameKey(candidate);
+        });
+    // Kernels that only one of the runs launched can't be compared
+    if (baseline == baselines.end()) {
+      continue;
+    }
+    KernelPerfRegression regression{*baseline, candidate};
+    regression.time_regressed =
+        candidate.time_ms > baseline->time_ms * (1.0 + time_tolerance);
+    regression.registers_regressed = baseline->registers >= 0 &&
+        candidate.registers > baseline->registers + register_tolerance;
+    if (regression.time_regressed || regression.registers_regressed) {
+      regressions.push_back(std::move(regression));
+    }
+  }
+  std::stable_sort(
+      regressions.begin(),
+      regressions.end(),
+      [](const auto& a, const auto& b) {
+        return a.timeRatio() > b.timeRatio();
+      });
+  return regressions;
+}
+
+} // namespace nvfuser
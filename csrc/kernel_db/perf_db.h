@@ -0,0 +1,114 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <kernel_db/kernel_db.h>
+#include <visibility.h>
+
+namespace nvfuser {
+
+//! KernelPerfRecord is one measurement of a kernel. Records are matched
+//! across runs by fusion hash, segment, GPU, and input shapes, while the
+//! remaining fields are what is compared.
+struct KernelPerfRecord {
+  //! Stable hash of the unscheduled complete fusion
+  uint64_t fusion_hash = 0;
+  //! Segment of the fusion the kernel was compiled for
+  int64_t segment = 0;
+  //! Name and compute capability of the GPU, e.g., "NVIDIA H100 (sm_90)"
+  std::string gpu;
+  //! Sizes and dtypes of the segment inputs
+  std::string inputs;
+  std::string kernel_name;
+  std::string scheduler;
+  //! HeuristicParams::toString() collapsed to a single line
+  std::string heuristic_params;
+  int64_t registers = -1;
+  double time_ms = 0.0;
+
+  //! Serializes the record as a line of tab separated fields
+  std::string toLine() const;
+  //! Returns false if the line is badly formed
+  static bool fromLine(const std::string& line, KernelPerfRecord& record);
+
+  //! Whether both records measure the same kernel in the same conditions
+  bool sameKey(const KernelPerfRecord& other) const {
+    return fusion_hash == other.fusion_hash && segment == other.segment &&
+        gpu == other.gpu && inputs == other.inputs;
+  }
+};
+
+//! A kernel whose runtime or register count got worse from the baseline run
+//! to the candidate run. Times are the medians of the records of each run.
+struct KernelPerfRegression {
+  KernelPerfRecord baseline;
+  KernelPerfRecord candidate;
+  bool time_regressed = false;
+  bool registers_regressed = false;
+
+  double timeRatio() const {
+    return baseline.time_ms > 0.0 ? candidate.time_ms / baseline.time_ms : 0.0;
+  }
+
+  std::string toString() const;
+};
+
+//! KernelPerfDb is a sibling of KernelDb that records measured kernel times,
+//! heuristic params, and register counts keyed on fusion and GPU, so that
+//! runs of different nvFuser versions can be compared to catch performance
+//! regressions.
+//!
+//! Each run has a label, e.g., the nvFuser version, and appends its records
+//! to <directory>/<run>.tsv, one line per kernel launch. Lines are appended
+//! in a single write, so several processes can record the same run. The
+//! files are also read by tools/kernel_perf_db.py.
+class KernelPerfDb {
+ public:
+  NVF_API KernelPerfDb(const std::string& directory, const std::string& run);
+
+  //! Thread-Safe method to get the db of the process. Recording is enabled by
+  //! NVFUSER_ENABLE=kernel_perf_db, optionally with the directory and the
+  //! label of the run, e.g., kernel_perf_db(/shared/perf_db,v0.2.23). The
+  //! default is nvfuser_kernel_perf_db in the temp directory and the "default"
+  //! run.
+  NVF_API static KernelPerfDb& get();
+
+  const fs::path& directory() const {
+    return directory_;
+  }
+  const std::string& run() const {
+    return run_;
+  }
+
+  //! Appends a record to the file of the run
+  NVF_API bool record(const KernelPerfRecord& record) const;
+  //! Returns every record of a run, skipping badly formed lines
+  NVF_API std::vector<KernelPerfRecord> load(const std::string& run) const;
+
+  //! Compares the kernels recorded by both runs. A kernel regressed if its
+  //! median time grew by more than time_tolerance, relative to the baseline,
+  //! or if it uses more than register_tolerance more registers. Regressions
+  //! are sorted from the largest time ratio.
+  NVF_API std::vector<KernelPerfRegression> findRegressions(
+      const std::string& baseline_run,
+      const std::string& candidate_run,
+      double time_tolerance = 0.05,
+      int64_t register_tolerance = 0) const;
+
+ private:
+  fs::path runFile(const std::string& run) const;
+
+  fs::path directory_;
+  std::string run_;
+};
+
+} // namespace nvfuser
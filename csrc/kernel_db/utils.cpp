@@ -6,10 +6,41 @@
  */
 // clang-format on
 #include <kernel_db/utils.h>
+
+#include <unistd.h>
+#include <array>
+#include <atomic>
+#include <cstdio>
 #include <fstream>
+#include <functional>
+#include <thread>
+#include <utility>
+
+#ifdef NVFUSER_BUILD_WITH_ZSTD
+#include <zstd.h>
+#endif
 
 namespace nvfuser {
 
+namespace {
+
+// Cubins start with the ELF magic and PTX is text, so neither can be mistaken
+// for a zstd frame
+bool is_zstd_frame(const std::vector<char>& blob) {
+  constexpr std::array<uint8_t, 4> zstd_magic = {0x28, 0xb5, 0x2f, 0xfd};
+  if (blob.size() < zstd_magic.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < zstd_magic.size(); ++i) {
+    if (static_cast<uint8_t>(blob[i]) != zstd_magic[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
 bool append_to_text_file(const std::string& file_path, const std::string& src) {
   bool status = false;
   std::ofstream file(file_path, std::ios::app | std::ios::binary);
@@ -76,4 +107,97 @@ bool copy_to_text_file(const std::string& file_path, const std::string& src) {
   return status;
 }
 
+bool atomic_copy_to_file(
+    const std::string& file_path,
+    const char* src,
+    size_t size) {
+  // The temporary name has to be unique across processes and threads so that
+  // concurrent writers of the same entry never clobber each other's partially
+  // written files.
+  static std::atomic<uint64_t> counter{0};
+  const std::string tmp_path = file_path + ".tmp." +
+      std::to_string(static_cast<long>(getpid())) + "." +
+      std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) +
+      "." + std::to_string(counter++);
+  {
+    std::ofstream file(tmp_path, std::ios::out | std::ios::binary);
+    if (!file) {
+      return false;
+    }
+    file.write(src, (std::streamsize)size);
+    file.close();
+    if (!file) {
+      std::remove(tmp_path.c_str());
+      return false;
+    }
+  }
+  // rename(2) atomically replaces the destination on POSIX file systems
+  if (std::rename(tmp_path.c_str(), file_path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+uint64_t stable_hash(const std::string& src) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (const char c : src) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+bool is_blob_compression_available() {
+#ifdef NVFUSER_BUILD_WITH_ZSTD
+  return true;
+#else
+  return false;
+#endif
+}
+
+std::vector<char> compress_blob(const std::vector<char>& src) {
+#ifdef NVFUSER_BUILD_WITH_ZSTD
+  if (src.empty() || is_zstd_frame(src)) {
+    return src;
+  }
+  // Cubins compress well already at low levels, and decompression speed does
+  // not depend on the level
+  constexpr int compression_level = 3;
+  std::vector<char> dst(ZSTD_compressBound(src.size()));
+  const size_t size = ZSTD_compress(
+      dst.data(), dst.size(), src.data(), src.size(), compression_level);
+  if (ZSTD_isError(size)) {
+    return src;
+  }
+  dst.resize(size);
+  return dst;
+#else
+  return src;
+#endif
+}
+
+bool decompress_blob(std::vector<char>& blob) {
+  if (!is_zstd_frame(blob)) {
+    return true;
+  }
+#ifdef NVFUSER_BUILD_WITH_ZSTD
+  const unsigned long long size =
+      ZSTD_getFrameContentSize(blob.data(), blob.size());
+  if (size == ZSTD_CONTENTSIZE_UNKNOWN || size == ZSTD_CONTENTSIZE_ERROR) {
+    return false;
+  }
+  std::vector<char> dst(size);
+  const size_t decompressed_size =
+      ZSTD_decompress(dst.data(), dst.size(), blob.data(), blob.size());
+  if (ZSTD_isError(decompressed_size) || decompressed_size != size) {
+    return false;
+  }
+  blob = std::move(dst);
+  return true;
+#else
+  return false;
+#endif
+}
+
 } // namespace nvfuser
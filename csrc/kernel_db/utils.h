@@ -6,6 +6,7 @@
  */
 // clang-format on
 #pragma once
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -34,4 +35,29 @@ NVF_API bool copy_to_text_file(
     const std::string& file_path,
     const std::string& src);
 
+//! Writes the data to a uniquely named temporary file in the same directory as
+//! file_path and then renames it into place.  Concurrent readers, including
+//! other processes, either see the complete file or no file at all.
+NVF_API bool atomic_copy_to_file(
+    const std::string& file_path,
+    const char* src,
+    size_t size);
+
+//! 64-bit FNV-1a hash of a string.  Unlike std::hash, the value is stable
+//! across processes and builds, so it is used to name on-disk entries.
+NVF_API uint64_t stable_hash(const std::string& src);
+
+//! Returns true if nvFuser is built with NVFUSER_BUILD_WITH_ZSTD, so that
+//! compress_blob actually compresses.
+NVF_API bool is_blob_compression_available();
+
+//! Compresses a cubin or PTX blob into a zstd frame. Returns the blob
+//! unchanged if compression is unavailable or the blob is already compressed.
+NVF_API std::vector<char> compress_blob(const std::vector<char>& src);
+
+//! Decompresses a blob written by compress_blob in place. Blobs that aren't
+//! zstd frames, e.g., cubins stored without compression, are left unchanged.
+//! Returns false if the frame is corrupted or nvFuser is built without zstd.
+NVF_API bool decompress_blob(std::vector<char>& blob);
+
 } // namespace nvfuser
@@ -99,6 +99,7 @@ TensorIndex::TensorIndex(
   NVF_ERROR(
       isPointerType(index->dtype()) || index->dtype() == DataType::Index ||
           isStructType(index->dtype()) ||
+          index->dtype() == DataType::Int /*For sub-tensor indexing*/ ||
           index->dtype() ==
               DataType::UInt /*For matrix descriptor for hopper MMA*/,
       "Cannot index with a value other than an int/pointer/struct.");
@@ -407,18 +408,21 @@ std::string Asm::toInlineString(int indent_size) const {
 
 NVFUSER_DEFINE_CLONE_AND_CREATE(Asm)
 
-BlockSync::BlockSync(IrBuilderPasskey passkey, bool war_sync) : Expr(passkey) {
+BlockSync::BlockSync(IrBuilderPasskey passkey, bool war_sync, bool warp_sync)
+    : Expr(passkey) {
   NVF_ERROR(passkey.ir_container_ != nullptr);
   NVF_ERROR(
       passkey.ir_container_->isA<kir::Kernel>(),
       "IR type only valid for Kernel container.");
   addDataAttribute(war_sync);
+  addDataAttribute(warp_sync);
 }
 
 std::string BlockSync::toString(int indent_size) const {
   std::stringstream ss;
   indent(ss, indent_size) << "BLOCKSYNC(war_hazard="
-                          << boolLiteral(isWarHazardSync()) << ")\n";
+                          << boolLiteral(isWarHazardSync())
+                          << ", warp=" << boolLiteral(isWarpSync()) << ")\n";
   return ss.str();
 }
 
@@ -853,6 +857,62 @@ std::string UpdateMagicZero::toInlineString(int indent_size) const {
 
 NVFUSER_DEFINE_CLONE_AND_CREATE(UpdateMagicZero)
 
+IncrementScalar::IncrementScalar(
+    IrBuilderPasskey passkey,
+    Val* scalar,
+    Val* increment)
+    : Expr(passkey) {
+  NVF_ERROR(passkey.ir_container_ != nullptr);
+  NVF_ERROR(
+      passkey.ir_container_->isA<kir::Kernel>(),
+      "IR type only valid for Kernel container.");
+  NVF_ERROR(
+      scalar->isScalar() && increment->isScalar(),
+      "IncrementScalar only supports scalars: ",
+      scalar->toString());
+  addInput(scalar);
+  addInput(increment);
+}
+
+std::string IncrementScalar::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << scalar()->toString()
+                          << " += " << increment()->toInlineString() << ";\n";
+  return ss.str();
+}
+
+std::string IncrementScalar::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "IncrementScalar can not be printed inline");
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(IncrementScalar)
+
+RecordTimelineEvent::RecordTimelineEvent(
+    IrBuilderPasskey passkey,
+    TensorView* buffer,
+    int64_t event)
+    : Expr(passkey) {
+  NVF_ERROR(passkey.ir_container_ != nullptr);
+  NVF_ERROR(
+      passkey.ir_container_->isA<kir::Kernel>(),
+      "IR type only valid for Kernel container.");
+  addInput(buffer);
+  addDataAttribute(event);
+}
+
+std::string RecordTimelineEvent::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << "RECORD_TIMELINE_EVENT(" << event() << ", "
+                          << buffer()->toString() << ")\n";
+  return ss.str();
+}
+
+std::string RecordTimelineEvent::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "RecordTimelineEvent can not be printed inline");
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(RecordTimelineEvent)
+
 IfThenElse::IfThenElse(IrBuilderPasskey passkey, Predicate* cond)
     : Expr(passkey) {
   setPredicate(cond);
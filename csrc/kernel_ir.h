@@ -55,6 +55,7 @@ class AsyncWait;
 class AsyncCommit;
 class InitMagicZero;
 class UpdateMagicZero;
+class RecordTimelineEvent;
 class IfThenElse;
 class GridReduction;
 class GroupedGridReduction;
@@ -391,7 +392,10 @@ class BlockSync final : public Expr {
  public:
   using Expr::Expr;
 
-  explicit BlockSync(IrBuilderPasskey passkey, bool war_sync = false);
+  explicit BlockSync(
+      IrBuilderPasskey passkey,
+      bool war_sync = false,
+      bool warp_sync = false);
 
   const char* getOpString() const override {
     return "BlockSync";
@@ -406,6 +410,12 @@ class BlockSync final : public Expr {
   bool isWarHazardSync() const {
     return attribute<bool>(0);
   }
+
+  //! Only the threads of each warp are synchronized, i.e., the threads that
+  //! communicate are known to be in the same warp
+  bool isWarpSync() const {
+    return attribute<bool>(1);
+  }
 };
 
 // Synchronize all blocks in device, implies cooperative group launch is
@@ -835,6 +845,67 @@ class UpdateMagicZero final : public Expr {
   std::string toInlineString(int indent_size = 0) const override;
 };
 
+// Advances a hoisted scalar in place, i.e., prints "scalar += increment;".
+// This is the update of the running index created by index strength
+// reduction. It has no output, so the definition of the scalar is left as its
+// initial value.
+class IncrementScalar final : public Expr {
+ public:
+  using Expr::Expr;
+
+  explicit IncrementScalar(
+      IrBuilderPasskey passkey,
+      Val* scalar,
+      Val* increment);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  const char* getOpString() const override {
+    return "IncrementScalar";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+
+  Val* scalar() const {
+    return input(0);
+  }
+
+  Val* increment() const {
+    return input(1);
+  }
+};
+
+//! Appends an event and the global timer to the timeline of the calling warp
+//! when EnableOption::KernelTimeline is set. Only the first active lane of
+//! the sampled warps records it, see KernelPerformanceProfile.
+class RecordTimelineEvent final : public Expr {
+ public:
+  using Expr::Expr;
+
+  explicit RecordTimelineEvent(
+      IrBuilderPasskey passkey,
+      TensorView* buffer,
+      int64_t event);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  const char* getOpString() const override {
+    return "RecordTimelineEvent";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+
+  TensorView* buffer() const {
+    return input(0)->as<TensorView>();
+  }
+
+  int64_t event() const {
+    return attribute<int64_t>(0);
+  }
+};
+
 //! IfThenElse provides scoping for an boolean operator. Exprs placed in its
 //! body are considered inside the scope of the if statement. In the future the
 //! implementation should look quite different so that we can do proper
@@ -252,6 +252,64 @@ std::unordered_map<IterDomain*, IterDomain*> PairwiseLogicalDomainMap::map(
     return dom_map;
   }
 
+  if (auto* op = dynamic_cast<GroupedMatmulOp*>(consumer_tv_->definition())) {
+    // mat1 = {M, K}, mat2 = {G, K, N}, offsets = {G}
+    // output = {M, N, (rK)}
+    int64_t input_position = 2;
+    if (producer_tv_->sameAs(op->mat1())) {
+      input_position = 0;
+    } else if (producer_tv_->sameAs(op->mat2())) {
+      input_position = 1;
+    }
+    const std::vector<IterDomain*>& aligned_producer_ids =
+        ops::mapGroupedMatmulOpIterDomains(
+            producer_logical, input_position, consumer_root.size());
+    pairwiseMapAllIds(aligned_producer_ids, consumer_root);
+    return dom_map;
+  }
+
+  if (auto* op =
+          dynamic_cast<SegmentedReductionOp*>(consumer_tv_->definition())) {
+    // in = {T, ...}, offsets = {B}
+    // output = {B, ...}
+    // The segmented axis T has no mapping to the output.
+    if (producer_tv_->sameAs(op->offsets())) {
+      updatePairwiseLogicalDomainMap(
+          producer_logical.at(0), consumer_root.at(0));
+    } else {
+      for (auto idx : c10::irange(1, consumer_root.size())) {
+        updatePairwiseLogicalDomainMap(
+            producer_logical.at(idx), consumer_root.at(idx));
+      }
+    }
+    return dom_map;
+  }
+
+  if (auto* op = dynamic_cast<EmbeddingBwdOp*>(consumer_tv_->definition())) {
+    // grad_output = {..., D}, indices = {...}
+    // grad_weight = {num_weights, D}
+    // Only the embedding dimension is mapped.
+    if (producer_tv_->sameAs(op->gradOutput())) {
+      updatePairwiseLogicalDomainMap(
+          producer_logical.back(), consumer_root.back());
+    }
+    return dom_map;
+  }
+
+  if (auto* op = dynamic_cast<TopKOp*>(consumer_tv_->definition())) {
+    // The selected axis has extent k in the outputs, so it is not mapped.
+    // All other axes map positionally.
+    if (producer_tv_->sameAs(op->in())) {
+      for (auto idx : c10::irange(consumer_root.size())) {
+        if ((int64_t)idx != op->dim()) {
+          updatePairwiseLogicalDomainMap(
+              producer_logical.at(idx), consumer_root.at(idx));
+        }
+      }
+    }
+    return dom_map;
+  }
+
   if (SdpaFwdOp* op = dynamic_cast<SdpaFwdOp*>(consumer_tv_->definition())) {
     // Note: Explicit handling of DIDx(D) until
     // https://github.com/NVIDIA/Fuser/issues/2563 is resolved. Producers:
@@ -33,13 +33,17 @@ std::string toString(MatmulDimRole role);
 //!  OUTPUT - fusion outputs that have the matmul as a dependency
 //!  EPILOGUE_INPUT - an input to the fusion that is a producer of an
 //!    OUTPUT, but not of an MMA input
+//!  PROLOGUE_INPUT - an input to the fusion with M but no N or K dimensions
+//!    that is only a producer of MMA inputs, e.g., the per-row statistics of
+//!    a normalization that is applied while loading operand A
 //!
 //!  Note: bias vector tensors will be assigned to the EPILOGUE_INPUT role.
 enum class MatmulTensorRole {
   OPERAND_A = 0,
   OPERAND_B,
   OUTPUT,
-  EPILOGUE_INPUT
+  EPILOGUE_INPUT,
+  PROLOGUE_INPUT
 };
 
 //! The expected number of occurances of core TensorView roles in fusion
@@ -80,7 +84,15 @@ struct MatMulTileOptions {
 enum class MmaMacro : uint64_t;
 
 struct MmaMacroEncode {
-  enum class Arch : uint16_t { NoMma, Volta, Turing, Ampere, Hopper } arch;
+  enum class Arch : uint16_t {
+    NoMma,
+    Volta,
+    Turing,
+    Ampere,
+    Hopper,
+    Blackwell1CTA,
+    Blackwell2CTA
+  } arch;
   uint16_t m;
   uint16_t n;
   uint16_t k;
@@ -162,6 +174,83 @@ enum class MmaMacro : uint64_t {
   MACRO(Hopper, 64, 240, 16),
   MACRO(Hopper, 64, 248, 16),
   MACRO(Hopper, 64, 256, 16),
+
+  // tcgen05.mma issued by a single CTA, which accumulates in tensor memory
+  MACRO(Blackwell1CTA, 64, 8, 16),
+  MACRO(Blackwell1CTA, 64, 16, 16),
+  MACRO(Blackwell1CTA, 64, 24, 16),
+  MACRO(Blackwell1CTA, 64, 32, 16),
+  MACRO(Blackwell1CTA, 64, 40, 16),
+  MACRO(Blackwell1CTA, 64, 48, 16),
+  MACRO(Blackwell1CTA, 64, 56, 16),
+  MACRO(Blackwell1CTA, 64, 64, 16),
+  MACRO(Blackwell1CTA, 64, 72, 16),
+  MACRO(Blackwell1CTA, 64, 80, 16),
+  MACRO(Blackwell1CTA, 64, 88, 16),
+  MACRO(Blackwell1CTA, 64, 96, 16),
+  MACRO(Blackwell1CTA, 64, 104, 16),
+  MACRO(Blackwell1CTA, 64, 112, 16),
+  MACRO(Blackwell1CTA, 64, 120, 16),
+  MACRO(Blackwell1CTA, 64, 128, 16),
+  MACRO(Blackwell1CTA, 64, 136, 16),
+  MACRO(Blackwell1CTA, 64, 144, 16),
+  MACRO(Blackwell1CTA, 64, 152, 16),
+  MACRO(Blackwell1CTA, 64, 160, 16),
+  MACRO(Blackwell1CTA, 64, 168, 16),
+  MACRO(Blackwell1CTA, 64, 176, 16),
+  MACRO(Blackwell1CTA, 64, 184, 16),
+  MACRO(Blackwell1CTA, 64, 192, 16),
+  MACRO(Blackwell1CTA, 64, 200, 16),
+  MACRO(Blackwell1CTA, 64, 208, 16),
+  MACRO(Blackwell1CTA, 64, 216, 16),
+  MACRO(Blackwell1CTA, 64, 224, 16),
+  MACRO(Blackwell1CTA, 64, 232, 16),
+  MACRO(Blackwell1CTA, 64, 240, 16),
+  MACRO(Blackwell1CTA, 64, 248, 16),
+  MACRO(Blackwell1CTA, 64, 256, 16),
+  MACRO(Blackwell1CTA, 128, 16, 16),
+  MACRO(Blackwell1CTA, 128, 32, 16),
+  MACRO(Blackwell1CTA, 128, 48, 16),
+  MACRO(Blackwell1CTA, 128, 64, 16),
+  MACRO(Blackwell1CTA, 128, 80, 16),
+  MACRO(Blackwell1CTA, 128, 96, 16),
+  MACRO(Blackwell1CTA, 128, 112, 16),
+  MACRO(Blackwell1CTA, 128, 128, 16),
+  MACRO(Blackwell1CTA, 128, 144, 16),
+  MACRO(Blackwell1CTA, 128, 160, 16),
+  MACRO(Blackwell1CTA, 128, 176, 16),
+  MACRO(Blackwell1CTA, 128, 192, 16),
+  MACRO(Blackwell1CTA, 128, 208, 16),
+  MACRO(Blackwell1CTA, 128, 224, 16),
+  MACRO(Blackwell1CTA, 128, 240, 16),
+  MACRO(Blackwell1CTA, 128, 256, 16),
+
+  // tcgen05.mma issued by a pair of CTAs in a cluster. M is the extent of
+  // the pair, each CTA holds half of it.
+  MACRO(Blackwell2CTA, 128, 32, 16),
+  MACRO(Blackwell2CTA, 128, 64, 16),
+  MACRO(Blackwell2CTA, 128, 96, 16),
+  MACRO(Blackwell2CTA, 128, 128, 16),
+  MACRO(Blackwell2CTA, 128, 160, 16),
+  MACRO(Blackwell2CTA, 128, 192, 16),
+  MACRO(Blackwell2CTA, 128, 224, 16),
+  MACRO(Blackwell2CTA, 128, 256, 16),
+  MACRO(Blackwell2CTA, 256, 16, 16),
+  MACRO(Blackwell2CTA, 256, 32, 16),
+  MACRO(Blackwell2CTA, 256, 48, 16),
+  MACRO(Blackwell2CTA, 256, 64, 16),
+  MACRO(Blackwell2CTA, 256, 80, 16),
+  MACRO(Blackwell2CTA, 256, 96, 16),
+  MACRO(Blackwell2CTA, 256, 112, 16),
+  MACRO(Blackwell2CTA, 256, 128, 16),
+  MACRO(Blackwell2CTA, 256, 144, 16),
+  MACRO(Blackwell2CTA, 256, 160, 16),
+  MACRO(Blackwell2CTA, 256, 176, 16),
+  MACRO(Blackwell2CTA, 256, 192, 16),
+  MACRO(Blackwell2CTA, 256, 208, 16),
+  MACRO(Blackwell2CTA, 256, 224, 16),
+  MACRO(Blackwell2CTA, 256, 240, 16),
+  MACRO(Blackwell2CTA, 256, 256, 16),
 };
 
 #undef MACRO
@@ -195,6 +284,18 @@ inline bool isHopper(MmaMacro macro) {
   return MmaMacroEncode(macro).arch == MmaMacroEncode::Arch::Hopper;
 }
 
+inline bool isBlackwell1CTA(MmaMacro macro) {
+  return MmaMacroEncode(macro).arch == MmaMacroEncode::Arch::Blackwell1CTA;
+}
+
+inline bool isBlackwell2CTA(MmaMacro macro) {
+  return MmaMacroEncode(macro).arch == MmaMacroEncode::Arch::Blackwell2CTA;
+}
+
+inline bool isBlackwell(MmaMacro macro) {
+  return isBlackwell1CTA(macro) || isBlackwell2CTA(macro);
+}
+
 //! Get the m size from macro type
 inline int64_t getM(MmaMacro macro) {
   return MmaMacroEncode(macro).m;
@@ -0,0 +1,162 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <multidevice/backend_table.h>
+
+#include <kernel_db/utils.h>
+
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+namespace nvfuser {
+
+namespace {
+
+constexpr char kFieldSeparator = '\t';
+
+int64_t log2Bucket(int64_t message_bytes) {
+  int64_t log2 = 0;
+  while (message_bytes > 1) {
+    message_bytes >>= 1;
+    ++log2;
+  }
+  return log2;
+}
+
+template <typename T>
+std::string toName(const T& value) {
+  std::stringstream ss;
+  ss << value;
+  return ss.str();
+}
+
+std::optional<CommunicationType> parseCommunicationType(
+    const std::string& name) {
+  for (auto type :
+       {CommunicationType::Allgather,
+        CommunicationType::Allreduce,
+        CommunicationType::ReduceScatter}) {
+    if (toName(type) == name) {
+      return type;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<CommunicatorBackend> parseBackend(const std::string& name) {
+  for (auto backend :
+       {CommunicatorBackend::kNccl,
+        CommunicatorBackend::kUcc,
+        CommunicatorBackend::kGloo}) {
+    if (toName(backend) == name) {
+      return backend;
+    }
+  }
+  return std::nullopt;
+}
+
+} // namespace
+
+void CommunicatorBackendTable::set(
+    CommunicationType type,
+    int64_t team_size,
+    int64_t message_bytes,
+    CommunicatorBackend backend) {
+  NVF_ERROR(
+      isTunable(type),
+      "The backend of a ",
+      type,
+      " isn't selected by message size");
+  entries_[{type, team_size, log2Bucket(message_bytes)}] = backend;
+}
+
+std::optional<CommunicatorBackend> CommunicatorBackendTable::lookup(
+    CommunicationType type,
+    int64_t team_size,
+    int64_t message_bytes) const {
+  const int64_t log2 = log2Bucket(message_bytes);
+  auto matches = [&](auto it) {
+    return it != entries_.end() && std::get<0>(it->first) == type &&
+        std::get<1>(it->first) == team_size;
+  };
+  // The first bucket at least as large and the last smaller one
+  auto above = entries_.lower_bound({type, team_size, log2});
+  auto below =
+      above == entries_.begin() ? entries_.end() : std::prev(above);
+  if (!matches(above)) {
+    return matches(below) ? std::make_optional(below->second) : std::nullopt;
+  }
+  if (matches(below) &&
+      log2 - std::get<2>(below->first) < std::get<2>(above->first) - log2) {
+    return below->second;
+  }
+  return above->second;
+}
+
+std::string CommunicatorBackendTable::toString() const {
+  std::stringstream ss;
+  for (const auto& [key, backend] : entries_) {
+    const auto& [type, team_size, log2] = key;
+    ss << type << kFieldSeparator << team_size << kFieldSeparator << log2
+       << kFieldSeparator << backend << "\n";
+  }
+  return ss.str();
+}
+
+std::optional<CommunicatorBackendTable> CommunicatorBackendTable::fromString(
+    const std::string& contents) {
+  CommunicatorBackendTable table;
+  std::stringstream contents_ss(contents);
+  std::string line;
+  while (std::getline(contents_ss, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    std::vector<std::string> fields;
+    std::stringstream line_ss(line);
+    std::string field;
+    while (std::getline(line_ss, field, kFieldSeparator)) {
+      fields.push_back(field);
+    }
+    if (fields.size() != 4) {
+      return std::nullopt;
+    }
+    auto type = parseCommunicationType(fields[0]);
+    auto backend = parseBackend(fields[3]);
+    if (!type.has_value() || !backend.has_value()) {
+      return std::nullopt;
+    }
+    try {
+      const int64_t team_size = std::stoll(fields[1]);
+      const int64_t log2 = std::stoll(fields[2]);
+      if (log2 < 0 || log2 > 62) {
+        return std::nullopt;
+      }
+      table.set(type.value(), team_size, (int64_t)1 << log2, backend.value());
+    } catch (const std::exception&) {
+      return std::nullopt;
+    }
+  }
+  return table;
+}
+
+bool CommunicatorBackendTable::save(const std::string& file_path) const {
+  const std::string contents = toString();
+  return atomic_copy_to_file(file_path, contents.data(), contents.size());
+}
+
+std::optional<CommunicatorBackendTable> CommunicatorBackendTable::load(
+    const std::string& file_path) {
+  std::string contents;
+  if (!copy_from_text_file(file_path, contents)) {
+    return std::nullopt;
+  }
+  return fromString(contents);
+}
+
+} // namespace nvfuser
@@ -0,0 +1,76 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <tuple>
+
+#include <multidevice/communication.h>
+#include <multidevice/communicator.h>
+#include <visibility.h>
+
+namespace nvfuser {
+
+// CommunicatorBackendTable selects the backend of a collective by its type,
+// team size and message size, e.g., UCC for small latency-bound messages and
+// NCCL for large ones on some topologies. Message sizes are bucketed by their
+// power of two, and a message falls in the nearest bucket measured for the
+// same type and team size.
+//
+// The message size is the number of bytes each rank sends, so that every rank
+// of the team selects the same backend. Only the collectives whose message
+// size is the same on every rank are selected by the table.
+//
+// Communicator::calibrateBackends fills the table by timing the collectives of
+// the world on every available backend. The table is stored as tab separated
+// lines of the type, team size, log2 of the bucket in bytes and backend.
+class CommunicatorBackendTable {
+ public:
+  static bool isTunable(CommunicationType type) {
+    return type == CommunicationType::Allgather ||
+        type == CommunicationType::Allreduce ||
+        type == CommunicationType::ReduceScatter;
+  }
+
+  NVF_API void set(
+      CommunicationType type,
+      int64_t team_size,
+      int64_t message_bytes,
+      CommunicatorBackend backend);
+
+  // Returns std::nullopt if no bucket was measured for the type and team size
+  NVF_API std::optional<CommunicatorBackend> lookup(
+      CommunicationType type,
+      int64_t team_size,
+      int64_t message_bytes) const;
+
+  bool empty() const {
+    return entries_.empty();
+  }
+
+  NVF_API std::string toString() const;
+  // Returns std::nullopt if a line is badly formed
+  NVF_API static std::optional<CommunicatorBackendTable> fromString(
+      const std::string& contents);
+
+  // Replaces the file atomically, so that concurrent readers see the complete
+  // table or none
+  NVF_API bool save(const std::string& file_path) const;
+  NVF_API static std::optional<CommunicatorBackendTable> load(
+      const std::string& file_path);
+
+ private:
+  // Type, team size and log2 of the message size in bytes
+  using Key = std::tuple<CommunicationType, int64_t, int64_t>;
+  std::map<Key, CommunicatorBackend> entries_;
+};
+
+} // namespace nvfuser
@@ -66,6 +66,8 @@ struct ReduceOptions {
   int64_t rootRank = 0;
 };
 
+struct AllToAllOptions {};
+
 struct BarrierOptions {
   std::vector<int64_t> device_ids;
 };
@@ -161,15 +163,35 @@ class Backend : public torch::CustomClassHolder {
     return c10::make_intrusive<Work>();
   }
 
+  c10::intrusive_ptr<Work> alltoall_base(
+      at::Tensor& outputBuffer,
+      at::Tensor& inputBuffer,
+      std::vector<int64_t>& outputSplitSizes,
+      std::vector<int64_t>& inputSplitSizes,
+      const AllToAllOptions& opts = AllToAllOptions()) {
+    return c10::make_intrusive<Work>();
+  }
+
   int getSize() const {
     return 0;
   }
+
+  int getRank() const {
+    return 0;
+  }
 };
 
 struct TCPStoreOptions {
   static constexpr uint16_t kDefaultPort = 0;
 };
 
-class TCPStore : public torch::CustomClassHolder {};
+class TCPStore : public torch::CustomClassHolder {
+ public:
+  void set(const std::string& key, const std::vector<uint8_t>& value) {}
+
+  std::vector<uint8_t> get(const std::string& key) {
+    return {};
+  }
+};
 
 } // namespace c10d
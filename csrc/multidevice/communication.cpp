@@ -14,6 +14,9 @@
 #endif
 #include <utils.h>
 
+#include <limits>
+#include <numeric>
+
 namespace nvfuser {
 
 std::ostream& operator<<(std::ostream& os, const CommunicationType& type) {
@@ -42,6 +45,9 @@ std::ostream& operator<<(std::ostream& os, const CommunicationType& type) {
     case CommunicationType::SendRecv:
       os << "SendRecv";
       break;
+    case CommunicationType::AllToAll:
+      os << "AllToAll";
+      break;
     default:
       NVF_THROW("unrecognized CommunicationType: ", type);
   }
@@ -112,6 +118,7 @@ bool hasRoot(CommunicationType type) {
     case CommunicationType::Allgather:
     case CommunicationType::Allreduce:
     case CommunicationType::ReduceScatter:
+    case CommunicationType::AllToAll:
       return false;
     default:
       NVF_THROW("unrecognized CommunicationType: ", type);
@@ -129,6 +136,7 @@ bool isReduction(CommunicationType type) {
     case CommunicationType::Scatter:
     case CommunicationType::Broadcast:
     case CommunicationType::SendRecv:
+    case CommunicationType::AllToAll:
       return false;
     default:
       NVF_THROW("unrecognized CommunicationType: ", type);
@@ -145,7 +153,9 @@ Communication::Communication(
     Team team,
     DeviceIdxType root,
     RedOpType red_op,
-    int64_t scattered_axis)
+    int64_t scattered_axis,
+    TensorView* input_splits,
+    TensorView* output_splits)
     : Expr(passkey) {
   NVF_ERROR(
       in->getDeviceMesh().size() > 0,
@@ -156,6 +166,13 @@ Communication::Communication(
 
   addInput(in);
   addOutput(out);
+  NVF_ERROR(
+      (input_splits == nullptr) == (output_splits == nullptr),
+      "The input and output splits must be given together.");
+  if (input_splits != nullptr) {
+    addInput(input_splits);
+    addOutput(output_splits);
+  }
   addDataAttribute(type);
   addDataAttribute(team);
   addDataAttribute(root);
@@ -175,6 +192,10 @@ void Communication::validate() {
   NVF_ERROR(isReduction(type()) == (reduceOp() != RedOpType::UNUSED))
   NVF_ERROR(
       (type() == CommunicationType::ReduceScatter) == (scatteredAxis() >= 0));
+  NVF_ERROR(
+      type() == CommunicationType::AllToAll || inputSplits() == nullptr,
+      "Only AllToAll takes split sizes, not ",
+      type());
 }
 
 NVFUSER_DEFINE_CLONE_AND_CREATE(Communication)
@@ -205,6 +226,10 @@ std::string Communication::toString(const int indent_size) const {
   if (!outputs().empty()) {
     ss << ", output=" << out();
   }
+  if (inputSplits() != nullptr) {
+    ss << ", input_splits=" << inputSplits()
+       << ", output_splits=" << outputSplits();
+  }
   ss << ")\n";
   return ss.str();
 }
@@ -231,11 +256,13 @@ P2PCommunication::P2PCommunication(
     IrBuilderPasskey passkey,
     P2PCommunicationType type,
     TensorView* buffer,
-    Val* peer)
+    Val* peer,
+    CommunicatorBackend backend)
     : Expr(passkey) {
   addInput(buffer);
   addDataAttribute(type);
   addAttribute(peer);
+  addDataAttribute(backend);
 }
 
 NVFUSER_DEFINE_CLONE_AND_CREATE(P2PCommunication)
@@ -245,7 +272,8 @@ std::string P2PCommunication::toString(const int indent_size) const {
   indent(ss, indent_size) << "P2PCommunication " << name() << " ("
                           << "type=" << type() << ", "
                           << "buffer=" << buffer() << ", "
-                          << "peer=" << peer() << ")\n";
+                          << "peer=" << peer() << ", "
+                          << "backend=" << backend() << ")\n";
   return ss.str();
 }
 
@@ -501,6 +529,82 @@ c10::intrusive_ptr<c10d::Work> postSendRecv(
         /*tag=*/0);
   }
 }
+
+std::vector<int64_t> splitSizesToHost(at::Tensor splits) {
+  at::Tensor host_splits = splits.to(at::kCPU, at::kLong).contiguous();
+  const int64_t* data = host_splits.data_ptr<int64_t>();
+  return std::vector<int64_t>(data, data + host_splits.numel());
+}
+
+c10::intrusive_ptr<c10d::Work> postAllToAll(
+    Communication* communication,
+    DeviceIdxType my_device_index,
+    c10d::Backend* backend,
+    at::Tensor input_tensor,
+    at::Tensor output_tensor,
+    at::Tensor input_splits,
+    at::Tensor output_splits) {
+  const int64_t team_size = communication->team_size();
+  NVF_ERROR(
+      input_tensor.is_contiguous() && output_tensor.is_contiguous(),
+      "AllToAll requires contiguous buffers");
+  std::vector<int64_t> no_splits;
+
+  if (!input_splits.defined()) {
+    NVF_ERROR(
+        input_tensor.numel() == output_tensor.numel() &&
+            input_tensor.numel() % team_size == 0,
+        "AllToAll buffers must have the same number of elements, divisible by ",
+        team_size,
+        ", but got ",
+        input_tensor.sizes(),
+        " and ",
+        output_tensor.sizes());
+    // Viewing the buffers as [team_size, -1] makes the chunks contiguous
+    // whatever the rank of the buffers, e.g., [1, N] -> [team_size, N/size]
+    at::Tensor output_buffer = output_tensor.view({team_size, -1});
+    at::Tensor input_buffer = input_tensor.view({team_size, -1});
+    return backend->alltoall_base(
+        output_buffer, input_buffer, no_splits, no_splits, {});
+  }
+
+  NVF_ERROR(
+      output_splits.defined() && input_splits.numel() == team_size &&
+          output_splits.numel() == team_size,
+      "AllToAll split sizes must have ",
+      team_size,
+      " elements");
+  NVF_ERROR(
+      output_splits.scalar_type() == at::kLong && output_splits.is_contiguous(),
+      "AllToAll output splits must be a contiguous int64 tensor");
+  at::Tensor send_counts = input_splits.to(at::kLong).contiguous();
+  backend->alltoall_base(output_splits, send_counts, no_splits, no_splits, {})
+      ->wait();
+
+  std::vector<int64_t> input_split_sizes = splitSizesToHost(send_counts);
+  std::vector<int64_t> output_split_sizes = splitSizesToHost(output_splits);
+  const int64_t input_rows = std::accumulate(
+      input_split_sizes.begin(), input_split_sizes.end(), (int64_t)0);
+  const int64_t output_rows = std::accumulate(
+      output_split_sizes.begin(), output_split_sizes.end(), (int64_t)0);
+  NVF_ERROR(
+      input_rows <= input_tensor.size(0),
+      "AllToAll sends ",
+      input_rows,
+      " rows but the src buffer has ",
+      input_tensor.size(0));
+  NVF_ERROR(
+      output_rows <= output_tensor.size(0),
+      "AllToAll receives ",
+      output_rows,
+      " rows but the dst buffer has ",
+      output_tensor.size(0));
+  // c10d expects the split sizes to cover the whole buffers
+  at::Tensor output_buffer = output_tensor.narrow(0, 0, output_rows);
+  at::Tensor input_buffer = input_tensor.narrow(0, 0, input_rows);
+  return backend->alltoall_base(
+      output_buffer, input_buffer, output_split_sizes, input_split_sizes, {});
+}
 } // namespace
 
 c10::intrusive_ptr<c10d::Work> postSingleCommunication(
@@ -508,7 +612,9 @@ c10::intrusive_ptr<c10d::Work> postSingleCommunication(
     DeviceIdxType my_device_index,
     c10d::Backend* backend,
     at::Tensor input_tensor,
-    at::Tensor output_tensor) {
+    at::Tensor output_tensor,
+    at::Tensor input_splits,
+    at::Tensor output_splits) {
   const Team& team = communication->team();
   if (std::find(team.begin(), team.end(), my_device_index) == team.end()) {
     return nullptr;
@@ -540,6 +646,15 @@ c10::intrusive_ptr<c10d::Work> postSingleCommunication(
     case CommunicationType::SendRecv:
       return postSendRecv(
           communication, my_device_index, backend, input_tensor, output_tensor);
+    case CommunicationType::AllToAll:
+      return postAllToAll(
+          communication,
+          my_device_index,
+          backend,
+          input_tensor,
+          output_tensor,
+          input_splits,
+          output_splits);
     default:
       NVF_THROW("Wrong communication type: ", communication->type());
       return nullptr;
@@ -548,6 +663,252 @@ c10::intrusive_ptr<c10d::Work> postSingleCommunication(
 
 namespace {
 
+// Below this size, collectives are latency bound and the extra steps of the
+// hierarchical decomposition cost more than they save in bandwidth.
+constexpr int64_t kMinHierarchicalMessageBytes = 1 << 20;
+
+bool canPostHierarchically(
+    Communication* communication,
+    c10d::Backend* backend,
+    const at::Tensor& input_tensor,
+    const at::Tensor& output_tensor) {
+  if (communication->type() != CommunicationType::Allreduce &&
+      communication->type() != CommunicationType::Allgather) {
+    return false;
+  }
+  // The intermediate steps write in place, which only NCCL supports
+  if (backend->getBackendName() != "nccl") {
+    return false;
+  }
+  const DeviceMesh& mesh = communication->in()->getDeviceMesh();
+  if (mesh.rank() != 2 || mesh.shape().at(0) == 1 ||
+      mesh.shape().at(1) == 1 || communication->team() != mesh.vector()) {
+    return false;
+  }
+  if (!input_tensor.is_contiguous() || !output_tensor.is_contiguous() ||
+      output_tensor.numel() * output_tensor.element_size() <
+          kMinHierarchicalMessageBytes) {
+    return false;
+  }
+  // The intra-node reduce-scatter splits the buffer evenly
+  return communication->type() != CommunicationType::Allreduce ||
+      output_tensor.numel() % mesh.shape().at(1) == 0;
+}
+
+c10::intrusive_ptr<c10d::Work> postHierarchicalAllreduce(
+    Communication* communication,
+    DeviceIdxType my_device_index,
+    c10d::Backend* intra_node_backend,
+    c10d::Backend* inter_node_backend,
+    at::Tensor input_tensor,
+    at::Tensor output_tensor) {
+  doLocalCopy(output_tensor, input_tensor);
+  at::Tensor buffer = output_tensor.view(-1);
+  at::Tensor chunk = at::tensor_split(buffer, intra_node_backend->getSize())
+                         .at(intra_node_backend->getRank());
+
+  std::vector<at::Tensor> chunks({chunk});
+  intra_node_backend
+      ->_reduce_scatter_base(
+          chunk, buffer, {.reduceOp = communication->reduceOp()})
+      ->wait();
+  inter_node_backend->allreduce(chunks, {.reduceOp = communication->reduceOp()})
+      ->wait();
+  return intra_node_backend->_allgather_base(buffer, chunk, {});
+}
+
+c10::intrusive_ptr<c10d::Work> postHierarchicalAllgather(
+    Communication* communication,
+    DeviceIdxType my_device_index,
+    c10d::Backend* intra_node_backend,
+    c10d::Backend* inter_node_backend,
+    at::Tensor input_tensor,
+    at::Tensor output_tensor) {
+  at::Tensor buffer = output_tensor.view(-1);
+  at::Tensor input_buffer = input_tensor.view(-1);
+  at::Tensor block = at::tensor_split(buffer, inter_node_backend->getSize())
+                         .at(inter_node_backend->getRank());
+  assertBuffersHaveSameSize(
+      {input_buffer}, at::tensor_split(block, intra_node_backend->getSize()));
+
+  intra_node_backend->_allgather_base(block, input_buffer, {})->wait();
+  return inter_node_backend->_allgather_base(buffer, block, {});
+}
+
+} // namespace
+
+c10::intrusive_ptr<c10d::Work> postHierarchicalCommunication(
+    Communication* communication,
+    DeviceIdxType my_device_index,
+    Communicator* communicator,
+    std::optional<CommunicatorBackend> backend_type,
+    at::Tensor input_tensor,
+    at::Tensor output_tensor,
+    at::Tensor input_splits,
+    at::Tensor output_splits) {
+  c10d::Backend* backend =
+      communicator->getBackendForTeam(communication->team(), backend_type);
+  const Team& team = communication->team();
+  if (std::find(team.begin(), team.end(), my_device_index) == team.end() ||
+      !canPostHierarchically(
+          communication, backend, input_tensor, output_tensor)) {
+    return postSingleCommunication(
+        communication,
+        my_device_index,
+        backend,
+        input_tensor,
+        output_tensor,
+        input_splits,
+        output_splits);
+  }
+
+  const DeviceMesh& mesh = communication->in()->getDeviceMesh();
+  c10d::Backend* intra_node_backend = communicator->getBackendForTeam(
+      mesh.getSlice(/*axis=*/1, my_device_index), backend_type);
+  c10d::Backend* inter_node_backend = communicator->getBackendForTeam(
+      mesh.getSlice(/*axis=*/0, my_device_index), backend_type);
+  if (communication->type() == CommunicationType::Allreduce) {
+    return postHierarchicalAllreduce(
+        communication,
+        my_device_index,
+        intra_node_backend,
+        inter_node_backend,
+        input_tensor,
+        output_tensor);
+  }
+  return postHierarchicalAllgather(
+      communication,
+      my_device_index,
+      intra_node_backend,
+      inter_node_backend,
+      input_tensor,
+      output_tensor);
+}
+
+namespace {
+
+// Number of consecutive elements sharing an FP8 scale
+constexpr int64_t kCompressionBlockSize = 128;
+// Largest finite value of at::kFloat8_e4m3fn
+constexpr double kFloat8E4m3Max = 448.0;
+
+bool canPostCompressed(
+    Communication* communication,
+    DeviceIdxType my_device_index,
+    const at::Tensor& input_tensor,
+    const at::Tensor& output_tensor) {
+  if (communication->type() != CommunicationType::Allreduce &&
+      communication->type() != CommunicationType::ReduceScatter) {
+    return false;
+  }
+  // The scattered chunks must be contiguous, i.e., the axes outside the
+  // scattered axis must have size 1
+  if (communication->type() == CommunicationType::ReduceScatter) {
+    const int64_t scattered_axis = communication->scatteredAxis();
+    for (auto axis : c10::irange(scattered_axis)) {
+      if (input_tensor.size(axis) != 1) {
+        return false;
+      }
+    }
+  }
+  const Team& team = communication->team();
+  if (communication->reduceOp() != c10d::ReduceOp::SUM || team.size() < 2 ||
+      std::find(team.begin(), team.end(), my_device_index) == team.end()) {
+    return false;
+  }
+  if (input_tensor.scalar_type() != at::kFloat &&
+      input_tensor.scalar_type() != at::kBFloat16) {
+    return false;
+  }
+  // Each rank reduces an equal number of whole blocks
+  return input_tensor.is_contiguous() && output_tensor.is_contiguous() &&
+      input_tensor.numel() %
+          (communication->team_size() * kCompressionBlockSize) ==
+      0;
+}
+
+// Quantizes blocks, i.e., [..., kCompressionBlockSize], into FP8 values and
+// their FP32 scales, [..., 1]. The FP8 values are returned as bytes, which
+// every backend can move.
+std::pair<at::Tensor, at::Tensor> quantizeBlocks(const at::Tensor& blocks) {
+  at::Tensor values = blocks.to(at::kFloat);
+  at::Tensor scales = values.abs()
+                          .amax(/*dim=*/-1, /*keepdim=*/true)
+                          .div_(kFloat8E4m3Max)
+                          .clamp_min_(std::numeric_limits<float>::min());
+  at::Tensor quantized = values.div_(scales).to(at::kFloat8_e4m3fn);
+  return {quantized.view(at::kByte), scales};
+}
+
+at::Tensor dequantizeBlocks(
+    const at::Tensor& quantized,
+    const at::Tensor& scales) {
+  return quantized.view(at::kFloat8_e4m3fn).to(at::kFloat).mul_(scales);
+}
+
+} // namespace
+
+c10::intrusive_ptr<c10d::Work> postCompressedCommunication(
+    Communication* communication,
+    DeviceIdxType my_device_index,
+    Communicator* communicator,
+    std::optional<CommunicatorBackend> backend_type,
+    at::Tensor input_tensor,
+    at::Tensor output_tensor,
+    at::Tensor input_splits,
+    at::Tensor output_splits) {
+  if (!canPostCompressed(
+          communication, my_device_index, input_tensor, output_tensor)) {
+    return postHierarchicalCommunication(
+        communication,
+        my_device_index,
+        communicator,
+        backend_type,
+        input_tensor,
+        output_tensor,
+        input_splits,
+        output_splits);
+  }
+  c10d::Backend* backend =
+      communicator->getBackendForTeam(communication->team(), backend_type);
+  const int64_t team_size = communication->team_size();
+
+  // Reduce-scatter: the blocks of chunk i are sent to rank i, which sums them
+  // in FP32
+  auto [quantized, scales] = quantizeBlocks(
+      input_tensor.view({team_size, -1, kCompressionBlockSize}));
+  at::Tensor received = at::empty_like(quantized);
+  at::Tensor received_scales = at::empty_like(scales);
+  std::vector<int64_t> equal_splits;
+  backend->alltoall_base(received, quantized, equal_splits, equal_splits)
+      ->wait();
+  c10::intrusive_ptr<c10d::Work> work = backend->alltoall_base(
+      received_scales, scales, equal_splits, equal_splits);
+  work->wait();
+  at::Tensor reduced =
+      dequantizeBlocks(received, received_scales).sum(/*dim=*/0);
+  if (communication->type() == CommunicationType::ReduceScatter) {
+    output_tensor.view({-1, kCompressionBlockSize}).copy_(reduced);
+    return work;
+  }
+
+  // Allgather of the reduced chunks
+  auto [quantized_chunk, chunk_scales] = quantizeBlocks(reduced);
+  at::Tensor gathered =
+      at::empty({team_size, quantized_chunk.size(0), kCompressionBlockSize},
+                quantized_chunk.options());
+  at::Tensor gathered_scales = at::empty(
+      {team_size, chunk_scales.size(0), 1}, chunk_scales.options());
+  backend->_allgather_base(gathered, quantized_chunk, {})->wait();
+  work = backend->_allgather_base(gathered_scales, chunk_scales, {});
+  work->wait();
+  output_tensor.view({team_size, -1, kCompressionBlockSize})
+      .copy_(dequantizeBlocks(gathered, gathered_scales));
+  return work;
+}
+
+namespace {
+
 c10::intrusive_ptr<c10d::Work> postSend(
     P2PCommunication* communication,
     DeviceIdxType my_device_index,
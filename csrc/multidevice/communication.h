@@ -31,7 +31,8 @@ enum class CommunicationType {
   Allreduce,
   ReduceScatter,
   Broadcast,
-  SendRecv
+  SendRecv,
+  AllToAll
 };
 
 std::ostream& operator<<(std::ostream& os, const CommunicationType& type);
@@ -49,6 +50,8 @@ class Communication : public Expr {
   // Only specify `root` for types that have root.
   // Only specify `red_op` for reduction types.
   // Only specify `scattered_axis` for ReduceScatter.
+  // Only specify `input_splits` and `output_splits` for an AllToAll with
+  // variable split sizes.
   Communication(
       IrBuilderPasskey passkey,
       CommunicationType type,
@@ -59,7 +62,9 @@ class Communication : public Expr {
                  // sharding.
       DeviceIdxType root = -1,
       RedOpType red_op = RedOpType::UNUSED,
-      int64_t scattered_axis = -1);
+      int64_t scattered_axis = -1,
+      TensorView* input_splits = nullptr,
+      TensorView* output_splits = nullptr);
 
   Communication(const Communication& other) = delete;
   Communication& operator=(const Communication& other) = delete;
@@ -107,6 +112,18 @@ class Communication : public Expr {
     return attribute<int64_t>(4);
   }
 
+  // The number of rows an AllToAll sends to each device of the team, as a
+  // [team_size] int64 tensor on the device, or nullptr for equal splits
+  TensorView* inputSplits() const {
+    return inputs().size() > 1 ? input(1)->as<TensorView>() : nullptr;
+  }
+
+  // The number of rows an AllToAll receives from each device of the team,
+  // which it writes to this [team_size] int64 tensor
+  TensorView* outputSplits() const {
+    return outputs().size() > 1 ? output(1)->as<TensorView>() : nullptr;
+  }
+
   // PyTorch's process group expects the root to be specified
   // as an integer between 0 and world_size-1. We choose it to be
   // the device's relative index within the team
@@ -124,11 +141,14 @@ class P2PCommunication : public Expr {
  public:
   using Expr::Expr;
 
+  // With CommunicatorBackend::kCuda, the communication is a copy through
+  // CUDA IPC, which requires both peers to be on the same node.
   P2PCommunication(
       IrBuilderPasskey passkey,
       P2PCommunicationType type,
       TensorView* buffer,
-      Val* peer);
+      Val* peer,
+      CommunicatorBackend backend = comm_backend_default);
 
   P2PCommunication(const P2PCommunication& other) = delete;
   P2PCommunication& operator=(const P2PCommunication& other) = delete;
@@ -154,6 +174,10 @@ class P2PCommunication : public Expr {
   Val* peer() const {
     return attributeVal(1);
   }
+
+  CommunicatorBackend backend() const {
+    return attribute<CommunicatorBackend>(2);
+  }
 };
 
 // The method "post" triggers the execution of the communication. This call is
@@ -215,12 +239,71 @@ class P2PCommunication : public Expr {
 // (*) SendRecv
 // Copies the sender's src buffers to the receiver's dst buffer
 // It is equivalent to a Broadcast with a team of size == 2
+// (*) AllToAll
+// Copies the i-th chunk of each device's src buffer to the respective chunk of
+// the i-th device's dst buffer, so the j-th chunk of a dst buffer comes from
+// the j-th device.
+// Requirements:
+//   - all devices have one src buffer and one dst buffer
+//   - all buffers are contiguous and have the same number of elements,
+//     which is divisible by <team_size>
+// With variable split sizes, e.g., to dispatch the tokens of a mixture of
+// experts, the chunks are ranges of rows, i.e., of the outermost dimension.
+// Their sizes are given by `input_splits`, on the device, and the sizes of the
+// received chunks are exchanged first and written to `output_splits`. The
+// received chunks are packed at the front of the dst buffer, whose rows must
+// be enough for them; the remaining rows are left untouched.
+// Reading the split sizes synchronizes the host with the stream.
 c10::intrusive_ptr<c10d::Work> postSingleCommunication(
     Communication* communication,
     DeviceIdxType my_device_index,
     c10d::Backend* backend,
     at::Tensor input_tensor,
-    at::Tensor output_tensor);
+    at::Tensor output_tensor,
+    at::Tensor input_splits = at::Tensor(),
+    at::Tensor output_splits = at::Tensor());
+
+// Posts a communication decomposed along the hierarchy of the 2-D mesh,
+// [number of nodes, devices per node], of its input, so that most of the
+// traffic stays on the intra-node links:
+// (*) Allreduce
+// An intra-node reduce-scatter, an inter-node allreduce of the resulting
+// chunks and an intra-node allgather.
+// (*) Allgather
+// An intra-node allgather followed by an inter-node allgather of the
+// node-level blocks.
+// The intermediate works are waited for before posting the next step, and the
+// returned work completes the communication. Falls back to
+// postSingleCommunication if the mesh is flat, if the team is not the whole
+// mesh, or if the message is too small for the decomposition to pay off.
+c10::intrusive_ptr<c10d::Work> postHierarchicalCommunication(
+    Communication* communication,
+    DeviceIdxType my_device_index,
+    Communicator* communicator,
+    std::optional<CommunicatorBackend> backend_type,
+    at::Tensor input_tensor,
+    at::Tensor output_tensor,
+    at::Tensor input_splits = at::Tensor(),
+    at::Tensor output_splits = at::Tensor());
+
+// Posts a sum Allreduce or ReduceScatter of FP32 or BF16 data compressed to
+// FP8 with an FP32 scale per block of 128 elements.
+// The reduce-scatter is an all-to-all of the compressed chunks, each rank
+// summing the chunks it receives in FP32, and the Allreduce is completed by an
+// allgather of the compressed sums. This moves 2 to 4 times fewer bytes at the
+// cost of the FP8 precision. The intermediate works are waited for before
+// posting the next step. Falls back to postHierarchicalCommunication for other
+// communications, for non-contiguous chunks, or if the number of elements is
+// not a multiple of the team size times the block size.
+c10::intrusive_ptr<c10d::Work> postCompressedCommunication(
+    Communication* communication,
+    DeviceIdxType my_device_index,
+    Communicator* communicator,
+    std::optional<CommunicatorBackend> backend_type,
+    at::Tensor input_tensor,
+    at::Tensor output_tensor,
+    at::Tensor input_splits = at::Tensor(),
+    at::Tensor output_splits = at::Tensor());
 
 c10::intrusive_ptr<c10d::Work> postSingleCommunication(
     P2PCommunication* communication,
@@ -0,0 +1,151 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <multidevice/communication_timeline.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+
+#include <exceptions.h>
+
+namespace nvfuser {
+
+namespace {
+
+// The start and time of each communication of a rank
+std::vector<double> serializeTimeline(const FusionProfile& profile) {
+  std::vector<double> timeline;
+  timeline.reserve(2 * profile.communication_profiles.size());
+  for (const CommunicationProfile& cprof : profile.communication_profiles) {
+    timeline.push_back(cprof.start_ms);
+    timeline.push_back(cprof.time_ms);
+  }
+  return timeline;
+}
+
+std::vector<uint8_t> toBytes(const std::vector<double>& values) {
+  std::vector<uint8_t> bytes(values.size() * sizeof(double));
+  std::memcpy(bytes.data(), values.data(), bytes.size());
+  return bytes;
+}
+
+std::vector<double> fromBytes(const std::vector<uint8_t>& bytes) {
+  NVF_ERROR(
+      bytes.size() % sizeof(double) == 0,
+      "Invalid communication timeline of ",
+      bytes.size(),
+      " bytes");
+  std::vector<double> values(bytes.size() / sizeof(double));
+  std::memcpy(values.data(), bytes.data(), bytes.size());
+  return values;
+}
+
+} // namespace
+
+std::vector<CommunicationTimelineEntry> aggregateCommunicationProfiles(
+    Communicator* communicator,
+    const FusionProfile& profile) {
+  NVF_CHECK(
+      communicator != nullptr && communicator->is_available(),
+      "A valid communicator must be provided");
+  c10d::TCPStore* store = communicator->getTcpStore();
+
+  // Ranks aggregate their profiles in the same order, so a per-process count
+  // keeps the store keys unique and matching
+  static int64_t num_aggregations = 0;
+  const std::string prefix = "nvfuser_communication_timeline_" +
+      std::to_string(num_aggregations++) + "_";
+  store->set(
+      prefix + std::to_string(communicator->deviceId()),
+      toBytes(serializeTimeline(profile)));
+
+  const std::vector<CommunicationProfile>& cprofs =
+      profile.communication_profiles;
+  std::vector<CommunicationTimelineEntry> timeline(cprofs.size());
+  for (size_t i = 0; i < cprofs.size(); ++i) {
+    timeline[i].name = cprofs[i].name;
+    timeline[i].bytes = cprofs[i].bytes;
+  }
+  std::vector<double> min_start_ms(cprofs.size());
+  std::vector<double> max_start_ms(cprofs.size());
+
+  const auto num_ranks = static_cast<int64_t>(communicator->size());
+  for (RankType rank = 0; rank < num_ranks; ++rank) {
+    const std::vector<double> rank_timeline = fromBytes(store->get(
+        prefix + std::to_string(communicator->rankToDiD(rank))));
+    NVF_CHECK(
+        rank_timeline.size() == 2 * cprofs.size(),
+        "Rank ",
+        rank,
+        " profiled ",
+        rank_timeline.size() / 2,
+        " communications but rank ",
+        communicator->deviceId(),
+        " profiled ",
+        cprofs.size());
+    for (size_t i = 0; i < cprofs.size(); ++i) {
+      CommunicationTimelineEntry& entry = timeline[i];
+      const double start_ms = rank_timeline[2 * i];
+      const double time_ms = rank_timeline[2 * i + 1];
+      if (rank == 0) {
+        entry.min_time_ms = time_ms;
+        entry.max_time_ms = time_ms;
+        min_start_ms[i] = start_ms;
+        max_start_ms[i] = start_ms;
+      }
+      entry.min_time_ms = std::min(entry.min_time_ms, time_ms);
+      entry.max_time_ms = std::max(entry.max_time_ms, time_ms);
+      entry.mean_time_ms += time_ms / static_cast<double>(num_ranks);
+      min_start_ms[i] = std::min(min_start_ms[i], start_ms);
+      if (start_ms > max_start_ms[i] || rank == 0) {
+        max_start_ms[i] = start_ms;
+        entry.straggler = rank;
+      }
+      entry.max_end_ms = std::max(entry.max_end_ms, start_ms + time_ms);
+    }
+  }
+
+  for (size_t i = 0; i < timeline.size(); ++i) {
+    timeline[i].start_skew_ms = max_start_ms[i] - min_start_ms[i];
+    timeline[i].serialized =
+        i > 0 && min_start_ms[i] >= timeline[i - 1].max_end_ms;
+  }
+  return timeline;
+}
+
+std::ostream& operator<<(
+    std::ostream& os,
+    const std::vector<CommunicationTimelineEntry>& timeline) {
+  os << std::setfill(' ') << std::left << std::setw(6) << "Com#" << " "
+     << std::setw(14) << "Name" << " " << std::setw(9) << "MB" << " "
+     << std::setw(11) << "MinTime(ms)" << " " << std::setw(12)
+     << "MeanTime(ms)" << " " << std::setw(11) << "MaxTime(ms)" << " "
+     << std::setw(11) << "StartSkew" << " " << std::setw(9) << "Straggler"
+     << " " << "Notes" << std::endl;
+  for (size_t i = 0; i < timeline.size(); ++i) {
+    const CommunicationTimelineEntry& entry = timeline[i];
+    os << std::right << std::fixed << std::setprecision(3) << std::setw(6)
+       << i << " " << std::setw(14) << entry.name << " " << std::setw(9)
+       << static_cast<double>(entry.bytes) * 1.0e-6 << " " << std::setw(11)
+       << entry.min_time_ms << " " << std::setw(12) << entry.mean_time_ms
+       << " " << std::setw(11) << entry.max_time_ms << " " << std::setw(11)
+       << entry.start_skew_ms << " " << std::setw(9) << entry.straggler << " ";
+    // A skew larger than the communication itself means the ranks mostly
+    // waited for the straggler
+    if (entry.start_skew_ms > entry.mean_time_ms) {
+      os << "straggler-bound ";
+    }
+    if (entry.serialized) {
+      os << "serialized";
+    }
+    os << std::endl;
+  }
+  return os;
+}
+
+} // namespace nvfuser
@@ -0,0 +1,52 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fusion_profiler.h>
+#include <multidevice/communicator.h>
+#include <multidevice/multidevice.h>
+#include <visibility.h>
+
+namespace nvfuser {
+
+// Cross-rank view of the i-th communication profiled on every rank. Start
+// times are relative to the start of each rank's profile, so they are only
+// comparable when the ranks start profiling at about the same time, e.g.,
+// right after a barrier.
+struct CommunicationTimelineEntry {
+  std::string name;
+  int64_t bytes = 0;
+  double min_time_ms = 0.0;
+  double mean_time_ms = 0.0;
+  double max_time_ms = 0.0;
+  // Difference between the latest and the earliest start across ranks
+  double start_skew_ms = 0.0;
+  // Rank that started the communication last, which the others waited for
+  RankType straggler = 0;
+  // Latest end across ranks
+  double max_end_ms = 0.0;
+  // True if no rank started the communication before every rank finished the
+  // previous one, i.e., it didn't overlap with the previous communication
+  bool serialized = false;
+};
+
+// Gathers the communication profiles of all ranks through the Communicator's
+// store. Must be called by every rank with profiles of the same host program.
+NVF_API std::vector<CommunicationTimelineEntry> aggregateCommunicationProfiles(
+    Communicator* communicator,
+    const FusionProfile& profile);
+
+NVF_API std::ostream& operator<<(
+    std::ostream& os,
+    const std::vector<CommunicationTimelineEntry>& timeline);
+
+} // namespace nvfuser
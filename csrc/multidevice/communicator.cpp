@@ -6,10 +6,18 @@
  */
 // clang-format on
 #include <cuda_utils.h>
+#include <multidevice/backend_table.h>
 #include <multidevice/communicator.h>
 #include <options.h>
 
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/util/irange.h>
+
 #include <netdb.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
 #include <map>
 
 #ifdef NVFUSER_DISTRIBUTED
@@ -38,6 +46,9 @@ std::ostream& operator<<(std::ostream& out, const CommunicatorBackend& cb) {
     case CommunicatorBackend::kGloo:
       out << "GLOO";
       break;
+    case CommunicatorBackend::kCuda:
+      out << "CUDA";
+      break;
   }
   return out;
 }
@@ -170,6 +181,91 @@ c10::intrusive_ptr<c10d::Backend> createBackend(
   NVF_THROW("no distributed backend available");
 }
 #endif
+
+// Message sizes of the calibration, from 1KiB to 64MiB
+constexpr int64_t kMinLog2CalibratedBytes = 10;
+constexpr int64_t kMaxLog2CalibratedBytes = 26;
+constexpr int64_t kLog2CalibratedBytesStride = 2;
+constexpr int64_t kNumCalibrationWarmups = 2;
+constexpr int64_t kNumCalibrationIterations = 10;
+
+// Returns the average time in seconds of a collective of all the ranks of the
+// backend, where each rank sends message_bytes
+double timeCollective(
+    c10d::Backend* backend,
+    CommunicationType type,
+    int64_t message_bytes,
+    const at::TensorOptions& options) {
+  const int64_t team_size = backend->getSize();
+  const int64_t chunk_numel = std::max<int64_t>(
+      message_bytes / (int64_t)sizeof(float) / team_size, 1);
+  std::vector<at::Tensor> inputs = {
+      at::empty({chunk_numel * team_size}, options)};
+  std::vector<std::vector<at::Tensor>> gathered = {
+      std::vector<at::Tensor>(team_size)};
+  for (auto& tensor : gathered.at(0)) {
+    tensor = at::empty_like(inputs.at(0));
+  }
+  std::vector<at::Tensor> scattered = {at::empty({chunk_numel}, options)};
+  std::vector<std::vector<at::Tensor>> chunks = {
+      at::tensor_split(inputs.at(0), team_size)};
+
+  auto post = [&]() -> c10::intrusive_ptr<c10d::Work> {
+    switch (type) {
+      case CommunicationType::Allgather:
+        return backend->allgather(gathered, inputs, {});
+      case CommunicationType::Allreduce:
+        return backend->allreduce(inputs, {.reduceOp = c10d::ReduceOp::SUM});
+      case CommunicationType::ReduceScatter:
+        return backend->reduce_scatter(
+            scattered, chunks, {.reduceOp = c10d::ReduceOp::SUM});
+      default:
+        NVF_THROW("The backend of a ", type, " isn't calibrated");
+    }
+  };
+
+  for ([[maybe_unused]] auto _ : c10::irange(kNumCalibrationWarmups)) {
+    post()->wait();
+  }
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceSynchronize());
+  using clock = std::chrono::steady_clock;
+  const auto start = clock::now();
+  for ([[maybe_unused]] auto _ : c10::irange(kNumCalibrationIterations)) {
+    post()->wait();
+  }
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceSynchronize());
+  return std::chrono::duration<double>(clock::now() - start).count() /
+      kNumCalibrationIterations;
+}
+
+#ifdef NVFUSER_DISTRIBUTED
+// The table depends on the GPU and the topology, e.g.,
+// NVIDIA_H100_80GB_HBM3_2x8.tsv for two nodes of eight GPUs
+std::string backendTablePath(int64_t size, int64_t local_size) {
+  std::filesystem::path directory =
+      std::filesystem::temp_directory_path() / "nvfuser_communicator_backends";
+  const auto& args =
+      getEnableOptionArguments(EnableOption::CommunicatorBackendTable);
+  if (!args.empty()) {
+    directory = args.at(0);
+  }
+  std::error_code error;
+  // Another process may create the directory concurrently
+  std::filesystem::create_directories(directory, error);
+
+  std::string gpu = at::cuda::getCurrentDeviceProperties()->name;
+  std::replace_if(
+      gpu.begin(),
+      gpu.end(),
+      [](unsigned char c) { return !std::isalnum(c); },
+      '_');
+  return (directory /
+          (gpu + "_" + std::to_string(size / local_size) + "x" +
+           std::to_string(local_size) + ".tsv"))
+      .string();
+}
+#endif
+
 } // namespace
 
 Communicator::Communicator(
@@ -222,6 +318,25 @@ Communicator::Communicator(
 #ifdef USE_C10D_NCCL
   nccl_available_ = true;
 #endif
+
+#ifdef NVFUSER_DISTRIBUTED
+  if (isOptionEnabled(EnableOption::CommunicatorBackendTable)) {
+    const std::string file_path = backendTablePath(size_, local_size_);
+    auto table = CommunicatorBackendTable::load(file_path);
+    // Calibrate unless every process found the table, e.g., on a file system
+    // that isn't shared between nodes
+    const int found_table = table.has_value() && !table->empty();
+    at::Tensor found = at::full({1}, found_table, at::kInt).to(device());
+    std::vector<at::Tensor> founds = {found};
+    getWorld()->allreduce(founds, {.reduceOp = c10d::ReduceOp::MIN})->wait();
+    if (found.item<int>() == 1) {
+      backend_table_ =
+          std::make_unique<CommunicatorBackendTable>(std::move(table.value()));
+    } else {
+      calibrateBackends(file_path);
+    }
+  }
+#endif
 }
 
 void Communicator::cleanup() {
@@ -271,6 +386,9 @@ c10d::Backend* Communicator::getBackendForTeam(
       "or the instance wasn't successfully initialized.");
 
   CommunicatorBackend b = getBackend(backend);
+  NVF_ERROR(
+      b != CommunicatorBackend::kCuda,
+      "CUDA IPC is not a c10d backend and only supports P2PCommunication");
   // generate a string key which is unique to the team
   // create the team and cache it
   std::string team_key = prefix + getTeamKey(team, b);
@@ -307,6 +425,82 @@ c10d::Backend* Communicator::getWorld(
   return getBackendForTeam(all_ranks, backend);
 }
 
+CommunicatorBackend Communicator::selectBackend(
+    CommunicationType type,
+    int64_t team_size,
+    int64_t message_bytes) const {
+  if (backend_table_ == nullptr ||
+      !isOptionEnabled(EnableOption::CommunicatorBackendTable) ||
+      !CommunicatorBackendTable::isTunable(type)) {
+    return default_backend_;
+  }
+  auto backend = backend_table_->lookup(type, team_size, message_bytes);
+  if (!backend.has_value() || !isBackendAvailable(backend.value())) {
+    return default_backend_;
+  }
+  return backend.value();
+}
+
+void Communicator::calibrateBackends(const std::string& file_path) {
+  NVF_ERROR(
+      is_available(),
+      "The singleton Communicator isn't available to calibrate its backends");
+  std::vector<CommunicatorBackend> backends;
+  for (auto backend : {CommunicatorBackend::kNccl, CommunicatorBackend::kUcc}) {
+    if (isBackendAvailable(backend)) {
+      backends.push_back(backend);
+    }
+  }
+  const std::vector<CommunicationType> types = {
+      CommunicationType::Allgather,
+      CommunicationType::Allreduce,
+      CommunicationType::ReduceScatter};
+
+  const auto options = at::TensorOptions().dtype(at::kFloat).device(device());
+  std::vector<double> times;
+  for (auto type : types) {
+    for (int64_t log2 = kMinLog2CalibratedBytes;
+         log2 <= kMaxLog2CalibratedBytes;
+         log2 += kLog2CalibratedBytesStride) {
+      for (auto backend : backends) {
+        times.push_back(timeCollective(
+            getWorld(backend), type, (int64_t)1 << log2, options));
+      }
+    }
+  }
+  // A collective takes as long as its slowest rank. Selecting on those times
+  // also makes all the processes select the same backends.
+  at::Tensor times_tensor = at::tensor(times, at::kDouble).to(device());
+  std::vector<at::Tensor> all_times = {times_tensor};
+  getWorld()->allreduce(all_times, {.reduceOp = c10d::ReduceOp::MAX})->wait();
+  times_tensor = times_tensor.cpu();
+  const auto* slowest_times = times_tensor.data_ptr<double>();
+
+  auto table = std::make_unique<CommunicatorBackendTable>();
+  for (auto type : types) {
+    for (int64_t log2 = kMinLog2CalibratedBytes;
+         log2 <= kMaxLog2CalibratedBytes;
+         log2 += kLog2CalibratedBytesStride) {
+      const auto fastest = std::min_element(
+          slowest_times, slowest_times + (int64_t)backends.size());
+      table->set(
+          type,
+          size_,
+          (int64_t)1 << log2,
+          backends.at(std::distance(slowest_times, fastest)));
+      slowest_times += (int64_t)backends.size();
+    }
+  }
+  backend_table_ = std::move(table);
+
+  if (!file_path.empty() && deviceId() == 0) {
+    NVF_CHECK(
+        backend_table_->save(file_path),
+        "Unable to save the communicator backend table to ",
+        file_path);
+  }
+}
+
 void Communicator::barrier(std::optional<CommunicatorBackend> backend) {
   // Explicitly specify the (local) device ID to avoid a warning. Without this,
   // ProcessGroupNCCL::barrier may guess the wrong mapping and failed to block
@@ -22,8 +22,14 @@
 #endif
 #include <visibility.h>
 
+#include <memory>
+#include <string>
+
 namespace nvfuser {
 
+enum class CommunicationType;
+class CommunicatorBackendTable;
+
 // This file implements the class Communicator which sets up the inter-process
 // Backend. This class contains inter-process information, such as the rank, the
 // world size, as well as the Process Group that can be called to perform
@@ -37,7 +43,9 @@ namespace nvfuser {
 using RankType = DeviceIdxType;
 
 // Supported backends. TODO: gloo untested
-enum class CommunicatorBackend { kNccl, kUcc, kGloo };
+// kCuda is not a c10d backend: it implements P2PCommunication between
+// processes of the same node through CUDA IPC, see multidevice/ipc_handle.h
+enum class CommunicatorBackend { kNccl, kUcc, kGloo, kCuda };
 
 std::ostream& operator<<(std::ostream& out, const CommunicatorBackend& cb);
 
@@ -97,6 +105,26 @@ class Communicator {
     default_backend_ = backend;
   }
 
+  // returns the backend of a collective of a team, where each rank sends
+  // message_bytes. This is the backend selected by the backend table,
+  // calibrated with NVFUSER_ENABLE=communicator_backend_table, if it holds the
+  // collective, and the default backend otherwise.
+  CommunicatorBackend selectBackend(
+      CommunicationType type,
+      int64_t team_size,
+      int64_t message_bytes) const;
+
+  // times the collectives of the world selected by message size on every
+  // available backend, and fills the backend table with the fastest backend
+  // for each message size. All the processes must call it. The table is
+  // saved to file_path, if not empty.
+  void calibrateBackends(const std::string& file_path = "");
+
+  // returns the backend table, or nullptr if the backends weren't calibrated
+  const CommunicatorBackendTable* backendTable() const {
+    return backend_table_.get();
+  }
+
   // performs a blocking barrier in the communicator
   void barrier(std::optional<CommunicatorBackend> backend = std::nullopt);
 
@@ -131,12 +159,26 @@ class Communicator {
   c10d::Backend* getWorld(
       std::optional<CommunicatorBackend> backend = std::nullopt);
 
+  // returns the store shared by all the processes, e.g., to exchange IPC
+  // handles
+  c10d::TCPStore* getTcpStore() {
+    return store_.get();
+  }
+
+  // returns whether a device is handled by a process on the same node as the
+  // current process
+  bool isOnSameNode(DeviceIdxType d_id) const {
+    return dIdToRank(d_id) / local_size_ == rank_ / local_size_;
+  }
+
   // returns if a backend is available for creation
   bool isBackendAvailable(CommunicatorBackend backend) const {
     if (backend == CommunicatorBackend::kUcc) {
       return ucc_available_;
     } else if (backend == CommunicatorBackend::kNccl) {
       return nccl_available_;
+    } else if (backend == CommunicatorBackend::kCuda) {
+      return is_available_;
     }
     return false;
   }
@@ -174,6 +216,7 @@ class Communicator {
   c10::intrusive_ptr<c10d::TCPStore> store_;
   // cache for the created backends. The keys are strings generated from Teams
   std::unordered_map<std::string, c10::intrusive_ptr<c10d::Backend>> backends_;
+  std::unique_ptr<CommunicatorBackendTable> backend_table_;
 };
 
 } // namespace nvfuser
@@ -8,6 +8,7 @@
 
 #include <multidevice/device_mesh.h>
 
+#include <functional>
 #include <numeric>
 #include <unordered_set>
 
@@ -26,8 +27,17 @@ DeviceMesh::DeviceMesh(std::initializer_list<DeviceIdxType> devices) {
   setDevices(std::vector<DeviceIdxType>(devices));
 }
 
-void DeviceMesh::setDevices(std::vector<DeviceIdxType> devices) {
+DeviceMesh::DeviceMesh(
+    std::vector<DeviceIdxType> devices,
+    std::vector<int64_t> shape) {
+  setDevices(std::move(devices), std::move(shape));
+}
+
+void DeviceMesh::setDevices(
+    std::vector<DeviceIdxType> devices,
+    std::optional<std::vector<int64_t>> shape) {
   vector_ = std::move(devices);
+  shape_ = shape.value_or(std::vector<int64_t>{size()});
 
   std::unordered_set<DeviceIdxType> unique_devices(
       vector_.begin(), vector_.end());
@@ -35,6 +45,42 @@ void DeviceMesh::setDevices(std::vector<DeviceIdxType> devices) {
       unique_devices.size() == vector_.size(),
       "Device mesh has duplicates: ",
       vector_);
+  NVF_ERROR(!shape_.empty(), "Device mesh must have at least one dimension");
+  NVF_ERROR(
+      std::accumulate(
+          shape_.begin(), shape_.end(), int64_t{1}, std::multiplies<>()) ==
+          size(),
+      "Device mesh shape ",
+      shape_,
+      " does not match its number of devices: ",
+      vector_);
+}
+
+std::vector<DeviceIdxType> DeviceMesh::getSlice(
+    const int64_t axis,
+    const DeviceIdxType device) const {
+  NVF_ERROR(
+      axis >= 0 && axis < rank(),
+      "Axis ",
+      axis,
+      " is out of bounds for a mesh of rank ",
+      rank());
+  const int64_t index = idxOf(device);
+  NVF_ERROR(index != -1, "Device ", device, " is not in ", *this);
+
+  int64_t stride = 1;
+  for (int64_t i = rank() - 1; i > axis; i--) {
+    stride *= shape_.at(i);
+  }
+  // The index of the device with coordinate 0 along axis
+  const int64_t first = index - (index / stride) % shape_.at(axis) * stride;
+
+  std::vector<DeviceIdxType> slice;
+  slice.reserve(shape_.at(axis));
+  for (int64_t i = 0; i < shape_.at(axis); i++) {
+    slice.push_back(vector_.at(first + i * stride));
+  }
+  return slice;
 }
 
 /*static*/ DeviceMesh DeviceMesh::createForNumDevices(
@@ -45,7 +91,11 @@ void DeviceMesh::setDevices(std::vector<DeviceIdxType> devices) {
 }
 
 std::ostream& operator<<(std::ostream& out, const DeviceMesh& mesh) {
-  out << "DeviceMesh{" << mesh.vector() << "}";
+  out << "DeviceMesh{";
+  if (mesh.rank() > 1) {
+    out << "shape=" << mesh.shape() << ", ";
+  }
+  out << mesh.vector() << "}";
   return out;
 }
 
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <optional>
 #include <vector>
 
 #include <exceptions.h>
@@ -18,8 +19,11 @@
 namespace nvfuser {
 
 // The class DeviceMesh represents a set of (unique) devices on which a Pipeline
-// Stage will be executed. For now, we only support flat meshes, but later we
-// will add support for n-dimensional meshes.
+// Stage will be executed. The devices are laid out in a row-major
+// n-dimensional shape that models the topology of the cluster, e.g.,
+// [number of nodes, devices per node]. Sharding is still 1-D: DIDx shards
+// across all the devices of the mesh regardless of its shape. The shape is
+// used to decompose collectives along the hierarchy of the network.
 class DeviceMesh final {
  public:
   // https://google.github.io/styleguide/cppguide.html#Implicit_Conversions
@@ -34,6 +38,9 @@ class DeviceMesh final {
   // mesh = {1, 2};`, which is more concise.
   explicit DeviceMesh(std::vector<DeviceIdxType> devices = {});
   DeviceMesh(std::initializer_list<DeviceIdxType> devices);
+  // Creates a mesh of the given shape. The product of the shape must be the
+  // number of devices.
+  DeviceMesh(std::vector<DeviceIdxType> devices, std::vector<int64_t> shape);
   DeviceMesh(const DeviceMesh&) = default;
   DeviceMesh(DeviceMesh&&) = default;
   DeviceMesh& operator=(const DeviceMesh&) = default;
@@ -51,6 +58,22 @@ class DeviceMesh final {
 
   int64_t size(ParallelType parallel_type) const;
 
+  // Returns the shape of the mesh. A flat mesh has a 1-D shape.
+  const std::vector<int64_t>& shape() const {
+    return shape_;
+  }
+
+  // Returns the number of dimensions of the mesh
+  int64_t rank() const {
+    return static_cast<int64_t>(shape_.size());
+  }
+
+  // Returns the devices whose coordinates match the ones of device except
+  // along axis, ordered by their coordinate along axis. For example, in a
+  // [number of nodes, devices per node] mesh, getSlice(1, device) returns the
+  // devices on the same node as device.
+  std::vector<DeviceIdxType> getSlice(int64_t axis, DeviceIdxType device) const;
+
   // Returns a vector containing the device indices of the mesh
   const std::vector<DeviceIdxType>& vector() const {
     return vector_;
@@ -76,18 +99,22 @@ class DeviceMesh final {
   }
 
   bool operator==(const DeviceMesh& other) const {
-    return vector_ == other.vector();
+    return vector_ == other.vector() && shape_ == other.shape();
   }
 
   bool operator!=(const DeviceMesh& other) const {
-    return vector_ != other.vector();
+    return !(*this == other);
   }
 
  private:
-  void setDevices(std::vector<DeviceIdxType> devices);
+  void setDevices(
+      std::vector<DeviceIdxType> devices,
+      std::optional<std::vector<int64_t>> shape = std::nullopt);
 
   // stores the list of device indices
   std::vector<DeviceIdxType> vector_;
+  // stores the shape of the mesh, whose product is the size of vector_
+  std::vector<int64_t> shape_;
 };
 
 std::ostream& operator<<(std::ostream& out, const DeviceMesh& mesh);
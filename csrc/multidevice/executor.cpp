@@ -23,10 +23,11 @@ namespace nvfuser {
 MultiDeviceExecutor::MultiDeviceExecutor(
     std::unique_ptr<Fusion> fusion,
     Communicator& comm,
-    hir::HostIrEvaluatorParams params)
+    hir::HostIrEvaluatorParams params,
+    const PipelineParams& pipeline_params)
     : comm_(comm) {
-  std::unique_ptr<hir::HostIrContainer> hic =
-      HostIrLower::lower(std::move(fusion), comm.deviceId());
+  std::unique_ptr<hir::HostIrContainer> hic = HostIrLower::lower(
+      std::move(fusion), comm.deviceId(), pipeline_params);
   // Create the HostIrEvaluator representing the host program
   host_ir_executor_ =
       std::make_unique<hir::HostIrEvaluator>(std::move(hic), &comm, params);
@@ -12,6 +12,7 @@
 #include <fusion.h>
 #include <fusion_segmenter.h>
 #include <host_ir/executor.h>
+#include <host_ir/pipeline.h>
 #include <ir/cloner.h>
 #include <multidevice/communication.h>
 #include <multidevice/communicator.h>
@@ -48,6 +49,8 @@ namespace nvfuser {
          can be either a "Set" or "Reduce" Exprs.
   - the runtime order of execution of the different segments is computed in
     prepareRuntimeOrder
+  - if pipeline_params.num_micro_batches is larger than 1, the segments are
+    grouped into pipeline stages computed on micro-batches, see PipelineParams
 
   II. At runtime, through the method runWithInput:
   - allocateRecvBuffers allocates on each device the necessary buffers to
@@ -74,7 +77,8 @@ class MultiDeviceExecutor {
   MultiDeviceExecutor(
       std::unique_ptr<Fusion> fusion,
       Communicator& comm,
-      hir::HostIrEvaluatorParams params = hir::HostIrEvaluatorParams());
+      hir::HostIrEvaluatorParams params = hir::HostIrEvaluatorParams(),
+      const PipelineParams& pipeline_params = PipelineParams());
 
   // Run the fusion on several devices with the given global inputs
   std::vector<at::Tensor> runWithInput(const std::vector<c10::IValue>& inputs);
@@ -0,0 +1,186 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <multidevice/ipc_handle.h>
+
+#include <cstring>
+#include <vector>
+
+#include <cuda_utils.h>
+#include <exceptions.h>
+
+namespace nvfuser {
+
+namespace {
+
+// The semaphore is padded so that the staging area is well aligned
+constexpr int64_t kSemaphoreBytes = 256;
+
+enum class IpcSemaphore : cuuint32_t { kIdle = 0, kReady = 1 };
+
+void waitSemaphore(void* semaphore, IpcSemaphore value, cudaStream_t stream) {
+#if (CUDA_VERSION >= 12000)
+  NVFUSER_CUDA_SAFE_CALL(cuStreamWaitValue32(
+      stream,
+      reinterpret_cast<CUdeviceptr>(semaphore),
+      static_cast<cuuint32_t>(value),
+      CU_STREAM_WAIT_VALUE_EQ));
+#else
+  NVF_THROW("CUDA IPC communications require CUDA 12 or newer");
+#endif
+}
+
+void writeSemaphore(void* semaphore, IpcSemaphore value, cudaStream_t stream) {
+#if (CUDA_VERSION >= 12000)
+  // The default flags make the prior copies visible before the write
+  NVFUSER_CUDA_SAFE_CALL(cuStreamWriteValue32(
+      stream,
+      reinterpret_cast<CUdeviceptr>(semaphore),
+      static_cast<cuuint32_t>(value),
+      CU_STREAM_WRITE_VALUE_DEFAULT));
+#else
+  NVF_THROW("CUDA IPC communications require CUDA 12 or newer");
+#endif
+}
+
+} // namespace
+
+IpcP2pChannel::IpcP2pChannel(
+    Communicator* communicator,
+    DeviceIdxType sender,
+    DeviceIdxType receiver,
+    int64_t size_in_bytes,
+    const std::string& key)
+    : is_sender_(communicator->deviceId() == sender),
+      size_in_bytes_(size_in_bytes) {
+  NVF_ERROR(
+      communicator->deviceId() == sender ||
+          communicator->deviceId() == receiver,
+      "Device ",
+      communicator->deviceId(),
+      " is neither the sender nor the receiver of the channel ",
+      key);
+  NVF_CHECK(
+      communicator->isOnSameNode(is_sender_ ? receiver : sender),
+      "CUDA IPC requires the devices ",
+      sender,
+      " and ",
+      receiver,
+      " to be on the same node");
+
+  // The sender exports the buffer before it enqueues anything, so a send
+  // never waits for its peer. Only the receiver blocks in the store, until
+  // the sender has posted its first send on the channel.
+  c10d::TCPStore* store = communicator->getTcpStore();
+  if (!is_sender_) {
+    std::vector<uint8_t> serialized_handle = store->get(key);
+    NVF_ERROR(
+        serialized_handle.size() == sizeof(cudaIpcMemHandle_t),
+        "Invalid IPC handle for the channel ",
+        key);
+    cudaIpcMemHandle_t handle;
+    std::memcpy(&handle, serialized_handle.data(), sizeof(handle));
+    NVFUSER_CUDA_RT_SAFE_CALL(
+        cudaIpcOpenMemHandle(&base_, handle, cudaIpcMemLazyEnablePeerAccess));
+    return;
+  }
+
+  NVFUSER_CUDA_RT_SAFE_CALL(
+      cudaMalloc(&base_, kSemaphoreBytes + size_in_bytes));
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaMemset(base_, 0, kSemaphoreBytes));
+  // The semaphore must be kIdle before the receiver can see the buffer
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceSynchronize());
+  cudaIpcMemHandle_t handle;
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaIpcGetMemHandle(&handle, base_));
+  const auto* handle_bytes = reinterpret_cast<const uint8_t*>(&handle);
+  store->set(
+      key, std::vector<uint8_t>(handle_bytes, handle_bytes + sizeof(handle)));
+}
+
+IpcP2pChannel::~IpcP2pChannel() {
+  if (base_ == nullptr) {
+    return;
+  }
+  // Errors can't be thrown from a destructor, and they are not actionable at
+  // this point anyway
+  if (is_sender_) {
+    cudaFree(base_);
+  } else {
+    cudaIpcCloseMemHandle(base_);
+  }
+}
+
+void* IpcP2pChannel::stagingArea() const {
+  return static_cast<uint8_t*>(base_) + kSemaphoreBytes;
+}
+
+void IpcP2pChannel::send(const at::Tensor& buffer, cudaStream_t stream) {
+  NVF_ERROR(is_sender_, "Only the sender of a channel can send");
+  NVF_CHECK(
+      buffer.is_contiguous() &&
+          static_cast<int64_t>(buffer.nbytes()) == size_in_bytes_,
+      "Expected a contiguous buffer of ",
+      size_in_bytes_,
+      " bytes, but got ",
+      buffer.sizes());
+  waitSemaphore(semaphore(), IpcSemaphore::kIdle, stream);
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaMemcpyAsync(
+      stagingArea(),
+      buffer.data_ptr(),
+      size_in_bytes_,
+      cudaMemcpyDeviceToDevice,
+      stream));
+  writeSemaphore(semaphore(), IpcSemaphore::kReady, stream);
+}
+
+void IpcP2pChannel::recv(const at::Tensor& buffer, cudaStream_t stream) {
+  NVF_ERROR(!is_sender_, "Only the receiver of a channel can receive");
+  NVF_CHECK(
+      buffer.is_contiguous() &&
+          static_cast<int64_t>(buffer.nbytes()) == size_in_bytes_,
+      "Expected a contiguous buffer of ",
+      size_in_bytes_,
+      " bytes, but got ",
+      buffer.sizes());
+  waitSemaphore(semaphore(), IpcSemaphore::kReady, stream);
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaMemcpyAsync(
+      buffer.data_ptr(),
+      stagingArea(),
+      size_in_bytes_,
+      cudaMemcpyDeviceToDevice,
+      stream));
+  writeSemaphore(semaphore(), IpcSemaphore::kIdle, stream);
+}
+
+IpcP2pChannel& IpcP2pChannelCache::get(
+    DeviceIdxType sender,
+    DeviceIdxType receiver,
+    int64_t size_in_bytes) {
+  std::string key = "nvfuser_ipc_" + std::to_string(sender) + "_" +
+      std::to_string(receiver) + "_" + std::to_string(size_in_bytes);
+  auto it = channels_.find(key);
+  if (it != channels_.end()) {
+    return *it->second;
+  }
+
+  // Several caches, e.g., one per HostIrEvaluator, may create the same
+  // channel. Peers create them in the same order, so a per-process count
+  // keeps the store keys unique and matching.
+  static std::unordered_map<std::string, int64_t> num_created_channels;
+  const std::string store_key =
+      key + "_" + std::to_string(num_created_channels[key]++);
+  auto inserted_it =
+      channels_
+          .emplace(
+              key,
+              std::make_unique<IpcP2pChannel>(
+                  communicator_, sender, receiver, size_in_bytes, store_key))
+          .first;
+  return *inserted_it->second;
+}
+
+} // namespace nvfuser
@@ -0,0 +1,87 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <ATen/core/Tensor.h>
+#include <cuda_runtime.h>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include <multidevice/communicator.h>
+#include <multidevice/multidevice.h>
+
+namespace nvfuser {
+
+// Implements a P2PCommunication between two processes of the same node with
+// CUDA IPC, which avoids the staging and the launch latency of c10d backends
+// for small messages.
+//
+// The sender allocates, outside of the caching allocator so it can be
+// exported, a buffer made of a semaphore followed by a staging area. Its IPC
+// handle is published once through the Communicator's store and the receiver
+// maps it in its address space, so the sender never waits for the receiver
+// on the host. Transfers are then entirely enqueued on the current streams of
+// both peers, without any host synchronization:
+//   - the sender waits for the semaphore to be kIdle, copies its buffer into
+//     the staging area and sets the semaphore to kReady;
+//   - the receiver waits for the semaphore to be kReady, copies the remote
+//     staging area into its buffer over NVLink and resets the semaphore to
+//     kIdle.
+// Successive transfers on a channel are therefore serialized in FIFO order.
+class IpcP2pChannel {
+ public:
+  // Must be called by both the sender and the receiver.
+  IpcP2pChannel(
+      Communicator* communicator,
+      DeviceIdxType sender,
+      DeviceIdxType receiver,
+      int64_t size_in_bytes,
+      const std::string& key);
+  ~IpcP2pChannel();
+
+  IpcP2pChannel(const IpcP2pChannel&) = delete;
+  IpcP2pChannel& operator=(const IpcP2pChannel&) = delete;
+  IpcP2pChannel(IpcP2pChannel&&) = delete;
+  IpcP2pChannel& operator=(IpcP2pChannel&&) = delete;
+
+  void send(const at::Tensor& buffer, cudaStream_t stream);
+  void recv(const at::Tensor& buffer, cudaStream_t stream);
+
+ private:
+  void* semaphore() const {
+    return base_;
+  }
+  void* stagingArea() const;
+
+  const bool is_sender_;
+  const int64_t size_in_bytes_;
+  // Allocated by the sender and mapped by the receiver
+  void* base_ = nullptr;
+};
+
+// Creates the channels of a process on first use and caches them. A channel
+// is identified by its sender, its receiver and its message size, which both
+// peers know without further coordination.
+class IpcP2pChannelCache {
+ public:
+  explicit IpcP2pChannelCache(Communicator* communicator)
+      : communicator_(communicator) {}
+
+  IpcP2pChannel& get(
+      DeviceIdxType sender,
+      DeviceIdxType receiver,
+      int64_t size_in_bytes);
+
+ private:
+  Communicator* communicator_;
+  std::unordered_map<std::string, std::unique_ptr<IpcP2pChannel>> channels_;
+};
+
+} // namespace nvfuser
@@ -0,0 +1,191 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <multidevice/symmetric_tensor.h>
+
+#include <ATen/EmptyTensor.h>
+#include <ATen/ops/from_blob.h>
+
+#include <cstring>
+#include <string>
+
+#include <cuda_utils.h>
+#include <exceptions.h>
+#include <utils.h>
+
+namespace nvfuser {
+
+namespace {
+
+// The signals are padded so that the tensor is well aligned
+constexpr int64_t kSignalAlignment = 256;
+
+int64_t signalBytes(int64_t num_signals) {
+  return roundUpToMultiple(
+      num_signals * (int64_t)sizeof(uint32_t), kSignalAlignment);
+}
+
+void* signalOf(void* buffer, int64_t index) {
+  return static_cast<uint32_t*>(buffer) + index;
+}
+
+void* tensorOf(void* buffer, int64_t num_signals) {
+  return static_cast<uint8_t*>(buffer) + signalBytes(num_signals);
+}
+
+} // namespace
+
+SymmetricTensor::SymmetricTensor(
+    Communicator* communicator,
+    const std::vector<int64_t>& sizes,
+    const std::vector<int64_t>& strides,
+    at::ScalarType dtype)
+    : communicator_(communicator),
+      sizes_(sizes),
+      strides_(strides),
+      dtype_(dtype) {
+  NVF_CHECK(
+      communicator->is_available(),
+      "Symmetric tensors require a valid communicator");
+  const int64_t local_size = communicator->local_size();
+  const int64_t my_index = localIndex(communicator->deviceId());
+  const DeviceIdxType first_device = communicator->deviceId() - my_index;
+  const int64_t nbytes = signalBytes(local_size) +
+      (int64_t)at::detail::computeStorageNbytes(
+          sizes, strides, c10::elementSize(dtype));
+
+  // The processes of a node allocate their symmetric tensors in the same
+  // order, so a per-process count keeps the store keys unique and matching
+  static int64_t num_created_tensors = 0;
+  const std::string key_prefix =
+      "nvfuser_symmetric_" + std::to_string(num_created_tensors++) + "_";
+
+  buffers_.resize(local_size, nullptr);
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaMalloc(&buffers_.at(my_index), nbytes));
+  NVFUSER_CUDA_RT_SAFE_CALL(
+      cudaMemset(buffers_.at(my_index), 0, signalBytes(local_size)));
+  // The signals must be reset before the peers can see the buffer
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceSynchronize());
+  cudaIpcMemHandle_t handle;
+  NVFUSER_CUDA_RT_SAFE_CALL(
+      cudaIpcGetMemHandle(&handle, buffers_.at(my_index)));
+  const auto* handle_bytes = reinterpret_cast<const uint8_t*>(&handle);
+  c10d::TCPStore* store = communicator->getTcpStore();
+  store->set(
+      key_prefix + std::to_string(communicator->deviceId()),
+      std::vector<uint8_t>(handle_bytes, handle_bytes + sizeof(handle)));
+
+  for (int64_t index = 0; index < local_size; index++) {
+    if (index == my_index) {
+      continue;
+    }
+    const DeviceIdxType peer = first_device + index;
+    std::vector<uint8_t> serialized_handle =
+        store->get(key_prefix + std::to_string(peer));
+    NVF_ERROR(
+        serialized_handle.size() == sizeof(cudaIpcMemHandle_t),
+        "Invalid IPC handle for the symmetric tensor of device ",
+        peer);
+    cudaIpcMemHandle_t peer_handle;
+    std::memcpy(&peer_handle, serialized_handle.data(), sizeof(peer_handle));
+    NVFUSER_CUDA_RT_SAFE_CALL(cudaIpcOpenMemHandle(
+        &buffers_.at(index), peer_handle, cudaIpcMemLazyEnablePeerAccess));
+  }
+
+  // Tensors of peers are accessed from the current device, whose address
+  // space they are mapped in
+  auto options =
+      at::TensorOptions().dtype(dtype).device(communicator->device());
+  tensors_.reserve(local_size);
+  for (void* buffer : buffers_) {
+    tensors_.push_back(
+        at::from_blob(tensorOf(buffer, local_size), sizes, strides, options));
+  }
+  local_tensor_ = tensors_.at(my_index);
+  num_sent_.resize(local_size, 0);
+  num_waited_.resize(local_size, 0);
+}
+
+SymmetricTensor::~SymmetricTensor() {
+  // Errors can't be thrown from a destructor, and they are not actionable at
+  // this point anyway
+  const int64_t my_index = localIndex(communicator_->deviceId());
+  for (auto index : c10::irange((int64_t)buffers_.size())) {
+    if (buffers_.at(index) == nullptr) {
+      continue;
+    }
+    if (index == my_index) {
+      cudaFree(buffers_.at(index));
+    } else {
+      cudaIpcCloseMemHandle(buffers_.at(index));
+    }
+  }
+}
+
+int64_t SymmetricTensor::localIndex(DeviceIdxType device) const {
+  return device % communicator_->local_size();
+}
+
+void SymmetricTensor::checkIsOnSameNode(DeviceIdxType peer) const {
+  NVF_CHECK(
+      communicator_->isOnSameNode(peer),
+      "Device ",
+      peer,
+      " is not on the same node as device ",
+      communicator_->deviceId());
+}
+
+const at::Tensor& SymmetricTensor::remoteTensor(DeviceIdxType peer) const {
+  checkIsOnSameNode(peer);
+  return tensors_.at(localIndex(peer));
+}
+
+void SymmetricTensor::signal(DeviceIdxType peer, cudaStream_t stream) {
+  checkIsOnSameNode(peer);
+  const int64_t peer_index = localIndex(peer);
+  // The peer holds one signal per process of the node
+  void* peer_signal = signalOf(
+      buffers_.at(peer_index), localIndex(communicator_->deviceId()));
+  const uint32_t value = ++num_sent_.at(peer_index);
+#if (CUDA_VERSION >= 12000)
+  // The default flags make the prior writes visible before the signal
+  NVFUSER_CUDA_SAFE_CALL(cuStreamWriteValue32(
+      stream,
+      reinterpret_cast<CUdeviceptr>(peer_signal),
+      static_cast<cuuint32_t>(value),
+      CU_STREAM_WRITE_VALUE_DEFAULT));
+#else
+  NVF_THROW("Symmetric tensors require CUDA 12 or newer");
+#endif
+}
+
+void SymmetricTensor::waitSignal(DeviceIdxType peer, cudaStream_t stream) {
+  checkIsOnSameNode(peer);
+  const int64_t peer_index = localIndex(peer);
+  void* signal = signalOf(
+      buffers_.at(localIndex(communicator_->deviceId())), peer_index);
+  const uint32_t value = ++num_waited_.at(peer_index);
+#if (CUDA_VERSION >= 12000)
+  // GEQ compares cyclically, so the counters may wrap around
+  NVFUSER_CUDA_SAFE_CALL(cuStreamWaitValue32(
+      stream,
+      reinterpret_cast<CUdeviceptr>(signal),
+      static_cast<cuuint32_t>(value),
+      CU_STREAM_WAIT_VALUE_GEQ));
+#else
+  NVF_THROW("Symmetric tensors require CUDA 12 or newer");
+#endif
+}
+
+bool SymmetricTensor::hasSameLayout(
+    const std::vector<int64_t>& sizes,
+    const std::vector<int64_t>& strides,
+    at::ScalarType dtype) const {
+  return sizes == sizes_ && strides == strides_ && dtype == dtype_;
+}
+
+} // namespace nvfuser
@@ -0,0 +1,92 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <ATen/core/Tensor.h>
+#include <cuda_runtime.h>
+
+#include <cstdint>
+#include <vector>
+
+#include <multidevice/communicator.h>
+#include <multidevice/multidevice.h>
+
+namespace nvfuser {
+
+// A tensor allocated with the same sizes by every process of a node, and
+// mapped in the address space of all of them through CUDA IPC, like the
+// symmetric heap of NVSHMEM. A kernel can therefore take the tensor of a peer
+// as an output, and its stores go straight to the peer's memory over NVLink,
+// with no copy or collective launched afterwards.
+//
+// Each process also owns one signal per peer, next to its tensor. After its
+// writes, the producer signals the consumer, which makes the consumer's
+// stream wait for them, e.g.,
+//   producer: kernel(out=remoteTensor(consumer)); signal(consumer)
+//   consumer: waitSignal(producer); kernel(in=localTensor())
+// Signals are enqueued on the given streams, so neither side synchronizes
+// with the host. Like with NVSHMEM, it is up to the program to not overwrite
+// a tensor before its owner is done reading it.
+//
+// The constructor must be called by all the processes of the node, in the
+// same order.
+class SymmetricTensor {
+ public:
+  SymmetricTensor(
+      Communicator* communicator,
+      const std::vector<int64_t>& sizes,
+      const std::vector<int64_t>& strides,
+      at::ScalarType dtype);
+  ~SymmetricTensor();
+
+  SymmetricTensor(const SymmetricTensor&) = delete;
+  SymmetricTensor& operator=(const SymmetricTensor&) = delete;
+  SymmetricTensor(SymmetricTensor&&) = delete;
+  SymmetricTensor& operator=(SymmetricTensor&&) = delete;
+
+  const at::Tensor& localTensor() const {
+    return local_tensor_;
+  }
+
+  // Returns the tensor of a peer on the same node, on which the kernels of
+  // the current process can read and write
+  const at::Tensor& remoteTensor(DeviceIdxType peer) const;
+
+  // Signals the peer that the work enqueued so far on stream is done
+  void signal(DeviceIdxType peer, cudaStream_t stream);
+
+  // Makes stream wait for the next signal of the peer
+  void waitSignal(DeviceIdxType peer, cudaStream_t stream);
+
+  bool hasSameLayout(
+      const std::vector<int64_t>& sizes,
+      const std::vector<int64_t>& strides,
+      at::ScalarType dtype) const;
+
+ private:
+  // Returns the index of a device among the processes of the node
+  int64_t localIndex(DeviceIdxType device) const;
+
+  void checkIsOnSameNode(DeviceIdxType peer) const;
+
+  Communicator* communicator_;
+  const std::vector<int64_t> sizes_;
+  const std::vector<int64_t> strides_;
+  const at::ScalarType dtype_;
+  // Signals followed by the tensor of each process of the node, indexed by
+  // local index. Only the buffer of the current process is owned.
+  std::vector<void*> buffers_;
+  std::vector<at::Tensor> tensors_;
+  at::Tensor local_tensor_;
+  // Number of signals sent to and waited for from each peer. Signals are
+  // counters, so they never have to be reset.
+  std::vector<uint32_t> num_sent_;
+  std::vector<uint32_t> num_waited_;
+};
+
+} // namespace nvfuser
@@ -425,6 +425,54 @@ bool haveDifferentShardings(
   return false;
 }
 
+namespace {
+
+// Returns whether the logical axis `axis` of tv is outer-split by the number
+// of devices, the outer part being parallelized on DIDx, e.g.,
+//   logical: [N, H, L, E]
+//   loop: [N, H, DIDx(D), L/D, E]
+bool isOuterSplitOnDIDx(const TensorView* tv, int64_t axis) {
+  if (!tv->hasDeviceMesh() || numDeviceDims(tv) != 1) {
+    return false;
+  }
+  auto it = std::find_if(
+      tv->getLoopDomain().begin(), tv->getLoopDomain().end(), [](auto* id) {
+        return id->getParallelType() == ParallelType::DIDx;
+      });
+  if (it == tv->getLoopDomain().end()) {
+    return false;
+  }
+  auto* split = dynamic_cast<Split*>((*it)->definition());
+  return split != nullptr && split->outer() == *it && !split->innerSplit() &&
+      split->in() == tv->getLogicalDomain().at(axis);
+}
+
+} // namespace
+
+bool isContextParallelSdpa(const Expr* expr) {
+  auto* sdpa = dynamic_cast<const SdpaFwdOp*>(expr);
+  if (sdpa == nullptr || !sdpa->query()->hasDeviceMesh()) {
+    return false;
+  }
+  const DeviceMesh& mesh = sdpa->query()->getDeviceMesh();
+  if (mesh.rank() != 1 || mesh.size() < 2) {
+    return false;
+  }
+  for (TensorView* tv :
+       {sdpa->query(),
+        sdpa->key(),
+        sdpa->value(),
+        sdpa->attn_out(),
+        sdpa->logsumexp()}) {
+    if (tv->getDeviceMesh() != mesh || !isOuterSplitOnDIDx(tv, /*axis=*/2)) {
+      return false;
+    }
+  }
+  // Each rank attends to whole chunks of keys, which rules out causal masks
+  // and dropout
+  return sdpa->dropout_p()->isZero() && sdpa->is_causal()->isFalse();
+}
+
 bool isResharding(const Expr* expr) {
   FUSER_PERF_SCOPE("isResharding");
 
@@ -432,6 +480,12 @@ bool isResharding(const Expr* expr) {
     return false;
   }
 
+  // The sequence axis of the key and value is not mapped to the outputs, so
+  // the check below would miss that each rank needs all their shards
+  if (isContextParallelSdpa(expr)) {
+    return true;
+  }
+
   // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
   IdModel id_model({const_cast<Expr*>(expr)}, {}, false, false);
   id_model.buildAlmostExactGraph();
@@ -450,11 +504,47 @@ bool isResharding(const Expr* expr) {
   return false;
 }
 
+bool isAllToAll(Expr* expr) {
+  if (!expr->isA<LoadStoreOp>() ||
+      expr->as<LoadStoreOp>()->opType() != LoadStoreOpType::Set ||
+      !expr->input(0)->isA<TensorView>() ||
+      !expr->output(0)->isA<TensorView>()) {
+    return false;
+  }
+  auto* input = expr->input(0)->as<TensorView>();
+  auto* output = expr->output(0)->as<TensorView>();
+  if (input->getDeviceMesh() != output->getDeviceMesh()) {
+    return false;
+  }
+  auto [shard_additions, shard_deletions] = getShardingChanges(input, output);
+  if (shard_additions.size() != 1 || shard_deletions.size() != 1) {
+    return false;
+  }
+  IterDomain* added = shard_additions.at(0);
+  IterDomain* deleted = shard_deletions.at(0);
+  if (added->getParallelType() != deleted->getParallelType()) {
+    return false;
+  }
+  // Each device sends the chunks of the axis that becomes sharded and
+  // receives the chunks of the axis that stops being sharded. The chunks are
+  // contiguous if these axes are the outermost allocated ones.
+  auto pairwise_map =
+      PairwiseLogicalDomainMap(input, output).mapBroadcast(false);
+  IterDomain* added_in_input = pairwise_map.mapConsumerToProducer().at(added);
+  IterDomain* deleted_in_output =
+      pairwise_map.mapProducerToConsumer().at(deleted);
+  return allocationIndex(input, added_in_input) == 0 &&
+      allocationIndex(output, deleted_in_output) == 0;
+}
+
 bool isInnerResharding(Expr* expr) {
   NVF_ERROR(
       ir_utils::isTvOp(expr),
       "Non-tv op is not supported : ",
       expr->toString());
+  if (isAllToAll(expr)) {
+    return false;
+  }
 
   for (auto input : ir_utils::filterByType<TensorView>(expr->inputs())) {
     for (auto output : ir_utils::filterByType<TensorView>(expr->outputs())) {
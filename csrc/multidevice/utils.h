@@ -81,6 +81,14 @@ std::unordered_set<TensorView*> getTvsWithDifferentSharding(
 // Returns whether an Expr embeds multi-device resharding
 bool isResharding(const Expr* expr);
 
+// Returns whether expr is an SdpaFwdOp parallelized over the sequence, i.e.,
+// context parallelism: the query, key, value and outputs are all sharded on a
+// 1D mesh by outer-splitting their sequence axis, e.g.,
+//   query: [N, H, L, E] -> loop: [N, H, DIDx(D), L/D, E]
+// Each rank then needs the key and value shards of all the other ranks, so
+// the op is resharding and lowered to a ring attention.
+bool isContextParallelSdpa(const Expr* expr);
+
 // Returns whether two tensors have different shardings. Expect a
 // producer/consumer relationship between the arguments.
 bool haveDifferentShardings(
@@ -88,6 +96,13 @@ bool haveDifferentShardings(
     const TensorView* consumer,
     const IdModel& id_model);
 
+// Returns whether a resharding expr moves the sharding of a tensor from one
+// axis to another on the same mesh, e.g.,
+//   [DIDx(i0), i1] -> [i0, DIDx(i1)],
+// such that all the chunks exchanged are contiguous, i.e., it can be lowered
+// to an all-to-all.
+bool isAllToAll(Expr* expr);
+
 // Returns whether a resharding expr reshards an inner axis
 bool isInnerResharding(Expr* expr);
 
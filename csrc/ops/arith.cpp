@@ -1525,6 +1525,121 @@ TensorView* min(
   return reductionOp(BinaryOpType::Min, axes, init, v1, keep_dim);
 }
 
+TensorView* scan(
+    TensorView* v1,
+    int64_t dim,
+    BinaryOpType scan_op_type,
+    Val* init) {
+  NVF_CHECK(
+      init->isConstScalar(),
+      "Cannot create a scan operation where the initial value is not a const "
+      "scalar.");
+  const auto logical = TensorDomain::noReductions(v1->getLogicalDomain());
+  dim = wrapDim(dim, (int64_t)logical.size());
+  NVF_CHECK(
+      !logical.at(dim)->isBroadcast(),
+      "Cannot scan a broadcast dimension: ",
+      logical.at(dim)->toString());
+
+  TensorView* out = ops::newOutputTV({v1}, v1->getDataType().value());
+  IrBuilder::create<ScanOp>(
+      scan_op_type,
+      SimplifyingIrBuilder::maybeCastExpr(out->dtype(), init),
+      out,
+      v1,
+      dim);
+  return out;
+}
+
+namespace {
+
+// Accumulate integral and boolean inputs in Int, like PyTorch does
+TensorView* castForAccumulation(TensorView* v1, DataType dtype) {
+  if (dtype == DataType::Null) {
+    auto initial_v1_dtype = v1->getDataType().value();
+    if (isBooleanType(initial_v1_dtype) || isIntegralType(initial_v1_dtype)) {
+      dtype = DataType::Int;
+    }
+  }
+  if (dtype != DataType::Null) {
+    v1 = optionalCastStrict(dtype, v1)->as<TensorView>();
+  }
+  return v1;
+}
+
+} // namespace
+
+TensorView* cumsum(TensorView* v1, int64_t dim, DataType dtype) {
+  v1 = castForAccumulation(v1, dtype);
+  return scan(
+      v1,
+      dim,
+      BinaryOpType::Add,
+      FusionGuard::getCurFusion()->zeroVal(v1->getDataType().value()));
+}
+
+TensorView* cumprod(TensorView* v1, int64_t dim, DataType dtype) {
+  v1 = castForAccumulation(v1, dtype);
+  return scan(
+      v1,
+      dim,
+      BinaryOpType::Mul,
+      FusionGuard::getCurFusion()->oneVal(v1->getDataType().value()));
+}
+
+SortResult sort(TensorView* v1, int64_t dim, bool descending, bool stable) {
+  const auto logical = TensorDomain::noReductions(v1->getLogicalDomain());
+  dim = wrapDim(dim, (int64_t)logical.size());
+
+  TensorView* values = ops::newOutputTV({v1}, v1->getDataType().value());
+  TensorView* indices = ops::newOutputTV({v1}, DataType::Int);
+  IrBuilder::create<SortOp>(values, indices, v1, dim, descending, stable);
+  return {values, indices};
+}
+
+SortResult topk(
+    TensorView* v1,
+    Val* k,
+    int64_t dim,
+    bool largest,
+    bool sorted) {
+  NVF_CHECK(
+      k->isIntegralScalar(),
+      "Expected k to be an integral scalar, but got ",
+      k->toString());
+  const auto logical = TensorDomain::noReductions(v1->getLogicalDomain());
+  dim = wrapDim(dim, (int64_t)logical.size());
+  NVF_CHECK(
+      !logical.at(dim)->isBroadcast(),
+      "Cannot select from a broadcast dimension: ",
+      logical.at(dim)->toString());
+
+  // The selected axis gets a new IterDomain of extent k. The other axes
+  // match the input like a pointwise op.
+  k = SimplifyingIrBuilder::maybeCastExpr(DataType::Index, k);
+  auto make_domain = [&]() {
+    std::vector<IterDomain*> out_domain;
+    out_domain.reserve(logical.size());
+    for (auto idx : c10::irange(logical.size())) {
+      if ((int64_t)idx == dim) {
+        out_domain.push_back(
+            IterDomainBuilder(FusionGuard::getCurFusion()->zeroVal(), k)
+                .build());
+      } else {
+        out_domain.push_back(ops::newOutputIterDomain({logical.at(idx)}));
+      }
+    }
+    return IrBuilder::create<TensorDomain>(
+        out_domain, TensorDomain::getContiguityFilledWith(out_domain, true));
+  };
+  TensorView* values =
+      IrBuilder::create<TensorView>(make_domain(), v1->getDataType().value());
+  TensorView* indices =
+      IrBuilder::create<TensorView>(make_domain(), DataType::Int);
+  IrBuilder::create<TopKOp>(values, indices, v1, k, dim, largest, sorted);
+  return {values, indices};
+}
+
 std::vector<Val*> shape(TensorView* inp) {
   auto iter_domains = TensorDomain::noReductions(inp->getLogicalDomain());
   std::vector<Val*> shape;
@@ -596,6 +596,52 @@ NVF_API TensorView* min(
     bool keep_dim = false,
     DataType dtype = DataType::Null);
 
+// SCAN OPERATIONS
+//! Inclusive scan of v1 along dim. Element i of the output combines init and
+//! elements 0 through i of the input with scan_op_type.
+NVF_API TensorView* scan(
+    TensorView* v1,
+    int64_t dim,
+    BinaryOpType scan_op_type,
+    Val* init);
+
+//! Cumulative sum along dim, like torch.cumsum. Integral and boolean inputs
+//! are accumulated in Int unless dtype says otherwise.
+NVF_API TensorView* cumsum(
+    TensorView* v1,
+    int64_t dim,
+    DataType dtype = DataType::Null);
+
+//! Cumulative product along dim, like torch.cumprod
+NVF_API TensorView* cumprod(
+    TensorView* v1,
+    int64_t dim,
+    DataType dtype = DataType::Null);
+
+// SORT OPERATIONS
+//! Values and their positions in the input along the sorted axis, as
+//! returned by sort and topk
+struct SortResult {
+  TensorView* values = nullptr;
+  TensorView* indices = nullptr;
+};
+
+//! Sorts v1 along dim, like torch.sort
+NVF_API SortResult sort(
+    TensorView* v1,
+    int64_t dim = -1,
+    bool descending = false,
+    bool stable = false);
+
+//! The k largest (or smallest) elements of v1 along dim, like torch.topk.
+//! k must not exceed the extent of dim.
+NVF_API SortResult topk(
+    TensorView* v1,
+    Val* k,
+    int64_t dim = -1,
+    bool largest = true,
+    bool sorted = true);
+
 // COMPOUND OPERATIONS
 // add_alpha
 NVF_API Val* add_alpha(Val* v1, Val* v2, Val* s);
@@ -24,6 +24,15 @@ ForwardDropoutResult dropout(TensorView* x, Val* prob) {
 }
 
 ForwardDropoutResult dropout(TensorView* x, Val* prob, Val* scale) {
+  return dropout(x, prob, scale, nullptr, nullptr);
+}
+
+ForwardDropoutResult dropout(
+    TensorView* x,
+    Val* prob,
+    Val* scale,
+    Val* philox_seed,
+    Val* philox_offset) {
   NVF_ERROR(x != nullptr, "Input is invalid.");
   NVF_ERROR(
       prob != nullptr && prob->getDataType().has_value() &&
@@ -34,7 +43,7 @@ ForwardDropoutResult dropout(TensorView* x, Val* prob, Val* scale) {
           scale->getDataType().value() == DataType::Double,
       "Scale is not a valid Double.");
 
-  auto rand_vals = rand_like(x);
+  auto rand_vals = rand_like(x, philox_seed, philox_offset);
   auto mask = lt(rand_vals, prob);
   auto apply_mask = mul(x, mask);
   auto y = mul(apply_mask, scale);
@@ -56,6 +65,27 @@ TensorView* dropout_backward(TensorView* dy, TensorView* mask, Val* scale) {
   return dx;
 }
 
+TensorView* dropout_backward(
+    TensorView* dy,
+    Val* prob,
+    Val* scale,
+    Val* philox_seed,
+    Val* philox_offset) {
+  NVF_ERROR(dy != nullptr, "Grad Output is invalid.");
+  NVF_ERROR(
+      prob != nullptr && prob->getDataType().has_value() &&
+          prob->getDataType().value() == DataType::Double,
+      "Probability is not a valid Double.");
+  NVF_ERROR(
+      philox_seed != nullptr && philox_offset != nullptr,
+      "The mask can only be regenerated from a given Philox seed and offset");
+
+  // Same draws as the forward, which are a function of the seed, the offset
+  // and the linear index of each element only
+  auto mask = lt(rand_like(dy, philox_seed, philox_offset), prob);
+  return dropout_backward(dy, mask, scale);
+}
+
 TensorView* triu(TensorView* tv, Val* offset) {
   NVF_CHECK(
       isIntegralType(offset->getDataType().value()),
@@ -478,6 +508,290 @@ TensorView* matmul(TensorView* tv_a, TensorView* tv_b) {
   return out;
 }
 
+TensorView* grouped_matmul(
+    TensorView* mat1,
+    TensorView* mat2,
+    TensorView* offsets) {
+  auto mat1_domain = TensorDomain::noReductions(mat1->getLogicalDomain());
+  auto mat2_domain = TensorDomain::noReductions(mat2->getLogicalDomain());
+  auto offsets_domain = TensorDomain::noReductions(offsets->getLogicalDomain());
+  NVF_CHECK(
+      mat1_domain.size() == 2 && mat2_domain.size() == 3 &&
+          offsets_domain.size() == 1,
+      "Expected mat1[M, K], mat2[G, K, N] and offsets[G], got: ",
+      mat1_domain,
+      ", ",
+      mat2_domain,
+      " and ",
+      offsets_domain);
+  NVF_CHECK(
+      mat1->dtype() == mat2->dtype(),
+      "Expected mat1 and mat2 to have the same dtype, got: ",
+      mat1->dtype(),
+      " and ",
+      mat2->dtype());
+  NVF_CHECK(
+      isIntegralType(offsets->dtype()),
+      "Expected integral offsets, got: ",
+      offsets->dtype());
+  NVF_CHECK(
+      mat1_domain.back()->isBroadcast() == mat2_domain.at(1)->isBroadcast(),
+      "K should be broadcast in both mat1 and mat2, or neither.");
+
+  // Output is [M, N] with a reduction axis rK if K is not a broadcast
+  bool k_bcast = mat1_domain.back()->isBroadcast();
+  size_t ndims_out = k_bcast ? 2 : 3;
+  const std::vector<IterDomain*>& mapping_1 =
+      ops::mapGroupedMatmulOpIterDomains(mat1_domain, 0, ndims_out);
+  const std::vector<IterDomain*>& mapping_2 =
+      ops::mapGroupedMatmulOpIterDomains(mat2_domain, 1, ndims_out);
+
+  std::vector<IterDomain*> out_domain = {
+      ops::newOutputIterDomain({mapping_1.at(0)}),
+      ops::newOutputIterDomain({mapping_2.at(1)})};
+  if (!k_bcast) {
+    out_domain.push_back(ops::newOutputIterDomain(
+        {mapping_1.at(2), mapping_2.at(2)},
+        /*force_iter_type=*/IterType::Reduction));
+  }
+
+  TensorDomain* td = IrBuilder::create<TensorDomain>(
+      out_domain, TensorDomain::getContiguityFilledWith(out_domain, true));
+  TensorView* out = IrBuilder::create<TensorView>(td, mat1->dtype());
+  IrBuilder::create<GroupedMatmulOp>(out, mat1, mat2, offsets);
+  return out;
+}
+
+TensorView* segmented_reduction(
+    BinaryOpType reduction_op_type,
+    TensorView* in,
+    TensorView* offsets,
+    Val* init) {
+  auto in_domain = TensorDomain::noReductions(in->getLogicalDomain());
+  auto offsets_domain = TensorDomain::noReductions(offsets->getLogicalDomain());
+  NVF_CHECK(
+      !in_domain.empty() && offsets_domain.size() == 1,
+      "Expected in[T, ...] and offsets[B], got: ",
+      in_domain,
+      " and ",
+      offsets_domain);
+  NVF_CHECK(
+      isIntegralType(offsets->dtype()),
+      "Expected integral offsets, got: ",
+      offsets->dtype());
+  NVF_CHECK(
+      init->isConstScalar(),
+      "Cannot create a segmented reduction where the initial value is not a "
+      "const scalar.");
+
+  // Output is [B, ...]. The segmented axis T has no mapping to the output.
+  std::vector<IterDomain*> out_domain;
+  out_domain.reserve(in_domain.size());
+  out_domain.push_back(ops::newOutputIterDomain({offsets_domain.at(0)}));
+  for (auto idx : c10::irange(1, in_domain.size())) {
+    out_domain.push_back(ops::newOutputIterDomain({in_domain.at(idx)}));
+  }
+
+  TensorDomain* td = IrBuilder::create<TensorDomain>(
+      out_domain, TensorDomain::getContiguityFilledWith(out_domain, true));
+  TensorView* out = IrBuilder::create<TensorView>(td, in->dtype());
+  IrBuilder::create<SegmentedReductionOp>(
+      reduction_op_type,
+      SimplifyingIrBuilder::maybeCastExpr(out->dtype(), init),
+      out,
+      in,
+      offsets);
+  return out;
+}
+
+TensorView* segmented_sum(TensorView* in, TensorView* offsets) {
+  if (isBooleanType(in->dtype()) || isIntegralType(in->dtype())) {
+    in = castOp(DataType::Int, in);
+  }
+  return segmented_reduction(
+      BinaryOpType::Add,
+      in,
+      offsets,
+      FusionGuard::getCurFusion()->zeroVal(in->dtype()));
+}
+
+TensorView* segmented_max(TensorView* in, TensorView* offsets) {
+  Val* init = ops::getMinimumValue(in->dtype());
+  NVF_CHECK(init != nullptr, "Missing initial value");
+  return segmented_reduction(BinaryOpType::Max, in, offsets, init);
+}
+
+TensorView* segment_ids(TensorView* offsets, Val* num_rows) {
+  NVF_CHECK(
+      TensorDomain::noReductions(offsets->getLogicalDomain()).size() == 1,
+      "Expected 1D offsets, got: ",
+      offsets->toString());
+  // ids[t] is the number of segments that end at or before row t. B is
+  // usually small, so the [T, B] comparison is cheaper than a search.
+  TensorView* rows = iota(num_rows);
+  TensorView* ended = le(
+      broadcast(castOp(DataType::Int, offsets), {true, false}),
+      broadcast(rows, {false, true}));
+  return sum(ended, {1});
+}
+
+TensorView* embedding_bwd(
+    TensorView* grad_output,
+    TensorView* indices,
+    Val* num_weights,
+    int64_t padding_idx,
+    bool scale_grad_by_freq) {
+  auto grad_domain =
+      TensorDomain::noReductions(grad_output->getLogicalDomain());
+  auto indices_domain = TensorDomain::noReductions(indices->getLogicalDomain());
+  NVF_CHECK(
+      grad_domain.size() == indices_domain.size() + 1,
+      "Expected grad_output[..., D] and indices[...], got: ",
+      grad_domain,
+      " and ",
+      indices_domain);
+  NVF_CHECK(
+      isIntegralType(indices->dtype()),
+      "Expected integral indices, got: ",
+      indices->dtype());
+  NVF_CHECK(
+      num_weights->isIntegralScalar(),
+      "Expected an integral number of weights, got: ",
+      num_weights->toString());
+
+  // Output is [num_weights, D]. The leading dims are reduced into rows
+  // selected at runtime, so they have no mapping to the output.
+  std::vector<IterDomain*> out_domain{
+      IterDomainBuilder(
+          FusionGuard::getCurFusion()->zeroVal(),
+          SimplifyingIrBuilder::maybeCastExpr(DataType::Index, num_weights))
+          .build(),
+      ops::newOutputIterDomain({grad_domain.back()})};
+  TensorDomain* td = IrBuilder::create<TensorDomain>(
+      out_domain, TensorDomain::getContiguityFilledWith(out_domain, true));
+  TensorView* grad_weight =
+      IrBuilder::create<TensorView>(td, grad_output->dtype());
+  IrBuilder::create<EmbeddingBwdOp>(
+      grad_weight,
+      grad_output,
+      indices,
+      num_weights,
+      padding_idx,
+      scale_grad_by_freq);
+  return grad_weight;
+}
+
+TensorView* unpack_int4(TensorView* packed) {
+  NVF_CHECK(
+      packed->dtype() == DataType::Int8,
+      "Expected int4 values packed into Int8, got: ",
+      packed->dtype());
+  auto ndims =
+      (int64_t)TensorDomain::noReductions(packed->getLogicalDomain()).size();
+  NVF_CHECK(ndims > 0, "Expected a non-scalar packed tensor");
+
+  // Shifts are arithmetic on the sign-extended Int32 value, so both nibbles
+  // keep their sign
+  TensorView* x = castOp(DataType::Int32, packed);
+  TensorView* lo = bitwise_right_shift(
+      bitwise_left_shift(x, IrBuilder::create<Val>(28L)),
+      IrBuilder::create<Val>(28L));
+  TensorView* hi = bitwise_right_shift(x, IrBuilder::create<Val>(4L));
+
+  // [..., C, 2] -> [..., 2 * C]
+  std::vector<bool> bcast_flags(ndims + 1, false);
+  bcast_flags.back() = true;
+  TensorView* unpacked =
+      cat({broadcast(lo, bcast_flags), broadcast(hi, bcast_flags)}, -1);
+  return castOp(DataType::Int8, flatten(unpacked, ndims - 1, ndims));
+}
+
+TensorView* decompress_sparse24(TensorView* values, TensorView* metadata) {
+  NVF_CHECK(
+      isIntegralType(metadata->dtype()),
+      "Expected integral 2:4 sparsity metadata, got: ",
+      metadata->dtype());
+  auto values_domain = TensorDomain::noReductions(values->getLogicalDomain());
+  auto metadata_domain =
+      TensorDomain::noReductions(metadata->getLogicalDomain());
+  NVF_CHECK(
+      !values_domain.empty() && values_domain.size() == metadata_domain.size(),
+      "Expected [..., K / 2] values and [..., K / 4] metadata, got: ",
+      values_domain,
+      " and ",
+      metadata_domain);
+  const auto ndims = (int64_t)values_domain.size();
+  Fusion* fusion = values->fusion();
+
+  // [..., K / 2] -> [..., K / 4, 2], the kept values of each group
+  std::vector<Val*> grouped_sizes;
+  grouped_sizes.reserve(ndims + 1);
+  for (auto id : values_domain) {
+    grouped_sizes.push_back(id->getMaybeExpandedExtent());
+  }
+  grouped_sizes.back() = metadata_domain.back()->getMaybeExpandedExtent();
+  grouped_sizes.push_back(IrBuilder::create<Val>(2L, DataType::Index));
+  TensorView* grouped = reshape(values, grouped_sizes);
+  TensorView* first = select(grouped, ndims, fusion->zeroVal());
+  TensorView* second = select(grouped, ndims, fusion->oneVal());
+
+  TensorView* meta = castOp(DataType::Int32, metadata);
+  Val* position_mask = IrBuilder::create<Val>(3L, DataType::Int32);
+  TensorView* first_pos = bitwise_and(meta, position_mask);
+  TensorView* second_pos = bitwise_and(
+      bitwise_right_shift(meta, IrBuilder::create<Val>(2L, DataType::Int32)),
+      position_mask);
+
+  // Scatter the kept values of each group to their positions in
+  // [..., K / 4, 4]
+  std::vector<bool> group_bcast(ndims + 1, false);
+  group_bcast.back() = true;
+  std::vector<bool> pos_bcast(ndims + 1, true);
+  pos_bcast.back() = false;
+  TensorView* pos = broadcast(
+      iota(
+          IrBuilder::create<Val>(4L, DataType::Index),
+          nullptr,
+          nullptr,
+          DataType::Int32),
+      pos_bcast);
+  TensorView* dense = where(
+      eq(broadcast(second_pos, group_bcast), pos),
+      broadcast(second, group_bcast),
+      where(
+          eq(broadcast(first_pos, group_bcast), pos),
+          broadcast(first, group_bcast),
+          fusion->zeroVal(values->dtype())));
+  return castOp(values->dtype(), flatten(dense, ndims - 1, ndims));
+}
+
+TensorView* dequantize(
+    TensorView* q,
+    TensorView* scale,
+    int64_t group_size,
+    DataType dtype) {
+  auto q_domain = TensorDomain::noReductions(q->getLogicalDomain());
+  auto scale_domain = TensorDomain::noReductions(scale->getLogicalDomain());
+  NVF_CHECK(
+      q_domain.size() == 2 && scale_domain.size() == 2,
+      "Expected a [K, N] weight and [K / group_size, N] scales, got: ",
+      q_domain,
+      " and ",
+      scale_domain);
+  NVF_CHECK(group_size > 0, "Invalid group size: ", group_size);
+
+  // [K, N] -> [K / g, g, N], so each scale row broadcasts over its group
+  Val* k = q_domain.at(0)->getMaybeExpandedExtent();
+  Val* g = IrBuilder::create<Val>(group_size, DataType::Index);
+  Val* n = q_domain.at(1)->getMaybeExpandedExtent();
+  TensorView* grouped =
+      reshape(castOp(DataType::Float, q), {div(k, g), g, n});
+  TensorView* scaled = mul(
+      grouped,
+      broadcast(castOp(DataType::Float, scale), {false, true, false}));
+  return castOp(dtype, reshape(scaled, {k, n}));
+}
+
 SdpfaFwdResult sdpfa_fwd(
     TensorView* query,
     TensorView* key,
@@ -35,6 +35,24 @@ NVF_API TensorView* dropout_backward(
     TensorView* mask,
     Val* scale);
 
+// Variants drawing the mask from the given Philox seed and offset, so that
+// the backward regenerates the mask instead of reading a saved one. The mask
+// returned by the forward doesn't need to be a fusion output. dy must have the
+// shape and dtype of x for the masks to match.
+NVF_API ForwardDropoutResult dropout(
+    TensorView* x,
+    Val* prob,
+    Val* scale,
+    Val* philox_seed,
+    Val* philox_offset);
+
+NVF_API TensorView* dropout_backward(
+    TensorView* dy,
+    Val* prob,
+    Val* scale,
+    Val* philox_seed,
+    Val* philox_offset);
+
 NVF_API TensorView* triu(TensorView* tv, Val* offset);
 
 struct LstmResult {
@@ -78,6 +96,74 @@ NVF_API TensorView* view_as_real(TensorView* x);
 // layouts via strides. This has the same functionality as torch.matmul
 TensorView* matmul(TensorView* tv_a, TensorView* tv_b);
 
+// Grouped matmul of mat1[M, K] with mat2[G, K, N], where offsets[G] holds the
+// cumulative end row in mat1 of each of the G groups. Group g multiplies rows
+// [offsets[g-1], offsets[g]) of mat1 with mat2[g]. The output is [M, N].
+NVF_API TensorView* grouped_matmul(
+    TensorView* mat1,
+    TensorView* mat2,
+    TensorView* offsets);
+
+// Reduction of the variable-length segments along the first axis of a packed
+// in[T, ...], so that batches of sequences need no padding. offsets[B] holds
+// the cumulative end row of each segment, like for grouped_matmul. The output
+// is [B, ...].
+NVF_API TensorView* segmented_reduction(
+    BinaryOpType reduction_op_type,
+    TensorView* in,
+    TensorView* offsets,
+    Val* init);
+
+// Per-segment sum and max of a packed in[T, ...]. Integral and boolean inputs
+// are summed in Int, like sum.
+NVF_API TensorView* segmented_sum(TensorView* in, TensorView* offsets);
+NVF_API TensorView* segmented_max(TensorView* in, TensorView* offsets);
+
+// The segment of each of the num_rows rows described by offsets[B], as an Int
+// tensor of shape [num_rows]. Rows past offsets[B-1] get B, which is out of
+// range for a segmented_reduction result. Indexing a segmented_reduction
+// result with it broadcasts the per-segment values back to the rows, e.g. for
+// a softmax over each sequence.
+NVF_API TensorView* segment_ids(TensorView* offsets, Val* num_rows);
+
+// Gradient of an embedding lookup with respect to a weight table of
+// num_weights rows, like at::embedding_dense_backward. grad_output is
+// [..., D] and indices has its leading dims. Duplicate indices are reduced
+// after sorting, so the result is deterministic even for skewed token
+// distributions. The output is [num_weights, D].
+NVF_API TensorView* embedding_bwd(
+    TensorView* grad_output,
+    TensorView* indices,
+    Val* num_weights,
+    int64_t padding_idx = -1,
+    bool scale_grad_by_freq = false);
+
+// Unpacks signed int4 values stored two per byte, low nibble first, like
+// the weights of W4A16 checkpoints. packed is an Int8 tensor of shape
+// [..., C] and the result is an Int8 tensor of shape [..., 2 * C] holding one
+// sign-extended value in [-8, 7] per element.
+NVF_API TensorView* unpack_int4(TensorView* packed);
+
+// Decompresses a 2:4 structured-sparse operand, which keeps two values of
+// every group of four consecutive elements along its last dimension, like
+// weights pruned for sparse tensor cores. values is [..., K / 2] and holds the
+// kept values of each group in order. metadata is an integral tensor of shape
+// [..., K / 4] whose bits [1:0] and [3:2] are the positions in their group of
+// the first and second kept values. The result is the dense [..., K] operand
+// of the dtype of values, with zeros in place of the pruned elements.
+NVF_API TensorView* decompress_sparse24(
+    TensorView* values,
+    TensorView* metadata);
+
+// Dequantizes a [K, N] integer or FP8 weight with scales shared by groups of
+// group_size consecutive rows along K. scale is [K / group_size, N], and K
+// must be divisible by group_size. The result is q * scale in dtype.
+NVF_API TensorView* dequantize(
+    TensorView* q,
+    TensorView* scale,
+    int64_t group_size,
+    DataType dtype);
+
 // Scaled Dot Product Flash Attention Forward Result
 struct SdpfaFwdResult {
   TensorView* output = nullptr;
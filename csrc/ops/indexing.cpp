@@ -242,4 +242,36 @@ TensorView* takeAlongAxis(TensorView* inp, TensorView* index, int64_t dim) {
   return out_tensor->as<TensorView>();
 }
 
+TensorView* gatherPages(TensorView* pages, TensorView* block_table) {
+  std::vector<IterDomain*> page_domain =
+      TensorDomain::noReductions(pages->getLogicalDomain());
+  std::vector<IterDomain*> table_domain =
+      TensorDomain::noReductions(block_table->getLogicalDomain());
+  NVF_CHECK(
+      page_domain.size() >= 2,
+      "pages must be of shape [num_pages, page_size, ...], but got ",
+      pages->toString());
+  NVF_CHECK(
+      table_domain.size() == 2,
+      "block_table must be of shape [batch, pages_per_sequence], but got ",
+      block_table->toString());
+  NVF_CHECK(
+      isIntegralType(block_table->dtype()),
+      "block_table must hold integers, but got ",
+      block_table->dtype());
+
+  // [batch * pages_per_sequence, page_size, ...]
+  TensorView* gathered = indexSelect(pages, 0, flatten(block_table));
+
+  std::vector<Val*> new_sizes;
+  new_sizes.reserve(page_domain.size());
+  new_sizes.push_back(table_domain.at(0)->extent());
+  new_sizes.push_back(
+      mul(table_domain.at(1)->extent(), page_domain.at(1)->extent()));
+  for (auto i : c10::irange((size_t)2, page_domain.size())) {
+    new_sizes.push_back(page_domain.at(i)->extent());
+  }
+  return reshape(gathered, new_sizes);
+}
+
 } // namespace nvfuser
@@ -43,6 +43,17 @@ NVF_API TensorView* scatter(
     TensorView* index,
     TensorView* src);
 
+//! Gathers the pages of a paged tensor, e.g., a paged KV cache, through a
+//! block table. `pages` is of shape [num_pages, page_size, ...] and
+//! `block_table` of shape [batch, pages_per_sequence] holds the page indices of
+//! each sequence. The result is of shape
+//! [batch, pages_per_sequence * page_size, ...].
+//!
+//! The indirection is an IndexSelectOp on the page axis, so kernels fusing
+//! the result with its consumers read the pages in place rather than a
+//! contiguous copy.
+NVF_API TensorView* gatherPages(TensorView* pages, TensorView* block_table);
+
 //! numpy.take_along_axis
 //! (https://numpy.org/doc/stable/reference/generated/numpy.take_along_axis.html)
 //! Note the order of the parameters follows the numpy order, which is
@@ -310,6 +310,35 @@ std::vector<IterDomain*> mapLinearOpIterDomains(
   return mapping;
 }
 
+std::vector<IterDomain*> mapGroupedMatmulOpIterDomains(
+    const std::vector<IterDomain*>& input_domain,
+    int64_t input_position,
+    size_t out_size) {
+  NVF_ERROR(
+      input_position >= 0 && input_position <= 2,
+      "Input position must be 0, 1, or 2. Found ",
+      input_position);
+  NVF_ERROR(out_size == 2 || out_size == 3);
+  std::vector<IterDomain*> mapping(out_size, nullptr);
+
+  // mat1: {M, K}
+  // mat2: {G, K, N}
+  // offsets: {G}
+  // Output: {M, N, (rK)}. rK exists iff K is not a broadcast.
+  if (input_position == 0) {
+    mapping[0] = input_domain.at(0);
+    if (out_size == 3) {
+      mapping[2] = input_domain.at(1);
+    }
+  } else if (input_position == 1) {
+    mapping[1] = input_domain.at(2);
+    if (out_size == 3) {
+      mapping[2] = input_domain.at(1);
+    }
+  }
+  return mapping;
+}
+
 namespace {
 ParallelType promoteParallelType(ParallelType a, ParallelType b) {
   if (a == b) {
@@ -550,6 +579,10 @@ Val* getMinimumValue(DataType v) {
       return IrBuilder::create<Val>(
           (int64_t)std::numeric_limits<int32_t>::lowest());
       break;
+    case (DataType::Int8):
+      return IrBuilder::create<Val>(
+          (int64_t)std::numeric_limits<int8_t>::lowest());
+      break;
     case (DataType::Bool):
       return IrBuilder::create<Val>(false);
       break;
@@ -595,6 +628,10 @@ Val* getMaximumValue(DataType v) {
       return IrBuilder::create<Val>(
           (int64_t)std::numeric_limits<int32_t>::max());
       break;
+    case (DataType::Int8):
+      return IrBuilder::create<Val>(
+          (int64_t)std::numeric_limits<int8_t>::max());
+      break;
     case (DataType::Bool):
       return IrBuilder::create<Val>(true);
       break;
@@ -86,6 +86,19 @@ std::vector<IterDomain*> mapLinearOpIterDomains(
     size_t out_size,
     bool k_bcast);
 
+// For GroupedMatmulOp, mat1[M, K] and mat2[G, K, N] map to the output
+// [M, N, (rK)] as {id_M, nullptr, id_K} and {nullptr, id_N, id_K}. The group
+// dimension G and the offsets do not map to the output. Args:
+// 1. input_domain: root/logical domain without reductions for any input to
+// GroupedMatmulOp
+// 2. input_position: Specifies if the input is mat1 / mat2 / offsets (0, 1, or
+// 2)
+// 3. out_size: GroupedMatmulOp output dimension, 3 unless K is a broadcast.
+std::vector<IterDomain*> mapGroupedMatmulOpIterDomains(
+    const std::vector<IterDomain*>& input_domain,
+    int64_t input_position,
+    size_t out_size);
+
 // Takes a vector of aligned input iterdomains to create the output iterdomain.
 // This is used if the input iterdomains are not trivially mapped to the output
 // iterdomains. For eg: MatmulOp. If given, the forced_iter_type argument will
@@ -102,6 +102,7 @@ std::unordered_map<DebugDumpOption, std::vector<std::string>> Options<
       {"bank_conflict", DebugDumpOption::BankConflictInfo},
       {"buffer_reuse_verbose", DebugDumpOption::BufferReuseInfo},
       {"ca_map", DebugDumpOption::ComputeAtMap},
+      {"compile_times", DebugDumpOption::CompileTimes},
       {"cubin", DebugDumpOption::Cubin},
       {"cuda_full", DebugDumpOption::CudaFull},
       {"cuda_kernel", DebugDumpOption::CudaKernel},
@@ -130,6 +131,7 @@ std::unordered_map<DebugDumpOption, std::vector<std::string>> Options<
       {"lower_verbose", DebugDumpOption::LowerVerbose},
       {"occupancy", DebugDumpOption::Occupancy},
       {"parallel_dimensions", DebugDumpOption::ParallelDimensions},
+      {"peak_memory", DebugDumpOption::PeakMemory},
       {"perf_debug_verbose", DebugDumpOption::PerfDebugVerbose},
       {"pre_segmenter_logging", DebugDumpOption::PreSegmenterLogging},
       {"predicate_elimination", DebugDumpOption::PredicateElimination},
@@ -152,19 +154,78 @@ std::unordered_map<DebugDumpOption, std::vector<std::string>> Options<
 const std::unordered_map<std::string, EnableOption>& getEnableOptions() {
   static const std::unordered_map<std::string, EnableOption> available_options =
       {
+          {"async_compile", EnableOption::AsyncCompile},
+          {"autotune", EnableOption::Autotune},
+          {"cluster_reduction", EnableOption::ClusterReduction},
+          {"coalesce_communications", EnableOption::CoalesceCommunications},
+          {"combined_inner_outer_reduction",
+           EnableOption::CombinedInnerOuterReduction},
+          {"communicator_backend_table",
+           EnableOption::CommunicatorBackendTable},
+          {"compact_tensor_args", EnableOption::CompactTensorArgs},
+          {"compress_kernel_binaries", EnableOption::CompressKernelBinaries},
+          {"compressed_collectives", EnableOption::CompressedCollectives},
+          {"concurrent_segments", EnableOption::ConcurrentSegments},
+          {"cost_based_sharding", EnableOption::CostBasedSharding},
+          {"cuda_graph", EnableOption::CudaGraph},
+          {"deterministic_reductions",
+           EnableOption::DeterministicReductions},
           {"fuse_matmul", EnableOption::FuseMatmul},
           {"fuse_multiple_matmuls", EnableOption::FuseMultipleMatmuls},
+          {"grid_persistent_normalization",
+           EnableOption::GridPersistentNormalization},
+          {"grid_stride_pointwise", EnableOption::GridStridePointwise},
+          {"grid_swizzle", EnableOption::GridSwizzle},
+          {"heuristic_snapshot", EnableOption::HeuristicSnapshot},
+          {"host_scalar_hoisting", EnableOption::HostScalarHoisting},
           {"id_model", EnableOption::IdModel},
+          {"index_strength_reduction", EnableOption::IndexStrengthReduction},
+          {"index_type_variants", EnableOption::IndexTypeVariants},
+          {"intermediate_arena", EnableOption::IntermediateArena},
           {"io_to_lower_precision", EnableOption::IoToLowerPrecision},
           {"kernel_db", EnableOption::KernelDb},
           {"kernel_debug", EnableOption::KernelDebug},
           {"kernel_lineinfo", EnableOption::KernelLineInfo},
+          {"kernel_perf_db", EnableOption::KernelPerfDb},
           {"kernel_profile", EnableOption::KernelProfile},
+          {"kernel_timeline", EnableOption::KernelTimeline},
+          {"l2_persist_intermediates", EnableOption::L2PersistIntermediates},
+          {"latency_mode", EnableOption::LatencyMode},
+          {"lazy_kernel_loading", EnableOption::LazyKernelLoading},
+          {"limit_register_pressure", EnableOption::LimitRegisterPressure},
+          {"matmul_auto_select", EnableOption::MatmulAutoSelect},
+          {"matmul_split_k", EnableOption::MatmulSplitK},
+          {"megakernel", EnableOption::Megakernel},
+          {"memoize_expr_simplify", EnableOption::MemoizeExprSimplify},
+          {"memoize_transform_replay", EnableOption::MemoizeTransformReplay},
           {"memory_promotion", EnableOption::MemoryPromotion},
+          {"minimal_preamble", EnableOption::MinimalPreamble},
+          {"misaligned_vectorize", EnableOption::MisalignedVectorize},
+          {"occupancy_target", EnableOption::OccupancyTarget},
+          {"pad_global_intermediates", EnableOption::PadGlobalIntermediates},
+          {"parallel_lowering", EnableOption::ParallelLowering},
+          {"partial_segment_copy", EnableOption::PartialSegmentCopy},
+          {"precompiled_preamble", EnableOption::PrecompiledPreamble},
+          {"prefetch_allgathers", EnableOption::PrefetchAllgathers},
+          {"prune_magic_zero", EnableOption::PruneMagicZero},
+          {"resetting_grid_sync", EnableOption::ResettingGridSync},
           {"reuse_zeroed_memory", EnableOption::ReuseZeroedMemory},
           {"resize_scheduler", EnableOption::ResizeScheduler},
+          {"segmenter_cost_model", EnableOption::SegmenterCostModel},
+          {"serial_loop_prefetch", EnableOption::SerialLoopPrefetch},
+          {"smem_broadcast_inputs", EnableOption::SmemBroadcastInputs},
+          {"smem_interval_packing", EnableOption::SmemIntervalPacking},
+          {"stage_cpu_scalars", EnableOption::StageCpuScalars},
+          {"static_block_dim", EnableOption::StaticBlockDim},
           {"static_fusion_count", EnableOption::StaticFusionCount},
+          {"sub_tensor_indexing", EnableOption::SubTensorIndexing},
+          {"swizzle_bank_conflicts", EnableOption::SwizzleBankConflicts},
+          {"tma_pointwise", EnableOption::TmaPointwise},
+          {"transposed_outer_reduction",
+           EnableOption::TransposedOuterReduction},
           {"warn_register_spill", EnableOption::WarnRegisterSpill},
+          {"warp_sync", EnableOption::WarpSync},
+          {"zero_copy_cat", EnableOption::ZeroCopyCat},
       };
   return available_options;
 }
@@ -190,13 +251,17 @@ const std::unordered_map<std::string, DisableOption>& getDisableOptions() {
   static const std::unordered_map<std::string, DisableOption>
       available_options = {
           {"compile_to_sass", DisableOption::CompileToSass},
+          {"compiled_binary_cache", DisableOption::CompiledBinaryCache},
           {"contig_indexing", DisableOption::ContigIndexing},
+          {"expr_eval_view_replay", DisableOption::ExprEvalViewReplay},
           {"expr_simplify", DisableOption::ExprSimplify},
           {"fallback", DisableOption::Fallback},
           {"fma", DisableOption::Fma},
           {"grouped_grid_welford_outer_opt",
            DisableOption::GroupedGridWelfordOuterOpt},
+          {"horizontal_fusion", DisableOption::HorizontalFusion},
           {"index_hoist", DisableOption::IndexHoist},
+          {"lazy_serde", DisableOption::LazySerde},
           {"magic_zero", DisableOption::MagicZero},
           {"matmul_expr_eval", DisableOption::MatmulExprEval},
           {"nvtx", DisableOption::Nvtx},
@@ -204,6 +269,7 @@ const std::unordered_map<std::string, DisableOption>& getDisableOptions() {
           {"parallel_serde", DisableOption::ParallelSerde},
           {"predicate_elimination", DisableOption::PredicateElimination},
           {"python_inline_definitions", DisableOption::PythonInlineDefinitions},
+          {"rematerialization", DisableOption::Rematerialization},
           {"kernel_reuse", DisableOption::KernelReuse},
           {"var_name_remapping", DisableOption::VarNameRemapping},
           {"welford_vectorization", DisableOption::WelfordVectorization},
@@ -246,6 +312,7 @@ std::unordered_map<ProfilerOption, std::vector<std::string>> Options<
       {"print", ProfilerOption::Print},
       {"print.nocupti", ProfilerOption::PrintNocupti},
       {"print.verbose", ProfilerOption::PrintVerbose},
+      {"metrics", ProfilerOption::Metrics},
   };
 
   auto options = parseEnvOptions("PROF", available_options);
@@ -346,5 +413,13 @@ bool isProfilerPrintingVerbose() {
   return ProfilerOptionsGuard::getCurOptions().has(
       ProfilerOption::PrintVerbose);
 }
+bool isProfilerCollectingMetrics() {
+  return ProfilerOptionsGuard::getCurOptions().has(ProfilerOption::Metrics);
+}
+
+const std::vector<std::string>& getProfilerOptionArguments(
+    ProfilerOption option) {
+  return ProfilerOptionsGuard::getCurOptions().getArgs(option);
+}
 
 } // namespace nvfuser
@@ -45,6 +45,8 @@ enum class DebugDumpOption {
                 //!< for conciseness
   KernelIr, //!< Dump the compiler Kernel IR
   ComputeAtMap, //!< Dump the computeAt map
+  CompileTimes, //!< Dump the host time spent in each phase of compiling a
+                //!< fusion after its segments are compiled
   CudaKernel, //!< Dump the generated CUDA C++ kernel code
   CudaFull, //!< Dump the complete CUDA C++ code
   CudaToFile, //!< Dump CUDA Strings to File
@@ -61,6 +63,7 @@ enum class DebugDumpOption {
   SchedulerDebug, //! Dump scheduler heuristic parameters
   SchedulerVerbose, //! Dump detailed scheduler logging
   ParallelDimensions, //!< Dump known parallel dimensions
+  PeakMemory, //!< Dump the memory of each FusionKernelRuntime execution
   PerfDebugVerbose, //! When running kernels, print verbose information
                     //! associated with what's running
   PreSegmenterLogging,
@@ -91,21 +94,180 @@ enum class DebugDumpOption {
 //! These can be set through the `NVFUSER_ENABLE` environment variable
 //!
 enum class EnableOption {
+  AsyncCompile, //! Compile new kernels in the background and evaluate fusions
+                //! with ATen until they are ready
+  Autotune, //! Benchmark variants of the pointwise and reduction heuristics
+            //! of a new single-kernel fusion and keep the fastest
+  ClusterReduction, //! Let the reduction heuristic combine small cross-grid
+                    //! reductions within a thread block cluster through
+                    //! distributed shared memory on Hopper
+  CoalesceCommunications, //! Group adjacent independent collectives of the
+                          //! same team of a host program into coalesced
+                          //! regions
+  CombinedInnerOuterReduction, //! Let the combined inner-outer scheduler
+                               //! take an inner and an outer reduction of a
+                               //! shared input that need no persistent
+                               //! buffer, e.g. row and column sums
+  CommunicatorBackendTable, //! Select the backend of collectives by message
+                            //! size from a table calibrated when the
+                            //! Communicator is created. Takes the directory
+                            //! the table is stored in as an optional
+                            //! argument.
+  CompactTensorArgs, //! Don't pass the sizes or strides of a tensor to a
+                     //! kernel that never reads them
+  CompressKernelBinaries, //! Store the cubins and PTX of serialized fusion
+                          //! caches and of the kernel db compressed with
+                          //! zstd. Requires NVFUSER_BUILD_WITH_ZSTD.
+  CompressedCollectives, //! Compress the data of sum Allreduces and
+                         //! ReduceScatters of FP32 or BF16 tensors to FP8
+                         //! with per-block scales
+  ConcurrentSegments, //! Run independent segments of a fusion on a pool of
+                      //! CUDA streams. The optional argument sets the number
+                      //! of streams.
+  CostBasedSharding, //! Propagate shardings to unannotated tensors by
+                     //! minimizing the estimated resharding volume
+  CudaGraph, //! Capture the kernels of a fusion into a CUDA graph per input
+             //! shape and replay it on later runs
+  DeterministicReductions, //! Make reductions and scatters produce the same
+                           //! bits on every run, e.g., by not picking
+                           //! kernels by timing or evaluating scatters with
+                           //! duplicate indices with ATen
   FuseMatmul, //! Enable automatic fusion of matmul and linear ops
   FuseMultipleMatmuls, //! Allow fusing more than one matmul in a single kernel
+  GridPersistentNormalization, //! Split the rows of inner persistent
+                               //! normalizations that don't fit in a block
+                               //! across a grid that combines the partial
+                               //! reductions with a cooperative allreduce
+  GridStridePointwise, //! Launch the 1D pointwise schedule with one wave of
+                       //! CTAs looping over the tiles with a grid stride
+  GridSwizzle, //! Rasterize the 2D grids of the pointwise and transpose
+               //! schedules in groups of tiles sharing data in L2
+  HeuristicSnapshot, //! Reuse the tuned heuristics of fusions recorded in
+                     //! a HeuristicSnapshot, also by older versions, and
+                     //! record the new ones. Takes the path of the snapshot
+                     //! as an optional argument.
+  HostScalarHoisting, //! Evaluate the integer scalars a kernel computes
+                      //! only from its inputs, e.g., products and ceilDivs
+                      //! of extents, on the host once per launch, and
+                      //! pass them as kernel arguments
   IdModel, //! Enable IdModel
+  IndexStrengthReduction, //! Replace hoisted indices of serial loops that
+                          //! are affine in the loop index with a running
+                          //! scalar advanced at the end of each iteration
+  IndexTypeVariants, //! Reuse a runtime compiled with 32-bit indexing for
+                     //! inputs that need 64-bit indexing, compiling the
+                     //! 64-bit variants of its kernels on first use
+  IntermediateArena, //! Place segment intermediates in one planned buffer
+                     //! per runtime
   IoToLowerPrecision, //! Enable castInputOutputToLowerPrecision. #1889 explains
                       //! why we disabled it by default.
   KernelDb, //! Enable Kernel Database
   KernelDebug, //! Enable debug mode in nvrtc
   KernelLineInfo, //! Embed line info to compiled kernel, and dump the full CUDA
                   //! C++ code
+  KernelPerfDb, //! Record the time, heuristic params, and registers of every
+                //! kernel launch to a KernelPerfDb. Takes the directory of the
+                //! db and the label of the run as optional arguments.
   KernelProfile, //! Enable intra-kernel performance profiling
+  KernelTimeline, //! Record a per-warp timeline of TMA issues, mbarrier
+                  //! waits, mma issues, and epilogue stores of the first
+                  //! blocks of each kernel. Takes the number of sampled
+                  //! blocks and of records per warp as optional arguments.
+  L2PersistIntermediates, //! Keep the intermediates of an intermediate arena
+                          //! persisting in L2 between the segments
+  LatencyMode, //! Avoid grid reductions in reductions of at most 64Ki
+               //! elements, or of the optional argument, to minimize the
+               //! latency of tiny fusions
+  LazyKernelLoading, //! Load kernels as context-independent CUDA libraries
+                     //! shared by all devices, whose code is loaded on a
+                     //! device on the first use of the kernel (CUDA 12+)
+  LimitRegisterPressure, //! Shrink the unroll factors of pointwise and
+                         //! reduction kernels whose estimated registers
+                         //! exceed maxrregcount, or which spill more bytes
+                         //! than the optional argument (default 0)
+  MatmulAutoSelect, //! Time ATen and the Matmul scheduler on the first run
+                    //! of each input shape of a fusion with matmuls and keep
+                    //! the faster runtime
+  MatmulSplitK, //! Let the Hopper matmul heuristic split K across CTAs when
+                //! the output tiles leave SMs idle. Partial sums are reduced
+                //! serially, so results stay deterministic.
+  Megakernel, //! Run the kernel segments of a fusion as the stages of a
+              //! single persistent cooperative kernel when their launches
+              //! are compatible (experimental)
+  MemoizeExprSimplify, //! Memoize the results of simplifyExpr on
+                       //! structurally equal expressions during lowering
+  MemoizeTransformReplay, //! Memoize the loop positions TransformPropagator
+                          //! matches without replay within a fusion
   MemoryPromotion, //! Enable promotion of memory types for non-pointwise ops
+  MinimalPreamble, //! Only include the runtime files a kernel refers to,
+                   //! and their dependencies, in its preamble. Ignored with
+                   //! PrecompiledPreamble, which shares the full preamble.
+  MisalignedVectorize, //! Let the pointwise heuristic vectorize elementwise
+                       //! fusions whose inputs are not aligned, handling the
+                       //! misaligned head and tail with scalar accesses
+  OccupancyTarget, //! Lower maxrregcount and set the shared memory carve-out
+                   //! so that the blocks per SM intended by the heuristic
+                   //! fit, relaxing the register cap if ptxas spills
+  PadGlobalIntermediates, //! Allocate the global intermediates of a kernel
+                          //! by their loop domains, rounding their extents
+                          //! up to the split factors, so that writing them
+                          //! needs no boundary predicates
+  ParallelLowering, //! Run independent analyses of the lowering of a kernel
+                    //! concurrently on the thread pool
+  PartialSegmentCopy, //! Copy only the statements a segment depends on into
+                      //! its fusion instead of the complete fusion
+  PrecompiledPreamble, //! Compile the kernel preamble once as an NVRTC
+                       //! precompiled header and reuse it for every kernel
+  PrefetchAllgathers, //! Post the allgathers of parameters of host programs
+                      //! ahead of their consumers on a communication
+                      //! stream. Takes the number of compute segments to
+                      //! prefetch over, 2 by default, and the memory budget
+                      //! of the prefetched parameters in MiB, 1024 by
+                      //! default, as optional arguments.
+  PruneMagicZero, //! Only protect the unrolled loops that contain predicates
+                  //! depending on their indices with magic zero
+  ResettingGridSync, //! Make the grid syncs of cooperative kernels clear
+                     //! their semaphores, so that they reuse zeroed memory
+                     //! instead of clearing it before each launch
   ReuseZeroedMemory, //! Re-use zeroed memory used for grid synchronization
   ResizeScheduler, //! Enable the resize scheduler
+  SegmenterCostModel, //! Only merge segments when an analytical model of
+                      //! the bytes moved and the occupancy of persistent
+                      //! buffers predicts the merged kernel to be faster
+  SerialLoopPrefetch, //! Let the reduction heuristic prefetch the loads of
+                      //! the next iteration of the serial reduction loop
+                      //! into registers
+  SmemBroadcastInputs, //! Stage the inputs of 2D pointwise schedules that
+                       //! are broadcast across the rows of a block in
+                       //! shared memory, loaded once per block
+  SmemIntervalPacking, //! Pack shared memory allocations of compile-time
+                       //! size by their live intervals when that uses less
+                       //! memory than stack-based reuse
+  StageCpuScalars, //! Copy the CPU scalar tensor inputs of a fusion, e.g., a
+                   //! step count, through a pinned staging ring into device
+                   //! memory, so that kernels read them from global memory
+                   //! and the fusion can be captured into a CUDA graph
+  StaticBlockDim, //! Specialize kernels whose block size is fixed by the
+                  //! heuristic for that size, emitting it as constants and
+                  //! in __launch_bounds__
   StaticFusionCount, //! Enable using single static count in kernel name
+  SubTensorIndexing, //! Index tensors with more than 2^31 elements in 32-bit
+                     //! when each offset within the outermost allocation
+                     //! dimension provably fits, adding a 64-bit base
+  SwizzleBankConflicts, //! Swizzle the allocation of shared memory tensors
+                        //! whose accesses have bank conflicts, and keep the
+                        //! swizzles when they reduce the conflicts
+  TmaPointwise, //! Let the pointwise heuristic load large inputs with TMA on
+                //! Hopper
+  TransposedOuterReduction, //! Let the reduction heuristic reduce outer
+                            //! reductions of a small inner dimension in tiles
+                            //! transposed through shared memory
   WarnRegisterSpill, //! Enable warnings of register spill
+  WarpSync, //! Replace the block syncs between threads that are always in the
+            //! same warp with __syncwarp
+  ZeroCopyCat, //! Allocate the output of a segment that only concatenates
+               //! intermediates up front and let their producers write into
+               //! its slices instead of running the segment
   EndOfOption //! Placeholder for counting the number of elements
 };
 
@@ -116,13 +278,21 @@ enum class EnableOption {
 enum class DisableOption {
   CompileToSass, //! Disable direct compilation to sass so the ptx can be
                  //! examined
+  CompiledBinaryCache, //! Disable sharing compiled binaries of identical
+                       //! kernels across KernelExecutors and devices
   ContigIndexing, //! Disable contiguous indexing
+  ExprEvalViewReplay, //! Disable replaying the views of expr-eval segments
+                      //! with as_strided
   ExprSimplify, //! Disable expression simplifier
   Fallback, //! Disable fallback
   Fma, //! Disable FMA instructions
   GroupedGridWelfordOuterOpt, //! Disable use of outer-optimized
                               //! grouped grid welford kernel
+  HorizontalFusion, //! Disable fusing independent pointwise subgraphs and
+                    //! segments into a single kernel
   IndexHoist, //! Disable index hoisting
+  LazySerde, //! Disable deferring the deserialization of kernel runtimes to
+             //! their first use
   MagicZero, //! Disable nvfuser_zero
   MatmulExprEval, //! Disable ATen evaluation for the entire fusion containing
                   //! matmul
@@ -131,6 +301,8 @@ enum class DisableOption {
   ParallelSerde, //! Disable deserializing FusionExecutorCache in parallel
   PredicateElimination, //! Disable predicate elimination
   PythonInlineDefinitions, //! Disable printing of inline definitions
+  Rematerialization, //! Disable recomputing cheap producers in consumer
+                     //! segments instead of materializing them
   KernelReuse, //! Disable re-using cached FusionKernelRuntimes with different
                //! input shapes
   VarNameRemapping, //! Disable variable name remapping
@@ -164,6 +336,10 @@ enum class ProfilerOption {
   PrintVerbose, //! Enables the profiler and prints a complete set of columns
                 //! to the console.  WARNING: The output is will wrap on small
                 //! screens!
+  Metrics, //! Enables the profiler and collects hardware counters of each
+           //! kernel with the CUPTI range profiler, which replays kernels.
+           //! Takes the names of the metrics to collect as arguments, e.g.,
+           //! metrics(dram__bytes.sum), or collects a default set.
   EndOfOption //! Placeholder for counting the number of elements
 };
 
@@ -300,6 +476,7 @@ bool isProfilerEnabled();
 bool isProfilerEnabledWithCupti();
 bool isProfilerPrintingEnabled();
 bool isProfilerPrintingVerbose();
+bool isProfilerCollectingMetrics();
 
 const std::vector<std::string>& getProfilerOptionArguments(
     ProfilerOption option);
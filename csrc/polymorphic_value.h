@@ -246,6 +246,10 @@ inline bool isSameNanSensitive(const T& a, const T& b) {
 }
 
 inline bool isSame(const PolymorphicValue& a, const PolymorphicValue& b) {
+  // Fast path for the most common case, which avoids looking up the types
+  if (a.is<int64_t>() && b.is<int64_t>()) {
+    return a.as<int64_t>() == b.as<int64_t>();
+  }
   if (a.type() != b.type()) {
     return false;
   }
@@ -12,6 +12,9 @@
 #include <logical_domain_map.h>
 #include <preseg_passes/allocation_order_inference.h>
 
+#include <algorithm>
+#include <unordered_set>
+
 namespace nvfuser::preseg_passes {
 
 namespace {
@@ -71,10 +74,10 @@ int64_t countNonTrivialIterDomains(const TensorView* tv) {
 // 3. append reversed mapped_ids at the end of unmapped_id_vec.
 //   target_alloc_domain
 //   {iS3[i3], iS4[i4], iS6[i5], ir8[1], iS5[i1], iS7[i2]}
-void mapAllocationDomain(
+std::vector<IterDomain*> mappedAllocationDomain(
     const IdModel& id_model,
     const TensorView* ref,
-    TensorView* target) {
+    const TensorView* target) {
   const ValGraph& exact_graph = id_model.idGraph(IdMappingMode::EXACT);
 
   std::vector<IterDomain*> ref_alloc_domain = ref->getMaybeAllocationDomain();
@@ -208,12 +211,75 @@ void mapAllocationDomain(
   std::copy(mapped_ids.rbegin(), mapped_ids.rend(), unmapped_ids_vec_end);
 #endif
 
+  return target_alloc_domain;
+}
+
+void mapAllocationDomain(
+    const IdModel& id_model,
+    const TensorView* ref,
+    TensorView* target) {
+  std::vector<IterDomain*> target_alloc_domain =
+      mappedAllocationDomain(id_model, ref, target);
   // skip trivial allocation domain
-  if (target_alloc_domain != target_logical_domain) {
+  if (target_alloc_domain != target->getLogicalDomain()) {
     target->setAllocationDomain(target_alloc_domain, true);
   }
 }
 
+// Returns the fastest non-broadcast & non-reduction iter domain of domain, or
+// nullptr if there's none.
+IterDomain* innermostNonTrivialId(const std::vector<IterDomain*>& domain) {
+  auto it = std::find_if(domain.rbegin(), domain.rend(), [](IterDomain* id) {
+    return !id->isBroadcast() && !id->isReduction();
+  });
+  return it == domain.rend() ? nullptr : *it;
+}
+
+// Note [ Global Layout Cost ]
+//
+// Estimates how many of the accesses touching target are transposed, when
+// target is allocated as target_alloc_domain. neighbors are the tensors read
+// or written in the same fusion as target, paired with their weights.
+//
+// A neighbor whose innermost non-trivial allocation iter domain is exactly
+// mapped to a non-trivial iter domain of target agrees with target's layout
+// only if target's innermost non-trivial allocation iter domain falls in the
+// same exact group. Otherwise one side of the copy between them is
+// uncoalesced, and the weight of the neighbor is added to the cost. Neighbors
+// whose innermost dimension doesn't exist in target are transposed whatever
+// layout target picks, so they don't contribute.
+int64_t transposeCost(
+    const ValGraph& exact_graph,
+    const TensorView* target,
+    const std::vector<IterDomain*>& target_alloc_domain,
+    const std::vector<std::pair<TensorView*, int64_t>>& neighbors) {
+  IterDomain* target_innermost = innermostNonTrivialId(target_alloc_domain);
+  int64_t cost = 0;
+  for (const auto& [tv, weight] : neighbors) {
+    IterDomain* innermost =
+        innermostNonTrivialId(tv->getMaybeAllocationDomain());
+    if (innermost == nullptr || !exact_graph.hasGroup(innermost)) {
+      continue;
+    }
+    const ValGroup& vg = exact_graph.toGroup(innermost);
+    if (std::none_of(
+            target->getLogicalDomain().begin(),
+            target->getLogicalDomain().end(),
+            [&](IterDomain* id) {
+              return !id->isBroadcast() && !id->isReduction() &&
+                  exact_graph.hasGroup(id) && exact_graph.toGroup(id) == vg;
+            })) {
+      continue;
+    }
+    if (target_innermost == nullptr ||
+        !exact_graph.hasGroup(target_innermost) ||
+        exact_graph.toGroup(target_innermost) != vg) {
+      cost += weight;
+    }
+  }
+  return cost;
+}
+
 // Note [ Allocation Order Propagation ]
 //
 // The propagation tries to populate allocation domain from srcs to dsts.
@@ -236,7 +302,12 @@ void mapAllocationDomain(
 //         Note1: when we have multiple candidates with the same count of
 //         non-trivial iter domains, we require there's no ambiguity by
 //         checking both candidates having the same iter domain mapping.
-//         Otherwise we'll stop the propagation by leaving ref as nullptr.
+//         Otherwise we don't propagate from a single reference, but pick
+//         among the layouts of the tied candidates and target's logical
+//         domain the one with the lowest cost over the DAG, i.e., the inputs
+//         dst depends on and the dsts visited before it, or with a user
+//         specified allocation domain, that share an input with dst. See
+//         Note [ Global Layout Cost ]. Ties keep the logical domain.
 //     2.3 It does not have self mapping;
 //   3. Propagate memory format from selected reference in `srcs` to its
 //   corresponding target in `dsts`.
@@ -269,6 +340,33 @@ void inferenceAllocationOrder(
     }
   }
 
+  // srcs each dst depends on, used to weigh layouts across the whole DAG
+  std::unordered_map<TensorView*, std::unordered_set<TensorView*>> dst_srcs;
+  for (TensorView* dst : dsts) {
+    if (dst == nullptr) {
+      continue;
+    }
+    for (TensorView* tv : srcs) {
+      if (DependencyCheck::isDependencyOf(tv, dst)) {
+        dst_srcs[dst].insert(tv);
+      }
+    }
+  }
+  auto share_src = [&dst_srcs](TensorView* a, TensorView* b) {
+    return std::any_of(
+        dst_srcs[a].begin(), dst_srcs[a].end(), [&](TensorView* tv) {
+          return dst_srcs[b].count(tv) > 0;
+        });
+  };
+
+  // dsts whose layout is settled, either by the user or by this pass
+  std::vector<TensorView*> visited_dsts;
+  for (TensorView* dst : dsts) {
+    if (dst != nullptr && dst->hasAllocation()) {
+      visited_dsts.push_back(dst);
+    }
+  }
+
   // propagate new allocation domain on dsts
   for (TensorView* dst : dsts) {
     // safe check when allocation domain on the entry cannot be safely mutated.
@@ -276,6 +374,7 @@ void inferenceAllocationOrder(
         fusion->getOutputAlias(dst).type != AllocationType::New) {
       continue;
     }
+    visited_dsts.push_back(dst);
 
     // skip entry with self mapping.
     if (hasSelfMapping(dst, exact_graph).has_value()) {
@@ -284,6 +383,8 @@ void inferenceAllocationOrder(
 
     // find a ref among srcs to be propagated to given dst
     TensorView* ref = nullptr;
+    // all srcs with the highest non-trivial iter domain count
+    std::vector<TensorView*> candidates;
 
     // high water mark for candidate of ref.
     int64_t non_bc_high_water_mark = 0;
@@ -303,9 +404,13 @@ void inferenceAllocationOrder(
       // new candidate found, update ref and high water mark.
       if (non_trivial_iter_count[tv] > non_bc_high_water_mark) {
         ref = tv;
+        candidates = {tv};
         non_bc_high_water_mark = non_trivial_iter_count[tv];
         continue;
       }
+      if (non_trivial_iter_count[tv] == non_bc_high_water_mark) {
+        candidates.push_back(tv);
+      }
       // found multiple candidate with the same iterdomain count
       if (non_trivial_iter_count[tv] == non_bc_high_water_mark &&
           ref != nullptr) {
@@ -330,6 +435,37 @@ void inferenceAllocationOrder(
     // propagate allocation domain if we still have a candidate.
     if (ref) {
       mapAllocationDomain(id_model, ref, dst);
+      continue;
+    }
+    if (candidates.size() < 2) {
+      continue;
+    }
+
+    // ambiguous references, pick the cheapest layout for the whole DAG. See
+    // Note [ Global Layout Cost ]
+    std::vector<std::pair<TensorView*, int64_t>> neighbors;
+    for (TensorView* tv : dst_srcs[dst]) {
+      neighbors.emplace_back(tv, countNonTrivialIterDomains(tv));
+    }
+    for (TensorView* tv : visited_dsts) {
+      if (tv != dst && share_src(tv, dst)) {
+        neighbors.emplace_back(tv, countNonTrivialIterDomains(tv));
+      }
+    }
+    std::vector<IterDomain*> best_alloc_domain = dst->getLogicalDomain();
+    int64_t best_cost =
+        transposeCost(exact_graph, dst, best_alloc_domain, neighbors);
+    for (TensorView* candidate : candidates) {
+      std::vector<IterDomain*> alloc_domain =
+          mappedAllocationDomain(id_model, candidate, dst);
+      int64_t cost = transposeCost(exact_graph, dst, alloc_domain, neighbors);
+      if (cost < best_cost) {
+        best_alloc_domain = std::move(alloc_domain);
+        best_cost = cost;
+      }
+    }
+    if (best_alloc_domain != dst->getLogicalDomain()) {
+      dst->setAllocationDomain(best_alloc_domain, true);
     }
   }
 }
@@ -399,7 +535,18 @@ void AllocationDomainPass::runPass(Fusion* fusion) {
   // see issue: https://github.com/NVIDIA/Fuser/pull/2425
   for (TensorView* output : output_tvs) {
     if (Expr* def = output->definition()) {
-      if (def->isOneOf<LinearOp, SdpaFwdOp, SdpaBwdOp, MatmulOp, MmaOp>()) {
+      if (def->isOneOf<
+              LinearOp,
+              GroupedMatmulOp,
+              SegmentedReductionOp,
+              EmbeddingBwdOp,
+              ScanOp,
+              SortOp,
+              TopKOp,
+              SdpaFwdOp,
+              SdpaBwdOp,
+              MatmulOp,
+              MmaOp>()) {
         continue;
       }
     }
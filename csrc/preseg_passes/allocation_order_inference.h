@@ -16,7 +16,9 @@ namespace nvfuser::preseg_passes {
 
 // Realize allocation order propagation on fusion inputs to optimize allocation
 // domain of output tensor. This optimization pass currently only applies to
-// fusion outputs, but not intermediate tensors.
+// fusion outputs, but not intermediate tensors. When inputs disagree on the
+// layout of an output, the layout with the fewest transposed accesses across
+// the fusion is picked.
 class AllocationDomainPass : public OptimizationPass<AllocationDomainPass> {
   friend class OptimizationPass<AllocationDomainPass>;
 
@@ -0,0 +1,191 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <preseg_passes/cse.h>
+
+#include <fusion.h>
+#include <ir/interface_nodes.h>
+#include <ir/internal_nodes.h>
+#include <ir/utils.h>
+#include <multidevice/utils.h>
+#include <utils.h>
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace nvfuser::preseg_passes {
+
+namespace {
+
+bool isCommutative(const Expr* expr) {
+  auto* bop = dynamic_cast<const BinaryOp*>(expr);
+  if (bop == nullptr) {
+    return false;
+  }
+  switch (bop->getBinaryOpType()) {
+    case BinaryOpType::Add:
+    case BinaryOpType::Mul:
+    case BinaryOpType::BitwiseAnd:
+    case BinaryOpType::BitwiseOr:
+    case BinaryOpType::BitwiseXor:
+    case BinaryOpType::Eq:
+    case BinaryOpType::NE:
+    case BinaryOpType::LogicalAnd:
+    case BinaryOpType::LogicalOr:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns true if the outputs of expr may be replaced by those of an
+// equivalent expression or replace them
+bool canMerge(const Expr* expr) {
+  if (expr->isOneOf<RNGOp, SdpaFwdOp>() || isResharding(expr)) {
+    return false;
+  }
+  return std::all_of(
+      expr->outputs().begin(), expr->outputs().end(), [](Val* out) {
+        return out->isA<TensorView>() &&
+            (!out->isFusionOutput() ||
+             out->fusion()->getOutputAlias(out).type == AllocationType::New);
+      });
+}
+
+bool sameOutputs(const Expr* expr, const Expr* other) {
+  for (const auto i : c10::irange(expr->outputs().size())) {
+    auto* out = expr->output(i)->as<TensorView>();
+    auto* other_out = other->output(i)->as<TensorView>();
+    if (out->dtype() != other_out->dtype() ||
+        !out->domain()->sameAs(other_out->domain()) ||
+        out->getContiguity() != other_out->getContiguity()) {
+      return false;
+    }
+    if (out->hasDeviceMesh() != other_out->hasDeviceMesh() ||
+        (out->hasDeviceMesh() &&
+         !(out->getDeviceMesh() == other_out->getDeviceMesh()))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool sameInput(Val* input, Val* other_input) {
+  return input == other_input ||
+      (!input->isA<TensorView>() && input->sameAs(other_input));
+}
+
+// Finds the first visited expression that computes the same values as the
+// given one. The inputs of the expressions are expected to be replaced by
+// their representatives already.
+class ExprTable {
+ public:
+  // Returns the equivalent expression visited before, if any, or records expr
+  // and returns nullptr
+  Expr* findOrInsert(Expr* expr, const std::vector<Val*>& inputs) {
+    std::vector<std::pair<Expr*, std::vector<Val*>>>& bucket =
+        buckets_[hash(expr, inputs)];
+    for (const auto& [other, other_inputs] : bucket) {
+      if (same(expr, inputs, other, other_inputs)) {
+        return other;
+      }
+    }
+    bucket.emplace_back(expr, inputs);
+    return nullptr;
+  }
+
+ private:
+  // Scalars are hashed by their expressions, so that equivalent ones created
+  // separately, e.g., by each copy of a normalization, hash the same
+  static size_t hashInput(Val* input) {
+    if (input->isA<TensorView>()) {
+      return std::hash<Val*>()(input);
+    }
+    return std::hash<std::string>()(input->toInlineString());
+  }
+
+  static size_t hash(const Expr* expr, const std::vector<Val*>& inputs) {
+    size_t hash = typeid(*expr).hash_code();
+    hashCombine(hash, expr->attributes().size());
+    std::vector<size_t> input_hashes;
+    input_hashes.reserve(inputs.size());
+    for (Val* input : inputs) {
+      input_hashes.push_back(hashInput(input));
+    }
+    if (isCommutative(expr)) {
+      std::sort(input_hashes.begin(), input_hashes.end());
+    }
+    for (size_t input_hash : input_hashes) {
+      hashCombine(hash, input_hash);
+    }
+    return hash;
+  }
+
+  static bool same(
+      const Expr* expr,
+      const std::vector<Val*>& inputs,
+      const Expr* other,
+      const std::vector<Val*>& other_inputs) {
+    if (!expr->sameOp(other) || !sameOutputs(expr, other)) {
+      return false;
+    }
+    auto same_inputs = [&](bool swapped) {
+      for (const auto i : c10::irange(inputs.size())) {
+        const auto j = swapped ? inputs.size() - 1 - i : i;
+        if (!sameInput(inputs[i], other_inputs[j])) {
+          return false;
+        }
+      }
+      return true;
+    };
+    return same_inputs(/*swapped=*/false) ||
+        (isCommutative(expr) && same_inputs(/*swapped=*/true));
+  }
+
+  std::unordered_map<size_t, std::vector<std::pair<Expr*, std::vector<Val*>>>>
+      buckets_;
+};
+
+} // namespace
+
+void CsePass::runPass(Fusion* fusion) {
+  // Computed for all expressions before any is replaced, since replacing the
+  // inputs of an expression creates a new one
+  std::unordered_map<Val*, Val*> representatives;
+  std::vector<std::pair<Val*, Val*>> replacements;
+  ExprTable table;
+  for (Expr* expr : fusion->exprs()) {
+    if (!canMerge(expr)) {
+      continue;
+    }
+    std::vector<Val*> inputs;
+    inputs.reserve(expr->inputs().size());
+    for (Val* input : expr->inputs()) {
+      auto it = representatives.find(input);
+      inputs.push_back(it == representatives.end() ? input : it->second);
+    }
+    Expr* equivalent = table.findOrInsert(expr, inputs);
+    if (equivalent == nullptr) {
+      continue;
+    }
+    for (const auto i : c10::irange(expr->outputs().size())) {
+      representatives[expr->output(i)] = equivalent->output(i);
+      replacements.emplace_back(expr->output(i), equivalent->output(i));
+    }
+  }
+
+  for (auto [old_val, new_val] : replacements) {
+    ir_utils::replaceValInAllExprInputsAndFusionOutputs(old_val, new_val);
+  }
+}
+
+} // namespace nvfuser::preseg_passes
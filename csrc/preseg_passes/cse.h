@@ -0,0 +1,41 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <preseg_passes/optimization_pass.h>
+
+namespace nvfuser::preseg_passes {
+
+//! CsePass merges tensor expressions that compute the same values, e.g.,
+//!
+//!   t1 = castOp(Float, t0)
+//!   t2 = castOp(Float, t0)
+//!   t3 = add(t1, t2)
+//!
+//! becomes
+//!
+//!   t1 = castOp(Float, t0)
+//!   t3 = add(t1, t1)
+//!
+//! Expressions are the same if they are of the same op with the same
+//! attributes and inputs, where the inputs of commutative binary ops may be
+//! swapped, and if their outputs have the same dtypes and domains. Since
+//! expressions are visited in topological order, chains of duplicated
+//! expressions, such as whole normalizations, are merged one expression at a
+//! time. Random ops and outputs that alias inputs are never merged.
+class CsePass : public OptimizationPass<CsePass> {
+  friend class OptimizationPass<CsePass>;
+
+ protected:
+  static void runPass(Fusion* fusion);
+  static std::string name() {
+    return "CsePass";
+  }
+};
+
+} // namespace nvfuser::preseg_passes
@@ -0,0 +1,147 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <preseg_passes/donate_inputs.h>
+
+#include <deque>
+#include <unordered_set>
+#include <vector>
+
+#include <fusion.h>
+#include <id_model/id_model.h>
+#include <ir/all_nodes.h>
+#include <ir/utils.h>
+
+namespace nvfuser::preseg_passes {
+
+namespace {
+
+bool isElementwise(Expr* expr) {
+  if (auto* ldst = dynamic_cast<LoadStoreOp*>(expr)) {
+    return ldst->opType() == LoadStoreOpType::Set;
+  }
+  return expr->isOneOf<UnaryOp, BinaryOp, TernaryOp>();
+}
+
+// Returns true if tv's logical domain is exactly mapped to in's, position by
+// position, i.e., tv is indexed the same way as in
+bool isIndexedLike(
+    const ValGraph& exact_graph,
+    const TensorView* in,
+    const TensorView* tv) {
+  const std::vector<IterDomain*>& in_logical = in->getLogicalDomain();
+  const std::vector<IterDomain*>& logical = tv->getLogicalDomain();
+  if (logical.size() != in_logical.size()) {
+    return false;
+  }
+  for (auto i : c10::irange(logical.size())) {
+    if (!exact_graph.hasGroup(logical[i]) ||
+        !exact_graph.hasGroup(in_logical[i]) ||
+        exact_graph.toGroup(logical[i]) != exact_graph.toGroup(in_logical[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the fusion output that can be written in place of in, or nullptr
+// if there's none. See InputDonationPass.
+TensorView* findInPlaceOutput(const ValGraph& exact_graph, TensorView* in) {
+  TensorView* out = nullptr;
+  std::unordered_set<TensorView*> visited;
+  std::deque<TensorView*> to_visit = {in};
+  while (!to_visit.empty()) {
+    TensorView* tv = to_visit.front();
+    to_visit.pop_front();
+    if (!visited.insert(tv).second) {
+      continue;
+    }
+    if (tv != in && tv->isFusionOutput()) {
+      if (out != nullptr) {
+        return nullptr;
+      }
+      out = tv;
+    }
+    for (Expr* use : tv->uses()) {
+      if (!isElementwise(use)) {
+        return nullptr;
+      }
+      for (auto* use_out : ir_utils::filterByType<TensorView>(use->outputs())) {
+        if (!isIndexedLike(exact_graph, in, use_out)) {
+          return nullptr;
+        }
+        to_visit.push_back(use_out);
+      }
+    }
+  }
+  return out;
+}
+
+} // namespace
+
+void InputDonationPass::runPass(Fusion* fusion) {
+  std::vector<TensorView*> donatable_inputs;
+  for (auto* in : ir_utils::filterByType<TensorView>(fusion->inputs())) {
+    // Broadcast dimensions may be concretized, in which case an element is
+    // read by many threads
+    if (fusion->isDonatable(in) && !in->isFusionOutput() &&
+        !in->hasBroadcast()) {
+      donatable_inputs.push_back(in);
+    }
+  }
+  if (donatable_inputs.empty()) {
+    return;
+  }
+
+  std::unordered_set<Val*> aliased_inputs;
+  for (Val* out : fusion->outputs()) {
+    if (Val* aliased_io = fusion->getOutputAlias(out).aliased_io) {
+      aliased_inputs.insert(aliased_io);
+    }
+  }
+
+  IdModel id_model(fusion, /*build_graphs=*/false, /*allow_self_mapping=*/true);
+  id_model.buildExactGraph();
+  const ValGraph& exact_graph = id_model.idGraph(IdMappingMode::EXACT);
+
+  for (TensorView* in : donatable_inputs) {
+    if (aliased_inputs.count(in)) {
+      continue;
+    }
+    TensorView* out = findInPlaceOutput(exact_graph, in);
+    if (out == nullptr || out->dtype() != in->dtype() ||
+        fusion->getOutputAlias(out).type != AllocationType::New) {
+      continue;
+    }
+
+    // out is written with the strides of in
+    std::optional<std::vector<int64_t>> in_order = ir_utils::computePermutation(
+        in->getLogicalDomain(), in->getMaybeAllocationDomain());
+    if (!in_order.has_value()) {
+      continue;
+    }
+    if (out->hasAllocation()) {
+      if (ir_utils::computePermutation(
+              out->getLogicalDomain(), out->getMaybeAllocationDomain()) !=
+              in_order ||
+          out->getContiguity() != in->getContiguity()) {
+        continue;
+      }
+    } else if (in->hasAllocation()) {
+      out->setAllocationDomain(
+          ir_utils::applyPermutation(out->getLogicalDomain(), *in_order),
+          in->getContiguity());
+    } else {
+      out->setContiguity(in->getContiguity());
+    }
+
+    fusion->aliasOutputToInput(out, in, AllocationType::ReuseBuffer);
+    aliased_inputs.insert(in);
+  }
+}
+
+} // namespace nvfuser::preseg_passes
@@ -0,0 +1,41 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <preseg_passes/optimization_pass.h>
+
+namespace nvfuser::preseg_passes {
+
+//! InputDonationPass writes outputs in place of the inputs marked with
+//! Fusion::markDonatable, e.g.,
+//!
+//!   t1 = relu(t0)        // t0 is donatable
+//!   t2 = mul(t1, bias)   // bias is broadcast
+//!
+//! aliases t2 to t0 with AllocationType::ReuseBuffer, so no buffer is
+//! allocated for t2. An input is written in place only when every tensor
+//! computed from it is computed element-wise at the same index with the same
+//! shape, and when exactly one fusion output is computed from it. Then each
+//! element of the input is read only by the thread writing the same element
+//! of the output, and segments reading the input run before the segment
+//! writing the output. The output keeps the dtype, allocation order and
+//! contiguity of the input.
+//!
+//! This runs after SegmentInplaceUpdatePass, whose copies protect in-place
+//! updates that could race, which the aliases made here can't.
+class InputDonationPass : public OptimizationPass<InputDonationPass> {
+  friend class OptimizationPass<InputDonationPass>;
+
+ protected:
+  static void runPass(Fusion* fusion);
+  static std::string name() {
+    return "InputDonationPass";
+  }
+};
+
+} // namespace nvfuser::preseg_passes
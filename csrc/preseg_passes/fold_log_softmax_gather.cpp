@@ -0,0 +1,166 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <preseg_passes/fold_log_softmax_gather.h>
+
+#include <fusion.h>
+#include <ir/interface_nodes.h>
+#include <ir/internal_nodes.h>
+#include <ir/utils.h>
+#include <ops/arith.h>
+#include <ops/indexing.h>
+
+#include <optional>
+#include <vector>
+
+namespace nvfuser::preseg_passes {
+
+namespace {
+
+// The reductions of a log_softmax along one dimension
+struct LogSoftmax {
+  TensorView* in = nullptr;
+  TensorView* max = nullptr;
+  TensorView* sum = nullptr;
+};
+
+template <typename T>
+T* definitionOf(Val* val) {
+  return val->isA<TensorView>() ? dynamic_cast<T*>(val->definition())
+                                : nullptr;
+}
+
+// Returns the input of a BroadcastOp, or val itself
+Val* skipBroadcast(Val* val) {
+  if (auto* bcast = definitionOf<BroadcastOp>(val)) {
+    return bcast->in();
+  }
+  return val;
+}
+
+// Returns the reduction producing val if it only reduces dim
+ReductionOp* getReductionAlong(Val* val, BinaryOpType op_type, int64_t dim) {
+  auto* rop = definitionOf<ReductionOp>(val);
+  if (rop == nullptr || rop->getReductionOpType() != op_type) {
+    return nullptr;
+  }
+  const auto& logical = rop->out()->as<TensorView>()->getLogicalDomain();
+  for (auto i : c10::irange(logical.size())) {
+    if (logical.at(i)->isReduction() != ((int64_t)i == dim)) {
+      return nullptr;
+    }
+  }
+  return rop;
+}
+
+UnaryOp* getUnaryOp(Val* val, UnaryOpType op_type) {
+  auto* uop = definitionOf<UnaryOp>(val);
+  if (uop == nullptr || uop->getUnaryOpType() != op_type) {
+    return nullptr;
+  }
+  return uop;
+}
+
+// Matches y = (x - max(x)) - log(sum(exp(x - max(x)))) along dim, with the
+// log applied before or after broadcasting the sum
+std::optional<LogSoftmax> matchLogSoftmax(TensorView* y, int64_t dim) {
+  auto* y_def = definitionOf<BinaryOp>(y);
+  if (y_def == nullptr || y_def->getBinaryOpType() != BinaryOpType::Sub) {
+    return std::nullopt;
+  }
+
+  Val* log_val = skipBroadcast(y_def->rhs());
+  UnaryOp* log_op = getUnaryOp(log_val, UnaryOpType::Log);
+  if (log_op == nullptr) {
+    return std::nullopt;
+  }
+  ReductionOp* sum_op =
+      getReductionAlong(skipBroadcast(log_op->in()), BinaryOpType::Add, dim);
+  if (sum_op == nullptr) {
+    return std::nullopt;
+  }
+  UnaryOp* exp_op = getUnaryOp(sum_op->in(), UnaryOpType::Exp);
+  if (exp_op == nullptr || exp_op->in() != y_def->lhs()) {
+    return std::nullopt;
+  }
+
+  auto* shifted = definitionOf<BinaryOp>(y_def->lhs());
+  if (shifted == nullptr || shifted->getBinaryOpType() != BinaryOpType::Sub ||
+      !shifted->lhs()->isA<TensorView>()) {
+    return std::nullopt;
+  }
+  ReductionOp* max_op =
+      getReductionAlong(skipBroadcast(shifted->rhs()), BinaryOpType::Max, dim);
+  if (max_op == nullptr || max_op->in() != shifted->lhs()) {
+    return std::nullopt;
+  }
+
+  return LogSoftmax{
+      shifted->lhs()->as<TensorView>(),
+      max_op->out()->as<TensorView>(),
+      sum_op->out()->as<TensorView>()};
+}
+
+void foldGather(TorchGatherOp* gather) {
+  TensorView* y = gather->lookupTv();
+  if (!gather->exactSizes() || y->uses().size() != 1 || y->isFusionOutput()) {
+    return;
+  }
+  const int64_t dim = gather->dim();
+  auto log_softmax = matchLogSoftmax(y, dim);
+  if (!log_softmax.has_value()) {
+    return;
+  }
+
+  // Gather from the fusion input whenever the log_softmax input is only an
+  // upcast of it, so that the gather can be fused
+  TensorView* lookup = log_softmax->in;
+  std::vector<DataType> casts;
+  while (auto* cast = getUnaryOp(lookup, UnaryOpType::Cast)) {
+    if (!cast->in()->isA<TensorView>()) {
+      break;
+    }
+    casts.push_back(lookup->dtype());
+    lookup = cast->in()->as<TensorView>();
+  }
+  if (!lookup->isFusionInput()) {
+    lookup = log_softmax->in;
+    casts.clear();
+  }
+
+  TensorView* picked = takeAlongAxis(lookup, gather->indexTv(), dim);
+  for (auto it = casts.rbegin(); it != casts.rend(); ++it) {
+    picked = castOp(*it, picked);
+  }
+
+  std::vector<bool> broadcast_mask(
+      TensorDomain::noReductions(y->getLogicalDomain()).size(), false);
+  broadcast_mask.at(dim) = true;
+  TensorView* log_sum_exp = add(log(log_softmax->sum), log_softmax->max);
+  TensorView* result = sub(picked, broadcast(log_sum_exp, broadcast_mask));
+  result = maybeCastOp(y->dtype(), result);
+
+  ir_utils::replaceValInAllExprInputsAndFusionOutputs(
+      gather->output(0), result);
+}
+
+} // namespace
+
+void FoldLogSoftmaxGatherPass::runPass(Fusion* fusion) {
+  std::vector<TorchGatherOp*> gather_ops;
+  for (Expr* expr : fusion->exprs()) {
+    if (auto* gather = dynamic_cast<TorchGatherOp*>(expr)) {
+      gather_ops.push_back(gather);
+    }
+  }
+
+  for (TorchGatherOp* gather : gather_ops) {
+    foldGather(gather);
+  }
+}
+
+} // namespace nvfuser::preseg_passes
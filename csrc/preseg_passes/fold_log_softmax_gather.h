@@ -0,0 +1,44 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <preseg_passes/optimization_pass.h>
+
+namespace nvfuser::preseg_passes {
+
+//! FoldLogSoftmaxGatherPass avoids materializing a log_softmax that is only
+//! used to pick the log-probability of the target class, as in a
+//! cross-entropy loss over a large vocabulary:
+//!
+//!   x = castOp(Float, logits)
+//!   m = max(x, {dim})
+//!   s = sum(exp(x - m), {dim})
+//!   y = x - m - log(s)
+//!   picked = takeAlongAxis(y, target, dim)
+//!
+//! becomes
+//!
+//!   picked = castOp(Float, takeAlongAxis(logits, target, dim)) - (m + log(s))
+//!
+//! A gather requires its lookup to be a fusion input, so the original fusion
+//! writes the full [tokens, vocab] y to global memory in its own segment. The
+//! rewrite only keeps the two reductions over the logits, and the gather
+//! reads one element per row. The log_softmax must not be used by anything
+//! else.
+class FoldLogSoftmaxGatherPass
+    : public OptimizationPass<FoldLogSoftmaxGatherPass> {
+  friend class OptimizationPass<FoldLogSoftmaxGatherPass>;
+
+ protected:
+  static void runPass(Fusion* fusion);
+  static std::string name() {
+    return "FoldLogSoftmaxGatherPass";
+  }
+};
+
+} // namespace nvfuser::preseg_passes
@@ -0,0 +1,126 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <preseg_passes/fold_sdpa_scale.h>
+
+#include <fusion.h>
+#include <ir/builder.h>
+#include <ir/interface_nodes.h>
+#include <ir/internal_nodes.h>
+#include <ir/utils.h>
+#include <ops/arith.h>
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace nvfuser::preseg_passes {
+
+namespace {
+
+// Matches operand = [castOp(dtype,)] mul([castOp(Float,)] x, c) with a scalar
+// c, and returns x and c. x has the dtype of operand.
+std::optional<std::pair<TensorView*, Val*>> getScaledOperand(
+    TensorView* operand) {
+  if (operand->uses().size() != 1 || operand->isFusionOutput()) {
+    return std::nullopt;
+  }
+
+  auto is_cast = [](Expr* expr) {
+    auto* uop = dynamic_cast<UnaryOp*>(expr);
+    return uop != nullptr && uop->getUnaryOpType() == UnaryOpType::Cast &&
+        uop->in()->isA<TensorView>();
+  };
+
+  TensorView* scaled = operand;
+  if (is_cast(operand->definition())) {
+    scaled = operand->definition()->input(0)->as<TensorView>();
+    if (scaled->uses().size() != 1 || scaled->isFusionOutput()) {
+      return std::nullopt;
+    }
+  }
+
+  auto* bop = dynamic_cast<BinaryOp*>(scaled->definition());
+  if (bop == nullptr || bop->getBinaryOpType() != BinaryOpType::Mul) {
+    return std::nullopt;
+  }
+
+  for (auto [x, c] :
+       {std::make_pair(bop->lhs(), bop->rhs()),
+        std::make_pair(bop->rhs(), bop->lhs())}) {
+    if (!x->isA<TensorView>() || c->isA<TensorView>() || !c->isScalar()) {
+      continue;
+    }
+    auto* x_tv = x->as<TensorView>();
+    if (x_tv->dtype() != operand->dtype() && is_cast(x_tv->definition()) &&
+        x_tv->definition()->input(0)->dtype() == operand->dtype()) {
+      x_tv = x_tv->definition()->input(0)->as<TensorView>();
+    }
+    if (x_tv->dtype() != operand->dtype()) {
+      continue;
+    }
+    return std::make_pair(x_tv, c);
+  }
+  return std::nullopt;
+}
+
+void foldScale(SdpaFwdOp* sdpa) {
+  auto scaled_query = getScaledOperand(sdpa->query());
+  auto scaled_key = getScaledOperand(sdpa->key());
+  if (!scaled_query.has_value() && !scaled_key.has_value()) {
+    return;
+  }
+
+  Val* scale = sdpa->scale();
+  if (scale == nullptr) {
+    // Default scale of SdpaFwdOp::evaluate, computed from the unpadded E
+    IterDomain* e_id =
+        TensorDomain::noReductions(sdpa->query()->getLogicalDomain()).back();
+    scale = reciprocal(sqrt(castOp(DataType::Double, e_id->extent())));
+  }
+
+  TensorView* query = sdpa->query();
+  if (scaled_query.has_value()) {
+    query = scaled_query->first;
+    scale = mul(scale, castOp(DataType::Double, scaled_query->second));
+  }
+  TensorView* key = sdpa->key();
+  if (scaled_key.has_value()) {
+    key = scaled_key->first;
+    scale = mul(scale, castOp(DataType::Double, scaled_key->second));
+  }
+
+  // Registering the new expression replaces the definition of the outputs
+  IrBuilder::create<SdpaFwdOp>(
+      sdpa->attn_out(),
+      sdpa->logsumexp(),
+      sdpa->philox_seed(),
+      sdpa->philox_offset(),
+      query,
+      key,
+      sdpa->value(),
+      sdpa->dropout_p(),
+      sdpa->is_causal(),
+      scale);
+}
+
+} // namespace
+
+void FoldSdpaScalePass::runPass(Fusion* fusion) {
+  std::vector<SdpaFwdOp*> sdpa_ops;
+  for (Expr* expr : fusion->exprs()) {
+    if (auto* sdpa = dynamic_cast<SdpaFwdOp*>(expr)) {
+      sdpa_ops.push_back(sdpa);
+    }
+  }
+
+  for (SdpaFwdOp* sdpa : sdpa_ops) {
+    foldScale(sdpa);
+  }
+}
+
+} // namespace nvfuser::preseg_passes
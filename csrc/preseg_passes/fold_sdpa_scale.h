@@ -0,0 +1,38 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <preseg_passes/optimization_pass.h>
+
+namespace nvfuser::preseg_passes {
+
+//! FoldSdpaScalePass folds scalar multiplications of the query or key of an
+//! SdpaFwdOp into its softmax scale. For example,
+//!
+//!   q = castOp(BFloat16, mul(castOp(Float, q_in), c))
+//!   o = sdpfa_fwd(q, k, v, dropout_p, is_causal, scale)
+//!
+//! becomes
+//!
+//!   o = sdpfa_fwd(q_in, k, v, dropout_p, is_causal, scale * c)
+//!
+//! where a missing scale is the default 1/sqrt(E). This removes the pointwise
+//! kernel scaling the query and its round trip through global memory. The
+//! query or key must not be used by anything else, e.g. SdpaBwdOp, which
+//! would otherwise need a rescaled gradient.
+class FoldSdpaScalePass : public OptimizationPass<FoldSdpaScalePass> {
+  friend class OptimizationPass<FoldSdpaScalePass>;
+
+ protected:
+  static void runPass(Fusion* fusion);
+  static std::string name() {
+    return "FoldSdpaScalePass";
+  }
+};
+
+} // namespace nvfuser::preseg_passes
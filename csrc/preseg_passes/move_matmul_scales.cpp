@@ -0,0 +1,170 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <preseg_passes/move_matmul_scales.h>
+
+#include <fusion.h>
+#include <ir/interface_nodes.h>
+#include <ir/internal_nodes.h>
+#include <ir/utils.h>
+#include <ops/alias.h>
+#include <ops/arith.h>
+#include <ops/composite.h>
+
+#include <optional>
+#include <vector>
+
+namespace nvfuser::preseg_passes {
+
+namespace {
+
+// A matmul operand of the form [castOp(dtype,)] mul(x, scale), where x is an
+// FP8 or int8 tensor, possibly upcast, and scale is constant along K
+struct ScaledOperand {
+  // The quantized tensor before any upcast
+  TensorView* quantized = nullptr;
+  Val* scale = nullptr;
+};
+
+// Every value of these dtypes is exact in Half and BFloat16. Unpacked int4
+// weights are also Int8.
+bool isQuantized(DataType dtype) {
+  return dtype == DataType::Float8_e4m3fn || dtype == DataType::Float8_e5m2 ||
+      dtype == DataType::Int8;
+}
+
+// Strips casts, e.g. upcasts to Float
+TensorView* stripUpcast(TensorView* tv) {
+  while (auto* uop = dynamic_cast<UnaryOp*>(tv->definition())) {
+    if (uop->getUnaryOpType() != UnaryOpType::Cast ||
+        !uop->in()->isA<TensorView>()) {
+      break;
+    }
+    tv = uop->in()->as<TensorView>();
+  }
+  return tv;
+}
+
+bool isConstantAlongK(Val* scale, int64_t k_pos) {
+  auto* scale_tv = dynamic_cast<TensorView*>(scale);
+  if (scale_tv == nullptr) {
+    return scale->isScalar();
+  }
+  std::vector<IterDomain*> logical =
+      TensorDomain::noReductions(scale_tv->getLogicalDomain());
+  if ((int64_t)logical.size() != 2) {
+    return false;
+  }
+  IterDomain* k_id = logical.at(k_pos);
+  return k_id->isBroadcast() && !k_id->hasExpandedExtent();
+}
+
+std::optional<ScaledOperand> getScaledOperand(
+    TensorView* operand,
+    int64_t k_pos) {
+  if (operand->nDims() != 2 || operand->uses().size() != 1 ||
+      operand->isFusionOutput()) {
+    return std::nullopt;
+  }
+
+  TensorView* scaled = operand;
+  if (auto* uop = dynamic_cast<UnaryOp*>(operand->definition());
+      uop != nullptr && uop->getUnaryOpType() == UnaryOpType::Cast &&
+      uop->in()->isA<TensorView>()) {
+    scaled = uop->in()->as<TensorView>();
+    if (scaled->uses().size() != 1 || scaled->isFusionOutput()) {
+      return std::nullopt;
+    }
+  }
+
+  auto* bop = dynamic_cast<BinaryOp*>(scaled->definition());
+  if (bop == nullptr || bop->getBinaryOpType() != BinaryOpType::Mul) {
+    return std::nullopt;
+  }
+
+  for (auto [x, scale] :
+       {std::make_pair(bop->lhs(), bop->rhs()),
+        std::make_pair(bop->rhs(), bop->lhs())}) {
+    auto* x_tv = dynamic_cast<TensorView*>(x);
+    if (x_tv == nullptr ||
+        TensorDomain::noReductions(x_tv->getLogicalDomain()).size() != 2 ||
+        !isConstantAlongK(scale, k_pos)) {
+      continue;
+    }
+    TensorView* quantized = stripUpcast(x_tv);
+    if (!isQuantized(quantized->dtype())) {
+      continue;
+    }
+    return ScaledOperand{quantized, scale};
+  }
+  return std::nullopt;
+}
+
+void moveScales(Expr* mm) {
+  const bool is_linear = mm->isA<LinearOp>();
+  auto* a = mm->input(0)->as<TensorView>();
+  auto* b = mm->input(1)->as<TensorView>();
+  auto* out = mm->output(0)->as<TensorView>();
+
+  // A is [M, K]. B is [K, N] for MatmulOp and [N, K] for LinearOp
+  std::optional<ScaledOperand> scaled_a = getScaledOperand(a, 1);
+  std::optional<ScaledOperand> scaled_b =
+      getScaledOperand(b, is_linear ? 1 : 0);
+  if (!scaled_a.has_value() && !scaled_b.has_value()) {
+    return;
+  }
+
+  auto unscaled = [](TensorView* operand,
+                     const std::optional<ScaledOperand>& scaled) {
+    if (!scaled.has_value()) {
+      return operand;
+    }
+    // Upcasting FP8 or int8 to a half precision dtype is exact
+    return castOp(operand->dtype(), scaled->quantized);
+  };
+  TensorView* new_a = unscaled(a, scaled_a);
+  TensorView* new_b = unscaled(b, scaled_b);
+
+  TensorView* new_out =
+      is_linear ? linear(new_a, new_b) : matmul(new_a, new_b);
+  TensorView* result = castOp(DataType::Float, new_out);
+  if (scaled_a.has_value()) {
+    // [M, 1] broadcasts along N in the output
+    result = mul(result, scaled_a->scale)->as<TensorView>();
+  }
+  if (scaled_b.has_value()) {
+    Val* scale = scaled_b->scale;
+    if (is_linear && scale->isA<TensorView>()) {
+      // [N, 1] -> [1, N]
+      scale = broadcast(squeeze(scale->as<TensorView>(), {1}), {true, false});
+    }
+    result = mul(result, scale)->as<TensorView>();
+  }
+  result = castOp(out->dtype(), result);
+
+  ir_utils::replaceValInAllExprInputsAndFusionOutputs(out, result);
+}
+
+} // namespace
+
+void MoveMatmulScalesPass::runPass(Fusion* fusion) {
+  std::vector<Expr*> matmuls;
+  for (Expr* expr : fusion->exprs()) {
+    if (expr->isA<MatmulOp>()) {
+      matmuls.push_back(expr);
+    } else if (auto* lop = dynamic_cast<LinearOp*>(expr);
+               lop != nullptr && !lop->has_bias()) {
+      matmuls.push_back(expr);
+    }
+  }
+
+  for (Expr* mm : matmuls) {
+    moveScales(mm);
+  }
+}
+
+} // namespace nvfuser::preseg_passes
@@ -0,0 +1,45 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <preseg_passes/optimization_pass.h>
+
+namespace nvfuser::preseg_passes {
+
+//! MoveMatmulScalesPass moves the dequantization scales of FP8 and int8
+//! matmul operands past the matmul, so the scaled half-precision operands are
+//! never materialized. For example,
+//!
+//!   a = castOp(BFloat16, mul(castOp(Float, a_fp8), a_scale)) // [M, K]
+//!   b = castOp(BFloat16, mul(castOp(Float, b_fp8), b_scale)) // [N, K]
+//!   c = linear(a, b)
+//!
+//! becomes
+//!
+//!   c = castOp(BFloat16,
+//!       mul(mul(castOp(Float,
+//!           linear(castOp(BFloat16, a_fp8), castOp(BFloat16, b_fp8))),
+//!           a_scale), broadcast(squeeze(b_scale))))
+//!
+//! This is only valid when the scales are constant along K, i.e. they are
+//! scalars or per-row/per-column tensors whose K dimension is a broadcast.
+//! Scales blocked along K, e.g. the grouped scales of dequantize(), would
+//! have to be applied to partial accumulators in the main loop and are left
+//! in place. Weight-only int8 and unpacked int4 operands are Int8 tensors, so
+//! a per-channel W8A16 or W4A16 matmul is handled the same way.
+class MoveMatmulScalesPass : public OptimizationPass<MoveMatmulScalesPass> {
+  friend class OptimizationPass<MoveMatmulScalesPass>;
+
+ protected:
+  static void runPass(Fusion* fusion);
+  static std::string name() {
+    return "MoveMatmulScalesPass";
+  }
+};
+
+} // namespace nvfuser::preseg_passes
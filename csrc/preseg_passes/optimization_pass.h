@@ -54,6 +54,7 @@ class OptimizationPass {
     }
 
     FUSER_PERF_SCOPE(DerivedClass::name().c_str());
+    FUSER_COMPILE_PHASE_SCOPE("Preseg " + DerivedClass::name());
     DerivedClass::runPass(fusion);
 
     // TODO: skip the logging of the pass where the fusion has not been changed.
@@ -14,17 +14,24 @@
 #include <preseg_passes/add_axioms.h>
 #include <preseg_passes/allocation_order_inference.h>
 #include <preseg_passes/consecutive_cast.h>
+#include <preseg_passes/cse.h>
+#include <preseg_passes/donate_inputs.h>
 #include <preseg_passes/exact_mapped_extent_substitution.h>
+#include <preseg_passes/fold_log_softmax_gather.h>
+#include <preseg_passes/fold_sdpa_scale.h>
 #include <preseg_passes/insert_reshardings.h>
 #include <preseg_passes/make_resharding_contiguous.h>
 #include <preseg_passes/mark_aliases_prepare.h>
+#include <preseg_passes/move_matmul_scales.h>
 #include <preseg_passes/move_pad.h>
 #include <preseg_passes/move_split_cat.h>
 #include <preseg_passes/propagate_shardings.h>
 #include <preseg_passes/remove_bcast_squeeze.h>
 #include <preseg_passes/remove_empty.h>
 #include <preseg_passes/reorder_sharded_axis.h>
+#include <preseg_passes/rewrite_reductions.h>
 #include <preseg_passes/segment_inplace_update.h>
+#include <preseg_passes/split_full_reduction.h>
 #include <preseg_passes/translate_repeat_to_expand.h>
 
 namespace nvfuser::preseg_passes {
@@ -51,6 +58,21 @@ namespace nvfuser::preseg_passes {
   OptimizationPass<TranslateRepeatToExpand>::runPass(fusion);
   // removes consecutive cast operations
   OptimizationPass<ConsecutiveCastPass>::runPass(fusion);
+  // Merges duplicated expressions, e.g., from tracing. Placed after
+  // ConsecutiveCastPass so that cast chains are simplified before they are
+  // compared.
+  OptimizationPass<CsePass>::runPass(fusion);
+  // Applies K-invariant FP8 operand scales in the matmul epilogue. Placed
+  // after ConsecutiveCastPass so the upcast chains it matches are simplified.
+  OptimizationPass<MoveMatmulScalesPass>::runPass(fusion);
+  OptimizationPass<FoldSdpaScalePass>::runPass(fusion);
+  // Also placed after ConsecutiveCastPass, which simplifies the casts of
+  // the logits this pass looks through
+  OptimizationPass<FoldLogSoftmaxGatherPass>::runPass(fusion);
+  // Placed before SplitFullReductionPass, which splits the reductions this
+  // pass merges
+  OptimizationPass<RewriteReductionsPass>::runPass(fusion);
+  OptimizationPass<SplitFullReductionPass>::runPass(fusion);
   OptimizationPass<AddAxiomsPass>::runPass(fusion);
   OptimizationPass<MoveSplitCatPass>::runPass(fusion);
   // MovePadPass needs to happen:
@@ -82,6 +104,8 @@ namespace nvfuser::preseg_passes {
   OptimizationPass<AllocationDomainPass>::runPass(fusion);
   OptimizationPass<RemoveBcastSqueeze>::runPass(fusion);
   OptimizationPass<SegmentInplaceUpdatePass>::runPass(fusion);
+  // Must run after SegmentInplaceUpdatePass. See InputDonationPass.
+  OptimizationPass<InputDonationPass>::runPass(fusion);
 }
 
 } // namespace nvfuser::preseg_passes
@@ -7,12 +7,17 @@
 // clang-format on
 #include <preseg_passes/propagate_shardings.h>
 
+#include <limits>
+#include <map>
+#include <unordered_map>
 #include <vector>
 
 #include <ir/interface_nodes.h>
 #include <ir/iostream.h>
 #include <ir/utils.h>
+#include <logical_domain_map.h>
 #include <multidevice/utils.h>
+#include <options.h>
 
 namespace nvfuser::preseg_passes {
 
@@ -46,16 +51,321 @@ void validateMeshes(Fusion* fusion) {
       tv_without_mesh,
       " not.");
 }
-} // namespace
 
-void PropagateShardingsPass::runPass(Fusion* fusion) {
-  auto num_device_parallel_dimensions = [](const TensorView* tv) -> int64_t {
-    return std::count_if(
-        tv->getLoopDomain().begin(),
-        tv->getLoopDomain().end(),
-        std::mem_fn(&IterDomain::isDeviceDim));
-  };
+int64_t numDeviceParallelDimensions(const TensorView* tv) {
+  return std::count_if(
+      tv->getLoopDomain().begin(),
+      tv->getLoopDomain().end(),
+      std::mem_fn(&IterDomain::isDeviceDim));
+}
+
+// Extents only known at runtime are assumed to be this large when estimating
+// communication volumes
+constexpr int64_t kUnknownExtent = 1024;
+
+// The cost model falls back to the local rules when more sharding assignments
+// than this would have to be evaluated
+constexpr int64_t kMaxShardingAssignments = 4096;
+
+// The sharding of a TensorView as seen by the cost model
+struct ShardingState {
+  const DeviceMesh* mesh = nullptr;
+  // Logical or root IterDomain sharded on DIDx, if any
+  IterDomain* sharded_id = nullptr;
+  int64_t num_dids = 0;
+};
+
+// A way to shard the outputs of an Expr that have no mesh: like the reference
+// input or, if `replicated`, on the mesh of the reference input only
+struct ShardingCandidate {
+  TensorView* ref = nullptr;
+  bool replicated = false;
+};
+
+ShardingState getShardingState(TensorView* tv) {
+  ShardingState state;
+  state.mesh = &tv->getDeviceMesh();
+  state.num_dids = numDeviceParallelDimensions(tv);
+  const int64_t axis = getShardedLogicalAxis(tv, ParallelType::DIDx);
+  if (axis != -1) {
+    state.sharded_id =
+        TensorDomain::noReductions(tv->getLogicalDomain()).at(axis);
+  }
+  return state;
+}
+
+double estimateBytes(TensorView* tv) {
+  double num_elements = 1;
+  for (IterDomain* id : TensorDomain::noReductions(tv->getLogicalDomain())) {
+    if (id->isBroadcast()) {
+      continue;
+    }
+    num_elements *= id->extent()->isConstInt()
+        ? static_cast<double>(id->extent()->evaluate().as<int64_t>())
+        : static_cast<double>(kUnknownExtent);
+  }
+  return num_elements *
+      static_cast<double>(dataTypeSize(tv->dtype(), DataType::Int));
+}
+
+// Chooses the shardings of the TensorViews without a mesh by minimizing the
+// total estimated resharding volume of the fusion. Each Expr with such outputs
+// can shard them like any of its inputs, or replicate them. The assignments
+// are enumerated depth-first in topological order with branch-and-bound,
+// starting from the choices of the local rules, which are kept on ties.
+// Outputs of the fusion always follow the local rules so that the shapes
+// returned to the user don't change.
+class ShardingCostModel {
+ public:
+  explicit ShardingCostModel(Fusion* fusion) : exprs_(fusion->exprs()) {
+    for (TensorView* tv : fusion->allTvs()) {
+      if (tv->hasDeviceMesh()) {
+        states_[tv] = getShardingState(tv);
+      }
+    }
+    choices_.resize(exprs_.size());
+  }
+
+  // Returns false, leaving the fusion untouched, if the search space is too
+  // large.
+  bool run() {
+    if (!searchSpaceIsSmallEnough()) {
+      return false;
+    }
+    search(0, 0.0);
+    apply();
+    return true;
+  }
+
+ private:
+  std::vector<TensorView*> outputsWithoutMesh(Expr* expr) const {
+    std::vector<TensorView*> outputs;
+    for (auto* tv : ir_utils::filterByType<TensorView>(expr->outputs())) {
+      if (!tv->hasDeviceMesh()) {
+        outputs.push_back(tv);
+      }
+    }
+    return outputs;
+  }
+
+  // The first candidate is the choice of the local rules
+  std::vector<ShardingCandidate> getCandidates(Expr* expr) const {
+    std::vector<TensorView*> outputs = outputsWithoutMesh(expr);
+    if (outputs.empty()) {
+      return {};
+    }
+    TensorView* rule_ref = nullptr;
+    std::vector<TensorView*> inputs_with_mesh;
+    for (auto* input : ir_utils::filterByType<TensorView>(expr->inputs())) {
+      auto it = states_.find(input);
+      if (it == states_.end() ||
+          std::find(inputs_with_mesh.begin(), inputs_with_mesh.end(), input) !=
+              inputs_with_mesh.end()) {
+        continue;
+      }
+      if (rule_ref == nullptr ||
+          it->second.num_dids > states_.at(rule_ref).num_dids) {
+        rule_ref = input;
+      }
+      inputs_with_mesh.push_back(input);
+    }
+    if (rule_ref == nullptr) {
+      return {};
+    }
+
+    std::vector<ShardingCandidate> candidates = {{rule_ref}};
+    if (std::any_of(outputs.begin(), outputs.end(), [](TensorView* tv) {
+          return tv->isFusionOutput();
+        })) {
+      return candidates;
+    }
+    for (TensorView* input : inputs_with_mesh) {
+      if (input != rule_ref) {
+        candidates.push_back({input});
+      }
+    }
+    if (states_.at(rule_ref).sharded_id != nullptr) {
+      candidates.push_back({rule_ref, /*replicated=*/true});
+    }
+    return candidates;
+  }
+
+  ShardingState getCandidateState(
+      const ShardingCandidate& candidate,
+      TensorView* tv) {
+    const ShardingState& ref_state = states_.at(candidate.ref);
+    ShardingState state;
+    state.mesh = ref_state.mesh;
+    if (candidate.replicated || ref_state.sharded_id == nullptr) {
+      return state;
+    }
+    IterDomain* id = getOrDefault(
+        getProducerToConsumerMap(candidate.ref, tv), ref_state.sharded_id);
+    // Like shardAllLike, reduction dimensions are not sharded
+    if (id != nullptr && !id->isReduction()) {
+      state.sharded_id = id;
+      state.num_dids = 1;
+    }
+    return state;
+  }
+
+  const std::unordered_map<IterDomain*, IterDomain*>& getProducerToConsumerMap(
+      TensorView* producer,
+      TensorView* consumer) {
+    auto [it, inserted] = p2c_maps_.try_emplace({producer, consumer});
+    if (inserted) {
+      it->second = PairwiseLogicalDomainMap(producer, consumer)
+                       .mapProducerToConsumer();
+    }
+    return it->second;
+  }
+
+  // Bytes communicated by the resharding between producer and consumer,
+  // weighted by the type of collective and the size of the mesh
+  double estimateReshardingCost(TensorView* producer, TensorView* consumer) {
+    const ShardingState& p_state = states_.at(producer);
+    const ShardingState& c_state = states_.at(consumer);
+    const double bytes = estimateBytes(producer);
+    if (*p_state.mesh != *c_state.mesh) {
+      // Send/recv or broadcast between meshes
+      return bytes;
+    }
+    const auto num_devices = static_cast<double>(p_state.mesh->size());
+    if (num_devices <= 1) {
+      return 0.0;
+    }
+
+    // Like haveDifferentShardings, only look at mapped IterDomains
+    const std::unordered_map<IterDomain*, IterDomain*>& p2c =
+        getProducerToConsumerMap(producer, consumer);
+    IterDomain* p_sharded_id = p_state.sharded_id == nullptr
+        ? nullptr
+        : getOrDefault(p2c, p_state.sharded_id);
+    IterDomain* c_sharded_id = c_state.sharded_id;
+    if (c_sharded_id != nullptr &&
+        std::none_of(p2c.begin(), p2c.end(), [&](const auto& p_and_c) {
+          return p_and_c.second == c_sharded_id;
+        })) {
+      c_sharded_id = nullptr;
+    }
+    if (p_sharded_id == c_sharded_id) {
+      return 0.0;
+    }
+
+    const double fraction = (num_devices - 1) / num_devices;
+    if (p_sharded_id != nullptr && p_sharded_id->isReduction()) {
+      // An allreduce moves twice as much data as a reduce-scatter
+      return bytes * fraction * (c_sharded_id == nullptr ? 2.0 : 1.0);
+    }
+    // Allgather, scatter or all-to-all
+    return bytes * fraction;
+  }
+
+  double estimateReshardingCost(Expr* expr) {
+    if (!ir_utils::isTvOp(expr)) {
+      return 0.0;
+    }
+    double cost = 0.0;
+    for (auto* input : ir_utils::filterByType<TensorView>(expr->inputs())) {
+      for (auto* output : ir_utils::filterByType<TensorView>(expr->outputs())) {
+        if (input->isCpuScalar() || output->isCpuScalar() ||
+            !states_.count(input) || !states_.count(output)) {
+          continue;
+        }
+        cost += estimateReshardingCost(input, output);
+      }
+    }
+    return cost;
+  }
+
+  // Counts the assignments along the choices of the local rules. The number
+  // of candidates of an Expr only depends on which of its inputs have a mesh,
+  // which doesn't depend on the choices.
+  bool searchSpaceIsSmallEnough() {
+    int64_t num_assignments = 1;
+    std::vector<TensorView*> assigned;
+    for (Expr* expr : exprs_) {
+      std::vector<ShardingCandidate> candidates = getCandidates(expr);
+      if (candidates.empty()) {
+        continue;
+      }
+      num_assignments *= static_cast<int64_t>(candidates.size());
+      if (num_assignments > kMaxShardingAssignments) {
+        break;
+      }
+      for (TensorView* tv : outputsWithoutMesh(expr)) {
+        states_[tv] = getCandidateState(candidates.front(), tv);
+        assigned.push_back(tv);
+      }
+    }
+    for (TensorView* tv : assigned) {
+      states_.erase(tv);
+    }
+    return num_assignments <= kMaxShardingAssignments;
+  }
 
+  void search(size_t expr_index, double cost) {
+    if (cost >= best_cost_) {
+      return;
+    }
+    if (expr_index == exprs_.size()) {
+      best_cost_ = cost;
+      best_choices_ = choices_;
+      return;
+    }
+
+    Expr* expr = exprs_.at(expr_index);
+    std::vector<ShardingCandidate> candidates = getCandidates(expr);
+    if (candidates.empty()) {
+      search(expr_index + 1, cost + estimateReshardingCost(expr));
+      return;
+    }
+    std::vector<TensorView*> outputs = outputsWithoutMesh(expr);
+    for (const ShardingCandidate& candidate : candidates) {
+      for (TensorView* tv : outputs) {
+        states_[tv] = getCandidateState(candidate, tv);
+      }
+      choices_.at(expr_index) = candidate;
+      search(expr_index + 1, cost + estimateReshardingCost(expr));
+    }
+    for (TensorView* tv : outputs) {
+      states_.erase(tv);
+    }
+  }
+
+  void apply() const {
+    for (size_t i = 0; i < exprs_.size(); i++) {
+      const ShardingCandidate& choice = best_choices_.at(i);
+      if (choice.ref == nullptr) {
+        continue;
+      }
+      std::vector<TensorView*> outputs = outputsWithoutMesh(exprs_.at(i));
+      if (choice.replicated) {
+        for (TensorView* tv : outputs) {
+          tv->setDeviceMesh(choice.ref->getDeviceMesh());
+        }
+      } else {
+        shardAllLike(choice.ref, outputs);
+      }
+    }
+  }
+
+  const std::vector<Expr*> exprs_;
+  std::unordered_map<TensorView*, ShardingState> states_;
+  std::map<
+      std::pair<TensorView*, TensorView*>,
+      std::unordered_map<IterDomain*, IterDomain*>>
+      p2c_maps_;
+  // The candidate chosen for each Expr, or a null reference if the Expr has
+  // no output to shard
+  std::vector<ShardingCandidate> choices_;
+  std::vector<ShardingCandidate> best_choices_;
+  double best_cost_ = std::numeric_limits<double>::infinity();
+};
+
+// Shards the outputs without a mesh of each Expr like its "most parallel"
+// input
+void propagateShardingsWithLocalRules(Fusion* fusion) {
   const std::vector<Expr*>& exprs = fusion->exprs();
   for (Expr* expr : exprs) {
     const auto& inputs = ir_utils::filterByType<TensorView>(expr->inputs());
@@ -76,7 +386,7 @@ void PropagateShardingsPass::runPass(Fusion* fusion) {
       if (!input->hasDeviceMesh()) {
         continue;
       }
-      int64_t num_dids = num_device_parallel_dimensions(input);
+      int64_t num_dids = numDeviceParallelDimensions(input);
       if (num_dids > max_num_dids) {
         max_num_dids = num_dids;
         ref_input = input;
@@ -97,7 +407,17 @@ void PropagateShardingsPass::runPass(Fusion* fusion) {
     }
     shardAllLike(ref_input, outputs_without_mesh);
   }
+}
 
+} // namespace
+
+void PropagateShardingsPass::runPass(Fusion* fusion) {
+  if (!isOptionEnabled(EnableOption::CostBasedSharding) ||
+      !ShardingCostModel(fusion).run()) {
+    propagateShardingsWithLocalRules(fusion);
+  }
+
+  const std::vector<Expr*>& exprs = fusion->exprs();
   // Back-propagate device meshes. This makes sure all TensorViews have a mesh
   // if any of them has one. This is needed in addition to the forward
   // propagation for ops that don't take any TensorView operands, e.g.,
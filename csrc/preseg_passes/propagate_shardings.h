@@ -17,6 +17,11 @@ namespace nvfuser::preseg_passes {
 // is inserted into the fusion, because the multidevice shcheduling hasn't been
 // applied.
 //
+// With EnableOption::CostBasedSharding, the shardings of intermediate tvs are
+// instead chosen to minimize the estimated resharding volume of the whole
+// fusion. This falls back to the simple rule when the search space is too
+// large.
+//
 // TODO: Re-implement a robust and smatert sharding propagation pass.
 class PropagateShardingsPass : public OptimizationPass<PropagateShardingsPass> {
   friend class OptimizationPass<PropagateShardingsPass>;
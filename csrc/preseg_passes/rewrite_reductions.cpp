@@ -0,0 +1,266 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <preseg_passes/rewrite_reductions.h>
+
+#include <fusion.h>
+#include <ir/interface_nodes.h>
+#include <ir/internal_nodes.h>
+#include <ir/utils.h>
+#include <ops/arith.h>
+
+#include <vector>
+
+namespace nvfuser::preseg_passes {
+
+namespace {
+
+bool isFloatingTensor(Val* val) {
+  return val->isA<TensorView>() && isFloatingPointType(val->dtype());
+}
+
+bool isScalar(Val* val) {
+  return !val->isA<TensorView>() && val->isScalar();
+}
+
+// Whether tv can be replaced with a new tensor
+bool isReplaceable(TensorView* tv) {
+  return !tv->hasDeviceMesh() &&
+      (!tv->isFusionOutput() ||
+       tv->fusion()->getOutputAlias(tv).type == AllocationType::New);
+}
+
+// Whether tv is only used by a single expression, which is being rewritten
+bool isSingleUse(TensorView* tv) {
+  return !tv->isFusionOutput() && tv->uses().size() == 1;
+}
+
+// Returns the ReductionOp defining val if it is a plain sum
+ReductionOp* getSum(Val* val) {
+  auto* rop = dynamic_cast<ReductionOp*>(val->definition());
+  if (rop == nullptr || rop->getReductionOpType() != BinaryOpType::Add ||
+      !rop->init()->isZero()) {
+    return nullptr;
+  }
+  return rop;
+}
+
+std::vector<int64_t> getReductionAxes(TensorView* tv) {
+  std::vector<int64_t> axes;
+  const std::vector<IterDomain*>& logical = tv->getLogicalDomain();
+  for (const auto i : c10::irange(logical.size())) {
+    if (logical[i]->isReduction()) {
+      axes.push_back((int64_t)i);
+    }
+  }
+  return axes;
+}
+
+// Whether tv is the result of a reduction, possibly with kept dimensions
+bool isReductionResult(TensorView* tv) {
+  Expr* def = tv->definition();
+  if (def != nullptr && def->isA<BroadcastOp>()) {
+    def = def->input(0)->definition();
+  }
+  return def != nullptr && def->isOneOf<ReductionOp, WelfordOp>();
+}
+
+// Returns the 0-dim tensor that is c or that c is a broadcast of, or nullptr
+TensorView* getZeroDimFactor(Val* c) {
+  auto* tv = dynamic_cast<TensorView*>(c);
+  if (tv == nullptr) {
+    return nullptr;
+  }
+  if (tv->nDims() == 0) {
+    return tv;
+  }
+  auto* bcast = dynamic_cast<BroadcastOp*>(tv->definition());
+  if (bcast == nullptr || bcast->in()->as<TensorView>()->nDims() != 0) {
+    return nullptr;
+  }
+  auto* in = bcast->in()->as<TensorView>();
+  return in->dtype() == tv->dtype() ? in : nullptr;
+}
+
+// sum(a) + sum(b) -> sum(a + b), and likewise for subtraction
+bool mergeSiblingSums(BinaryOp* bop) {
+  if (bop->getBinaryOpType() != BinaryOpType::Add &&
+      bop->getBinaryOpType() != BinaryOpType::Sub) {
+    return false;
+  }
+  auto* out = bop->out()->as<TensorView>();
+  if (!isFloatingTensor(out) || !isReplaceable(out) ||
+      !isFloatingTensor(bop->lhs()) || !isFloatingTensor(bop->rhs()) ||
+      bop->lhs() == bop->rhs()) {
+    return false;
+  }
+  auto* lhs = bop->lhs()->as<TensorView>();
+  auto* rhs = bop->rhs()->as<TensorView>();
+  ReductionOp* lhs_sum = getSum(lhs);
+  ReductionOp* rhs_sum = getSum(rhs);
+  if (lhs_sum == nullptr || rhs_sum == nullptr || !isSingleUse(lhs) ||
+      !isSingleUse(rhs)) {
+    return false;
+  }
+  auto* a = lhs_sum->in()->as<TensorView>();
+  auto* b = rhs_sum->in()->as<TensorView>();
+  if (a->dtype() != out->dtype() || b->dtype() != out->dtype() ||
+      lhs->dtype() != out->dtype() || rhs->dtype() != out->dtype()) {
+    return false;
+  }
+
+  // The reduced axes must be of the same extents. Other axes are combined by
+  // the addition as before.
+  const std::vector<IterDomain*>& lhs_logical = lhs->getLogicalDomain();
+  const std::vector<IterDomain*>& rhs_logical = rhs->getLogicalDomain();
+  if (lhs_logical.size() != rhs_logical.size()) {
+    return false;
+  }
+  for (const auto i : c10::irange(lhs_logical.size())) {
+    IterDomain* lhs_id = lhs_logical[i];
+    IterDomain* rhs_id = rhs_logical[i];
+    if (lhs_id->getIterType() != rhs_id->getIterType() ||
+        (lhs_id->isReduction() &&
+         !lhs_id->extent()->sameAs(rhs_id->extent()))) {
+      return false;
+    }
+  }
+
+  TensorView* combined =
+      bop->getBinaryOpType() == BinaryOpType::Add ? add(a, b) : sub(a, b);
+  TensorView* new_out = sum(combined, getReductionAxes(lhs));
+  if (new_out->dtype() != out->dtype()) {
+    return false;
+  }
+  ir_utils::replaceValInAllExprInputsAndFusionOutputs(out, new_out);
+  return true;
+}
+
+// sum(x * c) -> sum(x) * c, and likewise for division by c
+bool hoistScalarFactor(ReductionOp* rop) {
+  if (getSum(rop->out()) == nullptr) {
+    return false;
+  }
+  auto* out = rop->out()->as<TensorView>();
+  auto* in = rop->in()->as<TensorView>();
+  auto* bop = dynamic_cast<BinaryOp*>(in->definition());
+  if (!isFloatingTensor(out) || !isReplaceable(out) || !isSingleUse(in) ||
+      bop == nullptr || in->dtype() != out->dtype()) {
+    return false;
+  }
+
+  auto as_factor = [](Val* c) -> Val* {
+    if (isScalar(c)) {
+      return c;
+    }
+    return getZeroDimFactor(c);
+  };
+  TensorView* x = nullptr;
+  Val* c = nullptr;
+  if (bop->getBinaryOpType() == BinaryOpType::Mul) {
+    if ((c = as_factor(bop->rhs())) != nullptr) {
+      x = dynamic_cast<TensorView*>(bop->lhs());
+    } else if ((c = as_factor(bop->lhs())) != nullptr) {
+      x = dynamic_cast<TensorView*>(bop->rhs());
+    }
+  } else if (bop->getBinaryOpType() == BinaryOpType::Div) {
+    if ((c = as_factor(bop->rhs())) != nullptr) {
+      x = dynamic_cast<TensorView*>(bop->lhs());
+    }
+  }
+  if (x == nullptr || x->nDims() != in->nDims() || x->dtype() != in->dtype()) {
+    return false;
+  }
+
+  TensorView* reduced = sum(x, getReductionAxes(out));
+  TensorView* new_out = bop->getBinaryOpType() == BinaryOpType::Mul
+      ? mul(reduced, c)
+      : div(reduced, c);
+  if (new_out->dtype() != out->dtype()) {
+    return false;
+  }
+  ir_utils::replaceValInAllExprInputsAndFusionOutputs(out, new_out);
+  return true;
+}
+
+// (r op1 s1) op2 s2 -> r op s, where op1 and op2 are multiplications or
+// divisions by scalars and r is the result of a reduction
+bool foldScalarFactors(BinaryOp* bop) {
+  auto is_scaling = [](BinaryOp* op) {
+    return op != nullptr &&
+        (op->getBinaryOpType() == BinaryOpType::Mul ||
+         op->getBinaryOpType() == BinaryOpType::Div) &&
+        isFloatingTensor(op->lhs()) && isScalar(op->rhs());
+  };
+  if (!is_scaling(bop)) {
+    return false;
+  }
+  auto* out = bop->out()->as<TensorView>();
+  auto* t = bop->lhs()->as<TensorView>();
+  auto* inner = dynamic_cast<BinaryOp*>(t->definition());
+  if (!is_scaling(inner) || !isReplaceable(out) || !isSingleUse(t)) {
+    return false;
+  }
+  auto* r = inner->lhs()->as<TensorView>();
+  if (!isReductionResult(r) || r->dtype() != out->dtype() ||
+      t->dtype() != out->dtype()) {
+    return false;
+  }
+
+  // Integer scalars, e.g., the number of reduced elements, are not divided
+  // with integer division
+  auto to_floating = [](Val* s) {
+    return isFloatingPointType(s->dtype()) ? s : castOp(DataType::Double, s);
+  };
+  Val* s1 = to_floating(inner->rhs());
+  Val* s2 = to_floating(bop->rhs());
+  const bool inner_mul = inner->getBinaryOpType() == BinaryOpType::Mul;
+  const bool outer_mul = bop->getBinaryOpType() == BinaryOpType::Mul;
+  TensorView* new_out = nullptr;
+  if (inner_mul && outer_mul) {
+    new_out = mul(r, mul(s1, s2));
+  } else if (inner_mul) {
+    new_out = mul(r, div(s1, s2));
+  } else if (outer_mul) {
+    new_out = mul(r, div(s2, s1));
+  } else {
+    new_out = div(r, mul(s1, s2));
+  }
+  if (new_out->dtype() != out->dtype()) {
+    return false;
+  }
+  ir_utils::replaceValInAllExprInputsAndFusionOutputs(out, new_out);
+  return true;
+}
+
+// Rewrites the first match, since rewriting invalidates the expressions that
+// use the rewritten tensors
+bool rewriteOnce(Fusion* fusion) {
+  for (Expr* expr : fusion->exprs()) {
+    if (auto* bop = dynamic_cast<BinaryOp*>(expr)) {
+      if (mergeSiblingSums(bop) || foldScalarFactors(bop)) {
+        return true;
+      }
+    } else if (auto* rop = dynamic_cast<ReductionOp*>(expr)) {
+      if (hoistScalarFactor(rop)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+void RewriteReductionsPass::runPass(Fusion* fusion) {
+  // Every rewrite removes a reduction or a scaling, or moves a scaling after
+  // a reduction, so this terminates
+  while (rewriteOnce(fusion)) {
+  }
+}
+
+} // namespace nvfuser::preseg_passes
@@ -0,0 +1,38 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <preseg_passes/optimization_pass.h>
+
+namespace nvfuser::preseg_passes {
+
+//! RewriteReductionsPass simplifies floating-point sums and the scalar
+//! factors applied around them, so that schedulers see fewer reductions and
+//! smaller persistent buffers:
+//!
+//!   sum(a) + sum(b)  ->  sum(a + b)     (also for -)
+//!   sum(x * c)       ->  sum(x) * c     (also for /)
+//!   (r / n) * c      ->  r * (c / n)    (any mix of * and /)
+//!
+//! where the sums reduce the same axes, c and n are scalars or, for the
+//! second rewrite, 0-dim or broadcast 0-dim tensors, and r is the result of
+//! a reduction, e.g., a mean followed by a rescale. The rewritten tensors
+//! must be of the same floating-point type and must not be used elsewhere.
+//! The rewrites reassociate floating-point math, so results may differ in
+//! rounding.
+class RewriteReductionsPass : public OptimizationPass<RewriteReductionsPass> {
+  friend class OptimizationPass<RewriteReductionsPass>;
+
+ protected:
+  static void runPass(Fusion* fusion);
+  static std::string name() {
+    return "RewriteReductionsPass";
+  }
+};
+
+} // namespace nvfuser::preseg_passes
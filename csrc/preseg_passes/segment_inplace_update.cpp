@@ -32,6 +32,10 @@ namespace nvfuser::preseg_passes {
 // that all write operations to the fusion inputs occur after the read
 // operations have completed. See Issue #2664: https://
 // github.com/NVIDIA/Fuser/issues/2664
+// 4. An output written in place of a slice of an input (see
+// Fusion::aliasOutputToInputSlice) races with any other read of the input,
+// e.g., an attention over the KV cache being appended to, so its update is
+// also forced into a separate copy kernel when the input has other uses.
 namespace {
 void insertSegmentSet(Fusion* fusion) {
   std::vector<TensorView*> aliased_tvs;
@@ -131,19 +135,27 @@ void insertSegmentSet(Fusion* fusion) {
 
   // For all aliased tensorviews:
   // 1) if that tv or the corresponding aliased input is a producer/consumer of
-  // a broadcast op, or 2) the aliased input has a concretized broadcast, insert
+  // a broadcast op, 2) the aliased input has a concretized broadcast, or 3)
+  // the output updates a slice of an aliased input that is read, insert
   // a (segment_set + set) to force the inplace update into a separate copy
   // kernel. NOTE: We cannot use a segment_set alone. Since, there will be no
   // data flow across this segment_set (the output of segment_set is an output
   // of given fusion with no uses), it will be merged with other segments.
   // https://github.com/NVIDIA/Fuser/blob/92b635125ae509cc6b2ccbe29e957586a9cbb059/csrc/fusion_segmenter.cpp#L2331-L2346
   for (auto aliased_tv : aliased_tvs) {
-    TensorView* aliased_input =
-        fusion->getOutputAlias(aliased_tv).aliased_io->as<TensorView>();
+    const AliasInfo& alias_info = fusion->getOutputAlias(aliased_tv);
+    TensorView* aliased_input = alias_info.aliased_io->as<TensorView>();
+    const bool reads_updated_slice =
+        alias_info.slice_offset != nullptr && !aliased_input->uses().empty();
     if (visited_tvs.count(aliased_tv) || visited_tvs.count(aliased_input) ||
-        hasConcretizedBroadcast(aliased_input)) {
+        hasConcretizedBroadcast(aliased_input) || reads_updated_slice) {
       TensorView* alias_seg = segment_set(aliased_tv);
       TensorView* alias_copy = set(alias_seg);
+      if (alias_info.slice_offset != nullptr) {
+        // The copy is the one written to the strided slice
+        alias_copy->setContiguity(aliased_tv->getContiguity());
+        aliased_tv->setContiguity(true);
+      }
       fusion->replaceOutput(aliased_tv, alias_copy);
     }
   }
@@ -0,0 +1,145 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <preseg_passes/split_full_reduction.h>
+
+#include <fusion.h>
+#include <id_model/id_model.h>
+#include <ir/interface_nodes.h>
+#include <ir/internal_nodes.h>
+#include <ir/utils.h>
+#include <iter_visitor.h>
+#include <ops/arith.h>
+#include <scheduler/utils.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace nvfuser::preseg_passes {
+
+namespace {
+
+bool isSplittable(ReductionOp* rop) {
+  switch (rop->getReductionOpType()) {
+    case BinaryOpType::Max:
+    case BinaryOpType::Min:
+    case BinaryOpType::Add:
+      return rop->in()->isA<TensorView>() && rop->out()->isA<TensorView>();
+    default:
+      return false;
+  }
+}
+
+// Returns the reduction axes of out that are exactly mapped to the reduction
+// axes of norm, or an empty vector unless all of them are mapped and out
+// reduces more axes than norm
+std::vector<int64_t> getNormalizedAxes(
+    TensorView* out,
+    TensorView* norm,
+    const ValGraph& exact_graph) {
+  std::vector<IterDomain*> norm_ids;
+  for (IterDomain* id : norm->getLogicalDomain()) {
+    if (id->isReduction()) {
+      norm_ids.push_back(id);
+    }
+  }
+
+  std::vector<int64_t> axes;
+  int64_t num_reductions = 0;
+  const auto& logical = out->getLogicalDomain();
+  for (auto i : c10::irange(logical.size())) {
+    if (!logical.at(i)->isReduction()) {
+      continue;
+    }
+    ++num_reductions;
+    if (std::any_of(norm_ids.begin(), norm_ids.end(), [&](IterDomain* id) {
+          return exact_graph.disjointValSets().strictAreMapped(
+              logical.at(i), id);
+        })) {
+      axes.push_back((int64_t)i);
+    }
+  }
+  if (axes.size() != norm_ids.size() ||
+      (int64_t)axes.size() >= num_reductions) {
+    return {};
+  }
+  return axes;
+}
+
+void splitReduction(ReductionOp* rop, const std::vector<int64_t>& inner_axes) {
+  auto* out = rop->out()->as<TensorView>();
+  const auto& logical = out->getLogicalDomain();
+
+  // The remaining reduction axes are renumbered after the inner axes are
+  // removed
+  std::vector<int64_t> outer_axes;
+  int64_t num_removed = 0;
+  for (auto i : c10::irange(logical.size())) {
+    if (std::find(inner_axes.begin(), inner_axes.end(), (int64_t)i) !=
+        inner_axes.end()) {
+      ++num_removed;
+    } else if (logical.at(i)->isReduction()) {
+      outer_axes.push_back((int64_t)i - num_removed);
+    }
+  }
+
+  TensorView* inner = reductionOp(
+      rop->getReductionOpType(),
+      inner_axes,
+      rop->init(),
+      rop->in()->as<TensorView>(),
+      /*keep_dim=*/false,
+      out->dtype());
+  TensorView* outer = reductionOp(
+      rop->getReductionOpType(),
+      outer_axes,
+      rop->init(),
+      inner,
+      /*keep_dim=*/false,
+      out->dtype());
+  ir_utils::replaceValInAllExprInputsAndFusionOutputs(out, outer);
+}
+
+} // namespace
+
+void SplitFullReductionPass::runPass(Fusion* fusion) {
+  std::vector<ReductionOp*> candidates;
+  for (Expr* expr : fusion->exprs()) {
+    if (auto* rop = dynamic_cast<ReductionOp*>(expr);
+        rop != nullptr && isSplittable(rop)) {
+      candidates.push_back(rop);
+    }
+  }
+  if (candidates.empty()) {
+    return;
+  }
+
+  const std::vector<TensorView*> reduction_tvs =
+      scheduler_utils::getReductionTvs(fusion);
+  IdModel id_model(fusion, /*build_graphs=*/false);
+  id_model.buildExactGraph();
+  const ValGraph& exact_graph = id_model.idGraph(IdMappingMode::EXACT);
+
+  for (ReductionOp* rop : candidates) {
+    auto* out = rop->out()->as<TensorView>();
+    for (TensorView* norm : reduction_tvs) {
+      if (norm == out ||
+          norm->getLogicalDomain().size() != out->getLogicalDomain().size() ||
+          !DependencyCheck::isDependencyOf(norm, rop->in())) {
+        continue;
+      }
+      std::vector<int64_t> inner_axes =
+          getNormalizedAxes(out, norm, exact_graph);
+      if (!inner_axes.empty()) {
+        splitReduction(rop, inner_axes);
+        break;
+      }
+    }
+  }
+}
+
+} // namespace nvfuser::preseg_passes
@@ -0,0 +1,41 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <preseg_passes/optimization_pass.h>
+
+namespace nvfuser::preseg_passes {
+
+//! SplitFullReductionPass splits a reduction of the output of a normalization
+//! so that it first reduces the normalized axes, as for the amax of an FP8
+//! quantization recipe:
+//!
+//!   y = rms_norm(x, {1})
+//!   amax = max(abs(y), {0, 1})
+//!
+//! becomes
+//!
+//!   amax = max(max(abs(y), {1}), {0})
+//!
+//! The original reduction does not have the reduction axes of the
+//! normalization, so the normalization schedulers reject it and y is written
+//! to and read back from global memory by a separate reduction kernel. After
+//! the split, the inner reduction is scheduled together with the
+//! normalization and only the per-row partial results are left for the
+//! remaining reduction. Only Max, Min and Add reductions are split.
+class SplitFullReductionPass : public OptimizationPass<SplitFullReductionPass> {
+  friend class OptimizationPass<SplitFullReductionPass>;
+
+ protected:
+  static void runPass(Fusion* fusion);
+  static std::string name() {
+    return "SplitFullReductionPass";
+  }
+};
+
+} // namespace nvfuser::preseg_passes
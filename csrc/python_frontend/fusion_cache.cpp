@@ -12,24 +12,29 @@
 #include <instrumentation.h>
 #include <options.h>
 #include <python_frontend/fusion_cache.h>
+#include <runtime/compile_thread_pool.h>
 #include <runtime/fusion_kernel_runtime.h>
 #include <serde/fusion_record.h>
 #include <utils.h>
 
+#include <array>
+#include <cstring>
 #include <filesystem>
+#include <unordered_set>
 namespace fs = std::filesystem;
 
 #ifdef _WIN32
 #include <c10/util/win32-headers.h>
 #else
+#include <fcntl.h>
 #include <pthread.h>
+#include <sys/mman.h>
 #include <unistd.h>
 #endif
 
 namespace nvfuser::python_frontend {
 
 namespace {
-using BinaryBuffer = std::vector<uint8_t>;
 
 // Generate temporary file for this FusionCacheBuffer
 std::string getSerdeTmpFile() {
@@ -79,39 +84,23 @@ fs::path getSerdeFilePath(const std::string& file_name) {
   return kernel_db_path / file_name;
 }
 
-BinaryBuffer openFusionCache(std::string filename) {
-  FUSER_PERF_SCOPE("Flatbuffers::openFusionCache");
-  auto file_handle = std::fopen(filename.c_str(), "rb");
-  NVF_CHECK(file_handle != nullptr, "Failed to open FusionCache buffer.");
-
-  auto file_path = fs::path(filename.c_str());
-  auto file_size = fs::file_size(file_path);
-  NVF_CHECK(file_size > 0, "FusionCache buffer is empty.");
-
-  BinaryBuffer buffer(file_size);
-  size_t read_status =
-      std::fread(buffer.data(), sizeof(uint8_t), file_size, file_handle);
-  NVF_CHECK(
-      read_status == file_size, "Failed to read entire FusionCache buffer.\n");
-  return buffer;
-}
-
 // This check function only throws errors if strict flag is enabled.
 const serde::FusionCache* verifyFusionCache(
-    const BinaryBuffer& buffer,
+    const uint8_t* data,
+    size_t size,
     std::optional<int64_t> device_id) {
   FUSER_PERF_SCOPE("Flatbuffers::verifyFusionCache");
-  auto fusion_cache_buffer = serde::GetFusionCache(buffer.data());
+  auto fusion_cache_buffer = serde::GetFusionCache(data);
 
   // Check flatbuffer integrity
-  flatbuffers::Verifier v(buffer.data(), buffer.size());
+  flatbuffers::Verifier v(data, size);
   NVF_CHECK(
       fusion_cache_buffer->Verify(v),
       "Failed to verify the integrity of FusionCache buffer.");
 
   // Check schema version
   NVF_CHECK(
-      serde::FusionCacheBufferHasIdentifier(buffer.data()),
+      serde::FusionCacheBufferHasIdentifier(data),
       "Failed to verify the schema version of the FusionCache buffer");
 
   // Check device major and minor versions
@@ -151,6 +140,84 @@ const serde::FusionCache* verifyFusionCache(
   return fusion_cache_buffer;
 }
 
+// A FusionCache journal starts with kJournalMagic, which is followed by
+// records. Each record is a little-endian uint64 size and a FusionCache
+// flatbuffer of that size, zero-padded to kJournalAlignment bytes.
+constexpr std::array<char, 8> kJournalMagic = {
+    'N', 'V', 'F', 'J', 'R', 'N', 'L', '1'};
+constexpr size_t kJournalAlignment = 8;
+
+bool isFusionCacheJournal(const uint8_t* data, size_t size) {
+  return size >= kJournalMagic.size() &&
+      std::memcmp(data, kJournalMagic.data(), kJournalMagic.size()) == 0;
+}
+
+// Verify each record in the journal. A truncated record at the end of the
+// journal is left by an interrupted write, so it is dropped with a warning.
+std::vector<const serde::FusionCache*> getJournalRecords(
+    const FusionCacheBuffer& buffer,
+    std::optional<int64_t> device_id) {
+  std::vector<const serde::FusionCache*> records;
+  size_t offset = kJournalMagic.size();
+  while (offset < buffer.size()) {
+    uint64_t record_size = 0;
+    if (buffer.size() - offset < sizeof(record_size)) {
+      TORCH_WARN("Dropping the truncated header of a FusionCache record.");
+      break;
+    }
+    std::memcpy(&record_size, buffer.data() + offset, sizeof(record_size));
+    offset += sizeof(record_size);
+    if (buffer.size() - offset < record_size) {
+      TORCH_WARN("Dropping a truncated FusionCache record.");
+      break;
+    }
+    records.push_back(
+        verifyFusionCache(buffer.data() + offset, record_size, device_id));
+    offset += (record_size + kJournalAlignment - 1) / kJournalAlignment *
+        kJournalAlignment;
+  }
+  return records;
+}
+
+void appendJournalRecord(
+    const std::string& filename,
+    const std::vector<uint8_t>& record) {
+  FUSER_PERF_SCOPE("FusionCache::appendJournalRecord");
+  const bool is_new_file =
+      !fs::exists(filename) || fs::file_size(filename) == 0;
+  auto file_handle = std::fopen(filename.c_str(), "ab");
+  NVF_CHECK(
+      file_handle != nullptr, "Failed to open FusionCache journal ", filename);
+
+  bool write_status = true;
+  if (is_new_file) {
+    write_status &= std::fwrite(
+                        kJournalMagic.data(),
+                        sizeof(char),
+                        kJournalMagic.size(),
+                        file_handle) == kJournalMagic.size();
+  }
+  const uint64_t record_size = record.size();
+  write_status &=
+      std::fwrite(&record_size, sizeof(record_size), 1, file_handle) == 1;
+  write_status &= std::fwrite(
+                      record.data(),
+                      sizeof(uint8_t),
+                      record.size(),
+                      file_handle) == record.size();
+  const std::array<uint8_t, kJournalAlignment> padding{};
+  const size_t padding_size =
+      (kJournalAlignment - record.size() % kJournalAlignment) %
+      kJournalAlignment;
+  write_status &= std::fwrite(
+                      padding.data(),
+                      sizeof(uint8_t),
+                      padding_size,
+                      file_handle) == padding_size;
+  std::fclose(file_handle);
+  NVF_ERROR(write_status, "Failed to append a record to ", filename);
+}
+
 } // namespace
 
 void serialize() {
@@ -295,12 +362,15 @@ flatbuffers::Offset<serde::TrieNode> TrieNode::serialize(
     flatbuffers::FlatBufferBuilder& builder,
     const std::map<RecordFunctor*, size_t>&
         map_record_functor_to_trie_node_id) {
-  // Map children TrieNode to its corresponding Integer index
+  // Map children TrieNode to its corresponding Integer index. Children that
+  // are not in the map are left out of a partial serialization.
   std::vector<size_t> children_trie_node_ids;
   children_trie_node_ids.reserve(children.size());
   for (auto&& c : children) {
-    size_t id = map_record_functor_to_trie_node_id.at(c.first);
-    children_trie_node_ids.push_back(id);
+    auto id_it = map_record_functor_to_trie_node_id.find(c.first);
+    if (id_it != map_record_functor_to_trie_node_id.end()) {
+      children_trie_node_ids.push_back(id_it->second);
+    }
   }
 
   return serde::CreateTrieNodeDirect(
@@ -312,6 +382,45 @@ flatbuffers::Offset<serde::TrieNode> TrieNode::serialize(
       isTerminal());
 }
 
+FusionCacheBuffer::FusionCacheBuffer(const std::string& filename) {
+  FUSER_PERF_SCOPE("Flatbuffers::openFusionCache");
+  auto file_handle = std::fopen(filename.c_str(), "rb");
+  NVF_CHECK(file_handle != nullptr, "Failed to open FusionCache buffer.");
+
+  auto file_path = fs::path(filename.c_str());
+  size_ = fs::file_size(file_path);
+  NVF_CHECK(size_ > 0, "FusionCache buffer is empty.");
+
+#ifndef _WIN32
+  // Map the file instead of reading it, so that only the pages of the
+  // fusions that are used get loaded
+  void* mapping =
+      mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fileno(file_handle), 0);
+  if (mapping != MAP_FAILED) {
+    std::fclose(file_handle);
+    data_ = static_cast<const uint8_t*>(mapping);
+    is_mapped_ = true;
+    return;
+  }
+#endif
+
+  contents_.resize(size_);
+  size_t read_status =
+      std::fread(contents_.data(), sizeof(uint8_t), size_, file_handle);
+  std::fclose(file_handle);
+  NVF_CHECK(
+      read_status == size_, "Failed to read entire FusionCache buffer.\n");
+  data_ = contents_.data();
+}
+
+FusionCacheBuffer::~FusionCacheBuffer() {
+#ifndef _WIN32
+  if (is_mapped_) {
+    munmap(const_cast<uint8_t*>(data_), size_);
+  }
+#endif
+}
+
 FusionCache* FusionCache::get(
     size_t max_fusions,
     std::optional<int64_t> selected_device,
@@ -338,7 +447,8 @@ FusionCache* FusionCache::get(
 
         // Hide exception message because it should be resolved by saving a new
         // workspace.
-        if (!isOptionDisabled(DisableOption::ParallelSerde)) {
+        if (isOptionDisabled(DisableOption::LazySerde) &&
+            !isOptionDisabled(DisableOption::ParallelSerde)) {
           std::cout
               << "Use NVFUSER_DISABLE=parallel_serde to print exception message."
               << std::endl;
@@ -430,6 +540,77 @@ void FusionCache::stats(std::ostream& os) const {
     os << "Cache Lookups: " << root_->visits;
     os << " Cache Hits: " << total_cache_hits;
     os << " Hit Rate: " << hit_rate << "%\n";
+
+    size_t runtime_hits = 0;
+    size_t runtime_misses = 0;
+    size_t evicted_runtimes = 0;
+    int64_t runtime_bytes = 0;
+    for (const auto& scheds : fusions_) {
+      if (scheds == nullptr || scheds->auto_gen_schedules == nullptr) {
+        continue;
+      }
+      const FusionExecutorCache* fec = scheds->auto_gen_schedules.get();
+      runtime_hits += fec->numRuntimeHits();
+      runtime_misses += fec->numRuntimeMisses();
+      evicted_runtimes += fec->numEvictedRuntimes();
+      runtime_bytes += fec->approximateBytes();
+    }
+    os << "Kernel Runtime Lookups: " << runtime_hits + runtime_misses;
+    os << " Hits: " << runtime_hits;
+    os << " Misses: " << runtime_misses;
+    os << " Evictions: " << evicted_runtimes << "\n";
+    os << "Approximate Kernel Runtime Bytes: " << runtime_bytes;
+    if (memory_budget_bytes_ > 0) {
+      os << " Budget: " << memory_budget_bytes_;
+    }
+    os << "\n";
+  }
+}
+
+void FusionCache::setMemoryBudget(int64_t bytes) {
+  NVF_CHECK(bytes >= 0, "Invalid memory budget: ", bytes);
+  memory_budget_bytes_ = bytes;
+  enforceMemoryBudget();
+}
+
+int64_t FusionCache::memoryBudget() const {
+  return memory_budget_bytes_;
+}
+
+void FusionCache::enforceMemoryBudget() {
+  if (memory_budget_bytes_ == 0) {
+    return;
+  }
+  FUSER_PERF_SCOPE("FusionCache::enforceMemoryBudget");
+  std::vector<FusionExecutorCache*> fecs;
+  int64_t bytes = 0;
+  for (const auto& scheds : fusions_) {
+    if (scheds != nullptr && scheds->auto_gen_schedules != nullptr) {
+      fecs.push_back(scheds->auto_gen_schedules.get());
+      bytes += fecs.back()->approximateBytes();
+    }
+  }
+  while (bytes > memory_budget_bytes_) {
+    // Evict the least recently used runtime across all fusions
+    FusionExecutorCache* lru_fec = nullptr;
+    uint64_t lru_use = 0;
+    for (FusionExecutorCache* fec : fecs) {
+      std::optional<uint64_t> use = fec->leastRecentUse();
+      if (use.has_value() && (lru_fec == nullptr || use.value() < lru_use)) {
+        lru_fec = fec;
+        lru_use = use.value();
+      }
+    }
+    if (lru_fec == nullptr) {
+      return;
+    }
+    const int64_t evicted_bytes = lru_fec->evictLeastRecentlyUsedRuntime();
+    if (evicted_bytes == 0) {
+      // The cache is running on another thread
+      fecs.erase(std::find(fecs.begin(), fecs.end(), lru_fec));
+      continue;
+    }
+    bytes -= evicted_bytes;
   }
 }
 
@@ -618,13 +799,25 @@ TrieNode* FusionCache::rootTriePtr() {
   return root_.get();
 }
 
-void FusionCache::serialize(std::string filename) const {
-  FUSER_PERF_SCOPE("FusionCache::serialize");
-  flatbuffers::FlatBufferBuilder builder(1024);
+flatbuffers::Offset<serde::FusionCache> FusionCache::serializeFusions(
+    flatbuffers::FlatBufferBuilder& builder,
+    const std::vector<TrieNode*>& terminal_nodes,
+    bool all_nodes) const {
   // TODO: Serialize Fusion IR containers
 
-  // 1. Flattened the TrieStructure using breadth-first search
-  // 2. Map RecordFunctor pointer to its position in flattened order
+  // 1. Unless all_nodes is set, only keep the paths from the root to the
+  // terminal nodes
+  std::unordered_set<TrieNode*> kept_nodes;
+  if (!all_nodes) {
+    for (TrieNode* node : terminal_nodes) {
+      while (node != nullptr && kept_nodes.insert(node).second) {
+        node = node->parent;
+      }
+    }
+  }
+
+  // 2. Flattened the TrieStructure using breadth-first search
+  // 3. Map RecordFunctor pointer to its position in flattened order
   std::map<RecordFunctor*, size_t> map_record_functor_to_trie_node_id;
   std::vector<TrieNode*> bfs_order;
   std::deque<TrieNode*> queue = {root_.get()};
@@ -637,11 +830,13 @@ void FusionCache::serialize(std::string filename) const {
     bfs_order.push_back(current_node);
 
     for (auto&& child : current_node->children) {
-      queue.push_back(child.second.get());
+      if (all_nodes || kept_nodes.count(child.second.get()) > 0) {
+        queue.push_back(child.second.get());
+      }
     }
   }
 
-  // 3. Serialize TrieNode in Breadth-First Search (BFS) order
+  // 4. Serialize TrieNode in Breadth-First Search (BFS) order
   //
   // Note 1) All TrieNode pointers are mapped to their corresponding index in
   // BFS traversal order.
@@ -659,21 +854,22 @@ void FusionCache::serialize(std::string filename) const {
     fb_nodes.push_back(serialized_trie_node);
   }
 
-  // 4. Map the terminal nodes to their BFS positions.
-  // 5. Serialize each FusionExecutorCache for each fusion.
+  // 5. Map the terminal nodes to their BFS positions.
+  // 6. Serialize each FusionExecutorCache for each fusion.
   std::vector<size_t> terminal_node_idx;
-  terminal_node_idx.reserve(terminal_nodes_.size());
+  terminal_node_idx.reserve(terminal_nodes.size());
 
   using fb_fusion_executor_cache =
       flatbuffers::Offset<serde::FusionExecutorCache>;
   std::vector<fb_fusion_executor_cache> fb_auto_gen_schedules;
-  fb_auto_gen_schedules.reserve(terminal_nodes_.size());
+  fb_auto_gen_schedules.reserve(terminal_nodes.size());
 
-  for (auto node : terminal_nodes_) {
+  for (auto node : terminal_nodes) {
     terminal_node_idx.push_back(
         map_record_functor_to_trie_node_id.at(node->record.get()));
 
     auto schedule = queryFusionSchedules(node->fusion_id);
+    schedule->auto_gen_schedules->materializeRuntimes();
     fb_auto_gen_schedules.emplace_back(
         schedule->auto_gen_schedules->serialize(builder));
   }
@@ -683,9 +879,9 @@ void FusionCache::serialize(std::string filename) const {
   int cuda_minor = 0;
   NVFUSER_NVRTC_SAFE_CALL(nvrtcVersion(&cuda_major, &cuda_minor));
 
-  // 6. Build FusionCache flatbuffer object
+  // 7. Build FusionCache flatbuffer object
   // See table definition for FusionCache in serde/fusion_cache.fbs
-  auto fusion_cache = serde::CreateFusionCacheDirect(
+  return serde::CreateFusionCacheDirect(
       builder,
       max_fusions_,
       &fb_nodes,
@@ -696,9 +892,16 @@ void FusionCache::serialize(std::string filename) const {
       device_prop->minor,
       cuda_major,
       cuda_minor);
-  builder.Finish(fusion_cache, /*file_identifier=*/"NV01");
+}
+
+void FusionCache::serialize(std::string filename) const {
+  FUSER_PERF_SCOPE("FusionCache::serialize");
+  flatbuffers::FlatBufferBuilder builder(1024);
+  builder.Finish(
+      serializeFusions(builder, terminal_nodes_, /*all_nodes=*/true),
+      /*file_identifier=*/"NV01");
 
-  // 6. Write flatbuffer binary to file
+  // Write flatbuffer binary to file
   auto fb = builder.GetBufferSpan();
   auto file_handle = std::fopen(filename.c_str(), "wb");
   size_t write_status =
@@ -709,6 +912,81 @@ void FusionCache::serialize(std::string filename) const {
   std::fclose(file_handle);
 }
 
+void FusionCache::appendToJournal(std::string filename) {
+  FUSER_PERF_SCOPE("FusionCache::appendToJournal");
+  if (filename != journal_filename_) {
+    // The fusion ids of another journal don't match the ids of this cache, so
+    // only the journal this cache was deserialized from can be continued
+    NVF_CHECK(
+        !fs::exists(filename) || fs::file_size(filename) == 0,
+        "Cannot append to ",
+        filename,
+        " because this FusionCache was not deserialized from it.");
+    journal_filename_ = filename;
+    journaled_runtimes_.clear();
+  }
+
+  // Append the fusions created or given new kernel runtimes since the last
+  // record. A later record of a fusion replaces its earlier records.
+  std::vector<TrieNode*> changed_nodes;
+  for (auto fusion_id : c10::irange(terminal_nodes_.size())) {
+    TrieNode* node = terminal_nodes_.at(fusion_id);
+    size_t num_runtimes = queryFusionSchedules(node->fusion_id)
+                              ->auto_gen_schedules->numCreatedRuntimes();
+    if (fusion_id >= journaled_runtimes_.size()) {
+      journaled_runtimes_.push_back(num_runtimes);
+    } else if (journaled_runtimes_.at(fusion_id) != num_runtimes) {
+      journaled_runtimes_.at(fusion_id) = num_runtimes;
+    } else {
+      continue;
+    }
+    changed_nodes.push_back(node);
+  }
+  if (changed_nodes.empty()) {
+    return;
+  }
+
+  flatbuffers::FlatBufferBuilder builder(1024);
+  builder.Finish(
+      serializeFusions(builder, changed_nodes, /*all_nodes=*/false),
+      /*file_identifier=*/"NV01");
+  auto fb = builder.GetBufferSpan();
+  std::vector<uint8_t> record(fb.begin(), fb.end());
+
+  // Each write waits for the previous one so that the records stay in order
+  journal_write_ = std::async(
+      std::launch::async,
+      [previous_write = std::move(journal_write_),
+       record = std::move(record),
+       filename]() mutable {
+        if (previous_write.valid()) {
+          previous_write.get();
+        }
+        appendJournalRecord(filename, record);
+      });
+}
+
+void FusionCache::waitForJournalWrites() {
+  if (journal_write_.valid()) {
+    journal_write_.get();
+  }
+}
+
+void FusionCache::compactJournal(
+    const std::string& journal_filename,
+    const std::string& filename,
+    std::optional<int64_t> selected_device) {
+  FUSER_PERF_SCOPE("FusionCache::compactJournal");
+  // Deserializing sets the global fusion count of the process
+  auto global_fusion_count = KernelExecutor::getGlobalFusionCount();
+  {
+    FusionCache fusion_cache(/*max_fusions=*/0, selected_device);
+    fusion_cache.deserialize(journal_filename);
+    fusion_cache.serialize(filename);
+  }
+  KernelExecutor::setGlobalFusionCount(global_fusion_count);
+}
+
 void FusionCache::deserialize(std::string filename) {
   // See table definition for FusionCache in serde/fusion_cache.fbs
   // 0. Load flatbuffer binary from file
@@ -716,12 +994,77 @@ void FusionCache::deserialize(std::string filename) {
   NVF_CHECK(
       fusions_.empty(),
       "Deserialization is prohibited if FusionCache is already populated.");
-  const BinaryBuffer& buffer = openFusionCache(filename);
-  const serde::FusionCache* fusion_cache_buffer =
-      verifyFusionCache(buffer, device_id_);
+  serde_buffer_ = std::make_unique<FusionCacheBuffer>(filename);
+
+  // A journal holds several records that are merged in order
+  const bool is_journal =
+      isFusionCacheJournal(serde_buffer_->data(), serde_buffer_->size());
+  std::vector<const serde::FusionCache*> records;
+  if (is_journal) {
+    records = getJournalRecords(*serde_buffer_, device_id_);
+  } else {
+    records.push_back(verifyFusionCache(
+        serde_buffer_->data(), serde_buffer_->size(), device_id_));
+  }
 
+  // The FusionExecutorCache of each fusion in its latest record
+  std::map<size_t, const serde::FusionExecutorCache*> fb_fec_nodes;
+  for (auto fusion_cache_buffer : records) {
+    deserializeTrie(fusion_cache_buffer, fb_fec_nodes);
+  }
+
+  std::atomic<bool> detect_exception_in_thread_pool{false};
+  CompileTaskGroup deserialization_tasks;
+  for (const auto& fb_fec_entry : fb_fec_nodes) {
+    auto fusion_id = fb_fec_entry.first;
+    auto fb_fec_node = fb_fec_entry.second;
+    auto fusion_schedule = queryFusionSchedules(fusion_id);
+
+    if (!isOptionDisabled(DisableOption::LazySerde)) {
+      // Kernel runtimes are rebuilt from serde_buffer_ on first use
+      fusion_schedule->auto_gen_schedules->deserialize(
+          fb_fec_node, (int64_t)fusion_id, /*lazy=*/true);
+    } else if (!isOptionDisabled(DisableOption::ParallelSerde)) {
+      // Parallelize the deserialization of each FusionExecutorCache.
+      deserialization_tasks.run([=, &detect_exception_in_thread_pool]() {
+        FUSER_PERF_SCOPE("FusionCache::deserializeFusionParallel");
+        try {
+          fusion_schedule->auto_gen_schedules->deserialize(
+              fb_fec_node, (int64_t)fusion_id);
+        } catch (const std::exception& e) {
+          // Set flag inside lambda so we can throw an exception after thread
+          // pool completes its work.
+          detect_exception_in_thread_pool.store(true);
+        }
+      });
+    } else {
+      FUSER_PERF_SCOPE("FusionCache::deserializeFusionSerial");
+      fusion_schedule->auto_gen_schedules->deserialize(
+          fb_fec_node, (int64_t)fusion_id);
+    }
+  }
+
+  if (isOptionDisabled(DisableOption::LazySerde) &&
+      !isOptionDisabled(DisableOption::ParallelSerde)) {
+    // Wait until all fusion executor caches are deserialized
+    deserialization_tasks.wait();
+    NVF_ERROR(
+        !detect_exception_in_thread_pool.load(),
+        "Detected exception while deserializing fusions in parallel.\n",
+        "Use NVFUSER_DISABLE=parallel_serde to print exception message.");
+  }
+
+  // Continue appending to the journal without repeating its fusions
+  if (is_journal) {
+    journal_filename_ = filename;
+    journaled_runtimes_.assign(fusions_.size(), 0);
+  }
+}
+
+void FusionCache::deserializeTrie(
+    const serde::FusionCache* fusion_cache_buffer,
+    std::map<size_t, const serde::FusionExecutorCache*>& fb_fec_nodes) {
   // See table definition for FusionCache in serde/fusion_cache.fbs
-  FUSER_PERF_SCOPE("FusionCache::deserialize");
   NVF_CHECK(fusion_cache_buffer != nullptr, "Fusion Cache buffer is invalid.");
 
   // 0. Set static fusion count in Fusion Executor
@@ -732,16 +1075,25 @@ void FusionCache::deserialize(std::string filename) {
   max_fusions_ = fusion_cache_buffer->max_fusions();
 
   // 2. Deserialize fusions: (Fusion) and structure: (TrieNode) fields
-  std::generate_n(
-      std::back_inserter(fusions_),
-      fusion_cache_buffer->terminal_nodes()->size(),
-      [] { return std::make_unique<FusionSchedules>(); });
+  for (auto node_idx : *fusion_cache_buffer->terminal_nodes()) {
+    size_t fusion_id =
+        fusion_cache_buffer->structure()->Get(node_idx)->fusion_id();
+    while (fusions_.size() <= fusion_id) {
+      fusions_.emplace_back(
+          std::make_unique<FusionSchedules>((int64_t)fusions_.size()));
+    }
+  }
 
   serde::RecordFunctorFactory record_functor_factory;
 
-  using BfsState = std::pair<TrieNode*, size_t>;
+  // The last element tells whether the TrieNode is created by this buffer.
+  // Journal records repeat the paths to their fusions, which may already be
+  // in the trie.
+  using BfsState = std::tuple<TrieNode*, size_t, bool>;
   std::deque<BfsState> queue = {
-      {root_.get() /* TrieNode pointer */, 0 /* structure_idx */}};
+      {root_.get() /* TrieNode pointer */,
+       0 /* structure_idx */,
+       false /* is_new */}};
 
   // state_queue holds the FusionState for each BfsState in the queue.
   std::deque<std::unique_ptr<FusionState>> state_queue;
@@ -753,11 +1105,12 @@ void FusionCache::deserialize(std::string filename) {
   // corresponding TrieNode pointers. It is used to reconstruct the
   // terminal_nodes vector.
   std::vector<TrieNode*> bfs_order;
+  std::unordered_set<TrieNode*> new_terminal_nodes;
 
   // Starting from the root node, we build the Trie structure in breadth-first
   // (BFS) order.
   while (!queue.empty()) {
-    auto& [trie_ptr, structure_idx] = queue.front();
+    auto& [trie_ptr, structure_idx, is_new] = queue.front();
 
     // Update BFS order
     bfs_order.push_back(trie_ptr);
@@ -773,7 +1126,7 @@ void FusionCache::deserialize(std::string filename) {
     // Deserialize Table TrieNode => Field: visits (ulong)
     trie_ptr->visits = fb_trie_node->visits();
 
-    // Build fusion container if current node is a terminal node
+    // Build fusion container if current node is a new terminal node
     if (fb_trie_node->is_terminal()) {
       NVF_CHECK(
           fb_trie_node->children()->size() == 0,
@@ -784,6 +1137,9 @@ void FusionCache::deserialize(std::string filename) {
       NVF_CHECK(
           trie_ptr->fusion_id == fb_trie_node->fusion_id(),
           "The fusion id for this TrieNode should already be set.")
+    }
+    if (fb_trie_node->is_terminal() && is_new) {
+      new_terminal_nodes.insert(trie_ptr);
       FusionSchedules* fs = queryFusionSchedules(fb_trie_node->fusion_id());
       Fusion* fusion = fs->preschedFusion();
       try {
@@ -814,18 +1170,27 @@ void FusionCache::deserialize(std::string filename) {
       auto rec =
           record_functor_factory.parse(serde_buffer->type(), serde_buffer);
 
-      // Deserialize the record and fusion id fields in the TrieNode table
-      auto status = trie_ptr->children.emplace(
-          rec,
-          std::make_unique<TrieNode>(
-              rec, trie_ptr, fb_child_trie_node->fusion_id()));
-      NVF_CHECK(
-          status.second,
-          "Fusion-Cache Deserialization: Failed to add child to the current TrieNode.");
-
-      // Add child TrieNode to BFS queue
-      queue.emplace_back(
-          status.first->second.get() /* TrieNode pointer */, child_bfs_idx);
+      auto existing_child = trie_ptr->children.find(rec);
+      if (existing_child != trie_ptr->children.end()) {
+        delete rec;
+        queue.emplace_back(
+            existing_child->second.get(), child_bfs_idx, /*is_new=*/false);
+      } else {
+        // Deserialize the record and fusion id fields in the TrieNode table
+        auto status = trie_ptr->children.emplace(
+            rec,
+            std::make_unique<TrieNode>(
+                rec, trie_ptr, fb_child_trie_node->fusion_id()));
+        NVF_CHECK(
+            status.second,
+            "Fusion-Cache Deserialization: Failed to add child to the current TrieNode.");
+
+        // Add child TrieNode to BFS queue
+        queue.emplace_back(
+            status.first->second.get() /* TrieNode pointer */,
+            child_bfs_idx,
+            /*is_new=*/true);
+      }
       state_queue.emplace_back(state->clone());
     }
 
@@ -834,43 +1199,15 @@ void FusionCache::deserialize(std::string filename) {
     state_queue.pop_front();
   }
 
-  std::atomic<bool> detect_exception_in_thread_pool{false};
   // Deserialize terminal_nodes field in the FusionCache table
-  for (auto idx : c10::irange(fusions_.size())) {
+  for (auto idx : c10::irange(fusion_cache_buffer->terminal_nodes()->size())) {
     auto node_idx = fusion_cache_buffer->terminal_nodes()->Get(idx);
     auto trie_node = bfs_order.at(node_idx);
-    terminal_nodes_.push_back(trie_node);
-
-    auto fb_fec_node = fusion_cache_buffer->auto_gen_schedules()->Get(idx);
-    auto fusion_schedule = queryFusionSchedules(trie_node->fusion_id);
-
-    if (!isOptionDisabled(DisableOption::ParallelSerde)) {
-      // Parallelize the deserialization of each FusionExecutorCache.
-      getThreadPool()->run([=, &detect_exception_in_thread_pool]() {
-        FUSER_PERF_SCOPE("FusionCache::deserializeFusionParallel");
-        try {
-          fusion_schedule->auto_gen_schedules->deserialize(
-              fb_fec_node, (int64_t)trie_node->fusion_id);
-        } catch (const std::exception& e) {
-          // Set flag inside lambda so we can throw an exception after thread
-          // pool completes its work.
-          detect_exception_in_thread_pool.store(true);
-        }
-      });
-    } else {
-      FUSER_PERF_SCOPE("FusionCache::deserializeFusionSerial");
-      fusion_schedule->auto_gen_schedules->deserialize(
-          fb_fec_node, (int64_t)trie_node->fusion_id);
+    if (new_terminal_nodes.count(trie_node) > 0) {
+      terminal_nodes_.push_back(trie_node);
     }
-  }
-
-  if (!isOptionDisabled(DisableOption::ParallelSerde)) {
-    // Wait until all fusion executor caches are deserialized
-    getThreadPool()->waitWorkComplete();
-    NVF_ERROR(
-        !detect_exception_in_thread_pool.load(),
-        "Detected exception while deserializing fusions in parallel.\n",
-        "Use NVFUSER_DISABLE=parallel_serde to print exception message.");
+    fb_fec_nodes[trie_node->fusion_id] =
+        fusion_cache_buffer->auto_gen_schedules()->Get(idx);
   }
 }
 
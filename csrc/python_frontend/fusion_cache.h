@@ -14,8 +14,11 @@
 #include <scheduler/compile_time_info.h>
 #include <scheduler/registry.h>
 
+#include <future>
 #include <memory>
 #include <mutex>
+#include <string>
+#include <vector>
 
 namespace nvfuser::python_frontend {
 
@@ -166,6 +169,32 @@ struct TrieNode {
   std::optional<std::string> exception = std::nullopt;
 };
 
+//! \class FusionCacheBuffer
+//! \brief A read-only memory mapping of a serialized FusionCache. Lazily
+//! deserialized FusionExecutorCaches rebuild their kernel runtimes from it on
+//! first use, so it lives as long as the FusionCache.
+class FusionCacheBuffer : public NonCopyable {
+ public:
+  explicit FusionCacheBuffer(const std::string& filename);
+  ~FusionCacheBuffer();
+
+  const uint8_t* data() const {
+    return data_;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+ private:
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  //! Whether data_ is a mapping of the file instead of pointing to contents_
+  bool is_mapped_ = false;
+  //! Holds a copy of the file where it can't be mapped
+  std::vector<uint8_t> contents_;
+};
+
 //! \class FusionCache
 //! \brief A singleton class used in the nvFuser python interface
 //! to manage the caching of fusions.
@@ -213,11 +242,30 @@ class FusionCache {
   NVF_API void stats(std::ostream& os) const;
   //! Reset Cache to an empty state
   NVF_API static void reset();
+  //! Bound the approximate memory held by the kernel runtimes of all fusions.
+  //! Past the budget, the least recently used runtimes are evicted after an
+  //! execution, and are compiled again if they are needed. Each fusion keeps
+  //! its most recent runtime. A budget of 0, the default, is unlimited.
+  NVF_API void setMemoryBudget(int64_t bytes);
+  NVF_API int64_t memoryBudget() const;
 
   //! Serialize Fusion Cache using flatbuffers
   NVF_API void serialize(std::string filename) const;
-  //! Deserialize Fusion Cache using flatbuffers
+  //! Deserialize Fusion Cache using flatbuffers. The file is either a
+  //! serialized Fusion Cache or a journal written by appendToJournal.
   NVF_API void deserialize(std::string filename);
+  //! Thread-Unsafe: Append the fusions created or recompiled since the last
+  //! append to a journal. The record is built on the calling thread, and the
+  //! file is written in the background.
+  NVF_API void appendToJournal(std::string filename);
+  //! Wait for the pending journal writes and rethrow a failed write
+  NVF_API void waitForJournalWrites();
+  //! Replace a journal with a single serialized Fusion Cache. Requires a GPU
+  //! because kernel runtimes are rebuilt before they are serialized.
+  NVF_API static void compactJournal(
+      const std::string& journal_filename,
+      const std::string& filename,
+      std::optional<int64_t> selected_device = std::nullopt);
 
   //! The rest of the public methods are only used in C++
 
@@ -255,8 +303,24 @@ class FusionCache {
       bool overwrite_existing_schedule = false);
   //! Get the root Trie ptr
   NVF_API TrieNode* rootTriePtr();
+  //! Thread-Unsafe: Evict kernel runtimes until the approximate memory they
+  //! hold fits the memory budget, see setMemoryBudget
+  void enforceMemoryBudget();
 
  private:
+  //! Serialize the given terminal nodes and their FusionExecutorCaches. If
+  //! all_nodes is false, only the ancestors of terminal_nodes are kept in the
+  //! trie structure.
+  flatbuffers::Offset<serde::FusionCache> serializeFusions(
+      flatbuffers::FlatBufferBuilder& builder,
+      const std::vector<TrieNode*>& terminal_nodes,
+      bool all_nodes) const;
+  //! Merge the trie structure of a serialized Fusion Cache into this cache
+  //! and map each of its fusion ids to its FusionExecutorCache
+  void deserializeTrie(
+      const serde::FusionCache* fusion_cache_buffer,
+      std::map<size_t, const serde::FusionExecutorCache*>& fb_fec_nodes);
+
   //! The static pointer to the FusionCache
   static FusionCache* singleton_;
   //! Lock for accessing the singleton by multiple threads
@@ -264,9 +328,14 @@ class FusionCache {
 
   //! The max allowed number of fusions in the cache
   size_t max_fusions_;
+  //! See setMemoryBudget
+  int64_t memory_budget_bytes_ = 0;
   //! A separate process is created for each device in a distributed setting.
   //! Each FusionCache becomes associated with a device.
   std::optional<int64_t> device_id_;
+  //! The serialized cache this cache was deserialized from. It must outlive
+  //! fusions_, which may still read their kernel runtimes from it.
+  std::unique_ptr<FusionCacheBuffer> serde_buffer_;
   //! The root (start) of the prefix tree to start a cache look up of a given
   //! fusion definition.
   std::unique_ptr<TrieNode> root_;
@@ -283,6 +352,15 @@ class FusionCache {
   // NOTE: I would prefer this be per FusionSchedules object but the container
   // is not allowed to be copied or moved.
   InputsIdLookup user_def_input_encodings_;
+
+  //! The journal that appendToJournal last wrote to or that this cache was
+  //! deserialized from
+  std::string journal_filename_;
+  //! The number of kernel runtimes of each fusion when it was last written
+  //! to journal_filename_
+  std::vector<size_t> journaled_runtimes_;
+  //! The latest pending write to journal_filename_
+  std::future<void> journal_write_;
 };
 
 //! Serialize Fusion Cache to common workspace
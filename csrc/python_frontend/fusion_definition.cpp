@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
+#include <c10/cuda/CUDAGuard.h>
 #include <debug.h>
 #include <fusion_profiler.h>
 #include <instrumentation.h>
@@ -44,6 +45,8 @@ const char* dtypeToPyString(PrimDataType t) {
       return "DataType.Int";
     case DataType::Int32:
       return "DataType.Int32";
+    case DataType::Int8:
+      return "DataType.Int8";
     case DataType::ComplexFloat:
       return "DataType.ComplexFloat";
     case DataType::ComplexDouble:
@@ -351,14 +354,42 @@ std::vector<at::Tensor> FusionDefinition::execute(
     bool capture_debug_output,
     bool profile,
     std::vector<std::string> _enable_options,
-    std::vector<std::string> _disable_options) const {
+    std::vector<std::string> _disable_options,
+    const std::vector<at::Tensor>& outputs) const {
   debug_output_ = std::nullopt;
   std::stringstream debug_ss;
   DebugStreamGuard dsg(capture_debug_output ? debug_ss : std::cout);
 
   NVF_CHECK(id().has_value(), "Valid fusion schedule is not available!");
 
-  auto scheds = fusionCache()->queryFusionSchedules(id().value());
+  std::vector<at::Tensor> results = executeById(
+      id().value(),
+      inputs,
+      selected_device,
+      override_user_schedule,
+      profile,
+      _enable_options,
+      _disable_options,
+      outputs);
+
+  if (capture_debug_output) {
+    debug_output_ = debug_ss.str();
+  }
+
+  return results;
+}
+
+std::vector<at::Tensor> FusionDefinition::executeById(
+    size_t fusion_id,
+    const at::ArrayRef<c10::IValue>& inputs,
+    std::optional<int8_t> selected_device,
+    bool override_user_schedule,
+    bool profile,
+    const std::vector<std::string>& _enable_options,
+    const std::vector<std::string>& _disable_options,
+    const std::vector<at::Tensor>& given_outputs) {
+  FusionCache* fusion_cache = FusionCache::get();
+  auto scheds = fusion_cache->queryFusionSchedules(fusion_id);
 
   std::vector<at::Tensor> outputs;
   if (profile) {
@@ -385,13 +416,13 @@ std::vector<at::Tensor> FusionDefinition::execute(
     NVF_CHECK(
         inputs.empty() || device > -1,
         "Inputs are not all on the same device or don't match selection!");
-    auto user_sched_id = fusionCache()->queryUserScheduleId(scheds, inputs);
+    auto user_sched_id = fusion_cache->queryUserScheduleId(scheds, inputs);
     if (user_sched_id.has_value()) {
       if (isProfilerEnabledWithCupti()) {
         FusionProfiler::start();
         FusionProfiler::createSegments(1);
       }
-      auto& user_sched = fusionCache()->queryUserSchedule(
+      auto& user_sched = fusion_cache->queryUserSchedule(
           scheds, user_sched_id.value(), device);
       scheds->last_user_def_scheduled_ir = user_sched.scheduled_fusion.get();
       scheds->last_user_def_executor = user_sched.executor.get();
@@ -402,7 +433,7 @@ std::vector<at::Tensor> FusionDefinition::execute(
           user_sched.executor->compile(
               user_sched.scheduled_fusion.get(), inputs);
         }
-        outputs = user_sched.executor->run(inputs);
+        outputs = user_sched.executor->run(inputs, given_outputs);
       } else {
         // Automatic scheduler was used for UserSchedule.
         // Pass launch and compile params to compileFusion and runFusion.
@@ -417,6 +448,7 @@ std::vector<at::Tensor> FusionDefinition::execute(
         }
         outputs = user_sched.executor->run(
             inputs,
+            given_outputs,
             user_sched.heuristic_params->lparams,
             user_sched.heuristic_params->cparams);
       }
@@ -436,19 +468,70 @@ std::vector<at::Tensor> FusionDefinition::execute(
   // generated output through user scheduled kernel.
   if (outputs.empty()) {
     outputs = scheds->auto_gen_schedules->runFusionWithInputs(
-        inputs, std::nullopt, selected_device);
+        inputs, std::nullopt, selected_device, given_outputs);
   }
   if (profile) {
     ProfilerOptionsGuard::getCurOptions().unset(ProfilerOption::Enable);
   }
 
-  if (capture_debug_output) {
-    debug_output_ = debug_ss.str();
-  }
+  fusion_cache->enforceMemoryBudget();
+
+  return outputs;
+}
 
+std::vector<std::vector<at::Tensor>> FusionDefinition::executeBatch(
+    const std::vector<std::pair<size_t, std::vector<c10::IValue>>>& fusions,
+    std::optional<int8_t> device) {
+  FUSER_PERF_SCOPE("FusionDefinition::executeBatch");
+  std::vector<std::vector<at::Tensor>> outputs;
+  outputs.reserve(fusions.size());
+  for (const auto& [fusion_id, inputs] : fusions) {
+    outputs.push_back(executeById(fusion_id, inputs, device));
+  }
   return outputs;
 }
 
+FusionFuture FusionDefinition::executeAsync(
+    size_t fusion_id,
+    std::vector<c10::IValue> inputs,
+    std::optional<int8_t> selected_device) {
+  FUSER_PERF_SCOPE("FusionDefinition::executeAsync");
+  FusionSchedules* scheds =
+      FusionCache::get()->queryFusionSchedules(fusion_id);
+  // User schedules are looked up in the FusionCache, which relies on the GIL
+  // for thread safety, unlike the FusionExecutorCache
+  NVF_CHECK(
+      scheds->user_def_schedules.empty(),
+      "Asynchronous execution doesn't support user schedules");
+  const int8_t device = getCommonDeviceCUDA(inputs, selected_device);
+  NVF_CHECK(
+      inputs.empty() || device > -1,
+      "Inputs are not all on the same device or don't match selection!");
+  c10::cuda::CUDAStream stream =
+      c10::cuda::getCurrentCUDAStream(device > -1 ? device : 0);
+
+  // A dedicated thread is used instead of the nvFuser thread pool, because
+  // compiling the segments waits for tasks of that pool, which could deadlock
+  // once all of its threads run executions
+  std::shared_future<std::vector<at::Tensor>> outputs = std::async(
+      std::launch::async,
+      [scheds, inputs = std::move(inputs), selected_device, stream]() {
+        c10::cuda::CUDAStreamGuard stream_guard(stream);
+        return scheds->auto_gen_schedules->runFusionWithInputs(
+            inputs, std::nullopt, selected_device);
+      });
+  return FusionFuture(std::move(outputs));
+}
+
+bool FusionFuture::done() const {
+  return outputs_.wait_for(std::chrono::seconds(0)) ==
+      std::future_status::ready;
+}
+
+std::vector<at::Tensor> FusionFuture::result() const {
+  return outputs_.get();
+}
+
 std::string FusionDefinition::fusionIr() {
   NVF_CHECK(id().has_value(), "Invalid fusion definition!");
   std::stringstream ss;
@@ -571,6 +654,42 @@ std::string FusionDefinition::scheduledFusionIrFor(
       inputs, tensor_transforms);
 }
 
+std::unordered_map<std::string, size_t> FusionDefinition::runtimeCacheStats()
+    const {
+  NVF_CHECK(id().has_value(), "Invalid fusion definition!");
+  auto scheds = fusionCache()->queryFusionSchedules(id().value());
+  const FusionExecutorCache* fec = scheds->auto_gen_schedules.get();
+  return {
+      {"runtime_hits", fec->numRuntimeHits()},
+      {"runtime_misses", fec->numRuntimeMisses()},
+      {"created_runtimes", fec->numCreatedRuntimes()},
+      {"evicted_runtimes", fec->numEvictedRuntimes()}};
+}
+
+void FusionDefinition::setAsyncCompilation(bool enabled) const {
+  NVF_CHECK(id().has_value(), "Invalid fusion definition!");
+  auto scheds = fusionCache()->queryFusionSchedules(id().value());
+  if (enabled) {
+    scheds->auto_gen_schedules->enableAsyncCompilation();
+  } else {
+    scheds->auto_gen_schedules->disableAsyncCompilation();
+  }
+}
+
+void FusionDefinition::setShapeBucketPolicy(
+    const std::vector<std::pair<int64_t, int64_t>>& input_dims) const {
+  NVF_CHECK(id().has_value(), "Invalid fusion definition!");
+  auto scheds = fusionCache()->queryFusionSchedules(id().value());
+  scheds->auto_gen_schedules->setShapeBucketPolicy(
+      ShapeBucketPolicy::powersOfTwo(input_dims));
+}
+
+void FusionDefinition::clearShapeBucketPolicy() const {
+  NVF_CHECK(id().has_value(), "Invalid fusion definition!");
+  auto scheds = fusionCache()->queryFusionSchedules(id().value());
+  scheds->auto_gen_schedules->clearShapeBucketPolicy();
+}
+
 std::optional<size_t> FusionDefinition::id() const {
   return fusion_id_;
 }
@@ -9,6 +9,7 @@
 
 #include <exceptions.h>
 #include <functional>
+#include <future>
 #include <iostream>
 #include <unordered_map>
 
@@ -146,6 +147,24 @@ struct Vector {
   FusionDefinition* fusion_definition;
 };
 
+//! FusionFuture holds the outputs of FusionDefinition::executeAsync. They are
+//! available once the fusion is compiled and launched, and they are ready to
+//! use on the stream that was current when executeAsync was called.
+class NVF_API FusionFuture {
+ public:
+  explicit FusionFuture(std::shared_future<std::vector<at::Tensor>> outputs)
+      : outputs_(std::move(outputs)) {}
+
+  //! Whether the fusion was launched or failed, i.e., result() doesn't block
+  bool done() const;
+  //! Waits for the launch and returns the outputs, or rethrows the error of
+  //! the compilation or of the launch
+  std::vector<at::Tensor> result() const;
+
+ private:
+  std::shared_future<std::vector<at::Tensor>> outputs_;
+};
+
 //! FusionDefinition defines the C++ side of a Python Context manager to
 //! encapsulate the definition of fusion operations.
 //!
@@ -192,7 +211,9 @@ class NVF_API FusionDefinition : public FusionState {
   NVF_API void finalizeMultideviceSchedule();
   //! Prints a python function representing the definition
   NVF_API void print(std::ostream& os) const;
-  //! Executes a fusion if a valid definition or cache lookup occurred prior
+  //! Executes a fusion if a valid definition or cache lookup occurred prior.
+  //! If given, the outputs are written to `outputs`, see
+  //! FusionExecutorCache::runFusionWithInputs.
   NVF_API std::vector<at::Tensor> execute(
       const at::ArrayRef<c10::IValue>& inputs,
       std::optional<int8_t> device,
@@ -200,7 +221,34 @@ class NVF_API FusionDefinition : public FusionState {
       bool capture_debug_output,
       bool profile,
       std::vector<std::string> _enable_options,
-      std::vector<std::string> _disable_options) const;
+      std::vector<std::string> _disable_options,
+      const std::vector<at::Tensor>& outputs = {}) const;
+  //! Executes a cached fusion given its id, i.e., FusionDefinition::id(),
+  //! without building its records again nor walking the FusionCache trie.
+  //! Meant for small fusions executed often, whose definition costs more
+  //! than their kernels.
+  NVF_API static std::vector<at::Tensor> executeById(
+      size_t fusion_id,
+      const at::ArrayRef<c10::IValue>& inputs,
+      std::optional<int8_t> device = std::nullopt,
+      bool override_user_schedule = false,
+      bool profile = false,
+      const std::vector<std::string>& _enable_options = {},
+      const std::vector<std::string>& _disable_options = {},
+      const std::vector<at::Tensor>& outputs = {});
+  //! Executes several cached fusions, given their ids and inputs, back to back
+  //! on the current stream. Returns the outputs of each fusion in order.
+  NVF_API static std::vector<std::vector<at::Tensor>> executeBatch(
+      const std::vector<std::pair<size_t, std::vector<c10::IValue>>>& fusions,
+      std::optional<int8_t> device = std::nullopt);
+  //! Executes a cached fusion on a separate thread so that the caller, e.g.,
+  //! a Python thread that released the GIL, isn't blocked by a first-time
+  //! segmentation and compilation. The outputs are computed on the current
+  //! stream of the caller. Fusions with user schedules are not supported.
+  NVF_API static FusionFuture executeAsync(
+      size_t fusion_id,
+      std::vector<c10::IValue> inputs,
+      std::optional<int8_t> device = std::nullopt);
   //! Return debugging output captured through exeuction with
   //! capture_debug_output=true
   std::optional<std::string> getDebugOutput() const {
@@ -232,6 +280,16 @@ class NVF_API FusionDefinition : public FusionState {
       const at::ArrayRef<c10::IValue>& inputs,
       bool tensor_transforms,
       bool override_user_schedule) const;
+  //! Return the kernel runtime lookups and runtimes of the auto-generated
+  //! schedules, see FusionExecutorCache::numRuntimeHits
+  NVF_API std::unordered_map<std::string, size_t> runtimeCacheStats() const;
+  //! See FusionExecutorCache::enableAsyncCompilation
+  NVF_API void setAsyncCompilation(bool enabled) const;
+  //! Bucket the extents of the given (input index, dim) pairs by powers of
+  //! two, see FusionExecutorCache::setShapeBucketPolicy
+  NVF_API void setShapeBucketPolicy(
+      const std::vector<std::pair<int64_t, int64_t>>& input_dims) const;
+  NVF_API void clearShapeBucketPolicy() const;
   //! Return fusion id of defined FusionDefinition
   NVF_API std::optional<size_t> id() const;
   //! Prints the Prescheduled Fusion IR representation
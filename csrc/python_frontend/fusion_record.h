@@ -3052,6 +3052,159 @@ struct SdpaBwdOpRecord : RecordFunctor {
   }
 };
 
+//! Specialized Record Functor for the sort op. The outputs are the sorted
+//! values and their indices.
+struct SortOpRecord : RecordFunctor {
+  SortOpRecord(
+      std::vector<State> args,
+      std::vector<State> outputs,
+      int64_t dim,
+      bool descending,
+      bool stable)
+      : RecordFunctor(
+            std::move(args),
+            std::move(outputs),
+            "ops.sort",
+            serde::RecordType::SortOp),
+        dim_(dim),
+        descending_(descending),
+        stable_(stable) {}
+  ~SortOpRecord() override = default;
+  RecordFunctor* clone() final {
+    return new SortOpRecord(*this);
+  }
+
+  //! Child specific hash function in lower 32 bits.
+  //! | 31 ---------- 30 | 29 ------ 28 | 27 -----------------------------  0 |
+  //! | descending       | stable       | dim                                 |
+  size_t hash() const final {
+    auto result = RecordFunctor::hash();
+    return result | (static_cast<size_t>(descending_) << 30) |
+        (static_cast<size_t>(stable_) << 28) |
+        (static_cast<size_t>(dim_) & 0xfffffff);
+  }
+
+  bool operator==(const RecordFunctor& other) const final {
+    auto result = false;
+    if (auto child_ptr = dynamic_cast<const SortOpRecord*>(&other)) {
+      result = RecordFunctor::operator==(other);
+      result = result && (dim_ == child_ptr->dim_);
+      result = result && (descending_ == child_ptr->descending_);
+      result = result && (stable_ == child_ptr->stable_);
+    }
+    return result;
+  }
+
+  void operator()(FusionState& fd) final {
+    auto arg = fd.getFusionState(args_.at(0).index)->as<TensorView>();
+    auto result = sort(arg, dim_, descending_, stable_);
+    fd.setFusionState(outputs_.at(0).index, result.values);
+    fd.setFusionState(outputs_.at(1).index, result.indices);
+  }
+
+  void print(std::ostream& os, bool close_function = true) const final {
+    RecordFunctor::print(os, false);
+    os << ", dim=" << dim_;
+    os << ", descending=" << (descending_ ? "True" : "False");
+    os << ", stable=" << (stable_ ? "True" : "False");
+    if (close_function) {
+      os << ")";
+    }
+  }
+
+  std::pair<serde::RecordData, flatbuffers::Offset<void>> recordData(
+      flatbuffers::FlatBufferBuilder& builder) const final {
+    return {
+        serde::RecordData::Sort,
+        serde::CreateSort(builder, dim_, descending_, stable_).Union()};
+  }
+
+ private:
+  //! Dimension to sort along
+  int64_t dim_;
+  //! Sort in descending order
+  bool descending_;
+  //! Preserve the order of equal elements
+  bool stable_;
+};
+
+//! Specialized Record Functor for the topk op. The second argument is k and
+//! the outputs are the selected values and their indices.
+struct TopKOpRecord : RecordFunctor {
+  TopKOpRecord(
+      std::vector<State> args,
+      std::vector<State> outputs,
+      int64_t dim,
+      bool largest,
+      bool sorted)
+      : RecordFunctor(
+            std::move(args),
+            std::move(outputs),
+            "ops.topk",
+            serde::RecordType::TopKOp),
+        dim_(dim),
+        largest_(largest),
+        sorted_(sorted) {}
+  ~TopKOpRecord() override = default;
+  RecordFunctor* clone() final {
+    return new TopKOpRecord(*this);
+  }
+
+  //! Child specific hash function in lower 32 bits.
+  //! | 31 ---------- 30 | 29 ------ 28 | 27 -----------------------------  0 |
+  //! | largest          | sorted       | dim                                 |
+  size_t hash() const final {
+    auto result = RecordFunctor::hash();
+    return result | (static_cast<size_t>(largest_) << 30) |
+        (static_cast<size_t>(sorted_) << 28) |
+        (static_cast<size_t>(dim_) & 0xfffffff);
+  }
+
+  bool operator==(const RecordFunctor& other) const final {
+    auto result = false;
+    if (auto child_ptr = dynamic_cast<const TopKOpRecord*>(&other)) {
+      result = RecordFunctor::operator==(other);
+      result = result && (dim_ == child_ptr->dim_);
+      result = result && (largest_ == child_ptr->largest_);
+      result = result && (sorted_ == child_ptr->sorted_);
+    }
+    return result;
+  }
+
+  void operator()(FusionState& fd) final {
+    auto arg = fd.getFusionState(args_.at(0).index)->as<TensorView>();
+    auto k = fd.getFusionState(args_.at(1).index);
+    auto result = topk(arg, k, dim_, largest_, sorted_);
+    fd.setFusionState(outputs_.at(0).index, result.values);
+    fd.setFusionState(outputs_.at(1).index, result.indices);
+  }
+
+  void print(std::ostream& os, bool close_function = true) const final {
+    RecordFunctor::print(os, false);
+    os << ", dim=" << dim_;
+    os << ", largest=" << (largest_ ? "True" : "False");
+    os << ", sorted=" << (sorted_ ? "True" : "False");
+    if (close_function) {
+      os << ")";
+    }
+  }
+
+  std::pair<serde::RecordData, flatbuffers::Offset<void>> recordData(
+      flatbuffers::FlatBufferBuilder& builder) const final {
+    return {
+        serde::RecordData::TopK,
+        serde::CreateTopK(builder, dim_, largest_, sorted_).Union()};
+  }
+
+ private:
+  //! Dimension to select along
+  int64_t dim_;
+  //! Select the largest elements instead of the smallest
+  bool largest_;
+  //! Return the selected elements in sorted order
+  bool sorted_;
+};
+
 } // namespace nvfuser::python_frontend
 
 //! Creating the template specialized hash and equal_to functions for a
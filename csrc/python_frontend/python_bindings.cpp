@@ -618,6 +618,7 @@ void defineHeuristicParamBindings(py::module& nvfuser) {
       .PARAM(CompileParams, maxrregcount)
       .PARAM(CompileParams, enable_magic_zero)
       .PARAM(CompileParams, enable_ptxas_verbose)
+      .PARAM(CompileParams, target_blocks_per_sm)
       .TOSTRINGMETHOD(CompileParams);
 
   DEFINECLASS(GemmTile)
@@ -694,7 +695,9 @@ void defineHeuristicParamBindings(py::module& nvfuser) {
       .PARAM(PointwiseParams, flip_grid_binding)
       .PARAM(PointwiseParams, vectorization_factor)
       .PARAM(PointwiseParams, unroll_factor_inner)
-      .PARAM(PointwiseParams, unroll_factor_outer);
+      .PARAM(PointwiseParams, unroll_factor_outer)
+      .PARAM(PointwiseParams, use_tma_load)
+      .PARAM(PointwiseParams, vectorize_lookup);
 
   // Reduction scheduler parameters
   INITHEURISTICPARAMS(ReductionParams)
@@ -727,6 +730,9 @@ void defineHeuristicParamBindings(py::module& nvfuser) {
       .PARAM(ReductionParams, block_dim_outer_reduction)
       .PARAM(ReductionParams, grid_dim_outer_reduction)
       .PARAM(ReductionParams, compute_persistent_buffer_with_first_consumer)
+      .PARAM(ReductionParams, cluster_reduction)
+      .PARAM(ReductionParams, transposed_outer_reduction)
+      .PARAM(ReductionParams, serial_prefetch_depth)
       .PARAM(ReductionParams, static_bdimx)
       .PARAM(ReductionParams, static_bdimy)
       .PARAM(ReductionParams, combined_inner_outer)
@@ -768,6 +774,7 @@ void initNvFuserPythonBindings(PyObject* module) {
       .value("Half", DataType::Half)
       .value("Int", DataType::Int)
       .value("Int32", DataType::Int32)
+      .value("Int8", DataType::Int8)
       .value("Bool", DataType::Bool)
       .value("BFloat16", DataType::BFloat16)
       .value("Float8_e4m3fn", DataType::Float8_e4m3fn)
@@ -824,7 +831,8 @@ void initNvFuserPythonBindings(PyObject* module) {
       .value("outer_persistent", SchedulerType::OuterPersistent)
       .value("transpose", SchedulerType::Transpose)
       .value("expr_eval", SchedulerType::ExprEval)
-      .value("resize", SchedulerType::Resize);
+      .value("resize", SchedulerType::Resize)
+      .value("horizontal", SchedulerType::Horizontal);
 
   nvfuser.def("compute_contiguity", computeContiguity);
   nvfuser.def("compute_tensor_descriptor", computeTensorDescriptor);
@@ -843,6 +851,11 @@ void initNvFuserPythonBindings(PyObject* module) {
           py::arg("load_from_default_workspace") = true,
           py::return_value_policy::reference)
       .def("num_fusions", &FusionCache::numFusions)
+      .def(
+          "set_memory_budget",
+          &FusionCache::setMemoryBudget,
+          py::arg("bytes"))
+      .def("memory_budget", &FusionCache::memoryBudget)
       .def_static(
           "reset", &FusionCache::reset, py::return_value_policy::reference)
       .def(
@@ -859,6 +872,22 @@ void initNvFuserPythonBindings(PyObject* module) {
             self.deserialize(filename);
           },
           py::arg("filename"))
+      .def(
+          "append_to_journal",
+          [](FusionCache& self, std::string filename) {
+            FUSER_PERF_SCOPE("FusionCache.append_to_journal (string)");
+            self.appendToJournal(filename);
+          },
+          py::arg("filename"))
+      .def(
+          "wait_for_journal_writes",
+          [](FusionCache& self) { self.waitForJournalWrites(); })
+      .def_static(
+          "compact_journal",
+          &FusionCache::compactJournal,
+          py::arg("journal_filename"),
+          py::arg("filename"),
+          py::arg("selected_device") = py::none())
       .def(
           "__repr__",
           [](FusionCache& self) {
@@ -955,6 +984,15 @@ void initNvFuserPythonBindings(PyObject* module) {
   kernel_prof.def_property_readonly(
       "scheduler", [](KernelProfile& self) { return self.scheduler; });
 
+  //! Host time spent in a phase of compilation, e.g. a lowering pass
+  py::class_<inst::CompilePhase> compile_phase(nvfuser, "CompilePhase");
+  compile_phase.def_property_readonly(
+      "name", [](inst::CompilePhase& self) { return self.name; });
+  compile_phase.def_property_readonly(
+      "count", [](inst::CompilePhase& self) { return self.count; });
+  compile_phase.def_property_readonly(
+      "time_ms", [](inst::CompilePhase& self) { return self.time_ms; });
+
   //! A fusion profile is generated for FusionDefinition.
   py::class_<FusionProfile> fusion_prof(nvfuser, "FusionProfile");
   fusion_prof.def_property_readonly(
@@ -987,6 +1025,9 @@ void initNvFuserPythonBindings(PyObject* module) {
   fusion_prof.def_property_readonly("kernel_profiles", [](FusionProfile& self) {
     return self.kernel_profiles;
   });
+  fusion_prof.def_property_readonly("compile_phases", [](FusionProfile& self) {
+    return self.compile_phases;
+  });
 
   //! These are the FusionDefinition supported object types that are either
   //! defined as inputs or the output of an operation.
@@ -1049,6 +1090,15 @@ void initNvFuserPythonBindings(PyObject* module) {
   vector_class.def(pybind11::self == pybind11::self);
   vector_class.def(pybind11::self != pybind11::self);
 
+  //! Outputs of FusionDefinition.execute_async. Waiting for them releases the
+  //! GIL so the fusion can be compiled while other Python threads run.
+  py::class_<FusionFuture> fusion_future(nvfuser, "FusionFuture");
+  fusion_future.def("done", &FusionFuture::done)
+      .def(
+          "result",
+          &FusionFuture::result,
+          py::call_guard<py::gil_scoped_release>());
+
   //! The FusionDefinition is a context manager in Python where the user will
   //! define the set the operations and connections between operations for
   //! nvFuser to create.
@@ -1174,7 +1224,9 @@ void initNvFuserPythonBindings(PyObject* module) {
              bool capture_debug_output,
              bool profile,
              std::vector<std::string> _enable_options,
-             std::vector<std::string> _disable_options) {
+             std::vector<std::string> _disable_options,
+             std::optional<std::vector<std::optional<at::Tensor>>>
+                 maybe_outputs) {
             std::vector<c10::IValue> inputs;
             for (py::handle obj : iter) {
               // Allows for a Vector of Sizes to be inputed as a list/tuple
@@ -1194,6 +1246,13 @@ void initNvFuserPythonBindings(PyObject* module) {
               NVF_CHECK(device.value() < 256, "Maximum device index is 255");
               int8_device = (int8_t)device.value();
             }
+            // None stands for an output to allocate
+            std::vector<at::Tensor> outputs;
+            if (maybe_outputs.has_value()) {
+              for (const auto& output : maybe_outputs.value()) {
+                outputs.push_back(output.value_or(at::Tensor()));
+              }
+            }
             return self.execute(
                 inputs,
                 int8_device,
@@ -1201,7 +1260,8 @@ void initNvFuserPythonBindings(PyObject* module) {
                 capture_debug_output,
                 profile,
                 _enable_options,
-                _disable_options);
+                _disable_options,
+                outputs);
           },
           py::arg("inputs"),
           py::kw_only(),
@@ -1211,7 +1271,115 @@ void initNvFuserPythonBindings(PyObject* module) {
           py::arg("profile") = false,
           py::arg("_enable_options") = py::none(),
           py::arg("_disable_options") = py::none(),
+          py::arg("outputs") = py::none(),
           py::return_value_policy::reference)
+      .def_static(
+          "_execute_by_id",
+          [](size_t fusion_id,
+             const py::iterable& iter,
+             std::optional<int64_t> device,
+             bool override_user_schedule,
+             bool profile) {
+            std::vector<c10::IValue> inputs;
+            for (py::handle obj : iter) {
+              // Allows for a Vector of Sizes to be inputed as a list/tuple
+              if (py::isinstance<py::list>(obj) ||
+                  py::isinstance<py::tuple>(obj)) {
+                for (py::handle item : obj) {
+                  inputs.push_back(
+                      torch::jit::toIValue(item, c10::AnyType::get()));
+                }
+              } else {
+                inputs.push_back(
+                    torch::jit::toIValue(obj, c10::AnyType::get()));
+              }
+            }
+            std::optional<int8_t> int8_device = std::nullopt;
+            if (device.has_value()) {
+              NVF_CHECK(device.value() < 256, "Maximum device index is 255");
+              int8_device = (int8_t)device.value();
+            }
+            return FusionDefinition::executeById(
+                fusion_id,
+                inputs,
+                int8_device,
+                override_user_schedule,
+                profile);
+          },
+          py::arg("fusion_id"),
+          py::arg("inputs"),
+          py::kw_only(),
+          py::arg("device") = py::none(),
+          py::arg("override_user_schedule") = false,
+          py::arg("profile") = false,
+          py::return_value_policy::reference)
+      .def_static(
+          "_execute_batch",
+          [](const py::iterable& fusions, std::optional<int64_t> device) {
+            // All the arguments are converted before any fusion runs, so
+            // that a bad argument doesn't leave the batch half executed
+            std::vector<std::pair<size_t, std::vector<c10::IValue>>> batch;
+            for (py::handle fusion : fusions) {
+              auto [fusion_id, iter] =
+                  py::cast<std::pair<size_t, py::iterable>>(fusion);
+              std::vector<c10::IValue> inputs;
+              for (py::handle obj : iter) {
+                // Allows for a Vector of Sizes to be inputed as a list/tuple
+                if (py::isinstance<py::list>(obj) ||
+                    py::isinstance<py::tuple>(obj)) {
+                  for (py::handle item : obj) {
+                    inputs.push_back(
+                        torch::jit::toIValue(item, c10::AnyType::get()));
+                  }
+                } else {
+                  inputs.push_back(
+                      torch::jit::toIValue(obj, c10::AnyType::get()));
+                }
+              }
+              batch.emplace_back(fusion_id, std::move(inputs));
+            }
+            std::optional<int8_t> int8_device = std::nullopt;
+            if (device.has_value()) {
+              NVF_CHECK(device.value() < 256, "Maximum device index is 255");
+              int8_device = (int8_t)device.value();
+            }
+            return FusionDefinition::executeBatch(batch, int8_device);
+          },
+          py::arg("fusions"),
+          py::kw_only(),
+          py::arg("device") = py::none(),
+          py::return_value_policy::reference)
+      .def_static(
+          "_execute_async",
+          [](size_t fusion_id,
+             const py::iterable& iter,
+             std::optional<int64_t> device) {
+            std::vector<c10::IValue> inputs;
+            for (py::handle obj : iter) {
+              // Allows for a Vector of Sizes to be inputed as a list/tuple
+              if (py::isinstance<py::list>(obj) ||
+                  py::isinstance<py::tuple>(obj)) {
+                for (py::handle item : obj) {
+                  inputs.push_back(
+                      torch::jit::toIValue(item, c10::AnyType::get()));
+                }
+              } else {
+                inputs.push_back(
+                    torch::jit::toIValue(obj, c10::AnyType::get()));
+              }
+            }
+            std::optional<int8_t> int8_device = std::nullopt;
+            if (device.has_value()) {
+              NVF_CHECK(device.value() < 256, "Maximum device index is 255");
+              int8_device = (int8_t)device.value();
+            }
+            return FusionDefinition::executeAsync(
+                fusion_id, std::move(inputs), int8_device);
+          },
+          py::arg("fusion_id"),
+          py::arg("inputs"),
+          py::kw_only(),
+          py::arg("device") = py::none())
       .def_static(
           "_profile",
           &FusionProfiler::profile,
@@ -1228,6 +1396,25 @@ void initNvFuserPythonBindings(PyObject* module) {
           "_user_schedule_ir",
           [](FusionDefinition& self) { return self.userScheduleIr(); },
           py::return_value_policy::reference)
+      .def(
+          "_runtime_cache_stats",
+          [](FusionDefinition& self) { return self.runtimeCacheStats(); })
+      .def(
+          "_set_async_compilation",
+          [](FusionDefinition& self, bool enabled) {
+            self.setAsyncCompilation(enabled);
+          },
+          py::arg("enabled"))
+      .def(
+          "_set_shape_bucket_policy",
+          [](FusionDefinition& self,
+             const std::vector<std::pair<int64_t, int64_t>>& input_dims) {
+            self.setShapeBucketPolicy(input_dims);
+          },
+          py::arg("input_dims"))
+      .def(
+          "_clear_shape_bucket_policy",
+          [](FusionDefinition& self) { self.clearShapeBucketPolicy(); })
       .def(
           "_last_cuda_code",
           [](FusionDefinition& self,
@@ -3621,6 +3808,62 @@ void initNvFuserPythonBindings(PyObject* module) {
       py::arg("scale").none(true) = py::none(),
       py::return_value_policy::reference);
 
+  nvf_ops.def(
+      "sort",
+      [](FusionDefinition::Operators& self,
+         Tensor arg,
+         int64_t dim,
+         bool descending,
+         bool stable) -> decltype(auto) {
+        FUSER_PERF_SCOPE("Operators.sort");
+        NVF_CHECK(
+            self.validUse(), "Attempting to add to a completed definition!");
+        FusionDefinition* fd = self.fusion_definition;
+        Tensor values = fd->defineTensor(arg.dims);
+        Tensor indices = fd->defineTensor(arg.dims);
+        fd->defineRecord(new SortOpRecord(
+            {fd->recordingState(arg())},
+            {fd->recordingState(values()), fd->recordingState(indices())},
+            dim,
+            descending,
+            stable));
+        return std::make_tuple(values, indices);
+      },
+      py::arg("arg"),
+      py::arg("dim") = -1,
+      py::arg("descending") = false,
+      py::arg("stable") = false,
+      py::return_value_policy::reference);
+
+  nvf_ops.def(
+      "topk",
+      [](FusionDefinition::Operators& self,
+         Tensor arg,
+         Scalar k,
+         int64_t dim,
+         bool largest,
+         bool sorted) -> decltype(auto) {
+        FUSER_PERF_SCOPE("Operators.topk");
+        NVF_CHECK(
+            self.validUse(), "Attempting to add to a completed definition!");
+        FusionDefinition* fd = self.fusion_definition;
+        Tensor values = fd->defineTensor(arg.dims);
+        Tensor indices = fd->defineTensor(arg.dims);
+        fd->defineRecord(new TopKOpRecord(
+            {fd->recordingState(arg()), fd->recordingState(k())},
+            {fd->recordingState(values()), fd->recordingState(indices())},
+            dim,
+            largest,
+            sorted));
+        return std::make_tuple(values, indices);
+      },
+      py::arg("arg"),
+      py::arg("k"),
+      py::arg("dim") = -1,
+      py::arg("largest") = true,
+      py::arg("sorted") = true,
+      py::return_value_policy::reference);
+
   bindSchedule(fusion_def);
 
   bindCommunicator(nvfuser);
@@ -273,6 +273,10 @@ class FusionTranslator : public OptInConstDispatch {
           break;
         }
         case AllocationType::ReuseBuffer: {
+          NVF_CHECK(
+              alias_info.slice_offset == nullptr,
+              "Outputs written in place of a slice of an input can't be "
+              "translated to a FusionDefinition");
           size_t num_visited = visited_alias_output.count(v);
           if (num_visited == 0) {
             visited_alias_output.insert(v);
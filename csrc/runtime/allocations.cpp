@@ -13,6 +13,7 @@
 #include <polymorphic_value.h>
 #include <runtime/executor_kernel_arg.h>
 #include <runtime/executor_utils.h>
+#include <scalar_value.h>
 #include <tensor_metadata.h>
 
 namespace nvfuser {
@@ -86,7 +87,7 @@ int64_t computeSharedMemory(
           smem_alloc->buffer()->name(),
           " should be int64 but found ",
           address_val);
-      const auto size_val = expr_eval.evaluate(smem_alloc->size());
+      const ScalarValue size_val = expr_eval.evaluateScalar(smem_alloc->size());
       NVF_ERROR(
           size_val.hasValue(),
           "Failed to evaluate the size ",
@@ -157,7 +158,7 @@ std::pair<std::vector<int64_t>, std::vector<int64_t>> inferShape(
 
   for (const auto i : c10::irange(symbolic_sizes.size())) {
     auto symbolic_size = symbolic_sizes.at(i);
-    const auto inferred_val = expr_eval.evaluate(symbolic_size);
+    const ScalarValue inferred_val = expr_eval.evaluateScalar(symbolic_size);
     NVF_ERROR(
         inferred_val.hasValue(),
         "Could not launch kernel as program could not infer ",
@@ -243,6 +244,42 @@ void fillTensorWithNan(at::Tensor& t) {
   }
 }
 
+namespace {
+at::Tensor allocateNewTensor(
+    const GlobalBufferInfo& out_info,
+    const c10::Device& device) {
+  auto alloc_tensor = at::native::empty_strided_cuda(
+      out_info.sizes,
+      out_info.strides,
+      out_info.type,
+      c10::nullopt,
+      device,
+      c10::nullopt);
+  if (shouldFillAllocationWithNan()) {
+    fillTensorWithNan(alloc_tensor);
+  }
+  return alloc_tensor;
+}
+} // namespace
+
+at::Tensor sliceOfAliasedTensor(
+    const at::Tensor& aliased_tensor,
+    int64_t axis,
+    int64_t offset,
+    int64_t size) {
+  NVF_CHECK(
+      offset >= 0 && offset + size <= aliased_tensor.size(axis),
+      "The slice [",
+      offset,
+      ", ",
+      offset + size,
+      ") written in place is out of the bounds of axis ",
+      axis,
+      " of the aliased tensor, of size ",
+      aliased_tensor.size(axis));
+  return aliased_tensor.slice(axis, offset, offset + size);
+}
+
 at::Tensor allocateTensor(
     const GlobalBufferInfo& out_info,
     const AliasInfo& alias_info,
@@ -273,25 +310,24 @@ at::Tensor allocateTensor(
   }
 
   switch (alias_info.type) {
-    case AllocationType::New: {
-      auto alloc_tensor = at::native::empty_strided_cuda(
-          out_info.sizes,
-          out_info.strides,
-          out_info.type,
-          c10::nullopt,
-          device,
-          c10::nullopt);
-      if (shouldFillAllocationWithNan()) {
-        fillTensorWithNan(alloc_tensor);
-      }
-      return alloc_tensor;
-    }
+    case AllocationType::New:
+      return allocateNewTensor(out_info, device);
     case AllocationType::ReuseBuffer:
       // Unlike for `AllocationType::Evaluate`, don't use
       // ExpressionEvaluator to compute the output tensor. This is because
       // the output tensor may hold different data from the input, e.g., an
       // updated running mean.  `ExpressionEvaluator::evaluate(out_tv)`
       // would trigger non-trivial host computation.
+      if (Val* offset = alias_info.slice_offset) {
+        IterDomain* sliced_id = TensorDomain::noReductions(
+                                    out_tv->getLogicalDomain())
+                                    .at(alias_info.slice_axis);
+        return sliceOfAliasedTensor(
+            aliased_io_tensor.value(),
+            alias_info.slice_axis,
+            ee.evaluate(offset).as<int64_t>(),
+            ee.evaluate(sliced_id->extent()).as<int64_t>());
+      }
       return aliased_io_tensor.value();
     case AllocationType::Evaluate: {
       auto out_tensor = ee.evaluate(out_tv).as<at::Tensor>();
@@ -363,6 +399,79 @@ std::vector<at::Tensor> allocateOutputs(
   return out_tensors;
 }
 
+bool outputsAreNewBuffers(const Fusion* fusion) {
+  std::unordered_set<Val*> seen_outputs;
+  for (Val* out : fusion->outputs()) {
+    if (fusion->getOutputAlias(out).type != AllocationType::New ||
+        out->isFusionInput() || !seen_outputs.insert(out).second) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<at::Tensor> allocateNewOutputs(
+    const std::vector<GlobalBufferInfo>& output_info,
+    const c10::Device& device,
+    std::vector<at::Tensor> outputs) {
+  FUSER_PERF_SCOPE("fusion_executor::allocations::allocateNewOutputs");
+  if (outputs.empty()) {
+    outputs.resize(output_info.size());
+  }
+  NVF_ERROR(outputs.size() == output_info.size());
+  for (const auto i : c10::irange(output_info.size())) {
+    if (!outputs[i].defined()) {
+      outputs[i] = allocateNewTensor(output_info[i], device);
+    }
+  }
+  return outputs;
+}
+
+void validateProvidedOutputs(
+    const std::vector<GlobalBufferInfo>& output_info,
+    const std::vector<at::Tensor>& outputs,
+    const c10::Device& device) {
+  FUSER_PERF_SCOPE("fusion_executor::allocations::validateProvidedOutputs");
+  NVF_CHECK(
+      outputs.size() == output_info.size(),
+      "Expected ",
+      output_info.size(),
+      " output buffers but got ",
+      outputs.size());
+  for (const auto i : c10::irange(outputs.size())) {
+    const at::Tensor& output = outputs[i];
+    if (!output.defined()) {
+      continue;
+    }
+    const GlobalBufferInfo& out_info = output_info[i];
+    NVF_CHECK(
+        output.device() == device,
+        "Output buffer ",
+        i,
+        " is expected on ",
+        device,
+        " but is on ",
+        output.device());
+    NVF_CHECK(
+        output.scalar_type() == out_info.type,
+        "Output buffer ",
+        i,
+        " is expected to be of type ",
+        out_info.type,
+        " but is of type ",
+        output.scalar_type());
+    const c10::IntArrayRef expected_sizes(out_info.sizes);
+    NVF_CHECK(
+        output.sizes() == expected_sizes,
+        "Output buffer ",
+        i,
+        " is expected to be of sizes ",
+        expected_sizes,
+        " but is of sizes ",
+        output.sizes());
+  }
+}
+
 namespace {
 GlobalBufferInfo getBufferInfo(
     ExpressionEvaluator& expr_eval,
@@ -61,6 +61,14 @@ std::pair<std::vector<int64_t>, std::vector<int64_t>> inferShapeOfOutput(
     TensorView* tv,
     ExpressionEvaluator& expr_eval);
 
+// Returns the slice of `aliased_tensor` that an output aliased by
+// Fusion::aliasOutputToInputSlice is written to
+at::Tensor sliceOfAliasedTensor(
+    const at::Tensor& aliased_tensor,
+    int64_t axis,
+    int64_t offset,
+    int64_t size);
+
 // Allocate an `at::Tensor` for `out_info` or compute it as an alias.
 at::Tensor allocateTensor(
     const GlobalBufferInfo& out_info,
@@ -76,6 +84,28 @@ std::vector<at::Tensor> allocateOutputs(
     const c10::Device& device,
     ExpressionEvaluator& ee);
 
+// Returns true if every output of the fusion is a new buffer, i.e., not an
+// alias of an input or another output and not a duplicated output. Then
+// allocateNewOutputs can allocate the outputs without evaluating anything.
+bool outputsAreNewBuffers(const Fusion* fusion);
+
+// Allocate the output tensors described by output_info, which must all be new
+// buffers. See outputsAreNewBuffers. The defined tensors of `outputs`, e.g.,
+// buffers provided by the caller, are kept instead of being allocated.
+std::vector<at::Tensor> allocateNewOutputs(
+    const std::vector<GlobalBufferInfo>& output_info,
+    const c10::Device& device,
+    std::vector<at::Tensor> outputs = {});
+
+// Check that the output buffers provided by the caller match the sizes and
+// dtypes in output_info and are on the given device. Undefined buffers are
+// allocated later and are skipped. Strides are validated against the
+// contiguity of the outputs when they are bound as kernel arguments.
+void validateProvidedOutputs(
+    const std::vector<GlobalBufferInfo>& output_info,
+    const std::vector<at::Tensor>& outputs,
+    const c10::Device& device);
+
 //! Return information necessary for allocating output tensors. Input
 //! and output tensors are allowed to alias each other, which is
 //! specified by the list of int pairs of input and output indices
@@ -0,0 +1,222 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <runtime/compile_thread_pool.h>
+
+#include <exceptions.h>
+#include <utils.h>
+
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace nvfuser {
+
+namespace {
+
+constexpr size_t kNumPriorities = (size_t)CompilePriority::Speculative + 1;
+
+thread_local std::optional<CompilePriority> current_priority;
+
+// Sets the priority of the calling thread for the duration of a task
+class PriorityGuard {
+ public:
+  explicit PriorityGuard(CompilePriority priority)
+      : saved_(std::exchange(current_priority, priority)) {}
+  ~PriorityGuard() {
+    current_priority = saved_;
+  }
+
+ private:
+  std::optional<CompilePriority> saved_;
+};
+
+// The queues hold one reference to a group per task submitted to it. The group
+// itself holds the tasks, so that the thread waiting for a group can steal
+// them, and so that cancelling a group drops its tasks from every queue at
+// once. A worker popping a group whose tasks are gone simply moves on.
+class CompileThreadPool {
+ public:
+  static CompileThreadPool& get() {
+    static CompileThreadPool pool;
+    return pool;
+  }
+
+  ~CompileThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  void push(std::shared_ptr<CompileTaskGroup::State> group) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queues_.at((size_t)group->priority).push_back(std::move(group));
+    ++num_queued_;
+    // Workers are started lazily, so that processes that never compile in
+    // parallel don't hold idle threads. Woken up workers count as idle until
+    // they pop a task, so each queued task beyond the idle workers asks for a
+    // new one.
+    if (num_queued_ > num_idle_ &&
+        (int64_t)workers_.size() < maxCompileThreads()) {
+      workers_.emplace_back([this]() { work(); });
+    } else {
+      work_cv_.notify_one();
+    }
+  }
+
+ private:
+  CompileThreadPool() = default;
+
+  bool hasWork() const {
+    return std::any_of(queues_.begin(), queues_.end(), [](const auto& queue) {
+      return !queue.empty();
+    });
+  }
+
+  void work() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      ++num_idle_;
+      work_cv_.wait(lock, [this]() { return stop_ || hasWork(); });
+      --num_idle_;
+      if (stop_) {
+        return;
+      }
+      auto queue = std::find_if(
+          queues_.begin(), queues_.end(), [](const auto& queue) {
+            return !queue.empty();
+          });
+      std::shared_ptr<CompileTaskGroup::State> group =
+          std::move(queue->front());
+      queue->pop_front();
+      --num_queued_;
+      lock.unlock();
+      {
+        PriorityGuard guard(group->priority);
+        group->runOne();
+      }
+      group.reset();
+      lock.lock();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::array<std::deque<std::shared_ptr<CompileTaskGroup::State>>,
+             kNumPriorities>
+      queues_;
+  std::vector<std::thread> workers_;
+  int64_t num_queued_ = 0;
+  int64_t num_idle_ = 0;
+  bool stop_ = false;
+};
+
+} // namespace
+
+int64_t maxCompileThreads() {
+  static const int64_t max_threads = []() {
+    const auto num_cores =
+        std::max((int64_t)std::thread::hardware_concurrency(), (int64_t)1);
+    return std::min((int64_t)getNumThreads(), num_cores);
+  }();
+  return max_threads;
+}
+
+bool CompileTaskGroup::State::runOne() {
+  std::function<void()> task;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (pending.empty()) {
+      return false;
+    }
+    task = std::move(pending.front());
+    pending.pop_front();
+    ++num_running;
+  }
+
+  std::exception_ptr task_error;
+  try {
+    task();
+  } catch (...) {
+    task_error = std::current_exception();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (task_error != nullptr && error == nullptr) {
+    error = task_error;
+  }
+  --num_running;
+  done_cv.notify_all();
+  return true;
+}
+
+CompileTaskGroup::CompileTaskGroup(CompilePriority priority)
+    : state_(std::make_shared<State>(priority)) {}
+
+CompileTaskGroup::~CompileTaskGroup() {
+  // Errors are only reported by an explicit wait()
+  try {
+    wait();
+  } catch (...) {
+  }
+}
+
+void CompileTaskGroup::run(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    NVF_ERROR(!state_->cancelled, "Cannot add a task to a cancelled group");
+    state_->pending.push_back(std::move(task));
+  }
+  // Wakes up a waiter so that it steals the task
+  state_->done_cv.notify_all();
+  CompileThreadPool::get().push(state_);
+}
+
+void CompileTaskGroup::wait() {
+  // The stolen tasks run at the more urgent of the priorities of the waiter
+  // and of the group, so that the work they submit isn't queued behind
+  // less urgent work
+  PriorityGuard guard(std::min(currentPriority(), state_->priority));
+  while (true) {
+    while (state_->runOne()) {
+    }
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->done_cv.wait(lock, [this]() {
+      return state_->num_running == 0 || !state_->pending.empty();
+    });
+    if (state_->pending.empty()) {
+      if (state_->error != nullptr) {
+        std::rethrow_exception(std::exchange(state_->error, nullptr));
+      }
+      return;
+    }
+  }
+}
+
+void CompileTaskGroup::cancel() {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  state_->cancelled = true;
+  state_->pending.clear();
+}
+
+CompilePriority CompileTaskGroup::priority() const {
+  return state_->priority;
+}
+
+CompilePriority CompileTaskGroup::currentPriority() {
+  return current_priority.value_or(CompilePriority::Blocking);
+}
+
+} // namespace nvfuser
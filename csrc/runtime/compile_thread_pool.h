@@ -0,0 +1,105 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include <visibility.h>
+
+namespace nvfuser {
+
+//! Priorities of the compilation tasks, from the most urgent to the least
+//! urgent. A worker always picks the oldest queued task of the most urgent
+//! priority.
+enum class CompilePriority {
+  //! A caller is blocked until the task finishes, e.g., the first run of a
+  //! fusion without an asynchronous fallback
+  Blocking,
+  //! Requests are served by a fallback meanwhile, e.g., compileFusionAsync
+  Background,
+  //! Nothing waits for the result yet, e.g., ahead-of-time compilation
+  Speculative,
+};
+
+//! A set of tasks submitted to the compilation thread pool together, e.g.,
+//! the segments of a fusion. Unlike waiting on the whole pool, wait() only
+//! waits for the tasks of this group, so a blocking compilation never waits
+//! behind speculative work of other fusions. While waiting, the calling thread
+//! steals and runs the queued tasks of the group itself, which also makes it
+//! safe to wait for a group from within a task of the pool.
+//!
+//! Groups are cheap to create and may outlive the owner of their tasks, so
+//! tasks must not be added after the group is cancelled or destroyed.
+class CompileTaskGroup {
+ public:
+  //! The priority defaults to that of the task running on the calling thread,
+  //! so that nested work, e.g., the parallel analyses of a lowering, is not
+  //! more urgent than the compilation it belongs to
+  NVF_API explicit CompileTaskGroup(
+      CompilePriority priority = currentPriority());
+
+  //! Waits for the tasks of the group
+  NVF_API ~CompileTaskGroup();
+
+  CompileTaskGroup(const CompileTaskGroup&) = delete;
+  CompileTaskGroup& operator=(const CompileTaskGroup&) = delete;
+
+  NVF_API void run(std::function<void()> task);
+
+  //! Runs the queued tasks of the group on the calling thread and waits for
+  //! those started by the pool. Rethrows the first exception a task threw.
+  NVF_API void wait();
+
+  //! Drops the queued tasks of the group, e.g., when their result became
+  //! obsolete. Tasks that already started run to completion.
+  NVF_API void cancel();
+
+  CompilePriority priority() const;
+
+  //! Priority of the task running on the calling thread, or Blocking outside
+  //! of the pool
+  NVF_API static CompilePriority currentPriority();
+
+  struct State;
+
+ private:
+  std::shared_ptr<State> state_;
+};
+
+//! Shared state of a CompileTaskGroup, referenced by the pool while any of its
+//! tasks are queued
+struct CompileTaskGroup::State {
+  explicit State(CompilePriority priority) : priority(priority) {}
+
+  //! Pops and runs a queued task. Returns false if none is left.
+  bool runOne();
+
+  const CompilePriority priority;
+  std::mutex mutex;
+  std::condition_variable done_cv;
+  //! Tasks not started yet
+  std::deque<std::function<void()>> pending;
+  //! Tasks started and not finished yet
+  int64_t num_running = 0;
+  bool cancelled = false;
+  std::exception_ptr error;
+};
+
+//! Number of worker threads of the compilation thread pool. Workers are
+//! started on demand up to this number, which is the smaller of the number of
+//! cores and NVFUSER_NUM_THREADS, 8 by default.
+NVF_API int64_t maxCompileThreads();
+
+} // namespace nvfuser
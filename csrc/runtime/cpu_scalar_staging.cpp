@@ -0,0 +1,113 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <runtime/cpu_scalar_staging.h>
+
+#include <ATen/ops/empty.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <c10/cuda/CUDAStream.h>
+
+#include <cstddef>
+#include <cstring>
+
+#include <cuda_utils.h>
+#include <exceptions.h>
+#include <instrumentation.h>
+#include <utils.h>
+
+namespace nvfuser {
+
+namespace {
+
+// Large enough and aligned for every scalar type, including complex double
+constexpr int64_t kBytesPerScalar = 16;
+
+} // namespace
+
+CpuScalarStaging::CpuScalarStaging(std::vector<int64_t> input_indices)
+    : input_indices_(std::move(input_indices)) {}
+
+CpuScalarStaging::~CpuScalarStaging() {
+  // Errors can't be thrown from a destructor, and they are not actionable at
+  // this point anyway
+  for (Slot& slot : slots_) {
+    if (slot.copied != nullptr) {
+      cudaEventDestroy(slot.copied);
+    }
+  }
+}
+
+void CpuScalarStaging::stage(KernelArgumentHolder& args) {
+  FUSER_PERF_SCOPE("CpuScalarStaging::stage");
+  std::vector<int64_t> staged_indices;
+  for (int64_t index : input_indices_) {
+    const PolymorphicValue& arg = *args[index];
+    if (arg.is<at::Tensor>() && is_cpu_scalar(arg.as<at::Tensor>())) {
+      staged_indices.push_back(index);
+    }
+  }
+  if (staged_indices.empty()) {
+    return;
+  }
+  const int64_t num_bytes = (int64_t)staged_indices.size() * kBytesPerScalar;
+
+  const auto device_index = (c10::DeviceIndex)args.getDeviceIndex();
+  c10::cuda::CUDAGuard device_guard(device_index);
+  cudaStream_t stream = c10::cuda::getCurrentCUDAStream(device_index).stream();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  Slot& slot = slots_.at(next_slot_);
+  next_slot_ = (next_slot_ + 1) % kNumSlots;
+  if (slot.copied == nullptr) {
+    NVFUSER_CUDA_RT_SAFE_CALL(
+        cudaEventCreateWithFlags(&slot.copied, cudaEventDisableTiming));
+  } else {
+    // The copy kNumSlots runs ago is normally long done
+    NVFUSER_CUDA_RT_SAFE_CALL(cudaEventSynchronize(slot.copied));
+  }
+  if (!slot.host.defined() || slot.host.numel() < num_bytes) {
+    slot.host = at::empty(
+        {num_bytes},
+        at::TensorOptions().dtype(at::kByte).pinned_memory(true));
+  }
+
+  auto* host_data = static_cast<std::byte*>(slot.host.data_ptr());
+  for (auto i : c10::irange(staged_indices.size())) {
+    const auto& scalar = args[staged_indices[i]]->as<at::Tensor>();
+    std::memcpy(
+        host_data + (int64_t)i * kBytesPerScalar,
+        scalar.data_ptr(),
+        scalar.element_size());
+  }
+  // The caching allocator only hands a freed block out to work enqueued later
+  // on the same stream, so the kernels reading it are safe
+  at::Tensor block = at::empty(
+      {num_bytes},
+      at::TensorOptions().dtype(at::kByte).device(at::kCUDA, device_index));
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaMemcpyAsync(
+      block.data_ptr(),
+      host_data,
+      num_bytes,
+      cudaMemcpyHostToDevice,
+      stream));
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaEventRecord(slot.copied, stream));
+
+  for (auto i : c10::irange(staged_indices.size())) {
+    PolymorphicValue* arg = args[staged_indices[i]];
+    const auto& scalar = arg->as<at::Tensor>();
+    at::Tensor staged = block
+                            .narrow(
+                                /*dim=*/0,
+                                (int64_t)i * kBytesPerScalar,
+                                (int64_t)scalar.element_size())
+                            .view(scalar.scalar_type())
+                            .reshape({});
+    *arg = std::move(staged);
+  }
+}
+
+} // namespace nvfuser
@@ -0,0 +1,66 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <ATen/core/Tensor.h>
+#include <cuda_runtime.h>
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <runtime/executor_kernel_arg.h>
+
+namespace nvfuser {
+
+//! Moves the CPU scalar tensor arguments of a fusion, e.g., the step count or
+//! the learning rate of an optimizer, to the device of the other arguments.
+//! The scalars of a run are packed into a slot of a ring of pinned host
+//! buffers and copied with a single asynchronous H2D copy into a device
+//! argument block, ordered on the current stream. Unlike copies from pageable
+//! memory, this never synchronizes with the host, and unlike scalars passed
+//! by value, the kernels read them from device memory, so that the run can
+//! be captured into and replayed from a CUDA graph.
+//!
+//! The host only waits when a slot is reused while its previous copy is
+//! still queued, i.e., when it runs kNumSlots fusions ahead of the device.
+class CpuScalarStaging {
+ public:
+  static constexpr int64_t kNumSlots = 8;
+
+  //! input_indices are the positions of the CPU scalar inputs in the
+  //! arguments
+  explicit CpuScalarStaging(std::vector<int64_t> input_indices);
+  ~CpuScalarStaging();
+
+  CpuScalarStaging(const CpuScalarStaging&) = delete;
+  CpuScalarStaging& operator=(const CpuScalarStaging&) = delete;
+
+  //! Replaces the CPU scalar tensors of args with 0-dim tensors in the
+  //! device argument block. Other arguments, e.g., a scalar already given on
+  //! the device, are left alone.
+  void stage(KernelArgumentHolder& args);
+
+ private:
+  struct Slot {
+    //! Pinned host buffer
+    at::Tensor host;
+    //! Recorded after the copy out of host, which can be overwritten once
+    //! it completes
+    cudaEvent_t copied = nullptr;
+  };
+
+  const std::vector<int64_t> input_indices_;
+  //! fusion executor caches may be run by several threads
+  std::mutex mutex_;
+  std::array<Slot, kNumSlots> slots_;
+  int64_t next_slot_ = 0;
+};
+
+} // namespace nvfuser
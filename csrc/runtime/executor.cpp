@@ -18,7 +18,9 @@
 #include <ir/all_nodes.h>
 #include <ir/graphviz.h>
 #include <ir/utils.h>
+#include <id_model/indexing.h>
 #include <iter_visitor.h>
+#include <kernel_db/utils.h>
 #include <kernel_ir.h>
 #include <options.h>
 #include <polymorphic_value.h>
@@ -29,6 +31,7 @@
 #include <tensor_metadata.h>
 #include <utils.h>
 
+#include <ATen/EmptyTensor.h>
 #include <ATen/core/LegacyTypeDispatch.h>
 #include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/llvm_jit_strings.h>
@@ -38,9 +41,11 @@
 #include <c10/cuda/CUDAStream.h>
 #include <c10/util/irange.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <fstream>
+#include <limits>
 
 namespace nvfuser {
 
@@ -133,6 +138,24 @@ std::string getStructuredCodeFromExternalFiles(const int64_t fusion_id) {
   buffer << cuda_src.rdbuf();
   return buffer.str();
 }
+
+// Sub-tensor indexing passes the sizes and strides of tensors as
+// 32-bit integers, so each of them needs to fit
+bool tensorArgsFitInInt32(const KernelArgumentHolder& args) {
+  constexpr int64_t max_int32 = std::numeric_limits<int32_t>::max();
+  for (const auto i : c10::irange(args.size())) {
+    if (!args[i]->is<at::Tensor>()) {
+      continue;
+    }
+    const auto& tensor = args[i]->as<at::Tensor>();
+    for (const auto dim : c10::irange(tensor.dim())) {
+      if (tensor.size(dim) > max_int32 || tensor.stride(dim) > max_int32) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
 } // namespace
 
 std::unique_ptr<PrecomputedValues>& KernelExecutor::
@@ -150,8 +173,15 @@ std::string KernelExecutor::getStructuredCode(
   // generating cuda code;
   std::string code = "";
   code += includeStdComplex();
+  // The precompiled preamble is shared by all kernels, so it has to be the
+  // full one
+  const bool minimal_preamble =
+      isOptionEnabled(EnableOption::MinimalPreamble) &&
+      !isOptionEnabled(EnableOption::PrecompiledPreamble);
   code += std::string("namespace {\n") + defineTypes() +
-      defineIndexType(index_type) + executor_utils::kernelPreamble() +
+      defineIndexType(index_type) +
+      (minimal_preamble ? executor_utils::kernelPreamble(kernel_str)
+                        : executor_utils::kernelPreamble()) +
       kernel_str + "}\n";
 
   if (isDebugDumpEnabled(DebugDumpOption::CudaKernel)) {
@@ -175,6 +205,16 @@ std::string KernelExecutor::getStructuredCode(
   return code;
 }
 
+int64_t KernelExecutor::approximateBytes() const {
+  auto bytes = static_cast<int64_t>(kernel_code_.size());
+  if (compiled_kernel_ != nullptr) {
+    bytes += static_cast<int64_t>(
+        compiled_kernel_->ptx.size() + compiled_kernel_->cubin.size() +
+        compiled_kernel_->compile_log.size());
+  }
+  return bytes;
+}
+
 std::string KernelExecutor::getStructuredCode() const {
   return getStructuredCode(kernelString(), kernel()->indexType());
 }
@@ -196,11 +236,110 @@ void ExprEvalExecutor::compile(Fusion* fusion) {
       supported(fusion),
       "ExprEvalExecutor does not support the Fusion provided.");
   fusion_ = std::make_unique<Fusion>(*fusion);
+
+  // Build the execution plan: every expr producing tensors, in topological
+  // order, with the workspace slots of their tensor inputs and outputs
+  std::unordered_map<Val*, int64_t> slots;
+  auto get_slot = [&](Val* val) -> int64_t {
+    if (!val->isA<TensorView>()) {
+      return -1;
+    }
+    auto [it, inserted] = slots.try_emplace(val, num_slots_);
+    if (inserted) {
+      num_slots_++;
+    }
+    return it->second;
+  };
+  for (Val* in : fusion_->inputs()) {
+    input_slots_.push_back(get_slot(in));
+  }
+  for (Expr* expr : StmtSort::getExprsTo(fusion_->outputs())) {
+    if (ir_utils::filterByType<TensorView>(expr->outputs()).empty()) {
+      continue;
+    }
+    // CatOp evaluates the inputs of its PadOps directly, so the PadOps are
+    // only evaluated if something else uses them
+    if (expr->isA<PadOp>() && !expr->output(0)->isFusionOutput() &&
+        std::all_of(
+            expr->output(0)->uses().begin(),
+            expr->output(0)->uses().end(),
+            [](Expr* use) { return use->isA<CatOp>(); })) {
+      continue;
+    }
+    PlanStep step;
+    step.expr = expr;
+    step.evaluate_through_evaluator = expr->isA<CatOp>();
+    for (Val* in : expr->inputs()) {
+      step.input_slots.push_back(get_slot(in));
+    }
+    for (Val* out : expr->outputs()) {
+      step.output_slots.push_back(get_slot(out));
+    }
+    const int64_t num_tensor_inputs = std::count_if(
+        step.input_slots.begin(), step.input_slots.end(), [](int64_t slot) {
+          return slot >= 0;
+        });
+    if (!step.evaluate_through_evaluator && num_tensor_inputs == 1 &&
+        expr->outputs().size() == 1 && step.output_slots[0] >= 0) {
+      step.view_input = std::distance(
+          step.input_slots.begin(),
+          std::find_if(
+              step.input_slots.begin(),
+              step.input_slots.end(),
+              [](int64_t slot) { return slot >= 0; }));
+    }
+    plan_.push_back(std::move(step));
+  }
+  for (Val* out : fusion_->outputs()) {
+    output_slots_.push_back(get_slot(out));
+    NVF_ERROR(output_slots_.back() >= 0, "Expected a tensor output: ", out);
+  }
+
   if (isProfilerEnabled()) {
     FusionProfiler::segment(group_id_).stopCompile();
   }
 }
 
+std::optional<std::vector<int64_t>> ExprEvalExecutor::inputSignature(
+    const KernelArgumentHolder& args) const {
+  // Each argument starts with a tag so that different argument kinds can't
+  // produce the same signature
+  enum class Tag : int64_t { Tensor, Int, Double, Bool };
+  std::vector<int64_t> signature;
+  for (const auto i : c10::irange(fusion_->inputs().size())) {
+    const PolymorphicValue& arg = *args[i];
+    if (arg.is<at::Tensor>()) {
+      const at::Tensor& tensor = arg.as<at::Tensor>();
+      if (tensor.is_cpu()) {
+        return std::nullopt;
+      }
+      signature.push_back(static_cast<int64_t>(Tag::Tensor));
+      signature.push_back(static_cast<int64_t>(tensor.scalar_type()));
+      signature.push_back(tensor.device().index());
+      signature.push_back(tensor.dim());
+      signature.insert(
+          signature.end(), tensor.sizes().begin(), tensor.sizes().end());
+      signature.insert(
+          signature.end(), tensor.strides().begin(), tensor.strides().end());
+    } else if (arg.is<int64_t>()) {
+      signature.push_back(static_cast<int64_t>(Tag::Int));
+      signature.push_back(arg.as<int64_t>());
+    } else if (arg.is<double>()) {
+      signature.push_back(static_cast<int64_t>(Tag::Double));
+      const double value = arg.as<double>();
+      int64_t bits = 0;
+      std::memcpy(&bits, &value, sizeof(bits));
+      signature.push_back(bits);
+    } else if (arg.is<bool>()) {
+      signature.push_back(static_cast<int64_t>(Tag::Bool));
+      signature.push_back(arg.as<bool>());
+    } else {
+      return std::nullopt;
+    }
+  }
+  return signature;
+}
+
 bool ExprEvalExecutor::isCompiled() const {
   return fusion_ != nullptr;
 }
@@ -222,21 +361,120 @@ std::vector<at::Tensor> ExprEvalExecutor::run(
   }
 
   NVF_ERROR(fusion_, "Need to compile before you can run.");
+  NVF_ERROR(
+      outputs.empty(),
+      "Fusion executor is using expression evaluator,",
+      " and expects that the outputs are not populated, which they were.");
   // Bind fusion inputs
   auto expr_eval = executor_utils::bindInputs(args, fusion_.get());
-  {
-    NVF_ERROR(
-        outputs.empty(),
-        "Fusion executor is using expression evaluator,",
-        " and expects that the outputs are not populated, which they were.");
-    if (outputs.empty()) {
-      for (const auto& out_val : fusion_->outputs()) {
-        auto out_tensor =
-            expr_eval.evaluate(out_val->as<TensorView>()).as<at::Tensor>();
-        expr_eval.bind(out_val, out_tensor);
-        outputs.emplace_back(out_tensor);
+
+  if (isProfilerEnabled()) {
+    auto estimate = executor_utils::estimateFlops(fusion_.get(), expr_eval);
+    FusionProfiler::segment(group_id_).flopsExecuted(
+        estimate.flops, estimate.mma_dtype);
+  }
+
+  std::vector<at::Tensor> tensors(num_slots_);
+  for (const auto i : c10::irange(input_slots_.size())) {
+    if (input_slots_[i] >= 0) {
+      tensors[input_slots_[i]] = args[i]->as<at::Tensor>();
+    }
+  }
+
+  // Views computed for the same input signature are replayed. Otherwise, the
+  // views of this run are recorded for the next ones.
+  std::shared_ptr<const ViewReplayCache> replay_cache;
+  std::unique_ptr<ViewReplayCache> new_replay_cache;
+  if (!isOptionDisabled(DisableOption::ExprEvalViewReplay)) {
+    if (std::optional<std::vector<int64_t>> signature = inputSignature(args)) {
+      {
+        std::lock_guard<std::mutex> guard(view_replay_mutex_);
+        replay_cache = view_replay_cache_;
+      }
+      if (replay_cache == nullptr ||
+          replay_cache->input_signature != *signature) {
+        replay_cache = nullptr;
+        new_replay_cache = std::make_unique<ViewReplayCache>();
+        new_replay_cache->input_signature = std::move(*signature);
+        new_replay_cache->views.resize(plan_.size());
+      }
+    }
+  }
+
+  int64_t num_replayed_views = 0;
+  std::vector<PolymorphicValue> expr_inputs;
+  for (const auto i : c10::irange(plan_.size())) {
+    const PlanStep& step = plan_[i];
+    Expr* expr = step.expr;
+
+    if (replay_cache != nullptr && replay_cache->views[i].has_value()) {
+      const ViewMetadata& view = *replay_cache->views[i];
+      const at::Tensor& in = tensors[step.input_slots[step.view_input]];
+      at::Tensor out = in.as_strided(
+          view.sizes,
+          view.strides,
+          in.storage_offset() + view.storage_offset_delta);
+      expr_eval.setEvaluatedValue(expr->output(0), out);
+      tensors[step.output_slots[0]] = std::move(out);
+      num_replayed_views++;
+      continue;
+    }
+
+    std::vector<PolymorphicValue> expr_outputs;
+    if (step.evaluate_through_evaluator) {
+      for (Val* out : expr->outputs()) {
+        expr_outputs.push_back(expr_eval.evaluate(out));
+      }
+    } else {
+      expr_inputs.clear();
+      for (const auto j : c10::irange(expr->inputs().size())) {
+        if (step.input_slots[j] >= 0) {
+          expr_inputs.emplace_back(tensors[step.input_slots[j]]);
+          continue;
+        }
+        const PolymorphicValue& value = expr_eval.evaluate(expr->input(j));
+        NVF_ERROR(
+            value.hasValue(),
+            "Could not evaluate ",
+            expr->input(j)->toInlineString(),
+            " for ",
+            expr);
+        expr_inputs.push_back(value);
+      }
+      expr_outputs = expr->evaluate(expr_eval, expr_inputs);
+      NVF_ERROR(expr_outputs.size() == expr->outputs().size());
+      for (const auto j : c10::irange(expr_outputs.size())) {
+        expr_eval.setEvaluatedValue(expr->output(j), expr_outputs[j]);
+      }
+    }
+    for (const auto j : c10::irange(expr_outputs.size())) {
+      if (step.output_slots[j] >= 0 && expr_outputs[j].is<at::Tensor>()) {
+        tensors[step.output_slots[j]] = expr_outputs[j].as<at::Tensor>();
       }
     }
+
+    if (new_replay_cache != nullptr && step.view_input >= 0) {
+      const at::Tensor& in = tensors[step.input_slots[step.view_input]];
+      const at::Tensor& out = tensors[step.output_slots[0]];
+      if (out.defined() && out.is_alias_of(in) &&
+          out.scalar_type() == in.scalar_type()) {
+        new_replay_cache->views[i] = ViewMetadata{
+            out.sizes().vec(),
+            out.strides().vec(),
+            out.storage_offset() - in.storage_offset()};
+      }
+    }
+  }
+  num_replayed_views_ = num_replayed_views;
+
+  if (new_replay_cache != nullptr) {
+    std::lock_guard<std::mutex> guard(view_replay_mutex_);
+    view_replay_cache_ = std::move(new_replay_cache);
+  }
+
+  outputs.reserve(output_slots_.size());
+  for (int64_t slot : output_slots_) {
+    outputs.push_back(tensors[slot]);
   }
   if (isProfilerEnabled()) {
     FusionProfiler::segment(group_id_).stopKernel();
@@ -284,6 +522,47 @@ bool hasCpuScalarOutputs(Fusion* fusion) {
       });
   return has_any_cpu_output;
 }
+
+// Returns the block size to specialize a kernel for. The block size must be
+// the same for every input the kernel may run with, so each thread
+// dimension used by the kernel has to be fixed by the launch constraints of
+// the heuristic or by a constant extent. Warp specialized kernels are
+// excluded, as their compute warps don't cover the whole block.
+std::optional<codegen::BlockDimSpecialization> getBlockDimSpecialization(
+    kir::Kernel* kernel,
+    const LaunchParams& launch_constraints,
+    const LaunchParams& launch_params,
+    const CompileParams& compile_params) {
+  const auto& pdim_map = kernel->summary().parallel_dimension_map;
+  if (pdim_map.hasWarpSpecialization()) {
+    return std::nullopt;
+  }
+  for (ParallelType pt : kParallelTypeTIDs) {
+    Val* dim = pdim_map.getRaw(pt);
+    if (dim != nullptr && !dim->isConstInt() &&
+        !launch_constraints.hasDim(pt)) {
+      return std::nullopt;
+    }
+  }
+
+  codegen::BlockDimSpecialization block_dim;
+  block_dim.dims = {
+      launch_params.bdimx(), launch_params.bdimy(), launch_params.bdimz()};
+  // Keep the occupancy targeted by the register limit, which ptxas
+  // otherwise derives from -maxrregcount
+  if (auto max_register = executor_utils::getMaxRegCount(
+          block_dim.numThreads(), compile_params.maxrregcount)) {
+    block_dim.min_blocks_per_sm = std::max<int64_t>(
+        1,
+        getThreadsPerSMGivenRegPerThread(max_register.value()) /
+            block_dim.numThreads());
+  }
+  return block_dim;
+}
+
+std::array<int64_t, 3> blockDims(const LaunchParams& launch_params) {
+  return {launch_params.bdimx(), launch_params.bdimy(), launch_params.bdimz()};
+}
 } // namespace
 
 bool KernelExecutor::supported(Fusion* fusion) {
@@ -412,6 +691,20 @@ void KernelExecutor::compile(
     compile_params.index_type = PrimDataType::Int32;
   }
 
+  // The arguments are too large to be indexed in 32 bits as a whole,
+  // but if each of their sizes and strides as well as every loop
+  // extent fits, only the tensor offsets need to be computed in 64 bits
+  if (isOptionEnabled(EnableOption::SubTensorIndexing) &&
+      arg_index_type == PrimDataType::Int &&
+      compile_params.index_type == PrimDataType::Int &&
+      tensorArgsFitInInt32(args)) {
+    auto expr_eval = executor_utils::bindInputs(args, fusion);
+    if (canUseSubTensorIndexing(fusion, expr_eval)) {
+      compile_params.index_type = PrimDataType::Int32;
+      compile_params.sub_tensor_indexing = true;
+    }
+  }
+
   c10::DeviceGuard dg(options_.device);
 
   NVF_ERROR(
@@ -428,6 +721,10 @@ void KernelExecutor::compile(
   }
   lowered_->run();
 
+  if (isOptionEnabled(EnableOption::SwizzleBankConflicts)) {
+    swizzleBankConflicts(fusion, args, launch_constraints, compile_params);
+  }
+
   kir::Kernel* kernel = lowered_->kernel();
 
   for (const auto& hook : post_lowering_hooks_) {
@@ -464,6 +761,7 @@ void KernelExecutor::compile(
   // TODO: pass block_size here;
   std::optional<int64_t> dynamic_smem = std::nullopt;
   std::optional<int64_t> block_size = std::nullopt;
+  block_dim_specialization_ = std::nullopt;
   if (!args.empty()) {
     auto expr_eval = executor_utils::bindInputs(args, kernel);
     auto launch_params = computeLaunchParams(
@@ -471,9 +769,17 @@ void KernelExecutor::compile(
     block_size = launch_params.nThreads();
     dynamic_smem = launch_params.smem();
     NVF_ERROR(block_size > 0, "launch param inferred block size < 0");
+    if (isOptionEnabled(EnableOption::StaticBlockDim)) {
+      block_dim_specialization_ = getBlockDimSpecialization(
+          kernel, launch_constraints, launch_params, compile_params);
+    }
   }
 
-  kernel_code_ = codegen::generateCudaKernel(kernel, kernelName(), block_size);
+  {
+    FUSER_COMPILE_PHASE_SCOPE("Codegen");
+    kernel_code_ = codegen::generateCudaKernel(
+        kernel, kernelName(), block_size, block_dim_specialization_);
+  }
 
   // If NVFUSER_EXTERNAL_SRC is set, utilize the external source code.
   // If the loaded external source code is empty, revert to the default codegen.
@@ -547,13 +853,7 @@ void KernelExecutor::compile(
       (block_size.has_value() ? block_size.value() : 1),
       block_size_high_water_mark_);
   maxrregcount_high_water_mark_ = compile_params.maxrregcount;
-  compiled_kernel_ = executor_utils::getCompiledKernel(
-      kernel_code_,
-      structured_code,
-      kernelName(),
-      kernel_id_,
-      compile_params,
-      block_size);
+  compileKernelCode(structured_code, compile_params, block_size);
   NVF_ERROR(validKernelId(), "Invalid kernel id for KernelExecutor.");
 
   // These should be nullopt at this point, but reset just in case
@@ -563,6 +863,7 @@ void KernelExecutor::compile(
   // has at least that size of dynamic shmem
   if (dynamic_smem.has_value()) {
     ensureAvailableDynamicSmemSize(dynamic_smem.value());
+    setPreferredSmemCarveout(dynamic_smem.value());
   }
 
   if (isDebugDumpEnabled(DebugDumpOption::Sass)) {
@@ -691,14 +992,19 @@ LaunchParams KernelExecutor::computeLaunchParams(
     // TODO: here is an optimization opportunity since welford uses int64_t for
     // N while the data type is not neccessarily double. But it may need more
     // work on the alignment
-    const int welford_factor =
-        kernel_summary.has_block_welford || kernel_summary.has_grid_welford ? 3
-                                                                            : 1;
+    // N is not kept in shared memory if it is uniform across the block
+    int welford_factor = 1;
+    if (kernel_summary.has_block_welford_with_smem_n ||
+        kernel_summary.has_grid_welford) {
+      welford_factor = 3;
+    } else if (kernel_summary.has_block_welford) {
+      welford_factor = 2;
+    }
     // in outer reduction, may group iteration domain, e.g. when vectorized.
     const int64_t grouped_iter_factor = kernel_summary.num_grouped_iterations;
 
     NVF_CHECK(
-        !(kernel_summary.has_iter_grouped_reductions && welford_factor == 3),
+        !(kernel_summary.has_iter_grouped_reductions && welford_factor > 1),
         "can't have welford and iter grouped reductions at the same time! Should be handled by grouped welford!");
 
     reduction_broadcast_workspace =
@@ -783,6 +1089,56 @@ std::vector<GlobalBufferInfo> KernelExecutor::getIntermediateBufferInfo(
   return global_buffers;
 }
 
+void KernelExecutor::swizzleBankConflicts(
+    Fusion* fusion,
+    const KernelArgumentHolder& args,
+    const LaunchParams& launch_constraints,
+    const CompileParams& compile_params) {
+  FUSER_PERF_SCOPE("KernelExecutor::swizzleBankConflicts");
+  // Returns the bank conflicts of a kernel and their total number of ways.
+  // Addresses that can't be evaluated without running the kernel are treated
+  // as having no conflicts.
+  auto get_conflicts = [&](kir::Kernel* kernel) {
+    std::unordered_map<Val*, PolymorphicValue> known_values;
+    for (auto i : c10::irange(std::min(kernel->inputs().size(), args.size()))) {
+      known_values.emplace(kernel->inputs().at(i), *args[i]);
+    }
+    std::unordered_map<const Expr*, std::pair<int64_t, int64_t>> info;
+    try {
+      info = getBankConflictInfo(kernel, launch_constraints, known_values);
+    } catch (const std::exception&) {
+      info.clear();
+    }
+    int64_t ways = 0;
+    for (const auto& [expr, conflict] : info) {
+      for (int64_t way : {conflict.first, conflict.second}) {
+        ways += way > 1 ? way : 0;
+      }
+    }
+    return std::make_pair(info, ways);
+  };
+
+  auto [info, ways] = get_conflicts(lowered_->kernel());
+  if (info.empty()) {
+    return;
+  }
+
+  // Swizzle a copy so that the fusion is unchanged if the swizzles don't help
+  Fusion swizzled_fusion(*fusion);
+  if (nvfuser::swizzleBankConflicts(&swizzled_fusion, info).empty()) {
+    return;
+  }
+  auto swizzled = std::make_unique<GpuLower>(&swizzled_fusion, compile_params);
+  for (const auto& hook : lowering_hooks_) {
+    hook(swizzled.get());
+  }
+  swizzled->run();
+
+  if (get_conflicts(swizzled->kernel()).second < ways) {
+    lowered_ = std::move(swizzled);
+  }
+}
+
 void KernelExecutor::setUsedTVs() {
   auto used_vals = fusion()->usedMathVals();
   auto used_tvs = ir_utils::filterByType<TensorView>(used_vals);
@@ -795,10 +1151,14 @@ namespace {
 // Make sure the index type of Kernel is valid
 void validateIndexType(
     kir::Kernel* kernel,
-    const CompileParams& compile_params) {
+    const CompileParams& compile_params,
+    bool sub_tensor_indexing) {
+  // A kernel using sub-tensor indexing stands in for an int64 kernel
   NVF_ERROR(
       !compile_params.index_type.has_value() ||
-          kernel->indexType() == compile_params.index_type.value(),
+          kernel->indexType() == compile_params.index_type.value() ||
+          (sub_tensor_indexing &&
+           compile_params.index_type.value() == PrimDataType::Int),
       "Kernel index type and compilation index type don't match. Kernel type: ",
       kernel->indexType(),
       ". Compilation index type: ",
@@ -856,6 +1216,10 @@ void dumpFusionArgs(
   }
   debug() << "Outputs:" << std::endl;
   for (const auto& output : outputs) {
+    if (!output.defined()) {
+      debug() << "  (to be allocated)" << std::endl;
+      continue;
+    }
     debug() << "  " << output.scalar_type() << " " << output.sizes()
             << " (strides = " << output.strides() << ")" << std::endl;
   }
@@ -901,6 +1265,19 @@ void dumpKernelArgs(
   }
 }
 
+// Returns the bytes of the buffers that are not zeroed and that are zeroed
+std::pair<int64_t, int64_t> globalBufferBytes(
+    const std::vector<GlobalBufferInfo>& buffers) {
+  int64_t bytes = 0;
+  int64_t zeroed_bytes = 0;
+  for (const auto& buf_info : buffers) {
+    const auto buf_bytes = (int64_t)at::detail::computeStorageNbytes(
+        buf_info.sizes, buf_info.strides, c10::elementSize(buf_info.type));
+    (buf_info.zero_init ? zeroed_bytes : bytes) += buf_bytes;
+  }
+  return {bytes, zeroed_bytes};
+}
+
 } // namespace
 
 void KernelExecutor::initializeExecutorEntry(
@@ -908,7 +1285,6 @@ void KernelExecutor::initializeExecutorEntry(
     const KernelArgumentHolder& args,
     const LaunchParams& launch_constraints,
     const CompileParams& compile_params,
-    const std::vector<at::Tensor>& outputs,
     DataType index_type) {
   FUSER_PERF_SCOPE("KernelExecutor::initializeExecutorEntry");
 
@@ -923,8 +1299,9 @@ void KernelExecutor::initializeExecutorEntry(
     NVF_CHECK(expr_eval.evaluate(entry.first).as<bool>(), entry.second);
   }
 
+  // Output buffers provided by the caller are validated by runFusion
   executor_utils::validateVectorizedTensors(
-      kernel(), args, outputs, compileTimeDataCache(), expr_eval);
+      kernel(), args, {}, compileTimeDataCache(), expr_eval);
 
   executor_utils::validateCircularBuffering(kernel(), expr_eval);
 
@@ -938,105 +1315,34 @@ void KernelExecutor::initializeExecutorEntry(
       "Expected blockDim.x >= 32 but found ",
       launch_params.bdimx());
 
-  std::vector<GlobalBufferInfo> output_info;
-
-  if (outputs.empty()) {
-    output_info =
-        getBufferInfos(expr_eval, index_type, lowered_->kernel()->outputs());
-  } else {
-    // Need to save the information necessary for allocations as
-    // future uses of this ExecutorEntry may not be provided with
-    // allocated outputs
-    for (const auto& output : outputs) {
-      output_info.emplace_back(GlobalBufferInfo{
-          .sizes = output.sizes().vec(),
-          .strides = output.strides().vec(),
-          .type = output.scalar_type()});
-    }
-  }
+  // The outputs are inferred even if the caller provides them, so that the
+  // provided buffers can be validated and future uses of this ExecutorEntry,
+  // which may not provide them, can allocate them
+  std::vector<GlobalBufferInfo> output_info =
+      getBufferInfos(expr_eval, index_type, lowered_->kernel()->outputs());
 
   auto intermediates = getIntermediateBufferInfo(expr_eval, index_type);
 
   // All information is gathered. Save it to ExecutorEntry
   executor_entry.launch_params = launch_params;
   executor_entry.outputs = output_info;
+  executor_entry.outputs_are_new_buffers = outputsAreNewBuffers(fusion());
   executor_entry.intermediates = intermediates;
   executor_entry.init = true;
 }
 
-/// Copies the data, logical_size, and alloc_stride parameters to the
-/// appropriate parts of entry.args[idx].
-///
-/// For GPU tensors, we pass a Tensor<type, rank, rank> struct (see
-/// runtime/tensor.cu), where the rank describes the number of elements in the
-/// shape and stride arrays. The actual shapes and strides are dynamic, but the
-/// type and rank of the tensors are actually static (changing them would need
-/// a new FusionDefinition). So we create the storage area for the
-/// Tensor<t,r,r> during ::computeArgs, and then in this function we just
-/// update that memory with the current values for the tensor's base address,
-/// shape, and strides.
-///
-/// @param entry the entry we have previously setup for this fusion
-/// @param idx the index into entry.args and related parallel arrays in the
-///            entry.
-/// @param idx_type_size generally sizeof(int32_t) or sizeof(int64_t); used for
-///                      computing how large the arrays to copy are.
-static void fillTensorArgMetadata(
-    KernelExecutor::ExecutorEntry& entry,
-    const PolymorphicValue& tensor_metadata,
-    size_t idx,
-    size_t idx_type_size) {
-  void* data = tensor_metadata->*&TensorMetaData::data;
-  // g++ has trouble inferring the types of more complicated fields through our
-  // *& operators. Creating an `auto` alias as a temporary resolves this
-  // problem.
-#define TMD_ARRAY_REF(pv, field)                  \
-  ({                                              \
-    const auto& fld_tmp_ = pv->*&field;           \
-    const c10::IntArrayRef& fld_aref_ = fld_tmp_; \
-    fld_aref_;                                    \
-  })
-  const c10::IntArrayRef& shape =
-      TMD_ARRAY_REF(tensor_metadata, TensorMetaData::logical_size);
-  const c10::IntArrayRef& strides =
-      TMD_ARRAY_REF(tensor_metadata, TensorMetaData::alloc_stride);
-#undef TMD_ARRAY_REF
-
-  // These are the three offsets we need to copy into.
-  std::array<std::byte*, 3> offsets = {
-      entry.args[idx].data(), // data ptr
-      entry.args[idx].data() + sizeof(void*), // shape array
-      // strides array:
-      entry.args[idx].data() + sizeof(void*) + shape.size() * idx_type_size,
-  };
-
-  memcpy(offsets[0], &data, sizeof(void*));
-  switch (idx_type_size) {
-    case sizeof(int64_t): {
-      // we use i64's for our sizes, so can use a simple copy here
-      memcpy(offsets[1], shape.data(), shape.size() * sizeof(int64_t));
-      memcpy(offsets[2], strides.data(), strides.size() * sizeof(int64_t));
-    } break;
-    case sizeof(int32_t): {
-      // we need to cast per-element, so need a loop.
-      // This case happens when the kernel uses 32bit indices. Since we
-      // (specifically TensorMetaData) store indices in 64bit, we can't
-      // directly copy our buffer into the args buffer. We thus have to
-      // manually downcast each element to fit in the smaller buffer.
-      for (size_t i = 0; i < shape.size(); ++i) {
-        const int32_t shp = static_cast<int32_t>(shape[i]);
-        memcpy(offsets[1] + i * sizeof(int32_t), &shp, sizeof(int32_t));
-      }
-      // In rare cases we have fewer strides than shapes
-      for (size_t i = 0; i < strides.size(); ++i) {
-        const int32_t strd = static_cast<int32_t>(strides[i]);
-        memcpy(offsets[2] + i * sizeof(int32_t), &strd, sizeof(int32_t));
-      }
-    } break;
-    default:
-      NVF_CHECK(0, "Unhandled index type size");
-      break;
-  }
+std::pair<int64_t, int64_t> KernelExecutor::workBufferBytes(
+    const KernelArgumentHolder& args,
+    const LaunchParams& launch_constraints,
+    const CompileParams& compile_params) {
+  FUSER_PERF_SCOPE("KernelExecutor::workBufferBytes");
+  NVF_ERROR(isCompiled(), "Work buffers are only known for compiled kernels");
+  // The precomputed values are shared with run()
+  std::lock_guard<std::mutex> guard(entry_mutex_);
+  ExecutorEntry entry;
+  initializeExecutorEntry(
+      entry, args, launch_constraints, compile_params, kernel()->indexType());
+  return globalBufferBytes(entry.intermediates);
 }
 
 // set the arguments that we'll pass to cuLaunchKernel. This should happen
@@ -1052,46 +1358,54 @@ void KernelExecutor::computeArgs(
   const std::vector<Val*>& params = kernel->parameters();
   entry.args.resize(params.size());
   entry.arg_ptrs.resize(params.size());
+  entry.tensor_arg_indices.clear();
+  entry.scalar_arg_indices.clear();
   const PrimDataType idx_type = kernel->indexType();
+  const kir::KernelSummary& summary = kernel->summary();
   for (size_t p = 0; p < params.size(); ++p) {
-    entry.args[p] = getKernelArgument(expr_eval, params[p], idx_type);
+    const auto* tv = dynamic_cast<const TensorView*>(params[p]);
+    entry.args[p] = getKernelArgument(
+        expr_eval,
+        params[p],
+        idx_type,
+        /*pass_logical_size=*/!summary.params_without_logical_size.count(tv),
+        /*pass_alloc_stride=*/!summary.params_without_alloc_stride.count(tv));
     entry.arg_ptrs[p] = entry.args[p].data();
+
+    const PolymorphicValue& pv = expr_eval.evaluate(params[p]);
+    if (pv.is<at::Tensor>() && pv.as<at::Tensor>().is_cuda()) {
+      entry.tensor_arg_indices.push_back(p);
+    } else {
+      entry.scalar_arg_indices.push_back(p);
+    }
   }
 }
 
-// Reset the arguments that we'll pass to cuLaunchKernel. This needs to be
-// invoked on every shape change.
+// Patch the arguments that we'll pass to cuLaunchKernel for a new launch of
+// the same entry.
 void KernelExecutor::recomputeArgs(
     ExecutorEntry& entry,
     ExpressionEvaluator& expr_eval,
     const kir::Kernel* kernel) const {
   FUSER_PERF_SCOPE("KernelExecutor::recomputeArgs");
-  // assert(entry.init && "entry was never initialized");
+  NVF_ERROR(
+      entry.args.size() ==
+          entry.tensor_arg_indices.size() + entry.scalar_arg_indices.size(),
+      "recomputeArgs called before computeArgs");
 
   const std::vector<Val*>& params = kernel->parameters();
+  // GPU tensors are not passed directly: instead we pass a Tensor<type, rank,
+  // rank> struct. The types and ranks are static, and the shapes and strides
+  // are fixed for a given cache id, so we created the Tensor<t, r, r> struct
+  // during ::computeArgs, and here we just overwrite the base address.
+  for (size_t p : entry.tensor_arg_indices) {
+    const PolymorphicValue& pv = expr_eval.evaluate(params[p]);
+    void* data = pv.as<at::Tensor>().data_ptr();
+    memcpy(entry.args[p].data(), &data, sizeof(void*));
+  }
   const PrimDataType idx_type = kernel->indexType();
-  // assert(entry.args.size() == params.size());
-  // assert(entry.arg_ptrs.size() == params.size());
-  // assert(params.size() >= args.size());
-  for (size_t p = 0; p < params.size(); ++p) {
-    PolymorphicValue pv = expr_eval.evaluate(params[p]);
-    if (pv.is<at::Tensor>() && pv.as<at::Tensor>().is_cuda()) {
-      // GPU tensors are not passed directly: instead we pass a Tensor<type,
-      // rank, rank> struct. The pointer and dimensions are dynamic, but the
-      // types and ranks are actually static (changing the rank or the types
-      // would need to be done via a new FusionDefinition). As such, we created
-      // the Tensor<t, r, r> struct during ::computeArgs, and here we just fill
-      // in the base address, shape, and stride arrays to cover whatever new
-      // tensors we got this round.
-      TensorView* mtv = dynamic_cast<TensorView*>(params[p]);
-      const Val* mdexpr = IrBuilder::metadataExpr(mtv);
-      const PolymorphicValue& tmd = expr_eval.evaluate(mdexpr);
-      const size_t idx_type_size =
-          PrimDataType::Int == idx_type ? sizeof(int64_t) : sizeof(int32_t);
-      fillTensorArgMetadata(entry, tmd, p, idx_type_size);
-    } else {
-      entry.args[p] = getKernelArgument(expr_eval, params[p], idx_type);
-    }
+  for (size_t p : entry.scalar_arg_indices) {
+    entry.args[p] = getKernelArgument(expr_eval, params[p], idx_type);
     entry.arg_ptrs[p] = entry.args[p].data();
   }
 }
@@ -1105,15 +1419,11 @@ void KernelExecutor::recompileKernel(
   block_size_high_water_mark_ = new_launch_params.nThreads();
   maxrregcount_high_water_mark_ = new_compile_params.maxrregcount;
 
-  compiled_kernel_ = executor_utils::getCompiledKernel(
-      kernel_code_,
-      structured_code,
-      kernelName(),
-      kernel_id_,
-      new_compile_params,
-      block_size_high_water_mark_);
+  compileKernelCode(
+      structured_code, new_compile_params, block_size_high_water_mark_);
 
   resetCompiledKernelProperties();
+  setPreferredSmemCarveout(new_launch_params.smem());
 
   if (kernel()->summary().has_cooperative_grid_reduction) {
     // We need to increase shared memory before kernel launch, but also before
@@ -1122,7 +1432,9 @@ void KernelExecutor::recompileKernel(
     // false positives
     ensureAvailableDynamicSmemSize(new_launch_params.smem());
     validateCooperativeLaunch(
-        compiled_kernel_->function, new_launch_params, options_.device.index());
+        compiled_kernel_->getFunction(),
+        new_launch_params,
+        options_.device.index());
   }
 }
 
@@ -1135,7 +1447,7 @@ int64_t KernelExecutor::getAvailableDynamicSmemSize() {
     NVFUSER_CUDA_SAFE_CALL(cuFuncGetAttribute(
         &size,
         CU_FUNC_ATTRIBUTE_MAX_DYNAMIC_SHARED_SIZE_BYTES,
-        compiled_kernel_->function));
+        compiled_kernel_->getFunction()));
     available_dynamic_smem_size_ = size;
   }
   return available_dynamic_smem_size_.value();
@@ -1151,7 +1463,7 @@ int64_t KernelExecutor::getStaticSmemSize() {
     NVFUSER_CUDA_SAFE_CALL(cuFuncGetAttribute(
         &size,
         CU_FUNC_ATTRIBUTE_SHARED_SIZE_BYTES,
-        compiled_kernel_->function));
+        compiled_kernel_->getFunction()));
     static_smem_size_ = size;
   }
   return static_smem_size_.value();
@@ -1190,7 +1502,7 @@ int64_t KernelExecutor::ensureAvailableDynamicSmemSize(
   if (dynamic_smem_size > getAvailableDynamicSmemSize()) {
     validateDynamicSmemSize(dynamic_smem_size);
     NVFUSER_CUDA_SAFE_CALL(cuFuncSetAttribute(
-        compiled_kernel_->function,
+        compiled_kernel_->getFunction(),
         CU_FUNC_ATTRIBUTE_MAX_DYNAMIC_SHARED_SIZE_BYTES,
         dynamic_smem_size));
     available_dynamic_smem_size_ = dynamic_smem_size;
@@ -1203,6 +1515,85 @@ void KernelExecutor::resetCompiledKernelProperties() {
   static_smem_size_.reset();
 }
 
+void KernelExecutor::compileKernelCode(
+    const std::string& structured_code,
+    CompileParams compile_params,
+    std::optional<int64_t> block_size) {
+  FUSER_PERF_SCOPE("KernelExecutor::compileKernelCode");
+  occupancy_blocks_per_sm_ = std::nullopt;
+  // The launch bounds of a kernel specialized for its block size already
+  // fix its register cap
+  if (!isOptionEnabled(EnableOption::OccupancyTarget) ||
+      !compile_params.target_blocks_per_sm.has_value() ||
+      !block_size.has_value() || block_dim_specialization_.has_value()) {
+    compiled_kernel_ = executor_utils::getCompiledKernel(
+        kernel_code_,
+        structured_code,
+        kernelName(),
+        kernel_id_,
+        compile_params,
+        block_size);
+    return;
+  }
+
+  const int64_t max_threads_per_sm =
+      at::cuda::getDeviceProperties(options_.device.index())
+          ->maxThreadsPerMultiProcessor;
+  const int64_t requested_maxrregcount = compile_params.maxrregcount;
+  int64_t blocks_per_sm = std::clamp<int64_t>(
+      compile_params.target_blocks_per_sm.value(),
+      1,
+      std::max<int64_t>(1, max_threads_per_sm / block_size.value()));
+  // The spill report of ptxas is only parsed with the verbose output
+  compile_params.enable_ptxas_verbose = true;
+  while (true) {
+    compile_params.maxrregcount = std::min(
+        requested_maxrregcount,
+        getRegPerThreadGivenThreadsPerSM(blocks_per_sm * block_size.value()));
+    compiled_kernel_ = executor_utils::getCompiledKernel(
+        kernel_code_,
+        structured_code,
+        kernelName(),
+        kernel_id_,
+        compile_params,
+        block_size);
+    const int64_t spills = compiled_kernel_->register_spills;
+    if (isDebugDumpEnabled(DebugDumpOption::Occupancy)) {
+      debug() << "OccupancyTarget: " << blocks_per_sm << " blocks of "
+              << block_size.value() << " threads per SM, maxrregcount = "
+              << compile_params.maxrregcount << ", spills " << spills
+              << " bytes" << std::endl;
+    }
+    // Relaxing the cap cannot help once it is what the heuristic asked for
+    if (spills <= 0 || blocks_per_sm == 1 ||
+        compile_params.maxrregcount == requested_maxrregcount) {
+      break;
+    }
+    blocks_per_sm--;
+  }
+  occupancy_blocks_per_sm_ = blocks_per_sm;
+}
+
+void KernelExecutor::setPreferredSmemCarveout(int64_t dynamic_smem_size) {
+  if (!occupancy_blocks_per_sm_.has_value()) {
+    return;
+  }
+  auto properties = at::cuda::getDeviceProperties(options_.device.index());
+  const int64_t smem_per_block = getStaticSmemSize() + dynamic_smem_size +
+      (int64_t)properties->reservedSharedMemPerBlock;
+  // The carve-out is a percentage of the maximum shared memory of an SM. The
+  // driver rounds it up to the next supported configuration.
+  const int64_t carveout = std::min<int64_t>(
+      100,
+      ceilDiv(
+          100 * occupancy_blocks_per_sm_.value() * smem_per_block,
+          (int64_t)properties->sharedMemPerMultiprocessor));
+  NVFUSER_CUDA_SAFE_CALL(cuFuncSetAttribute(
+      compiled_kernel_->getFunction(),
+      CU_FUNC_ATTRIBUTE_PREFERRED_SHARED_MEMORY_CARVEOUT,
+      (int)carveout));
+}
+
 std::vector<at::Tensor> KernelExecutor::run(
     KernelArgumentHolder& args,
     const LaunchParams& launch_constraints,
@@ -1229,11 +1620,8 @@ std::vector<at::Tensor> KernelExecutor::run(
       " provided number of outputs does not match fusion output");
 
   NVF_ERROR(validKernelId(), "Invalid kernel id for KernelExecutor.");
-  NVF_ERROR(
-      !args.getCacheId().has_value() || outputs.empty(),
-      "short cut input cache is not compatible with pre-allocated output");
 
-  validateIndexType(kernel(), compile_params);
+  validateIndexType(kernel(), compile_params, lowered_->subTensorIndexing());
 
   const auto num_inputs = args.size();
 
@@ -1247,44 +1635,106 @@ std::vector<at::Tensor> KernelExecutor::run(
   at::cuda::jit::initializeCudaContext();
   NVF_ERROR(lowered_);
 
-  // Placeholder for the case where parameter cache is not used
-  ExecutorEntry temporary_executor_entry;
+  // Entries are shared by the threads that run the same cache id. Holding a
+  // reference keeps an entry alive if its cache id is evicted during the run.
+  std::shared_ptr<ExecutorEntry> executor_entry;
+  LaunchParams launch_params;
+  bool inputs_validated = false;
+  bool sub_tensor_indexing_validated = false;
+  {
+    std::lock_guard<std::mutex> guard(entry_mutex_);
+    if (args.getCacheId().has_value() && !disable_parameter_cache_) {
+      auto& entry = executor_entry_lookup_[*args.getCacheId()];
+      if (entry == nullptr) {
+        entry = std::make_shared<ExecutorEntry>();
+      }
+      executor_entry = entry;
+    } else {
+      // Placeholder for the case where parameter cache is not used
+      executor_entry = std::make_shared<ExecutorEntry>();
+    }
 
-  ExecutorEntry* executor_entry =
-      args.getCacheId().has_value() && !disable_parameter_cache_
-      ? &executor_entry_lookup_[*args.getCacheId()]
-      : &temporary_executor_entry;
+    // Initialize the executor entry if not initlized
+    if (!executor_entry->init) {
+      initializeExecutorEntry(
+          *executor_entry,
+          args,
+          launch_constraints,
+          compile_params,
+          kernel()->indexType());
+    }
 
-  // Initialize the executor entry if not initlized
-  if (!executor_entry->init) {
-    initializeExecutorEntry(
-        *executor_entry,
-        args,
-        launch_constraints,
-        compile_params,
-        outputs,
-        kernel()->indexType());
-  }
+    if (block_dim_specialization_.has_value() &&
+        block_dim_specialization_->dims !=
+            blockDims(executor_entry->launch_params)) {
+      // The launch params of the heuristic were updated, so the kernel is
+      // generated again for the new block size
+      block_dim_specialization_ = getBlockDimSpecialization(
+          kernel(),
+          launch_constraints,
+          executor_entry->launch_params,
+          compile_params);
+      kernel_code_ = codegen::generateCudaKernel(
+          kernel(),
+          kernelName(),
+          executor_entry->launch_params.nThreads(),
+          block_dim_specialization_);
+      recompileKernel(executor_entry->launch_params, compile_params);
+    } else if (!(executor_entry->launch_params.nThreads() <=
+                     block_size_high_water_mark_ &&
+                 compile_params.maxrregcount ==
+                     maxrregcount_high_water_mark_)) {
+      recompileKernel(executor_entry->launch_params, compile_params);
+    }
 
-  if (!(executor_entry->launch_params.nThreads() <=
-            block_size_high_water_mark_ &&
-        compile_params.maxrregcount == maxrregcount_high_water_mark_)) {
-    recompileKernel(executor_entry->launch_params, compile_params);
+    // TODO: Why does this need to be stored in the class?
+    launch_params_ = executor_entry->launch_params;
+    launch_params = executor_entry->launch_params;
+    inputs_validated = executor_entry->inputs_validated;
+    sub_tensor_indexing_validated =
+        executor_entry->sub_tensor_indexing_validated;
   }
 
-  // TODO: Why does this need to be stored in the class?
-  launch_params_ = executor_entry->launch_params;
-
   // context manager to disable auto grad for `empty_cuda` calls later
   at::AutoDispatchBelowADInplaceOrView non_variable_type_mode;
 
-  // Bind fusion inputs
-  auto expr_eval = executor_utils::bindInputs(args, fusion());
-
-  // only allocate outputs when not given
-  if (outputs.empty()) {
-    outputs = allocateOutputs(
-        fusion(), executor_entry->outputs, options_.device, expr_eval);
+  // Bind fusion inputs. They only need to be validated on the first launch
+  // of an entry.
+  auto expr_eval =
+      executor_utils::bindInputs(args, fusion(), !inputs_validated);
+
+  // Only allocate the outputs that are not given. Undefined tensors in
+  // `outputs` stand for outputs the caller did not provide.
+  const bool outputs_provided = !outputs.empty();
+  if (outputs_provided) {
+    validateProvidedOutputs(executor_entry->outputs, outputs, options_.device);
+  }
+  if (!outputs_provided ||
+      std::any_of(outputs.begin(), outputs.end(), [](const at::Tensor& t) {
+        return !t.defined();
+      })) {
+    if (executor_entry->outputs_are_new_buffers) {
+      outputs = allocateNewOutputs(
+          executor_entry->outputs, options_.device, std::move(outputs));
+    } else if (!outputs_provided) {
+      outputs = allocateOutputs(
+          fusion(), executor_entry->outputs, options_.device, expr_eval);
+    } else {
+      // Aliases are computed together, so the provided outputs are allocated
+      // too and then dropped
+      std::vector<at::Tensor> allocated_outputs = allocateOutputs(
+          fusion(), executor_entry->outputs, options_.device, expr_eval);
+      for (const auto i : c10::irange(outputs.size())) {
+        if (!outputs[i].defined()) {
+          outputs[i] = std::move(allocated_outputs[i]);
+        }
+      }
+    }
+  }
+  if (outputs_provided) {
+    // Vectorized accesses to the provided buffers must be aligned
+    executor_utils::validateVectorizedTensors(
+        kernel(), args, outputs, compileTimeDataCache(), expr_eval);
   }
   args.push(outputs);
 
@@ -1300,10 +1750,32 @@ std::vector<at::Tensor> KernelExecutor::run(
     expr_eval.bind(output, *args[kernel()->inputs().size() + i]);
   }
 
+  // The kernel may be reused for arguments of other sizes
+  if (lowered_->subTensorIndexing()) {
+    NVF_CHECK(
+        tensorArgsFitInInt32(args) &&
+            (sub_tensor_indexing_validated ||
+             canUseSubTensorIndexing(kernel(), expr_eval)),
+        "The kernel was compiled with sub-tensor indexing, but the given ",
+        "arguments require 64-bit indexing. Disable the ",
+        "sub_tensor_indexing option to run this fusion.");
+  }
+
+  if (isProfilerEnabled()) {
+    auto estimate = executor_utils::estimateFlops(kernel(), expr_eval);
+    FusionProfiler::segment(group_id_).flopsExecuted(
+        estimate.flops, estimate.mma_dtype);
+  }
+
   std::vector<at::Tensor> intermediates;
   at::Tensor profile_buffer;
+  at::Tensor timeline_buffer;
   {
     FUSER_PERF_SCOPE("KernelExecutor::runFusion::intermediates");
+    const auto [work_buffer_bytes, semaphore_bytes] =
+        globalBufferBytes(executor_entry->intermediates);
+    last_work_buffer_bytes_ = work_buffer_bytes;
+    last_semaphore_bytes_ = semaphore_bytes;
     for (const auto i : c10::irange(executor_entry->intermediates.size())) {
       const auto& buf_info = executor_entry->intermediates.at(i);
       bool has_expansion = false;
@@ -1355,94 +1827,109 @@ std::vector<at::Tensor> KernelExecutor::run(
       if (buf_info.is_profile_buffer) {
         profile_buffer = intermediate_buffer;
       }
+      if (buf_info.tv != nullptr &&
+          buf_info.tv == kernel()->profile().getTimelineBuffer()) {
+        timeline_buffer = intermediate_buffer;
+      }
     }
   }
 
-  if (executor_entry->args.empty()) {
-    computeArgs(*executor_entry, expr_eval, kernel());
-  }
-
-  if (isDebugDumpEnabled(DebugDumpOption::LaunchParam)) {
-    launch_params_.print();
-  }
+  // The argument buffers of an entry are patched in place, and
+  // cuLaunchKernel copies them, so patching and launching are serialized.
+  // Allocations above run concurrently.
+  {
+    std::lock_guard<std::mutex> guard(entry_mutex_);
+    executor_entry->inputs_validated = true;
+    executor_entry->sub_tensor_indexing_validated =
+        lowered_->subTensorIndexing();
+    // Arguments of a new entry are computed in full; later launches of the
+    // same entry only patch the slots that can change
+    bool args_up_to_date = false;
+    if (executor_entry->args.empty()) {
+      computeArgs(*executor_entry, expr_eval, kernel());
+      args_up_to_date = true;
+    }
 
-  if (isDebugDumpEnabled(DebugDumpOption::KernelArgs)) {
-    dumpKernelArgs(
-        fusion_id_,
-        group_id_,
-        args,
-        num_inputs,
-        outputs,
-        intermediates,
-        executor_entry->intermediates);
-  }
+    if (isDebugDumpEnabled(DebugDumpOption::LaunchParam)) {
+      launch_params.print();
+    }
 
-  if (isDebugDumpEnabled(DebugDumpOption::IndexType)) {
-    debug() << "Index type: " << kernel()->indexType() << std::endl;
-  }
+    if (isDebugDumpEnabled(DebugDumpOption::KernelArgs)) {
+      dumpKernelArgs(
+          fusion_id_,
+          group_id_,
+          args,
+          num_inputs,
+          outputs,
+          intermediates,
+          executor_entry->intermediates);
+    }
 
-  if (execute_kernel_ && !kernel()->topLevelExprs().empty()) {
-    FUSER_PERF_SCOPE("KernelExecutor::runFusion::execute_kernel");
-    ensureAvailableDynamicSmemSize(executor_entry->launch_params.smem());
+    if (isDebugDumpEnabled(DebugDumpOption::IndexType)) {
+      debug() << "Index type: " << kernel()->indexType() << std::endl;
+    }
 
-    recomputeArgs(*executor_entry, expr_eval, kernel());
+    if (execute_kernel_ && !kernel()->topLevelExprs().empty()) {
+      FUSER_PERF_SCOPE("KernelExecutor::runFusion::execute_kernel");
+      ensureAvailableDynamicSmemSize(executor_entry->launch_params.smem());
 
-    if (isDebugDumpEnabled(DebugDumpOption::Occupancy) ||
-        isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
-      int blocks_per_sm = -1;
-      NVFUSER_CUDA_SAFE_CALL(cuOccupancyMaxActiveBlocksPerMultiprocessor(
-          &blocks_per_sm,
-          compiled_kernel_->function,
-          launch_params_.nThreads(),
-          launch_params_.smem()));
+      if (!args_up_to_date) {
+        recomputeArgs(*executor_entry, expr_eval, kernel());
+      }
 
-      const int64_t device_id =
-          static_cast<unsigned char>(options_.device.index());
-      const auto prop =
-          at::cuda::getDeviceProperties((c10::DeviceIndex)device_id);
-      const int64_t warps_per_sm =
-          ceilDiv(blocks_per_sm * launch_params_.nThreads(), prop->warpSize);
+      if (isDebugDumpEnabled(DebugDumpOption::Occupancy) ||
+          isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+        int blocks_per_sm = -1;
+        NVFUSER_CUDA_SAFE_CALL(cuOccupancyMaxActiveBlocksPerMultiprocessor(
+            &blocks_per_sm,
+            compiled_kernel_->getFunction(),
+            launch_params.nThreads(),
+            launch_params.smem()));
+
+        const int64_t device_id =
+            static_cast<unsigned char>(options_.device.index());
+        const auto prop =
+            at::cuda::getDeviceProperties((c10::DeviceIndex)device_id);
+        const int64_t warps_per_sm =
+            ceilDiv(blocks_per_sm * launch_params.nThreads(), prop->warpSize);
+
+        const int hw_max_warps =
+            prop->maxThreadsPerMultiProcessor / prop->warpSize;
+        const float occupancy =
+            (float)warps_per_sm / (float)hw_max_warps * 100.f;
+        setKernelOccupancy(occupancy);
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(2) << occupancy << "%";
+
+        debug() << "num_sms=" << prop->multiProcessorCount
+                << ", blocks_per_sm=" << blocks_per_sm
+                << ", warps_per_sm=" << warps_per_sm
+                << ", occupancy=" << oss.str() << std::endl;
+      }
 
-      const int hw_max_warps =
-          prop->maxThreadsPerMultiProcessor / prop->warpSize;
-      const float occupancy = (float)warps_per_sm / (float)hw_max_warps * 100.f;
-      setKernelOccupancy(occupancy);
-      std::ostringstream oss;
-      oss << std::fixed << std::setprecision(2) << occupancy << "%";
+      const bool collect_metrics = isProfilerCollectingMetrics();
+      if (collect_metrics) {
+        FusionProfiler::startKernelMetrics();
+      }
 
-      debug() << "num_sms=" << prop->multiProcessorCount
-              << ", blocks_per_sm=" << blocks_per_sm
-              << ", warps_per_sm=" << warps_per_sm
-              << ", occupancy=" << oss.str() << std::endl;
-    }
+      if (KernelLaunchCollector* collector = KernelLaunchCollector::current()) {
+        KernelLaunchCollector::Launch launch;
+        launch.executor = this;
+        launch.launch_params = launch_params;
+        launch.args = executor_entry->args;
+        for (const auto i : c10::irange(args.size())) {
+          if (args[i]->is<at::Tensor>()) {
+            launch.tensors.push_back(args[i]->as<at::Tensor>());
+          }
+        }
+        collector->collect(std::move(launch));
+      } else {
+        this->launch(launch_params, executor_entry->arg_ptrs.data(), stream);
+      }
 
-    if (!kernel()->summary().has_cooperative_grid_reduction) {
-      FUSER_PERF_SCOPE("ExecutorRunFusion::cuLaunchKernel");
-      NVFUSER_CUDA_SAFE_CALL(cuLaunchKernel(
-          compiled_kernel_->function,
-          launch_params_.gdimx(),
-          launch_params_.gdimy(),
-          launch_params_.gdimz(),
-          launch_params_.bdimx(),
-          launch_params_.bdimy(),
-          launch_params_.bdimz(),
-          launch_params_.smem(),
-          stream,
-          executor_entry->arg_ptrs.data(),
-          nullptr));
-    } else {
-      FUSER_PERF_SCOPE("ExecutorRunFusion::cuLaunchCooperativeKernel");
-      NVFUSER_CUDA_SAFE_CALL(cuLaunchCooperativeKernel(
-          compiled_kernel_->function,
-          launch_params_.gdimx(),
-          launch_params_.gdimy(),
-          launch_params_.gdimz(),
-          launch_params_.bdimx(),
-          launch_params_.bdimy(),
-          launch_params_.bdimz(),
-          launch_params_.smem(),
-          stream,
-          executor_entry->arg_ptrs.data()));
+      if (collect_metrics) {
+        FusionProfiler::stopKernelMetrics(group_id_);
+      }
     }
   }
 
@@ -1452,6 +1939,11 @@ std::vector<at::Tensor> KernelExecutor::run(
     debug() << kernel()->profile().toString(profile_buffer);
   }
 
+  if (timeline_buffer.defined()) {
+    debug() << kernel()->profile().writeTimeline(
+        timeline_buffer, kernelName() + "_timeline.json");
+  }
+
   if (isProfilerEnabled()) {
     auto& sprof = FusionProfiler::segment(group_id_);
     sprof.stopKernel();
@@ -1461,6 +1953,71 @@ std::vector<at::Tensor> KernelExecutor::run(
   return outputs;
 }
 
+void KernelExecutor::launch(
+    const LaunchParams& launch_params,
+    void** arg_ptrs,
+    CUstream stream) const {
+  if (!kernel()->summary().has_cooperative_grid_reduction) {
+    FUSER_PERF_SCOPE("ExecutorRunFusion::cuLaunchKernel");
+    NVFUSER_CUDA_SAFE_CALL(cuLaunchKernel(
+        compiled_kernel_->getFunction(),
+        launch_params.gdimx(),
+        launch_params.gdimy(),
+        launch_params.gdimz(),
+        launch_params.bdimx(),
+        launch_params.bdimy(),
+        launch_params.bdimz(),
+        launch_params.smem(),
+        stream,
+        arg_ptrs,
+        nullptr));
+  } else {
+    FUSER_PERF_SCOPE("ExecutorRunFusion::cuLaunchCooperativeKernel");
+    NVFUSER_CUDA_SAFE_CALL(cuLaunchCooperativeKernel(
+        compiled_kernel_->getFunction(),
+        launch_params.gdimx(),
+        launch_params.gdimy(),
+        launch_params.gdimz(),
+        launch_params.bdimx(),
+        launch_params.bdimy(),
+        launch_params.bdimz(),
+        launch_params.smem(),
+        stream,
+        arg_ptrs));
+  }
+}
+
+namespace {
+
+thread_local KernelLaunchCollector* current_launch_collector = nullptr;
+
+} // namespace
+
+KernelLaunchCollector::KernelLaunchCollector()
+    : previous_(current_launch_collector) {
+  current_launch_collector = this;
+}
+
+KernelLaunchCollector::~KernelLaunchCollector() {
+  current_launch_collector = previous_;
+}
+
+KernelLaunchCollector* KernelLaunchCollector::current() {
+  return current_launch_collector;
+}
+
+void KernelLaunchCollector::launchEach(CUstream stream) {
+  FUSER_PERF_SCOPE("KernelLaunchCollector::launchEach");
+  for (Launch& launch : launches_) {
+    std::vector<void*> arg_ptrs;
+    arg_ptrs.reserve(launch.args.size());
+    for (auto& arg : launch.args) {
+      arg_ptrs.push_back(arg.data());
+    }
+    launch.executor->launch(launch.launch_params, arg_ptrs.data(), stream);
+  }
+}
+
 void KernelExecutor::compileRtc(
     const std::string& code,
     const std::string& name,
@@ -1524,7 +2081,7 @@ float KernelExecutor::runRtc(
   }
 
   NVFUSER_CUDA_SAFE_CALL(cuLaunchKernel(
-      compiled_kernel_->function,
+      compiled_kernel_->getFunction(),
       launch_params.gdimx(),
       launch_params.gdimy(),
       launch_params.gdimz(),
@@ -1560,7 +2117,7 @@ flatbuffers::Offset<serde::KernelExecutor> KernelExecutor::serialize(
   std::vector<fb_executor_entry> executor_entry_lookup_values_fb;
   for (const auto& [key, value] : executor_entry_lookup_) {
     executor_entry_lookup_keys_fb.push_back(key);
-    executor_entry_lookup_values_fb.push_back(serialize(builder, value));
+    executor_entry_lookup_values_fb.push_back(serialize(builder, *value));
   }
 
   // When compilation is skipped, avoid serializing cubin because it doesn't
@@ -1569,6 +2126,18 @@ flatbuffers::Offset<serde::KernelExecutor> KernelExecutor::serialize(
     return serde::CreateKernelExecutorDirect(builder);
   }
 
+  // The block dimensions and the minimum blocks per SM the kernel code is
+  // specialized for, or empty
+  std::vector<int64_t> block_dim_specialization_fb;
+  if (block_dim_specialization_.has_value()) {
+    const auto& dims = block_dim_specialization_->dims;
+    block_dim_specialization_fb = {
+        dims[0],
+        dims[1],
+        dims[2],
+        block_dim_specialization_->min_blocks_per_sm};
+  }
+
   return serde::CreateKernelExecutorDirect(
       builder,
       device_smem_limit_,
@@ -1584,7 +2153,9 @@ flatbuffers::Offset<serde::KernelExecutor> KernelExecutor::serialize(
       &executor_entry_lookup_keys_fb,
       &executor_entry_lookup_values_fb,
       toUnderlying(kernel()->indexType()),
-      serialize(builder, compiled_kernel_.get()));
+      serialize(builder, compiled_kernel_.get()),
+      lowered_->subTensorIndexing(),
+      &block_dim_specialization_fb);
 }
 
 flatbuffers::Offset<serde::CudaKernel> KernelExecutor::serialize(
@@ -1598,27 +2169,39 @@ flatbuffers::Offset<serde::CudaKernel> KernelExecutor::serialize(
   auto fb_kernel_name = builder.CreateString(compiled_kernel->kernel_name);
   auto fb_compile_args = builder.CreateString(compiled_kernel->compile_args);
 
+  // Kernel binaries dominate the size of a serialized fusion cache, so they
+  // are optionally stored compressed. getCompiledKernel decompresses them.
+  const bool compress = isOptionEnabled(EnableOption::CompressKernelBinaries);
+  if (compress && !is_blob_compression_available()) {
+    TORCH_WARN_ONCE(
+        "NVFUSER_ENABLE=compress_kernel_binaries requires nvFuser built with "
+        "NVFUSER_BUILD_WITH_ZSTD. Kernel binaries are stored uncompressed.");
+  }
+  auto create_blob = [&builder, compress](const std::vector<char>& blob) {
+    std::vector<char> compressed_blob;
+    const std::vector<char>* stored_blob = &blob;
+    if (compress) {
+      compressed_blob = compress_blob(blob);
+      stored_blob = &compressed_blob;
+    }
+    uint8_t* blob_ptr = nullptr;
+    auto fb_blob =
+        builder.CreateUninitializedVector(stored_blob->size(), &blob_ptr);
+    std::copy(stored_blob->begin(), stored_blob->end(), blob_ptr);
+    return fb_blob;
+  };
+
   flatbuffers::Offset<flatbuffers::Vector<uint8_t>> fb_cubin = 0;
   flatbuffers::Offset<flatbuffers::String> fb_cubin_filename = 0;
   if (!compiled_kernel->cubin.empty()) {
-    uint8_t* cubin_ptr = nullptr;
-    fb_cubin = builder.CreateUninitializedVector(
-        compiled_kernel->cubin.size(), &cubin_ptr);
-    std::copy(
-        compiled_kernel->cubin.begin(),
-        compiled_kernel->cubin.end(),
-        cubin_ptr);
+    fb_cubin = create_blob(compiled_kernel->cubin);
     fb_cubin_filename = builder.CreateString(compiled_kernel->cubin_filename);
   }
 
   flatbuffers::Offset<flatbuffers::Vector<uint8_t>> fb_ptx = 0;
   flatbuffers::Offset<flatbuffers::String> fb_ptx_filename = 0;
   if (!compiled_kernel->ptx.empty()) {
-    uint8_t* ptx_ptr = nullptr;
-    fb_ptx = builder.CreateUninitializedVector(
-        compiled_kernel->ptx.size(), &ptx_ptr);
-    std::copy(
-        compiled_kernel->ptx.begin(), compiled_kernel->ptx.end(), ptx_ptr);
+    fb_ptx = create_blob(compiled_kernel->ptx);
     fb_ptx_filename = builder.CreateString(compiled_kernel->ptx_filename);
   }
 
@@ -1747,10 +2330,21 @@ void KernelExecutor::deserialize(
   maxrregcount_high_water_mark_ = buffer->maxrregcount_high_water_mark();
   warp_size_ = buffer->warp_size();
   kernel_code_ = buffer->kernel_code()->str();
+  block_dim_specialization_ = std::nullopt;
+  if (buffer->block_dim_specialization() != nullptr &&
+      buffer->block_dim_specialization()->size() == 4) {
+    const auto* fb_block_dim = buffer->block_dim_specialization();
+    codegen::BlockDimSpecialization block_dim;
+    block_dim.dims = {
+        fb_block_dim->Get(0), fb_block_dim->Get(1), fb_block_dim->Get(2)};
+    block_dim.min_blocks_per_sm = fb_block_dim->Get(3);
+    block_dim_specialization_ = block_dim;
+  }
 
   // KernelDB query checks kernel_code string and compile_params before
   // copying cubin.
   compile_params.index_type = serde::mapToNvfuserDtype(buffer->index_type());
+  compile_params.sub_tensor_indexing = buffer->sub_tensor_indexing();
   compile_params.maxrregcount = maxrregcount_high_water_mark_;
 
   // Get lowered fusion
@@ -1770,7 +2364,8 @@ void KernelExecutor::deserialize(
   for (auto idx : c10::irange(buffer->executor_entry_lookup_keys()->size())) {
     executor_entry_lookup_.emplace(
         buffer->executor_entry_lookup_keys()->Get(idx),
-        deserialize(buffer->executor_entry_lookup_values()->Get(idx)));
+        std::make_shared<ExecutorEntry>(
+            deserialize(buffer->executor_entry_lookup_values()->Get(idx))));
   }
 
   compiled_kernel_ = executor_utils::getCompiledKernel(
@@ -6,6 +6,7 @@
  */
 // clang-format on
 #pragma once
+#include <codegen.h>
 #include <device_lower/lower2device.h>
 #include <exceptions.h>
 #include <expr_evaluator.h>
@@ -25,6 +26,9 @@
 #include <c10/core/DeviceType.h>
 
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
 
 namespace nvfuser {
 
@@ -57,9 +61,66 @@ class ExprEvalExecutor : public ExecutorAbstract {
     return fusion_;
   }
 
+  // Number of steps of the execution plan that were replayed as as_strided
+  // calls in the last run
+  int64_t numReplayedViews() const {
+    return num_replayed_views_;
+  }
+
  private:
+  // An expr producing tensors, evaluated in the order of the plan
+  struct PlanStep {
+    Expr* expr = nullptr;
+    // Workspace slot of each input, or -1 for inputs that are not tensors.
+    // Those are evaluated by the ExpressionEvaluator.
+    std::vector<int64_t> input_slots;
+    // Workspace slot of each output, or -1 for outputs that are not tensors
+    std::vector<int64_t> output_slots;
+    // The expr reads its producers from the ExpressionEvaluator, e.g., CatOp
+    // skips the PadOps of its inputs, so it is evaluated through it
+    bool evaluate_through_evaluator = false;
+    // Set to the position of the only tensor input if the only output is a
+    // tensor, which may then be a view of that input
+    int64_t view_input = -1;
+  };
+
+  // Where a view step found its output in the storage of its input
+  struct ViewMetadata {
+    std::vector<int64_t> sizes;
+    std::vector<int64_t> strides;
+    int64_t storage_offset_delta = 0;
+  };
+
+  // The metadata of the views computed for the same input sizes, strides,
+  // dtypes and scalars. Views are a function of those only, so they are
+  // replayed with as_strided instead of being dispatched through ATen again.
+  struct ViewReplayCache {
+    std::vector<int64_t> input_signature;
+    // Indexed by plan step, nullopt for steps that did not return a view
+    std::vector<std::optional<ViewMetadata>> views;
+  };
+
+  // Returns nullopt if the inputs can't be summarized, e.g., they contain CPU
+  // scalar tensors whose values the signature does not capture
+  std::optional<std::vector<int64_t>> inputSignature(
+      const KernelArgumentHolder& args) const;
+
   // TODO: Set properly
   std::unique_ptr<Fusion> fusion_;
+
+  // The exprs producing tensors in topological order, built at compile time
+  std::vector<PlanStep> plan_;
+  // Workspace slot of each fusion input, or -1 for inputs that are not tensors
+  std::vector<int64_t> input_slots_;
+  // Workspace slot of each fusion output
+  std::vector<int64_t> output_slots_;
+  int64_t num_slots_ = 0;
+
+  // Guards view_replay_cache_. A run reads it once and publishes a new one if
+  // the signature changed, without holding the lock while it evaluates.
+  std::mutex view_replay_mutex_;
+  std::shared_ptr<const ViewReplayCache> view_replay_cache_;
+  std::atomic<int64_t> num_replayed_views_ = 0;
 };
 
 class KernelExecutor : public ExecutorAbstract {
@@ -103,6 +164,10 @@ class KernelExecutor : public ExecutorAbstract {
   // reconsuming the args, so it is okay. It isn't done now because changing it
   // from a reference makes a call as run({}) ambiguous, and that is used
   // in some places in the codebase.
+  //
+  // run() may be called concurrently from several threads, e.g. to launch
+  // on different streams. Only updating the launch arguments of the cache
+  // entry and launching are serialized.
   NVF_API std::vector<at::Tensor> run(
       KernelArgumentHolder& args,
       const LaunchParams& launch_constraints = LaunchParams(),
@@ -155,7 +220,7 @@ class KernelExecutor : public ExecutorAbstract {
   // execute
   bool hasCompiledKernel() const {
     if (compiled_kernel_ != nullptr) {
-      NVF_ERROR(compiled_kernel_->function != nullptr);
+      NVF_ERROR(compiled_kernel_->isLoaded());
       NVF_ERROR(
           fusion_ == nullptr,
           "fusion_ should only be initialized when using expression evaluator.");
@@ -163,7 +228,13 @@ class KernelExecutor : public ExecutorAbstract {
     return validKernelId() && lowered_ && compiled_kernel_ != nullptr;
   };
 
+  //! Approximate host memory held by the generated code and the compiled
+  //! binaries. The loaded module uses about as much device memory as the
+  //! cubin.
+  int64_t approximateBytes() const;
+
   void evictCache(size_t cache_id) {
+    std::lock_guard<std::mutex> guard(entry_mutex_);
     executor_entry_lookup_.erase(cache_id);
   }
 
@@ -177,6 +248,9 @@ class KernelExecutor : public ExecutorAbstract {
     bool init = false;
     LaunchParams launch_params;
     std::vector<GlobalBufferInfo> outputs;
+    // True if all outputs are new buffers, so launches allocate them from
+    // `outputs` without evaluating aliases. See outputsAreNewBuffers.
+    bool outputs_are_new_buffers = false;
     // Temporary work buffers and intemediate global-memory tensors
     std::vector<GlobalBufferInfo> intermediates;
     // The arguments to the kernel. These are configured in computeArgs and
@@ -190,6 +264,22 @@ class KernelExecutor : public ExecutorAbstract {
     // This is just the data() pointers to the above `args`; cuLaunchKernel
     // requires an array of this form.
     std::vector<void*> arg_ptrs;
+    // Indices into `args` of GPU tensors. Their data pointer, at the start of
+    // their `struct Tensor`, is the only part that changes between launches
+    // of the same entry since shapes and strides are part of the cache id.
+    std::vector<size_t> tensor_arg_indices;
+    // Indices into `args` of scalars and CPU scalar tensors, which are passed
+    // by value and re-evaluated for every launch
+    std::vector<size_t> scalar_arg_indices;
+    // True once the inputs of a launch with this entry were bound with
+    // validation. Sizes, strides, and the scalars extents depend on are part
+    // of the cache id, so later launches bind the inputs without checking
+    // them again.
+    bool inputs_validated = false;
+    // True once the sizes of a launch with this entry were checked against
+    // sub-tensor indexing. Extents and intermediates only depend on the
+    // inputs, so later launches only check the tensor arguments.
+    bool sub_tensor_indexing_validated = false;
   };
 
   using ExecutorCompileTimeInfoCache =
@@ -242,6 +332,19 @@ class KernelExecutor : public ExecutorAbstract {
     return launch_params_;
   }
 
+  //! Returns the bytes of the global work buffers of the last kernel
+  //! execution that are not zeroed and that are zeroed, e.g., semaphores
+  std::pair<int64_t, int64_t> lastWorkBufferBytes() const {
+    return {last_work_buffer_bytes_.load(), last_semaphore_bytes_.load()};
+  }
+
+  //! Same as lastWorkBufferBytes for a run with args, without running. args
+  //! may hold meta tensors.
+  std::pair<int64_t, int64_t> workBufferBytes(
+      const KernelArgumentHolder& args,
+      const LaunchParams& launch_constraints,
+      const CompileParams& compile_params);
+
   //! Returns the string of the compiled kernel
   NVF_API std::string kernelString() const {
     NVF_ERROR(!kernel_code_.empty(), "Kernel code not generated");
@@ -255,6 +358,14 @@ class KernelExecutor : public ExecutorAbstract {
 
   NVF_API std::string getStructuredCode() const;
 
+  //! Launches the compiled kernel with the given arguments, cooperatively if
+  //! it has cooperative grid reductions. run() launches through it unless a
+  //! KernelLaunchCollector is alive on the calling thread.
+  void launch(
+      const LaunchParams& launch_params,
+      void** arg_ptrs,
+      CUstream stream) const;
+
   //! Returns a const reference to the latest compiled kernel.
   const executor_utils::CompiledKernel& compiledKernel() const {
     return *compiled_kernel_;
@@ -384,6 +495,15 @@ class KernelExecutor : public ExecutorAbstract {
       ExpressionEvaluator& expr_eval,
       DataType index_dtype);
 
+  //! Lower a copy of fusion whose shared memory tensors with bank conflicts
+  //! in lowered_ are swizzled, and keep that lowering if it has fewer
+  //! conflicts. Used with EnableOption::SwizzleBankConflicts.
+  void swizzleBankConflicts(
+      Fusion* fusion,
+      const KernelArgumentHolder& args,
+      const LaunchParams& launch_constraints,
+      const CompileParams& compile_params);
+
   void setUsedTVs();
 
   const std::vector<TensorView*>& getUsedTVs() const {
@@ -400,7 +520,6 @@ class KernelExecutor : public ExecutorAbstract {
       const KernelArgumentHolder& args,
       const LaunchParams& launch_constraints,
       const CompileParams& compile_params,
-      const std::vector<at::Tensor>& outputs,
       DataType index_type);
 
   std::unique_ptr<PrecomputedValues>& evaluatorPrecomputedValues();
@@ -414,11 +533,10 @@ class KernelExecutor : public ExecutorAbstract {
   // to we have now.
   void computeArgs(ExecutorEntry&, ExpressionEvaluator&, const kir::Kernel*)
       const;
-  // Updates an existing set of arguments based on the current arguments. It is
-  // is an error to call this before `computeArgs` has been invoked.
-  // recomputeArgs will fail if the arity of the function changes, or the rank
-  // of any tensor changes (as these are compiled-in to the generated kernel
-  // and therefore would require us to do a larger recompilation).
+  // Updates an existing set of arguments based on the current arguments by
+  // only overwriting the tensor data pointers and the scalars. It is an error
+  // to call this before `computeArgs` has been invoked, or with tensors whose
+  // shapes or strides differ from those passed to `computeArgs`.
   void recomputeArgs(ExecutorEntry&, ExpressionEvaluator&, const kir::Kernel*)
       const;
 
@@ -467,6 +585,21 @@ class KernelExecutor : public ExecutorAbstract {
   //! Clear the cached properties of the compiled kernel
   void resetCompiledKernelProperties();
 
+  //! Compile kernel_code_ into compiled_kernel_. With
+  //! EnableOption::OccupancyTarget, maxrregcount is lowered so that
+  //! compile_params.target_blocks_per_sm blocks of block_size threads fit in
+  //! the register file of an SM. While ptxas reports spills, the kernel is
+  //! compiled again targeting one block less.
+  void compileKernelCode(
+      const std::string& structured_code,
+      CompileParams compile_params,
+      std::optional<int64_t> block_size);
+
+  //! Set the preferred shared memory carve-out of the compiled kernel to the
+  //! smallest one holding the shared memory of occupancy_blocks_per_sm_
+  //! blocks, leaving the rest of the unified memory to L1
+  void setPreferredSmemCarveout(int64_t dynamic_smem_size);
+
  private:
   CompileOptions options_;
 
@@ -511,9 +644,25 @@ class KernelExecutor : public ExecutorAbstract {
   int64_t block_size_high_water_mark_ = 1;
   int64_t maxrregcount_high_water_mark_ = 255;
 
+  // The blocks per SM the register cap of compiled_kernel_ was chosen for
+  // with EnableOption::OccupancyTarget
+  std::optional<int64_t> occupancy_blocks_per_sm_ = std::nullopt;
+
+  // The block size the kernel code is specialized for with
+  // EnableOption::StaticBlockDim. The kernel is generated again when it's
+  // launched with another block size.
+  std::optional<codegen::BlockDimSpecialization> block_dim_specialization_;
+
   // lookup table to take short cut to retrieve recorded information in order to
   // launch kernels without re-inference parameters.
-  std::unordered_map<size_t, ExecutorEntry> executor_entry_lookup_;
+  std::unordered_map<size_t, std::shared_ptr<ExecutorEntry>>
+      executor_entry_lookup_;
+
+  // Guards executor_entry_lookup_, the argument buffers of its entries,
+  // recompilation and launch_params_, so that run() can be called from
+  // several threads at once. Outputs and intermediates are allocated without
+  // holding it.
+  mutable std::mutex entry_mutex_;
 
   // Compile time information caching. This is used for shape inference
   //  support. The cache stores graph information that are available
@@ -535,6 +684,10 @@ class KernelExecutor : public ExecutorAbstract {
   // Profiling support: the last launch param used
   LaunchParams launch_params_;
 
+  // Memory accounting support: the work buffers of the last run
+  std::atomic<int64_t> last_work_buffer_bytes_ = 0;
+  std::atomic<int64_t> last_semaphore_bytes_ = 0;
+
   // Profiling support: disable caching of launch params and output allocation
   // output allocation is also disable when output sizes are dependent on
   // runtime scalar inputs, such as for the case of tensor factory. see
@@ -554,4 +707,48 @@ class KernelExecutor : public ExecutorAbstract {
   std::vector<std::function<void(kir::Kernel*)>> post_lowering_hooks_;
 };
 
+//! While a KernelLaunchCollector is alive, KernelExecutor::run on the same
+//! thread allocates the outputs and work buffers and computes the arguments
+//! of its kernel as usual, but collects the launch instead of enqueuing it.
+//! The collected kernels are then launched together, e.g., as the stages of
+//! a Megakernel, or one after the other with launchEach.
+//!
+//! Nothing may read the outputs of a collected kernel before it is launched,
+//! so all the executors run while collecting have to be KernelExecutors.
+class KernelLaunchCollector : public NonCopyable {
+ public:
+  struct Launch {
+    const KernelExecutor* executor = nullptr;
+    LaunchParams launch_params;
+    std::vector<std::vector<std::byte>> args;
+    //! The tensors passed to the kernel. They are kept alive until it is
+    //! launched, so that kernels collected after it don't get their memory,
+    //! e.g., zeroed before the launch of the collected kernels.
+    std::vector<at::Tensor> tensors;
+  };
+
+  NVF_API KernelLaunchCollector();
+  NVF_API ~KernelLaunchCollector();
+
+  //! The innermost collector alive on the calling thread, if any
+  static KernelLaunchCollector* current();
+
+  void collect(Launch launch) {
+    launches_.push_back(std::move(launch));
+  }
+
+  //! Launches in the order they were collected
+  std::vector<Launch>& launches() {
+    return launches_;
+  }
+
+  //! Enqueues the collected kernels one after the other on stream, like
+  //! KernelExecutor::run would have
+  void launchEach(CUstream stream);
+
+ private:
+  KernelLaunchCollector* previous_ = nullptr;
+  std::vector<Launch> launches_;
+};
+
 } // namespace nvfuser
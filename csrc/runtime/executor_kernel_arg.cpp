@@ -21,6 +21,7 @@ namespace nvfuser {
 KernelArgumentHolder KernelArgumentHolder::createKernelArgumentHolder(
     const c10::ArrayRef<c10::IValue>& inputs,
     std::optional<int8_t> selected_device) {
+  FUSER_PERF_SCOPE("KernelArgumentHolder::createKernelArgumentHolder");
   if (inputs.empty()) {
     // default to device 0
     KernelArgumentHolder args;
@@ -298,42 +299,44 @@ std::vector<std::byte> polymorphicValueToBytes(
     auto& alloc_stride = argument->*&TensorMetaData::alloc_stride;
     if (argument.as<StructHandle>().is<TensorMetaData>()) {
       // special handle for TensorMetaData so that CPU overhead is minimal.
-      if (index_type == PrimDataType::Int) {
-        buffer.reserve(
-            sizeof(void*) + sizeof(int64_t) * logical_size.size() +
-            sizeof(int64_t) * alloc_stride.size());
-        buffer.insert(
-            buffer.end(), (std::byte*)&data, (std::byte*)&data + sizeof(void*));
-        buffer.insert(
-            buffer.end(),
-            (std::byte*)logical_size.data(),
-            (std::byte*)logical_size.data() +
-                sizeof(int64_t) * logical_size.size());
-        buffer.insert(
-            buffer.end(),
-            (std::byte*)alloc_stride.data(),
-            (std::byte*)alloc_stride.data() +
-                sizeof(int64_t) * alloc_stride.size());
-      } else {
-        buffer.reserve(
-            sizeof(void*) + sizeof(int32_t) * logical_size.size() +
-            sizeof(int32_t) * alloc_stride.size());
-        buffer.insert(
-            buffer.end(), (std::byte*)&data, (std::byte*)&data + sizeof(void*));
-        std::vector<int32_t> logical_size32(
-            logical_size.begin(), logical_size.end());
-        buffer.insert(
-            buffer.end(),
-            (std::byte*)logical_size32.data(),
-            (std::byte*)logical_size32.data() +
-                sizeof(int32_t) * logical_size32.size());
-        std::vector<int32_t> alloc_stride32(
-            alloc_stride.begin(), alloc_stride.end());
-        buffer.insert(
-            buffer.end(),
-            (std::byte*)alloc_stride32.data(),
-            (std::byte*)alloc_stride32.data() +
-                sizeof(int32_t) * alloc_stride32.size());
+      // Sizes and strides the kernel does not read are not passed.
+      bool pass_logical_size = true;
+      bool pass_alloc_stride = true;
+      for (const auto& field : dtype_.fields) {
+        if (field.name == "logical_size") {
+          pass_logical_size = field.used_in_kernel;
+        } else if (field.name == "alloc_stride") {
+          pass_alloc_stride = field.used_in_kernel;
+        }
+      }
+      const size_t index_size =
+          index_type == PrimDataType::Int ? sizeof(int64_t) : sizeof(int32_t);
+      buffer.reserve(
+          sizeof(void*) +
+          index_size * (pass_logical_size ? logical_size.size() : 0) +
+          index_size * (pass_alloc_stride ? alloc_stride.size() : 0));
+      buffer.insert(
+          buffer.end(), (std::byte*)&data, (std::byte*)&data + sizeof(void*));
+      auto insert_indices = [&](c10::IntArrayRef indices) {
+        if (index_type == PrimDataType::Int) {
+          buffer.insert(
+              buffer.end(),
+              (std::byte*)indices.data(),
+              (std::byte*)indices.data() + sizeof(int64_t) * indices.size());
+        } else {
+          std::vector<int32_t> indices32(indices.begin(), indices.end());
+          buffer.insert(
+              buffer.end(),
+              (std::byte*)indices32.data(),
+              (std::byte*)indices32.data() +
+                  sizeof(int32_t) * indices32.size());
+        }
+      };
+      if (pass_logical_size) {
+        insert_indices(logical_size);
+      }
+      if (pass_alloc_stride) {
+        insert_indices(alloc_stride);
       }
       return buffer;
     } else {
@@ -359,7 +362,9 @@ std::vector<std::byte> polymorphicValueToBytes(
 std::vector<std::byte> getKernelArgument(
     ExpressionEvaluator& ee,
     Val* parameter,
-    PrimDataType index_type) {
+    PrimDataType index_type,
+    bool pass_logical_size,
+    bool pass_alloc_stride) {
   FUSER_PERF_SCOPE("getKernelArgument");
   NVF_ERROR(parameter != nullptr);
   PolymorphicValue pv = ee.evaluate(parameter);
@@ -369,8 +374,19 @@ std::vector<std::byte> getKernelArgument(
     } else {
       const Val* metadata_val = IrBuilder::metadataExpr(tv);
       const PolymorphicValue& metadata = ee.evaluate(metadata_val);
-      return polymorphicValueToBytes(
-          metadata, metadata_val->dtype(), index_type);
+      if (pass_logical_size && pass_alloc_stride) {
+        return polymorphicValueToBytes(
+            metadata, metadata_val->dtype(), index_type);
+      }
+      auto metadata_type = std::get<StructType>(metadata_val->dtype().type);
+      for (auto& field : metadata_type.fields) {
+        if (field.name == "logical_size") {
+          field.used_in_kernel = pass_logical_size;
+        } else if (field.name == "alloc_stride") {
+          field.used_in_kernel = pass_alloc_stride;
+        }
+      }
+      return polymorphicValueToBytes(metadata, metadata_type, index_type);
     }
   }
   return polymorphicValueToBytes(pv, parameter->dtype(), index_type);
@@ -130,10 +130,14 @@ std::vector<std::byte> polymorphicValueToBytes(
     const DataType& dtype,
     PrimDataType index_type);
 
+//! pass_logical_size and pass_alloc_stride tell whether the sizes and
+//! strides of a tensor parameter are passed to the kernel
 std::vector<std::byte> getKernelArgument(
     ExpressionEvaluator& ee,
     Val* parameter,
-    PrimDataType index_type);
+    PrimDataType index_type,
+    bool pass_logical_size = true,
+    bool pass_alloc_stride = true);
 
 int64_t computeBytes(const KernelArgumentHolder& args);
 
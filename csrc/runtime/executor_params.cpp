@@ -22,7 +22,14 @@ std::string CompileParams::toString() const {
   }
   ss << "maxrregcount = " << maxrregcount << ", "
      << "enable_magic_zero = " << enable_magic_zero << ", "
-     << "enable_ptxas_verbose = " << enable_ptxas_verbose << "\n";
+     << "enable_ptxas_verbose = " << enable_ptxas_verbose << ", "
+     << "sub_tensor_indexing = " << sub_tensor_indexing << ", "
+     << "target_blocks_per_sm = ";
+  if (target_blocks_per_sm.has_value()) {
+    ss << target_blocks_per_sm.value() << "\n";
+  } else {
+    ss << "NotSet\n";
+  }
   return ss.str();
 }
 
@@ -21,6 +21,15 @@ struct CompileParams {
   bool enable_magic_zero = true;
   // if true, save ptxas info to compile log and check for register spilling
   bool enable_ptxas_verbose = false;
+  // if true, global tensors are linearized in 64-bit on top of 32-bit loop
+  // indices even though index_type is Int32. Set by KernelExecutor when the
+  // kernel arguments require Int but all the indexing outside of the
+  // linearization provably fits in 32 bits.
+  bool sub_tensor_indexing = false;
+  // Number of blocks per SM the heuristic intends to be resident. With
+  // EnableOption::OccupancyTarget, KernelExecutor lowers maxrregcount and
+  // sets the preferred shared memory carve-out so that they fit.
+  std::optional<int64_t> target_blocks_per_sm = std::nullopt;
 
   bool operator==(const CompileParams& other) const {
     // Disallow comparison if the index type is nullopt
@@ -32,7 +41,8 @@ struct CompileParams {
         "cannot compare as the other index type is not defined");
     return index_type == other.index_type &&
         maxrregcount == other.maxrregcount &&
-        enable_magic_zero == other.enable_magic_zero;
+        enable_magic_zero == other.enable_magic_zero &&
+        target_blocks_per_sm == other.target_blocks_per_sm;
   }
 
   bool operator!=(const CompileParams& other) const {
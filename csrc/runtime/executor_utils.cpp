@@ -19,6 +19,7 @@
 #include <ir/iostream.h>
 #include <ir/utils.h>
 #include <kernel_db/kernel_db.h>
+#include <kernel_db/utils.h>
 #include <options.h>
 #include <runtime/executor_utils.h>
 #include <tensor_metadata.h>
@@ -35,6 +36,7 @@
 #include <nvfuser_resources/block_sync_default.h>
 #include <nvfuser_resources/block_welford_outer.h>
 #include <nvfuser_resources/broadcast.h>
+#include <nvfuser_resources/cluster.h>
 #include <nvfuser_resources/complex_number.h>
 #include <nvfuser_resources/fp16_support.h>
 #include <nvfuser_resources/fp8_support.h>
@@ -56,8 +58,13 @@
 #include <nvfuser_resources/warp.h>
 #include <nvfuser_resources/welford.h>
 
+#include <algorithm>
+#include <cctype>
 #include <cstdlib>
 #include <fstream>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
 #include <variant>
 
 #include <nvrtc.h>
@@ -65,7 +72,61 @@
 namespace nvfuser {
 namespace executor_utils {
 
-std::string kernelPreamble() {
+namespace {
+
+//! Runtime files of the preamble that are only needed by some kernels
+enum PreambleComponent : uint32_t {
+  kFp8Support = 1 << 0,
+  kRandomNumbers = 1 << 1,
+  kGridSync = 1 << 2,
+  kMbarrier = 1 << 3,
+  kCluster = 1 << 4,
+  kBlockReduction = 1 << 5,
+  kGridReduction = 1 << 6,
+  kGridBroadcast = 1 << 7,
+  kBroadcast = 1 << 8,
+  kWelford = 1 << 9,
+  kWarp = 1 << 10,
+  kMemory = 1 << 11,
+  //! fused_welford_helper, fused_reduction, fused_welford_impl,
+  //! block_welford_outer, and fused_welford_impl_outer
+  kFusedReduction = 1 << 12,
+  kAllPreambleComponents = (1 << 13) - 1
+};
+
+//! How kernels refer to a component, and the components it depends on
+struct PreambleComponentUses {
+  PreambleComponent component;
+  std::vector<std::string> tokens;
+  uint32_t dependencies = 0;
+};
+
+//! Components in the order of the preamble. A component only depends on
+//! components before it.
+const std::vector<PreambleComponentUses>& preambleComponentUses() {
+  static const std::vector<PreambleComponentUses> uses = {
+      {kFp8Support, {"e4m3", "e5m2", "fp8"}},
+      {kRandomNumbers, {"rng_", "philox"}},
+      {kGridSync, {"grid_sync::"}},
+      {kMbarrier, {"mbarrier::"}},
+      {kCluster, {"cluster", "Cluster"}},
+      {kBlockReduction, {"blockReduce", "blockIterGroupedYdimReduce"}},
+      {kGridReduction,
+       {"reduction::", "gridReduce"},
+       kGridSync | kCluster | kBlockReduction},
+      {kGridBroadcast, {"grid_broadcast::"}, kGridSync},
+      {kBroadcast, {"broadcast::", "blockBroadcast"}},
+      {kWelford, {"welford", "Welford"}, kGridSync},
+      {kWarp, {"warp::"}},
+      {kMemory, {"toSmem", "Turing::", "Hopper::", "electSync"}, kMbarrier},
+      {kFusedReduction,
+       {"fused_reduction::", "ParallelReduce", "blockWelfordOuter"},
+       kGridSync | kGridReduction | kWelford},
+  };
+  return uses;
+}
+
+std::string buildKernelPreamble(uint32_t components) {
   std::stringstream ss;
   ss << nvfuser_resources::basic_type_traits_cu;
   ss << nvfuser_resources::bit_cu;
@@ -73,13 +134,17 @@ std::string kernelPreamble() {
 
   ss << nvfuser_resources::fp16_support_cu;
   ss << nvfuser_resources::bf16_support_cu;
-  ss << nvfuser_resources::fp8_support_cu;
+  if (components & kFp8Support) {
+    ss << nvfuser_resources::fp8_support_cu;
+  }
 
   // Base classes and helpers
   ss << nvfuser_resources::type_traits_cu;
   ss << nvfuser_resources::array_cu;
   ss << nvfuser_resources::tensor_cu;
-  ss << nvfuser_resources::random_numbers_cu;
+  if (components & kRandomNumbers) {
+    ss << nvfuser_resources::random_numbers_cu;
+  }
   ss << nvfuser_resources::helpers_cu;
   ss << nvfuser_resources::index_utils_cu;
   ss << nvfuser_resources::tuple_cu;
@@ -90,26 +155,74 @@ std::string kernelPreamble() {
   } else {
     ss << nvfuser_resources::block_sync_default_cu;
   }
-  ss << nvfuser_resources::grid_sync_cu;
-  ss << nvfuser_resources::mbarrier_cu;
+  if (components & kGridSync) {
+    ss << nvfuser_resources::grid_sync_cu;
+  }
+  if (components & kMbarrier) {
+    ss << nvfuser_resources::mbarrier_cu;
+  }
+  if (components & kCluster) {
+    ss << nvfuser_resources::cluster_cu;
+  }
 
   // Communication classes
-  ss << nvfuser_resources::block_reduction_cu;
-  ss << nvfuser_resources::grid_reduction_cu;
-  ss << nvfuser_resources::grid_broadcast_cu;
-  ss << nvfuser_resources::broadcast_cu;
-  ss << nvfuser_resources::welford_cu;
-  ss << nvfuser_resources::warp_cu;
-  ss << nvfuser_resources::memory_cu;
-  ss << nvfuser_resources::fused_welford_helper_cu;
-  ss << nvfuser_resources::fused_reduction_cu;
-  ss << nvfuser_resources::fused_welford_impl_cu;
-  ss << nvfuser_resources::block_welford_outer_cu;
-  ss << nvfuser_resources::fused_welford_impl_outer_cu;
+  if (components & kBlockReduction) {
+    ss << nvfuser_resources::block_reduction_cu;
+  }
+  if (components & kGridReduction) {
+    ss << nvfuser_resources::grid_reduction_cu;
+  }
+  if (components & kGridBroadcast) {
+    ss << nvfuser_resources::grid_broadcast_cu;
+  }
+  if (components & kBroadcast) {
+    ss << nvfuser_resources::broadcast_cu;
+  }
+  if (components & kWelford) {
+    ss << nvfuser_resources::welford_cu;
+  }
+  if (components & kWarp) {
+    ss << nvfuser_resources::warp_cu;
+  }
+  if (components & kMemory) {
+    ss << nvfuser_resources::memory_cu;
+  }
+  if (components & kFusedReduction) {
+    ss << nvfuser_resources::fused_welford_helper_cu;
+    ss << nvfuser_resources::fused_reduction_cu;
+    ss << nvfuser_resources::fused_welford_impl_cu;
+    ss << nvfuser_resources::block_welford_outer_cu;
+    ss << nvfuser_resources::fused_welford_impl_outer_cu;
+  }
 
   return ss.str();
 }
 
+} // namespace
+
+std::string kernelPreamble() {
+  return buildKernelPreamble(kAllPreambleComponents);
+}
+
+std::string kernelPreamble(const std::string& kernel_code) {
+  const auto& uses = preambleComponentUses();
+  uint32_t components = 0;
+  // Dependencies come before their users, so a reverse walk adds the
+  // dependencies of dependencies too
+  for (auto it = uses.rbegin(); it != uses.rend(); ++it) {
+    const bool used = (components & it->component) ||
+        std::any_of(it->tokens.begin(),
+                    it->tokens.end(),
+                    [&](const std::string& token) {
+                      return kernel_code.find(token) != std::string::npos;
+                    });
+    if (used) {
+      components |= it->component | it->dependencies;
+    }
+  }
+  return buildKernelPreamble(components);
+}
+
 // Query the target GPU version number NVRTC compiles CUDA kernels for
 void queryTargetGPUVersion(
     const cudaDeviceProp* const prop,
@@ -700,7 +813,8 @@ void validateVectorizedTensors(
 
 ExpressionEvaluator bindInputs(
     const KernelArgumentHolder& args,
-    Fusion* kernel) {
+    Fusion* kernel,
+    bool validate) {
   FUSER_PERF_SCOPE("executor_utils::bindInputs");
 
   // args may contains more than just inputs, but inputs are always at the
@@ -716,7 +830,7 @@ ExpressionEvaluator bindInputs(
     // expr_eval will create a PolymorphicValue containing *args[i], which means
     // that at::Tensor's lifetime will be at least as long as that of expr_eval.
     try {
-      expr_eval.bind(inputs[i], *args[i], true);
+      expr_eval.bind(inputs[i], *args[i], validate);
     } catch (const nvfError& e) {
       std::stringstream ss;
       ss << "When trying to run the provided host program,"
@@ -737,6 +851,74 @@ ExpressionEvaluator bindInputs(
 
 namespace {
 
+// Product of the extents of the logical domain of tv, or 0 if one of them is
+// not known
+int64_t logicalNumel(
+    TensorView* tv,
+    ExpressionEvaluator& expr_eval,
+    bool include_reductions) {
+  int64_t numel = 1;
+  for (IterDomain* id : tv->getLogicalDomain()) {
+    if (id->isBroadcast() || (id->isReduction() && !include_reductions)) {
+      continue;
+    }
+    PolymorphicValue extent = expr_eval.evaluate(id->extent());
+    if (!extent.is<int64_t>()) {
+      return 0;
+    }
+    numel *= extent.as<int64_t>();
+  }
+  return numel;
+}
+
+// Extent of the innermost logical axis of tv, i.e., K of a matmul operand
+int64_t innermostExtent(TensorView* tv, ExpressionEvaluator& expr_eval) {
+  auto logical = TensorDomain::noReductions(tv->getLogicalDomain());
+  if (logical.empty()) {
+    return 1;
+  }
+  PolymorphicValue extent = expr_eval.evaluate(logical.back()->extent());
+  return extent.is<int64_t>() ? extent.as<int64_t>() : 0;
+}
+
+} // namespace
+
+FlopEstimate estimateFlops(Fusion* fusion, ExpressionEvaluator& expr_eval) {
+  FlopEstimate estimate;
+  for (Expr* expr : fusion->exprs()) {
+    auto* out = dynamic_cast<TensorView*>(expr->output(0));
+    if (out == nullptr) {
+      continue;
+    }
+    if (auto* mma = dynamic_cast<MmaOp*>(expr)) {
+      // The logical domain of the output of an MmaOp has the K axis
+      estimate.flops += 2 * logicalNumel(out, expr_eval, true);
+      estimate.mma_dtype = mma->inA()->getDataType();
+    } else if (auto* matmul = dynamic_cast<MatmulOp*>(expr)) {
+      estimate.flops += 2 * logicalNumel(out, expr_eval, false) *
+          innermostExtent(matmul->inA(), expr_eval);
+      estimate.mma_dtype = matmul->inA()->getDataType();
+    } else if (auto* linear = dynamic_cast<LinearOp*>(expr)) {
+      estimate.flops += 2 * logicalNumel(out, expr_eval, false) *
+          innermostExtent(linear->inA()->as<TensorView>(), expr_eval);
+      estimate.mma_dtype = linear->inA()->getDataType();
+    } else if (expr->isOneOf<ReductionOp, WelfordOp>()) {
+      estimate.flops += logicalNumel(out, expr_eval, true);
+    } else if (auto* uop = dynamic_cast<UnaryOp*>(expr)) {
+      if (uop->getUnaryOpType() != UnaryOpType::Cast &&
+          uop->getUnaryOpType() != UnaryOpType::BitCast &&
+          uop->getUnaryOpType() != UnaryOpType::RefCast) {
+        estimate.flops += logicalNumel(out, expr_eval, false);
+      }
+    } else if (expr->isOneOf<BinaryOp, TernaryOp>()) {
+      estimate.flops += logicalNumel(out, expr_eval, false);
+    }
+  }
+  return estimate;
+}
+
+namespace {
+
 std::vector<char> compileNvrtcProgramToPtx(const nvrtcProgram& program) {
   size_t size = 0;
   NVFUSER_NVRTC_SAFE_CALL(nvrtcGetPTXSize(program, &size));
@@ -772,6 +954,8 @@ std::string dumpCompiledCodeToFile(
   return file_name.str();
 }
 
+} // namespace
+
 // Get the max register count passed as -maxrregcount ptxas
 // option. The count is determined based on block sizes, an optional
 // heuristic and an environment variable.
@@ -822,6 +1006,8 @@ std::optional<int64_t> getMaxRegCount(
   }
 }
 
+namespace {
+
 //! Utility class to invoke nvrtcCompileProgram. Mainly for setting up
 //! the c-str options.
 class NvrtcCompileDriver {
@@ -836,6 +1022,7 @@ class NvrtcCompileDriver {
 
   std::string invoke(nvrtcProgram program, const std::string& src) const {
     FUSER_PERF_SCOPE("executor_utils::Nvrtc::CompileProgram");
+    FUSER_COMPILE_PHASE_SCOPE("NVRTC");
     auto opts = getOptions();
     auto result = nvrtcCompileProgram(
         program, static_cast<int>(opts.size()), opts.data());
@@ -907,6 +1094,7 @@ class CuModuleLoadDataDriver {
   //! if enabled
   std::string invoke(CUmodule& module, const void* image) {
     FUSER_PERF_SCOPE("executor_utils::Nvrtc::LoadPTX");
+    FUSER_COMPILE_PHASE_SCOPE("Module load");
 
     auto [opts, opt_vals] = getOptions();
 
@@ -920,6 +1108,33 @@ class CuModuleLoadDataDriver {
     return log_;
   }
 
+#if (CUDA_VERSION >= 12000)
+  //! Invoke cuLibraryLoadData with ptx or cubin and the same options as
+  //! cuModuleLoadDataEx
+  std::string invokeLibrary(CUlibrary& library, const void* image) {
+    FUSER_PERF_SCOPE("executor_utils::Nvrtc::LoadLibrary");
+    FUSER_COMPILE_PHASE_SCOPE("Module load");
+
+    auto [opts, opt_vals] = getOptions();
+
+    NVFUSER_CUDA_SAFE_CALL(cuLibraryLoadData(
+        &library,
+        image,
+        opts.data(),
+        opt_vals.data(),
+        opts.size(),
+        nullptr,
+        nullptr,
+        0));
+
+    if (logging_enabled_) {
+      debug() << log_ << std::endl;
+    }
+
+    return log_;
+  }
+#endif
+
  private:
   // Get options that can be passed to cuModuleLoadDataEx
   std::pair<std::vector<CUjit_option>, std::vector<void*>> getOptions() {
@@ -1024,6 +1239,15 @@ void fillCompileOptions(
   if (isOptionEnabled(EnableOption::KernelProfile)) {
     nvrtc_compile_driver.setOption("-DNVFUSER_PROFILE_KERNEL");
   }
+
+#if CUDA_VERSION >= 12080
+  // NVRTC precompiles the first header included by the kernel, which is the
+  // kernel preamble. See splitKernelPreamble.
+  if (isOptionEnabled(EnableOption::PrecompiledPreamble)) {
+    nvrtc_compile_driver.setOption("--pch");
+  }
+#endif
+
   if (isDebugDumpEnabled(DebugDumpOption::PrintPtxasLog) ||
       isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose) ||
       isOptionEnabled(EnableOption::WarnRegisterSpill) ||
@@ -1115,17 +1339,89 @@ int warnRegisterSpill(const std::string& compile_log) {
   return store_count + load_count;
 }
 
+//! Source of a kernel whose preamble is moved to an in-memory header
+struct SplitKernelSource {
+  std::string header_name;
+  std::string header;
+  std::string body;
+};
+
+#if CUDA_VERSION >= 12080
+//! Move everything up to the end of the kernel preamble in the code built by
+//! KernelExecutor::getStructuredCode into a header so that NVRTC can compile
+//! it once and reuse it for all kernels with the same preamble. The header
+//! is named after a hash of its contents, as the index type and the sync
+//! implementation vary the preamble. Returns std::nullopt if the code does
+//! not contain the preamble, e.g. when it was read from an external file.
+std::optional<SplitKernelSource> splitKernelPreamble(
+    const std::string& full_src_code) {
+  static const std::string preamble = kernelPreamble();
+  const std::string namespace_begin = "namespace {\n";
+  const auto preamble_pos = full_src_code.find(preamble);
+  if (preamble_pos == std::string::npos) {
+    return std::nullopt;
+  }
+  const auto namespace_pos = full_src_code.rfind(namespace_begin, preamble_pos);
+  if (namespace_pos == std::string::npos) {
+    return std::nullopt;
+  }
+  const auto preamble_end = preamble_pos + preamble.size();
+
+  SplitKernelSource split;
+  split.header = full_src_code.substr(0, preamble_end) + "}\n";
+  split.header_name = "nvfuser_preamble_" +
+      std::to_string(std::hash<std::string>{}(split.header)) + ".h";
+  split.body = "#include \"" + split.header_name + "\"\n" + namespace_begin +
+      full_src_code.substr(preamble_end);
+  return split;
+}
+#endif
+
 void createNvrtcProgram(
     nvrtcProgram& program,
     const std::string& id,
-    const std::string& full_src_code) {
+    const std::string& full_src_code,
+    const SplitKernelSource* split_source = nullptr) {
   std::stringstream ss;
   ss << "__tmp_kernel_" << id << ".cu";
   std::string name = ss.str();
   FUSER_PERF_SCOPE("executor_utils::NvrtcCreateProgram");
+  if (split_source == nullptr) {
+    NVFUSER_NVRTC_SAFE_CALL(nvrtcCreateProgram(
+        &program, full_src_code.c_str(), name.c_str(), 0, nullptr, nullptr));
+    return;
+  }
+  const char* header = split_source->header.c_str();
+  const char* header_name = split_source->header_name.c_str();
   NVFUSER_NVRTC_SAFE_CALL(nvrtcCreateProgram(
-      &program, full_src_code.c_str(), name.c_str(), 0, nullptr, nullptr));
+      &program,
+      split_source->body.c_str(),
+      name.c_str(),
+      1,
+      &header,
+      &header_name));
+}
+
+#if CUDA_VERSION >= 12080
+//! The precompiled preamble is kept in the NVRTC PCH heap, which is shared
+//! by all programs of the process. Grow it when a compilation reports that
+//! the preamble did not fit so that the next compilation can create it.
+void growPchHeapIfExhausted(nvrtcProgram program) {
+  if (nvrtcGetPCHCreateStatus(program) !=
+      NVRTC_ERROR_PCH_CREATE_HEAP_EXHAUSTED) {
+    return;
+  }
+  static std::mutex pch_heap_mutex;
+  std::lock_guard<std::mutex> lock(pch_heap_mutex);
+  size_t required_size = 0;
+  NVFUSER_NVRTC_SAFE_CALL(nvrtcGetPCHHeapSizeRequired(program, &required_size));
+  size_t heap_size = 0;
+  NVFUSER_NVRTC_SAFE_CALL(nvrtcGetPCHHeapSize(&heap_size));
+  if (heap_size < required_size) {
+    NVFUSER_NVRTC_SAFE_CALL(nvrtcSetPCHHeapSize(required_size));
+  }
 }
+#endif
 
 // Compile the given source code with the NVRTC compiler driver.
 std::unique_ptr<CompiledKernel> compileSource(
@@ -1142,10 +1438,33 @@ std::unique_ptr<CompiledKernel> compileSource(
     NVFUSER_NVRTC_SAFE_CALL(nvrtcDestroyProgram(&program));
   });
 
-  createNvrtcProgram(program, id, full_src_code);
+  std::optional<SplitKernelSource> split_source;
+  if (isOptionEnabled(EnableOption::PrecompiledPreamble)) {
+#if CUDA_VERSION >= 12080
+    split_source = splitKernelPreamble(full_src_code);
+#else
+    TORCH_WARN_ONCE(
+        "NVFUSER_ENABLE=precompiled_preamble requires NVRTC 12.8 or newer, ",
+        "ignoring the option");
+#endif
+  }
+  createNvrtcProgram(
+      program,
+      id,
+      full_src_code,
+      split_source.has_value() ? &split_source.value() : nullptr);
 
   NVFUSER_NVRTC_SAFE_CALL(nvrtcAddNameExpression(program, func_name.c_str()));
-  log << nvrtc_compile.invoke(program, full_src_code) << std::endl;
+  log << nvrtc_compile.invoke(
+             program,
+             split_source.has_value() ? split_source->body : full_src_code)
+      << std::endl;
+
+#if CUDA_VERSION >= 12080
+  if (split_source.has_value()) {
+    growPchHeapIfExhausted(program);
+  }
+#endif
 
   auto compiled_kernel = std::make_unique<CompiledKernel>();
   const char* lowered_kernel_name = nullptr;
@@ -1173,6 +1492,218 @@ std::unique_ptr<CompiledKernel> compileSource(
   return compiled_kernel;
 }
 
+//! Whether full_src_code is the structured code of kernel_code, i.e. the
+//! kernel preceded by the preamble and closing its namespace
+bool isGeneratedFrom(
+    const std::string& full_src_code,
+    const std::string& kernel_code) {
+  const std::string suffix = kernel_code + "}\n";
+  return full_src_code.size() >= suffix.size() &&
+      full_src_code.compare(
+          full_src_code.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+//! Rename the kernel and the tensors of kernel_code in the order they first
+//! appear. Kernels generated from structurally identical fusions, e.g. the
+//! same layer defined by different FusionDefinitions, then have the same
+//! canonical code even though their kernel names differ.
+std::string canonicalKernelCode(
+    const std::string& kernel_code,
+    const std::string& func_name) {
+  auto is_identifier_char = [](char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+  };
+  auto is_tensor_name = [](const std::string& token) {
+    return token.size() > 1 && token[0] == 'T' &&
+        std::all_of(token.begin() + 1, token.end(), [](char c) {
+             return std::isdigit(static_cast<unsigned char>(c));
+           });
+  };
+
+  std::string canonical_code;
+  canonical_code.reserve(kernel_code.size());
+  std::unordered_map<std::string, std::string> tensor_names;
+  size_t pos = 0;
+  while (pos < kernel_code.size()) {
+    if (!is_identifier_char(kernel_code[pos])) {
+      canonical_code.push_back(kernel_code[pos++]);
+      continue;
+    }
+    size_t end = pos;
+    while (end < kernel_code.size() && is_identifier_char(kernel_code[end])) {
+      ++end;
+    }
+    std::string token = kernel_code.substr(pos, end - pos);
+    if (token == func_name) {
+      canonical_code += "nvfuser_kernel";
+    } else if (is_tensor_name(token)) {
+      auto [it, inserted] = tensor_names.emplace(
+          token, "T" + std::to_string(tensor_names.size()));
+      canonical_code += it->second;
+    } else {
+      canonical_code += token;
+    }
+    pos = end;
+  }
+  return canonical_code;
+}
+
+//! Process-wide cache of NVRTC outputs, shared by all KernelExecutors and
+//! devices. A kernel compiled once, for any fusion and device, is only
+//! loaded, and finalized by the driver if it is PTX, on other devices of the
+//! same architecture.
+//! The target architecture is part of the compile arguments, so devices of
+//! different architectures do not share entries.
+class CompiledBinaryCache {
+ public:
+  static CompiledBinaryCache& get() {
+    static CompiledBinaryCache cache;
+    return cache;
+  }
+
+  //! The cache is bypassed when a compilation is expected to produce logs or
+  //! dump files
+  static bool enabled(const CompileParams& compile_params) {
+    return !isOptionDisabled(DisableOption::CompiledBinaryCache) &&
+        !isOptionEnabled(EnableOption::WarnRegisterSpill) &&
+        !compile_params.enable_ptxas_verbose &&
+        !isDebugDumpEnabled(DebugDumpOption::PrintPtxasLog) &&
+        !isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose) &&
+        !isDebugDumpEnabled(DebugDumpOption::Cubin) &&
+        !isDebugDumpEnabled(DebugDumpOption::Ptx);
+  }
+
+  //! Kernels generated by codegen are keyed by their canonical code, see
+  //! canonicalKernelCode, so that structurally identical kernels of
+  //! different fusions share a binary. Any other source, e.g. one read from
+  //! an external file, is keyed by a hash of the full source code rather than
+  //! the code itself since it contains the whole preamble.
+  static std::string key(
+      std::optional<std::reference_wrapper<const std::string>> kernel_code,
+      const std::string& full_src_code,
+      const std::string& func_name,
+      const std::string& compile_args,
+      const CompileParams& compile_params) {
+    if (kernel_code.has_value() && compile_params.index_type.has_value() &&
+        isGeneratedFrom(full_src_code, kernel_code->get())) {
+      return compile_args + ";" +
+          toString(compile_params.index_type.value()) + ";" +
+          canonicalKernelCode(kernel_code->get(), func_name);
+    }
+    return compile_args + ";" + std::to_string(full_src_code.size()) + ";" +
+        std::to_string(std::hash<std::string>{}(full_src_code));
+  }
+
+  bool query(
+      const std::string& key,
+      std::string& kernel_name,
+      std::vector<char>& binary) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      return false;
+    }
+    kernel_name = it->second.first;
+    binary = it->second.second;
+    return true;
+  }
+
+  void insert(
+      const std::string& key,
+      const std::string& kernel_name,
+      const std::vector<char>& binary) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.emplace(key, std::make_pair(kernel_name, binary));
+  }
+
+ private:
+  mutable std::mutex mutex_;
+  //! Lowered kernel name and cubin or PTX for each key
+  std::unordered_map<std::string, std::pair<std::string, std::vector<char>>>
+      entries_;
+};
+
+#if (CUDA_VERSION >= 12000)
+//! Libraries loaded by the process, keyed by their kernel name and a hash of
+//! their binary, so that the executors of a kernel on different devices load
+//! it once. A library is unloaded with its last CompiledKernel.
+class LoadedLibraryCache {
+ public:
+  static LoadedLibraryCache& get() {
+    static LoadedLibraryCache cache;
+    return cache;
+  }
+
+  //! Returns the loaded library of binary, loading it if needed. Appends the
+  //! log of the load to log.
+  std::shared_ptr<CUlib_st> getOrLoad(
+      const std::string& kernel_name,
+      const std::vector<char>& binary,
+      CuModuleLoadDataDriver& module_load_driver,
+      std::stringstream& log) {
+    const std::string key = kernel_name + ";" + std::to_string(binary.size()) +
+        ";" +
+        std::to_string(std::hash<std::string_view>{}(
+            std::string_view(binary.data(), binary.size())));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = libraries_.find(key);
+    if (it != libraries_.end()) {
+      if (auto library = it->second.lock()) {
+        return library;
+      }
+    }
+    // Drop the entries of unloaded libraries
+    for (auto entry = libraries_.begin(); entry != libraries_.end();) {
+      entry = entry->second.expired() ? libraries_.erase(entry) : ++entry;
+    }
+
+    CUlibrary raw_library = nullptr;
+    log << module_load_driver.invokeLibrary(raw_library, binary.data())
+        << std::endl;
+    std::shared_ptr<CUlib_st> library(raw_library, [](CUlibrary library) {
+      NVFUSER_CUDA_SAFE_CALL(cuLibraryUnload(library));
+    });
+    libraries_[key] = library;
+    return library;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::weak_ptr<CUlib_st>> libraries_;
+};
+#endif
+
+//! Loads the cubin or PTX of compiled_kernel as a module and gets its
+//! function. With EnableOption::LazyKernelLoading, it is loaded as a library
+//! instead, whose kernel is loaded on a device by
+//! CompiledKernel::getFunction.
+void loadCompiledKernel(
+    CompiledKernel* compiled_kernel,
+    CuModuleLoadDataDriver& module_load_driver,
+    bool compile_to_sass,
+    std::stringstream& log) {
+  const std::vector<char>& binary =
+      compile_to_sass ? compiled_kernel->cubin : compiled_kernel->ptx;
+#if (CUDA_VERSION >= 12000)
+  if (isOptionEnabled(EnableOption::LazyKernelLoading)) {
+    compiled_kernel->library = LoadedLibraryCache::get().getOrLoad(
+        compiled_kernel->kernel_name, binary, module_load_driver, log);
+    NVFUSER_CUDA_SAFE_CALL(cuLibraryGetKernel(
+        &(compiled_kernel->kernel),
+        compiled_kernel->library.get(),
+        compiled_kernel->kernel_name.c_str()));
+    return;
+  }
+#endif
+  log << module_load_driver.invoke(compiled_kernel->module, binary.data())
+      << std::endl;
+  NVFUSER_CUDA_SAFE_CALL(cuModuleGetFunction(
+      &(compiled_kernel->function),
+      compiled_kernel->module,
+      compiled_kernel->kernel_name.c_str()));
+}
+
 } // namespace
 
 CompiledKernel::~CompiledKernel() {
@@ -1182,6 +1713,25 @@ CompiledKernel::~CompiledKernel() {
   }
 }
 
+bool CompiledKernel::isLoaded() const {
+#if (CUDA_VERSION >= 12000)
+  if (kernel != nullptr) {
+    return true;
+  }
+#endif
+  return function != nullptr;
+}
+
+CUfunction CompiledKernel::getFunction() const {
+#if (CUDA_VERSION >= 12000)
+  if (function == nullptr && kernel != nullptr) {
+    NVFUSER_CUDA_SAFE_CALL(cuKernelGetFunction(&function, kernel));
+  }
+#endif
+  NVF_ERROR(function != nullptr, "Kernel ", kernel_name, " is not loaded");
+  return function;
+}
+
 // Compile the source if no existing compiled binary is found in KernelDB
 std::unique_ptr<CompiledKernel> getCompiledKernel(
     std::optional<std::reference_wrapper<const std::string>> kernel_code,
@@ -1252,8 +1802,21 @@ std::unique_ptr<CompiledKernel> getCompiledKernel(
   auto& kernel_db = KernelDb::get();
   const auto use_kernel_db = kernel_db.enabled() && kernel_code.has_value();
 
+  auto& binary_cache = CompiledBinaryCache::get();
+  const bool use_binary_cache = CompiledBinaryCache::enabled(compile_params);
+  const std::string binary_cache_key = use_binary_cache
+      ? CompiledBinaryCache::key(
+            kernel_code, full_src_code, func_name, compile_args, compile_params)
+      : std::string();
+  const bool found_binary = use_binary_cache &&
+      binary_cache.query(
+          binary_cache_key,
+          compiled_kernel->kernel_name,
+          (compile_to_sass ? compiled_kernel->cubin : compiled_kernel->ptx));
+
   // If the Kernel Query fails, the Kernel is recompiled
-  if (!(use_kernel_db &&
+  if (!found_binary &&
+      !(use_kernel_db &&
         kernel_db.query(
             kernel_code.value(),
             compile_args,
@@ -1277,11 +1840,15 @@ std::unique_ptr<CompiledKernel> getCompiledKernel(
     }
   }
 
-  log << module_load_driver.invoke(
-             compiled_kernel->module,
-             (compile_to_sass ? compiled_kernel->cubin.data()
-                              : compiled_kernel->ptx.data()))
-      << std::endl;
+  if (use_binary_cache && !found_binary) {
+    binary_cache.insert(
+        binary_cache_key,
+        compiled_kernel->kernel_name,
+        (compile_to_sass ? compiled_kernel->cubin : compiled_kernel->ptx));
+  }
+
+  loadCompiledKernel(
+      compiled_kernel.get(), module_load_driver, compile_to_sass, log);
   compiled_kernel->compile_log = log.str();
   compiled_kernel->compile_args = compile_args;
 
@@ -1291,11 +1858,6 @@ std::unique_ptr<CompiledKernel> getCompiledKernel(
         warnRegisterSpill(compiled_kernel->compile_log);
   }
 
-  NVFUSER_CUDA_SAFE_CALL(cuModuleGetFunction(
-      &(compiled_kernel->function),
-      compiled_kernel->module,
-      compiled_kernel->kernel_name.c_str()));
-
   // Store block size used to generate compile arguments
   if (opt_block_size.has_value()) {
     compiled_kernel->block_size = opt_block_size.value();
@@ -1335,6 +1897,16 @@ std::unique_ptr<CompiledKernel> getCompiledKernel(
     compiled_kernel->ptx_filename = buffer->ptx_filename()->str();
   }
 
+  // With lazy deserialization, blobs stored compressed are only decompressed
+  // when their kernel is first used
+  NVF_CHECK(
+      decompress_blob(compiled_kernel->cubin) &&
+          decompress_blob(compiled_kernel->ptx),
+      "Unable to decompress the binaries of kernel ",
+      compiled_kernel->kernel_name,
+      ". Reading compressed kernel binaries requires nvFuser built with ",
+      "NVFUSER_BUILD_WITH_ZSTD.");
+
   at::cuda::jit::initializeCudaContext();
 
   // The above initialization works in some cases. However, it seems to
@@ -1392,18 +1964,10 @@ std::unique_ptr<CompiledKernel> getCompiledKernel(
       "Expected compiled ptx after deserializing CompiledKernel.");
 
   std::stringstream log;
-  log << module_load_driver.invoke(
-             compiled_kernel->module,
-             (compile_to_sass ? compiled_kernel->cubin.data()
-                              : compiled_kernel->ptx.data()))
-      << std::endl;
+  loadCompiledKernel(
+      compiled_kernel.get(), module_load_driver, compile_to_sass, log);
   compiled_kernel->compile_log = log.str();
 
-  NVFUSER_CUDA_SAFE_CALL(cuModuleGetFunction(
-      &(compiled_kernel->function),
-      compiled_kernel->module,
-      compiled_kernel->kernel_name.c_str()));
-
   return compiled_kernel;
 }
 
@@ -23,6 +23,7 @@
 #include <kernel.h>
 #include <runtime/executor_kernel_arg.h>
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -32,9 +33,32 @@ namespace executor_utils {
 // Include all the functions we might need in generated code
 std::string kernelPreamble();
 
-//! Bind input values to runtime values
-NVF_API ExpressionEvaluator
-bindInputs(const KernelArgumentHolder& args, Fusion* fusion);
+//! Preamble with only the runtime files kernel_code refers to, and the
+//! runtime files they depend on
+std::string kernelPreamble(const std::string& kernel_code);
+
+//! Bind input values to runtime values. Without validate, the inputs are
+//! not checked against the values already bound, e.g., extents shared by
+//! several inputs, which a caller may skip for arguments it has validated
+//! before.
+NVF_API ExpressionEvaluator bindInputs(
+    const KernelArgumentHolder& args,
+    Fusion* fusion,
+    bool validate = true);
+
+//! Nominal FLOP count of the math of a fusion for the extents bound in
+//! expr_eval, used by the FusionProfiler to place segments on the roofline.
+//! Pointwise ops, reductions, and welfords count one FLOP per element they
+//! compute and matmuls 2*M*N*K. Data movement, e.g., sets, casts,
+//! broadcasts, and views, is free.
+struct FlopEstimate {
+  int64_t flops = 0;
+  //! Data type of the operands of the matmuls of the fusion, if any, which
+  //! selects the tensor core peak instead of the CUDA core peak
+  std::optional<DataType> mma_dtype = std::nullopt;
+};
+
+FlopEstimate estimateFlops(Fusion* fusion, ExpressionEvaluator& expr_eval);
 
 NVF_API std::string disassembleBinary(
     const std::vector<char>& cubin,
@@ -45,8 +69,23 @@ NVF_API std::string disassembleBinary(
 struct CompiledKernel : public NonCopyable {
   NVF_API ~CompiledKernel();
 
+  //! Whether the binary is loaded as a module or a library
+  bool isLoaded() const;
+
+  //! Function of the kernel in the current context. The kernel of a library
+  //! is loaded on the device by the first call.
+  NVF_API CUfunction getFunction() const;
+
   CUmodule module = nullptr;
-  CUfunction function = nullptr;
+#if (CUDA_VERSION >= 12000)
+  //! Library loaded instead of module with EnableOption::LazyKernelLoading.
+  //! Libraries are context-independent and shared by the CompiledKernels of
+  //! the same binary, e.g., on different devices.
+  std::shared_ptr<CUlib_st> library;
+  CUkernel kernel = nullptr;
+#endif
+  //! Resolved by getFunction for a library
+  mutable CUfunction function = nullptr;
   std::string compile_log;
   std::vector<char> ptx;
   std::string ptx_filename;
@@ -58,6 +97,13 @@ struct CompiledKernel : public NonCopyable {
   int register_spills = -1;
 };
 
+// Returns the max register count passed as the -maxrregcount ptxas option,
+// if any, given the block size, the heuristic count and the
+// NVFUSER_MAX_REG_COUNT environment variable
+std::optional<int64_t> getMaxRegCount(
+    std::optional<int64_t> opt_block_size,
+    const int64_t max_register_heuristic);
+
 // Returns executable function and the ptxas log from compilation
 std::unique_ptr<CompiledKernel> getCompiledKernel(
     std::optional<std::reference_wrapper<const std::string>> kernel_code,
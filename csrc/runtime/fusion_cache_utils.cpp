@@ -8,28 +8,216 @@
 #include <runtime/fusion_cache_utils.h>
 
 #include <fusion_segmenter.h>
+#include <instrumentation.h>
 #include <ir/all_nodes.h>
 #include <polymorphic_value.h>
 #include <runtime/executor_kernel_arg.h>
+#include <scheduler/runtime_info.h>
 
+#include <ATen/EmptyTensor.h>
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <sstream>
 #include <unordered_set>
 
 namespace nvfuser {
 
 namespace {
 
-// Copy bytes of value to back of buffer. This is templated in order to avoid
+// Sinks consume the bytes of an input encoding. The encoding is only
+// materialized as a string for new input sets; known input sets are hashed
+// and compared in place.
+
+// Appends the encoding to a string
+class EncodingWriter {
+ public:
+  explicit EncodingWriter(std::string& buffer) : buffer_(buffer) {}
+
+  void append(const char* data, size_t size) {
+    buffer_.append(data, size);
+  }
+
+ private:
+  std::string& buffer_;
+};
+
+// Computes a 128-bit hash of the encoding. Bytes are packed into 64-bit words
+// so that hashing the encoding in pieces gives the same result as hashing the
+// whole string.
+class EncodingHasher {
+ public:
+  void append(const char* data, size_t size) {
+    length_ += size;
+    if (shift_ == 0) {
+      for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t)) {
+        uint64_t word = 0;
+        std::memcpy(&word, data, sizeof(uint64_t));
+        mix(word);
+        data += sizeof(uint64_t);
+      }
+    }
+    for (; size > 0; --size) {
+      word_ |= (uint64_t)(uint8_t)*(data++) << shift_;
+      shift_ += 8;
+      if (shift_ == 64) {
+        mix(word_);
+        word_ = 0;
+        shift_ = 0;
+      }
+    }
+  }
+
+  InputsIdLookup::EncodingHash digest() const {
+    uint64_t low = low_;
+    uint64_t high = high_;
+    if (shift_ != 0) {
+      low = (low ^ word_) * kMulLow;
+      high = (high ^ rotl(word_, 29)) * kMulHigh;
+    }
+    low ^= length_;
+    high ^= length_;
+    low += high;
+    high += low;
+    return {finalize(low), finalize(high)};
+  }
+
+ private:
+  static constexpr uint64_t kMulLow = 0x87c37b91114253d5ULL;
+  static constexpr uint64_t kMulHigh = 0x4cf5ad432745937fULL;
+
+  static uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+  }
+
+  // MurmurHash3 64-bit finalizer
+  static uint64_t finalize(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+  }
+
+  void mix(uint64_t word) {
+    low_ = rotl((low_ ^ word) * kMulLow, 31) * kMulHigh;
+    high_ = rotl((high_ ^ rotl(word, 29)) * kMulHigh, 33) * kMulLow;
+  }
+
+  uint64_t low_ = 0x9e3779b97f4a7c15ULL;
+  uint64_t high_ = 0x6a09e667f3bcc909ULL;
+  uint64_t word_ = 0;
+  int shift_ = 0;
+  uint64_t length_ = 0;
+};
+
+// Compares the encoding with a previously stored one
+class EncodingMatcher {
+ public:
+  explicit EncodingMatcher(const std::string& encoding)
+      : encoding_(encoding) {}
+
+  void append(const char* data, size_t size) {
+    if (!matched_ || pos_ + size > encoding_.size() ||
+        std::memcmp(encoding_.data() + pos_, data, size) != 0) {
+      matched_ = false;
+      return;
+    }
+    pos_ += size;
+  }
+
+  bool matched() const {
+    return matched_ && pos_ == encoding_.size();
+  }
+
+ private:
+  const std::string& encoding_;
+  size_t pos_ = 0;
+  bool matched_ = true;
+};
+
+// Copy bytes of value to the sink. This is templated in order to avoid
 // implicit cast such as int64_t -> size_t that might lose information.
-template <typename T>
-void encodeBuffer(T value, std::string& buffer) {
-  const char* v = reinterpret_cast<char*>(&value);
-  for (const auto i : c10::irange(sizeof(T))) {
-    (void)i; // Suppress unused variable warning
-    buffer.push_back(*(v++));
+template <typename T, typename Sink>
+void encodeBuffer(T value, Sink& sink) {
+  sink.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename Sink>
+void encodeChar(char value, Sink& sink) {
+  sink.append(&value, 1);
+}
+
+template <typename Sink>
+void encodeInputs(
+    const at::ArrayRef<c10::IValue>& inputs,
+    const std::unordered_set<size_t>& scalar_inputs_to_record,
+    int8_t device,
+    Sink& sink) {
+  encodeBuffer(device, sink);
+  for (const auto i : c10::irange(inputs.size())) {
+    const auto& input = inputs[i];
+    if (input.isTensor()) {
+      const auto& input_tensor = input.toTensor();
+
+      for (auto size : input_tensor.sizes()) {
+        encodeBuffer(size, sink);
+        encodeChar(' ', sink);
+      }
+      encodeChar('X', sink);
+      encodeChar(' ', sink);
+      for (auto stride : input_tensor.strides()) {
+        encodeBuffer(stride, sink);
+        encodeChar(' ', sink);
+      }
+      encodeChar('a', sink);
+      encodeBuffer(
+          SchedulerRuntimeInfo::computeAlignmentSize(
+              (size_t)input_tensor.data_ptr()),
+          sink);
+      // NOTE: device is set for the whole set of inputs first using device arg
+    } else {
+      // encode s for scalar;
+      encodeChar('s', sink);
+      if (scalar_inputs_to_record.find(i) != scalar_inputs_to_record.end()) {
+        // Add value of scalars here only if it is one of the scalars
+        // provided, as these are used in determining concretization.
+        // Note that although most commonly these will be Int or Bool scalars,
+        // any DataType might appear via `cast` and `where`, so we handle all
+        // cases here.
+        if (input.isInt()) {
+          encodeBuffer(input.toInt(), sink);
+        } else if (input.isBool()) {
+          encodeBuffer(input.toBool(), sink);
+        } else if (input.isDouble()) {
+          encodeBuffer(input.toDouble(), sink);
+        } else if (input.isComplexDouble()) {
+          encodeBuffer(input.toComplexDouble(), sink);
+        } else {
+          NVF_THROW(
+              "Unhandled input type when creating input ID. Cannot record ",
+              input);
+        }
+      }
+    }
+    encodeChar(';', sink);
   }
 }
+
 } // namespace
 
+std::string PeakMemoryStats::toString() const {
+  std::stringstream ss;
+  ss << "PeakMemoryStats {peak: " << peak_bytes
+     << " B, outputs: " << output_bytes
+     << " B, intermediates: " << intermediate_bytes
+     << " B, work buffers: " << work_buffer_bytes
+     << " B, semaphores: " << semaphore_bytes << " B}";
+  return ss.str();
+}
+
 ArgumentManager::ArgumentManager(
     KernelArgumentHolder& args,
     const RuntimeWorkSpace& runtime_workspace,
@@ -75,15 +263,60 @@ void ArgumentManager::addOutputsToArgsAndTensorMap(
       fusion_args_.push(group_runtime_outputs[group_out_i]);
     }
     runtime_output = fusion_args_.back();
+    if (peak_memory_ != nullptr) {
+      accountSegmentOutput(output, *runtime_output);
+    }
   }
 }
 
+void ArgumentManager::accountSegmentOutput(
+    Val* output,
+    const PolymorphicValue& value) {
+  if (!value.is<at::Tensor>() || !value.as<at::Tensor>().defined()) {
+    return;
+  }
+  const at::Tensor& tensor = value.as<at::Tensor>();
+  // Output sizes inferred without running the segments are meta tensors, so
+  // the bytes are computed from the metadata rather than the storage
+  const auto bytes = (int64_t)at::detail::computeStorageNbytes(
+      tensor.sizes(), tensor.strides(), tensor.itemsize());
+  if (output->isFusionOutput()) {
+    // Aliases of fusion inputs do not allocate
+    if (output->fusion()->getOutputAlias(output).type ==
+        AllocationType::New) {
+      peak_memory_->output_bytes += bytes;
+    }
+    return;
+  }
+  live_intermediate_bytes_[output] = bytes;
+  total_intermediate_bytes_ += bytes;
+}
+
+void ArgumentManager::updatePeakMemory() {
+  PeakMemoryStats& stats = *peak_memory_;
+  stats.intermediate_bytes =
+      std::max(stats.intermediate_bytes, total_intermediate_bytes_);
+  stats.work_buffer_bytes =
+      std::max(stats.work_buffer_bytes, segment_work_buffer_bytes_);
+  stats.semaphore_bytes =
+      std::max(stats.semaphore_bytes, segment_semaphore_bytes_);
+  stats.peak_bytes = std::max(
+      stats.peak_bytes,
+      stats.output_bytes + total_intermediate_bytes_ +
+          segment_work_buffer_bytes_ + segment_semaphore_bytes_);
+  segment_work_buffer_bytes_ = 0;
+  segment_semaphore_bytes_ = 0;
+}
+
 template <typename T>
 void ArgumentManager::updateWithSegmentOutputs(
     const std::vector<Val*>& group_outputs,
     const T& group_runtime_outputs,
     const int64_t group_id) {
   addOutputsToArgsAndTensorMap(group_outputs, group_runtime_outputs);
+  if (peak_memory_ != nullptr) {
+    updatePeakMemory();
+  }
   deleteUnusedArgs(group_id);
 }
 
@@ -181,10 +414,33 @@ void ArgumentManager::deleteUnusedArgs(int64_t run_order_id) {
     for (auto val : vals_last_used_at_segment_[run_order_id]) {
       fusion_args_.erase(tensor_map_.at(val));
       tensor_map_.erase(val);
+      if (auto it = live_intermediate_bytes_.find(val);
+          it != live_intermediate_bytes_.end()) {
+        total_intermediate_bytes_ -= it->second;
+        live_intermediate_bytes_.erase(it);
+      }
     }
   }
 }
 
+std::string inputsSignature(const KernelArgumentHolder& args) {
+  std::stringstream ss;
+  bool first = true;
+  for (const auto& arg : args) {
+    if (!first) {
+      ss << " ";
+    }
+    first = false;
+    if (arg->is<at::Tensor>()) {
+      const auto& tensor = arg->as<at::Tensor>();
+      ss << tensor.scalar_type() << tensor.sizes();
+    } else {
+      ss << "scalar";
+    }
+  }
+  return ss.str();
+}
+
 void prepareRuntimeOrder(
     SegmentedFusion* segmented_fusion,
     RuntimeWorkSpace& runtime_workspace) {
@@ -245,6 +501,224 @@ void prepareRuntimeOrder(
   }
 }
 
+ShapeBucketPolicy::ShapeBucketPolicy(std::vector<Dimension> dimensions)
+    : dimensions_(std::move(dimensions)) {
+  for (const auto& dimension : dimensions_) {
+    NVF_CHECK(
+        dimension.input_index >= 0,
+        "Invalid input index for a bucketed dimension: ",
+        dimension.input_index);
+    NVF_CHECK(
+        std::is_sorted(
+            dimension.boundaries.begin(), dimension.boundaries.end()) &&
+            std::adjacent_find(
+                dimension.boundaries.begin(), dimension.boundaries.end()) ==
+                dimension.boundaries.end(),
+        "Bucket boundaries must be strictly increasing");
+    NVF_CHECK(
+        dimension.boundaries.empty() || dimension.boundaries.front() > 1,
+        "Bucket boundaries must be larger than one");
+  }
+}
+
+ShapeBucketPolicy ShapeBucketPolicy::powersOfTwo(
+    const std::vector<std::pair<int64_t, int64_t>>& input_dims) {
+  std::vector<Dimension> dimensions;
+  dimensions.reserve(input_dims.size());
+  for (auto [input_index, dim] : input_dims) {
+    dimensions.push_back({input_index, dim, {}});
+  }
+  return ShapeBucketPolicy(std::move(dimensions));
+}
+
+std::optional<int64_t> ShapeBucketPolicy::bucketUpperBound(
+    const Dimension& dimension,
+    int64_t extent) const {
+  // Size-0 and size-1 extents determine the structure of the fusion, e.g.
+  // broadcasts, so they are never bucketed
+  if (extent <= 1) {
+    return std::nullopt;
+  }
+  if (dimension.boundaries.empty()) {
+    int64_t upper_bound = 1;
+    while (upper_bound < extent) {
+      upper_bound *= 2;
+    }
+    return upper_bound;
+  }
+  auto it = std::lower_bound(
+      dimension.boundaries.begin(), dimension.boundaries.end(), extent);
+  if (it == dimension.boundaries.end()) {
+    return std::nullopt;
+  }
+  return *it;
+}
+
+int64_t ShapeBucketPolicy::representativeExtent(
+    int64_t extent,
+    int64_t upper_bound) {
+  NVF_ERROR(extent > 0 && extent <= upper_bound);
+  constexpr int64_t max_factor = 16;
+  const int64_t factor = std::min(extent & -extent, max_factor);
+  if (factor == max_factor) {
+    return upper_bound / max_factor * max_factor;
+  }
+  // Largest value not above upper_bound that is an odd multiple of factor.
+  // extent is such a value, so the result is never smaller than extent.
+  return (upper_bound - factor) / (2 * factor) * (2 * factor) + factor;
+}
+
+std::optional<KernelArgumentHolder> ShapeBucketPolicy::bucketArgs(
+    const KernelArgumentHolder& args) const {
+  FUSER_PERF_SCOPE("ShapeBucketPolicy::bucketArgs");
+  if (dimensions_.empty()) {
+    return std::nullopt;
+  }
+
+  // Representative sizes of the inputs with at least one bucketed extent
+  std::unordered_map<int64_t, std::vector<int64_t>> bucketed_sizes;
+  for (const auto& dimension : dimensions_) {
+    if (dimension.input_index >= (int64_t)args.size() ||
+        !args[dimension.input_index]->is<at::Tensor>()) {
+      continue;
+    }
+    const auto& tensor = args[dimension.input_index]->as<at::Tensor>();
+    if (!tensor.is_cuda() && !tensor.is_meta()) {
+      continue;
+    }
+    const int64_t rank = tensor.dim();
+    const int64_t dim = dimension.dim < 0 ? dimension.dim + rank : dimension.dim;
+    if (dim < 0 || dim >= rank) {
+      continue;
+    }
+    auto upper_bound = bucketUpperBound(dimension, tensor.size(dim));
+    if (!upper_bound.has_value()) {
+      continue;
+    }
+    auto [it, inserted] =
+        bucketed_sizes.try_emplace(dimension.input_index, tensor.sizes().vec());
+    it->second.at(dim) =
+        representativeExtent(tensor.size(dim), upper_bound.value());
+  }
+  if (bucketed_sizes.empty()) {
+    return std::nullopt;
+  }
+
+  KernelArgumentHolder bucketed_args;
+  bucketed_args.setDeviceIndex(args.getDeviceIndex());
+  if (args.getCacheId().has_value()) {
+    bucketed_args.setCacheId(args.getCacheId().value());
+  }
+  for (auto i : c10::irange((int64_t)args.size())) {
+    auto sizes_it = bucketed_sizes.find(i);
+    if (sizes_it == bucketed_sizes.end()) {
+      bucketed_args.push(*args[i]);
+      continue;
+    }
+    const auto& tensor = args[i]->as<at::Tensor>();
+    if (SchedulerRuntimeInfo::computeAlignmentSize(
+            (size_t)tensor.data_ptr()) <
+        SchedulerRuntimeInfo::max_alignment_size_in_byte) {
+      return std::nullopt;
+    }
+
+    // Order dimensions from outermost to innermost by stride. Size-1 and
+    // expanded dimensions do not affect the memory layout.
+    std::vector<int64_t> stride_order(tensor.dim());
+    std::iota(stride_order.begin(), stride_order.end(), 0);
+    std::stable_sort(
+        stride_order.begin(), stride_order.end(), [&](int64_t a, int64_t b) {
+          return tensor.stride(a) > tensor.stride(b);
+        });
+    int64_t expected_stride = 1;
+    for (auto it = stride_order.rbegin(); it != stride_order.rend(); ++it) {
+      if (tensor.size(*it) <= 1 || tensor.stride(*it) == 0) {
+        continue;
+      }
+      if (tensor.stride(*it) != expected_stride) {
+        return std::nullopt;
+      }
+      expected_stride *= tensor.size(*it);
+    }
+
+    // Recompute dense strides for the representative sizes in the same order
+    const auto& sizes = sizes_it->second;
+    std::vector<int64_t> strides(tensor.dim(), 0);
+    int64_t stride = 1;
+    for (auto it = stride_order.rbegin(); it != stride_order.rend(); ++it) {
+      if (tensor.stride(*it) == 0 && tensor.size(*it) > 1) {
+        continue;
+      }
+      strides.at(*it) = stride;
+      stride *= std::max(sizes.at(*it), (int64_t)1);
+    }
+    bucketed_args.push(at::Tensor(at::detail::empty_strided_meta(
+        sizes,
+        strides,
+        tensor.scalar_type(),
+        c10::nullopt,
+        c10::Device(c10::DeviceType::Meta, 0),
+        c10::nullopt)));
+  }
+  return bucketed_args;
+}
+
+IntermediateArenaPlan::IntermediateArenaPlan(std::vector<Buffer> buffers)
+    : buffers_(std::move(buffers)), offsets_(buffers_.size(), 0) {
+  FUSER_PERF_SCOPE("IntermediateArenaPlan::IntermediateArenaPlan");
+  for (const auto& buffer : buffers_) {
+    NVF_ERROR(
+        buffer.num_bytes >= 0 && buffer.first_use <= buffer.last_use,
+        "Invalid buffer of ",
+        buffer.num_bytes,
+        " bytes live from ",
+        buffer.first_use,
+        " to ",
+        buffer.last_use);
+  }
+
+  const auto round_up = [](int64_t num_bytes) {
+    return (num_bytes + alignment - 1) / alignment * alignment;
+  };
+
+  std::vector<int64_t> order(buffers_.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+    return buffers_.at(a).num_bytes > buffers_.at(b).num_bytes;
+  });
+
+  // Placed buffers as (offset, end) pairs, gathered per buffer for those
+  // whose live ranges intersect
+  std::vector<int64_t> placed;
+  std::vector<std::pair<int64_t, int64_t>> conflicts;
+  for (int64_t i : order) {
+    const Buffer& buffer = buffers_.at(i);
+    conflicts.clear();
+    for (int64_t j : placed) {
+      const Buffer& other = buffers_.at(j);
+      if (other.first_use <= buffer.last_use &&
+          buffer.first_use <= other.last_use) {
+        conflicts.emplace_back(
+            offsets_.at(j), offsets_.at(j) + round_up(other.num_bytes));
+      }
+    }
+    std::sort(conflicts.begin(), conflicts.end());
+
+    // First fit into the gaps between conflicting buffers
+    const int64_t num_bytes = round_up(buffer.num_bytes);
+    int64_t offset = 0;
+    for (const auto& [begin, end] : conflicts) {
+      if (offset + num_bytes <= begin) {
+        break;
+      }
+      offset = std::max(offset, end);
+    }
+    offsets_.at(i) = offset;
+    arena_bytes_ = std::max(arena_bytes_, offset + num_bytes);
+    placed.push_back(i);
+  }
+}
+
 flatbuffers::Offset<serde::InputsIdLookup> InputsIdLookup::serialize(
     flatbuffers::FlatBufferBuilder& builder) const {
   // See definitions in serde/fusion_cache.fbs for table
@@ -254,21 +728,23 @@ flatbuffers::Offset<serde::InputsIdLookup> InputsIdLookup::serialize(
 
   // For serialization, we require a consistent ordering for the
   // encoding_lookup_ map.
-  std::unordered_map<std::string, size_t> str_key_ordering;
+  std::unordered_map<const std::string*, size_t> str_key_ordering;
 
   // 1. Serialize used_entry_ list
   std::vector<fb_string> lru_cache_fb;
   for (const auto& str : used_entry_) {
     lru_cache_fb.push_back(builder.CreateString(str));
-    str_key_ordering.emplace(str, str_key_ordering.size());
+    str_key_ordering.emplace(&str, str_key_ordering.size());
   }
 
-  // 2. Serialize encoding_lookup_ map
+  // 2. Serialize encoding_lookup_ map. The hashes are recomputed from the
+  // encodings during deserialization.
   std::vector<fb_string> encoding_lookup_keys_fb;
   std::vector<serde::EncodingEntry> encoding_lookup_values_fb;
-  for (auto&& [key, value] : encoding_lookup_) {
-    encoding_lookup_keys_fb.push_back(builder.CreateString(key));
-    encoding_lookup_values_fb.emplace_back(value.id, str_key_ordering.at(key));
+  for (auto&& [hash, value] : encoding_lookup_) {
+    encoding_lookup_keys_fb.push_back(builder.CreateString(*value.lru_iter));
+    encoding_lookup_values_fb.emplace_back(
+        value.id, str_key_ordering.at(&*value.lru_iter));
   }
 
   return serde::CreateInputsIdLookupDirect(
@@ -301,93 +777,72 @@ void InputsIdLookup::deserialize(const serde::InputsIdLookup* buffer) {
     EncodingEntry entry{
         fb_encoding_entry->id(),
         used_entry_iterators.at(fb_encoding_entry->lru_iter())};
-    encoding_lookup_.emplace(fb_encoding_lookup_str->str(), entry);
+    encoding_lookup_.emplace(
+        hashEncoding(fb_encoding_lookup_str->str()), entry);
   }
 }
 
+InputsIdLookup::EncodingHash InputsIdLookup::hashEncoding(
+    const std::string& encoding) {
+  EncodingHasher hasher;
+  hasher.append(encoding.data(), encoding.size());
+  return hasher.digest();
+}
+
 InputsIdLookup::IdLookupReturn InputsIdLookup::lookupId(
     const at::ArrayRef<c10::IValue>& inputs,
     const std::unordered_set<size_t>& scalar_inputs_to_record,
     int8_t device) {
+  FUSER_PERF_SCOPE("InputsIdLookup::lookupId");
   IdLookupReturn ret;
 
-  // lock mutex_ because we are touching encoding_
-  std::lock_guard<std::mutex> guard(mutex_);
-  encoding_.clear();
-  encodeBuffer(device, encoding_);
-  for (const auto i : c10::irange(inputs.size())) {
-    auto input = inputs[i];
-    if (input.isTensor()) {
-      auto& input_tensor = input.toTensor();
-
-      for (auto size : input_tensor.sizes()) {
-        encodeBuffer(size, encoding_);
-        encoding_.push_back(' ');
-      }
-      encoding_.push_back('X');
-      encoding_.push_back(' ');
-      for (auto stride : input_tensor.strides()) {
-        encodeBuffer(stride, encoding_);
-        encoding_.push_back(' ');
-      }
-      encoding_.push_back('a');
-      encodeBuffer(
-          SchedulerRuntimeInfo::computeAlignmentSize(
-              (size_t)input_tensor.data_ptr()),
-          encoding_);
-      // NOTE: device is set for the whole set of inputs first using device arg
-    } else {
-      // encode s for scalar;
-      encoding_.push_back('s');
-      if (scalar_inputs_to_record.find(i) != scalar_inputs_to_record.end()) {
-        // Add value of scalars here only if it is one of the scalars
-        // provided, as these are used in determining concretization.
-        // Note that although most commonly these will be Int or Bool scalars,
-        // any DataType might appear via `cast` and `where`, so we handle all
-        // cases here.
-        if (input.isInt()) {
-          encodeBuffer(input.toInt(), encoding_);
-        } else if (input.isBool()) {
-          encodeBuffer(input.toBool(), encoding_);
-        } else if (input.isDouble()) {
-          encodeBuffer(input.toDouble(), encoding_);
-        } else if (input.isComplexDouble()) {
-          encodeBuffer(input.toComplexDouble(), encoding_);
-        } else {
-          NVF_THROW(
-              "Unhandled input type when creating input ID. Cannot record ",
-              input);
-        }
-      }
-    }
-    encoding_.push_back(';');
-  }
+  EncodingHasher hasher;
+  encodeInputs(inputs, scalar_inputs_to_record, device, hasher);
+  const EncodingHash hash = hasher.digest();
 
-  auto& entry = encoding_lookup_[encoding_];
+  // lock mutex_ because we are touching encoding_ and the LRU cache
+  std::lock_guard<std::mutex> guard(mutex_);
 
-  if (entry.id == 0) {
-    // no entry existed for given input set, set id for given entry
-    entry.id = current_id_++;
-    if (used_entry_.size() == max_cache_size_) {
-      // pop least recently used cache;
-      const auto& remove_iter = encoding_lookup_.find(used_entry_.back());
-      used_entry_.pop_back();
-      ret.evict_id = remove_iter->second.id;
-      ret.eviction = true;
-      encoding_lookup_.erase(remove_iter);
+  // Verify the full encoding on hash hits
+  auto [hits_begin, hits_end] = encoding_lookup_.equal_range(hash);
+  for (auto it = hits_begin; it != hits_end; ++it) {
+    EncodingMatcher matcher(*it->second.lru_iter);
+    encodeInputs(inputs, scalar_inputs_to_record, device, matcher);
+    if (!matcher.matched()) {
+      continue;
     }
-  } else {
-    // short-cut to leave LRU entry as is
-    if (entry.lru_iter == used_entry_.begin()) {
-      ret.id = entry.id;
-      return ret;
+    // short-cut to leave LRU entry as is. Otherwise, move the entry to the
+    // front without reallocating it.
+    if (it->second.lru_iter != used_entry_.begin()) {
+      used_entry_.splice(
+          used_entry_.begin(), used_entry_, it->second.lru_iter);
     }
+    ret.id = it->second.id;
+    return ret;
+  }
 
-    used_entry_.erase(entry.lru_iter);
+  // no entry existed for given input set, set id for given entry
+  ret.id = current_id_++;
+  if (used_entry_.size() == max_cache_size_) {
+    // pop least recently used cache;
+    auto lru_iter = std::prev(used_entry_.end());
+    auto [lru_begin, lru_end] = encoding_lookup_.equal_range(
+        hashEncoding(*lru_iter));
+    auto remove_iter = std::find_if(lru_begin, lru_end, [&](const auto& kv) {
+      return kv.second.lru_iter == lru_iter;
+    });
+    NVF_ERROR(remove_iter != lru_end);
+    ret.evict_id = remove_iter->second.id;
+    ret.eviction = true;
+    encoding_lookup_.erase(remove_iter);
+    used_entry_.pop_back();
   }
 
-  ret.id = entry.id;
-  entry.lru_iter = used_entry_.insert(used_entry_.begin(), encoding_);
+  encoding_.clear();
+  EncodingWriter writer(encoding_);
+  encodeInputs(inputs, scalar_inputs_to_record, device, writer);
+  used_entry_.push_front(encoding_);
+  encoding_lookup_.emplace(hash, EncodingEntry{ret.id, used_entry_.begin()});
   return ret;
 }
 
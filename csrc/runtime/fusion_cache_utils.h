@@ -16,7 +16,9 @@
 
 #include <list>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -25,10 +27,32 @@ namespace nvfuser {
 class SegmentedGroup;
 class SegmentedFusion;
 
+//! Device memory allocated by an execution of a FusionKernelRuntime, in
+//! bytes. Fusion inputs are owned by the caller and not included. Segment
+//! outputs are counted by their storage, so an intermediate that is a view
+//! of another one is counted twice.
+struct PeakMemoryStats {
+  //! Fusion outputs allocated by the segments, which are live until the end
+  int64_t output_bytes = 0;
+  //! Peak of the live segment outputs that are not fusion outputs
+  int64_t intermediate_bytes = 0;
+  //! Largest global work buffers of a segment that are not zeroed, e.g.,
+  //! intermediate global tensors. They are freed when the segment completes.
+  int64_t work_buffer_bytes = 0;
+  //! Largest zeroed work buffers of a segment, e.g., grid sync semaphores
+  int64_t semaphore_bytes = 0;
+  //! Peak of the sum of the above while a segment runs
+  int64_t peak_bytes = 0;
+
+  std::string toString() const;
+};
+
 // Utilities for benchmarking and profiling
 struct ExecutorLog {
   std::unique_ptr<HeuristicParams> params = nullptr;
   ExecutorAbstract* fusion_executor = nullptr;
+  //! Memory of the most recent execution of the runtime
+  PeakMemoryStats peak_memory;
 };
 
 struct RuntimeWorkSpace {
@@ -43,6 +67,12 @@ struct RuntimeWorkSpace {
 // Fusion
 void prepareRuntimeOrder(SegmentedFusion*, RuntimeWorkSpace&);
 
+//! Sizes and dtypes of the tensor arguments, which key the records of a
+//! KernelPerfDb and of a HeuristicSnapshot. Scalar values, e.g., RNG seeds,
+//! may change between runs of the same kernel, so they only appear as
+//! placeholders.
+std::string inputsSignature(const KernelArgumentHolder& args);
+
 //! Simple hasher for pair<T, const U*>. There is no default hasher for pairs,
 //! since there are a lot of options how to combine hashes. In a case where one
 //! element of the pair is unlikely to change much, the following hash is fast
@@ -78,6 +108,17 @@ struct PairPointerEquals {
   }
 };
 
+//! Hashes a vector of integers, e.g. input sizes used as a cache key
+struct Int64VectorHash {
+  size_t operator()(const std::vector<int64_t>& values) const {
+    size_t hash = 0;
+    for (auto value : values) {
+      hashCombine(hash, std::hash<int64_t>{}(value));
+    }
+    return hash;
+  }
+};
+
 // This ArgumentManager do two things
 // (1) add outputs from a segment to the global fusion args to pass it to next
 // segment (2) delete args no longer being used to save memory. For task (2), it
@@ -104,6 +145,20 @@ class ArgumentManager {
       const T& group_runtime_outputs,
       const int64_t group_id);
 
+  //! Account the tensors produced by the segments in stats from now on
+  void trackPeakMemory(PeakMemoryStats* stats) {
+    peak_memory_ = stats;
+  }
+
+  //! Set the work buffers of the segment whose outputs are added next. They
+  //! are live on top of the tensors already live while the segment runs.
+  void setSegmentWorkBufferBytes(
+      int64_t work_buffer_bytes,
+      int64_t semaphore_bytes) {
+    segment_work_buffer_bytes_ = work_buffer_bytes;
+    segment_semaphore_bytes_ = semaphore_bytes;
+  }
+
   std::string toString() const {
     std::stringstream ss;
     ss << "ArgumentManager {";
@@ -122,6 +177,17 @@ class ArgumentManager {
   // map segment_id to vector of fusion vals lastly used at this segment
   std::unordered_map<int64_t, std::vector<Val*>> vals_last_used_at_segment_;
 
+  // Memory accounting, see trackPeakMemory
+  PeakMemoryStats* peak_memory_ = nullptr;
+  std::unordered_map<Val*, int64_t> live_intermediate_bytes_;
+  int64_t total_intermediate_bytes_ = 0;
+  int64_t segment_work_buffer_bytes_ = 0;
+  int64_t segment_semaphore_bytes_ = 0;
+
+  void accountSegmentOutput(Val* output, const PolymorphicValue& value);
+
+  void updatePeakMemory();
+
   void mapFusionInputsToArgs(
       const std::vector<Val*>& fusion_inputs,
       const std::vector<Val*>& group_extent_binding_order);
@@ -137,6 +203,113 @@ class ArgumentManager {
       const T& group_runtime_outputs);
 };
 
+//! ShapeBucketPolicy maps the extents of selected input dimensions to buckets
+//! so that a single FusionKernelRuntime serves every input shape in a bucket.
+//!
+//! FusionExecutorCache segments and schedules a fusion with a metadata copy of
+//! the inputs in which each bucketed extent is replaced by a representative
+//! extent of its bucket. Inputs in the same bucket therefore produce the same
+//! heuristics and re-use the same compiled kernels, which already take their
+//! extents as runtime arguments and predicate every access.
+//!
+//! The representative extent is the largest extent of the bucket that is
+//! divisible by the same power of two (up to 16) as the actual extent. This
+//! keeps vectorization decisions valid for the actual inputs.
+//!
+//! Bucketing is skipped for a set of inputs if any tensor with a bucketed
+//! dimension is not densely packed in its stride order or is not aligned to
+//! 16 bytes, since the representative metadata could not reproduce them.
+class ShapeBucketPolicy {
+ public:
+  //! A bucketed dimension of a fusion input tensor. Negative dims count from
+  //! the innermost dimension. When boundaries is empty, extents are rounded
+  //! up to the next power of two. Otherwise, boundaries must be increasing
+  //! and extents are rounded up to the next boundary; extents beyond the last
+  //! boundary are not bucketed.
+  struct Dimension {
+    int64_t input_index = 0;
+    int64_t dim = 0;
+    std::vector<int64_t> boundaries;
+  };
+
+  ShapeBucketPolicy() = default;
+
+  NVF_API explicit ShapeBucketPolicy(std::vector<Dimension> dimensions);
+
+  //! Bucket the given dimensions by powers of two
+  NVF_API static ShapeBucketPolicy powersOfTwo(
+      const std::vector<std::pair<int64_t, int64_t>>& input_dims);
+
+  const std::vector<Dimension>& dimensions() const {
+    return dimensions_;
+  }
+
+  //! Returns the upper bound of the bucket containing extent, or std::nullopt
+  //! if the extent does not fall into any bucket
+  NVF_API std::optional<int64_t> bucketUpperBound(
+      const Dimension& dimension,
+      int64_t extent) const;
+
+  //! Returns the representative extent used in place of extent
+  NVF_API static int64_t representativeExtent(
+      int64_t extent,
+      int64_t upper_bound);
+
+  //! Returns a metadata copy of args with every bucketed extent replaced by
+  //! its representative extent, or std::nullopt if no extent is bucketed or
+  //! the inputs cannot be bucketed.
+  NVF_API std::optional<KernelArgumentHolder> bucketArgs(
+      const KernelArgumentHolder& args) const;
+
+ private:
+  std::vector<Dimension> dimensions_;
+};
+
+//! IntermediateArenaPlan assigns offsets within a single arena to buffers
+//! with known live ranges, e.g. the tensors passed between the segments of a
+//! segmented fusion.
+//!
+//! A live range is an inclusive interval of segment run order ids, from the
+//! segment that writes a buffer to the last segment that reads it. Buffers
+//! may share memory only if their live ranges are disjoint. Offsets are
+//! assigned greedily, largest buffer first, each at the lowest aligned offset
+//! that does not overlap a placed buffer with an intersecting live range.
+class IntermediateArenaPlan {
+ public:
+  struct Buffer {
+    int64_t num_bytes = 0;
+    int64_t first_use = 0;
+    int64_t last_use = 0;
+  };
+
+  //! Alignment of every offset. It is the granularity of the CUDA caching
+  //! allocator, so buffers are aligned as if they were allocated separately.
+  static constexpr int64_t alignment = 512;
+
+  IntermediateArenaPlan() = default;
+
+  NVF_API explicit IntermediateArenaPlan(std::vector<Buffer> buffers);
+
+  const std::vector<Buffer>& buffers() const {
+    return buffers_;
+  }
+
+  //! Byte offset of each buffer in the arena
+  const std::vector<int64_t>& offsets() const {
+    return offsets_;
+  }
+
+  //! Size of the arena needed to hold all buffers
+  int64_t arenaBytes() const {
+    return arena_bytes_;
+  }
+
+ private:
+  std::vector<Buffer> buffers_;
+  std::vector<int64_t> offsets_;
+  int64_t arena_bytes_ = 0;
+};
+
 //! Encoding an input set to unique id, which is used to short-cut cache entry
 //! selection in our nested cache implementation to cut off overhead.
 //!
@@ -204,15 +377,37 @@ class InputsIdLookup : public NonCopyable {
   //! Deserialize InputsIdLookup using flatbuffers
   void deserialize(const serde::InputsIdLookup* buffer);
 
+  //! 128-bit hash of an input encoding
+  struct EncodingHash {
+    uint64_t low = 0;
+    uint64_t high = 0;
+
+    bool operator==(const EncodingHash& other) const {
+      return low == other.low && high == other.high;
+    }
+  };
+
+  //! Hash of an encoded string, the same as computed by lookupId for the
+  //! inputs it encodes
+  NVF_API static EncodingHash hashEncoding(const std::string& encoding);
+
  private:
-  // string to store encoded input meta information. Reuse the buffer instead of
-  // stringtream gives few us perf gain.
+  struct EncodingHashHash {
+    size_t operator()(const EncodingHash& hash) const {
+      return (size_t)hash.low;
+    }
+  };
+
+  // string to store the encoding of a new input set. Reuse the buffer instead
+  // of stringtream gives few us perf gain. Lookups of known input sets only
+  // hash and compare the encoding in place without building it.
   std::string encoding_; // Note: shared state, guarded by mutex_
 
   // mutex_ used to guard reused encoding_
   std::mutex mutex_;
 
-  //! entry stored in `encoding_lookup_` to implement LRU
+  //! entry stored in `encoding_lookup_` to implement LRU. lru_iter points to
+  //! the full encoding, which is compared on hash hits.
   // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
   struct EncodingEntry {
     size_t id = 0;
@@ -231,10 +426,11 @@ class InputsIdLookup : public NonCopyable {
   //! the beginning)
   std::list<std::string> used_entry_;
 
-  //! map from `std::string` to a unique id `size_t` (packaged in
-  //! `EncodingEntry`
-  //! ). We store an iterator to `used_entry_` to implement LRU
-  std::unordered_map<std::string, EncodingEntry> encoding_lookup_;
+  //! map from the hash of an encoding to a unique id `size_t` (packaged in
+  //! `EncodingEntry`). Distinct encodings with colliding hashes are kept as
+  //! separate entries. We store an iterator to `used_entry_` to implement LRU
+  std::unordered_multimap<EncodingHash, EncodingEntry, EncodingHashHash>
+      encoding_lookup_;
 };
 
 } // namespace nvfuser
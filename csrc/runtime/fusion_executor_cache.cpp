@@ -9,6 +9,8 @@
 
 #include <c10/util/irange.h>
 
+#include <sstream>
+
 #include <dynamic_transform.h>
 #include <fusion.h>
 #include <logical_domain_map.h>
@@ -21,6 +23,8 @@
 #include <fusion_profiler.h>
 #include <instrumentation.h>
 #include <ir/utils.h>
+#include <kernel_db/heuristic_snapshot.h>
+#include <kernel_db/utils.h>
 #include <logical_domain_map.h>
 #include <multidevice/communicator.h>
 #include <options.h>
@@ -42,12 +46,75 @@ FusionExecutorCache::FusionExecutorCache(
     : fusion_(std::move(fusion)),
       exact_map_(std::make_unique<ExactLogicalDomainMap>(fusion_.get())),
       fusion_id_{fusion_id},
-      auto_schedule_(auto_schedule) {}
+      auto_schedule_(auto_schedule) {
+  if (isOptionEnabled(EnableOption::StageCpuScalars)) {
+    // The staged inputs are regular 0-dim tensors for the whole pipeline
+    std::vector<int64_t> cpu_scalar_inputs;
+    for (auto i : c10::irange(fusion_->inputs().size())) {
+      auto* tv = dynamic_cast<TensorView*>(fusion_->inputs()[i]);
+      if (tv != nullptr && tv->isCpuScalar()) {
+        tv->setCpuScalar(false);
+        cpu_scalar_inputs.push_back((int64_t)i);
+      }
+    }
+    if (!cpu_scalar_inputs.empty()) {
+      cpu_scalar_staging_ =
+          std::make_unique<CpuScalarStaging>(std::move(cpu_scalar_inputs));
+    }
+  }
+  if (isOptionEnabled(EnableOption::HeuristicSnapshot)) {
+    std::stringstream ss;
+    fusion_->print(ss, /*include_tensor_transforms=*/false);
+    heuristic_snapshot_fusion_hash_ = stable_hash(ss.str());
+  }
+}
+
+namespace {
+
+// Copies an output that was not written to the buffer given for it, e.g.,
+// because it was computed by ATen or is an alias, into that buffer
+void copyToGivenOutput(
+    at::Tensor& given,
+    const at::Tensor& output,
+    size_t output_index) {
+  NVF_CHECK(
+      given.scalar_type() == output.scalar_type() &&
+          given.sizes() == output.sizes() && given.device() == output.device(),
+      "Output buffer ",
+      output_index,
+      " is expected to be a ",
+      output.scalar_type(),
+      " tensor of sizes ",
+      output.sizes(),
+      " on ",
+      output.device(),
+      " but is a ",
+      given.scalar_type(),
+      " tensor of sizes ",
+      given.sizes(),
+      " on ",
+      given.device());
+  given.copy_(output);
+}
+
+// Returns the scheduler of each segment of runtime, indexed by group id
+std::vector<SchedulerType> segmentSchedulers(FusionKernelRuntime* runtime) {
+  const auto& heuristics = runtime->schedulerHeuristics()->heuristicsList();
+  std::vector<SchedulerType> scheduler_types;
+  scheduler_types.reserve(heuristics.size());
+  for (const auto& params : heuristics) {
+    scheduler_types.push_back(params->scheduler_type);
+  }
+  return scheduler_types;
+}
+
+} // namespace
 
 std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
     const at::ArrayRef<c10::IValue>& inputs,
     std::optional<PrimDataType> forced_index_type,
-    std::optional<int8_t> selected_device) {
+    std::optional<int8_t> selected_device,
+    const std::vector<at::Tensor>& outputs) {
   FUSER_PERF_SCOPE("FusionExecutorCache::runFusionWithInputs");
   // NOTE: This should be the first code in the method to capture all host time
   if (isProfilerEnabled()) {
@@ -55,14 +122,21 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
   }
 
   KernelArgumentHolder args = prepareInputs(inputs, selected_device);
+  std::shared_lock<std::shared_mutex> use_lock(runtime_use_mutex_);
   auto kernel_runtime = getKernelRuntimeFor(args, forced_index_type);
 
   if (isProfilerEnabled()) {
     FusionProfiler::createSegments(kernel_runtime->executors().size());
   }
 
-  if (!kernel_runtime->isCompiled()) {
-    kernel_runtime->compileFusionParallel(args);
+  if (!kernel_runtime->isCompiling() && !kernel_runtime->isCompiled()) {
+    // A failed background compilation is retried synchronously so that the
+    // error surfaces to the caller
+    if (isAsyncCompilationEnabled() && !kernel_runtime->asyncCompileFailed()) {
+      kernel_runtime->compileFusionAsync(args);
+    } else {
+      kernel_runtime->compileFusionParallel(args);
+    }
   }
 
   most_recent_runtime_ = kernel_runtime;
@@ -78,24 +152,74 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
         " failed");
   }
 
-  auto outputs = kernel_runtime->runWithInputs(args);
+  // The given buffers are for the outputs that are returned. The runtime
+  // takes one, possibly undefined, for every output of the fusion.
+  std::vector<at::Tensor> given_outputs;
+  if (!outputs.empty()) {
+    given_outputs.resize(fusion->outputs().size());
+    size_t num_returned_outputs = 0;
+    for (const auto out_index : c10::irange(fusion->outputs().size())) {
+      Val* out = fusion->outputs()[out_index];
+      if (fusion->getOutputAlias(out).hide_output) {
+        continue;
+      }
+      if (num_returned_outputs < outputs.size()) {
+        given_outputs[out_index] = outputs[num_returned_outputs];
+      }
+      num_returned_outputs++;
+    }
+    NVF_CHECK(
+        num_returned_outputs == outputs.size(),
+        "Expected ",
+        num_returned_outputs,
+        " output buffers but got ",
+        outputs.size());
+  }
+
+  // Serve the request with ATen while the kernels are compiled in the
+  // background. If the fusion cannot be evaluated, wait for the kernels.
+  std::optional<std::vector<at::Tensor>> maybe_outputs;
+  if (kernel_runtime->isCompiling()) {
+    maybe_outputs = kernel_runtime->runWithExprEval(args);
+    if (!maybe_outputs.has_value()) {
+      kernel_runtime->waitForAsyncCompile();
+    }
+  }
 
-  // Kernel time measurement is off by default
-  kernel_runtime->disableKernelTimeMeasurement();
+  if (!maybe_outputs.has_value()) {
+    if (!kernel_runtime->isCompiled()) {
+      kernel_runtime->compileFusionParallel(args);
+    }
+    if (heuristic_snapshot_fusion_hash_.has_value()) {
+      recordTunedHeuristics(args, kernel_runtime);
+    }
+    maybe_outputs = kernel_runtime->runWithInputs(args, given_outputs);
+
+    // Kernel time measurement is off by default
+    kernel_runtime->disableKernelTimeMeasurement();
+  }
+  auto fusion_outputs = std::move(maybe_outputs.value());
 
   // Removing aliased outputs, since those are updated by the Fusion. It is not
   // semantically correct to actually return them as outputs from
   // fusion.
-  NVF_ERROR(fusion->outputs().size() == outputs.size());
+  NVF_ERROR(fusion->outputs().size() == fusion_outputs.size());
   size_t new_size = 0;
-  for (size_t out_index = 0; out_index < outputs.size(); out_index++) {
+  for (size_t out_index = 0; out_index < fusion_outputs.size(); out_index++) {
     Val* out = fusion->outputs()[out_index];
-    if (!fusion->getOutputAlias(out).hide_output) {
-      outputs[new_size] = outputs[out_index];
-      new_size++;
+    if (fusion->getOutputAlias(out).hide_output) {
+      continue;
     }
+    if (!given_outputs.empty() && given_outputs[out_index].defined() &&
+        !given_outputs[out_index].is_same(fusion_outputs[out_index])) {
+      copyToGivenOutput(
+          given_outputs[out_index], fusion_outputs[out_index], new_size);
+      fusion_outputs[out_index] = given_outputs[out_index];
+    }
+    fusion_outputs[new_size] = fusion_outputs[out_index];
+    new_size++;
   }
-  outputs.resize(new_size);
+  fusion_outputs.resize(new_size);
 
   // NOTE: This should be the last code in the method to capture all host time
   if (isProfilerEnabled()) {
@@ -105,7 +229,7 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
     debug() << FusionProfiler::profile();
   }
 
-  return outputs;
+  return fusion_outputs;
 }
 
 KernelArgumentHolder FusionExecutorCache::prepareInputs(
@@ -115,7 +239,16 @@ KernelArgumentHolder FusionExecutorCache::prepareInputs(
 
   KernelArgumentHolder args =
       KernelArgumentHolder::createKernelArgumentHolder(inputs, selected_device);
+  setCacheId(args, inputs);
+  if (cpu_scalar_staging_ != nullptr) {
+    cpu_scalar_staging_->stage(args);
+  }
+  return args;
+}
 
+void FusionExecutorCache::setCacheId(
+    KernelArgumentHolder& args,
+    const at::ArrayRef<c10::IValue>& inputs) {
   // TODO: move InputsIdLookup inside KernelArgumentHolder;
   // NOTE: We must ensure that the cache id is in fact unique. Dynamic fusions
   // may contain transformations that depend on input scalars, not just on the
@@ -124,16 +257,122 @@ KernelArgumentHolder FusionExecutorCache::prepareInputs(
   // fusions. This may not be ideal in all cases, since it will prevent
   // short-circuiting here, resulting in avoidable rebuilds of concretization
   // info.
-  auto id_lookup_ret = inputs_id_lookup_.lookupId(
-      inputs,
-      initialInfo().scalarInputsAffectingConcretization(),
-      args.getDeviceIndex());
+  const auto& scalar_inputs =
+      initialInfo().scalarInputsAffectingConcretization();
+  InputsIdLookup::IdLookupReturn id_lookup_ret;
+  {
+    std::lock_guard<std::mutex> lock(inputs_id_lookup_mutex_);
+    id_lookup_ret = inputs_id_lookup_.lookupId(
+        inputs, scalar_inputs, args.getDeviceIndex());
+  }
   if (id_lookup_ret.eviction) {
     evictCache(id_lookup_ret.evict_id);
   }
 
   args.setCacheId(id_lookup_ret.id);
-  return args;
+}
+
+void FusionExecutorCache::compileFusionAheadOfTime(
+    const std::vector<InputSignature>& signatures) {
+  FUSER_PERF_SCOPE("FusionExecutorCache::compileFusionAheadOfTime");
+  NVF_CHECK(
+      !isProfilerEnabled(),
+      "Ahead-of-time compilation is not supported while profiling");
+
+  // Segmentation and scheduling update the cache, so runtimes are created
+  // one at a time. Only their compilation runs concurrently.
+  std::shared_lock<std::shared_mutex> use_lock(runtime_use_mutex_);
+  std::vector<std::pair<FusionKernelRuntime*, KernelArgumentHolder>>
+      runtimes_to_compile;
+  std::unordered_set<FusionKernelRuntime*> visited_runtimes;
+  for (const auto& signature : signatures) {
+    NVF_CHECK(
+        signature.arguments.size() == fusion_->inputs().size(),
+        "Expected ",
+        fusion_->inputs().size(),
+        " arguments in the input signature but received ",
+        signature.arguments.size());
+
+    // Meta tensors stand in for the tensor inputs. They report a null data
+    // pointer, which is treated as maximally aligned.
+    std::vector<c10::IValue> inputs;
+    inputs.reserve(signature.arguments.size());
+    for (const auto& argument : signature.arguments) {
+      if (!argument.isTensor()) {
+        inputs.emplace_back(argument.scalar_value.value());
+        continue;
+      }
+      NVF_CHECK(
+          argument.strides.empty() ||
+              argument.strides.size() == argument.sizes.size(),
+          "Expected strides of the same rank as sizes in the input signature");
+      auto strides = argument.strides;
+      if (strides.empty()) {
+        strides.resize(argument.sizes.size(), 1);
+        for (int64_t i = (int64_t)strides.size() - 2; i >= 0; --i) {
+          strides[i] =
+              strides[i + 1] * std::max(argument.sizes[i + 1], (int64_t)1);
+        }
+      }
+      inputs.emplace_back(at::empty_strided(
+          argument.sizes,
+          strides,
+          argument.dtype,
+          c10::nullopt,
+          c10::Device(c10::DeviceType::Meta, 0),
+          c10::nullopt));
+    }
+
+    KernelArgumentHolder args;
+    args.setDeviceIndex(signature.device);
+    args.push(inputs);
+    setCacheId(args, inputs);
+
+    auto kernel_runtime = getKernelRuntimeFor(args);
+    if (kernel_runtime->isCompiling() || kernel_runtime->isCompiled() ||
+        !visited_runtimes.insert(kernel_runtime).second) {
+      continue;
+    }
+    runtimes_to_compile.emplace_back(kernel_runtime, std::move(args));
+  }
+
+  // A single runtime compiles its segments in parallel instead
+  if (runtimes_to_compile.size() == 1) {
+    auto& [kernel_runtime, args] = runtimes_to_compile.front();
+    kernel_runtime->compileFusionParallel(args);
+    return;
+  }
+
+  // Nothing waits for these runtimes yet, so the compilations of other
+  // caches that requests are blocked on go first
+  for (auto& [kernel_runtime, args] : runtimes_to_compile) {
+    kernel_runtime->compileFusionAsync(args, CompilePriority::Speculative);
+  }
+  for (auto& [kernel_runtime, args] : runtimes_to_compile) {
+    kernel_runtime->waitForAsyncCompile();
+  }
+  // Recompile failed runtimes synchronously to surface their errors
+  for (auto& [kernel_runtime, args] : runtimes_to_compile) {
+    if (kernel_runtime->asyncCompileFailed()) {
+      kernel_runtime->compileFusionParallel(args);
+    }
+  }
+}
+
+PeakMemoryStats FusionExecutorCache::predictPeakMemory(
+    const at::ArrayRef<c10::IValue>& inputs,
+    std::optional<int8_t> selected_device) {
+  FUSER_PERF_SCOPE("FusionExecutorCache::predictPeakMemory");
+  KernelArgumentHolder args = prepareInputs(inputs, selected_device);
+  std::shared_lock<std::shared_mutex> use_lock(runtime_use_mutex_);
+  auto kernel_runtime = getKernelRuntimeFor(args);
+  if (kernel_runtime->isCompiling()) {
+    kernel_runtime->waitForAsyncCompile();
+  }
+  if (!kernel_runtime->isCompiled()) {
+    kernel_runtime->compileFusionParallel(args);
+  }
+  return kernel_runtime->predictPeakMemory(args);
 }
 
 bool FusionExecutorCache::isCompiled(
@@ -145,7 +384,9 @@ bool FusionExecutorCache::isCompiled(
   KernelArgumentHolder args = prepareInputs(inputs);
   args.setDeviceIndex(device);
 
-  return getKernelRuntimeFor(args)->isCompiled();
+  std::shared_lock<std::shared_mutex> use_lock(runtime_use_mutex_);
+  auto kernel_runtime = getKernelRuntimeFor(args);
+  return !kernel_runtime->isCompiling() && kernel_runtime->isCompiled();
 }
 
 Fusion* FusionExecutorCache::fusion() {
@@ -216,13 +457,14 @@ std::string FusionExecutorCache::getCode(
 }
 
 std::string FusionExecutorCache::getMostRecentCode(bool intrinsic_code) const {
-  return getCode(most_recent_runtime_, intrinsic_code);
+  return getCode(most_recent_runtime_.load(), intrinsic_code);
 }
 
 std::string FusionExecutorCache::getCodeFor(
     const at::ArrayRef<c10::IValue>& inputs,
     bool intrinsic_code) {
   KernelArgumentHolder args = prepareInputs(inputs);
+  std::shared_lock<std::shared_mutex> use_lock(runtime_use_mutex_);
   auto kernel_runtime = getKernelRuntimeFor(args);
   return getCode(kernel_runtime, intrinsic_code);
 }
@@ -251,13 +493,14 @@ std::string FusionExecutorCache::getScheduledIr(
 
 std::string FusionExecutorCache::getMostRecentScheduledIr(
     bool tensor_transforms) const {
-  return getScheduledIr(most_recent_runtime_, tensor_transforms);
+  return getScheduledIr(most_recent_runtime_.load(), tensor_transforms);
 }
 
 std::string FusionExecutorCache::getScheduledIrFor(
     const at::ArrayRef<c10::IValue>& inputs,
     bool tensor_transforms) {
   KernelArgumentHolder args = prepareInputs(inputs);
+  std::shared_lock<std::shared_mutex> use_lock(runtime_use_mutex_);
   auto kernel_runtime = getKernelRuntimeFor(args);
   return getScheduledIr(kernel_runtime, tensor_transforms);
 }
@@ -266,8 +509,9 @@ std::string FusionExecutorCache::getScheduledIrFor(
 //  to capture runtime profiling info. We also need to define
 //  a suitable profiling window / buffer size.
 const ExecutorLog& FusionExecutorCache::getMostRecentExecutorInfo() {
-  NVF_ERROR(most_recent_runtime_ != nullptr);
-  return most_recent_runtime_->getMostRecentExecutorLog();
+  FusionKernelRuntime* kernel_runtime = most_recent_runtime_.load();
+  NVF_ERROR(kernel_runtime != nullptr);
+  return kernel_runtime->getMostRecentExecutorLog();
 }
 
 //! Get all cached runtimes
@@ -277,6 +521,9 @@ const std::unordered_map<
     PairPointerHash,
     PairPointerEquals>&
 FusionExecutorCache::getKernelRuntimes() const {
+  // Materializing rebuilds what the cache already holds, so the cache looks
+  // the same to its callers either way
+  const_cast<FusionExecutorCache*>(this)->materializeRuntimes();
   return kernel_runtimes_;
 }
 
@@ -284,6 +531,8 @@ FusionExecutorCache::getKernelRuntimes() const {
 //! FusionKernelRuntimes. If device is given, count only concretizations on
 //! the given device; otherwise count concretizations on all devices.
 size_t FusionExecutorCache::countConcretizations(int8_t device) const {
+  const_cast<FusionExecutorCache*>(this)->materializeRuntimes();
+  std::shared_lock<std::shared_mutex> lock(runtimes_mutex_);
   size_t concs = 0;
   for (auto& it : kernel_runtimes_) {
     if (device >= 0 && it.first.first != device) {
@@ -298,6 +547,8 @@ size_t FusionExecutorCache::countConcretizations(int8_t device) const {
 //! count only runtimes on the given device; otherwise count
 //! runtimes on all devices.
 size_t FusionExecutorCache::countRuntimes(int8_t device) const {
+  const_cast<FusionExecutorCache*>(this)->materializeRuntimes();
+  std::shared_lock<std::shared_mutex> lock(runtimes_mutex_);
   size_t runtimes = 0;
   for (auto& it : kernel_runtimes_) {
     if (device >= 0 && it.first.first != device) {
@@ -310,6 +561,7 @@ size_t FusionExecutorCache::countRuntimes(int8_t device) const {
 
 void FusionExecutorCache::profile(bool to_profile) {
   profiling_ = to_profile;
+  materializeRuntimes();
   for (auto& it : kernel_runtimes_) {
     for (auto& kernel_runtime : it.second) {
       kernel_runtime->profile(to_profile);
@@ -319,6 +571,7 @@ void FusionExecutorCache::profile(bool to_profile) {
 
 //! Internal knob for profiling shape inference
 void FusionExecutorCache::disableLaunchParamCache() {
+  materializeRuntimes();
   for (auto& it : kernel_runtimes_) {
     for (auto& kernel_runtime : it.second) {
       kernel_runtime->disableLaunchParamCache();
@@ -328,6 +581,7 @@ void FusionExecutorCache::disableLaunchParamCache() {
 
 //! Internal knob for profiling shape inference
 void FusionExecutorCache::disableKernelLaunch() {
+  materializeRuntimes();
   for (auto& it : kernel_runtimes_) {
     for (auto& kernel_runtime : it.second) {
       kernel_runtime->disableKernelLaunch();
@@ -343,10 +597,22 @@ float FusionExecutorCache::getMostRecentKernelTimeMs() const {
   return rt->kernelTimeMs();
 }
 
+bool FusionExecutorCache::isAsyncCompilationEnabled() const {
+  // The profiler attributes compile and kernel times to segments, which the
+  // ATen fallback does not have
+  return (async_compile_ || isOptionEnabled(EnableOption::AsyncCompile)) &&
+      !isProfilerEnabled() && !measure_kernel_time_;
+}
+
 flatbuffers::Offset<serde::FusionExecutorCache> FusionExecutorCache::serialize(
     flatbuffers::FlatBufferBuilder& builder) const {
   // See definitions in serde/fusion_cache.fbs for tables
   // FusionExecutorCache and KernelRuntimes
+  NVF_ERROR(
+      serialized_runtimes_.load() == nullptr,
+      "Call materializeRuntimes() before serializing a lazily deserialized ",
+      "FusionExecutorCache.");
+  std::shared_lock<std::shared_mutex> lock(runtimes_mutex_);
 
   // For serialization, we require a consistent ordering for the
   // kernel_runtimes_ map.
@@ -395,6 +661,7 @@ flatbuffers::Offset<serde::FusionExecutorCache> FusionExecutorCache::serialize(
     kernel_cache_values.push_back(kernel_cache_ordering.at(kernel_runtime_ptr));
   }
 
+  std::lock_guard<std::mutex> inputs_id_lookup_lock(inputs_id_lookup_mutex_);
   return serde::CreateFusionExecutorCacheDirect(
       builder,
       fusion_id_,
@@ -406,19 +673,65 @@ flatbuffers::Offset<serde::FusionExecutorCache> FusionExecutorCache::serialize(
 
 void FusionExecutorCache::deserialize(
     const serde::FusionExecutorCache* buffer,
-    int64_t fusion_id) {
+    int64_t fusion_id,
+    bool lazy) {
   // See definitions in serde/fusion_cache.fbs for tables
   // FusionExecutorCache and KernelRuntimes
 
   NVF_ERROR(buffer != nullptr, "serde::FusionExecutorCache is nullptr.");
+  std::unique_lock<std::shared_mutex> lock(runtimes_mutex_);
   NVF_ERROR(
       fusion_id == buffer->fusion_id(),
       "Expected serde fusion_id to match given fusion_id.");
 
   fusion_id_ = buffer->fusion_id();
 
-  inputs_id_lookup_.deserialize(buffer->inputs_cache());
+  {
+    std::lock_guard<std::mutex> inputs_id_lookup_lock(
+        inputs_id_lookup_mutex_);
+    inputs_id_lookup_.deserialize(buffer->inputs_cache());
+  }
+
+  if (lazy) {
+    serialized_runtimes_.store(buffer);
+    return;
+  }
+  deserializeRuntimes(buffer);
+}
+
+void FusionExecutorCache::materializeRuntimes() {
+  if (serialized_runtimes_.load() == nullptr) {
+    return;
+  }
+  std::unique_lock<std::shared_mutex> lock(runtimes_mutex_);
+  // Another thread may have materialized the runtimes already. The buffer is
+  // cleared first so that a failure is not retried on every lookup.
+  auto buffer = serialized_runtimes_.exchange(nullptr);
+  if (buffer == nullptr) {
+    return;
+  }
+  FUSER_PERF_SCOPE("FusionExecutorCache::materializeRuntimes");
+  try {
+    deserializeRuntimes(buffer);
+  } catch (const std::exception& e) {
+    // Unlike an eager deserialization, this can't fall back to a fresh
+    // workspace anymore. Drop the serialized runtimes and compile new ones.
+    TORCH_WARN(
+        "Failed to deserialize the kernel runtimes of fusion ",
+        fusion_id_,
+        ". They will be recompiled. Exception:\n",
+        e.what());
+    kernel_runtimes_.clear();
+    cached_conc_info_.clear();
+    conc_info_id_map_.clear();
+    deterministic_conc_info_.clear();
+    conc_info_by_fingerprint_.clear();
+    id_to_kernel_runtime_.clear();
+  }
+}
 
+void FusionExecutorCache::deserializeRuntimes(
+    const serde::FusionExecutorCache* buffer) {
   // For the id_to_kernel_runtime_ cache, we need a flat collection of all
   // FusionKernelRuntime objects.
   std::vector<FusionKernelRuntime*> all_runtimes;
@@ -513,8 +826,14 @@ void FusionExecutorCache::deserialize(
 }
 
 void FusionExecutorCache::evictCache(size_t cache_id) {
+  materializeRuntimes();
+  std::unique_lock<std::shared_mutex> lock(runtimes_mutex_);
   auto it = id_to_kernel_runtime_.find(cache_id);
-  NVF_ERROR(it != id_to_kernel_runtime_.end());
+  // The runtimes of ids restored from a serialized cache are gone if they
+  // failed to deserialize. See materializeRuntimes.
+  if (it == id_to_kernel_runtime_.end()) {
+    return;
+  }
   it->second->evictCache(cache_id);
   id_to_kernel_runtime_.erase(it);
 }
@@ -554,48 +873,201 @@ void FusionExecutorCache::evictCache(size_t cache_id) {
 FusionKernelRuntime* FusionExecutorCache::getKernelRuntimeFor(
     const KernelArgumentHolder& args,
     std::optional<PrimDataType> forced_index_type) {
-  // Check for id hit case (Path 1)
   FUSER_PERF_SCOPE("FusionExecutorCache::getKernelRuntimeFor");
-  auto unique_id_opt = args.getCacheId();
   NVF_CHECK(
-      unique_id_opt.has_value(),
+      args.getCacheId().has_value(),
       "KernelArgumentHolder has no cache ID in getKernelRuntimeFor");
-  auto unique_id = *unique_id_opt;
-  auto id_it = id_to_kernel_runtime_.find(unique_id);
-  if (id_it != id_to_kernel_runtime_.end()) {
-    // If the forced index type is given, don't use the cached runtime
-    // if its index type does not match with the forced type
-    if (!forced_index_type.has_value() ||
-        forced_index_type.value() == id_it->second->getIndexType()) {
-      return id_it->second;
+  materializeRuntimes();
+
+  // Check for id hit case (Path 1). Threads running known inputs only
+  // contend on the shared lock.
+  {
+    std::shared_lock<std::shared_mutex> lock(runtimes_mutex_);
+    if (auto kernel_runtime = findKernelRuntime(args, forced_index_type)) {
+      num_runtime_hits_++;
+      kernel_runtime->markUsed();
+      return kernel_runtime;
     }
   }
 
+  std::unique_lock<std::shared_mutex> lock(runtimes_mutex_);
+  // Another thread may have added a runtime for the same inputs
+  if (auto kernel_runtime = findKernelRuntime(args, forced_index_type)) {
+    num_runtime_hits_++;
+    kernel_runtime->markUsed();
+    return kernel_runtime;
+  }
+  num_runtime_misses_++;
+  FusionKernelRuntime* kernel_runtime =
+      createKernelRuntimeFor(args, forced_index_type);
+  kernel_runtime->markUsed();
+  return kernel_runtime;
+}
+
+int64_t FusionExecutorCache::approximateBytes() const {
+  std::shared_lock<std::shared_mutex> lock(runtimes_mutex_);
+  int64_t bytes = 0;
+  for (const auto& [conc_info, runtimes] : kernel_runtimes_) {
+    for (const auto& kernel_runtime : runtimes) {
+      bytes += kernel_runtime->approximateBytes();
+    }
+  }
+  return bytes;
+}
+
+std::optional<uint64_t> FusionExecutorCache::leastRecentUse() const {
+  std::shared_lock<std::shared_mutex> lock(runtimes_mutex_);
+  std::optional<uint64_t> least_recent_use = std::nullopt;
+  for (const auto& [conc_info, runtimes] : kernel_runtimes_) {
+    for (const auto& kernel_runtime : runtimes) {
+      if (kernel_runtime.get() == most_recent_runtime_.load() ||
+          kernel_runtime->isCompiling()) {
+        continue;
+      }
+      if (!least_recent_use.has_value() ||
+          kernel_runtime->lastUsed() < least_recent_use.value()) {
+        least_recent_use = kernel_runtime->lastUsed();
+      }
+    }
+  }
+  return least_recent_use;
+}
+
+int64_t FusionExecutorCache::evictLeastRecentlyUsedRuntime() {
+  // Don't wait for the threads running this cache. They may be the ones
+  // enforcing the memory budget.
+  std::unique_lock<std::shared_mutex> use_lock(
+      runtime_use_mutex_, std::try_to_lock);
+  if (!use_lock.owns_lock()) {
+    return 0;
+  }
+  std::unique_lock<std::shared_mutex> lock(runtimes_mutex_);
+  std::vector<std::unique_ptr<FusionKernelRuntime>>* lru_runtimes = nullptr;
+  size_t lru_index = 0;
+  for (auto& [conc_info, runtimes] : kernel_runtimes_) {
+    for (size_t i = 0; i < runtimes.size(); ++i) {
+      FusionKernelRuntime* kernel_runtime = runtimes[i].get();
+      if (kernel_runtime == most_recent_runtime_.load() ||
+          kernel_runtime->isCompiling()) {
+        continue;
+      }
+      if (lru_runtimes == nullptr ||
+          kernel_runtime->lastUsed() <
+              lru_runtimes->at(lru_index)->lastUsed()) {
+        lru_runtimes = &runtimes;
+        lru_index = i;
+      }
+    }
+  }
+  if (lru_runtimes == nullptr) {
+    return 0;
+  }
+
+  FusionKernelRuntime* evicted = lru_runtimes->at(lru_index).get();
+  const int64_t bytes = evicted->approximateBytes();
+  // The cache ids mapped to the evicted runtime look up a runtime again
+  for (auto it = id_to_kernel_runtime_.begin();
+       it != id_to_kernel_runtime_.end();) {
+    it = it->second == evicted ? id_to_kernel_runtime_.erase(it) : ++it;
+  }
+  lru_runtimes->erase(lru_runtimes->begin() + (int64_t)lru_index);
+  num_evicted_runtimes_++;
+  return bytes;
+}
+
+FusionKernelRuntime* FusionExecutorCache::findKernelRuntime(
+    const KernelArgumentHolder& args,
+    std::optional<PrimDataType> forced_index_type) const {
+  auto id_it = id_to_kernel_runtime_.find(args.getCacheId().value());
+  if (id_it == id_to_kernel_runtime_.end()) {
+    return nullptr;
+  }
+  // If the forced index type is given, don't use the cached runtime
+  // if its index type does not match with the forced type
+  if (forced_index_type.has_value() &&
+      forced_index_type.value() != id_it->second->getIndexType()) {
+    return nullptr;
+  }
+  return id_it->second;
+}
+
+FusionKernelRuntime* FusionExecutorCache::createKernelRuntimeFor(
+    const KernelArgumentHolder& args,
+    std::optional<PrimDataType> forced_index_type) {
+  FUSER_PERF_SCOPE("FusionExecutorCache::createKernelRuntimeFor");
+  const size_t unique_id = args.getCacheId().value();
+
   // Compute or get cached initial concretization info
   const auto& initial_info = initialInfo();
 
-  // Compute concretization info to use as cache key
-  DynamicTransformConcretizationInfo* conc_info = nullptr;
-  if (initial_info.isDynamic()) {
+  // Compute concretization info to use as cache key. If the values that
+  // determine concretization were seen before, reuse that info instead.
+  std::optional<std::vector<int64_t>> fingerprint;
+  const DynamicTransformConcretizationInfo* conc_info = nullptr;
+  DynamicTransformConcretizationInfo* new_conc_info = nullptr;
+  auto compute_conc_info = [&]() {
     // This class needs to own conc_info so it can be compared in subsequent
     // invocations.
     auto expr_eval = executor_utils::bindInputs(args, fusion_.get());
     cached_conc_info_.emplace_back(
         std::make_unique<DynamicTransformConcretizationInfo>(
             &initial_info, &expr_eval, exact_map_.get()));
-    conc_info = cached_conc_info_.back().get();
+    return cached_conc_info_.back().get();
+  };
+  if (initial_info.isDynamic()) {
+    fingerprint = initial_info.fingerprint(args);
+    if (fingerprint.has_value()) {
+      fingerprint->insert(fingerprint->begin(), args.getDeviceIndex());
+      auto fingerprint_it = conc_info_by_fingerprint_.find(*fingerprint);
+      if (fingerprint_it != conc_info_by_fingerprint_.end()) {
+        conc_info = fingerprint_it->second;
+      }
+    }
+    if (conc_info == nullptr) {
+      new_conc_info = compute_conc_info();
+      conc_info = new_conc_info;
+    }
   }
 
   // Initialize or fetch vector of FusionKernelRuntime objects associated with
   // each pair of device ID and concretization info.
   auto device_concrete_key = std::make_pair(args.getDeviceIndex(), conc_info);
-  auto& kernel_runtimes =
-      kernel_runtimes_.try_emplace(device_concrete_key).first->second;
+  auto kernel_runtimes_it =
+      kernel_runtimes_.try_emplace(device_concrete_key).first;
+  auto& kernel_runtimes = kernel_runtimes_it->second;
   auto result = conc_info_id_map_.try_emplace(
       device_concrete_key, conc_info_id_map_.size() + 1);
   if (result.second) {
     deterministic_conc_info_.emplace_back(device_concrete_key);
   }
+  if (fingerprint.has_value()) {
+    conc_info_by_fingerprint_.try_emplace(
+        std::move(fingerprint.value()), kernel_runtimes_it->first.second);
+  }
+
+  // Segment and schedule with the representative shape of the bucket of
+  // args so that all shapes in a bucket share kernels. Dynamic fusions are
+  // concretized with the actual args and are not bucketed.
+  std::optional<KernelArgumentHolder> maybe_bucketed_args;
+  if (shape_bucket_policy_.has_value() && !initial_info.isDynamic()) {
+    maybe_bucketed_args = shape_bucket_policy_->bucketArgs(args);
+  }
+  const KernelArgumentHolder& scheduling_args =
+      maybe_bucketed_args.has_value() ? maybe_bucketed_args.value() : args;
+
+  // Choices tuned by an earlier process, possibly of an older version,
+  // replace the timing runs
+  std::optional<TunedHeuristics> tuned;
+  if (heuristic_snapshot_fusion_hash_.has_value() && auto_schedule_) {
+    tuned = HeuristicSnapshot::get().lookup(
+        heuristic_snapshot_fusion_hash_.value(), inputsSignature(args));
+  }
+
+  // The backend of matmuls is selected for each input shape, so runtimes are
+  // not reused for other shapes
+  const bool select_matmul_backend = !tuned.has_value() &&
+      !initial_info.isDynamic() && !maybe_bucketed_args.has_value() &&
+      canSelectMatmulBackend(args);
 
   // Check for re-use hit case
   //  a kernel runtime is re-usable if all the compiled
@@ -613,14 +1085,35 @@ FusionKernelRuntime* FusionExecutorCache::getKernelRuntimeFor(
   // of input shapes we segment and compile a new FusionKernelRuntime.
   // Effectively, this option disables Paths 2 and 3 above so that we only
   // have Path 1 (hottest re-use path) and Path 4 (full recompile).
-  if (!isOptionDisabled(DisableOption::KernelReuse)) {
+  if (!isOptionDisabled(DisableOption::KernelReuse) &&
+      !select_matmul_backend) {
     FUSER_PERF_SCOPE("FusionExecutorCache::getKernelRuntimeFor::reuseKRT");
+    bool use_int64_indexing = false;
     auto runtime_it = std::find_if(
         kernel_runtimes.begin(),
         kernel_runtimes.end(),
-        [&args, &new_heuristics, &forced_index_type](auto& kernel_runtime) {
+        [&scheduling_args,
+         &new_heuristics,
+         &forced_index_type,
+         &use_int64_indexing](auto& kernel_runtime) {
+          // The heuristics of a runtime cannot be updated while its kernels
+          // are compiled in the background
+          if (kernel_runtime->isCompiling()) {
+            return false;
+          }
           auto maybe_heuristics =
-              kernel_runtime->getMaybeHeuristicsFor(args, forced_index_type);
+              kernel_runtime->getMaybeHeuristicsFor(
+                  scheduling_args, forced_index_type);
+          use_int64_indexing = false;
+          // The heuristics may only differ in the index type, in which case
+          // the 64-bit variants of the kernels of this runtime are used
+          if (!maybe_heuristics.has_value() &&
+              !forced_index_type.has_value() &&
+              kernel_runtime->canRunWithInt64Indexing()) {
+            maybe_heuristics = kernel_runtime->getMaybeHeuristicsFor(
+                scheduling_args, PrimDataType::Int32);
+            use_int64_indexing = maybe_heuristics.has_value();
+          }
           if (!maybe_heuristics.has_value()) {
             return false;
           }
@@ -629,7 +1122,11 @@ FusionKernelRuntime* FusionExecutorCache::getKernelRuntimeFor(
         });
     if (runtime_it != kernel_runtimes.end()) {
       kernel_runtime = runtime_it->get();
-      kernel_runtime->updateHeuristicsLaunchParams(new_heuristics.get());
+      kernel_runtime->updateHeuristicsLaunchParams(
+          new_heuristics.get(), unique_id);
+      if (use_int64_indexing) {
+        kernel_runtime->useInt64Indexing(unique_id);
+      }
       id_to_kernel_runtime_[unique_id] = kernel_runtime;
       return kernel_runtime;
     }
@@ -645,17 +1142,20 @@ FusionKernelRuntime* FusionExecutorCache::getKernelRuntimeFor(
     if (initial_info.isDynamic()) {
       const auto& conc_initial_info =
           conc_fusion->getManaged<DynamicTransformInitialInfo>("initial_info");
-      NVF_ERROR(conc_info);
-      conc_info->setInitialInfo(&conc_initial_info);
+      // Concretization redirects the info to the initial info of the clone,
+      // so an info found by fingerprint is not modified
+      auto fusion_conc_info =
+          new_conc_info != nullptr ? new_conc_info : compute_conc_info();
+      fusion_conc_info->setInitialInfo(&conc_initial_info);
 
       if (isDebugDumpEnabled(DebugDumpOption::FusionIrConcretized)) {
         debug() << "Fusion before concretization:" << std::endl;
         conc_fusion->printMath();
         debug() << conc_initial_info.toString() << std::endl;
-        debug() << conc_info->toString() << std::endl;
+        debug() << fusion_conc_info->toString() << std::endl;
       }
 
-      DynamicTransform::concretizeFusion(conc_fusion.get(), conc_info);
+      DynamicTransform::concretizeFusion(conc_fusion.get(), fusion_conc_info);
       // Initial info is used during concretization and is owned by
       // conc_fusion. After concretization, we stop managing it so that we
       // won't keep cloning it for every subsequent Fusion copy.
@@ -667,16 +1167,40 @@ FusionKernelRuntime* FusionExecutorCache::getKernelRuntimeFor(
       }
     }
     FusionGuard fg(conc_fusion.get());
-    kernel_runtimes.emplace_back(std::make_unique<FusionKernelRuntime>(
+    const int64_t concrete_id = conc_info_id_map_.at(device_concrete_key);
+    // Runtimes may have been evicted, so the ids continue after the last one
+    // instead of restarting at the number of runtimes
+    const int64_t runtime_id = kernel_runtimes.empty()
+        ? 0
+        : kernel_runtimes.back()->runtimeId() + 1;
+    auto new_runtime = std::make_unique<FusionKernelRuntime>(
         std::move(conc_fusion),
-        args,
+        scheduling_args,
         /*serde_buffer=*/nullptr,
         forced_index_type,
         fusion_id_,
-        conc_info_id_map_.at(device_concrete_key),
-        kernel_runtimes.size(),
-        auto_schedule_));
+        concrete_id,
+        runtime_id,
+        auto_schedule_,
+        /*matmul_expr_eval=*/!tuned.has_value() || tuned->matmul_expr_eval);
+    if (select_matmul_backend) {
+      selectMatmulBackend(
+          args, new_runtime, forced_index_type, concrete_id, runtime_id);
+    } else if (tuned.has_value()) {
+      // The variants are dropped if this version segments the fusion
+      // differently
+      const bool preset =
+          tuned->scheduler_types == segmentSchedulers(new_runtime.get()) &&
+          new_runtime->presetAutotuneVariants(tuned->autotune_variants);
+      if (!preset && isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+        debug() << "Heuristic snapshot: the autotuned variants don't apply "
+                   "to the segments of the fusion"
+                << std::endl;
+      }
+    }
+    kernel_runtimes.emplace_back(std::move(new_runtime));
     kernel_runtime = kernel_runtimes.back().get();
+    num_created_runtimes_++;
 
     if (profiling_) {
       kernel_runtime->profile(true);
@@ -686,8 +1210,151 @@ FusionKernelRuntime* FusionExecutorCache::getKernelRuntimeFor(
   }
 }
 
+void FusionExecutorCache::recordTunedHeuristics(
+    const KernelArgumentHolder& args,
+    FusionKernelRuntime* kernel_runtime) {
+  // Without a tuning option, the choices are those of the analytical
+  // heuristics, which need no record
+  if (!isOptionEnabled(EnableOption::Autotune) &&
+      !isOptionEnabled(EnableOption::MatmulAutoSelect) &&
+      !isOptionEnabled(EnableOption::LimitRegisterPressure)) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> guard(heuristic_snapshot_mutex_);
+    if (!heuristic_snapshot_ids_.insert(args.getCacheId().value()).second) {
+      return;
+    }
+  }
+  TunedHeuristics tuned;
+  tuned.matmul_expr_eval = kernel_runtime->matmulExprEval();
+  tuned.scheduler_types = segmentSchedulers(kernel_runtime);
+  tuned.autotune_variants = kernel_runtime->autotunedVariants();
+  if (!HeuristicSnapshot::get().record(
+          heuristic_snapshot_fusion_hash_.value(),
+          inputsSignature(args),
+          tuned)) {
+    TORCH_WARN(
+        "Heuristic snapshot: Unable to record the tuned heuristics of fusion ",
+        fusion_id_);
+  }
+}
+
+bool FusionExecutorCache::canSelectMatmulBackend(
+    const KernelArgumentHolder& args) const {
+  // ATen and nvFuser accumulate in different orders, so a backend picked by
+  // timing could differ between processes
+  if (!isOptionEnabled(EnableOption::MatmulAutoSelect) ||
+      isOptionEnabled(EnableOption::DeterministicReductions) ||
+      isOptionDisabled(DisableOption::MatmulExprEval) || !auto_schedule_ ||
+      profiling_ || isProfilerEnabled()) {
+    return false;
+  }
+  if (!ir_utils::hasOpsOfType<MatmulOp, LinearOp>(fusion_.get()) ||
+      ir_utils::hasOpsOfType<RNGOp>(fusion_.get())) {
+    return false;
+  }
+  for (const auto& arg : args) {
+    if (arg->is<at::Tensor>() && !arg->as<at::Tensor>().is_cuda()) {
+      return false;
+    }
+  }
+  return std::none_of(
+      fusion_->outputs().begin(), fusion_->outputs().end(), [&](Val* out) {
+        return fusion_->getOutputAlias(out).type ==
+            AllocationType::ReuseBuffer;
+      });
+}
+
+namespace {
+
+// Returns true if a segment of runtime evaluates a matmul with ATen
+bool hasExprEvalMatmul(FusionKernelRuntime* runtime) {
+  const auto& groups = runtime->fusionSegments()->groups();
+  return std::any_of(groups.begin(), groups.end(), [](SegmentedGroup* group) {
+    return group->schedulerType() == SchedulerType::ExprEval &&
+        std::any_of(group->exprs().begin(),
+                    group->exprs().end(),
+                    [](Expr* expr) {
+                      return expr->isOneOf<MatmulOp, LinearOp>();
+                    });
+  });
+}
+
+// Compiles runtime and returns its average time over several runs on args
+double measureRunTimeMs(
+    FusionKernelRuntime* runtime,
+    const KernelArgumentHolder& args) {
+  // Each runtime is run once to warm up and then timed over several runs
+  constexpr int64_t kMatmulSelectRuns = 5;
+  runtime->compileFusionParallel(args);
+  KernelArgumentHolder run_args(args);
+  runtime->runWithInputs(run_args);
+  CudaEventTimer timer(at::cuda::getCurrentCUDAStream());
+  timer.start();
+  for (int64_t i = 0; i < kMatmulSelectRuns; ++i) {
+    runtime->runWithInputs(run_args);
+  }
+  timer.stop();
+  return timer.time() / (double)kMatmulSelectRuns;
+}
+
+} // namespace
+
+void FusionExecutorCache::selectMatmulBackend(
+    const KernelArgumentHolder& args,
+    std::unique_ptr<FusionKernelRuntime>& kernel_runtime,
+    std::optional<PrimDataType> forced_index_type,
+    int64_t concrete_id,
+    int64_t runtime_id) {
+  FUSER_PERF_SCOPE("FusionExecutorCache::selectMatmulBackend");
+  if (!hasExprEvalMatmul(kernel_runtime.get())) {
+    return;
+  }
+
+  // The Matmul scheduler may reject the matmuls, in which case segmentation
+  // fails or still evaluates them with ATen
+  std::unique_ptr<FusionKernelRuntime> nvfuser_runtime;
+  double aten_time_ms = 0.0;
+  double nvfuser_time_ms = 0.0;
+  try {
+    auto fusion = std::make_unique<Fusion>(*fusion_);
+    FusionGuard fg(fusion.get());
+    nvfuser_runtime = std::make_unique<FusionKernelRuntime>(
+        std::move(fusion),
+        args,
+        /*serde_buffer=*/nullptr,
+        forced_index_type,
+        fusion_id_,
+        concrete_id,
+        runtime_id,
+        auto_schedule_,
+        /*matmul_expr_eval=*/false);
+    if (hasExprEvalMatmul(nvfuser_runtime.get())) {
+      return;
+    }
+    nvfuser_time_ms = measureRunTimeMs(nvfuser_runtime.get(), args);
+  } catch (const std::exception& e) {
+    if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+      debug() << "Matmul selection: skipping the Matmul scheduler: "
+              << e.what() << std::endl;
+    }
+    return;
+  }
+  aten_time_ms = measureRunTimeMs(kernel_runtime.get(), args);
+
+  if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+    debug() << "Matmul selection: ATen takes " << aten_time_ms
+            << " ms, the Matmul scheduler takes " << nvfuser_time_ms << " ms"
+            << std::endl;
+  }
+  if (nvfuser_time_ms < aten_time_ms) {
+    kernel_runtime = std::move(nvfuser_runtime);
+  }
+}
+
 DynamicTransformInitialInfo& FusionExecutorCache::initialInfo() {
-  if (!initial_info_.has_value()) {
+  std::call_once(initial_info_flag_, [this]() {
     initial_info_ = DynamicTransform::getInitialInfo(fusion());
     fusion()->manage(
         "initial_info",
@@ -696,7 +1363,7 @@ DynamicTransformInitialInfo& FusionExecutorCache::initialInfo() {
           return std::any_cast<DynamicTransformInitialInfo>(data).clone(
               ir_cloner);
         });
-  }
+  });
   return initial_info_.value();
 }
 
@@ -12,15 +12,20 @@
 #include <exceptions.h>
 #include <fusion.h>
 #include <fusion_segmenter.h>
+#include <runtime/cpu_scalar_staging.h>
 #include <runtime/fusion_cache_utils.h>
 #include <scheduler/heuristic.h>
 #include <serde/fusion_cache_generated.h>
 
 #include <c10/util/ArrayRef.h>
 
+#include <atomic>
 #include <mutex>
+#include <optional>
+#include <shared_mutex>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace nvfuser {
 class DynamicTransformConcretizationInfo;
@@ -31,6 +36,44 @@ class FusionKernelRuntime;
 class KernelArgumentHolder;
 enum class PrimDataType;
 
+//! Describes a fusion input without any data. A tensor input is described by
+//! its sizes, strides and dtype, a scalar input by its value. Scalar values
+//! only matter when they affect the concretization of a dynamic fusion.
+struct ArgumentSignature {
+  //! Empty strides describe a contiguous tensor
+  static ArgumentSignature tensor(
+      std::vector<int64_t> sizes,
+      at::ScalarType dtype,
+      std::vector<int64_t> strides = {}) {
+    ArgumentSignature signature;
+    signature.sizes = std::move(sizes);
+    signature.strides = std::move(strides);
+    signature.dtype = dtype;
+    return signature;
+  }
+
+  static ArgumentSignature scalar(c10::IValue value) {
+    ArgumentSignature signature;
+    signature.scalar_value = std::move(value);
+    return signature;
+  }
+
+  bool isTensor() const {
+    return !scalar_value.has_value();
+  }
+
+  std::vector<int64_t> sizes;
+  std::vector<int64_t> strides;
+  at::ScalarType dtype = at::ScalarType::Float;
+  std::optional<c10::IValue> scalar_value = std::nullopt;
+};
+
+//! Signatures of all the inputs of a fusion and the device to compile for
+struct InputSignature {
+  std::vector<ArgumentSignature> arguments;
+  int8_t device = 0;
+};
+
 //! [ Note -- Post-definition cache implementation ]
 //!
 //! First note that depending on how we acquire a computational graph, there may
@@ -109,6 +152,15 @@ enum class PrimDataType;
 //!     d) rank;
 //!     e) scalar type;
 //!
+//! [ Note -- Thread safety ]
+//! runFusionWithInputs may be called from several threads at once. Inputs
+//! that hit the id lookup (Path 1) only take a shared lock on the runtime
+//! maps. Adding a runtime, reusing one for new inputs (Path 2) and evicting a
+//! cache id take the lock exclusively. Runtimes are never destroyed before
+//! the cache, so a runtime found under the lock stays valid after it is
+//! released. A runtime found by several threads before it is compiled is
+//! compiled only once.
+//!
 //! [ Note -- Segmented Fusion Tentative Design ]
 //! Segmentation adds an extra dimension in caching. Initial implementation,
 //! assumed graph partition strategy is independent of input pattern, which we
@@ -135,9 +187,33 @@ class FusionExecutorCache {
   //! WARING: Correctness is not guaranteed.
   //! TODO: Check usage of forced_index_type. It's a lot of plumbing, what's the
   //! value.
+  //!
+  //! If given, outputs holds a preallocated buffer for each returned output,
+  //! or an undefined tensor for outputs to allocate as usual. The returned
+  //! outputs are those buffers. The buffers must match the sizes, dtypes and
+  //! device inferred for the outputs, their strides must match contiguity of
+  //! the outputs, and vectorized outputs must be aligned. Kernels write
+  //! directly into them; outputs computed otherwise, e.g., aliases, are
+  //! copied into them.
   NVF_API std::vector<at::Tensor> runFusionWithInputs(
       const at::ArrayRef<c10::IValue>& inputs,
       std::optional<PrimDataType> forced_index_type = std::nullopt,
+      std::optional<int8_t> selected_device = std::nullopt,
+      const std::vector<at::Tensor>& outputs = {});
+
+  //! Segment, schedule and compile the fusion for each of the given input
+  //! signatures without running it, so that the first run with matching
+  //! inputs does not pay the compilation cost. Distinct runtimes are compiled
+  //! concurrently. The compiled runtimes are serialized with the rest of the
+  //! cache.
+  NVF_API void compileFusionAheadOfTime(
+      const std::vector<InputSignature>& signatures);
+
+  //! Predicts the memory of running the fusion with inputs without launching
+  //! any kernel. The runtime for inputs is compiled if it is not yet. See
+  //! FusionKernelRuntime::predictPeakMemory.
+  NVF_API PeakMemoryStats predictPeakMemory(
+      const at::ArrayRef<c10::IValue>& inputs,
       std::optional<int8_t> selected_device = std::nullopt);
 
   //! query if there's a kernel ready to go for given inputs
@@ -205,6 +281,42 @@ class FusionExecutorCache {
   //! runtimes on all devices.
   size_t countRuntimes(int8_t device = -1) const;
 
+  //! Number of kernel runtimes compiled by this cache, excluding deserialized
+  //! runtimes. It only grows, so a change tells that a runtime was added.
+  size_t numCreatedRuntimes() const {
+    return num_created_runtimes_.load();
+  }
+
+  //! Approximate memory held by the kernel runtimes. See
+  //! FusionKernelRuntime::approximateBytes.
+  int64_t approximateBytes() const;
+
+  //! FusionKernelRuntime::lastUsed of the least recently used runtime that can
+  //! be evicted, or std::nullopt if there is none. The most recent runtime and
+  //! the runtimes being compiled in the background are never evicted.
+  std::optional<uint64_t> leastRecentUse() const;
+
+  //! Evicts the least recently used runtime that can be evicted, which unloads
+  //! its kernels. Returns the approximate bytes it held, or 0 if no runtime was
+  //! evicted, e.g., because another thread is running this cache.
+  int64_t evictLeastRecentlyUsedRuntime();
+
+  //! Number of kernel runtime lookups that found a runtime mapped to the cache
+  //! id of the inputs, i.e., that didn't need to concretize the fusion
+  size_t numRuntimeHits() const {
+    return num_runtime_hits_.load();
+  }
+
+  //! Number of kernel runtime lookups that missed, see numRuntimeHits
+  size_t numRuntimeMisses() const {
+    return num_runtime_misses_.load();
+  }
+
+  //! Number of runtimes evicted by evictLeastRecentlyUsedRuntime
+  size_t numEvictedRuntimes() const {
+    return num_evicted_runtimes_.load();
+  }
+
   void profile(bool to_profile);
 
   //! Internal knob for profiling shape inference
@@ -227,12 +339,48 @@ class FusionExecutorCache {
   //! be zero if the measurement is not enabled
   float getMostRecentKernelTimeMs() const;
 
+  //! Opt into asynchronous compilation. When inputs map to a runtime that is
+  //! not compiled yet, its kernels are compiled in the background and the
+  //! unscheduled fusion is evaluated with ATen in the meantime. Fusions that
+  //! ATen cannot evaluate still wait for the compilation. Can also be enabled
+  //! for all caches with NVFUSER_ENABLE=async_compile.
+  void enableAsyncCompilation() {
+    async_compile_ = true;
+  }
+
+  void disableAsyncCompilation() {
+    async_compile_ = false;
+  }
+
+  bool isAsyncCompilationEnabled() const;
+
+  //! Bucket the extents of the given input dimensions so that input shapes in
+  //! the same bucket share a FusionKernelRuntime instead of each segmenting
+  //! and compiling their own. Applies to runtimes created afterwards.
+  void setShapeBucketPolicy(ShapeBucketPolicy policy) {
+    shape_bucket_policy_ = std::move(policy);
+  }
+
+  void clearShapeBucketPolicy() {
+    shape_bucket_policy_.reset();
+  }
+
   //! Serialize Fusion Executor Cache using flatbuffers
   flatbuffers::Offset<serde::FusionExecutorCache> serialize(
       flatbuffers::FlatBufferBuilder& builder) const;
 
-  //! Deserialize Fusion Executor Cache using flatbuffers
-  void deserialize(const serde::FusionExecutorCache* buffer, int64_t fusion_id);
+  //! Deserialize Fusion Executor Cache using flatbuffers. If lazy is true,
+  //! only the input id lookup is restored and the kernel runtimes are rebuilt
+  //! from buffer on the first lookup, so buffer must outlive that lookup.
+  void deserialize(
+      const serde::FusionExecutorCache* buffer,
+      int64_t fusion_id,
+      bool lazy = false);
+
+  //! Rebuild the kernel runtimes of a lazily deserialized cache. Does nothing
+  //! if they are already rebuilt. Called by the lookups, and by the methods
+  //! reading or updating all the runtimes, e.g., countRuntimes.
+  void materializeRuntimes();
 
  private:
   //! Converts inputs from IValue to KernelArgumentHolder, also handles cache
@@ -241,16 +389,59 @@ class FusionExecutorCache {
       const at::ArrayRef<c10::IValue>& inputs,
       std::optional<int8_t> selected_device = std::nullopt);
 
+  //! Looks up the cache id of inputs and stores it in args
+  void setCacheId(
+      KernelArgumentHolder& args,
+      const at::ArrayRef<c10::IValue>& inputs);
+
   //! evict cached short cut entry in `code_to_fe_lookup_` as well as cached
   //! entry in `KernelExecutor`
   void evictCache(size_t cache_id);
 
+  //! Rebuild kernel_runtimes_ and id_to_kernel_runtime_ from buffer. Requires
+  //! runtimes_mutex_ to be held exclusively.
+  void deserializeRuntimes(const serde::FusionExecutorCache* buffer);
+
   //! The index type of forced_index_type is used to get a kernel
   //! runtime no matter what sizes inputs have
   FusionKernelRuntime* getKernelRuntimeFor(
       const KernelArgumentHolder& inputs,
       std::optional<PrimDataType> forced_index_type = std::nullopt);
 
+  //! Returns the runtime mapped to the cache id of args (Path 1), or nullptr.
+  //! Requires runtimes_mutex_ to be held.
+  FusionKernelRuntime* findKernelRuntime(
+      const KernelArgumentHolder& args,
+      std::optional<PrimDataType> forced_index_type) const;
+
+  //! Reuses (Path 2) or creates (Paths 3 and 4) a runtime for args and maps
+  //! the cache id of args to it. Requires runtimes_mutex_ to be held
+  //! exclusively.
+  FusionKernelRuntime* createKernelRuntimeFor(
+      const KernelArgumentHolder& args,
+      std::optional<PrimDataType> forced_index_type);
+
+  //! Returns true if NVFUSER_ENABLE=matmul_auto_select applies to args. The
+  //! fusion has to contain a matmul, and args are run several times, so they
+  //! have to be materialized on the device and must not be updated in place.
+  bool canSelectMatmulBackend(const KernelArgumentHolder& args) const;
+
+  //! If kernel_runtime evaluates a matmul with ATen, segments the fusion
+  //! again for the Matmul scheduler, times both runtimes on args and leaves
+  //! the faster one in kernel_runtime. Both runtimes are compiled.
+  void selectMatmulBackend(
+      const KernelArgumentHolder& args,
+      std::unique_ptr<FusionKernelRuntime>& kernel_runtime,
+      std::optional<PrimDataType> forced_index_type,
+      int64_t concrete_id,
+      int64_t runtime_id);
+
+  //! Records the tuned choices of kernel_runtime for args to the
+  //! HeuristicSnapshot, once per input id
+  void recordTunedHeuristics(
+      const KernelArgumentHolder& args,
+      FusionKernelRuntime* kernel_runtime);
+
   //! Get initial concretization info (without inputs). This computes the info
   //! if it has not yet been computed, then caches it for later use. This means
   //! this method should not be called until the definition of the Fusion is
@@ -265,6 +456,9 @@ class FusionExecutorCache {
   //! inputs to unique_id lookup table;
   InputsIdLookup inputs_id_lookup_;
 
+  //! Guards inputs_id_lookup_. Never held while taking runtimes_mutex_.
+  mutable std::mutex inputs_id_lookup_mutex_;
+
   //! Holds FusionKernelRuntime for concretized and scheduled Fusions. The key
   //! in this map is a (device, concretization info) pair. In case fusion_
   //! contains no dynamic transforms, the second part of the key is null. When a
@@ -294,9 +488,42 @@ class FusionExecutorCache {
   //! concretization info) pair
   std::vector<ConcreteInfo> deterministic_conc_info_;
 
+  //! Concretization info keyed by the device index followed by
+  //! DynamicTransformInitialInfo::fingerprint of the inputs. Inputs that only
+  //! differ in values that don't affect concretization find their entry of
+  //! kernel_runtimes_ here without binding inputs or recomputing the
+  //! concretization info.
+  std::unordered_map<
+      std::vector<int64_t>,
+      const DynamicTransformConcretizationInfo*,
+      Int64VectorHash>
+      conc_info_by_fingerprint_;
+
   //! Short-cut for exact size cache hit
   std::unordered_map<size_t, FusionKernelRuntime*> id_to_kernel_runtime_;
 
+  //! Guards kernel_runtimes_, id_to_kernel_runtime_ and the concretization
+  //! info. See [ Note -- Thread safety ].
+  mutable std::shared_mutex runtimes_mutex_;
+
+  //! Held shared while a runtime is used outside runtimes_mutex_, and
+  //! exclusively to evict runtimes. Never held while waiting for
+  //! runtimes_mutex_ exclusively in another thread, see
+  //! evictLeastRecentlyUsedRuntime.
+  mutable std::shared_mutex runtime_use_mutex_;
+
+  //! See numRuntimeHits, numRuntimeMisses and numEvictedRuntimes
+  std::atomic<size_t> num_runtime_hits_ = 0;
+  std::atomic<size_t> num_runtime_misses_ = 0;
+  std::atomic<size_t> num_evicted_runtimes_ = 0;
+
+  //! Runtimes of a lazily deserialized cache that are not rebuilt yet
+  std::atomic<const serde::FusionExecutorCache*> serialized_runtimes_ =
+      nullptr;
+
+  //! See numCreatedRuntimes
+  std::atomic<size_t> num_created_runtimes_ = 0;
+
   //! This is cached to speed up finding concretization info
   std::unique_ptr<ExactLogicalDomainMap> exact_map_;
 
@@ -306,16 +533,23 @@ class FusionExecutorCache {
   //! Flag to indicate kernel time measurement
   bool measure_kernel_time_ = false;
 
+  //! Flag to compile new kernels in the background
+  bool async_compile_ = false;
+
+  //! Policy used to schedule an input shape as its bucket's representative
+  std::optional<ShapeBucketPolicy> shape_bucket_policy_ = std::nullopt;
+
   //! Logging state for most recent compilation
   ExecutorLog most_recent_executor_log_;
 
   //! Profiling info:
   //! TODO: this can be largely expanded to look at complete
   //!   caching profiles. Currently it just makes it easier to test
-  FusionKernelRuntime* most_recent_runtime_ = nullptr;
+  std::atomic<FusionKernelRuntime*> most_recent_runtime_ = nullptr;
 
   //! Initial concretization info
   std::optional<DynamicTransformInitialInfo> initial_info_ = std::nullopt;
+  std::once_flag initial_info_flag_;
 
   // ID of fusion in python frontend fusion cache, which maps to a single
   // FusionExecutorCache.
@@ -323,6 +557,18 @@ class FusionExecutorCache {
 
   // Whether to auto schedule the Fusion. If set to false, scheduling is skipped
   const bool auto_schedule_;
+
+  //! Set if the CPU scalar inputs are moved to the device, see
+  //! EnableOption::StageCpuScalars. The option is read once, when the cache
+  //! is created, as its kernels are compiled for scalars in device memory.
+  std::unique_ptr<CpuScalarStaging> cpu_scalar_staging_;
+
+  //! Stable hash of fusion_ keying its records in the HeuristicSnapshot. Set
+  //! if EnableOption::HeuristicSnapshot is enabled when the cache is created.
+  std::optional<uint64_t> heuristic_snapshot_fusion_hash_;
+  //! Ids of the inputs whose tuned heuristics were recorded
+  std::mutex heuristic_snapshot_mutex_;
+  std::unordered_set<size_t> heuristic_snapshot_ids_;
 };
 
 } // namespace nvfuser
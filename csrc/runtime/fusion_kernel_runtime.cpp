@@ -7,22 +7,43 @@
 // clang-format on
 #include <runtime/fusion_kernel_runtime.h>
 
+#include <cuda_utils.h>
+#include <device_lower/analysis/register_pressure.h>
+#include <device_lower/lower2device.h>
 #include <fusion.h>
 #include <fusion_profiler.h>
 #include <fusion_segmenter.h>
 #include <instrumentation.h>
 #include <ir/base_nodes.h>
+#include <ir/utils.h>
+#include <kernel_db/perf_db.h>
+#include <kernel_db/utils.h>
+#include <options.h>
 #include <preseg_passes/pre_segmenter.h>
 #include <python_frontend/fusion_definition.h>
 #include <python_frontend/translation.h>
+#include <runtime/allocations.h>
 #include <runtime/executor.h>
 #include <runtime/executor_dispatch.h>
+#include <runtime/executor_utils.h>
 #include <runtime/fusion_cache_utils.h>
+#include <runtime/megakernel.h>
+#include <scheduler/autotune.h>
 #include <scheduler/heuristic.h>
+#include <scheduler/pointwise_heuristic.h>
 #include <serde/fusion_cache_generated.h>
 #include <type.h>
 
+#include <ATen/EmptyTensor.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAEvent.h>
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/cuda/CUDAGraphsC10Utils.h>
 #include <c10/cuda/CUDAGuard.h>
+#include <c10/cuda/CUDAStream.h>
+
+#include <algorithm>
+#include <limits>
 
 namespace nvfuser {
 
@@ -53,6 +74,76 @@ KernelArgumentHolder copyMetadataArg(const KernelArgumentHolder& src) {
   dst.setDeviceIndex(src.getDeviceIndex());
   return dst;
 }
+
+// Marks the accesses of the kernels launched on stream to
+// [ptr, ptr + num_bytes) as persisting in L2, so that intermediates written by
+// a segment are still in L2 when the next segment reads them. Returns false if
+// the device can't persist a window of that size.
+bool setL2PersistenceWindow(cudaStream_t stream, void* ptr, int64_t num_bytes) {
+  const cudaDeviceProp* prop = at::cuda::getCurrentDeviceProperties();
+  if (prop->persistingL2CacheMaxSize == 0 ||
+      num_bytes > (int64_t)prop->accessPolicyMaxWindowSize) {
+    return false;
+  }
+  size_t persisting_bytes = 0;
+  NVFUSER_CUDA_RT_SAFE_CALL(
+      cudaDeviceGetLimit(&persisting_bytes, cudaLimitPersistingL2CacheSize));
+  if (persisting_bytes == 0) {
+    // Nothing persists until a part of L2 is set aside
+    persisting_bytes = (size_t)prop->persistingL2CacheMaxSize;
+    NVFUSER_CUDA_RT_SAFE_CALL(
+        cudaDeviceSetLimit(cudaLimitPersistingL2CacheSize, persisting_bytes));
+  }
+  cudaStreamAttrValue attr = {};
+  attr.accessPolicyWindow.base_ptr = ptr;
+  attr.accessPolicyWindow.num_bytes = (size_t)num_bytes;
+  // Only persist as much of a larger window as fits in the set-aside part,
+  // or the window would thrash it
+  attr.accessPolicyWindow.hitRatio =
+      std::min(1.0f, (float)persisting_bytes / (float)num_bytes);
+  attr.accessPolicyWindow.hitProp = cudaAccessPropertyPersisting;
+  attr.accessPolicyWindow.missProp = cudaAccessPropertyStreaming;
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaStreamSetAttribute(
+      stream, cudaStreamAttributeAccessPolicyWindow, &attr));
+  return true;
+}
+
+// Kernels launched later on stream access L2 normally. The lines already
+// persisting are not reset, as cudaCtxResetPersistingL2Cache is not ordered
+// with the kernels still running. They are bounded by the set-aside part of L2
+// and are reused by the next run of the fusion.
+void clearL2PersistenceWindow(cudaStream_t stream) {
+  cudaStreamAttrValue attr = {};
+  attr.accessPolicyWindow.num_bytes = 0;
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaStreamSetAttribute(
+      stream, cudaStreamAttributeAccessPolicyWindow, &attr));
+}
+
+// A kernel whose outputs are all newly allocated neither writes into nor
+// returns a view of its inputs
+bool allocatesNewOutputs(ExecutorAbstract* ea) {
+  auto ke = dynamic_cast<KernelExecutor*>(ea);
+  if (ke == nullptr) {
+    return false;
+  }
+  Fusion* fusion = ke->fusion();
+  return std::all_of(
+      fusion->outputs().begin(), fusion->outputs().end(), [&](Val* out) {
+        return !out->isFusionInput() &&
+            fusion->getOutputAlias(out).type == AllocationType::New;
+      });
+}
+
+// A tensor without an allocation domain whose dimensions are all contiguous
+// is laid out like the default at::empty
+bool isDenseLayout(TensorView* tv) {
+  return !tv->hasAllocation() &&
+      std::all_of(tv->getContiguity().begin(),
+                  tv->getContiguity().end(),
+                  [](const std::optional<bool>& contiguity) {
+                    return contiguity.value_or(true);
+                  });
+}
 } // namespace
 
 FusionKernelRuntime::FusionKernelRuntime(
@@ -63,7 +154,8 @@ FusionKernelRuntime::FusionKernelRuntime(
     int64_t fusion_id,
     int64_t concrete_id,
     int64_t runtime_id,
-    bool auto_schedule)
+    bool auto_schedule,
+    bool matmul_expr_eval)
     : args_metadata_{copyMetadataArg(args)},
       fusion_id_{fusion_id},
       concrete_id_{concrete_id},
@@ -75,6 +167,19 @@ FusionKernelRuntime::FusionKernelRuntime(
       !fusion->hasDynamicTransform(),
       "Fusion must be concretized before constructing FusionKernelRuntime");
 
+  // Segment matmuls for the Matmul scheduler instead of ATen if that was
+  // selected for this runtime, including when it is deserialized and
+  // segmented again
+  matmul_expr_eval_ = serde_buffer != nullptr
+      ? serde_buffer->matmul_expr_eval()
+      : matmul_expr_eval;
+  EnableOptionsGuard enable_options_guard;
+  DisableOptionsGuard disable_options_guard;
+  if (!matmul_expr_eval_) {
+    EnableOptionsGuard::getCurOptions().set(EnableOption::FuseMatmul);
+    DisableOptionsGuard::getCurOptions().set(DisableOption::MatmulExprEval);
+  }
+
   preseg_passes::OptimizationPass<preseg_passes::PreSegmenter>::runPass(
       fusion.get());
 
@@ -129,6 +234,7 @@ FusionKernelRuntime::FusionKernelRuntime(
   prepareRuntimeOrder(segmented_fusion_.get(), runtime_workspace_);
 
   executors_.resize(segmented_fusion_->groups().size());
+  autotune_variants_.resize(segmented_fusion_->groups().size());
 
   if (isDebugDumpEnabled(DebugDumpOption::FusionSegments)) {
     segmented_fusion_->print();
@@ -145,7 +251,27 @@ FusionKernelRuntime::FusionKernelRuntime(
   heuristics_ = std::move(maybe_heuristics.value());
 }
 
+FusionKernelRuntime::~FusionKernelRuntime() {
+  // A compilation that hasn't started yet is obsolete
+  {
+    std::lock_guard<std::mutex> guard(async_compile_mutex_);
+    if (async_compile_tasks_ != nullptr) {
+      async_compile_tasks_->cancel();
+    }
+  }
+  waitForAsyncCompile();
+}
+
 void FusionKernelRuntime::evictCache(size_t input_id) {
+  // Graphs and arena plans may be in use by a run
+  std::lock_guard<std::mutex> run_guard(run_mutex_);
+  // Executors may still be written by an asynchronous compilation
+  std::lock_guard<std::mutex> guard(mutex_);
+  cuda_graphs_.erase(input_id);
+  cuda_graph_warmed_up_.erase(input_id);
+  arena_entries_.erase(input_id);
+  cache_id_launch_params_.erase(input_id);
+  int64_cache_ids_.erase(input_id);
   for (auto& ea : executors_) {
     if (auto ke = dynamic_cast<KernelExecutor*>(ea.get())) {
       ke->evictCache(input_id);
@@ -153,6 +279,24 @@ void FusionKernelRuntime::evictCache(size_t input_id) {
   }
 }
 
+std::atomic<uint64_t> FusionKernelRuntime::global_use_count_ = 0;
+
+int64_t FusionKernelRuntime::approximateBytes() const {
+  // Rough host footprint of an IR node with its domains and attributes
+  constexpr int64_t kBytesPerStatement = 256;
+  Fusion* fusion = segmented_fusion_->completeFusion();
+  int64_t bytes = kBytesPerStatement *
+      static_cast<int64_t>(
+          fusion->vals().size() + fusion->unordered_exprs().size());
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (const auto& executor : executors_) {
+    if (auto* ke = dynamic_cast<KernelExecutor*>(executor.get())) {
+      bytes += ke->approximateBytes();
+    }
+  }
+  return bytes;
+}
+
 bool FusionKernelRuntime::isCompiled() const {
   std::lock_guard<std::mutex> guard(mutex_);
   return std::all_of(
@@ -183,6 +327,16 @@ flatbuffers::Offset<serde::FusionKernelRuntime> FusionKernelRuntime::serialize(
     segmented_fusion_fb = segmented_fusion_->serialize(builder);
   }
 
+  // 2. Serialize the autotuned variants, flattened by group id
+  std::vector<int64_t> autotune_log2_scales;
+  autotune_log2_scales.reserve(autotune_variants_.size() * kNumAutotuneKnobs);
+  for (const auto& variant : autotune_variants_) {
+    autotune_log2_scales.insert(
+        autotune_log2_scales.end(),
+        variant.log2_scales.begin(),
+        variant.log2_scales.end());
+  }
+
   return serde::CreateFusionKernelRuntimeDirect(
       builder,
       fusion_id_,
@@ -190,7 +344,9 @@ flatbuffers::Offset<serde::FusionKernelRuntime> FusionKernelRuntime::serialize(
       runtime_id_,
       args_metadata_.serialize(builder),
       &executors_fb,
-      segmented_fusion_fb);
+      segmented_fusion_fb,
+      &autotune_log2_scales,
+      matmul_expr_eval_);
 }
 
 void FusionKernelRuntime::deserialize(
@@ -221,7 +377,30 @@ void FusionKernelRuntime::deserialize(
         "Could not find the serialized group associated with id: ", group_id);
   };
 
-  // 1. Deserialize KernelExecutor objects
+  // 1. Reapply the autotuned variants, which the kernels were compiled with,
+  // to the heuristics recomputed by the constructor
+  if (buffer->autotune_log2_scales() != nullptr &&
+      buffer->autotune_log2_scales()->size() > 0) {
+    NVF_ERROR(
+        buffer->autotune_log2_scales()->size() ==
+            autotune_variants_.size() * kNumAutotuneKnobs,
+        "Expected an autotuned variant for each segment.");
+    for (auto group_id : c10::irange(autotune_variants_.size())) {
+      auto& variant = autotune_variants_.at(group_id);
+      for (auto knob : c10::irange(kNumAutotuneKnobs)) {
+        variant.log2_scales.at(knob) = buffer->autotune_log2_scales()->Get(
+            group_id * kNumAutotuneKnobs + knob);
+      }
+      NVF_ERROR(
+          applyAutotuneVariant(heuristics_->at((int)group_id).get(), variant),
+          "Failed to reapply ",
+          variant.toString(),
+          " to the heuristics of segment ",
+          group_id);
+    }
+  }
+
+  // 2. Deserialize KernelExecutor objects
   for (auto idx : c10::irange(executors_.size())) {
     auto sg = runtime_workspace_.group_run_order.at(idx);
 
@@ -233,8 +412,12 @@ void FusionKernelRuntime::deserialize(
         "Heuristics do not match.");
     auto fusion_to_run = segmented_fusion_->makeFusion(sg).second;
     FusionGuard fg(fusion_to_run.get());
-    SchedulerEntry::makeSchedulerInstance(heuristic_params->scheduler_type)
-        ->schedule(fusion_to_run.get(), heuristic_params);
+    {
+      FUSER_COMPILE_PHASE_SCOPE(
+          toString(heuristic_params->scheduler_type) + " schedule");
+      SchedulerEntry::makeSchedulerInstance(heuristic_params->scheduler_type)
+          ->schedule(fusion_to_run.get(), heuristic_params);
+    }
 
     // Initialize associated executors
     executors_[group_id] = ExecutorDispatch::makeExecutor(
@@ -277,16 +460,42 @@ PrimDataType FusionKernelRuntime::getIndexType() const {
 }
 
 std::vector<at::Tensor> FusionKernelRuntime::runWithInputs(
-    KernelArgumentHolder& args) {
+    KernelArgumentHolder& args,
+    const std::vector<at::Tensor>& outputs) {
   FUSER_PERF_SCOPE("FusionKernelRuntime::runWithInputs");
 
+  // Eager runs keep their state on the stack. CUDA graphs, concurrent
+  // segments, the intermediate arena and the megakernel keep theirs in this
+  // runtime.
+  std::unique_lock<std::mutex> run_lock(run_mutex_, std::defer_lock);
+  if (isOptionEnabled(EnableOption::CudaGraph) || numSegmentStreams() > 1 ||
+      isOptionEnabled(EnableOption::IntermediateArena) ||
+      isOptionEnabled(EnableOption::Megakernel)) {
+    run_lock.lock();
+  }
+
+  if (outputs.empty() && canUseCudaGraph(args)) {
+    if (auto graph_outputs = runWithCudaGraph(args);
+        graph_outputs.has_value()) {
+      return std::move(graph_outputs.value());
+    }
+  }
+  if (canUseMegakernel()) {
+    return runWithMegakernel(args, outputs);
+  }
+  return runSegmentsEagerly(args, outputs);
+}
+
+std::vector<at::Tensor> FusionKernelRuntime::runSegmentsEagerly(
+    KernelArgumentHolder& args,
+    const std::vector<at::Tensor>& outputs) {
   if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
     debug() << "=================RUNNING FUSION SEGMENTS================="
             << std::endl;
   }
 
   c10::Device device(c10::DeviceType::CUDA, (int8_t)args.getDeviceIndex());
-  const auto& tensor_map = runSegmentsWithInputs(args);
+  const auto& tensor_map = runSegmentsWithInputs(args, outputs);
 
   if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
     debug() << "============= FINISHED RUNNING FUSION SEGMENTS ============"
@@ -308,12 +517,369 @@ std::vector<at::Tensor> FusionKernelRuntime::runWithInputs(
   return fusion_outputs;
 }
 
+bool FusionKernelRuntime::canUseCudaGraph(const KernelArgumentHolder& args) {
+  if (!isOptionEnabled(EnableOption::CudaGraph) ||
+      !args.getCacheId().has_value() || profiling_ || measure_kernel_time_ ||
+      isProfilerEnabled() || isCompiling()) {
+    return false;
+  }
+  // Already captured as part of an enclosing graph, e.g., of a host program
+  if (c10::cuda::currentStreamCaptureStatusMayInitCtx() !=
+      c10::cuda::CaptureStatus::None) {
+    return false;
+  }
+
+  if (!cuda_graph_supported_.has_value()) {
+    Fusion* fusion = segmented_fusion_->completeFusion();
+    // RNG ops need no special handling. During capture, the kernels read the
+    // seed and offset through the device pointers of the generator, and
+    // each replay advances them. See Note [CUDA graph capture and RNG seed
+    // and offset].
+    //
+    // Inputs updated in place would only update the graph's copies
+    bool supported = std::none_of(
+        fusion->outputs().begin(), fusion->outputs().end(), [fusion](Val* out) {
+          return fusion->getOutputAlias(out).type ==
+              AllocationType::ReuseBuffer;
+        });
+    // ATen and host IR segments may synchronize with the host
+    supported = supported &&
+        std::all_of(executors_.begin(),
+                    executors_.end(),
+                    [](const auto& executor) {
+                      return dynamic_cast<KernelExecutor*>(executor.get()) !=
+                          nullptr;
+                    });
+    cuda_graph_supported_ = supported;
+  }
+  if (!cuda_graph_supported_.value()) {
+    return false;
+  }
+
+  // CPU scalar tensors are passed by value, and overlapping tensors cannot
+  // be copied into
+  return std::all_of(args.cbegin(), args.cend(), [](const auto& arg) {
+    if (!arg->template is<at::Tensor>()) {
+      return true;
+    }
+    const auto& tensor = arg->template as<at::Tensor>();
+    return tensor.is_cuda() && tensor.is_non_overlapping_and_dense();
+  });
+}
+
+std::optional<std::vector<at::Tensor>> FusionKernelRuntime::runWithCudaGraph(
+    const KernelArgumentHolder& args) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::runWithCudaGraph");
+  const size_t cache_id = args.getCacheId().value();
+
+  CudaGraphEntry* entry = nullptr;
+  if (auto it = cuda_graphs_.find(cache_id); it != cuda_graphs_.end()) {
+    entry = it->second.get();
+    NVF_ERROR(entry->inputs.size() == args.size());
+
+    // Scalars are baked into the graph. Inputs with the same cache id may
+    // still have different scalar values.
+    for (auto i : c10::irange(args.size())) {
+      if (!args[i]->is<at::Tensor>() &&
+          !PolymorphicValue_functions::isSame(*args[i], entry->inputs[i])) {
+        return std::nullopt;
+      }
+    }
+    // Sizes and strides are part of the cache id
+    for (auto i : c10::irange(args.size())) {
+      if (!args[i]->is<at::Tensor>()) {
+        continue;
+      }
+      const auto& tensor = args[i]->as<at::Tensor>();
+      auto& graph_tensor = entry->inputs[i].as<at::Tensor>();
+      if (tensor.data_ptr() != graph_tensor.data_ptr()) {
+        graph_tensor.copy_(tensor, /*non_blocking=*/true);
+      }
+    }
+  } else {
+    if (cuda_graph_warmed_up_.insert(cache_id).second) {
+      return std::nullopt;
+    }
+    entry = cuda_graphs_.emplace(cache_id, captureCudaGraph(args))
+                .first->second.get();
+  }
+
+  entry->graph->replay();
+
+  // Copy the outputs so that they stay valid across replays
+  std::vector<at::Tensor> outputs;
+  outputs.reserve(entry->outputs.size());
+  for (const auto& output : entry->outputs) {
+    outputs.push_back(output.clone());
+  }
+  return outputs;
+}
+
+std::unique_ptr<FusionKernelRuntime::CudaGraphEntry> FusionKernelRuntime::
+    captureCudaGraph(const KernelArgumentHolder& args) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::captureCudaGraph");
+  auto entry = std::make_unique<CudaGraphEntry>();
+
+  // The graph reads its own copy of the inputs, so that later inputs can be
+  // copied in without overwriting the tensors of the caller
+  entry->inputs.reserve(args.size());
+  for (const auto& arg : args) {
+    if (arg->is<at::Tensor>()) {
+      const auto& tensor = arg->as<at::Tensor>();
+      auto graph_tensor =
+          at::empty_strided(tensor.sizes(), tensor.strides(), tensor.options());
+      graph_tensor.copy_(tensor, /*non_blocking=*/true);
+      entry->inputs.emplace_back(std::move(graph_tensor));
+    } else {
+      entry->inputs.push_back(*arg);
+    }
+  }
+
+  // Running the segments consumes the argument holder
+  KernelArgumentHolder graph_args;
+  graph_args.setDeviceIndex(args.getDeviceIndex());
+  graph_args.setCacheId(args.getCacheId().value());
+  for (const auto& input : entry->inputs) {
+    graph_args.push(input);
+  }
+
+  // Capture must not happen on the legacy default stream
+  const auto device_index = (c10::DeviceIndex)args.getDeviceIndex();
+  auto current_stream = c10::cuda::getCurrentCUDAStream(device_index);
+  auto capture_stream = c10::cuda::getStreamFromPool(
+      /*isHighPriority=*/false, device_index);
+  at::cuda::CUDAEvent inputs_ready;
+  inputs_ready.record(current_stream);
+  inputs_ready.block(capture_stream);
+  {
+    c10::cuda::CUDAStreamGuard stream_guard(capture_stream);
+    entry->graph = std::make_unique<at::cuda::CUDAGraph>();
+    entry->graph->capture_begin();
+    entry->outputs = runSegmentsEagerly(graph_args);
+    entry->graph->capture_end();
+  }
+  at::cuda::CUDAEvent captured;
+  captured.record(capture_stream);
+  captured.block(current_stream);
+  return entry;
+}
+
+bool FusionKernelRuntime::canUseMegakernel() {
+  // Graphs already remove the launch overhead, and timing or profiling the
+  // segments needs their kernels to be launched separately
+  if (!isOptionEnabled(EnableOption::Megakernel) ||
+      isOptionEnabled(EnableOption::CudaGraph) || profiling_ ||
+      measure_kernel_time_ || isProfilerEnabled() || isCompiling() ||
+      numSegmentStreams() > 1 ||
+      isOptionEnabled(EnableOption::IntermediateArena) ||
+      isOptionEnabled(EnableOption::KernelPerfDb) ||
+      isOptionEnabled(EnableOption::KernelProfile)) {
+    return false;
+  }
+
+  if (!megakernel_supported_.has_value()) {
+    // Kernels are only collected, so no segment may read the outputs of
+    // another on the host, e.g., an ATen segment
+    megakernel_supported_ = executors_.size() > 1 &&
+        std::all_of(executors_.begin(),
+                    executors_.end(),
+                    [](const auto& executor) {
+                      auto ke = dynamic_cast<KernelExecutor*>(executor.get());
+                      return ke != nullptr && Megakernel::supports(*ke);
+                    });
+  }
+  return megakernel_supported_.value();
+}
+
+std::vector<at::Tensor> FusionKernelRuntime::runWithMegakernel(
+    KernelArgumentHolder& args,
+    const std::vector<at::Tensor>& outputs) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::runWithMegakernel");
+  if (megakernel_ == nullptr) {
+    std::vector<const KernelExecutor*> stages;
+    stages.reserve(runtime_workspace_.group_run_order.size());
+    for (SegmentedGroup* group : runtime_workspace_.group_run_order) {
+      stages.push_back(executors_.at(group->groupId())->as<KernelExecutor>());
+    }
+    std::stringstream name;
+    name << "nvfuser_megakernel_f" << fusion_id_ << "_c" << concrete_id_
+         << "_r" << runtime_id_;
+    try {
+      megakernel_ = std::make_unique<Megakernel>(std::move(stages), name.str());
+    } catch (const std::exception& e) {
+      TORCH_WARN(
+          "The segments can't run as a megakernel, so they are launched "
+          "separately. Error: ",
+          e.what());
+      megakernel_supported_ = false;
+      return runSegmentsEagerly(args, outputs);
+    }
+  }
+
+  const auto device_index = (c10::DeviceIndex)args.getDeviceIndex();
+  KernelLaunchCollector collector;
+  std::vector<at::Tensor> fusion_outputs = runSegmentsEagerly(args, outputs);
+
+  CUstream stream = c10::cuda::getCurrentCUDAStream(device_index).stream();
+  bool launched = false;
+  try {
+    launched = megakernel_->launch(collector.launches(), stream);
+  } catch (const std::exception& e) {
+    TORCH_WARN(
+        "The megakernel failed to launch, so the segments are launched "
+        "separately. Error: ",
+        e.what());
+    megakernel_supported_ = false;
+  }
+  if (!launched) {
+    collector.launchEach(stream);
+  }
+  return fusion_outputs;
+}
+
 // passing args by value because we will be modify this
 void FusionKernelRuntime::compileFusionParallel(KernelArgumentHolder args) {
   FUSER_PERF_SCOPE("FusionKernelRuntime::compileFusionParallel");
+  compileFusion(
+      std::move(args), !isOptionDisabled(DisableOption::ParallelCompile));
+}
+
+void FusionKernelRuntime::compileFusionAsync(
+    KernelArgumentHolder args,
+    CompilePriority priority) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::compileFusionAsync");
+  // The fallback fusion is copied before compilation starts, and before
+  // other threads can observe isCompiling()
+  initExprEvalFusion();
+
+  // Several threads may miss the same runtime. Only the first one starts a
+  // compilation.
+  std::lock_guard<std::mutex> guard(async_compile_mutex_);
+  if (isCompiling()) {
+    return;
+  }
+  async_compile_failed_.store(false, std::memory_order_release);
+  is_compiling_.store(true, std::memory_order_release);
+  // The previous group has finished, as nothing was compiling
+  async_compile_tasks_ = std::make_shared<CompileTaskGroup>(priority);
+
+  async_compile_tasks_->run([this, args = std::move(args)]() {
+    FUSER_PERF_SCOPE("FusionKernelRuntime::compileFusionAsync::task");
+    try {
+      compileFusion(args, !isOptionDisabled(DisableOption::ParallelCompile));
+    } catch (const std::exception& e) {
+      async_compile_failed_.store(true, std::memory_order_release);
+      TORCH_WARN(
+          "Asynchronous compilation failed, the fusion will be compiled synchronously on its next run. Error: ",
+          e.what());
+    }
+    // Publish the executors written by compileFusion
+    is_compiling_.store(false, std::memory_order_release);
+  });
+}
+
+void FusionKernelRuntime::initExprEvalFusion() {
+  std::call_once(expr_eval_fusion_flag_, [this]() {
+    expr_eval_fusion_ =
+        std::make_unique<Fusion>(*segmented_fusion_->completeFusion());
+  });
+}
+
+void FusionKernelRuntime::waitForAsyncCompile() const {
+  std::shared_ptr<CompileTaskGroup> tasks;
+  {
+    std::lock_guard<std::mutex> guard(async_compile_mutex_);
+    tasks = async_compile_tasks_;
+  }
+  if (tasks != nullptr) {
+    tasks->wait();
+  }
+}
+
+std::optional<std::vector<at::Tensor>> FusionKernelRuntime::runWithExprEval(
+    KernelArgumentHolder& args) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::runWithExprEval");
+  if (expr_eval_unsupported_.load(std::memory_order_relaxed)) {
+    return std::nullopt;
+  }
+  initExprEvalFusion();
+
+  Fusion* fusion = expr_eval_fusion_.get();
+  FusionGuard fg(fusion);
+  std::vector<at::Tensor> outputs;
+  outputs.reserve(fusion->outputs().size());
+  try {
+    auto expr_eval = executor_utils::bindInputs(args, fusion);
+    for (Val* out : fusion->outputs()) {
+      const PolymorphicValue& out_value = expr_eval.evaluate(out);
+      if (!out_value.is<at::Tensor>()) {
+        expr_eval_unsupported_.store(true, std::memory_order_relaxed);
+        return std::nullopt;
+      }
+      outputs.push_back(out_value.as<at::Tensor>());
+    }
+  } catch (const std::exception& e) {
+    if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+      debug() << "Fusion cannot be evaluated with ATen: " << e.what()
+              << std::endl;
+    }
+    expr_eval_unsupported_.store(true, std::memory_order_relaxed);
+    return std::nullopt;
+  }
 
+  // In-place updates are applied only after every output has been evaluated,
+  // so a failed evaluation leaves the inputs untouched.
+  for (auto out_index : c10::irange(outputs.size())) {
+    const AliasInfo& alias_info =
+        fusion->getOutputAlias(fusion->outputs()[out_index]);
+    if (alias_info.type != AllocationType::ReuseBuffer) {
+      continue;
+    }
+    auto input_it = std::find(
+        fusion->inputs().begin(),
+        fusion->inputs().end(),
+        alias_info.aliased_io);
+    NVF_ERROR(input_it != fusion->inputs().end());
+    at::Tensor aliased_input =
+        args[std::distance(fusion->inputs().begin(), input_it)]
+            ->as<at::Tensor>();
+    if (Val* offset = alias_info.slice_offset) {
+      int64_t offset_value = 0;
+      if (offset->isConstScalar()) {
+        offset_value = offset->evaluate().as<int64_t>();
+      } else {
+        auto offset_it = std::find(
+            fusion->inputs().begin(), fusion->inputs().end(), offset);
+        NVF_ERROR(offset_it != fusion->inputs().end());
+        offset_value = args[std::distance(fusion->inputs().begin(), offset_it)]
+                           ->as<int64_t>();
+      }
+      aliased_input = sliceOfAliasedTensor(
+          aliased_input,
+          alias_info.slice_axis,
+          offset_value,
+          outputs[out_index].size(alias_info.slice_axis));
+    }
+    aliased_input.copy_(outputs[out_index]);
+    outputs[out_index] = aliased_input;
+  }
+  return outputs;
+}
+
+void FusionKernelRuntime::compileFusion(
+    KernelArgumentHolder args,
+    bool parallel) {
   std::lock_guard<std::mutex> guard(mutex_);
 
+  // Another thread may have compiled this runtime while we waited for the
+  // lock
+  if (std::all_of(
+          executors_.begin(), executors_.end(), [](const auto& executor) {
+            return ExecutorDispatch::isCompiled(executor.get());
+          })) {
+    return;
+  }
+
   NVF_ERROR(
       args.size() == segmented_fusion_->inputs().size(),
       "Inputs were not set up correctly, received ",
@@ -328,7 +894,8 @@ void FusionKernelRuntime::compileFusionParallel(KernelArgumentHolder args) {
   auto group_cache_id = args.getCacheId();
 
   const int64_t num_groups = (int64_t)runtime_workspace_.group_run_order.size();
-  num_live_args_after_segment_runs_.reserve(num_groups);
+  std::vector<int64_t> num_live_args_after_segment_runs;
+  num_live_args_after_segment_runs.reserve(num_groups);
   if (isProfilerEnabled()) {
     FusionProfiler::startCompile();
   }
@@ -336,6 +903,7 @@ void FusionKernelRuntime::compileFusionParallel(KernelArgumentHolder args) {
   std::atomic<bool> detect_exception_in_thread_pool{false};
   std::string thread_pool_error_message;
   std::mutex thread_pool_error_message_mutex;
+  CompileTaskGroup segment_tasks;
   for (int64_t run_order_id = 0; run_order_id < num_groups; ++run_order_id) {
     auto group_to_run = runtime_workspace_.group_run_order.at(run_order_id);
 
@@ -358,20 +926,20 @@ void FusionKernelRuntime::compileFusionParallel(KernelArgumentHolder args) {
       group_runtime_inputs.push(*args_manager.checkTensorMap(input));
     }
 
-    if (num_groups == 1 || isOptionDisabled(DisableOption::ParallelCompile)) {
+    if (num_groups == 1 || !parallel) {
       FUSER_PERF_SCOPE("FusionKernelRuntime::compileFusionParallel");
       c10::cuda::CUDAGuard dg(args.getDeviceIndex());
       c10::Device device(c10::DeviceType::CUDA, args.getDeviceIndex());
       compileKernel(group_runtime_inputs, group_to_run);
     } else {
       // launch compileKernel thread here
-      getThreadPool()->run([this,
-                            args,
-                            group_runtime_inputs,
-                            group_to_run,
-                            &detect_exception_in_thread_pool,
-                            &thread_pool_error_message,
-                            &thread_pool_error_message_mutex]() {
+      segment_tasks.run([this,
+                         args,
+                         group_runtime_inputs,
+                         group_to_run,
+                         &detect_exception_in_thread_pool,
+                         &thread_pool_error_message,
+                         &thread_pool_error_message_mutex]() {
         FUSER_PERF_SCOPE("FusionKernelRuntime::compileFusionParallel");
         try {
           c10::cuda::CUDAGuard dg(args.getDeviceIndex());
@@ -398,12 +966,15 @@ void FusionKernelRuntime::compileFusionParallel(KernelArgumentHolder args) {
     // map output args to tensor map
     args_manager.updateWithSegmentOutputs(
         group_to_run->outputs(), group_runtime_outputs, run_order_id);
-    num_live_args_after_segment_runs_.push_back((int64_t)args.size());
+    num_live_args_after_segment_runs.push_back((int64_t)args.size());
   }
+  // mutex_ is held since the start of the compilation
+  num_live_args_after_segment_runs_ =
+      std::move(num_live_args_after_segment_runs);
 
-  if (num_groups != 1 && !isOptionDisabled(DisableOption::ParallelCompile)) {
+  if (num_groups != 1 && parallel) {
     // Wait until all segments finish compiling
-    getThreadPool()->waitWorkComplete();
+    segment_tasks.wait();
     NVF_ERROR(
         !detect_exception_in_thread_pool.load(),
         "Detected exception while compiling fusion segments in parallel. ",
@@ -414,6 +985,17 @@ void FusionKernelRuntime::compileFusionParallel(KernelArgumentHolder args) {
   if (isProfilerEnabled()) {
     FusionProfiler::stopCompile();
   }
+  // Covers the segmentation of this runtime as well as its compilation
+  if (isDebugDumpEnabled(DebugDumpOption::CompileTimes)) {
+    auto compile_phase_profiler = inst::CompilePhaseProfiler::instance();
+    debug() << "Compile times of fusion " << fusion_id_ << " runtime "
+            << runtime_id_ << ":" << std::endl;
+    compile_phase_profiler->print(debug());
+    // The FusionProfiler collects the phases when it stops
+    if (!isProfilerEnabled()) {
+      compile_phase_profiler->reset();
+    }
+  }
 }
 
 void FusionKernelRuntime::disableLaunchParamCache() {
@@ -446,17 +1028,99 @@ HeuristicParamsList* FusionKernelRuntime::schedulerHeuristics() const {
   return heuristics_.get();
 }
 
+PeakMemoryStats FusionKernelRuntime::predictPeakMemory(
+    const KernelArgumentHolder& args) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::predictPeakMemory");
+  NVF_CHECK(
+      isCompiled(), "Peak memory is only predicted for compiled runtimes");
+
+  // We make a mutable copy of args so that we can use it in an
+  // ArgumentManager
+  KernelArgumentHolder mutable_args(args);
+  ArgumentManager args_manager(
+      mutable_args, runtime_workspace_, segmented_fusion_->inputs());
+  PeakMemoryStats peak_memory;
+  args_manager.trackPeakMemory(&peak_memory);
+
+  const int64_t num_groups = (int64_t)runtime_workspace_.group_run_order.size();
+  for (int64_t run_order_id : c10::irange(num_groups)) {
+    auto group_to_run = runtime_workspace_.group_run_order.at(run_order_id);
+    Fusion* fusion_to_run = group_to_run->getFusion();
+    FusionGuard fg(fusion_to_run);
+
+    KernelArgumentHolder group_runtime_inputs;
+    group_runtime_inputs.setDeviceIndex(args.getDeviceIndex());
+    for (auto input : group_to_run->inputs()) {
+      group_runtime_inputs.push(*args_manager.checkTensorMap(input));
+    }
+
+    if (auto ke = dynamic_cast<KernelExecutor*>(
+            executors_.at(group_to_run->groupId()).get())) {
+      LaunchParams launch_params;
+      CompileParams compile_params;
+      {
+        std::lock_guard<std::mutex> guard(mutex_);
+        std::tie(launch_params, compile_params) =
+            getKernelConfig(group_runtime_inputs, group_to_run);
+      }
+      const auto [work_buffer_bytes, semaphore_bytes] = ke->workBufferBytes(
+          group_runtime_inputs, launch_params, compile_params);
+      args_manager.setSegmentWorkBufferBytes(
+          work_buffer_bytes, semaphore_bytes);
+    }
+
+    auto group_runtime_outputs =
+        inferOutputSizes(fusion_to_run, group_runtime_inputs);
+    args_manager.updateWithSegmentOutputs(
+        group_to_run->outputs(), group_runtime_outputs, run_order_id);
+  }
+  return peak_memory;
+}
+
 const ExecutorLog& FusionKernelRuntime::getMostRecentExecutorLog() const {
   NVF_ERROR(profiling_, "Executor log is only produced in profiling mode");
   return most_recent_executor_log_;
 }
 
+std::unique_ptr<HeuristicParamsList> FusionKernelRuntime::
+    getHeuristicsInValidityRegions(
+        const KernelArgumentHolder& args,
+        std::optional<PrimDataType> forced_index_type) const {
+  if (heuristics_ == nullptr) {
+    return nullptr;
+  }
+  const auto& heuristics_list = heuristics_->heuristicsList();
+  const bool in_validity_regions = std::all_of(
+      heuristics_list.begin(),
+      heuristics_list.end(),
+      [&](const std::unique_ptr<HeuristicParams>& params) {
+        return params->validity_region.has_value() &&
+            (!forced_index_type.has_value() ||
+             params->cparams.index_type == forced_index_type) &&
+            params->validity_region->contains(args);
+      });
+  if (!in_validity_regions) {
+    return nullptr;
+  }
+  auto heuristics =
+      std::make_unique<HeuristicParamsList>(heuristics_list.size());
+  for (auto i : c10::irange(heuristics_list.size())) {
+    heuristics->at((int)i) = heuristics_list.at(i)->clone();
+  }
+  return heuristics;
+}
+
 std::optional<std::unique_ptr<HeuristicParamsList>> FusionKernelRuntime::
     getMaybeHeuristicsFor(
         const KernelArgumentHolder& args,
         std::optional<PrimDataType> forced_index_type) {
   FUSER_PERF_SCOPE("FusionKernelRuntime::getMaybeHeuristicsFor");
 
+  if (auto heuristics =
+          getHeuristicsInValidityRegions(args, forced_index_type)) {
+    return heuristics;
+  }
+
   // The runtime group run order is different from the segmented_fusion group
   // order. Instead of using HeuristicParamsList::emplaceBack, we initialize
   // HeuristicParamsList with the desired number of groups.
@@ -534,7 +1198,10 @@ std::optional<std::unique_ptr<HeuristicParamsList>> FusionKernelRuntime::
       // Check if this scheduler entry matches the previous entry for this
       // segmented group. If no match, then return std::nullptr
       auto heuristic_params = std::move(maybe_heuristic_params.value());
-      if (!heuristic_params->sameAs(
+      if (!applyAutotuneVariant(
+              heuristic_params.get(),
+              autotune_variants_.at(group_to_run->groupId())) ||
+          !heuristic_params->sameAs(
               heuristics_->at(group_to_run->groupId()).get())) {
         return std::nullopt;
       }
@@ -555,23 +1222,96 @@ std::optional<std::unique_ptr<HeuristicParamsList>> FusionKernelRuntime::
 }
 
 void FusionKernelRuntime::updateHeuristicsLaunchParams(
-    HeuristicParamsList* update_heuristics) {
+    HeuristicParamsList* update_heuristics,
+    std::optional<size_t> cache_id) {
   auto scheduler_list_length = heuristics_->heuristicsList().size();
   NVF_ERROR(
       update_heuristics->heuristicsList().size() == scheduler_list_length);
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (cache_id.has_value()) {
+    auto& launch_params = cache_id_launch_params_[cache_id.value()];
+    launch_params.clear();
+    for (const auto& heuristic_params : update_heuristics->heuristicsList()) {
+      launch_params.push_back(heuristic_params->lparams);
+    }
+    return;
+  }
   for (const auto i : c10::irange(scheduler_list_length)) {
     auto& heuristic_params = heuristics_->heuristicsList()[i];
     heuristic_params->lparams = update_heuristics->heuristicsList()[i]->lparams;
   }
 }
 
+bool FusionKernelRuntime::canRunWithInt64Indexing() const {
+  if (!isOptionEnabled(EnableOption::IndexTypeVariants) ||
+      getIndexType() != PrimDataType::Int32) {
+    return false;
+  }
+  // TMA requires 32-bit indexing
+  return std::none_of(
+      schedulers().begin(), schedulers().end(), [](const auto& params) {
+        if (params->scheduler_type == SchedulerType::Matmul) {
+          return true;
+        }
+        auto pparams = dynamic_cast<const PointwiseParams*>(params.get());
+        return pparams != nullptr && pparams->use_tma_load;
+      });
+}
+
+void FusionKernelRuntime::useInt64Indexing(size_t cache_id) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  int64_cache_ids_.insert(cache_id);
+}
+
+ExecutorAbstract* FusionKernelRuntime::getInt64Executor(
+    const KernelArgumentHolder& args,
+    SegmentedGroup* sg) {
+  auto group_id = sg->groupId();
+  ExecutorAbstract* ea = executors_.at(group_id).get();
+  // Only generated kernels depend on the index type
+  if (dynamic_cast<KernelExecutor*>(ea) == nullptr) {
+    return ea;
+  }
+  if (int64_executors_.empty()) {
+    int64_executors_.resize(executors_.size());
+  }
+  std::unique_ptr<ExecutorAbstract>& int64_ea = int64_executors_.at(group_id);
+  if (int64_ea != nullptr) {
+    return int64_ea.get();
+  }
+
+  FUSER_PERF_SCOPE("FusionKernelRuntime::compileInt64Kernel");
+  std::unique_ptr<HeuristicParams> heuristic_params =
+      schedulers().at(group_id)->clone();
+  heuristic_params->cparams.index_type = PrimDataType::Int;
+
+  auto fusion_to_run = segmented_fusion_->makeFusion(sg).second;
+  FusionGuard fg(fusion_to_run.get());
+  if (auto_schedule_) {
+    SchedulerEntry::makeSchedulerInstance(heuristic_params->scheduler_type)
+        ->schedule(fusion_to_run.get(), heuristic_params.get());
+  }
+  int64_ea = ExecutorDispatch::makeExecutor(
+      fusion_to_run.get(), fusion_id_, concrete_id_, runtime_id_, group_id);
+  ExecutorDispatch::compile(
+      int64_ea.get(),
+      fusion_to_run.get(),
+      args,
+      heuristic_params->lparams,
+      heuristic_params->cparams,
+      heuristic_params->scheduler_type);
+  return int64_ea.get();
+}
+
 const std::vector<std::unique_ptr<ExecutorAbstract>>& FusionKernelRuntime::
     executors() const {
   return executors_;
 }
 
 std::unordered_map<Val*, const PolymorphicValue*> FusionKernelRuntime::
-    runSegmentsWithInputs(KernelArgumentHolder& args) {
+    runSegmentsWithInputs(
+        KernelArgumentHolder& args,
+        const std::vector<at::Tensor>& outputs) {
   FUSER_PERF_SCOPE("FusionKernelRuntime::runSegmentsWithInputs");
   NVF_ERROR(
       args.size() == segmented_fusion_->inputs().size(),
@@ -586,12 +1326,136 @@ std::unordered_map<Val*, const PolymorphicValue*> FusionKernelRuntime::
   // group should share cache id.
   auto group_cache_id = args.getCacheId();
   const int64_t num_groups = (int64_t)runtime_workspace_.group_run_order.size();
-  num_live_args_after_segment_runs_.reserve(num_groups);
-  kernel_time_ms_ = 0;
+  if (measure_kernel_time_) {
+    kernel_time_ms_ = 0;
+  }
+
+  const int64_t num_streams = numSegmentStreams();
+  if (num_streams > 1 && num_streams != num_segment_streams_) {
+    assignSegmentStreams(num_streams);
+  }
+  const auto device_index = (c10::DeviceIndex)args.getDeviceIndex();
+  std::vector<c10::cuda::CUDAStream> streams;
+  if (num_streams > 1) {
+    streams.push_back(c10::cuda::getCurrentCUDAStream(device_index));
+    for (auto i : c10::irange(1, num_streams)) {
+      (void)i; // Suppress unused variable warning
+      streams.push_back(c10::cuda::getStreamFromPool(
+          /*isHighPriority=*/false, device_index));
+    }
+    // Side streams start after the work already enqueued on the current
+    // stream, e.g. the producers of the inputs
+    segment_fork_event_.record(streams.front());
+  }
+  std::vector<bool> stream_forked(num_streams, false);
+
+  // Memory is only accounted when it is reported
+  PeakMemoryStats peak_memory;
+  const bool track_peak_memory = profiling_ || isProfilerEnabled() ||
+      isDebugDumpEnabled(DebugDumpOption::PeakMemory);
+  if (track_peak_memory) {
+    args_manager.trackPeakMemory(&peak_memory);
+  }
+
+  // Given buffers are passed to the kernels producing the fusion outputs that
+  // are new buffers. A fusion output listed twice is written to the first
+  // buffer given for it.
+  std::unordered_map<Val*, at::Tensor> given_outputs;
+  if (!outputs.empty()) {
+    Fusion* fusion = segmented_fusion_->completeFusion();
+    NVF_ERROR(outputs.size() == fusion->outputs().size());
+    for (const auto i : c10::irange(outputs.size())) {
+      Val* out = fusion->outputs()[i];
+      if (outputs[i].defined() && !out->isFusionInput() &&
+          fusion->getOutputAlias(out).type == AllocationType::New) {
+        given_outputs.emplace(out, outputs[i]);
+      }
+    }
+  }
+
+  // The producers of a zero-copy concatenation write into slices of its
+  // output, which is allocated up front. Skipped segments would be missing
+  // from the profiles, and the producers may run on other streams than the
+  // allocation.
+  std::unordered_map<SegmentedGroup*, at::Tensor> zero_copy_cat_outputs;
+  if (isOptionEnabled(EnableOption::ZeroCopyCat) && num_streams == 1 &&
+      !track_peak_memory) {
+    zero_copy_cat_outputs = allocateZeroCopyCats(args, given_outputs);
+  }
+
+  // Intermediates reuse arena memory in run order, which does not order
+  // segments on different streams
+  const bool use_arena = num_streams == 1 && outputs.empty() &&
+      zero_copy_cat_outputs.empty() && canUseIntermediateArena(args);
+
+  ArenaEntry* arena_entry = nullptr;
+  std::vector<std::vector<ArenaTensor>> recorded_outputs;
+  if (use_arena) {
+    if (auto it = arena_entries_.find(group_cache_id.value());
+        it != arena_entries_.end()) {
+      arena_entry = it->second.get();
+      auto stream = c10::cuda::getCurrentCUDAStream(device_index);
+      if (!intermediate_arena_.defined() ||
+          intermediate_arena_.numel() < arena_entry->arena_bytes ||
+          arena_stream_ != stream) {
+        intermediate_arena_ = at::empty(
+            {arena_entry->arena_bytes},
+            at::TensorOptions()
+                .dtype(at::kByte)
+                .device(c10::DeviceType::CUDA, device_index));
+        arena_stream_ = stream;
+      }
+    } else {
+      recorded_outputs.reserve(num_groups);
+    }
+  }
+  // The intermediates of a planned arena are contiguous, so a single window
+  // covers all of them
+  const bool persist_intermediates = arena_entry != nullptr &&
+      isOptionEnabled(EnableOption::L2PersistIntermediates) &&
+      setL2PersistenceWindow(
+          arena_stream_->stream(),
+          intermediate_arena_.data_ptr(),
+          arena_entry->arena_bytes);
+
   for (auto run_order_id : c10::irange(num_groups)) {
     // TODO: index mode should be updated per segmented kernel
     // Prepare input vector
     auto group_to_run = runtime_workspace_.group_run_order.at(run_order_id);
+
+    if (auto it = zero_copy_cat_outputs.find(group_to_run);
+        it != zero_copy_cat_outputs.end()) {
+      args_manager.updateWithSegmentOutputs(
+          group_to_run->outputs(),
+          std::vector<at::Tensor>{it->second},
+          run_order_id);
+      continue;
+    }
+
+    std::optional<c10::cuda::CUDAStreamGuard> stream_guard;
+    if (num_streams > 1) {
+      const SegmentStreamInfo& info = segment_streams_.at(run_order_id);
+      const c10::cuda::CUDAStream& stream = streams.at(info.stream);
+      if (info.stream != 0 && !stream_forked.at(info.stream)) {
+        segment_fork_event_.block(stream);
+        stream_forked.at(info.stream) = true;
+      }
+      for (int64_t producer_id : info.producers_on_other_streams) {
+        segment_events_.at(producer_id).block(stream);
+      }
+      // Intermediates are freed from the host once their last consumer is
+      // launched, so the allocator must not reuse a buffer before consumers
+      // on other streams are done with it. Fusion inputs are ordered by the
+      // current stream, which waits for all side streams, and fusion outputs
+      // are recorded on it after the join.
+      for (Val* input : info.inputs_from_other_streams) {
+        const auto& tensor =
+            args_manager.checkTensorMap(input)->as<at::Tensor>();
+        c10::cuda::CUDACachingAllocator::recordStream(
+            tensor.storage().data_ptr(), stream);
+      }
+      stream_guard.emplace(stream);
+    }
     KernelArgumentHolder group_runtime_inputs;
     group_runtime_inputs.setDeviceIndex(args.getDeviceIndex());
     if (group_cache_id.has_value()) {
@@ -604,12 +1468,100 @@ std::unordered_map<Val*, const PolymorphicValue*> FusionKernelRuntime::
     // TODO: currently we are still outputing PyTorch tensors, instead of
     // something abstract. This is quite unsatisfying.
 
+    std::vector<at::Tensor> planned_outputs;
+    if (arena_entry != nullptr) {
+      planned_outputs = allocateSegmentOutputs(
+          arena_entry->segment_outputs.at(run_order_id), device_index);
+    } else if (
+        !given_outputs.empty() &&
+        dynamic_cast<KernelExecutor*>(
+            executors_.at(group_to_run->groupId()).get()) != nullptr) {
+      // Outputs left undefined are allocated by the executor
+      const auto& group_outputs = group_to_run->outputs();
+      for (const auto i : c10::irange(group_outputs.size())) {
+        auto it = given_outputs.find(group_outputs[i]);
+        if (it != given_outputs.end()) {
+          planned_outputs.resize(group_outputs.size());
+          planned_outputs[i] = it->second;
+        }
+      }
+    }
+
     // Run graph segment
-    std::vector<at::Tensor> group_runtime_outputs =
-        runKernelWithInput(group_runtime_inputs, group_to_run);
+    std::vector<at::Tensor> group_runtime_outputs = runKernelWithInput(
+        group_runtime_inputs, group_to_run, std::move(planned_outputs));
+    if (use_arena && arena_entry == nullptr) {
+      auto& recorded = recorded_outputs.emplace_back();
+      for (const auto& output : group_runtime_outputs) {
+        recorded.push_back(
+            {output.sizes().vec(),
+             output.strides().vec(),
+             output.scalar_type(),
+             (int64_t)at::detail::computeStorageNbytes(
+                 output.sizes(), output.strides(), output.itemsize())});
+      }
+    }
+    if (num_streams > 1 && segment_streams_.at(run_order_id).record_event) {
+      segment_events_.at(run_order_id)
+          .record(streams.at(segment_streams_.at(run_order_id).stream));
+    }
+    if (track_peak_memory) {
+      if (auto ke = dynamic_cast<KernelExecutor*>(
+              executors_.at(group_to_run->groupId()).get())) {
+        const auto [work_buffer_bytes, semaphore_bytes] =
+            ke->lastWorkBufferBytes();
+        args_manager.setSegmentWorkBufferBytes(
+            work_buffer_bytes, semaphore_bytes);
+      }
+    }
     args_manager.updateWithSegmentOutputs(
         group_to_run->outputs(), group_runtime_outputs, run_order_id);
-    num_live_args_after_segment_runs_.push_back((int64_t)args.size());
+  }
+
+  if (persist_intermediates) {
+    clearL2PersistenceWindow(arena_stream_->stream());
+  }
+
+  if (use_arena && arena_entry == nullptr) {
+    arena_entries_.emplace(
+        group_cache_id.value(),
+        planIntermediateArena(std::move(recorded_outputs)));
+  }
+
+  // Join the side streams into the current stream
+  for (auto stream : c10::irange(1, num_streams)) {
+    if (int64_t last_id = last_segment_on_stream_.at(stream); last_id >= 0) {
+      segment_events_.at(last_id).block(streams.front());
+    }
+  }
+  // Outputs allocated on a side stream are returned to the caller, which
+  // frees them in the order of the current stream
+  if (num_streams > 1) {
+    for (Val* output : fusionSegments()->outputs()) {
+      const PolymorphicValue* value = args_manager.checkTensorMap(output);
+      if (!value->is<at::Tensor>()) {
+        continue;
+      }
+      const auto& tensor = value->as<at::Tensor>();
+      if (tensor.defined() && tensor.is_cuda()) {
+        c10::cuda::CUDACachingAllocator::recordStream(
+            tensor.storage().data_ptr(), streams.front());
+      }
+    }
+  }
+
+  if (track_peak_memory) {
+    if (profiling_) {
+      std::lock_guard<std::mutex> guard(mutex_);
+      most_recent_executor_log_.peak_memory = peak_memory;
+    }
+    if (isProfilerEnabled()) {
+      FusionProfiler::peakMemoryBytes(peak_memory.peak_bytes);
+    }
+    if (isDebugDumpEnabled(DebugDumpOption::PeakMemory)) {
+      debug() << "Memory of fusion " << fusion_id_ << " runtime "
+              << runtime_id_ << ": " << peak_memory.toString() << std::endl;
+    }
   }
 
   if (isProfilerEnabled()) {
@@ -636,11 +1588,366 @@ std::unordered_map<Val*, const PolymorphicValue*> FusionKernelRuntime::
   return args_manager.getTensorMap();
 }
 
+int64_t FusionKernelRuntime::numSegmentStreams() const {
+  if (!isOptionEnabled(EnableOption::ConcurrentSegments) ||
+      runtime_workspace_.group_run_order.size() < 2 || isProfilerEnabled()) {
+    return 1;
+  }
+  int64_t num_streams = 4;
+  const auto& option_args =
+      getEnableOptionArguments(EnableOption::ConcurrentSegments);
+  if (!option_args.empty()) {
+    try {
+      num_streams = std::stol(option_args.at(0));
+    } catch (const std::exception&) {
+      NVF_THROW(
+          "Invalid number of streams for concurrent_segments: ",
+          option_args.at(0));
+    }
+    NVF_CHECK(
+        num_streams > 0,
+        "Invalid number of streams for concurrent_segments: ",
+        num_streams);
+  }
+  return num_streams;
+}
+
+void FusionKernelRuntime::assignSegmentStreams(int64_t num_streams) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::assignSegmentStreams");
+  const auto& run_order = runtime_workspace_.group_run_order;
+  const int64_t num_groups = (int64_t)run_order.size();
+
+  std::unordered_map<SegmentedGroup*, int64_t> run_order_ids;
+  for (auto run_order_id : c10::irange(num_groups)) {
+    run_order_ids.emplace(run_order.at(run_order_id), run_order_id);
+  }
+
+  segment_streams_.assign(num_groups, SegmentStreamInfo());
+  last_segment_on_stream_.assign(num_streams, -1);
+  std::vector<bool> handed_over_stream(num_groups, false);
+  int64_t next_stream = 0;
+  for (auto run_order_id : c10::irange(num_groups)) {
+    SegmentedGroup* group = run_order.at(run_order_id);
+    SegmentStreamInfo& info = segment_streams_.at(run_order_id);
+
+    int64_t stream = -1;
+    for (SegmentedEdge* edge : group->producer_edges) {
+      int64_t producer_id = run_order_ids.at(edge->from);
+      if (!handed_over_stream.at(producer_id)) {
+        handed_over_stream.at(producer_id) = true;
+        stream = segment_streams_.at(producer_id).stream;
+        break;
+      }
+    }
+    if (stream < 0) {
+      stream = next_stream;
+      next_stream = (next_stream + 1) % num_streams;
+    }
+    info.stream = stream;
+
+    for (SegmentedEdge* edge : group->producer_edges) {
+      int64_t producer_id = run_order_ids.at(edge->from);
+      SegmentStreamInfo& producer_info = segment_streams_.at(producer_id);
+      if (producer_info.stream == stream) {
+        continue;
+      }
+      producer_info.record_event = true;
+      if (std::find(
+              info.producers_on_other_streams.begin(),
+              info.producers_on_other_streams.end(),
+              producer_id) == info.producers_on_other_streams.end()) {
+        info.producers_on_other_streams.push_back(producer_id);
+      }
+      if (edge->val->isA<TensorView>() &&
+          std::find(
+              info.inputs_from_other_streams.begin(),
+              info.inputs_from_other_streams.end(),
+              edge->val) == info.inputs_from_other_streams.end()) {
+        info.inputs_from_other_streams.push_back(edge->val);
+      }
+    }
+    last_segment_on_stream_.at(stream) = run_order_id;
+  }
+  for (auto stream : c10::irange(1, num_streams)) {
+    if (int64_t last_id = last_segment_on_stream_.at(stream); last_id >= 0) {
+      segment_streams_.at(last_id).record_event = true;
+    }
+  }
+
+  segment_events_.resize(num_groups);
+  num_segment_streams_ = num_streams;
+}
+
+bool FusionKernelRuntime::canUseIntermediateArena(
+    const KernelArgumentHolder& args) const {
+  return isOptionEnabled(EnableOption::IntermediateArena) &&
+      args.getCacheId().has_value() && is_segmented_ &&
+      c10::cuda::currentStreamCaptureStatusMayInitCtx() ==
+      c10::cuda::CaptureStatus::None;
+}
+
+const std::unordered_map<Val*, int64_t>& FusionKernelRuntime::
+    arenaIntermediates() {
+  if (arena_intermediates_.has_value()) {
+    return arena_intermediates_.value();
+  }
+
+  const auto& run_order = runtime_workspace_.group_run_order;
+  const std::unordered_set<Val*> fusion_outputs(
+      segmented_fusion_->outputs().begin(), segmented_fusion_->outputs().end());
+  std::unordered_map<Val*, int64_t> last_uses;
+  std::unordered_set<Val*> excluded;
+  for (auto run_order_id : c10::irange((int64_t)run_order.size())) {
+    SegmentedGroup* group = run_order.at(run_order_id);
+    const bool eligible =
+        allocatesNewOutputs(executors_.at(group->groupId()).get());
+    for (Val* input : group->inputs()) {
+      if (auto it = last_uses.find(input); it != last_uses.end()) {
+        it->second = run_order_id;
+        if (!eligible) {
+          excluded.insert(input);
+        }
+      }
+    }
+    if (!eligible) {
+      continue;
+    }
+    for (Val* output : group->outputs()) {
+      if (output->isA<TensorView>() && !fusion_outputs.count(output)) {
+        last_uses.emplace(output, run_order_id);
+      }
+    }
+  }
+  for (Val* val : excluded) {
+    last_uses.erase(val);
+  }
+  arena_intermediates_ = std::move(last_uses);
+  return arena_intermediates_.value();
+}
+
+std::unique_ptr<FusionKernelRuntime::ArenaEntry> FusionKernelRuntime::
+    planIntermediateArena(
+        std::vector<std::vector<ArenaTensor>> segment_outputs) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::planIntermediateArena");
+  const auto& run_order = runtime_workspace_.group_run_order;
+  NVF_ERROR(segment_outputs.size() == run_order.size());
+  const auto& intermediates = arenaIntermediates();
+
+  std::vector<IntermediateArenaPlan::Buffer> buffers;
+  std::vector<ArenaTensor*> planned;
+  for (auto run_order_id : c10::irange((int64_t)run_order.size())) {
+    const auto& group_outputs = run_order.at(run_order_id)->outputs();
+    auto& outputs = segment_outputs.at(run_order_id);
+    NVF_ERROR(outputs.size() == group_outputs.size());
+    for (auto i : c10::irange(outputs.size())) {
+      auto it = intermediates.find(group_outputs.at(i));
+      if (it == intermediates.end()) {
+        continue;
+      }
+      buffers.push_back({outputs.at(i).num_bytes, run_order_id, it->second});
+      planned.push_back(&outputs.at(i));
+    }
+  }
+
+  IntermediateArenaPlan plan(std::move(buffers));
+  for (auto i : c10::irange(planned.size())) {
+    planned.at(i)->offset = plan.offsets().at(i);
+  }
+
+  auto entry = std::make_unique<ArenaEntry>();
+  entry->arena_bytes = plan.arenaBytes();
+  entry->segment_outputs = std::move(segment_outputs);
+  for (auto& outputs : entry->segment_outputs) {
+    if (std::none_of(outputs.begin(), outputs.end(), [](const auto& output) {
+          return output.offset >= 0;
+        })) {
+      outputs.clear();
+    }
+  }
+  return entry;
+}
+
+std::vector<at::Tensor> FusionKernelRuntime::allocateSegmentOutputs(
+    const std::vector<ArenaTensor>& outputs,
+    c10::DeviceIndex device_index) {
+  std::vector<at::Tensor> tensors;
+  tensors.reserve(outputs.size());
+  for (const auto& output : outputs) {
+    if (output.offset < 0) {
+      tensors.push_back(at::empty_strided(
+          output.sizes,
+          output.strides,
+          at::TensorOptions().dtype(output.dtype).device(
+              c10::DeviceType::CUDA, device_index)));
+    } else {
+      tensors.push_back(
+          intermediate_arena_.narrow(0, output.offset, output.num_bytes)
+              .view(output.dtype)
+              .as_strided(output.sizes, output.strides));
+    }
+    if (shouldFillAllocationWithNan()) {
+      fillTensorWithNan(tensors.back());
+    }
+  }
+  return tensors;
+}
+
+const std::vector<FusionKernelRuntime::ZeroCopyCat>& FusionKernelRuntime::
+    zeroCopyCats() {
+  if (zero_copy_cats_.has_value()) {
+    return zero_copy_cats_.value();
+  }
+
+  std::unordered_map<Val*, SegmentedGroup*> producers;
+  for (SegmentedGroup* group : runtime_workspace_.group_run_order) {
+    for (Val* output : group->outputs()) {
+      producers.emplace(output, group);
+    }
+  }
+
+  std::vector<ZeroCopyCat> cats;
+  for (SegmentedGroup* group : runtime_workspace_.group_run_order) {
+    if (group->outputs().size() != 1) {
+      continue;
+    }
+    auto* cat = dynamic_cast<CatOp*>(group->outputs().at(0)->definition());
+    if (cat == nullptr ||
+        !std::all_of(
+            group->exprs().begin(), group->exprs().end(), [&](Expr* expr) {
+              return expr == cat ||
+                  (expr->isA<PadOp>() &&
+                   expr->output(0)->uses() == std::vector<Expr*>{cat});
+            })) {
+      continue;
+    }
+    auto* out = cat->output(0)->as<TensorView>();
+    Fusion* fusion = segmented_fusion_->completeFusion();
+    if (!isDenseLayout(out) ||
+        (out->isFusionOutput() &&
+         fusion->getOutputAlias(out).type != AllocationType::New)) {
+      continue;
+    }
+
+    ZeroCopyCat zero_copy_cat{group, out, cat->concatenatedDim(), {}};
+    std::unordered_set<TensorView*> inputs;
+    for (Val* padded : cat->inputs()) {
+      auto* pad = dynamic_cast<PadOp*>(padded->definition());
+      if (pad == nullptr ||
+          std::find(group->exprs().begin(), group->exprs().end(), pad) ==
+              group->exprs().end() ||
+          pad->getPaddedAxes() != std::vector<int64_t>{zero_copy_cat.axis}) {
+        break;
+      }
+      auto* in = pad->in()->as<TensorView>();
+      auto producer = producers.find(in);
+      if (producer == producers.end() || in->isFusionOutput() ||
+          in->uses().size() != 1 || !isDenseLayout(in) ||
+          !inputs.insert(in).second ||
+          !allocatesNewOutputs(
+              executors_.at(producer->second->groupId()).get())) {
+        break;
+      }
+      zero_copy_cat.pads.push_back(pad);
+    }
+    if (zero_copy_cat.pads.size() == cat->inputs().size()) {
+      cats.push_back(std::move(zero_copy_cat));
+    }
+  }
+  zero_copy_cats_ = std::move(cats);
+  return zero_copy_cats_.value();
+}
+
+std::unordered_map<SegmentedGroup*, at::Tensor> FusionKernelRuntime::
+    allocateZeroCopyCats(
+        const KernelArgumentHolder& args,
+        std::unordered_map<Val*, at::Tensor>& given_outputs) {
+  std::unordered_map<SegmentedGroup*, at::Tensor> cat_outputs;
+  const auto& cats = zeroCopyCats();
+  if (cats.empty()) {
+    return cat_outputs;
+  }
+  FUSER_PERF_SCOPE("FusionKernelRuntime::allocateZeroCopyCats");
+
+  // Vectorized stores into the slices must stay aligned
+  constexpr int64_t kSliceAlignment = 16;
+  const auto evaluate_sizes = [](ExpressionEvaluator& expr_eval,
+                                 TensorView* tv) {
+    std::vector<int64_t> sizes;
+    for (IterDomain* id :
+         TensorDomain::noReductions(tv->getLogicalDomain())) {
+      PolymorphicValue extent = expr_eval.evaluate(id->extent());
+      if (!extent.hasValue()) {
+        return std::optional<std::vector<int64_t>>();
+      }
+      sizes.push_back(extent.as<int64_t>());
+    }
+    return std::make_optional(std::move(sizes));
+  };
+
+  ExpressionEvaluator expr_eval = executor_utils::bindInputs(
+      args, segmented_fusion_->completeFusion(), /*validate=*/false);
+  for (const ZeroCopyCat& cat : cats) {
+    std::optional<std::vector<int64_t>> out_sizes =
+        evaluate_sizes(expr_eval, cat.out);
+    if (!out_sizes.has_value()) {
+      continue;
+    }
+    at::Tensor out_tensor;
+    if (auto it = given_outputs.find(cat.out); it != given_outputs.end()) {
+      out_tensor = it->second;
+    } else {
+      out_tensor = at::empty(
+          out_sizes.value(),
+          at::TensorOptions()
+              .dtype(data_type_to_aten(cat.out->dtype()))
+              .device(c10::DeviceType::CUDA, args.getDeviceIndex()));
+    }
+    if (!out_tensor.is_contiguous() ||
+        out_tensor.sizes() != c10::IntArrayRef(out_sizes.value())) {
+      continue;
+    }
+
+    // Each input is padded to the extent of the output, starting at the end
+    // of the previous input
+    std::vector<at::Tensor> slices;
+    int64_t offset = 0;
+    for (PadOp* pad : cat.pads) {
+      std::optional<std::vector<int64_t>> in_sizes =
+          evaluate_sizes(expr_eval, pad->in()->as<TensorView>());
+      PolymorphicValue left_pad =
+          expr_eval.evaluate(pad->getPadWidths(cat.axis).first);
+      if (!in_sizes.has_value() || !left_pad.hasValue() ||
+          left_pad.as<int64_t>() != offset) {
+        break;
+      }
+      const int64_t extent = in_sizes->at(cat.axis);
+      at::Tensor slice = out_tensor.narrow(cat.axis, offset, extent);
+      offset += extent;
+      if (!slice.is_contiguous() ||
+          reinterpret_cast<uintptr_t>(slice.data_ptr()) % kSliceAlignment !=
+              0) {
+        break;
+      }
+      slices.push_back(std::move(slice));
+    }
+    if (slices.size() != cat.pads.size() ||
+        offset != out_sizes->at(cat.axis)) {
+      continue;
+    }
+    for (auto i : c10::irange(slices.size())) {
+      given_outputs[cat.pads.at(i)->in()] = std::move(slices.at(i));
+    }
+    cat_outputs.emplace(cat.group, std::move(out_tensor));
+  }
+  return cat_outputs;
+}
+
 std::vector<at::Tensor> FusionKernelRuntime::runKernelWithInput(
     KernelArgumentHolder& args,
-    SegmentedGroup* sg) {
-  FUSER_PERF_SCOPE("FusionKernelRuntime::runKernelWithInput");
-  std::lock_guard<std::mutex> guard(mutex_);
+    SegmentedGroup* sg,
+    std::vector<at::Tensor> outputs) {
+  FUSER_PERF_SEGMENT_SCOPE(
+      "FusionKernelRuntime::runKernelWithInput", sg ? sg->groupId() : -1);
   // This function will be called once on un-segmented fusion,
   // for segmented fusion, this function will be called on each segment
   // In the case of segmented fusion, segmented group needs to be given so
@@ -648,32 +1955,105 @@ std::vector<at::Tensor> FusionKernelRuntime::runKernelWithInput(
   // In the case of complete fusion, sg = nullptr, and the original fusion
   // is complied and run.
   NVF_ERROR(sg, "runKernelWithInput: need valid group to run");
-  auto [launch_params, compile_params] = getKernelConfig(args, sg);
   auto group_id = sg->groupId();
-  auto heuristic_params = schedulers().at(group_id).get();
-  ExecutorAbstract* ea = executors_.at(group_id).get();
+  LaunchParams launch_params;
+  CompileParams compile_params;
+  ExecutorAbstract* ea = nullptr;
+  HeuristicParams* heuristic_params = nullptr;
+  const bool record_perf = isOptionEnabled(EnableOption::KernelPerfDb);
+  {
+    // The executor itself is run without the lock, so that threads sharing
+    // this runtime launch concurrently
+    std::lock_guard<std::mutex> guard(mutex_);
+    std::tie(launch_params, compile_params) = getKernelConfig(args, sg);
+    heuristic_params = schedulers().at(group_id).get();
+    if (args.getCacheId().has_value() &&
+        int64_cache_ids_.count(args.getCacheId().value()) > 0) {
+      ea = getInt64Executor(args, sg);
+      compile_params.index_type = PrimDataType::Int;
+    } else {
+      ea = executors_.at(group_id).get();
+    }
+
+    if (profiling_) {
+      most_recent_executor_log_.fusion_executor = ea;
+      most_recent_executor_log_.params = heuristic_params->clone();
+    }
 
-  if (profiling_) {
-    most_recent_executor_log_.fusion_executor = ea;
-    most_recent_executor_log_.params = heuristic_params->clone();
+    // TODO: This is a work around for the fallback execution path where a
+    // kernel is not compiled. Perhaps the group/segment Id needs to be
+    // specified to the executor at its constructor.  Currently,
+    // initialization is ad hoc.
+    if (auto ke = dynamic_cast<KernelExecutor*>(ea)) {
+      ke->setGroupId(group_id);
+    }
+
+    if (record_perf && !perf_db_fusion_hash_.has_value()) {
+      std::stringstream ss;
+      segmented_fusion_->completeFusion()->print(
+          ss, /*include_tensor_transforms=*/false);
+      perf_db_fusion_hash_ = stable_hash(ss.str());
+    }
+  }
+  if (!record_perf) {
+    return ExecutorDispatch::run(
+        ea, args, launch_params, compile_params, std::move(outputs));
   }
 
-  // TODO: This is a work around for the fallback execution path where a
-  // kernel is not compiled. Perhaps the group/segment Id needs to be
-  // specified to the executor at its constructor.  Currently, initialization
-  // is ad hoc.
-  if (auto ke = dynamic_cast<KernelExecutor*>(ea)) {
-    ke->setGroupId(group_id);
+  // run appends the outputs to args, so the signature is taken first
+  const std::string inputs = inputsSignature(args);
+  CudaEventTimer timer(at::cuda::getCurrentCUDAStream());
+  timer.start();
+  auto kernel_outputs = ExecutorDispatch::run(
+      ea, args, launch_params, compile_params, std::move(outputs));
+  timer.stop();
+  recordKernelPerf(sg, ea, heuristic_params, inputs, timer.time());
+  return kernel_outputs;
+}
+
+void FusionKernelRuntime::recordKernelPerf(
+    SegmentedGroup* sg,
+    ExecutorAbstract* ea,
+    HeuristicParams* heuristic_params,
+    const std::string& inputs,
+    double time_ms) {
+  // Only kernels are recorded, not segments evaluated on the host
+  auto ke = dynamic_cast<KernelExecutor*>(ea);
+  if (ke == nullptr || !ke->hasCompiledKernel()) {
+    return;
   }
-  auto outputs = ExecutorDispatch::run(ea, args, launch_params, compile_params);
+  FUSER_PERF_SCOPE("FusionKernelRuntime::recordKernelPerf");
 
-  return outputs;
+  KernelPerfRecord record;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    record.fusion_hash = perf_db_fusion_hash_.value();
+  }
+  record.segment = sg->groupId();
+  const auto prop = at::cuda::getCurrentDeviceProperties();
+  record.gpu = std::string(prop->name) + " (sm_" +
+      std::to_string(prop->major * 10 + prop->minor) + ")";
+  record.inputs = inputs;
+  record.kernel_name = ke->kernelName();
+  record.scheduler = toString(heuristic_params->scheduler_type);
+  record.heuristic_params = heuristic_params->toString();
+  int registers = -1;
+  NVFUSER_CUDA_SAFE_CALL(cuFuncGetAttribute(
+      &registers,
+      CU_FUNC_ATTRIBUTE_NUM_REGS,
+      ke->compiledKernel().getFunction()));
+  record.registers = registers;
+  record.time_ms = time_ms;
+  if (!KernelPerfDb::get().record(record)) {
+    TORCH_WARN(
+        "Kernel perf db: Unable to record a run of ", record.kernel_name);
+  }
 }
 
 void FusionKernelRuntime::compileKernel(
     const KernelArgumentHolder& args,
     SegmentedGroup* sg) {
-  FUSER_PERF_SCOPE("FusionKernelRuntime::compileKernel");
+  FUSER_PERF_SEGMENT_SCOPE("FusionKernelRuntime::compileKernel", sg->groupId());
   auto group_id = sg->groupId();
   auto heuristic_params = schedulers().at(group_id).get();
 
@@ -682,12 +2062,23 @@ void FusionKernelRuntime::compileKernel(
 
   // Running a segment group as a single kernel,
   // make a fusion to run from segmented fusion
+  if (!autotune_variants_preset_ && canAutotune(args, sg)) {
+    autotuneKernel(args, sg);
+    return;
+  }
+  if (!autotune_variants_preset_ && canLimitRegisterPressure(sg)) {
+    limitRegisterPressure(args, sg);
+    return;
+  }
+
   auto fusion_to_run = segmented_fusion_->makeFusion(sg).second;
   if (isDebugDumpEnabled(DebugDumpOption::FusionIrPresched)) {
     fusion_to_run->printMath();
   }
   FusionGuard fg(fusion_to_run.get());
   if (auto_schedule_) {
+    FUSER_COMPILE_PHASE_SCOPE(
+        toString(heuristic_params->scheduler_type) + " schedule");
     SchedulerEntry::makeSchedulerInstance(heuristic_params->scheduler_type)
         ->schedule(fusion_to_run.get(), heuristic_params);
   }
@@ -708,6 +2099,258 @@ void FusionKernelRuntime::compileKernel(
       heuristic_params->scheduler_type);
 }
 
+bool FusionKernelRuntime::presetAutotuneVariants(
+    const std::vector<AutotuneVariant>& variants) {
+  NVF_ERROR(
+      !isCompiling() && !isCompiled(),
+      "Autotuned variants must be preset before compilation");
+  if (variants.size() != autotune_variants_.size()) {
+    return false;
+  }
+  std::vector<std::unique_ptr<HeuristicParams>> tuned_params;
+  tuned_params.reserve(variants.size());
+  for (auto group_id : c10::irange(variants.size())) {
+    auto params = heuristics_->at((int)group_id)->clone();
+    if (!applyAutotuneVariant(params.get(), variants.at(group_id))) {
+      return false;
+    }
+    tuned_params.push_back(std::move(params));
+  }
+  for (auto group_id : c10::irange(variants.size())) {
+    heuristics_->at((int)group_id) = std::move(tuned_params.at(group_id));
+  }
+  autotune_variants_ = variants;
+  autotune_variants_preset_ = true;
+  return true;
+}
+
+bool FusionKernelRuntime::canAutotune(
+    const KernelArgumentHolder& args,
+    SegmentedGroup* sg) const {
+  // Timings are noisy, so the variant picked, and thus the reduction order,
+  // could differ between processes
+  if (!isOptionEnabled(EnableOption::Autotune) ||
+      isOptionEnabled(EnableOption::DeterministicReductions) ||
+      !auto_schedule_ || is_segmented_ || isProfilerEnabled() ||
+      autotuneVariants(schedulers().at(sg->groupId()).get()).size() < 2) {
+    return false;
+  }
+  // Every tensor input has to be materialized to run the kernel
+  for (const auto& arg : args) {
+    if (arg->is<at::Tensor>() && !arg->as<at::Tensor>().is_cuda()) {
+      return false;
+    }
+  }
+  Fusion* fusion = segmented_fusion_->completeFusion();
+  if (ir_utils::hasOpsOfType<RNGOp>(fusion)) {
+    return false;
+  }
+  return std::none_of(
+      fusion->outputs().begin(), fusion->outputs().end(), [fusion](Val* out) {
+        return fusion->getOutputAlias(out).type == AllocationType::ReuseBuffer;
+      });
+}
+
+void FusionKernelRuntime::autotuneKernel(
+    const KernelArgumentHolder& args,
+    SegmentedGroup* sg) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::autotuneKernel");
+  // Each variant is run once to warm up and then timed over several runs
+  constexpr int64_t kAutotuneRuns = 5;
+
+  auto group_id = sg->groupId();
+  const std::unique_ptr<HeuristicParams>& default_params =
+      heuristics_->at(group_id);
+  KernelArgumentHolder run_args(args);
+
+  std::unique_ptr<HeuristicParams> best_params;
+  std::unique_ptr<ExecutorAbstract> best_executor;
+  AutotuneVariant best_variant;
+  double best_time_ms = std::numeric_limits<double>::infinity();
+  for (const auto& variant : autotuneVariants(default_params.get())) {
+    auto params = default_params->clone();
+    NVF_ERROR(applyAutotuneVariant(params.get(), variant));
+    std::unique_ptr<ExecutorAbstract> executor;
+    double time_ms = 0.0;
+    try {
+      auto fusion_to_run = segmented_fusion_->makeFusion(sg).second;
+      FusionGuard fg(fusion_to_run.get());
+      SchedulerEntry::makeSchedulerInstance(params->scheduler_type)
+          ->schedule(fusion_to_run.get(), params.get());
+      executor = ExecutorDispatch::makeExecutor(
+          fusion_to_run.get(), fusion_id_, concrete_id_, runtime_id_, group_id);
+      ExecutorDispatch::compile(
+          executor.get(),
+          fusion_to_run.get(),
+          args,
+          params->lparams,
+          params->cparams,
+          params->scheduler_type);
+
+      ExecutorDispatch::run(
+          executor.get(), run_args, params->lparams, params->cparams);
+      CudaEventTimer timer(at::cuda::getCurrentCUDAStream());
+      timer.start();
+      for (int64_t i = 0; i < kAutotuneRuns; ++i) {
+        ExecutorDispatch::run(
+            executor.get(), run_args, params->lparams, params->cparams);
+      }
+      timer.stop();
+      time_ms = timer.time() / (double)kAutotuneRuns;
+    } catch (const std::exception& e) {
+      // The analytical heuristics must always work
+      if (variant.isDefault()) {
+        throw;
+      }
+      if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+        debug() << "Autotune: skipping " << variant.toString() << ": "
+                << e.what() << std::endl;
+      }
+      continue;
+    }
+    if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+      debug() << "Autotune: " << variant.toString() << " takes " << time_ms
+              << " ms" << std::endl;
+    }
+    if (time_ms < best_time_ms) {
+      best_time_ms = time_ms;
+      best_params = std::move(params);
+      best_executor = std::move(executor);
+      best_variant = variant;
+    }
+  }
+
+  heuristics_->at(group_id) = std::move(best_params);
+  executors_[group_id] = std::move(best_executor);
+  autotune_variants_.at(group_id) = best_variant;
+}
+
+bool FusionKernelRuntime::canLimitRegisterPressure(SegmentedGroup* sg) const {
+  return isOptionEnabled(EnableOption::LimitRegisterPressure) &&
+      auto_schedule_ &&
+      registerPressureVariants(schedulers().at(sg->groupId()).get()).size() >
+      1;
+}
+
+void FusionKernelRuntime::limitRegisterPressure(
+    const KernelArgumentHolder& args,
+    SegmentedGroup* sg) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::limitRegisterPressure");
+  int64_t allowed_spill = 0;
+  const auto& option_args =
+      getEnableOptionArguments(EnableOption::LimitRegisterPressure);
+  if (!option_args.empty()) {
+    try {
+      allowed_spill = std::stoi(option_args[0]);
+    } catch (const std::exception& e) {
+      debug() << "skip invalid argument for LimitRegisterPressure, arg = "
+              << option_args[0] << std::endl;
+    }
+  }
+
+  auto group_id = sg->groupId();
+  const std::unique_ptr<HeuristicParams>& default_params =
+      heuristics_->at(group_id);
+  const std::vector<AutotuneVariant> variants =
+      registerPressureVariants(default_params.get());
+
+  std::unique_ptr<HeuristicParams> best_params;
+  std::unique_ptr<ExecutorAbstract> best_executor;
+  AutotuneVariant best_variant;
+  int64_t best_spills = std::numeric_limits<int64_t>::max();
+  for (const auto i : c10::irange(variants.size())) {
+    const AutotuneVariant& variant = variants.at(i);
+    auto params = default_params->clone();
+    NVF_ERROR(applyAutotuneVariant(params.get(), variant));
+    std::unique_ptr<ExecutorAbstract> executor;
+    int64_t spills = 0;
+    try {
+      auto fusion_to_run = segmented_fusion_->makeFusion(sg).second;
+      FusionGuard fg(fusion_to_run.get());
+      SchedulerEntry::makeSchedulerInstance(params->scheduler_type)
+          ->schedule(fusion_to_run.get(), params.get());
+
+      // Lowering is much cheaper than compiling, so variants that are
+      // estimated to exceed the register budget are skipped. The last variant
+      // is compiled regardless, so that at least one kernel is compiled.
+      if (i + 1 < variants.size()) {
+        GpuLower lower(fusion_to_run.get(), params->cparams);
+        const int64_t registers = estimateRegistersPerThread(lower.run());
+        if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+          debug() << "LimitRegisterPressure: " << variant.toString()
+                  << " is estimated to use " << registers << " registers"
+                  << std::endl;
+        }
+        if (registers > params->cparams.maxrregcount) {
+          continue;
+        }
+      }
+
+      CompileParams cparams = params->cparams;
+      cparams.enable_ptxas_verbose = true;
+      executor = ExecutorDispatch::makeExecutor(
+          fusion_to_run.get(), fusion_id_, concrete_id_, runtime_id_, group_id);
+      ExecutorDispatch::compile(
+          executor.get(),
+          fusion_to_run.get(),
+          args,
+          params->lparams,
+          cparams,
+          params->scheduler_type);
+      if (auto ke = dynamic_cast<KernelExecutor*>(executor.get())) {
+        spills = ke->getKernelRegisterSpills();
+      }
+    } catch (const std::exception& e) {
+      // The analytical heuristics must always work
+      if (variant.isDefault()) {
+        throw;
+      }
+      if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+        debug() << "LimitRegisterPressure: skipping " << variant.toString()
+                << ": " << e.what() << std::endl;
+      }
+      continue;
+    }
+    if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+      debug() << "LimitRegisterPressure: " << variant.toString() << " spills "
+              << spills << " bytes" << std::endl;
+    }
+    if (spills < best_spills) {
+      best_spills = spills;
+      best_params = std::move(params);
+      best_executor = std::move(executor);
+      best_variant = variant;
+    }
+    if (spills <= allowed_spill) {
+      break;
+    }
+  }
+
+  if (best_executor == nullptr) {
+    // Every variant was skipped, e.g. because the last one fails to
+    // schedule, so fall back to the analytical heuristics
+    best_params = default_params->clone();
+    best_variant = AutotuneVariant();
+    auto fusion_to_run = segmented_fusion_->makeFusion(sg).second;
+    FusionGuard fg(fusion_to_run.get());
+    SchedulerEntry::makeSchedulerInstance(best_params->scheduler_type)
+        ->schedule(fusion_to_run.get(), best_params.get());
+    best_executor = ExecutorDispatch::makeExecutor(
+        fusion_to_run.get(), fusion_id_, concrete_id_, runtime_id_, group_id);
+    ExecutorDispatch::compile(
+        best_executor.get(),
+        fusion_to_run.get(),
+        args,
+        best_params->lparams,
+        best_params->cparams,
+        best_params->scheduler_type);
+  }
+
+  heuristics_->at(group_id) = std::move(best_params);
+  executors_[group_id] = std::move(best_executor);
+  autotune_variants_.at(group_id) = best_variant;
+}
+
 std::pair<LaunchParams, CompileParams> FusionKernelRuntime::getKernelConfig(
     const KernelArgumentHolder& args,
     SegmentedGroup* sg) {
@@ -717,6 +2360,12 @@ std::pair<LaunchParams, CompileParams> FusionKernelRuntime::getKernelConfig(
   // Check that the heuristics are matched, in the case of segmented fusion
   NVF_ERROR(!sg || heuristic_params->scheduler_type == sg->schedulerType());
 
+  if (args.getCacheId().has_value()) {
+    if (auto it = cache_id_launch_params_.find(args.getCacheId().value());
+        it != cache_id_launch_params_.end()) {
+      return std::make_pair(it->second.at(group_id), heuristic_params->cparams);
+    }
+  }
   return std::make_pair(heuristic_params->lparams, heuristic_params->cparams);
 }
 
@@ -7,15 +7,24 @@
 // clang-format on
 #pragma once
 
+#include <ATen/cuda/CUDAEvent.h>
+#include <ATen/cuda/CUDAGraph.h>
+#include <c10/cuda/CUDAStream.h>
 #include <c10/util/ArrayRef.h>
 
 #include <fusion_segmenter.h>
 #include <polymorphic_value.h>
+#include <runtime/compile_thread_pool.h>
 #include <runtime/executor.h>
 #include <runtime/executor_kernel_arg.h>
 #include <runtime/fusion_cache_utils.h>
+#include <runtime/megakernel.h>
+#include <scheduler/autotune.h>
 
+#include <atomic>
 #include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace nvfuser {
@@ -52,7 +61,12 @@ class FusionKernelRuntime {
       int64_t fusion_id = 0,
       int64_t concrete_id = 0,
       int64_t runtime_id = 0,
-      bool auto_schedule = true);
+      bool auto_schedule = true,
+      bool matmul_expr_eval = true);
+
+  //! Waits for an in-flight asynchronous compilation, which refers to this
+  //! runtime
+  ~FusionKernelRuntime();
 
   //! Type notations within FusionKernelRuntime Context
 
@@ -76,12 +90,102 @@ class FusionKernelRuntime {
   PrimDataType getIndexType() const;
 
   //! Unified interface to run the managed kernels with given input
-  NVF_API std::vector<at::Tensor> runWithInputs(KernelArgumentHolder& args);
+  //!
+  //! Several threads may run the same runtime at once. Eager runs only
+  //! serialize on the kernel launches of each executor; runs using CUDA
+  //! graphs, concurrent segments or the intermediate arena are serialized.
+  //!
+  //! With NVFUSER_ENABLE=cuda_graph, the segments are captured into a CUDA
+  //! graph the second time a set of inputs with the same cache id is run,
+  //! including the allocation of intermediate and output tensors. Later runs
+  //! with that cache id copy their inputs into the graph's input buffers
+  //! unless they are those buffers, replay the graph and return copies of its
+  //! outputs.
+  //!
+  //! If given, `outputs` holds a buffer, or an undefined tensor, for each
+  //! output of the complete fusion. Kernels write the outputs that are new
+  //! buffers directly into the given ones; the others are returned as usual
+  //! and are left to the caller. Runs with given outputs are never captured
+  //! into CUDA graphs nor use the intermediate arena.
+  NVF_API std::vector<at::Tensor> runWithInputs(
+      KernelArgumentHolder& args,
+      const std::vector<at::Tensor>& outputs = {});
+
+  //! Returns the number of captured CUDA graphs
+  size_t numCudaGraphs() const {
+    return cuda_graphs_.size();
+  }
+
+  //! Returns the megakernel running the segments with
+  //! EnableOption::Megakernel, if it has been generated
+  const Megakernel* megakernel() const {
+    return megakernel_.get();
+  }
+
+  //! Returns the size of the buffer holding planned intermediates
+  int64_t intermediateArenaBytes() const {
+    return intermediate_arena_.defined() ? intermediate_arena_.numel() : 0;
+  }
+
+  //! Approximate memory held by this runtime: its segmented fusion and the
+  //! code and binaries of its kernels. Used to evict runtimes past a memory
+  //! budget, see FusionCache::setMemoryBudget.
+  int64_t approximateBytes() const;
+
+  //! Records a lookup of this runtime for least-recently-used eviction
+  void markUsed() {
+    last_used_.store(
+        global_use_count_.fetch_add(1, std::memory_order_relaxed) + 1,
+        std::memory_order_relaxed);
+  }
+
+  int64_t runtimeId() const {
+    return runtime_id_;
+  }
+
+  //! A process-wide count of lookups at the most recent use of this runtime,
+  //! so that runtimes of different caches can be ordered
+  uint64_t lastUsed() const {
+    return last_used_.load(std::memory_order_relaxed);
+  }
 
   //! Compile a kernel executor for given inputs. Note: The compilation is
   //! multithreaded. The segments in the fusion are compiled independently.
   NVF_API void compileFusionParallel(KernelArgumentHolder args);
 
+  //! Compile all segments in the background and return immediately. The
+  //! compilation runs as a task of the given priority on the compilation
+  //! thread pool, which compiles the segments in parallel at the same
+  //! priority. The new executors become visible through isCompiled() once
+  //! every segment has been compiled. Does nothing if a compilation is already
+  //! in flight.
+  NVF_API void compileFusionAsync(
+      KernelArgumentHolder args,
+      CompilePriority priority = CompilePriority::Background);
+
+  //! Returns true while a compileFusionAsync task is in flight. Unlike
+  //! isCompiled(), this never blocks on the compilation.
+  bool isCompiling() const {
+    return is_compiling_.load(std::memory_order_acquire);
+  }
+
+  //! Returns true if the most recent compileFusionAsync task threw
+  bool asyncCompileFailed() const {
+    return async_compile_failed_.load(std::memory_order_acquire);
+  }
+
+  //! Blocks until an in-flight compileFusionAsync task finishes. If the task
+  //! hasn't started yet, the calling thread runs it instead of waiting behind
+  //! the other tasks of the pool.
+  void waitForAsyncCompile() const;
+
+  //! Evaluates the unsegmented fusion with ATen through ExpressionEvaluator.
+  //! This serves requests while compileFusionAsync is in flight. Returns
+  //! std::nullopt if the fusion contains an expression that cannot be
+  //! evaluated, e.g. a random number generator.
+  NVF_API std::optional<std::vector<at::Tensor>> runWithExprEval(
+      KernelArgumentHolder& args);
+
   const std::vector<int64_t>& getArgsNumAfterSegmentRuns() {
     return num_live_args_after_segment_runs_;
   }
@@ -123,6 +227,30 @@ class FusionKernelRuntime {
   //! Returns the list of heuristics in this runtime
   HeuristicParamsList* schedulerHeuristics() const;
 
+  //! Returns false if matmuls were segmented for the Matmul scheduler
+  //! instead of being evaluated with ATen
+  bool matmulExprEval() const {
+    return matmul_expr_eval_;
+  }
+
+  //! Returns the autotuned variant of the heuristics of each segment, indexed
+  //! by group id. Segments that were not autotuned use the default variant.
+  const std::vector<AutotuneVariant>& autotunedVariants() const {
+    return autotune_variants_;
+  }
+
+  //! Applies variants tuned before, e.g., found in a HeuristicSnapshot, to the
+  //! heuristics of the segments, which are then compiled without autotuning
+  //! or limiting their register pressure. Returns false, leaving the
+  //! heuristics unchanged, if a variant doesn't apply to its segment.
+  NVF_API bool presetAutotuneVariants(
+      const std::vector<AutotuneVariant>& variants);
+
+  //! Predicts the memory of an execution with args without running it, from
+  //! the inferred sizes of the segment outputs and the work buffers of the
+  //! compiled kernels. args may hold meta tensors. See PeakMemoryStats.
+  NVF_API PeakMemoryStats predictPeakMemory(const KernelArgumentHolder& args);
+
   //! Return the most recently used executor, corresponding to the
   //!  most recent kernel launch.
   //! TODO: have a interface for grabbing all recent logs. Need to put a buffer
@@ -134,6 +262,9 @@ class FusionKernelRuntime {
   //  any segment cannot be scheduled or the parameters don't match
   //
   // Heuristics must use the index type of forced_index_type if given.
+  //
+  // If args fall in the validity regions of the heuristics of every segment,
+  // those heuristics are returned without being computed again.
   NVF_API std::optional<std::unique_ptr<HeuristicParamsList>>
   getMaybeHeuristicsFor(
       const KernelArgumentHolder& args,
@@ -141,30 +272,232 @@ class FusionKernelRuntime {
 
   //! Copy the launch params given in the parameter heuristics to prepare
   //!  for kernel launch for a new input dimension but same heuristics
-  void updateHeuristicsLaunchParams(HeuristicParamsList* update_heuristics);
+  //!
+  //! If cache_id is given, the launch params are only used for inputs with
+  //! that cache id, so that concurrent runs of other inputs are unaffected.
+  void updateHeuristicsLaunchParams(
+      HeuristicParamsList* update_heuristics,
+      std::optional<size_t> cache_id = std::nullopt);
+
+  //! Returns true if this runtime can run inputs that need 64-bit indexing
+  //! with its 32-bit heuristics, i.e., NVFUSER_ENABLE=index_type_variants is
+  //! set and no kernel requires 32-bit indexing. The kernels are then
+  //! recompiled with 64-bit indexing on their first run with such inputs
+  //! without segmenting or computing heuristics again.
+  bool canRunWithInt64Indexing() const;
+
+  //! Runs the inputs with the given cache id with the 64-bit indexing
+  //! variants of the kernels. See canRunWithInt64Indexing.
+  void useInt64Indexing(size_t cache_id);
 
   const std::vector<std::unique_ptr<ExecutorAbstract>>& executors() const;
 
  private:
+  //! Shared implementation of compileFusionParallel and compileFusionAsync.
+  //! Segments are compiled on the thread pool only if parallel is true.
+  void compileFusion(KernelArgumentHolder args, bool parallel);
+
+  //! Copies the complete fusion for runWithExprEval once
+  void initExprEvalFusion();
+
+  //! Runs the segments without a CUDA graph
+  std::vector<at::Tensor> runSegmentsEagerly(
+      KernelArgumentHolder& args,
+      const std::vector<at::Tensor>& outputs = {});
+
+  //! Captured CUDA graph of all segments for one input cache id
+  struct CudaGraphEntry {
+    std::unique_ptr<at::cuda::CUDAGraph> graph;
+    //! Inputs read by the graph. Tensors are owned by the graph.
+    std::vector<PolymorphicValue> inputs;
+    //! Outputs written by the graph, in the memory pool of the graph
+    std::vector<at::Tensor> outputs;
+  };
+
+  //! Returns true if the segments can be captured for args. Segments must
+  //! all be CUDA kernels without host-side RNG state, must not update inputs
+  //! in place, and all tensor inputs must be dense CUDA tensors.
+  bool canUseCudaGraph(const KernelArgumentHolder& args);
+
+  //! Replays, or captures then replays, the CUDA graph of the cache id of
+  //! args. Returns std::nullopt if args must be run eagerly instead.
+  std::optional<std::vector<at::Tensor>> runWithCudaGraph(
+      const KernelArgumentHolder& args);
+
+  //! Runs the segments on a side stream while capturing them into a graph
+  std::unique_ptr<CudaGraphEntry> captureCudaGraph(
+      const KernelArgumentHolder& args);
+
+  //! Returns true if the segments can run as the stages of a Megakernel.
+  //! Segments must all be CUDA kernels that can be stages, and run on a
+  //! single stream without profiling.
+  bool canUseMegakernel();
+
+  //! Collects the kernel launches of the segments and launches them as a
+  //! Megakernel, or one after the other if their launch parameters can't be
+  //! combined
+  std::vector<at::Tensor> runWithMegakernel(
+      KernelArgumentHolder& args,
+      const std::vector<at::Tensor>& outputs);
+
+  //! Stream assignment of a segment for concurrent execution
+  struct SegmentStreamInfo {
+    //! Index of the stream in the pool. 0 is the current stream.
+    int64_t stream = 0;
+    //! Run order ids of producers on other streams to wait for
+    std::vector<int64_t> producers_on_other_streams;
+    //! Inputs produced on other streams
+    std::vector<Val*> inputs_from_other_streams;
+    //! Whether an event is recorded after the segment is launched
+    bool record_event = false;
+  };
+
+  //! Returns the number of streams to run segments on, or 1 if segments run
+  //! in order on the current stream
+  int64_t numSegmentStreams() const;
+
+  //! Assigns segments to num_streams streams. A segment continues the stream
+  //! of its first producer that has not handed its stream to another
+  //! consumer yet. Otherwise, it starts on the next stream in round-robin
+  //! order, so independent branches of the segment DAG run concurrently.
+  void assignSegmentStreams(int64_t num_streams);
+
+  //! Placement of a segment output. Tensors with a negative offset are
+  //! allocated separately.
+  struct ArenaTensor {
+    std::vector<int64_t> sizes;
+    std::vector<int64_t> strides;
+    at::ScalarType dtype = at::ScalarType::Undefined;
+    int64_t num_bytes = 0;
+    int64_t offset = -1;
+  };
+
+  //! Placement of the segment outputs of one input cache id
+  struct ArenaEntry {
+    //! Outputs of each segment indexed by run order id. Segments without an
+    //! output in the arena have no outputs here and allocate their own.
+    std::vector<std::vector<ArenaTensor>> segment_outputs;
+    int64_t arena_bytes = 0;
+  };
+
+  //! Returns true if the intermediates of args can be placed in the arena.
+  //! The arena is not used during CUDA graph capture, which allocates from
+  //! the private memory pool of the graph instead.
+  bool canUseIntermediateArena(const KernelArgumentHolder& args) const;
+
+  //! Returns the intermediates that may be placed in the arena, mapped to
+  //! the run order id of their last consumer. Both their producer and their
+  //! consumers must be CUDA kernels whose outputs are all newly allocated,
+  //! so that no fusion output can alias the arena.
+  const std::unordered_map<Val*, int64_t>& arenaIntermediates();
+
+  //! Plans the arena given the outputs of a run of all segments
+  std::unique_ptr<ArenaEntry> planIntermediateArena(
+      std::vector<std::vector<ArenaTensor>> segment_outputs);
+
+  //! Allocates the outputs of a segment, slicing planned intermediates out of
+  //! the arena
+  std::vector<at::Tensor> allocateSegmentOutputs(
+      const std::vector<ArenaTensor>& outputs,
+      c10::DeviceIndex device_index);
+
+  //! A segment that only concatenates intermediates produced by earlier
+  //! kernels. With NVFUSER_ENABLE=zero_copy_cat, its output is allocated
+  //! before the producers run, the producers write their outputs directly
+  //! into the slices of it, and the segment itself is skipped.
+  struct ZeroCopyCat {
+    SegmentedGroup* group = nullptr;
+    TensorView* out = nullptr;
+    int64_t axis = 0;
+    //! Pads of the inputs of the concatenation, in order
+    std::vector<PadOp*> pads;
+  };
+
+  //! Returns the segments that may be run as a zero-copy concatenation. The
+  //! segment must consist of a CatOp and the PadOps of its inputs, and each
+  //! input must be a dense intermediate used only by the concatenation and
+  //! produced by a CUDA kernel whose outputs are all newly allocated.
+  const std::vector<ZeroCopyCat>& zeroCopyCats();
+
+  //! Allocates the outputs of the zero-copy concatenations of args and adds
+  //! the slices of them to given_outputs, keyed by the inputs of the
+  //! concatenations. Returns the allocated outputs by segment. A
+  //! concatenation whose extents can't be evaluated from the fusion inputs,
+  //! or whose slices wouldn't be dense and aligned, is run as usual.
+  std::unordered_map<SegmentedGroup*, at::Tensor> allocateZeroCopyCats(
+      const KernelArgumentHolder& args,
+      std::unordered_map<Val*, at::Tensor>& given_outputs);
+
   //! Runs each fusion segment given arguments. The outputs for a fusion are
   //! added back to the arguments, so they can be used as inputs to successive
   //! segments. Returns a map that links each NvFuser Val to its corresponding
   //! tensor.
+  //!
+  //! With NVFUSER_ENABLE=intermediate_arena, the first run of a cache id
+  //! records the intermediates passed between segments. Later runs place them
+  //! in a single arena by their live ranges over the run order, so that
+  //! intermediates whose last consumer has launched share memory with
+  //! intermediates produced afterwards.
+  //!
+  //! See runWithInputs for `outputs`.
   std::unordered_map<Val*, const PolymorphicValue*> runSegmentsWithInputs(
-      KernelArgumentHolder& args);
+      KernelArgumentHolder& args,
+      const std::vector<at::Tensor>& outputs = {});
 
   //! Interface to run a single kernel, either one kernel for single-kernel
   //! fusions, or a kernel for a segmentedGrouup in a segmented fusion. Returns
   //! the kernel outputs.
   std::vector<at::Tensor> runKernelWithInput(
       KernelArgumentHolder& args,
-      SegmentedGroup* sg);
+      SegmentedGroup* sg,
+      std::vector<at::Tensor> outputs = {});
+
+  //! Records a run of the kernel of sg to KernelPerfDb::get(). inputs is the
+  //! signature of the segment inputs.
+  void recordKernelPerf(
+      SegmentedGroup* sg,
+      ExecutorAbstract* ea,
+      HeuristicParams* heuristic_params,
+      const std::string& inputs,
+      double time_ms);
+
+  //! Returns copies of heuristics_ if the validity region of every segment
+  //! contains args, and nullptr otherwise
+  std::unique_ptr<HeuristicParamsList> getHeuristicsInValidityRegions(
+      const KernelArgumentHolder& args,
+      std::optional<PrimDataType> forced_index_type) const;
 
   //! Interface to compile a single kernel. It is either a single kernel for a
   //! fusion or a kernel for a segmentedGrouup in a segmented fusion. Returns
   //! launch and compile parameters for kernel.
   void compileKernel(const KernelArgumentHolder& args, SegmentedGroup* sg);
 
+  //! Returns true if the kernel of sg can be autotuned with args. Only
+  //! unsegmented fusions are tuned, since the inputs of later segments are
+  //! not materialized at compile time. Fusions that update their inputs in
+  //! place or use random numbers are not tuned, since they are run several
+  //! times.
+  bool canAutotune(const KernelArgumentHolder& args, SegmentedGroup* sg) const;
+
+  //! With NVFUSER_ENABLE=autotune, compiles the kernel of sg for each variant
+  //! of its heuristics, times it on args with CudaEventTimer and keeps the
+  //! fastest kernel and its heuristics. Variants that fail to compile or run
+  //! are skipped.
+  void autotuneKernel(const KernelArgumentHolder& args, SegmentedGroup* sg);
+
+  //! Returns true if the register pressure of the kernel of sg can be
+  //! limited, i.e. NVFUSER_ENABLE=limit_register_pressure is set and its
+  //! heuristics have unroll factors to shrink.
+  bool canLimitRegisterPressure(SegmentedGroup* sg) const;
+
+  //! Compiles the kernel of sg with the first variant of
+  //! registerPressureVariants whose lowered kernel is estimated to fit in
+  //! maxrregcount registers and which spills no more than the allowed number
+  //! of bytes. Falls back to the variant with the fewest spills.
+  void limitRegisterPressure(
+      const KernelArgumentHolder& args,
+      SegmentedGroup* sg);
+
   std::pair<LaunchParams, CompileParams> getKernelConfig(
       const KernelArgumentHolder& args,
       SegmentedGroup* sg);
@@ -173,6 +506,13 @@ class FusionKernelRuntime {
   NVF_API const std::vector<std::unique_ptr<HeuristicParams>>& schedulers()
       const;
 
+  //! Returns the executor of the 64-bit indexing variant of the kernel of
+  //! sg, compiling it on first use. Executors that do not generate a kernel
+  //! are returned as is. The caller must hold mutex_.
+  ExecutorAbstract* getInt64Executor(
+      const KernelArgumentHolder& args,
+      SegmentedGroup* sg);
+
  private:
   //! Entries indexed by groupID:
   //! Executors holding compiled kernels
@@ -186,6 +526,19 @@ class FusionKernelRuntime {
   //! Heuristics object holding scheduler entries for all segments
   std::unique_ptr<HeuristicParamsList> heuristics_;
 
+  //! Autotuned variant of each entry of heuristics_. It is reapplied to
+  //! recomputed heuristics, so that they match heuristics_ for new inputs and
+  //! after deserialization.
+  std::vector<AutotuneVariant> autotune_variants_;
+
+  //! Set by presetAutotuneVariants
+  bool autotune_variants_preset_ = false;
+
+  //! If false, the fusion is segmented as with NVFUSER_ENABLE=fuse_matmul and
+  //! NVFUSER_DISABLE=matmul_expr_eval. Set by FusionExecutorCache when it
+  //! selects the faster backend for matmuls.
+  bool matmul_expr_eval_ = true;
+
   // Checks if this runtime instance is for a single-kernel fusion (false) or a
   //  segmented fusion (true).
   bool is_segmented_ = true;
@@ -198,7 +551,7 @@ class FusionKernelRuntime {
 
   //! store number of arguments in KernelArgumentHolder after each segment
   //! used to check if arguments are erased if not being used in the following
-  //! segments
+  //! segments. Recorded by compileFusion under mutex_, runs don't update it.
   //! Only used in a single test: test_gpu3::FusionClearGmemBetweenSegments_CUDA
   std::vector<int64_t> num_live_args_after_segment_runs_;
 
@@ -213,10 +566,30 @@ class FusionKernelRuntime {
   //! The sum of the last kernel execution times
   float kernel_time_ms_ = 0;
 
+  //! Stable hash of the complete fusion keying the records of a
+  //! KernelPerfDb. Computed on the first recorded run, guarded by mutex_.
+  std::optional<uint64_t> perf_db_fusion_hash_;
+
   //! something to do with parallel compilation, not sure what it's actually
   //! being used to protect.
   mutable std::mutex mutex_;
 
+  //! Serializes runs that use state kept in this runtime, i.e. CUDA graphs,
+  //! segment streams and the intermediate arena, and their eviction
+  std::mutex run_mutex_;
+
+  //! Launch params set by updateHeuristicsLaunchParams, indexed by input
+  //! cache id and then by group id. Guarded by mutex_.
+  std::unordered_map<size_t, std::vector<LaunchParams>>
+      cache_id_launch_params_;
+
+  //! Entries indexed by groupID: 64-bit indexing variants of executors_,
+  //! compiled by getInt64Executor. Guarded by mutex_.
+  std::vector<std::unique_ptr<ExecutorAbstract>> int64_executors_;
+
+  //! Cache ids of the inputs run with int64_executors_. Guarded by mutex_.
+  std::unordered_set<size_t> int64_cache_ids_;
+
   // ID of fusion in python frontend fusion cache, which maps to a single
   // FusionExecutorCache.
   int64_t fusion_id_ = -1;
@@ -232,6 +605,82 @@ class FusionKernelRuntime {
 
   // Whether to auto schedule the Fusion. If set to false, scheduling is skipped
   const bool auto_schedule_;
+
+  //! See lastUsed
+  std::atomic<uint64_t> last_used_ = 0;
+  static std::atomic<uint64_t> global_use_count_;
+
+  //! Set while a compileFusionAsync task is in flight
+  std::atomic<bool> is_compiling_ = false;
+
+  //! Set if the most recent compileFusionAsync task threw
+  std::atomic<bool> async_compile_failed_ = false;
+
+  //! Holds the most recent compileFusionAsync task. Guarded by
+  //! async_compile_mutex_.
+  std::shared_ptr<CompileTaskGroup> async_compile_tasks_;
+  mutable std::mutex async_compile_mutex_;
+
+  //! Unsegmented copy of the fusion evaluated by runWithExprEval. It is
+  //! cloned before compilation starts so that running the fallback never
+  //! traverses IR that the compilation task is reading concurrently.
+  std::unique_ptr<Fusion> expr_eval_fusion_;
+  std::once_flag expr_eval_fusion_flag_;
+
+  //! Set once runWithExprEval fails, so that later calls skip the attempt
+  std::atomic<bool> expr_eval_unsupported_ = false;
+
+  //! Whether the segments of this runtime can be captured in a CUDA graph,
+  //! computed on first use
+  std::optional<bool> cuda_graph_supported_ = std::nullopt;
+
+  //! Whether the segments of this runtime can be the stages of a megakernel,
+  //! computed on first use
+  std::optional<bool> megakernel_supported_ = std::nullopt;
+
+  //! Generated on the first run with EnableOption::Megakernel
+  std::unique_ptr<Megakernel> megakernel_;
+
+  //! Cache ids that have been run eagerly once. A graph is captured on the
+  //! second run so that one-time host work, like raising the shared memory
+  //! limit of a kernel, happens outside of capture.
+  std::unordered_set<size_t> cuda_graph_warmed_up_;
+
+  //! CUDA graphs indexed by input cache id
+  std::unordered_map<size_t, std::unique_ptr<CudaGraphEntry>> cuda_graphs_;
+
+  //! Number of streams segment_streams_ was computed for
+  int64_t num_segment_streams_ = 1;
+
+  //! Stream assignment indexed by run order id
+  std::vector<SegmentStreamInfo> segment_streams_;
+
+  //! Run order id of the last segment on each stream, or -1
+  std::vector<int64_t> last_segment_on_stream_;
+
+  //! Events recorded after segments, indexed by run order id, and the event
+  //! that side streams wait for before their first segment. They are reused
+  //! across runs.
+  std::vector<at::cuda::CUDAEvent> segment_events_;
+  at::cuda::CUDAEvent segment_fork_event_;
+
+  //! Intermediates that may be placed in the arena, computed on first use
+  std::optional<std::unordered_map<Val*, int64_t>> arena_intermediates_ =
+      std::nullopt;
+
+  //! Segments that may be run as a zero-copy concatenation, computed on first
+  //! use
+  std::optional<std::vector<ZeroCopyCat>> zero_copy_cats_ = std::nullopt;
+
+  //! Arena plans indexed by input cache id
+  std::unordered_map<size_t, std::unique_ptr<ArenaEntry>> arena_entries_;
+
+  //! Byte buffer shared by the arena plans of all cache ids, and the stream
+  //! it was last used on. A run on another stream allocates a new buffer.
+  //! Dropping the old one is safe since the caching allocator only hands it
+  //! out again on its stream, after the work already enqueued there.
+  at::Tensor intermediate_arena_;
+  std::optional<c10::cuda::CUDAStream> arena_stream_ = std::nullopt;
 };
 
 } // namespace nvfuser
@@ -0,0 +1,273 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <runtime/megakernel.h>
+
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/ops/zeros.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <c10/util/irange.h>
+
+#include <algorithm>
+#include <array>
+#include <sstream>
+
+#include <codegen.h>
+#include <device_lower/utils.h>
+#include <driver_api.h>
+#include <exceptions.h>
+#include <instrumentation.h>
+
+namespace nvfuser {
+
+namespace {
+
+// Kernel parameters are limited to 4KB
+constexpr int64_t kMaxParamBytes = 4096;
+
+} // namespace
+
+Megakernel::Megakernel(
+    std::vector<const KernelExecutor*> stages,
+    std::string kernel_name)
+    : stages_(std::move(stages)), kernel_name_(std::move(kernel_name)) {
+  FUSER_PERF_SCOPE("Megakernel::Megakernel");
+  NVF_ERROR(!stages_.empty(), "A megakernel needs at least one stage");
+  index_type_ = stages_.front()->kernel()->indexType();
+
+  std::vector<std::string> stage_names;
+  std::vector<std::vector<std::string>> param_types;
+  std::stringstream ss;
+  for (const KernelExecutor* executor : stages_) {
+    NVF_ERROR(
+        supports(*executor),
+        "The kernel of ",
+        executor->kernelName(),
+        " can't be a stage of a megakernel");
+    const kir::Kernel* kernel = executor->kernel();
+    NVF_ERROR(
+        kernel->indexType() == index_type_,
+        "The stages of a megakernel must use the same index type");
+    codegen::KernelStage stage =
+        codegen::generateCudaKernelStage(kernel, executor->kernelName());
+    const auto& summary = kernel->summary();
+    uses_grid_dims_.push_back(
+        summary.has_grid_reductions || summary.has_grid_broadcasts ||
+        summary.has_grid_welford || summary.has_cooperative_grid_reduction ||
+        stage.definition.find("gridDim") != std::string::npos);
+    ss << stage.definition << "\n";
+    stage_names.push_back(executor->kernelName());
+    param_types.push_back(std::move(stage.param_types));
+  }
+
+  ss << "__global__ void " << kernel_name_ << "(";
+  for (const auto i : c10::irange(stages_.size())) {
+    for (const auto j : c10::irange(param_types[i].size())) {
+      ss << param_types[i][j] << " p" << i << "_" << j << ", ";
+    }
+  }
+  for (const auto i : c10::irange(stages_.size())) {
+    ss << "uint3 grid" << i << ", ";
+  }
+  ss << "int64_t* megakernel_semaphore) {\n";
+  for (const auto i : c10::irange(stages_.size())) {
+    if (i > 0) {
+      // Every block reaches the synchronization, including the ones that
+      // skipped the previous stage
+      ss << "  grid_sync::resettingSync<true, true, true, true>("
+         << "megakernel_semaphore[0], "
+         << "(uint64_t)gridDim.x * gridDim.y * gridDim.z, "
+         << "DefaultBlockDim());\n";
+    }
+    ss << "  if (blockIdx.x < grid" << i << ".x && blockIdx.y < grid" << i
+       << ".y && blockIdx.z < grid" << i << ".z) {\n";
+    ss << "    " << stage_names[i] << "(";
+    for (const auto j : c10::irange(param_types[i].size())) {
+      ss << (j > 0 ? ", " : "") << "p" << i << "_" << j;
+    }
+    ss << ");\n";
+    ss << "  }\n";
+  }
+  ss << "}\n";
+  code_ = ss.str();
+}
+
+bool Megakernel::supports(const KernelExecutor& executor) {
+  if (!executor.hasCompiledKernel()) {
+    return false;
+  }
+  const kir::Kernel* kernel = executor.kernel();
+  if (kernel->topLevelExprs().empty()) {
+    return false;
+  }
+  // Clusters and register sharing are attributes of the launch, and TMA
+  // descriptors, as well as the warp specialization they enable, can only be
+  // kernel parameters
+  if (kernel->hasManaged("cluster_dims") ||
+      kernel->hasManaged("enable_register_sharing")) {
+    return false;
+  }
+  std::vector<Expr*> exprs = kernel->as<Fusion>()->exprs();
+  return std::none_of(exprs.begin(), exprs.end(), [](Expr* expr) {
+    return ir_utils::isCpAsyncBulk(expr);
+  });
+}
+
+bool Megakernel::fitsOnDevice(
+    int64_t num_blocks,
+    int64_t num_threads,
+    int64_t smem) {
+  auto& blocks_per_sm = blocks_per_sm_[num_threads];
+  auto it = blocks_per_sm.find(smem);
+  if (it == blocks_per_sm.end()) {
+    int num_blocks_per_sm = 0;
+    NVFUSER_CUDA_SAFE_CALL(cuOccupancyMaxActiveBlocksPerMultiprocessor(
+        &num_blocks_per_sm,
+        compiled_kernel_->getFunction(),
+        (int)num_threads,
+        (size_t)smem));
+    it = blocks_per_sm.emplace(smem, num_blocks_per_sm).first;
+  }
+  const int64_t num_sms =
+      at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+  return it->second * num_sms >= num_blocks;
+}
+
+bool Megakernel::launch(
+    const std::vector<KernelLaunchCollector::Launch>& launches,
+    CUstream stream) {
+  FUSER_PERF_SCOPE("Megakernel::launch");
+  if (launches.size() != stages_.size()) {
+    return false;
+  }
+  const LaunchParams& first_params = launches.front().launch_params;
+  std::array<int64_t, 3> grid = {1, 1, 1};
+  int64_t smem = 0;
+  int64_t param_bytes = 0;
+  for (const auto i : c10::irange(launches.size())) {
+    const KernelLaunchCollector::Launch& launch = launches[i];
+    const LaunchParams& params = launch.launch_params;
+    if (launch.executor != stages_[i] ||
+        params.bdimx() != first_params.bdimx() ||
+        params.bdimy() != first_params.bdimy() ||
+        params.bdimz() != first_params.bdimz()) {
+      return false;
+    }
+    grid = {
+        std::max(grid[0], params.gdimx()),
+        std::max(grid[1], params.gdimy()),
+        std::max(grid[2], params.gdimz())};
+    smem = std::max(smem, params.smem());
+    for (const auto& arg : launch.args) {
+      param_bytes += roundUpToMultiple((int64_t)arg.size(), 8);
+    }
+  }
+  for (const auto i : c10::irange(launches.size())) {
+    const LaunchParams& params = launches[i].launch_params;
+    if (uses_grid_dims_[i] &&
+        (params.gdimx() != grid[0] || params.gdimy() != grid[1] ||
+         params.gdimz() != grid[2])) {
+      return false;
+    }
+  }
+  param_bytes += (int64_t)launches.size() * 12 + 8;
+  if (param_bytes > kMaxParamBytes) {
+    return false;
+  }
+
+  // Every stage has at least one output tensor, which is on the device of
+  // the kernels
+  c10::Device device = c10::Device(c10::DeviceType::CUDA, 0);
+  for (const auto& launch : launches) {
+    if (!launch.tensors.empty()) {
+      device = launch.tensors.back().device();
+      break;
+    }
+  }
+  c10::cuda::CUDAGuard device_guard(device);
+
+  const int64_t num_threads = first_params.nThreads();
+  if (compiled_kernel_ == nullptr) {
+    CompileParams compile_params;
+    compile_params.index_type = index_type_;
+    compiled_kernel_ = executor_utils::getCompiledKernel(
+        std::nullopt,
+        stages_.front()->getStructuredCode(code_, index_type_),
+        kernel_name_,
+        kernel_name_,
+        compile_params,
+        num_threads);
+    compiled_block_size_ = num_threads;
+  } else if (num_threads > compiled_block_size_) {
+    // The launch bounds of the megakernel don't allow more threads
+    return false;
+  }
+
+  if (smem > available_dynamic_smem_size_) {
+    int static_smem = 0;
+    NVFUSER_CUDA_SAFE_CALL(cuFuncGetAttribute(
+        &static_smem,
+        CU_FUNC_ATTRIBUTE_SHARED_SIZE_BYTES,
+        compiled_kernel_->getFunction()));
+    if (static_smem + smem >
+        (int64_t)at::cuda::getCurrentDeviceProperties()
+            ->sharedMemPerBlockOptin) {
+      return false;
+    }
+    NVFUSER_CUDA_SAFE_CALL(cuFuncSetAttribute(
+        compiled_kernel_->getFunction(),
+        CU_FUNC_ATTRIBUTE_MAX_DYNAMIC_SHARED_SIZE_BYTES,
+        (int)smem));
+    available_dynamic_smem_size_ = smem;
+  }
+  // All the blocks wait for each other between the stages
+  if (!fitsOnDevice(grid[0] * grid[1] * grid[2], num_threads, smem)) {
+    return false;
+  }
+
+  at::Tensor& semaphore = semaphores_[stream];
+  if (!semaphore.defined()) {
+    semaphore =
+        at::zeros({1}, at::TensorOptions().dtype(at::kLong).device(device));
+  }
+  void* semaphore_ptr = semaphore.data_ptr();
+
+  std::vector<std::array<uint32_t, 3>> grids;
+  grids.reserve(launches.size());
+  std::vector<void*> arg_ptrs;
+  for (const auto& launch : launches) {
+    for (const auto& arg : launch.args) {
+      // The kernel only reads its arguments
+      arg_ptrs.push_back(const_cast<std::byte*>(arg.data()));
+    }
+    const LaunchParams& params = launch.launch_params;
+    grids.push_back(
+        {(uint32_t)params.gdimx(),
+         (uint32_t)params.gdimy(),
+         (uint32_t)params.gdimz()});
+  }
+  for (auto& stage_grid : grids) {
+    arg_ptrs.push_back(stage_grid.data());
+  }
+  arg_ptrs.push_back(&semaphore_ptr);
+
+  NVFUSER_CUDA_SAFE_CALL(cuLaunchCooperativeKernel(
+      compiled_kernel_->getFunction(),
+      (unsigned int)grid[0],
+      (unsigned int)grid[1],
+      (unsigned int)grid[2],
+      (unsigned int)first_params.bdimx(),
+      (unsigned int)first_params.bdimy(),
+      (unsigned int)first_params.bdimz(),
+      (unsigned int)smem,
+      stream,
+      arg_ptrs.data()));
+  num_launches_++;
+  return true;
+}
+
+} // namespace nvfuser
@@ -0,0 +1,99 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <ATen/core/Tensor.h>
+#include <cuda.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <runtime/executor.h>
+#include <runtime/executor_utils.h>
+#include <utils.h>
+#include <visibility.h>
+
+namespace nvfuser {
+
+//! Runs the kernels of consecutive segments, e.g., the norm, projections and
+//! activation of a decode step, as the stages of a single persistent kernel.
+//! Each stage is the code of a kernel generated as a device function, see
+//! codegen::generateCudaKernelStage, and the stages are separated by a grid
+//! synchronization, so that a stage reads what the previous ones wrote
+//! without returning to the host. This saves the launch overhead and the
+//! ramp-down and ramp-up of each kernel, which dominate decode steps with
+//! small problem sizes.
+//!
+//! The megakernel is launched cooperatively with the largest grid of the
+//! stages. Blocks outside the grid of a stage skip it, so a stage can only
+//! have a smaller grid if its code doesn't read gridDim, e.g., for a grid
+//! reduction. All the stages have to use the same block size.
+class Megakernel : public NonCopyable {
+ public:
+  //! Generates the megakernel calling the kernels of stages in order. Throws
+  //! if a kernel can't be a stage. It is compiled by the first launch, for
+  //! its block size.
+  NVF_API Megakernel(
+      std::vector<const KernelExecutor*> stages,
+      std::string kernel_name);
+
+  //! Whether the compiled kernel of executor can be a stage
+  NVF_API static bool supports(const KernelExecutor& executor);
+
+  //! Launches the collected kernels of the stages as a single kernel on
+  //! stream. Returns false without launching anything if they are not the
+  //! stages, or if their launch parameters can't be combined, e.g., because
+  //! the block sizes differ or all the blocks can't be resident at once.
+  //! Throws if the megakernel fails to compile.
+  NVF_API bool launch(
+      const std::vector<KernelLaunchCollector::Launch>& launches,
+      CUstream stream);
+
+  //! Number of times the megakernel was launched
+  int64_t numLaunches() const {
+    return num_launches_;
+  }
+
+  const std::string& kernelName() const {
+    return kernel_name_;
+  }
+
+ private:
+  //! Whether the number of blocks can be resident at once with the given
+  //! block size and dynamic shared memory
+  bool fitsOnDevice(int64_t num_blocks, int64_t num_threads, int64_t smem);
+
+  const std::vector<const KernelExecutor*> stages_;
+  const std::string kernel_name_;
+  //! Whether the code of each stage reads gridDim, in which case it has to
+  //! run with the grid of the megakernel
+  std::vector<bool> uses_grid_dims_;
+  //! The code of the megakernel, including the stages
+  std::string code_;
+  PrimDataType index_type_ = PrimDataType::Int;
+  std::unique_ptr<executor_utils::CompiledKernel> compiled_kernel_;
+  //! The block size the megakernel is compiled for, which bounds the block
+  //! size of later launches
+  int64_t compiled_block_size_ = 0;
+  int64_t available_dynamic_smem_size_ = 0;
+  //! Maximum number of resident blocks per SM, keyed on the block size and
+  //! the dynamic shared memory
+  std::unordered_map<int64_t, std::unordered_map<int64_t, int64_t>>
+      blocks_per_sm_;
+  //! The semaphore of the grid synchronizations between the stages. It is
+  //! zero after every launch, and launches on the same stream never overlap,
+  //! so each stream reuses its own.
+  std::unordered_map<CUstream, at::Tensor> semaphores_;
+  int64_t num_launches_ = 0;
+};
+
+} // namespace nvfuser
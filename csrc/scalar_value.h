@@ -0,0 +1,138 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <exceptions.h>
+#include <polymorphic_value.h>
+
+#include <cstdint>
+#include <type_traits>
+
+namespace nvfuser {
+
+//! A trivially copyable value that holds nothing, an int64_t, a double, or a
+//! bool, i.e., the scalars that dominate argument binding, expression
+//! evaluation, and allocation inference.
+//!
+//! Copying or comparing a PolymorphicValue dispatches on all the types it can
+//! hold, some of which are refcounted. ScalarValue is an 8-byte payload and a
+//! tag instead, so it can be passed and stored by value on hot paths. It is a
+//! view of what a PolymorphicValue holds, not a replacement: values of other
+//! types convert to an empty ScalarValue.
+class ScalarValue {
+ public:
+  enum class Kind : uint8_t { Null, Int, Double, Bool };
+
+  ScalarValue() = default;
+  template <
+      typename T,
+      typename = std::enable_if_t<
+          std::is_integral_v<T> && !std::is_same_v<T, bool>>>
+  ScalarValue(T value) : kind_(Kind::Int), int_((int64_t)value) {}
+  ScalarValue(double value) : kind_(Kind::Double), double_(value) {}
+  ScalarValue(bool value) : kind_(Kind::Bool), bool_(value) {}
+
+  //! Returns an empty ScalarValue if value does not hold a scalar of the
+  //! supported types.
+  static ScalarValue fromPolymorphicValue(const PolymorphicValue& value) {
+    if (value.is<int64_t>()) {
+      return ScalarValue(value.as<int64_t>());
+    }
+    if (value.is<double>()) {
+      return ScalarValue(value.as<double>());
+    }
+    if (value.is<bool>()) {
+      return ScalarValue(value.as<bool>());
+    }
+    return ScalarValue();
+  }
+
+  PolymorphicValue toPolymorphicValue() const {
+    switch (kind_) {
+      case Kind::Int:
+        return PolymorphicValue(int_);
+      case Kind::Double:
+        return PolymorphicValue(double_);
+      case Kind::Bool:
+        return PolymorphicValue(bool_);
+      case Kind::Null:
+        break;
+    }
+    return PolymorphicValue();
+  }
+
+  Kind kind() const {
+    return kind_;
+  }
+
+  bool hasValue() const {
+    return kind_ != Kind::Null;
+  }
+
+  template <typename T>
+  bool is() const {
+    if constexpr (std::is_same_v<T, int64_t>) {
+      return kind_ == Kind::Int;
+    } else if constexpr (std::is_same_v<T, double>) {
+      return kind_ == Kind::Double;
+    } else if constexpr (std::is_same_v<T, bool>) {
+      return kind_ == Kind::Bool;
+    } else {
+      return false;
+    }
+  }
+
+  template <typename T>
+  T as() const {
+    NVF_ERROR(is<T>(), "ScalarValue does not hold the requested type");
+    if constexpr (std::is_same_v<T, int64_t>) {
+      return int_;
+    } else if constexpr (std::is_same_v<T, double>) {
+      return double_;
+    } else {
+      static_assert(std::is_same_v<T, bool>, "Unsupported scalar type");
+      return bool_;
+    }
+  }
+
+  //! Values of different kinds are never equal, like in isSame. Unlike
+  //! isSame, NaNs are not equal to each other.
+  bool operator==(const ScalarValue& other) const {
+    if (kind_ != other.kind_) {
+      return false;
+    }
+    switch (kind_) {
+      case Kind::Int:
+        return int_ == other.int_;
+      case Kind::Double:
+        return double_ == other.double_;
+      case Kind::Bool:
+        return bool_ == other.bool_;
+      case Kind::Null:
+        break;
+    }
+    return true;
+  }
+
+  bool operator!=(const ScalarValue& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  Kind kind_ = Kind::Null;
+  union {
+    int64_t int_ = 0;
+    double double_;
+    bool bool_;
+  };
+};
+
+static_assert(std::is_trivially_copyable_v<ScalarValue>);
+static_assert(sizeof(ScalarValue) == 16);
+
+} // namespace nvfuser
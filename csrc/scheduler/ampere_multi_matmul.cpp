@@ -987,11 +987,23 @@ void AmpereMultipleMatmulScheduler::schedulePrologues() {
   // expression, which we typically refer to as "ab". There is some special
   // handling of acr but otherwise we schedule ab and propagate backward
   // along this prologue region.
+  //
+  // Fusion inputs with the PROLOGUE_INPUT role, like the per-row statistics
+  // of a normalization applied to operand A, are loaded from global memory
+  // in that region, so they bound the propagation as well.
   auto schedulePrologueBranch = [&](const std::vector<TensorView*>& smem_stores,
                                     const std::vector<TensorView*>& smem_loads,
+                                    const std::vector<TensorView*>&
+                                        prologue_inputs,
                                     std::vector<TensorView*>& mma_inputs,
                                     MmaOperand operand_type) {
     NVF_ERROR(smem_stores.size() == smem_loads.size());
+    std::vector<TensorView*> store_boundary = smem_stores;
+    store_boundary.insert(
+        store_boundary.end(), prologue_inputs.begin(), prologue_inputs.end());
+    std::vector<TensorView*> load_boundary = smem_loads;
+    load_boundary.insert(
+        load_boundary.end(), prologue_inputs.begin(), prologue_inputs.end());
     // We will save abs_ and bbs_ here for later use
     // TODO: save all register prologue tensors instead to a new vector called
     // prologue_register_tensors_
@@ -1021,7 +1033,7 @@ void AmpereMultipleMatmulScheduler::schedulePrologues() {
       scheduler_utils::BoundedDirectionalTransformPropagator::backward(
           mma_input,
           -1,
-          smem_stores,
+          store_boundary,
           scheduler_utils::BoundedDirectionalTransformPropagator::Options()
               .propagateParallelType());
     }
@@ -1049,14 +1061,20 @@ void AmpereMultipleMatmulScheduler::schedulePrologues() {
         scheduler_utils::BoundedDirectionalTransformPropagator::backward(
             mma_input,
             -1,
-            smem_loads,
+            load_boundary,
             scheduler_utils::BoundedDirectionalTransformPropagator::Options()
                 .propagateParallelType());
       }
     }
   };
-  schedulePrologueBranch(acw_smems_, acrs_, abs_, MmaOperand::A);
-  schedulePrologueBranch(bcw_smems_, bcrs_, bbs_, MmaOperand::B);
+  std::vector<TensorView*> prologue_inputs;
+  if (auto it = tensor_roles_.find(MatmulTensorRole::PROLOGUE_INPUT);
+      it != tensor_roles_.end()) {
+    prologue_inputs = it->second;
+  }
+  schedulePrologueBranch(
+      acw_smems_, acrs_, prologue_inputs, abs_, MmaOperand::A);
+  schedulePrologueBranch(bcw_smems_, bcrs_, {}, bbs_, MmaOperand::B);
 }
 
 void AmpereMultipleMatmulScheduler::scheduleOutputTensor(TensorView* c) {
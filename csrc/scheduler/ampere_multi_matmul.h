@@ -71,9 +71,10 @@ class AmpereMultipleMatmulScheduler : public MultipleMatmulScheduler {
       : MultipleMatmulScheduler(fusion, params) {
     const auto device_prop = at::cuda::getCurrentDeviceProperties();
     const int cc = device_prop->major * 10 + device_prop->minor;
+    // Blackwell also supports the mma.sync macros of Ampere
     NVF_ERROR(
-        cc >= 75 && cc < 90,
-        "This matmul scheduler is restricted to Ampere and Turing.");
+        (cc >= 75 && cc < 90) || (cc >= 100 && isAmpere(params->mma_macro)),
+        "This matmul scheduler is restricted to Ampere and Turing macros.");
   }
 
   void run() final;
@@ -0,0 +1,249 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <scheduler/autotune.h>
+
+#include <scheduler/pointwise_heuristic.h>
+#include <scheduler/reduction_heuristic.h>
+
+#include <c10/util/irange.h>
+
+#include <algorithm>
+#include <optional>
+#include <sstream>
+
+namespace nvfuser {
+
+namespace {
+
+//! Largest unroll factor the autotuner proposes
+constexpr int64_t kMaxAutotuneUnrollFactor = 16;
+
+//! The factor of params that a knob scales, and the range it may be scaled in
+struct KnobFactor {
+  int64_t* factor = nullptr;
+  //! Vectorized reductions keep a factor of at least 2, so that the
+  //! vectorize flags stay consistent with their factors
+  int64_t min_factor = 1;
+  int64_t max_factor = 1;
+};
+
+std::optional<KnobFactor> getKnobFactor(
+    HeuristicParams* params,
+    AutotuneKnob knob) {
+  if (params->scheduler_type == SchedulerType::PointWise) {
+    auto pparams = params->as<PointwiseParams>();
+    // The TMA schedule neither vectorizes nor unrolls
+    if (pparams->use_tma_load) {
+      return std::nullopt;
+    }
+    switch (knob) {
+      case AutotuneKnob::Vectorize:
+        return KnobFactor{
+            &pparams->vectorization_factor,
+            1,
+            pparams->vectorization_factor};
+      case AutotuneKnob::InnerUnroll:
+        return KnobFactor{
+            &pparams->unroll_factor_inner, 1, kMaxAutotuneUnrollFactor};
+      case AutotuneKnob::OuterUnroll:
+        // The 1D schedule has no outer dimension
+        if (pparams->break_point == 0) {
+          return std::nullopt;
+        }
+        return KnobFactor{
+            &pparams->unroll_factor_outer, 1, kMaxAutotuneUnrollFactor};
+      default:
+        return std::nullopt;
+    }
+  }
+
+  if (params->scheduler_type != SchedulerType::Reduction &&
+      params->scheduler_type != SchedulerType::InnerPersistent) {
+    return std::nullopt;
+  }
+  auto rparams = params->as<ReductionParams>();
+  // The tiles of a transposed outer reduction fix the block shape
+  if (rparams->transposed_outer_reduction) {
+    return std::nullopt;
+  }
+  if (rparams->persistent_kernel) {
+    // The persistent buffer is split by the vectorization and unroll factors
+    // of the reduction domain, so only the iteration domain is tuned
+    if (knob != AutotuneKnob::OuterUnroll || rparams->vectorize_iter_dom ||
+        !rparams->multiple_reds_per_blk) {
+      return std::nullopt;
+    }
+    return KnobFactor{
+        &rparams->unroll_factor_iter_dom, 1, kMaxAutotuneUnrollFactor};
+  }
+  switch (knob) {
+    case AutotuneKnob::Vectorize:
+      if (rparams->vectorize_inner_reduction) {
+        return KnobFactor{
+            &rparams->unroll_factor_inner_reduction,
+            2,
+            rparams->unroll_factor_inner_reduction};
+      }
+      if (rparams->vectorize_iter_dom) {
+        return KnobFactor{
+            &rparams->unroll_factor_iter_dom,
+            2,
+            rparams->unroll_factor_iter_dom};
+      }
+      return std::nullopt;
+    case AutotuneKnob::InnerUnroll:
+      if (rparams->vectorize_inner_reduction) {
+        return KnobFactor{
+            &rparams->unroll_factor_top_of_vectorization,
+            1,
+            kMaxAutotuneUnrollFactor};
+      }
+      return KnobFactor{
+          &rparams->unroll_factor_inner_reduction,
+          1,
+          kMaxAutotuneUnrollFactor};
+    case AutotuneKnob::OuterUnroll:
+      // Unrolling the iteration domain requires one, which is only known to
+      // exist if the analytical heuristics already unroll it
+      if (rparams->vectorize_iter_dom ||
+          rparams->unroll_factor_iter_dom == 1) {
+        return std::nullopt;
+      }
+      return KnobFactor{
+          &rparams->unroll_factor_iter_dom, 1, kMaxAutotuneUnrollFactor};
+    default:
+      return std::nullopt;
+  }
+}
+
+//! Returns the scaled factor, or std::nullopt if it is out of range
+std::optional<int64_t> scaleFactor(
+    const KnobFactor& knob_factor,
+    int64_t log2_scale) {
+  const int64_t factor = *knob_factor.factor;
+  int64_t scaled = factor;
+  if (log2_scale > 0) {
+    scaled = factor << log2_scale;
+  } else if (log2_scale < 0) {
+    const int64_t divisor = (int64_t)1 << -log2_scale;
+    if (factor % divisor != 0) {
+      return std::nullopt;
+    }
+    scaled = factor / divisor;
+  }
+  if (scaled < knob_factor.min_factor || scaled > knob_factor.max_factor) {
+    return std::nullopt;
+  }
+  return scaled;
+}
+
+} // namespace
+
+bool AutotuneVariant::isDefault() const {
+  return std::all_of(
+      log2_scales.begin(), log2_scales.end(), [](int64_t log2_scale) {
+        return log2_scale == 0;
+      });
+}
+
+const char* toString(AutotuneKnob knob) {
+  static const std::array<const char*, kNumAutotuneKnobs> knob_names = {
+      "vectorize", "inner_unroll", "outer_unroll"};
+  return knob_names.at((size_t)knob);
+}
+
+std::string AutotuneVariant::toString() const {
+  std::stringstream ss;
+  ss << "AutotuneVariant{";
+  bool first = true;
+  for (auto knob : c10::irange(kNumAutotuneKnobs)) {
+    if (log2_scales.at(knob) == 0) {
+      continue;
+    }
+    ss << (first ? "" : ", ") << nvfuser::toString((AutotuneKnob)knob)
+       << ": x2^" << log2_scales.at(knob);
+    first = false;
+  }
+  ss << "}";
+  return ss.str();
+}
+
+std::vector<AutotuneVariant> autotuneVariants(const HeuristicParams* params) {
+  std::vector<AutotuneVariant> variants(1);
+  // getKnobFactor only hands out pointers into the params, which are not
+  // written here
+  auto mutable_params = const_cast<HeuristicParams*>(params);
+  for (auto knob : c10::irange(kNumAutotuneKnobs)) {
+    auto knob_factor = getKnobFactor(mutable_params, (AutotuneKnob)knob);
+    if (!knob_factor.has_value()) {
+      continue;
+    }
+    for (int64_t log2_scale : {-1, 1}) {
+      if (scaleFactor(knob_factor.value(), log2_scale).has_value()) {
+        AutotuneVariant variant;
+        variant.log2_scales.at(knob) = log2_scale;
+        variants.push_back(variant);
+      }
+    }
+  }
+  return variants;
+}
+
+std::vector<AutotuneVariant> registerPressureVariants(
+    const HeuristicParams* params) {
+  // Unroll factors are at most kMaxAutotuneUnrollFactor
+  constexpr int64_t kMaxLog2Shrink = 4;
+  const auto outer = (int64_t)AutotuneKnob::OuterUnroll;
+  const auto inner = (int64_t)AutotuneKnob::InnerUnroll;
+
+  std::vector<AutotuneVariant> variants(1);
+  for (int64_t log2_shrink = 1; log2_shrink <= kMaxLog2Shrink;
+       ++log2_shrink) {
+    for (auto knobs : {std::vector<int64_t>{outer},
+                       std::vector<int64_t>{inner},
+                       std::vector<int64_t>{outer, inner}}) {
+      AutotuneVariant variant;
+      for (int64_t knob : knobs) {
+        variant.log2_scales.at(knob) = -log2_shrink;
+      }
+      if (applyAutotuneVariant(params->clone().get(), variant)) {
+        variants.push_back(variant);
+      }
+    }
+  }
+  return variants;
+}
+
+bool applyAutotuneVariant(
+    HeuristicParams* params,
+    const AutotuneVariant& variant) {
+  // Check all knobs before writing any of them. Knobs are looked up on the
+  // unmodified params, since the vectorize flags they depend on don't change.
+  std::vector<std::pair<int64_t*, int64_t>> scaled_factors;
+  for (auto knob : c10::irange(kNumAutotuneKnobs)) {
+    const int64_t log2_scale = variant.log2_scales.at(knob);
+    if (log2_scale == 0) {
+      continue;
+    }
+    auto knob_factor = getKnobFactor(params, (AutotuneKnob)knob);
+    if (!knob_factor.has_value()) {
+      return false;
+    }
+    auto scaled = scaleFactor(knob_factor.value(), log2_scale);
+    if (!scaled.has_value()) {
+      return false;
+    }
+    scaled_factors.emplace_back(knob_factor->factor, scaled.value());
+  }
+  for (auto [factor, scaled] : scaled_factors) {
+    *factor = scaled;
+  }
+  return true;
+}
+
+} // namespace nvfuser
@@ -0,0 +1,76 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <scheduler/heuristic.h>
+#include <visibility.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace nvfuser {
+
+//! Knobs of the pointwise and reduction heuristics that the autotuner scales.
+//! Scaling them only changes the schedule, never the computed values.
+enum class AutotuneKnob {
+  //! PointwiseParams::vectorization_factor, or the vectorized factor of the
+  //! inner reduction or iteration domain of ReductionParams. Only shrunk,
+  //! since the analytical heuristics pick the widest legal vectorization.
+  Vectorize,
+  //! PointwiseParams::unroll_factor_inner, or the unroll factor of the inner
+  //! reduction domain of ReductionParams
+  InnerUnroll,
+  //! PointwiseParams::unroll_factor_outer of 2D schedules, or the unroll
+  //! factor of the iteration domain of ReductionParams
+  OuterUnroll,
+  EndOfKnob //! Placeholder for counting the number of elements
+};
+
+constexpr int64_t kNumAutotuneKnobs = (int64_t)AutotuneKnob::EndOfKnob;
+
+//! Name of a knob, e.g., "inner_unroll". Names are kept across versions, so
+//! that stored variants can be read back by newer versions.
+NVF_API const char* toString(AutotuneKnob knob);
+
+//! An AutotuneVariant scales each knob of heuristic parameters by a power of
+//! two. It is relative to the analytical heuristics, so it can be reapplied
+//! when the heuristics are recomputed for new input sizes or upon
+//! deserialization.
+struct AutotuneVariant {
+  //! log2 of the scale of each knob, indexed by AutotuneKnob
+  std::array<int64_t, kNumAutotuneKnobs> log2_scales{};
+
+  bool isDefault() const;
+  bool operator==(const AutotuneVariant& other) const {
+    return log2_scales == other.log2_scales;
+  }
+  std::string toString() const;
+};
+
+//! Returns the default variant followed by the variants that scale a single
+//! knob of params up or down by a factor of two. Returns only the default
+//! variant if the scheduler of params is not tuned.
+NVF_API std::vector<AutotuneVariant> autotuneVariants(
+    const HeuristicParams* params);
+
+//! Returns the default variant followed by the variants that shrink the
+//! unroll factors of params, in the order in which they should be tried to
+//! reduce register pressure. Each step halves the outer, the inner or both
+//! unroll factors once more than the previous one.
+NVF_API std::vector<AutotuneVariant> registerPressureVariants(
+    const HeuristicParams* params);
+
+//! Scales the knobs of params. Returns false, leaving params unchanged, if
+//! the variant doesn't apply to params.
+NVF_API bool applyAutotuneVariant(
+    HeuristicParams* params,
+    const AutotuneVariant& variant);
+
+} // namespace nvfuser
@@ -29,7 +29,20 @@ bool ExprEvalScheduler::canScheduleCompileTime(Fusion* fusion) {
     return false;
   }
 
-  if (exprs.front()->isOneOf<SdpaFwdOp, SdpaBwdOp>()) {
+  if (exprs.front()->isOneOf<
+          SdpaFwdOp,
+          SdpaBwdOp,
+          GroupedMatmulOp,
+          SegmentedReductionOp,
+          EmbeddingBwdOp,
+          ScanOp,
+          SortOp,
+          TopKOp>()) {
+    return true;
+  }
+
+  if (exprs.front()->isA<ScatterOp>() &&
+      isOptionEnabled(EnableOption::DeterministicReductions)) {
     return true;
   }
 
@@ -45,7 +58,7 @@ bool ExprEvalScheduler::canScheduleCompileTime(Fusion* fusion) {
 
   scheduler_debug_utils::canScheduleRejectReason(
       schedulerType(),
-      "Fusion must contain only a single expression of type MatmulOp/LinearOp/SdpaFwdOp/SdpaBwdOp");
+      "Fusion must contain only a single expression of type MatmulOp/LinearOp/GroupedMatmulOp/SegmentedReductionOp/EmbeddingBwdOp/ScanOp/SortOp/TopKOp/SdpaFwdOp/SdpaBwdOp");
   return false;
 }
 
@@ -70,6 +83,8 @@ std::unique_ptr<HeuristicParams> ExprEvalScheduler::computeHeuristics(
     HeuristicDataCache* data_cache) {
   auto params = std::make_unique<HeuristicParams>(SchedulerType::ExprEval);
   params->cparams.index_type = runtime_info.getIndexType();
+  // Nothing is compiled, so the params are the same for any input shape
+  params->validity_region = HeuristicValidityRegion{};
   return params;
 }
 
@@ -8,15 +8,37 @@
 #include <scheduler/heuristic.h>
 
 #include <fusion.h>
+#include <instrumentation.h>
+#include <runtime/executor_kernel_arg.h>
 #include <scheduler/registry.h>
 #include <scheduler/runtime_info.h>
 
 namespace nvfuser {
+
+bool HeuristicValidityRegion::contains(const KernelArgumentHolder& args) const {
+  for (const auto& range : extent_ranges) {
+    if (range.input >= (int64_t)args.size() ||
+        !args[range.input]->is<at::Tensor>()) {
+      return false;
+    }
+    const auto& tensor = args[range.input]->as<at::Tensor>();
+    if (range.dim >= tensor.dim()) {
+      return false;
+    }
+    const int64_t extent = tensor.size(range.dim);
+    if (extent < range.min || extent > range.max) {
+      return false;
+    }
+  }
+  return true;
+}
+
 HeuristicParamsList::HeuristicParamsList(
     SchedulerType scheduler_type,
     SchedulerRuntimeInfo& runtime_info,
     HeuristicDataCache* data_cache)
     : is_segmented_(false) {
+  FUSER_COMPILE_PHASE_SCOPE(toString(scheduler_type) + " heuristics");
   heuristics_.emplace_back(
       SchedulerEntry::makeSchedulerInstance(scheduler_type)
           ->computeHeuristics(runtime_info.fusion(), runtime_info, data_cache));
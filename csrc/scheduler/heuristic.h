@@ -11,12 +11,38 @@
 #include <scheduler/scheduler_types.h>
 #include <utils.h>
 
+#include <cstdint>
+#include <limits>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace nvfuser {
 
 class SchedulerRuntimeInfo;
 class HeuristicDataCache;
+class KernelArgumentHolder;
+
+//! Inclusive range of an extent of an input of the complete fusion
+struct InputExtentRange {
+  int64_t input = 0;
+  int64_t dim = 0;
+  int64_t min = 0;
+  int64_t max = std::numeric_limits<int64_t>::max();
+};
+
+//! Inputs for which a scheduler is known to compute the same params, so that
+//! a FusionKernelRuntime reuses its params, and the kernel compiled with them,
+//! without computing the heuristics again. The extents that aren't listed are
+//! unconstrained. A scheduler only reports a region if the params it computes
+//! for inputs in the region are the same, including the index type if it
+//! matters, e.g., params that don't depend on the input shapes at all.
+struct HeuristicValidityRegion {
+  std::vector<InputExtentRange> extent_ranges;
+
+  //! args are the inputs of the complete fusion
+  bool contains(const KernelArgumentHolder& args) const;
+};
 
 // Top-level class representing heuristic parameters. Most schedulers
 // have their own subclasses to have their specific parameters, except
@@ -29,6 +55,9 @@ class HeuristicParams : public PolymorphicBase {
   CompileParams cparams;
   const SchedulerType scheduler_type;
 
+  //! Unknown unless the scheduler reports it. Not compared by sameAs.
+  std::optional<HeuristicValidityRegion> validity_region;
+
   virtual std::string toString() const {
     std::stringstream ss;
     ss << "Heuristic Params (" << scheduler_type << ")";
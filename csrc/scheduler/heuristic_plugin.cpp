@@ -0,0 +1,511 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+
+#include <ir/interface_nodes.h>
+#include <ir/utils.h>
+#include <scheduler/heuristic_plugin.h>
+#include <scheduler/reduction_heuristic.h>
+#include <scheduler/registry.h>
+#include <scheduler/runtime_info.h>
+#include <scheduler/transpose_heuristic.h>
+#include <scheduler/utils.h>
+#include <scheduler/vectorize_helper.h>
+#include <sys_utils.h>
+#include <utils.h>
+
+#include <ATen/cuda/CUDAContext.h>
+
+#include <c10/util/irange.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+namespace nvfuser {
+
+namespace heuristic_plugin {
+
+namespace {
+
+std::mutex plugin_mutex;
+static class PluginInterface : LibraryLoader {
+ public:
+  PluginInterface() {
+    const char* envvar = getNvFuserEnv("HEURISTIC_PLUGIN");
+    if (envvar != nullptr) {
+      setFilename(envvar);
+    }
+  }
+
+  ~PluginInterface() = default;
+
+  bool available() const {
+    return !filename().empty();
+  }
+
+  bool configure(const ProblemDescription* problem, HeuristicConfig* config) {
+    NVF_ERROR(available());
+    if (configure_func_ptr_ == nullptr) {
+      std::lock_guard<std::mutex> lock(plugin_mutex);
+      configure_func_ptr_ =
+          (ConfigureHeuristicPointer)getSymbol("configureHeuristic");
+    }
+    return (*configure_func_ptr_)(problem, config);
+  }
+
+ private:
+  ConfigureHeuristicPointer configure_func_ptr_ = nullptr;
+} plugin;
+
+bool defaultConfigureHeuristic(
+    const ProblemDescription* problem,
+    HeuristicConfig* config) {
+  return plugin.configure(problem, config);
+}
+
+thread_local ConfigureHeuristicFunction configure_func =
+    defaultConfigureHeuristic;
+// See config_factory_modified in matmul_heuristic_plugin.cpp
+thread_local bool configure_func_modified = false;
+
+std::optional<SchedulerKind> toSchedulerKind(SchedulerType scheduler_type) {
+  switch (scheduler_type) {
+    case SchedulerType::Reduction:
+      return SchedulerKind::Reduction;
+    case SchedulerType::InnerPersistent:
+      return SchedulerKind::InnerPersistent;
+    case SchedulerType::OuterPersistent:
+      return SchedulerKind::OuterPersistent;
+    case SchedulerType::InnerOuterPersistent:
+      return SchedulerKind::InnerOuterPersistent;
+    case SchedulerType::Transpose:
+      return SchedulerKind::Transpose;
+    default:
+      return std::nullopt;
+  }
+}
+
+ParallelDim toParallelDim(ParallelType ptype) {
+  switch (ptype) {
+    case ParallelType::TIDx:
+      return ParallelDim::TIDx;
+    case ParallelType::TIDy:
+      return ParallelDim::TIDy;
+    case ParallelType::TIDz:
+      return ParallelDim::TIDz;
+    case ParallelType::BIDx:
+      return ParallelDim::BIDx;
+    case ParallelType::BIDy:
+      return ParallelDim::BIDy;
+    case ParallelType::BIDz:
+      return ParallelDim::BIDz;
+    default:
+      return ParallelDim::Serial;
+  }
+}
+
+ParallelType toParallelType(ParallelDim pdim) {
+  switch (pdim) {
+    case ParallelDim::Serial:
+      return ParallelType::Serial;
+    case ParallelDim::TIDx:
+      return ParallelType::TIDx;
+    case ParallelDim::TIDy:
+      return ParallelType::TIDy;
+    case ParallelDim::TIDz:
+      return ParallelType::TIDz;
+    case ParallelDim::BIDx:
+      return ParallelType::BIDx;
+    case ParallelDim::BIDy:
+      return ParallelType::BIDy;
+    case ParallelDim::BIDz:
+      return ParallelType::BIDz;
+    default:
+      NVF_THROW(
+          "Unrecognized parallel dimension returned by plugin: ",
+          (int64_t)pdim);
+  }
+}
+
+char dtypeToLetter(const DataType& dtype) {
+  if (dtype == DataType::Bool) {
+    return 'b';
+  } else if (dtype == DataType::Int32) {
+    return 'I';
+  } else if (dtype == DataType::Int) {
+    return 'L';
+  } else if (dtype == DataType::Float8_e4m3fn) {
+    return 'Q';
+  } else if (dtype == DataType::Float8_e5m2) {
+    return 'R';
+  } else if (dtype == DataType::BFloat16) {
+    return 'T';
+  } else if (dtype == DataType::Half) {
+    return 'H';
+  } else if (dtype == DataType::Float) {
+    return 'S';
+  } else if (dtype == DataType::Double) {
+    return 'D';
+  } else if (dtype == DataType::ComplexFloat) {
+    return 'C';
+  } else if (dtype == DataType::ComplexDouble) {
+    return 'Z';
+  }
+  return 'X';
+}
+
+void fillDtypes(char* dtypes, const std::vector<Val*>& vals) {
+  uint32_t num_tensors = 0;
+  for (auto tv : ir_utils::filterByType<TensorView>(vals)) {
+    if (num_tensors == kMaxTensors) {
+      break;
+    }
+    dtypes[num_tensors++] = dtypeToLetter(tv->dtype());
+  }
+  dtypes[num_tensors] = '\0';
+}
+
+//! Returns the tensor whose logical domain is described to the plugin
+TensorView* getReferenceTv(Fusion* fusion, SchedulerType scheduler_type) {
+  if (scheduler_type == SchedulerType::Transpose) {
+    TensorView* reference_tv = nullptr;
+    for (auto tv : ir_utils::filterByType<TensorView>(fusion->outputs())) {
+      if (reference_tv == nullptr ||
+          tv->getLogicalDomain().size() >
+              reference_tv->getLogicalDomain().size()) {
+        reference_tv = tv;
+      }
+    }
+    return reference_tv;
+  }
+  const auto reduction_tvs = scheduler_utils::getReductionTvs(fusion);
+  if (reduction_tvs.empty()) {
+    return nullptr;
+  }
+  // The combined inner outer scheduler uses an inner reduction as reference
+  auto it = std::find_if(
+      reduction_tvs.begin(),
+      reduction_tvs.end(),
+      scheduler_utils::isFastestDimReduction);
+  return it == reduction_tvs.end() ? reduction_tvs.front() : *it;
+}
+
+void fillProblemDescription(
+    ProblemDescription& problem,
+    const HeuristicParams* params,
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicDataCache* data_cache) {
+  problem.scheduler = toSchedulerKind(params->scheduler_type).value();
+
+  TensorView* reference_tv = getReferenceTv(fusion, params->scheduler_type);
+  NVF_ERROR(reference_tv != nullptr, "Could not find a reference tensor.");
+  const auto& logical = reference_tv->getLogicalDomain();
+  problem.num_dims = (uint32_t)std::min((size_t)kMaxDims, logical.size());
+  for (auto i : c10::irange(problem.num_dims)) {
+    problem.extents[i] = 1;
+  }
+  for (auto i : c10::irange(logical.size())) {
+    IterDomain* id = logical.at(i);
+    const PolymorphicValue extent =
+        runtime_info.expressionEvaluator().evaluate(id->extent());
+    NVF_ERROR(
+        extent.hasValue(), "Could not evaluate extent of ", id->toString());
+    const auto dim = std::min((uint32_t)i, problem.num_dims - 1);
+    problem.extents[dim] *= extent.as<int64_t>();
+    if (id->isReduction()) {
+      problem.reduction_axes |= 1u << dim;
+    }
+  }
+
+  fillDtypes(problem.input_dtypes, fusion->inputs());
+  fillDtypes(problem.output_dtypes, fusion->outputs());
+  for (auto tv : ir_utils::filterByType<TensorView>(fusion->inputs())) {
+    problem.max_input_dtype_size = std::max(
+        problem.max_input_dtype_size,
+        dataTypeSize(tv->getDataType().value(), runtime_info.getIndexType()));
+  }
+  problem.index_type_size = dataTypeSize(runtime_info.getIndexType());
+
+  const auto device_prop = at::cuda::getCurrentDeviceProperties();
+  problem.sm_count = device_prop->multiProcessorCount;
+  problem.max_threads_per_block = device_prop->maxThreadsPerBlock;
+  problem.shared_memory_per_block =
+      (int64_t)device_prop->sharedMemPerBlockOptin;
+
+  if (params->scheduler_type == SchedulerType::Transpose) {
+    return;
+  }
+
+  const auto properties = scheduler_utils::getReductionProperties(
+      fusion, runtime_info, reference_tv);
+  problem.total_reduction_numel = properties.total_reduction_numel;
+  problem.total_iteration_numel = properties.total_iteration_numel;
+  problem.inner_most_dimension_numel = properties.inner_most_dimension_numel;
+  problem.fastest_dim_reduction = properties.fastest_dim_reduction;
+
+  auto reduced_tv = ir_utils::getSoleProducerTv(reference_tv);
+  // Same cache entry as the reduction and normalization heuristics
+  auto vec_break_point = HeuristicDataCacheEntry<
+      HeuristicCompileTime::VectorizationBreakPointOfReductionProducer>(
+      data_cache, [&reference_tv, &reduced_tv, &properties]() {
+        return std::make_unique<int64_t>(
+            vectorize_helper::getVectorizationBreakPointOfReductionProducer(
+                reference_tv,
+                reduced_tv,
+                properties.inner_most_dimension_ndims));
+      });
+  problem.max_vectorize_factor = vectorize_helper::getVectorizationFactor(
+      runtime_info, reduced_tv, data_cache, vec_break_point.get());
+
+  if (params->scheduler_type == SchedulerType::Reduction) {
+    return;
+  }
+  auto persistent_buffer_info_entry =
+      HeuristicDataCacheEntry<HeuristicCompileTime::PersistentBufferInfo>(
+          data_cache, [&fusion]() {
+            return std::make_unique<scheduler_utils::PersistentBufferInfo>(
+                scheduler_utils::persistentBuffers(fusion));
+          });
+  const auto buffer_size = scheduler_utils::persistentBufferSize(
+      fusion, runtime_info, persistent_buffer_info_entry.get(), data_cache);
+  problem.persistent_buffer_size = buffer_size.persistent_buffer_size;
+  problem.projected_persistent_buffer_size =
+      buffer_size.projected_persistent_buffer_size;
+}
+
+void copyParamsToConfig(
+    HeuristicConfig* config,
+    const HeuristicParams* params) {
+  const LaunchParams& lparams = params->lparams;
+  config->gdimx = lparams.getRawVal(ParallelType::BIDx);
+  config->gdimy = lparams.getRawVal(ParallelType::BIDy);
+  config->gdimz = lparams.getRawVal(ParallelType::BIDz);
+  config->bdimx = lparams.getRawVal(ParallelType::TIDx);
+  config->bdimy = lparams.getRawVal(ParallelType::TIDy);
+  config->bdimz = lparams.getRawVal(ParallelType::TIDz);
+
+  if (auto tparams = dynamic_cast<const TransposeParams*>(params)) {
+    TransposeConfig& tconfig = config->transpose;
+    tconfig.tile_size1 = tparams->tile_size1;
+    tconfig.tile_size2 = tparams->tile_size2;
+    tconfig.vectorize_factor1 = tparams->vectorize_factor1;
+    tconfig.vectorize_factor2 = tparams->vectorize_factor2;
+    return;
+  }
+
+  auto rparams = params->as<ReductionParams>();
+  ReductionConfig& rconfig = config->reduction;
+  rconfig.persistent_kernel = rparams->persistent_kernel;
+  rconfig.project_persistent_buffers = rparams->project_persistent_buffers;
+  rconfig.schedule_3d = rparams->schedule_3D;
+  rconfig.flip_grid = rparams->flip_grid;
+
+  rconfig.cross_block_inner_reduction = rparams->cross_block_inner_reduction;
+  rconfig.cross_grid_inner_reduction = rparams->cross_grid_inner_reduction;
+  rconfig.unroll_factor_inner_reduction =
+      rparams->unroll_factor_inner_reduction;
+  rconfig.unroll_factor_top_of_vectorization =
+      rparams->unroll_factor_top_of_vectorization;
+  rconfig.vectorize_inner_reduction = rparams->vectorize_inner_reduction;
+  rconfig.split_grid_dim_inner_reduction =
+      rparams->split_grid_dim_inner_reduction;
+  rconfig.pad_inner_reduction_to_warp = rparams->pad_inner_reduction_to_warp;
+  rconfig.batches_per_block_inner_reduction =
+      rparams->batches_per_block_inner_reduction;
+  rconfig.block_dim_inner_reduction =
+      toParallelDim(rparams->block_dim_inner_reduction);
+  rconfig.grid_dim_inner_reduction =
+      toParallelDim(rparams->grid_dim_inner_reduction);
+
+  rconfig.multiple_reds_per_blk = rparams->multiple_reds_per_blk;
+  rconfig.unroll_factor_iter_dom = rparams->unroll_factor_iter_dom;
+  rconfig.vectorize_iter_dom = rparams->vectorize_iter_dom;
+  rconfig.split_grid_dim_iter_dom_inner =
+      rparams->split_grid_dim_iter_dom_inner;
+  rconfig.split_grid_dim_iter_dom_outer =
+      rparams->split_grid_dim_iter_dom_outer;
+  rconfig.block_dim_iter_dom = toParallelDim(rparams->block_dim_iter_dom);
+  rconfig.grid_dim_iter_dom = toParallelDim(rparams->grid_dim_iter_dom);
+
+  rconfig.cross_block_outer_reduction = rparams->cross_block_outer_reduction;
+  rconfig.cross_grid_outer_reduction = rparams->cross_grid_outer_reduction;
+  rconfig.split_grid_dim_outer_reduction =
+      rparams->split_grid_dim_outer_reduction;
+  rconfig.batches_per_block_outer_reduction =
+      rparams->batches_per_block_outer_reduction;
+  rconfig.unroll_factor_outer_reduction =
+      rparams->unroll_factor_outer_reduction;
+  rconfig.block_dim_outer_reduction =
+      toParallelDim(rparams->block_dim_outer_reduction);
+  rconfig.grid_dim_outer_reduction =
+      toParallelDim(rparams->grid_dim_outer_reduction);
+
+  rconfig.compute_persistent_buffer_with_first_consumer =
+      rparams->compute_persistent_buffer_with_first_consumer;
+}
+
+void copyConfigToParams(
+    HeuristicParams* params,
+    const HeuristicConfig* config,
+    const ProblemDescription& problem) {
+  LaunchParams& lparams = params->lparams;
+  lparams.bindUnsafe(config->gdimx, ParallelType::BIDx);
+  lparams.bindUnsafe(config->gdimy, ParallelType::BIDy);
+  lparams.bindUnsafe(config->gdimz, ParallelType::BIDz);
+  lparams.bindUnsafe(config->bdimx, ParallelType::TIDx);
+  lparams.bindUnsafe(config->bdimy, ParallelType::TIDy);
+  lparams.bindUnsafe(config->bdimz, ParallelType::TIDz);
+
+  if (auto tparams = dynamic_cast<TransposeParams*>(params)) {
+    const TransposeConfig& tconfig = config->transpose;
+    NVF_CHECK(
+        tconfig.tile_size1 >= 1 && tconfig.tile_size2 >= 1,
+        "Invalid transpose tile sizes returned by plugin");
+    // The analytical vectorization factors are the widest legal ones
+    NVF_CHECK(
+        tconfig.vectorize_factor1 >= 1 &&
+            tconfig.vectorize_factor1 <= tparams->vectorize_factor1 &&
+            tconfig.vectorize_factor2 >= 1 &&
+            tconfig.vectorize_factor2 <= tparams->vectorize_factor2,
+        "Plugin may only shrink the transpose vectorization factors");
+    tparams->tile_size1 = tconfig.tile_size1;
+    tparams->tile_size2 = tconfig.tile_size2;
+    tparams->vectorize_factor1 = tconfig.vectorize_factor1;
+    tparams->vectorize_factor2 = tconfig.vectorize_factor2;
+    return;
+  }
+
+  auto rparams = params->as<ReductionParams>();
+  const ReductionConfig& rconfig = config->reduction;
+  NVF_CHECK(
+      rconfig.persistent_kernel == rparams->persistent_kernel,
+      "Plugin may not change whether a ",
+      rparams->scheduler_type,
+      " kernel is persistent");
+  NVF_CHECK(
+      rconfig.unroll_factor_inner_reduction >= 1 &&
+          rconfig.unroll_factor_top_of_vectorization >= 1 &&
+          rconfig.unroll_factor_iter_dom >= 1 &&
+          rconfig.unroll_factor_outer_reduction >= 1 &&
+          rconfig.batches_per_block_inner_reduction >= 1 &&
+          rconfig.batches_per_block_outer_reduction >= 1,
+      "Unroll factors and batches returned by plugin must be positive");
+  NVF_CHECK(
+      !rconfig.vectorize_inner_reduction ||
+          rconfig.unroll_factor_inner_reduction <=
+              problem.max_vectorize_factor,
+      "Inner reduction vectorization factor ",
+      rconfig.unroll_factor_inner_reduction,
+      " returned by plugin exceeds the maximum of ",
+      problem.max_vectorize_factor);
+  NVF_CHECK(
+      !rconfig.vectorize_iter_dom ||
+          rconfig.unroll_factor_iter_dom <= problem.max_vectorize_factor,
+      "Iteration domain vectorization factor ",
+      rconfig.unroll_factor_iter_dom,
+      " returned by plugin exceeds the maximum of ",
+      problem.max_vectorize_factor);
+
+  rparams->project_persistent_buffers = rconfig.project_persistent_buffers;
+  rparams->schedule_3D = rconfig.schedule_3d;
+  rparams->flip_grid = rconfig.flip_grid;
+
+  rparams->cross_block_inner_reduction = rconfig.cross_block_inner_reduction;
+  rparams->cross_grid_inner_reduction = rconfig.cross_grid_inner_reduction;
+  rparams->unroll_factor_inner_reduction =
+      rconfig.unroll_factor_inner_reduction;
+  rparams->unroll_factor_top_of_vectorization =
+      rconfig.unroll_factor_top_of_vectorization;
+  rparams->vectorize_inner_reduction = rconfig.vectorize_inner_reduction;
+  rparams->split_grid_dim_inner_reduction =
+      rconfig.split_grid_dim_inner_reduction;
+  rparams->pad_inner_reduction_to_warp = rconfig.pad_inner_reduction_to_warp;
+  rparams->batches_per_block_inner_reduction =
+      rconfig.batches_per_block_inner_reduction;
+  rparams->block_dim_inner_reduction =
+      toParallelType(rconfig.block_dim_inner_reduction);
+  rparams->grid_dim_inner_reduction =
+      toParallelType(rconfig.grid_dim_inner_reduction);
+
+  rparams->multiple_reds_per_blk = rconfig.multiple_reds_per_blk;
+  rparams->unroll_factor_iter_dom = rconfig.unroll_factor_iter_dom;
+  rparams->vectorize_iter_dom = rconfig.vectorize_iter_dom;
+  rparams->split_grid_dim_iter_dom_inner =
+      rconfig.split_grid_dim_iter_dom_inner;
+  rparams->split_grid_dim_iter_dom_outer =
+      rconfig.split_grid_dim_iter_dom_outer;
+  rparams->block_dim_iter_dom = toParallelType(rconfig.block_dim_iter_dom);
+  rparams->grid_dim_iter_dom = toParallelType(rconfig.grid_dim_iter_dom);
+
+  rparams->cross_block_outer_reduction = rconfig.cross_block_outer_reduction;
+  rparams->cross_grid_outer_reduction = rconfig.cross_grid_outer_reduction;
+  rparams->split_grid_dim_outer_reduction =
+      rconfig.split_grid_dim_outer_reduction;
+  rparams->batches_per_block_outer_reduction =
+      rconfig.batches_per_block_outer_reduction;
+  rparams->unroll_factor_outer_reduction =
+      rconfig.unroll_factor_outer_reduction;
+  rparams->block_dim_outer_reduction =
+      toParallelType(rconfig.block_dim_outer_reduction);
+  rparams->grid_dim_outer_reduction =
+      toParallelType(rconfig.grid_dim_outer_reduction);
+
+  rparams->compute_persistent_buffer_with_first_consumer =
+      rconfig.compute_persistent_buffer_with_first_consumer;
+}
+
+} // namespace
+
+bool updateHeuristicParams(
+    HeuristicParams* params,
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicDataCache* data_cache) {
+  if (!hasPlugin() || !toSchedulerKind(params->scheduler_type).has_value()) {
+    return false;
+  }
+
+  ProblemDescription problem;
+  fillProblemDescription(problem, params, fusion, runtime_info, data_cache);
+
+  // Set previous heuristic values so they are available to the plugin
+  HeuristicConfig config;
+  copyParamsToConfig(&config, params);
+
+  // Execute the user-provided heuristic
+  if (!configure_func(&problem, &config)) {
+    return false;
+  }
+
+  // Load values from config back into params
+  copyConfigToParams(params, &config, problem);
+  params->tag += "Heuristic Plugin.\n";
+  return true;
+}
+
+bool hasPlugin() {
+  return configure_func_modified || plugin.available();
+}
+
+ConfigureHeuristicGuard::ConfigureHeuristicGuard(
+    ConfigureHeuristicFunction func)
+    : prev_func_(configure_func), prev_func_modified_(configure_func_modified) {
+  configure_func = func;
+  configure_func_modified = true;
+}
+
+ConfigureHeuristicGuard::~ConfigureHeuristicGuard() {
+  configure_func = prev_func_;
+  configure_func_modified = prev_func_modified_;
+}
+
+} // namespace heuristic_plugin
+
+} // namespace nvfuser
@@ -0,0 +1,66 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <fusion.h>
+#include <scheduler/heuristic.h>
+#include <scheduler/heuristic_plugin_api.h>
+#include <visibility.h>
+
+#include <functional>
+
+namespace nvfuser {
+
+class SchedulerRuntimeInfo;
+class HeuristicDataCache;
+
+namespace heuristic_plugin {
+
+//! Returns true if ConfigureHeuristicGuard is active indicating an imitated
+//! plugin, or if a shared library plugin has been provided using the
+//! environment variable NVFUSER_HEURISTIC_PLUGIN.
+NVF_API bool hasPlugin();
+
+//! If there is no user-defined plugin (see hasPlugin()), or params are not of
+//! a scheduler supported by the plugin API, we return false. Otherwise, we
+//! describe the problem to the plugin and let it modify the heuristic
+//! parameters in place. Returns true if the plugin modified them.
+bool updateHeuristicParams(
+    HeuristicParams* params,
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicDataCache* data_cache);
+
+//! Defines the type of the "configureHeuristic" symbol
+using ConfigureHeuristicFunction =
+    std::function<bool(const ProblemDescription*, HeuristicConfig*)>;
+
+//! This function can be used to imitate a plugin. To do so, create a guard
+//! object like this:
+//!
+//!   ConfigureHeuristicGuard chg(
+//!       [](const ProblemDescription* problem, HeuristicConfig* config) {
+//!         config->reduction.unroll_factor_iter_dom = 2;
+//!         return true;
+//!       });
+//!
+//! When chg passes out of scope, the configure function will be reset to its
+//! prior value.
+class NVF_API ConfigureHeuristicGuard {
+ public:
+  explicit ConfigureHeuristicGuard(ConfigureHeuristicFunction func);
+  ~ConfigureHeuristicGuard();
+
+ private:
+  ConfigureHeuristicFunction prev_func_;
+  bool prev_func_modified_;
+};
+
+} // namespace heuristic_plugin
+
+} // namespace nvfuser
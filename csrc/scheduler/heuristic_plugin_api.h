@@ -0,0 +1,187 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <cstdint>
+
+namespace nvfuser {
+
+namespace heuristic_plugin {
+
+//! This is a minimal interface for plugging custom heuristics into the
+//! reduction, normalization and transpose schedulers. It is the counterpart of
+//! matmul_heuristic_plugin_api.h for those schedulers.
+//!
+//! To plug in your own heuristic, create a dynamic library exporting
+//!
+//!   extern "C" bool configureHeuristic(
+//!       const ProblemDescription* problem,
+//!       HeuristicConfig* config);
+//!
+//! nvFuser fills the config with the parameters chosen by its own heuristics
+//! before calling configureHeuristic. The plugin may modify them and return
+//! true, or return false to keep nvFuser's parameters.
+//!
+//! If that library is located at /path/to/libfoo.so you can set
+//! NVFUSER_HEURISTIC_PLUGIN=/path/to/libfoo.so to use the plugin.
+//!
+//! All structs below are plain old data with explicit integer encodings, so
+//! their layout doesn't depend on nvFuser internals. Any change to their
+//! layout bumps kApiVersion; plugins should check problem->api_version.
+
+constexpr uint32_t kApiVersion = 1;
+
+//! Maximum number of dimensions of the reference tensor
+constexpr uint32_t kMaxDims = 8;
+
+//! Maximum number of fusion inputs and outputs whose dtypes are described
+constexpr uint32_t kMaxTensors = 16;
+
+extern "C" {
+
+//! Explicit integer mapping for the schedulers queried through the plugin
+enum class SchedulerKind : uint8_t {
+  Reduction = 0,
+  InnerPersistent = 1,
+  OuterPersistent = 2,
+  InnerOuterPersistent = 3,
+  Transpose = 4,
+};
+
+//! Explicit integer mapping for the parallel dimensions of ReductionConfig
+enum class ParallelDim : uint8_t {
+  Serial = 0,
+  TIDx = 1,
+  TIDy = 2,
+  TIDz = 3,
+  BIDx = 4,
+  BIDy = 5,
+  BIDz = 6,
+};
+
+//! This is the information available to the plugin to determine the kernel
+//! configuration.
+struct ProblemDescription {
+  uint32_t api_version = kApiVersion;
+  SchedulerKind scheduler = SchedulerKind::Reduction;
+
+  //! Extents of the logical domain of the reference tensor, outermost first.
+  //! The reference tensor is the reduction tensor for reduction and
+  //! normalization schedulers, and the largest output for the transpose
+  //! scheduler. Dimensions beyond kMaxDims are merged into the innermost one.
+  uint32_t num_dims = 0;
+  int64_t extents[kMaxDims] = {};
+  //! Bit i is set if dimension i of the reference tensor is reduced
+  uint32_t reduction_axes = 0;
+
+  //! Reduction properties of the reference tensor. Zero for transposes.
+  int64_t total_reduction_numel = 0;
+  int64_t total_iteration_numel = 0;
+  int64_t inner_most_dimension_numel = 0;
+  bool fastest_dim_reduction = false;
+
+  //! Dtypes of fusion inputs and outputs, as null-terminated strings with one
+  //! letter per tensor, using the letters of the matmul plugin precision
+  //! string extended with:
+  //!  b = Bool
+  //!  L = Int64
+  //!  X = any other type
+  //! Tensors beyond kMaxTensors are omitted.
+  char input_dtypes[kMaxTensors + 1] = {};
+  char output_dtypes[kMaxTensors + 1] = {};
+  //! Largest dtype size in bytes among the fusion inputs
+  int64_t max_input_dtype_size = 1;
+  //! Index type size in bytes, 4 or 8
+  int64_t index_type_size = 8;
+
+  //! Widest vectorization allowed by the alignment and contiguity of the
+  //! reduced tensor. Zero for transposes, whose vectorization factors can only
+  //! be shrunk.
+  int64_t max_vectorize_factor = 0;
+
+  //! Persistent buffer sizes in bytes, for the persistent schedulers only
+  int64_t persistent_buffer_size = 0;
+  int64_t projected_persistent_buffer_size = 0;
+
+  //! Properties of the current device
+  int64_t sm_count = 0;
+  int64_t max_threads_per_block = 0;
+  int64_t shared_memory_per_block = 0;
+};
+
+//! Parameters of reduction and normalization kernels. See ReductionParams for
+//! the meaning of each field.
+struct ReductionConfig {
+  bool persistent_kernel = false;
+  bool project_persistent_buffers = false;
+  bool schedule_3d = false;
+  bool flip_grid = false;
+
+  bool cross_block_inner_reduction = false;
+  bool cross_grid_inner_reduction = false;
+  int64_t unroll_factor_inner_reduction = 1;
+  int64_t unroll_factor_top_of_vectorization = 1;
+  bool vectorize_inner_reduction = false;
+  bool split_grid_dim_inner_reduction = false;
+  bool pad_inner_reduction_to_warp = false;
+  int64_t batches_per_block_inner_reduction = 1;
+  ParallelDim block_dim_inner_reduction = ParallelDim::Serial;
+  ParallelDim grid_dim_inner_reduction = ParallelDim::Serial;
+
+  bool multiple_reds_per_blk = false;
+  int64_t unroll_factor_iter_dom = 1;
+  bool vectorize_iter_dom = false;
+  bool split_grid_dim_iter_dom_inner = false;
+  bool split_grid_dim_iter_dom_outer = false;
+  ParallelDim block_dim_iter_dom = ParallelDim::Serial;
+  ParallelDim grid_dim_iter_dom = ParallelDim::Serial;
+
+  bool cross_block_outer_reduction = false;
+  bool cross_grid_outer_reduction = false;
+  bool split_grid_dim_outer_reduction = false;
+  int64_t batches_per_block_outer_reduction = 1;
+  int64_t unroll_factor_outer_reduction = 1;
+  ParallelDim block_dim_outer_reduction = ParallelDim::Serial;
+  ParallelDim grid_dim_outer_reduction = ParallelDim::Serial;
+
+  bool compute_persistent_buffer_with_first_consumer = false;
+};
+
+//! Parameters of transpose kernels. See TransposeParams for the meaning of
+//! each field.
+struct TransposeConfig {
+  int64_t tile_size1 = 32;
+  int64_t tile_size2 = 32;
+  int64_t vectorize_factor1 = 1;
+  int64_t vectorize_factor2 = 1;
+};
+
+struct HeuristicConfig {
+  //! Only the config of problem->scheduler is read back
+  ReductionConfig reduction;
+  TransposeConfig transpose;
+
+  //! Launch dimensions, -1 if they are inferred from the schedule
+  int64_t gdimx = -1;
+  int64_t gdimy = -1;
+  int64_t gdimz = -1;
+  int64_t bdimx = -1;
+  int64_t bdimy = -1;
+  int64_t bdimz = -1;
+};
+
+//! Defines the type of the "configureHeuristic" symbol
+typedef bool (*ConfigureHeuristicPointer)(
+    const ProblemDescription* problem,
+    HeuristicConfig* config);
+
+} // extern "C"
+
+} // namespace heuristic_plugin
+
+} // namespace nvfuser
@@ -27,8 +27,40 @@
 #include <runtime/executor_utils.h>
 #include "mma_type.h"
 
+#include <ATen/cuda/CUDAContext.h>
+
+#include <algorithm>
+#include <utility>
+
 namespace nvfuser {
 
+namespace {
+
+//! Registers per thread of the producer warp group of a warp-specialized
+//! kernel. It only issues TMA loads, so it gives most of its registers to the
+//! compute warp groups.
+constexpr int64_t producer_registers_per_thread = 40;
+
+//! Splits the register file between one producer warp group and
+//! num_compute_warp_groups compute warp groups, as required by setmaxnreg.
+std::pair<int64_t, int64_t> getWarpSpecializedRegisterSharing(
+    int64_t num_compute_warp_groups) {
+  constexpr int64_t threads_per_warp_group = 128;
+  constexpr int64_t max_registers_per_thread = 256;
+  const int64_t registers_per_sm =
+      at::cuda::getCurrentDeviceProperties()->regsPerMultiprocessor;
+  const int64_t compute_registers =
+      (registers_per_sm / threads_per_warp_group -
+       producer_registers_per_thread) /
+      num_compute_warp_groups;
+  // setmaxnreg takes a multiple of 8
+  return {
+      producer_registers_per_thread,
+      std::min(max_registers_per_thread, compute_registers / 8 * 8)};
+}
+
+} // namespace
+
 void HopperMultipleMatmulScheduler::transformLikeMmaOutput(
     TensorView* tv,
     bool is_mma_result) {
@@ -640,13 +672,28 @@ void HopperMultipleMatmulScheduler::setUpCircularBuffering() {
         " but is expected to be positive and not greater than number of stages: ",
         params_->circular_buffer_options.smem_circular_buffer_stage);
 
+    CircularBufferType cb_type = Pipelined(false);
+    if (params_->circular_buffering_strategy ==
+        MatmulParams::CircularBufferingStrategy::WarpSpecialized) {
+      // The compute warp groups are parallelized on TIDy in
+      // transformLikeMmaOutput, so the producer warp group is the extra
+      // TIDy index padded by warp specialization.
+      const int64_t num_compute_warp_groups =
+          (params_->tile_sizes.cta_tile.m / getM(params_->mma_macro)) *
+          (params_->tile_sizes.cta_tile.n / getN(params_->mma_macro));
+      cb_type = WarpSpecialized(
+          ParallelType::TIDy,
+          getWarpSpecializedRegisterSharing(num_compute_warp_groups));
+    }
+
     for (TensorView* acw_smem : acw_smems_) {
       acw_smem->circularBuffer(
           params_->circular_buffer_options.smem_circular_buffer_stage,
           /*prefetch_distance=*/
           params_->circular_buffer_options.smem_circular_buffer_stage -
               params_->circular_buffer_options
-                  .smem_circular_buffer_prefetch_gap);
+                  .smem_circular_buffer_prefetch_gap,
+          cb_type);
     }
     for (TensorView* bcw_smem : bcw_smems_) {
       bcw_smem->circularBuffer(
@@ -654,7 +701,8 @@ void HopperMultipleMatmulScheduler::setUpCircularBuffering() {
           /*prefetch_distance=*/
           params_->circular_buffer_options.smem_circular_buffer_stage -
               params_->circular_buffer_options
-                  .smem_circular_buffer_prefetch_gap);
+                  .smem_circular_buffer_prefetch_gap,
+          cb_type);
     }
   }
 
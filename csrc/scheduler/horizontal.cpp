@@ -0,0 +1,382 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <ATen/cuda/CUDAContext.h>
+#include <disjoint_set.h>
+#include <instrumentation.h>
+#include <ir/utils.h>
+#include <options.h>
+#include <scheduler/cache_policy_refiner.h>
+#include <scheduler/debug_utils.h>
+#include <scheduler/horizontal.h>
+#include <scheduler/horizontal_heuristic.h>
+#include <scheduler/mark_aliases.h>
+#include <scheduler/registry_utils.h>
+#include <scheduler/runtime_info.h>
+#include <scheduler/tools/domain_map.h>
+#include <scheduler/tools/inlining.h>
+#include <scheduler/utils.h>
+#include <scheduler/vectorize_helper.h>
+
+#include <unordered_map>
+
+namespace nvfuser {
+
+namespace {
+
+// Kernel arguments are limited to 4KB of parameter space
+constexpr int64_t kMaxKernelParamBytes = 4096;
+
+// A connected subgraph of the fusion
+struct Component {
+  std::vector<TensorView*> outputs;
+  std::vector<TensorView*> tvs;
+};
+
+// Groups the tensors of the fusion by connected subgraph, in the order of the
+// first fusion output of each subgraph. Scalars are shared freely between
+// subgraphs and do not connect them.
+std::vector<Component> getComponents(Fusion* fusion) {
+  DisjointSets<Val*> component_sets;
+  for (auto output : fusion->outputs()) {
+    component_sets.initializeSet(output);
+  }
+  for (auto expr : fusion->exprs()) {
+    auto output0 = expr->output(0);
+    component_sets.initializeSet(output0);
+    for (auto input : ir_utils::filterByType<TensorView>(expr->inputs())) {
+      component_sets.mapEntries(output0, input);
+    }
+    for (auto output : expr->outputs()) {
+      component_sets.mapEntries(output0, output);
+    }
+  }
+
+  std::vector<Component> components;
+  std::unordered_map<const void*, size_t> component_ids;
+  for (auto output : ir_utils::filterByType<TensorView>(fusion->outputs())) {
+    const auto& set = component_sets.getDisjointSetOf(output);
+    auto [it, inserted] = component_ids.try_emplace(&set, components.size());
+    if (inserted) {
+      components.emplace_back();
+      components.back().tvs =
+          ir_utils::filterByType<TensorView>(set.vector()).vector();
+    }
+    components.at(it->second).outputs.push_back(output);
+  }
+  return components;
+}
+
+// Finds the reference of each subgraph the same way the pointwise scheduler
+// does for a whole fusion, but only requires the reference to cover the
+// inputs and outputs of its own subgraph.
+class ComponentDomainMap : public scheduler_tools::DomainMap {
+ public:
+  using scheduler_tools::DomainMap::DomainMap;
+
+  TensorView* findReferenceTensor(const Component& component) const {
+    TensorView* result = nullptr;
+    int64_t max_dims = 0;
+    for (auto output_tv : component.outputs) {
+      if (output_tv->isFusionInput() ||
+          !isValidReference(output_tv, component)) {
+        continue;
+      }
+      if (std::any_of(
+              output_tv->getLogicalDomain().begin(),
+              output_tv->getLogicalDomain().end(),
+              [](IterDomain* id) { return id->isBroadcast(); })) {
+        continue;
+      }
+      int64_t n_dims = scheduler_utils::nLogicalDims(output_tv);
+      if (n_dims > max_dims) {
+        result = output_tv;
+        max_dims = n_dims;
+      }
+    }
+    return result;
+  }
+
+ private:
+  bool isValidReference(TensorView* tv, const Component& component) const {
+    for (auto other_tv : component.tvs) {
+      if (other_tv->isFusionInput() && !other_tv->uses().empty() &&
+          !areAllInputIdsMappedTo(other_tv, tv)) {
+        return false;
+      }
+      if (other_tv->isFusionOutput() && other_tv != tv &&
+          !areAllTargetIdsCoveredBy(other_tv, tv)) {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+int64_t estimateKernelParamBytes(Fusion* fusion) {
+  int64_t param_bytes = 0;
+  auto add_param = [&param_bytes](Val* val) {
+    constexpr int64_t word_size = 8;
+    if (auto tv = dynamic_cast<TensorView*>(val)) {
+      // Data pointer, sizes and strides
+      auto alloc_dom =
+          TensorDomain::noReductions(tv->getMaybeAllocationDomain());
+      param_bytes += word_size * (1 + 2 * (int64_t)alloc_dom.size());
+    } else {
+      param_bytes += word_size;
+    }
+  };
+  for (auto input : fusion->inputs()) {
+    add_param(input);
+  }
+  for (auto output : fusion->outputs()) {
+    add_param(output);
+  }
+  return param_bytes;
+}
+
+// Flattens the reference into [chunks/gdimx, gdimx, bdimx, vectorization] and
+// propagates the schedule to the rest of its subgraph. Blocks stride over the
+// chunks, so every subgraph uses the same launch configuration regardless of
+// its size.
+void scheduleComponent(
+    TensorView* reference_tv,
+    const std::vector<TensorView*>& component_tvs,
+    const HorizontalParams* hparams,
+    int64_t vectorization_factor) {
+  std::unordered_map<int64_t, int64_t> logical_reorder_map =
+      scheduler_utils::maybeLogicalReorderAsAllocationMap(reference_tv);
+  if (!logical_reorder_map.empty()) {
+    reference_tv->reorder(logical_reorder_map);
+  }
+  reference_tv->flatten();
+  // [I]
+
+  if (vectorization_factor > 1) {
+    reference_tv->split(0, vectorization_factor);
+  }
+  reference_tv->split(0, hparams->bdimx);
+  reference_tv->split(0, hparams->gdimx);
+  // [I/v/bdimx/gdimx, gdimx(BIDx), bdimx(TIDx), v]
+  reference_tv->axis(1)->parallelize(ParallelType::BIDx);
+  reference_tv->axis(2)->parallelize(ParallelType::TIDx);
+
+  TransformPropagator propagator(reference_tv);
+  MaxLogicalDomainInfoSpanningTree spanning_tree(reference_tv);
+  spanning_tree.traverse(&propagator);
+  scheduler_utils::parallelizeAllLike(reference_tv, component_tvs);
+
+  if (vectorization_factor == 1) {
+    return;
+  }
+
+  auto inputs_outputs =
+      scheduler_utils::getInputsOutputsWithInnerDim(reference_tv, true, true);
+  std::vector<TensorView*> vectorized_tvs;
+  bool should_vectorize_reference_tv = false;
+  for (auto tv : inputs_outputs) {
+    if (tv == reference_tv) {
+      should_vectorize_reference_tv = true;
+    }
+    if (!tv->isFusionInput()) {
+      vectorized_tvs.emplace_back(tv);
+      continue;
+    }
+    // move inputs to consumers of inputs
+    auto consumer_tvs = ir_utils::consumerTvsOf(tv);
+    vectorized_tvs.insert(
+        vectorized_tvs.end(), consumer_tvs.begin(), consumer_tvs.end());
+  }
+  if (vectorized_tvs.empty()) {
+    return;
+  }
+  reference_tv->axis(3)->parallelize(ParallelType::Vectorize);
+  scheduler_utils::parallelizeAllLike(
+      reference_tv, vectorized_tvs, {ParallelType::Vectorize});
+  if (!should_vectorize_reference_tv) {
+    reference_tv->axis(3)->parallelize(ParallelType::Serial);
+  }
+}
+
+} // namespace
+
+bool HorizontalScheduler::canScheduleCompileTime(Fusion* fusion) {
+  if (isOptionDisabled(DisableOption::HorizontalFusion)) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        schedulerType(), "Disabled by NVFUSER_DISABLE=horizontal_fusion");
+    return false;
+  }
+
+  if (scheduler_utils::isResharding(fusion)) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        schedulerType(), "Fusion is resharding.");
+    return false;
+  }
+
+  if (ir_utils::hasAnyReductionOps(fusion)) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        schedulerType(), "No support for reduction ops");
+    return false;
+  }
+
+  for (auto expr : fusion->exprs()) {
+    if (!expr->output(0)->isA<TensorView>()) {
+      continue;
+    }
+    if (!expr->isOneOf<
+            UnaryOp,
+            BinaryOp,
+            TernaryOp,
+            LoadStoreOp,
+            BroadcastOp>()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          schedulerType(),
+          "Only pointwise ops are supported, found: ",
+          expr->getOpString());
+      return false;
+    }
+  }
+
+  if (registry_utils::hasNonUniqueBcast(fusion)) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        schedulerType(),
+        "Broadcasting dimension might be broadcasting to multiple sizes.");
+    return false;
+  }
+
+  // Connected fusions are left to the pointwise scheduler
+  auto components = getComponents(fusion);
+  if (components.size() < 2) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        schedulerType(), "Fusion has no independent subgraphs.");
+    return false;
+  }
+
+  ComponentDomainMap domain_map(fusion);
+  for (const auto& component : components) {
+    if (domain_map.findReferenceTensor(component) == nullptr) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          schedulerType(),
+          "Cannot find a reference tensor for the subgraph of ",
+          component.outputs.front()->toString());
+      return false;
+    }
+  }
+
+  // Too many tensors can't be passed to a single kernel. Such fusions are
+  // segmented into one kernel per subgraph instead.
+  if (estimateKernelParamBytes(fusion) > kMaxKernelParamBytes) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        schedulerType(), "Kernel arguments exceed the parameter space.");
+    return false;
+  }
+
+  return true;
+}
+
+std::unique_ptr<HeuristicParams> HorizontalScheduler::computeHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicDataCache* data_cache) {
+  FUSER_PERF_SCOPE("HorizontalScheduler::computeHeuristics");
+  auto hparams = std::make_unique<HorizontalParams>();
+  hparams->tag = "Horizontal heuristics";
+  hparams->cparams.index_type = runtime_info.getIndexType();
+
+  auto components = getComponents(fusion);
+  ComponentDomainMap domain_map(fusion);
+
+  // The grid is sized for the largest subgraph and capped at a full wave, so
+  // blocks loop over the chunks of larger subgraphs and skip the missing
+  // chunks of smaller ones.
+  int64_t max_num_chunks = 1;
+  for (const auto& component : components) {
+    TensorView* reference_tv = domain_map.findReferenceTensor(component);
+    NVF_ERROR(reference_tv != nullptr);
+
+    // The vectorization analysis is per reference, so it can't be cached
+    // across subgraphs
+    int64_t vectorization_factor = vectorize_helper::getVectorizationFactor(
+        runtime_info,
+        reference_tv,
+        /*data_cache=*/nullptr,
+        /*break_point=*/0,
+        scheduler_utils::maybeLogicalReorderAsAllocationMap(reference_tv));
+    hparams->vectorization_factors.push_back(vectorization_factor);
+
+    int64_t numel = 1;
+    for (auto id :
+         TensorDomain::noReductions(reference_tv->getLogicalDomain())) {
+      auto inferred_val =
+          runtime_info.expressionEvaluator().evaluate(id->extent());
+      NVF_ERROR(
+          inferred_val.hasValue(),
+          "Error inferring extent of: ",
+          id->toString());
+      numel *= inferred_val.as<int64_t>();
+    }
+    max_num_chunks = std::max(
+        max_num_chunks, ceilDiv(numel, hparams->bdimx * vectorization_factor));
+  }
+
+  const auto device_prop = at::cuda::getCurrentDeviceProperties();
+  const int64_t blocks_per_wave = (int64_t)device_prop->multiProcessorCount *
+      ((int64_t)device_prop->maxThreadsPerMultiProcessor / hparams->bdimx);
+  hparams->gdimx =
+      std::max(std::min(max_num_chunks, blocks_per_wave), (int64_t)1);
+
+  return hparams;
+}
+
+void HorizontalScheduler::schedule(
+    Fusion* fusion,
+    const HeuristicParams* params) {
+  FUSER_PERF_SCOPE("HorizontalScheduler::schedule");
+
+  FusionGuard fg(fusion);
+  const auto hparams = dynamic_cast<const HorizontalParams*>(params);
+  NVF_ERROR(
+      hparams != nullptr,
+      "Incorrect parameters sent to HorizontalScheduler::schedule",
+      params);
+
+  // Make sure we don't have global memory set on intermediate tensors from
+  // fusion segmentation
+  scheduler_utils::clearMemorySpace(fusion);
+
+  scheduler_utils::cacheInputs(fusion, true);
+  scheduler_utils::cacheAndForkOutputs(fusion, true);
+
+  refineCachePolicy(fusion);
+
+  // The caches are part of the subgraphs, so the subgraphs are collected
+  // after caching. Their order doesn't change since it follows the fusion
+  // outputs.
+  auto components = getComponents(fusion);
+  NVF_ERROR(
+      components.size() == hparams->vectorization_factors.size(),
+      "Expected ",
+      hparams->vectorization_factors.size(),
+      " independent subgraphs, found ",
+      components.size());
+  ComponentDomainMap domain_map(fusion);
+  for (auto i : c10::irange(components.size())) {
+    TensorView* reference_tv = domain_map.findReferenceTensor(components[i]);
+    NVF_ERROR(reference_tv != nullptr);
+    scheduleComponent(
+        reference_tv,
+        components[i].tvs,
+        hparams,
+        hparams->vectorization_factors[i]);
+  }
+
+  inlineMost();
+
+  markAliases(fusion);
+}
+
+} // namespace nvfuser
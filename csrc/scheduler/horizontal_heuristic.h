@@ -0,0 +1,76 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <c10/util/hash.h>
+#include <scheduler/heuristic.h>
+#include <utils.h>
+
+#include <sstream>
+#include <vector>
+
+namespace nvfuser {
+
+//! Parameters of the horizontal scheduler, which fuses independent
+//! pointwise subgraphs, e.g. the per-parameter updates of an optimizer step,
+//! into a single kernel. Every subgraph is flattened into chunks of
+//! bdimx * vectorization factor elements, and the gdimx blocks of the grid
+//! stride over the chunks of every subgraph.
+class HorizontalParams : public HeuristicParams {
+ public:
+  HorizontalParams() : HeuristicParams(SchedulerType::Horizontal) {};
+
+  int64_t bdimx = 128;
+
+  int64_t gdimx = 1;
+
+  // Vectorization factor of each subgraph, in the order of their first
+  // fusion output
+  std::vector<int64_t> vectorization_factors;
+
+  using HeuristicParams::HeuristicParams;
+
+  // Warning: Does not check launch parameters!
+  bool sameAs(const HeuristicParams* other_base) const override {
+    auto other = dynamic_cast<const HorizontalParams*>(other_base);
+    if (other == nullptr) {
+      return false;
+    }
+    bool attr_equal = other->cparams == cparams && other->bdimx == bdimx &&
+        other->gdimx == gdimx &&
+        other->vectorization_factors == vectorization_factors;
+    return attr_equal;
+  }
+
+  std::string toString() const override {
+    std::stringstream ss;
+    ss << "\n===== Horizontal Parameters ========\n"
+       << (tag.empty() ? "" : "Tag: ") << tag
+       << " Horizontal Characteristics:\n"
+       << " bdimx: " << bdimx << "\n"
+       << " gdimx: " << gdimx << "\n"
+       << " vectorization factors: "
+       << toDelimitedString(vectorization_factors) << "\n";
+    ss << "====================================\n";
+    return ss.str();
+  }
+
+  size_t hash() const override {
+    size_t attr_hash = c10::get_hash(bdimx, gdimx);
+    for (auto factor : vectorization_factors) {
+      hashCombine(attr_hash, static_cast<size_t>(factor));
+    }
+    return attr_hash;
+  }
+
+  std::unique_ptr<HeuristicParams> clone() const override {
+    return std::make_unique<HorizontalParams>(*this);
+  }
+};
+
+} // namespace nvfuser
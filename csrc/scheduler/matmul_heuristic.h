@@ -27,6 +27,13 @@ class MatmulParams : public HeuristicParams {
   //!  parallelization will be done.
   enum class TileRasterizationOrder { RowMajor = 0, ColumnMajor = 1 };
 
+  //! How the operand loads are circular buffered on Hopper+ devices.
+  //!  Pipelined: every warp group issues TMA loads and computes.
+  //!  WarpSpecialized: an extra producer warp group, the last TIDy index,
+  //!   issues TMA loads and signals mbarriers while the compute warp groups
+  //!   run wgmma.
+  enum class CircularBufferingStrategy { Pipelined = 0, WarpSpecialized = 1 };
+
   //! A wrapper for circular buffering config pieces
   struct CircularBufferOptions {
     bool circular_buffer_smem_write = false;
@@ -165,6 +172,11 @@ class MatmulParams : public HeuristicParams {
   //! Specify which tensor we circular buffer.
   CircularBufferOptions circular_buffer_options = {};
 
+  //! Specify the circular buffering strategy of operand loads. This parameter
+  //! is ignored on Ampere and Turing.
+  CircularBufferingStrategy circular_buffering_strategy =
+      CircularBufferingStrategy::Pipelined;
+
   //! Swizzle factor is used to increase L2 hit rate.
   //!  It horizontally squeezes the grid so that gridDim.x is larger and
   //!  gridDim.y is smaller.
@@ -201,6 +213,12 @@ class MatmulParams : public HeuristicParams {
        << (tag.empty() ? "" : "Tag: ") << tag << "\n"
        << "MMA macro: " << nvfuser::toString(mma_macro) << "\n"
        << circular_buffer_options.toString() << "\n"
+       << "Circular buffering strategy: "
+       << ((circular_buffering_strategy ==
+            CircularBufferingStrategy::WarpSpecialized)
+               ? "warp-specialized"
+               : "pipelined")
+       << "\n"
        << supported_vec_size.toString() << "\n"
        << nvfuser::toString(tile_sizes) << "\n"
        << "Async global mem load: "
@@ -239,7 +257,9 @@ class MatmulParams : public HeuristicParams {
         (nvfuser::hash(tile_sizes) << 3) ^
         (std::hash<size_t>{}(static_cast<size_t>(cta_order)) << 4) ^
         (std::hash<size_t>{}(grid_swizzle_factor) << 5) ^
-        (std::hash<size_t>{}(splitk_factor) << 6);
+        (std::hash<size_t>{}(splitk_factor) << 6) ^
+        (std::hash<size_t>{}(static_cast<size_t>(circular_buffering_strategy))
+         << 7);
     return attr_hash;
   }
 
@@ -253,6 +273,7 @@ class MatmulParams : public HeuristicParams {
         other->async_gmem_load_operands == async_gmem_load_operands &&
         other->tile_sizes == tile_sizes &&
         other->circular_buffer_options == circular_buffer_options &&
+        other->circular_buffering_strategy == circular_buffering_strategy &&
         other->supported_vec_size == supported_vec_size &&
         other->cta_order == cta_order &&
         other->grid_swizzle_factor == grid_swizzle_factor &&
@@ -65,6 +65,11 @@ inline std::optional<MmaMacro> getMmaOp(
     case 80:
     case 86:
     case 89:
+    // Blackwell runs the mma.sync macros of Ampere until the tcgen05 macros
+    // are supported by codegen
+    case 100:
+    case 103:
+    case 120:
       macro_encode.arch = MmaMacroEncode::Arch::Ampere;
       if ((n_extent % 16) == 0) {
         macro_encode.n = 16;
@@ -208,6 +213,28 @@ bool fillDefaultAmpereHeuristic(
   return true;
 }
 
+//! Returns a split-K factor that fills the SMs when the output tiles alone
+//! leave part of the only wave idle, as in skinny matmuls with a large K. Each
+//! split keeps at least min_k_tiles iterations of the main loop, so that the
+//! circular buffering pipeline can still be filled. The partial sums are
+//! reduced serially, so the factor is also capped to bound the latency of the
+//! reduction.
+int64_t getWaveFillingSplitKFactor(
+    int64_t num_tiles,
+    int64_t k_tiles,
+    int64_t num_sms,
+    int64_t min_k_tiles) {
+  constexpr int64_t max_splitk_factor = 16L;
+  if (num_tiles >= num_sms) {
+    return 1L;
+  }
+  const int64_t splitk_factor = std::min(
+      {num_sms / num_tiles,
+       k_tiles / std::max(min_k_tiles, 1L),
+       max_splitk_factor});
+  return std::max(splitk_factor, 1L);
+}
+
 bool fillDefaultHopperHeuristic(
     MatmulParams* mparams,
     const ProblemShape& problem_shape,
@@ -311,10 +338,22 @@ bool fillDefaultHopperHeuristic(
   // stages and async mem copy
   mparams->circular_buffer_options.smem_circular_buffer_stage = 8;
 
-  // TODO: We should take the main loop structure into account here to get a
-  // more accurate estimate in case of horizontal fusion
+  // Each operand is loaded once per stage, even if it is shared by several
+  // of the fused matmuls, like the activations of a gated MLP
+  const auto roleSmemPerStage = [&tensor_roles, &cta_tile](
+                                    MatmulTensorRole role,
+                                    int64_t tile_extent) -> int64_t {
+    const auto op_it = tensor_roles.find(role);
+    NVF_ERROR(op_it != tensor_roles.end());
+    int64_t smem = 0;
+    for (const TensorView* operand : op_it->second) {
+      smem += dataTypeSize(operand->dtype()) * tile_extent * cta_tile.k;
+    }
+    return smem;
+  };
   int64_t operand_smem_per_stage =
-      (int64_t)num_problems * 2 * (cta_tile.m + cta_tile.n) * cta_tile.k;
+      roleSmemPerStage(MatmulTensorRole::OPERAND_A, cta_tile.m) +
+      roleSmemPerStage(MatmulTensorRole::OPERAND_B, cta_tile.n);
   // We leave a bit of space for semaphores
   int64_t max_operand_smem =
       (int64_t)device_prop->sharedMemPerBlock - (1L << 7);
@@ -357,6 +396,20 @@ bool fillDefaultHopperHeuristic(
   // properly inline when we swizzle unmapped loop broadcasts
   mparams->grid_swizzle_factor = 1L;
 
+  // Split K to fill the SMs. The scheduler reduces the partial sums with
+  // a serial grid reduction, in a fixed order, so the result is bitwise
+  // deterministic.
+  if (isOptionEnabled(EnableOption::MatmulSplitK) && num_problems == 1 &&
+      problem_shape[(size_t)MatmulDimRole::Batch] == 1) {
+    int64_t Ktiles =
+        ceilDiv(problem_shape[(size_t)MatmulDimRole::K], cta_tile.k);
+    mparams->splitk_factor = (int)getWaveFillingSplitKFactor(
+        Mtiles * Ntiles,
+        Ktiles,
+        device_prop->multiProcessorCount,
+        mparams->circular_buffer_options.smem_circular_buffer_stage);
+  }
+
   // TODO: Finally, we set the CGA size
 
   return true;
@@ -481,9 +534,12 @@ std::string isMatmulFusionDefinitionSupported(
     }
 
     // Non-core input roles are optional, no requirements for definitions
-    entry = tensor_roles.find(MatmulTensorRole::EPILOGUE_INPUT);
-    if (entry != tensor_roles.end()) {
-      tvs_with_roles.insert(entry->second.begin(), entry->second.end());
+    for (MatmulTensorRole role :
+         {MatmulTensorRole::EPILOGUE_INPUT, MatmulTensorRole::PROLOGUE_INPUT}) {
+      entry = tensor_roles.find(role);
+      if (entry != tensor_roles.end()) {
+        tvs_with_roles.insert(entry->second.begin(), entry->second.end());
+      }
     }
 
     const auto in_out_tvs_count =
@@ -981,13 +1037,19 @@ std::unique_ptr<MatmulParams> getMatmulHeuristics(
   // Disable magic zero for matmul kernels
   mparams->cparams.enable_magic_zero = false;
 
-  // Set whether to use shared memory for epilogue
+  // Set whether to use shared memory for epilogue. The Hopper scheduler
+  // stages each fusion output, e.g., an activation and its pre-activation
+  // saved for backward, in its own buffer for a TMA store.
+  const int64_t num_epilogue_buffers = isHopper(mparams->mma_macro)
+      ? (int64_t)fusion->outputs().size()
+      : (int64_t)patterns.size();
   std::tie(mparams->use_smem_epilogue, mparams->promote_prologue_smem_reuse) =
       mma_utils::generateSharedMemoryEpilogueHeuristics(
           mparams->tile_sizes,
           mparams->circular_buffer_options.smem_circular_buffer_stage,
           tensor_roles,
-          /*ignore_occupancy_drop=*/true);
+          /*ignore_occupancy_drop=*/true,
+          num_epilogue_buffers);
   if (isHopper(mparams->mma_macro)) {
     // Always promote smem reuse for Hopper. This is needed because we use TMA
     // which has higher alignment requirements, so it's important that we place
@@ -1046,7 +1108,7 @@ std::string getMatmulCompileTimeRejectReason(Fusion* fusion) {
   {
     for (const mma_utils::MatmulPattern& pattern : patterns) {
       Expr* op = pattern.output->definition();
-      if (device_prop->major >= 9) {
+      if (device_prop->major == 9) {
         for (TensorView* operand : {pattern.A, pattern.B}) {
           if (!operand->isFusionInput() &&
               (operand->definition() == nullptr ||
@@ -1140,7 +1202,7 @@ std::string getMatmulRunTimeRejectReason(
     SchedulerRuntimeInfo& runtime_info) {
   const auto device_prop = at::cuda::getCurrentDeviceProperties();
 
-  if (device_prop->major >= 9 &&
+  if (device_prop->major == 9 &&
       runtime_info.getIndexType() != DataType::Int32) {
     // See https://github.com/NVIDIA/Fuser/issues/3595
     return "Hopper matmul is not yet supported with problem sizes requiring 64-bit indexing";
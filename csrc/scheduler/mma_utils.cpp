@@ -7,6 +7,7 @@
 // clang-format on
 
 #include <ATen/cuda/CUDAContext.h>
+#include <algorithm>
 
 #include <device_lower/utils.h>
 #include <id_model/id_model.h>
@@ -100,7 +101,8 @@ std::pair<bool, bool> generateSharedMemoryEpilogueHeuristics(
     const MmaDataTypes& data_types,
     bool smem_a_reuse_guaranteed,
     bool smem_b_reuse_guaranteed,
-    bool ignore_occupancy_drop) {
+    bool ignore_occupancy_drop,
+    const SharedMemoryBufferCounts& buffer_counts) {
   const size_t shared_memory_available = deviceAvailableSharedMemoryBytes();
 
   // We clip smem_circular_buffer_stage to 1 since we will always load operands
@@ -117,8 +119,11 @@ std::pair<bool, bool> generateSharedMemoryEpilogueHeuristics(
       /*circular_buffer_smem_read=*/true,
       smem_circular_buffer_stage};
 
-  const auto [smem_a, smem_b, smem_c] =
+  const auto [smem_a_per_buffer, smem_b_per_buffer, smem_c_per_buffer] =
       computeSharedMemorySizes(gemm_tile, circular_buffer_options, data_types);
+  const size_t smem_a = smem_a_per_buffer * buffer_counts.a;
+  const size_t smem_b = smem_b_per_buffer * buffer_counts.b;
+  const size_t smem_c = smem_c_per_buffer * buffer_counts.c;
 
   // NOTE: we can simply add these sizes since they should be integer multiples
   // of 16 bytes, so they will automatically be aligned. This may change with
@@ -198,7 +203,8 @@ std::pair<bool, bool> generateSharedMemoryEpilogueHeuristics(
     const MatMulTileOptions& gemm_tile,
     const int smem_circular_buffer_stage,
     const TensorRolesMap& tensor_roles,
-    const bool ignore_occupancy_drop) {
+    const bool ignore_occupancy_drop,
+    const int64_t num_epilogue_buffers) {
   auto data_types = getMmaDataTypes(tensor_roles);
   // getMmaDataTypes provides the dtypes of A, B, and OUTPUT.
   // These are the problem types that indicate the gmem IO. We use smem to load
@@ -233,10 +239,27 @@ std::pair<bool, bool> generateSharedMemoryEpilogueHeuristics(
   // cases, we check that there is no re-use when there is more than one use of
   // either a or b. If there are multiple uses we might wind up re-using memory,
   // but in that case the calculation below will be overly conservative.
-  const TensorView* a = getOperandTv(tensor_roles, MatmulTensorRole::OPERAND_A);
-  const TensorView* b = getOperandTv(tensor_roles, MatmulTensorRole::OPERAND_B);
-  bool smem_a_reuse_guaranteed = a->uses().size() == 1;
-  bool smem_b_reuse_guaranteed = b->uses().size() == 1;
+  //
+  // When several matmuls are fused, each operand has its own smem buffer and
+  // the reuse of a role is only guaranteed if it is for all of its operands.
+  // An operand used by more than one of the matmuls, like the activations of
+  // a gated MLP, is not reused for the epilogue, but it is loaded once.
+  const auto roleOperands = [&tensor_roles](MatmulTensorRole role) {
+    // getOperandTv checks that the role has operands
+    getOperandTv(tensor_roles, role);
+    return tensor_roles.at(role);
+  };
+  const auto hasSingleUses = [](const std::vector<TensorView*>& operands) {
+    return std::all_of(operands.begin(), operands.end(), [](TensorView* tv) {
+      return tv->uses().size() == 1;
+    });
+  };
+  const std::vector<TensorView*>& as =
+      roleOperands(MatmulTensorRole::OPERAND_A);
+  const std::vector<TensorView*>& bs =
+      roleOperands(MatmulTensorRole::OPERAND_B);
+  bool smem_a_reuse_guaranteed = hasSingleUses(as);
+  bool smem_b_reuse_guaranteed = hasSingleUses(bs);
 
   return generateSharedMemoryEpilogueHeuristics(
       gemm_tile,
@@ -244,7 +267,8 @@ std::pair<bool, bool> generateSharedMemoryEpilogueHeuristics(
       data_types,
       smem_a_reuse_guaranteed,
       smem_b_reuse_guaranteed,
-      ignore_occupancy_drop);
+      ignore_occupancy_drop,
+      {(int64_t)as.size(), (int64_t)bs.size(), num_epilogue_buffers});
 }
 
 void scheduleWarpTileWithReduction(
@@ -1450,6 +1474,33 @@ TensorRolesMapOpt getTensorRoles(
     return has;
   };
 
+  // Whether all uses of tv reach a tensor with a K dimension, i.e., a tensor
+  // of the prologue, before reaching one with an N dimension. The epilogue
+  // begins after the K dimension is reduced, so tv is not used there.
+  const auto isOnlyUsedInPrologue = [&findDims](TensorView* tv) {
+    std::vector<TensorView*> to_visit = {tv};
+    while (!to_visit.empty()) {
+      TensorView* producer = to_visit.back();
+      to_visit.pop_back();
+      const std::vector<TensorView*> consumers =
+          ir_utils::consumerTvsOf(producer);
+      if (consumers.empty()) {
+        return false;
+      }
+      for (TensorView* consumer : consumers) {
+        DimPresence has = findDims(consumer);
+        if (has.k) {
+          continue;
+        }
+        if (has.n || has.unmapped) {
+          return false;
+        }
+        to_visit.push_back(consumer);
+      }
+    }
+    return true;
+  };
+
   for (TensorView* tv : mma_input_candidates) {
     DimPresence has = findDims(tv);
     if (has.unmapped) {
@@ -1460,6 +1511,8 @@ TensorRolesMapOpt getTensorRoles(
       tensor_roles
           [has.m ? MatmulTensorRole::OPERAND_A : MatmulTensorRole::OPERAND_B]
               .push_back(tv);
+    } else if (has.m && !has.n && isOnlyUsedInPrologue(tv)) {
+      tensor_roles[MatmulTensorRole::PROLOGUE_INPUT].push_back(tv);
     } else {
       tensor_roles[MatmulTensorRole::EPILOGUE_INPUT].push_back(tv);
       continue;
@@ -399,11 +399,25 @@ TensorRolesMapOpt getTensorRoles(
 //!
 //! Returns true in the second position if reusing shared memory for the
 //!  epilogue does not increase occupancy.
+//!
+//! num_epilogue_buffers is the number of tiles staged in shared memory by the
+//!  epilogue, one per matmul result on Ampere and one per fusion output on
+//!  Hopper, where each output is written with its own TMA store.
 std::pair<bool, bool> generateSharedMemoryEpilogueHeuristics(
     const MatMulTileOptions& gemm_tile,
     const int smem_circular_buffer_stage,
     const TensorRolesMap& tensor_roles,
-    bool ignore_occupancy_drop = false);
+    bool ignore_occupancy_drop = false,
+    int64_t num_epilogue_buffers = 1);
+
+//! Number of shared memory buffers of each of smem_a, smem_b, and smem_c in a
+//!  kernel fusing several matmuls. An operand shared by the matmuls, like the
+//!  activations of the two matmuls of a gated MLP, is loaded once.
+struct SharedMemoryBufferCounts {
+  int64_t a = 1;
+  int64_t b = 1;
+  int64_t c = 1;
+};
 
 //! This version assumes roles_map has been analyzed to determine smem datatypes
 //! as well as guarantees about prologue smem reuse.
@@ -413,7 +427,8 @@ NVF_API std::pair<bool, bool> generateSharedMemoryEpilogueHeuristics(
     const MmaDataTypes& data_types,
     bool smem_a_reuse_guaranteed = false,
     bool smem_b_reuse_guaranteed = false,
-    bool ignore_occupancy_drop = false);
+    bool ignore_occupancy_drop = false,
+    const SharedMemoryBufferCounts& buffer_counts = {});
 
 //! Compute the amount of shared memory we expect to need. The actual amount
 //! allocated will be determined by aliasing (see alias_memory.cpp). This
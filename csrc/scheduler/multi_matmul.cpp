@@ -131,6 +131,10 @@ void scheduleMultipleMatmuls(Fusion* fusion, const MatmulParams* params) {
     AmpereMultipleMatmulScheduler(fusion, params).run();
   } else if (cc >= 90 && cc < 100) {
     HopperMultipleMatmulScheduler(fusion, params).run();
+  } else if (cc >= 100 && isAmpere(params->mma_macro)) {
+    // Blackwell runs the mma.sync macros of Ampere until the tcgen05 macros
+    // are supported by codegen
+    AmpereMultipleMatmulScheduler(fusion, params).run();
   } else {
     NVF_THROW(
         "The matrix multiplication scheduler is unavailable for this device: ",
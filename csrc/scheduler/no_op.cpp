@@ -113,6 +113,8 @@ std::unique_ptr<HeuristicParams> NoOpScheduler::computeHeuristics(
     HeuristicDataCache* data_cache) {
   auto params = std::make_unique<HeuristicParams>(SchedulerType::NoOp);
   params->cparams.index_type = runtime_info.getIndexType();
+  // Nothing is compiled, so the params are the same for any input shape
+  params->validity_region = HeuristicValidityRegion{};
   return params;
 }
 
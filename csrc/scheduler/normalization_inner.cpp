@@ -6,7 +6,9 @@
  */
 // clang-format on
 #include <instrumentation.h>
+#include <options.h>
 #include <scheduler/debug_utils.h>
+#include <scheduler/heuristic_plugin.h>
 #include <scheduler/normalization_inner.h>
 #include <scheduler/normalization_utils.h>
 #include <scheduler/reduction_utils.h>
@@ -16,6 +18,8 @@
 
 #include <ATen/cuda/CUDAContext.h>
 
+#include <optional>
+
 namespace nvfuser {
 using PersistentKernelProperties =
     normalization_scheduler_utils::PersistentKernelProperties;
@@ -61,6 +65,23 @@ std::pair<int64_t, int64_t> getPersistentBufferSize(
       persistent_buffer_size, available_persistent_buffer_size);
 }
 
+// Number of blocks each row is split across by the grid persistent
+// heuristic. Each block owns an SM, so that all blocks of the cooperative
+// launch are co-resident, and holds its part of the row in registers.
+// Returns std::nullopt if the blocks of all rows don't fit in one wave.
+std::optional<int64_t> getGridPersistentBlocksPerRow(
+    const int64_t persistent_buffer_size,
+    const int64_t total_iteration_numel) {
+  const int64_t blocks_per_row =
+      ceilDiv(persistent_buffer_size, scheduler_utils::register_file_size);
+  const int64_t device_multiprocessor_count =
+      (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+  if (blocks_per_row * total_iteration_numel > device_multiprocessor_count) {
+    return std::nullopt;
+  }
+  return blocks_per_row;
+}
+
 // Return the maximum register count each thread can use and achieved occupancy.
 // We always guarantee the returned register count is at least as large as the
 // buffer+overhead estimate. We meet the desired occupancy but don't try to
@@ -158,6 +179,9 @@ struct NormInnerParams {
   int64_t occupancy = -1;
   int64_t n_persistent_tails = -1;
   bool is_pad_bdimx = false;
+  // Whether each row is reduced with warp shuffles, either over whole warps
+  // or over segments of a warp holding several rows
+  bool is_warp_shuffle_bdimx = false;
   void print() const {
     std::cout << "bdimx: " << bdimx << ", bdimy: " << bdimy
               << ", padded_bdimx: " << padded_bdimx
@@ -166,7 +190,9 @@ struct NormInnerParams {
               << ", non_buffer_registers: " << non_buffer_registers
               << ", occupancy: " << occupancy
               << ", n_persistent_tails: " << n_persistent_tails
-              << ", is_pad_bdimx: " << is_pad_bdimx << std::endl;
+              << ", is_pad_bdimx: " << is_pad_bdimx
+              << ", is_warp_shuffle_bdimx: " << is_warp_shuffle_bdimx
+              << std::endl;
   }
 };
 
@@ -202,6 +228,9 @@ NormInnerParams getNormInnerParamsGivenPerisisentBatchSize(
       : params.bdimx + (device_warp_size - params.bdimx % device_warp_size);
   params.is_pad_bdimx = params.bdimx > 16 &&
       params.padded_bdimx * params.bdimy <= max_threads_per_block;
+  params.is_warp_shuffle_bdimx = params.is_pad_bdimx ||
+      params.bdimx % device_warp_size == 0 ||
+      device_warp_size % params.bdimx == 0;
 
   // calculate register per thread and achieved occupancy
   int64_t threads_per_block = params.is_pad_bdimx
@@ -262,6 +291,15 @@ bool compareTwoHeuristics(
     return score > 0;
   }
 
+  // prefer block dims whose rows are reduced with warp shuffles, e.g., 8
+  // threads per row rather than 10 for small rows, so that a warp reduces 4
+  // rows without shared memory or block syncs
+  score = compare(
+      params_a.is_warp_shuffle_bdimx, params_b.is_warp_shuffle_bdimx);
+  if (score != 0) {
+    return score > 0;
+  }
+
   // Ensure the count of non buffer registers is larger than the min overhead.
   // But don't want to achieve this goal at the cost of using a very large block
   // size, it avoids using a small persistent batch with a large block size,
@@ -295,11 +333,13 @@ bool compareTwoHeuristics(
 //         Ensures minimum required occupancy is surpassed.
 //     (b) Prefer divisible by persistent batch size.
 //         Aims for even workload distribution.
-//     (c) Prefer non buffer register exceeds min overhead.
+//     (c) Prefer rows reduced with warp shuffles.
+//         Packs several small rows per warp instead of syncing the block.
+//     (d) Prefer non buffer register exceeds min overhead.
 //         Maximizes compiler optimization potential.
-//     (d) Seek larger occupancy.
+//     (e) Seek larger occupancy.
 //         Exceeds the target minimum for better performance.
-//     (e) Use large persistent batch size as a tiebreaker.
+//     (f) Use large persistent batch size as a tiebreaker.
 //         Use more registers for persistent buffers.
 // This sequence ensures meeting target occupancy, promotes even workload
 // distribution, enhances register optimization, and prefers higher occupancy.
@@ -411,6 +451,11 @@ void innerPersistentHeuristic2D(
 
   // Fill in the reduction params
   rparams->cparams.maxrregcount = best_heuristic.register_per_thread;
+  const int64_t threads_per_block = best_heuristic.is_pad_bdimx
+      ? best_heuristic.padded_bdimx * best_heuristic.bdimy
+      : best_heuristic.bdimx * best_heuristic.bdimy;
+  rparams->cparams.target_blocks_per_sm = std::max<int64_t>(
+      1, best_heuristic.occupancy * threads_per_warp / threads_per_block);
 
   // Inner reduction domain
   rparams->cross_block_inner_reduction = true;
@@ -491,6 +536,47 @@ void innerPersistentHeuristicSharedMemory(
       LaunchParams::UNINITIALIZED_VAL);
 }
 
+// Rows too long for a block are split across blocks_per_row blocks of the
+// grid. The partial reductions, including Welford states, are combined with
+// the cooperative grid allreduce before the normalization reads the
+// persistent buffers again.
+void innerPersistentHeuristicGrid(
+    const PersistentKernelProperties& properties,
+    const int64_t blocks_per_row,
+    ReductionParams* rparams) {
+  const auto dev_prop = at::cuda::getCurrentDeviceProperties();
+  const int64_t vectorize_factor = properties.vectorize_factor;
+  // One block per SM, so a block may use the whole register file
+  const int64_t bdimx =
+      std::min((int64_t)dev_prop->maxThreadsPerBlock, (int64_t)512);
+  const int64_t elements_per_block =
+      ceilDiv(properties.total_reduction_numel, blocks_per_row);
+  const int64_t persistent_batch =
+      ceilDiv(elements_per_block, vectorize_factor * bdimx);
+
+  rparams->cparams.maxrregcount = getRegPerThreadGivenThreadsPerSM(bdimx);
+  rparams->cross_block_inner_reduction = true;
+  rparams->block_dim_inner_reduction = ParallelType::TIDx;
+  rparams->pad_inner_reduction_to_warp = true;
+  rparams->cross_grid_inner_reduction = true;
+  rparams->grid_dim_inner_reduction = ParallelType::BIDx;
+  rparams->batches_per_block_inner_reduction = persistent_batch;
+  rparams->unroll_factor_inner_reduction = vectorize_factor;
+  rparams->vectorize_inner_reduction = vectorize_factor > 1;
+
+  // Iter
+  rparams->multiple_reds_per_blk = false;
+  rparams->grid_dim_iter_dom = ParallelType::BIDy;
+  rparams->unroll_factor_iter_dom = 1;
+  rparams->lparams = LaunchParams(
+      blocks_per_row,
+      LaunchParams::UNINITIALIZED_VAL,
+      LaunchParams::UNINITIALIZED_VAL,
+      LaunchParams::UNINITIALIZED_VAL,
+      LaunchParams::UNINITIALIZED_VAL,
+      LaunchParams::UNINITIALIZED_VAL);
+}
+
 // TODO: clean and revise the heuristics
 void innerPersistentHeuristic3D(
     const PersistentKernelProperties& properties,
@@ -998,8 +1084,29 @@ std::unique_ptr<ReductionParams> getInnerPersistentHeuristics(
   rparams->project_persistent_buffers = prop.project_persistent_buffers;
   rparams->cparams.index_type = prop.index_type;
 
+  // Rows that don't fit in the registers and shared memory of a block are
+  // split across the grid, see canScheduleRunTime
+  std::optional<int64_t> grid_blocks_per_row;
+  if (isOptionEnabled(EnableOption::GridPersistentNormalization) &&
+      prop.total_reduction_numel == prop.inner_most_dimension_numel &&
+      prop.max_persistent_buffer_size >
+          normalization_scheduler_utils::
+              getMaxRegOrSharedMemorySizeForPersistentBuffer(
+                  runtime_info, prop.persistent_buffers, true)) {
+    grid_blocks_per_row = getGridPersistentBlocksPerRow(
+        prop.max_persistent_buffer_size, prop.total_iteration_numel);
+    NVF_ERROR(
+        grid_blocks_per_row.has_value(),
+        "Rows don't fit in a grid persistent kernel.");
+  }
+
   // specific heuristics for different cases
-  if (prop.max_persistent_buffer_size > scheduler_utils::register_file_size) {
+  if (grid_blocks_per_row.has_value()) {
+    rparams->tag = "Grid Inner Persistent Heuristic.\n";
+    innerPersistentHeuristicGrid(
+        prop, grid_blocks_per_row.value(), rparams.get());
+  } else if (
+      prop.max_persistent_buffer_size > scheduler_utils::register_file_size) {
     rparams->tag = "Shared Memory Inner Persistent Heuristic.\n";
     // all persistent buffers are moved to shared memory
     // TODO: allow only part of the buffers to be moved to shared memory
@@ -1065,6 +1172,20 @@ bool InnerPersistentKernelScheduler::canScheduleRunTime(
       (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
 
   if (persistent_buffer_size > available_persistent_buffer_size) {
+    // Rows too long for a block may be split across the blocks of a grid,
+    // which are co-resident, so the checks on the number of blocks below
+    // don't apply
+    if (can_use_smem_persistent &&
+        isOptionEnabled(EnableOption::GridPersistentNormalization)) {
+      if (!getGridPersistentBlocksPerRow(
+               persistent_buffer_size, properties.total_iteration_numel)
+               .has_value()) {
+        scheduler_debug_utils::canScheduleRejectReason(
+            schedulerType(), "rows don't fit in a grid persistent kernel.");
+        return false;
+      }
+      return true;
+    }
     scheduler_debug_utils::canScheduleRejectReason(
         schedulerType(),
         can_use_smem_persistent
@@ -1116,6 +1237,8 @@ std::unique_ptr<HeuristicParams> InnerPersistentKernelScheduler::
   FUSER_PERF_SCOPE("InnerPersistentKernelScheduler::computeHeuristics");
   auto rparams = getInnerPersistentHeuristics(fusion, runtime_info, data_cache);
   NVF_ERROR(rparams != nullptr);
+  heuristic_plugin::updateHeuristicParams(
+      rparams.get(), fusion, runtime_info, data_cache);
   return rparams;
 }
 
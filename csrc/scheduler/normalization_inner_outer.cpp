@@ -6,7 +6,9 @@
  */
 // clang-format on
 #include <instrumentation.h>
+#include <options.h>
 #include <scheduler/debug_utils.h>
+#include <scheduler/heuristic_plugin.h>
 #include <scheduler/normalization_inner_outer.h>
 #include <scheduler/normalization_utils.h>
 #include <scheduler/reduction_utils.h>
@@ -119,6 +121,57 @@ int64_t partialOuterReductionBufferSize(
   return partial_reduction_buffer_size;
 }
 
+// Size of the rows of the inputs shared by the inner and outer reductions.
+// Without persistent buffers, a block still holds a row of them in registers
+// while both reductions consume it.
+int64_t sharedInputRowSize(
+    const std::vector<TensorView*>& reduction_tvs,
+    SchedulerRuntimeInfo& runtime_info) {
+  std::unordered_set<TensorView*> inner_inputs;
+  TensorView* outer_reduction_tv = nullptr;
+  for (auto tv : reduction_tvs) {
+    if (scheduler_utils::isFastestDimReduction(tv)) {
+      auto inputs = ir_utils::inputTvsOf(tv);
+      inner_inputs.insert(inputs.begin(), inputs.end());
+    } else if (outer_reduction_tv == nullptr) {
+      outer_reduction_tv = tv;
+    }
+  }
+  if (outer_reduction_tv == nullptr) {
+    return 0;
+  }
+
+  // The iteration domains of an outer reduction span a row
+  int64_t row_numel = 1;
+  for (auto id : outer_reduction_tv->getLogicalDomain()) {
+    if (id->isReduction() || id->isBroadcast()) {
+      continue;
+    }
+    auto id_size = runtime_info.expressionEvaluator().evaluate(id->extent());
+    NVF_ERROR(id_size.hasValue(), "Could not infer the size of a row.");
+    row_numel *= id_size.as<int64_t>();
+  }
+
+  std::unordered_set<TensorView*> shared_inputs;
+  for (auto tv : reduction_tvs) {
+    if (scheduler_utils::isFastestDimReduction(tv)) {
+      continue;
+    }
+    for (auto input : ir_utils::inputTvsOf(tv)) {
+      if (inner_inputs.count(input)) {
+        shared_inputs.insert(input);
+      }
+    }
+  }
+  int64_t row_size = 0;
+  for (auto input : shared_inputs) {
+    row_size += row_numel *
+        (int64_t)dataTypeSize(input->getDataType().value(),
+                              runtime_info.getIndexType());
+  }
+  return row_size;
+}
+
 // Decide where to store persistent buffers.
 // By default, they reside in registers.
 // If register space runs low but there's ample shared memory,
@@ -279,6 +332,10 @@ PersistentBufferStorageParams getPersistentBufferStorageParams(
   buffer_params.smem_buffer_size = total_smem_buffer_size;
   buffer_params.regs_buffer_size =
       partialOuterReductionBufferSize(reduction_tvs, runtime_info);
+  if (persistent_buffer_info.persistent_buffers.empty()) {
+    buffer_params.regs_buffer_size +=
+        sharedInputRowSize(reduction_tvs, runtime_info);
+  }
   if (buffer_params.regs_buffer_size <= available_regs &&
       buffer_params.smem_buffer_size <= available_smem) {
     buffer_params.smem_persistent_buffers = buffers;
@@ -299,45 +356,34 @@ PersistentBufferStorageParams getPersistentBufferStorageParams(
   if (!outer_broadcast_tvs.empty()) {
     buffers = sortProjectableBufferInputs(buffers, outer_broadcast_tvs);
   }
-  // (2.2) Before this loop, all cached input buffers are in shared memory. Move
-  // buffer from shared memory to register.
-  int64_t n_regs_buffer = -1;
-  const int n_buffers = (int)buffers.size();
-  for (int i = 0; i < n_buffers; i++) {
-    auto current_tv = buffers[i];
-    auto [buffer_size_regs, buffer_size_smem] =
-        required_size_regs_smem_map.at(current_tv);
-    buffer_params.regs_buffer_size += buffer_size_regs;
-    buffer_params.smem_buffer_size -= buffer_size_smem;
-
-    // The first-i buffers to are moved from shared memory to register
-    // If both the register buffer size and shared memory buffer size are within
-    // the allowable limit, we found a good configuration.
-    if (buffer_params.regs_buffer_size <= available_regs &&
-        buffer_params.smem_buffer_size <= available_smem) {
-      n_regs_buffer = i + 1;
-      break;
-    }
-    // Register buffer size exceeds the limit, can't move more to registers.
-    // Break the loop.
-    if (buffer_params.regs_buffer_size > available_regs) {
-      break;
-    }
+  // (2.2) All cached input buffers are in shared memory. Move some of them to
+  // registers so that the combined capacity of registers and shared memory
+  // holds all of them.
+  std::vector<std::pair<int64_t, int64_t>> buffer_sizes;
+  buffer_sizes.reserve(buffers.size());
+  for (auto buffer : buffers) {
+    buffer_sizes.push_back(required_size_regs_smem_map.at(buffer));
+  }
+  auto in_regs = normalization_scheduler_utils::selectRegisterPersistentBuffers(
+      buffer_sizes,
+      buffer_params.regs_buffer_size,
+      available_regs,
+      available_smem);
+  if (!in_regs.has_value()) {
+    buffer_params.has_enough_regs_and_smem = false;
+    return buffer_params;
   }
 
-  // n_regs_buffer > 0 indicats a good configuration is found.
-  // The first n_regs_buffer buffers are stored in registers and last [n_buffers
-  // - n_regs_buffer] are stored in shared memory.
-  if (n_regs_buffer > 0) {
-    buffer_params.has_enough_regs_and_smem = true;
-    auto n_smem_buffer = n_buffers - n_regs_buffer;
-    buffer_params.smem_persistent_buffers.reserve(n_smem_buffer);
-    for (int i = 0; i < n_smem_buffer; i++) {
-      buffer_params.smem_persistent_buffers.emplace_back(
-          buffers[n_buffers - 1 - i]);
+  // The buffers not moved to registers are stored in shared memory
+  buffer_params.has_enough_regs_and_smem = true;
+  for (int64_t i = (int64_t)buffers.size() - 1; i >= 0; i--) {
+    auto [buffer_size_regs, buffer_size_smem] = buffer_sizes.at(i);
+    if (in_regs->at(i)) {
+      buffer_params.regs_buffer_size += buffer_size_regs;
+      buffer_params.smem_buffer_size -= buffer_size_smem;
+    } else {
+      buffer_params.smem_persistent_buffers.emplace_back(buffers.at(i));
     }
-  } else {
-    buffer_params.has_enough_regs_and_smem = false;
   }
   return buffer_params;
 }
@@ -829,7 +875,8 @@ std::unique_ptr<ReductionParams> getInnerOuterPersistentHeuristics(
 
   auto& persistent_buffer_info = persistent_buffer_info_entry.get();
   NVF_ERROR(
-      !persistent_buffer_info.persistent_buffers.empty(),
+      !persistent_buffer_info.persistent_buffers.empty() ||
+          isOptionEnabled(EnableOption::CombinedInnerOuterReduction),
       "Persistent scheduler requires persistent buffers.");
   auto buffer_params = getPersistentBufferStorageParams(
       fusion,
@@ -1285,9 +1332,12 @@ bool InnerOuterPersistentKernelScheduler::canScheduleCompileTime(
     return false;
   }
 
-  // Only accept persistent kernels
+  // Only accept persistent kernels, unless the inner and outer reductions
+  // are combined to read their shared input once, e.g. the row and column
+  // sums of a matrix
   auto persistent_buffer_info = scheduler_utils::persistentBuffers(fusion);
-  if (persistent_buffer_info.persistent_buffers.empty()) {
+  if (persistent_buffer_info.persistent_buffers.empty() &&
+      !isOptionEnabled(EnableOption::CombinedInnerOuterReduction)) {
     scheduler_debug_utils::canScheduleRejectReason(
         schedulerType(), "no persistent buffer identified");
     return false;
@@ -1423,6 +1473,8 @@ std::unique_ptr<HeuristicParams> InnerOuterPersistentKernelScheduler::
   auto rparams =
       getInnerOuterPersistentHeuristics(fusion, runtime_info, data_cache);
   NVF_ERROR(rparams != nullptr);
+  heuristic_plugin::updateHeuristicParams(
+      rparams.get(), fusion, runtime_info, data_cache);
   return rparams;
 }
 
@@ -8,6 +8,7 @@
 #include <instrumentation.h>
 #include <scheduler/cache_policy_refiner.h>
 #include <scheduler/debug_utils.h>
+#include <scheduler/heuristic_plugin.h>
 #include <scheduler/normalization_outer.h>
 #include <scheduler/normalization_utils.h>
 #include <scheduler/reduction_utils.h>
@@ -662,6 +663,8 @@ std::unique_ptr<HeuristicParams> OuterPersistentKernelScheduler::
   FUSER_PERF_SCOPE("OuterPersistentKernelScheduler::computeHeuristics");
   auto rparams = getOuterPersistentHeuristics(fusion, runtime_info, data_cache);
   NVF_ERROR(rparams != nullptr);
+  heuristic_plugin::updateHeuristicParams(
+      rparams.get(), fusion, runtime_info, data_cache);
   return rparams;
 }
 
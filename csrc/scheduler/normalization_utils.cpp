@@ -20,6 +20,8 @@
 
 #include <ATen/cuda/CUDAContext.h>
 
+#include <limits>
+
 namespace nvfuser {
 namespace normalization_scheduler_utils {
 
@@ -716,6 +718,65 @@ void checkReductionTvForScheduling(Fusion* fusion, TensorView* ref_red_tv) {
       "Tried to schedule a fusion with no tensor inputs, currently not supported.");
 }
 
+std::optional<std::vector<bool>> selectRegisterPersistentBuffers(
+    const std::vector<std::pair<int64_t, int64_t>>& buffer_sizes,
+    int64_t regs_buffer_size,
+    int64_t available_regs,
+    int64_t available_smem) {
+  const int64_t n_buffers = (int64_t)buffer_sizes.size();
+  int64_t smem_buffer_size = 0;
+  for (const auto& [size_regs, size_smem] : buffer_sizes) {
+    smem_buffer_size += size_smem;
+  }
+
+  // Move the buffers to registers in order, as long as registers are left
+  std::vector<bool> in_regs(n_buffers, false);
+  int64_t prefix_regs = regs_buffer_size;
+  int64_t prefix_smem = smem_buffer_size;
+  for (const auto i : c10::irange(n_buffers)) {
+    if (prefix_regs <= available_regs && prefix_smem <= available_smem) {
+      return in_regs;
+    }
+    prefix_regs += buffer_sizes.at(i).first;
+    prefix_smem -= buffer_sizes.at(i).second;
+    if (prefix_regs > available_regs) {
+      break;
+    }
+    in_regs.at(i) = true;
+  }
+  if (prefix_regs <= available_regs && prefix_smem <= available_smem) {
+    return in_regs;
+  }
+
+  // Fall back to the subset with the fewest register bytes. There are only a
+  // handful of persistent buffers in practice, so enumerating is cheap.
+  constexpr int64_t max_enumerated_buffers = 16;
+  if (n_buffers > max_enumerated_buffers) {
+    return std::nullopt;
+  }
+  std::optional<std::vector<bool>> best;
+  int64_t best_regs = std::numeric_limits<int64_t>::max();
+  for (int64_t mask = 1; mask < ((int64_t)1 << n_buffers); ++mask) {
+    int64_t subset_regs = regs_buffer_size;
+    int64_t subset_smem = smem_buffer_size;
+    for (const auto i : c10::irange(n_buffers)) {
+      if (mask & ((int64_t)1 << i)) {
+        subset_regs += buffer_sizes.at(i).first;
+        subset_smem -= buffer_sizes.at(i).second;
+      }
+    }
+    if (subset_regs <= available_regs && subset_smem <= available_smem &&
+        subset_regs < best_regs) {
+      best_regs = subset_regs;
+      best = std::vector<bool>(n_buffers);
+      for (const auto i : c10::irange(n_buffers)) {
+        best->at(i) = mask & ((int64_t)1 << i);
+      }
+    }
+  }
+  return best;
+}
+
 int64_t getMaxRegOrSharedMemorySizeForPersistentBuffer(
     SchedulerRuntimeInfo& runtime_info,
     const std::vector<TensorView*>& persistent_buffers,
@@ -13,6 +13,7 @@
 #include <scheduler/reduction_utils.h>
 #include <scheduler/scheduler_types.h>
 #include <scheduler/utils.h>
+#include <visibility.h>
 #include <cmath>
 #include <optional>
 #include <ostream>
@@ -286,6 +287,23 @@ int64_t getMaxRegOrSharedMemorySizeForPersistentBuffer(
     const std::vector<TensorView*>& persistent_buffers,
     const bool can_use_smem_persistent);
 
+// Picks the persistent buffers to move from shared memory to registers when
+// they don't all fit in shared memory. buffer_sizes holds the register and
+// shared memory sizes of each buffer, and regs_buffer_size the register bytes
+// already used by other buffers. Returns a mask of the buffers to keep in
+// registers, or std::nullopt if no choice fits both limits.
+//
+// The shortest prefix of buffer_sizes that fits is preferred, so callers order
+// the buffers by how much they'd rather keep them in registers. When no prefix
+// fits, e.g. because one large buffer overflows the registers while a smaller
+// one later in the list would do, every subset is considered and the one with
+// the fewest register bytes wins.
+NVF_API std::optional<std::vector<bool>> selectRegisterPersistentBuffers(
+    const std::vector<std::pair<int64_t, int64_t>>& buffer_sizes,
+    int64_t regs_buffer_size,
+    int64_t available_regs,
+    int64_t available_smem);
+
 // Returns true if persistent buffers are projected to inputs, meaning the
 // inputs are cached instead of the persistent buffers. The decision of
 // projection is primarily based on the required sizes of the two cases --
@@ -11,6 +11,7 @@
 #include <instrumentation.h>
 #include <ir/printer.h>
 #include <multidevice/utils.h>
+#include <options.h>
 #include <scheduler/cache_policy_refiner.h>
 #include <scheduler/debug_utils.h>
 #include <scheduler/mark_aliases.h>
@@ -29,6 +30,63 @@ namespace {
 // Unused at the moment, commenting for clang tidy
 constexpr int64_t kThreadX = 128;
 
+// Elements of the 1D TMA box loaded per CTA, the largest box dimension TMA
+// supports. Each thread of the CTA computes one element of the box.
+constexpr int64_t kTmaTileSize = 256;
+
+// TMA boxes streamed by each CTA of the circular buffered TMA schedule, and
+// the number of shared memory buffers they cycle through
+constexpr int64_t kTmaTilesPerCta = 8;
+constexpr int64_t kTmaCircularBufferStages = 4;
+
+// Whether to load inputs with TMA, which Hopper issues as bulk copies without
+// spending registers on the loaded data. Worth it only when there are enough
+// boxes to fill the GPU and every candidate input is 16B aligned.
+bool shouldUseTmaLoad(
+    Fusion* fusion,
+    TensorView* reference_tv,
+    SchedulerRuntimeInfo& runtime_info,
+    int64_t n_elems) {
+  if (!isOptionEnabled(EnableOption::TmaPointwise) ||
+      at::cuda::getCurrentDeviceProperties()->major < 9 ||
+      runtime_info.getIndexType() != DataType::Int32) {
+    return false;
+  }
+  const int64_t device_multiprocessor_count =
+      (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+  if (n_elems < device_multiprocessor_count * kTmaTileSize * 8) {
+    return false;
+  }
+  std::vector<TensorView*> tma_inputs =
+      pointwise_utils::getTmaLoadableInputs(fusion, reference_tv);
+  return !tma_inputs.empty() &&
+      std::all_of(tma_inputs.begin(), tma_inputs.end(), [&](TensorView* tv) {
+           return runtime_info.getAlignmentSize(tv) >= 16;
+         });
+}
+
+// Turns the cached inputs that can be loaded with TMA into shared memory
+// tensors written by cp.async.bulk.tensor. Returns the converted caches.
+std::vector<TensorView*> setUpTmaLoads(
+    Fusion* fusion,
+    const std::vector<TensorView*>& cached_inputs) {
+  std::vector<TensorView*> tma_inputs = pointwise_utils::getTmaLoadableInputs(
+      fusion, pointwise_utils::getReferenceTensor(fusion));
+  std::vector<TensorView*> tma_tvs;
+  for (TensorView* cached_input : cached_inputs) {
+    auto* ldst = dynamic_cast<LoadStoreOp*>(cached_input->definition());
+    if (ldst == nullptr ||
+        std::find(tma_inputs.begin(), tma_inputs.end(), ldst->in()) ==
+            tma_inputs.end()) {
+      continue;
+    }
+    ldst->setOpType(LoadStoreOpType::CpAsyncBulkTensorTile);
+    cached_input->setMemoryType(MemoryType::Shared);
+    tma_tvs.push_back(cached_input);
+  }
+  return tma_tvs;
+}
+
 } // namespace
 
 std::unique_ptr<PointwiseParams> getPointwiseHeuristics(
@@ -68,10 +126,22 @@ std::unique_ptr<PointwiseParams> getPointwiseHeuristics(
   const int64_t device_multiprocessor_count =
       (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
 
+  std::vector<IndexSelectOp*> vectorizable_lookups =
+      pointwise_utils::getVectorizableIndexSelects(fusion, largest_out);
+  // The indices of those lookups are only read on the lhs of the break point,
+  // so they don't limit the vectorization of the rows
+  std::unordered_set<TensorView*> lookup_index_tvs;
+  for (IndexSelectOp* op : vectorizable_lookups) {
+    lookup_index_tvs.insert(op->indexTv());
+  }
+
   // TODO: Set to 1?
   int64_t max_input_dtype_size = 2;
 
   for (auto inp : in_tvs) {
+    if (lookup_index_tvs.count(inp) != 0) {
+      continue;
+    }
     max_input_dtype_size = std::max(
         max_input_dtype_size,
         (int64_t)dataTypeSize(inp->getDataType().value(), index_type));
@@ -328,6 +398,40 @@ std::unique_ptr<PointwiseParams> getPointwiseHeuristics(
     }
   }
 
+  // Embedding lookups gather whole rows of their table. Put the rows on the
+  // rhs of the break point, so a block row of threads reads each gathered row
+  // with vectorized loads, instead of scalar reads of the 1D schedule.
+  int64_t lookup_break_point = 0;
+  for (IndexSelectOp* op : vectorizable_lookups) {
+    lookup_break_point = std::max(lookup_break_point, op->dim() + 1);
+  }
+  if (!vectorizable_lookups.empty() && break_point < lookup_break_point &&
+      max_vect_unroll_factor > 1) {
+    int64_t lookup_right_elem_count = 1;
+    for (const auto right_i :
+         c10::irange(lookup_break_point, (int64_t)ref_root.size())) {
+      lookup_right_elem_count *= elem_counts[right_i];
+    }
+    const int64_t lookup_left_elem_count = n_elems / lookup_right_elem_count;
+    // Rows narrower than an unrolled warp are not worth a 2D schedule
+    if (lookup_left_elem_count > 1 &&
+        ceilDiv(lookup_right_elem_count, max_vect_unroll_factor) >=
+            at::cuda::getCurrentDeviceProperties()->warpSize) {
+      break_point = static_cast<int>(lookup_break_point);
+      flip_grid_binding = false;
+      right_elem_count = lookup_right_elem_count;
+      bdimx = std::min(
+          ceilDiv(lookup_right_elem_count, max_vect_unroll_factor), kThreadX);
+      bdimy = 1;
+      if (lookup_left_elem_count > device_multiprocessor_count) {
+        bdimy = kThreadX / bdimx;
+      }
+      gdim_left = ceilDiv(lookup_left_elem_count, bdimy);
+      gdim_right =
+          ceilDiv(lookup_right_elem_count, bdimx * max_vect_unroll_factor);
+    }
+  }
+
   params->vectorization_factor = std::min(
       max_vect_factor,
       vectorize_helper::getVectorizationFactor(
@@ -358,6 +462,90 @@ std::unique_ptr<PointwiseParams> getPointwiseHeuristics(
     }
   }
 
+  if (shouldUseTmaLoad(fusion, largest_out, runtime_info, n_elems)) {
+    // The TMA schedule is 1D with one box per CTA
+    params->use_tma_load = true;
+    params->vectorization_factor = 1;
+    params->unroll_factor_inner = 1;
+    params->unroll_factor_outer = 1;
+    break_point = 0;
+    flip_grid_binding = false;
+    bdimx = kTmaTileSize;
+    bdimy = 1;
+    gdim_left = 1;
+    // shouldUseTmaLoad requires at least kTmaTilesPerCta boxes per SM, so
+    // each CTA can stream several boxes and still fill the GPU
+    params->tma_circular_buffer_stages = kTmaCircularBufferStages;
+  }
+
+  // The factor above is limited by the alignment of the inputs, so each
+  // alignment needs its own kernel. Peeling the misaligned head and tail lets
+  // one kernel vectorize the body for all of them.
+  if (isOptionEnabled(EnableOption::MisalignedVectorize) &&
+      !params->use_tma_load && vectorizable_lookups.empty() &&
+      max_vect_factor > params->vectorization_factor &&
+      pointwise_utils::getMisalignedVectorizableInput(fusion, largest_out) !=
+          nullptr) {
+    params->vectorize_misaligned = true;
+    params->vectorization_factor = max_vect_factor;
+    params->unroll_factor_inner = 1;
+    params->unroll_factor_outer = 1;
+    break_point = 0;
+    flip_grid_binding = false;
+    bdimx = kThreadX;
+    bdimy = 1;
+    gdim_left = 1;
+    gdim_right = 1;
+  }
+
+  if (params->vectorization_factor > 1 && !params->use_tma_load &&
+      !vectorizable_lookups.empty() && break_point >= lookup_break_point) {
+    // The gathered rows must be aligned to the vector width like any other
+    // vectorized input. A smaller factor still beats scalar row reads.
+    int64_t lookup_vectorization_factor = params->vectorization_factor;
+    for (IndexSelectOp* op : vectorizable_lookups) {
+      TensorView* lookup = op->lookupTv();
+      const auto dtype_size =
+          (int64_t)dataTypeSize(lookup->dtype(), index_type);
+      lookup_vectorization_factor = std::min(
+          lookup_vectorization_factor,
+          (int64_t)runtime_info.getAlignmentSize(lookup) / dtype_size);
+      const std::vector<IterDomain*> lookup_logical =
+          TensorDomain::noReductions(lookup->getLogicalDomain());
+      int64_t row_size = 1;
+      for (auto i :
+           c10::irange(op->dim() + 1, (int64_t)lookup_logical.size())) {
+        row_size *= runtime_info.expressionEvaluator()
+                        .evaluate(lookup_logical[i]->extent())
+                        .as<int64_t>();
+      }
+      lookup_vectorization_factor = std::min(
+          lookup_vectorization_factor,
+          scheduler_utils::maxVectorizationWidth(row_size));
+    }
+    if (lookup_vectorization_factor > 1) {
+      params->vectorization_factor = lookup_vectorization_factor;
+      params->vectorize_lookup = true;
+    }
+  }
+
+  // Launch as many CTAs as can be resident at once and let them loop over
+  // the tiles. Registers may lower the occupancy, but each CTA then still
+  // gets the same number of tiles, up to one.
+  if (isOptionEnabled(EnableOption::GridStridePointwise) && break_point == 0 &&
+      !params->use_tma_load && !params->vectorize_misaligned) {
+    const int64_t max_resident_blocks = device_multiprocessor_count *
+        (int64_t)at::cuda::getCurrentDeviceProperties()
+            ->maxThreadsPerMultiProcessor /
+        kThreadX;
+    const int64_t num_blocks = ceilDiv(
+        n_elems,
+        kThreadX * params->vectorization_factor * params->unroll_factor_inner);
+    if (num_blocks > max_resident_blocks) {
+      params->grid_stride_blocks = max_resident_blocks;
+    }
+  }
+
   NVF_ERROR(right_elem_count > 0 || break_point == 0);
   NVF_ERROR(!(bdimy > 1 && gdim_right > 1));
 
@@ -369,11 +557,43 @@ std::unique_ptr<PointwiseParams> getPointwiseHeuristics(
   if (params->split_block) {
     params->lparams.bind(bdimy, ParallelType::TIDy);
   }
+
+  // The rows of a split block read the same values of the inputs broadcast
+  // along them, so these are loaded once per block into shared memory, which
+  // cuts their loads by bdimy instead of relying on L1
+  if (isOptionEnabled(EnableOption::SmemBroadcastInputs) &&
+      params->split_block) {
+    params->smem_broadcast_inputs = true;
+  }
   if ((flip_grid_binding && gdim_right > 65535) ||
       (!flip_grid_binding && gdim_left > 65535)) {
     params->split_grid_y_dim = true;
   }
 
+  // Group the tiles of a wave along the slower grid dimension, so that the
+  // inputs broadcast along it are read from L2 by all the tiles needing them.
+  // The merged grid must fit in BIDx.
+  if (isOptionEnabled(EnableOption::GridSwizzle) && break_point > 0 &&
+      !params->split_block && !params->split_grid_y_dim) {
+    const int64_t inner_tile = bdimx * params->vectorization_factor *
+        params->unroll_factor_inner;
+    const int64_t inner_tiles = ceilDiv(right_elem_count, inner_tile);
+    const int64_t outer_tiles =
+        ceilDiv(n_elems / right_elem_count, params->unroll_factor_outer);
+    const int64_t ctas_per_wave = device_multiprocessor_count *
+        (int64_t)at::cuda::getCurrentDeviceProperties()
+            ->maxThreadsPerMultiProcessor /
+        bdimx;
+    if (inner_tiles * outer_tiles <= std::numeric_limits<int32_t>::max()) {
+      // BIDx walks along the inner tiles, or the outer ones when flipped
+      params->grid_swizzle_factor = scheduler_utils::getGridSwizzleFactor(
+          flip_grid_binding ? inner_tiles : outer_tiles,
+          flip_grid_binding ? outer_tiles : inner_tiles,
+          inner_tile * params->unroll_factor_outer * dtype_sum,
+          ctas_per_wave);
+    }
+  }
+
   if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
     debug() << "\n===== Pointwise Stats ========\n"
             << "num_elems: " << n_elems << "\n"
@@ -468,12 +688,28 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams* pparams) {
   // fusion segmentation
   scheduler_utils::clearMemorySpace(fusion);
 
+  TensorView* misaligned_input = nullptr;
+  if (pparams->vectorize_misaligned) {
+    misaligned_input = pointwise_utils::getMisalignedVectorizableInput(
+        fusion, pointwise_utils::getReferenceTensor(fusion));
+    NVF_ERROR(
+        misaligned_input != nullptr,
+        "Expected an input to vectorize with misaligned vectorization");
+  }
+
   // Cache inputs
   auto cached_inputs = scheduler_utils::cacheInputs(fusion, true);
 
   // Cache and fork outputs
   auto cached_outputs = scheduler_utils::cacheAndForkOutputs(fusion, true);
 
+  // This has to happen before refineCachePolicy, which only refines plain
+  // loads
+  std::vector<TensorView*> tma_tvs;
+  if (pparams->use_tma_load) {
+    tma_tvs = setUpTmaLoads(fusion, cached_inputs);
+  }
+
   scheduler_utils::prepareForMemoryTypePromotion(fusion);
 
   refineCachePolicy(fusion);
@@ -513,6 +749,12 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams* pparams) {
 
   scheduler_utils::moveNonConcretizedBroadcastInnermost(fusion, {reference_tv});
 
+  std::vector<IndexSelectOp*> vectorized_lookups;
+  if (pparams->vectorize_lookup) {
+    vectorized_lookups =
+        pointwise_utils::getVectorizableIndexSelects(fusion, reference_tv);
+  }
+
   int64_t num_device_dims = numDeviceDims(reference_tv);
   int64_t device_aware_break_point = pparams->break_point + num_device_dims;
 
@@ -760,6 +1002,25 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams* pparams) {
           unswitch_pos = 4;
         }
       }
+    } else if (pparams->grid_swizzle_factor > 1) {
+      // [i-remainder, o-remainder, Unswitch, Unroll, TIDx, Vect]
+      // Split the slower grid dim by the swizzle factor and make it the
+      // fastest, so that consecutive CTAs walk a group of tiles along it
+      if (pparams->flip_grid_binding) {
+        reference_tv->split(0, pparams->grid_swizzle_factor);
+        // [i-remainder/swizzle, swizzle, o-remainder, Unswitch, ...]
+        reference_tv->reorder({{1, 2}});
+      } else {
+        reference_tv->split(1, pparams->grid_swizzle_factor);
+        // [i-remainder, o-remainder/swizzle, swizzle, Unswitch, ...]
+        reference_tv->reorder({{0, 1}});
+      }
+      // [slow/swizzle, fast, swizzle, Unswitch, Unroll, TIDx, Vect]
+      reference_tv->merge(0);
+      reference_tv->merge(0);
+      // [BIDx | Unswitch, Unroll, TIDx, Vect]
+      reference_tv->axis(0)->parallelize(ParallelType::BIDx);
+      unswitch_pos = 2;
     } else {
       // [BIDy | BIDx | Unswitch, Unroll, TIDx, Vect]
       if (pparams->flip_grid_binding) {
@@ -799,7 +1060,25 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams* pparams) {
     // unmerged...]
     reference_tv->reorder({{-1, 0}});
 
-    if (pparams->unroll_factor_inner == 1 &&
+    if (pparams->use_tma_load) {
+      // [BIDx, TIDx]. The TIDx of TMA loaded tensors becomes Bulk below.
+      reference_tv->split(0, kTmaTileSize);
+      if (pparams->tma_circular_buffer_stages > 1) {
+        // [BIDx, serial, TIDx]. The serial loop is circular buffered.
+        reference_tv->split(0, kTmaTilesPerCta);
+      }
+      reference_tv->axis(0)->parallelize(ParallelType::BIDx);
+      reference_tv->axis(-1)->parallelize(ParallelType::TIDx);
+    } else if (pparams->vectorize_misaligned) {
+      // [BIDx, TIDx, MisalignedVectorize]. Without an unswitch, the
+      // vectorized loop is right inside the loop its tensor is computed at,
+      // as the misaligned vectorization pass requires.
+      reference_tv->split(0, pparams->vectorization_factor);
+      reference_tv->split(0, kThreadX);
+      reference_tv->axis(0)->parallelize(ParallelType::BIDx);
+      reference_tv->axis(1)->parallelize(ParallelType::TIDx);
+    } else if (
+        pparams->unroll_factor_inner == 1 &&
         pparams->vectorization_factor > 1) {
       // Vectorize
       reference_tv->split(0, pparams->vectorization_factor);
@@ -846,7 +1125,20 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams* pparams) {
         vectorize_id = reference_tv->axis(tidx_pos + 1);
       }
     }
-    unswitch_pos = 2;
+    // Without an unswitch, TMA loads are computed right inside BIDx, or
+    // inside the loop over the boxes of a CTA
+    if (pparams->use_tma_load) {
+      unswitch_pos = pparams->tma_circular_buffer_stages > 1 ? 2 : 1;
+    } else {
+      unswitch_pos = 2;
+    }
+    if (pparams->grid_stride_blocks > 0) {
+      // [serial, BIDx, Unswitch, ...]. Each iteration of the serial loop
+      // moves all the CTAs by the grid size.
+      reference_tv->split(0, pparams->grid_stride_blocks);
+      reference_tv->axis(0)->parallelize(ParallelType::Serial);
+      unswitch_pos++;
+    }
   }
 
   TransformPropagator propagator(reference_tv);
@@ -854,7 +1146,21 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams* pparams) {
   spanning_tree.traverse(&propagator);
   scheduler_utils::parallelizeAllLike(reference_tv);
 
-  if (pparams->vectorization_factor > 1) {
+  for (TensorView* tma_tv : tma_tvs) {
+    NVF_ERROR(
+        tma_tv->nDims() == reference_tv->nDims(),
+        "Expected TMA loaded tensors to be scheduled like the reference, got: ",
+        tma_tv->toString());
+    tma_tv->axis(-1)->parallelize(ParallelType::Bulk);
+  }
+
+  if (pparams->vectorize_misaligned) {
+    // Only the load of one input is vectorized. The peeled head and tail
+    // follow its alignment, which the other tensors may not share.
+    for (TensorView* cached_input : ir_utils::consumerTvsOf(misaligned_input)) {
+      cached_input->axis(-1)->parallelize(ParallelType::MisalignedVectorize);
+    }
+  } else if (pparams->vectorization_factor > 1) {
     // Grab all tensor views that should be vectorized
     auto inputs_outputs =
         scheduler_utils::getInputsOutputsWithInnerDim(reference_tv, true, true);
@@ -873,6 +1179,11 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams* pparams) {
       vectorized_tvs.insert(
           vectorized_tvs.end(), consumer_tvs.begin(), consumer_tvs.end());
     }
+    // Lookup tables are not cached, so their rows are gathered by the
+    // indexSelect itself
+    for (IndexSelectOp* op : vectorized_lookups) {
+      vectorized_tvs.push_back(op->output(0)->as<TensorView>());
+    }
     if (!vectorized_tvs.empty()) {
       // Aggressively mark with vectorized and cleanup later. That way we
       // don't have to manually specify parallelization outside the reference.
@@ -885,6 +1196,20 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams* pparams) {
     }
   }
 
+  // A cached input broadcast along TIDy is the same for all the rows of a
+  // block. In shared memory, it is written by the first row only.
+  if (pparams->smem_broadcast_inputs) {
+    for (TensorView* cached_input : cached_inputs) {
+      const std::vector<IterDomain*>& loop = cached_input->getLoopDomain();
+      if (std::any_of(loop.begin(), loop.end(), [](IterDomain* id) {
+            return id->getParallelType() == ParallelType::TIDy &&
+                id->isBroadcast();
+          })) {
+        cached_input->setMemoryType(MemoryType::Shared);
+      }
+    }
+  }
+
   // Begin by inlining at the unswitch position for the entire DAG. The cached
   // inputs, and outputs will keep this inline position, but other tensors will
   // get a higher position in later inline propagation. We need this separate
@@ -907,6 +1232,18 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams* pparams) {
   }
   inlineMost(inner_most_tensors);
 
+  // A producer warp group along TIDy streams the TMA boxes into a ring of
+  // shared memory buffers, so the loads of later boxes overlap the compute
+  // of earlier ones without spending consumer registers on them
+  if (pparams->tma_circular_buffer_stages > 1) {
+    for (TensorView* tma_tv : tma_tvs) {
+      tma_tv->circularBuffer(
+          pparams->tma_circular_buffer_stages,
+          pparams->tma_circular_buffer_stages - 1,
+          WarpSpecialized(ParallelType::TIDy));
+    }
+  }
+
   scheduler_utils::promoteProducerMemoryTypes(fusion, cached_inputs);
 
   // TODO(#1401): We could let segmentation split a partially alias-producing
@@ -53,6 +53,47 @@ class PointwiseParams : public HeuristicParams {
   // Also used in 1D scheduler.
   int64_t unroll_factor_inner = 1;
 
+  // Load the inputs returned by pointwise_utils::getTmaLoadableInputs into
+  // shared memory with TMA. Only used by the 1D scheduler, which then tiles the
+  // problem with one TMA box of bdimx elements per CTA and doesn't vectorize
+  // or unroll.
+  bool use_tma_load = false;
+
+  // With use_tma_load, each CTA loops over several TMA boxes, which are
+  // circular buffered through this many shared memory buffers by a
+  // warp-specialized producer along TIDy. 1 loads a single box per CTA.
+  int64_t tma_circular_buffer_stages = 1;
+
+  // Also vectorize the row gathers from the lookup tables of the ops returned
+  // by pointwise_utils::getVectorizableIndexSelects, as for embedding lookups.
+  // Requires a break point right of their indexed dimension.
+  bool vectorize_lookup = false;
+
+  // Vectorize the load of pointwise_utils::getMisalignedVectorizableInput with
+  // ParallelType::MisalignedVectorize, which peels the misaligned head and
+  // tail of each row at runtime. The kernel is then valid for any alignment of
+  // that input. Only used by the 1D scheduler.
+  bool vectorize_misaligned = false;
+
+  // If positive, the 1D scheduler launches this many CTAs, which loop over
+  // the tiles with a grid stride. This avoids a partial last wave and keeps
+  // the grid the same across sizes. Not used with TMA loads or misaligned
+  // vectorization.
+  int64_t grid_stride_blocks = 0;
+
+  // If larger than 1, the 2D scheduler merges its grid into BIDx so that
+  // consecutive CTAs walk this many tiles along the slower grid dimension
+  // before moving along the faster one. This keeps the tiles of a wave close
+  // to each other, so that the data they share stays in L2. Not used with a
+  // split block or a split y grid dim.
+  int64_t grid_swizzle_factor = 1;
+
+  // With a split block, the 2D scheduler stages the cached inputs that are
+  // broadcast along TIDy, e.g., a bias, in shared memory. The threads of the
+  // first row of the block load them once, instead of every row loading the
+  // same values.
+  bool smem_broadcast_inputs = false;
+
   using HeuristicParams::HeuristicParams;
 
   // Warning: Does not check launch parameters!
@@ -68,7 +109,14 @@ class PointwiseParams : public HeuristicParams {
         other->split_grid_y_dim == split_grid_y_dim &&
         other->unroll_factor_outer == unroll_factor_outer &&
         other->unroll_factor_inner == unroll_factor_inner &&
-        other->flip_grid_binding == flip_grid_binding;
+        other->flip_grid_binding == flip_grid_binding &&
+        other->use_tma_load == use_tma_load &&
+        other->tma_circular_buffer_stages == tma_circular_buffer_stages &&
+        other->vectorize_lookup == vectorize_lookup &&
+        other->vectorize_misaligned == vectorize_misaligned &&
+        other->grid_stride_blocks == grid_stride_blocks &&
+        other->grid_swizzle_factor == grid_swizzle_factor &&
+        other->smem_broadcast_inputs == smem_broadcast_inputs;
     return attr_equal;
   }
 
@@ -94,6 +142,28 @@ class PointwiseParams : public HeuristicParams {
     if (flip_grid_binding) {
       ss << "Flip BIDx/BIDy bindings\n";
     }
+    if (use_tma_load) {
+      ss << "Load inputs with TMA\n";
+      if (tma_circular_buffer_stages > 1) {
+        ss << "  Warp-specialized circular buffer stages: "
+           << tma_circular_buffer_stages << "\n";
+      }
+    }
+    if (vectorize_lookup) {
+      ss << "Vectorize lookup rows\n";
+    }
+    if (vectorize_misaligned) {
+      ss << "Misaligned vectorization\n";
+    }
+    if (grid_stride_blocks > 0) {
+      ss << "Grid stride blocks: " << grid_stride_blocks << "\n";
+    }
+    if (grid_swizzle_factor > 1) {
+      ss << "Grid swizzle factor: " << grid_swizzle_factor << "\n";
+    }
+    if (smem_broadcast_inputs) {
+      ss << "Stage broadcast inputs in shared memory\n";
+    }
     ss << "====================================\n";
     return ss.str();
   }
@@ -106,7 +176,14 @@ class PointwiseParams : public HeuristicParams {
         static_cast<size_t>(split_grid_y_dim) << 6 ^
         static_cast<size_t>(unroll_factor_outer) << 7 ^
         static_cast<size_t>(unroll_factor_inner) << 9 ^
-        static_cast<size_t>(flip_grid_binding) << 10;
+        static_cast<size_t>(flip_grid_binding) << 10 ^
+        static_cast<size_t>(use_tma_load) << 11 ^
+        static_cast<size_t>(vectorize_lookup) << 12 ^
+        static_cast<size_t>(tma_circular_buffer_stages) << 13 ^
+        static_cast<size_t>(vectorize_misaligned) << 14 ^
+        static_cast<size_t>(grid_stride_blocks) << 15 ^
+        static_cast<size_t>(grid_swizzle_factor) << 16 ^
+        static_cast<size_t>(smem_broadcast_inputs) << 17;
     return attr_hash;
   }
 
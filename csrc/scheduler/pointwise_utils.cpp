@@ -17,5 +17,194 @@ TensorView* getReferenceTensor(Fusion* fusion) {
   return reference_tv;
 }
 
+namespace {
+
+// The reference logical domain without reductions and broadcasts. Empty if
+// the fusion has view ops, or the reference is device parallel or has a
+// non-trivial allocation domain, in which case the reference is merged in an
+// order the callers don't model.
+std::vector<IterDomain*> getPlainReferenceLogical(
+    Fusion* fusion,
+    TensorView* reference_tv) {
+  if (!ir_utils::getViewOps(fusion).empty() ||
+      !scheduler_utils::maybeLogicalReorderAsAllocationMap(reference_tv)
+           .empty()) {
+    return {};
+  }
+  std::vector<IterDomain*> ref_logical = TensorDomain::noBroadcasts(
+      TensorDomain::noReductions(reference_tv->getLogicalDomain()));
+  if (std::any_of(ref_logical.begin(), ref_logical.end(), [](IterDomain* id) {
+        return id->isDeviceDim();
+      })) {
+    return {};
+  }
+  return ref_logical;
+}
+
+bool isContiguous(TensorView* tv) {
+  const auto& contiguity = tv->getContiguity();
+  return std::all_of(contiguity.begin(), contiguity.end(), [](const auto& c) {
+    return !c.has_value() || c.value();
+  });
+}
+
+} // namespace
+
+std::vector<TensorView*> getTmaLoadableInputs(
+    Fusion* fusion,
+    TensorView* reference_tv) {
+  FusionGuard fg(fusion);
+  std::vector<IterDomain*> ref_logical =
+      getPlainReferenceLogical(fusion, reference_tv);
+  if (ref_logical.empty()) {
+    return {};
+  }
+
+  auto is_tma_dtype = [](DataType dtype) {
+    return dtype == DataType::Double || dtype == DataType::Float ||
+        dtype == DataType::Half || dtype == DataType::BFloat16 ||
+        dtype == DataType::Int || dtype == DataType::Int32;
+  };
+
+  ComputeAtMap ca_map(fusion);
+  std::vector<TensorView*> tma_inputs;
+  for (auto tv : ir_utils::filterByType<TensorView>(fusion->inputs())) {
+    if (tv->uses().empty() || !is_tma_dtype(tv->dtype()) ||
+        !ir_utils::hasTrivialAllocationDomain(tv)) {
+      continue;
+    }
+    const std::vector<IterDomain*>& logical = tv->getLogicalDomain();
+    if (logical.size() != ref_logical.size()) {
+      continue;
+    }
+    bool mapped = true;
+    for (auto i : c10::irange(logical.size())) {
+      if (logical[i]->isBroadcast() || logical[i]->isReduction() ||
+          !ca_map.areMapped(
+              logical[i], ref_logical[i], IdMappingMode::EXACT)) {
+        mapped = false;
+        break;
+      }
+    }
+    const auto& contiguity = tv->getContiguity();
+    bool contiguous =
+        std::all_of(contiguity.begin(), contiguity.end(), [](const auto& c) {
+          return c.has_value() && c.value();
+        });
+    if (mapped && contiguous) {
+      tma_inputs.push_back(tv);
+    }
+  }
+  return tma_inputs;
+}
+
+std::vector<IndexSelectOp*> getVectorizableIndexSelects(
+    Fusion* fusion,
+    TensorView* reference_tv) {
+  FusionGuard fg(fusion);
+  std::vector<IndexSelectOp*> index_selects =
+      ir_utils::getOpsOfType<IndexSelectOp>(fusion);
+  if (index_selects.empty()) {
+    return {};
+  }
+  // Break points are positions in the reference logical domain, so it must
+  // not have broadcasts that getPlainReferenceLogical drops
+  std::vector<IterDomain*> ref_logical =
+      getPlainReferenceLogical(fusion, reference_tv);
+  if (ref_logical.empty() ||
+      ref_logical.size() !=
+          TensorDomain::noReductions(reference_tv->getLogicalDomain())
+              .size()) {
+    return {};
+  }
+
+  ComputeAtMap ca_map(fusion);
+  std::vector<IndexSelectOp*> vectorizable;
+  for (IndexSelectOp* op : index_selects) {
+    TensorView* lookup = op->lookupTv();
+    const std::vector<IterDomain*> lookup_logical =
+        TensorDomain::noReductions(lookup->getLogicalDomain());
+    if (!lookup->isFusionInput() ||
+        !ir_utils::hasTrivialAllocationDomain(lookup) ||
+        !isContiguous(lookup) ||
+        op->dim() + 1 >= (int64_t)lookup_logical.size()) {
+      continue;
+    }
+    const std::vector<IterDomain*> out_logical = TensorDomain::noReductions(
+        op->output(0)->as<TensorView>()->getLogicalDomain());
+    if (out_logical.size() != ref_logical.size()) {
+      continue;
+    }
+    bool mapped = true;
+    for (auto i : c10::irange(op->dim() + 1, (int64_t)out_logical.size())) {
+      if (out_logical[i]->isBroadcast() ||
+          !ca_map.areMapped(
+              out_logical[i], ref_logical[i], IdMappingMode::EXACT)) {
+        mapped = false;
+        break;
+      }
+    }
+    if (mapped) {
+      vectorizable.push_back(op);
+    }
+  }
+  return vectorizable;
+}
+
+TensorView* getMisalignedVectorizableInput(
+    Fusion* fusion,
+    TensorView* reference_tv) {
+  FusionGuard fg(fusion);
+  if (fusion->outputs().size() != 1 ||
+      fusion->outputs().front() != reference_tv ||
+      !ir_utils::hasTrivialAllocationDomain(reference_tv)) {
+    return nullptr;
+  }
+  std::vector<IterDomain*> ref_logical =
+      getPlainReferenceLogical(fusion, reference_tv);
+  if (ref_logical.empty() ||
+      ref_logical.size() !=
+          TensorDomain::noReductions(reference_tv->getLogicalDomain())
+              .size()) {
+    return nullptr;
+  }
+
+  for (Expr* expr : fusion->exprs()) {
+    if (ir_utils::isScalarOp(expr)) {
+      continue;
+    }
+    auto* ldst = dynamic_cast<LoadStoreOp*>(expr);
+    if (!(ldst != nullptr && ldst->opType() == LoadStoreOpType::Set) &&
+        !expr->isOneOf<UnaryOp, BinaryOp, TernaryOp>()) {
+      return nullptr;
+    }
+  }
+
+  ComputeAtMap ca_map(fusion);
+  for (auto tv : ir_utils::filterByType<TensorView>(fusion->inputs())) {
+    if (tv->uses().empty() || !ir_utils::hasTrivialAllocationDomain(tv) ||
+        !isContiguous(tv)) {
+      continue;
+    }
+    const std::vector<IterDomain*>& logical = tv->getLogicalDomain();
+    if (logical.size() != ref_logical.size()) {
+      continue;
+    }
+    bool mapped = true;
+    for (auto i : c10::irange(logical.size())) {
+      if (logical[i]->isBroadcast() ||
+          !ca_map.areMapped(
+              logical[i], ref_logical[i], IdMappingMode::EXACT)) {
+        mapped = false;
+        break;
+      }
+    }
+    if (mapped) {
+      return tv;
+    }
+  }
+  return nullptr;
+}
+
 } // namespace pointwise_utils
 } // namespace nvfuser
@@ -20,5 +20,36 @@ namespace pointwise_utils {
 // Return reference tensor view.
 TensorView* getReferenceTensor(Fusion* fusion);
 
+// Return the fusion inputs that the 1D schedule can load with TMA. These are
+// contiguous inputs of a TMA-supported dtype without broadcasts, whose logical
+// domain is exactly mapped to the reference one in order, so merging the
+// reference flattens them into a single contiguous TMA dimension. Empty if the
+// fusion has view ops, or the reference is device parallel or has a
+// non-trivial allocation domain.
+std::vector<TensorView*> getTmaLoadableInputs(
+    Fusion* fusion,
+    TensorView* reference_tv);
+
+// Return the indexSelect ops whose row gathers can be vectorized, as for
+// embedding lookups. The lookup table must be contiguous with a trivial
+// allocation domain and must not be indexed on its innermost dimension. The
+// output dimensions right of the indexed one must be exactly mapped to the
+// reference ones in order, so they end up on the rhs of a break point of
+// dim() + 1. Empty under the same conditions as getTmaLoadableInputs.
+std::vector<IndexSelectOp*> getVectorizableIndexSelects(
+    Fusion* fusion,
+    TensorView* reference_tv);
+
+// Return the fusion input whose load the 1D schedule can vectorize with
+// ParallelType::MisalignedVectorize, or nullptr. The fusion must only have
+// elementwise ops and a single output, the reference, without broadcasts. The
+// input must be contiguous with a trivial allocation domain and its logical
+// domain exactly mapped to the reference one in order. The misaligned head and
+// tail are peeled according to the alignment of this one input, so only the
+// first such input is returned and the other accesses stay scalar.
+TensorView* getMisalignedVectorizableInput(
+    Fusion* fusion,
+    TensorView* reference_tv);
+
 } // namespace pointwise_utils
 } // namespace nvfuser
@@ -7,14 +7,20 @@
 // clang-format on
 #include <ATen/cuda/CUDAContext.h>
 #include <debug.h>
+#include <device_lower/analysis/bank_conflict.h>
+#include <device_lower/analysis/circular_buffer.h>
 #include <instrumentation.h>
+#include <iter_visitor.h>
 #include <multidevice/utils.h>
+#include <options.h>
 #include <scheduler/debug_utils.h>
+#include <scheduler/heuristic_plugin.h>
 #include <scheduler/mark_aliases.h>
 #include <scheduler/reduction.h>
 #include <scheduler/reduction_utils.h>
 #include <scheduler/registry_utils.h>
 #include <scheduler/runtime_info.h>
+#include <scheduler/tools/inlining.h>
 #include <scheduler/utils.h>
 #include <scheduler/vectorize_helper.h>
 
@@ -41,6 +47,32 @@ int64_t roundDownPow2OrMultipleOf(const int64_t x, const int64_t multiple) {
   return std::max(std::max(round_down_multiple, round_down_pow2), (int64_t)1);
 }
 
+// Returns true if the reduction should be done without cross-grid reductions
+// to minimize its latency. With NVFUSER_ENABLE=latency_mode, this is the case
+// for problems of at most 64Ki elements, or of at most the number of elements
+// given as the option argument. Grid reductions help large problems fill the
+// device, but for tiny ones their semaphores and global memory round trip
+// dominate the kernel time.
+bool useLatencyMode(
+    const int64_t total_reduction_numel,
+    const int64_t total_iteration_numel) {
+  if (!isOptionEnabled(EnableOption::LatencyMode)) {
+    return false;
+  }
+  int64_t max_numel = 64 * 1024;
+  const auto& option_args =
+      getEnableOptionArguments(EnableOption::LatencyMode);
+  if (!option_args.empty()) {
+    try {
+      max_numel = std::stol(option_args[0]);
+    } catch (const std::exception& e) {
+      debug() << "skip invalid argument for LatencyMode, arg = "
+              << option_args[0] << std::endl;
+    }
+  }
+  return total_reduction_numel * total_iteration_numel <= max_numel;
+}
+
 int64_t clamp(const int64_t val, const int64_t min_val, const int64_t max_val) {
   return std::min(std::max(val, min_val), max_val);
 }
@@ -289,8 +321,9 @@ std::unique_ptr<ReductionParams> inner2dReductionHeuristic(
   constexpr int64_t kEight = 8;
   // Cross grid reduction if we haven't hit our target blocks, and we have manyr
   // reduction elements.
-  if ((godim < target_blocks && remainder_in_reduction >= 0) ||
-      (remainder_in_reduction >= kEight)) {
+  if (!useLatencyMode(total_reduction_numel, total_iteration_numel) &&
+      ((godim < target_blocks && remainder_in_reduction >= 0) ||
+       (remainder_in_reduction >= kEight))) {
     grdim = remainder_in_reduction;
   }
 
@@ -644,8 +677,9 @@ std::unique_ptr<ReductionParams> inner3dReductionHeuristic(
   constexpr int64_t kEight = 8;
   // Cross grid reduction if we haven't hit our target blocks, and we have manyr
   // reduction elements.
-  if ((godim < target_blocks && remainder_in_reduction >= 0) ||
-      (remainder_in_reduction >= kEight)) {
+  if (!useLatencyMode(total_reduction_numel, total_iteration_numel) &&
+      ((godim < target_blocks && remainder_in_reduction >= 0) ||
+       (remainder_in_reduction >= kEight))) {
     auto grdim = std::min(remainder_in_reduction, bdimx * bdimy * kEight);
 
     gridim = remainder_in_inner_dim;
@@ -1363,13 +1397,117 @@ std::unique_ptr<ReductionParams> outerReductionHeuristic(
       max_threads_per_block);
 
   // pick the better heuristic
-  if (isBetterThan(block_params, grid_params, sm_count)) {
+  if (useLatencyMode(total_reduction_numel, total_iteration_numel) ||
+      isBetterThan(block_params, grid_params, sm_count)) {
     return heuristicParaToSchedulerPara(block_params);
   } else {
     return heuristicParaToSchedulerPara(grid_params);
   }
 }
 
+// Rows and columns of the tiles of a transposed outer reduction. A warp loads
+// a row of a tile and reduces a column of it.
+constexpr int64_t kTransposeTile = 32;
+// Largest iteration domain of a transposed outer reduction. Larger ones give
+// the regular outer reduction heuristics enough columns to coalesce loads.
+constexpr int64_t kMaxTransposedIterationNumel = 128;
+
+// Whether the outer reduction of reduction_tvs should be transposed through
+// shared memory, see ReductionParams::transposed_outer_reduction. The epilogue
+// is scheduled like the final warp reductions, which is only done for a single
+// reduction followed by unary ops.
+bool canTransposeOuterReduction(
+    Fusion* fusion,
+    const std::vector<TensorView*>& reduction_tvs,
+    const scheduler_utils::ReductionTvProperties& properties) {
+  if (properties.fastest_dim_reduction || reduction_tvs.size() != 1) {
+    return false;
+  }
+  TensorView* reduction_tv = reduction_tvs.front();
+  if (!reduction_tv->definition()->isA<ReductionOp>() ||
+      isSharded(reduction_tv)) {
+    return false;
+  }
+  if (properties.total_iteration_numel % kTransposeTile != 0 ||
+      properties.total_iteration_numel > kMaxTransposedIterationNumel ||
+      properties.total_reduction_numel < kTransposeTile) {
+    return false;
+  }
+  if (std::any_of(
+          fusion->outputs().begin(), fusion->outputs().end(), [&](Val* out) {
+            return out != reduction_tv &&
+                !DependencyCheck::isDependencyOf(reduction_tv, out);
+          })) {
+    return false;
+  }
+  auto epilogue = StmtSort::getExprsBetween({reduction_tv}, fusion->outputs());
+  return std::all_of(epilogue.begin(), epilogue.end(), [](Expr* expr) {
+    return expr->isOneOf<UnaryOp, LoadStoreOp>();
+  });
+}
+
+std::unique_ptr<ReductionParams> transposedOuterReductionHeuristic(
+    const int64_t total_reduction_numel,
+    const int64_t total_iteration_numel) {
+  // WARNING: Current device for codegen may not be the target device
+  auto dev_prop = at::cuda::getCurrentDeviceProperties();
+  const int64_t sm_count = (int64_t)dev_prop->multiProcessorCount;
+  const int64_t max_threads_per_sm =
+      (int64_t)dev_prop->maxThreadsPerMultiProcessor;
+
+  // Each thread accumulates rows_per_thread rows of a column of the tile, which
+  // are unrolled to overlap their loads
+  const int64_t rows_per_thread = 4;
+  const int64_t bdimx = kTransposeTile;
+  const int64_t bdimy = kTransposeTile / rows_per_thread;
+  const int64_t gidim = ceilDiv(total_iteration_numel, kTransposeTile);
+
+  // Split the rows across a grid reduction until the SMs are filled, while
+  // each block still reduces a few tiles
+  const int64_t min_tiles_per_block = 4;
+  const int64_t blocks_per_sm = max_threads_per_sm / (bdimx * bdimy);
+  const int64_t grdim = std::max(
+      std::min(
+          {ceilDiv(
+               ceilDiv(total_reduction_numel, kTransposeTile),
+               min_tiles_per_block),
+           ceilDiv(sm_count * blocks_per_sm, gidim),
+           scheduler_utils::y_grid_limit}),
+      (int64_t)1);
+
+  auto rparams = std::make_unique<ReductionParams>();
+  rparams->transposed_outer_reduction = true;
+  rparams->cross_block_inner_reduction = true;
+  rparams->block_dim_inner_reduction = ParallelType::TIDx;
+  rparams->cross_grid_inner_reduction = grdim > 1;
+  if (rparams->cross_grid_inner_reduction) {
+    rparams->split_grid_dim_inner_reduction = true;
+    rparams->grid_dim_inner_reduction = ParallelType::BIDy;
+  }
+  rparams->multiple_reds_per_blk = true;
+  rparams->block_dim_iter_dom = ParallelType::TIDy;
+  rparams->grid_dim_iter_dom = ParallelType::BIDx;
+  rparams->unroll_factor_inner_reduction = rows_per_thread;
+  rparams->static_bdimx = true;
+  rparams->static_bdimy = true;
+  rparams->lparams = LaunchParams(
+      LaunchParams::UNINITIALIZED_VAL,
+      grdim > 1 ? grdim : LaunchParams::UNINITIALIZED_VAL,
+      LaunchParams::UNINITIALIZED_VAL,
+      bdimx,
+      bdimy,
+      LaunchParams::UNINITIALIZED_VAL);
+
+  if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+    debug() << "\n===== Transposed Outer Reduction Stats ========\n"
+            << "total_reduction_numel: " << total_reduction_numel << "\n"
+            << "total_iteration_numel: " << total_iteration_numel << "\n"
+            << "grid(" << gidim << ", " << grdim << ", 1)" << std::endl;
+    debug() << rparams->toString() << std::endl;
+  }
+  return rparams;
+}
+
 std::unique_ptr<ReductionParams> reductionHeuristic(
     const int64_t total_reduction_numel,
     const int64_t total_iteration_numel,
@@ -1407,6 +1545,31 @@ std::unique_ptr<ReductionParams> reductionHeuristic(
   }
 }
 
+// Prefetches the next iteration of the serial reduction loop when each thread
+// runs it at least twice. Outer reductions and small inner reductions
+// typically have too few warps per SM to hide the latency of their loads
+// otherwise.
+int64_t serialPrefetchDepth(
+    const ReductionParams* rparams,
+    const int64_t total_reduction_numel) {
+  if (rparams->persistent_kernel || rparams->schedule_3D) {
+    return 0;
+  }
+  const auto dim = [&](ParallelType ptype) -> int64_t {
+    return rparams->lparams.hasDim(ptype) ? rparams->lparams.getDim(ptype)
+                                          : 1;
+  };
+  int64_t numel_per_iteration = rparams->unroll_factor_inner_reduction *
+      rparams->unroll_factor_top_of_vectorization;
+  if (rparams->cross_block_inner_reduction) {
+    numel_per_iteration *= dim(rparams->block_dim_inner_reduction);
+  }
+  if (rparams->cross_grid_inner_reduction) {
+    numel_per_iteration *= dim(rparams->grid_dim_inner_reduction);
+  }
+  return total_reduction_numel >= 2 * numel_per_iteration ? 1 : 0;
+}
+
 std::unique_ptr<ReductionParams> getReductionHeuristics(
     Fusion* fusion,
     SchedulerRuntimeInfo& runtime_info,
@@ -1492,6 +1655,14 @@ std::unique_ptr<ReductionParams> getReductionHeuristics(
   // Protect heuristics div by 0:
   n_tensor_inputs = std::max(n_tensor_inputs, 1l);
 
+  if (isOptionEnabled(EnableOption::TransposedOuterReduction) &&
+      canTransposeOuterReduction(fusion, reduction_tvs, properties)) {
+    auto heuristic = transposedOuterReductionHeuristic(
+        properties.total_reduction_numel, properties.total_iteration_numel);
+    heuristic->cparams.index_type = runtime_info.getIndexType();
+    return heuristic;
+  }
+
   auto heuristic = reductionHeuristic(
       properties.total_reduction_numel,
       properties.total_iteration_numel,
@@ -1501,10 +1672,148 @@ std::unique_ptr<ReductionParams> getReductionHeuristics(
       max_dtype_size,
       vectorize_factor);
   heuristic->cparams.index_type = runtime_info.getIndexType();
+  if (isOptionEnabled(EnableOption::SerialLoopPrefetch)) {
+    heuristic->serial_prefetch_depth =
+        serialPrefetchDepth(heuristic.get(), properties.total_reduction_numel);
+  }
   return heuristic;
 }
 
+// Largest cluster size that is guaranteed to be launchable
+constexpr int64_t kMaxPortableClusterSize = 8;
+
+// Whether the cross-grid inner reduction of rparams can be done within a
+// thread block cluster. The whole reduction segment has to fit in one cluster,
+// so the grid dimension of the reduction must be a small fixed size.
+bool canUseClusterReduction(Fusion* fusion, const ReductionParams* rparams) {
+  if (!rparams->fastest_dim || rparams->schedule_3D ||
+      rparams->persistent_kernel || !rparams->cross_grid_inner_reduction ||
+      rparams->grid_dim_inner_reduction != ParallelType::BIDx ||
+      !rparams->split_grid_dim_inner_reduction) {
+    return false;
+  }
+  const int64_t gdimx = rparams->lparams.gdimx();
+  if (gdimx < 2 || gdimx > kMaxPortableClusterSize) {
+    return false;
+  }
+  // Welford and grouped reductions have their own grid reduction routines
+  return !ir_utils::hasOpsOfType<WelfordOp, GroupedReductionOp>(fusion);
+}
+
+// Schedules the outer reduction of reduction_tv, canonicalized to [I, R], in
+// tiles that are transposed through shared memory, see
+// ReductionParams::transposed_outer_reduction:
+//
+//   partial   [BIDx, BIDy, rS, unroll, TIDy, TIDx(I)]  rows loaded by warps
+//   tile_smem [BIDx, BIDy, unroll, TIDy, TIDx(I)]      swizzled tile
+//   tile      [BIDx, BIDy, S, TIDy(I), TIDx]           columns loaded by warps
+//   reduction [BIDx, rBIDy, S, TIDy(I), rTIDx]         warp reductions
+//
+// where BIDy is only used if the rows are split across a grid reduction.
+void scheduleTransposedOuterReduction(
+    const ReductionParams* rparams,
+    TensorView* reduction_tv) {
+  const bool has_grid_reduction = rparams->cross_grid_inner_reduction;
+  const int64_t rows_per_thread = rparams->unroll_factor_inner_reduction;
+  NVF_ERROR(
+      rparams->lparams.bdimx() == kTransposeTile &&
+          rparams->lparams.bdimy() * rows_per_thread == kTransposeTile,
+      "Invalid transposed outer reduction parameters: ",
+      rparams->toString());
+
+  // [I, R] -> [I/32, 32, (BIDy), rS, r32]
+  reduction_tv->split(0, kTransposeTile);
+  reduction_tv->split(2, kTransposeTile);
+  if (has_grid_reduction) {
+    reduction_tv->split(2, rparams->lparams.gdimy(), false);
+  }
+  const int64_t serial_pos = has_grid_reduction ? 3 : 2;
+  TensorView* partial = reduction_tv->rFactor({serial_pos});
+
+  TensorView* tile_smem = partial->cacheAfter();
+  tile_smem->setMemoryType(MemoryType::Shared);
+  TensorView* tile = tile_smem->cacheAfter();
+
+  // [I/32, 32, (BIDy), rS, 32] -> [I/32, (BIDy), rS, unroll, TIDy, TIDx]
+  partial->split(-1, rows_per_thread, false);
+  partial->reorder({{1, -1}});
+  partial->axis(0)->parallelize(ParallelType::BIDx);
+  if (has_grid_reduction) {
+    partial->axis(1)->parallelize(ParallelType::BIDy);
+  }
+  partial->axis(-3)->parallelize(ParallelType::Unroll);
+  partial->axis(-2)->parallelize(ParallelType::TIDy);
+  partial->axis(-1)->parallelize(ParallelType::TIDx);
+
+  // [I/32, 32, (rBIDy), r32] -> [I/32, (rBIDy), S, TIDy, rTIDx]
+  reduction_tv->split(1, rparams->lparams.bdimy());
+  if (has_grid_reduction) {
+    reduction_tv->reorder({{3, 1}});
+  }
+  reduction_tv->axis(0)->parallelize(ParallelType::BIDx);
+  if (has_grid_reduction) {
+    reduction_tv->axis(1)->parallelize(ParallelType::BIDy);
+  }
+  reduction_tv->axis(-2)->parallelize(ParallelType::TIDy);
+  reduction_tv->axis(-1)->parallelize(ParallelType::TIDx);
+
+  // Reduce the columns within warps before the grid reduction
+  TensorView* reference_tv = has_grid_reduction
+      ? reduction_tv->rFactor({reduction_tv->nDims() - 1})
+      : reduction_tv;
+
+  // Threads are bound to different dimensions of the tile on each side of
+  // tile_smem, so each side is propagated from its own reference
+  const std::unordered_set<TensorView*> boundary{tile};
+  reduction_scheduler_utils::propagateTransformation(partial, boundary);
+  reduction_scheduler_utils::propagateTransformation(reference_tv, boundary);
+  const auto producer_tvs = scheduler_utils::getAllTvsFrom({partial}, {tile});
+  scheduler_utils::parallelizeAllLike(
+      partial, {producer_tvs.begin(), producer_tvs.end()});
+  const auto consumer_tvs =
+      scheduler_utils::getAllTvsFrom({reference_tv}, {tile_smem});
+  scheduler_utils::parallelizeAllLike(
+      reference_tv, {consumer_tvs.begin(), consumer_tvs.end()});
+
+  inlineMost();
+
+  // Warps store rows of the tile and load its columns, which would all hit
+  // the same bank without a swizzle
+  swizzleAllocation(tile_smem);
+}
+
 // fusion is the input IR that will be modified by this function
+// Circular-buffers the cached inputs in registers over the serial reduction
+// loop, so that the loads of the next prefetch_depth iterations are in flight
+// while the current one is reduced. Inputs not loaded within that loop, e.g.
+// of broadcast tensors, are left as is.
+void prefetchSerialLoads(
+    TensorView* reference_tv,
+    const std::vector<TensorView*>& cached_inputs,
+    const int64_t prefetch_depth) {
+  for (TensorView* tv : cached_inputs) {
+    if (tv->getMemoryType() != MemoryType::Local ||
+        !tv->definition()->isA<LoadStoreOp>() ||
+        tv->getComputeAtPosition() == 0 || tv->hasComputeWith() ||
+        tv->nDims() != reference_tv->nDims() ||
+        tv->axis(0)->getParallelType() == ParallelType::Unroll) {
+      continue;
+    }
+    IterDomain* axis = getCircularBufferAxis(tv);
+    if (axis == nullptr || axis->getParallelType() != ParallelType::Serial) {
+      continue;
+    }
+    const auto pos = std::distance(
+        tv->getLoopDomain().begin(),
+        std::find(
+            tv->getLoopDomain().begin(), tv->getLoopDomain().end(), axis));
+    if (!reference_tv->axis(pos)->isReduction()) {
+      continue;
+    }
+    tv->circularBuffer(prefetch_depth + 1, prefetch_depth);
+  }
+}
+
 void scheduleReduction(Fusion* fusion, const ReductionParams* rparams) {
   FusionGuard fg(fusion);
 
@@ -1561,6 +1870,17 @@ void scheduleReduction(Fusion* fusion, const ReductionParams* rparams) {
         "If all dims are reduction, should be sending it to fastest dim scheduler.");
   }
 
+  if (rparams->transposed_outer_reduction) {
+    NVF_ERROR(
+        reduction_tvs.size() == 1 && has_iter_axis,
+        "Transposed outer reduction needs a single reduction with an "
+        "iteration domain");
+    scheduleTransposedOuterReduction(rparams, reduction_tv);
+    scheduler_utils::promoteProducerMemoryTypes(fusion, cached_inputs);
+    markAliases(fusion);
+    return;
+  }
+
   TensorView* reference_tv = reduction_scheduler_utils::scheduleReductionTV(
       rparams, reduction_tv, has_iter_axis);
 
@@ -1600,6 +1920,25 @@ void scheduleReduction(Fusion* fusion, const ReductionParams* rparams) {
 
   scheduler_utils::promoteProducerMemoryTypes(fusion, cached_inputs);
 
+  if (rparams->serial_prefetch_depth > 0 && !rparams->persistent_kernel) {
+    prefetchSerialLoads(
+        reference_tv, cached_inputs, rparams->serial_prefetch_depth);
+  }
+
+  if (rparams->cluster_reduction) {
+    NVF_ERROR(
+        canUseClusterReduction(fusion, rparams),
+        "Invalid cluster reduction parameters: ",
+        rparams->toString());
+    // Codegen emits clusterReduce for the grid reductions when it sees
+    // cluster_reduction, which relies on each cluster spanning exactly the
+    // blocks of one reduction segment
+    fusion->manage(
+        "cluster_dims",
+        std::tuple<int64_t, int64_t, int64_t>{rparams->lparams.gdimx(), 1, 1});
+    fusion->manage("cluster_reduction", true);
+  }
+
   // TODO(#1401): We could let segmentation split a partially alias-producing
   // fusion into an alias-only segment and the rest. This way, the rest of the
   // fusion (which has fewer expressions) can potentially find a better
@@ -1766,6 +2105,13 @@ std::unique_ptr<HeuristicParams> ReductionScheduler::computeHeuristics(
   FUSER_PERF_SCOPE("ReductionScheduler::computeHeuristics");
   auto rparams = getReductionHeuristics(fusion, runtime_info, data_cache);
   NVF_ERROR(rparams != nullptr);
+  heuristic_plugin::updateHeuristicParams(
+      rparams.get(), fusion, runtime_info, data_cache);
+  // Decided after the plugin as it depends on the final grid size
+  rparams->cluster_reduction =
+      isOptionEnabled(EnableOption::ClusterReduction) &&
+      at::cuda::getCurrentDeviceProperties()->major >= 9 &&
+      canUseClusterReduction(fusion, rparams.get());
   return rparams;
 }
 
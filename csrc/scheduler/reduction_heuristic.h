@@ -119,6 +119,25 @@ class ReductionParams : public HeuristicParams {
   // Use computeWith to persistent buffers
   bool compute_persistent_buffer_with_first_consumer = false;
 
+  // Launch the blocks of each cross-grid inner reduction as one thread block
+  // cluster and combine their partial results through distributed shared
+  // memory instead of a global work buffer. Requires the grid dimension of the
+  // inner reduction to be a valid cluster size.
+  bool cluster_reduction = false;
+
+  // Reduce an outer reduction of a small iteration domain in tiles of 32 rows
+  // by 32 columns. Tiles are loaded a row per warp, accumulated in registers,
+  // and stored to shared memory, from where each warp reduces a column of the
+  // tile. Rows are split across blocks by a grid reduction on BIDy.
+  bool transposed_outer_reduction = false;
+
+  // Number of iterations of the serial reduction loop whose loads of the
+  // cached inputs are issued ahead of the iteration being reduced, by
+  // circular buffering the cached inputs in registers. 0 disables it. Only
+  // applies to non-persistent schedules, whose reduction loop is then not
+  // unswitched.
+  int64_t serial_prefetch_depth = 0;
+
   bool static_bdimx = false;
   bool static_bdimy = false;
 
@@ -202,7 +221,10 @@ class ReductionParams : public HeuristicParams {
         other->unroll_factor_top_of_vectorization ==
             unroll_factor_top_of_vectorization &&
         other->vectorization_factor_tmp_gmem_write ==
-            vectorization_factor_tmp_gmem_write;
+            vectorization_factor_tmp_gmem_write &&
+        other->cluster_reduction == cluster_reduction &&
+        other->transposed_outer_reduction == transposed_outer_reduction &&
+        other->serial_prefetch_depth == serial_prefetch_depth;
 
     if (other->static_bdimy || static_bdimy) {
       attr_equal = attr_equal && other->lparams.bdimy() == lparams.bdimy();
@@ -218,6 +240,8 @@ class ReductionParams : public HeuristicParams {
     ss << "\n===== Reduction Parameters ========\n"
        << (tag.empty() ? "" : "Tag: ") << tag << "\n"
        << (fastest_dim ? "Red On Fastest Dim\n" : "Red On Slow Dim\n")
+       << (transposed_outer_reduction ? "Transposed Through Shared Memory\n"
+                                      : "")
        << (persistent_kernel ? "Persistent Kernel\n" : "")
        << (project_persistent_buffers ? "Project Persistent Buffers\n" : "");
     if (batches_per_block_inner_reduction > 1 || persistent_kernel) {
@@ -275,6 +299,7 @@ class ReductionParams : public HeuristicParams {
     if (cross_grid_inner_reduction) {
       ss << "cross grid - " << grid_dim_inner_reduction << " / ";
       ss << (split_grid_dim_inner_reduction ? "split grid dim / " : "");
+      ss << (cluster_reduction ? "cluster / " : "");
     }
     if (batches_per_block_inner_reduction > 1 || persistent_kernel) {
       ss << "persistent batch - " << batches_per_block_inner_reduction << " / ";
@@ -293,6 +318,9 @@ class ReductionParams : public HeuristicParams {
     if (compute_persistent_buffer_with_first_consumer) {
       ss << "\ncomputeWith persistent buffers";
     }
+    if (serial_prefetch_depth > 0) {
+      ss << "\nSerial prefetch depth: " << serial_prefetch_depth;
+    }
 
     ss << "\n" << lparams.toString();
     ss << cparams.toString() << "\n";
@@ -327,7 +355,10 @@ class ReductionParams : public HeuristicParams {
         static_cast<size_t>(unroll_factor_outer_reduction) << (bits - 22) ^
         static_cast<size_t>(compute_persistent_buffer_with_first_consumer)
             << (bits - 23) ^
-        static_cast<size_t>(unroll_factor_top_of_vectorization) << (bits - 24);
+        static_cast<size_t>(unroll_factor_top_of_vectorization) << (bits - 24) ^
+        static_cast<size_t>(cluster_reduction) << (bits - 25) ^
+        static_cast<size_t>(transposed_outer_reduction) << (bits - 26) ^
+        static_cast<size_t>(serial_prefetch_depth) << (bits - 27);
     return attr_hash;
   }
 
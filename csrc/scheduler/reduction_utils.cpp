@@ -206,7 +206,11 @@ TensorView* scheduleReductionTV(
           inner_reduce_axis, rparams->unroll_factor_top_of_vectorization);
     }
 
-    inner_unswitch(inner_reduce_axis);
+    // An unswitched loop would be picked as the circular buffer loop of the
+    // prefetched loads instead of the serial reduction loop
+    if (rparams->serial_prefetch_depth == 0) {
+      inner_unswitch(inner_reduce_axis);
+    }
     if (rparams->cross_grid_inner_reduction) {
       if (rparams->split_grid_dim_inner_reduction) {
         outer_parallel(inner_reduce_axis, rparams->grid_dim_inner_reduction);
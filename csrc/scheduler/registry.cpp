@@ -10,6 +10,7 @@
 #include <scheduler/all_schedulers.h>
 #include <scheduler/debug_utils.h>
 #include <scheduler/heuristic.h>
+#include <scheduler/horizontal.h>
 #include <scheduler/matmul_utils.h>
 #include <scheduler/registry.h>
 #include <scheduler/registry_utils.h>
@@ -41,6 +42,45 @@ bool checkCanSchedule(Fusion* fusion, SchedulerType scheduler_type) {
     return false;
   }
 
+  // The same holds for `GroupedMatmulOp`, `SegmentedReductionOp`,
+  // `EmbeddingBwdOp`, `ScanOp`, `SortOp` and `TopKOp`, which have no codegen
+  // support
+  if (ir_utils::hasOpsOfType<GroupedMatmulOp>(fusion)) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        scheduler_type, "GroupedMatmulOp is not supported.");
+    return false;
+  }
+  if (ir_utils::hasOpsOfType<SegmentedReductionOp>(fusion)) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        scheduler_type, "SegmentedReductionOp is not supported.");
+    return false;
+  }
+  if (ir_utils::hasOpsOfType<EmbeddingBwdOp>(fusion)) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        scheduler_type, "EmbeddingBwdOp is not supported.");
+    return false;
+  }
+  if (ir_utils::hasOpsOfType<ScanOp>(fusion)) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        scheduler_type, "ScanOp is not supported.");
+    return false;
+  }
+  if (ir_utils::hasOpsOfType<SortOp, TopKOp>(fusion)) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        scheduler_type, "SortOp and TopKOp are not supported.");
+    return false;
+  }
+
+  // Threads storing to the same position of a scatter race, so the value kept
+  // for duplicate indices depends on the run. They are left to ATen's
+  // deterministic implementation instead.
+  if (isOptionEnabled(EnableOption::DeterministicReductions) &&
+      ir_utils::hasOpsOfType<ScatterOp>(fusion)) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        scheduler_type, "ScatterOp is not deterministic.");
+    return false;
+  }
+
   // Fusions with `MatmulOp, LinearOp, MmaOp` can only be accepted by Matmul
   // scheduler.
   if (scheduler_type != SchedulerType::Matmul &&
@@ -50,7 +90,9 @@ bool checkCanSchedule(Fusion* fusion, SchedulerType scheduler_type) {
     return false;
   }
 
-  if (!registry_utils::isConnectedFusionGraph(fusion)) {
+  // Only the horizontal scheduler fuses independent subgraphs
+  if (scheduler_type != SchedulerType::Horizontal &&
+      !registry_utils::isConnectedFusionGraph(fusion)) {
     scheduler_debug_utils::canScheduleRejectReason(
         scheduler_type, "Connected fusion graph check failed!");
     return false;
@@ -93,6 +135,8 @@ std::unique_ptr<SchedulerEntry> SchedulerEntry::makeSchedulerInstance(
       return std::make_unique<ExprEvalScheduler>();
     case SchedulerType::Resize:
       return std::make_unique<ResizeScheduler>();
+    case SchedulerType::Horizontal:
+      return std::make_unique<HorizontalScheduler>();
     default:
       NVF_THROW("unreachable");
   }
@@ -125,6 +169,7 @@ bool canSchedule(
     SchedulerRuntimeInfo& runtime_info,
     HeuristicDataCache* data_cache,
     bool skip_compile_time_checks) {
+  FUSER_COMPILE_PHASE_SCOPE(toString(scheduler_type) + " canSchedule");
   // If a data cache is given, the compile time part doesn't need to be checked,
   // since during segmentation the segmenter will call
   // SchedulerEntry::proposeHeuristics which doesn't pass a data_cache.
@@ -59,6 +59,61 @@ std::pair<TensorView*, int64_t> getLargestTensor(
   return std::make_pair(largest_tv, max_num_elms);
 }
 
+// Returns true if id is exact mapped with the concatenated dimension of cat
+// ops that all concatenate two halves of equal extent, like the rotate_half
+// of rotary embeddings:
+//
+//   x1 = x[..., : d / 2]
+//   x2 = x[..., d / 2 :]
+//   y = cat([-x2, x1], -1)
+//
+// The extents of the halves are only compared when an evaluator is given.
+bool isRotateHalfId(
+    Fusion* fusion,
+    IterDomain* id,
+    const ValGraph& exact_graph,
+    ExpressionEvaluator* expr_eval) {
+  if (!exact_graph.hasGroup(id)) {
+    return false;
+  }
+  bool found = false;
+  for (auto cat : ir_utils::getOpsOfType<CatOp>(fusion)) {
+    const int64_t cat_dim = cat->concatenatedDim();
+    auto out_tv = cat->output(0)->as<TensorView>();
+    IterDomain* cat_id =
+        TensorDomain::noReductions(out_tv->getLogicalDomain()).at(cat_dim);
+    if (!exact_graph.hasGroup(cat_id) ||
+        !exact_graph.disjointValSets().strictAreMapped(cat_id, id)) {
+      continue;
+    }
+    if (cat->inputs().size() != 2) {
+      return false;
+    }
+    if (expr_eval != nullptr) {
+      std::vector<int64_t> half_extents;
+      for (auto inp : cat->inputs()) {
+        auto pad = dynamic_cast<PadOp*>(inp->definition());
+        if (pad == nullptr) {
+          return false;
+        }
+        auto half_tv = pad->in()->as<TensorView>();
+        IterDomain* half_id =
+            TensorDomain::noReductions(half_tv->getLogicalDomain()).at(cat_dim);
+        auto extent = expr_eval->evaluate(half_id->extent());
+        if (!extent.hasValue()) {
+          return false;
+        }
+        half_extents.push_back(extent.as<int64_t>());
+      }
+      if (half_extents.at(0) != half_extents.at(1) || half_extents.at(0) == 0) {
+        return false;
+      }
+    }
+    found = true;
+  }
+  return found;
+}
+
 } // namespace
 
 bool ResizeScheduler::canScheduleCompileTime(Fusion* fusion) {
@@ -248,6 +303,25 @@ std::unique_ptr<HeuristicParams> ResizeScheduler::computeHeuristics(
       (int64_t)vec_ref_tv->getLogicalDomain().size() - 1,
       {});
 
+  // The reference is reordered like the allocation domain of the largest
+  // input, so the innermost IDs of both need to be the rotated dimension
+  if (ir_utils::hasOpsOfType<CatOp>(fusion)) {
+    IdModel id_model(fusion, /*build_graphs=*/false);
+    const auto& exact_graph = id_model.buildExactGraph();
+    params->split_rotate_half = isRotateHalfId(
+        fusion,
+        ref_tv->getLogicalDomain().back(),
+        exact_graph,
+        &runtime_info.expressionEvaluator());
+    if (params->split_rotate_half && largest_input != nullptr) {
+      auto alloc = TensorDomain::noBroadcasts(TensorDomain::noReductions(
+          largest_input->getMaybeAllocationDomain()));
+      params->split_rotate_half = !alloc.empty() &&
+          exact_graph.disjointValSets().strictAreMapped(
+              alloc.back(), ref_tv->getLogicalDomain().back());
+    }
+  }
+
   return params;
 }
 
@@ -391,6 +465,21 @@ void ResizeScheduler::schedule(Fusion* fusion, const HeuristicParams* params) {
 
   const int64_t vec_factor = resize_params->vectorization_factor;
 
+  // Split a rotate-half style concatenation into its halves, so that each
+  // thread computes the same vector of both halves in a loop of two
+  // iterations. The offsets of the resize ops are then constant in each
+  // iteration instead of depending on the index of the rotated dimension.
+  const bool split_rotate_half = resize_params->split_rotate_half &&
+      isRotateHalfId(
+          fusion,
+          ref_tv->getLoopDomain().back(),
+          id_model->idGraph(IdMappingMode::EXACT),
+          nullptr);
+  if (split_rotate_half) {
+    ref_tv->split(-1, 2, /*inner_split=*/false);
+    // [..., 2, I0/2]
+  }
+
   int64_t next_innermost_pos = -1;
   // [..., ...]
   //        ^
@@ -404,6 +493,15 @@ void ResizeScheduler::schedule(Fusion* fusion, const HeuristicParams* params) {
     //   +--- next_innermost_pos
   }
 
+  if (split_rotate_half) {
+    ref_tv->reorder(std::unordered_map<int64_t, int64_t>{
+        {next_innermost_pos - 1, next_innermost_pos}});
+    --next_innermost_pos;
+    // [..., I0/2, 2, vec_factor]
+    //   ^
+    //   +--- next_innermost_pos
+  }
+
   ref_tv->flatten(outermost_pos, next_innermost_pos);
   // [..., I0, vec_factor]
   //       ^
@@ -27,6 +27,10 @@ class ResizeParams : public HeuristicParams {
 
   int64_t vectorization_factor = 1;
 
+  // Split the innermost dimension of the reference into the halves of a
+  // rotate-half style concatenation, e.g., of rotary embeddings
+  bool split_rotate_half = false;
+
   static constexpr int64_t max_gdimx = (1L << 31) - 1L;
 
   using HeuristicParams::HeuristicParams;
@@ -40,7 +44,8 @@ class ResizeParams : public HeuristicParams {
     bool attr_equal = other->cparams == cparams &&
         other->split_grid_x_dim == split_grid_x_dim &&
         other->largest_input == largest_input &&
-        other->vectorization_factor == vectorization_factor;
+        other->vectorization_factor == vectorization_factor &&
+        other->split_rotate_half == split_rotate_half;
     return attr_equal;
   }
 
@@ -50,7 +55,8 @@ class ResizeParams : public HeuristicParams {
        << (tag.empty() ? "" : "Tag: ") << tag << " Resize Characteristics:\n"
        << " split grid x dim: " << split_grid_x_dim << "\n"
        << " index of largest input: " << largest_input << "\n"
-       << " vectorization factor: " << vectorization_factor << "\n";
+       << " vectorization factor: " << vectorization_factor << "\n"
+       << " split rotate half: " << split_rotate_half << "\n";
     ss << "====================================\n";
     return ss.str();
   }
@@ -140,6 +140,33 @@ size_t SchedulerRuntimeInfo::getAlignmentSize(TensorView* tv) {
     return alignment_entry->second;
   }
 
+  // An output written in place of a slice of an input is as aligned as the
+  // slice, whose start depends on the offset and whose outer dimensions keep
+  // the strides of the input. See Fusion::aliasOutputToInputSlice.
+  const AliasInfo& alias_info = complete_fusion_->getOutputAlias(tv);
+  if (alias_info.slice_offset != nullptr) {
+    auto* aliased_tv = alias_info.aliased_io->as<TensorView>();
+    const auto dtype_size = (size_t)dataTypeSize(aliased_tv->dtype());
+    const std::vector<int64_t>& strides =
+        input_strides_elements_.at(aliased_tv);
+    const auto offset =
+        expression_evaluator_->evaluate(alias_info.slice_offset)
+            .as<int64_t>();
+    size_t alignment_size = std::min(
+        getAlignmentSize(aliased_tv),
+        SchedulerRuntimeInfo::computeAlignmentSize(
+            (size_t)(offset * strides.at(alias_info.slice_axis)) *
+            dtype_size));
+    for (auto dim : c10::irange(alias_info.slice_axis)) {
+      alignment_size = std::min(
+          alignment_size,
+          SchedulerRuntimeInfo::computeAlignmentSize(
+              (size_t)strides.at(dim) * dtype_size));
+    }
+    alignment_map_[tv] = alignment_size;
+    return alignment_size;
+  }
+
   auto alignment_size = SchedulerRuntimeInfo::computeAlignmentSize(ptrOf(tv));
   auto strides_it = input_discontig_strides_.find(tv);
   if (strides_it != input_discontig_strides_.end()) {
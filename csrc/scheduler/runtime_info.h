@@ -58,8 +58,9 @@ class SchedulerRuntimeInfo : public NonCopyable {
 
   //! Lookup for the alignment sizes of the given tv. Currently only returns
   //!  actual alignment info for input tensors to the complete fusion,
-  //!  and for other intermediate/fuser-allocated tensors will
-  //!  return max_alignment_size_in_byte.
+  //!  and for outputs written in place of a slice of an input. Other
+  //!  intermediate/fuser-allocated tensors will return
+  //!  max_alignment_size_in_byte.
   size_t getAlignmentSize(TensorView* tv);
 
   //! Returns sizes of tensor dimensions in same order as allocation domain,
@@ -57,11 +57,12 @@ enum class SchedulerType {
   OuterPersistent,
   Transpose,
   ExprEval,
-  Resize
+  Resize,
+  Horizontal
 };
 
 //! Define a schedule table to loop over all the heuristics in priority order.
-constexpr std::array<SchedulerType, 10> all_heuristics_in_priority_order = {
+constexpr std::array<SchedulerType, 11> all_heuristics_in_priority_order = {
     SchedulerType::ExprEval,
     SchedulerType::NoOp,
     SchedulerType::Matmul,
@@ -69,6 +70,7 @@ constexpr std::array<SchedulerType, 10> all_heuristics_in_priority_order = {
     SchedulerType::Resize,
     SchedulerType::Transpose,
     SchedulerType::PointWise,
+    SchedulerType::Horizontal,
     SchedulerType::InnerPersistent,
     SchedulerType::OuterPersistent,
     SchedulerType::InnerOuterPersistent};
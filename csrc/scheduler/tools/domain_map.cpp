@@ -423,6 +423,83 @@ TensorView* PointwiseDomainMap::findReferenceTensor(
   return result;
 }
 
+TransposeDomainMap::TransposeDomainMap(Fusion* fusion)
+    : DomainMap(fusion), shared_inner_dim_(findSharedInnerDim()) {}
+
+namespace {
+
+// Inputs and outputs that the transpose scheduler groups
+std::vector<TensorView*> groupedInputsOutputs(Fusion* fusion) {
+  std::vector<TensorView*> tvs;
+  for (auto tv : ir_utils::filterByType<TensorView>(fusion->outputs())) {
+    tvs.push_back(tv);
+  }
+  for (auto tv : ir_utils::filterByType<TensorView>(fusion->inputs())) {
+    if (tv->uses().empty() || ir_utils::isTorchGatherLookupTv(tv) ||
+        ir_utils::isIndexSelectLookupTv(tv)) {
+      continue;
+    }
+    tvs.push_back(tv);
+  }
+  return tvs;
+}
+
+} // namespace
+
+IterDomain* TransposeDomainMap::findSharedInnerDim() const {
+  if (!scheduler_utils::getViewTVs(fusion_).empty()) {
+    return nullptr;
+  }
+  IterDomain* shared_inner_dim = nullptr;
+  for (auto tv : groupedInputsOutputs(fusion_)) {
+    IterDomain* inner_dim = scheduler_utils::innerMostAllocDim(tv);
+    if (inner_dim == nullptr) {
+      return nullptr;
+    }
+    if (shared_inner_dim == nullptr) {
+      shared_inner_dim = inner_dim;
+    } else if (!ca_map_.areMapped(
+                   shared_inner_dim, inner_dim, IdMappingMode::EXACT)) {
+      return nullptr;
+    }
+  }
+  if (shared_inner_dim == nullptr) {
+    return nullptr;
+  }
+
+  // There's nothing to transpose if the dims left of the shared one are also
+  // shared
+  IterDomain* outer_dim = nullptr;
+  for (auto tv : groupedInputsOutputs(fusion_)) {
+    const auto& alloc_dom = tv->getMaybeAllocationDomain();
+    auto it = std::find_if(alloc_dom.rbegin(), alloc_dom.rend(), [&](auto id) {
+      return !id->isReduction() && !id->isBroadcast() &&
+          !ca_map_.areMapped(id, shared_inner_dim, IdMappingMode::EXACT);
+    });
+    if (it == alloc_dom.rend()) {
+      return nullptr;
+    }
+    if (outer_dim == nullptr) {
+      outer_dim = *it;
+    } else if (!ca_map_.areMapped(outer_dim, *it, IdMappingMode::EXACT)) {
+      return shared_inner_dim;
+    }
+  }
+  return nullptr;
+}
+
+IterDomain* TransposeDomainMap::groupInnerDim(TensorView* tv) const {
+  if (shared_inner_dim_ == nullptr) {
+    return scheduler_utils::innerMostAllocDim(tv);
+  }
+  const auto& alloc_dom = tv->getMaybeAllocationDomain();
+  auto it = std::find_if(alloc_dom.rbegin(), alloc_dom.rend(), [&](auto id) {
+    return !id->isReduction() && !id->isBroadcast() &&
+        !ca_map_.areMapped(id, shared_inner_dim_, IdMappingMode::EXACT);
+  });
+  return it == alloc_dom.rend() ? nullptr : *it;
+}
+
 TensorView* TransposeDomainMap::findReferenceFor(
     const std::vector<TensorView*>& group) const {
   TensorView* result = nullptr;
@@ -476,7 +553,7 @@ bool TransposeDomainMap::hasAtLeastTwoValidGroups(Fusion* fusion) {
   }
   // reference 1 is the global reference, so it must have dim mapped the
   // innermost dim of both groups
-  auto innermost2 = scheduler_utils::innerMostAllocDim(ref2);
+  auto innermost2 = domain_map.groupInnerDim(ref2);
   return domain_map.getMappedAllocDimIn(ref1, innermost2) != nullptr;
 }
 
@@ -538,6 +615,32 @@ int64_t TransposeDomainMap::getInnerLeafDim(
 std::vector<std::vector<TensorView*>> TransposeDomainMap::
     groupInputsOutputsByInnerDim() const {
   std::vector<std::vector<TensorView*>> groups;
+  if (shared_inner_dim_ != nullptr) {
+    // Views are excluded, so the dims left of the shared inner dim are
+    // grouped by exact mapping
+    std::vector<IterDomain*> group_inner_dims;
+    for (auto tv : groupedInputsOutputs(fusion_)) {
+      IterDomain* inner_dim = groupInnerDim(tv);
+      auto it = std::find_if(
+          group_inner_dims.begin(), group_inner_dims.end(), [&](auto id) {
+            return ca_map_.areMapped(id, inner_dim, IdMappingMode::EXACT);
+          });
+      if (it == group_inner_dims.end()) {
+        group_inner_dims.push_back(inner_dim);
+        groups.emplace_back(std::vector<TensorView*>{tv});
+      } else {
+        groups.at(std::distance(group_inner_dims.begin(), it)).push_back(tv);
+      }
+    }
+    std::stable_sort(
+        groups.begin(),
+        groups.end(),
+        [](const std::vector<TensorView*>& v1,
+           const std::vector<TensorView*>& v2) {
+          return v1.size() > v2.size();
+        });
+    return groups;
+  }
   auto output_tvs = ir_utils::filterByType<TensorView>(fusion_->outputs());
   auto input_tvs = ir_utils::filterByType<TensorView>(fusion_->inputs());
   std::unordered_set<TensorView*> grouped;
@@ -91,7 +91,7 @@ class PointwiseDomainMap : public scheduler_tools::DomainMap {
 // that maps to all iterDomains in the fusion.
 class TransposeDomainMap : public scheduler_tools::DomainMap {
  public:
-  using scheduler_tools::DomainMap::DomainMap;
+  TransposeDomainMap(Fusion* fusion);
 
   // Note that this may not be able to find any reference if any
   // tensor in the group is only connected with an input through
@@ -144,12 +144,31 @@ class TransposeDomainMap : public scheduler_tools::DomainMap {
   // different group with T1 and T3.
   std::vector<std::vector<TensorView*>> groupInputsOutputsByInnerDim() const;
 
+  // The inner-most allocation dim shared by all inputs and outputs, e.g., D
+  // of a permutation [B, H, S, D] -> [B, S, H, D] of attention heads. With
+  // such a dim, the groups are told apart by the dims left of it, and the
+  // shared dim is kept inner-most in the tiles of both groups. Returns nullptr
+  // if there's no such dim, if all the tensors also share the dim left of it,
+  // or if the fusion has view ops.
+  IterDomain* sharedInnerDim() const {
+    return shared_inner_dim_;
+  }
+
+  // The inner-most allocation dim of tv that tells its group apart, i.e.,
+  // the inner-most one not mapped to sharedInnerDim()
+  IterDomain* groupInnerDim(TensorView* tv) const;
+
   // In the transpose scheculing, unlike the pointwise scheduling, the
   // permissive map is required to find reference tensors. See also PR
   // #661
   IterDomain* getMappedInputConcreteID(
       const std::unordered_set<IterDomain*>& in_concrete_ids,
       IterDomain* out_id) const override;
+
+ private:
+  IterDomain* findSharedInnerDim() const;
+
+  IterDomain* shared_inner_dim_ = nullptr;
 };
 
 } // namespace scheduler_tools
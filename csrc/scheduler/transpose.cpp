@@ -9,7 +9,9 @@
 #include <ATen/cuda/CUDAContext.h>
 #include <debug.h>
 #include <instrumentation.h>
+#include <options.h>
 #include <scheduler/debug_utils.h>
+#include <scheduler/heuristic_plugin.h>
 #include <scheduler/reduction_utils.h>
 #include <scheduler/registry_utils.h>
 #include <scheduler/runtime_info.h>
@@ -18,6 +20,8 @@
 #include <scheduler/utils.h>
 #include <scheduler/vectorize_helper.h>
 
+#include <cmath>
+
 namespace nvfuser {
 
 bool TransposeScheduler::canScheduleCompileTime(Fusion* fusion) {
@@ -99,7 +103,7 @@ namespace {
 //
 // This function checks the inner `n` iterdomain and reorder reduction
 // iterdomain to the beginning.
-void moveReductionsOut(TensorView* tv, int n) {
+void moveReductionsOut(TensorView* tv, int64_t n) {
   if (!tv->isFusionInput()) {
     return;
   }
@@ -422,7 +426,7 @@ getInnerMostDimInfoInReference(
             std::vector<int64_t> data;
             data.reserve(group_references.size());
             for (auto ref_tv : group_references) {
-              auto inner_most_id = scheduler_utils::innerMostAllocDim(ref_tv);
+              auto inner_most_id = domain_map.groupInnerDim(ref_tv);
               auto inner_most_pos_in_global_ref =
                   domain_map.getInnerLeafDim(global_reference, inner_most_id);
               data.emplace_back(inner_most_pos_in_global_ref);
@@ -432,6 +436,10 @@ getInnerMostDimInfoInReference(
   return innermost_info_entry;
 }
 
+// Largest shared inner-most dim, in bytes, the transpose scheduler tiles.
+// Beyond it, the pointwise scheduler accesses enough contiguous bytes.
+constexpr int64_t kMaxSharedInnerDimBytes = 64;
+
 // If can schedule at runtime, returns empty string, otherwise returns the
 // reason why we should not schedule at runtime.
 std::string getTransposeRuntimeRejectReason(
@@ -478,15 +486,40 @@ std::string getTransposeRuntimeRejectReason(
   auto inner_size1 = shape_in_ref1[inner_most_pos1_in_ref1];
   auto inner_size2 = shape_in_ref1[inner_most_pos2_in_ref1];
 
+  // The pointwise scheduler already moves whole sectors when the shared
+  // inner-most dim is large enough
+  int64_t shared_inner_pos_in_ref1 = -1;
+  int64_t shared_inner_size = 1;
+  if (IterDomain* shared_inner_dim = domain_map.sharedInnerDim()) {
+    shared_inner_pos_in_ref1 =
+        domain_map.getInnerLeafDim(reference1, shared_inner_dim);
+    shared_inner_size = shape_in_ref1.at(shared_inner_pos_in_ref1);
+    int64_t max_io_dtype_size = 1;
+    for (const auto& vals : {fusion->inputs(), fusion->outputs()}) {
+      for (auto tv : ir_utils::filterByType<TensorView>(vals)) {
+        max_io_dtype_size = std::max(
+            max_io_dtype_size,
+            dataTypeSize(tv->dtype(), runtime_info.getIndexType()));
+      }
+    }
+    if (shared_inner_size * max_io_dtype_size > kMaxSharedInnerDimBytes) {
+      return "The shared inner-most dim is large enough for the pointwise "
+             "scheduler to coalesce memory accesses";
+    }
+  }
+
   // For cases like
   //   transpose(T0[1000000000, 2, 2], 1, 2)
   // the pointwise scheduler should provide better performance, because it
   // provides coalesced memory access
-  if (inner_size1 * inner_size2 < (int64_t)default_tile_elements) {
-    auto inner_elements = inner_size1 * inner_size2;
+  if (inner_size1 * inner_size2 * shared_inner_size <
+      (int64_t)default_tile_elements) {
+    auto inner_elements = inner_size1 * inner_size2 * shared_inner_size;
     for (int64_t i = inner_most_pos2_in_ref1 + 1; i < inner_most_pos1_in_ref1;
          i++) {
-      inner_elements *= shape_in_ref1[i];
+      if (i != shared_inner_pos_in_ref1) {
+        inner_elements *= shape_in_ref1[i];
+      }
     }
     // note that the algorithm here is only an approximation because it only
     // checks reference1. In principle, we need to check all inputs and outputs
@@ -617,16 +650,35 @@ std::unique_ptr<TransposeParams> getTransposeHeuristics(
   tparams->tag = "Transpose heuristics";
   tparams->cparams.index_type = index_type;
 
-  // Expand inner-most dims to virtual inner-most dims so that the inner-most
-  // dims has at least tile_size elements
-  // See note [Supporting small transpose dimensions]
-  maybeBuildVirtualInnerDims(
-      tparams.get(),
-      device_multiprocessor_count,
-      n_elems,
-      shape_in_ref1,
-      inner_most_pos1_in_ref1,
-      inner_most_pos2_in_ref1);
+  int64_t shared_inner_pos_in_ref1 = -1;
+  if (IterDomain* shared_inner_dim = domain_map.sharedInnerDim()) {
+    // The tiles are [tile_size1, tile_size2, shared_inner_size], so shrink
+    // the tiled dims to keep about as many elements per tile as in 2D. The
+    // shared dim is small and already makes the inner-most dims of both
+    // groups contiguous chunks, so no virtual inner-most dims are built.
+    shared_inner_pos_in_ref1 =
+        domain_map.getInnerLeafDim(reference1, shared_inner_dim);
+    tparams->shared_inner_size = shape_in_ref1.at(shared_inner_pos_in_ref1);
+    const int64_t default_tile_elements =
+        TransposeParams::getDefaultTileSize() *
+        TransposeParams::getDefaultTileSize();
+    tparams->tile_size1 = std::max<int64_t>(
+        8,
+        scheduler_utils::lastPow2((int64_t)std::sqrt(
+            default_tile_elements / tparams->shared_inner_size)));
+    tparams->tile_size2 = tparams->tile_size1;
+  } else {
+    // Expand inner-most dims to virtual inner-most dims so that the
+    // inner-most dims has at least tile_size elements
+    // See note [Supporting small transpose dimensions]
+    maybeBuildVirtualInnerDims(
+        tparams.get(),
+        device_multiprocessor_count,
+        n_elems,
+        shape_in_ref1,
+        inner_most_pos1_in_ref1,
+        inner_most_pos2_in_ref1);
+  }
 
   NVF_ERROR(
       !hasSmallTransposeDimensions(tparams) ||
@@ -687,15 +739,12 @@ std::unique_ptr<TransposeParams> getTransposeHeuristics(
 
   // Don't unroll at the cost of getting a full wave on the GPU
   auto max_unroll_factor_occupancy = ceilDiv(
-      n_elems,
-      device_multiprocessor_count * (int64_t)tparams->tile_size1 *
-          (int64_t)tparams->tile_size2);
+      n_elems, device_multiprocessor_count * tparams->getElementsPerTile());
   max_unroll_factor = std::min(max_unroll_factor, max_unroll_factor_occupancy);
 
   // Don't unroll at the cost of getting a full warp, useful for the case where
   // tile sizes are small
-  auto max_unroll_factor_block =
-      ceilDiv((int64_t)tparams->tile_size1 * (int64_t)tparams->tile_size2, 32l);
+  auto max_unroll_factor_block = ceilDiv(tparams->getElementsPerTile(), 32l);
   max_unroll_factor = std::min(max_unroll_factor, max_unroll_factor_block);
 
   // Note: [Computing Vectorization Width for Transpose]
@@ -737,27 +786,80 @@ std::unique_ptr<TransposeParams> getTransposeHeuristics(
     // simply map those merged domains via ContiguousInnerDimensionsMapper
     scheduler_utils::splitDims(reference1, tparams->split_before_tiling);
 
-    tparams->vectorize_factor1 =
-        vectorize_helper::getVectorizationFactorTransposeGroup(
+    // With a shared inner-most dim, the contiguous inner dims of a group are
+    // its inner-most dim merged with the shared one
+    auto vectorization_factor = [&](int64_t inner_most_pos,
+                                    const std::vector<int64_t>& dims_merged,
+                                    const std::vector<TensorView*>& group) {
+      if (shared_inner_pos_in_ref1 >= 0) {
+        return vectorize_helper::getVectorizationFactorTransposeGroup(
             runtime_info,
             reference1,
-            inner_most_pos1_in_ref1,
-            tparams->dims_merged_with_1,
-            grouped_inputs_outputs[0],
+            shared_inner_pos_in_ref1,
+            {inner_most_pos},
+            group,
             max_unroll_factor);
+      }
+      return vectorize_helper::getVectorizationFactorTransposeGroup(
+          runtime_info,
+          reference1,
+          inner_most_pos,
+          dims_merged,
+          group,
+          max_unroll_factor);
+    };
+
+    tparams->vectorize_factor1 = vectorization_factor(
+        inner_most_pos1_in_ref1,
+        tparams->dims_merged_with_1,
+        grouped_inputs_outputs[0]);
 
     // TODO: Since group2 only has global->shared and shared->global set op, we
     // can have fine-grained control of unroll/vectorization at per tensor
     // level. We should not be using a single global vectorize factor for the
     // entire group 2
-    tparams->vectorize_factor2 =
-        vectorize_helper::getVectorizationFactorTransposeGroup(
-            runtime_info,
-            reference1,
-            inner_most_pos2_in_ref1,
-            tparams->dims_merged_with_2,
-            grouped_inputs_outputs[1],
-            max_unroll_factor);
+    tparams->vectorize_factor2 = vectorization_factor(
+        inner_most_pos2_in_ref1,
+        tparams->dims_merged_with_2,
+        grouped_inputs_outputs[1]);
+  }
+
+  // Without a swizzle, a wave of CTAs reads whole rows of tiles of group 1
+  // and writes columns of tiles of group 2 that are far apart, so that the
+  // sectors of a tile partially read or written by a CTA are evicted before
+  // its neighbors along the outer tiled dim use them. Virtual inner-most dims
+  // are left alone, as the extents of their tiles are not known here, and so
+  // are 3D tiles.
+  if (isOptionEnabled(EnableOption::GridSwizzle) &&
+      !hasSmallTransposeDimensions(tparams) &&
+      tparams->shared_inner_size == 1) {
+    const int64_t outer_pos =
+        std::min(inner_most_pos1_in_ref1, inner_most_pos2_in_ref1);
+    const int64_t inner_pos =
+        std::max(inner_most_pos1_in_ref1, inner_most_pos2_in_ref1);
+    auto tile_size = [&](int64_t pos) {
+      return pos == inner_most_pos1_in_ref1 ? tparams->tile_size1
+                                            : tparams->tile_size2;
+    };
+    // The grid dims right of the outer tiled dim are merged into its faster
+    // part
+    int64_t num_fast_tiles =
+        ceilDiv(shape_in_ref1.at(inner_pos), tile_size(inner_pos));
+    for (auto pos : c10::irange(outer_pos + 1, (int64_t)shape_in_ref1.size())) {
+      if (pos != inner_pos) {
+        num_fast_tiles *= shape_in_ref1.at(pos);
+      }
+    }
+    const int64_t ctas_per_wave = device_multiprocessor_count *
+        (int64_t)at::cuda::getCurrentDeviceProperties()
+            ->maxThreadsPerMultiProcessor /
+        tparams->getThreadsPerBlock();
+    tparams->grid_swizzle_factor = scheduler_utils::getGridSwizzleFactor(
+        ceilDiv(shape_in_ref1.at(outer_pos), tile_size(outer_pos)),
+        num_fast_tiles,
+        tparams->tile_size1 * tparams->tile_size2 * max_io_dtype_size *
+            n_io_tensors,
+        ctas_per_wave);
   }
 
   tparams->lparams.bind(tparams->getThreadsPerBlock(), ParallelType::TIDx);
@@ -893,8 +995,20 @@ void scheduleTranspose(Fusion* fusion, const TransposeParams* tparams) {
       reference2 != nullptr,
       "Could not find a fully broadcasted tensor to reference schedule on the second group.");
 
-  auto inner_most_id1 = scheduler_utils::innerMostAllocDim(reference1);
-  auto inner_most_id2 = scheduler_utils::innerMostAllocDim(reference2);
+  auto inner_most_id1 = domain_map.groupInnerDim(reference1);
+  auto inner_most_id2 = domain_map.groupInnerDim(reference2);
+
+  // With a dim shared by both groups, the tiles are [tile1, tile2, shared],
+  // so that both groups access contiguous chunks of tile * shared elements
+  IterDomain* shared_inner_id = nullptr;
+  if (IterDomain* shared_inner_dim = domain_map.sharedInnerDim()) {
+    NVF_ERROR(
+        !hasSmallTransposeDimensions(tparams),
+        "Virtual inner-most dims are not built with a shared inner-most dim");
+    shared_inner_id = reference1->axis(
+        domain_map.getInnerLeafDim(reference1, shared_inner_dim));
+  }
+  const int64_t n_tile_dims = shared_inner_id == nullptr ? 2 : 3;
 
   //////////////////////////////////////////
   // Step 1: Make virtual inner most dims //
@@ -953,13 +1067,34 @@ void scheduleTranspose(Fusion* fusion, const TransposeParams* tparams) {
   reference1->reorder({{inner_most_pos2_in_ref1 + 1, -1}});
   // [..., I1/tile1, .., I2/tile2, ..., tile1, tile2]
 
+  if (shared_inner_id != nullptr) {
+    const auto& loop_domain = reference1->getLoopDomain();
+    auto shared_it =
+        std::find(loop_domain.begin(), loop_domain.end(), shared_inner_id);
+    NVF_ERROR(shared_it != loop_domain.end());
+    reference1->reorder(
+        {{std::distance(loop_domain.begin(), shared_it), -1}});
+    // [..., I1/tile1, .., I2/tile2, ..., tile1, tile2, shared]
+  }
+
+  if (tparams->grid_swizzle_factor > 1) {
+    // Move a factor of the outer tiled dim right of all the other grid dims,
+    // so that consecutive CTAs walk a group of tiles along it
+    const int64_t outer_pos =
+        std::min(inner_most_pos1_in_ref1, inner_most_pos2_in_ref1);
+    reference1->split(outer_pos, tparams->grid_swizzle_factor);
+    reference1->reorder(
+        {{outer_pos + 1, reference1->nDims() - n_tile_dims - 1}});
+    // [..., I/tile/swizzle, .., I'/tile', ..., swizzle, tile1, tile2]
+  }
+
   // Merge remaining dimensions ignoring reduction axes (See Issue #2317)
   // The reduction axes cannot be at any position.
   // For example: [i0, r1, i1, r2, i2] after tiling is [i0, r1, i1/tile1, r2,
   // i2/tile2, tile1, tile2] The following code merges all the outer iterdomains
   // as: [i0 * i1/tile1 * i2/tile2, r1, r2, tile1, tile2]
-  int64_t rhs_i = reference1->nDims() - 3;
-  for (int64_t lhs_i = reference1->nDims() - 4; lhs_i >= 0; lhs_i--) {
+  int64_t rhs_i = reference1->nDims() - n_tile_dims - 1;
+  for (int64_t lhs_i = rhs_i - 1; lhs_i >= 0; lhs_i--) {
     if (reference1->axis(lhs_i)->isReduction() ||
         reference1->axis(lhs_i)->isDeviceDim()) {
       continue;
@@ -1001,10 +1136,12 @@ void scheduleTranspose(Fusion* fusion, const TransposeParams* tparams) {
   // transform tile for vectorization/unroll
   // See note [vectorization and unroll of input and output]
 
-  int64_t pos = reference2->nDims() - 2;
-  // [..., tile1, tile2]
-  moveReductionsOut(reference2, 2);
-  reference2->merge(pos);
+  int64_t pos = reference2->nDims() - n_tile_dims;
+  // [..., tile1, tile2(, shared)]
+  moveReductionsOut(reference2, n_tile_dims);
+  for ([[maybe_unused]] auto i : c10::irange(n_tile_dims - 1)) {
+    reference2->merge(pos);
+  }
   reference2->split(pos, tparams->vectorize_factor2);
   reference2->split(pos, tparams->getThreadsPerBlock());
   // [..., Unroll, TIDx, Vectorize]
@@ -1086,11 +1223,13 @@ void scheduleTranspose(Fusion* fusion, const TransposeParams* tparams) {
   //////////////////////////////
 
   // schedule group 1
-  reference1->reorder({{-2, -1}});
-  // [..., tile2, tile1]
-  pos = reference1->nDims() - 2;
-  moveReductionsOut(reference1, 2);
-  reference1->merge(pos);
+  reference1->reorder({{-n_tile_dims, -n_tile_dims + 1}});
+  // [..., tile2, tile1(, shared)]
+  pos = reference1->nDims() - n_tile_dims;
+  moveReductionsOut(reference1, n_tile_dims);
+  for ([[maybe_unused]] auto i : c10::irange(n_tile_dims - 1)) {
+    reference1->merge(pos);
+  }
   reference1->split(pos, tparams->vectorize_factor1);
   reference1->split(pos, tparams->getThreadsPerBlock());
   if (tparams->vectorize_factor1 > 1) {
@@ -1215,6 +1354,8 @@ std::unique_ptr<HeuristicParams> TransposeScheduler::computeHeuristics(
   FUSER_PERF_SCOPE("TransposeScheduler::computeHeuristics");
   auto tparams = getTransposeHeuristics(fusion, runtime_info, data_cache);
   NVF_ERROR(tparams != nullptr);
+  heuristic_plugin::updateHeuristicParams(
+      tparams.get(), fusion, runtime_info, data_cache);
   return tparams;
 }
 
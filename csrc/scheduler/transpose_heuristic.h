@@ -51,6 +51,16 @@ class TransposeParams : public HeuristicParams {
   // Tile size for the inner most dim of tensors in the second group
   int64_t tile_size2 = getDefaultTileSize();
 
+  // If larger than 1, consecutive CTAs walk this many tiles along the outer
+  // of the two tiled dims before moving along the inner one, so that the
+  // tiles of a wave read and write nearby rows of both groups in L2
+  int64_t grid_swizzle_factor = 1;
+
+  // Extent of the inner-most dim shared by both groups, which is kept
+  // inner-most in the tiles of both, making them 3D. 1 if the groups don't
+  // share their inner-most dim. See TransposeDomainMap::sharedInnerDim.
+  int64_t shared_inner_size = 1;
+
   using HeuristicParams::HeuristicParams;
 
   // Warning: Does not check launch parameters!
@@ -65,7 +75,9 @@ class TransposeParams : public HeuristicParams {
         other->dims_merged_with_2 == dims_merged_with_2 &&
         other->vectorize_factor1 == vectorize_factor1 &&
         other->vectorize_factor2 == vectorize_factor2 &&
-        other->tile_size1 == tile_size1 && other->tile_size2 == tile_size2;
+        other->tile_size1 == tile_size1 && other->tile_size2 == tile_size2 &&
+        other->grid_swizzle_factor == grid_swizzle_factor &&
+        other->shared_inner_size == shared_inner_size;
     return attr_equal;
   }
 
@@ -76,8 +88,14 @@ class TransposeParams : public HeuristicParams {
        << " BlckX: " << lparams.bdimx() << "\n";
     ss << " input tile size: " << tile_size1 << "\n";
     ss << " output tile size: " << tile_size2 << "\n";
-    int64_t elements_per_tile = tile_size1 * tile_size2;
+    if (shared_inner_size > 1) {
+      ss << " shared inner size: " << shared_inner_size << "\n";
+    }
+    int64_t elements_per_tile = getElementsPerTile();
     ss << " elements per tile: " << elements_per_tile << "\n";
+    if (grid_swizzle_factor > 1) {
+      ss << " grid swizzle factor: " << grid_swizzle_factor << "\n";
+    }
     int64_t elements_per_thread = elements_per_tile / lparams.bdimx();
     ss << " elements per thread: " << elements_per_thread << "\n";
     if (vectorize_factor1 > 1) {
@@ -146,16 +164,22 @@ class TransposeParams : public HeuristicParams {
         vectorize_factor1,
         vectorize_factor2,
         tile_size1,
-        tile_size2);
+        tile_size2,
+        grid_swizzle_factor,
+        shared_inner_size);
   }
 
   std::unique_ptr<HeuristicParams> clone() const override {
     return std::make_unique<TransposeParams>(*this);
   }
 
+  int64_t getElementsPerTile() const {
+    return tile_size1 * tile_size2 * shared_inner_size;
+  }
+
   int64_t getThreadsPerBlock() const {
-    int64_t tile_vectors1 = ceilDiv(tile_size1 * tile_size2, vectorize_factor1);
-    int64_t tile_vectors2 = ceilDiv(tile_size1 * tile_size2, vectorize_factor2);
+    int64_t tile_vectors1 = ceilDiv(getElementsPerTile(), vectorize_factor1);
+    int64_t tile_vectors2 = ceilDiv(getElementsPerTile(), vectorize_factor2);
     int64_t tile_vectors = std::min(tile_vectors1, tile_vectors2);
     return std::min(getMaxThreadsPerBlock(), tile_vectors);
   }
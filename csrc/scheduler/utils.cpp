@@ -2572,6 +2572,28 @@ int64_t getSharedMemoryOverheadPerBlock(
   return reduction_broadcast_workspace + smem_overhead_driver;
 }
 
+int64_t getGridSwizzleFactor(
+    int64_t num_slow_tiles,
+    int64_t num_fast_tiles,
+    int64_t bytes_per_tile,
+    int64_t ctas_per_wave) {
+  constexpr int64_t kMaxGridSwizzleFactor = 16;
+  const int64_t l2_size =
+      (int64_t)at::cuda::getCurrentDeviceProperties()->l2CacheSize;
+  if (num_slow_tiles * num_fast_tiles * bytes_per_tile <= l2_size / 2 ||
+      num_fast_tiles <= ctas_per_wave) {
+    return 1;
+  }
+  // Grow the groups of a wave towards a square of tiles
+  int64_t factor = 1;
+  while (factor * 2 <= kMaxGridSwizzleFactor &&
+         factor * factor * 4 <= ctas_per_wave &&
+         num_slow_tiles % (factor * 2) == 0) {
+    factor *= 2;
+  }
+  return factor;
+}
+
 bool isResharding(Fusion* fusion) {
   const std::vector<Expr*>& exprs = fusion->exprs();
   return std::any_of(
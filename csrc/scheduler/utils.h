@@ -706,6 +706,18 @@ int64_t getSharedMemoryOverheadPerBlock(
     const std::vector<TensorView*>& reduction_tvs,
     int64_t threads_per_block = -1);
 
+//! Number of consecutive tiles along the slower of two grid dimensions that
+//! a swizzled grid walks before moving along the faster one. Without a
+//! swizzle, a wave of CTAs spans ctas_per_wave tiles of one row of the grid,
+//! so the data shared by the rows is evicted from L2 before the next row
+//! reuses it. Returns 1 if the tiles of the grid fit in L2 anyway, if a wave
+//! already covers more than a row, or if no factor divides num_slow_tiles.
+int64_t getGridSwizzleFactor(
+    int64_t num_slow_tiles,
+    int64_t num_fast_tiles,
+    int64_t bytes_per_tile,
+    int64_t ctas_per_wave);
+
 // Returns true if any Expr in `fusion` is resharding.
 bool isResharding(Fusion* fusion);
 
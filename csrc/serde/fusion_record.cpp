@@ -598,6 +598,28 @@ void RecordFunctorFactory::registerAllParsers() {
   };
   registerParser(RecordType::SizeOp, deserializeSizeOpRecord);
 
+  auto deserializeSortOpRecord = [](const RecordFunctor* buffer) {
+    auto data = buffer->data_as_Sort();
+    return new python_frontend::SortOpRecord(
+        parseStateArgs(buffer->args()),
+        parseStateArgs(buffer->outputs()),
+        data->dim(),
+        data->descending(),
+        data->stable());
+  };
+  registerParser(RecordType::SortOp, deserializeSortOpRecord);
+
+  auto deserializeTopKOpRecord = [](const RecordFunctor* buffer) {
+    auto data = buffer->data_as_TopK();
+    return new python_frontend::TopKOpRecord(
+        parseStateArgs(buffer->args()),
+        parseStateArgs(buffer->outputs()),
+        data->dim(),
+        data->largest(),
+        data->sorted());
+  };
+  registerParser(RecordType::TopKOp, deserializeTopKOpRecord);
+
   auto deserializeAtOpRecord = [](const RecordFunctor* buffer) {
     auto data = buffer->data_as_At();
     return new python_frontend::AtOpRecord(
@@ -22,7 +22,11 @@
 #include <scheduler/tools/maxinfo_propagator.h>
 #include <transform_iter.h>
 
+#include <any>
 #include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace nvfuser {
 
@@ -1009,6 +1013,128 @@ bool validateDomain(TensorView* tv, TensorDomain* new_td) {
       first_mismatch >= tv->getMaxComputePosition();
 }
 
+//! Memo of the loop positions TransformPropagators matched without replay in
+//! a fusion. Schedulers propagate the same transformations several times,
+//! e.g., with overlapping spanning trees or while trying variants, and most
+//! of the hops of a repeated propagation already match, which is only found
+//! by a BestEffortReplay. Enabled by EnableOption::MemoizeTransformReplay.
+//!
+//! Statement names are never reused within a fusion, so a hop is keyed by
+//! the names of the domains of both tensors and of the expression between
+//! them. Any transformation of either tensor creates new IterDomains and
+//! misses the memo. The tensors are also keyed by address, as the names of
+//! the statements of a fusion swapped with another one start over.
+class MatchedPosMemo {
+ public:
+  enum class Direction : int64_t { PasC, CasP };
+
+  //! Memo of the fusion of the tensors, created on first use
+  static MatchedPosMemo& get(const TensorView* tv) {
+    static const std::string kKey = "transform_replay_matched_pos_memo";
+    Fusion* fusion = tv->fusion();
+    if (!fusion->hasManaged(kKey)) {
+      // The names of a clone may differ, e.g., for a partial copy, so clones
+      // start with an empty memo
+      fusion->manage(
+          kKey,
+          std::make_shared<MatchedPosMemo>(),
+          [](IrCloner&, std::any) -> std::any {
+            return std::make_shared<MatchedPosMemo>();
+          });
+    }
+    return *fusion->getManaged<std::shared_ptr<MatchedPosMemo>>(kKey);
+  }
+
+  //! TransformReplay::getMatchedLeafPosWithoutReplayPasC or CasP of target
+  //! and reference with skip_resize
+  int64_t matchedPos(
+      Direction direction,
+      const TensorView* target,
+      const TensorView* reference,
+      int64_t reference_pos) {
+    std::vector<int64_t> key =
+        makeKey(direction, target, reference, reference_pos);
+    auto it = matched_pos_.find(key);
+    if (it != matched_pos_.end()) {
+      return it->second;
+    }
+    int64_t pos = direction == Direction::PasC
+        ? TransformReplay::getMatchedLeafPosWithoutReplayPasC(
+              target, reference, reference_pos, true)
+        : TransformReplay::getMatchedLeafPosWithoutReplayCasP(
+              target, reference, reference_pos, true);
+    matched_pos_.emplace(std::move(key), pos);
+    return pos;
+  }
+
+ private:
+  struct KeyHash {
+    size_t operator()(const std::vector<int64_t>& key) const {
+      size_t hash = key.size();
+      for (int64_t v : key) {
+        hashCombine(hash, std::hash<int64_t>()(v));
+      }
+      return hash;
+    }
+  };
+
+  static std::vector<int64_t> makeKey(
+      Direction direction,
+      const TensorView* target,
+      const TensorView* reference,
+      int64_t reference_pos) {
+    const TensorView* consumer =
+        direction == Direction::PasC ? reference : target;
+    std::vector<int64_t> key{
+        (int64_t)direction,
+        reference_pos,
+        consumer->definition() == nullptr
+            ? -1
+            : (int64_t)consumer->definition()->name()};
+    for (const TensorView* tv : {target, reference}) {
+      key.push_back((int64_t)reinterpret_cast<intptr_t>(tv));
+      key.push_back((int64_t)tv->name());
+      for (const auto* domain :
+           {&tv->getMaybeRootDomain(),
+            &tv->getLogicalDomain(),
+            &tv->getLoopDomain()}) {
+        // The size separates the domains
+        key.push_back((int64_t)domain->size());
+        for (IterDomain* id : *domain) {
+          key.push_back((int64_t)id->name());
+        }
+      }
+    }
+    return key;
+  }
+
+  std::unordered_map<std::vector<int64_t>, int64_t, KeyHash> matched_pos_;
+};
+
+int64_t matchedPosPasC(
+    const TensorView* producer,
+    const TensorView* consumer,
+    int64_t consumer_pos) {
+  if (!isOptionEnabled(EnableOption::MemoizeTransformReplay)) {
+    return TransformReplay::getMatchedLeafPosWithoutReplayPasC(
+        producer, consumer, consumer_pos, true);
+  }
+  return MatchedPosMemo::get(consumer).matchedPos(
+      MatchedPosMemo::Direction::PasC, producer, consumer, consumer_pos);
+}
+
+int64_t matchedPosCasP(
+    const TensorView* consumer,
+    const TensorView* producer,
+    int64_t producer_pos) {
+  if (!isOptionEnabled(EnableOption::MemoizeTransformReplay)) {
+    return TransformReplay::getMatchedLeafPosWithoutReplayCasP(
+        consumer, producer, producer_pos, true);
+  }
+  return MatchedPosMemo::get(producer).matchedPos(
+      MatchedPosMemo::Direction::CasP, consumer, producer, producer_pos);
+}
+
 } // namespace
 
 void TransformPropagator::propagateC2P(TensorView* from, TensorView* to) {
@@ -1024,8 +1150,7 @@ void TransformPropagator::propagateC2P(TensorView* from, TensorView* to) {
   //
   // Note on resize: When propagating transformations, resize is just
   // skipped, or forwarded, so the matching here is done by skipping it.
-  int64_t new_pos =
-      TransformReplay::getMatchedLeafPosWithoutReplayPasC(to, from, pos, true);
+  int64_t new_pos = matchedPosPasC(to, from, pos);
   bool debug_print = isDebugDumpEnabled(DebugDumpOption::TransformPropagator);
   if (debug_print) {
     debug() << "TransformPropagator::propagateC2P" << std::endl;
@@ -1056,8 +1181,7 @@ void TransformPropagator::propagateC2P(TensorView* from, TensorView* to) {
 void TransformPropagator::propagateP2C(TensorView* from, TensorView* to) {
   int64_t pos = replayed_pos_.at(from);
   // See note [Using multiple TransformPropagators]
-  int64_t new_pos =
-      TransformReplay::getMatchedLeafPosWithoutReplayCasP(to, from, pos, true);
+  int64_t new_pos = matchedPosCasP(to, from, pos);
   bool debug_print = isDebugDumpEnabled(DebugDumpOption::TransformPropagator);
   if (debug_print) {
     debug() << "TransformPropagator::propagateP2C" << std::endl;
@@ -1122,8 +1246,7 @@ void MostInlinedTransformPropagator::propagateC2P(
     TensorView* to) {
   int64_t pos = (int64_t)from->nDims();
   // See note [Using multiple TransformPropagators]
-  int64_t new_pos =
-      TransformReplay::getMatchedLeafPosWithoutReplayPasC(to, from, pos, true);
+  int64_t new_pos = matchedPosPasC(to, from, pos);
   bool debug_print = isDebugDumpEnabled(DebugDumpOption::TransformPropagator);
   if (debug_print) {
     debug() << "MostInlinedTransformPropagator::propagateC2P" << std::endl;
@@ -1154,8 +1277,7 @@ void MostInlinedTransformPropagator::propagateP2C(
     TensorView* to) {
   int64_t pos = (int64_t)from->nDims();
   // See note [Using multiple TransformPropagators]
-  int64_t new_pos =
-      TransformReplay::getMatchedLeafPosWithoutReplayCasP(to, from, pos, true);
+  int64_t new_pos = matchedPosCasP(to, from, pos);
   bool debug_print = isDebugDumpEnabled(DebugDumpOption::TransformPropagator);
   if (debug_print) {
     debug() << "MostInlinedTransformPropagator::propagateP2C" << std::endl;
@@ -133,6 +133,15 @@ bool isInclusiveType(const DataType& base_type, const DataType& wider_type) {
       base_type == DataType::Int32) {
     return true;
   }
+  // int8 values are exact in every wider integral or floating point type
+  if (base_type == DataType::Int8 &&
+      (wider_type == DataType::Int || wider_type == DataType::Int32 ||
+       wider_type == DataType::Double || wider_type == DataType::Float ||
+       wider_type == DataType::Half || wider_type == DataType::BFloat16 ||
+       wider_type == DataType::ComplexDouble ||
+       wider_type == DataType::ComplexFloat)) {
+    return true;
+  }
   if (wider_type == DataType::ComplexDouble &&
       base_type == DataType::ComplexFloat) {
     return true;
@@ -234,6 +243,8 @@ static std::string data_type2string(DataType t) {
               return "nvfuser_index_t";
             case DataType::Int32:
               return "int";
+            case DataType::Int8:
+              return "int8_t";
             case DataType::UInt:
               return "uint64_t";
             case DataType::UInt32:
@@ -868,6 +879,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
     case supported_switch_pair(DataType::Index, DataType::Float):
     case supported_switch_pair(DataType::Int, DataType::Float):
     case supported_switch_pair(DataType::Int32, DataType::Float):
+    case supported_switch_pair(DataType::Int8, DataType::Float):
     case supported_switch_pair(DataType::UInt, DataType::Float):
     case supported_switch_pair(DataType::UInt32, DataType::Float):
     case supported_switch_pair(DataType::Double, DataType::Float):
@@ -878,6 +890,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
       return "(float)std::real";
     case supported_switch_pair(DataType::Index, DataType::Int):
     case supported_switch_pair(DataType::Int32, DataType::Int):
+    case supported_switch_pair(DataType::Int8, DataType::Int):
     case supported_switch_pair(DataType::UInt, DataType::Int):
     case supported_switch_pair(DataType::UInt32, DataType::Int):
     case supported_switch_pair(DataType::Float, DataType::Int):
@@ -889,6 +902,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
       return "(int64_t)std::real";
     case supported_switch_pair(DataType::Index, DataType::Int32):
     case supported_switch_pair(DataType::Int, DataType::Int32):
+    case supported_switch_pair(DataType::Int8, DataType::Int32):
     case supported_switch_pair(DataType::UInt, DataType::Int32):
     case supported_switch_pair(DataType::UInt32, DataType::Int32):
     case supported_switch_pair(DataType::Float, DataType::Int32):
@@ -898,9 +912,22 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
     case supported_switch_pair(DataType::ComplexFloat, DataType::Int32):
     case supported_switch_pair(DataType::ComplexDouble, DataType::Int32):
       return "(int32_t)std::real";
+    case supported_switch_pair(DataType::Index, DataType::Int8):
+    case supported_switch_pair(DataType::Int, DataType::Int8):
+    case supported_switch_pair(DataType::Int32, DataType::Int8):
+    case supported_switch_pair(DataType::UInt, DataType::Int8):
+    case supported_switch_pair(DataType::UInt32, DataType::Int8):
+    case supported_switch_pair(DataType::Float, DataType::Int8):
+    case supported_switch_pair(DataType::Double, DataType::Int8):
+    case supported_switch_pair(DataType::Bool, DataType::Int8):
+      return "(int8_t)";
+    case supported_switch_pair(DataType::ComplexFloat, DataType::Int8):
+    case supported_switch_pair(DataType::ComplexDouble, DataType::Int8):
+      return "(int8_t)std::real";
     case supported_switch_pair(DataType::Index, DataType::UInt):
     case supported_switch_pair(DataType::Int, DataType::UInt):
     case supported_switch_pair(DataType::Int32, DataType::UInt):
+    case supported_switch_pair(DataType::Int8, DataType::UInt):
     case supported_switch_pair(DataType::UInt32, DataType::UInt):
     case supported_switch_pair(DataType::Float, DataType::UInt):
     case supported_switch_pair(DataType::Double, DataType::UInt):
@@ -912,6 +939,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
     case supported_switch_pair(DataType::Index, DataType::UInt32):
     case supported_switch_pair(DataType::Int, DataType::UInt32):
     case supported_switch_pair(DataType::Int32, DataType::UInt32):
+    case supported_switch_pair(DataType::Int8, DataType::UInt32):
     case supported_switch_pair(DataType::UInt, DataType::UInt32):
     case supported_switch_pair(DataType::Float, DataType::UInt32):
     case supported_switch_pair(DataType::Double, DataType::UInt32):
@@ -922,6 +950,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
       return "(uint32_t)std::real";
     case supported_switch_pair(DataType::Int, DataType::Index):
     case supported_switch_pair(DataType::Int32, DataType::Index):
+    case supported_switch_pair(DataType::Int8, DataType::Index):
     case supported_switch_pair(DataType::UInt, DataType::Index):
     case supported_switch_pair(DataType::UInt32, DataType::Index):
     case supported_switch_pair(DataType::Float, DataType::Index):
@@ -934,6 +963,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
     case supported_switch_pair(DataType::Index, DataType::Double):
     case supported_switch_pair(DataType::Int, DataType::Double):
     case supported_switch_pair(DataType::Int32, DataType::Double):
+    case supported_switch_pair(DataType::Int8, DataType::Double):
     case supported_switch_pair(DataType::UInt, DataType::Double):
     case supported_switch_pair(DataType::UInt32, DataType::Double):
     case supported_switch_pair(DataType::Float, DataType::Double):
@@ -947,6 +977,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
     case supported_switch_pair(DataType::Index, DataType::Bool):
     case supported_switch_pair(DataType::Int, DataType::Bool):
     case supported_switch_pair(DataType::Int32, DataType::Bool):
+    case supported_switch_pair(DataType::Int8, DataType::Bool):
     case supported_switch_pair(DataType::UInt, DataType::Bool):
     case supported_switch_pair(DataType::UInt32, DataType::Bool):
       return "(bool)";
@@ -956,6 +987,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
     case supported_switch_pair(DataType::Index, DataType::ComplexDouble):
     case supported_switch_pair(DataType::Int, DataType::ComplexDouble):
     case supported_switch_pair(DataType::Int32, DataType::ComplexDouble):
+    case supported_switch_pair(DataType::Int8, DataType::ComplexDouble):
     case supported_switch_pair(DataType::UInt, DataType::ComplexDouble):
     case supported_switch_pair(DataType::UInt32, DataType::ComplexDouble):
     case supported_switch_pair(DataType::Double, DataType::ComplexDouble):
@@ -966,6 +998,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
     case supported_switch_pair(DataType::Index, DataType::ComplexFloat):
     case supported_switch_pair(DataType::Int, DataType::ComplexFloat):
     case supported_switch_pair(DataType::Int32, DataType::ComplexFloat):
+    case supported_switch_pair(DataType::Int8, DataType::ComplexFloat):
     case supported_switch_pair(DataType::UInt, DataType::ComplexFloat):
     case supported_switch_pair(DataType::UInt32, DataType::ComplexFloat):
     case supported_switch_pair(DataType::Double, DataType::ComplexFloat):
@@ -980,6 +1013,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
       return "__double2half";
     case supported_switch_pair(DataType::Int, DataType::Half):
     case supported_switch_pair(DataType::Int32, DataType::Half):
+    case supported_switch_pair(DataType::Int8, DataType::Half):
     case supported_switch_pair(DataType::UInt, DataType::Half):
     case supported_switch_pair(DataType::UInt32, DataType::Half):
     case supported_switch_pair(DataType::Index, DataType::Half):
@@ -996,6 +1030,8 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
       return "__half2double";
     case supported_switch_pair(DataType::Half, DataType::Int32):
       return "__half2int32";
+    case supported_switch_pair(DataType::Half, DataType::Int8):
+      return "(int8_t)__half2int32";
     case supported_switch_pair(DataType::Half, DataType::Int):
       return "__half2int";
     case supported_switch_pair(DataType::Half, DataType::UInt32):
@@ -1019,6 +1055,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
       return "__half2bfloat";
     case supported_switch_pair(DataType::Int, DataType::BFloat16):
     case supported_switch_pair(DataType::Int32, DataType::BFloat16):
+    case supported_switch_pair(DataType::Int8, DataType::BFloat16):
     case supported_switch_pair(DataType::UInt, DataType::BFloat16):
     case supported_switch_pair(DataType::UInt32, DataType::BFloat16):
     case supported_switch_pair(DataType::Index, DataType::BFloat16):
@@ -1037,6 +1074,8 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
       return "__bfloat2half";
     case supported_switch_pair(DataType::BFloat16, DataType::Int32):
       return "__bfloat2int32";
+    case supported_switch_pair(DataType::BFloat16, DataType::Int8):
+      return "(int8_t)__bfloat2int32";
     case supported_switch_pair(DataType::BFloat16, DataType::Int):
       return "__bfloat2int";
     case supported_switch_pair(DataType::BFloat16, DataType::UInt32):
@@ -1111,6 +1150,8 @@ DataType aten_to_data_type(const at::ScalarType& scalar_type) {
       return DataType::Int;
     case at::ScalarType::Int:
       return DataType::Int32;
+    case at::ScalarType::Char:
+      return DataType::Int8;
     case at::ScalarType::ComplexFloat:
       return DataType::ComplexFloat;
     case at::ScalarType::ComplexDouble:
@@ -1146,6 +1187,8 @@ at::ScalarType data_type_to_aten(const DataType& data_type) {
           "There's also this information in FusionExecutorCache and the Registry system.");
     case DataType::Int32:
       return at::ScalarType::Int;
+    case DataType::Int8:
+      return at::ScalarType::Char;
     case DataType::ComplexFloat:
       return at::ScalarType::ComplexFloat;
     case DataType::ComplexDouble:
@@ -1371,6 +1414,7 @@ std::string typePrefix(const DataType data_type) {
     case DataType::Index:
     case DataType::Int:
     case DataType::Int32:
+    case DataType::Int8:
     case DataType::UInt:
     case DataType::UInt32:
     case DataType::SMemAddress:
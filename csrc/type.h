@@ -85,7 +85,10 @@ enum class PrimDataType {
   // Pointers
   SMemAddress,
   // Null
-  Null
+  Null,
+  // Types added later. Serialized caches store the enumerators as integers,
+  // so new ones are appended instead of grouped with their kind.
+  Int8
 };
 
 #if defined(__GNUC__) && !defined(__clang__)
@@ -181,6 +184,7 @@ struct DataType {
   static constexpr PrimDataType Int = PrimDataType::Int;
   static constexpr PrimDataType Index = PrimDataType::Index;
   static constexpr PrimDataType Int32 = PrimDataType::Int32;
+  static constexpr PrimDataType Int8 = PrimDataType::Int8;
   static constexpr PrimDataType UInt = PrimDataType::UInt;
   static constexpr PrimDataType UInt32 = PrimDataType::UInt32;
   static constexpr PrimDataType Bool = PrimDataType::Bool;
@@ -264,6 +268,7 @@ inline bool isIntegralType(DataType dtype) {
             case DataType::Index:
             case DataType::Int:
             case DataType::Int32:
+            case DataType::Int8:
             case DataType::UInt:
             case DataType::UInt32:
               return true;
@@ -393,6 +398,10 @@ DEFINE_DATATYPE_TO_ATEN_AND_NATIVE_TYPE(
     DataType::Int32,
     at::ScalarType::Int,
     int);
+DEFINE_DATATYPE_TO_ATEN_AND_NATIVE_TYPE(
+    DataType::Int8,
+    at::ScalarType::Char,
+    int8_t);
 DEFINE_DATATYPE_TO_NATIVE_TYPE(DataType::UInt, uint64_t);
 DEFINE_DATATYPE_TO_NATIVE_TYPE(DataType::UInt32, uint32_t);
 DEFINE_DATATYPE_TO_ATEN_AND_NATIVE_TYPE(
@@ -841,6 +850,7 @@ ValType promoteType(const ValType& t1, const ValType& t2);
   HANDLE_TYPE_PROMOTION(Type1, double);              \
   HANDLE_TYPE_PROMOTION(Type1, int64_t);             \
   HANDLE_TYPE_PROMOTION(Type1, int);                 \
+  HANDLE_TYPE_PROMOTION(Type1, int8_t);              \
   HANDLE_TYPE_PROMOTION(Type1, bool);                \
   HANDLE_TYPE_PROMOTION(Type1, std::complex<float>); \
   HANDLE_TYPE_PROMOTION(Type1, std::complex<double>)
@@ -881,6 +891,7 @@ inline DataType promoteType(const DataType& t1, const DataType& t2) {
   HANDLE_TYPE_PROMOTION1(double);
   HANDLE_TYPE_PROMOTION1(int64_t);
   HANDLE_TYPE_PROMOTION1(int);
+  HANDLE_TYPE_PROMOTION1(int8_t);
   HANDLE_TYPE_PROMOTION1(bool);
   HANDLE_TYPE_PROMOTION1(std::complex<float>);
   HANDLE_TYPE_PROMOTION1(std::complex<double>);
@@ -1010,6 +1021,8 @@ constexpr inline size_t primDataTypeSize(PrimDataType type) {
       return sizeof(int64_t);
     case DataType::Int32:
       return sizeof(int32_t);
+    case DataType::Int8:
+      return sizeof(int8_t);
     case DataType::UInt:
       return sizeof(uint64_t);
     case DataType::UInt32:
@@ -15,6 +15,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <optional>
+#include <thread>
 
 namespace nvfuser {
 
@@ -30,13 +31,6 @@ int getNumThreads() {
   return std::max(std::min(num_threads_value, max_num_threads), 1);
 }
 
-// TODO: clean this up with some knobs
-c10::ThreadPool* getThreadPool() {
-  static auto num_threads = getNumThreads();
-  static c10::ThreadPool pool(num_threads);
-  return &pool;
-}
-
 std::string debug_str(const c10::IValue& val) {
   if (val.isTensor()) {
     return debug_str(val.toTensor());
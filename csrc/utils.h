@@ -50,7 +50,6 @@
 namespace nvfuser {
 
 int getNumThreads();
-c10::ThreadPool* getThreadPool();
 
 std::string debug_str(const c10::IValue& val);
 std::string debug_str(const at::Tensor& tensor);
@@ -0,0 +1,43 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <heuristic_plugin_api.h>
+
+#include <cstdint>
+#include <iostream>
+
+using namespace nvfuser::heuristic_plugin;
+
+// This example heuristic simply prints the problem description, then doubles
+// the iteration domain unroll factor of non-persistent outer reductions.
+extern "C" bool configureHeuristic(
+    const ProblemDescription* problem,
+    HeuristicConfig* config) {
+  if (problem->api_version != kApiVersion) {
+    return false;
+  }
+  std::cout << "Using example heuristic for problem: ";
+  std::cout << "scheduler=" << (int)problem->scheduler << " ";
+  std::cout << "extents=[";
+  for (uint32_t i = 0; i < problem->num_dims; i++) {
+    std::cout << (i ? ", " : "") << problem->extents[i];
+  }
+  std::cout << "] ";
+  std::cout << "reduction_axes=" << problem->reduction_axes << " ";
+  std::cout << "inputs=" << problem->input_dtypes << " ";
+  std::cout << "outputs=" << problem->output_dtypes << " ";
+  std::cout << "persistent_buffer_size=" << problem->persistent_buffer_size
+            << std::endl;
+
+  if (problem->scheduler != SchedulerKind::Reduction ||
+      problem->fastest_dim_reduction ||
+      config->reduction.vectorize_iter_dom) {
+    return false;
+  }
+  config->reduction.unroll_factor_iter_dom *= 2;
+  return true;
+}
@@ -198,6 +198,7 @@ class FusionDefinition(_C._FusionDefinition):
         save_repro_inputs=False,
         _enable_options: list[str] = [],
         _disable_options: list[str] = [],
+        outputs=None,
     ):
         """
         Executes an nvFuser set of kernels for a given Fusion
@@ -245,6 +246,12 @@ class FusionDefinition(_C._FusionDefinition):
                 Note: Currently, we do not cache/store these options in the FusionCache which makes it
                     plausible to reuse kernels when executing the same fusion definition with different sets of options.
                     Reset the FusionCache manually to avoid inadvertent kernel reuse when between different sets of options.
+            outputs (Optional[List[Optional[Tensor]]]): Preallocated buffers,
+                one per output, to write the outputs to. The buffers must
+                match the sizes, dtypes, device and contiguity of the outputs,
+                and are returned in place of new tensors. A None entry is
+                allocated as usual. Not supported with segments defined in
+                Python.
 
         Returns:
             List[Tensor]
@@ -304,6 +311,9 @@ class FusionDefinition(_C._FusionDefinition):
             self.fake_inputs = [fake_mode.from_tensor(inp) for inp in inputs]
 
         if hasattr(self, "segments") and len(self.segments) > 0:
+            assert (
+                outputs is None
+            ), "Preallocated outputs are not supported with segments"
             return self._execute_segments(inputs, device=device, profile=profile)
 
         results = None
@@ -324,12 +334,121 @@ class FusionDefinition(_C._FusionDefinition):
                 profile=profile,
                 _enable_options=_enable_options,
                 _disable_options=_disable_options,
+                outputs=outputs,
             )
             return results
         except Exception as err:
             logger.exception(self._repro_error_str("executing", inputs))
             raise
 
+    @staticmethod
+    def execute_by_id(
+        fusion_id, inputs, *, device=None, override_user_schedule=False
+    ):
+        """
+        Executes a cached fusion given the id of its FusionDefinition
+
+        Unlike `execute`, this does not build the definition again nor look
+        it up in the FusionCache, which can cost more than the kernels of a
+        small fusion. The id is returned by `FusionDefinition.id()` once the
+        definition is complete, and stays valid until the FusionCache is
+        reset. Schedules defined in `schedule` must have been created by
+        `execute` before.
+
+        Args:
+            fusion_id (int): The id of a complete FusionDefinition.
+            inputs (List[Union[Tensor, Scalar]]): A list of inputs to fusion.
+
+        Kwargs:
+            device (Optional[Union[int, str, torch.device]]): See `execute`.
+            override_user_schedule (bool): For a user defined schedule,
+                override with auto-generated schedule (default: False)
+
+        Returns:
+            List[Tensor]
+        """
+        if device is not None:
+            if not isinstance(device, torch.device):
+                device = torch.device(device)
+            assert (
+                device.type == "cuda"
+            ), "If device argument is passed it must be a CUDA device"
+            device = device.index
+        return _C._FusionDefinition._execute_by_id(
+            fusion_id,
+            inputs,
+            device=device,
+            override_user_schedule=override_user_schedule,
+        )
+
+    def execute_async(self, inputs, *, device=None):
+        """
+        Executes the fusion on a separate thread and returns immediately
+
+        Segmentation and compilation on a cache miss don't hold the calling
+        thread. The launch is enqueued on the current stream of the caller,
+        where the outputs are ready to use. User schedules are not supported.
+
+        Args:
+            inputs (List[Union[Tensor, Scalar]]): A list of inputs to fusion.
+
+        Kwargs:
+            device (Optional[Union[int, str, torch.device]]): See `execute`.
+
+        Returns:
+            FusionFuture: `result()` waits for the launch, with the GIL
+            released, and returns the List[Tensor] of outputs.
+        """
+        if device is not None:
+            if not isinstance(device, torch.device):
+                device = torch.device(device)
+            assert (
+                device.type == "cuda"
+            ), "If device argument is passed it must be a CUDA device"
+            device = device.index
+
+        # if definition is not defined by a context manager, try a child class
+        if self.id() is None:
+            self._setup_definition()
+            self.definition()
+            self._finalize_definition()
+
+        return _C._FusionDefinition._execute_async(self.id(), inputs, device=device)
+
+    @staticmethod
+    def execute_batch(fusions, *, device=None):
+        """
+        Executes several cached fusions back to back with a single call into
+        nvFuser
+
+        The arguments of all the fusions are converted before any of them
+        runs, and the fusions are launched in order on the current stream.
+
+        Args:
+            fusions (List[Tuple[Union[FusionDefinition, int], List]]): Pairs
+                of a complete FusionDefinition, or its id, and its inputs.
+
+        Kwargs:
+            device (Optional[Union[int, str, torch.device]]): See `execute`.
+
+        Returns:
+            List[List[Tensor]]: The outputs of each fusion.
+        """
+        if device is not None:
+            if not isinstance(device, torch.device):
+                device = torch.device(device)
+            assert (
+                device.type == "cuda"
+            ), "If device argument is passed it must be a CUDA device"
+            device = device.index
+        batch = []
+        for fusion, inputs in fusions:
+            if isinstance(fusion, _C._FusionDefinition):
+                assert fusion.id() is not None, "The definition is not complete"
+                fusion = fusion.id()
+            batch.append((fusion, inputs))
+        return _C._FusionDefinition._execute_batch(batch, device=device)
+
     def debug_output(self):
         """
         Retrieve string of captured debug information from the previous execution.
@@ -451,6 +570,49 @@ class FusionDefinition(_C._FusionDefinition):
             inputs, tensor_transforms, override_user_schedule
         )
 
+    def runtime_cache_stats(self):
+        """
+        Returns the kernel runtime lookups of the auto-generated schedules
+
+        A lookup hits when the inputs map to a kernel runtime that already
+        exists. A missed lookup concretizes the fusion, and creates and
+        compiles a runtime unless an existing one is reused, e.g., through a
+        shape bucket policy.
+
+        Returns:
+            Dict[str, int]: "runtime_hits", "runtime_misses",
+            "created_runtimes" and "evicted_runtimes", counted since the
+            definition was created.
+        """
+        return self._runtime_cache_stats()
+
+    def set_async_compilation(self, enabled):
+        """
+        Compiles the kernels of new runtimes in the background, evaluating the
+        fusion with ATen meanwhile, like NVFUSER_ENABLE=async_compile but only
+        for this definition
+
+        Args:
+            enabled (bool): Whether new runtimes are compiled asynchronously.
+        """
+        self._set_async_compilation(enabled)
+
+    def set_shape_bucket_policy(self, input_dims):
+        """
+        Rounds the extents of the given input dimensions up to powers of two
+        when looking up a kernel runtime, so that shapes in the same bucket
+        share compiled kernels. Applies to runtimes created afterwards.
+
+        Args:
+            input_dims (Optional[List[Tuple[int, int]]]): Pairs of an input
+                index and a dimension of that input, which may be negative.
+                None clears the policy.
+        """
+        if input_dims is None:
+            self._clear_shape_bucket_policy()
+        else:
+            self._set_shape_bucket_policy(input_dims)
+
     def profile(self):
         """
         Returns the FusionProfile object from the CUPTI based FusionProfiler
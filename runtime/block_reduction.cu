@@ -11,6 +11,97 @@
 // reduce the warps, this could save some shared memory, but could be slower in
 // some instances.
 //
+// Two-level reduction used by blockReduce when every warp holds threads of a
+// single reduction segment: each warp reduces with shuffles, then the first
+// warp of each segment reduces the partial results of its warps. This takes
+// two block syncs instead of one per level of the shared memory tree, for any
+// number of warps per segment.
+template <bool Aligned, typename T, typename Func, typename BlockDimT>
+__device__ void blockReduceWarpShuffle(
+    T& out,
+    const T& inp_val,
+    Func reduction_op,
+    T* shared_mem,
+    bool read_pred,
+    bool write_pred,
+    T init_val,
+    unsigned int reduction_size,
+    unsigned int reduction_tid,
+    unsigned int reduction_idx,
+    BlockDimT block_dim) {
+  constexpr unsigned int WARP_SIZE = 32;
+
+  T reduce_val = init_val;
+  if (read_pred) {
+    reduce_val = inp_val;
+  }
+  for (int i = 16; i >= 1; i /= 2) {
+    reduction_op(
+        reduce_val, __shfl_xor_sync(0xffffffff, reduce_val, i, WARP_SIZE));
+  }
+
+  unsigned int num_of_warps = reduction_size / WARP_SIZE;
+  unsigned int warp_idx = reduction_tid / WARP_SIZE;
+  unsigned int lane_idx = reduction_tid % WARP_SIZE;
+  unsigned int smem_offset = reduction_idx * num_of_warps;
+  if (lane_idx == 0) {
+    shared_mem[smem_offset + warp_idx] = reduce_val;
+  }
+  block_sync::sync<Aligned>(block_dim);
+
+  if (warp_idx == 0) {
+    // num_of_warps is at most 32 as blocks have at most 1024 threads
+    reduce_val = lane_idx < num_of_warps ? shared_mem[smem_offset + lane_idx]
+                                         : init_val;
+    for (int i = 16; i >= 1; i /= 2) {
+      reduction_op(
+          reduce_val, __shfl_xor_sync(0xffffffff, reduce_val, i, WARP_SIZE));
+    }
+    if (lane_idx == 0 && write_pred) {
+      reduction_op(out, reduce_val);
+    }
+  }
+  block_sync::sync<Aligned>(block_dim);
+}
+
+// Reduction used by blockReduce when reduction segments are contiguous ranges
+// of the linear thread index with fewer threads than a warp, whose size
+// divides the warp size, e.g., an inner reduction of 8 threads on TIDx with a
+// row per TIDy. Each warp then reduces several segments at once with shuffles
+// over its segmented lanes, without shared memory or block syncs.
+template <typename T, typename Func>
+__device__ void blockReduceSubWarpShuffle(
+    T& out,
+    const T& inp_val,
+    Func reduction_op,
+    bool read_pred,
+    bool write_pred,
+    T init_val,
+    unsigned int reduction_size,
+    unsigned int reduction_tid) {
+  constexpr unsigned int WARP_SIZE = 32;
+
+  T reduce_val = init_val;
+  if (read_pred) {
+    reduce_val = inp_val;
+  }
+  // The last warp of a block may be partial, but holds whole segments
+  unsigned int num_threads = blockDim.x * blockDim.y * blockDim.z;
+  unsigned int tid =
+      threadIdx.x + blockDim.x * (threadIdx.y + blockDim.y * threadIdx.z);
+  unsigned int num_lanes =
+      min(WARP_SIZE, num_threads - tid / WARP_SIZE * WARP_SIZE);
+  unsigned int mask =
+      num_lanes == WARP_SIZE ? 0xffffffff : (1u << num_lanes) - 1;
+  for (unsigned int i = reduction_size / 2; i >= 1; i /= 2) {
+    reduction_op(
+        reduce_val, __shfl_xor_sync(mask, reduce_val, i, reduction_size));
+  }
+  if (reduction_tid == 0 && write_pred) {
+    reduction_op(out, reduce_val);
+  }
+}
+
 //  EXAMPLE USAGE:
 //  blockReduceSum<X_THREADS, Y_THREADS, Z_THREADS>
 //    (output[output_index], inputs[input_index],
@@ -57,6 +148,52 @@ __device__ void blockReduce(
   unsigned int reduction_num =
       index_utils::maskedSize<!X_REDUCE, !Y_REDUCE, !Z_REDUCE>(block_dim);
 
+  // Warp shuffles need all the threads of a warp, which aligned reductions
+  // guarantee. Every warp is within a single reduction segment if segments
+  // are contiguous ranges of the linear thread index whose size is a
+  // multiple of the warp size, e.g., any inner reduction over a multiple of 32
+  // threads, whether its size is a power of two or not. Conversely, every
+  // segment is within a single warp if its size divides the warp size.
+  if constexpr (
+      Aligned && std::is_arithmetic<T>::value &&
+      !std::is_same<T, bool>::value) {
+    bool is_contiguous_segment =
+        (X_REDUCE || block_dim.x == 1 || (!Y_REDUCE && !Z_REDUCE)) &&
+        (Y_REDUCE || block_dim.y == 1 || !Z_REDUCE);
+    // Warps are formed from blockDim, which block_dim differs from with warp
+    // specialization
+    bool is_full_block = block_dim.x == blockDim.x &&
+        block_dim.y == blockDim.y && block_dim.z == blockDim.z;
+    if (is_contiguous_segment && is_full_block && reduction_size < 32 &&
+        32 % reduction_size == 0) {
+      blockReduceSubWarpShuffle(
+          out,
+          inp_val,
+          reduction_op,
+          read_pred,
+          write_pred,
+          init_val,
+          reduction_size,
+          reduction_tid);
+      return;
+    }
+    if (is_contiguous_segment && is_full_block && reduction_size % 32 == 0) {
+      blockReduceWarpShuffle<Aligned>(
+          out,
+          inp_val,
+          reduction_op,
+          shared_mem,
+          read_pred,
+          write_pred,
+          init_val,
+          reduction_size,
+          reduction_tid,
+          reduction_idx,
+          block_dim);
+      return;
+    }
+  }
+
   // smem_offset is the offset into shared memory for the current thread.
   // To ensure coalesced access to shared memory, we need to ensure
   // each transaction is accessing a contiguous block of 128 bytes.
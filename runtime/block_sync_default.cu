@@ -19,6 +19,26 @@ struct DefaultBlockDim {
   }
 };
 
+// The block dimensions of a kernel specialized for a fixed block size. They
+// are compile-time constants, so that they can be folded into the indexing of
+// block reductions and broadcasts. Like DefaultBlockDim, they cover the whole
+// block.
+template <uint32_t X, uint32_t Y, uint32_t Z>
+struct StaticBlockDim {
+  static constexpr uint32_t x = X, y = Y, z = Z;
+  __device__ operator dim3() const {
+    return dim3(X, Y, Z);
+  }
+};
+
+// Whether a block dimension type always covers all the threads of the block
+template <typename BlockDimT>
+constexpr bool is_whole_block_dim_v =
+    std::is_same_v<BlockDimT, DefaultBlockDim>;
+
+template <uint32_t X, uint32_t Y, uint32_t Z>
+constexpr bool is_whole_block_dim_v<StaticBlockDim<X, Y, Z>> = true;
+
 // Default block synchronization. Just use __barrier_sync
 namespace block_sync {
 
@@ -29,7 +49,7 @@ template <bool aligned, typename BlockDimT>
 __forceinline__ __device__ void sync(BlockDimT block_dim) {
   if constexpr (aligned) {
     __syncthreads();
-  } else if constexpr (std::is_same_v<BlockDimT, DefaultBlockDim>) {
+  } else if constexpr (is_whole_block_dim_v<BlockDimT>) {
     __barrier_sync(0);
   } else {
     uint32_t num_threads = block_dim.x * block_dim.y * block_dim.z;
@@ -5,37 +5,36 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
-#pragma once
 
 #if (defined(__CUDA_ARCH__) && (__CUDA_ARCH__ >= 900))
 
 // The optional .relaxed qualifier on barrier.cluster.arrive specifies that
 // there are no memory ordering and visibility guarantees provided for the
 // memory accesses performed prior to barrier.cluster.arrive.
-void clusterArriveRelaxed() {
+__device__ inline void clusterArriveRelaxed() {
   asm volatile("barrier.cluster.arrive.relaxed.aligned;" : :);
 }
 
 // A thread arrives at barrier but it does not have to wait for threads in other
 // participating warps.
-void clusterArrive() {
+__device__ inline void clusterArrive() {
   asm volatile("barrier.cluster.arrive.aligned;" : :);
 }
 
 // A thread waits for all non-exited threads of the cluster to perform
 // cluster_arrive.
-void clusterWait() {
+__device__ inline void clusterWait() {
   asm volatile("barrier.cluster.wait.aligned;" : :);
 }
 
 // Synchronize threads in cluster
-void clusterSync() {
-  cluster_arrive();
-  cluster_wait();
+__device__ inline void clusterSync() {
+  clusterArrive();
+  clusterWait();
 }
 
 // Returns the dim3 grid size in terms of number of clusters.
-dim3 clusterGridDims() {
+__device__ inline dim3 clusterGridDims() {
   uint32_t x, y, z;
   asm volatile("mov.u32 %0, %%nclusterid.x;" : "=r"(x) :);
   asm volatile("mov.u32 %0, %%nclusterid.y;" : "=r"(y) :);
@@ -44,7 +43,7 @@ dim3 clusterGridDims() {
 }
 
 // Returns the dim3 cluster rank in the grid.
-dim3 clusterIdInGrid() {
+__device__ inline dim3 clusterIdInGrid() {
   uint32_t x, y, z;
   asm volatile("mov.u32 %0, %%clusterid.x;" : "=r"(x) :);
   asm volatile("mov.u32 %0, %%clusterid.y;" : "=r"(y) :);
@@ -53,7 +52,7 @@ dim3 clusterIdInGrid() {
 }
 
 // Returns the relative dim3 block rank local to the cluster.
-dim3 blockIdInCluster() {
+__device__ inline dim3 blockIdInCluster() {
   uint32_t x, y, z;
   asm volatile("mov.u32 %0, %%cluster_ctaid.x;" : "=r"(x) :);
   asm volatile("mov.u32 %0, %%cluster_ctaid.y;" : "=r"(y) :);
@@ -62,7 +61,7 @@ dim3 blockIdInCluster() {
 }
 
 // Returns the dim3 cluster shape.
-dim3 clusterShape() {
+__device__ inline dim3 clusterShape() {
   uint32_t x, y, z;
   asm volatile("mov.u32 %0, %%cluster_nctaid.x;" : "=r"(x) :);
   asm volatile("mov.u32 %0, %%cluster_nctaid.y;" : "=r"(y) :);
@@ -71,14 +70,14 @@ dim3 clusterShape() {
 }
 
 // Get 1D ctaid in a cluster.
-uint32_t blockRankInCluster() {
+__device__ inline uint32_t blockRankInCluster() {
   uint32_t rank;
   asm volatile("mov.u32 %0, %%cluster_ctarank;" : "=r"(rank) :);
   return rank;
 }
 
 // Set the destination block-ID in cluster for a given SMEM Address
-uint32_t mapSharedRank(uint32_t smemAddr, uint32_t rank) {
+__device__ inline uint32_t mapSharedRank(uint32_t smemAddr, uint32_t rank) {
   uint32_t result;
   asm volatile("mapa.shared::cluster.u32  %0, %1, %2;"
                : "=r"(result)
@@ -86,4 +85,16 @@ uint32_t mapSharedRank(uint32_t smemAddr, uint32_t rank) {
   return result;
 }
 
+// Maps a generic pointer into the shared memory of this block to the
+// corresponding address in the shared memory of the block with the given rank
+// in the cluster. The result can be dereferenced like any generic pointer.
+template <typename T>
+__device__ inline T* mapSharedRank(T* ptr, uint32_t rank) {
+  uint64_t result;
+  asm volatile("mapa.u64  %0, %1, %2;"
+               : "=l"(result)
+               : "l"(reinterpret_cast<uint64_t>(ptr)), "r"(rank));
+  return reinterpret_cast<T*>(result);
+}
+
 #endif // Arch 90
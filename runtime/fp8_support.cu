@@ -425,3 +425,101 @@ __device__ __inline__ __e5m2 operator|(const __e5m2 x, const __e5m2 y) {
   asm("{  or.b16 %0, %1, %2;}\n" : "=h"(val) : "h"(x_val), "h"(y_val));
   return __e5m2(val);
 }
+
+// Packed conversions between FP8 and float or half. Each instruction converts
+// two elements, with the same results as the scalar conversions above.
+
+__device__ __inline__ void __fp8x2Cast(const float* in, __e4m3* out) {
+  unsigned short _tmp_buffer;
+  // The first operand is converted into the upper byte
+  asm("{cvt.rn.satfinite.e4m3x2.f32 %0, %1, %2;}"
+      : "=h"(_tmp_buffer)
+      : "f"(in[1]), "f"(in[0]));
+  memcpy(out, &_tmp_buffer, 2 * sizeof(uint8_t));
+}
+
+__device__ __inline__ void __fp8x2Cast(const __half* in, __e4m3* out) {
+  uint32_t buffer;
+  memcpy(&buffer, in, 2 * sizeof(__half));
+  unsigned short _tmp_buffer;
+  asm("{cvt.rn.satfinite.e4m3x2.f16x2 %0, %1;}"
+      : "=h"(_tmp_buffer)
+      : "r"(buffer));
+  memcpy(out, &_tmp_buffer, 2 * sizeof(uint8_t));
+}
+
+__device__ __inline__ void __fp8x2Cast(const __e4m3* in, __half* out) {
+  unsigned short _tmp_buffer;
+  memcpy(&_tmp_buffer, in, 2 * sizeof(uint8_t));
+  uint32_t buffer;
+  asm("{cvt.rn.f16x2.e4m3x2 %0, %1;}" : "=r"(buffer) : "h"(_tmp_buffer));
+  memcpy(out, &buffer, 2 * sizeof(__half));
+}
+
+__device__ __inline__ void __fp8x2Cast(const __e4m3* in, float* out) {
+  unsigned short _tmp_buffer;
+  memcpy(&_tmp_buffer, in, 2 * sizeof(uint8_t));
+  asm("{\n\t"
+      ".reg .b32 buf0;\n\t"
+      ".reg .b16 lo, hi;\n\t"
+      "cvt.rn.f16x2.e4m3x2 buf0, %2;\n\t"
+      "mov.b32 {lo, hi}, buf0;\n\t"
+      "cvt.f32.f16 %0, lo;\n\t"
+      "cvt.f32.f16 %1, hi;\n\t"
+      "}"
+      : "=f"(out[0]), "=f"(out[1])
+      : "h"(_tmp_buffer));
+}
+
+__device__ __inline__ void __fp8x2Cast(const float* in, __e5m2* out) {
+  unsigned short _tmp_buffer;
+  // The first operand is converted into the upper byte
+  asm("{cvt.rn.satfinite.e5m2x2.f32 %0, %1, %2;}"
+      : "=h"(_tmp_buffer)
+      : "f"(in[1]), "f"(in[0]));
+  memcpy(out, &_tmp_buffer, 2 * sizeof(uint8_t));
+}
+
+__device__ __inline__ void __fp8x2Cast(const __half* in, __e5m2* out) {
+  uint32_t buffer;
+  memcpy(&buffer, in, 2 * sizeof(__half));
+  unsigned short _tmp_buffer;
+  asm("{cvt.rn.satfinite.e5m2x2.f16x2 %0, %1;}"
+      : "=h"(_tmp_buffer)
+      : "r"(buffer));
+  memcpy(out, &_tmp_buffer, 2 * sizeof(uint8_t));
+}
+
+__device__ __inline__ void __fp8x2Cast(const __e5m2* in, __half* out) {
+  unsigned short _tmp_buffer;
+  memcpy(&_tmp_buffer, in, 2 * sizeof(uint8_t));
+  uint32_t buffer;
+  asm("{cvt.rn.f16x2.e5m2x2 %0, %1;}" : "=r"(buffer) : "h"(_tmp_buffer));
+  memcpy(out, &buffer, 2 * sizeof(__half));
+}
+
+__device__ __inline__ void __fp8x2Cast(const __e5m2* in, float* out) {
+  unsigned short _tmp_buffer;
+  memcpy(&_tmp_buffer, in, 2 * sizeof(uint8_t));
+  asm("{\n\t"
+      ".reg .b32 buf0;\n\t"
+      ".reg .b16 lo, hi;\n\t"
+      "cvt.rn.f16x2.e5m2x2 buf0, %2;\n\t"
+      "mov.b32 {lo, hi}, buf0;\n\t"
+      "cvt.f32.f16 %0, lo;\n\t"
+      "cvt.f32.f16 %1, hi;\n\t"
+      "}"
+      : "=f"(out[0]), "=f"(out[1])
+      : "h"(_tmp_buffer));
+}
+
+// Converts N contiguous elements, two at a time. Generated for unrolled loops
+// that only cast between local arrays.
+template <int N, typename InT, typename OutT>
+__device__ __inline__ void fp8PackedCast(const InT* in, OutT* out) {
+  static_assert(N % 2 == 0, "Packed FP8 casts convert pairs of elements");
+#pragma unroll
+  for (int i = 0; i < N; i += 2) {
+    __fp8x2Cast(in + i, out + i);
+  }
+}
@@ -308,6 +308,97 @@ __device__ void gridReduce(
   }
 }
 
+// A non-persistent grid reduction whose result is not used by anything else
+// in the kernel, e.g., when the output is written to global memory directly.
+// The result then doesn't need to end up in a particular block, so the last
+// block of each segment to arrive does the final reduction, and no block
+// waits for the others. The arguments are the same as for gridReduce.
+template <
+    bool X_BLOCK,
+    bool Y_BLOCK,
+    bool Z_BLOCK,
+    bool X_THREAD,
+    bool Y_THREAD,
+    bool Z_THREAD,
+    bool Aligned,
+    typename T,
+    typename Func,
+    typename BlockDimT>
+__device__ void gridReduceLastArrival(
+    T& out,
+    const T& inp_val,
+    Func reduction_op,
+    volatile T* work_buf,
+    int64_t* sync_flags,
+    T* shared_buf,
+    bool read_pred,
+    bool write_pred,
+    T init_val,
+    const nvfuser_index_t entrance_ind,
+    const nvfuser_index_t n_entrances,
+    BlockDimT block_dim) {
+  T block_reduction_val = init_val;
+
+  // Do block reduction when required
+  if (X_THREAD || Y_THREAD || Z_THREAD) {
+    blockReduce<X_THREAD, Y_THREAD, Z_THREAD, Aligned>(
+        block_reduction_val,
+        inp_val,
+        reduction_op,
+        shared_buf,
+        read_pred,
+        true,
+        init_val,
+        block_dim);
+  } else if (read_pred) {
+    block_reduction_val = inp_val;
+  }
+
+  const auto grid_reduction_segment_size =
+      index_utils::maskedSize<X_BLOCK, Y_BLOCK, Z_BLOCK>(gridDim);
+  const auto idx_in_grid_segment =
+      index_utils::maskedOffset<!X_BLOCK, !Y_BLOCK, !Z_BLOCK>(
+          blockIdx, gridDim);
+  const auto block_reduction_segment_size =
+      index_utils::maskedSize<!X_THREAD, !Y_THREAD, !Z_THREAD>(block_dim);
+  const nvfuser_index_t grid_segment_size =
+      index_utils::maskedSize<!X_BLOCK, !Y_BLOCK, !Z_BLOCK>(gridDim);
+
+  work_buf += (entrance_ind * grid_segment_size + idx_in_grid_segment) *
+      grid_reduction_segment_size * block_reduction_segment_size;
+
+  if ((!X_THREAD || threadIdx.x == 0) && (!Y_THREAD || threadIdx.y == 0) &&
+      (!Z_THREAD || threadIdx.z == 0)) {
+    auto block_offset =
+        index_utils::maskedOffset<X_BLOCK, Y_BLOCK, Z_BLOCK>(blockIdx, gridDim);
+    auto thread_offset =
+        index_utils::maskedOffset<!X_THREAD, !Y_THREAD, !Z_THREAD>(
+            threadIdx, block_dim);
+    auto work_buf_offset =
+        block_offset * block_reduction_segment_size + thread_offset;
+    work_buf[work_buf_offset] = block_reduction_val;
+  }
+
+  // Use a different sync flag for each call
+  const bool last_to_arrive = grid_sync::arrive<Aligned>(
+      sync_flags[entrance_ind * grid_segment_size + idx_in_grid_segment],
+      grid_reduction_segment_size,
+      block_dim);
+
+  if (last_to_arrive) {
+    gridReduceLastBlock<!X_THREAD, !Y_THREAD, !Z_THREAD, Aligned>(
+        out,
+        (T*)work_buf,
+        grid_reduction_segment_size,
+        block_reduction_segment_size,
+        reduction_op,
+        shared_buf,
+        write_pred,
+        init_val,
+        block_dim);
+  }
+}
+
 // This is just a wrapper of the above grid reduction routine to
 // measure the elapsed cycles. The measurement must be done just by
 // one thread, and in this case it should be done by one of the
@@ -382,6 +473,96 @@ __device__ void gridReduce(
 }
 #endif // NVFUSER_PROFILE_KERNEL
 
+#if (defined(__CUDA_ARCH__) && (__CUDA_ARCH__ >= 900))
+// Grid reduction for kernels launched with thread block clusters where every
+// reduction segment is exactly one cluster, i.e. the cluster spans all the
+// blocks of the reduced grid dimensions and nothing else. The partial results
+// of the blocks are exchanged through distributed shared memory, so unlike
+// gridReduce no global work buffer or semaphore is used and the blocks only
+// wait for the other blocks of their own cluster.
+//
+// The last block of the segment reduces the partials of all the blocks in a
+// fixed order, so the result is deterministic. shared_buf must hold at least
+// one element per thread of the block, which is what blockReduce requires
+// anyway.
+template <
+    bool X_BLOCK,
+    bool Y_BLOCK,
+    bool Z_BLOCK,
+    bool X_THREAD,
+    bool Y_THREAD,
+    bool Z_THREAD,
+    bool Aligned,
+    typename T,
+    typename Func,
+    typename BlockDimT>
+__device__ void clusterReduce(
+    T& out,
+    const T& inp_val,
+    Func reduction_op,
+    T* shared_buf,
+    bool read_pred,
+    bool write_pred,
+    T init_val,
+    // block_dim is basically just blockDim (wrapped as DefaultBlockDim) if
+    // there is no warp specialization in the kernel. If there is warp
+    // specialization, block_dim is the the dimension of the compute warps.
+    BlockDimT block_dim) {
+  T block_reduction_val = init_val;
+
+  // Do block reduction when required
+  if (X_THREAD || Y_THREAD || Z_THREAD) {
+    blockReduce<X_THREAD, Y_THREAD, Z_THREAD, Aligned>(
+        block_reduction_val,
+        inp_val,
+        reduction_op,
+        shared_buf,
+        read_pred,
+        true,
+        init_val,
+        block_dim);
+  } else if (read_pred) {
+    block_reduction_val = inp_val;
+  }
+
+  // shared_buf may still be read by the block reduction
+  block_sync::sync<Aligned>(block_dim);
+
+  const bool has_partial = (!X_THREAD || threadIdx.x == 0) &&
+      (!Y_THREAD || threadIdx.y == 0) && (!Z_THREAD || threadIdx.z == 0);
+  const auto thread_offset =
+      index_utils::maskedOffset<!X_THREAD, !Y_THREAD, !Z_THREAD>(
+          threadIdx, block_dim);
+  if (has_partial) {
+    shared_buf[thread_offset] = block_reduction_val;
+  }
+
+  // The arrive has release and the wait has acquire semantics, which makes
+  // the partials visible to the whole cluster
+  clusterSync();
+
+  if (has_partial &&
+      index_utils::maskedIsLast<X_BLOCK, Y_BLOCK, Z_BLOCK>(
+          blockIdx, gridDim)) {
+    const auto cluster_size =
+        index_utils::maskedSize<X_BLOCK, Y_BLOCK, Z_BLOCK>(gridDim);
+    T cluster_reduction_val = init_val;
+    for (nvfuser_index_t rank = 0; rank < cluster_size; ++rank) {
+      reduction_op(
+          cluster_reduction_val,
+          *mapSharedRank(&shared_buf[thread_offset], (uint32_t)rank));
+    }
+    if (write_pred) {
+      reduction_op(out, cluster_reduction_val);
+    }
+  }
+
+  // Shared memory of a block must stay untouched until the last block of the
+  // cluster is done reading it
+  clusterSync();
+}
+#endif // Arch 90
+
 template <
     bool X_BLOCK,
     bool Y_BLOCK,
@@ -107,6 +107,112 @@ __device__ void sync(
       block_dim);
 }
 
+// A grid synchronization like the persistent sync above that leaves the
+// semaphore at zero once all blocks have left it, so that the semaphore can be
+// placed in reused zeroed memory instead of being cleared before each launch.
+// All blocks must be resident on device, i.e., the kernel has to be launched
+// cooperatively.
+//
+// The semaphore counts the arriving blocks. The last one to arrive sets the
+// first bit, which releases the other blocks, and the released blocks count
+// down as they leave. The last one to leave clears the semaphore. A block only
+// arrives at the next sync after the semaphore has been cleared.
+template <
+    bool X_BLOCK,
+    bool Y_BLOCK,
+    bool Z_BLOCK,
+    bool Aligned,
+    typename BlockDimT>
+__device__ void resettingSync(
+    int64_t& semaphore,
+    const uint64_t& segment_size,
+    BlockDimT block_dim) {
+  // Finish all global memory transactions before synchronizing
+  __threadfence();
+
+  // Synchronize all threads in a block before synchronizing blocks
+  block_sync::sync<Aligned>(block_dim);
+
+  // Only allow linear_tid == 0 to participate in the synchronization
+  if (threadIdx.x == 0 && threadIdx.y == 0 && threadIdx.z == 0) {
+    auto semaphore_ptr = reinterpret_cast<unsigned long long*>(&semaphore);
+
+    // Wait for all blocks to have left the previous sync
+    unsigned int ns = 8;
+    while (((uint64_t)globalAsVolatile(semaphore) & FIRST_UINT64_BIT) != 0) {
+#if __CUDA_ARCH__ >= 700
+      // __nanosleep only available on compute capability 7.0 or higher
+      __nanosleep(ns); // avoids busy waiting
+      if (ns < 256) {
+        ns *= 2;
+      }
+#endif
+    }
+
+    uint64_t old_arrive = atomicAdd(semaphore_ptr, 1ULL);
+    if (old_arrive == segment_size - 1) {
+      // All the other blocks are waiting, so nothing else updates the
+      // semaphore until it is released
+      atomicExch(
+          semaphore_ptr,
+          segment_size == 1 ? 0ULL : (FIRST_UINT64_BIT | (segment_size - 1)));
+    } else {
+      ns = 8;
+      while (((uint64_t)globalAsVolatile(semaphore) & FIRST_UINT64_BIT) ==
+             0) {
+#if __CUDA_ARCH__ >= 700
+        // __nanosleep only available on compute capability 7.0 or higher
+        __nanosleep(ns); // avoids busy waiting
+        if (ns < 256) {
+          ns *= 2;
+        }
+#endif
+      }
+      uint64_t old_leave = atomicAdd(semaphore_ptr, ~0ULL);
+      if (old_leave == (FIRST_UINT64_BIT | 1)) {
+        atomicExch(semaphore_ptr, 0ULL);
+      }
+    }
+  }
+
+  // Sync block to make sure all other threads are waiting on the sync
+  block_sync::sync<Aligned>(block_dim);
+}
+
+// Arrives at the semaphore of a reduction segment without waiting for the
+// other blocks. Returns true in the last block of the segment to arrive, which
+// then sees what the other blocks wrote to global memory before arriving. The
+// semaphore must be zero before the first block arrives and is reset to zero
+// by the last one.
+template <bool Aligned, typename BlockDimT>
+__device__ bool arrive(
+    int64_t& semaphore,
+    const uint64_t& segment_size,
+    BlockDimT block_dim) {
+  __shared__ bool last_to_arrive;
+
+  // Finish all global memory transactions before arriving
+  __threadfence();
+
+  // Synchronize all threads in a block before arriving
+  block_sync::sync<Aligned>(block_dim);
+
+  if (threadIdx.x == 0 && threadIdx.y == 0 && threadIdx.z == 0) {
+    auto semaphore_ptr = reinterpret_cast<unsigned long long*>(&semaphore);
+    uint64_t old_arrive = atomicAdd(semaphore_ptr, 1ULL);
+    last_to_arrive = old_arrive == segment_size - 1;
+    if (last_to_arrive) {
+      // Every other block has arrived, so nothing else updates the semaphore
+      atomicExch(semaphore_ptr, 0ULL);
+      __threadfence();
+    }
+  }
+
+  // Broadcast the result to the block
+  block_sync::sync<Aligned>(block_dim);
+  return last_to_arrive;
+}
+
 // Grid sync that can be called multiple times in the same kernel without all
 // blocks being resident on device. This allows grid sync to be called multiple
 // times as long as it's not broadcasted on the parallel axis it was reduced on.
@@ -496,6 +496,38 @@ __device__ inline int64_t readCycleCounter() {
   return clock64();
 }
 
+// Append an event to the timeline of the warp of the calling thread, see
+// KernelPerformanceProfile::writeTimeline for the layout of the buffer. Only
+// the warps of the first num_sampled_blocks blocks record, and only the first
+// active lane of each warp does.
+__device__ inline void recordTimelineEvent(
+    int64_t* buffer,
+    int64_t event,
+    int64_t num_sampled_blocks,
+    int64_t max_records) {
+  const int64_t block = (int64_t)blockIdx.x +
+      (int64_t)gridDim.x *
+          ((int64_t)blockIdx.y + (int64_t)gridDim.y * (int64_t)blockIdx.z);
+  if (block >= num_sampled_blocks) {
+    return;
+  }
+  const unsigned int thread =
+      threadIdx.x + blockDim.x * (threadIdx.y + blockDim.y * threadIdx.z);
+  if (__ffs(__activemask()) - 1 != (int)(thread % 32)) {
+    return;
+  }
+  int64_t* row = buffer + (block * 32 + thread / 32) * (1 + 2 * max_records);
+  const int64_t count = row[0];
+  if (count < max_records) {
+    uint64_t timestamp;
+    asm volatile("mov.u64 %0, %%globaltimer;" : "=l"(timestamp));
+    row[1 + 2 * count] = (int64_t)timestamp;
+    row[2 + 2 * count] = event;
+  }
+  // Keep counting past the cap so that dropped records are reported
+  row[0] = count + 1;
+}
+
 __device__ float print_impl(const char* name, float value) {
   printf(
       "%s = %f @ threadIdx=(%d,%d,%d), blockIdx=(%d,%d,%d)\n",
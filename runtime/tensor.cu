@@ -7,7 +7,10 @@
 // clang-format on
 template <typename T, int Dims, int AllocDims = Dims>
 struct Tensor {
-  __device__ T& operator[](nvfuser_index_t ind) {
+  // Offsets are int64_t even with 32-bit nvfuser_index_t when
+  // sub-tensor indexing is used
+  template <typename IndexT>
+  __device__ T& operator[](IndexT ind) {
     return data[ind];
   };
 
@@ -16,12 +19,40 @@ struct Tensor {
   Array<nvfuser_index_t, AllocDims, 1> alloc_stride;
 };
 
+// Specializations for tensors whose sizes or strides are not read by the
+// kernel, which are then not passed to it (see
+// EnableOption::CompactTensorArgs)
+template <typename T, int AllocDims>
+struct Tensor<T, 0, AllocDims> {
+  template <typename IndexT>
+  __device__ T& operator[](IndexT ind) {
+    return data[ind];
+  };
+
+  T* data;
+  Array<nvfuser_index_t, AllocDims, 1> alloc_stride;
+};
+
+template <typename T, int Dims>
+struct Tensor<T, Dims, 0> {
+  template <typename IndexT>
+  __device__ T& operator[](IndexT ind) {
+    return data[ind];
+  };
+
+  T* data;
+  Array<nvfuser_index_t, Dims, 1> logical_size;
+};
+
 // Specialization for 0-dim case as it does not need size and stride arrays.
 // They will be an error as well since zero-length arrays are not allowed.
+// This is also used for tensors of any dimension whose sizes and strides are
+// both not read by the kernel. The index of a 0-dim tensor is always zero.
 template <typename T>
 struct Tensor<T, 0> {
-  __device__ T& operator[](nvfuser_index_t i) {
-    return *data;
+  template <typename IndexT>
+  __device__ T& operator[](IndexT ind) {
+    return data[ind];
   };
 
   T* data;
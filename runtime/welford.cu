@@ -260,6 +260,126 @@ __inline__ __device__ void blockWelford(
       init_val,
       block_dim);
 }
+
+// Same as blockWelford, but in_N must be the same on all threads and every
+// thread must participate, i.e., there is no read predicate. A partial
+// result at offset i of the reduction segment then combines the inputs at
+// the offsets j with j % stride == i, so its N is known without keeping N
+// in shared memory. The results are identical to blockWelford.
+template <
+    bool X_REDUCE,
+    bool Y_REDUCE,
+    bool Z_REDUCE,
+    bool Aligned,
+    typename T,
+    typename TN,
+    typename BlockDimT>
+__inline__ __device__ void blockWelfordUniformN(
+    T& out_avg,
+    T& out_M2,
+    TN& out_N,
+    const T& in_avg,
+    const T& in_M2,
+    const TN& in_N,
+    T* shared_mem_avg,
+    T* shared_mem_M2,
+    bool write_pred,
+    // block_dim is basically just blockDim (wrapped as DefaultBlockDim) if
+    // there is no warp specialization in the kernel. If there is warp
+    // specialization, block_dim is the the dimension of the compute warps.
+    BlockDimT block_dim) {
+  // If this thread will output a final result
+  bool should_write =
+      index_utils::maskedIsZero<X_REDUCE, Y_REDUCE, Z_REDUCE>(threadIdx);
+
+  // Size of the reduction segments
+  unsigned int reduction_size =
+      index_utils::maskedSize<X_REDUCE, Y_REDUCE, Z_REDUCE>(block_dim);
+
+  // Index into the reduction segment
+  unsigned int reduction_tid =
+      index_utils::maskedOffset<X_REDUCE, Y_REDUCE, Z_REDUCE>(
+          threadIdx, block_dim);
+
+  // Index of the reduction segment
+  unsigned int reduction_idx =
+      index_utils::maskedOffset<!X_REDUCE, !Y_REDUCE, !Z_REDUCE>(
+          threadIdx, block_dim);
+
+  // Offset into smem for the current thread
+  unsigned int smem_offset = reduction_idx * reduction_size + reduction_tid;
+
+  // N of the partial result at offset i when the segment has been folded
+  // with the stride 1 << log2_stride
+  auto partial_N = [&](unsigned int i, int log2_stride) {
+    return in_N *
+        (TN)((reduction_size - i + (1u << log2_stride) - 1) >> log2_stride);
+  };
+
+  shared_mem_avg[smem_offset] = in_avg;
+  shared_mem_M2[smem_offset] = in_M2;
+
+  block_sync::sync<Aligned>(block_dim);
+  // Reduce down to nearest power of 2:
+  int log2_np2 = 31 - __clz(reduction_size);
+  int np2 = 1 << log2_np2;
+
+  if (reduction_tid < np2 && reduction_tid + np2 < reduction_size) {
+    TN a_N = in_N;
+    welfordCombine(
+        shared_mem_avg[smem_offset],
+        shared_mem_M2[smem_offset],
+        a_N,
+        shared_mem_avg[smem_offset + np2],
+        shared_mem_M2[smem_offset + np2],
+        in_N);
+  }
+  block_sync::sync<Aligned>(block_dim);
+
+  // loop peel the final iteration to save one syncthread for the end
+  int log2_stride = log2_np2;
+  for (int factor = np2 / 2; factor > 1; factor >>= 1) {
+    if (reduction_tid < factor) {
+      TN a_N = partial_N(reduction_tid, log2_stride);
+      welfordCombine(
+          shared_mem_avg[smem_offset],
+          shared_mem_M2[smem_offset],
+          a_N,
+          shared_mem_avg[smem_offset + factor],
+          shared_mem_M2[smem_offset + factor],
+          partial_N(reduction_tid + factor, log2_stride));
+    }
+    --log2_stride;
+    block_sync::sync<Aligned>(block_dim);
+  }
+
+  if (should_write && write_pred) {
+    T res_avg = out_avg;
+    T res_M2 = out_M2;
+    TN res_N = out_N;
+    welfordCombine(
+        res_avg,
+        res_M2,
+        res_N,
+        shared_mem_avg[smem_offset],
+        shared_mem_M2[smem_offset],
+        partial_N(0, log2_stride));
+    if (reduction_size > 1) {
+      welfordCombine(
+          res_avg,
+          res_M2,
+          res_N,
+          shared_mem_avg[smem_offset + 1],
+          shared_mem_M2[smem_offset + 1],
+          partial_N(1, log2_stride));
+    }
+    out_avg = res_avg;
+    out_M2 = res_M2;
+    out_N = res_N;
+  }
+  block_sync::sync<Aligned>(block_dim);
+}
+
 // -----------------------------------------------------------------------------------------------
 //  Grid Welford Prototype
 // -----------------------------------------------------------------------------------------------
@@ -29,6 +29,9 @@
 #   --build-without-distributed
 #     Build nvfuser without multidevice support
 #
+#   --build-with-zstd
+#     Build nvfuser with zstd, to store serialized kernel binaries compressed with NVFUSER_ENABLE=compress_kernel_binaries.
+#
 #   --debug
 #     Building nvfuser in debug mode
 #
@@ -77,6 +80,7 @@ NO_BENCHMARK = False
 NO_NINJA = False
 BUILD_WITH_UCC = False
 BUILD_WITH_ASAN = False
+BUILD_WITH_ZSTD = False
 BUILD_WITHOUT_DISTRIBUTED = False
 OVERWRITE_VERSION = False
 EXPLICIT_ERROR_CHECK = False
@@ -117,6 +121,9 @@ for i, arg in enumerate(sys.argv):
     if arg == "--build-without-distributed":
         BUILD_WITHOUT_DISTRIBUTED = True
         continue
+    if arg == "--build-with-zstd":
+        BUILD_WITH_ZSTD = True
+        continue
     if arg == "--debug":
         BUILD_TYPE = "Debug"
         continue
@@ -348,6 +355,8 @@ def cmake():
         cmd_str.append("-DBUILD_NVFUSER_BENCHMARK=ON")
     if BUILD_WITH_ASAN:
         cmd_str.append("-DNVFUSER_BUILD_WITH_ASAN=ON")
+    if BUILD_WITH_ZSTD:
+        cmd_str.append("-DNVFUSER_BUILD_WITH_ZSTD=ON")
     if BUILD_WITHOUT_DISTRIBUTED:
         cmd_str.append("-DNVFUSER_DISTRIBUTED=OFF")
     cmd_str.append(".")
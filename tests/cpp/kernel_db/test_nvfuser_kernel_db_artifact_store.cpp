@@ -0,0 +1,98 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <gmock/gmock-matchers.h>
+#include <gtest/gtest.h>
+
+#include <torch/torch.h>
+
+#include <kernel_db/artifact_store.h>
+#include <kernel_db/kernel_db.h>
+#include <kernel_db/utils.h>
+#include <tests/cpp/utils.h>
+#include <tests/cpp/validator.h>
+
+// RUN CMD: bin/test_jit --gtest_filter="NVFuserTest*KernelDb_ArtifactStore*"
+namespace nvfuser {
+
+TEST_F(NVFuserTest, KernelDb_ArtifactStore_CUDA) {
+  // Setup the test db
+  fs::path test_data =
+      fs::path(__FILE__).parent_path() / "test_data/kernel_db_for_query_test";
+  ASSERT_TRUE(fs::is_directory(test_data));
+  std::string code;
+  std::vector<char> cubin;
+  ASSERT_TRUE(copy_from_text_file(test_data / "kernel_0.cu", code));
+  ASSERT_TRUE(copy_from_binary_file(test_data / "kernel_0.cubin", cubin));
+  const std::string compile_args(
+      "--std=c++14 --gpu-architecture=sm_80 -default-device --fmad=true -DNDEBUG --ptxas-options --maxrregcount=255");
+  const std::string kernel_signature(
+      "_ZN76_GLOBAL__N__00000000_37___tmp_kernel_pointwise_f0_c1_r0_g0_cu_8995cef2_3255329nvfuser_pointwise_f0_c1_r0_g0ENS_6TensorIfLi2ELi2EEES1_S1_");
+
+  const std::string kernel_db_file("index.bin");
+  const std::string writer_db_dir("nvfuser_kernel_db_store_writer_test");
+  const std::string reader_db_dir("nvfuser_kernel_db_store_reader_test");
+  fs::path store_path =
+      fs::temp_directory_path() / "nvfuser_kernel_db_store_test";
+  for (const auto& dir : {fs::temp_directory_path() / writer_db_dir,
+                          fs::temp_directory_path() / reader_db_dir,
+                          store_path}) {
+    if (fs::is_directory(dir)) {
+      fs::remove_all(dir);
+    }
+  }
+  auto store = std::make_shared<DirectoryArtifactStore>(store_path.string());
+
+  // A kernel written by one node is published to the store
+  {
+    auto& kernel_db =
+        KernelDb::get(writer_db_dir, kernel_db_file, true, false, true);
+    ASSERT_TRUE(kernel_db.enabled());
+    kernel_db.setArtifactStore(store);
+    ASSERT_TRUE(kernel_db.write(code, compile_args, kernel_signature, cubin));
+  }
+
+  // Another node with an empty local db fetches it from the store
+  {
+    auto& kernel_db =
+        KernelDb::get(reader_db_dir, kernel_db_file, true, false, true);
+    ASSERT_TRUE(kernel_db.enabled());
+    ASSERT_EQ(kernel_db.size(), 0);
+
+    std::string queried_signature;
+    std::vector<char> queried_cubin;
+    ASSERT_FALSE(kernel_db.query(
+        code, compile_args, queried_signature, queried_cubin));
+
+    kernel_db.setArtifactStore(store);
+    ASSERT_TRUE(kernel_db.query(
+        code, compile_args, queried_signature, queried_cubin));
+    EXPECT_EQ(queried_signature, kernel_signature);
+    EXPECT_EQ(queried_cubin, cubin);
+    // The fetched kernel is added to the local db
+    EXPECT_EQ(kernel_db.size(), 1);
+
+    // The store holds the artifact under its content address
+    KernelArtifact artifact;
+    const KernelDbKey key{stable_hash(code), stable_hash(compile_args)};
+    ASSERT_TRUE(store->fetch(key, artifact));
+    EXPECT_EQ(artifact.kernel_code, code);
+    EXPECT_EQ(artifact.compile_args, compile_args);
+  }
+
+  // Cleanup DB Directories
+  KernelDb::get(reader_db_dir, kernel_db_file, true, true, true);
+  for (const auto& dir : {fs::temp_directory_path() / writer_db_dir,
+                          fs::temp_directory_path() / reader_db_dir,
+                          store_path}) {
+    if (fs::is_directory(dir)) {
+      fs::remove_all(dir);
+    }
+  }
+}
+
+} // namespace nvfuser
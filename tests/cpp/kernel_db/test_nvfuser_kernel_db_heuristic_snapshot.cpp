@@ -0,0 +1,126 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <gtest/gtest.h>
+
+#include <torch/torch.h>
+
+#include <algorithm>
+#include <sstream>
+
+#include <kernel_db/heuristic_snapshot.h>
+#include <kernel_db/utils.h>
+#include <ops/all_ops.h>
+#include <options.h>
+#include <runtime/fusion_executor_cache.h>
+#include <runtime/fusion_kernel_runtime.h>
+#include <tests/cpp/utils.h>
+#include <tests/cpp/validator.h>
+
+// RUN CMD: bin/test_jit --gtest_filter="NVFuserTest*KernelDb_Heuristic*"
+namespace nvfuser {
+
+TEST_F(NVFuserTest, KernelDb_HeuristicSnapshotRecords) {
+  fs::path path =
+      fs::temp_directory_path() / "nvfuser_heuristic_snapshot_test.tsv";
+  fs::remove(path);
+
+  TunedHeuristics tuned;
+  tuned.matmul_expr_eval = false;
+  tuned.scheduler_types = {SchedulerType::Reduction, SchedulerType::PointWise};
+  tuned.autotune_variants.resize(2);
+  tuned.autotune_variants.at(0).log2_scales.at(
+      (size_t)AutotuneKnob::InnerUnroll) = 1;
+  tuned.autotune_variants.at(0).log2_scales.at(
+      (size_t)AutotuneKnob::Vectorize) = -1;
+  EXPECT_EQ(
+      tuned.toString(),
+      "matmul_expr_eval=0 reduction:vectorize=-1,inner_unroll=1 pointwise");
+  EXPECT_EQ(TunedHeuristics::fromString(tuned.toString()), tuned);
+  EXPECT_FALSE(
+      TunedHeuristics::fromString("matmul_expr_eval=1 unknown").has_value());
+  EXPECT_FALSE(TunedHeuristics::fromString("pointwise").has_value());
+
+  {
+    HeuristicSnapshot snapshot(path.string());
+    EXPECT_FALSE(snapshot.lookup(1, "Float[8, 8]").has_value());
+    ASSERT_TRUE(snapshot.record(1, "Float[8, 8]", tuned));
+    // Records of the same choices are not appended again
+    ASSERT_TRUE(snapshot.record(1, "Float[8, 8]", tuned));
+    ASSERT_TRUE(snapshot.record(2, "Float[8, 8]", TunedHeuristics()));
+  }
+  // A record naming a scheduler this version doesn't know is dropped
+  ASSERT_TRUE(append_to_text_file(
+      path.string(),
+      "0000000000000003\tFloat[8, 8]\tmatmul_expr_eval=1 old\n"));
+
+  std::string contents;
+  ASSERT_TRUE(copy_from_text_file(path.string(), contents));
+  EXPECT_EQ(std::count(contents.begin(), contents.end(), '\n'), 4);
+
+  HeuristicSnapshot reloaded(path.string());
+  EXPECT_EQ(reloaded.lookup(1, "Float[8, 8]"), tuned);
+  EXPECT_EQ(reloaded.lookup(2, "Float[8, 8]"), TunedHeuristics());
+  EXPECT_FALSE(reloaded.lookup(1, "Float[8, 16]").has_value());
+  EXPECT_FALSE(reloaded.lookup(3, "Float[8, 8]").has_value());
+
+  // Files of another format are left alone
+  ASSERT_TRUE(
+      copy_to_text_file(path.string(), "nvfuser_heuristic_snapshot\t0\n"));
+  HeuristicSnapshot incompatible(path.string());
+  EXPECT_FALSE(incompatible.record(1, "Float[8, 8]", tuned));
+  EXPECT_FALSE(incompatible.lookup(1, "Float[8, 8]").has_value());
+
+  fs::remove(path);
+}
+
+// The variant recorded, e.g., by an older version, is applied instead of
+// autotuning the kernel again
+TEST_F(NVFuserTest, KernelDb_HeuristicSnapshotReuse_CUDA) {
+  fs::path path =
+      fs::temp_directory_path() / "nvfuser_heuristic_snapshot_reuse_test.tsv";
+  fs::remove(path);
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::HeuristicSnapshot, {path.string()});
+  EnableOptionsGuard::getCurOptions().set(EnableOption::Autotune);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  TensorView* tv1 = sin(tv0);
+  fusion->addOutput(tv1);
+
+  std::stringstream ss;
+  fusion->print(ss, /*include_tensor_transforms=*/false);
+  const uint64_t fusion_hash = stable_hash(ss.str());
+
+  TunedHeuristics tuned;
+  tuned.scheduler_types = {SchedulerType::PointWise};
+  tuned.autotune_variants.resize(1);
+  tuned.autotune_variants.at(0).log2_scales.at(
+      (size_t)AutotuneKnob::Vectorize) = -1;
+  HeuristicSnapshot& snapshot = HeuristicSnapshot::get();
+  EXPECT_EQ(snapshot.path(), path);
+  ASSERT_TRUE(snapshot.record(fusion_hash, "Float[1024, 1024]", tuned));
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 1024}, options);
+  auto outputs = executor_cache.runFusionWithInputs({t0});
+  testValidate(
+      executor_cache.fusion(), outputs, {t0}, {t0.sin()}, __LINE__, __FILE__);
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_EQ(runtime->autotunedVariants(), tuned.autotune_variants);
+  EXPECT_EQ(snapshot.lookup(fusion_hash, "Float[1024, 1024]"), tuned);
+
+  fs::remove(path);
+}
+
+} // namespace nvfuser
@@ -5,8 +5,6 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
-#include <fstream>
-
 #include <gmock/gmock-matchers.h>
 #include <gtest/gtest.h>
 
@@ -23,14 +21,13 @@ namespace nvfuser {
 
 TEST_F(NVFuserTest, KernelDb_Open_CUDA) {
   // Check a corrupted DB and reset the DB
-  // 1.) Test writes a bad db.csv file and open fails to match header
-  // 2.) Should delete cubins because of bad db.csv file.
-  // 3.) Creates a new empty db.csv file with proper header
+  // 1.) Test writes a bad index.bin file and open fails to match header
+  // 2.) Should delete cubins because of bad index.bin file.
+  // 3.) Creates a new empty index.bin file with proper header
   try {
     const std::string kernel_db_dir("nvfuser_kernel_db_open_test");
     const std::string bad_text("blahblahblah\n");
-    const std::string header(
-        "kernel_signature,compile_args,kernel_code_file,cubin_file");
+    const std::string header("NVFKDB01");
     fs::path test_db_path = fs::temp_directory_path() / kernel_db_dir;
     if (fs::is_directory(test_db_path)) {
       fs::remove_all(test_db_path);
@@ -38,7 +35,7 @@ TEST_F(NVFuserTest, KernelDb_Open_CUDA) {
     ASSERT_TRUE(fs::create_directory(test_db_path));
 
     // Setup 1
-    const std::string kernel_db_file("db.csv");
+    const std::string kernel_db_file("index.bin");
     fs::path test_db_file = test_db_path / kernel_db_file;
     ASSERT_FALSE(fs::is_regular_file(test_db_file));
     ASSERT_TRUE(copy_to_text_file(test_db_file.string(), bad_text));
@@ -53,10 +50,9 @@ TEST_F(NVFuserTest, KernelDb_Open_CUDA) {
     // Check 2
     ASSERT_FALSE(fs::is_regular_file(test_cubin_file));
     // Check 3
-    std::ifstream db_file(test_db_file.c_str(), std::ios::in);
-    std::string line;
-    std::getline(db_file, line);
-    ASSERT_TRUE(header == line);
+    std::string index;
+    ASSERT_TRUE(copy_from_text_file(test_db_file.string(), index));
+    ASSERT_TRUE(header == index);
 
     // Cleanup DB Directory
     if (fs::is_directory(test_db_path)) {
@@ -64,11 +60,11 @@ TEST_F(NVFuserTest, KernelDb_Open_CUDA) {
     }
     SUCCEED();
   } catch (const std::exception& e) {
-    FAIL() << "Failed replacing a bad db.csv file and removing cubins!"
+    FAIL() << "Failed replacing a bad index.bin file and removing cubins!"
            << e.what();
   }
 
-  // Check a successful opening of an existing DB
+  // Check a successful opening of an existing DB written by another process
   try {
     // Setup DB Directory
     const std::string kernel_db_dir("nvfuser_kernel_db_test");
@@ -76,30 +72,24 @@ TEST_F(NVFuserTest, KernelDb_Open_CUDA) {
     if (fs::is_directory(test_db_path)) {
       fs::remove_all(test_db_path);
     }
-    ASSERT_TRUE(fs::create_directory(test_db_path));
 
-    // Setup DB File and corresponding fake cubins and cuda files
-    const std::string header(
-        "kernel_signature,compile_args,kernel_code_file,cubin_file\n");
-    const std::string test_text("blahblahblah\n");
-    const std::string kernel_db_file("db.csv");
-    const std::string kernel_db_cubin("test1.cubin");
-    const std::string kernel_db_kernel("test1.cu");
-    fs::path test_db_file_path = test_db_path / kernel_db_file;
-    fs::path test_cubin_path = test_db_path / kernel_db_cubin;
-    fs::path test_kernel_path = test_db_path / kernel_db_kernel;
+    const std::string kernel_db_file("index.bin");
+    const std::string test_text("blahblahblah");
+    const std::vector<char> test_cubin(test_text.begin(), test_text.end());
 
-    copy_to_text_file(test_db_file_path, header);
-    const std::string db_line = test_text + "," + test_text + "," +
-        kernel_db_kernel + "," + kernel_db_cubin;
-    ASSERT_TRUE(append_to_text_file(test_db_file_path, db_line));
-    ASSERT_TRUE(copy_to_text_file(test_cubin_path, test_text));
-    ASSERT_TRUE(copy_to_text_file(test_kernel_path, test_text));
+    {
+      auto& kernel_db =
+          KernelDb::get(kernel_db_dir, kernel_db_file, true, false, true);
+      ASSERT_TRUE(kernel_db.enabled());
+      ASSERT_TRUE(kernel_db.write(test_text, test_text, test_text, test_cubin));
+    }
 
-    // Open Db
-    auto& kernel_db = KernelDb::get(kernel_db_dir, kernel_db_file, true, false);
+    // Reset the singleton to restore the DB from disk
+    auto& kernel_db =
+        KernelDb::get(kernel_db_dir, kernel_db_file, true, false, true);
 
     ASSERT_TRUE(kernel_db.enabled());
+    ASSERT_TRUE(kernel_db.size() == 1);
 
     // Cleanup DB Directory
     if (fs::is_directory(test_db_path)) {
@@ -0,0 +1,136 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <gmock/gmock-matchers.h>
+#include <gtest/gtest.h>
+
+#include <torch/torch.h>
+
+#include <kernel_db/perf_db.h>
+#include <ops/all_ops.h>
+#include <options.h>
+#include <runtime/fusion_executor_cache.h>
+#include <tests/cpp/utils.h>
+#include <tests/cpp/validator.h>
+
+// RUN CMD: bin/test_jit --gtest_filter="NVFuserTest*KernelDb_Perf*"
+namespace nvfuser {
+
+namespace {
+
+KernelPerfRecord makeRecord(
+    uint64_t fusion_hash,
+    int64_t registers,
+    double time_ms) {
+  KernelPerfRecord record;
+  record.fusion_hash = fusion_hash;
+  record.segment = 0;
+  record.gpu = "NVIDIA Test GPU (sm_90)";
+  record.inputs = "Float[1024, 1024]";
+  record.kernel_name = "nvfuser_pointwise_f0_c1_r0_g0";
+  record.scheduler = "pointwise";
+  record.heuristic_params = "\n===== Pointwise Parameters ========\n\tvec 4\n";
+  record.registers = registers;
+  record.time_ms = time_ms;
+  return record;
+}
+
+} // namespace
+
+TEST_F(NVFuserTest, KernelDb_PerfRegressions) {
+  fs::path db_path = fs::temp_directory_path() / "nvfuser_kernel_perf_db_test";
+  if (fs::is_directory(db_path)) {
+    fs::remove_all(db_path);
+  }
+
+  KernelPerfDb baseline(db_path.string(), "baseline");
+  KernelPerfDb candidate(db_path.string(), "candidate");
+  // Fusion 1 gets slower, fusion 2 uses more registers, fusion 3 is within
+  // the tolerance, and fusion 4 is only launched by the candidate
+  for (double time_ms : {1.0, 1.1, 10.0}) {
+    ASSERT_TRUE(baseline.record(makeRecord(1, 32, time_ms)));
+  }
+  ASSERT_TRUE(baseline.record(makeRecord(2, 32, 1.0)));
+  ASSERT_TRUE(baseline.record(makeRecord(3, 32, 1.0)));
+  for (double time_ms : {1.5, 1.6, 0.1}) {
+    ASSERT_TRUE(candidate.record(makeRecord(1, 32, time_ms)));
+  }
+  ASSERT_TRUE(candidate.record(makeRecord(2, 40, 1.0)));
+  ASSERT_TRUE(candidate.record(makeRecord(3, 32, 1.02)));
+  ASSERT_TRUE(candidate.record(makeRecord(4, 64, 5.0)));
+
+  // Separators in the fields don't break the records
+  auto records = baseline.load("baseline");
+  ASSERT_EQ(records.size(), 5);
+  EXPECT_EQ(
+      records.front().heuristic_params,
+      "===== Pointwise Parameters ======== vec 4");
+  EXPECT_EQ(records.front().fusion_hash, 1);
+  EXPECT_EQ(records.front().registers, 32);
+
+  auto regressions = baseline.findRegressions("baseline", "candidate");
+  ASSERT_EQ(regressions.size(), 2);
+  // Medians are compared, so the outliers of fusion 1 don't matter
+  EXPECT_EQ(regressions.at(0).candidate.fusion_hash, 1);
+  EXPECT_TRUE(regressions.at(0).time_regressed);
+  EXPECT_FALSE(regressions.at(0).registers_regressed);
+  EXPECT_DOUBLE_EQ(regressions.at(0).baseline.time_ms, 1.1);
+  EXPECT_DOUBLE_EQ(regressions.at(0).candidate.time_ms, 1.5);
+  EXPECT_EQ(regressions.at(1).candidate.fusion_hash, 2);
+  EXPECT_FALSE(regressions.at(1).time_regressed);
+  EXPECT_TRUE(regressions.at(1).registers_regressed);
+  EXPECT_THAT(
+      regressions.at(1).toString(), ::testing::HasSubstr("registers 32 -> 40"));
+
+  // Looser tolerances accept both
+  EXPECT_TRUE(
+      baseline.findRegressions("baseline", "candidate", 0.5, 8).empty());
+
+  fs::remove_all(db_path);
+}
+
+TEST_F(NVFuserTest, KernelDb_PerfRecord_CUDA) {
+  fs::path db_path =
+      fs::temp_directory_path() / "nvfuser_kernel_perf_db_record_test";
+  if (fs::is_directory(db_path)) {
+    fs::remove_all(db_path);
+  }
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::KernelPerfDb, {db_path.string(), "test_run"});
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  TensorView* tv1 = sin(tv0);
+  fusion->addOutput(tv1);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 256}, options);
+  for ([[maybe_unused]] auto i : c10::irange(2)) {
+    auto outputs = executor_cache.runFusionWithInputs({t0});
+    testValidate(
+        executor_cache.fusion(), outputs, {t0}, {t0.sin()}, __LINE__, __FILE__);
+  }
+
+  const auto& perf_db = KernelPerfDb::get();
+  EXPECT_EQ(perf_db.directory(), db_path);
+  auto records = perf_db.load("test_run");
+  ASSERT_EQ(records.size(), 2);
+  EXPECT_TRUE(records.at(0).sameKey(records.at(1)));
+  EXPECT_EQ(records.at(0).scheduler, "pointwise");
+  EXPECT_EQ(records.at(0).inputs, "Float[128, 256]");
+  EXPECT_GT(records.at(0).registers, 0);
+  EXPECT_GT(records.at(0).time_ms, 0.0);
+  EXPECT_FALSE(records.at(0).heuristic_params.empty());
+
+  fs::remove_all(db_path);
+}
+
+} // namespace nvfuser
@@ -20,14 +20,31 @@
 namespace nvfuser {
 
 TEST_F(NVFuserTest, KernelDb_Query_CUDA) {
-  // Setup the test db
-  fs::path test_db =
+  // Setup the test db from the checked-in kernel and cubin
+  fs::path test_data =
       fs::path(__FILE__).parent_path() / "test_data/kernel_db_for_query_test";
-  ASSERT_TRUE(fs::is_directory(test_db));
-  const std::string test_db_file_name("db.csv");
-  fs::path test_db_file = test_db / test_db_file_name;
-  ASSERT_TRUE(fs::is_regular_file(test_db_file));
+  ASSERT_TRUE(fs::is_directory(test_data));
+  fs::path test_db = fs::temp_directory_path() / "nvfuser_kernel_db_query_test";
+  if (fs::is_directory(test_db)) {
+    fs::remove_all(test_db);
+  }
+  const std::string test_db_file_name("index.bin");
+  const std::string compiler_args(
+      "--std=c++14 --gpu-architecture=sm_80 -default-device --fmad=true -DNDEBUG --ptxas-options --maxrregcount=255");
+  const std::string kernel_signature(
+      "_ZN76_GLOBAL__N__00000000_37___tmp_kernel_pointwise_f0_c1_r0_g0_cu_8995cef2_3255329nvfuser_pointwise_f0_c1_r0_g0ENS_6TensorIfLi2ELi2EEES1_S1_");
+  {
+    std::string code;
+    std::vector<char> cubin;
+    ASSERT_TRUE(copy_from_text_file(test_data / "kernel_0.cu", code));
+    ASSERT_TRUE(copy_from_binary_file(test_data / "kernel_0.cubin", cubin));
+    auto& kernel_db =
+        KernelDb::get(test_db.string(), test_db_file_name, false, false, true);
+    ASSERT_TRUE(kernel_db.enabled());
+    ASSERT_TRUE(kernel_db.write(code, compiler_args, kernel_signature, cubin));
+  }
 
+  // Reopen the db as another process would
   auto& kernel_db =
       KernelDb::get(test_db.string(), test_db_file_name, false, false, true);
   ASSERT_TRUE(kernel_db.enabled());
@@ -48,7 +65,7 @@ TEST_F(NVFuserTest, KernelDb_Query_CUDA) {
 
   // Check a query with a good code string and bad compiler args
   try {
-    fs::path code_path = test_db / "kernel_0.cu";
+    fs::path code_path = test_data / "kernel_0.cu";
     std::string code;
     ASSERT_TRUE(copy_from_text_file(code_path, code));
     const std::string bad_text("blahblahblah");
@@ -64,20 +81,24 @@ TEST_F(NVFuserTest, KernelDb_Query_CUDA) {
 
   // Check a successful query
   try {
-    fs::path code_path = test_db / "kernel_0.cu";
+    fs::path code_path = test_data / "kernel_0.cu";
     std::string code;
     ASSERT_TRUE(copy_from_text_file(code_path, code));
-    const std::string compiler_args(
-        "--std=c++14 --gpu-architecture=sm_80 -default-device --fmad=true -DNDEBUG --ptxas-options --maxrregcount=255");
     std::string dummy_name;
     std::vector<char> dummy_cubin(0);
 
     ASSERT_TRUE(kernel_db.query(code, compiler_args, dummy_name, dummy_cubin));
+    ASSERT_EQ(dummy_name, kernel_signature);
     SUCCEED();
   } catch (const std::exception& e) {
     FAIL() << "Unexpected failure while querying db for existing entry!"
            << e.what();
   }
+
+  // Cleanup DB Directory
+  if (fs::is_directory(test_db)) {
+    fs::remove_all(test_db);
+  }
 }
 
 } // namespace nvfuser
@@ -29,7 +29,7 @@ TEST_F(NVFuserTest, KernelDb_Write_CUDA) {
   ASSERT_TRUE(fs::is_regular_file(test_data_kernel));
 
   const std::string kernel_db_dir("nvfuser_kernel_db_write_test");
-  const std::string kernel_db_file("db.csv");
+  const std::string kernel_db_file("index.bin");
   fs::path test_db_path = fs::temp_directory_path() / kernel_db_dir;
   if (fs::is_directory(test_db_path)) {
     fs::remove_all(test_db_path);
@@ -74,4 +74,26 @@ TEST_F(NVFuserTest, KernelDb_Write_CUDA) {
   }
 }
 
+TEST_F(NVFuserTest, KernelDb_CompressBlob_CUDA) {
+  fs::path test_data_cubin = fs::path(__FILE__).parent_path() /
+      "test_data/kernel_db_for_query_test/kernel_0.cubin";
+  std::vector<char> cubin;
+  ASSERT_TRUE(copy_from_binary_file(test_data_cubin.string(), cubin));
+
+  // Uncompressed blobs are read as is
+  std::vector<char> blob = cubin;
+  EXPECT_TRUE(decompress_blob(blob));
+  EXPECT_EQ(blob, cubin);
+
+  if (!is_blob_compression_available()) {
+    GTEST_SKIP() << "nvFuser is built without NVFUSER_BUILD_WITH_ZSTD";
+  }
+  std::vector<char> compressed = compress_blob(cubin);
+  EXPECT_LT(compressed.size(), cubin.size());
+  // Compressing twice is a no-op
+  EXPECT_EQ(compress_blob(compressed), compressed);
+  EXPECT_TRUE(decompress_blob(compressed));
+  EXPECT_EQ(compressed, cubin);
+}
+
 } // namespace nvfuser
@@ -18,6 +18,7 @@
 #include <ops/alias.h>
 #include <ops/arith.h>
 #include <preseg_passes/segment_inplace_update.h>
+#include <runtime/allocations.h>
 #include <sys_utils.h>
 #include <tests/cpp/utils.h>
 #include <tests/cpp/validator.h>
@@ -1201,6 +1202,72 @@ TEST_F(AliasTest, KernelExecutor) {
   EXPECT_EQ(out_tensor.data_ptr(), in_tensor.data_ptr());
 }
 
+// ExprEvalExecutor replays the views it computed for the same input sizes and
+// strides with as_strided
+TEST_F(AliasTest, ExprEvalExecutorReplaysViews) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* in = makeContigTensor(2);
+  TensorView* out = permute(in, {1, 0});
+  out = slice(out, {{fusion.oneVal(), out->axis(0)->extent()}, Slice()});
+  fusion.addInput(in);
+  fusion.addOutput(out);
+  fusion.aliasOutputToInput(out, in, AllocationType::Evaluate);
+
+  ExprEvalExecutor ee;
+  ee.compile(&fusion);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto run = [&](const at::Tensor& in_tensor) {
+    auto args = KernelArgumentHolder::createKernelArgumentHolder({in_tensor});
+    at::Tensor out_tensor = ee.run(args)[0];
+    EXPECT_TRUE(out_tensor.is_alias_of(in_tensor));
+    EXPECT_TRUE(at::equal(out_tensor, in_tensor.t().slice(0, 1)));
+  };
+
+  run(at::randn({4, 6}, options));
+  EXPECT_EQ(ee.numReplayedViews(), 0);
+  run(at::randn({4, 6}, options));
+  EXPECT_EQ(ee.numReplayedViews(), 2);
+  // A storage offset doesn't change the signature
+  run(at::randn({5, 6}, options).slice(0, 1));
+  EXPECT_EQ(ee.numReplayedViews(), 2);
+  // New sizes are evaluated and recorded again
+  run(at::randn({3, 6}, options));
+  EXPECT_EQ(ee.numReplayedViews(), 0);
+}
+
+// Launches allocate the outputs from the cached buffer infos only when no
+// output is an alias or a duplicate
+TEST_F(AliasTest, OutputsAreNewBuffers) {
+  {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+    TensorView* in = makeContigTensor(2);
+    TensorView* out = sin(in);
+    fusion.addInput(in);
+    fusion.addOutput(out);
+    EXPECT_TRUE(outputsAreNewBuffers(&fusion));
+
+    TensorView* alias_out = permute(in, {1, 0});
+    fusion.addOutput(alias_out);
+    fusion.aliasOutputToInput(alias_out, in, AllocationType::Evaluate);
+    EXPECT_FALSE(outputsAreNewBuffers(&fusion));
+  }
+
+  {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+    TensorView* in = makeContigTensor(2);
+    TensorView* out = sin(in);
+    fusion.addInput(in);
+    fusion.addOutput(out);
+    fusion.addOutput(out);
+    EXPECT_FALSE(outputsAreNewBuffers(&fusion));
+  }
+}
+
 TEST_F(AliasTest, InplaceUpdate) {
   auto fusion = std::make_unique<Fusion>();
   FusionGuard fg(fusion.get());
@@ -1591,4 +1658,108 @@ TEST_F(AliasTest, ReshapeInplaceUpdateNoSegmentation) {
       __FILE__);
 }
 
+TEST_F(AliasTest, InplaceUpdateOfSliceAtDynamicOffset) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  // A decoding step appending its keys to a KV cache of shape [b, h, s, e]
+  constexpr int64_t b = 2, h = 4, s = 16, e = 32;
+  TensorView* cache = makeContigConcreteTensor({b, h, s, e});
+  TensorView* k = makeContigConcreteTensor({b, h, 1, e});
+  Val* position = IrBuilder::create<Val>(DataType::Int);
+  fusion->addInput(cache);
+  fusion->addInput(k);
+  fusion->addInput(position);
+  TensorView* new_k = add(mul(k, IrBuilder::create<Val>(2.0)), k);
+  fusion->addOutput(new_k);
+  fusion->aliasOutputToInputSlice(new_k, cache, 2, position);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto options = at::dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor cache_tensor = at::randn({b, h, s, e}, options);
+  at::Tensor k_tensor = at::randn({b, h, 1, e}, options);
+  for (int64_t t : {3, 4}) {
+    at::Tensor original_cache = cache_tensor.clone();
+    std::vector<at::Tensor> out_tensors =
+        executor_cache.runFusionWithInputs({cache_tensor, k_tensor, t});
+    ASSERT_EQ(out_tensors.size(), 1);
+
+    EXPECT_TRUE(out_tensors[0].is_alias_of(cache_tensor));
+    EXPECT_TRUE(
+        cache_tensor.slice(2, t, t + 1).allclose(k_tensor * 2 + k_tensor));
+    EXPECT_TRUE(
+        cache_tensor.slice(2, 0, t).equal(original_cache.slice(2, 0, t)));
+    EXPECT_TRUE(
+        cache_tensor.slice(2, t + 1).equal(original_cache.slice(2, t + 1)));
+    EXPECT_FALSE(executor_cache.getMostRecentKernelRuntime()->isSegmented());
+  }
+}
+
+// The producers of `cat` are separate segments, so with zero_copy_cat they
+// write directly into the slices of its output
+TEST_F(AliasTest, ZeroCopyCat) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::ZeroCopyCat);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* in0 = makeContigTensor(2);
+  TensorView* in1 = makeContigTensor(2);
+  fusion->addInput(in0);
+  fusion->addInput(in1);
+  TensorView* a = segment_set(sin(in0));
+  TensorView* b = segment_set(cos(in1));
+  TensorView* out = cat({a, b}, /*dim=*/0);
+  fusion->addOutput(out);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto options = at::dtype(at::kFloat).device(at::kCUDA, 0);
+  for (int64_t rows : {64, 128}) {
+    at::Tensor in0_tensor = at::randn({rows, 32}, options);
+    at::Tensor in1_tensor = at::randn({rows * 2, 32}, options);
+    std::vector<at::Tensor> out_tensors =
+        executor_cache.runFusionWithInputs({in0_tensor, in1_tensor});
+    testValidate(
+        executor_cache.fusion(),
+        out_tensors,
+        {in0_tensor, in1_tensor},
+        __LINE__,
+        __FILE__);
+  }
+  EXPECT_TRUE(executor_cache.getMostRecentKernelRuntime()->isSegmented());
+}
+
+// Slices of the inner dimension aren't dense, so the concatenation runs as
+// usual
+TEST_F(AliasTest, ZeroCopyCat_InnerDimension) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::ZeroCopyCat);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* in0 = makeContigTensor(2);
+  TensorView* in1 = makeContigTensor(2);
+  fusion->addInput(in0);
+  fusion->addInput(in1);
+  TensorView* a = segment_set(sin(in0));
+  TensorView* b = segment_set(cos(in1));
+  TensorView* out = cat({a, b}, /*dim=*/1);
+  fusion->addOutput(out);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto options = at::dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor in0_tensor = at::randn({64, 32}, options);
+  at::Tensor in1_tensor = at::randn({64, 16}, options);
+  std::vector<at::Tensor> out_tensors =
+      executor_cache.runFusionWithInputs({in0_tensor, in1_tensor});
+  testValidate(
+      executor_cache.fusion(),
+      out_tensors,
+      {in0_tensor, in1_tensor},
+      __LINE__,
+      __FILE__);
+}
+
 } // namespace nvfuser
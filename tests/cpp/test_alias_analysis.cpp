@@ -100,6 +100,49 @@ TEST_F(AliasAnalysisTest, View_MergeNonContiguous) {
   EXPECT_EQ(analysis.getRoot(out), nullptr);
 }
 
+TEST_F(AliasAnalysisTest, View_MergeAcrossBroadcast) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  const std::vector<int64_t> in_shape({2, 3, 1});
+  const std::vector<int64_t> out_shape({6, 1});
+
+  TensorView* in = makeContigConcreteTensor(in_shape);
+  fusion.addInput(in);
+  TensorView* out = reshape(in, in_shape, out_shape);
+  fusion.addOutput(out);
+
+  // The broadcast sits between the merged IterDomains in allocation order.
+  in->setAllocationDomain({in->axis(0), in->axis(2), in->axis(1)}, true);
+
+  AliasAnalysisResult analysis = findAliases(&fusion);
+  EXPECT_EQ(analysis.getRoot(out), in);
+  EXPECT_EQ(analysis.copyReason(out), "");
+}
+
+TEST_F(AliasAnalysisTest, View_CopyReason) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  const std::vector<int64_t> in_shape({2, 3, 4});
+  const std::vector<int64_t> out_shape({6, 4});
+
+  TensorView* in = makeContigConcreteTensor(in_shape);
+  fusion.addInput(in);
+  TensorView* out = reshape(in, in_shape, out_shape);
+  fusion.addOutput(out);
+
+  in->setAllocationDomain({in->axis(1), in->axis(0), in->axis(2)}, true);
+
+  AliasAnalysisResult analysis = findAliases(&fusion);
+  EXPECT_EQ(analysis.getRoot(out), nullptr);
+  EXPECT_THAT(
+      analysis.copyReason(out),
+      testing::HasSubstr("not adjacent in allocation order"));
+  EXPECT_THAT(
+      analysis.toString(), testing::HasSubstr("Reshapes that need a copy"));
+}
+
 TEST_F(AliasAnalysisTest, Set) {
   Fusion fusion;
   FusionGuard fg(&fusion);
@@ -139,6 +139,32 @@ TEST_F(AllocationOrderInferenceTest, BinaryOpPropagationTwoTV) {
   EXPECT_THAT(getAllocationOrder(tv3), ElementsAre(1, 0, 2, 3));
 }
 
+TEST_F(AllocationOrderInferenceTest, BinaryOpPropagationAmbiguousRefs) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(4);
+  fusion.addInput(tv0);
+  auto tv1 = makeSymbolicTensor(4);
+  fusion.addInput(tv1);
+  auto tv2 = relu(tv0);
+  fusion.addOutput(tv2);
+  // tv0 and tv1 disagree on the layout of tv3. Writing tv3 in the layout of
+  // tv0 also keeps it consistent with tv2, so fewer accesses are transposed.
+  auto tv3 = add(tv0, tv1);
+  fusion.addOutput(tv3);
+
+  std::vector<IterDomain*> tv0_nhwc = {
+      tv0->axis(0), tv0->axis(2), tv0->axis(3), tv0->axis(1)};
+  tv0->setAllocationDomain(tv0_nhwc, true);
+
+  preseg_passes::OptimizationPass<preseg_passes::AllocationDomainPass>::runPass(
+      &fusion);
+  EXPECT_THAT(getAllocationOrder(tv2), ElementsAre(0, 2, 3, 1));
+  EXPECT_THAT(getAllocationOrder(tv3), ElementsAre(0, 2, 3, 1));
+}
+
 TEST_F(AllocationOrderInferenceTest, BinaryOpPropagationWithBroadcast) {
   auto fusion_ptr = std::make_unique<Fusion>();
   Fusion& fusion = *fusion_ptr.get();
@@ -929,6 +929,47 @@ TEST_F(CombinedSchedulerTest, InnerOuterNoOuterBroadcastTv) {
       persistent_params->lparams);
 }
 
+// The row and column sums need no persistent buffer, but are still computed
+// in one kernel reading the input once
+TEST_F(CombinedSchedulerTest, InnerOuterNoPersistentBuffer) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::CombinedInnerOuterReduction);
+
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  const int dim0 = 1024, dim1 = 2048;
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  auto tv2 = sum(tv0, {0});
+  fusion.addOutput(tv1);
+  fusion.addOutput(tv2);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({dim0, dim1}, options);
+  std::vector<c10::IValue> aten_inputs = {t0};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_FALSE(runtime->isSegmented());
+  EXPECT_EQ(
+      runtime->schedulerHeuristics()->heuristicsList().at(0)->scheduler_type,
+      SchedulerType::InnerOuterPersistent);
+
+  testValidate(
+      executor_cache.fusion(),
+      cg_outputs,
+      aten_inputs,
+      {t0.sum({1}), t0.sum({0})},
+      __LINE__,
+      __FILE__);
+}
+
 // Reproduce error found in:
 // thunder/tests/test_torch_compile_executor.py::test_torch_compile_cat_nvfuser_phi2_tanh
 // Only happens when shared memory persistent is used.
@@ -997,6 +1038,40 @@ TEST_F(CombinedSchedulerTest, SharedMemoryPersistentVectFactor) {
   testValidate(&fusion_copy, cg_outputs, aten_inputs, __LINE__, __FILE__);
 }
 
+// Persistent buffers are split between registers and shared memory using
+// their combined capacity, not only by moving a prefix of them to registers
+TEST_F(CombinedSchedulerTest, SelectRegisterPersistentBuffers) {
+  using normalization_scheduler_utils::selectRegisterPersistentBuffers;
+  constexpr int64_t kB = 1024;
+
+  // Moving the first buffer is enough
+  auto in_regs = selectRegisterPersistentBuffers(
+      {{16 * kB, 16 * kB}, {64 * kB, 64 * kB}},
+      150 * kB,
+      200 * kB,
+      64 * kB);
+  ASSERT_TRUE(in_regs.has_value());
+  EXPECT_EQ(in_regs.value(), std::vector<bool>({true, false}));
+
+  // The first buffer doesn't fit in registers, but the second one does and
+  // frees enough shared memory
+  in_regs = selectRegisterPersistentBuffers(
+      {{64 * kB, 64 * kB}, {16 * kB, 16 * kB}},
+      150 * kB,
+      200 * kB,
+      64 * kB);
+  ASSERT_TRUE(in_regs.has_value());
+  EXPECT_EQ(in_regs.value(), std::vector<bool>({false, true}));
+
+  // Not enough room in either
+  EXPECT_FALSE(selectRegisterPersistentBuffers(
+                   {{64 * kB, 64 * kB}, {16 * kB, 16 * kB}},
+                   150 * kB,
+                   200 * kB,
+                   32 * kB)
+                   .has_value());
+}
+
 using InnerOuterReshapeTest = NVFuserFixtureParamTest<bool>;
 INSTANTIATE_TEST_SUITE_P(
     ,
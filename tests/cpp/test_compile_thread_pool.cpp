@@ -0,0 +1,121 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <gtest/gtest.h>
+
+#include <runtime/compile_thread_pool.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+namespace nvfuser {
+
+namespace {
+
+// Occupies every worker of the pool until release() is called
+class BusyPool {
+ public:
+  BusyPool() {
+    for (int64_t i = 0; i < maxCompileThreads(); ++i) {
+      tasks_.run([this]() {
+        ++num_started_;
+        while (!released_.load()) {
+          std::this_thread::yield();
+        }
+      });
+    }
+  }
+
+  ~BusyPool() {
+    release();
+  }
+
+  void release() {
+    released_.store(true);
+    tasks_.wait();
+  }
+
+  int64_t numStarted() const {
+    return num_started_.load();
+  }
+
+ private:
+  std::atomic<bool> released_{false};
+  std::atomic<int64_t> num_started_{0};
+  CompileTaskGroup tasks_{CompilePriority::Speculative};
+};
+
+} // namespace
+
+TEST(CompileThreadPoolTest, RunAll) {
+  std::atomic<int64_t> num_done{0};
+  CompileTaskGroup tasks;
+  for (int64_t i = 0; i < 100; ++i) {
+    tasks.run([&num_done]() { ++num_done; });
+  }
+  tasks.wait();
+  EXPECT_EQ(num_done.load(), 100);
+}
+
+// A group doesn't wait for the tasks of other groups, even when they occupy
+// every worker
+TEST(CompileThreadPoolTest, WaitForOwnTasks) {
+  BusyPool busy_pool;
+
+  std::atomic<int64_t> num_done{0};
+  CompileTaskGroup tasks(CompilePriority::Blocking);
+  tasks.run([&num_done]() { ++num_done; });
+  tasks.wait();
+  EXPECT_EQ(num_done.load(), 1);
+}
+
+TEST(CompileThreadPoolTest, Cancel) {
+  BusyPool busy_pool;
+  while (busy_pool.numStarted() < maxCompileThreads()) {
+    std::this_thread::yield();
+  }
+
+  std::atomic<int64_t> num_done{0};
+  CompileTaskGroup tasks;
+  for (int64_t i = 0; i < 10; ++i) {
+    tasks.run([&num_done]() { ++num_done; });
+  }
+  tasks.cancel();
+  busy_pool.release();
+  tasks.wait();
+  EXPECT_EQ(num_done.load(), 0);
+}
+
+// Groups created by a task default to the priority of the task
+TEST(CompileThreadPoolTest, InheritPriority) {
+  EXPECT_EQ(CompileTaskGroup::currentPriority(), CompilePriority::Blocking);
+
+  std::atomic<CompilePriority> nested_priority{CompilePriority::Blocking};
+  std::atomic<bool> done{false};
+  CompileTaskGroup tasks(CompilePriority::Speculative);
+  tasks.run([&nested_priority, &done]() {
+    CompileTaskGroup nested_tasks;
+    nested_priority.store(nested_tasks.priority());
+    done.store(true);
+  });
+  // A waiter runs the task at its own, more urgent priority, so let a worker
+  // pick it up first
+  while (!done.load()) {
+    std::this_thread::yield();
+  }
+  tasks.wait();
+  EXPECT_EQ(nested_priority.load(), CompilePriority::Speculative);
+}
+
+TEST(CompileThreadPoolTest, RethrowError) {
+  CompileTaskGroup tasks;
+  tasks.run([]() { throw std::runtime_error("compilation failed"); });
+  EXPECT_THROW(tasks.wait(), std::runtime_error);
+}
+
+} // namespace nvfuser
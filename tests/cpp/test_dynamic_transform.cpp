@@ -1381,4 +1381,53 @@ TEST_F(NVFuserTest, DynamicSqueezeTrivialWelford) {
   testValidate(fusion, outputs, inputs, __LINE__, __FILE__);
 }
 
+// Inputs that only differ in values not affecting concretization, here the
+// alignment of a tensor and a double scalar, have the same fingerprint
+TEST_F(NVFuserTest, DynamicTransformFingerprint) {
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  Fusion* fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto reshape_shape0 = IrBuilder::create<Val>(DataType::Int);
+  fusion->addInput(reshape_shape0);
+  auto reshape_shape1 = IrBuilder::create<Val>(DataType::Int);
+  fusion->addInput(reshape_shape1);
+  auto scale = IrBuilder::create<Val>(DataType::Double);
+  fusion->addInput(scale);
+
+  auto tv1 = reshape(tv0, {reshape_shape0, reshape_shape1});
+  auto tv2 = mul(tv1, scale);
+  fusion->addOutput(tv2);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({4, 3}, options);
+  // Same sizes, but not aligned to 16 bytes
+  at::Tensor t0_misaligned =
+      at::randn({13}, options).narrow(0, 1, 12).view({4, 3});
+  std::vector<c10::IValue> inputs = {t0, 3L, 4L, 2.0};
+  std::vector<c10::IValue> misaligned_inputs = {t0_misaligned, 3L, 4L, 3.0};
+  std::vector<c10::IValue> reshaped_inputs = {t0, 2L, 6L, 2.0};
+
+  auto initial_info = DynamicTransform::getInitialInfo(fusion);
+  auto fingerprint = [&initial_info](
+                         const std::vector<c10::IValue>& test_inputs) {
+    auto args = KernelArgumentHolder::createKernelArgumentHolder(test_inputs);
+    auto values = initial_info.fingerprint(args);
+    NVF_CHECK(values.has_value());
+    return values.value();
+  };
+  EXPECT_EQ(fingerprint(inputs), fingerprint(misaligned_inputs));
+  EXPECT_NE(fingerprint(inputs), fingerprint(reshaped_inputs));
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  for (const auto& inputs_to_run :
+       {inputs, misaligned_inputs, reshaped_inputs}) {
+    auto outputs = executor_cache.runFusionWithInputs(inputs_to_run);
+    testValidate(fusion, outputs, inputs_to_run, __LINE__, __FILE__);
+  }
+  EXPECT_EQ(executor_cache.countConcretizations(), 2);
+}
+
 } // namespace nvfuser
@@ -0,0 +1,103 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <gtest/gtest.h>
+
+#include <fusion.h>
+#include <ops/all_ops.h>
+#include <runtime/fusion_executor_cache.h>
+#include <runtime/fusion_kernel_runtime.h>
+#include <tests/cpp/utils.h>
+
+namespace nvfuser {
+
+using EmbeddingBwdTest = NVFuserTest;
+
+// Most tokens hit a handful of rows, as with a Zipfian vocabulary. The result
+// matches index_add and is bitwise identical across runs.
+TEST_F(EmbeddingBwdTest, SkewedIndices) {
+  constexpr int64_t num_weights = 1000;
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* grad = makeContigTensor(3);
+  TensorView* indices = makeContigTensor(2, DataType::Int);
+  fusion->addInput(grad);
+  fusion->addInput(indices);
+  TensorView* grad_weight = embedding_bwd(
+      grad, indices, IrBuilder::create<Val>(num_weights, DataType::Int));
+  fusion->addOutput(grad_weight);
+
+  EXPECT_TRUE(grad_weight->definition()->isA<EmbeddingBwdOp>());
+  EXPECT_EQ(grad_weight->nDims(), 2);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t_grad = at::randn({8, 512, 64}, options);
+  at::Tensor t_indices = at::where(
+      at::rand({8, 512}, options) < 0.9,
+      at::randint(0, 4, {8, 512}, options.dtype(at::kLong)),
+      at::randint(0, num_weights, {8, 512}, options.dtype(at::kLong)));
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t_grad, t_indices});
+  auto rerun = executor_cache.runFusionWithInputs({t_grad, t_indices});
+
+  at::Tensor expected = at::zeros({num_weights, 64}, options)
+                            .index_add_(
+                                0,
+                                t_indices.flatten(),
+                                t_grad.view({-1, 64}).to(at::kDouble))
+                            .to(at::kFloat);
+  EXPECT_TRUE(at::allclose(outputs[0], expected, 1e-3, 1e-3));
+  EXPECT_TRUE(at::equal(outputs[0], rerun[0]));
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_EQ(runtime->fusionSegments()->groups().size(), 1);
+}
+
+// The producer of the gradient is still scheduled as a kernel, and padding
+// rows receive no gradient
+TEST_F(EmbeddingBwdTest, PaddingIdx) {
+  constexpr int64_t num_weights = 16;
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* tv0 = makeContigTensor(2);
+  TensorView* indices = makeContigTensor(1, DataType::Int);
+  fusion->addInput(tv0);
+  fusion->addInput(indices);
+  TensorView* tv1 = mul(tv0, IrBuilder::create<Val>(2.0));
+  TensorView* tv2 = embedding_bwd(
+      tv1,
+      indices,
+      IrBuilder::create<Val>(num_weights, DataType::Int),
+      /*padding_idx=*/0,
+      /*scale_grad_by_freq=*/true);
+  fusion->addOutput(tv2);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 32}, options);
+  at::Tensor t_indices =
+      at::randint(0, num_weights, {128}, options.dtype(at::kLong));
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0, t_indices});
+
+  at::Tensor expected = at::embedding_dense_backward(
+      t0 * 2.0,
+      t_indices,
+      num_weights,
+      /*padding_idx=*/0,
+      /*scale_grad_by_freq=*/true);
+  EXPECT_TRUE(at::allclose(outputs[0], expected, 1e-4, 1e-4));
+  EXPECT_TRUE(outputs[0][0].eq(0).all().item<bool>());
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_EQ(runtime->fusionSegments()->groups().size(), 2);
+}
+
+} // namespace nvfuser
@@ -15,6 +15,7 @@
 #include <expr_evaluator.h>
 #include <fusion.h>
 #include <ops/all_ops.h>
+#include <runtime/executor.h>
 
 namespace nvfuser {
 
@@ -814,4 +815,134 @@ TEST_F(ExprEvalTest, TensorMetadataPrecomputedValues) {
   checkIntValue(evaluator, logical_size_1, 4);
 }
 
+// Extents computed from tensor metadata are evaluated by the value machine of
+// PrecomputedValues, without falling back to an ExpressionEvaluator
+TEST_F(ExprEvalTest, PrecomputedValuesGetItemGetAttr) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto* tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+
+  Val* metadata = fusion.metadataOf(tv0);
+  Val* logical_size = IrBuilder::getAttrExpr(metadata, "logical_size");
+  Val* size0 = IrBuilder::getItemExpr(logical_size, fusion.zeroVal());
+  Val* size1 = IrBuilder::getItemExpr(logical_size, fusion.oneVal());
+  Val* extent0 = ceilDiv(size0, IrBuilder::create<Val>(2L));
+  Val* extent1 = max(
+      add(neg(size1), IrBuilder::create<Val>(10L)),
+      IrBuilder::create<Val>(5L));
+  auto* tv1 = full(
+      {extent0, extent1},
+      IrBuilder::create<Val>(1.0),
+      DataType::Float,
+      /*maybe_symbolic=*/false);
+  fusion.addOutput(tv1);
+
+  PrecomputedValues pv(&fusion);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({3, 4}, options);
+  auto args = KernelArgumentHolder::createKernelArgumentHolder({t0});
+  pv.bindInputs(args);
+  pv.evaluate();
+
+  const PolymorphicValue& value0 = pv.getMaybeValueFor(tv1->axis(0)->extent());
+  const PolymorphicValue& value1 = pv.getMaybeValueFor(tv1->axis(1)->extent());
+  ASSERT_TRUE(value0.is<int64_t>());
+  ASSERT_TRUE(value1.is<int64_t>());
+  EXPECT_EQ(value0.as<int64_t>(), 2);
+  EXPECT_EQ(value1.as<int64_t>(), 6);
+}
+
+// Rebinding inputs reuses the values computed from the inputs that didn't
+// change and recomputes the others
+TEST_F(ExprEvalTest, PrecomputedValuesRebind) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto* tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+
+  Val* extent0 = mul(tv0->axis(0)->extent(), IrBuilder::create<Val>(2L));
+  Val* extent1 = add(tv0->axis(1)->extent(), fusion.oneVal());
+  auto* tv1 = full(
+      {extent0, extent1},
+      IrBuilder::create<Val>(1.0),
+      DataType::Float,
+      /*maybe_symbolic=*/false);
+  fusion.addOutput(tv1);
+
+  PrecomputedValues pv(&fusion);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto check = [&](at::IntArrayRef sizes) {
+    auto args = KernelArgumentHolder::createKernelArgumentHolder(
+        {at::randn(sizes, options)});
+    pv.bindInputs(args);
+    pv.evaluate();
+    EXPECT_EQ(
+        pv.getMaybeValueFor(tv1->axis(0)->extent()).as<int64_t>(),
+        sizes[0] * 2);
+    EXPECT_EQ(
+        pv.getMaybeValueFor(tv1->axis(1)->extent()).as<int64_t>(),
+        sizes[1] + 1);
+  };
+
+  check({3, 4});
+  // Only the batch size changes
+  check({5, 4});
+  check({5, 4});
+  check({5, 7});
+}
+
+// The extents of the parallel types and the addresses of shared memory
+// buffers, which the launch parameters are computed from, are evaluated by
+// the value machine of PrecomputedValues
+TEST_F(ExprEvalTest, PrecomputedValuesLaunchParams) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto* tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto* tv1 = set(tv0);
+  auto* tv2 = set(tv1);
+  fusion.addOutput(tv2);
+
+  tv1->setMemoryType(MemoryType::Shared);
+  for (auto tv : {tv1, tv2}) {
+    tv->axis(0)->parallelize(ParallelType::BIDx);
+    tv->axis(1)->parallelize(ParallelType::TIDx);
+  }
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({3, 64}, options);
+  KernelExecutor ke;
+  ke.compile(&fusion, {t0});
+
+  kir::Kernel* kernel = ke.kernel();
+  PrecomputedValues pv(kernel);
+  pv.bindInputs(KernelArgumentHolder::createKernelArgumentHolder({t0}));
+  pv.evaluate();
+
+  const auto& parallel_extents =
+      kernel->summary().parallel_dimension_map.getMap();
+  ASSERT_EQ(parallel_extents.count(ParallelType::TIDx), 1);
+  EXPECT_EQ(
+      pv.getMaybeValueFor(parallel_extents.at(ParallelType::TIDx))
+          .as<int64_t>(),
+      64);
+  EXPECT_EQ(
+      pv.getMaybeValueFor(parallel_extents.at(ParallelType::BIDx))
+          .as<int64_t>(),
+      3);
+
+  const auto& smem_allocations = kernel->summary().dynamic_smem_allocations;
+  ASSERT_FALSE(smem_allocations.empty());
+  for (auto alloc : smem_allocations) {
+    ASSERT_NE(alloc->address(), nullptr);
+    EXPECT_TRUE(pv.getMaybeValueFor(alloc->address()).hasValue());
+  }
+}
+
 } // namespace nvfuser
@@ -1201,4 +1201,25 @@ TEST_F(ExprSimplifierTest, OrderTransitivity) {
 #undef EXPECT_VALUE_TRUE
 }
 
+// Structurally equal expressions are only simplified once while a cache is
+// active, and results are not shared across different assumptions
+TEST_F(ExprSimplifierTest, MemoizedSimplification) {
+  SimplifyExprCache cache;
+  SimplifyExprCacheGuard cache_guard(&cache);
+
+  auto first = simplifyExpr("( i1 + 0 ) * 1"_);
+  EXPECT_EQ(cache.numHits(), 0);
+  EXPECT_TRUE(first->sameAs("i1"_));
+
+  auto second = simplifyExpr("( i1 + 0 ) * 1"_);
+  EXPECT_EQ(cache.numHits(), 1);
+  EXPECT_EQ(first, second);
+
+  EXPECT_TRUE(simplifyExpr("i1 < i3"_, {}, {"i1 < i2 && i2 < i3"_})
+                  ->value()
+                  .as<bool>());
+  EXPECT_FALSE(simplifyExpr("i1 < i3"_)->value().hasValue());
+  EXPECT_EQ(cache.numHits(), 1);
+}
+
 } // namespace nvfuser
@@ -0,0 +1,946 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <gmock/gmock-matchers.h>
+#include <gtest/gtest.h>
+
+#include <cuda_utils.h>
+#include <fusion.h>
+#include <ops/all_ops.h>
+#include <options.h>
+#include <runtime/fusion_executor_cache.h>
+#include <runtime/fusion_kernel_runtime.h>
+#include <scheduler/autotune.h>
+#include <serde/fusion_cache_generated.h>
+#include <tests/cpp/utils.h>
+#include <tests/cpp/validator.h>
+
+#include <c10/cuda/CUDAGuard.h>
+#include <c10/cuda/CUDAStream.h>
+
+#include <string>
+#include <thread>
+
+namespace nvfuser {
+
+using FusionExecutorCacheTest = NVFuserTest;
+
+// The first run is served by ATen while the kernel is compiled in the
+// background. Later runs use the compiled kernel.
+TEST_F(FusionExecutorCacheTest, AsyncCompilation) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sin(tv0);
+  auto tv2 = sum(tv1, {1});
+  fusion->addOutput(tv2);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  executor_cache.enableAsyncCompilation();
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 1024}, options);
+
+  auto outputs = executor_cache.runFusionWithInputs({t0});
+  testValidate(executor_cache.fusion(), outputs, {t0}, __LINE__, __FILE__);
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  ASSERT_NE(runtime, nullptr);
+  runtime->waitForAsyncCompile();
+  EXPECT_FALSE(runtime->isCompiling());
+  EXPECT_FALSE(runtime->asyncCompileFailed());
+  EXPECT_TRUE(executor_cache.isCompiled({t0}));
+
+  outputs = executor_cache.runFusionWithInputs({t0});
+  testValidate(executor_cache.fusion(), outputs, {t0}, __LINE__, __FILE__);
+  EXPECT_EQ(executor_cache.getMostRecentKernelRuntime(), runtime);
+  EXPECT_EQ(executor_cache.countRuntimes(), 1);
+}
+
+// Fusions that cannot be evaluated by ATen, like those containing RNG ops,
+// wait for the background compilation instead.
+TEST_F(FusionExecutorCacheTest, AsyncCompilationWithoutFallback) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(1);
+  fusion->addInput(tv0);
+  auto tv1 = rand_like(tv0);
+  auto tv2 = add(tv0, tv1);
+  fusion->addOutput(tv2);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  executor_cache.enableAsyncCompilation();
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::zeros({4096}, options);
+
+  auto outputs = executor_cache.runFusionWithInputs({t0});
+  EXPECT_TRUE(executor_cache.isCompiled({t0}));
+  EXPECT_EQ(outputs.size(), 1);
+  EXPECT_TRUE(outputs[0].ge(0).all().item<bool>());
+  EXPECT_TRUE(outputs[0].lt(1).all().item<bool>());
+}
+
+// Sequence lengths in the same bucket share a single runtime and produce
+// correct results for their actual extents
+TEST_F(FusionExecutorCacheTest, ShapeBuckets) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = exp(tv0);
+  auto tv2 = sum(tv1, {1});
+  auto tv3 = add(tv0, IrBuilder::create<Val>(1.0));
+  fusion->addOutput(tv2);
+  fusion->addOutput(tv3);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  executor_cache.setShapeBucketPolicy(
+      ShapeBucketPolicy::powersOfTwo({{/*input_index=*/0, /*dim=*/0}}));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (int64_t seqlen : {260, 300, 420, 500}) {
+    at::Tensor t0 = at::randn({seqlen, 1024}, options);
+    auto outputs = executor_cache.runFusionWithInputs({t0});
+    testValidate(executor_cache.fusion(), outputs, {t0}, __LINE__, __FILE__);
+  }
+  EXPECT_EQ(executor_cache.countRuntimes(), 1);
+
+  at::Tensor t0 = at::randn({513, 1024}, options);
+  auto outputs = executor_cache.runFusionWithInputs({t0});
+  testValidate(executor_cache.fusion(), outputs, {t0}, __LINE__, __FILE__);
+}
+
+TEST_F(FusionExecutorCacheTest, ShapeBucketRepresentativeExtent) {
+  ShapeBucketPolicy policy({{0, 0, {8, 100, 1024}}});
+  const auto& dimension = policy.dimensions().front();
+
+  EXPECT_EQ(policy.bucketUpperBound(dimension, 1), std::nullopt);
+  EXPECT_EQ(policy.bucketUpperBound(dimension, 5), 8);
+  EXPECT_EQ(policy.bucketUpperBound(dimension, 100), 100);
+  EXPECT_EQ(policy.bucketUpperBound(dimension, 101), 1024);
+  EXPECT_EQ(policy.bucketUpperBound(dimension, 1025), std::nullopt);
+
+  // The representative keeps the power-of-two divisibility of the extent
+  EXPECT_EQ(ShapeBucketPolicy::representativeExtent(5, 8), 7);
+  EXPECT_EQ(ShapeBucketPolicy::representativeExtent(6, 8), 6);
+  EXPECT_EQ(ShapeBucketPolicy::representativeExtent(260, 512), 508);
+  EXPECT_EQ(ShapeBucketPolicy::representativeExtent(384, 512), 512);
+  EXPECT_EQ(ShapeBucketPolicy::representativeExtent(48, 100), 96);
+}
+
+// Kernels compiled ahead of time from input signatures are used by the first
+// run with matching inputs, and survive serialization.
+TEST_F(FusionExecutorCacheTest, AheadOfTimeCompilation) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(3);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {2});
+  auto tv2 = relu(tv0);
+  fusion->addOutput(tv1);
+  fusion->addOutput(tv2);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  const std::vector<std::pair<int64_t, int64_t>> shapes = {
+      {1, 128}, {8, 512}, {32, 2048}};
+  std::vector<InputSignature> signatures;
+  for (auto [batch, seqlen] : shapes) {
+    signatures.push_back(
+        {{ArgumentSignature::tensor({batch, seqlen, 768}, at::kFloat)}, 0});
+  }
+  executor_cache.compileFusionAheadOfTime(signatures);
+  const size_t num_runtimes = executor_cache.countRuntimes();
+  EXPECT_GE(num_runtimes, 1u);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (auto [batch, seqlen] : shapes) {
+    at::Tensor t0 = at::randn({batch, seqlen, 768}, options);
+    EXPECT_TRUE(executor_cache.isCompiled({t0}));
+  }
+
+  flatbuffers::FlatBufferBuilder builder(1024);
+  builder.Finish(executor_cache.serialize(builder));
+  auto buffer = flatbuffers::GetRoot<serde::FusionExecutorCache>(
+      builder.GetBufferPointer());
+
+  FusionExecutorCache restored_cache(
+      std::make_unique<Fusion>(*executor_cache.fusion()));
+  restored_cache.deserialize(buffer, /*fusion_id=*/0);
+  EXPECT_EQ(restored_cache.countRuntimes(), num_runtimes);
+
+  for (auto [batch, seqlen] : shapes) {
+    at::Tensor t0 = at::randn({batch, seqlen, 768}, options);
+    EXPECT_TRUE(restored_cache.isCompiled({t0}));
+    auto outputs = restored_cache.runFusionWithInputs({t0});
+    testValidate(restored_cache.fusion(), outputs, {t0}, __LINE__, __FILE__);
+  }
+  EXPECT_EQ(restored_cache.countRuntimes(), num_runtimes);
+}
+
+// A lazily deserialized cache rebuilds its runtimes on the first lookup or
+// query of its runtimes
+TEST_F(FusionExecutorCacheTest, LazyDeserialization) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(relu(tv0), {1});
+  fusion->addOutput(tv1);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({8, 1024}, options);
+  executor_cache.runFusionWithInputs({t0});
+
+  flatbuffers::FlatBufferBuilder builder(1024);
+  builder.Finish(executor_cache.serialize(builder));
+  auto buffer = flatbuffers::GetRoot<serde::FusionExecutorCache>(
+      builder.GetBufferPointer());
+
+  FusionExecutorCache restored_cache(
+      std::make_unique<Fusion>(*executor_cache.fusion()));
+  restored_cache.deserialize(buffer, /*fusion_id=*/0, /*lazy=*/true);
+  EXPECT_EQ(restored_cache.countRuntimes(), 1);
+  EXPECT_EQ(restored_cache.countConcretizations(), 1);
+
+  EXPECT_TRUE(restored_cache.isCompiled({t0}));
+  EXPECT_EQ(restored_cache.countRuntimes(), 1);
+  auto outputs = restored_cache.runFusionWithInputs({t0});
+  testValidate(restored_cache.fusion(), outputs, {t0}, __LINE__, __FILE__);
+}
+
+// The least recently used runtime is evicted, and is created again on the next
+// run that needs it
+TEST_F(FusionExecutorCacheTest, EvictLeastRecentlyUsedRuntime) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  fusion->addOutput(tv1);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor small = at::randn({16, 16}, options);
+  at::Tensor large = at::randn({1024, 65536}, options);
+  executor_cache.runFusionWithInputs({small});
+  executor_cache.runFusionWithInputs({large});
+  if (executor_cache.countRuntimes() < 2) {
+    GTEST_SKIP() << "Both shapes are served by the same runtime";
+  }
+  EXPECT_EQ(executor_cache.numRuntimeMisses(), 2);
+  const int64_t bytes = executor_cache.approximateBytes();
+  EXPECT_GT(bytes, 0);
+
+  FusionKernelRuntime* most_recent =
+      executor_cache.getMostRecentKernelRuntime();
+  EXPECT_GT(executor_cache.evictLeastRecentlyUsedRuntime(), 0);
+  EXPECT_EQ(executor_cache.countRuntimes(), 1);
+  EXPECT_EQ(executor_cache.numEvictedRuntimes(), 1);
+  EXPECT_LT(executor_cache.approximateBytes(), bytes);
+  // The most recent runtime is never evicted
+  EXPECT_FALSE(executor_cache.leastRecentUse().has_value());
+  EXPECT_EQ(executor_cache.evictLeastRecentlyUsedRuntime(), 0);
+  EXPECT_EQ(executor_cache.getMostRecentKernelRuntime(), most_recent);
+
+  auto outputs = executor_cache.runFusionWithInputs({small});
+  testValidate(executor_cache.fusion(), outputs, {small}, __LINE__, __FILE__);
+  EXPECT_EQ(executor_cache.countRuntimes(), 2);
+  EXPECT_EQ(executor_cache.numRuntimeMisses(), 3);
+
+  outputs = executor_cache.runFusionWithInputs({large});
+  testValidate(executor_cache.fusion(), outputs, {large}, __LINE__, __FILE__);
+  EXPECT_EQ(executor_cache.numRuntimeHits(), 1);
+}
+
+// A segmented fusion is captured into a CUDA graph on its second run and
+// replayed afterwards, including for new input tensors of the same shape
+TEST_F(FusionExecutorCacheTest, CudaGraphReplay) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::CudaGraph);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  auto s0 = IrBuilder::create<Val>(DataType::Double);
+  fusion->addInput(tv0);
+  fusion->addInput(s0);
+  auto tv1 = sum(tv0, {1});
+  auto tv2 = broadcast(tv1, {false, true});
+  auto tv3 = mul(tv0, tv2);
+  auto tv4 = sum(tv3, {0});
+  auto tv5 = mul(tv4, s0);
+  fusion->addOutput(tv5);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<at::Tensor> outputs;
+  for (auto i : c10::irange(4)) {
+    (void)i; // Suppress unused variable warning
+    at::Tensor t0 = at::randn({64, 1024}, options);
+    outputs = executor_cache.runFusionWithInputs({t0, 2.0});
+    testValidate(
+        executor_cache.fusion(), outputs, {t0, 2.0}, __LINE__, __FILE__);
+  }
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_EQ(runtime->numCudaGraphs(), 1);
+
+  // Outputs of earlier replays are not overwritten
+  at::Tensor t0 = at::randn({64, 1024}, options);
+  auto new_outputs = executor_cache.runFusionWithInputs({t0, 2.0});
+  EXPECT_FALSE(at::equal(outputs[0], new_outputs[0]));
+
+  // A different scalar value runs without the graph
+  new_outputs = executor_cache.runFusionWithInputs({t0, 3.0});
+  testValidate(
+      executor_cache.fusion(), new_outputs, {t0, 3.0}, __LINE__, __FILE__);
+}
+
+// CPU scalar tensors, e.g., a learning rate, are staged into device memory,
+// so a fusion reading them is replayed from its graph for any of their values
+TEST_F(FusionExecutorCacheTest, CudaGraphWithStagedCpuScalars) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::CudaGraph);
+  EnableOptionsGuard::getCurOptions().set(EnableOption::StageCpuScalars);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  auto tv1 = makeContigTensor(0);
+  tv1->setCpuScalar(true);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  auto tv2 = mul(tv0, tv1);
+  fusion->addOutput(tv2);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({64, 1024}, options);
+  for (auto i : c10::irange(4)) {
+    at::Tensor lr = at::scalar_tensor(1.0 + (double)i, at::kFloat);
+    auto outputs = executor_cache.runFusionWithInputs({t0, lr});
+    EXPECT_TRUE(at::allclose(outputs[0], t0 * lr.item<float>()));
+  }
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_EQ(runtime->numCudaGraphs(), 1);
+}
+
+// Launches with the same input cache id only patch the data pointers and
+// scalars of the kernel arguments
+TEST_F(FusionExecutorCacheTest, PatchKernelArguments) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  auto tv1 = makeSymbolicTensor(2);
+  auto s0 = IrBuilder::create<Val>(DataType::Double);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addInput(s0);
+  auto tv2 = add(tv0, tv1);
+  auto tv3 = mul(tv2, s0);
+  fusion->addOutput(tv3);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (auto i : c10::irange(3)) {
+    at::Tensor t0 = at::randn({128, 256}, options);
+    at::Tensor t1 = at::randn({128, 256}, options);
+    c10::IValue scale = (double)i + 0.5;
+    auto outputs = executor_cache.runFusionWithInputs({t0, t1, scale});
+    testValidate(
+        executor_cache.fusion(),
+        outputs,
+        {t0, t1, scale},
+        __LINE__,
+        __FILE__);
+  }
+  EXPECT_EQ(executor_cache.countRuntimes(), 1);
+}
+
+// Independent branches of a segmented fusion run on separate streams
+TEST_F(FusionExecutorCacheTest, ConcurrentSegments) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::ConcurrentSegments, {"3"});
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = segment_set(tv0);
+  auto tv2 = sum(sin(tv1), {1});
+  auto tv3 = segment_set(tv0);
+  auto tv4 = sum(cos(tv3), {0});
+  auto tv5 = segment_set(tv2);
+  auto tv6 = add(sum(tv5, {0}), sum(tv4, {0}));
+  fusion->addOutput(tv2);
+  fusion->addOutput(tv4);
+  fusion->addOutput(tv6);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (auto i : c10::irange(2)) {
+    (void)i; // Suppress unused variable warning
+    at::Tensor t0 = at::randn({256, 512}, options);
+    auto outputs = executor_cache.runFusionWithInputs({t0});
+    testValidate(executor_cache.fusion(), outputs, {t0}, __LINE__, __FILE__);
+  }
+  EXPECT_TRUE(executor_cache.getMostRecentKernelRuntime()->isSegmented());
+}
+
+// Consecutive pointwise segments run as the stages of a single kernel
+TEST_F(FusionExecutorCacheTest, Megakernel) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::Megakernel);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = segment_set(sin(tv0));
+  auto tv2 = segment_set(cos(tv1));
+  auto tv3 = exp(tv2);
+  fusion->addOutput(tv3);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (auto i : c10::irange(2)) {
+    (void)i; // Suppress unused variable warning
+    at::Tensor t0 = at::randn({128, 1024}, options);
+    auto outputs = executor_cache.runFusionWithInputs({t0});
+    testValidate(executor_cache.fusion(), outputs, {t0}, __LINE__, __FILE__);
+  }
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_TRUE(runtime->isSegmented());
+  ASSERT_NE(runtime->megakernel(), nullptr);
+  EXPECT_EQ(runtime->megakernel()->numLaunches(), 2);
+}
+
+// Stages whose launches can't be combined, e.g., a grid reduction with
+// another grid than the next stage, are launched separately
+TEST_F(FusionExecutorCacheTest, MegakernelWithReduction) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::Megakernel);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {0});
+  auto tv2 = segment_set(tv1);
+  auto tv3 = add(broadcast(tv2, {true, false}), tv0);
+  fusion->addOutput(tv3);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (auto i : c10::irange(2)) {
+    (void)i; // Suppress unused variable warning
+    at::Tensor t0 = at::randn({4096, 256}, options);
+    auto outputs = executor_cache.runFusionWithInputs({t0});
+    testValidate(executor_cache.fusion(), outputs, {t0}, __LINE__, __FILE__);
+  }
+  EXPECT_TRUE(executor_cache.getMostRecentKernelRuntime()->isSegmented());
+}
+
+TEST_F(FusionExecutorCacheTest, IntermediateArenaPlan) {
+  constexpr int64_t alignment = IntermediateArenaPlan::alignment;
+  // A chain of buffers each read by the next segment, and one buffer live
+  // across the whole chain
+  IntermediateArenaPlan plan(
+      {{1000, 0, 1}, {1000, 1, 2}, {1000, 2, 3}, {1000, 3, 4}, {10, 0, 4}});
+  EXPECT_THAT(
+      plan.offsets(),
+      testing::ElementsAre(0, 2 * alignment, 0, 2 * alignment, 4 * alignment));
+  EXPECT_EQ(plan.arenaBytes(), 5 * alignment);
+
+  // Buffers live at the same segment never overlap
+  const auto& buffers = plan.buffers();
+  for (auto i : c10::irange(buffers.size())) {
+    for (auto j : c10::irange(i + 1, buffers.size())) {
+      if (buffers[i].first_use > buffers[j].last_use ||
+          buffers[j].first_use > buffers[i].last_use) {
+        continue;
+      }
+      EXPECT_TRUE(
+          plan.offsets()[i] + buffers[i].num_bytes <= plan.offsets()[j] ||
+          plan.offsets()[j] + buffers[j].num_bytes <= plan.offsets()[i]);
+    }
+  }
+}
+
+TEST_F(FusionExecutorCacheTest, IntermediateArena) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::IntermediateArena);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = segment_set(sin(tv0));
+  auto tv2 = segment_set(cos(tv1));
+  auto tv3 = segment_set(exp(tv2));
+  auto tv4 = neg(tv3);
+  fusion->addOutput(tv4);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 1024}, options);
+  std::vector<at::Tensor> outputs;
+  for (auto i : c10::irange(2)) {
+    (void)i; // Suppress unused variable warning
+    outputs = executor_cache.runFusionWithInputs({t0});
+    testValidate(executor_cache.fusion(), outputs, {t0}, __LINE__, __FILE__);
+  }
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_TRUE(runtime->isSegmented());
+  // Each intermediate is only live while its producer and consumer run, so
+  // the three intermediates fit in the space of two
+  const int64_t num_bytes = t0.numel() * (int64_t)t0.itemsize();
+  EXPECT_GT(runtime->intermediateArenaBytes(), 0);
+  EXPECT_LE(runtime->intermediateArenaBytes(), 2 * num_bytes);
+
+  // Outputs are not placed in the arena, so a later run does not overwrite
+  // them
+  at::Tensor t1 = at::randn({1024, 1024}, options);
+  for (auto i : c10::irange(2)) {
+    (void)i; // Suppress unused variable warning
+    auto new_outputs = executor_cache.runFusionWithInputs({t1});
+    testValidate(
+        executor_cache.fusion(), new_outputs, {t1}, __LINE__, __FILE__);
+  }
+  testValidate(executor_cache.fusion(), outputs, {t0}, __LINE__, __FILE__);
+}
+
+TEST_F(FusionExecutorCacheTest, L2PersistIntermediates) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::IntermediateArena);
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::L2PersistIntermediates);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = segment_set(sin(tv0));
+  auto tv2 = segment_set(cos(tv1));
+  auto tv3 = neg(tv2);
+  fusion->addOutput(tv3);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  // The window is only set once the arena is planned by the first run
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({256, 1024}, options);
+  for (auto i : c10::irange(3)) {
+    (void)i; // Suppress unused variable warning
+    auto outputs = executor_cache.runFusionWithInputs({t0});
+    testValidate(executor_cache.fusion(), outputs, {t0}, __LINE__, __FILE__);
+  }
+
+  // Later kernels on the stream are not affected
+  cudaStreamAttrValue attr;
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaStreamGetAttribute(
+      c10::cuda::getCurrentCUDAStream(),
+      cudaStreamAttributeAccessPolicyWindow,
+      &attr));
+  EXPECT_EQ(attr.accessPolicyWindow.num_bytes, 0);
+}
+
+TEST_F(FusionExecutorCacheTest, ConcurrentRuns) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(sin(tv0), {1});
+  auto tv2 = segment_set(tv1);
+  auto tv3 = add(tv2, IrBuilder::create<Val>(1.0));
+  fusion->addOutput(tv3);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  // Threads share runtimes and race on compiling them and on adding cache
+  // ids, including evictions once the lookup exceeds its capacity
+  constexpr int64_t num_threads = 4;
+  constexpr int64_t num_runs = 20;
+  std::vector<std::thread> threads;
+  std::vector<std::string> errors(num_threads);
+  for (auto thread_id : c10::irange(num_threads)) {
+    threads.emplace_back([&, thread_id]() {
+      c10::cuda::CUDAStreamGuard stream_guard(c10::cuda::getStreamFromPool());
+      auto options =
+          at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+      try {
+        for (auto i : c10::irange(num_runs)) {
+          at::Tensor t0 = at::randn({128 + (i % 3) * 32, 256}, options);
+          auto outputs = executor_cache.runFusionWithInputs({t0});
+          auto expected = t0.sin().sum({1}) + 1.0;
+          if (!at::allclose(outputs.at(0), expected, 1e-4, 1e-4)) {
+            errors.at(thread_id) = "Mismatch in run " + std::to_string(i);
+            return;
+          }
+        }
+      } catch (const std::exception& e) {
+        errors.at(thread_id) = e.what();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_THAT(errors, testing::Each(testing::IsEmpty()));
+  EXPECT_GE(executor_cache.countRuntimes(), 1);
+}
+
+// An autotuned runtime keeps the fastest variant of its heuristics, which
+// is reapplied when the heuristics are recomputed for new inputs
+TEST_F(FusionExecutorCacheTest, Autotune) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::Autotune);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  auto tv1 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  auto tv2 = add(tv0, tv1);
+  auto tv3 = sin(tv2);
+  fusion->addOutput(tv3);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 1024}, options);
+  at::Tensor t1 = at::randn({1024, 1024}, options);
+  auto outputs = executor_cache.runFusionWithInputs({t0, t1});
+  testValidate(
+      executor_cache.fusion(), outputs, {t0, t1}, __LINE__, __FILE__);
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  ASSERT_EQ(runtime->autotunedVariants().size(), 1);
+  const auto& heuristics = runtime->schedulerHeuristics()->heuristicsList();
+  EXPECT_EQ(heuristics.at(0)->scheduler_type, SchedulerType::PointWise);
+  EXPECT_GT(autotuneVariants(heuristics.at(0).get()).size(), 1);
+
+  at::Tensor t2 = at::randn({2048, 1024}, options);
+  at::Tensor t3 = at::randn({2048, 1024}, options);
+  outputs = executor_cache.runFusionWithInputs({t2, t3});
+  testValidate(
+      executor_cache.fusion(), outputs, {t2, t3}, __LINE__, __FILE__);
+  EXPECT_EQ(
+      executor_cache.getMostRecentKernelRuntime()->autotunedVariants().size(),
+      1);
+}
+
+// Limiting register pressure keeps a single variant of the heuristics, like
+// autotuning
+TEST_F(FusionExecutorCacheTest, LimitRegisterPressure) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::LimitRegisterPressure);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(sin(tv0), {1});
+  fusion->addOutput(tv1);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 1024}, options);
+  auto outputs = executor_cache.runFusionWithInputs({t0});
+  testValidate(executor_cache.fusion(), outputs, {t0}, __LINE__, __FILE__);
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  ASSERT_EQ(runtime->autotunedVariants().size(), 1);
+  const auto& heuristics = runtime->schedulerHeuristics()->heuristicsList();
+  EXPECT_EQ(heuristics.at(0)->scheduler_type, SchedulerType::Reduction);
+
+  // The kept variant is reapplied to the heuristics of new inputs
+  at::Tensor t1 = at::randn({2048, 1024}, options);
+  outputs = executor_cache.runFusionWithInputs({t1});
+  testValidate(executor_cache.fusion(), outputs, {t1}, __LINE__, __FILE__);
+}
+
+// The register cap and shared memory carve-out follow the blocks per SM
+// intended by the inner persistent heuristic
+TEST_F(FusionExecutorCacheTest, OccupancyTarget) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::OccupancyTarget);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = softmax(tv0, 1);
+  fusion->addOutput(tv1);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 4096}, options);
+  auto outputs = executor_cache.runFusionWithInputs({t0});
+  testValidate(executor_cache.fusion(), outputs, {t0}, __LINE__, __FILE__);
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_FALSE(runtime->isSegmented());
+  const auto& heuristics = runtime->schedulerHeuristics()->heuristicsList();
+  EXPECT_EQ(heuristics.at(0)->scheduler_type, SchedulerType::InnerPersistent);
+  const CompileParams& cparams = heuristics.at(0)->cparams;
+  ASSERT_TRUE(cparams.target_blocks_per_sm.has_value());
+  EXPECT_GE(cparams.target_blocks_per_sm.value(), 1);
+}
+
+// The backend of a matmul is selected once per input shape and persists
+// through serialization
+TEST_F(FusionExecutorCacheTest, MatmulAutoSelect) {
+  NVFUSER_TEST_CUDA_ARCH_RANGE_GUARD(8, 0, 10, 0);
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::MatmulAutoSelect);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2, DataType::BFloat16);
+  auto tv1 = makeContigTensor(2, DataType::BFloat16);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  auto tv2 = relu(matmul(tv0, tv1));
+  fusion->addOutput(tv2);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  // Exactly the runtimes evaluating the matmul with ATen have an ExprEval
+  // segment
+  auto check_backend = [](FusionKernelRuntime* runtime) {
+    const auto& heuristics = runtime->schedulerHeuristics()->heuristicsList();
+    bool has_expr_eval = std::any_of(
+        heuristics.begin(), heuristics.end(), [](const auto& params) {
+          return params->scheduler_type == SchedulerType::ExprEval;
+        });
+    EXPECT_EQ(has_expr_eval, runtime->matmulExprEval());
+  };
+
+  auto options =
+      at::TensorOptions().dtype(at::kBFloat16).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 256}, options);
+  at::Tensor t1 = at::randn({256, 512}, options);
+  auto outputs = executor_cache.runFusionWithInputs({t0, t1});
+  testValidate(
+      executor_cache.fusion(), outputs, {t0, t1}, __LINE__, __FILE__);
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  check_backend(runtime);
+  const bool matmul_expr_eval = runtime->matmulExprEval();
+
+  // Another shape is timed again instead of reusing the runtime
+  at::Tensor t2 = at::randn({128, 256}, options);
+  outputs = executor_cache.runFusionWithInputs({t2, t1});
+  testValidate(
+      executor_cache.fusion(), outputs, {t2, t1}, __LINE__, __FILE__);
+  check_backend(executor_cache.getMostRecentKernelRuntime());
+  EXPECT_EQ(executor_cache.countRuntimes(), 2);
+
+  flatbuffers::FlatBufferBuilder builder(1024);
+  builder.Finish(executor_cache.serialize(builder));
+  auto buffer = flatbuffers::GetRoot<serde::FusionExecutorCache>(
+      builder.GetBufferPointer());
+
+  FusionExecutorCache restored_cache(
+      std::make_unique<Fusion>(*executor_cache.fusion()));
+  restored_cache.deserialize(buffer, /*fusion_id=*/0);
+  outputs = restored_cache.runFusionWithInputs({t0, t1});
+  testValidate(restored_cache.fusion(), outputs, {t0, t1}, __LINE__, __FILE__);
+  EXPECT_EQ(
+      restored_cache.getMostRecentKernelRuntime()->matmulExprEval(),
+      matmul_expr_eval);
+  EXPECT_EQ(restored_cache.countRuntimes(), 2);
+}
+
+TEST_F(FusionExecutorCacheTest, PreallocatedOutputs) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* in = makeContigTensor(2);
+  fusion->addInput(in);
+  TensorView* out = sin(in);
+  fusion->addOutput(out);
+  // Computed by ATen as an alias of the input, so it is copied to its buffer
+  TensorView* alias_out = permute(in, {1, 0});
+  fusion->addOutput(alias_out);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({32, 64}, options);
+  at::Tensor out_buffer = at::empty({32, 64}, options);
+  at::Tensor alias_out_buffer = at::empty({64, 32}, options);
+  for (int i = 0; i < 2; i++) {
+    auto outputs = executor_cache.runFusionWithInputs(
+        {t0},
+        std::nullopt,
+        std::nullopt,
+        {out_buffer, alias_out_buffer});
+    ASSERT_EQ(outputs.size(), 2);
+    EXPECT_TRUE(outputs[0].is_same(out_buffer));
+    EXPECT_TRUE(outputs[1].is_same(alias_out_buffer));
+    testValidate(
+        executor_cache.fusion(), outputs, {t0}, __LINE__, __FILE__);
+  }
+
+  // Undefined buffers are allocated as usual
+  auto outputs = executor_cache.runFusionWithInputs(
+      {t0}, std::nullopt, std::nullopt, {out_buffer, at::Tensor()});
+  EXPECT_TRUE(outputs[0].is_same(out_buffer));
+  EXPECT_FALSE(outputs[1].is_same(alias_out_buffer));
+  testValidate(executor_cache.fusion(), outputs, {t0}, __LINE__, __FILE__);
+
+  EXPECT_THAT(
+      [&]() {
+        executor_cache.runFusionWithInputs(
+            {t0},
+            std::nullopt,
+            std::nullopt,
+            {at::empty({32, 32}, options), alias_out_buffer});
+      },
+      ::testing::ThrowsMessage<nvfError>(
+          ::testing::HasSubstr("is expected to be of sizes")));
+  EXPECT_THAT(
+      [&]() {
+        executor_cache.runFusionWithInputs(
+            {t0}, std::nullopt, std::nullopt, {out_buffer});
+      },
+      ::testing::ThrowsMessage<nvfError>(
+          ::testing::HasSubstr("Expected 2 output buffers")));
+}
+
+// Each intermediate of the chain is freed after its consumer runs, so at most
+// two of them are live at once
+TEST_F(FusionExecutorCacheTest, PeakMemory) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* in = makeContigTensor(2);
+  fusion->addInput(in);
+  TensorView* tv = sin(in);
+  tv = segment_set(tv);
+  tv = cos(tv);
+  tv = segment_set(tv);
+  tv = exp(tv);
+  fusion->addOutput(tv);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  executor_cache.profile(true);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 1024}, options);
+  constexpr int64_t tensor_bytes = 1024 * 1024 * 4;
+
+  auto outputs = executor_cache.runFusionWithInputs({t0});
+  testValidate(executor_cache.fusion(), outputs, {t0}, __LINE__, __FILE__);
+  ASSERT_EQ(
+      executor_cache.getMostRecentKernelRuntime()->executors().size(), 3);
+
+  const PeakMemoryStats& measured =
+      executor_cache.getMostRecentExecutorInfo().peak_memory;
+  EXPECT_EQ(measured.output_bytes, tensor_bytes);
+  EXPECT_EQ(measured.intermediate_bytes, 2 * tensor_bytes);
+  EXPECT_EQ(measured.work_buffer_bytes, 0);
+  EXPECT_EQ(measured.peak_bytes, 2 * tensor_bytes);
+
+  const PeakMemoryStats predicted = executor_cache.predictPeakMemory({t0});
+  EXPECT_EQ(predicted.peak_bytes, measured.peak_bytes);
+  EXPECT_EQ(predicted.intermediate_bytes, measured.intermediate_bytes);
+}
+
+TEST_F(FusionExecutorCacheTest, HeuristicValidityRegion) {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  KernelArgumentHolder args;
+  args.push(std::vector<at::Tensor>{at::randn({64, 32}, options)});
+
+  HeuristicValidityRegion region;
+  EXPECT_TRUE(region.contains(args));
+  region.extent_ranges.push_back({/*input=*/0, /*dim=*/0, 1, 64});
+  EXPECT_TRUE(region.contains(args));
+  region.extent_ranges.push_back({/*input=*/0, /*dim=*/1, 1, 16});
+  EXPECT_FALSE(region.contains(args));
+}
+
+// The params of a matmul evaluated with ATen don't depend on the shapes, so
+// new shapes reuse them without computing the heuristics again
+TEST_F(FusionExecutorCacheTest, ReuseHeuristicsInValidityRegion) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  auto tv1 = makeContigTensor(2, DataType::Half);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  auto tv2 = matmul(tv0, tv1);
+  fusion->addOutput(tv2);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({64, 32}, options);
+  at::Tensor t1 = at::randn({32, 16}, options);
+  auto outputs = executor_cache.runFusionWithInputs({t0, t1});
+  testValidate(
+      executor_cache.fusion(), outputs, {t0, t1}, __LINE__, __FILE__);
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  const auto& heuristics = runtime->schedulerHeuristics()->heuristicsList();
+  if (std::any_of(heuristics.begin(), heuristics.end(), [](const auto& params) {
+        return params->scheduler_type != SchedulerType::ExprEval;
+      })) {
+    GTEST_SKIP() << "The matmul is not evaluated with ATen";
+  }
+  for (const auto& params : heuristics) {
+    EXPECT_TRUE(params->validity_region.has_value());
+  }
+
+  at::Tensor t2 = at::randn({128, 32}, options);
+  at::Tensor t3 = at::randn({32, 48}, options);
+  outputs = executor_cache.runFusionWithInputs({t2, t3});
+  testValidate(
+      executor_cache.fusion(), outputs, {t2, t3}, __LINE__, __FILE__);
+  EXPECT_EQ(executor_cache.getMostRecentKernelRuntime(), runtime);
+  EXPECT_EQ(executor_cache.countRuntimes(), 1);
+}
+
+} // namespace nvfuser
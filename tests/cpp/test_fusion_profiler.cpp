@@ -239,4 +239,74 @@ TEST_F(FusionProfilerTest, FusionProfilerErrorChecks) {
   }
 }
 
+TEST_F(FusionProfilerTest, CompilePhases) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  ProfilerOptionsGuard::getCurOptions().set(ProfilerOption::EnableNocupti);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  fusion->addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({128, 256}, options);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  executor_cache.runFusionWithInputs({t0});
+
+  std::vector<std::string> phase_names;
+  for (const auto& phase : FusionProfiler::profile().compile_phases) {
+    EXPECT_GT(phase.count, 0);
+    EXPECT_GE(phase.time_ms, 0.0);
+    phase_names.push_back(phase.name);
+  }
+  EXPECT_THAT(
+      phase_names,
+      testing::IsSupersetOf(
+          {"Preseg PreSegmenter",
+           "Segmenter",
+           "reduction heuristics",
+           "reduction schedule",
+           "GpuLower::analysis build parallelDimensionMap",
+           "GpuLower::run IndexLowering",
+           "Codegen",
+           "Module load"}));
+
+  // A second run reuses the compiled kernel
+  executor_cache.runFusionWithInputs({t0});
+  EXPECT_TRUE(FusionProfiler::profile().compile_phases.empty());
+}
+
+TEST_F(FusionProfilerTest, Roofline) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  ProfilerOptionsGuard::getCurOptions().unset(ProfilerOption::EnableNocupti);
+  ProfilerOptionsGuard::getCurOptions().set(ProfilerOption::Enable);
+
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  // Casts are free, the add and the mul are one FLOP per element each
+  auto tv2 = castOp(DataType::Double, add(tv0, tv1));
+  auto tv3 = mul(tv2, IrBuilder::create<Val>(2.0));
+  fusion->addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({128, 256}, options);
+  auto t1 = at::randn({128, 256}, options);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  executor_cache.runFusionWithInputs({t0, t1});
+
+  const auto& kprof = FusionProfiler::profile().kernel_profiles.at(0);
+  EXPECT_EQ(kprof.flops, 2 * 128 * 256);
+  EXPECT_GT(kprof.gflops, 0.0);
+  EXPECT_GT(kprof.peak_gflops, 0.0);
+  EXPECT_GT(kprof.percentage_peak_flops, 0.0);
+  // Two FLOPs per 16 bytes is well below the ridge point of any GPU
+  EXPECT_EQ(kprof.bound, "Mem");
+}
+
 } // namespace nvfuser
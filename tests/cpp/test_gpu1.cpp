@@ -364,6 +364,52 @@ TEST_F(NVFuserTest, FusionMove_CUDA) {
   ASSERT_EQ(lowered_ir.str(), moved_lowered_ir.str());
 }
 
+// Statements are allocated from the arena of their container, and removed
+// ones leave holes in its dense vectors that are compacted eventually
+TEST_F(NVFuserTest, FusionStatementArena_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  std::vector<Val*> kept;
+  std::vector<Val*> removed;
+  for (auto i : c10::irange(3000)) {
+    Val* val = IrBuilder::create<Val>(DataType::Int);
+    (i % 3 == 0 ? kept : removed).push_back(val);
+  }
+  for (Val* val : removed) {
+    fusion.removeVal(val);
+  }
+  for (Val* val : removed) {
+    EXPECT_FALSE(fusion.inContainer(val));
+  }
+  for (Val* val : kept) {
+    EXPECT_TRUE(fusion.inContainer(val));
+  }
+  auto vals = fusion.deterministic_vals();
+  EXPECT_EQ(std::vector<Val*>(vals.begin(), vals.end()), kept);
+
+  // Copies keep the deterministic order of the original
+  Fusion copy(fusion);
+  auto copied_vals = copy.deterministic_vals();
+  ASSERT_EQ(copied_vals.size(), kept.size());
+  for (auto i : c10::irange(kept.size())) {
+    EXPECT_EQ(copied_vals.at(i)->name(), kept.at(i)->name());
+    EXPECT_TRUE(copy.inContainer(copied_vals.at(i)));
+    EXPECT_FALSE(fusion.inContainer(copied_vals.at(i)));
+  }
+
+  // Statements follow their container when swapped, and the shortcut vals of
+  // each container stay valid
+  Val* zero = fusion.zeroVal();
+  swap(fusion, copy);
+  EXPECT_TRUE(copy.inContainer(kept.front()));
+  EXPECT_FALSE(fusion.inContainer(kept.front()));
+  EXPECT_EQ(kept.front()->container(), &copy);
+  EXPECT_EQ(fusion.vals().size(), kept.size());
+  EXPECT_EQ(zero, fusion.zeroVal());
+  EXPECT_TRUE(zero->isZeroInt());
+}
+
 TEST_F(NVFuserTest, FusionSimpleArith_CUDA) {
   std::stringstream ss1, ss2;
 
@@ -2739,6 +2785,47 @@ TEST_F(NVFuserTest, FusionFp8CastOps_CUDA) {
   }
 }
 
+TEST_F(NVFuserTest, FusionFp8PackedCast_CUDA) {
+#if (CUDA_VERSION >= 12010)
+  if (!deviceMajorMinorCheck(8, 9)) {
+#else
+  if (true) {
+#endif
+    GTEST_SKIP() << "skipping FP8 tests on pre-Ada GPUs";
+  }
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  TensorView* tv1 = set(tv0);
+  TensorView* tv2 = castOp(DataType::Float8_e4m3fn, tv1);
+  TensorView* tv3 = set(tv2);
+  fusion.addOutput(tv3);
+
+  tv3->split(1, 4);
+  TransformPropagatorWithCheck propagator(tv3);
+  MaxLogicalDomainInfoSpanningTree(tv3).traverse(&propagator);
+  tv3->axis(0)->parallelize(ParallelType::BIDx);
+  tv3->axis(1)->parallelize(ParallelType::TIDx);
+  scheduler_utils::parallelizeAllLike(tv3);
+  tv1->axis(2)->parallelize(ParallelType::Vectorize);
+  tv3->axis(2)->parallelize(ParallelType::Vectorize);
+  inlineMost();
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({16, 128}, options);
+
+  KernelExecutor ke;
+  ke.compile(&fusion, {t0});
+  EXPECT_THAT(ke.kernelString(), testing::HasSubstr("fp8PackedCast<4>"));
+  auto outputs = ke.run({t0});
+
+  at::Tensor ref_output = t0.to(at::kFloat8_e4m3fn);
+  EXPECT_TRUE(outputs[0].to(at::kFloat).equal(ref_output.to(at::kFloat)));
+}
+
 // Start off simple, block on the outer dim
 // block stride + thread all reduce + unrolling on inner dim
 TEST_F(NVFuserTest, FusionReduction1_CUDA) {
@@ -2804,6 +2891,68 @@ TEST_F(NVFuserTest, FusionReduction1_CUDA) {
       &fusion, {cg_output}, {input}, {aten_output}, __LINE__, __FILE__);
 }
 
+// Block reductions over a multiple of 32 threads first reduce within warps,
+// whether the number of warps is a power of two or not
+TEST_F(NVFuserTest, FusionBlockReduceWarpShuffle_CUDA) {
+  for (int64_t tidx : {96, 160, 256}) {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+
+    TensorView* tv0 = makeSymbolicTensor(2);
+    fusion.addInput(tv0);
+    TensorView* tv1 = sum(tv0, {1});
+    fusion.addOutput(tv1);
+
+    tv1->split(1, tidx);
+    TensorView* tv2 = tv1->rFactor({1});
+    tv0->computeAt(tv1, 1);
+    tv1->axis(0)->parallelize(ParallelType::BIDx);
+    tv1->axis(-1)->parallelize(ParallelType::TIDx);
+    tv2->axis(-1)->parallelize(ParallelType::TIDx);
+
+    auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+    at::Tensor t0 = at::randn({65, 1000}, options);
+
+    KernelExecutor ke;
+    ke.compile(&fusion, {t0});
+    auto cg_outputs = ke.run({t0});
+    testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+  }
+}
+
+// Block reductions over fewer threads than a warp, whose number divides the
+// warp size, reduce several rows per warp with shuffles. The last warp of
+// these blocks of 3 rows is partial.
+TEST_F(NVFuserTest, FusionBlockReduceSubWarpShuffle_CUDA) {
+  for (int64_t tidx : {4, 8, 16}) {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+
+    TensorView* tv0 = makeSymbolicTensor(2);
+    fusion.addInput(tv0);
+    TensorView* tv1 = sum(tv0, {1});
+    fusion.addOutput(tv1);
+
+    tv1->split(1, tidx);
+    tv1->split(0, 3);
+    TensorView* tv2 = tv1->rFactor({2});
+    tv0->computeAt(tv1, 2);
+    for (TensorView* tv : {tv1, tv2}) {
+      tv->axis(0)->parallelize(ParallelType::BIDx);
+      tv->axis(1)->parallelize(ParallelType::TIDy);
+      tv->axis(-1)->parallelize(ParallelType::TIDx);
+    }
+
+    auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+    at::Tensor t0 = at::randn({3 * 65, 100}, options);
+
+    KernelExecutor ke;
+    ke.compile(&fusion, {t0});
+    auto cg_outputs = ke.run({t0});
+    testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+  }
+}
+
 TEST_F(NVFuserTest, FusionReduction2_CUDA) {
   Fusion fusion;
   FusionGuard fg(&fusion);
@@ -4519,6 +4668,40 @@ TEST_F(NVFuserTest, FusionGridReduction8_CUDA) {
   testValidate(&fusion, out, {input}, __LINE__, __FILE__);
 }
 
+// A grid reduction whose output is not read by the kernel is finished by the
+// last block to arrive
+TEST_F(NVFuserTest, FusionGridReductionLastArrival_CUDA) {
+  for (bool has_consumer : {false, true}) {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+
+    auto tv0 = makeSymbolicTensor(2);
+    fusion.addInput(tv0);
+    auto tv1 = sum(tv0, {0});
+    fusion.addOutput(tv1);
+    if (has_consumer) {
+      auto tv2 = add(tv1, IrBuilder::create<Val>(1.0));
+      fusion.addOutput(tv2);
+      tv2->axis(0)->parallelize(ParallelType::TIDx);
+    }
+
+    tv1->axis(0)->parallelize(ParallelType::BIDx);
+    tv1->axis(1)->parallelize(ParallelType::TIDx);
+
+    auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+    at::Tensor input = at::randn({100, 64}, options);
+
+    KernelExecutor ke;
+    ke.compile(&fusion, {input});
+    EXPECT_EQ(
+        ke.kernelString().find("gridReduceLastArrival") != std::string::npos,
+        !has_consumer);
+    auto out = ke.run({input});
+
+    testValidate(&fusion, out, {input}, __LINE__, __FILE__);
+  }
+}
+
 TEST_F(NVFuserTest, FusionGridReduction9_CUDA) {
   Fusion fusion;
   FusionGuard fg(&fusion);
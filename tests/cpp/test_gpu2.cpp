@@ -1095,6 +1095,52 @@ TEST_F(NVFuserTest, FusionDisjointSet_CUDA) {
   }
 }
 
+// Containers larger than kMaxLinearSize switch from linear search to a set,
+// and merged sets keep their deterministic order
+TEST_F(NVFuserTest, FusionDisjointSetLarge_CUDA) {
+  constexpr int num = 4 * VectorOfUniqueEntries<int>::kMaxLinearSize;
+  VectorOfUniqueEntries<int> entries;
+  for (auto i : c10::irange(num)) {
+    EXPECT_TRUE(entries.pushBack(i));
+    EXPECT_FALSE(entries.pushBack(i));
+    EXPECT_EQ(entries.set().size(), (size_t)(i + 1));
+  }
+  for (auto i : c10::irange(num - 1)) {
+    EXPECT_EQ(entries.erase(num - 1 - i), 1);
+    EXPECT_EQ(entries.erase(num - 1 - i), 0);
+    EXPECT_FALSE(entries.has(num - 1 - i));
+    EXPECT_TRUE(entries.has(0));
+    EXPECT_EQ(entries.set().size(), (size_t)(num - 1 - i));
+  }
+
+  DisjointSets<int> sets;
+  for (auto i : c10::irange(num)) {
+    sets.initializeSet(i);
+  }
+  // Merges the odd entries, 1 first, and leaves the even ones alone
+  for (int i = 3; i < num; i += 2) {
+    sets.mapEntries(1, i);
+  }
+  EXPECT_EQ(sets.size(), num / 2 + 1);
+  ASSERT_EQ(sets.disjointSets().size(), (size_t)(num / 2 + 1));
+  for (auto i : c10::irange(num / 2)) {
+    EXPECT_EQ(sets.disjointSets().at(i)->vector(), std::vector<int>{2 * i});
+  }
+  const auto& odd = *sets.disjointSets().back();
+  ASSERT_EQ(odd.size(), num / 2);
+  for (auto i : c10::irange(num / 2)) {
+    EXPECT_EQ(odd.at(i), 2 * i + 1);
+  }
+  EXPECT_EQ(&sets.getDisjointSetOf(num - 1), &odd);
+
+  DisjointSets<int> copy(sets);
+  EXPECT_TRUE(sets.erase(0));
+  EXPECT_EQ(sets.size(), num / 2);
+  EXPECT_EQ(copy.size(), num / 2 + 1);
+  EXPECT_EQ(sets.disjointSets().front()->front(), 2);
+  EXPECT_EQ(copy.disjointSets().front()->front(), 0);
+}
+
 TEST_F(NVFuserTest, FusionNonUniqueBroadcastSize_CUDA) {
   Fusion fusion;
   FusionGuard fg(&fusion);
@@ -2389,6 +2435,49 @@ TEST_F(NVFuserTest, FusionBlockWelfordOp_CUDA) {
       __FILE__);
 }
 
+// With static sizes matching the block size, the block welford is not
+// predicated and its input N is always 1, so N is not kept in shared memory
+TEST_F(NVFuserTest, FusionBlockWelfordUniformN_CUDA) {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto options_int = at::TensorOptions().dtype(at::kLong).device(at::kCUDA, 0);
+
+  const int64_t M = 64;
+  for (int64_t N : {96, 128}) {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+
+    auto tv0 = makeConcreteTensor({M, N});
+    fusion.addInput(tv0);
+    auto tv1 = mul(tv0, IrBuilder::create<Val>(1.0));
+    auto tvs = Welford(tv1, {1});
+    fusion.addOutput(tvs.avg);
+    fusion.addOutput(tvs.var_sum);
+    fusion.addOutput(tvs.n);
+
+    tvs.avg->axis(0)->parallelize(ParallelType::BIDx);
+    tvs.avg->axis(-1)->parallelize(ParallelType::TIDx);
+
+    tv1->computeAt(tvs.avg, -1);
+
+    at::Tensor t0 = at::randn({M, N}, options);
+
+    KernelExecutor ke;
+    ke.compile(&fusion, {t0});
+    EXPECT_THAT(ke.kernelString(), testing::HasSubstr("blockWelfordUniformN<"));
+    auto outputs = ke.run({t0});
+
+    outputs[1] /= N;
+
+    testValidate(
+        ke.kernel(),
+        outputs,
+        {t0},
+        {t0.mean({1}), t0.var({1}, false), at::ones({M}, options_int) * N},
+        __LINE__,
+        __FILE__);
+  }
+}
+
 TEST_F(NVFuserTest, FusionGridWelfordOp_CUDA) {
   Fusion fusion;
   FusionGuard fg(&fusion);
@@ -4604,6 +4693,118 @@ TEST_F(NVFuserTest, FusionValidateParallelize7_CUDA) {
       "Grid sync not found");
 }
 
+// The grid sync clears its semaphore, so the sync buffer is taken from reused
+// zeroed memory on every launch
+TEST_F(NVFuserTest, ResettingGridSync) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::ResettingGridSync);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+
+  auto tv1 = set(tv0);
+  auto tv2 = set(tv1);
+  fusion.addOutput(tv2);
+
+  tv1->setMemoryType(MemoryType::Global);
+
+  tv1->axis(0)->parallelize(ParallelType::BIDx);
+  tv1->axis(1)->parallelize(ParallelType::TIDx);
+  tv2->axis(1)->parallelize(ParallelType::TIDy);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({8, 32}, options);
+
+  KernelExecutor ke;
+  ke.compile(&fusion, {t0});
+  EXPECT_THAT(ke.kernelString(), testing::HasSubstr("resettingSync"));
+  for (auto i : c10::irange(3)) {
+    (void)i; // Suppress unused variable warning
+    auto cg_outputs = ke.run({t0});
+    testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+  }
+}
+
+// Threads only communicate within a warp through shared memory, so the RAW
+// sync is a warp sync
+TEST_F(NVFuserTest, WarpSync) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::WarpSync);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigConcreteTensor({8, 16});
+  fusion.addInput(tv0);
+
+  auto tv1 = set(tv0);
+  auto tv2 = set(tv1);
+  fusion.addOutput(tv2);
+
+  tv1->setMemoryType(MemoryType::Shared);
+
+  tv1->axis(0)->parallelize(ParallelType::TIDy);
+  tv1->axis(1)->parallelize(ParallelType::TIDx);
+  tv2->axis(0)->parallelize(ParallelType::TIDy);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({8, 16}, options);
+
+  KernelExecutor ke;
+  ke.compile(&fusion, {t0});
+  EXPECT_THAT(ke.kernelString(), testing::HasSubstr("__syncwarp();"));
+  EXPECT_THAT(
+      ke.kernelString(), testing::Not(testing::HasSubstr("__syncthreads();")));
+  auto cg_outputs = ke.run({t0});
+  testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
+TEST_F(NVFuserTest, CompactTensorArgs) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::CompactTensorArgs);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(2);
+  auto tv2 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  fusion.addInput(tv2);
+  auto tv3 = add(tv0, tv1);
+  auto tv4 = add(tv3, tv2);
+  fusion.addOutput(tv4);
+
+  tv4->merge(0);
+  tv4->split(0, 128);
+  TransformPropagatorWithCheck propagator(tv4);
+  MaxLogicalDomainInfoSpanningTree(tv4).traverse(&propagator);
+  tv4->axis(0)->parallelize(ParallelType::BIDx);
+  tv4->axis(1)->parallelize(ParallelType::TIDx);
+  scheduler_utils::parallelizeAllLike(tv4);
+  inlineMost();
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({32, 64}, options);
+  at::Tensor t1 = at::randn({32, 64}, options);
+  at::Tensor t2 = at::randn({64, 32}, options).t();
+  std::vector<c10::IValue> inputs = {t0, t1, t2};
+
+  KernelExecutor ke;
+  ke.compile(&fusion, inputs);
+  // Only T0 provides the extents, and only the non-contiguous T2 needs its
+  // strides
+  EXPECT_THAT(ke.kernelString(), testing::HasSubstr("Tensor<float, 2, 0> T0"));
+  EXPECT_THAT(ke.kernelString(), testing::HasSubstr("Tensor<float, 0, 0> T1"));
+  EXPECT_THAT(ke.kernelString(), testing::HasSubstr("Tensor<float, 0, 2> T2"));
+  auto cg_outputs = ke.run(inputs);
+  testValidate(&fusion, cg_outputs, inputs, __LINE__, __FILE__);
+}
+
 // From issue #1880
 TEST_F(NVFuserTest, FusionValidateParallelize8_CUDA) {
   Fusion fusion;
@@ -3202,6 +3202,45 @@ TEST_F(NVFuserTest, FusionTransformPropagatorNoOverwrite_CUDA) {
   NVF_CHECK(TransformReplay::fullSelfMatching(expect, tv1));
 }
 
+// Propagating again, after transforming the tail of the reference, gives the
+// same schedule with memoized matched positions
+TEST_F(NVFuserTest, FusionTransformPropagatorMemoized_CUDA) {
+  auto schedule = [](bool memoize) {
+    EnableOptionsGuard opt_guard;
+    if (memoize) {
+      EnableOptionsGuard::getCurOptions().set(
+          EnableOption::MemoizeTransformReplay);
+    }
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+
+    auto tv0 = makeSymbolicTensor(2);
+    fusion.addInput(tv0);
+    auto tv1 = sin(tv0);
+    auto tv2 = sum(tv1, {1});
+    auto tv3 = broadcast(tv2, {false, true});
+    auto tv4 = add(tv3, tv1);
+    fusion.addOutput(tv4);
+
+    tv4->merge(0);
+    tv4->split(0, 128);
+    for ([[maybe_unused]] auto i : c10::irange(2)) {
+      TransformPropagatorWithCheck propagator(tv4);
+      MaxLogicalDomainInfoSpanningTree(tv4).traverse(&propagator);
+    }
+    tv4->split(1, 4);
+    TransformPropagatorWithCheck propagator(tv4);
+    MaxLogicalDomainInfoSpanningTree(tv4).traverse(&propagator);
+
+    std::vector<std::string> tvs;
+    for (auto tv : fusion.allTvs()) {
+      tvs.push_back(tv->toString());
+    }
+    return tvs;
+  };
+  EXPECT_EQ(schedule(true), schedule(false));
+}
+
 TEST_F(NVFuserTest, FusionIssue1785Repro_CUDA) {
   Fusion fusion;
   FusionGuard fg(&fusion);
@@ -3424,6 +3463,72 @@ TEST_F(NVFuserTest, FusionInsertMagicZero1_CUDA) {
       tv2->toString());
 }
 
+// Same as FusionInsertMagicZero1, where the unrolled loop is predicated, so
+// its predicates are still protected when unnecessary magic zeros are pruned
+TEST_F(NVFuserTest, FusionPruneMagicZeroPredicated_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::PruneMagicZero);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+
+  auto tv1 = add(tv0, IrBuilder::create<Val>(1.0));
+  auto tv2 = set(tv1);
+  fusion.addOutput(tv2);
+
+  tv2->split(0, 32);
+  tv2->split(-1, 2);
+  tv2->reorder({{1, 2}, {2, 1}});
+  tv2->merge(0);
+
+  TransformPropagatorWithCheck propagator(tv2);
+  MaxLogicalDomainInfoSpanningTree(tv2).traverse(&propagator);
+
+  tv0->computeAt(tv2, 1);
+
+  GpuLower gpulw(&fusion);
+  gpulw.run();
+  EXPECT_TRUE(PredicateMagicZeroChecker::isProtected(tv2, gpulw));
+}
+
+// The sizes are divisible by the splits, so nothing in the unrolled loop is
+// predicated and magic zero is not used at all
+TEST_F(NVFuserTest, FusionPruneMagicZeroUnpredicated_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::PruneMagicZero);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigConcreteTensor({1024, 4});
+  fusion.addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Val>(1.0));
+  auto tv2 = set(tv1);
+  fusion.addOutput(tv2);
+
+  tv2->split(0, 128);
+  TransformPropagatorWithCheck propagator(tv2);
+  MaxLogicalDomainInfoSpanningTree(tv2).traverse(&propagator);
+  tv2->axis(0)->parallelize(ParallelType::BIDx);
+  tv2->axis(1)->parallelize(ParallelType::TIDx);
+  scheduler_utils::parallelizeAllLike(tv2);
+  inlineMost();
+
+  GpuLower gpulw(&fusion);
+  const std::string code = codegen::generateCudaKernel(gpulw.run());
+  EXPECT_THAT(code, testing::Not(testing::HasSubstr("nvfuser_zero")));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 4}, options);
+  KernelExecutor ke;
+  ke.compile(&fusion, {t0});
+  auto cg_outputs = ke.run({t0});
+  testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
 TEST_F(NVFuserTest, FusionExpandRepro1860_CUDA) {
   auto fusion_ptr = std::make_unique<Fusion>();
   Fusion& fusion = *fusion_ptr;
@@ -9384,6 +9489,290 @@ TEST_F(NVFuserTest, CastPrecision) {
   ASSERT_FALSE(tv4_precision.has_value());
 }
 
+// Kernels compiled with the preamble as a precompiled header, including
+// kernels whose preambles differ in their index type
+TEST_F(NVFuserTest, PrecompiledPreamble) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::PrecompiledPreamble);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Val>(1.0));
+  fusion.addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({32, 64}, options);
+
+  for (auto index_type : {PrimDataType::Int, PrimDataType::Int32}) {
+    // Compile twice so the second kernel uses the precompiled preamble
+    for ([[maybe_unused]] auto i : c10::irange(2)) {
+      KernelExecutor ke;
+      CompileParams compile_params;
+      compile_params.index_type = index_type;
+      ke.compile(&fusion, {t0}, LaunchParams(), compile_params);
+#if CUDA_VERSION >= 12080
+      EXPECT_THAT(
+          ke.compiledKernel().compile_args, testing::HasSubstr("--pch"));
+#endif
+      auto outputs = ke.run({t0});
+      testValidate(&fusion, outputs, {t0}, __LINE__, __FILE__);
+    }
+  }
+}
+
+// Identical kernels compiled by different KernelExecutors, possibly on
+// different devices, share the binary compiled by NVRTC
+TEST_F(NVFuserTest, CompiledBinaryCache) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = mul(tv0, IrBuilder::create<Val>(2.0));
+  fusion.addOutput(tv1);
+
+  const int64_t num_devices = std::min<int64_t>(at::cuda::getNumGPUs(), 2);
+  std::vector<std::vector<char>> binaries;
+  for (auto device : c10::irange(num_devices)) {
+    for ([[maybe_unused]] auto i : c10::irange(2)) {
+      auto options =
+          at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, device);
+      at::Tensor t0 = at::randn({32, 64}, options);
+      KernelExecutor ke;
+      ke.compile(&fusion, {t0});
+      const auto& compiled_kernel = ke.compiledKernel();
+      binaries.push_back(
+          compiled_kernel.cubin.empty() ? compiled_kernel.ptx
+                                        : compiled_kernel.cubin);
+      auto outputs = ke.run({t0});
+      testValidate(&fusion, outputs, {t0}, __LINE__, __FILE__);
+    }
+  }
+  EXPECT_EQ(binaries.at(0), binaries.at(1));
+}
+
+// Kernels of structurally identical fusions share a binary even though their
+// kernel and tensor names differ
+TEST_F(NVFuserTest, CompiledBinaryCacheStructurallyIdentical) {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({32, 64}, options);
+
+  std::vector<std::string> lowered_names;
+  for (auto fusion_id : c10::irange(2)) {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+    // Shift the names of the tensors of the second fusion
+    if (fusion_id == 1) {
+      makeSymbolicTensor(2);
+    }
+    auto tv0 = makeSymbolicTensor(2);
+    fusion.addInput(tv0);
+    auto tv1 = sin(tv0);
+    auto tv2 = mul(tv1, IrBuilder::create<Val>(3.0));
+    fusion.addOutput(tv2);
+
+    KernelExecutor ke(fusion_id);
+    ke.compile(&fusion, {t0});
+    lowered_names.push_back(ke.compiledKernel().kernel_name);
+    auto outputs = ke.run({t0});
+    testValidate(&fusion, outputs, {t0}, __LINE__, __FILE__);
+  }
+  EXPECT_EQ(lowered_names.at(0), lowered_names.at(1));
+}
+
+// A pointwise kernel leaves the reduction and RNG helpers out of its
+// preamble, which a reduction kernel includes
+TEST_F(NVFuserTest, MinimalPreamble) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::MinimalPreamble);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 1024}, options);
+
+  for (bool reduce : {false, true}) {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+    auto tv0 = makeSymbolicTensor(2);
+    fusion.addInput(tv0);
+    auto tv1 = sin(tv0);
+    if (reduce) {
+      tv1 = sum(tv1, {1});
+      tv1->axis(0)->parallelize(ParallelType::BIDx);
+      tv1->axis(1)->parallelize(ParallelType::TIDx);
+    }
+    fusion.addOutput(tv1);
+
+    KernelExecutor ke;
+    ke.compile(&fusion, {t0});
+    const std::string code = ke.getStructuredCode();
+    EXPECT_THAT(code, testing::Not(testing::HasSubstr("philox")));
+    EXPECT_THAT(code, testing::Not(testing::HasSubstr("welfordCombine")));
+    if (reduce) {
+      EXPECT_THAT(code, testing::HasSubstr("void blockReduce("));
+    } else {
+      EXPECT_THAT(code, testing::Not(testing::HasSubstr("blockReduce")));
+    }
+    auto outputs = ke.run({t0});
+    testValidate(&fusion, outputs, {t0}, __LINE__, __FILE__);
+  }
+}
+
+// Inputs are only validated on the first launch of an executor entry. Later
+// launches with new data, and launches of new shapes, still give the right
+// results.
+TEST_F(NVFuserTest, CachedInputValidation) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeSymbolicTensor(2);
+  auto tv1 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  auto tv2 = add(tv0, tv1);
+  fusion->addOutput(tv2);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (auto sizes : {std::vector<int64_t>{32, 64},
+                     std::vector<int64_t>{32, 64},
+                     std::vector<int64_t>{64, 32},
+                     std::vector<int64_t>{32, 64}}) {
+    at::Tensor t0 = at::randn(sizes, options);
+    at::Tensor t1 = at::randn(sizes, options);
+    auto outputs = executor_cache.runFusionWithInputs({t0, t1});
+    testValidate(
+        executor_cache.fusion(),
+        outputs,
+        {t0, t1},
+        {t0 + t1},
+        __LINE__,
+        __FILE__);
+  }
+}
+
+#if (CUDA_VERSION >= 12000)
+// Kernels loaded as libraries are shared by the executors of all devices and
+// loaded on a device when they are first launched there
+TEST_F(NVFuserTest, LazyKernelLoading) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::LazyKernelLoading);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = mul(tv0, IrBuilder::create<Val>(2.0));
+  fusion.addOutput(tv1);
+
+  const int64_t num_devices = std::min<int64_t>(at::cuda::getNumGPUs(), 2);
+  std::vector<std::unique_ptr<KernelExecutor>> executors;
+  for (auto device : c10::irange(num_devices)) {
+    for ([[maybe_unused]] auto i : c10::irange(2)) {
+      auto options =
+          at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, device);
+      at::Tensor t0 = at::randn({32, 64}, options);
+      auto& ke = executors.emplace_back(std::make_unique<KernelExecutor>());
+      ke->compile(&fusion, {t0});
+      const auto& compiled_kernel = ke->compiledKernel();
+      EXPECT_EQ(compiled_kernel.module, nullptr);
+      ASSERT_NE(compiled_kernel.library, nullptr);
+      EXPECT_EQ(
+          compiled_kernel.library, executors.front()->compiledKernel().library);
+      auto outputs = ke->run({t0});
+      testValidate(&fusion, outputs, {t0}, __LINE__, __FILE__);
+    }
+  }
+}
+#endif
+
+// Running the independent analyses of the lowering concurrently gives the
+// same kernel
+TEST_F(NVFuserTest, ParallelLowering) {
+  auto make_fusion = []() {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    auto tv0 = makeSymbolicTensor(2);
+    fusion->addInput(tv0);
+    auto tv1 = sum(sin(tv0), {1});
+    auto tv2 = add(tv0, broadcast(tv1, {false, true}));
+    fusion->addOutput(tv2);
+
+    tv1->split(1, 128);
+    tv1->axis(-1)->parallelize(ParallelType::TIDx);
+    tv1->axis(0)->parallelize(ParallelType::BIDx);
+    TransformPropagatorWithCheck propagator(tv1);
+    MaxLogicalDomainInfoSpanningTree(tv1).traverse(&propagator);
+    scheduler_utils::parallelizeAllLike(tv1);
+    inlineMost();
+    return fusion;
+  };
+
+  std::vector<std::string> kernels;
+  for (bool parallel : {false, true}) {
+    EnableOptionsGuard opt_guard;
+    if (parallel) {
+      EnableOptionsGuard::getCurOptions().set(EnableOption::ParallelLowering);
+    }
+    auto fusion = make_fusion();
+    FusionGuard fg(fusion.get());
+    GpuLower lower(fusion.get());
+    kernels.push_back(codegen::generateCudaKernel(lower.run()));
+  }
+  EXPECT_EQ(kernels.at(0), kernels.at(1));
+}
+
+// A block reduction whose bdimx is fixed by the launch constraints is
+// specialized for it, so the kernel doesn't read blockDim
+TEST_F(NVFuserTest, FusionStaticBlockDim_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::StaticBlockDim);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  fusion.addOutput(tv1);
+
+  tv1->split(1, NamedScalar::getParallelDim(ParallelType::TIDx));
+  auto tv2 = tv1->rFactor({1});
+  for (auto tv : {tv1, tv2}) {
+    tv->axis(0)->parallelize(ParallelType::BIDx);
+    tv->axis(-1)->parallelize(ParallelType::TIDx);
+  }
+  inlineMost();
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({37, 1000}, options);
+
+  auto lparams = LaunchParams(-1, -1, -1, 128, -1, -1);
+  KernelExecutor ke;
+  ke.compile(&fusion, {t0}, lparams);
+  auto cg_outputs = ke.run({t0}, lparams);
+
+  EXPECT_THAT(
+      ke.kernelString(),
+      testing::HasSubstr("__launch_bounds__(/*MAX_THREADS_PER_BLOCK=*/128"));
+  EXPECT_THAT(
+      ke.kernelString(), testing::HasSubstr("StaticBlockDim<128, 1, 1>()"));
+  EXPECT_THAT(
+      ke.kernelString(), testing::Not(testing::HasSubstr("blockDim")));
+
+  testValidate(
+      &fusion,
+      cg_outputs,
+      {t0},
+      {t0.sum({1})},
+      __LINE__,
+      __FILE__,
+      "",
+      lparams);
+}
+
 // Test file size should be up to 10K LoC. Create a new file for more tests.
 
 } // namespace nvfuser
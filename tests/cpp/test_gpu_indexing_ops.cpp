@@ -10,6 +10,7 @@
 
 #include <ops/all_ops.h>
 #include <runtime/fusion_executor_cache.h>
+#include <scheduler/pointwise_heuristic.h>
 #include <tests/cpp/utils.h>
 #include <tests/cpp/validator.h>
 
@@ -671,4 +672,83 @@ TEST_F(NVFuserTest, MultipleIndexSelectIssue_CUDA) {
   testValidate(&fusion, outputs, aten_inputs, __LINE__, __FILE__);
 }
 
+// The rows of an embedding table are gathered with vectorized loads, one
+// block row of threads per gathered row
+TEST_F(NVFuserTest, IndexSelectVectorizedLookup_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  TensorView* tv0 = makeContigTensor(2);
+  TensorView* tv_idx = makeContigTensor(1, DataType::Int);
+  fusion.addInput(tv0);
+  fusion.addInput(tv_idx);
+  TensorView* tv1 = indexSelect(tv0, 0, tv_idx);
+  TensorView* tv2 = mul(tv1, IrBuilder::create<Val>(2.0));
+  fusion.addOutput(tv2);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto options_i = at::TensorOptions().dtype(at::kLong).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1000, 256}, options);
+  at::Tensor t_idx = at::randint(0, 1000, {4096}, options_i);
+  std::vector<c10::IValue> aten_inputs = {t0, t_idx};
+
+  auto cg_results =
+      scheduleAndRun(&fusion, SchedulerType::PointWise, aten_inputs);
+  auto pparams = cg_results.heuristic_params->as<PointwiseParams>();
+  EXPECT_TRUE(pparams->vectorize_lookup);
+  EXPECT_EQ(pparams->break_point, 1);
+  EXPECT_EQ(pparams->vectorization_factor, 4);
+  EXPECT_TRUE(std::any_of(
+      tv1->getLoopDomain().begin(),
+      tv1->getLoopDomain().end(),
+      [](IterDomain* id) {
+        return id->getParallelType() == ParallelType::Vectorize;
+      }));
+  testValidate(&fusion, cg_results.outputs, aten_inputs, __LINE__, __FILE__);
+}
+
+// Decoding attention reads the keys of each sequence from a paged KV cache
+TEST_F(NVFuserTest, GatherPages_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  constexpr int64_t num_pages = 64, page_size = 16, h = 4, e = 32;
+  constexpr int64_t b = 3, pages_per_sequence = 5;
+  TensorView* pages = makeContigConcreteTensor({num_pages, page_size, h, e});
+  TensorView* block_table =
+      makeContigConcreteTensor({b, pages_per_sequence}, DataType::Int);
+  TensorView* q = makeContigConcreteTensor({b, 1, h, e});
+  fusion.addInput(pages);
+  fusion.addInput(block_table);
+  fusion.addInput(q);
+  TensorView* k = gatherPages(pages, block_table);
+  TensorView* scores = sum(mul(k, q), {-1});
+  fusion.addOutput(scores);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto options_i = at::TensorOptions().dtype(at::kLong).device(at::kCUDA, 0);
+  at::Tensor t_pages = at::randn({num_pages, page_size, h, e}, options);
+  at::Tensor t_block_table =
+      at::randperm(num_pages, options_i)
+          .slice(0, 0, b * pages_per_sequence)
+          .view({b, pages_per_sequence});
+  at::Tensor t_q = at::randn({b, 1, h, e}, options);
+  std::vector<c10::IValue> aten_inputs = {t_pages, t_block_table, t_q};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  at::Tensor t_k = t_pages.index_select(0, t_block_table.flatten())
+                       .view({b, pages_per_sequence * page_size, h, e});
+  testValidate(
+      executor_cache.fusion(),
+      outputs,
+      aten_inputs,
+      {(t_k * t_q).sum({-1})},
+      __LINE__,
+      __FILE__);
+}
+
 } // namespace nvfuser
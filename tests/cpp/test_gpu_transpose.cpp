@@ -1352,4 +1352,61 @@ TEST_F(TransposeTest, ReductionIterDomainOnInputsIssue1659) {
   testValidate(fusion_ptr, cg_outputs, {t0, t1}, __LINE__, __FILE__);
 }
 
+// Rows of tiles longer than a wave are swizzled so that a wave covers a
+// square of tiles
+TEST_F(TransposeTest, GridSwizzle) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::GridSwizzle);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = transpose(tv0, 0, 1);
+  fusion->addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({512, 1 << 17}, options);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto cg_outputs = executor_cache.runFusionWithInputs({t0});
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  auto heuristic_params =
+      runtime->schedulerHeuristics()->heuristicsList().at(0).get();
+  ASSERT_EQ(heuristic_params->scheduler_type, SchedulerType::Transpose);
+  EXPECT_GT(heuristic_params->as<TransposeParams>()->grid_swizzle_factor, 1);
+
+  EXPECT_TRUE(t0.transpose(0, 1).equal(cg_outputs.at(0)));
+}
+
+// Both groups share the small inner-most dim, as in a [B, S, H, D] to
+// [B, H, S, D] permute of attention heads, which is tiled along with it
+TEST_F(TransposeTest, SharedInnerMostDim) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(4);
+  fusion->addInput(tv0);
+  auto tv1 = permute(tv0, {0, 2, 1, 3});
+  fusion->addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({4, 512, 16, 8}, options);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto cg_outputs = executor_cache.runFusionWithInputs({t0});
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  auto heuristic_params =
+      runtime->schedulerHeuristics()->heuristicsList().at(0).get();
+  ASSERT_EQ(heuristic_params->scheduler_type, SchedulerType::Transpose);
+  EXPECT_EQ(heuristic_params->as<TransposeParams>()->shared_inner_size, 8);
+
+  EXPECT_TRUE(t0.permute({0, 2, 1, 3}).equal(cg_outputs.at(0)));
+}
+
 } // namespace nvfuser
@@ -0,0 +1,142 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <gmock/gmock-matchers.h>
+#include <gtest/gtest.h>
+
+#include <fusion.h>
+#include <ops/all_ops.h>
+#include <scheduler/heuristic_plugin.h>
+#include <scheduler/heuristic_plugin_api.h>
+#include <scheduler/reduction_heuristic.h>
+#include <scheduler/transpose_heuristic.h>
+#include <tests/cpp/utils.h>
+#include <tests/cpp/validator.h>
+
+#include <string>
+
+namespace nvfuser {
+
+using namespace heuristic_plugin;
+
+using HeuristicPluginTest = NVFuserTest;
+
+// The plugin sees the reduction problem and the analytical parameters, and
+// its parameters are used to schedule the kernel
+TEST_F(HeuristicPluginTest, Reduction) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  fusion->addOutput(tv1);
+
+  ProblemDescription seen_problem;
+  ConfigureHeuristicGuard guard(
+      [&seen_problem](
+          const ProblemDescription* problem, HeuristicConfig* config) {
+        seen_problem = *problem;
+        if (!config->reduction.vectorize_inner_reduction) {
+          return false;
+        }
+        config->reduction.unroll_factor_inner_reduction = 2;
+        return true;
+      });
+  EXPECT_TRUE(hasPlugin());
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 4096}, options);
+  auto cg_results =
+      scheduleAndRun(fusion.get(), SchedulerType::Reduction, {t0});
+  testValidate(
+      fusion.get(), cg_results.outputs, {t0}, __LINE__, __FILE__);
+
+  EXPECT_EQ(seen_problem.api_version, kApiVersion);
+  EXPECT_EQ(seen_problem.scheduler, SchedulerKind::Reduction);
+  ASSERT_EQ(seen_problem.num_dims, 2);
+  EXPECT_EQ(seen_problem.extents[0], 1024);
+  EXPECT_EQ(seen_problem.extents[1], 4096);
+  EXPECT_EQ(seen_problem.reduction_axes, 0b10);
+  EXPECT_EQ(seen_problem.total_reduction_numel, 4096);
+  EXPECT_EQ(seen_problem.total_iteration_numel, 1024);
+  EXPECT_TRUE(seen_problem.fastest_dim_reduction);
+  EXPECT_EQ(std::string(seen_problem.input_dtypes), "S");
+  EXPECT_EQ(std::string(seen_problem.output_dtypes), "S");
+  EXPECT_EQ(seen_problem.max_vectorize_factor, 4);
+
+  auto rparams = cg_results.heuristic_params->as<ReductionParams>();
+  if (rparams->vectorize_inner_reduction) {
+    EXPECT_EQ(rparams->unroll_factor_inner_reduction, 2);
+  }
+}
+
+// Vectorization wider than the problem allows is rejected
+TEST_F(HeuristicPluginTest, InvalidVectorization) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  fusion->addOutput(tv1);
+
+  ConfigureHeuristicGuard guard(
+      [](const ProblemDescription* problem, HeuristicConfig* config) {
+        config->reduction.vectorize_inner_reduction = true;
+        config->reduction.unroll_factor_inner_reduction =
+            problem->max_vectorize_factor * 2;
+        return true;
+      });
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 4096}, options);
+  EXPECT_THAT(
+      [&]() { scheduleAndRun(fusion.get(), SchedulerType::Reduction, {t0}); },
+      testing::ThrowsMessage<nvfuser::nvfError>(
+          testing::HasSubstr("exceeds the maximum")));
+}
+
+TEST_F(HeuristicPluginTest, Transpose) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sin(tv0);
+  auto tv2 = transpose(tv1, 0, 1);
+  fusion->addOutput(tv2);
+
+  ProblemDescription seen_problem;
+  ConfigureHeuristicGuard guard(
+      [&seen_problem](
+          const ProblemDescription* problem, HeuristicConfig* config) {
+        seen_problem = *problem;
+        config->transpose.vectorize_factor1 = 1;
+        config->transpose.vectorize_factor2 = 1;
+        return true;
+      });
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({512, 1024}, options);
+  auto cg_results =
+      scheduleAndRun(fusion.get(), SchedulerType::Transpose, {t0});
+  testValidate(
+      fusion.get(), cg_results.outputs, {t0}, __LINE__, __FILE__);
+
+  EXPECT_EQ(seen_problem.scheduler, SchedulerKind::Transpose);
+  ASSERT_EQ(seen_problem.num_dims, 2);
+  EXPECT_EQ(seen_problem.extents[0], 1024);
+  EXPECT_EQ(seen_problem.extents[1], 512);
+  EXPECT_EQ(seen_problem.reduction_axes, 0);
+
+  auto tparams = cg_results.heuristic_params->as<TransposeParams>();
+  EXPECT_EQ(tparams->vectorize_factor1, 1);
+  EXPECT_EQ(tparams->vectorize_factor2, 1);
+}
+
+} // namespace nvfuser
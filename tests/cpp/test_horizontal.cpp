@@ -0,0 +1,136 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <gtest/gtest.h>
+
+#include <fusion.h>
+#include <ops/all_ops.h>
+#include <options.h>
+#include <runtime/fusion_executor_cache.h>
+#include <runtime/fusion_kernel_runtime.h>
+#include <scheduler/horizontal_heuristic.h>
+#include <tests/cpp/utils.h>
+#include <tests/cpp/validator.h>
+
+namespace nvfuser {
+
+using HorizontalTest = NVFuserTest;
+
+namespace {
+
+// An SGD with momentum update of one parameter:
+//   momentum = 0.9 * momentum + grad
+//   param = param - lr * momentum
+void addMomentumUpdate(Fusion* fusion, Val* lr, int64_t ndims) {
+  TensorView* param = makeContigTensor(ndims);
+  TensorView* grad = makeContigTensor(ndims);
+  TensorView* momentum = makeContigTensor(ndims);
+  fusion->addInput(param);
+  fusion->addInput(grad);
+  fusion->addInput(momentum);
+  TensorView* new_momentum =
+      add(mul(momentum, IrBuilder::create<Val>(0.9)), grad);
+  TensorView* new_param = sub(param, mul(new_momentum, lr));
+  fusion->addOutput(new_param);
+  fusion->addOutput(new_momentum);
+}
+
+} // namespace
+
+// The updates of parameters of different shapes share a single kernel
+TEST_F(HorizontalTest, OptimizerStep) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  Val* lr = IrBuilder::create<Val>(DataType::Double);
+  fusion->addInput(lr);
+  const std::vector<std::vector<int64_t>> shapes = {
+      {4096}, {63, 33}, {8, 16, 32}};
+  for (const auto& shape : shapes) {
+    addMomentumUpdate(fusion.get(), lr, (int64_t)shape.size());
+  }
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<c10::IValue> inputs = {0.01};
+  for (const auto& shape : shapes) {
+    for (auto i : c10::irange(3)) {
+      (void)i; // Suppress unused variable warning
+      inputs.push_back(at::randn(shape, options));
+    }
+  }
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs(inputs);
+  testValidate(executor_cache.fusion(), outputs, inputs, __LINE__, __FILE__);
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_FALSE(runtime->isSegmented());
+  const auto& heuristics = runtime->schedulerHeuristics()->heuristicsList();
+  ASSERT_EQ(heuristics.size(), 1);
+  EXPECT_EQ(heuristics.at(0)->scheduler_type, SchedulerType::Horizontal);
+  auto hparams = heuristics.at(0)->as<HorizontalParams>();
+  // The odd number of elements of the second parameter prevents its
+  // vectorization
+  EXPECT_EQ(hparams->vectorization_factors, std::vector<int64_t>({4, 1, 4}));
+}
+
+// Independent subgraphs are scheduled separately when horizontal fusion is
+// disabled or when one of them is not pointwise
+TEST_F(HorizontalTest, Rejected) {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 64}, options);
+  at::Tensor t1 = at::randn({256}, options);
+
+  {
+    DisableOptionsGuard opt_guard;
+    DisableOptionsGuard::getCurOptions().set(DisableOption::HorizontalFusion);
+
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    TensorView* tv0 = makeContigTensor(2);
+    TensorView* tv1 = makeContigTensor(1);
+    fusion->addInput(tv0);
+    fusion->addInput(tv1);
+    fusion->addOutput(sin(tv0));
+    fusion->addOutput(cos(tv1));
+
+    FusionExecutorCache executor_cache(std::move(fusion));
+    auto outputs = executor_cache.runFusionWithInputs({t0, t1});
+    testValidate(
+        executor_cache.fusion(), outputs, {t0, t1}, __LINE__, __FILE__);
+    EXPECT_EQ(
+        executor_cache.getMostRecentKernelRuntime()
+            ->fusionSegments()
+            ->groups()
+            .size(),
+        2);
+  }
+
+  {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    TensorView* tv0 = makeContigTensor(2);
+    TensorView* tv1 = makeContigTensor(1);
+    fusion->addInput(tv0);
+    fusion->addInput(tv1);
+    fusion->addOutput(sum(tv0, {1}));
+    fusion->addOutput(cos(tv1));
+
+    FusionExecutorCache executor_cache(std::move(fusion));
+    auto outputs = executor_cache.runFusionWithInputs({t0, t1});
+    testValidate(
+        executor_cache.fusion(), outputs, {t0, t1}, __LINE__, __FILE__);
+    EXPECT_EQ(
+        executor_cache.getMostRecentKernelRuntime()
+            ->fusionSegments()
+            ->groups()
+            .size(),
+        2);
+  }
+}
+
+} // namespace nvfuser
@@ -585,6 +585,55 @@ TEST_F(StreamTest, ByIndex) {
   }
 }
 
+// A matmul is computed on a side stream and consumed on the original stream,
+// which only waits for it through an event, without blocking the host
+TEST_F(StreamTest, RecordAndWaitEvent) {
+  constexpr int64_t M = 512;
+  constexpr int64_t K = 1024;
+  constexpr int64_t N = 256;
+
+  auto hic = std::make_unique<HostIrContainer>();
+  FusionGuard fg(hic.get());
+
+  TensorView* a = makeContigTensor(2);
+  TensorView* b = makeContigTensor(2);
+  TensorView* c = makeContigTensor(2);
+  auto* matmul = IrBuilder::create<MatmulOp>(c, a, b);
+  TensorView* d = add(c, c);
+  hic->addInput(a);
+  hic->addInput(b);
+  hic->addInput(c);
+  hic->addOutput(d);
+
+  auto* get_stream = IrBuilder::create<GetCurrentStream>();
+  auto* record_event = IrBuilder::create<RecordEvent>();
+  std::vector<Expr*> top_level_exprs = {
+      get_stream,
+      IrBuilder::create<SetCurrentStream>(IrBuilder::create<Stream>()),
+      matmul,
+      record_event,
+      IrBuilder::create<SetCurrentStream>(get_stream->stream()),
+      IrBuilder::create<WaitEvent>(record_event),
+      d->definition()};
+  for (Expr* expr : top_level_exprs) {
+    hic->pushBackTopLevelExprs(expr);
+  }
+
+  HostIrEvaluator hie(std::move(hic));
+
+  auto options = at::TensorOptions().device(at::kCUDA, 0).dtype(torch::kFloat);
+  at::Tensor a_tensor = at::randn({M, K}, options);
+  at::Tensor b_tensor = at::randn({K, N}, options);
+  at::Tensor c_tensor = at::empty({M, N}, options);
+  // Running twice checks that the events are reused
+  for (int i = 0; i < 2; i++) {
+    at::Tensor output =
+        hie.runWithInput({{a, a_tensor}, {b, b_tensor}, {c, c_tensor}})
+            .at(0);
+    EXPECT_TRUE(output.allclose(at::matmul(a_tensor, b_tensor) * 2));
+  }
+}
+
 using StreamHostIrTestParams = std::tuple<bool, int, int>;
 using StreamHostIrTest = NVFuserFixtureParamTest<StreamHostIrTestParams>;
 
@@ -697,6 +746,72 @@ INSTANTIATE_TEST_SUITE_P(
       return ss.str();
     });
 
+using CudaGraphHostIrTest = NVFuserTest;
+
+// The host program posts a fusion on two streams and joins them back to the
+// default stream. Its first run is eager, its second run is captured into a
+// CUDA graph, and later runs replay the graph with new input data.
+TEST_F(CudaGraphHostIrTest, MultipleStreams) {
+  constexpr int64_t kNumStreams = 2;
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  std::vector<int64_t> input_sizes = {4, 8, 32};
+
+  auto tv0 = makeConcreteTensor(input_sizes);
+  auto tv1 = add(tv0, tv0);
+  auto tv2 = sum(tv1, {0});
+  fusion->addInput(tv0);
+  fusion->addOutput(tv2);
+
+  auto hic = std::make_unique<HostIrContainer>();
+  FusionGuard::setCurFusion(hic.get());
+  auto host_unit = IrBuilder::create<HostUnit>(std::move(fusion));
+
+  IrCloner ir_cloner_input(hic.get());
+  Val* input =
+      ir_cloner_input.clone(host_unit->fusion_to_execute()->inputs().at(0));
+  hic->addInput(input);
+
+  std::vector<Stream*> streams;
+  for (int64_t i = 0; i < kNumStreams; i++) {
+    streams.push_back(IrBuilder::create<Stream>());
+    IrCloner ir_cloner_output(hic.get());
+    std::vector<Val*> post_on_stream_outputs = {ir_cloner_output.clone(
+        host_unit->fusion_to_execute()->outputs().at(0))};
+    auto post_on_stream = IrBuilder::create<PostOnStream>(
+        host_unit, std::vector<Val*>{input}, post_on_stream_outputs);
+    hic->pushBackTopLevelExprs(
+        IrBuilder::create<SetCurrentStream>(streams.back()));
+    hic->pushBackTopLevelExprs(post_on_stream);
+    hic->addOutput(post_on_stream->outputs().at(0));
+  }
+  hic->pushBackTopLevelExprs(
+      IrBuilder::create<SetCurrentStream>(hic->getDefaultStream()));
+  for (Stream* stream : streams) {
+    hic->pushBackTopLevelExprs(IrBuilder::create<Synchronize>(stream));
+  }
+
+  HostIrEvaluatorParams params;
+  params.use_fusion_executor_cache = true;
+  params.use_cuda_graph = true;
+  HostIrEvaluator hie(std::move(hic), nullptr, params);
+
+  auto options = at::TensorOptions().device(at::kCUDA, 0);
+  setCurrentCUDAStream(c10::cuda::getDefaultCUDAStream(0));
+  for (int run = 0; run < 4; run++) {
+    at::Tensor t0 = at::randn(input_sizes, options);
+    auto ref_output = at::sum(t0 * 2, {0});
+
+    auto outputs = hie.runWithInput({{input, t0}});
+
+    ASSERT_EQ(outputs.size(), kNumStreams);
+    for (const auto& output : outputs) {
+      EXPECT_TRUE(torch::allclose(ref_output, output));
+    }
+  }
+}
+
 using SliceHostIrTestParams = bool;
 using SliceHostIrTest = NVFuserFixtureParamTest<SliceHostIrTestParams>;
 
@@ -1090,6 +1205,67 @@ TEST_F(AllocationTest, inHostForLoop) {
   EXPECT_EQ(sizes, outputs.at(0).sizes());
 }
 
+// With the allocation pool, the temporary buffer allocated in the loop body
+// is only allocated on the first run
+TEST_F(AllocationTest, PoolInHostForLoop) {
+  constexpr int64_t kForLoopStop = 4;
+  constexpr int64_t M = 64;
+  constexpr int64_t K = 128;
+
+  auto hic = std::make_unique<HostIrContainer>();
+  FusionGuard fg(hic.get());
+
+  auto* for_loop = IrBuilder::create<ForLoop>(
+      /*IterDomain=*/makeContigConcreteTensor({0})->axis(0), // unused
+      /*index=*/IrBuilder::create<Val>(DataType::Index),
+      /*start=*/hic->zeroVal(),
+      /*stop=*/IrBuilder::create<Val>(kForLoopStop, DataType::Index),
+      /*step=*/hic->oneVal(),
+      /*vectorize=*/false,
+      /*vectorize_shift=*/nullptr,
+      /*unroll_required=*/false,
+      CircularBufferLoopStage::NotApplicable,
+      /*circular_buffer_loop_stage_depth=*/0);
+
+  TensorView* a = makeContigConcreteTensor({M, K});
+  TensorView* b = makeContigConcreteTensor({K, K});
+  TensorView* c = makeContigConcreteTensor({M, K});
+  TensorView* tmp = makeContigConcreteTensor({M, K});
+  tmp->setMemoryType(MemoryType::Global);
+  for_loop->body().push_back(
+      IrBuilder::create<kir::Allocate>(tmp, MemoryType::Global));
+  for_loop->body().push_back(IrBuilder::create<MatmulOp>(tmp, a, b));
+  for_loop->body().push_back(IrBuilder::create<MatmulOp>(c, tmp, b));
+
+  hic->addInput(a);
+  hic->addInput(b);
+  hic->addInput(c);
+  hic->addOutput(c);
+  hic->pushBackTopLevelExprs(for_loop);
+
+  HostIrEvaluator hie(
+      std::move(hic), /*communicator=*/nullptr, {.use_allocation_pool = true});
+
+  auto options = at::TensorOptions().device(at::kCUDA, 0).dtype(torch::kFloat);
+  at::Tensor a_tensor = at::randn({M, K}, options);
+  at::Tensor b_tensor = at::randn({K, K}, options);
+  at::Tensor c_tensor = at::empty({M, K}, options);
+  auto num_allocations = []() {
+    return c10::cuda::CUDACachingAllocator::get()
+        ->getDeviceStats(0)
+        .allocation[0]
+        .allocated;
+  };
+
+  hie.runWithInput({{a, a_tensor}, {b, b_tensor}, {c, c_tensor}});
+  const int64_t num_allocations_after_first_run = num_allocations();
+  hie.runWithInput({{a, a_tensor}, {b, b_tensor}, {c, c_tensor}});
+
+  EXPECT_EQ(num_allocations(), num_allocations_after_first_run);
+  EXPECT_TRUE(c_tensor.allclose(
+      at::matmul(at::matmul(a_tensor, b_tensor), b_tensor), 1e-3, 1e-3));
+}
+
 } // namespace hir
 
 } // namespace nvfuser
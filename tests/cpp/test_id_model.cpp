@@ -2672,4 +2672,55 @@ TEST_F(IdModelTest, LoopGraphWithSetLoopDomain) {
   }
 }
 
+// Incrementally adding scheduling transforms should give the same
+// EXACT and BROADCAST graphs as building a new model
+TEST_F(IdModelTest, AddTransformsOf) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(1);
+  fusion.addInput(tv0);
+  auto tv1 = makeSymbolicTensor(2);
+  fusion.addInput(tv1);
+  auto tv2 = broadcast(tv0, {false, true});
+  auto tv3 = add(tv2, tv1);
+  fusion.addOutput(tv3);
+
+  IdModel id_model(&fusion, /*build_graphs=*/false);
+  id_model.buildBroadcastGraph();
+  id_model.buildPermissiveGraph();
+
+  tv3->merge(0)->split(0, 4);
+  TransformPropagator propagator(tv3);
+  MaxLogicalDomainInfoSpanningTree(tv3).traverse(&propagator);
+
+  for (auto tv : fusion.allTvs()) {
+    id_model.addTransformsOf(tv);
+  }
+  EXPECT_FALSE(id_model.hasIdGraph(IdMappingMode::PERMISSIVE));
+
+  IdModel ref_model(&fusion, /*build_graphs=*/false);
+  ref_model.buildBroadcastGraph();
+
+  std::vector<IterDomain*> all_ids;
+  for (auto tv : fusion.allTvs()) {
+    auto tv_ids = tv->domain()->allIDs();
+    all_ids.insert(all_ids.end(), tv_ids.begin(), tv_ids.end());
+  }
+
+  for (auto mode : {IdMappingMode::EXACT, IdMappingMode::BROADCAST}) {
+    const auto& graph = id_model.idGraph(mode).disjointValSets();
+    const auto& ref_graph = ref_model.idGraph(mode).disjointValSets();
+    for (auto id0 : all_ids) {
+      for (auto id1 : all_ids) {
+        EXPECT_EQ(
+            graph.strictAreMapped(id0, id1),
+            ref_graph.strictAreMapped(id0, id1))
+            << "Mismatched mapping of " << id0->toString() << " and "
+            << id1->toString() << " in " << mode;
+      }
+    }
+  }
+}
+
 } // namespace nvfuser
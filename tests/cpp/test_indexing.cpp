@@ -12,6 +12,9 @@
 #include <tests/cpp/utils.h>
 #include <tests/cpp/validator.h>
 
+#include <device_lower/lower2device.h>
+#include <device_lower/utils.h>
+#include <expr_evaluator.h>
 #include <fusion.h>
 #include <id_model/id_model.h>
 #include <id_model/indexing.h>
@@ -5666,4 +5669,52 @@ TEST_F(IndexingTest, BroadcastLogicalDomainIndexing) {
   testValidate(&fusion, outputs, inputs, __LINE__, __FILE__);
 }
 
+// A tensor with 2^32 elements can still use 32-bit loop indices as
+// long as each extent and stride fits in int32. Only the tensor
+// offsets are linearized in 64 bits.
+TEST_F(IndexingTest, SubTensorIndexing) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Val>(1.0));
+  fusion.addOutput(tv1);
+
+  // [i0, i1/128, 128]
+  tv1->split(1, 128);
+  tv1->axis(0)->parallelize(ParallelType::BIDx);
+  tv1->axis(1)->parallelize(ParallelType::BIDy);
+  tv1->axis(2)->parallelize(ParallelType::TIDx);
+
+  ExpressionEvaluator expr_eval;
+  expr_eval.bind(tv0->axis(0)->extent(), 1L << 20);
+  expr_eval.bind(tv0->axis(1)->extent(), 1L << 12);
+  EXPECT_TRUE(canUseSubTensorIndexing(&fusion, expr_eval));
+
+  // The loop indices are int32, but the offsets of tv0 and tv1 are
+  // int64
+  CompileParams cparams;
+  cparams.index_type = PrimDataType::Int32;
+  cparams.sub_tensor_indexing = true;
+  GpuLower gpulw(&fusion, cparams);
+  kir::Kernel* kernel = gpulw.run();
+  EXPECT_EQ(kernel->indexType(), PrimDataType::Int32);
+
+  int64_t num_global_indices = 0;
+  for (Expr* expr : ir_utils::flattenScopedExprs(kernel->topLevelExprs())) {
+    for (auto ti : ir_utils::filterByType<kir::TensorIndex>(expr->inputs())) {
+      EXPECT_EQ(ti->index()->dtype(), DataType::Int) << ti->toString();
+      ++num_global_indices;
+    }
+  }
+  EXPECT_EQ(num_global_indices, 1);
+
+  // The inner extent is too large to be indexed in 32 bits
+  ExpressionEvaluator large_expr_eval;
+  large_expr_eval.bind(tv0->axis(0)->extent(), 2L);
+  large_expr_eval.bind(tv0->axis(1)->extent(), 1L << 31);
+  EXPECT_FALSE(canUseSubTensorIndexing(&fusion, large_expr_eval));
+}
+
 } // namespace nvfuser
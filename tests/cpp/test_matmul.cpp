@@ -4061,6 +4061,73 @@ TEST_F(HopperMatmulTest, HSH_NT_UseScheduler) {
   EXPECT_TRUE(cg_outputs[0].allclose(out_ref, 1e-6 * K, 1e-6 * K));
 }
 
+// The operand loads are issued by a dedicated producer warp group
+TEST_F(HopperMatmulTest, HSH_NT_UseScheduler_WarpSpecialized) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  constexpr int64_t M = 2048, N = 2048, K = 8192;
+  const auto dtype = DataType::Half;
+
+  auto tv0 = makeContigConcreteTensor({-1, -1, 1}, dtype); // K, M
+  auto tv1 = makeContigConcreteTensor({-1, 1, -1}, dtype); // K, N
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+
+  auto tv2 = fusedMultiplySum(tv0, tv1, {0});
+
+  // Reorder the accumulator as [M, N, K]
+  // [K, M, N] -> [M, N, K]
+  tv2->reorder({{-3, -1}});
+  tv2->commitLeafToLogical();
+
+  auto tv3 = castOp(DataType::Half, tv2);
+  fusion.addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA);
+  auto a_ref = at::randn({K, M, 1}, options);
+  auto b_ref = at::randn({K, 1, N}, options);
+  auto out_ref = at::matmul(a_ref.squeeze().t(), b_ref.squeeze()).to(at::kHalf);
+
+  MatMulTileOptions gemm_tile;
+  gemm_tile.cta_tile = GemmTile(128, 256, 16);
+  gemm_tile.warp_tile = GemmTile(64, 256, 16);
+
+  MatmulParams mparams;
+  mparams.supported_vec_size = {8, 8, 8};
+  mparams.mma_macro = MmaMacro::Hopper_64_256_16;
+  mparams.tile_sizes = gemm_tile;
+  mparams.cta_order = MatmulParams::TileRasterizationOrder::ColumnMajor;
+  mparams.async_gmem_load_operands = true;
+  mparams.circular_buffer_options.circular_buffer_smem_write = true;
+  mparams.circular_buffer_options.circular_buffer_smem_read = false;
+  mparams.circular_buffer_options.smem_circular_buffer_stage = 4;
+  mparams.circular_buffer_options.smem_circular_buffer_prefetch_gap = 1;
+  mparams.circular_buffering_strategy =
+      MatmulParams::CircularBufferingStrategy::WarpSpecialized;
+  mparams.splitk_factor = 1;
+  mparams.use_smem_epilogue = true;
+  mparams.cluster_dims = {2, 1, 1};
+  mparams.promote_prologue_smem_reuse = true;
+
+  SchedulerEntry::makeSchedulerInstance(SchedulerType::Matmul)
+      ->schedule(&fusion, &mparams);
+
+  std::vector<c10::IValue> inputs = {a_ref, b_ref};
+
+  KernelExecutor ke;
+  ke.compile(&fusion, inputs);
+  EXPECT_TRUE(getBankConflictInfo(ke.kernel()).empty());
+  auto cg_outputs = ke.run(inputs);
+  // One producer warp group in addition to the two compute warp groups
+  EXPECT_EQ(ke.lastLaunchParams().bdimy(), 3);
+  ASSERT_FALSE(
+      PredicatedChecker::isCpAsyncMmaPredicatedByIfThenElse(ke.kernel()));
+
+  // Relax tolerance for larger sum due to large K
+  EXPECT_TRUE(cg_outputs[0].allclose(out_ref, 1e-6 * K, 1e-6 * K));
+}
+
 TEST_F(HopperMatmulTest, HSH_TN_UseScheduler) {
   Fusion fusion;
   FusionGuard fg(&fusion);
@@ -4299,6 +4366,47 @@ TEST_F(HopperMatmulTest, MLPBenchmarkFwdGEMM) {
   EXPECT_TRUE(cg_outputs[0].allclose(out_ref, 1e-6 * K, 1e-6 * K));
 }
 
+// A skinny matmul with a large K leaves most SMs idle, so the heuristic
+// splits K. The split-K sum is a serial grid reduction, which makes repeated
+// runs bitwise identical.
+TEST_F(HopperMatmulTest, SkinnySplitKIsDeterministic) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::FuseMatmul);
+  EnableOptionsGuard::getCurOptions().set(EnableOption::MatmulSplitK);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  constexpr int64_t M = 64, N = 256, K = 16384;
+  const auto dtype = DataType::BFloat16;
+
+  auto tv0 = makeContigConcreteTensor({-1, -1}, dtype); // M, K
+  auto tv1 = makeContigConcreteTensor({-1, -1}, dtype); // N, K
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+
+  auto tv2 = linear(tv0, tv1);
+
+  fusion.addOutput(tv2);
+
+  auto options = at::TensorOptions().dtype(at::kBFloat16).device(at::kCUDA);
+  auto a_ref = at::randn({M, K}, options);
+  auto b_ref = at::randn({N, K}, options);
+  auto out_ref = at::linear(a_ref, b_ref);
+
+  std::vector<c10::IValue> inputs = {a_ref, b_ref};
+  auto cg_results = scheduleAndRun(&fusion, SchedulerType::Matmul, inputs);
+  auto mparams = cg_results.heuristic_params->as<MatmulParams>();
+  EXPECT_GT(mparams->splitk_factor, 1);
+
+  // Relax tolerance for larger sum due to large K
+  EXPECT_TRUE(cg_results.outputs[0].allclose(out_ref, 1e-6 * K, 1e-6 * K));
+
+  auto rerun_outputs =
+      cg_results.kernel_executor->run(inputs, mparams->lparams);
+  EXPECT_TRUE(at::equal(cg_results.outputs[0], rerun_outputs[0]));
+}
+
 TEST_F(HopperMatmulTest, MLPBenchmarkFwdEpilogueFusion) {
   Fusion fusion;
   FusionGuard fg(&fusion);
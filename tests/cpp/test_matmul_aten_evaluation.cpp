@@ -293,6 +293,96 @@ TEST_P(LinearNodeParametrizedTest, LinearNodeSymbolic) {
   EXPECT_TRUE(at::allclose(out[0], out_ref));
 }
 
+// A linear layer with a 2:4 structured-sparse weight, which is decompressed
+// from its kept values and their positions
+TEST_F(NVFuserTest, LinearSparse24Weight) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2, DataType::BFloat16);
+  auto values = makeContigTensor(2, DataType::BFloat16);
+  auto metadata = makeContigTensor(2, DataType::Int8);
+  fusion->addInput(tv0);
+  fusion->addInput(values);
+  fusion->addInput(metadata);
+  auto tv1 = linear(tv0, decompress_sparse24(values, metadata));
+  fusion->addOutput(tv1);
+
+  constexpr int64_t m = 32, n = 48, k = 64;
+  auto options = at::TensorOptions().dtype(at::kBFloat16).device(at::kCUDA);
+  at::Tensor t0 = at::randn({m, k}, options);
+  at::Tensor t_values = at::randn({n, k / 2}, options);
+  // The six ordered pairs of positions in a group of four
+  at::Tensor pairs =
+      at::tensor({0, 1, 0, 2, 0, 3, 1, 2, 1, 3, 2, 3}, options.dtype(at::kLong))
+          .view({6, 2});
+  at::Tensor positions =
+      pairs.index({at::randint(6, {n, k / 4}, options.dtype(at::kLong))});
+  at::Tensor t_metadata =
+      (positions.select(-1, 0) | (positions.select(-1, 1) << 2))
+          .to(at::kChar);
+  at::Tensor dense = at::zeros({n, k / 4, 4}, options)
+                         .scatter_(2, positions, t_values.view({n, k / 4, 2}))
+                         .view({n, k});
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto out = executor_cache.runFusionWithInputs({t0, t_values, t_metadata});
+  EXPECT_TRUE(at::allclose(out[0], at::linear(t0, dense), 1e-2, 1e-2));
+}
+
+using GroupedMatmulNodeTest = NVFuserTest;
+
+// Ragged groups, including an empty group and trailing rows that belong to no
+// group
+TEST_F(GroupedMatmulNodeTest, RaggedGroups) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2, DataType::BFloat16);
+  auto tv1 = makeSymbolicTensor(3, DataType::BFloat16);
+  auto tv2 = makeSymbolicTensor(1, DataType::Int32);
+  auto tv3 = grouped_matmul(tv0, tv1, tv2);
+
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addInput(tv2);
+  fusion->addOutput(tv3);
+
+  {
+    IdModel id_model(fusion.get());
+    const ValGraph& vg = id_model.idGraph(IdMappingMode::EXACT);
+    vg.validateConsistency();
+    EXPECT_TRUE(checkMapped(vg, tv0->axis(0), tv3->axis(0)));
+    EXPECT_TRUE(checkMapped(vg, tv1->axis(2), tv3->axis(1)));
+    EXPECT_TRUE(checkMapped(vg, tv0->axis(1), tv1->axis(1)));
+    EXPECT_TRUE(checkMapped(vg, tv0->axis(1), tv3->axis(2)));
+  }
+
+  auto options = at::TensorOptions().dtype(at::kBFloat16).device(at::kCUDA);
+  at::Tensor t0 = at::randn({48, 64}, options);
+  at::Tensor t1 = at::randn({4, 64, 32}, options);
+  at::Tensor t2 = at::tensor({5, 5, 20, 40}, options.dtype(at::kInt));
+
+  at::Tensor out_ref = at::zeros({48, 32}, options);
+  int64_t start = 0;
+  for (auto g : c10::irange(4)) {
+    int64_t end = t2[g].item<int64_t>();
+    out_ref.narrow(0, start, end - start) =
+        at::matmul(t0.narrow(0, start, end - start), t1[g]);
+    start = end;
+  }
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto out = executor_cache.runFusionWithInputs({t0, t1, t2});
+
+  const auto& executors =
+      executor_cache.getMostRecentKernelRuntime()->executors();
+  EXPECT_EQ(executors.size(), 1);
+  EXPECT_FALSE(executors.front()->isA<KernelExecutor>());
+
+  EXPECT_TRUE(at::allclose(out[0], out_ref));
+}
+
 constexpr int64_t b = 128, m = 64, k = 32, n = 16;
 
 // Parametrize a_shape and b_shape
@@ -2617,6 +2617,52 @@ TEST_F(MatmulSchedulerTest, SegmentLinearOpPrologue) {
   testValidate(executor_cache.fusion(), outputs, {t0, t1}, __LINE__, __FILE__);
 }
 
+// A normalization with precomputed per-row statistics is applied to operand
+// A in the register prologue of the matmul instead of a separate kernel
+TEST_F(MatmulSchedulerTest, LinearOpNormalizationPrologue) {
+  NVFUSER_TEST_CUDA_ARCH_RANGE_GUARD(7, 5, 9, 0);
+  EnableOptionsGuard eog;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::FuseMatmul);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  auto tv1 = makeContigTensor(1);
+  auto tv2 = makeContigTensor(1);
+  auto tv3 = makeContigTensor(2, DataType::Half);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addInput(tv2);
+  fusion->addInput(tv3);
+
+  auto tv4 = castOp(DataType::Float, tv0);
+  auto tv5 = sub(tv4, broadcast(tv1, {false, true}));
+  auto tv6 = mul(tv5, broadcast(tv2, {false, true}));
+  auto tv7 = castOp(DataType::Half, tv6);
+  auto tv8 = linear(tv7, tv3);
+  fusion->addOutput(tv8);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  const int M = 504, N = 136, K = 248;
+  at::manual_seed(0);
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA);
+  auto t0 = at::randn({M, K}, options);
+  auto t1 = t0.to(at::kFloat).mean({1});
+  auto t2 = at::rsqrt(t0.to(at::kFloat).var({1}, false) + 1e-5);
+  auto t3 = at::randn({N, K}, options);
+  std::vector<c10::IValue> inputs = {t0, t1, t2, t3};
+
+  auto outputs = executor_cache.runFusionWithInputs(inputs);
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_FALSE(runtime->isSegmented());
+  EXPECT_TRUE(isSchedulerInUse(runtime, SchedulerType::Matmul));
+
+  testValidate(executor_cache.fusion(), outputs, inputs, __LINE__, __FILE__);
+}
+
 // Test that the matmul scheduler refuses to translate a matmul that is not
 // Half or BFloat16
 TEST_F(MatmulSchedulerTest, SegmentMatmulOpUnsupportedDtype) {
@@ -2881,6 +2927,154 @@ INSTANTIATE_TEST_SUITE_P(
                   : "dontfuse";
     });
 
+// The two matmuls of a gated MLP share their A operand, which is loaded once
+// per stage. The heuristics size the shared memory for one A tile, two B
+// tiles, and one epilogue buffer per matmul.
+TEST_F(MatmulSchedulerTest, GatedMlpSharedMemory) {
+  NVFUSER_TEST_CUDA_ARCH_RANGE_GUARD(7, 5, 9, 0);
+  EnableOptionsGuard eog;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::FuseMatmul);
+  EnableOptionsGuard::getCurOptions().set(EnableOption::FuseMultipleMatmuls);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  auto tv1 = makeContigTensor(2, DataType::Half);
+  auto tv2 = makeContigTensor(2, DataType::Half);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addInput(tv2);
+
+  auto tv3 = matmul(tv0, tv1);
+  auto tv4 = matmul(tv0, tv2);
+  auto tv5 = mul(mul(sigmoid(tv3), tv3), tv4);
+  auto tv6 = castOp(DataType::Half, tv5);
+  fusion->addOutput(tv6);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  const int M = 2048, N = 2048, K = 1024;
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA);
+  auto t0 = at::randn({M, K}, options);
+  auto t1 = at::randn({K, N}, options);
+  auto t2 = at::randn({K, N}, options);
+  auto outputs = executor_cache.runFusionWithInputs({t0, t1, t2});
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  ASSERT_TRUE(isSchedulerInUse(runtime, SchedulerType::Matmul));
+  const auto mparams = runtime->schedulerHeuristics()
+                           ->heuristicsList()
+                           .at(0)
+                           ->as<MatmulParams>();
+  const GemmTile& cta_tile = mparams->tile_sizes.cta_tile;
+  const int64_t stages = std::max(
+      1, mparams->circular_buffer_options.smem_circular_buffer_stage);
+  const int64_t operand_smem =
+      stages * (cta_tile.m + 2 * cta_tile.n) * cta_tile.k * 2;
+  const int64_t epilogue_smem = mparams->use_smem_epilogue
+      ? 2 * cta_tile.m * cta_tile.n * (int64_t)sizeof(float)
+      : 0;
+  EXPECT_LE(
+      mparams->promote_prologue_smem_reuse
+          ? std::max(operand_smem, epilogue_smem)
+          : operand_smem + epilogue_smem,
+      (int64_t)deviceAvailableSharedMemoryBytes());
+
+  auto t3 = at::matmul(t0.to(at::kFloat), t1.to(at::kFloat));
+  auto t4 = at::matmul(t0.to(at::kFloat), t2.to(at::kFloat));
+  auto tref = (at::sigmoid(t3) * t3 * t4).to(at::kHalf);
+  EXPECT_TRUE(outputs[0].allclose(tref, 1e-2, 1e-2));
+}
+
+// Each output of a Hopper smem epilogue, like an activation and the
+// pre-activation saved for backward, is staged in its own shared memory
+// buffer for its TMA store, which the heuristics have to account for
+TEST_F(MatmulSchedulerTest, HopperMultipleOutputSmemEpilogue) {
+  NVFUSER_TEST_CUDA_ARCH_RANGE_GUARD(9, 0, 10, 0);
+  EnableOptionsGuard eog;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::FuseMatmul);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2, DataType::BFloat16);
+  auto tv1 = makeContigTensor(2, DataType::BFloat16);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+
+  auto tv2 = linear(tv0, tv1);
+  auto tv3 = castOp(DataType::BFloat16, tv2);
+  auto tv4 = castOp(DataType::BFloat16, gelu(tv2));
+  fusion->addOutput(tv3);
+  fusion->addOutput(tv4);
+
+  // Both operands have a single use, so their buffers can be reused for the
+  // epilogue. With 4 stages of a 128x256x64 tile, the operands take 192KiB
+  // and each staged output 128KiB, so a single output fits but two don't.
+  const MmaDataTypes data_types = {
+      DataType::BFloat16, DataType::BFloat16, DataType::Float};
+  MatMulTileOptions large_tile;
+  large_tile.cta_tile = GemmTile(128, 256, 64);
+  large_tile.warp_tile = GemmTile(64, 256, 64);
+  EXPECT_TRUE(mma_utils::generateSharedMemoryEpilogueHeuristics(
+                  large_tile,
+                  /*smem_circular_buffer_stage=*/4,
+                  data_types,
+                  /*smem_a_reuse_guaranteed=*/true,
+                  /*smem_b_reuse_guaranteed=*/true,
+                  /*ignore_occupancy_drop=*/true,
+                  {/*a=*/1, /*b=*/1, /*c=*/1})
+                  .first);
+  EXPECT_FALSE(mma_utils::generateSharedMemoryEpilogueHeuristics(
+                   large_tile,
+                   /*smem_circular_buffer_stage=*/4,
+                   data_types,
+                   /*smem_a_reuse_guaranteed=*/true,
+                   /*smem_b_reuse_guaranteed=*/true,
+                   /*ignore_occupancy_drop=*/true,
+                   {/*a=*/1, /*b=*/1, /*c=*/2})
+                   .first);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  const int M = 2048, N = 2048, K = 2048;
+  auto options = at::TensorOptions().dtype(at::kBFloat16).device(at::kCUDA);
+  auto t0 = at::randn({M, K}, options);
+  auto t1 = at::randn({N, K}, options);
+  auto outputs = executor_cache.runFusionWithInputs({t0, t1});
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  ASSERT_TRUE(isSchedulerInUse(runtime, SchedulerType::Matmul));
+  const auto mparams = runtime->schedulerHeuristics()
+                           ->heuristicsList()
+                           .at(0)
+                           ->as<MatmulParams>();
+  // The heuristic counts a buffer for each of the two outputs
+  EXPECT_EQ(
+      mparams->use_smem_epilogue,
+      mma_utils::generateSharedMemoryEpilogueHeuristics(
+          mparams->tile_sizes,
+          mparams->circular_buffer_options.smem_circular_buffer_stage,
+          data_types,
+          /*smem_a_reuse_guaranteed=*/true,
+          /*smem_b_reuse_guaranteed=*/true,
+          /*ignore_occupancy_drop=*/true,
+          {/*a=*/1, /*b=*/1, /*c=*/2})
+          .first);
+
+  auto t2 = at::linear(t0.to(at::kFloat), t1.to(at::kFloat));
+  testValidate(
+      executor_cache.fusion(),
+      outputs,
+      {t0, t1},
+      {t2.to(at::kBFloat16), at::gelu(t2).to(at::kBFloat16)},
+      __LINE__,
+      __FILE__);
+}
+
 // This test can be used to check that an external plugin has been loaded. It
 // is DISABLED_ so that the test suite will pass even if the user has not
 // provided a plugin via NVFUSER_MATMUL_HEURISTIC_PLUGIN. To check that a
@@ -1075,4 +1075,22 @@ INSTANTIATE_TEST_SUITE_P(
         kAllSmemSwizzleModes),
     testNameHopperSS);
 
+// The tcgen05 macros encode the extent of the whole MMA, which spans both
+// CTAs of a pair for the 2-CTA macros
+TEST_F(NVFuserTest, BlackwellMmaMacros) {
+  constexpr auto macro_1cta = MmaMacro::Blackwell1CTA_128_256_16;
+  EXPECT_TRUE(isBlackwell(macro_1cta));
+  EXPECT_TRUE(isBlackwell1CTA(macro_1cta));
+  EXPECT_FALSE(isBlackwell2CTA(macro_1cta));
+  EXPECT_FALSE(isHopper(macro_1cta));
+  EXPECT_EQ(getMmaOpShape(macro_1cta), GemmTile(128, 256, 16));
+  EXPECT_EQ(toString(macro_1cta), "Blackwell1CTA_128_256_16");
+
+  constexpr auto macro_2cta = MmaMacro::Blackwell2CTA_256_128_16;
+  EXPECT_TRUE(isBlackwell(macro_2cta));
+  EXPECT_TRUE(isBlackwell2CTA(macro_2cta));
+  EXPECT_EQ(getMmaOpShape(macro_2cta), GemmTile(256, 128, 16));
+  EXPECT_EQ(toString(macro_2cta), "Blackwell2CTA_256_128_16");
+}
+
 } // namespace nvfuser
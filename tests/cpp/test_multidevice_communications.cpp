@@ -17,6 +17,7 @@
 #include <ops/utils.h>
 
 #include <iostream>
+#include <numeric>
 
 namespace nvfuser {
 
@@ -407,6 +408,279 @@ TEST_P(CommunicationTest, ReduceScatter) {
   }
 }
 
+TEST_P(CommunicationTest, AllToAll) {
+  hir::HostIrContainer container;
+  FusionGuard fg(&container);
+  auto* in = makeContigTensor(3);
+  in->setDeviceMesh(full_mesh_);
+  auto* out = ops::newValLike(in, in->dtype())->as<TensorView>();
+  auto communication = IrBuilder::create<Communication>(
+      CommunicationType::AllToAll, out, in, all_ranks_);
+
+  const int64_t num_devices = communicator_->size();
+  const int64_t device_id = communicator_->deviceId();
+  // The input is sharded on axis 0 and the output on axis 1
+  at::Tensor unsharded_tensor =
+      at::empty({num_devices, num_devices, kTensorSize}, tensor_options);
+  at::Tensor output_tensor =
+      at::empty({num_devices, 1, kTensorSize}, tensor_options);
+  for (auto repetition : c10::irange(kNumRepetitions)) {
+    unsharded_tensor.copy_(
+        at::arange(num_devices * num_devices * kTensorSize, tensor_options)
+            .view({num_devices, num_devices, kTensorSize}) +
+        repetition);
+    at::Tensor input_tensor =
+        unsharded_tensor.slice(0, device_id, device_id + 1).contiguous();
+
+    auto work = postSingleCommunication(
+        communication, device_id, backend_, input_tensor, output_tensor);
+    work->wait();
+
+    validate(
+        output_tensor, unsharded_tensor.slice(1, device_id, device_id + 1));
+  }
+}
+
+TEST_P(CommunicationTest, AllToAllVariableSplits) {
+  if (GetParam() != CommunicatorBackend::kNccl) {
+    GTEST_SKIP() << "Variable split sizes are only tested with NCCL";
+  }
+  hir::HostIrContainer container;
+  FusionGuard fg(&container);
+  auto* in = makeContigTensor(2);
+  in->setDeviceMesh(full_mesh_);
+  auto* out = ops::newValLike(in, in->dtype())->as<TensorView>();
+  auto* in_splits = makeContigTensor(1, DataType::Int);
+  in_splits->setDeviceMesh(full_mesh_);
+  auto* out_splits = makeContigTensor(1, DataType::Int);
+  out_splits->setDeviceMesh(full_mesh_);
+  auto communication = IrBuilder::create<Communication>(
+      CommunicationType::AllToAll,
+      out,
+      in,
+      all_ranks_,
+      /*root=*/-1,
+      RedOpType::UNUSED,
+      /*scattered_axis=*/-1,
+      in_splits,
+      out_splits);
+
+  // Device i sends i+j+1 rows, filled with i, to device j, like tokens routed
+  // to the experts of a mixture of experts
+  const int64_t num_devices = communicator_->size();
+  const int64_t device_id = communicator_->deviceId();
+  at::Tensor input_splits =
+      at::arange(num_devices, tensor_options.dtype(at::kLong)) + device_id + 1;
+  const int64_t input_rows = input_splits.sum().item<int64_t>();
+  at::Tensor input_tensor =
+      at::full({input_rows, kTensorSize}, device_id, tensor_options);
+  // Enough for the most rows any device receives
+  const int64_t capacity = 2 * num_devices * num_devices;
+  at::Tensor output_tensor =
+      at::zeros({capacity, kTensorSize}, tensor_options);
+  at::Tensor output_splits =
+      at::empty({num_devices}, tensor_options.dtype(at::kLong));
+
+  auto work = postSingleCommunication(
+      communication,
+      device_id,
+      backend_,
+      input_tensor,
+      output_tensor,
+      input_splits,
+      output_splits);
+  work->wait();
+
+  at::Tensor expected_splits =
+      at::arange(num_devices, tensor_options.dtype(at::kLong)) + device_id + 1;
+  validate(output_splits, expected_splits);
+  std::vector<at::Tensor> expected_chunks;
+  for (auto sender : c10::irange(num_devices)) {
+    expected_chunks.push_back(at::full(
+        {sender + device_id + 1, kTensorSize}, sender, tensor_options));
+  }
+  at::Tensor expected = at::cat(expected_chunks);
+  validate(output_tensor.narrow(0, 0, expected.size(0)), expected);
+}
+
+namespace {
+
+// Lays out the devices as [size/2 "nodes", 2 devices per node]
+DeviceMesh createTwoLevelMesh(int64_t num_devices) {
+  std::vector<DeviceIdxType> devices(num_devices);
+  std::iota(devices.begin(), devices.end(), 0);
+  return DeviceMesh(devices, {num_devices / 2, 2});
+}
+
+} // namespace
+
+TEST_P(CommunicationTest, HierarchicalAllreduce) {
+  // Large enough for the decomposition to pay off
+  constexpr int64_t kLargeTensorSize = 1 << 18;
+  const int64_t num_devices = communicator_->size();
+  if (num_devices < 4 || num_devices % 2 != 0) {
+    GTEST_SKIP() << "needs an even number of at least four devices";
+  }
+  const DeviceMesh mesh = createTwoLevelMesh(num_devices);
+  EXPECT_EQ(
+      mesh.getSlice(/*axis=*/1, 3), std::vector<DeviceIdxType>({2, 3}));
+
+  hir::HostIrContainer container;
+  FusionGuard fg(&container);
+  auto* in = makeContigTensor(2);
+  in->setDeviceMesh(mesh);
+  auto* out = newForReduction(in, {0});
+  auto communication = IrBuilder::create<Communication>(
+      CommunicationType::Allreduce,
+      out,
+      in,
+      mesh.vector(),
+      /*root=*/-1,
+      kReductionOp);
+
+  at::Tensor input_tensor = at::empty({1, kLargeTensorSize}, tensor_options);
+  at::Tensor output_tensor = at::empty({kLargeTensorSize}, tensor_options);
+  for (auto repetition : c10::irange(kNumRepetitions)) {
+    input_tensor.copy_(
+        at::arange(kLargeTensorSize, tensor_options).unsqueeze(0) +
+        (communicator_->deviceId() + 1) * repetition);
+
+    auto work = postHierarchicalCommunication(
+        communication,
+        communicator_->deviceId(),
+        communicator_,
+        GetParam(),
+        input_tensor,
+        output_tensor);
+    work->wait();
+
+    const int64_t s = num_devices;
+    auto ref = at::arange(kLargeTensorSize, tensor_options) * s +
+        s * (s + 1) / 2 * repetition;
+    validate(output_tensor, ref);
+  }
+}
+
+TEST_P(CommunicationTest, HierarchicalAllgather) {
+  constexpr int64_t kLargeTensorSize = 1 << 18;
+  const int64_t num_devices = communicator_->size();
+  if (num_devices < 4 || num_devices % 2 != 0) {
+    GTEST_SKIP() << "needs an even number of at least four devices";
+  }
+  const DeviceMesh mesh = createTwoLevelMesh(num_devices);
+
+  hir::HostIrContainer container;
+  FusionGuard fg(&container);
+  auto* in = makeContigTensor(2);
+  in->setDeviceMesh(mesh);
+  auto* out = ops::newValLike(in, in->dtype())->as<TensorView>();
+  auto communication = IrBuilder::create<Communication>(
+      CommunicationType::Allgather, out, in, mesh.vector());
+
+  at::Tensor input_tensor = at::empty({1, kLargeTensorSize}, tensor_options);
+  at::Tensor output_tensor =
+      at::empty({num_devices, kLargeTensorSize}, tensor_options);
+  for (auto repetition : c10::irange(kNumRepetitions)) {
+    input_tensor.copy_(
+        at::arange(kLargeTensorSize, tensor_options).unsqueeze(0) +
+        (communicator_->deviceId() + 1) * repetition);
+
+    auto work = postHierarchicalCommunication(
+        communication,
+        communicator_->deviceId(),
+        communicator_,
+        GetParam(),
+        input_tensor,
+        output_tensor);
+    work->wait();
+
+    at::Tensor ref =
+        at::arange(kLargeTensorSize, tensor_options).unsqueeze(0) +
+        at::arange(1, num_devices + 1, tensor_options).unsqueeze(1) *
+            repetition;
+    validate(output_tensor, ref);
+  }
+}
+
+TEST_P(CommunicationTest, CompressedAllreduce) {
+  constexpr int64_t kLargeTensorSize = 1 << 16;
+  hir::HostIrContainer container;
+  FusionGuard fg(&container);
+  auto* in = makeContigTensor(2);
+  in->setDeviceMesh(full_mesh_);
+  auto* out = newForReduction(in, {0});
+  auto communication = IrBuilder::create<Communication>(
+      CommunicationType::Allreduce,
+      out,
+      in,
+      all_ranks_,
+      /*root=*/-1,
+      kReductionOp);
+
+  const int64_t num_devices = communicator_->size();
+  at::Tensor unsharded_input_tensor =
+      at::randn({num_devices, kLargeTensorSize}, tensor_options);
+  at::Tensor input_tensor =
+      shardTensor(unsharded_input_tensor, /*axis=*/0, full_mesh_);
+  at::Tensor output_tensor = at::empty({kLargeTensorSize}, tensor_options);
+
+  auto work = postCompressedCommunication(
+      communication,
+      communicator_->deviceId(),
+      communicator_,
+      GetParam(),
+      input_tensor,
+      output_tensor);
+  work->wait();
+
+  // FP8 keeps 3 bits of mantissa, and the data is compressed twice
+  at::Tensor ref = unsharded_input_tensor.sum(0);
+  EXPECT_TRUE(at::allclose(output_tensor, ref, /*rtol=*/0.15, /*atol=*/0.1))
+      << "Maximum error: " << (output_tensor - ref).abs().max();
+}
+
+TEST_P(CommunicationTest, CompressedReduceScatter) {
+  constexpr int64_t kLargeTensorSize = 1 << 16;
+  hir::HostIrContainer container;
+  FusionGuard fg(&container);
+  auto* in = makeContigTensor(3);
+  in->setDeviceMesh(full_mesh_);
+  auto* out = newForReduction(in, {0});
+  auto communication = IrBuilder::create<Communication>(
+      CommunicationType::ReduceScatter,
+      out,
+      in,
+      all_ranks_,
+      /*root=*/-1,
+      kReductionOp,
+      /*scattered_axis=*/1);
+
+  const int64_t num_devices = communicator_->size();
+  const int64_t device_id = communicator_->deviceId();
+  at::Tensor unsharded_input_tensor = at::randn(
+      {num_devices, num_devices, kLargeTensorSize},
+      tensor_options.dtype(at::kBFloat16));
+  at::Tensor input_tensor =
+      unsharded_input_tensor.slice(0, device_id, device_id + 1);
+  at::Tensor output_tensor =
+      at::empty({1, kLargeTensorSize}, input_tensor.options());
+
+  auto work = postCompressedCommunication(
+      communication,
+      device_id,
+      communicator_,
+      GetParam(),
+      input_tensor,
+      output_tensor);
+  work->wait();
+
+  at::Tensor ref = unsharded_input_tensor.to(at::kFloat).sum({0}).slice(
+      0, device_id, device_id + 1);
+  EXPECT_TRUE(at::allclose(
+      output_tensor.to(at::kFloat), ref, /*rtol=*/0.1, /*atol=*/0.1))
+      << "Maximum error: " << (output_tensor.to(at::kFloat) - ref).abs().max();
+}
+
 INSTANTIATE_TEST_SUITE_P(
     ,
     CommunicationTest,
@@ -11,7 +11,9 @@
 #include <gmock/gmock-matchers.h>
 #include <gtest/gtest.h>
 
+#include <multidevice/backend_table.h>
 #include <multidevice/communicator.h>
+#include <options.h>
 #include <tests/cpp/multidevice.h>
 
 namespace std {
@@ -82,10 +84,83 @@ TEST_P(CommunicatorTest, Barrier) {
   }
 }
 
+TEST_P(CommunicatorTest, CalibrateBackends) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::CommunicatorBackendTable);
+
+  communicator_->calibrateBackends();
+  const CommunicatorBackendTable* table = communicator_->backendTable();
+  ASSERT_NE(table, nullptr);
+  for (auto type :
+       {CommunicationType::Allgather,
+        CommunicationType::Allreduce,
+        CommunicationType::ReduceScatter}) {
+    for (int64_t message_bytes : {1 << 10, 1 << 20, 1 << 26}) {
+      auto backend = table->lookup(type, communicator_->size(), message_bytes);
+      ASSERT_TRUE(backend.has_value());
+      EXPECT_TRUE(communicator_->isBackendAvailable(backend.value()));
+      EXPECT_EQ(
+          communicator_->selectBackend(
+              type, communicator_->size(), message_bytes),
+          backend.value());
+    }
+  }
+  // Broadcasts aren't selected by message size
+  EXPECT_EQ(
+      communicator_->selectBackend(
+          CommunicationType::Broadcast, communicator_->size(), 1 << 10),
+      comm_backend_default);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     ,
     CommunicatorTest,
     testing::Values(CommunicatorBackend::kNccl, CommunicatorBackend::kUcc),
     testing::PrintToStringParamName());
 
+using CommunicatorBackendTableTest = NVFuserTest;
+
+TEST_F(CommunicatorBackendTableTest, LookupNearestBucket) {
+  CommunicatorBackendTable table;
+  table.set(
+      CommunicationType::Allreduce, 8, 1 << 10, CommunicatorBackend::kUcc);
+  table.set(
+      CommunicationType::Allreduce, 8, 1 << 20, CommunicatorBackend::kNccl);
+
+  EXPECT_EQ(
+      table.lookup(CommunicationType::Allreduce, 8, 1),
+      CommunicatorBackend::kUcc);
+  EXPECT_EQ(
+      table.lookup(CommunicationType::Allreduce, 8, (1 << 14) + 1),
+      CommunicatorBackend::kUcc);
+  EXPECT_EQ(
+      table.lookup(CommunicationType::Allreduce, 8, 1 << 16),
+      CommunicatorBackend::kNccl);
+  EXPECT_EQ(
+      table.lookup(CommunicationType::Allreduce, 8, (int64_t)1 << 40),
+      CommunicatorBackend::kNccl);
+  EXPECT_FALSE(table.lookup(CommunicationType::Allreduce, 4, 1 << 10));
+  EXPECT_FALSE(table.lookup(CommunicationType::Allgather, 8, 1 << 10));
+}
+
+TEST_F(CommunicatorBackendTableTest, Serialization) {
+  CommunicatorBackendTable table;
+  table.set(
+      CommunicationType::Allgather, 2, 1 << 12, CommunicatorBackend::kUcc);
+  table.set(
+      CommunicationType::ReduceScatter, 2, 1 << 24, CommunicatorBackend::kNccl);
+
+  auto parsed = CommunicatorBackendTable::fromString(table.toString());
+  ASSERT_TRUE(parsed.has_value());
+  EXPECT_EQ(parsed->toString(), table.toString());
+  EXPECT_EQ(
+      parsed->lookup(CommunicationType::ReduceScatter, 2, 1 << 24),
+      CommunicatorBackend::kNccl);
+
+  EXPECT_FALSE(CommunicatorBackendTable::fromString("Allreduce\t2\t10\n"));
+  EXPECT_FALSE(
+      CommunicatorBackendTable::fromString("Broadcast\t2\t10\tNCCL\n"));
+}
+
 } // namespace nvfuser
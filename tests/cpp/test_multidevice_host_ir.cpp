@@ -7,10 +7,15 @@
 // clang-format on
 #include <cuda_profiler_api.h>
 #include <fusion.h>
+#include <fusion_profiler.h>
 #include <host_ir/container.h>
 #include <host_ir/executor.h>
+#include <host_ir/lower.h>
+#include <host_ir/prefetch_allgathers.h>
 #include <ir/all_nodes.h>
+#include <multidevice/communication_timeline.h>
 #include <ops/all_ops.h>
+#include <options.h>
 #include <tests/cpp/multidevice.h>
 
 namespace nvfuser {
@@ -300,6 +305,142 @@ TEST_F(P2PCommHostIrTest, RingPairwiseExchange) {
   EXPECT_TRUE(torch::allclose(ref_output, outputs.back()));
 }
 
+TEST_F(P2PCommHostIrTest, CudaIpcRingPairwiseExchange) {
+  constexpr int64_t kTensorSize = 1024;
+  constexpr int64_t kNumRepetitions = 4;
+  const int64_t communicator_size = communicator_->size();
+  const int64_t my_device_index = communicator_->deviceId();
+  const int64_t send_peer = (my_device_index + 1) % communicator_size;
+  const int64_t recv_peer =
+      (communicator_size + my_device_index - 1) % communicator_size;
+
+  if (communicator_size < 2) {
+    GTEST_SKIP() << "needs at least two ranks";
+  }
+  if (communicator_->local_size() != communicator_size) {
+    GTEST_SKIP() << "CUDA IPC needs all the ranks to be on the same node";
+  }
+
+  auto hic = std::make_unique<HostIrContainer>();
+  FusionGuard::setCurFusion(hic.get());
+
+  TensorView* send_buffer = makeContigTensor(1);
+  TensorView* recv_buffer = makeContigTensor(1);
+
+  // Sends never wait for the receiver, even when they set up the channel, so
+  // all the devices can post them before their receives
+  auto* send = IrBuilder::create<P2PCommunication>(
+      P2PCommunicationType::SEND,
+      send_buffer,
+      IrBuilder::create<Val>(send_peer),
+      CommunicatorBackend::kCuda);
+  auto* recv = IrBuilder::create<P2PCommunication>(
+      P2PCommunicationType::RECV,
+      recv_buffer,
+      IrBuilder::create<Val>(recv_peer),
+      CommunicatorBackend::kCuda);
+  auto* wait = IrBuilder::create<Wait>(recv);
+
+  hic->addInput(send_buffer);
+  hic->addOutput(recv_buffer);
+  for (auto host_expr : std::vector<Expr*>({send, recv, wait})) {
+    hic->pushBackTopLevelExprs(host_expr);
+  }
+
+  HostIrEvaluator hie(std::move(hic), communicator_);
+
+  auto options = at::TensorOptions().device(communicator_->device());
+  // Repeating checks that the channel is reused once the previous message has
+  // been consumed
+  for (int64_t repetition = 0; repetition < kNumRepetitions; repetition++) {
+    at::Tensor send_buffer_aten =
+        at::randn(kTensorSize, options) + my_device_index;
+    at::Tensor recv_buffer_aten = at::empty(kTensorSize, options);
+
+    auto outputs = hie.runWithInput(
+        {{send_buffer, send_buffer_aten}, {recv_buffer, recv_buffer_aten}});
+
+    at::Tensor ref_output = send_buffer_aten + (recv_peer - my_device_index);
+    EXPECT_TRUE(torch::allclose(ref_output, outputs.back()));
+  }
+}
+
+// Each device runs a kernel whose output is the symmetric tensor of the next
+// device, and reads what the previous device wrote into its own
+TEST_F(P2PCommHostIrTest, KernelWritesToSymmetricTensorOfPeer) {
+  constexpr int64_t kTensorSize = 1024;
+  constexpr int64_t kNumRepetitions = 4;
+  const int64_t communicator_size = communicator_->size();
+  const int64_t my_device_index = communicator_->deviceId();
+  const int64_t send_peer = (my_device_index + 1) % communicator_size;
+  const int64_t recv_peer =
+      (communicator_size + my_device_index - 1) % communicator_size;
+
+  if (communicator_size < 2) {
+    GTEST_SKIP() << "needs at least two ranks";
+  }
+  if (communicator_->local_size() != communicator_size) {
+    GTEST_SKIP() << "CUDA IPC needs all the ranks to be on the same node";
+  }
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+  TensorView* in = makeContigConcreteTensor({kTensorSize});
+  fusion.addInput(in);
+  TensorView* out = add(in, IrBuilder::create<Val>(1.0));
+  fusion.addOutput(out);
+
+  auto options = at::TensorOptions().device(communicator_->device());
+  auto ke = std::make_unique<KernelExecutor>();
+  ke->compile(&fusion, {at::randn(kTensorSize, options)});
+
+  auto hic = std::make_unique<HostIrContainer>();
+  FusionGuard::setCurFusion(hic.get());
+  hic->pushBackKernelExecutor(std::move(ke));
+
+  IrCloner ir_cloner(hic.get());
+  TensorView* hic_in = ir_cloner.clone(in);
+  TensorView* peer_buffer = ir_cloner.clone(out);
+  TensorView* buffer = makeContigConcreteTensor({kTensorSize});
+
+  auto* allocate = IrBuilder::create<SymmetricAllocate>(buffer);
+  auto* get_remote_tensor = IrBuilder::create<GetRemoteTensor>(
+      peer_buffer, buffer, IrBuilder::create<Val>(send_peer));
+  auto* launch_kernel = IrBuilder::create<LaunchKernel>(
+      0, std::vector<Val*>{hic_in}, std::vector<Val*>{peer_buffer});
+  auto* put_signal = IrBuilder::create<PutSignal>(
+      buffer, IrBuilder::create<Val>(send_peer));
+  auto* wait_signal = IrBuilder::create<WaitSignal>(
+      buffer, IrBuilder::create<Val>(recv_peer));
+
+  hic->addInput(hic_in);
+  hic->addOutput(buffer);
+  for (Expr* host_expr : std::vector<Expr*>(
+           {allocate,
+            get_remote_tensor,
+            launch_kernel,
+            put_signal,
+            wait_signal})) {
+    hic->pushBackTopLevelExprs(host_expr);
+  }
+
+  HostIrEvaluator hie(std::move(hic), communicator_);
+
+  // Repeating checks that the symmetric tensor and its signals are reused
+  for (int64_t repetition = 0; repetition < kNumRepetitions; repetition++) {
+    at::Tensor in_aten =
+        at::arange(kTensorSize, options.dtype(at::kFloat)) + my_device_index;
+
+    at::Tensor received = hie.runWithInput({{hic_in, in_aten}}).at(0).clone();
+
+    EXPECT_TRUE(
+        torch::allclose(in_aten + (recv_peer - my_device_index) + 1, received));
+    // The next repetition overwrites the symmetric tensor of the peer, so it
+    // must be done reading it
+    communicator_->barrier();
+  }
+}
+
 TEST_F(P2PCommHostIrTest, CoalescedRingPairwiseExchange) {
   constexpr int64_t kTensorSize = 1024;
   const int64_t communicator_size = communicator_->size();
@@ -350,6 +491,280 @@ TEST_F(P2PCommHostIrTest, CoalescedRingPairwiseExchange) {
   EXPECT_TRUE(torch::allclose(ref_output, outputs.back()));
 }
 
+using CoalesceCommunicationsTest = MultiDeviceTest;
+
+// Two independent allreduces, e.g., of gradients, are posted in one
+// coalesced group
+TEST_F(CoalesceCommunicationsTest, IndependentAllreduces) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::CoalesceCommunications);
+  constexpr int64_t kTensorSize = 1024;
+  const int64_t d = communicator_->size();
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* x = makeContigTensor(2);
+  TensorView* y = makeContigTensor(2);
+  TensorView* x_sum = sum(x, {0});
+  TensorView* y_sum = sum(y, {0});
+  fusion->addInput(x);
+  fusion->addInput(y);
+  fusion->addOutput(x_sum);
+  fusion->addOutput(y_sum);
+
+  auto mesh = DeviceMesh::createForNumDevices(d);
+  for (auto* tv : {x, y, x_sum, y_sum}) {
+    tv->setDeviceMesh(mesh);
+  }
+  x->axis(0)->parallelize(ParallelType::DIDx);
+  y->axis(0)->parallelize(ParallelType::DIDx);
+
+  std::unique_ptr<HostIrContainer> hic =
+      HostIrLower::lower(std::move(fusion), communicator_->deviceId());
+  const auto& top_level_exprs = hic->topLevelExprs();
+  EXPECT_EQ(
+      std::count_if(
+          top_level_exprs.begin(),
+          top_level_exprs.end(),
+          [](Expr* expr) { return expr->isA<StartCoalescing>(); }),
+      1);
+  EXPECT_EQ(
+      std::count_if(
+          top_level_exprs.begin(),
+          top_level_exprs.end(),
+          [](Expr* expr) { return expr->isA<Wait>(); }),
+      1);
+
+  Val* x_in = hic->inputs().at(0);
+  Val* y_in = hic->inputs().at(1);
+  HostIrEvaluator hie(std::move(hic), communicator_);
+  auto options = at::TensorOptions().device(communicator_->device());
+  at::Tensor unsharded_x = at::randn({d, kTensorSize}, options);
+  at::Tensor unsharded_y = at::randn({d, kTensorSize}, options);
+  auto outputs = hie.runWithInput(
+      {{x_in, shardTensor(unsharded_x, 0, mesh)},
+       {y_in, shardTensor(unsharded_y, 0, mesh)}});
+
+  EXPECT_TRUE(at::allclose(outputs.at(0), unsharded_x.sum(0), 1e-4, 1e-4));
+  EXPECT_TRUE(at::allclose(outputs.at(1), unsharded_y.sum(0), 1e-4, 1e-4));
+}
+
+using PrefetchAllgathersTest = MultiDeviceTest;
+
+// The allgather of the second layer's parameter is posted before the first
+// layer, and the gathered parameters are deallocated after their last use
+TEST_F(PrefetchAllgathersTest, TwoLayers) {
+  constexpr int64_t kHiddenSize = 1024;
+  const int64_t d = communicator_->size();
+  auto mesh = DeviceMesh::createForNumDevices(d);
+
+  // A layer adds its gathered parameter to its activation
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* in_fusion = makeContigConcreteTensor({d, kHiddenSize});
+  TensorView* w_fusion = makeContigConcreteTensor({d, kHiddenSize});
+  TensorView* out_fusion = add(in_fusion, w_fusion);
+  fusion->addInput(in_fusion);
+  fusion->addInput(w_fusion);
+  fusion->addOutput(out_fusion);
+  for (auto* tv : {in_fusion, w_fusion, out_fusion}) {
+    tv->setDeviceMesh(mesh);
+  }
+
+  auto hic = std::make_unique<HostIrContainer>();
+  FusionGuard::setCurFusion(hic.get());
+  auto* hu = IrBuilder::create<HostUnit>(std::move(fusion));
+
+  auto make_tensor = [&]() {
+    TensorView* tv = makeContigConcreteTensor({d, kHiddenSize});
+    tv->setDeviceMesh(mesh);
+    return tv;
+  };
+  std::vector<TensorView*> activations = {make_tensor()};
+  std::vector<TensorView*> shards;
+  std::vector<TensorView*> parameters;
+  hic->addInput(activations.front());
+  for ([[maybe_unused]] auto layer : c10::irange(2)) {
+    TensorView* shard = make_tensor();
+    shard->axis(0)->parallelize(ParallelType::DIDx);
+    TensorView* parameter = make_tensor();
+    TensorView* activation = make_tensor();
+    hic->addInput(shard);
+
+    auto* allocate =
+        IrBuilder::create<kir::Allocate>(parameter, MemoryType::Global);
+    auto* communication = IrBuilder::create<Communication>(
+        CommunicationType::Allgather, parameter, shard, mesh.vector());
+    auto* wait = IrBuilder::create<Wait>(communication);
+    auto* post_compute = IrBuilder::create<PostOnStream>(
+        hu,
+        std::vector<Val*>{activations.back(), parameter},
+        std::vector<Val*>{activation});
+    for (Expr* expr : std::vector<Expr*>{allocate, communication, wait}) {
+      hic->pushBackTopLevelExprs(expr);
+    }
+    hic->pushBackTopLevelExprs(post_compute);
+
+    shards.push_back(shard);
+    parameters.push_back(parameter);
+    activations.push_back(activation);
+  }
+  hic->addOutput(activations.back());
+
+  // The budget fits one prefetched parameter
+  prefetchAllgathers(
+      hic.get(),
+      /*max_distance=*/1,
+      /*memory_budget_bytes=*/d * kHiddenSize * (int64_t)sizeof(float));
+
+  const auto& top_level_exprs = hic->topLevelExprs();
+  auto first_compute = std::find_if(
+      top_level_exprs.begin(), top_level_exprs.end(), [](Expr* expr) {
+        return expr->isA<PostOnStream>();
+      });
+  EXPECT_EQ(
+      std::count_if(
+          top_level_exprs.begin(),
+          first_compute,
+          [](Expr* expr) { return expr->isA<Communication>(); }),
+      2);
+  EXPECT_EQ(
+      std::count_if(
+          top_level_exprs.begin(),
+          top_level_exprs.end(),
+          [](Expr* expr) { return expr->isA<Deallocate>(); }),
+      2);
+
+  HostIrEvaluator hie(std::move(hic), communicator_);
+  auto options = at::TensorOptions().device(communicator_->device());
+  at::Tensor in = at::randn({d, kHiddenSize}, options);
+  std::vector<at::Tensor> unsharded_parameters = {
+      at::randn({d, kHiddenSize}, options),
+      at::randn({d, kHiddenSize}, options)};
+  auto outputs = hie.runWithInput(
+      {{activations.front(), in},
+       {shards.at(0), shardTensor(unsharded_parameters.at(0), 0, mesh)},
+       {shards.at(1), shardTensor(unsharded_parameters.at(1), 0, mesh)}});
+
+  EXPECT_TRUE(at::allclose(
+      outputs.at(0),
+      in + unsharded_parameters.at(0) + unsharded_parameters.at(1)));
+}
+
+using StreamParallelLoopTest = MultiDeviceTest;
+
+// A chain of compute and an allgather, all stream-parallel on their outermost
+// axis, is lowered into one host loop computing it slice by slice
+TEST_F(StreamParallelLoopTest, ComputeAllgatherCompute) {
+  constexpr int64_t kNumSlices = 4;
+  constexpr int64_t kHiddenSize = 256;
+  const int64_t d = communicator_->size();
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* x = makeContigTensor(3); // [Stream(S), DIDx(D), H]
+  TensorView* y = mul(x, x);
+  TensorView* z = set(y); // [Stream(S), D, H]
+  TensorView* w = add(z, z);
+  fusion->addInput(x);
+  fusion->addOutput(w);
+
+  auto mesh = DeviceMesh::createForNumDevices(d);
+  for (auto* tv : {x, y, z, w}) {
+    tv->setDeviceMesh(mesh);
+    tv->axis(0)->parallelize(ParallelType::Stream);
+  }
+  x->axis(1)->parallelize(ParallelType::DIDx);
+  y->axis(1)->parallelize(ParallelType::DIDx);
+
+  std::unique_ptr<HostIrContainer> hic =
+      HostIrLower::lower(std::move(fusion), communicator_->deviceId());
+  const auto& top_level_exprs = hic->topLevelExprs();
+  EXPECT_EQ(
+      std::count_if(
+          top_level_exprs.begin(),
+          top_level_exprs.end(),
+          [](Expr* expr) { return expr->isA<ForLoop>(); }),
+      1);
+  EXPECT_TRUE(std::none_of(
+      top_level_exprs.begin(), top_level_exprs.end(), [](Expr* expr) {
+        return expr->isA<PostOnStream>() || expr->isA<Communication>();
+      }));
+
+  Val* x_in = hic->inputs().at(0);
+  HostIrEvaluator hie(std::move(hic), communicator_);
+  auto options = at::TensorOptions().device(communicator_->device());
+  at::Tensor unsharded_x = at::randn({kNumSlices, d, kHiddenSize}, options);
+  auto outputs = hie.runWithInput({{x_in, shardTensor(unsharded_x, 1, mesh)}});
+
+  EXPECT_TRUE(at::allclose(outputs.at(0), unsharded_x * unsharded_x * 2));
+}
+
+using CommunicationProfileTest = MultiDeviceTest;
+
+// The allreduce of a host program is timed by the FusionProfiler, and the
+// profiles of all ranks are aggregated in a timeline
+TEST_F(CommunicationProfileTest, Allreduce) {
+  constexpr int64_t kTensorSize = 1 << 20;
+  const int64_t d = communicator_->size();
+  auto mesh = DeviceMesh::createForNumDevices(d);
+
+  auto hic = std::make_unique<HostIrContainer>();
+  FusionGuard fg(hic.get());
+  TensorView* in = makeContigTensor(1);
+  TensorView* out = makeContigTensor(1);
+  in->setDeviceMesh(mesh);
+  out->setDeviceMesh(mesh);
+  auto* allreduce = IrBuilder::create<Communication>(
+      CommunicationType::Allreduce,
+      out,
+      in,
+      mesh.vector(),
+      /*root=*/-1,
+      RedOpType::SUM);
+  auto* wait = IrBuilder::create<Wait>(allreduce);
+  hic->pushBackTopLevelExprs(allreduce);
+  hic->pushBackTopLevelExprs(wait);
+  hic->addInput(in);
+  hic->addInput(out);
+
+  HostIrEvaluator hie(std::move(hic), communicator_);
+  auto options =
+      at::TensorOptions().dtype(at::kFloat).device(communicator_->device());
+  at::Tensor in_tensor = at::ones({kTensorSize}, options);
+  at::Tensor out_tensor = at::empty({kTensorSize}, options);
+
+  ProfilerOptionsGuard opt_guard;
+  ProfilerOptionsGuard::getCurOptions().set(ProfilerOption::EnableNocupti);
+  communicator_->barrier();
+  FusionProfiler::start(/*cupti_disable=*/true);
+  hie.runWithInput({{in, in_tensor}, {out, out_tensor}});
+  FusionProfiler::stop();
+
+  EXPECT_TRUE(at::allclose(out_tensor, in_tensor * d));
+  const FusionProfile& profile = FusionProfiler::profile();
+  ASSERT_EQ(profile.communication_profiles.size(), 1);
+  const CommunicationProfile& cprof = profile.communication_profiles.at(0);
+  EXPECT_EQ(cprof.team_size, d);
+  EXPECT_EQ(cprof.bytes, kTensorSize * 4);
+  EXPECT_GT(cprof.time_ms, 0.0);
+  EXPECT_GE(cprof.start_ms, 0.0);
+  EXPECT_GT(cprof.algorithm_bandwidth_gbs, 0.0);
+  EXPECT_GE(cprof.bus_bandwidth_gbs, cprof.algorithm_bandwidth_gbs);
+  EXPECT_EQ(profile.communication_time_ms, cprof.time_ms);
+
+  std::vector<CommunicationTimelineEntry> timeline =
+      aggregateCommunicationProfiles(communicator_, profile);
+  ASSERT_EQ(timeline.size(), 1);
+  EXPECT_EQ(timeline.at(0).bytes, cprof.bytes);
+  EXPECT_LE(timeline.at(0).min_time_ms, cprof.time_ms);
+  EXPECT_GE(timeline.at(0).max_time_ms, cprof.time_ms);
+  EXPECT_GE(timeline.at(0).straggler, 0);
+  EXPECT_LT(timeline.at(0).straggler, d);
+  EXPECT_FALSE(timeline.at(0).serialized);
+}
+
 using OverlapDistributedMatmulTest = MultiDeviceTest;
 
 TEST_F(OverlapDistributedMatmulTest, AG_matmul) {
@@ -408,6 +823,187 @@ TEST_F(OverlapDistributedMatmulTest, AG_matmul) {
   EXPECT_TRUE(torch::allclose(tc_ref, tc, 1e-2, 1e-2));
 }
 
+// Slices too small for the ring of send/recv to pay off fall back to
+// allgathers at runtime
+TEST_F(OverlapDistributedMatmulTest, AG_matmul_SmallSlices) {
+  constexpr int64_t M = 1024;
+  constexpr int64_t K = 64;
+  constexpr int64_t N = 32;
+  constexpr int64_t S = 4;
+  const int64_t D = communicator_->size();
+  if (M % (D * S) != 0) {
+    GTEST_SKIP() << "M must be a multiple of D * S, but got M = " << M
+                 << ", D = " << D << ", S = " << S;
+  }
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* a = makeContigTensor(4); //[S, DIDx(D), M/(S*D), K]
+  TensorView* b = makeContigTensor(2); //[K, N]
+  TensorView* c = matmul(a, b); //[S, D, M/(S*D), N]
+
+  fusion->addInput(a);
+  fusion->addInput(b);
+  fusion->addOutput(c);
+
+  auto mesh = DeviceMesh::createForNumDevices(D);
+  a->setDeviceMesh(mesh);
+  b->setDeviceMesh(mesh);
+  c->setDeviceMesh(mesh);
+
+  a->axis(1)->parallelize(ParallelType::DIDx);
+  c->axis(0)->parallelize(ParallelType::Stream);
+
+  MultiDeviceExecutor executor(std::move(fusion), *communicator_);
+
+  auto tensor_options =
+      at::TensorOptions().dtype(at::kFloat).device(communicator_->device());
+  at::Tensor ta_unsharded = at::randn({S, D, M / (S * D), K}, tensor_options);
+  at::Tensor ta = ta_unsharded.slice(
+      1, communicator_->deviceId(), communicator_->deviceId() + 1);
+  at::Tensor tb = at::randn({K, N}, tensor_options);
+
+  at::Tensor tc = executor.runWithInput({ta, tb}).at(0);
+
+  EXPECT_TRUE(torch::allclose(at::matmul(ta_unsharded, tb), tc, 1e-3, 1e-3));
+}
+
+TEST_F(OverlapDistributedMatmulTest, matmul_RS) {
+  constexpr int64_t M = 8192;
+  constexpr int64_t K = 8192;
+  constexpr int64_t N = 1024;
+  constexpr int64_t S = 8;
+  const int64_t D = communicator_->size();
+  if (M % (D * S) != 0 || K % D != 0) {
+    GTEST_SKIP() << "M must be a multiple of D * S and K a multiple of D, "
+                 << "but got M = " << M << ", K = " << K << ", D = " << D
+                 << ", S = " << S;
+  }
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* a = makeContigTensor(5); //[S, DIDx(D), D, M/(S*D), K/D]
+  TensorView* b = makeContigTensor(4); //[DIDx(D), 1, K/D, N]
+  TensorView* c_unreduced = matmul(a, b); //[S, DIDx(D), D, M/(S*D), N]
+  // [Stream(S), r(D), DIDx(D), M/(S*D), N]
+  TensorView* c = sum(c_unreduced, {1});
+
+  fusion->addInput(a);
+  fusion->addInput(b);
+  fusion->addOutput(c);
+
+  auto mesh = DeviceMesh::createForNumDevices(D);
+  for (auto tv : {a, b, c_unreduced, c}) {
+    tv->setDeviceMesh(mesh);
+  }
+
+  a->axis(1)->parallelize(ParallelType::DIDx);
+  b->axis(0)->parallelize(ParallelType::DIDx);
+  c_unreduced->axis(1)->parallelize(ParallelType::DIDx);
+  c->axis(0)->parallelize(ParallelType::Stream);
+  c->axis(2)->parallelize(ParallelType::DIDx);
+
+  MultiDeviceExecutor executor(std::move(fusion), *communicator_);
+
+  auto tensor_options =
+      at::TensorOptions().dtype(at::kFloat).device(communicator_->device());
+  const int64_t my_device_index = communicator_->deviceId();
+  at::Tensor ta_unsharded =
+      at::randn({S, D, D, M / (S * D), K / D}, tensor_options);
+  at::Tensor ta = ta_unsharded.slice(1, my_device_index, my_device_index + 1);
+  at::Tensor tb_unsharded = at::randn({D, 1, K / D, N}, tensor_options);
+  at::Tensor tb = tb_unsharded.slice(0, my_device_index, my_device_index + 1);
+  at::Tensor tc_ref = at::matmul(ta_unsharded, tb_unsharded)
+                          .sum(1)
+                          .slice(1, my_device_index, my_device_index + 1);
+
+  std::vector<c10::IValue> inputs = {ta, tb};
+  at::Tensor tc;
+
+  constexpr int64_t kNumberOfIterations = 20;
+  constexpr int64_t kNumberOfWarmupIterations = 5;
+  for (auto i : c10::irange(kNumberOfIterations)) {
+    if (i == kNumberOfWarmupIterations) {
+      cudaProfilerStart();
+    }
+    tc = executor.runWithInput(inputs).at(0);
+  }
+  cudaProfilerStop();
+
+  EXPECT_TRUE(torch::allclose(tc_ref, tc, 1e-1, 1e-1));
+}
+
+using RingAttentionTest = MultiDeviceTest;
+
+TEST_F(RingAttentionTest, SequenceParallelSdpa) {
+  NVFUSER_TEST_CUDA_ARCH_GUARD(8, 0);
+  constexpr int64_t N = 2;
+  constexpr int64_t H = 4;
+  constexpr int64_t L = 128; // Sequence length per device
+  constexpr int64_t E = 64;
+  const int64_t D = communicator_->size();
+  if (D < 2) {
+    GTEST_SKIP() << "Needs at least two devices";
+  }
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* q = makeContigTensor(4, DataType::BFloat16); // [N, H, D*L, E]
+  TensorView* k = makeContigTensor(4, DataType::BFloat16);
+  TensorView* v = makeContigTensor(4, DataType::BFloat16);
+  fusion->addInput(q);
+  fusion->addInput(k);
+  fusion->addInput(v);
+  auto [attn, lse, philox_seed, philox_offset] = sdpfa_fwd(
+      q,
+      k,
+      v,
+      /*dropout_p=*/IrBuilder::create<Val>(0.0),
+      /*is_causal=*/IrBuilder::create<Val>(false),
+      /*scale=*/nullptr);
+  fusion->addOutput(attn);
+  fusion->addOutput(lse);
+
+  // [N, H, DIDx(D), L, E]
+  auto mesh = DeviceMesh::createForNumDevices(D);
+  for (TensorView* tv : {q, k, v, attn, lse}) {
+    tv->setDeviceMesh(mesh);
+    tv->split(2, D, /*inner_split=*/false);
+    tv->axis(2)->parallelize(ParallelType::DIDx);
+    tv->setAllocationDomain(tv->getLoopDomain(), true);
+  }
+  for (TensorView* tv : {philox_seed, philox_offset}) {
+    tv->setDeviceMesh(mesh);
+  }
+
+  auto tensor_options =
+      at::TensorOptions().dtype(at::kBFloat16).device(communicator_->device());
+  at::Tensor q_tensor = at::randn({N, H, D * L, E}, tensor_options);
+  at::Tensor k_tensor = at::randn({N, H, D * L, E}, tensor_options);
+  at::Tensor v_tensor = at::randn({N, H, D * L, E}, tensor_options);
+  auto ref = at::_scaled_dot_product_flash_attention(
+      q_tensor,
+      k_tensor,
+      v_tensor,
+      /*dropout_p=*/0.0,
+      /*is_causal=*/false,
+      /*return_debug_mask=*/false);
+
+  MultiDeviceExecutor executor(std::move(fusion), *communicator_);
+  std::vector<at::Tensor> outputs = executor.runWithInput(
+      {shardTensor(q_tensor, q),
+       shardTensor(k_tensor, k),
+       shardTensor(v_tensor, v)});
+
+  EXPECT_TRUE(at::allclose(
+      outputs.at(0), shardTensor(std::get<0>(ref), attn), 1e-2, 1e-2));
+  EXPECT_TRUE(at::allclose(
+      outputs.at(1), shardTensor(std::get<1>(ref), lse), 1e-3, 1e-3));
+}
+
 } // namespace hir
 
 } // namespace nvfuser
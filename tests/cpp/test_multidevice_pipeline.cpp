@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
+#include <gmock/gmock-matchers.h>
 #include <gtest/gtest.h>
 
 #include <algorithm>
@@ -18,6 +19,7 @@
 #include <expr_evaluator.h>
 #include <fusion.h>
 #include <fusion_segmenter.h>
+#include <host_ir/pipeline.h>
 #include <ir/all_nodes.h>
 #include <ir/graphviz.h>
 #include <ir/iostream.h>
@@ -59,6 +61,7 @@ class PipelineTest : public MultiDeviceTest {
   std::vector<at::Tensor> outputs;
   std::vector<at::Tensor> ref_unsharded_outputs;
   hir::HostIrEvaluatorParams host_ir_executor_params;
+  PipelineParams pipeline_params;
 };
 
 void PipelineTest::validate(bool validate_with_prescribed_values) {
@@ -127,7 +130,8 @@ void PipelineTest::executeAndValidate(bool validate_with_prescribed_values) {
   runtime = std::make_unique<MultiDeviceExecutor>(
       std::make_unique<Fusion>(*fusion),
       *communicator_,
-      host_ir_executor_params);
+      host_ir_executor_params,
+      pipeline_params);
   auto error_msg = runtime->validate();
   if (error_msg != "") {
     GTEST_SKIP() << error_msg;
@@ -588,4 +592,136 @@ INSTANTIATE_TEST_SUITE_P(
         SchedulingMode::Automatic),
     testing::PrintToStringParamName());
 
+using PipelineScheduleTest = NVFuserTest;
+
+TEST_F(PipelineScheduleTest, OneFOneB) {
+  using Steps = std::vector<PipelineStep>;
+  // Forward stages 0 to 2 and backward stages 2 to 4. Rank 2 runs its forward
+  // and backward as stage 2.
+  const std::vector<int64_t> stage_ranks = {0, 1, 2, 1, 0};
+  EXPECT_EQ(
+      pipelineSteps(PipelineSchedule::OneFOneB, stage_ranks, 4, 0),
+      (Steps{{0, 0}, {0, 1}, {0, 2}, {4, 0}, {0, 3}, {4, 1}, {4, 2}, {4, 3}}));
+  EXPECT_EQ(
+      pipelineSteps(PipelineSchedule::OneFOneB, stage_ranks, 4, 1),
+      (Steps{{1, 0}, {1, 1}, {3, 0}, {1, 2}, {3, 1}, {1, 3}, {3, 2}, {3, 3}}));
+  EXPECT_EQ(
+      pipelineSteps(PipelineSchedule::OneFOneB, stage_ranks, 4, 2),
+      (Steps{{2, 0}, {2, 1}, {2, 2}, {2, 3}}));
+  // Fewer micro-batches than warmup steps
+  EXPECT_EQ(
+      pipelineSteps(PipelineSchedule::OneFOneB, stage_ranks, 1, 0),
+      (Steps{{0, 0}, {4, 0}}));
+
+  // Forward only
+  EXPECT_EQ(
+      pipelineSteps(PipelineSchedule::OneFOneB, {0, 1}, 2, 1),
+      (Steps{{1, 0}, {1, 1}}));
+
+  EXPECT_THAT(
+      [&]() { pipelineSteps(PipelineSchedule::OneFOneB, {0, 1, 0, 1}, 4, 0); },
+      ::testing::ThrowsMessage<nvfuser::nvfError>(
+          ::testing::HasSubstr("must run on rank")));
+}
+
+TEST_F(PipelineScheduleTest, Interleaved) {
+  using Steps = std::vector<PipelineStep>;
+  // Two chunks per rank
+  const std::vector<int64_t> stage_ranks = {0, 1, 0, 1};
+  EXPECT_EQ(
+      pipelineSteps(PipelineSchedule::Interleaved, stage_ranks, 4, 0),
+      (Steps{{0, 0}, {0, 1}, {2, 0}, {2, 1}, {0, 2}, {0, 3}, {2, 2}, {2, 3}}));
+  EXPECT_EQ(
+      pipelineSteps(PipelineSchedule::Interleaved, stage_ranks, 4, 1),
+      (Steps{{1, 0}, {1, 1}, {3, 0}, {3, 1}, {1, 2}, {1, 3}, {3, 2}, {3, 3}}));
+
+  EXPECT_THAT(
+      [&]() {
+        pipelineSteps(PipelineSchedule::Interleaved, stage_ranks, 3, 0);
+      },
+      ::testing::ThrowsMessage<nvfuser::nvfError>(
+          ::testing::HasSubstr("must be a multiple of its number of ranks")));
+}
+
+class PipelineTestMicroBatches
+    : public PipelineTest,
+      public testing::WithParamInterface<PipelineSchedule> {};
+
+TEST_P(PipelineTestMicroBatches, Schedule) {
+  if (communicator_->size() < 2) {
+    GTEST_SKIP() << "Needs at least two devices";
+  }
+  if (!disable_skip &&
+      !communicator_->isBackendAvailable(CommunicatorBackend::kNccl)) {
+    GTEST_SKIP() << "Backend not available";
+  }
+  pipeline_params.schedule = GetParam();
+  pipeline_params.num_micro_batches = 4;
+  constexpr int64_t B = 64;
+  constexpr int64_t H = 8;
+
+  // 1F1B: a forward stage on each device, and the backward stage of device 0.
+  // Interleaved: two forward chunks on each device.
+  std::vector<DeviceMesh> stage_meshes = {
+      DeviceMesh({0}), DeviceMesh({1}), DeviceMesh({0})};
+  if (pipeline_params.schedule == PipelineSchedule::Interleaved) {
+    stage_meshes.push_back(DeviceMesh({1}));
+  }
+
+  FusionGuard fg(fusion.get());
+  TensorView* x = makeContigTensor(2);
+  TensorView* w = makeContigTensor(1);
+  fusion->addInput(x);
+  fusion->addInput(w);
+  // The weight isn't micro-batched
+  TensorView* bw = broadcast(w, {true, false});
+  TensorView* activation = add(x, bw);
+  for (auto* tv : {x, w, bw, activation}) {
+    tv->setDeviceMesh(stage_meshes.front());
+  }
+  x->axis(0)->parallelize(ParallelType::Stream);
+  activation->axis(0)->parallelize(ParallelType::Stream);
+
+  // Integers keep the reference exact regardless of the order of the sums
+  at::Tensor x_tensor = at::randint(-3, 4, {B, H}, tensor_options);
+  at::Tensor w_tensor = at::randint(-3, 4, {H}, tensor_options);
+  at::Tensor activation_tensor = x_tensor + w_tensor;
+  TensorView* tv = activation;
+  at::Tensor ref = activation_tensor;
+  for (auto stage : c10::irange(1, stage_meshes.size())) {
+    TensorView* received = set(tv);
+    if (stage == 1) {
+      tv = mul(received, received);
+      ref = ref * ref;
+    } else if (pipeline_params.schedule == PipelineSchedule::OneFOneB) {
+      // The backward stage reads an activation of the forward stage computed
+      // on the same device
+      tv = add(received, activation);
+      ref = ref + activation_tensor;
+    } else {
+      tv = add(received, received);
+      ref = ref + ref;
+    }
+    for (auto* stage_tv : {received, tv}) {
+      stage_tv->setDeviceMesh(stage_meshes.at(stage));
+      stage_tv->axis(0)->parallelize(ParallelType::Stream);
+    }
+  }
+  // Outputs that aren't micro-batched are summed over the micro-batches
+  TensorView* tv_sum = sum(tv, {0});
+  tv_sum->setDeviceMesh(stage_meshes.back());
+  fusion->addOutput(tv);
+  fusion->addOutput(tv_sum);
+
+  unsharded_inputs = {x_tensor, w_tensor};
+  ref_unsharded_outputs = {ref, ref.sum(0)};
+  executeAndValidate(/*validate_with_prescribed_values=*/true);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ,
+    PipelineTestMicroBatches,
+    testing::Values(PipelineSchedule::OneFOneB, PipelineSchedule::Interleaved),
+    testing::PrintToStringParamName());
+
 } // namespace nvfuser
@@ -9,6 +9,8 @@
 #include <gtest/gtest.h>
 
 #include <device_lower/analysis/bank_conflict.h>
+#include <device_lower/analysis/register_pressure.h>
+#include <device_lower/lower2device.h>
 #include <logical_domain_map.h>
 #include <ops/all_ops.h>
 #include <scheduler/all_schedulers.h>
@@ -1352,4 +1354,77 @@ TEST_F(PersistentBufferTest, GetResolutionIssue1123) {
       std::vector<TensorView*>{tv7});
 }
 
+// The register estimate of a persistent kernel covers the persistent buffer
+// of each thread
+TEST_F(PersistentBufferTest, RegisterPressureEstimate) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = softmax(tv0, 1);
+  fusion->addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<c10::IValue> aten_inputs = {at::randn({1024, 4096}, options)};
+  SchedulerRuntimeInfo runtime_info(fusion.get(), aten_inputs);
+  auto scheduler =
+      SchedulerEntry::makeSchedulerInstance(SchedulerType::InnerPersistent);
+  auto heuristic_params =
+      scheduler->computeHeuristics(fusion.get(), runtime_info);
+  scheduler->schedule(fusion.get(), heuristic_params.get());
+  auto rparams = heuristic_params->as<ReductionParams>();
+  const int64_t buffer_per_thread =
+      rparams->batches_per_block_inner_reduction *
+      rparams->unroll_factor_inner_reduction;
+
+  GpuLower lower(fusion.get(), heuristic_params->cparams);
+  EXPECT_GE(estimateRegistersPerThread(lower.run()), buffer_per_thread);
+}
+
+// Rows too long for the registers and shared memory of a block are split
+// across a grid, and the Welford states are combined with a grid allreduce
+TEST_F(PersistentBufferTest, GridPersistentLayerNorm) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::GridPersistentNormalization);
+
+  const std::vector<int64_t> input_shape = {2, 1 << 20};
+  const int64_t blocks_per_row = ceilDiv(
+      input_shape[1] * (int64_t)sizeof(float),
+      scheduler_utils::register_file_size);
+  if (input_shape[0] * blocks_per_row > deviceSMCount()) {
+    GTEST_SKIP() << "Not enough SMs to run this test";
+  }
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  constexpr float kEps = 1e-5;
+  const std::vector<int64_t> norm_shape = {input_shape[1]};
+  auto result = layer_norm(
+      tv0, norm_shape, nullptr, nullptr, IrBuilder::create<Val>(kEps));
+  fusion->addOutput(result.output);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn(input_shape, options);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto cg_outputs = executor_cache.runFusionWithInputs({t0});
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_FALSE(runtime->isSegmented());
+  const auto& heuristic_params =
+      runtime->schedulerHeuristics()->heuristicsList().at(0);
+  ASSERT_EQ(heuristic_params->scheduler_type, SchedulerType::InnerPersistent);
+  auto rparams = heuristic_params->as<ReductionParams>();
+  EXPECT_TRUE(rparams->cross_grid_inner_reduction);
+  EXPECT_TRUE(rparams->smem_persistent_buffers.empty());
+
+  auto t1 = at::layer_norm(t0, norm_shape, {}, {}, kEps);
+  testValidate(
+      executor_cache.fusion(), cg_outputs, {t0}, {t1}, __LINE__, __FILE__);
+}
+
 } // namespace nvfuser
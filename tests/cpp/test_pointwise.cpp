@@ -1282,4 +1282,194 @@ TEST_F(NVFuserTest, DomainMapBroadcastIssue3653) {
       executor_cache.fusion(), out_tensors, inputs, __LINE__, __FILE__);
 }
 
+// On Hopper, the 1D schedule loads the full sized input with TMA and the
+// broadcast one with a plain load. The TMA boxes are circular buffered by a
+// producer warp group.
+TEST_F(PointwiseTest, TmaLoad) {
+  NVFUSER_TEST_CUDA_ARCH_GUARD(9, 0);
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::TmaPointwise);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(1);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  auto tv2 = broadcast(tv1, {true, false});
+  auto tv3 = add(tv0, tv2);
+  fusion->addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({8192, 1000}, options);
+  auto t1 = at::randn({1000}, options);
+
+  auto cg_results =
+      scheduleAndRun(fusion.get(), SchedulerType::PointWise, {t0, t1});
+  auto pparams = cg_results.heuristic_params->as<PointwiseParams>();
+  EXPECT_TRUE(pparams->use_tma_load);
+  EXPECT_EQ(pparams->break_point, 0);
+  EXPECT_EQ(pparams->lparams.bdimx(), 256);
+
+  auto* tma_load = ir_utils::consumerTvsOf(tv0).at(0);
+  EXPECT_EQ(tma_load->getMemoryType(), MemoryType::Shared);
+  EXPECT_EQ(
+      tma_load->definition()->as<LoadStoreOp>()->opType(),
+      LoadStoreOpType::CpAsyncBulkTensorTile);
+  EXPECT_EQ(pparams->tma_circular_buffer_stages, 4);
+  ASSERT_TRUE(tma_load->isCircularBuffered());
+  EXPECT_EQ(tma_load->circularBufferOptions().stage, 4);
+  EXPECT_TRUE(std::holds_alternative<WarpSpecialized>(
+      tma_load->circularBufferOptions().type));
+  EXPECT_EQ(
+      ir_utils::consumerTvsOf(tv1).at(0)->getMemoryType(), MemoryType::Local);
+
+  testValidate(fusion.get(), cg_results.outputs, {t0, t1}, __LINE__, __FILE__);
+}
+
+// Inputs at different misaligned offsets share one kernel that peels the
+// misaligned head and tail and vectorizes the rest
+TEST_F(PointwiseTest, MisalignedVectorize) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::MisalignedVectorize);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  auto tv2 = add(sin(tv0), tv1);
+  fusion->addOutput(tv2);
+
+  constexpr int64_t kRows = 1024;
+  constexpr int64_t kCols = 1027;
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor buffer = at::randn({kRows * kCols + 3}, options);
+  at::Tensor t1 = at::randn({kRows, kCols}, options);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  for (int64_t offset : {1, 2, 3}) {
+    at::Tensor t0 =
+        buffer.narrow(0, offset, kRows * kCols).view({kRows, kCols});
+    auto outputs = executor_cache.runFusionWithInputs({t0, t1});
+    testValidate(
+        executor_cache.fusion(), outputs, {t0, t1}, __LINE__, __FILE__);
+
+    FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+    const PointwiseParams* pparams = runtime->schedulerHeuristics()
+                                         ->heuristicsList()
+                                         .at(0)
+                                         ->as<PointwiseParams>();
+    EXPECT_TRUE(pparams->vectorize_misaligned);
+    EXPECT_EQ(pparams->vectorization_factor, 4);
+  }
+  EXPECT_EQ(executor_cache.countRuntimes(), 1);
+}
+
+TEST_F(PointwiseTest, GridStride) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::GridStridePointwise);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(1);
+  auto tv1 = makeContigTensor(1);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  auto tv2 = add(sin(tv0), tv1);
+  fusion->addOutput(tv2);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  FusionExecutorCache executor_cache(std::move(fusion));
+  // Both sizes need more than one wave, so they launch the same grid
+  std::vector<int64_t> grid_stride_blocks;
+  for (int64_t size : {1L << 24, (1L << 24) + 5}) {
+    at::Tensor t0 = at::randn({size}, options);
+    at::Tensor t1 = at::randn({size}, options);
+    auto outputs = executor_cache.runFusionWithInputs({t0, t1});
+    testValidate(
+        executor_cache.fusion(), outputs, {t0, t1}, __LINE__, __FILE__);
+
+    FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+    const PointwiseParams* pparams = runtime->schedulerHeuristics()
+                                         ->heuristicsList()
+                                         .at(0)
+                                         ->as<PointwiseParams>();
+    EXPECT_GT(pparams->grid_stride_blocks, 0);
+    grid_stride_blocks.push_back(pparams->grid_stride_blocks);
+  }
+  EXPECT_EQ(grid_stride_blocks.at(0), grid_stride_blocks.at(1));
+}
+
+TEST_F(PointwiseTest, GridSwizzle) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::GridSwizzle);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(1);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  auto tv2 = add(tv0, broadcast(tv1, {true, false}));
+  fusion->addOutput(tv2);
+
+  // The broadcast row is read by each row of tiles, which are longer than a
+  // wave of CTAs
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({16, 1 << 22}, options);
+  at::Tensor t1 = at::randn({1 << 22}, options);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0, t1});
+  testValidate(executor_cache.fusion(), outputs, {t0, t1}, __LINE__, __FILE__);
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  const PointwiseParams* pparams = runtime->schedulerHeuristics()
+                                       ->heuristicsList()
+                                       .at(0)
+                                       ->as<PointwiseParams>();
+  EXPECT_GT(pparams->break_point, 0);
+  EXPECT_GT(pparams->grid_swizzle_factor, 1);
+}
+
+TEST_F(PointwiseTest, SmemBroadcastInputs) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::SmemBroadcastInputs);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(1);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  auto tv2 = add(tv0, broadcast(tv1, {true, false}));
+  fusion->addOutput(tv2);
+
+  // The rows are too short for a block, which is split across several rows
+  // reading the same bias
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({8192, 256}, options);
+  at::Tensor t1 = at::randn({256}, options);
+  std::vector<c10::IValue> aten_inputs = {t0, t1};
+
+  auto cg_results =
+      scheduleAndRun(fusion.get(), SchedulerType::PointWise, aten_inputs);
+  auto pparams = cg_results.heuristic_params->as<PointwiseParams>();
+  EXPECT_TRUE(pparams->split_block);
+  EXPECT_TRUE(pparams->smem_broadcast_inputs);
+  EXPECT_EQ(
+      ir_utils::consumerTvsOf(tv1).at(0)->getMemoryType(), MemoryType::Shared);
+  EXPECT_EQ(
+      ir_utils::consumerTvsOf(tv0).at(0)->getMemoryType(), MemoryType::Local);
+  testValidate(
+      fusion.get(), cg_results.outputs, aten_inputs, __LINE__, __FILE__);
+}
+
 } // namespace nvfuser
@@ -13,6 +13,7 @@
 #include <tests/cpp/utils.h>
 
 #include <polymorphic_value.h>
+#include <scalar_value.h>
 #include <type.h>
 
 namespace nvfuser {
@@ -161,4 +162,38 @@ TEST_F(PolymorphicValueTest, Struct) {
   }
 }
 
+TEST_F(PolymorphicValueTest, ScalarValue) {
+  ScalarValue empty;
+  EXPECT_FALSE(empty.hasValue());
+  // Complex numbers are not supported
+  EXPECT_FALSE(ScalarValue::fromPolymorphicValue(
+                   PolymorphicValue(std::complex<double>(1.0, 2.0)))
+                   .hasValue());
+  EXPECT_FALSE(empty.toPolymorphicValue().hasValue());
+
+  for (const PolymorphicValue& value :
+       {PolymorphicValue(3L), PolymorphicValue(2.5), PolymorphicValue(true)}) {
+    ScalarValue scalar = ScalarValue::fromPolymorphicValue(value);
+    EXPECT_TRUE(scalar.hasValue());
+    EXPECT_TRUE(PolymorphicValue_functions::isSame(
+        scalar.toPolymorphicValue(), value));
+  }
+
+  ScalarValue i = ScalarValue::fromPolymorphicValue(PolymorphicValue(3L));
+  EXPECT_TRUE(i.is<int64_t>());
+  EXPECT_FALSE(i.is<double>());
+  EXPECT_EQ(i.as<int64_t>(), 3);
+  EXPECT_THAT(
+      [&]() { i.as<double>(); },
+      ::testing::ThrowsMessage<nvfuser::nvfError>(
+          ::testing::HasSubstr("does not hold the requested type")));
+
+  // Values of different kinds are never equal
+  EXPECT_EQ(i, ScalarValue(3L));
+  EXPECT_NE(i, ScalarValue(4L));
+  EXPECT_NE(i, ScalarValue(3.0));
+  EXPECT_NE(ScalarValue(true), ScalarValue(1L));
+  EXPECT_EQ(empty, ScalarValue());
+}
+
 } // namespace nvfuser
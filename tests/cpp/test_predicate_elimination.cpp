@@ -481,4 +481,53 @@ TEST_F(PredicateEliminationTest, ExtentEqualToMaxParallelTypeExtent) {
   testValidate(&fusion, cg_outputs, {t0}, {t0}, __LINE__, __FILE__);
 }
 
+// A global intermediate allocated by its loop domain is padded to the
+// multiple of the split factor, so writing it doesn't need a predicate
+TEST_F(PredicateEliminationTest, PadGlobalIntermediates) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(1);
+  fusion.addInput(tv0);
+  auto tv1 = set(tv0);
+  auto tv2 = add(tv1, IrBuilder::create<Val>(1.0));
+  auto tv3 = mul(tv2, IrBuilder::create<Val>(2.0));
+  fusion.addOutput(tv3);
+
+  tv2->setMemoryType(MemoryType::Global);
+
+  for (auto tv : {tv1, tv2, tv3}) {
+    tv->split(0, 32);
+    tv->axis(0)->parallelize(ParallelType::BIDx);
+    tv->axis(1)->parallelize(ParallelType::TIDx);
+  }
+
+  {
+    GpuLower gpulw(&fusion);
+    gpulw.run();
+    EXPECT_TRUE(PredicatedChecker::isPredicated(tv2, gpulw));
+  }
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::PadGlobalIntermediates);
+
+  {
+    GpuLower gpulw(&fusion);
+    gpulw.run();
+    EXPECT_TRUE(PredicatedChecker::isPredicated(tv1, gpulw));
+    EXPECT_FALSE(PredicatedChecker::isPredicated(tv2, gpulw));
+    EXPECT_TRUE(PredicatedChecker::isPredicated(tv3, gpulw));
+  }
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({100}, options);
+
+  KernelExecutor ke;
+  ke.compile(&fusion, {t0});
+  auto cg_outputs = ke.run({t0});
+  testValidate(
+      &fusion, cg_outputs, {t0}, {(t0 + 1) * 2}, __LINE__, __FILE__);
+}
+
 } // namespace nvfuser
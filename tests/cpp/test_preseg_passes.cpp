@@ -12,9 +12,16 @@
 #include <ir/all_nodes.h>
 #include <ir/utils.h>
 #include <ops/all_ops.h>
+#include <preseg_passes/cse.h>
+#include <preseg_passes/donate_inputs.h>
+#include <preseg_passes/fold_log_softmax_gather.h>
+#include <preseg_passes/move_matmul_scales.h>
 #include <preseg_passes/optimization_pass.h>
 #include <preseg_passes/pre_segmenter.h>
+#include <preseg_passes/rewrite_reductions.h>
+#include <preseg_passes/split_full_reduction.h>
 #include <preseg_passes/translate_repeat_to_expand.h>
+#include <scheduler/utils.h>
 #include <tests/cpp/utils.h>
 #include <tests/cpp/validator.h>
 
@@ -1031,4 +1038,376 @@ TEST_F(PresegTest, TranslateRepeatToExpand6) {
       ElementsAre(HeuristicIs(SchedulerType::PointWise)));
 }
 
+// Per-row scales of FP8 operands are applied to the linear output instead of
+// its operands
+TEST_F(PresegTest, MoveMatmulScales) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr;
+  FusionGuard fg(&fusion);
+
+  auto a = makeContigTensor(2, DataType::Float8_e4m3fn);
+  auto a_scale = makeContigConcreteTensor({-1, 1});
+  auto b = makeContigTensor(2, DataType::Float8_e4m3fn);
+  auto b_scale = makeContigConcreteTensor({-1, 1});
+  fusion.addInput(a);
+  fusion.addInput(a_scale);
+  fusion.addInput(b);
+  fusion.addInput(b_scale);
+
+  auto dequantize = [](TensorView* x, TensorView* scale) {
+    return castOp(DataType::BFloat16, mul(castOp(DataType::Float, x), scale));
+  };
+  auto c = linear(dequantize(a, a_scale), dequantize(b, b_scale));
+  fusion.addOutput(c);
+
+  {
+    Fusion fusion_copy = fusion;
+    OptimizationPass<MoveMatmulScalesPass>::runPass(&fusion_copy);
+    auto* new_out = fusion_copy.outputs().at(0)->as<TensorView>();
+    EXPECT_EQ(new_out->dtype(), DataType::BFloat16);
+    auto linear_ops = ir_utils::getOpsOfType<LinearOp>(&fusion_copy);
+    ASSERT_EQ(linear_ops.size(), 1);
+    for (Val* operand : linear_ops.at(0)->inputs()) {
+      auto* uop = dynamic_cast<UnaryOp*>(operand->definition());
+      ASSERT_NE(uop, nullptr);
+      EXPECT_EQ(uop->getUnaryOpType(), UnaryOpType::Cast);
+      EXPECT_EQ(uop->in()->dtype(), DataType::Float8_e4m3fn);
+    }
+  }
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t_a = at::randn({128, 64}, options);
+  auto t_a_scale = at::rand({128, 1}, options);
+  auto t_b = at::randn({256, 64}, options);
+  auto t_b_scale = at::rand({256, 1}, options);
+  std::vector<c10::IValue> inputs = {
+      t_a.to(at::kFloat8_e4m3fn),
+      t_a_scale,
+      t_b.to(at::kFloat8_e4m3fn),
+      t_b_scale};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto outputs = executor_cache.runFusionWithInputs(inputs);
+
+  auto ref = at::linear(
+      inputs[0].toTensor().to(at::kFloat) * t_a_scale,
+      inputs[2].toTensor().to(at::kFloat) * t_b_scale);
+  EXPECT_TRUE(at::allclose(outputs[0].to(at::kFloat), ref, 1e-2, 1e-1));
+}
+
+// Per-channel scales of an unpacked int4 weight are applied to the linear
+// output, so the matmul reads the weight as exact BFloat16 integers
+TEST_F(PresegTest, MoveMatmulScalesInt4) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr;
+  FusionGuard fg(&fusion);
+
+  auto a = makeContigTensor(2, DataType::BFloat16);
+  auto b_packed = makeContigTensor(2, DataType::Int8);
+  auto b_scale = makeContigConcreteTensor({-1, 1});
+  fusion.addInput(a);
+  fusion.addInput(b_packed);
+  fusion.addInput(b_scale);
+
+  auto b = castOp(
+      DataType::BFloat16,
+      mul(castOp(DataType::Float, unpack_int4(b_packed)), b_scale));
+  auto c = linear(a, b);
+  fusion.addOutput(c);
+
+  {
+    Fusion fusion_copy = fusion;
+    OptimizationPass<MoveMatmulScalesPass>::runPass(&fusion_copy);
+    auto linear_ops = ir_utils::getOpsOfType<LinearOp>(&fusion_copy);
+    ASSERT_EQ(linear_ops.size(), 1);
+    auto* uop = dynamic_cast<UnaryOp*>(linear_ops.at(0)->inB()->definition());
+    ASSERT_NE(uop, nullptr);
+    EXPECT_EQ(uop->getUnaryOpType(), UnaryOpType::Cast);
+    EXPECT_EQ(uop->in()->dtype(), DataType::Int8);
+  }
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t_a = at::randn({128, 64}, options).to(at::kBFloat16);
+  auto t_b_packed = at::randint(-128, 128, {256, 32}, options.dtype(at::kChar));
+  auto t_b_scale = at::rand({256, 1}, options);
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto outputs =
+      executor_cache.runFusionWithInputs({t_a, t_b_packed, t_b_scale});
+
+  // Low nibble first
+  auto t_b = at::stack(
+                 {at::bitwise_right_shift(
+                      at::bitwise_left_shift(t_b_packed, 4), 4),
+                  at::bitwise_right_shift(t_b_packed, 4)},
+                 -1)
+                 .flatten(-2);
+  auto ref = at::linear(t_a.to(at::kFloat), t_b.to(at::kFloat) * t_b_scale);
+  EXPECT_TRUE(at::allclose(outputs[0].to(at::kFloat), ref, 1e-2, 1e-1));
+}
+
+// The target log-probabilities of a cross-entropy loss are gathered from the
+// logits, so the full log_softmax is never written to global memory
+TEST_F(PresegTest, FoldLogSoftmaxGather) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr;
+  FusionGuard fg(&fusion);
+
+  auto logits = makeContigTensor(2, DataType::BFloat16);
+  auto target = makeContigConcreteTensor({-1, 1}, DataType::Int);
+  fusion.addInput(logits);
+  fusion.addInput(target);
+  auto log_probs = log_softmax(castOp(DataType::Float, logits), 1);
+  auto loss = neg(sum(takeAlongAxis(log_probs, target, 1), {0, 1}));
+  fusion.addOutput(loss);
+
+  {
+    Fusion fusion_copy = fusion;
+    OptimizationPass<FoldLogSoftmaxGatherPass>::runPass(&fusion_copy);
+    auto gather_ops = ir_utils::getOpsOfType<TorchGatherOp>(&fusion_copy);
+    ASSERT_EQ(gather_ops.size(), 1);
+    EXPECT_TRUE(gather_ops.at(0)->lookupTv()->isFusionInput());
+  }
+
+  auto options = at::TensorOptions().dtype(at::kBFloat16).device(at::kCUDA, 0);
+  at::Tensor t_logits = at::randn({256, 32000}, options);
+  at::Tensor t_target =
+      at::randint(0, 32000, {256, 1}, options.dtype(at::kLong));
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto outputs = executor_cache.runFusionWithInputs({t_logits, t_target});
+
+  at::Tensor ref = -at::log_softmax(t_logits.to(at::kFloat), 1)
+                        .gather(1, t_target)
+                        .sum();
+  EXPECT_TRUE(at::allclose(outputs[0], ref, 1e-3, 1e-3));
+
+  // No segment outputs a [tokens, vocab] tensor
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  for (SegmentedGroup* group : runtime->fusionSegments()->groups()) {
+    for (Val* output : group->outputs()) {
+      EXPECT_LE(scheduler_utils::nLogicalDims(output->as<TensorView>()), 1)
+          << output->toString();
+    }
+  }
+}
+
+TEST_F(PresegTest, SplitFullReduction) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr;
+  FusionGuard fg(&fusion);
+
+  auto x = makeContigTensor(2, DataType::BFloat16);
+  auto weight = makeContigTensor(1);
+  auto scale = makeContigTensor(0);
+  fusion.addInput(x);
+  fusion.addInput(weight);
+  fusion.addInput(scale);
+  auto y = rms_norm(
+               castOp(DataType::Float, x),
+               /*kNormShapeNumDims=*/1,
+               weight,
+               IrBuilder::create<Val>(1e-5))
+               .output;
+  auto amax = max(abs(y), {0, 1});
+  auto y_fp8 = castOp(DataType::Float8_e4m3fn, mul(y, scale));
+  fusion.addOutput(y_fp8);
+  fusion.addOutput(amax);
+
+  {
+    Fusion fusion_copy = fusion;
+    OptimizationPass<SplitFullReductionPass>::runPass(&fusion_copy);
+    auto* outer = fusion_copy.outputs().at(1)->definition();
+    ASSERT_TRUE(outer->isA<ReductionOp>());
+    auto* inner = outer->input(0)->definition();
+    ASSERT_TRUE(inner->isA<ReductionOp>());
+    auto* row_amax = inner->output(0)->as<TensorView>();
+    EXPECT_FALSE(row_amax->getLogicalDomain().at(0)->isReduction());
+    EXPECT_TRUE(row_amax->getLogicalDomain().at(1)->isReduction());
+  }
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t_x = at::randn({1024, 4096}, options.dtype(at::kBFloat16));
+  at::Tensor t_weight = at::randn({4096}, options);
+  at::Tensor t_scale = at::full({}, 2.0, options);
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto outputs =
+      executor_cache.runFusionWithInputs({t_x, t_weight, t_scale});
+
+  at::Tensor t_xf = t_x.to(at::kFloat);
+  at::Tensor t_y =
+      t_xf * at::rsqrt(t_xf.pow(2).mean({1}, /*keepdim=*/true) + 1e-5) *
+      t_weight;
+  EXPECT_TRUE(at::allclose(outputs[1], t_y.abs().amax(), 1e-3, 1e-3));
+  EXPECT_TRUE(at::allclose(
+      outputs[0].to(at::kFloat),
+      (t_y * t_scale).to(at::kFloat8_e4m3fn).to(at::kFloat),
+      0.125,
+      1e-2));
+
+  // The normalized activation is only written in FP8
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  for (SegmentedGroup* group : runtime->fusionSegments()->groups()) {
+    for (Val* output : group->outputs()) {
+      auto* tv = output->as<TensorView>();
+      if (scheduler_utils::nLogicalDims(tv) == 2) {
+        EXPECT_EQ(tv->dtype(), DataType::Float8_e4m3fn) << tv->toString();
+      }
+    }
+  }
+}
+
+TEST_F(PresegTest, Cse) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr;
+  FusionGuard fg(&fusion);
+
+  auto x = makeContigTensor(2, DataType::BFloat16);
+  auto y = makeContigTensor(2);
+  fusion.addInput(x);
+  fusion.addInput(y);
+  // Duplicated casts, normalizations and commuted adds
+  auto x0 = castOp(DataType::Float, x);
+  auto x1 = castOp(DataType::Float, x);
+  auto [var0, mean0] = variance_mean(x0, {1}, 0, /*keepdim=*/false);
+  auto [var1, mean1] = variance_mean(x1, {1}, 0, /*keepdim=*/false);
+  auto sum0 = add(x0, y);
+  auto sum1 = add(y, x1);
+  fusion.addOutput(add(var0, mean1));
+  fusion.addOutput(sub(var1, mean0));
+  fusion.addOutput(mul(sum0, sum1));
+  // Random values are never merged
+  auto r0 = rand_like(y);
+  auto r1 = rand_like(y);
+  fusion.addOutput(sub(r0, r1));
+
+  {
+    Fusion fusion_copy = fusion;
+    OptimizationPass<CsePass>::runPass(&fusion_copy);
+    auto count_ops = [&](auto is_op) {
+      const auto exprs = fusion_copy.exprs();
+      return std::count_if(exprs.begin(), exprs.end(), is_op);
+    };
+    EXPECT_EQ(count_ops([](Expr* e) {
+                return e->isA<UnaryOp>() &&
+                    e->as<UnaryOp>()->getUnaryOpType() == UnaryOpType::Cast;
+              }),
+              1);
+    EXPECT_EQ(count_ops([](Expr* e) { return e->isA<WelfordOp>(); }), 1);
+    EXPECT_EQ(count_ops([](Expr* e) { return e->isA<RNGOp>(); }), 2);
+    Val* y_copy = fusion_copy.inputs().at(1);
+    EXPECT_EQ(count_ops([y_copy](Expr* e) {
+                return e->isA<BinaryOp>() &&
+                    e->as<BinaryOp>()->getBinaryOpType() == BinaryOpType::Add &&
+                    (e->input(0) == y_copy || e->input(1) == y_copy);
+              }),
+              1);
+  }
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t_x = at::randn({128, 1024}, options.dtype(at::kBFloat16));
+  at::Tensor t_y = at::randn({128, 1024}, options);
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto outputs = executor_cache.runFusionWithInputs({t_x, t_y});
+
+  at::Tensor t_xf = t_x.to(at::kFloat);
+  auto [t_var, t_mean] = at::var_mean(t_xf, {1}, /*correction=*/0);
+  EXPECT_TRUE(at::allclose(outputs[0], t_var + t_mean, 1e-3, 1e-3));
+  EXPECT_TRUE(at::allclose(outputs[1], t_var - t_mean, 1e-3, 1e-3));
+  EXPECT_TRUE(
+      at::allclose(outputs[2], (t_xf + t_y) * (t_xf + t_y), 1e-3, 1e-3));
+  EXPECT_FALSE(at::equal(outputs[3], at::zeros_like(t_y)));
+}
+
+TEST_F(PresegTest, RewriteReductions) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr;
+  FusionGuard fg(&fusion);
+
+  auto a = makeContigTensor(2);
+  auto b = makeContigTensor(2);
+  auto c = IrBuilder::create<Val>(DataType::Double);
+  fusion.addInput(a);
+  fusion.addInput(b);
+  fusion.addInput(c);
+  fusion.addOutput(add(sum(a, {1}), sum(b, {1})));
+  fusion.addOutput(sum(mul(a, c), {1}));
+  fusion.addOutput(mul(mean(b, {1}, /*keepdim=*/false), c));
+
+  {
+    Fusion fusion_copy = fusion;
+    OptimizationPass<RewriteReductionsPass>::runPass(&fusion_copy);
+    EXPECT_EQ(ir_utils::getOpsOfType<ReductionOp>(&fusion_copy).size(), 3);
+    // The sums are merged
+    auto* merged = fusion_copy.outputs().at(0)->definition();
+    ASSERT_TRUE(merged->isA<ReductionOp>());
+    // The factor is applied after the sum
+    auto* scaled = fusion_copy.outputs().at(1)->definition();
+    ASSERT_TRUE(scaled->isA<BinaryOp>());
+    EXPECT_TRUE(scaled->input(0)->definition()->isA<ReductionOp>());
+    // The mean and the rescale are a single scaling of the sum
+    auto* rescaled = fusion_copy.outputs().at(2)->definition();
+    ASSERT_TRUE(rescaled->isA<BinaryOp>());
+    EXPECT_TRUE(rescaled->input(0)->definition()->isA<ReductionOp>());
+  }
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t_a = at::randn({128, 1024}, options);
+  at::Tensor t_b = at::randn({128, 1024}, options);
+  const double t_c = 0.5;
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto outputs = executor_cache.runFusionWithInputs({t_a, t_b, t_c});
+  EXPECT_TRUE(at::allclose(outputs[0], t_a.sum(1) + t_b.sum(1), 1e-3, 1e-3));
+  EXPECT_TRUE(at::allclose(outputs[1], (t_a * t_c).sum(1), 1e-3, 1e-3));
+  EXPECT_TRUE(at::allclose(outputs[2], t_b.mean(1) * t_c, 1e-3, 1e-3));
+}
+
+TEST_F(PresegTest, InputDonation) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr;
+  FusionGuard fg(&fusion);
+
+  auto x = makeContigTensor(2);
+  auto bias = makeContigTensor(1);
+  auto y = makeContigTensor(2);
+  fusion.addInput(x);
+  fusion.addInput(bias);
+  fusion.addInput(y);
+  fusion.addOutput(mul(relu(x), broadcast(bias, {true, false})));
+  // The reduction reads all elements of a row of y, so y can't be
+  // overwritten while it's read
+  fusion.addOutput(sub(y, broadcast(sum(y, {1}), {false, true})));
+  fusion.markDonatable(x);
+  fusion.markDonatable(y);
+
+  {
+    Fusion fusion_copy = fusion;
+    OptimizationPass<InputDonationPass>::runPass(&fusion_copy);
+    const AliasInfo& x_alias =
+        fusion_copy.getOutputAlias(fusion_copy.outputs().at(0));
+    EXPECT_EQ(x_alias.type, AllocationType::ReuseBuffer);
+    EXPECT_EQ(x_alias.aliased_io, fusion_copy.inputs().at(0));
+    EXPECT_FALSE(x_alias.hide_output);
+    EXPECT_EQ(
+        fusion_copy.getOutputAlias(fusion_copy.outputs().at(1)).type,
+        AllocationType::New);
+  }
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t_x = at::randn({128, 1024}, options);
+  at::Tensor t_bias = at::randn({1024}, options);
+  at::Tensor t_y = at::randn({128, 1024}, options);
+  at::Tensor expected_0 = at::relu(t_x) * t_bias;
+  at::Tensor expected_1 = t_y - t_y.sum(1, /*keepdim=*/true);
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto outputs = executor_cache.runFusionWithInputs({t_x, t_bias, t_y});
+  EXPECT_EQ(outputs[0].data_ptr(), t_x.data_ptr());
+  EXPECT_TRUE(at::allclose(outputs[0], expected_0));
+  EXPECT_TRUE(at::allclose(outputs[1], expected_1, 1e-3, 1e-3));
+}
+
 } // namespace nvfuser::preseg_passes
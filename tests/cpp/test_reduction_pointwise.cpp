@@ -159,4 +159,154 @@ TEST_F(NVFuserTest, InnerReductionUnrollVectorization) {
   testValidate(&fusion_copy, cg_outputs, runtime_inputs, __LINE__, __FILE__);
 }
 
+// The blocks of a cross-grid inner reduction form one thread block cluster and
+// combine their partial results through distributed shared memory
+TEST_F(NVFuserTest, InnerReductionCluster) {
+  NVFUSER_TEST_CUDA_ARCH_GUARD(9, 0);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  fusion->addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({4, 1 << 20}, options);
+  std::vector<c10::IValue> runtime_inputs({t0});
+
+  SchedulerRuntimeInfo runtime_info(fusion.get(), runtime_inputs);
+  auto scheduler_instance =
+      SchedulerEntry::makeSchedulerInstance(SchedulerType::Reduction);
+  auto heuristic_params =
+      scheduler_instance->computeHeuristics(fusion.get(), runtime_info);
+  auto rparams = heuristic_params->as<ReductionParams>();
+  ASSERT_TRUE(rparams->cross_grid_inner_reduction);
+  ASSERT_EQ(rparams->grid_dim_inner_reduction, ParallelType::BIDx);
+
+  // Shrink the reduction grid to a cluster of 4 blocks
+  const auto& lparams = rparams->lparams;
+  rparams->lparams = LaunchParams(
+      4,
+      lparams.getRawVal(ParallelType::BIDy),
+      lparams.getRawVal(ParallelType::BIDz),
+      lparams.getRawVal(ParallelType::TIDx),
+      lparams.getRawVal(ParallelType::TIDy),
+      lparams.getRawVal(ParallelType::TIDz));
+  rparams->cluster_reduction = true;
+
+  auto fusion_copy = *fusion;
+  scheduler_instance->schedule(fusion.get(), rparams);
+  KernelExecutor ke;
+  ke.compile(fusion.get(), runtime_inputs, rparams->lparams);
+  EXPECT_THAT(ke.kernelString(), testing::HasSubstr("clusterReduce"));
+  auto cg_outputs = ke.run(runtime_inputs, rparams->lparams);
+  testValidate(&fusion_copy, cg_outputs, runtime_inputs, __LINE__, __FILE__);
+}
+
+// Tiny inner and outer reductions are done within blocks in latency mode
+TEST_F(NVFuserTest, LatencyModeReduction) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::LatencyMode);
+
+  for (int64_t reduction_dim : {0, 1}) {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+
+    auto tv0 = makeContigTensor(2);
+    fusion->addInput(tv0);
+    auto tv1 = sum(tv0, {reduction_dim});
+    fusion->addOutput(tv1);
+
+    auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+    at::Tensor t0 = reduction_dim == 1 ? at::randn({4, 4096}, options)
+                                       : at::randn({4096, 4}, options);
+
+    FusionExecutorCache executor_cache(std::move(fusion));
+    auto outputs = executor_cache.runFusionWithInputs({t0});
+    testValidate(executor_cache.fusion(), outputs, {t0}, __LINE__, __FILE__);
+
+    FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+    const ReductionParams* rparams = runtime->schedulerHeuristics()
+                                         ->heuristicsList()
+                                         .at(0)
+                                         ->as<ReductionParams>();
+    EXPECT_FALSE(rparams->cross_grid_inner_reduction);
+    EXPECT_FALSE(rparams->cross_grid_outer_reduction);
+  }
+}
+
+// Bias gradient of a small inner dimension. Tiles are transposed through
+// shared memory so that warps reduce their columns.
+TEST_F(NVFuserTest, TransposedOuterReduction) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::TransposedOuterReduction);
+
+  for (int64_t num_rows : {64, 1 << 20}) {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+
+    auto tv0 = makeContigTensor(2, DataType::Half);
+    fusion->addInput(tv0);
+    auto tv1 = castOp(DataType::Float, tv0);
+    auto tv2 = sum(tv1, {0});
+    auto tv3 = castOp(DataType::Half, tv2);
+    fusion->addOutput(tv3);
+
+    auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+    at::Tensor t0 = at::randn({num_rows, 64}, options);
+
+    FusionExecutorCache executor_cache(std::move(fusion));
+    auto outputs = executor_cache.runFusionWithInputs({t0});
+    testValidate(executor_cache.fusion(), outputs, {t0}, __LINE__, __FILE__);
+
+    FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+    EXPECT_FALSE(runtime->isSegmented());
+    const ReductionParams* rparams = runtime->schedulerHeuristics()
+                                         ->heuristicsList()
+                                         .at(0)
+                                         ->as<ReductionParams>();
+    EXPECT_TRUE(rparams->transposed_outer_reduction);
+    EXPECT_EQ(rparams->cross_grid_inner_reduction, num_rows > 64);
+    auto ke =
+        dynamic_cast<KernelExecutor*>(runtime->executors().at(0).get());
+    ASSERT_NE(ke, nullptr);
+    EXPECT_THAT(ke->kernelString(), testing::HasSubstr("warpReduceTIDX"));
+  }
+}
+
+// The loads of the next iteration of the serial reduction loop are issued
+// before the current one is reduced
+TEST_F(NVFuserTest, SerialLoopPrefetch) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::SerialLoopPrefetch);
+
+  for (int64_t reduction_axis : {0, 1}) {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+
+    auto tv0 = makeContigTensor(2);
+    fusion->addInput(tv0);
+    auto tv1 = sum(tv0, {reduction_axis});
+    fusion->addOutput(tv1);
+
+    auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+    at::Tensor t0 = reduction_axis == 0 ? at::randn({1 << 16, 256}, options)
+                                        : at::randn({256, 1 << 16}, options);
+
+    FusionExecutorCache executor_cache(std::move(fusion));
+    auto outputs = executor_cache.runFusionWithInputs({t0});
+    testValidate(executor_cache.fusion(), outputs, {t0}, __LINE__, __FILE__);
+
+    FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+    const ReductionParams* rparams = runtime->schedulerHeuristics()
+                                         ->heuristicsList()
+                                         .at(0)
+                                         ->as<ReductionParams>();
+    EXPECT_EQ(rparams->serial_prefetch_depth, 1);
+  }
+}
+
 } // namespace nvfuser
@@ -553,4 +553,110 @@ TEST_F(RNGTest, DifferentOffsets) {
   }
 }
 
+// RNG ops computed in the same loop each keep their own Philox result
+TEST_F(RNGTest, InterleavedRNGOps) {
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  auto fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  Val* size_val = IrBuilder::create<Val>(DataType::Int);
+  fusion->addInput(size_val);
+  TensorView* tv0 = rand({size_val}, DataType::Float);
+  TensorView* tv1 = rand({size_val}, DataType::Float);
+  fusion->addOutput(tv0);
+  fusion->addOutput(tv1);
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+
+  for (int64_t size : {16, 10003, 100000}) {
+    at::manual_seed(0);
+    auto cg_outputs = executor_cache.runFusionWithInputs({size});
+    EXPECT_FALSE(executor_cache.getMostRecentKernelRuntime()->isSegmented());
+
+    at::manual_seed(0);
+    auto ref0 = generate_uniform(size, at::kFloat);
+    auto ref1 = generate_uniform(size, at::kFloat);
+
+    testValidate(
+        executor_cache.fusion(),
+        cg_outputs,
+        {size},
+        {ref0, ref1},
+        __LINE__,
+        __FILE__);
+  }
+}
+
+// Replays of a CUDA graph with an RNG op generate new random numbers
+TEST_F(RNGTest, CudaGraphReplay) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::CudaGraph);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* tv0 = makeContigTensor(1);
+  fusion->addInput(tv0);
+  TensorView* tv1 = add(tv0, rand_like(tv0));
+  fusion->addOutput(tv1);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::zeros({4096}, options);
+  std::vector<at::Tensor> outputs;
+  for (auto i : c10::irange(4)) {
+    (void)i; // Suppress unused variable warning
+    outputs.push_back(executor_cache.runFusionWithInputs({t0}).at(0));
+  }
+  EXPECT_EQ(executor_cache.getMostRecentKernelRuntime()->numCudaGraphs(), 1);
+
+  for (auto i : c10::irange(1, 4)) {
+    EXPECT_FALSE(at::equal(outputs[i - 1], outputs[i]));
+    EXPECT_TRUE(outputs[i].ge(0).all().item<bool>());
+    EXPECT_TRUE(outputs[i].lt(1).all().item<bool>());
+  }
+}
+
+// The backward of a dropout regenerates the mask of the forward from the
+// Philox seed and offset instead of reading it
+TEST_F(RNGTest, DropoutBackwardRegeneratesMask) {
+  constexpr double kKeepProb = 0.9;
+  auto make_fusion = [&](bool backward) {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    TensorView* in = makeContigTensor(2);
+    Val* seed = IrBuilder::create<Val>(DataType::Int);
+    Val* offset = IrBuilder::create<Val>(DataType::Int);
+    fusion->addInput(in);
+    fusion->addInput(seed);
+    fusion->addInput(offset);
+    Val* prob = IrBuilder::create<Val>(kKeepProb);
+    Val* scale = IrBuilder::create<Val>(1.0 / kKeepProb);
+    if (backward) {
+      fusion->addOutput(dropout_backward(in, prob, scale, seed, offset));
+    } else {
+      auto [out, mask] = dropout(in, prob, scale, seed, offset);
+      fusion->addOutput(out);
+      fusion->addOutput(mask);
+    }
+    return fusion;
+  };
+
+  FusionExecutorCache forward(make_fusion(/*backward=*/false));
+  FusionExecutorCache backward(make_fusion(/*backward=*/true));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor x = at::randn({1000, 1024}, options);
+  at::Tensor dy = at::randn({1000, 1024}, options);
+  std::vector<at::Tensor> forward_outputs =
+      forward.runFusionWithInputs({x, 42, 8});
+  at::Tensor mask = forward_outputs.at(1);
+  std::vector<at::Tensor> backward_outputs =
+      backward.runFusionWithInputs({dy, 42, 8});
+
+  EXPECT_TRUE(backward_outputs.at(0).allclose(dy * mask / kKeepProb));
+  EXPECT_FALSE(mask.all().item<bool>());
+}
+
 } // namespace nvfuser
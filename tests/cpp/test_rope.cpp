@@ -12,6 +12,7 @@
 #include <ir/graphviz.h>
 #include <ops/all_ops.h>
 #include <runtime/fusion_executor_cache.h>
+#include <scheduler/resize_heuristic.h>
 #include <tests/cpp/utils.h>
 #include <tests/cpp/validator.h>
 
@@ -971,4 +972,65 @@ TEST_F(RopeTest, EndingRepeat) {
   }
 }
 
+// The rotated dimension of rotate_half is split into its halves, which each
+// thread computes in a serial loop of two iterations
+TEST_F(RopeTest, RotateHalf) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  FusionGuard fg(fusion_ptr.get());
+  Fusion& fusion = *fusion_ptr;
+
+  const int64_t seq_len = 1024;
+  const int64_t head_dim = 128;
+  std::vector<int64_t> shape{seq_len, head_dim};
+
+  auto tv0 = makeContigConcreteTensor(shape);
+  fusion.addInput(tv0);
+  auto tv1 = makeContigConcreteTensor(shape);
+  fusion.addInput(tv1);
+  auto tv2 = makeContigConcreteTensor(shape);
+  fusion.addInput(tv2);
+
+  auto tv3 = slice(
+      tv0,
+      {{fusion.zeroVal(), IrBuilder::create<Val>(seq_len)},
+       {fusion.zeroVal(), IrBuilder::create<Val>(head_dim / 2)}});
+  auto tv4 = slice(
+      tv0,
+      {{fusion.zeroVal(), IrBuilder::create<Val>(seq_len)},
+       {IrBuilder::create<Val>(head_dim / 2),
+        IrBuilder::create<Val>(head_dim)}});
+  auto tv5 = cat({neg(tv4), tv3}, -1);
+  auto tv6 = add(mul(tv0, tv1), mul(tv5, tv2));
+  fusion.addOutput(tv6);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn(shape, options);
+  auto t1 = at::randn(shape, options);
+  auto t2 = at::randn(shape, options);
+  std::vector<c10::IValue> inputs({t0, t1, t2});
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto outputs = executor_cache.runFusionWithInputs(inputs);
+  testValidate(&fusion, outputs, inputs, __LINE__, __FILE__);
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_FALSE(runtime->isSegmented());
+  auto resize_params = dynamic_cast<ResizeParams*>(
+      runtime->schedulerHeuristics()->heuristicsList().front().get());
+  ASSERT_NE(resize_params, nullptr);
+  EXPECT_TRUE(resize_params->split_rotate_half);
+  EXPECT_EQ(resize_params->vectorization_factor, 4);
+
+  // The reference should look like:
+  //   [iblockIdx.x, ithreadIdx.x, iS{2}, iV{4}]
+  Fusion* scheduled_fusion =
+      dynamic_cast<KernelExecutor*>(runtime->executors().at(0).get())->fusion();
+  auto ref_tv = scheduled_fusion->outputs().at(0)->as<TensorView>();
+  IterDomain* half_id = ref_tv->axis(-2);
+  EXPECT_EQ(half_id->getParallelType(), ParallelType::Serial);
+  ASSERT_TRUE(half_id->extent()->isConstInt());
+  EXPECT_EQ(half_id->extent()->evaluate().as<int64_t>(), 2L);
+  EXPECT_EQ(ref_tv->axis(-1)->getParallelType(), ParallelType::Vectorize);
+}
+
 } // namespace nvfuser
@@ -7,6 +7,7 @@
 // clang-format on
 #include <gtest/gtest.h>
 
+#include <device_lower/utils.h>
 #include <fusion.h>
 #include <ops/all_ops.h>
 #include <runtime/executor.h>
@@ -404,4 +405,87 @@ __global__ void CUDAGeneratedKernel(int64_t i0, int64_t i1, int64_t i2, Tensor<i
       fusion.get(), cg_outputs, {start, end, step}, __LINE__, __FILE__);
 }
 
+// The hoisted indices of the serial loops are computed by running scalars
+// instead of multiplications by the loop index
+TEST_F(ScalarHoistTest, IndexStrengthReduction) {
+  if (isOptionDisabled(DisableOption::IndexHoist)) {
+    GTEST_SKIP() << "Index hoisting disabled";
+  }
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::IndexStrengthReduction);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(3);
+  fusion->addInput(tv0);
+  auto tv1 = sin(tv0);
+  fusion->addOutput(tv1);
+
+  GpuLower gpulw(fusion.get());
+  kir::Kernel* kernel = gpulw.run();
+
+  // The i0 and i1 loops each advance the hoisted input and output indices
+  int64_t num_increments = 0;
+  for (auto expr : ir_utils::flattenScopedExprs(kernel->topLevelExprs())) {
+    if (auto inc = dynamic_cast<kir::IncrementScalar*>(expr)) {
+      EXPECT_TRUE(inc->scalar()->isScalar());
+      ++num_increments;
+    }
+  }
+  EXPECT_GE(num_increments, 2);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({5, 7, 9}, options).transpose(0, 2);
+
+  KernelExecutor ke;
+  ke.compile(fusion.get(), {t0});
+  auto cg_outputs = ke.run({t0});
+
+  testValidate(fusion.get(), cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
+// Integer arithmetic on the extents of the inputs, e.g., the extent of a merged
+// domain, is evaluated on the host and passed as a kernel argument
+TEST_F(ScalarHoistTest, HostScalarHoisting) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::HostScalarHoisting);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sin(tv0);
+  fusion->addOutput(tv1);
+
+  tv1->merge(0);
+  tv1->split(0, 128);
+  tv1->axis(0)->parallelize(ParallelType::BIDx);
+  tv1->axis(1)->parallelize(ParallelType::TIDx);
+
+  GpuLower gpulw(fusion.get());
+  kir::Kernel* kernel = gpulw.run();
+
+  const auto& params = kernel->parameters();
+  EXPECT_TRUE(std::any_of(params.begin(), params.end(), [](Val* param) {
+    return param->definition() != nullptr &&
+        param->definition()->isA<BinaryOp>();
+  }));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({33, 65}, options);
+
+  KernelExecutor ke;
+  ke.compile(fusion.get(), {t0});
+  auto cg_outputs = ke.run({t0});
+  testValidate(fusion.get(), cg_outputs, {t0}, __LINE__, __FILE__);
+
+  // The hoisted scalars are evaluated again for new extents
+  at::Tensor t1 = at::randn({17, 129}, options);
+  cg_outputs = ke.run({t1});
+  testValidate(fusion.get(), cg_outputs, {t1}, __LINE__, __FILE__);
+}
+
 } // namespace nvfuser
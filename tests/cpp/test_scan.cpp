@@ -0,0 +1,73 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <gtest/gtest.h>
+
+#include <fusion.h>
+#include <ir/utils.h>
+#include <ops/all_ops.h>
+#include <runtime/fusion_executor_cache.h>
+#include <runtime/fusion_kernel_runtime.h>
+#include <tests/cpp/utils.h>
+
+namespace nvfuser {
+
+using ScanTest = NVFuserTest;
+
+// The scan is evaluated in its own segment, and its producer and consumer
+// are still scheduled as kernels
+TEST_F(ScanTest, Cumsum) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  TensorView* tv1 = sin(tv0);
+  TensorView* tv2 = cumsum(tv1, -1);
+  TensorView* tv3 = mul(tv2, IrBuilder::create<Val>(2.0));
+  fusion->addOutput(tv3);
+
+  EXPECT_TRUE(tv2->definition()->isA<ScanOp>());
+  EXPECT_EQ(tv2->definition()->as<ScanOp>()->dim(), 1);
+  EXPECT_EQ(tv2->nDims(), 2);
+  EXPECT_FALSE(tv2->hasReduction());
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({8, 1024}, options);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0});
+
+  at::Tensor expected = at::cumsum(t0.sin(), 1) * 2.0;
+  EXPECT_TRUE(at::allclose(outputs[0], expected, 1e-4, 1e-4));
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_EQ(runtime->fusionSegments()->groups().size(), 3);
+}
+
+// Integral inputs are accumulated in Int, like torch.cumprod
+TEST_F(ScanTest, CumprodInt) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* tv0 = makeContigTensor(2, DataType::Int32);
+  fusion->addInput(tv0);
+  TensorView* tv1 = cumprod(tv0, 0);
+  fusion->addOutput(tv1);
+
+  EXPECT_EQ(tv1->dtype(), DataType::Int);
+
+  auto options = at::TensorOptions().dtype(at::kInt).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randint(1, 4, {6, 32}, options);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0});
+
+  EXPECT_TRUE(at::equal(outputs[0], at::cumprod(t0, 0)));
+}
+
+} // namespace nvfuser
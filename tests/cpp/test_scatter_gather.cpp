@@ -1310,4 +1310,41 @@ TEST_F(ScatterGatherTest, GatherIterGoupedReduction) {
       lparams);
 }
 
+// Stores of duplicate indices race in a kernel, so the scatter is evaluated
+// with a deterministic formulation instead
+TEST_F(ScatterGatherTest, DeterministicScatterWithDuplicateIndices) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::DeterministicReductions);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* tv_input = makeContigTensor(2);
+  TensorView* tv_idx = makeContigTensor(2, DataType::Int);
+  TensorView* tv_src = makeContigTensor(2);
+  fusion->addInput(tv_input);
+  fusion->addInput(tv_idx);
+  fusion->addInput(tv_src);
+  TensorView* tv_out = scatter(tv_input, 0, tv_idx, tv_src);
+  fusion->addOutput(tv_out);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor input = at::randn({4, 32}, options);
+  at::Tensor idx = at::randint(0, 4, {1024, 32}, options.dtype(at::kLong));
+  at::Tensor src = at::randn({1024, 32}, options);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({input, idx, src});
+  EXPECT_THAT(
+      executor_cache.getMostRecentKernelRuntime()
+          ->schedulerHeuristics()
+          ->heuristicsList(),
+      testing::ElementsAre(HeuristicIs(SchedulerType::ExprEval)));
+  for ([[maybe_unused]] auto i : c10::irange(3)) {
+    auto rerun_outputs = executor_cache.runFusionWithInputs({input, idx, src});
+    EXPECT_TRUE(at::equal(rerun_outputs[0], outputs[0]));
+  }
+}
+
 } // namespace nvfuser
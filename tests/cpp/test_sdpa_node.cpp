@@ -690,6 +690,58 @@ TEST_F(SDPATest, AttnProgram) {
   EXPECT_TRUE(at::allclose(out[0], expected_out));
 }
 
+// Scaling the query is folded into the softmax scale, so the fusion is a
+// single SdpaFwdOp evaluated by ATen
+TEST_F(SDPATest, FoldQueryScale) {
+  NVFUSER_TEST_CUDA_ARCH_GUARD(8, 0);
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  std::vector<int64_t> q_shape({n, h, l, e});
+  std::vector<int64_t> kv_shape({n, h, s, e});
+
+  auto tvq = makeSymbolicTensor(q_shape, DataType::Half);
+  auto tvk = makeSymbolicTensor(kv_shape, DataType::Half);
+  auto tvv = makeSymbolicTensor(kv_shape, DataType::Half);
+
+  fusion->addInput(tvq);
+  fusion->addInput(tvk);
+  fusion->addInput(tvv);
+
+  auto tvq_scaled = castOp(
+      DataType::Half,
+      mul(castOp(DataType::Float, tvq), IrBuilder::create<Val>(0.5)));
+  auto output = sdpfa_fwd(
+      tvq_scaled,
+      tvk,
+      tvv,
+      /*dropout_p=*/IrBuilder::create<Val>(0.0),
+      /*is_causal=*/IrBuilder::create<Val>(false),
+      /*scale=*/nullptr);
+  addSdpaFwdOutputs(fusion.get(), output);
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  at::Tensor q = at::randn(q_shape, options);
+  at::Tensor k = at::randn(kv_shape, options);
+  at::Tensor v = at::randn(kv_shape, options);
+
+  auto aten_out = at::_scaled_dot_product_flash_attention(
+      q,
+      k,
+      v,
+      /*dropout_p=*/0.0,
+      /*is_causal=*/false,
+      /*return_debug_mask=*/false,
+      /*scale=*/0.5 / std::sqrt(e));
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto nvf_out = executor_cache.runFusionWithInputs({q, k, v});
+  validateSdpaFwdOutputs(nvf_out, aten_out);
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_FALSE(runtime->isSegmented());
+  EXPECT_FALSE(runtime->executors().front()->isA<KernelExecutor>());
+}
+
 TEST_F(SDPATest, AttnFwdBwd) {
   NVFUSER_TEST_CUDA_ARCH_GUARD(8, 0);
 
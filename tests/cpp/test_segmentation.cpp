@@ -439,6 +439,47 @@ TEST_F(SegmentationTest, ForceBf16Simple) {
   }
 }
 
+TEST_F(SegmentationTest, LowerPrecisionSegmentEdgesPerFusion) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  auto tv1 = makeSymbolicTensor(2);
+
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+
+  // Group 1
+  auto tv2 = sum(tv0, {1});
+  auto tv3 = broadcast(tv2, {false, true});
+
+  // Group 2
+  auto tv4 = add(tv3, tv1); // Edge: tv3: expect cast even though the output
+                            // is Float
+  fusion->addOutput(tv4);
+
+  setLowerPrecisionSegmentEdges(fusion.get(), DataType::Half);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  std::vector<int64_t> shape{15, 16};
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto in0 = at::randn(shape, options);
+  auto in1 = at::randn(shape, options);
+  auto out_tensors = executor_cache.runFusionWithInputs({in0, in1});
+  EXPECT_TRUE(at::allclose(
+      out_tensors[0], in0.sum({1}, /*keepdim=*/true) + in1, 1e-2, 1e-2));
+
+  // Check the segmented edge is fp16
+  SegmentedFusion* segmented_fusion =
+      executor_cache.getMostRecentKernelRuntime()->fusionSegments();
+  for (SegmentedEdge* edge : segmented_fusion->edges()) {
+    auto* edge_tv = edge->val->as<TensorView>();
+    EXPECT_EQ(edge_tv->getDataType(), DataType::Half);
+  }
+}
+
 TEST_F(SegmentationTest, ForceFp16NotAllCast) {
   EnableOptionsGuard opt_guard;
   EnableOptionsGuard::getCurOptions().set(EnableOption::IoToLowerPrecision);
@@ -618,6 +659,51 @@ TEST_F(SegmentationTest, EraseReductionsInSegmentationEdges) {
   }
 }
 
+// Copying only the subgraph of a segment gives the same segment fusion as
+// copying the complete fusion
+TEST_F(SegmentationTest, PartialSegmentCopy) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigConcreteTensor({8, 16});
+  fusion->addInput(tv0);
+  auto* tv1 = reshape(tv0, {8, 16}, {128});
+  auto* tv2 = segment_set(sin(tv1));
+  auto* tv3 = sum(tv2, {0});
+  auto* tv4 = segment_set(add(tv2, broadcast(tv3, {true})));
+  auto* tv5 = exp(tv4);
+  fusion->addOutput(tv3);
+  fusion->addOutput(tv5);
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::PartialSegmentCopy);
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto in0 = at::randn({8, 16}, options);
+  auto outputs = executor_cache.runFusionWithInputs({in0});
+  testValidate(executor_cache.fusion(), outputs, {in0}, __LINE__, __FILE__);
+
+  SegmentedFusion* segmented_fusion =
+      executor_cache.getMostRecentKernelRuntime()->fusionSegments();
+  EXPECT_GT(segmented_fusion->groups().size(), 1);
+  for (SegmentedGroup* group : segmented_fusion->groups()) {
+    std::unique_ptr<Fusion> partial =
+        segmented_fusion->makeFusion(group).second;
+    EnableOptionsGuard::getCurOptions().unset(
+        EnableOption::PartialSegmentCopy);
+    std::unique_ptr<Fusion> complete =
+        segmented_fusion->makeFusion(group).second;
+    EnableOptionsGuard::getCurOptions().set(EnableOption::PartialSegmentCopy);
+
+    std::stringstream partial_ir;
+    partial_ir << *partial;
+    std::stringstream complete_ir;
+    complete_ir << *complete;
+    EXPECT_EQ(partial_ir.str(), complete_ir.str());
+    EXPECT_LT(partial->vals().size(), complete->vals().size());
+  }
+}
+
 TEST_F(SegmentationTest, AliasedOutputOnSegmentation) {
   auto fusion = std::make_unique<Fusion>();
   FusionGuard fg(fusion.get());
@@ -703,4 +789,112 @@ TEST_F(SegmentationTest, ForwardInputsToSegmenterSetIssue2658) {
       executor_cache.fusion(), out_tensors, {in_tensor}, __LINE__, __FILE__);
 }
 
+TEST_F(SegmentationTest, RematerializeBroadcastMask) {
+  auto options = at::TensorOptions().device(at::kCUDA, 0);
+  at::Tensor in_tensor = at::randn({128, 64}, options.dtype(at::kFloat));
+  at::Tensor mask_tensor = at::randn({128}, options.dtype(at::kFloat)) > 0;
+
+  auto run = [&]() -> int64_t {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    TensorView* in = makeContigTensor(2);
+    TensorView* mask = makeContigTensor(1, DataType::Bool);
+    fusion->addInput(in);
+    fusion->addInput(mask);
+    TensorView* float_mask =
+        broadcast(castOp(DataType::Float, mask), {false, true});
+    TensorView* masked = segment_set(mul(in, float_mask));
+    fusion->addOutput(add(masked, float_mask));
+
+    FusionExecutorCache executor_cache(std::move(fusion));
+    std::vector<at::Tensor> out_tensors =
+        executor_cache.runFusionWithInputs({in_tensor, mask_tensor});
+    testValidate(
+        executor_cache.fusion(),
+        out_tensors,
+        {in_tensor, mask_tensor},
+        __LINE__,
+        __FILE__);
+
+    // Count the tensors materialized between segments
+    FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+    EXPECT_EQ(runtime->fusionSegments()->groups().size(), 2);
+    int64_t num_intermediates = 0;
+    for (SegmentedGroup* group : runtime->fusionSegments()->groups()) {
+      num_intermediates += std::count_if(
+          group->inputs().begin(), group->inputs().end(), [](Val* v) {
+            return v->isA<TensorView>() && !v->isFusionInput();
+          });
+    }
+    return num_intermediates;
+  };
+
+  // The consumer segment recomputes float_mask from mask, so only `masked`
+  // goes through global memory
+  EXPECT_EQ(run(), 1);
+
+  DisableOptionsGuard opt_guard;
+  DisableOptionsGuard::getCurOptions().set(DisableOption::Rematerialization);
+  EXPECT_EQ(run(), 2);
+}
+
+TEST_F(SegmentationTest, HorizontalMergeIndependentSegments) {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024}, options);
+  at::Tensor t1 = at::randn({32, 16}, options);
+
+  auto run = [&]() -> int64_t {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    TensorView* tv0 = makeContigTensor(1);
+    TensorView* tv1 = makeContigTensor(2);
+    fusion->addInput(tv0);
+    fusion->addInput(tv1);
+    // Two independent branches of different shapes, each broken into two
+    // segments
+    fusion->addOutput(neg(segment_set(relu(tv0))));
+    fusion->addOutput(neg(segment_set(relu(tv1))));
+
+    FusionExecutorCache executor_cache(std::move(fusion));
+    std::vector<at::Tensor> out_tensors =
+        executor_cache.runFusionWithInputs({t0, t1});
+    testValidate(
+        executor_cache.fusion(), out_tensors, {t0, t1}, __LINE__, __FILE__);
+    return executor_cache.getMostRecentKernelRuntime()
+        ->fusionSegments()
+        ->groups()
+        .size();
+  };
+
+  // The relu segments and the neg segments are launched together
+  EXPECT_EQ(run(), 2);
+
+  DisableOptionsGuard opt_guard;
+  DisableOptionsGuard::getCurOptions().set(DisableOption::HorizontalFusion);
+  EXPECT_EQ(run(), 4);
+}
+
+// Merges saving an intermediate without hurting the occupancy of persistent
+// buffers are kept by the cost model
+TEST_F(SegmentationTest, CostModelKeepsProfitableMerges) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::SegmenterCostModel);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  TensorView* tv1 = relu(tv0);
+  TensorView* tv2 = softmax(tv1, 1);
+  fusion->addOutput(neg(tv2));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 1024}, options);
+  FusionExecutorCache executor_cache(std::move(fusion));
+  std::vector<at::Tensor> out_tensors =
+      executor_cache.runFusionWithInputs({t0});
+  testValidate(executor_cache.fusion(), out_tensors, {t0}, __LINE__, __FILE__);
+  EXPECT_FALSE(executor_cache.getMostRecentKernelRuntime()->isSegmented());
+}
+
 } // namespace nvfuser
@@ -0,0 +1,117 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <gtest/gtest.h>
+
+#include <fusion.h>
+#include <ops/all_ops.h>
+#include <runtime/fusion_executor_cache.h>
+#include <tests/cpp/utils.h>
+
+namespace nvfuser {
+
+using SegmentedReductionTest = NVFuserTest;
+
+// Rows past the last offset are ignored and empty segments hold the initial
+// value
+TEST_F(SegmentedReductionTest, Sum) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* tv0 = makeContigTensor(2);
+  TensorView* offsets = makeContigTensor(1, DataType::Int);
+  fusion->addInput(tv0);
+  fusion->addInput(offsets);
+  TensorView* tv1 = segmented_sum(tv0, offsets);
+  fusion->addOutput(tv1);
+
+  EXPECT_TRUE(tv1->definition()->isA<SegmentedReductionOp>());
+  EXPECT_EQ(tv1->nDims(), 2);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({12, 64}, options);
+  at::Tensor t_offsets = at::tensor({3, 3, 7, 10}, options.dtype(at::kLong));
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0, t_offsets});
+
+  at::Tensor expected = at::stack(
+      {t0.narrow(0, 0, 3).sum(0),
+       at::zeros({64}, options),
+       t0.narrow(0, 3, 4).sum(0),
+       t0.narrow(0, 7, 3).sum(0)});
+  EXPECT_TRUE(at::allclose(outputs[0], expected, 1e-5, 1e-5));
+}
+
+// Softmax over each sequence of a packed batch. The per-segment results are
+// broadcast back to the rows with segment_ids.
+TEST_F(SegmentedReductionTest, Softmax) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* tv0 = makeContigTensor(2);
+  TensorView* offsets = makeContigTensor(1, DataType::Int);
+  fusion->addInput(tv0);
+  fusion->addInput(offsets);
+  TensorView* ids = segment_ids(offsets, tv0->axis(0)->extent());
+  TensorView* row_max = indexSelect(segmented_max(tv0, offsets), 0, ids);
+  TensorView* tv1 = exp(sub(tv0, row_max));
+  TensorView* row_sum = indexSelect(segmented_sum(tv1, offsets), 0, ids);
+  TensorView* tv2 = div(tv1, row_sum);
+  fusion->addOutput(tv2);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({10, 32}, options);
+  at::Tensor t_offsets = at::tensor({2, 7, 10}, options.dtype(at::kLong));
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0, t_offsets});
+
+  at::Tensor expected = at::cat(
+      {at::softmax(t0.narrow(0, 0, 2), 0),
+       at::softmax(t0.narrow(0, 2, 5), 0),
+       at::softmax(t0.narrow(0, 7, 3), 0)});
+  EXPECT_TRUE(at::allclose(outputs[0], expected, 1e-5, 1e-5));
+}
+
+// Segments are reduced in a fixed order instead of with atomics
+TEST_F(SegmentedReductionTest, Deterministic) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::DeterministicReductions);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* tv0 = makeContigTensor(2);
+  TensorView* offsets = makeContigTensor(1, DataType::Int);
+  fusion->addInput(tv0);
+  fusion->addInput(offsets);
+  TensorView* tv1 = segmented_sum(tv0, offsets);
+  fusion->addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({4096, 16}, options);
+  at::Tensor t_offsets =
+      at::tensor({1000, 1000, 3000, 4000}, options.dtype(at::kLong));
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0, t_offsets});
+
+  at::Tensor expected = at::stack(
+      {t0.narrow(0, 0, 1000).sum(0),
+       at::zeros({16}, options),
+       t0.narrow(0, 1000, 2000).sum(0),
+       t0.narrow(0, 3000, 1000).sum(0)});
+  EXPECT_TRUE(at::allclose(outputs[0], expected, 1e-4, 1e-4));
+  for ([[maybe_unused]] auto i : c10::irange(3)) {
+    auto rerun_outputs = executor_cache.runFusionWithInputs({t0, t_offsets});
+    EXPECT_TRUE(at::equal(rerun_outputs[0], outputs[0]));
+  }
+}
+
+} // namespace nvfuser
@@ -9,6 +9,7 @@
 #include <gmock/gmock-matchers.h>
 #include <gtest/gtest.h>
 
+#include <global_allocator.h>
 #include <grouped_reduction.h>
 #include <ir/utils.h>
 #include <kernel_ir.h>
@@ -24,6 +25,7 @@
 
 #include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/Exceptions.h>
+#include <c10/cuda/CUDAGuard.h>
 #include <c10/cuda/CUDAStream.h>
 
 #include <algorithm>
@@ -132,8 +134,7 @@ TEST_F(SerialGridReductionTest, Scheduling) {
           // was not launched, but we can check that the global zeroed memory
           // pool actually serviced an allocation request.
           EXPECT_THAT(
-              ss.str(),
-              testing::HasSubstr("Allocating byte range: 0 to 512 bytes"));
+              ss.str(), testing::HasSubstr("bytes in a 512-byte block"));
         }
 
         testValidate(fusion, outputs, {input}, __LINE__, __FILE__);
@@ -142,4 +143,38 @@ TEST_F(SerialGridReductionTest, Scheduling) {
   }
 }
 
+// Zeroed semaphore buffers are pooled per stream, so that kernels running
+// concurrently on different streams never share them
+TEST_F(SerialGridReductionTest, ZeroedMemoryPerStream) {
+  const c10::Device device(c10::DeviceType::CUDA, 0);
+  releaseZeroedMemory();
+  const ZeroedMemoryStats initial_stats = zeroedMemoryStats(device);
+
+  at::Tensor t0 = contigZeroedTensor({100}, at::kInt, device);
+  at::Tensor t1;
+  {
+    c10::cuda::CUDAStreamGuard stream_guard(c10::cuda::getStreamFromPool());
+    t1 = contigZeroedTensor({100}, at::kInt, device);
+  }
+  EXPECT_NE(t0.data_ptr(), t1.data_ptr());
+  EXPECT_EQ(zeroedMemoryStats(device).in_use_bytes, 2 * 512);
+
+  // Two buffers for the same launch get separate blocks
+  at::Tensor t2 = contigZeroedTensor({100}, at::kInt, device);
+  EXPECT_NE(t0.data_ptr(), t2.data_ptr());
+
+  // Released blocks are handed out again on the same stream
+  releaseZeroedMemory();
+  EXPECT_EQ(zeroedMemoryStats(device).in_use_bytes, 0);
+  at::Tensor t3 = contigZeroedTensor({100}, at::kInt, device);
+  EXPECT_TRUE(
+      t3.data_ptr() == t0.data_ptr() || t3.data_ptr() == t2.data_ptr());
+  EXPECT_TRUE(at::all(t3 == 0).item<bool>());
+  releaseZeroedMemory();
+
+  const ZeroedMemoryStats stats = zeroedMemoryStats(device);
+  EXPECT_GE(stats.num_streams, std::max(initial_stats.num_streams, (int64_t)2));
+  EXPECT_LE(stats.reserved_bytes, initial_stats.reserved_bytes + 3 * 512);
+}
+
 } // namespace nvfuser
@@ -103,6 +103,36 @@ TEST_F(ShardingTest, PropagateSharding) {
   EXPECT_TRUE(getTvsWithDifferentSharding(a, tvs).empty());
 }
 
+// `c` is used by two ops with the replicated `b` and only once with the
+// sharded `a`, so replicating `c` needs fewer communications than sharding it
+// like `a`.
+TEST_F(ShardingTest, CostBasedPropagateSharding) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::CostBasedSharding);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* a = makeContigConcreteTensor({6, 8});
+  TensorView* b = makeContigConcreteTensor({6, 8});
+  TensorView* c = add(a, b);
+  TensorView* d = mul(c, b);
+
+  DeviceMesh mesh({0, 1, 2});
+  a->setDeviceMesh(mesh);
+  b->setDeviceMesh(mesh);
+  a->axis(0)->parallelize(ParallelType::DIDx);
+  fusion.addInput(a);
+  fusion.addInput(b);
+  fusion.addOutput(d);
+
+  preseg_passes::OptimizationPass<
+      preseg_passes::PropagateShardingsPass>::runPass(&fusion);
+  EXPECT_EQ(c->getDeviceMesh(), mesh);
+  EXPECT_FALSE(isSharded(c));
+  EXPECT_FALSE(isSharded(d));
+}
+
 void isContiguous(TensorView* tv) {
   EXPECT_TRUE(tv->hasAllocation());
   auto contiguity = tv->getContiguity();
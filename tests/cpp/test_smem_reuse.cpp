@@ -511,6 +511,66 @@ TEST_F(SmemReuseTest, SkippedSyncInterval) {
   }
 }
 
+// A long-lived allocation placed on top of a freed one keeps the stack-based
+// allocator from reclaiming the freed memory, while interval packing re-uses
+// it
+//
+//   a: Write A and B
+//   b: Last read of A, followed by a block sync
+//   c: Write C
+//   d: Last read of B, followed by a block sync
+//   e: Write E
+//   f: Last read of C and E
+TEST_F(SmemReuseTest, IntervalPacking) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  int64_t H = 5;
+  auto tv0 = makeContigConcreteTensor({H});
+  fusion->addInput(tv0);
+
+  auto tv1 = set(tv0); // A
+  tv1->setMemoryType(MemoryType::Shared);
+  auto tv2 = neg(tv0); // B
+  tv2->setMemoryType(MemoryType::Shared);
+  auto tv3 = sum(add(tv1, tv2), {0});
+  tv3->axis(0)->parallelize(ParallelType::TIDx);
+
+  auto tv4 = mul(tv3, tv0); // C
+  tv4->setMemoryType(MemoryType::Shared);
+  auto tv5 = sum(add(tv2, tv4), {0});
+  tv5->axis(0)->parallelize(ParallelType::TIDx);
+
+  auto tv6 = mul(tv5, tv0); // E
+  tv6->setMemoryType(MemoryType::Shared);
+  auto tv7 = add(tv4, tv6);
+  fusion->addOutput(tv7);
+
+  auto smem_usage = [&fusion]() {
+    GpuLower gpulw(fusion.get());
+    ExpressionEvaluator ee;
+    int64_t usage = 0;
+    for (auto alloc : gpulw.run()->summary().dynamic_smem_allocations) {
+      EXPECT_NE(alloc->address(), nullptr);
+      auto addr = ee.evaluate(alloc->address()).as<int64_t>();
+      auto size = ee.evaluate(alloc->size()).as<int64_t>() *
+          dataTypeSize(alloc->buffer()->dtype());
+      usage = std::max(usage, addr + size);
+    }
+    return usage;
+  };
+
+  int64_t stack_usage = smem_usage();
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::SmemIntervalPacking);
+  int64_t packed_usage = smem_usage();
+
+  EXPECT_LT(packed_usage, stack_usage);
+  // C overlaps both B and E, which share an address
+  EXPECT_EQ(packed_usage, alignInt(H * 4) + H * 4);
+}
+
 TEST_F(SmemReuseTest, SmemReuseWithDifferentVectorizationFactor) {
   auto fusion = std::make_unique<Fusion>();
   FusionGuard fg(fusion.get());
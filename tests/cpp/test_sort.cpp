@@ -0,0 +1,74 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <gtest/gtest.h>
+
+#include <fusion.h>
+#include <ops/all_ops.h>
+#include <runtime/fusion_executor_cache.h>
+#include <runtime/fusion_kernel_runtime.h>
+#include <tests/cpp/utils.h>
+
+namespace nvfuser {
+
+using SortTest = NVFuserTest;
+
+TEST_F(SortTest, Sort) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  SortResult result = sort(tv0, -1, /*descending=*/true);
+  fusion->addOutput(result.values);
+  fusion->addOutput(result.indices);
+
+  EXPECT_TRUE(result.values->definition()->isA<SortOp>());
+  EXPECT_EQ(result.values->definition()->as<SortOp>()->dim(), 1);
+  EXPECT_EQ(result.indices->dtype(), DataType::Int);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({8, 128}, options);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0});
+
+  auto [values, indices] = at::sort(t0, 1, /*descending=*/true);
+  EXPECT_TRUE(at::equal(outputs[0], values));
+  EXPECT_TRUE(at::equal(outputs[1], indices));
+}
+
+// The selected axis has extent k, and the producer of the top-k and the
+// consumers of its outputs are still scheduled as kernels
+TEST_F(SortTest, TopK) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  TensorView* tv1 = mul(tv0, IrBuilder::create<Val>(2.0));
+  SortResult result = topk(tv1, IrBuilder::create<Val>(4L, DataType::Int));
+  TensorView* tv2 = exp(result.values);
+  fusion->addOutput(tv2);
+  fusion->addOutput(result.indices);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({8, 1024}, options);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0});
+
+  auto [values, indices] = at::topk(t0 * 2.0, 4, 1);
+  EXPECT_EQ(outputs[0].sizes(), (std::vector<int64_t>{8, 4}));
+  EXPECT_TRUE(at::allclose(outputs[0], values.exp()));
+  EXPECT_TRUE(at::equal(outputs[1], indices));
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_EQ(runtime->fusionSegments()->groups().size(), 3);
+}
+
+} // namespace nvfuser
@@ -7,9 +7,11 @@ from functools import partial
 import itertools
 import io
 import math
+import os
 import re
 import random
 import sys
+import tempfile
 from typing import List
 
 import torch
@@ -75,6 +77,24 @@ class TestNvFuserFrontend(NVFuserTest):
         self.assertEqual(eager_out, nvf_out2[0])
         self.assertEqual(eager_out, nvf_out3[0])
 
+        # Execute the cached fusion without building its definition again
+        nvf_out4 = FusionDefinition.execute_by_id(fd2.id(), inputs)
+        self.assertEqual(eager_out, nvf_out4[0])
+
+        # Execute the cached fusion twice in a single call
+        nvf_outs = FusionDefinition.execute_batch(
+            [(fd2, inputs), (fd2.id(), inputs)]
+        )
+        self.assertEqual(len(nvf_outs), 2)
+        self.assertEqual(eager_out, nvf_outs[0][0])
+        self.assertEqual(eager_out, nvf_outs[1][0])
+
+        # Execute the cached fusion on a separate thread
+        future = fd2.execute_async(inputs)
+        nvf_out5 = future.result()
+        self.assertTrue(future.done())
+        self.assertEqual(eager_out, nvf_out5[0])
+
     def test_basic_fp16(self):
         inputs = [
             torch.ones(2, 4, 8, device="cuda", dtype=torch.float16),
@@ -4876,3 +4896,104 @@ fd.execute(inputs)
 
         self.assertEqual(nvf_out[0], d)
         self.assertEqual(nvf_out[1], e)
+
+    def test_fusion_cache_journal(self):
+        inputs = [
+            torch.randn(4, 8, device="cuda"),
+            torch.randn(4, 8, device="cuda"),
+        ]
+
+        def add_func(fd: FusionDefinition) -> None:
+            t0 = fd.from_pytorch(inputs[0])
+            t1 = fd.from_pytorch(inputs[1])
+            fd.add_output(fd.ops.add(t0, t1))
+
+        def mul_func(fd: FusionDefinition) -> None:
+            t0 = fd.from_pytorch(inputs[0])
+            t1 = fd.from_pytorch(inputs[1])
+            fd.add_output(fd.ops.mul(t0, t1))
+
+        def run(fusion_func):
+            with FusionDefinition() as fd:
+                fusion_func(fd)
+            return fd.execute(inputs)[0]
+
+        FusionCache.reset()
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            journal = os.path.join(tmp_dir, "journal")
+            compacted = os.path.join(tmp_dir, "compacted")
+
+            # Each append only writes the fusions changed since the last one
+            fc = FusionCache.get()
+            run(add_func)
+            fc.append_to_journal(journal)
+            fc.wait_for_journal_writes()
+            journal_size = os.path.getsize(journal)
+            fc.append_to_journal(journal)
+            fc.wait_for_journal_writes()
+            self.assertEqual(os.path.getsize(journal), journal_size)
+
+            FusionCache.reset()
+            fc = FusionCache.get()
+            fc.deserialize(journal)
+            self.assertEqual(fc.num_fusions(), 1)
+            run(mul_func)
+            fc.append_to_journal(journal)
+            fc.wait_for_journal_writes()
+            self.assertGreater(os.path.getsize(journal), journal_size)
+
+            FusionCache.compact_journal(journal, compacted)
+            for filename in [journal, compacted]:
+                FusionCache.reset()
+                fc = FusionCache.get()
+                fc.deserialize(filename)
+                self.assertEqual(fc.num_fusions(), 2)
+                self.assertEqual(run(add_func), inputs[0] + inputs[1])
+                self.assertEqual(run(mul_func), inputs[0] * inputs[1])
+                self.assertEqual(fc.num_fusions(), 2)
+        FusionCache.reset()
+
+    def test_sort_topk(self):
+        inputs = [torch.randn(4, 64, device="cuda")]
+
+        def fusion_func(fd: FusionDefinition):
+            t0 = fd.from_pytorch(inputs[0])
+            values, indices = fd.ops.sort(t0, dim=-1, descending=True)
+            k = fd.define_scalar(8, dtype=DataType.Int)
+            top_values, top_indices = fd.ops.topk(t0, k, dim=-1)
+            fd.add_output(values)
+            fd.add_output(indices)
+            fd.add_output(top_values)
+            fd.add_output(top_indices)
+
+        nvf_out, _ = self.exec_nvfuser(fusion_func, inputs)
+        eager_values, eager_indices = torch.sort(inputs[0], dim=-1, descending=True)
+        self.assertEqual(nvf_out[0], eager_values)
+        self.assertEqual(nvf_out[1], eager_indices)
+        eager_top = torch.topk(inputs[0], 8, dim=-1)
+        self.assertEqual(nvf_out[2], eager_top.values)
+        self.assertEqual(nvf_out[3], eager_top.indices)
+
+    def test_runtime_cache_stats(self):
+        with FusionDefinition() as fd:
+            t0 = fd.define_tensor(shape=[-1, -1], contiguity=[True, True])
+            t1 = fd.ops.sin(t0)
+            t2 = fd.ops.mul(t1, t0)
+            fd.add_output(t2)
+
+        # Extents 5 and 7 fall into the same power-of-two bucket
+        fd.set_shape_bucket_policy([(0, 0)])
+        start = fd.runtime_cache_stats()
+        for rows in [5, 5, 7]:
+            t0 = torch.randn(rows, 64, device="cuda")
+            nvf_out = fd.execute([t0])
+            self.assertEqual(nvf_out[0], t0.sin() * t0)
+        stats = fd.runtime_cache_stats()
+        fd.set_shape_bucket_policy(None)
+
+        def delta(key):
+            return stats[key] - start[key]
+
+        self.assertEqual(delta("runtime_hits") + delta("runtime_misses"), 3)
+        self.assertGreaterEqual(delta("runtime_hits"), 1)
+        self.assertLessEqual(delta("created_runtimes"), 1)
@@ -0,0 +1,146 @@
+# SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+# All rights reserved.
+# SPDX-License-Identifier: BSD-3-Clause
+#
+# Flags kernels whose runtime or register count regressed between two runs
+# recorded with NVFUSER_ENABLE=kernel_perf_db(<directory>,<run>), e.g.,
+#
+#   NVFUSER_ENABLE="kernel_perf_db(/tmp/perf_db,old)" python model.py
+#   # upgrade nvFuser
+#   NVFUSER_ENABLE="kernel_perf_db(/tmp/perf_db,new)" python model.py
+#   python tools/kernel_perf_db.py /tmp/perf_db old new
+#
+# The comparison mirrors KernelPerfDb::findRegressions in
+# csrc/kernel_db/perf_db.h. "kernel_perf_db.py -h" for help.
+
+import argparse
+from dataclasses import dataclass
+import os
+import sys
+
+
+@dataclass
+class Kernel:
+    fusion_hash: str
+    segment: int
+    gpu: str
+    inputs: str
+    kernel_name: str
+    scheduler: str
+    heuristic_params: str
+    registers: int
+    times_ms: list[float]
+
+    @property
+    def key(self) -> tuple:
+        return (self.fusion_hash, self.segment, self.gpu, self.inputs)
+
+    @property
+    def time_ms(self) -> float:
+        # Matches the upper median of KernelPerfDb
+        return sorted(self.times_ms)[len(self.times_ms) // 2]
+
+
+# Reads the records of a run and summarizes them by kernel. See
+# KernelPerfRecord::toLine for the format of a record.
+def load_run(directory: str, run: str) -> dict[tuple, Kernel]:
+    kernels: dict[tuple, Kernel] = {}
+    path = os.path.join(directory, run + ".tsv")
+    with open(path) as f:
+        for line in f:
+            fields = line.rstrip("\n").split("\t")
+            if len(fields) != 9:
+                # Truncated by a process that died while appending
+                continue
+            try:
+                kernel = Kernel(
+                    fields[0],
+                    int(fields[1]),
+                    fields[2],
+                    fields[3],
+                    fields[4],
+                    fields[5],
+                    fields[6],
+                    int(fields[7]),
+                    [float(fields[8])],
+                )
+            except ValueError:
+                continue
+            if existing := kernels.get(kernel.key):
+                existing.kernel_name = kernel.kernel_name
+                existing.scheduler = kernel.scheduler
+                existing.heuristic_params = kernel.heuristic_params
+                existing.registers = max(existing.registers, kernel.registers)
+                existing.times_ms += kernel.times_ms
+            else:
+                kernels[kernel.key] = kernel
+    return kernels
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(
+        description="Compares two runs recorded in a kernel perf db."
+    )
+    parser.add_argument("directory", help="directory of the kernel perf db")
+    parser.add_argument("baseline", help="label of the baseline run")
+    parser.add_argument("candidate", help="label of the candidate run")
+    parser.add_argument(
+        "--time-tolerance",
+        type=float,
+        default=0.05,
+        help="relative growth of the median time that is a regression",
+    )
+    parser.add_argument(
+        "--register-tolerance",
+        type=int,
+        default=0,
+        help="number of extra registers that is a regression",
+    )
+    args = parser.parse_args()
+
+    baselines = load_run(args.directory, args.baseline)
+    candidates = load_run(args.directory, args.candidate)
+
+    regressions = []
+    for key, candidate in candidates.items():
+        baseline = baselines.get(key)
+        if baseline is None:
+            continue
+        time_regressed = candidate.time_ms > baseline.time_ms * (
+            1.0 + args.time_tolerance
+        )
+        registers_regressed = (
+            baseline.registers >= 0
+            and candidate.registers > baseline.registers + args.register_tolerance
+        )
+        if time_regressed or registers_regressed:
+            ratio = candidate.time_ms / baseline.time_ms if baseline.time_ms else 0
+            regressions.append((ratio, baseline, candidate, registers_regressed))
+    regressions.sort(key=lambda regression: regression[0], reverse=True)
+
+    num_compared = len(candidates.keys() & baselines.keys())
+    print(
+        f"Compared {num_compared} kernels: "
+        f"{len(baselines) - num_compared} only in {args.baseline}, "
+        f"{len(candidates) - num_compared} only in {args.candidate}."
+    )
+    for ratio, baseline, candidate, registers_regressed in regressions:
+        print(
+            f"{candidate.kernel_name} ({candidate.scheduler}, fusion "
+            f"{candidate.fusion_hash} segment {candidate.segment}, "
+            f"{candidate.gpu}, {candidate.inputs})"
+        )
+        print(
+            f"  time {baseline.time_ms:.4f} ms -> {candidate.time_ms:.4f} ms "
+            f"({ratio:.2f}x), registers {baseline.registers} -> "
+            f"{candidate.registers}{' (regressed)' if registers_regressed else ''}"
+        )
+        if baseline.heuristic_params != candidate.heuristic_params:
+            print(f"  baseline params: {baseline.heuristic_params}")
+            print(f"  candidate params: {candidate.heuristic_params}")
+    # A non-zero exit status lets CI fail on regressions
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())